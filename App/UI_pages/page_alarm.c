@@ -0,0 +1,494 @@
+/**
+ * @file      page_alarm.c
+ * @brief     闹钟设置页面
+ * @details   列表显示全部闹钟，选中一项后进入编辑：编码器按键依次切换时、分、星期一~日和开关，
+ *            旋转编码器修改当前项，确认键保存，返回键放弃修改回到列表。
+ *            列表由通用列表控件实现，时和分的滚动数值由 ui_slot 预先光栅化。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_display.h"
+#include "app_i18n.h"
+#include "ui_list.h"
+#include "ui_slot.h"
+#include "app_fmt.h"
+#include "app_anim.h"
+#include "app_alarm.h"
+#include "input.h"
+
+/**
+ * @defgroup PageAlarm 闹钟设置页面
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define ALARM_LIST_ITEM_HEIGHT 16 ///< 列表每行的像素高度
+#define ALARM_LIST_LEFT_X 2       ///< 列表区域左侧的X坐标
+#define ALARM_LIST_WIDTH 124      ///< 列表区域的像素宽度
+#define ALARM_ROW_TEXT_MAX 20     ///< 列表一行文字的最大长度 (含结尾的 '\0')
+
+#define ALARM_FOCUS_HOUR 0        ///< 编辑焦点：时
+#define ALARM_FOCUS_MINUTE 1      ///< 编辑焦点：分
+#define ALARM_FOCUS_DAY0 2        ///< 编辑焦点：星期一，之后依次为星期二~日
+#define ALARM_FOCUS_ENABLE 9      ///< 编辑焦点：开关
+#define ALARM_FOCUS_COUNT 10      ///< 编辑焦点的个数
+
+#define ALARM_VALUE_Y 38          ///< 时和分的基线Y坐标
+#define ALARM_HOUR_X 44           ///< 时的中心X坐标
+#define ALARM_MINUTE_X 84         ///< 分的中心X坐标
+#define ALARM_SLOT_PITCH 18       ///< 老虎机中相邻数值的行距，上下两个值在裁剪区域内露出一部分
+#define ALARM_SLOT_Y0 17          ///< 老虎机裁剪区域的顶部Y坐标
+#define ALARM_SLOT_Y1 48          ///< 老虎机裁剪区域的底部Y坐标 (不含)
+#define ALARM_DAY_X0 9            ///< 星期一的左侧X坐标
+#define ALARM_DAY_PITCH 16        ///< 相邻星期的间距
+#define ALARM_DAY_Y 61            ///< 星期的基线Y坐标
+#define ALARM_SLOT_ROLL_MS 150    ///< 老虎机滚动动画的时长
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 页面状态枚举
+ */
+typedef enum
+{
+    ALARM_STATE_LIST,         ///< 闹钟列表
+    ALARM_STATE_EDIT,         ///< 编辑一个闹钟
+    ALARM_STATE_SLOT_ROLLING  ///< 编辑中，老虎机滚动动画
+} Alarm_State_e;
+
+/**
+ * @brief 闹钟设置页面的私有数据结构体
+ */
+typedef struct
+{
+    UI_List_t list;          ///< 闹钟列表
+    App_Alarm_t edit;        ///< 正在编辑的闹钟
+    uint8_t focus;           ///< 编辑焦点 (ALARM_FOCUS_*)
+    uint8_t state;           ///< 页面状态 (Alarm_State_e)
+    int16_t slot_y_offset;   ///< 老虎机滚动动画的Y轴偏移
+    int16_t slot_direction;  ///< 老虎机滚动方向
+    uint32_t anim_start;     ///< 滚动动画的开始时间戳
+    char row[ALARM_ROW_TEXT_MAX]; ///< 列表一行的文字，绘制时逐行生成
+} Page_Alarm_Data_t;
+
+/* Private variables ---------------------------------------------------------*/
+PAGE_DATA_CHECK(Page_Alarm_Data_t); ///< 闹钟页面的数据由页面管理器在进入时分配 (Page_Data)
+
+///< 一周各天的缩写，从星期一开始
+static const char day_letters[7] = {'M', 'T', 'W', 'T', 'F', 'S', 'S'};
+
+/* Private function prototypes -----------------------------------------------*/
+static void Page_Alarm_Enter(const Page_Base *page);
+static void Page_Alarm_Loop(const Page_Base *page);
+static void Page_Alarm_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_Alarm_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static uint16_t Alarm_Count(const void *ctx);
+static const char *Alarm_Text(const void *ctx, uint16_t index);
+static void Alarm_Draw_Edit(Page_Alarm_Data_t *data, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Alarm_Draw_Value(Page_Alarm_Data_t *data, u8g2_t *u8g2, uint8_t field, int16_t cx, int16_t y);
+static void Alarm_Slot_Text(char str[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX], uint8_t field, int value);
+static void Alarm_Prefetch(const Page_Alarm_Data_t *data);
+static void Alarm_Saved(const Page_Base *page);
+
+/**
+ * @brief 闹钟列表的布局，4个闹钟正好占满屏幕
+ */
+static const UI_List_Config_t alarm_list = {
+    .x = ALARM_LIST_LEFT_X,
+    .y = 0,
+    .w = ALARM_LIST_WIDTH,
+    .text_x = 6,
+    .item_h = ALARM_LIST_ITEM_HEIGHT,
+    .baseline = 12,
+    .rows = 4,
+    .wrap = true,
+    .font = ALARM_FONT_LIST,
+    .count = Alarm_Count,
+    .text = Alarm_Text};
+
+/* Public variables ----------------------------------------------------------*/
+/**
+ * @brief 闹钟设置页面的全局实例
+ */
+const Page_Base g_page_alarm = {
+    .enter = Page_Alarm_Enter,
+    .exit = NULL,
+    .loop = Page_Alarm_Loop,
+    .draw = Page_Alarm_Draw,
+    .action = Page_Alarm_Action,
+    .page_name = "Alarm",
+    .id = PAGE_ID_ALARM};
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief  获取闹钟数量
+ * @param[in] ctx 页面数据 (未使用)
+ * @return uint16_t 闹钟数量
+ */
+static uint16_t Alarm_Count(const void *ctx)
+{
+    return APP_ALARM_COUNT;
+}
+
+/**
+ * @brief  生成列表一行的文字，如 "1 07:30 MTWTF-- On"
+ * @details 列表控件取得文字后立即绘制，所有行共用页面数据中的一个缓冲区。
+ * @param[in] ctx 页面数据
+ * @param[in] index 闹钟序号
+ * @return const char* 该行的文字
+ */
+static const char *Alarm_Text(const void *ctx, uint16_t index)
+{
+    Page_Alarm_Data_t *data = (Page_Alarm_Data_t *)ctx;
+    const App_Alarm_t *alarm = app_alarm_get((uint8_t)index);
+    char *p = data->row;
+
+    p = fmt_char(p, (char)('1' + index));
+    p = fmt_char(p, ' ');
+    p = fmt_u2(p, alarm->hour);
+    p = fmt_char(p, ':');
+    p = fmt_u2(p, alarm->minute);
+    p = fmt_char(p, ' ');
+    if (alarm->days == 0)
+    {
+        p = fmt_str(p, "Once   ");
+    }
+    else
+    {
+        for (uint8_t d = 0; d < 7; d++)
+        {
+            p = fmt_char(p, (alarm->days & (1U << d)) ? day_letters[d] : '-');
+        }
+    }
+    fmt_str(p, alarm->enabled ? " On" : " Off");
+    return data->row;
+}
+
+/**
+ * @brief  页面进入函数
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Alarm_Enter(const Page_Base *page)
+{
+    Page_Alarm_Data_t *data = Page_Data(page);
+
+    data->state = ALARM_STATE_LIST;
+    data->slot_y_offset = 0;
+    UI_List_Init(&data->list, &alarm_list, data, Page_Resume_Get(page, 0));
+    UI_Slot_Reset();
+}
+
+/**
+ * @brief  生成老虎机中三个值的字符串
+ * @param[out] str 上一个值、当前值和下一个值
+ * @param[in] field ALARM_FOCUS_HOUR 或 ALARM_FOCUS_MINUTE
+ * @param[in] value 当前值
+ * @return 无
+ */
+static void Alarm_Slot_Text(char str[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX], uint8_t field, int value)
+{
+    int max_value = (field == ALARM_FOCUS_HOUR) ? 23 : 59;
+
+    fmt_u2(str[0], (value == 0) ? max_value : value - 1);
+    fmt_u2(str[1], value);
+    fmt_u2(str[2], (value == max_value) ? 0 : value + 1);
+}
+
+/**
+ * @brief  空闲时预先生成下一次旋转后的老虎机位图
+ * @details 按上一次的旋转方向预测下一个值 (默认为增加)，旋转后的第一帧只需复制位图。
+ * @param[in] data 页面数据
+ * @return 无
+ */
+static void Alarm_Prefetch(const Page_Alarm_Data_t *data)
+{
+    char str[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX];
+    const char *const text[UI_SLOT_ROWS] = {str[0], str[1], str[2]};
+    int modulus = (data->focus == ALARM_FOCUS_HOUR) ? 24 : 60;
+    int value = (data->focus == ALARM_FOCUS_HOUR) ? data->edit.hour : data->edit.minute;
+
+    // 滚动方向为 -1 表示数值增加
+    value = (value + ((data->slot_direction > 0) ? modulus - 1 : 1)) % modulus;
+    Alarm_Slot_Text(str, data->focus, value);
+    UI_Slot_Prefetch(((uint32_t)data->focus << 16) | (uint16_t)value, text);
+}
+
+/**
+ * @brief  页面循环函数
+ * @details 驱动老虎机的滚动动画，并处理反馈信息的显示超时；编辑时和分时在空闲时预先生成下一个值的位图。
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Alarm_Loop(const Page_Base *page)
+{
+    Page_Alarm_Data_t *data = Page_Data(page);
+    uint32_t elapsed = Page_Now() - data->anim_start;
+
+    if (data->state == ALARM_STATE_SLOT_ROLLING)
+    {
+        if (elapsed >= ALARM_SLOT_ROLL_MS)
+        {
+            data->slot_y_offset = 0;
+            data->state = ALARM_STATE_EDIT;
+        }
+        else
+        {
+            q16_t progress = Anim_Ease(ANIM_EASE_OUT_QUAD, Anim_Progress(elapsed, ALARM_SLOT_ROLL_MS));
+            data->slot_y_offset = Anim_Lerp(data->slot_direction * ALARM_SLOT_PITCH, 0, progress);
+        }
+        Page_Invalidate(page);
+    }
+    else if (data->state == ALARM_STATE_EDIT && (data->focus == ALARM_FOCUS_HOUR || data->focus == ALARM_FOCUS_MINUTE))
+    {
+        Alarm_Prefetch(data);
+    }
+}
+
+/**
+ * @brief  保存反馈的提示框关闭后回到列表
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Alarm_Saved(const Page_Base *page)
+{
+    Page_Alarm_Data_t *data = Page_Data(page);
+
+    data->state = ALARM_STATE_LIST;
+    Page_Invalidate(page);
+}
+
+/**
+ * @brief  绘制时或分
+ * @details 聚焦的一项用老虎机显示上一个值、当前值和下一个值 (限制在裁剪区域内)，另一项只显示当前值。
+ * @param[in] data 页面数据
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] field ALARM_FOCUS_HOUR 或 ALARM_FOCUS_MINUTE
+ * @param[in] cx 数值中心的X坐标 (已加上X方向偏移)
+ * @param[in] y 基线Y坐标 (已加上Y方向偏移)
+ * @return 无
+ */
+static void Alarm_Draw_Value(Page_Alarm_Data_t *data, u8g2_t *u8g2, uint8_t field, int16_t cx, int16_t y)
+{
+    int value = (field == ALARM_FOCUS_HOUR) ? data->edit.hour : data->edit.minute;
+    char str[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX];
+
+    u8g2_SetFont(u8g2, ALARM_FONT_VALUE);
+    if (data->focus != field)
+    {
+        fmt_u2(str[1], value);
+        u8g2_DrawStr(u8g2, cx - Page_Str_Width(u8g2, str[1]) / 2, y, str[1]);
+        return;
+    }
+
+    uint32_t key = ((uint32_t)field << 16) | (uint16_t)value;
+    if (!UI_Slot_Ready(key))
+    {
+        const char *const text[UI_SLOT_ROWS] = {str[0], str[1], str[2]};
+        Alarm_Slot_Text(str, field, value);
+        UI_Slot_Build(u8g2, key, text, ALARM_SLOT_PITCH);
+    }
+
+    // 上下两个值只在时间一行附近露出，不能盖住标题和星期
+    u8g2_uint_t saved_x0 = u8g2->clip_x0;
+    u8g2_uint_t saved_y0 = u8g2->clip_y0;
+    u8g2_uint_t saved_x1 = u8g2->clip_x1;
+    u8g2_uint_t saved_y1 = u8g2->clip_y1;
+    int16_t y0 = y - ALARM_VALUE_Y + ALARM_SLOT_Y0;
+    int16_t y1 = y - ALARM_VALUE_Y + ALARM_SLOT_Y1;
+    if (y0 < (int16_t)saved_y0)
+    {
+        y0 = (int16_t)saved_y0;
+    }
+    if (y1 > (int16_t)saved_y1)
+    {
+        y1 = (int16_t)saved_y1;
+    }
+    if (y1 <= y0)
+    {
+        return;
+    }
+    u8g2_SetClipWindow(u8g2, saved_x0, (u8g2_uint_t)y0, saved_x1, (u8g2_uint_t)y1);
+    UI_Slot_Draw(u8g2, cx - UI_Slot_Width() / 2, y, data->slot_y_offset);
+    u8g2_SetClipWindow(u8g2, saved_x0, saved_y0, saved_x1, saved_y1);
+}
+
+/**
+ * @brief  绘制编辑界面
+ * @details 第一行为闹钟序号和开关，中间为时和分，最下面一行为星期：重复的星期反色显示，焦点所在的项加下划线。
+ * @param[in] data 页面数据
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+static void Alarm_Draw_Edit(Page_Alarm_Data_t *data, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    char title[8] = "Alarm ";
+    const char *state = data->edit.enabled ? "On" : "Off";
+
+    u8g2_SetFont(u8g2, ALARM_FONT_LIST);
+    if (Page_Strip_Text_Visible(u8g2, 11 + y_offset))
+    {
+        fmt_char(title + 6, (char)('1' + data->list.selected));
+        u8g2_DrawStr(u8g2, 2 + x_offset, 11 + y_offset, title);
+
+        int16_t state_w = Page_Str_Width(u8g2, state);
+        int16_t state_x = 124 - state_w;
+        u8g2_DrawStr(u8g2, state_x + x_offset, 11 + y_offset, state);
+        if (data->focus == ALARM_FOCUS_ENABLE)
+        {
+            u8g2_DrawHLine(u8g2, state_x + x_offset, 13 + y_offset, state_w);
+        }
+    }
+
+    Alarm_Draw_Value(data, u8g2, ALARM_FOCUS_HOUR, ALARM_HOUR_X + x_offset, ALARM_VALUE_Y + y_offset);
+    Alarm_Draw_Value(data, u8g2, ALARM_FOCUS_MINUTE, ALARM_MINUTE_X + x_offset, ALARM_VALUE_Y + y_offset);
+    u8g2_SetFont(u8g2, ALARM_FONT_VALUE);
+    u8g2_DrawStr(u8g2, 64 - Page_Str_Width(u8g2, ":") / 2 + x_offset, ALARM_VALUE_Y - 2 + y_offset, ":");
+
+    u8g2_SetFont(u8g2, ALARM_FONT_LIST);
+    if (Page_Strip_Text_Visible(u8g2, ALARM_DAY_Y + y_offset))
+    {
+        char letter[2] = {0, 0};
+        for (uint8_t d = 0; d < 7; d++)
+        {
+            int16_t x = ALARM_DAY_X0 + d * ALARM_DAY_PITCH + x_offset;
+            letter[0] = day_letters[d];
+            u8g2_DrawStr(u8g2, x + 2, ALARM_DAY_Y + y_offset, letter);
+            if (data->edit.days & (1U << d))
+            {
+                Page_Invert_Rect(u8g2, x, ALARM_DAY_Y - 10 + y_offset, 10, 12);
+            }
+            if (data->focus == ALARM_FOCUS_DAY0 + d)
+            {
+                u8g2_DrawHLine(u8g2, x, ALARM_DAY_Y + 2 + y_offset, 10);
+            }
+        }
+    }
+}
+
+/**
+ * @brief  页面绘制函数
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向 u8g2 实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+static void Page_Alarm_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    Page_Alarm_Data_t *data = Page_Data(page);
+
+    if (data->state == ALARM_STATE_LIST)
+    {
+        UI_List_Draw(&data->list, u8g2, x_offset, y_offset);
+        return;
+    }
+
+    Alarm_Draw_Edit(data, u8g2, x_offset, y_offset);
+}
+
+/**
+ * @brief  页面事件处理函数
+ * @details 列表中确认键或编码器按键进入编辑；编辑中修改时间时自动打开闹钟。
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向 u8g2 实例的指针 (未使用)
+ * @param[in] event 指向输入事件数据的指针
+ * @return 无
+ */
+static void Page_Alarm_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+{
+    Page_Alarm_Data_t *data = Page_Data(page);
+
+    if (data->state == ALARM_STATE_LIST)
+    {
+        switch (event->event)
+        {
+        case INPUT_EVENT_ENCODER:
+            UI_List_Move(&data->list, event->value);
+            Page_Resume_Set(page, (uint8_t)data->list.selected);
+            break;
+        case INPUT_EVENT_COMFIRM_PRESSED:
+        case INPUT_EVENT_ENCODER_PRESSED:
+            data->edit = *app_alarm_get((uint8_t)data->list.selected);
+            data->focus = ALARM_FOCUS_HOUR;
+            data->state = ALARM_STATE_EDIT;
+            UI_Slot_Reset();
+            Page_Invalidate(page);
+            break;
+        case INPUT_EVENT_BACK_PRESSED:
+            Go_Back_Page();
+            break;
+        default:
+            break;
+        }
+        return;
+    }
+
+    // 滚动动画和反馈信息期间只响应返回键
+    if (data->state != ALARM_STATE_EDIT)
+    {
+        if (event->event == INPUT_EVENT_BACK_PRESSED)
+        {
+            data->state = ALARM_STATE_LIST;
+            Page_Invalidate(page);
+        }
+        return;
+    }
+
+    switch (event->event)
+    {
+    case INPUT_EVENT_ENCODER:
+    {
+        int16_t step = event->accel_value;
+        if (data->focus == ALARM_FOCUS_HOUR || data->focus == ALARM_FOCUS_MINUTE)
+        {
+            if (data->focus == ALARM_FOCUS_HOUR)
+            {
+                data->edit.hour = (uint8_t)(((data->edit.hour + step) % 24 + 24) % 24);
+            }
+            else
+            {
+                data->edit.minute = (uint8_t)(((data->edit.minute + step) % 60 + 60) % 60);
+            }
+            data->edit.enabled = true;
+            data->state = ALARM_STATE_SLOT_ROLLING;
+            data->slot_direction = (event->value > 0) ? -1 : 1;
+            data->slot_y_offset = data->slot_direction * ALARM_SLOT_PITCH;
+            data->anim_start = Page_Now();
+        }
+        else if (data->focus == ALARM_FOCUS_ENABLE)
+        {
+            data->edit.enabled = !data->edit.enabled;
+        }
+        else
+        {
+            data->edit.days ^= (uint8_t)(1U << (data->focus - ALARM_FOCUS_DAY0));
+        }
+        Page_Invalidate(page);
+        break;
+    }
+    case INPUT_EVENT_ENCODER_PRESSED:
+        data->focus = (uint8_t)((data->focus + 1) % ALARM_FOCUS_COUNT);
+        Page_Invalidate(page);
+        break;
+    case INPUT_EVENT_COMFIRM_PRESSED:
+        Page_Toast(app_alarm_set((uint8_t)data->list.selected, &data->edit) ? app_str(STR_MSG_ALARM_SAVED) : app_str(STR_MSG_SAVE_FAILED),
+                   PAGE_TOAST_MS, Alarm_Saved); // 显示1秒后回到列表
+        break;
+    case INPUT_EVENT_BACK_PRESSED:
+        data->state = ALARM_STATE_LIST; // 放弃修改
+        Page_Invalidate(page);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @}
+ */
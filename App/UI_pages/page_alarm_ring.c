@@ -0,0 +1,169 @@
+/**
+ * @file      page_alarm_ring.c
+ * @brief     闹钟响铃页面实现文件
+ * @details   闹钟开始响铃时由主循环切换到本页面 (清空页面堆栈)。页面显示 "ALARM" 和当前时间，
+ *            每 500ms 整屏反色一次作为提示。任意按键停止响铃并返回主页面；
+ *            响铃超时自动停止后同样返回主页面，之后照常自动熄屏。
+ * @author    SandOcean
+ * @date      2025-09-29
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_display.h"
+#include "app_glyph_cache.h"
+#include "app_fmt.h"
+#include "app_settings.h"
+#include "app_alarm.h"
+#include "input.h"
+#include "DS3231.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define RING_FLASH_MS 500      ///< 反色闪烁的半周期
+#define RING_TITLE_Y 18        ///< "ALARM" 的基线Y坐标
+#define RING_TIME_Y 52         ///< 时间的基线Y坐标
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 响铃页面的私有数据结构体
+ */
+typedef struct
+{
+    char time_str[6];     ///< 格式化的时间字符串 "HH:MM"
+    uint8_t minute;       ///< 上一次生成字符串时的分钟
+    bool inverted;        ///< 当前是否反色
+    uint32_t enter_time;  ///< 进入页面的时间戳，闪烁以此为起点
+} Page_Alarm_Ring_Data;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Page_Alarm_Ring_Enter(const Page_Base *page);
+static void Page_Alarm_Ring_Loop(const Page_Base *page);
+static void Page_Alarm_Ring_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_Alarm_Ring_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static void Ring_Format_Time(Page_Alarm_Ring_Data *data);
+
+/* Private variables ---------------------------------------------------------*/
+PAGE_DATA_CHECK(Page_Alarm_Ring_Data); ///< 数据由页面管理器在进入时分配 (Page_Data)
+
+/* Public variables ----------------------------------------------------------*/
+/**
+ * @brief 响铃页面的全局实例
+ */
+const Page_Base g_page_alarm_ring = {
+    .enter = Page_Alarm_Ring_Enter,
+    .exit = NULL,
+    .loop = Page_Alarm_Ring_Loop,
+    .draw = Page_Alarm_Ring_Draw,
+    .action = Page_Alarm_Ring_Action,
+    .page_name = "alarm_ring",
+    .id = PAGE_ID_ALARM_RING};
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 按缓存时间生成 "HH:MM"
+ * @param[in,out] data 页面数据
+ * @return 无
+ */
+static void Ring_Format_Time(Page_Alarm_Ring_Data *data)
+{
+    Time_t now;
+
+    DS3231_DST_GetCachedTime(&now, g_app_settings.dst_enabled);
+    data->minute = now.minute;
+    char *p = fmt_u2(data->time_str, now.hour);
+    p = fmt_char(p, ':');
+    fmt_u2(p, now.minute);
+}
+
+/**
+ * @brief 响铃页面进入函数
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Alarm_Ring_Enter(const Page_Base *page)
+{
+    Page_Alarm_Ring_Data *data = Page_Data(page);
+
+    data->inverted = false;
+    data->enter_time = Page_Now();
+    Ring_Format_Time(data);
+}
+
+/**
+ * @brief 响铃页面的逻辑循环函数
+ * @details 闪烁相位或分钟变化时整屏失效；响铃已停止 (超时) 时返回主页面。
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Alarm_Ring_Loop(const Page_Base *page)
+{
+    Page_Alarm_Ring_Data *data = Page_Data(page);
+    Time_t now;
+
+    if (!app_alarm_is_ringing())
+    {
+        Page_Manager_Go_Home();
+        return;
+    }
+
+    bool inverted = ((Page_Now() - data->enter_time) / RING_FLASH_MS) & 1U;
+    if (inverted != data->inverted)
+    {
+        data->inverted = inverted;
+        Page_Invalidate(page);
+    }
+
+    DS3231_DST_GetCachedTime(&now, g_app_settings.dst_enabled);
+    if (now.minute != data->minute)
+    {
+        Ring_Format_Time(data);
+        Page_Invalidate(page);
+    }
+}
+
+/**
+ * @brief 响铃页面的绘制函数
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+static void Page_Alarm_Ring_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    Page_Alarm_Ring_Data *data = Page_Data(page);
+
+    u8g2_SetFont(u8g2, MENU_FONT);
+    if (Page_Strip_Text_Visible(u8g2, RING_TITLE_Y + y_offset))
+    {
+        int16_t x = (128 - (int16_t)Page_Str_Width(u8g2, "ALARM")) / 2;
+        u8g2_DrawStr(u8g2, x + x_offset, RING_TITLE_Y + y_offset, "ALARM");
+    }
+
+    u8g2_SetFont(u8g2, CLOCK_FONT);
+    if (Page_Strip_Text_Visible(u8g2, RING_TIME_Y + y_offset))
+    {
+        int16_t x = (128 - (int16_t)Glyph_Cache_GetStrWidth(u8g2, data->time_str)) / 2;
+        Glyph_Cache_DrawStr(u8g2, x + x_offset, RING_TIME_Y + y_offset, data->time_str);
+    }
+
+    if (data->inverted)
+    {
+        Page_Invert_Rect(u8g2, x_offset, y_offset, 128, 64);
+    }
+}
+
+/**
+ * @brief 响铃页面的事件处理函数
+ * @details 任意按键或旋转都停止响铃并返回主页面。
+ * @param[in] page 指向页面基类的指针 (未使用)
+ * @param[in] u8g2 指向u8g2实例的指针 (未使用)
+ * @param[in] event 指向输入事件数据的指针 (未使用)
+ * @return 无
+ */
+static void Page_Alarm_Ring_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+{
+    app_alarm_dismiss();
+    Page_Manager_Go_Home();
+}
@@ -0,0 +1,168 @@
+/**
+ * @file      page_ambient.c
+ * @brief     低功耗时钟页面实现文件
+ * @details   自动熄屏超时后显示的极简表盘：只有 "HH:MM"，由主循环以最低对比度显示。
+ *            页面只在分钟变化时失效，其余时间没有任何绘制和I2C传输，主循环在两次 SQW 唤醒之间处于停止模式。
+ *            每分钟重绘时把表盘移到下一个位置，长时间常亮也不会烧屏。本页面不处理输入，
+ *            任意输入由主循环用于唤醒并返回主页面。
+ *            整帧模式下进入时把显示器切换为 U8G2_PROFILE_BAND：只扫描数字所在的 4 页，降低预充电和 VCOMH，
+ *            每帧只发送这 4 页；纵向的防烧屏偏移改由显示偏移完成，显存中的数字只左右移动。退出时恢复 U8G2_PROFILE_FULL。
+ * @author    SandOcean
+ * @date      2025-09-28
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_display.h"
+#include "app_glyph_cache.h"
+#include "app_fmt.h"
+#include "app_settings.h"
+#include "DS3231.h"
+#include "u8g2_stm32_hal.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define AMBIENT_BASELINE_Y 44 ///< 默认位置下时间的基线Y坐标 (字高24，上下各留约20行)
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 低功耗时钟页面的私有数据结构体
+ */
+typedef struct
+{
+    char time_str[6]; ///< 格式化的时间字符串 "HH:MM"
+    uint8_t hour;     ///< 上一次生成字符串时的小时
+    uint8_t minute;   ///< 上一次生成字符串时的分钟
+    bool valid;       ///< 上面的字段是否有效
+    bool band;        ///< 显示器处于 U8G2_PROFILE_BAND，纵向偏移由显示器完成
+} Page_Ambient_Data;
+
+/**
+ * @brief 表盘相对默认位置的偏移
+ */
+typedef struct
+{
+    int8_t x; ///< X方向偏移 (像素)
+    int8_t y; ///< Y方向偏移 (像素)
+} Ambient_Shift_t;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Page_Ambient_Enter(const Page_Base *page);
+static void Page_Ambient_Exit(const Page_Base *page);
+static void Page_Ambient_Loop(const Page_Base *page);
+static void Page_Ambient_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+
+/* Private variables ---------------------------------------------------------*/
+PAGE_DATA_CHECK(Page_Ambient_Data); ///< 数据由页面管理器在进入时分配 (Page_Data)
+
+/**
+ * @brief 防烧屏的表盘位置序列，按分钟依次使用
+ * @details 表盘只有一行数字，上下左右都有大片空白，移动范围比主页面大得多。
+ */
+static const Ambient_Shift_t ambient_shifts[] = {
+    {0, 0}, {12, -8}, {-14, 6}, {6, 12}, {-8, -14}, {16, 4}, {-16, -4}, {-4, 10}, {10, -12}, {-10, 14},
+};
+
+/**
+ * @brief 取当前分钟的表盘偏移
+ * @param[in] data 页面私有数据
+ * @return const Ambient_Shift_t* 偏移
+ */
+static const Ambient_Shift_t *Ambient_Shift(const Page_Ambient_Data *data)
+{
+    return &ambient_shifts[data->minute % (sizeof(ambient_shifts) / sizeof(ambient_shifts[0]))];
+}
+
+/* Public variables ----------------------------------------------------------*/
+/**
+ * @brief 低功耗时钟页面的全局实例
+ */
+const Page_Base g_page_ambient = {
+    .enter = Page_Ambient_Enter,
+    .exit = Page_Ambient_Exit,
+    .loop = Page_Ambient_Loop,
+    .draw = Page_Ambient_Draw,
+    .action = NULL, // 输入由主循环用于唤醒，不会到达本页面
+    .page_name = "ambient",
+    .id = PAGE_ID_AMBIENT};
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 低功耗时钟页面进入函数
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Ambient_Enter(const Page_Base *page)
+{
+    Page_Ambient_Data *data = Page_Data(page);
+
+    data->valid = false;
+    data->band = false;
+    Page_Ambient_Loop(page); // 立即生成时间字符串
+}
+
+/**
+ * @brief 低功耗时钟页面退出函数
+ * @details 恢复扫描全部行，下一个页面的第一帧随之发送范围之外的页。
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Ambient_Exit(const Page_Base *page)
+{
+    Page_Ambient_Data *data = Page_Data(page);
+
+    if (data->band)
+    {
+        u8g2_stm32_SetProfile(U8G2_PROFILE_FULL, 0);
+        data->band = false;
+    }
+}
+
+/**
+ * @brief 低功耗时钟页面的逻辑循环函数
+ * @details 只比较缓存时间的时和分，分钟变化时整屏失效 (显存比较后只发送新旧位置所在的页)。
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Ambient_Loop(const Page_Base *page)
+{
+    Page_Ambient_Data *data = Page_Data(page);
+    Time_t now;
+
+    DS3231_DST_GetCachedTime(&now, g_app_settings.dst_enabled);
+    if (data->valid && now.hour == data->hour && now.minute == data->minute)
+    {
+        return;
+    }
+
+    data->hour = now.hour;
+    data->minute = now.minute;
+    data->valid = true;
+    data->band = (u8g2_stm32_SetProfile(U8G2_PROFILE_BAND, Ambient_Shift(data)->y) == HAL_OK);
+    char *p = fmt_u2(data->time_str, now.hour);
+    p = fmt_char(p, ':');
+    fmt_u2(p, now.minute);
+    Page_Invalidate(page);
+}
+
+/**
+ * @brief 低功耗时钟页面的绘制函数
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+static void Page_Ambient_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    Page_Ambient_Data *data = Page_Data(page);
+    const Ambient_Shift_t *shift = Ambient_Shift(data);
+    int16_t y = AMBIENT_BASELINE_Y + (data->band ? 0 : shift->y) + y_offset;
+
+    u8g2_SetFont(u8g2, CLOCK_FONT);
+    if (Page_Strip_Text_Visible(u8g2, y))
+    {
+        int16_t x = (128 - (int16_t)Glyph_Cache_GetStrWidth(u8g2, data->time_str)) / 2;
+        Glyph_Cache_DrawStr(u8g2, x + shift->x + x_offset, y, data->time_str);
+    }
+}
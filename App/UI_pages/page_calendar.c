@@ -0,0 +1,403 @@
+/**
+ * @file      page_calendar.c
+ * @brief     月历页面实现文件
+ * @details   在主页面向左旋转编码器进入。翻到一个月时只计算一次：1日的星期由
+ *            days-from-civil 的天数直接取模得到 (不含循环)，再按它把该月的日期填入 6x7 的表格，
+ *            每格一个字节 (日期和"今天"标志)。之后每帧的绘制只按表格逐格用字形缓存写入日期数字，
+ *            翻月的滚动动画中两个月的表格都已生成，动画的每一帧也只是按偏移重新拷贝这些字形；
+ *            启用离屏画布 (ui_canvas.h) 时两个月在翻月时画到画布上一次，每一帧只复制表格区域的视窗。
+ *            旋转编码器翻月，新的月份从下方 (下一月) 或上方 (上一月) 滚入；
+ *            按下编码器回到本月，返回键或确认键返回主页面。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_display.h"
+#include "app_settings.h"
+#include "app_glyph_cache.h"
+#include "app_anim.h"
+#include "app_fmt.h"
+#include "ui_canvas.h"
+#include "DS3231.h"
+#include "input.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define CAL_HEADER_Y   8    ///< 年月标题的基线Y坐标
+#define CAL_NAMES_Y    16   ///< 星期名称行的基线Y坐标
+#define CAL_GRID_X0    1    ///< 表格左端的X坐标
+#define CAL_GRID_Y0    18   ///< 表格顶端的Y坐标
+#define CAL_ROWS       6    ///< 表格的行数 (一个月最多跨6周)
+#define CAL_COLS       7    ///< 表格的列数 (周一到周日)
+#define CAL_CELL_W     18   ///< 每格的宽度
+#define CAL_ROW_H      7    ///< 每行的高度
+#define CAL_BASELINE   6    ///< 日期数字的基线相对行顶端的偏移
+#define CAL_GRID_H     (CAL_ROWS * CAL_ROW_H) ///< 表格的高度
+#define CAL_SCROLL_MS  200  ///< 翻月滚动动画的时长 (ms)
+#define CAL_YEAR_MIN   TIME_EPOCH_YEAR ///< 可翻到的最早年份
+#define CAL_YEAR_MAX   2099 ///< 可翻到的最晚年份 (DS3231 的范围)
+#define CAL_CELL_DAY   0x1F ///< 表格一格中日期所占的位，0 为空格
+#define CAL_CELL_TODAY 0x80 ///< 表格一格中"今天"的标志
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 一个月的表格
+ */
+typedef struct
+{
+    uint16_t year;                          ///< 年份
+    uint8_t month;                          ///< 月份 (1-12)
+    uint8_t cells[CAL_ROWS * CAL_COLS];     ///< 按行排列的各格 (CAL_CELL_DAY | CAL_CELL_TODAY)
+} Cal_Month_t;
+
+/**
+ * @brief 月历页面的私有数据结构体
+ */
+typedef struct
+{
+    int16_t scroll;     ///< 显示中的表格相对最终位置的Y偏移，翻月时由补间动画驱动到0
+    int8_t dir;         ///< 最近一次翻月的方向 (1 为下一月，-1 为上一月)
+    uint8_t shown;      ///< 显示中的表格在 cal_months 中的下标，另一项为滚动中离开的月份
+    uint8_t gen;        ///< 表格每次重新生成时加一，作为离屏画布的键值
+    uint16_t today_year; ///< 生成表格时的今天
+    uint8_t today_month;
+    uint8_t today_day;
+} Page_Calendar_Data;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Page_Calendar_Enter(const Page_Base *page);
+static void Page_Calendar_Loop(const Page_Base *page);
+static void Page_Calendar_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_Calendar_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static void Calendar_Build(Cal_Month_t *m, uint16_t year, uint8_t month, const Page_Calendar_Data *data);
+static void Calendar_Show(const Page_Base *page, uint16_t year, uint8_t month, int8_t dir);
+static void Calendar_Draw_Grid(const Cal_Month_t *m, u8g2_t *u8g2, int16_t x_offset, int16_t top);
+static void Calendar_Draw_Canvas(u8g2_t *u8g2, int16_t top, const void *ctx);
+static bool Calendar_Draw_Scroll(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t top);
+
+/* Private variables ---------------------------------------------------------*/
+PAGE_DATA_CHECK(Page_Calendar_Data); ///< 数据由页面管理器在进入时分配 (Page_Data)
+
+/**
+ * @brief 显示中和滚动中离开的两个月的表格
+ * @details 两个表格共约100字节，放不进页面私有数据区，只有一个月历页面，放在这里。
+ */
+static Cal_Month_t cal_months[2];
+
+///< 星期名称，周一在第0列，与 Time_t 的 week 一致
+static const char *const cal_week_names[CAL_COLS] = {"Mo", "Tu", "We", "Th", "Fr", "Sa", "Su"};
+
+/* Public variables ----------------------------------------------------------*/
+/**
+ * @brief 月历页面的全局实例
+ */
+const Page_Base g_page_calendar = {
+    .enter = Page_Calendar_Enter,
+    .exit = NULL,
+    .loop = Page_Calendar_Loop,
+    .draw = Page_Calendar_Draw,
+    .action = Page_Calendar_Action,
+    .page_name = "Calendar",
+    .id = PAGE_ID_CALENDAR};
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 生成一个月的表格
+ * @details 1日的星期由纪元起的天数取模得到，之后各日期依次排在它后面，不需要逐日推算星期。
+ * @param[out] m 表格
+ * @param[in] year 年份
+ * @param[in] month 月份 (1-12)
+ * @param[in] data 页面数据 (今天的日期)
+ * @return 无
+ */
+static void Calendar_Build(Cal_Month_t *m, uint16_t year, uint8_t month, const Page_Calendar_Data *data)
+{
+    uint8_t first = (uint8_t)(Time_Weekday_From_Days(Time_Days_From_Civil(year, month, 1)) - 1);
+    uint8_t days = Time_Days_In_Month(year, month);
+
+    m->year = year;
+    m->month = month;
+    memset(m->cells, 0, sizeof(m->cells));
+    for (uint8_t d = 1; d <= days; d++)
+    {
+        m->cells[first + d - 1] = d;
+    }
+    if (data->today_year == year && data->today_month == month)
+    {
+        m->cells[first + data->today_day - 1] |= CAL_CELL_TODAY;
+    }
+}
+
+/**
+ * @brief 翻到指定的月份
+ * @param[in] page 指向页面基类的指针
+ * @param[in] year 年份
+ * @param[in] month 月份 (1-12)
+ * @param[in] dir 滚入的方向 (1 从下方，-1 从上方，0 不滚动)
+ * @return 无
+ */
+static void Calendar_Show(const Page_Base *page, uint16_t year, uint8_t month, int8_t dir)
+{
+    Page_Calendar_Data *data = Page_Data(page);
+
+    // 动画进行中再次翻月时，正在离开的月份直接换成刚才显示的月份
+    data->shown ^= 1;
+    Calendar_Build(&cal_months[data->shown], year, month, data);
+    data->gen++;
+    data->dir = dir;
+    data->scroll = (int16_t)(dir * CAL_GRID_H);
+    if (dir != 0)
+    {
+        Anim_Tween_Start(&data->scroll, 0, CAL_SCROLL_MS, ANIM_EASE_OUT_CUBIC);
+    }
+    Page_Invalidate(page);
+}
+
+/**
+ * @brief 按表格绘制一个月的日期
+ * @param[in] m 表格
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset X方向偏移
+ * @param[in] top 表格顶端的Y坐标 (屏幕坐标)
+ * @return 无
+ */
+static void Calendar_Draw_Grid(const Cal_Month_t *m, u8g2_t *u8g2, int16_t x_offset, int16_t top)
+{
+    char buf[3];
+
+    for (uint8_t r = 0; r < CAL_ROWS; r++)
+    {
+        int16_t row_y = (int16_t)(top + r * CAL_ROW_H);
+        if (!Page_Strip_Visible(row_y, CAL_ROW_H))
+        {
+            continue;
+        }
+        for (uint8_t c = 0; c < CAL_COLS; c++)
+        {
+            uint8_t cell = m->cells[r * CAL_COLS + c];
+            int16_t cell_x = (int16_t)(CAL_GRID_X0 + c * CAL_CELL_W + x_offset);
+            if ((cell & CAL_CELL_DAY) == 0)
+            {
+                continue;
+            }
+            fmt_uint(buf, cell & CAL_CELL_DAY, 1);
+            Glyph_Cache_DrawStr(u8g2, cell_x + (CAL_CELL_W - (int16_t)Glyph_Cache_GetStrWidth(u8g2, buf)) / 2,
+                                row_y + CAL_BASELINE, buf);
+            if (cell & CAL_CELL_TODAY)
+            {
+                Page_Invert_Rect(u8g2, cell_x + 2, row_y, CAL_CELL_W - 4, CAL_ROW_H);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 在离屏画布上绘制滚动中的两个月
+ * @details 两个表格上下相接：下一月从下方滚入时上方为离开的月份，上一月从上方滚入时上方为新的月份。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] top 画布第0行的Y坐标
+ * @param[in] ctx 页面实例
+ * @return 无
+ */
+static void Calendar_Draw_Canvas(u8g2_t *u8g2, int16_t top, const void *ctx)
+{
+    const Page_Calendar_Data *data = Page_Data((const Page_Base *)ctx);
+    const Cal_Month_t *shown = &cal_months[data->shown];
+    const Cal_Month_t *leaving = &cal_months[data->shown ^ 1];
+
+    u8g2_SetFont(u8g2, CALENDAR_FONT);
+    Calendar_Draw_Grid((data->dir > 0) ? leaving : shown, u8g2, 0, top);
+    Calendar_Draw_Grid((data->dir > 0) ? shown : leaving, u8g2, 0, top + CAL_GRID_H);
+}
+
+/**
+ * @brief 用离屏画布绘制滚动中的表格
+ * @details 翻月时两个月的表格只绘制一次，动画的每一帧只按滚动偏移把表格区域的视窗复制到显存。
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset X方向偏移
+ * @param[in] top 表格顶端的Y坐标 (屏幕坐标)
+ * @return bool 已绘制返回 true；画布不可用时返回 false，由调用者逐帧绘制两个表格
+ */
+static bool Calendar_Draw_Scroll(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t top)
+{
+    Page_Calendar_Data *data = Page_Data(page);
+
+    if (!UI_Canvas_Ready(page, data->gen) &&
+        !UI_Canvas_Render(u8g2, page, data->gen, 2 * CAL_GRID_H, Calendar_Draw_Canvas, page))
+    {
+        return false;
+    }
+    UI_Canvas_Blit(u8g2, x_offset, top, CAL_GRID_H,
+                   (int16_t)((data->dir > 0) ? CAL_GRID_H - data->scroll : -data->scroll));
+    return true;
+}
+
+/**
+ * @brief 月历页面进入函数
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Calendar_Enter(const Page_Base *page)
+{
+    Page_Calendar_Data *data = Page_Data(page);
+    Time_t now;
+
+    DS3231_DST_GetCachedTime(&now, g_app_settings.dst_enabled);
+    data->today_year = now.year;
+    data->today_month = now.month;
+    data->today_day = now.day;
+    Calendar_Show(page, now.year, now.month, 0);
+}
+
+/**
+ * @brief 月历页面的逻辑循环函数
+ * @details 过了零点时重新生成表格，"今天"的标记移到新的日期。
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Calendar_Loop(const Page_Base *page)
+{
+    Page_Calendar_Data *data = Page_Data(page);
+    Time_t now;
+
+    DS3231_DST_GetCachedTime(&now, g_app_settings.dst_enabled);
+    if (now.day == data->today_day && now.month == data->today_month && now.year == data->today_year)
+    {
+        return;
+    }
+    data->today_year = now.year;
+    data->today_month = now.month;
+    data->today_day = now.day;
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        if (cal_months[i].month != 0)
+        {
+            Calendar_Build(&cal_months[i], cal_months[i].year, cal_months[i].month, data);
+        }
+    }
+    data->gen++;
+    Page_Invalidate(page);
+}
+
+/**
+ * @brief 月历页面的绘制函数
+ * @details 滚动中两个月的表格都画在表格区域内 (与当前裁剪窗口取交集)，标题和星期名称不动。
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+static void Page_Calendar_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    Page_Calendar_Data *data = Page_Data(page);
+    const Cal_Month_t *m = &cal_months[data->shown];
+    char buf[8];
+    char *p;
+
+    u8g2_SetFont(u8g2, DATE_TEMP_FONT);
+    if (Page_Strip_Text_Visible(u8g2, CAL_HEADER_Y + y_offset))
+    {
+        p = fmt_u4(buf, m->year);
+        p = fmt_char(p, '-');
+        fmt_u2(p, m->month);
+        u8g2_DrawStr(u8g2, (128 - Page_Str_Width(u8g2, buf)) / 2 + x_offset, CAL_HEADER_Y + y_offset, buf);
+    }
+
+    u8g2_SetFont(u8g2, CALENDAR_FONT);
+    if (Page_Strip_Text_Visible(u8g2, CAL_NAMES_Y + y_offset))
+    {
+        for (uint8_t c = 0; c < CAL_COLS; c++)
+        {
+            int16_t x = (int16_t)(CAL_GRID_X0 + c * CAL_CELL_W + (CAL_CELL_W - Page_Str_Width(u8g2, cal_week_names[c])) / 2);
+            u8g2_DrawStr(u8g2, x + x_offset, CAL_NAMES_Y + y_offset, cal_week_names[c]);
+        }
+    }
+
+    int16_t top = CAL_GRID_Y0 + y_offset;
+    if (data->scroll == 0)
+    {
+        Calendar_Draw_Grid(m, u8g2, x_offset, top);
+        return;
+    }
+
+    if (Calendar_Draw_Scroll(page, u8g2, x_offset, top))
+    {
+        return;
+    }
+
+    // 滚动中的行不能画到星期名称上，与当前的裁剪窗口 (局部重绘) 取交集
+    u8g2_uint_t saved_x0 = u8g2->clip_x0;
+    u8g2_uint_t saved_y0 = u8g2->clip_y0;
+    u8g2_uint_t saved_x1 = u8g2->clip_x1;
+    u8g2_uint_t saved_y1 = u8g2->clip_y1;
+    int32_t y0 = (top > (int32_t)saved_y0) ? top : (int32_t)saved_y0;
+    int32_t y1 = (top + CAL_GRID_H < (int32_t)saved_y1) ? top + CAL_GRID_H : (int32_t)saved_y1;
+    if (y0 < 0)
+    {
+        y0 = 0;
+    }
+    if (y1 <= y0)
+    {
+        return;
+    }
+    u8g2_SetClipWindow(u8g2, saved_x0, (u8g2_uint_t)y0, saved_x1, (u8g2_uint_t)y1);
+    Calendar_Draw_Grid(m, u8g2, x_offset, top + data->scroll);
+    Calendar_Draw_Grid(&cal_months[data->shown ^ 1], u8g2, x_offset, top + data->scroll - data->dir * CAL_GRID_H);
+    u8g2_SetClipWindow(u8g2, saved_x0, saved_y0, saved_x1, saved_y1);
+}
+
+/**
+ * @brief 月历页面的事件处理函数
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针 (未使用)
+ * @param[in] event 指向输入事件数据的指针
+ * @return 无
+ */
+static void Page_Calendar_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+{
+    Page_Calendar_Data *data = Page_Data(page);
+    const Cal_Month_t *m = &cal_months[data->shown];
+    int32_t index = (int32_t)m->year * 12 + (m->month - 1);
+
+    switch (event->event)
+    {
+    case INPUT_EVENT_ENCODER:
+    {
+        // 一次转动多格时按格数翻月，动画只滚动一次
+        int32_t target = index + event->value;
+        if (target < (int32_t)CAL_YEAR_MIN * 12)
+        {
+            target = (int32_t)CAL_YEAR_MIN * 12;
+        }
+        if (target > (int32_t)CAL_YEAR_MAX * 12 + 11)
+        {
+            target = (int32_t)CAL_YEAR_MAX * 12 + 11;
+        }
+        if (target != index)
+        {
+            Calendar_Show(page, (uint16_t)(target / 12), (uint8_t)(target % 12 + 1), (target > index) ? 1 : -1);
+        }
+        break;
+    }
+    case INPUT_EVENT_ENCODER_PRESSED:
+    {
+        int32_t today = (int32_t)data->today_year * 12 + (data->today_month - 1);
+        if (today != index)
+        {
+            Calendar_Show(page, data->today_year, data->today_month, (today > index) ? 1 : -1);
+        }
+        break;
+    }
+    case INPUT_EVENT_BACK_PRESSED:
+    case INPUT_EVENT_COMFIRM_PRESSED:
+        Go_Back_Page();
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,240 @@
+/**
+ * @file      page_countdown.c
+ * @brief     倒计时页面实现文件
+ * @details   从主菜单进入，倒计时到期时由主循环切换到本页面 (清空页面堆栈)。
+ *            大号数字与秒表相同为 "MM:SS.cc"，由 UI_Digits 只使变化的字符失效。
+ *            未开始时旋转编码器调整下划线所在的分或秒，编码器按键在分和秒之间切换，确认键开始；
+ *            运行时确认键暂停，暂停时确认键继续、编码器按键清除。返回键离开页面，倒计时在后台继续。
+ *            到期后每 500ms 整屏反色一次，任意按键停止提示并回到设定的时间。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_display.h"
+#include "app_i18n.h"
+#include "app_chrono.h"
+#include "app_glyph_cache.h"
+#include "ui_digits.h"
+#include "input.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define CD_TITLE_Y 12    ///< 标题的基线Y坐标
+#define CD_DIGITS_Y 44   ///< 大号数字的基线Y坐标
+#define CD_DIGITS_TOP 16 ///< 大号数字的失效区域顶端 (页对齐)
+#define CD_DIGITS_H 32   ///< 大号数字的失效区域高度 (包括下划线)
+#define CD_CURSOR_Y 46   ///< 下划线的Y坐标
+#define CD_FLASH_MS 500  ///< 到期提示反色闪烁的半周期
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 倒计时页面的私有数据结构体
+ */
+typedef struct
+{
+    UI_Digits_t digits;  ///< 大号数字
+    uint8_t state;       ///< 上一次循环时的倒计时状态 (App_Countdown_State_e)
+    uint8_t field;       ///< 未开始时编辑的字段，0 为分，1 为秒
+    bool inverted;       ///< 到期提示当前是否反色
+    uint32_t ring_start; ///< 开始提示的时间戳，闪烁以此为起点
+} Page_Countdown_Data;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Page_Countdown_Enter(const Page_Base *page);
+static void Page_Countdown_Loop(const Page_Base *page);
+static void Page_Countdown_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_Countdown_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static void Countdown_Adjust(const Page_Countdown_Data *data, int16_t delta);
+
+/* Private variables ---------------------------------------------------------*/
+PAGE_DATA_CHECK(Page_Countdown_Data); ///< 数据由页面管理器在进入时分配 (Page_Data)
+
+/* Public variables ----------------------------------------------------------*/
+/**
+ * @brief 倒计时页面的全局实例
+ */
+const Page_Base g_page_countdown = {
+    .enter = Page_Countdown_Enter,
+    .exit = NULL,
+    .loop = Page_Countdown_Loop,
+    .draw = Page_Countdown_Draw,
+    .action = Page_Countdown_Action,
+    .page_name = "countdown",
+    .id = PAGE_ID_COUNTDOWN};
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 调整设定时间中正在编辑的字段
+ * @details 分在 0~99 之间、秒在 0~59 之间循环，不向另一个字段进位。
+ * @param[in] data 页面数据
+ * @param[in] delta 编码器增量
+ * @return 无
+ */
+static void Countdown_Adjust(const Page_Countdown_Data *data, int16_t delta)
+{
+    int32_t total = (int32_t)app_countdown_duration();
+    int32_t min = total / 60;
+    int32_t sec = total % 60;
+
+    if (data->field == 0)
+    {
+        min = ((min + delta) % 100 + 100) % 100;
+    }
+    else
+    {
+        sec = ((sec + delta) % 60 + 60) % 60;
+    }
+    app_countdown_set((uint32_t)(min * 60 + sec));
+}
+
+/**
+ * @brief 倒计时页面进入函数
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Countdown_Enter(const Page_Base *page)
+{
+    Page_Countdown_Data *data = Page_Data(page);
+
+    UI_Digits_Init(&data->digits, CD_DIGITS_TOP, CD_DIGITS_H);
+    data->state = (uint8_t)app_countdown_state();
+    data->field = 0;
+    data->inverted = false;
+    data->ring_start = Page_Now();
+    Page_Countdown_Loop(page);
+}
+
+/**
+ * @brief 倒计时页面的逻辑循环函数
+ * @details 状态变化 (包括到期和提示超时) 时整屏失效；其余时间只使变化的数字失效，
+ *          提示期间闪烁相位变化时整屏失效。
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Countdown_Loop(const Page_Base *page)
+{
+    Page_Countdown_Data *data = Page_Data(page);
+    uint8_t state = (uint8_t)app_countdown_state();
+    char text[UI_DIGITS_MAX + 1];
+
+    if (state != data->state)
+    {
+        data->state = state;
+        data->inverted = false;
+        data->ring_start = Page_Now();
+        Page_Invalidate(page);
+    }
+
+    app_chrono_format(text, app_countdown_remaining());
+    UI_Digits_Set(&data->digits, page, text);
+
+    if (state == APP_COUNTDOWN_RINGING)
+    {
+        bool inverted = ((Page_Now() - data->ring_start) / CD_FLASH_MS) & 1U;
+        if (inverted != data->inverted)
+        {
+            data->inverted = inverted;
+            Page_Invalidate(page);
+        }
+    }
+}
+
+/**
+ * @brief 倒计时页面的绘制函数
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+static void Page_Countdown_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    Page_Countdown_Data *data = Page_Data(page);
+    App_Str_t title = (data->state == APP_COUNTDOWN_RINGING) ? STR_MSG_TIME_UP : STR_MENU_TIMER;
+
+    u8g2_SetFont(u8g2, app_i18n_font(MENU_FONT));
+    if (Page_Strip_Text_Visible(u8g2, CD_TITLE_Y + y_offset))
+    {
+        app_i18n_draw(u8g2, 2 + x_offset, CD_TITLE_Y + y_offset, app_str(title));
+    }
+
+    u8g2_SetFont(u8g2, CLOCK_FONT);
+    if (Page_Strip_Visible(CD_DIGITS_TOP + y_offset, CD_DIGITS_H))
+    {
+        int16_t x = (128 - (int16_t)Glyph_Cache_GetStrWidth(u8g2, data->digits.text)) / 2;
+        UI_Digits_Draw(&data->digits, page, u8g2, x, CD_DIGITS_Y, x_offset, y_offset);
+
+        if (data->state == APP_COUNTDOWN_IDLE && data->digits.drawn >= 5)
+        {
+            // "MM:SS.cc" 中分为第0、1个字符，秒为第3、4个字符
+            uint8_t i = data->field ? 3 : 0;
+            u8g2_DrawBox(u8g2, data->digits.x[i] + x_offset, CD_CURSOR_Y + y_offset,
+                         data->digits.x[i + 2] - data->digits.x[i] - 1, 2);
+        }
+    }
+
+    if (data->inverted)
+    {
+        Page_Invert_Rect(u8g2, x_offset, y_offset, 128, 64);
+    }
+}
+
+/**
+ * @brief 倒计时页面的事件处理函数
+ * @details 提示期间任意按键或旋转都停止提示。
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针 (未使用)
+ * @param[in] event 指向输入事件数据的指针
+ * @return 无
+ */
+static void Page_Countdown_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+{
+    Page_Countdown_Data *data = Page_Data(page);
+    App_Countdown_State_e state = app_countdown_state();
+
+    if (state == APP_COUNTDOWN_RINGING)
+    {
+        app_countdown_reset();
+        Page_Countdown_Loop(page);
+        return;
+    }
+
+    switch (event->event)
+    {
+    case INPUT_EVENT_ENCODER:
+        if (state == APP_COUNTDOWN_IDLE)
+        {
+            Countdown_Adjust(data, event->value);
+        }
+        break;
+    case INPUT_EVENT_ENCODER_PRESSED:
+        if (state == APP_COUNTDOWN_IDLE)
+        {
+            data->field ^= 1U;
+            Page_Invalidate_Rect(page, 0, CD_DIGITS_TOP, 128, CD_DIGITS_H);
+        }
+        else if (state == APP_COUNTDOWN_PAUSED)
+        {
+            app_countdown_reset();
+        }
+        break;
+    case INPUT_EVENT_COMFIRM_PRESSED:
+        if (state == APP_COUNTDOWN_RUNNING)
+        {
+            app_countdown_pause();
+        }
+        else
+        {
+            app_countdown_start();
+        }
+        break;
+    case INPUT_EVENT_BACK_PRESSED:
+        Go_Back_Page();
+        return;
+    default:
+        break;
+    }
+    Page_Countdown_Loop(page);
+}
@@ -0,0 +1,512 @@
+/**
+ * @file      page_diag.c
+ * @brief     诊断界面实现文件
+ * @details   本文件定义了隐藏的诊断页面，显示性能分析模块的实时计数：
+ *            帧率、帧耗时、各I2C设备的总线利用率、丢弃的输入事件、主循环频率、栈和堆的使用量和EEPROM写入次数。
+ *            旋转编码器切换到I2C详情视图：每个设备一行，显示利用率、流量和启动以来的
+ *            NACK/超时/轮询重试/其他错误次数，以及按键扫描中断的最长响应延迟。再转一格为卡顿视图：超出预算的帧数、
+ *            最近一次的帧序号和忙碌时间，以及以各原因 (绘制、刷新、I2C等待、传感器、EEPROM、中断、其他) 耗时最多的帧数，
+ *            最后一行为启动以来输入到画面的延迟 (P50/P95/P99)。
+ *            再转一格为功耗视图：启动以来运行 (72MHz/降频)、睡眠、停止模式
+ *            和屏幕亮/暗/熄各自所占的时间比例、I2C忙碌的累计时间以及按这些时间估算的每天耗电。
+ *            在主菜单中长按确认键打开 Info 即可进入。数据每秒更新一次，未编入性能分析模块时前三个视图只显示提示。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.4
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_display.h"
+#include "app_fmt.h"
+#include "app_power.h"
+#include "input.h"
+#include "profiler.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define DIAG_LINE_HEIGHT 10 ///< 行高 (DATE_TEMP_FONT)，64像素的屏幕正好显示6行
+#define DIAG_LINE_MAX    32 ///< 行缓冲区长度，屏幕一行21个字符，多出的部分为数值位数超出预期时的余量
+#define DIAG_POWER_MS    1000 ///< 功耗视图的重绘间隔 (ms)
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 诊断页面的视图
+ */
+typedef enum
+{
+    DIAG_VIEW_OVERVIEW = 0, ///< 总览
+    DIAG_VIEW_I2C,          ///< I2C详情
+    DIAG_VIEW_JANK,         ///< 卡顿归因
+    DIAG_VIEW_POWER,        ///< 功耗状态的累计时间
+    DIAG_VIEW_COUNT
+} Diag_View_e;
+
+/**
+ * @brief 诊断页面的私有数据结构体
+ */
+typedef struct
+{
+    uint32_t seq;   ///< 最近一次绘制时的统计窗口序号
+    uint32_t drawn; ///< 功耗视图最近一次重绘的时刻
+    uint8_t view; ///< 当前视图 (Diag_View_e)
+} Page_Diag_Data_t;
+
+PAGE_DATA_CHECK(Page_Diag_Data_t); ///< 诊断页面的数据由页面管理器在进入时分配 (Page_Data)
+
+/* Private function prototypes -----------------------------------------------*/
+static void Page_Diag_Enter(const Page_Base *page);
+static void Page_Diag_Loop(const Page_Base *page);
+static void Page_Diag_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_Diag_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static char *fmt_hex2(char *dst, uint8_t value);
+static char *fmt_util(char *dst, const Profiler_I2C_Live_t *dev);
+static char *fmt_i2c(char *dst, const Profiler_Live_t *live, uint8_t index);
+static void Draw_Overview(u8g2_t *u8g2, const Profiler_Live_t *live, int16_t x, int16_t y);
+static void Draw_I2C(u8g2_t *u8g2, const Profiler_Live_t *live, int16_t x, int16_t y);
+static void Draw_Jank(u8g2_t *u8g2, const Profiler_Live_t *live, int16_t x, int16_t y);
+static char *fmt_pct(char *dst, uint32_t part, uint32_t total);
+static void Draw_Power(u8g2_t *u8g2, int16_t x, int16_t y);
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief 卡顿视图中各原因的简称
+ */
+static const char *const diag_jank_names[PROF_JANK_COUNT] = {
+    [PROF_JANK_DRAW] = "Draw", [PROF_JANK_FLUSH] = "Flush", [PROF_JANK_I2C] = "I2C",
+    [PROF_JANK_SENSOR] = "Sens", [PROF_JANK_EEPROM] = "EE", [PROF_JANK_ISR] = "ISR",
+    [PROF_JANK_OTHER] = "Oth",
+};
+
+/** 编译期检查：卡顿视图按 2+2+3 个原因分三行显示，增减原因时需调整 Draw_Jank */
+typedef char diag_jank_check[(PROF_JANK_COUNT == 7) ? 1 : -1];
+
+/* Public variables ----------------------------------------------------------*/
+/**
+ * @brief 诊断页面的全局实例
+ */
+const Page_Base g_page_diag = {
+    .enter = Page_Diag_Enter,
+    .exit = NULL,
+    .loop = Page_Diag_Loop,
+    .draw = Page_Diag_Draw,
+    .action = Page_Diag_Action,
+    .page_name = "Diag",
+    .id = PAGE_ID_DIAG};
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 输出两位大写十六进制数
+ * @param[out] dst 输出缓冲区，至少3字节
+ * @param[in] value 数值
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+static char *fmt_hex2(char *dst, uint8_t value)
+{
+    static const char digits[] = "0123456789ABCDEF";
+
+    dst[0] = digits[value >> 4];
+    dst[1] = digits[value & 0x0F];
+    dst[2] = '\0';
+    return &dst[2];
+}
+
+/**
+ * @brief 输出一个I2C设备的总线利用率，格式为 "7位地址 百分比%"
+ * @param[out] dst 输出缓冲区
+ * @param[in] dev 设备统计
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+static char *fmt_util(char *dst, const Profiler_I2C_Live_t *dev)
+{
+    dst = fmt_hex2(dst, (uint8_t)(dev->addr >> 1));
+    dst = fmt_char(dst, ' ');
+    dst = fmt_uint(dst, (dev->util_pm + 5U) / 10U, 0);
+    return fmt_char(dst, '%');
+}
+
+/**
+ * @brief 输出一个I2C设备的总线利用率，格式为 " 7位地址 百分比%"
+ * @param[out] dst 输出缓冲区
+ * @param[in] live 实时统计
+ * @param[in] index 设备序号
+ * @return char* 指向输出末尾 '\0' 的指针，设备未登记时不输出
+ */
+static char *fmt_i2c(char *dst, const Profiler_Live_t *live, uint8_t index)
+{
+    if (index >= PROFILER_I2C_DEVICES || live->i2c[index].addr == 0)
+    {
+        *dst = '\0';
+        return dst;
+    }
+    dst = fmt_char(dst, ' ');
+    return fmt_util(dst, &live->i2c[index]);
+}
+
+/**
+ * @brief 绘制总览视图
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] live 实时统计
+ * @param[in] x 左边界
+ * @param[in] y 第一行的基线
+ * @return 无
+ */
+static void Draw_Overview(u8g2_t *u8g2, const Profiler_Live_t *live, int16_t x, int16_t y)
+{
+    char line[DIAG_LINE_MAX];
+    char *p;
+
+    /* 帧率、因总线忙放弃的帧数与主循环频率 (每秒) */
+    p = fmt_str(line, "FPS ");
+    p = fmt_uint(p, live->rate[PROF_CNT_FRAME], 0);
+    p = fmt_str(p, " Skp ");
+    p = fmt_uint(p, live->rate[PROF_CNT_FRAME_SKIP], 0);
+    p = fmt_str(p, " Lp ");
+    fmt_uint(p, live->rate[PROF_CNT_LOOP], 0);
+    u8g2_DrawStr(u8g2, x, y, line);
+    y += DIAG_LINE_HEIGHT;
+
+    /* Page_Manager_Loop 的平均/最长耗时 */
+    p = fmt_str(line, "Frame ");
+    p = fmt_uint(p, live->frame_avg_us, 0);
+    p = fmt_char(p, '/');
+    p = fmt_uint(p, live->frame_max_us, 0);
+    fmt_str(p, " us");
+    u8g2_DrawStr(u8g2, x, y, line);
+    y += DIAG_LINE_HEIGHT;
+
+    /* 各I2C设备的总线利用率，每行两个 */
+    for (uint8_t i = 0; i < PROFILER_I2C_DEVICES; i += 2)
+    {
+        p = fmt_str(line, "I2C");
+        p = fmt_i2c(p, live, i);
+        fmt_i2c(p, live, i + 1);
+        u8g2_DrawStr(u8g2, x, y, line);
+        y += DIAG_LINE_HEIGHT;
+    }
+
+    /* 丢弃的输入事件与EEPROM写入次数 (启动以来) */
+    p = fmt_str(line, "InDrop ");
+    p = fmt_uint(p, live->total[PROF_CNT_INPUT_DROP], 0);
+    p = fmt_str(p, " EEwr ");
+    fmt_uint(p, live->total[PROF_CNT_EEPROM_WRITE], 0);
+    u8g2_DrawStr(u8g2, x, y, line);
+    y += DIAG_LINE_HEIGHT;
+
+    /* 栈和堆的最大使用量 (字节) */
+    p = fmt_str(line, "Stk ");
+    p = fmt_uint(p, live->stack_used, 0);
+    p = fmt_char(p, '/');
+    p = fmt_uint(p, PROFILER_STACK_SIZE, 0);
+    p = fmt_str(p, " Hp ");
+    p = fmt_uint(p, live->heap_used, 0);
+    p = fmt_char(p, '/');
+    fmt_uint(p, live->heap_size, 0);
+    u8g2_DrawStr(u8g2, x, y, line);
+}
+
+/**
+ * @brief 绘制I2C详情视图
+ * @details 每个设备一行："地址 利用率 字节每秒 NACK/超时/重试/错误"，失败次数为启动以来的累计值；
+ *          最后一行为按键扫描中断的响应延迟。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] live 实时统计
+ * @param[in] x 左边界
+ * @param[in] y 第一行的基线
+ * @return 无
+ */
+static void Draw_I2C(u8g2_t *u8g2, const Profiler_Live_t *live, int16_t x, int16_t y)
+{
+    char line[DIAG_LINE_MAX];
+    char *p;
+
+    u8g2_DrawStr(u8g2, x, y, "I2C use B/s N/T/R/E");
+    y += DIAG_LINE_HEIGHT;
+
+    for (uint8_t i = 0; i < PROFILER_I2C_DEVICES; i++)
+    {
+        const Profiler_I2C_Live_t *dev = &live->i2c[i];
+
+        if (dev->addr == 0)
+        {
+            break; // 设备按首次出现的顺序登记
+        }
+        p = fmt_util(line, dev);
+        p = fmt_char(p, ' ');
+        p = fmt_uint(p, dev->bytes, 0);
+        p = fmt_char(p, ' ');
+        p = fmt_uint(p, dev->nacks, 0);
+        p = fmt_char(p, '/');
+        p = fmt_uint(p, dev->timeouts, 0);
+        p = fmt_char(p, '/');
+        p = fmt_uint(p, dev->retries, 0);
+        p = fmt_char(p, '/');
+        fmt_uint(p, dev->errors, 0);
+        u8g2_DrawStr(u8g2, x, y, line);
+        y += DIAG_LINE_HEIGHT;
+    }
+
+    /* 按键扫描中断的最长响应延迟：上一秒/启动以来 */
+    p = fmt_str(line, "IRQ lat ");
+    p = fmt_uint(p, live->irq_lat_max_us, 0);
+    p = fmt_char(p, '/');
+    p = fmt_uint(p, live->irq_lat_worst_us, 0);
+    fmt_str(p, " us");
+    u8g2_DrawStr(u8g2, x, y, line);
+}
+
+/**
+ * @brief 绘制卡顿视图
+ * @details 第一行为启动以来超出预算的帧数，第二行为最近一次的忙碌时间 (ms) 和帧序号，
+ *          之后每行两到三个原因，数字为以该原因耗时最多的帧数；
+ *          最后一行为输入事件发生到响应的画面发送完成的延迟 P50/P95/P99 (ms)，没有记录时不显示。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] live 实时统计
+ * @param[in] x 左边界
+ * @param[in] y 第一行的基线
+ * @return 无
+ */
+static void Draw_Jank(u8g2_t *u8g2, const Profiler_Live_t *live, int16_t x, int16_t y)
+{
+    static const uint8_t rows[] = {2, 2, 3}; // 每行的原因数，合计 PROF_JANK_COUNT
+    char line[DIAG_LINE_MAX];
+    char *p;
+    uint8_t cause = 0;
+
+    p = fmt_str(line, "Jank ");
+    p = fmt_uint(p, live->jank_frames, 0);
+    p = fmt_str(p, " >");
+    p = fmt_uint(p, PROFILER_JANK_BUDGET_US / 1000U, 0);
+    fmt_str(p, "ms");
+    u8g2_DrawStr(u8g2, x, y, line);
+    y += DIAG_LINE_HEIGHT;
+
+    p = fmt_str(line, "Last ");
+    p = fmt_q1(p, (int32_t)((live->jank_last_us + 50U) / 100U));
+    p = fmt_str(p, "ms #");
+    fmt_uint(p, live->jank_last_frame, 0);
+    u8g2_DrawStr(u8g2, x, y, line);
+    y += DIAG_LINE_HEIGHT;
+
+    for (uint8_t r = 0; r < sizeof(rows); r++)
+    {
+        p = line;
+        for (uint8_t k = 0; k < rows[r]; k++, cause++)
+        {
+            if (k != 0)
+            {
+                p = fmt_char(p, ' ');
+            }
+            p = fmt_str(p, diag_jank_names[cause]);
+            p = fmt_char(p, ' ');
+            p = fmt_uint(p, live->jank_cause[cause], 0);
+        }
+        u8g2_DrawStr(u8g2, x, y, line);
+        y += DIAG_LINE_HEIGHT;
+    }
+
+    /* 输入到画面的延迟：P50/P95/P99 */
+    if (live->input_count != 0)
+    {
+        p = fmt_str(line, "Input ");
+        p = fmt_uint(p, live->input_p50_ms, 0);
+        p = fmt_char(p, '/');
+        p = fmt_uint(p, live->input_p95_ms, 0);
+        p = fmt_char(p, '/');
+        p = fmt_uint(p, live->input_p99_ms, 0);
+        fmt_str(p, "ms");
+        u8g2_DrawStr(u8g2, x, y, line);
+    }
+}
+
+/**
+ * @brief 输出百分比 (不含 '%')
+ * @param[out] dst 输出缓冲区
+ * @param[in] part 部分
+ * @param[in] total 总量，为0时输出0
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+static char *fmt_pct(char *dst, uint32_t part, uint32_t total)
+{
+    uint32_t pct = (total == 0) ? 0 : (uint32_t)(((uint64_t)part * 100U + total / 2U) / total);
+
+    return fmt_uint(dst, pct, 0);
+}
+
+/**
+ * @brief 绘制功耗视图
+ * @details 运行、睡眠和停止的比例以 MCU 的总时间为分母，屏幕三种状态的比例之和同样为100%。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 左边界
+ * @param[in] y 第一行的基线
+ * @return 无
+ */
+static void Draw_Power(u8g2_t *u8g2, int16_t x, int16_t y)
+{
+    uint32_t ms[POWER_RES_COUNT];
+    uint32_t total;
+    char line[DIAG_LINE_MAX];
+    char *p;
+
+    Power_Get_Residency(ms);
+    total = ms[POWER_RES_RUN_FAST] + ms[POWER_RES_RUN_SLOW] + ms[POWER_RES_SLEEP] + ms[POWER_RES_STOP];
+
+    /* 运行时间：72MHz/降频 */
+    p = fmt_str(line, "Run ");
+    p = fmt_pct(p, ms[POWER_RES_RUN_FAST], total);
+    p = fmt_str(p, "% Slow ");
+    p = fmt_pct(p, ms[POWER_RES_RUN_SLOW], total);
+    fmt_char(p, '%');
+    u8g2_DrawStr(u8g2, x, y, line);
+    y += DIAG_LINE_HEIGHT;
+
+    /* 低功耗模式 */
+    p = fmt_str(line, "Sleep ");
+    p = fmt_pct(p, ms[POWER_RES_SLEEP], total);
+    p = fmt_str(p, "% Stop ");
+    p = fmt_pct(p, ms[POWER_RES_STOP], total);
+    fmt_char(p, '%');
+    u8g2_DrawStr(u8g2, x, y, line);
+    y += DIAG_LINE_HEIGHT;
+
+    /* 屏幕：亮/暗/熄 */
+    p = fmt_str(line, "Disp ");
+    p = fmt_pct(p, ms[POWER_RES_DISPLAY_ON], total);
+    p = fmt_char(p, '/');
+    p = fmt_pct(p, ms[POWER_RES_DISPLAY_DIM], total);
+    p = fmt_char(p, '/');
+    p = fmt_pct(p, ms[POWER_RES_DISPLAY_OFF], total);
+    fmt_char(p, '%');
+    u8g2_DrawStr(u8g2, x, y, line);
+    y += DIAG_LINE_HEIGHT;
+
+    /* I2C总线忙碌的累计时间 */
+    p = fmt_str(line, "I2C ");
+    p = fmt_uint(p, ms[POWER_RES_I2C_BUSY], 0);
+    fmt_str(p, " ms");
+    u8g2_DrawStr(u8g2, x, y, line);
+    y += DIAG_LINE_HEIGHT;
+
+    /* 启动以来的总时间 (s) 与每天耗电的估算 */
+    p = fmt_str(line, "Up ");
+    p = fmt_uint(p, total / 1000U, 0);
+    fmt_str(p, " s");
+    u8g2_DrawStr(u8g2, x, y, line);
+    y += DIAG_LINE_HEIGHT;
+
+    p = fmt_str(line, "Est ");
+    p = fmt_q1(p, (int32_t)((Power_Estimate_uAh_Day() + 50U) / 100U));
+    fmt_str(p, " mAh/d");
+    u8g2_DrawStr(u8g2, x, y, line);
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 诊断页面进入函数
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Diag_Enter(const Page_Base *page)
+{
+    Page_Diag_Data_t *data = Page_Data(page);
+    data->seq = 0;
+    data->drawn = Page_Now();
+    data->view = DIAG_VIEW_OVERVIEW;
+}
+
+/**
+ * @brief 诊断页面循环函数
+ * @details 统计窗口结束后才重绘，每秒一次；功耗视图不依赖性能分析模块，按 DIAG_POWER_MS 重绘。
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Diag_Loop(const Page_Base *page)
+{
+    Page_Diag_Data_t *data = Page_Data(page);
+    Profiler_Live_t live;
+
+    if (data->view == DIAG_VIEW_POWER)
+    {
+        if (Page_Now() - data->drawn >= DIAG_POWER_MS)
+        {
+            data->drawn = Page_Now();
+            Page_Invalidate(page);
+        }
+        return;
+    }
+    if (Profiler_Get_Live(&live) && live.seq != data->seq)
+    {
+        data->seq = live.seq;
+        Page_Invalidate(page);
+    }
+}
+
+/**
+ * @brief 诊断页面绘制函数
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+static void Page_Diag_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    const Page_Diag_Data_t *data = Page_Data(page);
+    Profiler_Live_t live;
+    int16_t y = DIAG_LINE_HEIGHT - 1 + y_offset;
+
+    u8g2_SetFont(u8g2, DATE_TEMP_FONT);
+
+    if (data->view == DIAG_VIEW_POWER)
+    {
+        Draw_Power(u8g2, 0 + x_offset, y);
+        return;
+    }
+    if (!Profiler_Get_Live(&live))
+    {
+        u8g2_DrawStr(u8g2, 0 + x_offset, y, "Profiler off");
+        return;
+    }
+
+    if (data->view == DIAG_VIEW_I2C)
+    {
+        Draw_I2C(u8g2, &live, 0 + x_offset, y);
+    }
+    else if (data->view == DIAG_VIEW_JANK)
+    {
+        Draw_Jank(u8g2, &live, 0 + x_offset, y);
+    }
+    else
+    {
+        Draw_Overview(u8g2, &live, 0 + x_offset, y);
+    }
+}
+
+/**
+ * @brief 诊断页面事件处理函数
+ * @details 旋转编码器切换视图，任何按键返回。进入时按住的按键还会产生长按和连发事件，这些事件不处理。
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针 (未使用)
+ * @param[in] event 指向输入事件数据的指针
+ * @return 无
+ */
+static void Page_Diag_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+{
+    Page_Diag_Data_t *data = Page_Data(page);
+
+    switch (event->event)
+    {
+    case INPUT_EVENT_ENCODER:
+        data->view = (uint8_t)((data->view + 1U) % DIAG_VIEW_COUNT);
+        Page_Invalidate(page);
+        break;
+    case INPUT_EVENT_BACK_PRESSED:
+    case INPUT_EVENT_COMFIRM_PRESSED:
+    case INPUT_EVENT_ENCODER_PRESSED:
+        Go_Back_Page();
+        break;
+    default:
+        break;
+    }
+}
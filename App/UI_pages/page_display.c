@@ -1,18 +1,31 @@
 /**
  * @file      page_display.c
  * @brief     显示设置子菜单页面
- * @details   本文件定义了“显示”设置的子菜单，包含“语言”和“自动熄屏”选项，并实现了带动画的菜单交互。
+ * @details   本文件定义了“显示”设置的子菜单，包含“语言”、“自动熄屏”、“表盘”和“模式”选项，并实现了带动画的菜单交互。
+ *            “表盘”项不进入子页面，每次确认切换到下一个表盘 (ui_face)，项目文字显示当前的表盘名称。
+ *            “模式”项同样在本页切换显示模式 (正常/反色/夜间反色)，由亮度调度发送一条反色命令，画面不重绘。
+ *            “性能”项在本页切换性能配置 (省电/均衡/流畅，app_perf)，决定帧率上限、动画时长、采样间隔和降频前的保持时间。
  * @author    SandOcean
- * @date      2025-09-16
- * @version   1.0
+ * @date      2025-10-08
+ * @version   1.3
  * @copyright Copyright (c) 2025 SandOcean
  */
 
 #include "app_display.h"
+#include "app_i18n.h"
+#include "ui_list.h"
+#include "ui_face.h"
+#include "app_fmt.h"
+#include "app_settings.h"
+#include "app_perf.h"
 #include "input.h"
 
 /* Private defines -----------------------------------------------------------*/
-#define DISPLAY_MENU_ITEM_COUNT 2   ///< 菜单项数量
+#define DISPLAY_MENU_ITEM_COUNT 5   ///< 菜单项数量
+#define DISPLAY_MENU_VISIBLE_ROWS 3 ///< 同时显示的菜单项数量
+#define DISPLAY_MENU_FACE 2         ///< “表盘”项的索引
+#define DISPLAY_MENU_MODE 3         ///< “模式”项的索引
+#define DISPLAY_MENU_PERF 4         ///< “性能”项的索引
 #define DISPLAY_MENU_ITEM_HEIGHT 16 ///< 每个菜单项的像素高度
 #define DISPLAY_MENU_TOP_Y 8        ///< 菜单列表顶部的Y坐标
 #define DISPLAY_MENU_LEFT_X 5       ///< 菜单列表左侧的X坐标
@@ -20,104 +33,181 @@
 
 /* Private variables ---------------------------------------------------------*/
 ///< 菜单项文本数组
-static const char *menu_items[DISPLAY_MENU_ITEM_COUNT] = {
-    "Language",
-    "Auto-Off"};
+static const App_Str_t menu_items[DISPLAY_MENU_ITEM_COUNT] = {
+    STR_MENU_LANGUAGE,
+    STR_MENU_AUTO_OFF,
+    STR_MENU_FACE,
+    STR_MENU_MODE,
+    STR_MENU_PERF};
 
-/**
- * @brief 菜单动画状态枚举
- */
-typedef enum
-{
-    DISPLAY_MENU_STATE_IDLE,     ///< 空闲状态
-    DISPLAY_MENU_STATE_ANIMATING ///< 动画播放中状态
-} Display_Menu_State_e;
+///< 各显示模式的名称，按 Display_Mode_e 索引
+static const App_Str_t mode_names[DISPLAY_MODE_COUNT] = {
+    STR_MODE_NORMAL,
+    STR_MODE_INVERT,
+    STR_MODE_NIGHT};
+
+///< 菜单项图标，与 menu_items 一一对应
+static const UI_Icon_e menu_icons[DISPLAY_MENU_ITEM_COUNT] = {
+    UI_ICON_LANGUAGE,
+    UI_ICON_AUTO_OFF,
+    UI_ICON_CLOCK,
+    UI_ICON_DISPLAY,
+    UI_ICON_STOPWATCH};
+
+///< 各菜单项确认后进入的页面，与 menu_items 一一对应
+static const uint8_t menu_targets[DISPLAY_MENU_ITEM_COUNT] = {
+    PAGE_ID_LANGUAGE,
+    PAGE_ID_AUTO_OFF,
+    PAGE_ID_NONE,  // 在本页切换
+    PAGE_ID_NONE,
+    PAGE_ID_NONE};
 
 /**
  * @brief 显示设置页面的私有数据结构体
  */
 typedef struct
 {
-    int8_t selected_index;      ///< 当前选中的菜单项索引
-    Display_Menu_State_e state; ///< 菜单的动画状态
-    float anim_current_y;       ///< 高亮框当前的Y坐标 (用于动画插值)
-    int16_t anim_start_y;       ///< 高亮框动画的起始Y坐标
-    int16_t anim_target_y;      ///< 高亮框动画的目标Y坐标
-    uint32_t anim_start_time;   ///< 动画开始的系统时间
-    uint32_t anim_duration;     ///< 动画持续时间 (ms)
+    UI_List_t list;      ///< 菜单列表
+    char face_label[24]; ///< “表盘”项的文字 (含当前表盘名称)
+    char mode_label[24]; ///< “模式”项的文字 (含当前显示模式)
+    char perf_label[24]; ///< “性能”项的文字 (含当前性能配置)
 } Page_Display_Data_t;
 
-static Page_Display_Data_t g_page_display_data; ///< 显示设置页面的数据实例
+PAGE_DATA_CHECK(Page_Display_Data_t); ///< 显示设置页面的数据由页面管理器在进入时分配 (Page_Data)
 
 /* Private function prototypes -----------------------------------------------*/
-static void Page_Display_Enter(Page_Base *page);
-static void Page_Display_Loop(Page_Base *page);
-static void Page_Display_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
-static void Page_Display_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static void Page_Display_Enter(const Page_Base *page);
+static void Page_Display_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_Display_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static uint16_t Menu_Count(const void *ctx);
+static const char *Menu_Text(const void *ctx, uint16_t index);
+static UI_Icon_e Menu_Icon(const void *ctx, uint16_t index);
+static void Face_Label_Update(Page_Display_Data_t *data);
+static void Mode_Label_Update(Page_Display_Data_t *data);
+static void Perf_Label_Update(Page_Display_Data_t *data);
+
+///< 菜单列表的布局
+static const UI_List_Config_t menu_list = {
+    .x = DISPLAY_MENU_LEFT_X,
+    .y = DISPLAY_MENU_TOP_Y,
+    .w = DISPLAY_MENU_WIDTH,
+    .text_x = 22,
+    .icon_x = 7,
+    .item_h = DISPLAY_MENU_ITEM_HEIGHT,
+    .baseline = 12,
+    .rows = DISPLAY_MENU_VISIBLE_ROWS,
+    .wrap = true,
+    .font = MENU_FONT,
+    .count = Menu_Count,
+    .text = Menu_Text,
+    .icon = Menu_Icon};
 
 /* Public variables ----------------------------------------------------------*/
 /**
  * @brief 显示设置页面的全局实例
  */
-Page_Base g_page_display = {
+const Page_Base g_page_display = {
     .enter = Page_Display_Enter,
     .exit = NULL,
-    .loop = Page_Display_Loop,
+    .loop = NULL, // 高亮框的动画由补间动画池驱动，不需要 loop 逻辑
     .draw = Page_Display_Draw,
     .action = Page_Display_Action,
     .page_name = "Display",
-    .refresh_rate_ms = 30, // 动画需要高刷新率 (~33FPS)
-    .last_refresh_time = 0};
+    .id = PAGE_ID_DISPLAY};
 
 /* Function implementations --------------------------------------------------*/
 
 /**
- * @brief 页面进入函数
- * @param[in] page 指向页面基类的指针
- * @return 无
+ * @brief 获取菜单项数量
+ * @param[in] ctx 页面数据 (未使用)
+ * @return uint16_t 菜单项数量
  */
-static void Page_Display_Enter(Page_Base *page)
+static uint16_t Menu_Count(const void *ctx)
 {
-    Page_Display_Data_t *data = &g_page_display_data;
-    data->state = DISPLAY_MENU_STATE_IDLE;
-    data->selected_index = 0;
-
-    // 强制将动画的当前位置和目标位置都设置为第一个选项的坐标
-    int16_t initial_y = DISPLAY_MENU_TOP_Y + (data->selected_index * DISPLAY_MENU_ITEM_HEIGHT);
-    data->anim_current_y = initial_y;
-    data->anim_target_y = initial_y;
+    return DISPLAY_MENU_ITEM_COUNT;
 }
 
 /**
- * @brief 页面循环逻辑函数 (处理动画)
- * @param[in] page 指向页面基类的指针
- * @return 无
+ * @brief 获取菜单项文本
+ * @param[in] ctx 页面数据 (未使用)
+ * @param[in] index 菜单项索引
+ * @return const char* 菜单项文本
  */
-static void Page_Display_Loop(Page_Base *page)
+static const char *Menu_Text(const void *ctx, uint16_t index)
 {
-    Page_Display_Data_t *data = &g_page_display_data;
+    const Page_Display_Data_t *data = ctx;
 
-    if (data->state != DISPLAY_MENU_STATE_ANIMATING)
+    if (index == DISPLAY_MENU_FACE)
     {
-        return;
+        return data->face_label;
     }
-
-    uint32_t elapsed = HAL_GetTick() - data->anim_start_time;
-
-    if (elapsed >= data->anim_duration)
+    if (index == DISPLAY_MENU_MODE)
     {
-        // 动画结束
-        data->anim_current_y = data->anim_target_y;
-        data->state = DISPLAY_MENU_STATE_IDLE;
+        return data->mode_label;
     }
-    else
+    if (index == DISPLAY_MENU_PERF)
     {
-        // 动画进行中，使用线性插值计算当前Y坐标
-        float progress = (float)elapsed / data->anim_duration;
-
-        // 使用保存好的 anim_start_y 作为起点进行插值
-        data->anim_current_y = data->anim_start_y + (data->anim_target_y - data->anim_start_y) * progress;
+        return data->perf_label;
     }
+    return app_str(menu_items[index]);
+}
+
+/**
+ * @brief 获取菜单项图标
+ * @param[in] ctx 页面数据 (未使用)
+ * @param[in] index 菜单项索引
+ * @return UI_Icon_e 图标编号
+ */
+static UI_Icon_e Menu_Icon(const void *ctx, uint16_t index)
+{
+    return menu_icons[index];
+}
+
+/**
+ * @brief 按当前设置生成“表盘”项的文字
+ * @param[out] data 页面数据
+ * @return 无
+ */
+static void Face_Label_Update(Page_Display_Data_t *data)
+{
+    char *p = fmt_str(data->face_label, app_str(menu_items[DISPLAY_MENU_FACE]));
+    fmt_str(p, app_str(UI_Face_Get(g_app_settings.clock_face)->name));
+}
+
+/**
+ * @brief 按当前设置生成“模式”项的文字
+ * @param[out] data 页面数据
+ * @return 无
+ */
+static void Mode_Label_Update(Page_Display_Data_t *data)
+{
+    char *p = fmt_str(data->mode_label, app_str(menu_items[DISPLAY_MENU_MODE]));
+    fmt_str(p, app_str(mode_names[g_app_settings.display_mode]));
+}
+
+/**
+ * @brief 按当前设置生成“性能”项的文字
+ * @param[out] data 页面数据
+ * @return 无
+ */
+static void Perf_Label_Update(Page_Display_Data_t *data)
+{
+    char *p = fmt_str(data->perf_label, app_str(menu_items[DISPLAY_MENU_PERF]));
+    fmt_str(p, app_str(app_perf_get(g_app_settings.perf_profile)->name));
+}
+
+/**
+ * @brief 页面进入函数
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Display_Enter(const Page_Base *page)
+{
+    Page_Display_Data_t *data = Page_Data(page);
+    Face_Label_Update(data);
+    Mode_Label_Update(data);
+    Perf_Label_Update(data);
+    UI_List_Init(&data->list, &menu_list, data, Page_Resume_Get(page, 0));
 }
 
 /**
@@ -128,38 +218,11 @@ static void Page_Display_Loop(Page_Base *page)
  * @param[in] y_offset 屏幕的Y方向偏移
  * @return 无
  */
-static void Page_Display_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+static void Page_Display_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
 {
-    Page_Display_Data_t *data = &g_page_display_data;
-
-    // 绘制基础层 (所有正常显示的文字)
-    u8g2_SetFont(u8g2, MENU_FONT);
-    u8g2_SetDrawColor(u8g2, 1);
-    for (int i = 0; i < DISPLAY_MENU_ITEM_COUNT; i++)
-    {
-        u8g2_DrawStr(u8g2, 15 + x_offset, (i * DISPLAY_MENU_ITEM_HEIGHT) + DISPLAY_MENU_TOP_Y + 12 + y_offset, menu_items[i]);
-    }
-
-    // 设置裁剪窗口以绘制高亮反色层
-    int16_t clip_x0 = DISPLAY_MENU_LEFT_X + x_offset;
-    int16_t clip_y0 = (int16_t)data->anim_current_y + y_offset;
-    int16_t clip_x1 = clip_x0 + DISPLAY_MENU_WIDTH;
-    int16_t clip_y1 = clip_y0 + DISPLAY_MENU_ITEM_HEIGHT;
-    u8g2_SetClipWindow(u8g2, clip_x0, clip_y0, clip_x1, clip_y1);
-
-    // 在裁剪窗口内绘制反色内容
-    u8g2_SetDrawColor(u8g2, 1);
-    u8g2_DrawBox(u8g2, clip_x0, clip_y0, DISPLAY_MENU_WIDTH, DISPLAY_MENU_ITEM_HEIGHT);
-
-    u8g2_SetDrawColor(u8g2, 0);
-    for (int i = 0; i < DISPLAY_MENU_ITEM_COUNT; i++)
-    {
-        u8g2_DrawStr(u8g2, 15 + x_offset, (i * DISPLAY_MENU_ITEM_HEIGHT) + DISPLAY_MENU_TOP_Y + 12 + y_offset, menu_items[i]);
-    }
+    Page_Display_Data_t *data = Page_Data(page);
 
-    // 恢复裁剪窗口和绘制颜色
-    u8g2_SetMaxClipWindow(u8g2);
-    u8g2_SetDrawColor(u8g2, 1);
+    UI_List_Draw(&data->list, u8g2, x_offset, y_offset);
 }
 
 /**
@@ -169,52 +232,45 @@ static void Page_Display_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, i
  * @param[in] event 指向输入事件数据的指针
  * @return 无
  */
-static void Page_Display_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+static void Page_Display_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
 {
-    Page_Display_Data_t *data = &g_page_display_data;
-
-    if (data->state == DISPLAY_MENU_STATE_ANIMATING)
-    {
-        return; // 动画期间忽略输入
-    }
+    Page_Display_Data_t *data = Page_Data(page);
 
     switch (event->event)
     {
     case INPUT_EVENT_ENCODER:
-    {
-        int8_t old_index = data->selected_index;
-        data->selected_index += event->value;
-
-        // 循环边界检查
-        if (data->selected_index >= DISPLAY_MENU_ITEM_COUNT)
-        {
-            data->selected_index = 0;
-        }
-        if (data->selected_index < 0)
-        {
-            data->selected_index = DISPLAY_MENU_ITEM_COUNT - 1;
-        }
-
-        // 如果选项改变，则启动动画
-        if (old_index != data->selected_index)
-        {
-            data->state = DISPLAY_MENU_STATE_ANIMATING;
-            data->anim_start_time = HAL_GetTick();
-            data->anim_duration = 150;                 // 动画时长
-            data->anim_start_y = data->anim_current_y; // 保存动画起始位置
-            data->anim_target_y = DISPLAY_MENU_TOP_Y + (data->selected_index * DISPLAY_MENU_ITEM_HEIGHT);
-        }
+        UI_List_Move(&data->list, event->value);
+        Page_Resume_Set(page, (uint8_t)data->list.selected);
         break;
-    }
     case INPUT_EVENT_COMFIRM_PRESSED:
-        if (data->selected_index == 1)
+        if (data->list.selected == DISPLAY_MENU_FACE)
+        {
+            // 切换到下一个表盘，回到主页面时生效
+            g_app_settings.clock_face = (uint8_t)((g_app_settings.clock_face + 1) % CLOCK_FACE_COUNT);
+            app_settings_mark_dirty();
+            Face_Label_Update(data);
+            Page_Invalidate(page);
+            break;
+        }
+        if (data->list.selected == DISPLAY_MENU_MODE)
         {
-            Switch_Page(&g_page_auto_off); // 切换到自动熄屏设置页面
+            // 切换到下一个显示模式，设置修改的通知中由亮度调度发送反色命令
+            g_app_settings.display_mode = (uint8_t)((g_app_settings.display_mode + 1) % DISPLAY_MODE_COUNT);
+            app_settings_mark_dirty();
+            Mode_Label_Update(data);
+            Page_Invalidate(page);
+            break;
         }
-        else if (data->selected_index == 0)
+        if (data->list.selected == DISPLAY_MENU_PERF)
         {
-            Switch_Page(&g_page_language); // 切换到语言设置页面
+            // 切换到下一个性能配置，设置修改的通知中更新动画时长比例，其余参数在使用时读取
+            g_app_settings.perf_profile = (uint8_t)((g_app_settings.perf_profile + 1) % PERF_PROFILE_COUNT);
+            app_settings_mark_dirty();
+            Perf_Label_Update(data);
+            Page_Invalidate(page);
+            break;
         }
+        Switch_Page_Id(menu_targets[data->list.selected]); // 切换到选中项对应的设置页面
         break;
 
     case INPUT_EVENT_BACK_PRESSED:
@@ -0,0 +1,376 @@
+/**
+ * @file      page_history.c
+ * @brief     温度历史曲线页面实现文件
+ * @details   在主页面向右旋转编码器进入。曲线区域每列代表15分钟 (3个样本)，96列正好24小时，
+ *            按示波器的扫描方式从左到右循环写入：最新的一列右侧留一列空白作为分界，
+ *            新样本只重绘最新的一列和空白列，已画好的列不需要移动。
+ *            纵轴按24小时的最低、最高温度取整到1°C，范围变化时才整屏重绘。
+ *            整屏重绘要读取全部样本，分帧完成 (Page_Build_Begin)：每段在时间预算内画若干列，
+ *            画完之前屏幕保持上一帧，编码器和返回键照常响应。
+ *            旋转编码器在 AHT20 和 DS3231 两个温度之间切换，其余按键返回主页面。
+ * @author    SandOcean
+ * @date      2025-09-30
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_display.h"
+#include "app_i18n.h"
+#include "app_history.h"
+#include "app_fmt.h"
+#include "input.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define GRAPH_X0 20            ///< 曲线区域左侧的X坐标
+#define GRAPH_COLS 96          ///< 曲线区域的列数
+#define GRAPH_Y0 14            ///< 曲线区域顶部的Y坐标
+#define GRAPH_H 50             ///< 曲线区域的高度
+#define GRAPH_SAMPLES_PER_COL 3 ///< 每列的样本数
+#define GRAPH_MIN_SPAN 2       ///< 纵轴的最小范围 (°C)
+#define HEADER_Y 9             ///< 标题行的基线Y坐标
+#define HEADER_H 12            ///< 标题行的高度
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 温度历史页面的私有数据结构体
+ */
+typedef struct
+{
+    uint8_t series;       ///< 显示的序列 (History_Series_e)
+    uint32_t seq;         ///< 上一次绘制时的样本总数
+    int16_t lo;           ///< 纵轴下限 (°C)
+    int16_t hi;           ///< 纵轴上限 (°C)
+    char range[14];       ///< 右上角的最低和最高温度，如 "21.0-25.3"
+    uint32_t build_col;   ///< 分帧绘制中下一段从哪一列开始
+    bool build_resume;    ///< 分帧绘制已画完标题和纵轴，下一段从 build_col 接着画
+} Page_History_Data;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Page_History_Enter(const Page_Base *page);
+static void Page_History_Loop(const Page_Base *page);
+static void Page_History_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_History_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static uint8_t History_Update(Page_History_Data *data);
+static int16_t History_Y(const Page_History_Data *data, int16_t value);
+static void History_Draw_Column(const Page_History_Data *data, u8g2_t *u8g2, uint32_t col, int16_t x, int16_t y_offset);
+static void History_Label(char *dst, int16_t value);
+static void History_Rebuild(const Page_Base *page, Page_History_Data *data);
+
+/* Private variables ---------------------------------------------------------*/
+PAGE_DATA_CHECK(Page_History_Data); ///< 数据由页面管理器在进入时分配 (Page_Data)
+
+///< 各序列在标题中的名称
+static const char *const series_names[HISTORY_SERIES_COUNT] = {"Room", "RTC"};
+
+/* Public variables ----------------------------------------------------------*/
+/**
+ * @brief 温度历史页面的全局实例
+ */
+const Page_Base g_page_history = {
+    .enter = Page_History_Enter,
+    .exit = NULL,
+    .loop = Page_History_Loop,
+    .draw = Page_History_Draw,
+    .action = Page_History_Action,
+    .page_name = "History",
+    .id = PAGE_ID_HISTORY};
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 按当前记录生成最低、最高温度并计算纵轴范围
+ * @param[in,out] data 页面数据
+ * @return uint8_t 0: 都没有变化；1: 只有最低、最高温度变化；2: 纵轴范围变化
+ */
+static uint8_t History_Update(Page_History_Data *data)
+{
+    History_Series_e series = (History_Series_e)data->series;
+    int16_t min, max;
+    int16_t lo, hi;
+    char range[sizeof(data->range)];
+    char *p;
+
+    if (!app_history_min_max(series, &min, &max))
+    {
+        data->range[0] = '\0';
+        return 0;
+    }
+    p = fmt_q1(range, min);
+    p = fmt_char(p, '-');
+    fmt_q1(p, max);
+    uint8_t changed = (strcmp(range, data->range) != 0) ? 1 : 0;
+    strcpy(data->range, range);
+
+    // 向下和向上取整到1°C (温度可能为负)
+    lo = (int16_t)((min >= 0) ? min / 10 : -((-min + 9) / 10));
+    hi = (int16_t)((max >= 0) ? (max + 9) / 10 : -(-max / 10));
+    if (hi - lo < GRAPH_MIN_SPAN)
+    {
+        hi = (int16_t)(lo + GRAPH_MIN_SPAN);
+    }
+    if (lo == data->lo && hi == data->hi)
+    {
+        return changed;
+    }
+    data->lo = lo;
+    data->hi = hi;
+    return 2;
+}
+
+/**
+ * @brief 把温度换算为曲线区域中的Y坐标
+ * @param[in] data 页面数据
+ * @param[in] value 温度 (0.1°C)
+ * @return int16_t Y坐标 (未加Y方向偏移)
+ */
+static int16_t History_Y(const Page_History_Data *data, int16_t value)
+{
+    int32_t span = (int32_t)(data->hi - data->lo) * 10;
+    int32_t offset = (int32_t)value - data->lo * 10;
+
+    return (int16_t)(GRAPH_Y0 + GRAPH_H - 1 - offset * (GRAPH_H - 1) / span);
+}
+
+/**
+ * @brief 绘制一列
+ * @details 竖线覆盖该列的各样本以及前一列的最后一个样本，相邻的列首尾相接成连续的曲线。
+ *          只读取该列用到的样本，不依赖其他列的绘制结果。
+ * @param[in] data 页面数据
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] col 列的绝对序号 (样本序号 / GRAPH_SAMPLES_PER_COL)
+ * @param[in] x 列的X坐标 (已加上X方向偏移)
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+static void History_Draw_Column(const Page_History_Data *data, u8g2_t *u8g2, uint32_t col, int16_t x, int16_t y_offset)
+{
+    uint32_t seq = app_history_seq();
+    uint32_t oldest = seq - app_history_count();
+    uint32_t first = col * GRAPH_SAMPLES_PER_COL;
+    uint32_t last = first + GRAPH_SAMPLES_PER_COL - 1;
+    int16_t lo = INT16_MAX, hi = INT16_MIN;
+    int16_t value;
+
+    if (first > 0)
+    {
+        first--; // 前一列的最后一个样本
+    }
+    if (first < oldest)
+    {
+        first = oldest;
+    }
+    if (last >= seq)
+    {
+        last = seq - 1;
+    }
+    for (uint32_t s = first; s <= last; s++)
+    {
+        if (app_history_get((History_Series_e)data->series, (uint16_t)(seq - 1 - s), &value))
+        {
+            lo = (value < lo) ? value : lo;
+            hi = (value > hi) ? value : hi;
+        }
+    }
+    if (lo > hi)
+    {
+        return;
+    }
+
+    int16_t y_top = History_Y(data, hi);
+    int16_t y_bottom = History_Y(data, lo);
+    u8g2_DrawVLine(u8g2, x, y_top + y_offset, y_bottom - y_top + 1);
+}
+
+/**
+ * @brief 生成纵轴的刻度文字
+ * @param[out] dst 输出缓冲区
+ * @param[in] value 温度 (°C)
+ * @return 无
+ */
+static void History_Label(char *dst, int16_t value)
+{
+    if (value < 0)
+    {
+        dst = fmt_char(dst, '-');
+        value = (int16_t)-value;
+    }
+    fmt_uint(dst, (uint32_t)value, 1);
+}
+
+/**
+ * @brief 请求分帧整屏重绘
+ * @param[in] page 指向页面基类的指针
+ * @param[in,out] data 页面数据
+ * @return 无
+ */
+static void History_Rebuild(const Page_Base *page, Page_History_Data *data)
+{
+    data->build_resume = false;
+    Page_Build_Begin(page);
+}
+
+/**
+ * @brief 温度历史页面进入函数
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_History_Enter(const Page_Base *page)
+{
+    Page_History_Data *data = Page_Data(page);
+
+    data->series = HISTORY_SERIES_AHT20;
+    data->seq = app_history_seq();
+    data->lo = 0;
+    data->hi = 0;
+    data->range[0] = '\0';
+    History_Update(data);
+}
+
+/**
+ * @brief 温度历史页面的逻辑循环函数
+ * @details 有一个新样本时只失效最新的一列和其后的空白列，最低、最高温度改变时再加上标题行
+ *          (失效区域取外接矩形)；纵轴范围改变或一次补入了多个样本 (断电后恢复) 时整屏失效。
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_History_Loop(const Page_Base *page)
+{
+    Page_History_Data *data = Page_Data(page);
+    uint32_t seq = app_history_seq();
+
+    if (seq == data->seq)
+    {
+        return;
+    }
+
+    uint8_t changed = History_Update(data);
+    if (changed == 2 || seq - data->seq > 1)
+    {
+        History_Rebuild(page, data);
+    }
+    else
+    {
+        int16_t x = GRAPH_X0 + (int16_t)(((seq - 1) / GRAPH_SAMPLES_PER_COL) % GRAPH_COLS);
+        if (changed)
+        {
+            Page_Invalidate_Rect(page, 0, 0, 128, HEADER_H);
+        }
+        Page_Invalidate_Rect(page, x, GRAPH_Y0, (x + 1 < GRAPH_X0 + GRAPH_COLS) ? 2 : 1, GRAPH_H);
+        if (x + 1 >= GRAPH_X0 + GRAPH_COLS)
+        {
+            Page_Invalidate_Rect(page, GRAPH_X0, GRAPH_Y0, 1, GRAPH_H); // 空白列回到最左侧
+        }
+    }
+    data->seq = seq;
+}
+
+/**
+ * @brief 温度历史页面的绘制函数
+ * @details 只绘制与当前裁剪窗口相交的列。分帧绘制时第一段画标题和纵轴，之后每画一列检查一次时间预算。
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+static void Page_History_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    Page_History_Data *data = Page_Data(page);
+    uint32_t seq = app_history_seq();
+    uint32_t newest = (seq - 1) / GRAPH_SAMPLES_PER_COL;
+    uint32_t last = (newest + 2 > GRAPH_COLS) ? newest + 2 - GRAPH_COLS : 0; // 空白列右侧的一列
+    char label[6];
+    uint32_t col = newest;
+
+    if (Page_Build_Active() && data->build_resume)
+    {
+        col = data->build_col;
+    }
+    else
+    {
+        u8g2_SetFont(u8g2, DATE_TEMP_FONT);
+        if (Page_Strip_Text_Visible(u8g2, HEADER_Y + y_offset))
+        {
+            u8g2_DrawStr(u8g2, x_offset, HEADER_Y + y_offset, series_names[data->series]);
+            u8g2_DrawStr(u8g2, 128 - Page_Str_Width(u8g2, data->range) + x_offset, HEADER_Y + y_offset, data->range);
+        }
+
+        if (app_history_count() == 0)
+        {
+            const char *msg = app_str(STR_MSG_NO_DATA);
+            u8g2_SetFont(u8g2, app_i18n_font(DATE_TEMP_FONT));
+            if (Page_Strip_Text_Visible(u8g2, 42 + y_offset))
+            {
+                app_i18n_draw(u8g2, (128 - app_i18n_width(u8g2, msg)) / 2 + x_offset, 42 + y_offset, msg);
+            }
+            Page_Build_Done(page);
+            return;
+        }
+
+        // 纵轴和上下限
+        u8g2_DrawVLine(u8g2, GRAPH_X0 - 2 + x_offset, GRAPH_Y0 + y_offset, GRAPH_H);
+        if (Page_Strip_Text_Visible(u8g2, GRAPH_Y0 + 7 + y_offset))
+        {
+            History_Label(label, data->hi);
+            u8g2_DrawStr(u8g2, x_offset, GRAPH_Y0 + 7 + y_offset, label);
+        }
+        if (Page_Strip_Text_Visible(u8g2, GRAPH_Y0 + GRAPH_H - 1 + y_offset))
+        {
+            History_Label(label, data->lo);
+            u8g2_DrawStr(u8g2, x_offset, GRAPH_Y0 + GRAPH_H - 1 + y_offset, label);
+        }
+    }
+
+    // 从最新的一列向左 (循环) 画到空白列为止，分帧绘制时每列之后检查一次时间预算
+    for (;;)
+    {
+        int16_t x = GRAPH_X0 + (int16_t)(col % GRAPH_COLS) + x_offset;
+        if (x >= (int16_t)u8g2->user_x0 && x < (int16_t)u8g2->user_x1)
+        {
+            History_Draw_Column(data, u8g2, col, x, y_offset);
+        }
+        if (col <= last)
+        {
+            break;
+        }
+        col--;
+        if (Page_Build_Yield())
+        {
+            data->build_col = col;
+            data->build_resume = true;
+            return;
+        }
+    }
+    Page_Build_Done(page);
+}
+
+/**
+ * @brief 温度历史页面的事件处理函数
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针 (未使用)
+ * @param[in] event 指向输入事件数据的指针
+ * @return 无
+ */
+static void Page_History_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+{
+    Page_History_Data *data = Page_Data(page);
+
+    switch (event->event)
+    {
+    case INPUT_EVENT_ENCODER:
+        data->series = (uint8_t)((data->series + 1) % HISTORY_SERIES_COUNT);
+        data->lo = 0;
+        data->hi = 0;
+        History_Update(data);
+        History_Rebuild(page, data);
+        break;
+    case INPUT_EVENT_BACK_PRESSED:
+    case INPUT_EVENT_COMFIRM_PRESSED:
+    case INPUT_EVENT_ENCODER_PRESSED:
+        Go_Back_Page();
+        break;
+    default:
+        break;
+    }
+}
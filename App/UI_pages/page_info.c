@@ -2,34 +2,61 @@
  * @file      page_info.c
  * @brief     关于界面实现文件
  * @details   本文件定义了关于页面，用于显示应用名称、版本号等静态信息。
+ *            页面由控件树 (ui_widget) 描述，draw 只绘制与重绘区域相交的控件。
  * @author    SandOcean
  * @date      2025-09-16
- * @version   1.0
+ * @version   1.1
  * @copyright Copyright (c) 2025 SandOcean
  */
 
 #include "app_display.h"
 #include "app_config.h"
+#include "ui_widget.h"
 #include "input.h"
 
 /* Private function prototypes -----------------------------------------------*/
-static void Page_Info_Enter(Page_Base *page);
-static void Page_Info_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
-static void Page_Info_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static void Page_Info_Enter(const Page_Base *page);
+static void Page_Info_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_Info_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
 
 /* Public variables ----------------------------------------------------------*/
 /**
  * @brief 关于页面的全局实例
  */
-Page_Base g_page_info = {
+const Page_Base g_page_info = {
     .enter = Page_Info_Enter,
     .exit = NULL,
-    .loop = NULL, // 静态页面，不需要 loop 逻辑
+    .loop = NULL, // 静态页面，不需要 loop 逻辑,
     .draw = Page_Info_Draw,
     .action = Page_Info_Action,
     .page_name = "Info",
-    .refresh_rate_ms = 10000, // 静态页面，不需要高刷新率
-    .last_refresh_time = 0};
+    .id = PAGE_ID_INFO};
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief 关于页面的控件表
+ */
+static const UI_Widget_t s_info_widgets[] = {
+    {.kind = UI_WIDGET_LABEL, .parent = UI_WIDGET_ROOT, .x = 0, .y = 0, .w = 16, .h = 16, .base = 16,
+     .font = u8g2_font_open_iconic_app_2x_t, .text = "E"}, // 一个时钟符号 (0x45) 作为Logo
+    {.kind = UI_WIDGET_LABEL, .parent = UI_WIDGET_ROOT, .x = 22, .y = 0, .w = 106, .h = 18, .base = 14,
+     .font = INFO_FONT_BIG, .text = APP_NAME},
+    {.kind = UI_WIDGET_FILL, .parent = UI_WIDGET_ROOT, .x = 0, .y = 18, .w = 128, .h = 1},
+    {.kind = UI_WIDGET_LABEL, .parent = UI_WIDGET_ROOT, .x = 0, .y = 20, .w = 128, .h = 14, .base = 10,
+     .font = INFO_FONT_SMALL, .text = "Firmware: " APP_VERSION},
+    {.kind = UI_WIDGET_LABEL, .parent = UI_WIDGET_ROOT, .x = 0, .y = 38, .w = 128, .h = 14, .base = 10,
+     .font = INFO_FONT_SMALL, .text = APP_COPYRIGHT},
+    {.kind = UI_WIDGET_LABEL, .parent = UI_WIDGET_ROOT, .x = 0, .y = 48, .w = 128, .h = 14, .base = 10,
+     .font = INFO_FONT_SMALL, .text = APP_AUTHOR},
+};
+
+static UI_Widget_State_t s_info_state[sizeof(s_info_widgets) / sizeof(s_info_widgets[0])]; ///< 控件的属性
+
+/**
+ * @brief 关于页面的控件树
+ */
+static const UI_Widget_Tree_t s_info_tree = {
+    s_info_widgets, s_info_state, &g_page_info, sizeof(s_info_widgets) / sizeof(s_info_widgets[0])};
 
 /* Function implementations --------------------------------------------------*/
 
@@ -38,9 +65,9 @@ Page_Base g_page_info = {
  * @param[in] page 指向页面基类的指针 (未使用)
  * @return 无
  */
-static void Page_Info_Enter(Page_Base *page)
+static void Page_Info_Enter(const Page_Base *page)
 {
-    // 静态页面，进入时无需任何操作
+    UI_Widget_Init(&s_info_tree);
 }
 
 /**
@@ -51,31 +78,22 @@ static void Page_Info_Enter(Page_Base *page)
  * @param[in] y_offset 屏幕的Y方向偏移
  * @return 无
  */
-static void Page_Info_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+static void Page_Info_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
 {
-    /* 标题和Logo */
-    u8g2_SetFont(u8g2, u8g2_font_open_iconic_app_2x_t);        // 符号字体
-    u8g2_DrawGlyph(u8g2, 0 + x_offset, 16 + y_offset, 0x0045); // 一个时钟符号作为Logo
-    u8g2_SetFont(u8g2, INFO_FONT_BIG);
-    u8g2_DrawStr(u8g2, 22 + x_offset, 14 + y_offset, APP_NAME);
-    u8g2_DrawHLine(u8g2, 0 + x_offset, 18 + y_offset, 128);
-
-    /* 基本信息 */
-    u8g2_SetFont(u8g2, INFO_FONT_SMALL);
-    u8g2_DrawStr(u8g2, 0 + x_offset, 30 + y_offset, "Firmware: " APP_VERSION);
-    u8g2_DrawStr(u8g2, 0 + x_offset, 48 + y_offset, APP_COPYRIGHT);
-    u8g2_DrawStr(u8g2, 0 + x_offset, 58 + y_offset, APP_AUTHOR);
+    UI_Widget_Draw(&s_info_tree, u8g2, x_offset, y_offset);
 }
 
 /**
  * @brief 关于页面事件处理函数
  * @details 在关于页面，任何按键都视为返回操作。
+ *          主菜单在确认键按下时就切换到本页，若确认键一直按住，本页会收到它的长按事件，
+ *          以此作为进入诊断页面的隐藏入口。
  * @param[in] page 指向页面基类的指针 (未使用)
  * @param[in] u8g2 指向u8g2实例的指针 (未使用)
  * @param[in] event 指向输入事件数据的指针
  * @return 无
  */
-static void Page_Info_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+static void Page_Info_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
 {
     switch (event->event)
     {
@@ -84,6 +102,12 @@ static void Page_Info_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Da
     case INPUT_EVENT_ENCODER_PRESSED:
         Go_Back_Page();
         break;
+    case INPUT_EVENT_LONG_PRESS:
+        if (event->value == INPUT_EVENT_COMFIRM_PRESSED)
+        {
+            Switch_Page_Id(PAGE_ID_DIAG);
+        }
+        break;
     default:
         break;
     }
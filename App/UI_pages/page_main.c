@@ -2,18 +2,36 @@
  * @file      page_main.c
  * @brief     主页面实现文件
  * @details   本文件定义了主页面的行为，包括显示时间、日期、温湿度等信息。
+ *            表盘的布局和局部刷新由 ui_face 按 g_app_settings.clock_face 选择的表盘描述完成，
+ *            本页面只负责采集数据、防烧屏的整体移动和按键。在主页面按下编码器切换到下一个表盘，
+ *            也可以在“显示”菜单中选择。向右旋转编码器进入温度曲线，向左进入月历。
+ *            时间、温湿度和设置的变化由 app_bus 通知，没有变化 (也没有翻页或灰度动画) 时 loop 不重新生成表盘。
+ *            每一秒的画面在 DS3231 的 SQW 脉冲之前 AHEAD_MS 提前画好 (Page_Render_Ahead)，
+ *            到脉冲时刻只剩发送，显示的秒与 RTC 的差只有一帧的传输时间。
+ *            秒进度 (见 ui_face.h) 每一轮按RTC脉冲之后经过的时间推进，不经过表盘的重新生成，
+ *            按主页面 100ms 的重绘间隔以 10Hz 只发送新覆盖的像素所在的块。
+ *            电量等级变低 (见 app_battery.h) 时弹出提示框显示等级和电量百分比。
  * @author    SandOcean
- * @date      2025-09-17
- * @version   1.1
+ * @date      2025-10-08
+ * @version   1.8
  * @copyright Copyright (c) 2025 SandOcean
  */
 
 #include "app_display.h"
+#include "app_i18n.h"
+#include "ui_face.h"
 #include "app_main.h" // 包含 app_main.h 以访问全局标志
+#include "app_settings.h"
 #include "DS3231.h"
-#include "AHT20.h"
+#include "app_sensor.h"
+#include "app_battery.h"
+#include "app_fmt.h"
+#include "app_bus.h"
 #include "input.h"
-#include <stdio.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define SHIFT_PERIOD_MS  (3UL * 60 * 1000) ///< 防烧屏：整个表盘每隔这么久移动到下一个位置
+#define AHEAD_MS         20                 ///< 在下一个SQW脉冲之前这么久绘制下一秒的画面 (须长于一个逻辑步加一次绘制)
 
 /* Private types -------------------------------------------------------------*/
 /**
@@ -21,47 +39,65 @@
  */
 typedef struct
 {
-    Page_Base base; ///< 必须包含基类作为第一个成员
-    // 私有数据: 用于存储需要显示的内容
-    char time_str[12];      ///< 格式化的时间字符串
-    char date_str[12];      ///< 格式化的日期字符串
-    char week_str[5];       ///< 格式化的星期字符串
-    char temp_humi_str[20]; ///< 格式化的温湿度字符串
-
-    Time_t current_time;       ///< 当前时间数据
-    float current_temp;        ///< 当前温度数据
-    float current_humi;        ///< 当前湿度数据
-    uint32_t last_update_time; ///< 上次更新温湿度的时间戳
-
-    // 新增成员，用于处理设置加载失败的提示
-    bool show_error_msg;
-    uint32_t error_msg_start_time;
-
+    UI_Face_State_t face; ///< 表盘的显示状态
+    uint8_t face_index;   ///< 正在显示的表盘 (Clock_Face_e)，设置在后台加载或被修改后与之比较
 } Page_main_Data;
 
+/**
+ * @brief 表盘相对默认布局的偏移
+ */
+typedef struct
+{
+    int8_t x; ///< X方向偏移 (像素)
+    int8_t y; ///< Y方向偏移 (像素)
+} Face_Shift_t;
+
 /* Private function prototypes -----------------------------------------------*/
-static void Page_main_Enter(Page_Base *page);
-static void Page_main_Loop(Page_Base *page);
-static void Page_main_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
-static void Page_main_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static void Page_main_Enter(const Page_Base *page);
+static void Page_main_Exit(const Page_Base *page);
+static void Page_main_On_Change(App_Bus_Topic_e topic, void *arg);
+static void Page_main_Loop(const Page_Base *page);
+static void Page_main_Check_Battery(void);
+static void Page_main_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_main_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
 
 /* Private variables ---------------------------------------------------------*/
-static Page_main_Data g_page_main_data; ///< 主页面的数据实例
+PAGE_DATA_CHECK(Page_main_Data); ///< 主页面的数据由页面管理器在进入时分配 (Page_Data)
+
+/** 防烧屏的Y方向偏移；大号数字按页对齐时Y方向不移动，否则对齐的字形又要逐页移位 */
+#define FACE_SHIFT_Y(y) (UI_FACE_PAGE_ALIGN ? 0 : (y))
+
+/**
+ * @brief 防烧屏的表盘位置序列
+ * @details 绕默认位置走一圈，X方向最多 ±2 像素；表盘在竖直方向占满64行，Y方向只移动 ±1 像素，
+ *          避免时间的顶端和温湿度的底端被裁掉。相邻位置只差1像素，移动时不易察觉。
+ */
+static const Face_Shift_t face_shifts[] = {
+    {0, 0}, {1, 0}, {2, FACE_SHIFT_Y(1)}, {1, FACE_SHIFT_Y(1)}, {0, FACE_SHIFT_Y(1)}, {-1, FACE_SHIFT_Y(1)},
+    {-2, 0}, {-1, FACE_SHIFT_Y(-1)}, {0, FACE_SHIFT_Y(-1)}, {1, FACE_SHIFT_Y(-1)},
+};
+
+static uint8_t face_shift_index;    ///< 当前位置在 face_shifts 中的索引，离开主页面后保留
+static uint32_t face_shift_time;    ///< 上一次移动的时刻 (ms)
+static bool face_ahead;             ///< 表盘已提前显示下一秒，脉冲计数变化之前保持
+static uint32_t face_ahead_ticks;   ///< 提前显示时的SQW脉冲计数
+static bool face_stale;             ///< 数据源有变化，表盘需要重新生成
+static App_Bus_Sub_t face_subs[3];  ///< 时间、温湿度和设置的订阅，在主页面期间有效
+static uint8_t face_battery;        ///< 已提示过的电量等级 (App_Battery_Level_e)，离开主页面后保留
+static char face_battery_text[32];  ///< 电量提示框的文字 (显示期间须保持有效)
 
 /* Public variables ----------------------------------------------------------*/
 /**
  * @brief 主页面的全局实例
  */
-Page_Base g_page_main = {
+const Page_Base g_page_main = {
     .enter = Page_main_Enter,
-    .exit = NULL,
+    .exit = Page_main_Exit,
     .loop = Page_main_Loop,
     .draw = Page_main_Draw,
     .action = Page_main_Action,
     .page_name = "main",
-    .parent_page = NULL,
-    .refresh_rate_ms = 100, // 100ms刷新一次足够了
-    .last_refresh_time = 0};
+    .id = PAGE_ID_MAIN};
 
 /* Function implementations --------------------------------------------------*/
 /**
@@ -69,66 +105,157 @@ Page_Base g_page_main = {
  * @param[in] page 指向页面基类的指针
  * @return 无
  */
-static void Page_main_Enter(Page_Base *page)
+static void Page_main_Enter(const Page_Base *page)
 {
-    Page_main_Data *data = &g_page_main_data;
-    data->last_update_time = 0; // 强制在每次进入主页时都立即刷新一次温湿度
+    Page_main_Data *data = Page_Data(page);
 
-    // 检查设置加载失败的全局标志
-    if (g_settings_load_failed == true)
+    UI_Face_Reset(&data->face); // 重新进入时全部字段重新生成
+    data->face_index = g_app_settings.clock_face;
+    face_ahead = false;
+    face_stale = true;
+    app_bus_subscribe(&face_subs[0], APP_BUS_TIME_SECOND, Page_main_On_Change, NULL);
+    app_bus_subscribe(&face_subs[1], APP_BUS_SENSOR_UPDATED, Page_main_On_Change, NULL);
+    app_bus_subscribe(&face_subs[2], APP_BUS_SETTINGS_CHANGED, Page_main_On_Change, NULL);
+    Page_main_Loop(page); // 立即执行一次循环以填充数据 (并检查设置加载失败的标志)，时间未就绪时不等待
+}
+
+/**
+ * @brief 主页面退出函数
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_main_Exit(const Page_Base *page)
+{
+    (void)page;
+    for (uint8_t i = 0; i < sizeof(face_subs) / sizeof(face_subs[0]); i++)
     {
-        data->show_error_msg = true;
-        data->error_msg_start_time = HAL_GetTick();
-        // 将全局标志复位，这样下次返回主页时就不会再显示
-        g_settings_load_failed = false;
+        app_bus_unsubscribe(&face_subs[i]);
     }
-    else
+}
+
+/**
+ * @brief 时间、温湿度或设置变化的通知
+ * @param[in] topic 未使用
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void Page_main_On_Change(App_Bus_Topic_e topic, void *arg)
+{
+    (void)topic;
+    (void)arg;
+    face_stale = true;
+}
+
+/**
+ * @brief 电量等级变低时弹出提示
+ * @details 每次变低只提示一次，回到较高的等级后再次变低时重新提示。
+ * @return 无
+ */
+static void Page_main_Check_Battery(void)
+{
+    App_Battery_Level_e level = app_battery_level();
+    char *p;
+
+    if (level <= face_battery)
     {
-        data->show_error_msg = false;
+        face_battery = (uint8_t)level;
+        return;
     }
-
-    Page_main_Loop(page); // 立即执行一次循环以填充数据
+    face_battery = (uint8_t)level;
+    p = fmt_str(face_battery_text, app_str((level == APP_BATTERY_CRITICAL) ? STR_MSG_BATTERY_CRITICAL : STR_MSG_BATTERY_LOW));
+    p = fmt_char(p, '\n');
+    p = fmt_uint(p, app_battery_percent(), 0);
+    fmt_char(p, '%');
+    Page_Toast(face_battery_text, 3000, NULL);
 }
 
 /**
  * @brief 主页面的逻辑循环函数
- * @details 负责更新时间和温湿度等数据。
+ * @details 负责更新时间和温湿度等数据，数据源没有变化的通知时只检查防烧屏移动和提前绘制。
  * @param[in] page 指向页面基类的指针
  * @return 无
  */
-static void Page_main_Loop(Page_Base *page)
+static void Page_main_Loop(const Page_Base *page)
 {
-    Page_main_Data *data = &g_page_main_data;
+    Page_main_Data *data = Page_Data(page);
 
-    // 如果正在显示错误消息，检查是否超过3秒
-    if (data->show_error_msg)
+    // 设置在后台加载，加载失败的标志可能在进入页面之后才置位
+    if (g_settings_load_failed == true)
     {
-        if (HAL_GetTick() - data->error_msg_start_time > 3000)
-        {
-            data->show_error_msg = false; // 3秒后停止显示
-        }
+        Page_Toast(app_str(STR_MSG_LOAD_FAILED), 3000, NULL); // 显示3秒
+        // 将全局标志复位，这样下次返回主页时就不会再显示
+        g_settings_load_failed = false;
     }
+    Page_main_Check_Battery();
 
-    DS3231_DST_GetTime(&data->current_time, g_app_settings.dst_enabled);
+    // 表盘设置在加载完成或被修改后可能已经不同，换表盘时整屏重绘
+    if (data->face_index != g_app_settings.clock_face)
+    {
+        data->face_index = g_app_settings.clock_face;
+        UI_Face_Reset(&data->face);
+        Page_Invalidate(page);
+        face_stale = true;
+    }
 
-    // 每30秒更新一次温湿度
-    if (data->last_update_time == 0 || HAL_GetTick() - data->last_update_time > 30000)
+    // 防烧屏：定期把整个表盘移到下一个位置，只在移动时整屏重绘一次
+    if (Page_Now() - face_shift_time >= SHIFT_PERIOD_MS)
     {
-        data->last_update_time = HAL_GetTick();
-        AHT20_Read_Temp_Humi(&data->current_temp, &data->current_humi);
+        face_shift_time = Page_Now();
+        face_shift_index = (uint8_t)((face_shift_index + 1) % (sizeof(face_shifts) / sizeof(face_shifts[0])));
+        Page_Invalidate(page);
     }
 
-    // 更新要显示的字符串数据
-    sprintf(data->time_str, "%02d:%02d:%02d", data->current_time.hour, data->current_time.minute, data->current_time.second);
-    sprintf(data->date_str, "%04d-%02d-%02d", data->current_time.year, data->current_time.month, data->current_time.day);
+    // 时间缓存尚未同步 (上电后异步读取 RTC 还没有完成) 时不阻塞等待，读到后的下一步再填充表盘
+    DS3231_Cache_Snap_t snap;
+    if (!DS3231_Cache_Get(&snap))
+    {
+        return;
+    }
+
+    // 脉冲之前把表盘推进到下一秒并提前画好，脉冲到来 (计数变化) 前一直显示下一秒；
+    // 方波停止时超过预计时刻 AHEAD_MS 后回到实际时间
+    uint32_t edge_due = snap.edge_ms + DS3231_SQW_PERIOD_MS;
+    bool was_ahead = face_ahead;
+    if (face_ahead && (snap.ticks != face_ahead_ticks || (int32_t)(Page_Now() - edge_due) >= AHEAD_MS))
+    {
+        face_ahead = false;
+    }
+    if (!face_ahead && snap.ticks != 0 && DS3231_SQW_Get_Period() == DS3231_SQW_PERIOD_MS &&
+        (int32_t)(edge_due - Page_Now()) <= AHEAD_MS && Page_Render_Ahead(page, edge_due))
+    {
+        face_ahead = true;
+        face_ahead_ticks = snap.ticks;
+    }
+
+    // 秒进度与显示的秒一致：提前显示下一秒时取下一秒的开始；每分钟闹钟模式下 edge_ms 为这一分钟的开始
+    uint32_t minute_ms = face_ahead ? ((snap.epoch + 1) % 60) * 1000UL
+                                    : (snap.epoch % 60) * 1000UL + (Page_Now() - snap.edge_ms);
+    UI_Face_Sweep(&data->face, UI_Face_Get(data->face_index), page,
+                  (uint16_t)((minute_ms < 60000) ? minute_ms : 59999));
+
+    // 数据源都没有变化、表盘也没有逐帧的动画时无事可做
+    if (!face_stale && face_ahead == was_ahead && !UI_Face_Animating(&data->face))
+    {
+        return;
+    }
+    face_stale = false;
 
-    const char *week_str_map[] = {"MON", "TUE", "WED", "THU", "FRI", "SAT", "SUN"};
-    if (data->current_time.week >= 1 && data->current_time.week <= 7)
+    Time_t now;
+    DS3231_DST_GetCachedTime(&now, g_app_settings.dst_enabled);
+    if (face_ahead)
     {
-        strcpy(data->week_str, week_str_map[data->current_time.week - 1]);
+        Time_From_Epoch(Time_To_Epoch(&now) + 1, &now);
     }
 
-    sprintf(data->temp_humi_str, "T:%.1f\260C H:%.1f%%", data->current_temp, data->current_humi);
+    // 温湿度由主循环非阻塞采样并滤波，这里只读取缓存值。
+    // 温度四舍五入到0.1℃，湿度本身以0.1%为单位，均按一位小数的定点数输出
+    const AHT20_Data_t *env = app_sensor_get();
+    int16_t temp_d = (int16_t)((env->temperature_cdeg + (env->temperature_cdeg < 0 ? -5 : 5)) / 10);
+
+    // 只有数据源发生变化的字段失效
+    const Face_Shift_t *shift = &face_shifts[face_shift_index];
+    UI_Face_Update(&data->face, UI_Face_Get(data->face_index), page, &now, temp_d, env->humidity_pm,
+                   shift->x, shift->y);
 }
 
 /**
@@ -139,44 +266,15 @@ static void Page_main_Loop(Page_Base *page)
  * @param[in] y_offset 屏幕的Y方向偏移
  * @return 无
  */
-static void Page_main_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+static void Page_main_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
 {
-    Page_main_Data *data = &g_page_main_data;
-
-    /* 绘制时间 */
-    u8g2_SetFont(u8g2, CLOCK_FONT);
-    u8g2_uint_t time_width = u8g2_GetStrWidth(u8g2, data->time_str);
-    u8g2_DrawStr(u8g2, (128 - time_width) / 2 + x_offset, 28 + y_offset, data->time_str);
-
-    /* 绘制分割线 */
-    u8g2_DrawHLine(u8g2, 0 + x_offset, 36 + y_offset, 128);
+    Page_main_Data *data = Page_Data(page);
 
-    /* 绘制日期和星期 */
-    u8g2_SetFont(u8g2, DATE_TEMP_FONT);
-    u8g2_DrawStr(u8g2, 2 + x_offset, 50 + y_offset, data->week_str);
-    u8g2_uint_t date_width = u8g2_GetStrWidth(u8g2, data->date_str);
-    u8g2_DrawStr(u8g2, (128 - date_width - 2) + x_offset, 50 + y_offset, data->date_str);
+    // 表盘整体偏移到防烧屏的当前位置，错误提示弹窗仍居中显示
+    x_offset += face_shifts[face_shift_index].x;
+    y_offset += face_shifts[face_shift_index].y;
 
-    /* 绘制温度和湿度 */
-    u8g2_DrawStr(u8g2, 2 + x_offset, 62 + y_offset, data->temp_humi_str);
-
-    /* 如果需要，在最上层绘制错误信息弹窗 */
-    if (data->show_error_msg)
-    {
-        const char *msg = "Setting load failed";
-        u8g2_SetFont(u8g2, PROMPT_FONT); // 假设 PROMPT_FONT 是一个已定义的字体
-        uint16_t msg_w = u8g2_GetStrWidth(u8g2, msg);
-        uint16_t box_w = msg_w + 10;
-        uint16_t box_h = 16;
-        uint16_t box_x = (u8g2_GetDisplayWidth(u8g2) - box_w) / 2;
-        uint16_t box_y = (u8g2_GetDisplayHeight(u8g2) - box_h) / 2;
-
-        u8g2_SetDrawColor(u8g2, 0); // 绘制黑色背景
-        u8g2_DrawBox(u8g2, box_x, box_y, box_w, box_h);
-        u8g2_SetDrawColor(u8g2, 1); // 绘制白色边框和文字
-        u8g2_DrawFrame(u8g2, box_x, box_y, box_w, box_h);
-        u8g2_DrawStr(u8g2, box_x + 5, box_y + 12, msg);
-    }
+    UI_Face_Draw(&data->face, UI_Face_Get(data->face_index), page, u8g2, x_offset, y_offset);
 }
 
 /**
@@ -186,10 +284,29 @@ static void Page_main_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int1
  * @param[in] event 指向输入事件数据的指针
  * @return 无
  */
-static void Page_main_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+static void Page_main_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
 {
     if (event->event == INPUT_EVENT_COMFIRM_PRESSED)
     {
         Switch_Page(&g_page_main_menu); // 切换到菜单页
     }
-}
\ No newline at end of file
+    else if (event->event == INPUT_EVENT_ENCODER)
+    {
+        // 向右旋转编码器查看温度曲线，向左查看月历
+        if (event->value > 0)
+        {
+            Switch_Page_Ex(&g_page_history, PAGE_TRANS_SLIDE_UP);
+        }
+        else if (event->value < 0)
+        {
+            Switch_Page_Ex(&g_page_calendar, PAGE_TRANS_SLIDE_DOWN);
+        }
+    }
+    else if (event->event == INPUT_EVENT_ENCODER_PRESSED)
+    {
+        // 按下编码器切换到下一个表盘，下一次循环发现表盘变化后整页重绘
+        g_app_settings.clock_face = (uint8_t)((g_app_settings.clock_face + 1) % CLOCK_FACE_COUNT);
+        app_settings_mark_dirty();
+        Page_main_Loop(page);
+    }
+}
@@ -0,0 +1,199 @@
+/**
+ * @file      page_stopwatch.c
+ * @brief     秒表页面实现文件
+ * @details   从主菜单进入。中间为 1/100 秒的大号数字 "MM:SS.cc"，下方为最近一次计次。
+ *            计时由 app_chrono 按系统滴答完成，页面每一步只格式化一次当前值，
+ *            由 UI_Digits 只使变化的字符失效：通常每帧只有百分位和十分位两个字符被重绘和发送。
+ *            确认键开始/暂停；编码器按键在运行时计次、暂停时清零；返回键离开页面，秒表在后台继续运行。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_display.h"
+#include "app_i18n.h"
+#include "app_chrono.h"
+#include "app_glyph_cache.h"
+#include "app_fmt.h"
+#include "ui_digits.h"
+#include "input.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define SW_TITLE_Y 12  ///< 标题的基线Y坐标
+#define SW_DIGITS_Y 44 ///< 大号数字的基线Y坐标
+#define SW_DIGITS_TOP 16 ///< 大号数字的失效区域顶端 (页对齐)
+#define SW_DIGITS_H 32 ///< 大号数字的失效区域高度
+#define SW_LAP_Y 60    ///< 计次行的基线Y坐标
+#define SW_LAP_TOP 48  ///< 计次行的失效区域顶端 (页对齐)
+#define SW_LAP_H 16    ///< 计次行的失效区域高度
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 秒表页面的私有数据结构体
+ */
+typedef struct
+{
+    UI_Digits_t digits; ///< 大号数字
+    uint8_t laps;       ///< lap_str 对应的计次次数
+    char lap_str[16];   ///< 计次行 "#3  00:12.34"，没有计次时为空
+} Page_Stopwatch_Data;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Page_Stopwatch_Enter(const Page_Base *page);
+static void Page_Stopwatch_Loop(const Page_Base *page);
+static void Page_Stopwatch_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_Stopwatch_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static void Stopwatch_Format_Lap(Page_Stopwatch_Data *data);
+
+/* Private variables ---------------------------------------------------------*/
+PAGE_DATA_CHECK(Page_Stopwatch_Data); ///< 数据由页面管理器在进入时分配 (Page_Data)
+
+/* Public variables ----------------------------------------------------------*/
+/**
+ * @brief 秒表页面的全局实例
+ */
+const Page_Base g_page_stopwatch = {
+    .enter = Page_Stopwatch_Enter,
+    .exit = NULL,
+    .loop = Page_Stopwatch_Loop,
+    .draw = Page_Stopwatch_Draw,
+    .action = Page_Stopwatch_Action,
+    .page_name = "stopwatch",
+    .id = PAGE_ID_STOPWATCH};
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 按最近一次计次生成计次行
+ * @param[in,out] data 页面数据
+ * @return 无
+ */
+static void Stopwatch_Format_Lap(Page_Stopwatch_Data *data)
+{
+    uint32_t split;
+
+    data->laps = app_stopwatch_last_lap(&split);
+    if (data->laps == 0)
+    {
+        data->lap_str[0] = '\0';
+        return;
+    }
+    char *p = fmt_char(data->lap_str, '#');
+    p = fmt_uint(p, data->laps, 1);
+    p = fmt_str(p, "  ");
+    app_chrono_format(p, split);
+}
+
+/**
+ * @brief 秒表页面进入函数
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Stopwatch_Enter(const Page_Base *page)
+{
+    Page_Stopwatch_Data *data = Page_Data(page);
+    char text[UI_DIGITS_MAX + 1];
+
+    UI_Digits_Init(&data->digits, SW_DIGITS_TOP, SW_DIGITS_H);
+    app_chrono_format(text, app_stopwatch_elapsed());
+    UI_Digits_Set(&data->digits, page, text);
+    Stopwatch_Format_Lap(data);
+}
+
+/**
+ * @brief 秒表页面的逻辑循环函数
+ * @details 格式化当前累计时间，只使变化的字符失效；计次次数变化时使计次行失效。
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_Stopwatch_Loop(const Page_Base *page)
+{
+    Page_Stopwatch_Data *data = Page_Data(page);
+    char text[UI_DIGITS_MAX + 1];
+
+    app_chrono_format(text, app_stopwatch_elapsed());
+    UI_Digits_Set(&data->digits, page, text);
+
+    if (app_stopwatch_last_lap(NULL) != data->laps)
+    {
+        Stopwatch_Format_Lap(data);
+        Page_Invalidate_Rect(page, 0, SW_LAP_TOP, 128, SW_LAP_H);
+    }
+}
+
+/**
+ * @brief 秒表页面的绘制函数
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+static void Page_Stopwatch_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    Page_Stopwatch_Data *data = Page_Data(page);
+
+    u8g2_SetFont(u8g2, app_i18n_font(MENU_FONT));
+    if (Page_Strip_Text_Visible(u8g2, SW_TITLE_Y + y_offset))
+    {
+        app_i18n_draw(u8g2, 2 + x_offset, SW_TITLE_Y + y_offset, app_str(STR_MENU_STOPWATCH));
+    }
+
+    u8g2_SetFont(u8g2, CLOCK_FONT);
+    if (Page_Strip_Text_Visible(u8g2, SW_DIGITS_Y + y_offset))
+    {
+        int16_t x = (128 - (int16_t)Glyph_Cache_GetStrWidth(u8g2, data->digits.text)) / 2;
+        UI_Digits_Draw(&data->digits, page, u8g2, x, SW_DIGITS_Y, x_offset, y_offset);
+    }
+
+    if (data->lap_str[0] != '\0')
+    {
+        u8g2_SetFont(u8g2, DATE_TEMP_FONT);
+        if (Page_Strip_Text_Visible(u8g2, SW_LAP_Y + y_offset))
+        {
+            int16_t x = (128 - (int16_t)Page_Str_Width(u8g2, data->lap_str)) / 2;
+            u8g2_DrawStr(u8g2, x + x_offset, SW_LAP_Y + y_offset, data->lap_str);
+        }
+    }
+}
+
+/**
+ * @brief 秒表页面的事件处理函数
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针 (未使用)
+ * @param[in] event 指向输入事件数据的指针
+ * @return 无
+ */
+static void Page_Stopwatch_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+{
+    switch (event->event)
+    {
+    case INPUT_EVENT_COMFIRM_PRESSED:
+        if (app_stopwatch_running())
+        {
+            app_stopwatch_stop();
+        }
+        else
+        {
+            app_stopwatch_start();
+        }
+        break;
+    case INPUT_EVENT_ENCODER_PRESSED:
+        if (app_stopwatch_running())
+        {
+            (void)app_stopwatch_lap();
+        }
+        else
+        {
+            app_stopwatch_reset();
+        }
+        Page_Stopwatch_Loop(page);
+        break;
+    case INPUT_EVENT_BACK_PRESSED:
+        Go_Back_Page();
+        break;
+    default:
+        break;
+    }
+}
@@ -1,18 +1,21 @@
 /**
  * @file      page_time_date.c
  * @brief     日期设置页面
- * @details   使用老虎机式动画来设置年、月、日。
+ * @details   使用老虎机式动画来设置年、月、日，滚动的数值由 ui_slot 预先光栅化。
  * @author    SandOcean
- * @date      2025-09-17
- * @version   1.0
+ * @date      2025-10-08
+ * @version   1.1
  * @copyright Copyright (c) 2025 SandOcean
  */
 
 #include "app_display.h"
+#include "app_i18n.h"
+#include "ui_slot.h"
+#include "app_fmt.h"
+#include "app_anim.h"
 #include "app_config.h"
 #include "input.h"
 #include "DS3231.h"
-#include <stdio.h>
 #include <stdbool.h>
 
 /* Private defines -----------------------------------------------------------*/
@@ -31,8 +34,7 @@ typedef enum
     DATE_STATE_FOCUSED,      ///< 聚焦交互状态
     DATE_STATE_ZOOMING_OUT,  ///< 缩小动画状态
     DATE_STATE_SWITCHING,    ///< 准备切换焦点状态
-    DATE_STATE_SLOT_ROLLING, ///< 老虎机滚动动画状态
-    DATE_STATE_SHOW_MSG,     ///< 显示反馈信息状态
+    DATE_STATE_SLOT_ROLLING  ///< 老虎机滚动动画状态
 } Date_Set_State_e;
 
 /**
@@ -40,115 +42,70 @@ typedef enum
  */
 typedef struct
 {
-    Page_Base base;         // 必须包含基类作为第一个成员
     Time_t temp_date;       ///< 用于编辑的临时日期数据
     int8_t focus_index;     ///< 当前焦点: 0=年, 1=月, 2=日
     Date_Set_State_e state; ///< 页面动画状态
 
     uint32_t anim_start_time; ///< 通用动画起始时间戳
-    float anim_progress;      ///< 通用动画进度 (0.0 to 1.0)
+    q16_t anim_progress;      ///< 通用动画进度 (Q16, 0 to Q16_ONE)
 
-    float slot_anim_y_offset;      ///< 老虎机滚动动画的Y轴偏移
+    int16_t slot_anim_y_offset;    ///< 老虎机滚动动画的Y轴偏移
     int16_t slot_anim_direction;   ///< 老虎机滚动方向
     uint32_t slot_anim_start_time; ///< 老虎机滚动动画起始时间戳
 
     bool should_save_on_exit; ///< 退出时是否保存更改
-
-    const char *msg_text;    ///< 指向要显示的反馈信息字符串
-    uint32_t msg_start_time; ///< 反馈信息显示的开始时间戳
 } Page_Time_Date_Data_t;
 
 /* Private variables ---------------------------------------------------------*/
-static Page_Time_Date_Data_t g_page_data; ///< 日期设置页面的数据实例
+PAGE_DATA_CHECK(Page_Time_Date_Data_t); ///< 日期设置页面的数据由页面管理器在进入时分配 (Page_Data)
+
+static const int16_t value_positions_x[SLOT_ITEM_COUNT] = {21, 64, 107}; ///< 各项数值未聚焦时的中心X坐标
+static const int16_t label_positions_x[SLOT_ITEM_COUNT] = {18, 64, 107}; ///< 各项标签未聚焦时的中心X坐标
+static const App_Str_t labels[SLOT_ITEM_COUNT] = {STR_LABEL_YEAR, STR_LABEL_MONTH, STR_LABEL_DAY}; ///< 各项标签
 
 /* Private function prototypes -----------------------------------------------*/
-static void Page_Enter(Page_Base *page);
-static void Page_Exit(Page_Base *page);
-static void Page_Loop(Page_Base *page);
-static void Page_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
-static void Page_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
-static float lerp(float a, float b, float t);
-static bool is_leap_year(uint16_t year);
-static uint8_t get_max_days_in_month(uint16_t year, uint8_t month);
+static void Page_Enter(const Page_Base *page);
+static void Page_Exit(const Page_Base *page);
+static void Page_Loop(const Page_Base *page);
+static void Page_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static void Slot_Range(const Page_Time_Date_Data_t *data, int index, int *min_value, int *max_value);
+static void Slot_Text(char str[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX], const Page_Time_Date_Data_t *data, int index, int value, uint8_t digits);
+static void Build_Slot(u8g2_t *u8g2, const Page_Time_Date_Data_t *data, int index, int value, uint8_t digits, uint32_t key);
+static void Prefetch_Slot(const Page_Time_Date_Data_t *data);
 
 /* Public variables ----------------------------------------------------------*/
 /**
  * @brief 日期设置页面的全局实例
  */
-Page_Base g_page_time_date = {
+const Page_Base g_page_time_date = {
     .enter = Page_Enter,
     .exit = NULL,
     .loop = Page_Loop,
     .draw = Page_Draw,
     .action = Page_Action,
     .page_name = "DateSet",
-    .refresh_rate_ms = 16, // 动画需要高刷新率
-    .last_refresh_time = 0,
-};
+    .id = PAGE_ID_TIME_DATE};
 
 /* Function implementations --------------------------------------------------*/
 
-/**
- * @brief 辅助函数：线性插值
- * @param[in] a 起始值
- * @param[in] b 结束值
- * @param[in] t 插值进度 (0.0 to 1.0)
- * @return float - 插值结果。
- */
-static float lerp(float a, float b, float t)
-{
-    return a + t * (b - a);
-}
-
-/**
- * @brief 辅助函数：判断是否为闰年
- * @param[in] year 年份
- * @return bool 是否是闰年
- *         - @retval true 是闰年。
- *         - @retval false 不是闰年。
- */
-static bool is_leap_year(uint16_t year)
-{
-    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
-}
-
-/**
- * @brief 辅助函数：获取指定月份的最大天数
- * @param[in] year 年份
- * @param[in] month 月份
- * @return uint8_t - 该月份的最大天数。
- */
-static uint8_t get_max_days_in_month(uint16_t year, uint8_t month)
-{
-    if (month == 2)
-    {
-        return is_leap_year(year) ? 29 : 28;
-    }
-    else if (month == 4 || month == 6 || month == 9 || month == 11)
-    {
-        return 30;
-    }
-    else
-    {
-        return 31;
-    }
-}
-
 /**
  * @brief 页面进入函数
  * @param[in] page 指向页面基类的指针
  * @return 无
  */
-static void Page_Enter(Page_Base *page)
+static void Page_Enter(const Page_Base *page)
 {
-    DS3231_GetTime(&g_page_data.temp_date);
-
-    g_page_data.focus_index = 0;
-    g_page_data.state = DATE_STATE_ENTERING;
-    g_page_data.anim_start_time = HAL_GetTick();
-    g_page_data.anim_progress = 0;
-    g_page_data.slot_anim_y_offset = 0;
-    g_page_data.should_save_on_exit = false;
+    Page_Time_Date_Data_t *data = Page_Data(page);
+    DS3231_GetCachedTime(&data->temp_date);
+
+    data->focus_index = (int8_t)(Page_Resume_Get(page, 0) % SLOT_ITEM_COUNT);
+    data->state = DATE_STATE_ENTERING;
+    data->anim_start_time = Page_Now();
+    data->anim_progress = 0;
+    data->slot_anim_y_offset = 0;
+    data->should_save_on_exit = false;
+    UI_Slot_Reset();
 }
 
 /**
@@ -156,7 +113,7 @@ static void Page_Enter(Page_Base *page)
  * @param[in] page 指向页面基类的指针
  * @return 无
  */
-static void Page_Exit(Page_Base *page)
+static void Page_Exit(const Page_Base *page)
 {
     // 退出时的清理逻辑 (如果需要)
 }
@@ -166,85 +123,180 @@ static void Page_Exit(Page_Base *page)
  * @param[in] page 指向页面基类的指针
  * @return 无
  */
-static void Page_Loop(Page_Base *page)
+static void Page_Loop(const Page_Base *page)
 {
-    uint32_t elapsed = HAL_GetTick() - g_page_data.anim_start_time;
+    Page_Time_Date_Data_t *data = Page_Data(page);
+    // 放大/缩小/滚动动画期间逐帧重绘
+    if (data->state == DATE_STATE_ZOOMING_IN || data->state == DATE_STATE_ZOOMING_OUT ||
+        data->state == DATE_STATE_SLOT_ROLLING)
+    {
+        Page_Invalidate(page);
+    }
+
+    uint32_t elapsed = Page_Now() - data->anim_start_time;
 
-    switch (g_page_data.state)
+    switch (data->state)
     {
     case DATE_STATE_ENTERING:
         if (elapsed >= ANIM_DURATION_ENTER)
         {
-            g_page_data.state = DATE_STATE_ZOOMING_IN;
-            g_page_data.anim_start_time = HAL_GetTick();
+            data->state = DATE_STATE_ZOOMING_IN;
+            data->anim_start_time = Page_Now();
         }
         break;
 
     case DATE_STATE_ZOOMING_IN:
     {
-        if (elapsed >= ANIM_DURATION_ZOOM)
+        if (elapsed >= Anim_Scaled(ANIM_DURATION_ZOOM))
         {
-            g_page_data.anim_progress = 1.0f;
-            g_page_data.state = DATE_STATE_FOCUSED;
+            data->anim_progress = Q16_ONE;
+            data->state = DATE_STATE_FOCUSED;
         }
         else
         {
-            g_page_data.anim_progress = (float)elapsed / ANIM_DURATION_ZOOM;
+            data->anim_progress = Anim_Progress(elapsed, Anim_Scaled(ANIM_DURATION_ZOOM));
         }
         break;
     }
 
     case DATE_STATE_ZOOMING_OUT:
     {
-        if (elapsed >= ANIM_DURATION_ZOOM)
+        if (elapsed >= Anim_Scaled(ANIM_DURATION_ZOOM))
         {
-            g_page_data.anim_progress = 0.0f;
-            g_page_data.state = DATE_STATE_SWITCHING;
+            data->anim_progress = 0;
+            data->state = DATE_STATE_SWITCHING;
         }
         else
         {
-            g_page_data.anim_progress = 1.0f - ((float)elapsed / ANIM_DURATION_ZOOM);
+            data->anim_progress = Q16_ONE - Anim_Progress(elapsed, Anim_Scaled(ANIM_DURATION_ZOOM));
         }
         break;
     }
 
     case DATE_STATE_SWITCHING:
-        g_page_data.focus_index = (g_page_data.focus_index + 1) % SLOT_ITEM_COUNT;
-        g_page_data.state = DATE_STATE_ZOOMING_IN;
-        g_page_data.anim_start_time = HAL_GetTick();
+        data->focus_index = (data->focus_index + 1) % SLOT_ITEM_COUNT;
+        Page_Resume_Set(page, (uint8_t)data->focus_index);
+        data->state = DATE_STATE_ZOOMING_IN;
+        data->anim_start_time = Page_Now();
         break;
 
     case DATE_STATE_SLOT_ROLLING:
     {
-        uint32_t slot_elapsed = HAL_GetTick() - g_page_data.slot_anim_start_time;
+        uint32_t slot_elapsed = Page_Now() - data->slot_anim_start_time;
         uint32_t slot_duration = 150;
         if (slot_elapsed >= slot_duration)
         {
-            g_page_data.slot_anim_y_offset = 0;
-            g_page_data.state = DATE_STATE_FOCUSED;
+            data->slot_anim_y_offset = 0;
+            data->state = DATE_STATE_FOCUSED;
         }
         else
         {
-            float progress = (float)slot_elapsed / slot_duration;
-            progress = 1.0f - (1.0f - progress) * (1.0f - progress);
-            g_page_data.slot_anim_y_offset = g_page_data.slot_anim_direction * SLOT_ITEM_HEIGHT * (1.0f - progress);
+            q16_t progress = Anim_Ease(ANIM_EASE_OUT_QUAD, Anim_Progress(slot_elapsed, slot_duration));
+            data->slot_anim_y_offset = Anim_Lerp(data->slot_anim_direction * SLOT_ITEM_HEIGHT, 0, progress);
         }
         break;
     }
 
     case DATE_STATE_FOCUSED:
+        Prefetch_Slot(data);
         break;
+    }
+}
 
-    case DATE_STATE_SHOW_MSG:
-        if (HAL_GetTick() - g_page_data.msg_start_time >= 1000)
-        {
-            g_page_data.state = DATE_STATE_FOCUSED;
-            Go_Back_Page();
-        }
-        break;
+/**
+ * @brief 获取一项的取值范围
+ * @param[in] data 页面数据
+ * @param[in] index 项: 0=年, 1=月, 2=日
+ * @param[out] min_value 最小值
+ * @param[out] max_value 最大值 (日为当前年月的天数)
+ * @return 无
+ */
+static void Slot_Range(const Page_Time_Date_Data_t *data, int index, int *min_value, int *max_value)
+{
+    if (index == 0)
+    {
+        *min_value = 2000;
+        *max_value = 2099;
+    }
+    else if (index == 1)
+    {
+        *min_value = 1;
+        *max_value = 12;
+    }
+    else
+    {
+        *min_value = 1;
+        *max_value = Time_Days_In_Month(data->temp_date.year, data->temp_date.month);
     }
 }
 
+/**
+ * @brief 生成老虎机中三个值的字符串
+ * @details 上一个值和下一个值按该项的取值范围循环。
+ * @param[out] str 上一个值、当前值和下一个值
+ * @param[in] data 页面数据
+ * @param[in] index 聚焦的项: 0=年, 1=月, 2=日
+ * @param[in] value 当前值
+ * @param[in] digits 显示的位数
+ * @return 无
+ */
+static void Slot_Text(char str[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX], const Page_Time_Date_Data_t *data, int index, int value, uint8_t digits)
+{
+    int min_value, max_value;
+
+    Slot_Range(data, index, &min_value, &max_value);
+    fmt_uint(str[0], (value == min_value) ? max_value : value - 1, digits);
+    fmt_uint(str[1], value, digits);
+    fmt_uint(str[2], (value == max_value) ? min_value : value + 1, digits);
+}
+
+/**
+ * @brief 为聚焦的一项生成老虎机位图
+ * @param[in] u8g2 指向u8g2实例的指针 (当前字体为数值字体)
+ * @param[in] data 页面数据
+ * @param[in] index 聚焦的项: 0=年, 1=月, 2=日
+ * @param[in] value 当前值
+ * @param[in] digits 显示的位数
+ * @param[in] key 位图的键值
+ * @return 无
+ */
+static void Build_Slot(u8g2_t *u8g2, const Page_Time_Date_Data_t *data, int index, int value, uint8_t digits, uint32_t key)
+{
+    char str[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX];
+    const char *const text[UI_SLOT_ROWS] = {str[0], str[1], str[2]};
+
+    Slot_Text(str, data, index, value, digits);
+    UI_Slot_Build(u8g2, key, text, SLOT_ITEM_HEIGHT);
+}
+
+/**
+ * @brief 空闲时预先生成下一次旋转后的老虎机位图
+ * @details 按上一次的旋转方向预测下一个值 (进入页面后默认为增加)，旋转后的第一帧只需复制位图。
+ * @param[in] data 页面数据
+ * @return 无
+ */
+static void Prefetch_Slot(const Page_Time_Date_Data_t *data)
+{
+    char str[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX];
+    const char *const text[UI_SLOT_ROWS] = {str[0], str[1], str[2]};
+    int index = data->focus_index;
+    int value = (index == 0) ? data->temp_date.year : (index == 1) ? data->temp_date.month : data->temp_date.day;
+    int min_value, max_value;
+
+    // 滚动方向为 -1 表示数值增加
+    Slot_Range(data, index, &min_value, &max_value);
+    if (data->slot_anim_direction > 0)
+    {
+        value = (value == min_value) ? max_value : value - 1;
+    }
+    else
+    {
+        value = (value == max_value) ? min_value : value + 1;
+    }
+    Slot_Text(str, data, index, value, (index == 0) ? 4 : 2);
+    UI_Slot_Prefetch(((uint32_t)index << 16) | (uint16_t)value, text);
+}
+
 /**
  * @brief 页面绘制函数
  * @param[in] page 指向页面基类的指针
@@ -253,15 +305,12 @@ static void Page_Loop(Page_Base *page)
  * @param[in] y_offset 屏幕的Y方向偏移
  * @return 无
  */
-static void Page_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+static void Page_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
 {
-    float p = g_page_data.anim_progress;
-    p = p < 0.5 ? 2 * p * p : 1 - pow(-2 * p + 2, 2) / 2;
+    Page_Time_Date_Data_t *data = Page_Data(page);
+    q16_t p = Anim_Ease(ANIM_EASE_IN_OUT_QUAD, data->anim_progress);
 
-    const int16_t value_positions_x[] = {21, 64, 107};
     const int16_t value_y_small = 36;
-
-    const int16_t label_positions_x[] = {18, 64, 107};
     const int16_t label_y_small = 12;
 
     const int16_t focused_value_x = 64;
@@ -269,25 +318,24 @@ static void Page_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y
     const int16_t focused_label_x = 12;
     const int16_t focused_label_y = 12;
 
-    const char *labels[] = {"Year", "Mon", "Day"};
     char str[6];
 
     for (int i = 0; i < SLOT_ITEM_COUNT; i++)
     {
-        bool is_focus_target = (i == g_page_data.focus_index);
+        bool is_focus_target = (i == data->focus_index);
 
         int16_t current_value_x, current_value_y, current_label_x, current_label_y;
         const uint8_t *value_font, *label_font;
 
         if (is_focus_target)
         {
-            current_value_x = lerp(value_positions_x[i], focused_value_x, p);
-            current_value_y = lerp(value_y_small, focused_value_y, p);
+            current_value_x = Anim_Lerp(value_positions_x[i], focused_value_x, p);
+            current_value_y = Anim_Lerp(value_y_small, focused_value_y, p);
 
-            current_label_x = lerp(label_positions_x[i], focused_label_x, p);
-            current_label_y = lerp(label_y_small, focused_label_y, p);
+            current_label_x = Anim_Lerp(label_positions_x[i], focused_label_x, p);
+            current_label_y = Anim_Lerp(label_y_small, focused_label_y, p);
 
-            value_font = (p > 0.5) ? DATE_FONT_VALUE_LARGE : DATE_FONT_VALUE_SMALL;
+            value_font = (p > Q16_HALF) ? DATE_FONT_VALUE_LARGE : DATE_FONT_VALUE_SMALL;
             label_font = DATE_FONT_LABEL;
         }
         else
@@ -300,69 +348,50 @@ static void Page_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y
             label_font = DATE_FONT_LABEL;
         }
 
-        if (!is_focus_target && p > 0.1)
+        if (!is_focus_target && p > Q16_ONE / 10)
         {
         }
         else
         {
-            u8g2_SetFont(u8g2, label_font);
-            int16_t label_width = u8g2_GetStrWidth(u8g2, labels[i]);
-            u8g2_DrawStr(u8g2, current_label_x - (label_width / 2) + x_offset, current_label_y + y_offset, labels[i]);
+            u8g2_SetFont(u8g2, app_i18n_font(label_font));
+            if (Page_Strip_Text_Visible(u8g2, current_label_y + y_offset))
+            {
+                int16_t label_width = app_str_width(u8g2, labels[i]);
+                app_i18n_draw(u8g2, current_label_x - (label_width / 2) + x_offset, current_label_y + y_offset, app_str(labels[i]));
+            }
 
             int value = 0;
-            const char *format = "%02d";
+            uint8_t digits = 2;
             if (i == 0)
             {
-                value = g_page_data.temp_date.year;
-                format = "%04d";
+                value = data->temp_date.year;
+                digits = 4;
             }
             else if (i == 1)
             {
-                value = g_page_data.temp_date.month;
+                value = data->temp_date.month;
             }
             else
             {
-                value = g_page_data.temp_date.day;
+                value = data->temp_date.day;
             }
 
             u8g2_SetFont(u8g2, value_font);
-            sprintf(str, format, value);
-            int16_t text_width = u8g2_GetStrWidth(u8g2, str);
-            int16_t draw_x = current_value_x - (text_width / 2);
 
-            if (is_focus_target && (g_page_data.state == DATE_STATE_FOCUSED || g_page_data.state == DATE_STATE_SLOT_ROLLING))
+            if (is_focus_target && (data->state == DATE_STATE_FOCUSED || data->state == DATE_STATE_SLOT_ROLLING))
             {
                 int baseline_offset = 6;
-                float y_off = g_page_data.slot_anim_y_offset;
+                uint32_t key = ((uint32_t)i << 16) | (uint16_t)value;
 
-                int value_above, value_below;
-                if (i == 0)
-                {
-                    value_above = (value == 2000) ? 2099 : value - 1;
-                    value_below = (value == 2099) ? 2000 : value + 1;
-                }
-                else if (i == 1)
-                {
-                    value_above = (value == 1) ? 12 : value - 1;
-                    value_below = (value == 12) ? 1 : value + 1;
-                }
-                else
+                // 数值变化时才重新生成位图，滚动的每一帧只复制位图
+                if (!UI_Slot_Ready(key))
                 {
-                    uint8_t max_days = get_max_days_in_month(g_page_data.temp_date.year, g_page_data.temp_date.month);
-                    value_above = (value == 1) ? max_days : value - 1;
-                    value_below = (value == max_days) ? 1 : value + 1;
+                    Build_Slot(u8g2, data, i, value, digits, key);
                 }
+                int16_t draw_x = current_value_x - (UI_Slot_Width() / 2);
+                UI_Slot_Draw(u8g2, draw_x + x_offset, current_value_y + baseline_offset, data->slot_anim_y_offset);
 
-                sprintf(str, format, value);
-                u8g2_DrawStr(u8g2, draw_x + x_offset, current_value_y + baseline_offset + y_off, str);
-
-                sprintf(str, format, value_above);
-                u8g2_DrawStr(u8g2, draw_x + x_offset, current_value_y - SLOT_ITEM_HEIGHT + baseline_offset + y_off, str);
-
-                sprintf(str, format, value_below);
-                u8g2_DrawStr(u8g2, draw_x + x_offset, current_value_y + SLOT_ITEM_HEIGHT + baseline_offset + y_off, str);
-
-                int16_t arrow_width = u8g2_GetStrWidth(u8g2, ">");
+                int16_t arrow_width = Page_Str_Width(u8g2, ">");
                 int16_t arrow_x = draw_x - arrow_width - 10;
                 int16_t arrow_y = current_value_y + baseline_offset;
                 u8g2_DrawStr(u8g2, arrow_x + x_offset, arrow_y + y_offset, ">");
@@ -370,26 +399,25 @@ static void Page_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y
             else
             {
                 int baseline_offset = 5;
-                u8g2_DrawStr(u8g2, draw_x + x_offset, current_value_y + baseline_offset, str);
+                fmt_uint(str, value, digits);
+                bool zoomed = false;
+
+                // 聚焦动画中按进度连续缩放数值，字形缓存不可用时在中点切换字体
+                if (is_focus_target && (data->state == DATE_STATE_ZOOMING_IN || data->state == DATE_STATE_ZOOMING_OUT))
+                {
+                    zoomed = UI_Slot_Draw_Zoom(u8g2, DATE_FONT_VALUE_SMALL, DATE_FONT_VALUE_LARGE,
+                                               current_value_x + x_offset, current_value_y + baseline_offset, str, p);
+                }
+                if (!zoomed)
+                {
+                    u8g2_SetFont(u8g2, value_font);
+                    int16_t text_width = Page_Str_Width(u8g2, str);
+                    int16_t draw_x = current_value_x - (text_width / 2);
+                    u8g2_DrawStr(u8g2, draw_x + x_offset, current_value_y + baseline_offset, str);
+                }
             }
         }
     }
-    if (g_page_data.state == DATE_STATE_SHOW_MSG)
-    {
-        u8g2_SetFont(u8g2, PROMPT_FONT);
-        uint16_t msg_w = u8g2_GetStrWidth(u8g2, g_page_data.msg_text);
-        uint16_t box_w = msg_w + 10;
-        uint16_t box_h = 16;
-        uint16_t box_x = (u8g2_GetDisplayWidth(u8g2) - box_w) / 2;
-        uint16_t box_y = (u8g2_GetDisplayHeight(u8g2) - box_h) / 2;
-
-        u8g2_SetDrawColor(u8g2, 0);
-        u8g2_DrawBox(u8g2, box_x, box_y, box_w, box_h);
-        u8g2_SetDrawColor(u8g2, 1);
-        u8g2_DrawFrame(u8g2, box_x, box_y, box_w, box_h);
-
-        u8g2_DrawStr(u8g2, box_x + 5, box_y + 12, g_page_data.msg_text);
-    }
 }
 
 /**
@@ -399,9 +427,10 @@ static void Page_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y
  * @param[in] event 指向输入事件数据的指针
  * @return 无
  */
-static void Page_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+static void Page_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
 {
-    if (g_page_data.state != DATE_STATE_FOCUSED)
+    Page_Time_Date_Data_t *data = Page_Data(page);
+    if (data->state != DATE_STATE_FOCUSED)
     {
         if (event->event == INPUT_EVENT_BACK_PRESSED)
             Go_Back_Page();
@@ -412,61 +441,53 @@ static void Page_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t
     {
     case INPUT_EVENT_ENCODER:
     {
-        switch (g_page_data.focus_index)
+        // 数值调节使用加速增量，快速旋转时可以一次跨过多个值，按取模方式循环
+        int16_t step = event->accel_value;
+        switch (data->focus_index)
         {
         case 0:
-            g_page_data.temp_date.year += event->value;
-            if (g_page_data.temp_date.year > 2099)
-                g_page_data.temp_date.year = 2000;
-            if (g_page_data.temp_date.year < 2000)
-                g_page_data.temp_date.year = 2099;
+            data->temp_date.year = 2000 + ((data->temp_date.year - 2000 + step) % 100 + 100) % 100;
             break;
         case 1:
-            g_page_data.temp_date.month += event->value;
-            if (g_page_data.temp_date.month > 12)
-                g_page_data.temp_date.month = 1;
-            if (g_page_data.temp_date.month < 1)
-                g_page_data.temp_date.month = 12;
+            data->temp_date.month = 1 + ((data->temp_date.month - 1 + step) % 12 + 12) % 12;
             break;
         case 2:
         {
-            uint8_t max_days = get_max_days_in_month(g_page_data.temp_date.year, g_page_data.temp_date.month);
-            g_page_data.temp_date.day += event->value;
-            if (g_page_data.temp_date.day > max_days)
-                g_page_data.temp_date.day = 1;
-            if (g_page_data.temp_date.day < 1)
-                g_page_data.temp_date.day = max_days;
+            uint8_t max_days = Time_Days_In_Month(data->temp_date.year, data->temp_date.month);
+            data->temp_date.day = 1 + ((data->temp_date.day - 1 + step) % max_days + max_days) % max_days;
             break;
         }
         }
 
-        uint8_t max_days_after_change = get_max_days_in_month(g_page_data.temp_date.year, g_page_data.temp_date.month);
-        if (g_page_data.temp_date.day > max_days_after_change)
+        uint8_t max_days_after_change = Time_Days_In_Month(data->temp_date.year, data->temp_date.month);
+        if (data->temp_date.day > max_days_after_change)
         {
-            g_page_data.temp_date.day = max_days_after_change;
+            data->temp_date.day = max_days_after_change;
         }
 
-        g_page_data.state = DATE_STATE_SLOT_ROLLING;
-        g_page_data.slot_anim_direction = (event->value > 0) ? -1 : 1;
-        g_page_data.slot_anim_start_time = HAL_GetTick();
-        g_page_data.slot_anim_y_offset = g_page_data.slot_anim_direction * SLOT_ITEM_HEIGHT;
+        data->state = DATE_STATE_SLOT_ROLLING;
+        Page_Invalidate(page);
+        data->slot_anim_direction = (event->value > 0) ? -1 : 1;
+        data->slot_anim_start_time = Page_Now();
+        data->slot_anim_y_offset = data->slot_anim_direction * SLOT_ITEM_HEIGHT;
         break;
     }
     case INPUT_EVENT_ENCODER_PRESSED:
-        g_page_data.state = DATE_STATE_ZOOMING_OUT;
-        g_page_data.anim_start_time = HAL_GetTick();
+        data->state = DATE_STATE_ZOOMING_OUT;
+        Page_Invalidate(page);
+        data->anim_start_time = Page_Now();
         break;
 
     case INPUT_EVENT_COMFIRM_PRESSED:
         Time_t now;
-        DS3231_GetTime(&now);
-        now.year = g_page_data.temp_date.year;
-        now.month = g_page_data.temp_date.month;
-        now.day = g_page_data.temp_date.day;
-        DS3231_SetTime(&now);
-        g_page_data.msg_text = "Date Saved!";
-        g_page_data.state = DATE_STATE_SHOW_MSG;
-        g_page_data.msg_start_time = HAL_GetTick();
+        DS3231_Cache_Snap_t snap;
+        DS3231_Cache_Get(&snap); // 缓存与秒脉冲同步，不必在按键处理中阻塞读取芯片
+        Time_From_Epoch(snap.epoch, &now);
+        now.year = data->temp_date.year;
+        now.month = data->temp_date.month;
+        now.day = data->temp_date.day;
+        DS3231_SetTimeSync(Time_To_Epoch(&now), snap.edge_ms); // 在下一个秒脉冲写入，时分秒和秒相位不变
+        Page_Toast(app_str(STR_MSG_DATE_SAVED), PAGE_TOAST_MS, Page_Toast_Back); // 显示1秒后返回上一页
         break;
     case INPUT_EVENT_BACK_PRESSED:
         Go_Back_Page();
@@ -9,6 +9,8 @@
  */
 
 #include "app_display.h"
+#include "app_i18n.h"
+#include "ui_list.h"
 #include "input.h"
 
 /* Private defines -----------------------------------------------------------*/
@@ -20,101 +22,94 @@
 
 /* Private variables ---------------------------------------------------------*/
 ///< 菜单项文本数组
-static const char *menu_items[TIME_SET_ITEM_COUNT] = {
-    "Date",
-    "Time",
-    "DST" // Daylight Saving Time
+static const App_Str_t menu_items[TIME_SET_ITEM_COUNT] = {
+    STR_MENU_DATE,
+    STR_MENU_TIME,
+    STR_MENU_DST // Daylight Saving Time
 };
 
-/**
- * @brief 菜单动画状态枚举
- */
-typedef enum
-{
-    TIME_SET_STATE_IDLE,     ///< 空闲状态
-    TIME_SET_STATE_ANIMATING ///< 动画播放中状态
-} Time_Set_State_e;
+///< 各菜单项确认后进入的页面，与 menu_items 一一对应
+static const uint8_t menu_targets[TIME_SET_ITEM_COUNT] = {
+    PAGE_ID_TIME_DATE,
+    PAGE_ID_TIME_TIME,
+    PAGE_ID_TIME_DST};
 
 /**
  * @brief 时间设置子菜单页面的私有数据结构体
  */
 typedef struct
 {
-    int8_t selected_index;    ///< 当前选中的菜单项索引
-    Time_Set_State_e state;   ///< 菜单的动画状态
-    float anim_current_y;     ///< 高亮框当前的Y坐标 (用于动画插值)
-    int16_t anim_start_y;     ///< 高亮框动画的起始Y坐标
-    int16_t anim_target_y;    ///< 高亮框动画的目标Y坐标
-    uint32_t anim_start_time; ///< 动画开始的系统时间
-    uint32_t anim_duration;   ///< 动画持续时间 (ms)
+    UI_List_t list; ///< 菜单列表
 } Page_Time_Set_Data_t;
 
-static Page_Time_Set_Data_t g_page_time_set_data; ///< 时间设置子菜单页面的数据实例
+PAGE_DATA_CHECK(Page_Time_Set_Data_t); ///< 时间设置子菜单页面的数据由页面管理器在进入时分配 (Page_Data)
 
 /* Private function prototypes -----------------------------------------------*/
-static void Page_Time_Set_Enter(Page_Base *page);
-static void Page_Time_Set_Loop(Page_Base *page);
-static void Page_Time_Set_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
-static void Page_Time_Set_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static void Page_Time_Set_Enter(const Page_Base *page);
+static void Page_Time_Set_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_Time_Set_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static uint16_t Menu_Count(const void *ctx);
+static const char *Menu_Text(const void *ctx, uint16_t index);
+
+///< 菜单列表的布局
+static const UI_List_Config_t menu_list = {
+    .x = TIME_SET_LEFT_X,
+    .y = TIME_SET_TOP_Y,
+    .w = TIME_SET_WIDTH,
+    .text_x = 15,
+    .item_h = TIME_SET_ITEM_HEIGHT,
+    .baseline = 12,
+    .rows = TIME_SET_ITEM_COUNT,
+    .wrap = true,
+    .font = MENU_FONT,
+    .count = Menu_Count,
+    .text = Menu_Text};
 
 /* Public variables ----------------------------------------------------------*/
 /**
  * @brief 时间设置子菜单页面的全局实例
  */
-Page_Base g_page_time_set = {
+const Page_Base g_page_time_set = {
     .enter = Page_Time_Set_Enter,
     .exit = NULL,
-    .loop = Page_Time_Set_Loop,
+    .loop = NULL, // 高亮框的动画由补间动画池驱动，不需要 loop 逻辑
     .draw = Page_Time_Set_Draw,
     .action = Page_Time_Set_Action,
     .page_name = "TimeSet",
-    .refresh_rate_ms = 16, // ~60FPS
-    .last_refresh_time = 0};
+    .id = PAGE_ID_TIME_SET};
 
 /* Function implementations --------------------------------------------------*/
 
 /**
- * @brief 页面进入函数
- * @param[in] page 指向页面基类的指针
- * @return 无
+ * @brief 获取菜单项数量
+ * @param[in] ctx 页面数据 (未使用)
+ * @return uint16_t 菜单项数量
  */
-static void Page_Time_Set_Enter(Page_Base *page)
+static uint16_t Menu_Count(const void *ctx)
 {
-    Page_Time_Set_Data_t *data = &g_page_time_set_data;
-    data->state = TIME_SET_STATE_IDLE;
-    data->selected_index = 0;
-
-    int16_t initial_y = TIME_SET_TOP_Y + (data->selected_index * TIME_SET_ITEM_HEIGHT);
-    data->anim_current_y = initial_y;
-    data->anim_target_y = initial_y;
-    data->anim_start_y = initial_y;
+    return TIME_SET_ITEM_COUNT;
 }
 
 /**
- * @brief 页面循环逻辑函数 (处理动画)
+ * @brief 获取菜单项文本
+ * @param[in] ctx 页面数据 (未使用)
+ * @param[in] index 菜单项索引
+ * @return const char* 菜单项文本
+ */
+static const char *Menu_Text(const void *ctx, uint16_t index)
+{
+    return app_str(menu_items[index]);
+}
+
+/**
+ * @brief 页面进入函数
  * @param[in] page 指向页面基类的指针
  * @return 无
  */
-static void Page_Time_Set_Loop(Page_Base *page)
+static void Page_Time_Set_Enter(const Page_Base *page)
 {
-    Page_Time_Set_Data_t *data = &g_page_time_set_data;
-
-    if (data->state != TIME_SET_STATE_ANIMATING)
-    {
-        return;
-    }
-
-    uint32_t elapsed = HAL_GetTick() - data->anim_start_time;
-    if (elapsed >= data->anim_duration)
-    {
-        data->anim_current_y = data->anim_target_y;
-        data->state = TIME_SET_STATE_IDLE;
-    }
-    else
-    {
-        float progress = (float)elapsed / data->anim_duration;
-        data->anim_current_y = data->anim_start_y + (data->anim_target_y - data->anim_start_y) * progress;
-    }
+    Page_Time_Set_Data_t *data = Page_Data(page);
+    UI_List_Init(&data->list, &menu_list, data, Page_Resume_Get(page, 0));
 }
 
 /**
@@ -125,33 +120,11 @@ static void Page_Time_Set_Loop(Page_Base *page)
  * @param[in] y_offset 屏幕的Y方向偏移
  * @return 无
  */
-static void Page_Time_Set_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+static void Page_Time_Set_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
 {
-    Page_Time_Set_Data_t *data = &g_page_time_set_data;
-
-    // 绘制菜单项
-    u8g2_SetFont(u8g2, MENU_FONT);
-    u8g2_SetDrawColor(u8g2, 1);
-    for (int i = 0; i < TIME_SET_ITEM_COUNT; i++)
-    {
-        u8g2_DrawStr(u8g2, 15 + x_offset, (i * TIME_SET_ITEM_HEIGHT) + TIME_SET_TOP_Y + 12 + y_offset, menu_items[i]);
-    }
+    Page_Time_Set_Data_t *data = Page_Data(page);
 
-    // 绘制反色高亮框
-    int16_t clip_x0 = TIME_SET_LEFT_X + x_offset;
-    int16_t clip_y0 = (int16_t)data->anim_current_y + y_offset;
-    int16_t clip_x1 = clip_x0 + TIME_SET_WIDTH;
-    int16_t clip_y1 = clip_y0 + TIME_SET_ITEM_HEIGHT;
-    u8g2_SetClipWindow(u8g2, clip_x0, clip_y0, clip_x1, clip_y1);
-    u8g2_SetDrawColor(u8g2, 1);
-    u8g2_DrawBox(u8g2, clip_x0, clip_y0, TIME_SET_WIDTH, TIME_SET_ITEM_HEIGHT);
-    u8g2_SetDrawColor(u8g2, 0);
-    for (int i = 0; i < TIME_SET_ITEM_COUNT; i++)
-    {
-        u8g2_DrawStr(u8g2, 15 + x_offset, (i * TIME_SET_ITEM_HEIGHT) + TIME_SET_TOP_Y + 12 + y_offset, menu_items[i]);
-    }
-    u8g2_SetMaxClipWindow(u8g2);
-    u8g2_SetDrawColor(u8g2, 1);
+    UI_List_Draw(&data->list, u8g2, x_offset, y_offset);
 }
 
 /**
@@ -161,49 +134,18 @@ static void Page_Time_Set_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset,
  * @param[in] event 指向输入事件数据的指针
  * @return 无
  */
-static void Page_Time_Set_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+static void Page_Time_Set_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
 {
-    Page_Time_Set_Data_t *data = &g_page_time_set_data;
-
-    if (data->state == TIME_SET_STATE_ANIMATING)
-    {
-        return;
-    }
+    Page_Time_Set_Data_t *data = Page_Data(page);
 
     switch (event->event)
     {
     case INPUT_EVENT_ENCODER:
-    {
-        int8_t old_index = data->selected_index;
-        data->selected_index += event->value;
-        if (data->selected_index >= TIME_SET_ITEM_COUNT)
-            data->selected_index = 0;
-        if (data->selected_index < 0)
-            data->selected_index = TIME_SET_ITEM_COUNT - 1;
-
-        if (old_index != data->selected_index)
-        {
-            data->state = TIME_SET_STATE_ANIMATING;
-            data->anim_start_time = HAL_GetTick();
-            data->anim_duration = 150;
-            data->anim_start_y = data->anim_current_y;
-            data->anim_target_y = TIME_SET_TOP_Y + (data->selected_index * TIME_SET_ITEM_HEIGHT);
-        }
+        UI_List_Move(&data->list, event->value);
+        Page_Resume_Set(page, (uint8_t)data->list.selected);
         break;
-    }
     case INPUT_EVENT_COMFIRM_PRESSED:
-        switch (data->selected_index)
-        {
-        case 0: // Date
-            Switch_Page(&g_page_time_date);
-            break;
-        case 1: // Time
-            Switch_Page(&g_page_time_time);
-            break;
-        case 2: // DST
-            Switch_Page(&g_page_time_dst);
-            break;
-        }
+        Switch_Page_Id(menu_targets[data->list.selected]);
         break;
 
     case INPUT_EVENT_BACK_PRESSED:
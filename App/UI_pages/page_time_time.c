@@ -1,18 +1,21 @@
 /**
  * @file      page_time_time.c
  * @brief     时间设置页面
- * @details   使用老虎机式动画来设置时、分、秒。
+ * @details   使用老虎机式动画来设置时、分、秒，滚动的数值由 ui_slot 预先光栅化。
  * @author    SandOcean
- * @date      2025-09-17
- * @version   1.0
+ * @date      2025-10-08
+ * @version   1.1
  * @copyright Copyright (c) 2025 SandOcean
  */
 
 #include "app_display.h"
+#include "app_i18n.h"
+#include "ui_slot.h"
+#include "app_fmt.h"
+#include "app_anim.h"
 #include "app_config.h"
 #include "input.h"
 #include "DS3231.h"
-#include <stdio.h>
 #include <stdbool.h>
 
 /* Private defines -----------------------------------------------------------*/
@@ -31,8 +34,7 @@ typedef enum
     TIME_STATE_FOCUSED,      ///< 聚焦交互状态
     TIME_STATE_ZOOMING_OUT,  ///< 缩小动画状态
     TIME_STATE_SWITCHING,    ///< 准备切换焦点状态
-    TIME_STATE_SLOT_ROLLING, ///< 老虎机滚动动画状态
-    TIME_STATE_SHOW_MSG      ///< 显示反馈信息状态
+    TIME_STATE_SLOT_ROLLING  ///< 老虎机滚动动画状态
 } Time_Set_State_e;
 
 /**
@@ -45,63 +47,58 @@ typedef struct
     Time_Set_State_e state; ///< 页面动画状态
 
     uint32_t anim_start_time; ///< 通用动画起始时间戳
-    float anim_progress;      ///< 通用动画进度 (0.0 to 1.0)
+    q16_t anim_progress;      ///< 通用动画进度 (Q16, 0 to Q16_ONE)
 
-    float slot_anim_y_offset;      ///< 老虎机滚动动画的Y轴偏移
+    int16_t slot_anim_y_offset;    ///< 老虎机滚动动画的Y轴偏移
     int16_t slot_anim_direction;   ///< 老虎机滚动方向
     uint32_t slot_anim_start_time; ///< 老虎机滚动动画起始时间戳
-
-    const char *msg_text;    ///< 指向要显示的反馈信息字符串
-    uint32_t msg_start_time; ///< 反馈信息显示的开始时间戳
 } Page_Time_Time_Data_t;
 
 /* Private variables ---------------------------------------------------------*/
-static Page_Time_Time_Data_t g_page_data; ///< 时间设置页面的数据实例
+PAGE_DATA_CHECK(Page_Time_Time_Data_t); ///< 时间设置页面的数据由页面管理器在进入时分配 (Page_Data)
+
+static const int16_t value_positions_x[TIME_SLOT_ITEM_COUNT] = {21, 64, 107}; ///< 各项数值未聚焦时的中心X坐标
+static const int16_t label_positions_x[TIME_SLOT_ITEM_COUNT] = {18, 64, 107}; ///< 各项标签未聚焦时的中心X坐标
+static const App_Str_t labels[TIME_SLOT_ITEM_COUNT] = {STR_LABEL_HOUR, STR_LABEL_MINUTE, STR_LABEL_SECOND}; ///< 各项标签
 
 /* Private function prototypes -----------------------------------------------*/
-static void Page_Enter(Page_Base *page);
-static void Page_Loop(Page_Base *page);
-static void Page_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
-static void Page_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static void Page_Enter(const Page_Base *page);
+static void Page_Loop(const Page_Base *page);
+static void Page_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static void Slot_Text(char str[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX], int index, int value);
+static void Build_Slot(u8g2_t *u8g2, int index, int value, uint32_t key);
+static void Prefetch_Slot(const Page_Time_Time_Data_t *data);
 
 /* Public variables ----------------------------------------------------------*/
 /**
  * @brief 时间设置页面的全局实例
  */
-Page_Base g_page_time_time = {
+const Page_Base g_page_time_time = {
     .enter = Page_Enter,
     .exit = NULL,
     .loop = Page_Loop,
     .draw = Page_Draw,
     .action = Page_Action,
     .page_name = "TimeSetTime",
-    .refresh_rate_ms = 16,
-    .last_refresh_time = 0,
-};
+    .id = PAGE_ID_TIME_TIME};
 
 /* Function implementations --------------------------------------------------*/
-/**
- * @brief 辅助函数：线性插值
- * @param[in] a 起始值
- * @param[in] b 结束值
- * @param[in] t 插值进度 (0.0 to 1.0)
- * @return float - 插值结果。
- */
-static float lerp(float a, float b, float t) { return a + t * (b - a); }
-
 /**
  * @brief 页面进入函数
  * @param[in] page 指向页面基类的指针
  * @return 无
  */
-static void Page_Enter(Page_Base *page)
+static void Page_Enter(const Page_Base *page)
 {
-    DS3231_GetTime(&g_page_data.temp_time);
-    g_page_data.focus_index = 0;
-    g_page_data.state = TIME_STATE_ENTERING;
-    g_page_data.anim_start_time = HAL_GetTick();
-    g_page_data.anim_progress = 0;
-    g_page_data.slot_anim_y_offset = 0;
+    Page_Time_Time_Data_t *data = Page_Data(page);
+    DS3231_GetCachedTime(&data->temp_time);
+    data->focus_index = (int8_t)(Page_Resume_Get(page, 0) % TIME_SLOT_ITEM_COUNT);
+    data->state = TIME_STATE_ENTERING;
+    data->anim_start_time = Page_Now();
+    data->anim_progress = 0;
+    data->slot_anim_y_offset = 0;
+    UI_Slot_Reset();
 }
 
 /**
@@ -109,78 +106,134 @@ static void Page_Enter(Page_Base *page)
  * @param[in] page 指向页面基类的指针
  * @return 无
  */
-static void Page_Loop(Page_Base *page)
+static void Page_Loop(const Page_Base *page)
 {
-    uint32_t elapsed = HAL_GetTick() - g_page_data.anim_start_time;
-    switch (g_page_data.state)
+    Page_Time_Time_Data_t *data = Page_Data(page);
+    // 放大/缩小/滚动动画期间逐帧重绘
+    if (data->state == TIME_STATE_ZOOMING_IN || data->state == TIME_STATE_ZOOMING_OUT ||
+        data->state == TIME_STATE_SLOT_ROLLING)
+    {
+        Page_Invalidate(page);
+    }
+
+    uint32_t elapsed = Page_Now() - data->anim_start_time;
+    switch (data->state)
     {
     case TIME_STATE_ENTERING:
         if (elapsed >= ANIM_DURATION_ENTER)
         {
-            g_page_data.state = TIME_STATE_ZOOMING_IN;
-            g_page_data.anim_start_time = HAL_GetTick();
+            data->state = TIME_STATE_ZOOMING_IN;
+            data->anim_start_time = Page_Now();
         }
         break;
     case TIME_STATE_ZOOMING_IN:
     { // 使用花括号，避免编译器警告
-        if (elapsed >= ANIM_DURATION_ZOOM)
+        if (elapsed >= Anim_Scaled(ANIM_DURATION_ZOOM))
         {
-            g_page_data.anim_progress = 1.0f;
-            g_page_data.state = TIME_STATE_FOCUSED;
+            data->anim_progress = Q16_ONE;
+            data->state = TIME_STATE_FOCUSED;
         }
         else
         {
-            g_page_data.anim_progress = (float)elapsed / ANIM_DURATION_ZOOM;
+            data->anim_progress = Anim_Progress(elapsed, Anim_Scaled(ANIM_DURATION_ZOOM));
         }
         break;
     }
     case TIME_STATE_ZOOMING_OUT:
     {
-        if (elapsed >= ANIM_DURATION_ZOOM)
+        if (elapsed >= Anim_Scaled(ANIM_DURATION_ZOOM))
         {
-            g_page_data.anim_progress = 0.0f;
-            g_page_data.state = TIME_STATE_SWITCHING; // 应该切换到 SWITCHING 状态
+            data->anim_progress = 0;
+            data->state = TIME_STATE_SWITCHING; // 应该切换到 SWITCHING 状态
         }
         else
         {
-            g_page_data.anim_progress = 1.0f - ((float)elapsed / ANIM_DURATION_ZOOM);
+            data->anim_progress = Q16_ONE - Anim_Progress(elapsed, Anim_Scaled(ANIM_DURATION_ZOOM));
         }
         break;
     }
     case TIME_STATE_SWITCHING:
-        g_page_data.focus_index = (g_page_data.focus_index + 1) % TIME_SLOT_ITEM_COUNT;
-        g_page_data.state = TIME_STATE_ZOOMING_IN;
-        g_page_data.anim_start_time = HAL_GetTick();
+        data->focus_index = (data->focus_index + 1) % TIME_SLOT_ITEM_COUNT;
+        Page_Resume_Set(page, (uint8_t)data->focus_index);
+        data->state = TIME_STATE_ZOOMING_IN;
+        data->anim_start_time = Page_Now();
         break;
     case TIME_STATE_SLOT_ROLLING:
     {
-        uint32_t slot_elapsed = HAL_GetTick() - g_page_data.slot_anim_start_time;
+        uint32_t slot_elapsed = Page_Now() - data->slot_anim_start_time;
         uint32_t slot_duration = 150;
         if (slot_elapsed >= slot_duration)
         {
-            g_page_data.slot_anim_y_offset = 0;
-            g_page_data.state = TIME_STATE_FOCUSED;
+            data->slot_anim_y_offset = 0;
+            data->state = TIME_STATE_FOCUSED;
         }
         else
         {
-            float progress = (float)slot_elapsed / slot_duration;
-            progress = 1.0f - (1.0f - progress) * (1.0f - progress);
-            g_page_data.slot_anim_y_offset = g_page_data.slot_anim_direction * TIME_SLOT_ITEM_HEIGHT * (1.0f - progress);
+            q16_t progress = Anim_Ease(ANIM_EASE_OUT_QUAD, Anim_Progress(slot_elapsed, slot_duration));
+            data->slot_anim_y_offset = Anim_Lerp(data->slot_anim_direction * TIME_SLOT_ITEM_HEIGHT, 0, progress);
         }
         break;
     }
     case TIME_STATE_FOCUSED:
-        break;
-    case TIME_STATE_SHOW_MSG:
-        if (HAL_GetTick() - g_page_data.msg_start_time >= 1000)
-        {
-            g_page_data.state = TIME_STATE_FOCUSED;
-            Go_Back_Page();
-        }
+        Prefetch_Slot(data);
         break;
     }
 }
 
+/**
+ * @brief 生成老虎机中三个值的字符串
+ * @details 上一个值和下一个值按该项的取值范围循环。
+ * @param[out] str 上一个值、当前值和下一个值
+ * @param[in] index 聚焦的项: 0=时, 1=分, 2=秒
+ * @param[in] value 当前值
+ * @return 无
+ */
+static void Slot_Text(char str[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX], int index, int value)
+{
+    int max_value = (index == 0) ? 23 : 59;
+
+    fmt_u2(str[0], (value == 0) ? max_value : value - 1);
+    fmt_u2(str[1], value);
+    fmt_u2(str[2], (value == max_value) ? 0 : value + 1);
+}
+
+/**
+ * @brief 为聚焦的一项生成老虎机位图
+ * @param[in] u8g2 指向u8g2实例的指针 (当前字体为数值字体)
+ * @param[in] index 聚焦的项: 0=时, 1=分, 2=秒
+ * @param[in] value 当前值
+ * @param[in] key 位图的键值
+ * @return 无
+ */
+static void Build_Slot(u8g2_t *u8g2, int index, int value, uint32_t key)
+{
+    char str[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX];
+    const char *const text[UI_SLOT_ROWS] = {str[0], str[1], str[2]};
+
+    Slot_Text(str, index, value);
+    UI_Slot_Build(u8g2, key, text, TIME_SLOT_ITEM_HEIGHT);
+}
+
+/**
+ * @brief 空闲时预先生成下一次旋转后的老虎机位图
+ * @details 按上一次的旋转方向预测下一个值 (进入页面后默认为增加)，旋转后的第一帧只需复制位图。
+ * @param[in] data 页面数据
+ * @return 无
+ */
+static void Prefetch_Slot(const Page_Time_Time_Data_t *data)
+{
+    char str[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX];
+    const char *const text[UI_SLOT_ROWS] = {str[0], str[1], str[2]};
+    int index = data->focus_index;
+    int modulus = (index == 0) ? 24 : 60;
+    int value = (index == 0) ? data->temp_time.hour : (index == 1) ? data->temp_time.minute : data->temp_time.second;
+
+    // 滚动方向为 -1 表示数值增加
+    value = (value + ((data->slot_anim_direction > 0) ? modulus - 1 : 1)) % modulus;
+    Slot_Text(str, index, value);
+    UI_Slot_Prefetch(((uint32_t)index << 16) | (uint16_t)value, text);
+}
+
 /**
  * @brief 页面绘制函数
  * @param[in] page 指向页面基类的指针
@@ -189,36 +242,33 @@ static void Page_Loop(Page_Base *page)
  * @param[in] y_offset 屏幕的Y方向偏移
  * @return 无
  */
-static void Page_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+static void Page_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
 {
-    float p = g_page_data.anim_progress;
-    p = p < 0.5 ? 2 * p * p : 1 - pow(-2 * p + 2, 2) / 2;
+    Page_Time_Time_Data_t *data = Page_Data(page);
+    q16_t p = Anim_Ease(ANIM_EASE_IN_OUT_QUAD, data->anim_progress);
 
-    const int16_t value_positions_x[] = {21, 64, 107};
     const int16_t value_y_small = 36;
-    const int16_t label_positions_x[] = {18, 64, 107};
     const int16_t label_y_small = 12;
     const int16_t focused_value_x = 64;
     const int16_t focused_value_y = TIME_SLOT_Y_CENTER;
     const int16_t focused_label_x = 20;
     const int16_t focused_label_y = 12;
 
-    const char *labels[] = {"Hour", "Min", "Sec"};
     char str[6];
 
     for (int i = 0; i < TIME_SLOT_ITEM_COUNT; i++)
     {
-        bool is_focus_target = (i == g_page_data.focus_index);
+        bool is_focus_target = (i == data->focus_index);
         int16_t current_value_x, current_value_y, current_label_x, current_label_y;
         const uint8_t *value_font, *label_font;
 
         if (is_focus_target)
         {
-            current_value_x = lerp(value_positions_x[i], focused_value_x, p);
-            current_value_y = lerp(value_y_small, focused_value_y, p);
-            current_label_x = lerp(label_positions_x[i], focused_label_x, p);
-            current_label_y = lerp(label_y_small, focused_label_y, p);
-            value_font = (p > 0.5) ? TIME_FONT_VALUE_LARGE : TIME_FONT_VALUE_SMALL;
+            current_value_x = Anim_Lerp(value_positions_x[i], focused_value_x, p);
+            current_value_y = Anim_Lerp(value_y_small, focused_value_y, p);
+            current_label_x = Anim_Lerp(label_positions_x[i], focused_label_x, p);
+            current_label_y = Anim_Lerp(label_y_small, focused_label_y, p);
+            value_font = (p > Q16_HALF) ? TIME_FONT_VALUE_LARGE : TIME_FONT_VALUE_SMALL;
             label_font = TIME_FONT_LABEL;
         }
         else
@@ -231,80 +281,62 @@ static void Page_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y
             label_font = TIME_FONT_LABEL;
         }
 
-        if (!is_focus_target && p > 0.1)
+        if (!is_focus_target && p > Q16_ONE / 10)
             continue;
 
-        u8g2_SetFont(u8g2, label_font);
-        int16_t label_width = u8g2_GetStrWidth(u8g2, labels[i]);
-        u8g2_DrawStr(u8g2, current_label_x - (label_width / 2) + x_offset, current_label_y + y_offset, labels[i]);
+        u8g2_SetFont(u8g2, app_i18n_font(label_font));
+        if (Page_Strip_Text_Visible(u8g2, current_label_y + y_offset))
+        {
+            int16_t label_width = app_str_width(u8g2, labels[i]);
+            app_i18n_draw(u8g2, current_label_x - (label_width / 2) + x_offset, current_label_y + y_offset, app_str(labels[i]));
+        }
 
         int value = 0;
         if (i == 0)
-            value = g_page_data.temp_time.hour;
+            value = data->temp_time.hour;
         else if (i == 1)
-            value = g_page_data.temp_time.minute;
+            value = data->temp_time.minute;
         else
-            value = g_page_data.temp_time.second;
+            value = data->temp_time.second;
 
         u8g2_SetFont(u8g2, value_font);
-        sprintf(str, "%02d", value);
-        int16_t text_width = u8g2_GetStrWidth(u8g2, str);
-        int16_t draw_x = current_value_x - (text_width / 2);
 
-        if (is_focus_target && (g_page_data.state == TIME_STATE_FOCUSED || g_page_data.state == TIME_STATE_SLOT_ROLLING))
+        if (is_focus_target && (data->state == TIME_STATE_FOCUSED || data->state == TIME_STATE_SLOT_ROLLING))
         {
             int baseline_offset = 6;
-            float y_off = g_page_data.slot_anim_y_offset;
-
-            // --- 【关键修复】计算循环边界值 ---
-            int value_above, value_below;
-            if (i == 0)
-            { // Hour
-                value_above = (value == 0) ? 23 : value - 1;
-                value_below = (value == 23) ? 0 : value + 1;
-            }
-            else
-            { // Minute or Second
-                value_above = (value == 0) ? 59 : value - 1;
-                value_below = (value == 59) ? 0 : value + 1;
-            }
-            // --- 修复结束 ---
-
-            // 绘制中心值
-            sprintf(str, "%02d", value);
-            u8g2_DrawStr(u8g2, draw_x + x_offset, current_value_y + baseline_offset + y_off, str);
+            uint32_t key = ((uint32_t)i << 16) | (uint16_t)value;
 
-            // 绘制上方值
-            sprintf(str, "%02d", value_above);
-            u8g2_DrawStr(u8g2, draw_x + x_offset, current_value_y - TIME_SLOT_ITEM_HEIGHT + baseline_offset + y_off, str);
-
-            // 绘制下方值
-            sprintf(str, "%02d", value_below);
-            u8g2_DrawStr(u8g2, draw_x + x_offset, current_value_y + TIME_SLOT_ITEM_HEIGHT + baseline_offset + y_off, str);
+            // 数值变化时才重新生成位图，滚动的每一帧只复制位图
+            if (!UI_Slot_Ready(key))
+            {
+                Build_Slot(u8g2, i, value, key);
+            }
+            int16_t draw_x = current_value_x - (UI_Slot_Width() / 2);
+            UI_Slot_Draw(u8g2, draw_x + x_offset, current_value_y + baseline_offset, data->slot_anim_y_offset);
 
-            int16_t arrow_width = u8g2_GetStrWidth(u8g2, ">");
+            int16_t arrow_width = Page_Str_Width(u8g2, ">");
             u8g2_DrawStr(u8g2, draw_x - arrow_width - 10 + x_offset, current_value_y + baseline_offset + y_offset, ">");
         }
         else
         {
             int baseline_offset = 5;
-            u8g2_DrawStr(u8g2, draw_x + x_offset, current_value_y + baseline_offset, str);
-        }
-    }
+            fmt_u2(str, value);
+            bool zoomed = false;
 
-    if (g_page_data.state == TIME_STATE_SHOW_MSG)
-    {
-        u8g2_SetFont(u8g2, PROMPT_FONT);
-        uint16_t msg_w = u8g2_GetStrWidth(u8g2, g_page_data.msg_text);
-        uint16_t box_w = msg_w + 10;
-        uint16_t box_h = 16;
-        uint16_t box_x = (u8g2_GetDisplayWidth(u8g2) - box_w) / 2;
-        uint16_t box_y = (u8g2_GetDisplayHeight(u8g2) - box_h) / 2;
-        u8g2_SetDrawColor(u8g2, 0);
-        u8g2_DrawBox(u8g2, box_x, box_y, box_w, box_h);
-        u8g2_SetDrawColor(u8g2, 1);
-        u8g2_DrawFrame(u8g2, box_x, box_y, box_w, box_h);
-        u8g2_DrawStr(u8g2, box_x + 5, box_y + 12, g_page_data.msg_text);
+            // 聚焦动画中按进度连续缩放数值，字形缓存不可用时在中点切换字体
+            if (is_focus_target && (data->state == TIME_STATE_ZOOMING_IN || data->state == TIME_STATE_ZOOMING_OUT))
+            {
+                zoomed = UI_Slot_Draw_Zoom(u8g2, TIME_FONT_VALUE_SMALL, TIME_FONT_VALUE_LARGE,
+                                           current_value_x + x_offset, current_value_y + baseline_offset, str, p);
+            }
+            if (!zoomed)
+            {
+                u8g2_SetFont(u8g2, value_font);
+                int16_t text_width = Page_Str_Width(u8g2, str);
+                int16_t draw_x = current_value_x - (text_width / 2);
+                u8g2_DrawStr(u8g2, draw_x + x_offset, current_value_y + baseline_offset, str);
+            }
+        }
     }
 }
 
@@ -315,9 +347,10 @@ static void Page_Draw(Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y
  * @param[in] event 指向输入事件数据的指针
  * @return 无
  */
-static void Page_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+static void Page_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
 {
-    if (g_page_data.state != TIME_STATE_FOCUSED)
+    Page_Time_Time_Data_t *data = Page_Data(page);
+    if (data->state != TIME_STATE_FOCUSED)
     {
         if (event->event == INPUT_EVENT_BACK_PRESSED)
             Go_Back_Page();
@@ -328,38 +361,42 @@ static void Page_Action(Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t
     {
     case INPUT_EVENT_ENCODER:
     {
-        switch (g_page_data.focus_index)
+        // 数值调节使用加速增量，快速旋转时可以一次跨过多个值
+        int16_t step = event->accel_value;
+        switch (data->focus_index)
         {
         case 0: // 时
-            g_page_data.temp_time.hour = (g_page_data.temp_time.hour + event->value + 24) % 24;
+            data->temp_time.hour = ((data->temp_time.hour + step) % 24 + 24) % 24;
             break;
         case 1: // 分
-            g_page_data.temp_time.minute = (g_page_data.temp_time.minute + event->value + 60) % 60;
+            data->temp_time.minute = ((data->temp_time.minute + step) % 60 + 60) % 60;
             break;
         case 2: // 秒
-            g_page_data.temp_time.second = (g_page_data.temp_time.second + event->value + 60) % 60;
+            data->temp_time.second = ((data->temp_time.second + step) % 60 + 60) % 60;
             break;
         }
-        g_page_data.state = TIME_STATE_SLOT_ROLLING;
-        g_page_data.slot_anim_direction = (event->value > 0) ? -1 : 1;
-        g_page_data.slot_anim_start_time = HAL_GetTick();
-        g_page_data.slot_anim_y_offset = g_page_data.slot_anim_direction * TIME_SLOT_ITEM_HEIGHT;
+        data->state = TIME_STATE_SLOT_ROLLING;
+        Page_Invalidate(page);
+        data->slot_anim_direction = (event->value > 0) ? -1 : 1;
+        data->slot_anim_start_time = Page_Now();
+        data->slot_anim_y_offset = data->slot_anim_direction * TIME_SLOT_ITEM_HEIGHT;
         break;
     }
     case INPUT_EVENT_ENCODER_PRESSED:
-        g_page_data.state = TIME_STATE_ZOOMING_OUT;
-        g_page_data.anim_start_time = HAL_GetTick();
+        data->state = TIME_STATE_ZOOMING_OUT;
+        Page_Invalidate(page);
+        data->anim_start_time = Page_Now();
         break;
     case INPUT_EVENT_COMFIRM_PRESSED:
         Time_t now;
-        DS3231_GetTime(&now);
-        now.hour = g_page_data.temp_time.hour;
-        now.minute = g_page_data.temp_time.minute;
-        now.second = g_page_data.temp_time.second;
-        DS3231_SetTime(&now);
-        g_page_data.msg_text = "Time Saved!";
-        g_page_data.state = TIME_STATE_SHOW_MSG;
-        g_page_data.msg_start_time = HAL_GetTick();
+        DS3231_Cache_Snap_t snap;
+        DS3231_Cache_Get(&snap); // 缓存与秒脉冲同步，不必在按键处理中阻塞读取芯片
+        Time_From_Epoch(snap.epoch, &now);
+        now.hour = data->temp_time.hour;
+        now.minute = data->temp_time.minute;
+        now.second = data->temp_time.second;
+        DS3231_SetTimeSync(Time_To_Epoch(&now), snap.edge_ms); // 在下一个秒脉冲写入，保持芯片原有的秒相位
+        Page_Toast(app_str(STR_MSG_TIME_SAVED), PAGE_TOAST_MS, Page_Toast_Back); // 显示1秒后返回上一页
         break;
     case INPUT_EVENT_BACK_PRESSED:
         Go_Back_Page();
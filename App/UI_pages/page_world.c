@@ -0,0 +1,396 @@
+/**
+ * @file      page_world.c
+ * @brief     世界时钟页面
+ * @details   本文件定义了“世界时钟”页面：第一行为本地城市，其后为 WORLD_SLOT_COUNT 个可配置的城市及其本地时间。
+ *            各城市的时间都由同一个缓存的纪元秒 (DS3231_GetCachedEpoch) 推算 (app_world)，不读取芯片；
+ *            所有城市的偏移都是整分钟，各行的时间文本只在本地分钟变化时重新生成，并只重绘城市所在的行。
+ *            确认键打开选中行的城市列表：列表就是内置时区库 (app_tzdb) 按字母排序的全部时区，
+ *            数据源直接取 Flash 中的名称，打开时以二分查找选中当前的城市。列表与菜单共用同一个 UI_List_t，
+ *            几百个时区不增加页面数据。再按确认键选定城市，返回键不改变设置，设置在后台合并写入。
+ *            选中行的城市名 (中文界面下的本地标签等) 放不下时以跑马灯滚动，每次滚动只重绘这一行。
+ * @version   1.1
+ * @date      2025-10-08
+ * @author    SandOcean
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_display.h"
+#include "app_i18n.h"
+#include "ui_list.h"
+#include "ui_marquee.h"
+#include "input.h"
+#include "app_config.h"
+#include "app_settings.h"
+#include "app_world.h"
+#include "app_tzdb.h"
+#include "app_fmt.h"
+#include "DS3231.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define WORLD_ITEM_HOME 0                         ///< "本地"菜单项的索引，其后依次为各行城市
+#define WORLD_ITEM_COUNT (1 + WORLD_SLOT_COUNT)   ///< 菜单项数量
+#define WORLD_VISIBLE_ROWS 4                      ///< 同时显示的菜单项数量
+#define WORLD_ITEM_HEIGHT 16                      ///< 每个菜单项的像素高度
+#define WORLD_TOP_Y 0                             ///< 菜单列表顶部的Y坐标
+#define WORLD_LEFT_X 2                            ///< 菜单列表左侧的X坐标
+#define WORLD_WIDTH 124                           ///< 菜单列表的像素宽度
+#define WORLD_SECONDS_PER_DAY 86400U              ///< 一天的秒数
+#define WORLD_PICK_NONE 0xFF                      ///< 没有打开城市列表
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief 世界时钟页面的私有数据结构体
+ */
+typedef struct
+{
+    UI_List_t list;                           ///< 菜单列表，选择城市时是城市列表
+    uint32_t minute;                          ///< 时间文本对应的本地标准时间 (纪元分钟)
+    char home_label[18];                      ///< 本地菜单项的文本，如 "Home: Beijing"
+    char time_label[WORLD_SLOT_COUNT][8];     ///< 各行的时间文本，如 "07:05+1"，空行为空字符串
+    uint8_t pick;                             ///< 正在选择城市的菜单项，WORLD_PICK_NONE 为显示菜单
+} Page_World_Data_t;
+
+PAGE_DATA_CHECK(Page_World_Data_t); ///< 世界时钟页面的数据由页面管理器在进入时分配 (Page_Data)
+
+/* Private function prototypes -----------------------------------------------*/
+static void Page_World_Enter(const Page_Base *page);
+static void Page_World_Loop(const Page_Base *page);
+static void Page_World_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void Page_World_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+static void Update_Home_Label(Page_World_Data_t *data);
+static void Update_Times(const Page_Base *page, Page_World_Data_t *data, Epoch_t home_std);
+static uint16_t Item_Count(const void *ctx);
+static const char *Item_Text(const void *ctx, uint16_t index);
+static const char *Item_Value(const void *ctx, uint16_t index);
+static uint16_t Pick_Count(const void *ctx);
+static const char *Pick_Text(const void *ctx, uint16_t index);
+static void Pick_Open(Page_World_Data_t *data);
+static void Pick_Close(const Page_Base *page, Page_World_Data_t *data, bool apply);
+
+///< 菜单列表的布局
+static const UI_List_Config_t world_list = {
+    .x = WORLD_LEFT_X,
+    .y = WORLD_TOP_Y,
+    .w = WORLD_WIDTH,
+    .text_x = 6,
+    .item_h = WORLD_ITEM_HEIGHT,
+    .baseline = 12,
+    .rows = WORLD_VISIBLE_ROWS,
+    .wrap = true,
+    .font = MENU_FONT,
+    .count = Item_Count,
+    .text = Item_Text,
+    .value = Item_Value,
+    .marquee = true};
+
+///< 城市列表的布局，数据源为时区库 (空行的城市列表在最前面多一项 "--")
+static const UI_List_Config_t pick_list = {
+    .x = WORLD_LEFT_X,
+    .y = WORLD_TOP_Y,
+    .w = WORLD_WIDTH,
+    .text_x = 6,
+    .item_h = WORLD_ITEM_HEIGHT,
+    .baseline = 12,
+    .rows = WORLD_VISIBLE_ROWS,
+    .wrap = true,
+    .font = MENU_FONT,
+    .count = Pick_Count,
+    .text = Pick_Text,
+    .marquee = true};
+
+/* Public variables ----------------------------------------------------------*/
+/**
+ * @brief 世界时钟页面的全局实例
+ */
+const Page_Base g_page_world = {
+    .enter = Page_World_Enter,
+    .exit = NULL,
+    .loop = Page_World_Loop,
+    .draw = Page_World_Draw,
+    .action = Page_World_Action,
+    .page_name = "World",
+    .id = PAGE_ID_WORLD};
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 按当前设置生成本地菜单项的文本
+ * @param[in,out] data 页面数据
+ * @return 无
+ */
+static void Update_Home_Label(Page_World_Data_t *data)
+{
+    char *p = fmt_str(data->home_label, app_str(STR_WORLD_HOME));
+    fmt_str(p, app_world_city_name(g_app_settings.world_home));
+}
+
+/**
+ * @brief 推算各行城市的本地时间，重新生成时间文本并请求重绘有城市的行
+ * @details 本地时间跨天时各行的日期标记 (+1/-1) 也随分钟一起更新。
+ * @param[in] page 指向页面基类的指针
+ * @param[in,out] data 页面数据
+ * @param[in] home_std 本地标准时间的纪元秒
+ * @return 无
+ */
+static void Update_Times(const Page_Base *page, Page_World_Data_t *data, Epoch_t home_std)
+{
+    uint32_t home_day = Time_Apply_Dst(home_std, g_app_settings.dst_enabled) / WORLD_SECONDS_PER_DAY;
+    bool animating = UI_List_Is_Animating(&data->list);
+
+    data->minute = home_std / 60U;
+    for (uint8_t slot = 0; slot < WORLD_SLOT_COUNT; slot++)
+    {
+        Epoch_t local;
+        uint32_t day, of_day;
+        int16_t row_y;
+        char *p;
+
+        if (!app_world_local(slot, home_std, &local))
+        {
+            data->time_label[slot][0] = '\0';
+            continue;
+        }
+
+        day = local / WORLD_SECONDS_PER_DAY;
+        of_day = local % WORLD_SECONDS_PER_DAY;
+        p = fmt_u2(data->time_label[slot], (uint16_t)(of_day / 3600U));
+        p = fmt_char(p, ':');
+        p = fmt_u2(p, (uint16_t)(of_day / 60U % 60U));
+        if (day != home_day)
+        {
+            fmt_str(p, (day > home_day) ? "+1" : "-1");
+        }
+
+        // 列表静止时只重绘该行，动画中的列表整体都在变化
+        row_y = WORLD_TOP_Y + (slot + 1) * WORLD_ITEM_HEIGHT - data->list.scroll_y;
+        if (animating)
+        {
+            Page_Invalidate(page);
+        }
+        else if (row_y + WORLD_ITEM_HEIGHT > WORLD_TOP_Y && row_y < WORLD_TOP_Y + WORLD_VISIBLE_ROWS * WORLD_ITEM_HEIGHT)
+        {
+            Page_Invalidate_Rect(page, 0, row_y, 128, WORLD_ITEM_HEIGHT);
+        }
+    }
+}
+
+/**
+ * @brief 获取菜单项的数量
+ * @param[in] ctx 页面数据 (未使用)
+ * @return uint16_t 菜单项数量
+ */
+static uint16_t Item_Count(const void *ctx)
+{
+    return WORLD_ITEM_COUNT;
+}
+
+/**
+ * @brief 获取菜单项的文本
+ * @param[in] ctx 页面数据
+ * @param[in] index 菜单项索引
+ * @return const char* 菜单项文本
+ */
+static const char *Item_Text(const void *ctx, uint16_t index)
+{
+    const Page_World_Data_t *data = ctx;
+    if (index == WORLD_ITEM_HOME)
+    {
+        return data->home_label;
+    }
+    return app_world_city_name(g_app_settings.world_city[index - 1]);
+}
+
+/**
+ * @brief 获取菜单项右侧的时间文本
+ * @param[in] ctx 页面数据
+ * @param[in] index 菜单项索引
+ * @return const char* 时间文本，本地菜单项和空行返回 NULL
+ */
+static const char *Item_Value(const void *ctx, uint16_t index)
+{
+    const Page_World_Data_t *data = ctx;
+    if (index == WORLD_ITEM_HOME || data->time_label[index - 1][0] == '\0')
+    {
+        return NULL;
+    }
+    return data->time_label[index - 1];
+}
+
+/**
+ * @brief 获取城市列表的项目数
+ * @param[in] ctx 页面数据
+ * @return uint16_t 项目数，世界时钟的行比本地城市多一项空行
+ */
+static uint16_t Pick_Count(const void *ctx)
+{
+    const Page_World_Data_t *data = ctx;
+    return app_tzdb_list_count(NULL) + ((data->pick == WORLD_ITEM_HOME) ? 0U : 1U);
+}
+
+/**
+ * @brief 获取城市列表中一项的文本
+ * @param[in] ctx 页面数据
+ * @param[in] index 项目索引
+ * @return const char* 城市名称
+ */
+static const char *Pick_Text(const void *ctx, uint16_t index)
+{
+    const Page_World_Data_t *data = ctx;
+    if (data->pick == WORLD_ITEM_HOME)
+    {
+        return app_tzdb_list_text(NULL, index);
+    }
+    return (index == 0) ? app_world_city_name(WORLD_CITY_NONE) : app_tzdb_list_text(NULL, index - 1U);
+}
+
+/**
+ * @brief 打开选中菜单项的城市列表，并选中当前的城市
+ * @param[in,out] data 页面数据
+ * @return 无
+ */
+static void Pick_Open(Page_World_Data_t *data)
+{
+    uint8_t item = (uint8_t)data->list.selected;
+    uint16_t selected;
+
+    data->pick = item;
+    if (item == WORLD_ITEM_HOME)
+    {
+        selected = app_tzdb_list_index(g_app_settings.world_home);
+    }
+    else if (g_app_settings.world_city[item - 1] == WORLD_CITY_NONE)
+    {
+        selected = 0;
+    }
+    else
+    {
+        selected = app_tzdb_list_index(g_app_settings.world_city[item - 1]) + 1U;
+    }
+    UI_List_Init(&data->list, &pick_list, data, selected);
+}
+
+/**
+ * @brief 关闭城市列表，回到菜单中原来的菜单项
+ * @param[in] page 指向页面基类的指针
+ * @param[in,out] data 页面数据
+ * @param[in] apply 为 true 时把列表的选中项保存为该菜单项的城市
+ * @return 无
+ */
+static void Pick_Close(const Page_Base *page, Page_World_Data_t *data, bool apply)
+{
+    uint8_t item = data->pick;
+
+    if (apply)
+    {
+        if (item == WORLD_ITEM_HOME)
+        {
+            // 本地城市改变后所有行的偏移都随之改变
+            g_app_settings.world_home = app_tzdb_list_id(data->list.selected);
+            Update_Home_Label(data);
+        }
+        else
+        {
+            g_app_settings.world_city[item - 1] = (data->list.selected == 0) ? (uint8_t)WORLD_CITY_NONE
+                                                                             : app_tzdb_list_id(data->list.selected - 1U);
+        }
+        app_settings_mark_dirty(); // 稍后在后台与其他修改合并写入
+        Page_Toast(app_str(STR_MSG_SETTINGS_SAVED), PAGE_TOAST_MS, NULL);
+    }
+    data->pick = WORLD_PICK_NONE;
+    UI_List_Init(&data->list, &world_list, data, item);
+    Update_Times(page, data, DS3231_GetCachedEpoch());
+    Page_Invalidate(page);
+}
+
+/**
+ * @brief 页面进入函数
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_World_Enter(const Page_Base *page)
+{
+    Page_World_Data_t *data = Page_Data(page);
+
+    data->pick = WORLD_PICK_NONE;
+    Update_Home_Label(data);
+    UI_List_Init(&data->list, &world_list, data, 0);
+    Update_Times(page, data, DS3231_GetCachedEpoch());
+}
+
+/**
+ * @brief 页面循环函数
+ * @details 只在本地分钟变化时推算各行，每行只需一次比较和一次加法 (app_world_local)。
+ *          城市列表打开期间不推算，关闭时重新推算。跑马灯的偏移每一步只使选中行失效。
+ * @param[in] page 指向页面基类的指针
+ * @return 无
+ */
+static void Page_World_Loop(const Page_Base *page)
+{
+    Page_World_Data_t *data = Page_Data(page);
+    Epoch_t now = DS3231_GetCachedEpoch();
+
+    if (data->pick == WORLD_PICK_NONE && now / 60U != data->minute)
+    {
+        Update_Times(page, data, now);
+    }
+    UI_Marquee_Tick(page);
+}
+
+/**
+ * @brief 页面绘制函数
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+static void Page_World_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    Page_World_Data_t *data = Page_Data(page);
+
+    UI_List_Draw(&data->list, u8g2, x_offset, y_offset);
+}
+
+/**
+ * @brief 页面输入事件处理函数
+ * @param[in] page 指向页面基类的指针
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] event 指向输入事件数据的指针
+ * @return 无
+ */
+static void Page_World_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+{
+    Page_World_Data_t *data = Page_Data(page);
+
+    switch (event->event)
+    {
+    case INPUT_EVENT_ENCODER:
+        UI_List_Move(&data->list, event->value);
+        break;
+    case INPUT_EVENT_COMFIRM_PRESSED:
+        if (data->pick == WORLD_PICK_NONE)
+        {
+            Pick_Open(data);
+            Page_Invalidate(page);
+        }
+        else
+        {
+            Pick_Close(page, data, true);
+        }
+        break;
+
+    case INPUT_EVENT_BACK_PRESSED:
+        if (data->pick == WORLD_PICK_NONE)
+        {
+            Go_Back_Page();
+        }
+        else
+        {
+            Pick_Close(page, data, false);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
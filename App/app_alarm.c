@@ -0,0 +1,339 @@
+/**
+ * @file      app_alarm.c
+ * @brief     闹钟
+ * @details   下一次响铃只在闹钟表改动、对时、夏令时切换或响铃之后重新计算，结果同时写入 DS3231 的闹钟1
+ *            (芯片保存标准时间，写入前减去夏令时偏移)。熄屏期间主循环由每分钟的闹钟2唤醒，
+ *            闹钟1 总是落在整分钟上，与闹钟2同时触发，不需要额外的唤醒源。
+ *            闹钟表格式 (24字节)：| 魔法数 (4) | 闹钟 x4 (16) | CRC-32 (4) |，RAM 副本就是 app_persist 镜像中的区域。
+ *            旧版本写入的表在 CRC-32 的位置是 CRC-16 (2) 和填充 (2)，读取时同样接受。
+ * @author    SandOcean
+ * @date      2025-09-29
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_alarm.h"
+#include "app_persist.h"
+#include "eeprom_bd.h"
+#include "app_settings.h"
+#include <stddef.h> // For offsetof
+#include <string.h>
+
+/**
+ * @addtogroup AppAlarm
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define ALARM_TABLE_MAGIC 0x414C524DU ///< 闹钟表的魔法数 ("ALRM")
+#define ALARM_MAX_STEP_S  120         ///< 缓存时间两次调用之间前进超过该值视为对时 (熄屏时每分钟唤醒一次)
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 保存在 EEPROM 中的闹钟表
+ */
+typedef struct {
+    uint32_t magic;                      ///< 魔法数，固定为 ALARM_TABLE_MAGIC
+    App_Alarm_t alarm[APP_ALARM_COUNT];  ///< 闹钟
+    uint32_t crc;                        ///< 前面所有字段的 CRC-32 (旧版本为 CRC-16/CCITT 加2字节填充)
+} Alarm_Table_t;
+
+/** 编译期检查：闹钟表必须放得进预留的一页 */
+typedef char alarm_table_size_check[(sizeof(Alarm_Table_t) <= APP_ALARM_TABLE_SIZE) ? 1 : -1];
+
+/* Private variables ---------------------------------------------------------*/
+static Alarm_Table_t *const alarm_table = APP_PERSIST_MIRROR(Alarm_Table_t, APP_ALARM_BASE_ADDR); ///< 闹钟表的RAM副本
+static bool alarm_loaded;                ///< 闹钟表是否已校验 (读取失败或无效时全部关闭)
+static volatile bool alarm_dirty;        ///< 闹钟表有改动尚未保存
+static volatile bool alarm_saving;       ///< 是否有刷新在进行
+
+static bool next_valid;                  ///< 是否有下一次响铃
+static bool next_stale;                  ///< 下一次响铃需要重新计算
+static Epoch_t next_due;                 ///< 下一次响铃的本地时间
+static uint8_t next_index;               ///< 下一次响铃的闹钟序号
+static Epoch_t last_local;               ///< 上一次维护时的本地时间
+static int32_t last_dst_offset;          ///< 上一次维护时的夏令时偏移 (秒)
+
+static bool ringing;                     ///< 是否正在响铃
+static uint32_t ring_start;              ///< 开始响铃的时间戳
+
+/* Private function prototypes -----------------------------------------------*/
+static void alarm_load(void);
+static void alarm_save_cb(HAL_StatusTypeDef status, void *ctx);
+static void alarm_try_save(void);
+static bool alarm_occurrence(const App_Alarm_t *alarm, Epoch_t from, Epoch_t *due);
+static void alarm_schedule(Epoch_t local, int32_t dst_offset);
+static void alarm_stop(void);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 持久区读取完成后校验闹钟表
+ * @details 读取失败、魔法数或 CRC 不对 (首次使用或写入被打断) 时全部闹钟为关闭状态。
+ * @return 无
+ */
+static void alarm_load(void)
+{
+    App_Persist_State_e state = app_persist_state();
+
+    if (state != APP_PERSIST_READY && state != APP_PERSIST_FAILED) {
+        return;
+    }
+    if (state != APP_PERSIST_READY || alarm_table->magic != ALARM_TABLE_MAGIC ||
+        !app_persist_verify(alarm_table, offsetof(Alarm_Table_t, crc), offsetof(Alarm_Table_t, crc))) {
+        memset(alarm_table, 0, sizeof(*alarm_table));
+    }
+    next_stale = true;
+    alarm_loaded = true;
+}
+
+/**
+ * @brief 保存的完成回调 (I2C中断上下文)
+ * @param[in] status 写任务结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void alarm_save_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+
+    if (status != HAL_OK) {
+        alarm_dirty = true; // 由 app_alarm_service() 重试
+    }
+    alarm_saving = false;
+}
+
+/**
+ * @brief 闹钟表有改动时尝试启动保存
+ * @details 写入块设备的缓存后启动刷新，只有内容变化的字节才会写出。其他模块的刷新正在进行时
+ *          保留改动标志，下次重试时缓存已与新内容一致，不会重复写入。
+ * @return 无
+ */
+static void alarm_try_save(void)
+{
+    if (!alarm_dirty || alarm_saving) {
+        return;
+    }
+    alarm_table->magic = ALARM_TABLE_MAGIC;
+    alarm_table->crc = app_persist_crc(alarm_table, offsetof(Alarm_Table_t, crc));
+
+    alarm_saving = true;
+    alarm_dirty = false;
+    if (EEPROM_BD_Write(APP_ALARM_BASE_ADDR, alarm_table, sizeof(Alarm_Table_t)) != HAL_OK ||
+        EEPROM_BD_Flush_Async(alarm_save_cb, NULL) != HAL_OK) {
+        alarm_saving = false;
+        alarm_dirty = true;
+    }
+}
+
+/**
+ * @brief 计算一个闹钟不早于指定时刻的下一次响铃
+ * @details 最多向后查找7天 (加上当天共8天)，每天只比较星期是否在重复范围内。
+ * @param[in] alarm 闹钟
+ * @param[in] from 起始时刻 (本地时间，整分钟)
+ * @param[out] due 下一次响铃的本地时间
+ * @return bool 闹钟关闭或没有选中任何星期时返回 false
+ */
+static bool alarm_occurrence(const App_Alarm_t *alarm, Epoch_t from, Epoch_t *due)
+{
+    uint32_t day = from / TIME_SECS_PER_DAY;
+
+    if (!alarm->enabled) {
+        return false;
+    }
+    for (uint8_t d = 0; d <= 7; d++, day++) {
+        Epoch_t t = day * TIME_SECS_PER_DAY + alarm->hour * 3600UL + alarm->minute * 60UL;
+        if (t < from) {
+            continue;
+        }
+        if (alarm->days != 0 && !(alarm->days & (1U << (Time_Weekday_From_Days(day) - 1)))) {
+            continue;
+        }
+        *due = t;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 重新计算下一次响铃并写入 DS3231 的闹钟1
+ * @details 从下一个整分钟开始查找，当前这一分钟已经响过或被跳过。
+ * @param[in] local 当前本地时间
+ * @param[in] dst_offset 当前的夏令时偏移 (秒)
+ * @return 无
+ */
+static void alarm_schedule(Epoch_t local, int32_t dst_offset)
+{
+    Epoch_t from = local - local % 60 + 60;
+    Epoch_t due;
+    DS3231_Alarm_t hw;
+    Time_t t;
+
+    next_stale = false;
+    next_valid = false;
+    for (uint8_t i = 0; i < APP_ALARM_COUNT; i++) {
+        if (alarm_occurrence(&alarm_table->alarm[i], from, &due) && (!next_valid || due < next_due)) {
+            next_valid = true;
+            next_due = due;
+            next_index = i;
+        }
+    }
+
+    // 芯片按标准时间匹配日期、时、分、秒 (屏蔽位全为0)
+    if (next_valid) {
+        Time_From_Epoch((Epoch_t)(next_due - dst_offset), &t);
+        hw.second = 0;
+        hw.minute = t.minute;
+        hw.hour = t.hour;
+        hw.day = t.day;
+        hw.day_is_week = false;
+        hw.mask = 0;
+        (void)DS3231_SetAlarm(1, &hw);
+    }
+    (void)DS3231_EnableAlarmInterrupt(1, next_valid);
+}
+
+/**
+ * @brief 停止响铃并通知应用层
+ * @return 无
+ */
+static void alarm_stop(void)
+{
+    if (ringing) {
+        ringing = false;
+        app_alarm_ring(false);
+    }
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 闹钟维护函数，需在主循环中周期调用 (包括熄屏期间)
+ * @details 缓存时间倒退或跳过了下一次响铃 (对时) 时不补响，直接重新调度。
+ * @return bool 本次调用开始响铃时返回 true
+ */
+bool app_alarm_service(void)
+{
+    Epoch_t std = DS3231_GetCachedEpoch();
+    Epoch_t local = Time_Apply_Dst(std, g_app_settings.dst_enabled);
+    int32_t dst_offset = (int32_t)(local - std);
+    bool jumped = (local < last_local || local - last_local > ALARM_MAX_STEP_S);
+    bool started = false;
+
+    if (!alarm_loaded) {
+        alarm_load();
+    }
+    alarm_try_save();
+
+    if (ringing && HAL_GetTick() - ring_start >= APP_ALARM_RING_MS) {
+        alarm_stop();
+    }
+    if (!alarm_loaded) {
+        return false;
+    }
+
+    if (!next_stale && !jumped && dst_offset == last_dst_offset && next_valid && local >= next_due) {
+        App_Alarm_t *alarm = &alarm_table->alarm[next_index];
+
+        if (local - next_due < 60) {
+            if (alarm->days == 0) { // 单次闹钟响过后关闭
+                alarm->enabled = false;
+                alarm_dirty = true;
+                alarm_try_save();
+            }
+            ringing = true;
+            ring_start = HAL_GetTick();
+            app_alarm_ring(true);
+            started = true;
+        }
+        next_stale = true;
+    }
+    if (next_stale || jumped || dst_offset != last_dst_offset) {
+        alarm_schedule(local, dst_offset);
+    }
+
+    last_local = local;
+    last_dst_offset = dst_offset;
+    return started;
+}
+
+/**
+ * @brief 获取一个闹钟
+ * @details 闹钟表校验完成前镜像中可能是未校验的内容，返回一个关闭的闹钟。
+ * @param[in] index 闹钟序号
+ * @return const App_Alarm_t* 闹钟，序号无效时返回 NULL
+ */
+const App_Alarm_t *app_alarm_get(uint8_t index)
+{
+    static const App_Alarm_t alarm_off = {0};
+
+    if (index >= APP_ALARM_COUNT) {
+        return NULL;
+    }
+    return alarm_loaded ? &alarm_table->alarm[index] : &alarm_off;
+}
+
+/**
+ * @brief 修改一个闹钟
+ * @param[in] index 闹钟序号
+ * @param[in] alarm 新的设置
+ * @return bool 序号无效或闹钟表尚未读取完成时返回 false
+ */
+bool app_alarm_set(uint8_t index, const App_Alarm_t *alarm)
+{
+    if (index >= APP_ALARM_COUNT || !alarm_loaded || alarm->hour > 23 || alarm->minute > 59) {
+        return false;
+    }
+    alarm_table->alarm[index] = *alarm;
+    alarm_table->alarm[index].days &= 0x7F;
+    next_stale = true;
+    alarm_dirty = true;
+    alarm_try_save();
+    return true;
+}
+
+/**
+ * @brief 获取下一次响铃的时刻
+ * @param[out] local 下一次响铃的本地时间
+ * @return bool 没有启用的闹钟时返回 false
+ */
+bool app_alarm_next(Epoch_t *local)
+{
+    if (!next_valid || next_stale) {
+        return false;
+    }
+    *local = next_due;
+    return true;
+}
+
+/**
+ * @brief 查询是否正在响铃
+ * @return bool 正在响铃返回 true
+ */
+bool app_alarm_is_ringing(void)
+{
+    return ringing;
+}
+
+/**
+ * @brief 停止响铃
+ * @return 无
+ */
+void app_alarm_dismiss(void)
+{
+    alarm_stop();
+}
+
+/**
+ * @brief 响铃开始和停止的通知 (弱定义)
+ * @details 默认实现为空。
+ * @param[in] on 开始响铃为 true，停止为 false
+ * @return 无
+ */
+__weak void app_alarm_ring(bool on)
+{
+    (void)on;
+}
+
+/** @} */
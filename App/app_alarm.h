@@ -0,0 +1,105 @@
+/**
+ * @file      app_alarm.h
+ * @brief     闹钟头文件
+ * @details   最多 APP_ALARM_COUNT 个闹钟，每个闹钟有时、分、重复的星期和启用开关。
+ *            闹钟表保存在 AT24C32 中 app_history 检查点之后的一页，与设置记录分开，
+ *            修改后在后台写入。表或时间变化时重新计算下一次响铃的闹钟 (只在这时遍历整张表)，
+ *            并把它写入 DS3231 的闹钟1；主循环每次只需把缓存时间与这一个时刻比较。
+ *            闹钟时间按本地时间 (应用夏令时之后) 设定。
+ * @author    SandOcean
+ * @date      2025-09-29
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_ALARM_H
+#define __APP_ALARM_H
+
+#include "main.h"
+#include "DS3231.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppAlarm 闹钟
+ * @brief 持久化的闹钟表与下一次响铃的调度。
+ * @{
+ */
+
+/**
+ * @defgroup AppAlarm_Config 闹钟配置
+ * @{
+ */
+#define APP_ALARM_COUNT      4                 ///< 闹钟个数
+#define APP_ALARM_BASE_ADDR  0x0FA0            ///< 闹钟表在 AT24C32 中的地址 (一页，紧接 app_history 的检查点)
+#define APP_ALARM_TABLE_SIZE 32                ///< 闹钟表占用的字节数
+#define APP_ALARM_RING_MS    (5UL * 60 * 1000) ///< 无人响应时响铃的持续时间 (ms)
+/** @} */
+
+/**
+ * @brief 一个闹钟
+ */
+typedef struct {
+    uint8_t hour;   ///< 时 (0-23，本地时间)
+    uint8_t minute; ///< 分 (0-59)
+    uint8_t days;   ///< 重复的星期，bit0 为周一 ... bit6 为周日；为0时只响一次，响过后自动关闭
+    bool enabled;   ///< 是否启用
+} App_Alarm_t;
+
+/**
+ * @brief 闹钟维护函数，需在主循环中周期调用 (包括熄屏期间)
+ * @details 启动时 app_persist 的读取完成后校验闹钟表，之前不调度闹钟，表无效 (首次使用) 时全部闹钟为关闭状态；
+ *          重试未能提交的保存；发现对时、夏令时切换或闹钟表改动时重新调度；
+ *          缓存时间到达下一次响铃的时刻时开始响铃，响铃满 APP_ALARM_RING_MS 后自动停止。
+ *          需在 DS3231_Cache_Service() 之后调用。
+ * @return bool 本次调用开始响铃时返回 true，调用者应点亮屏幕并显示响铃页面
+ */
+bool app_alarm_service(void);
+
+/**
+ * @brief 获取一个闹钟
+ * @param[in] index 闹钟序号 (0 ~ APP_ALARM_COUNT-1)
+ * @return const App_Alarm_t* 闹钟，序号无效时返回 NULL
+ */
+const App_Alarm_t *app_alarm_get(uint8_t index);
+
+/**
+ * @brief 修改一个闹钟
+ * @details 立即生效并重新调度，EEPROM 在后台写入，总线忙时由 app_alarm_service() 重试。
+ * @param[in] index 闹钟序号
+ * @param[in] alarm 新的设置
+ * @return bool 序号无效或闹钟表尚未读取完成时返回 false
+ */
+bool app_alarm_set(uint8_t index, const App_Alarm_t *alarm);
+
+/**
+ * @brief 获取下一次响铃的时刻
+ * @param[out] local 下一次响铃的本地时间 (纪元秒)
+ * @return bool 没有启用的闹钟时返回 false
+ */
+bool app_alarm_next(Epoch_t *local);
+
+/**
+ * @brief 查询是否正在响铃
+ * @return bool 正在响铃返回 true
+ */
+bool app_alarm_is_ringing(void);
+
+/**
+ * @brief 停止响铃
+ * @return 无
+ */
+void app_alarm_dismiss(void);
+
+/**
+ * @brief 响铃开始和停止的通知 (弱定义，默认为空)
+ * @details 由 app_sound 重新定义，播放循环的响铃音 (AUDIO_ENABLE 为 0 时只有屏幕提示)；
+ *          改用振动马达等其他提示时替换该定义。在主循环上下文中调用。
+ * @param[in] on 开始响铃为 true，停止为 false
+ * @return 无
+ */
+void app_alarm_ring(bool on);
+
+/** @} */
+
+#endif /* __APP_ALARM_H */
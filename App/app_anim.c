@@ -0,0 +1,510 @@
+/**
+ * @file      app_anim.c
+ * @brief     定点数动画/缓动函数库实现文件
+ * @details   所有计算均为整数运算。二次/三次曲线直接用定点乘法求值,
+ *            回弹 (back) 和弹跳 (bounce) 曲线使用 65 点查找表并在相邻点之间线性插值。
+ *            补间动画池用固定数组保存活动的补间, 不使用动态内存。
+ *            弹簧的位置和速度以 Q8 保存 (像素 / 像素每秒), 每步用半隐式欧拉法积分:
+ *            v += K * (目标 - x) - D * v, x += dt * v, 其中 K = ω²dt, D = 2ωdt, 都在编译期算好。
+ *            ω·dt 为 0.15, 远小于该积分方法的稳定上限 2。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.4
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_anim.h"
+#include "main.h"
+
+/**
+ * @defgroup AppAnim 定点数动画库
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define ANIM_LUT_SHIFT    6                        ///< 查找表分段数的位数
+#define ANIM_LUT_SEGMENTS (1 << ANIM_LUT_SHIFT)    ///< 查找表分段数 (64段, 65个点)
+#define ANIM_LUT_FRAC     (16 - ANIM_LUT_SHIFT)    ///< 段内小数部分的位数
+
+#define SPRING_K  ((q16_t)((int64_t)ANIM_SPRING_OMEGA * ANIM_SPRING_OMEGA * ANIM_SPRING_STEP_MS * Q16_ONE / 1000)) ///< ω²dt (Q16)
+#define SPRING_D  ((q16_t)((int64_t)2 * ANIM_SPRING_OMEGA * ANIM_SPRING_STEP_MS * Q16_ONE / 1000))                 ///< 2ωdt (Q16)
+#define SPRING_DT ((q16_t)((int64_t)ANIM_SPRING_STEP_MS * Q16_ONE / 1000))                                         ///< dt (Q16 秒)
+#define SPRING_REST_POS (1 << 6)                          ///< 停止条件: 与目标的距离 (Q8, 1/4 像素)
+#define SPRING_REST_VEL (ANIM_SPRING_REST_PX_S << 8)      ///< 停止条件: 速度 (Q8)
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 补间动画描述
+ */
+typedef struct
+{
+    int16_t *target;     ///< 被驱动的变量, 为 NULL 表示该槽位空闲
+    int16_t from;        ///< 起始值
+    int16_t to;          ///< 目标值
+    Anim_Ease_e ease;    ///< 缓动曲线
+    uint32_t start_time; ///< 开始时间戳; 弹簧为已积分到的时间戳
+    uint32_t duration;   ///< 动画时长 (ms)
+    bool spring;         ///< 由弹簧驱动 (忽略 from/ease/duration)
+    int32_t pos;         ///< 弹簧的位置 (Q8 像素)
+    int32_t vel;         ///< 弹簧的速度 (Q8 像素/秒)
+} Anim_Tween_t;
+
+/* Private variables ---------------------------------------------------------*/
+static Anim_Tween_t s_tweens[ANIM_TWEEN_POOL_SIZE]; ///< 补间动画池
+static uint8_t s_reduced;                            ///< 关闭动画的原因 (Anim_Reduced_e), 非0时新的补间直接跳到终点
+static uint8_t s_time_pct = 100;                     ///< 动画时长的比例 (%), 由性能配置设置
+
+/**
+ * @brief easeOutBack 查找表 (c1 = 1.70158), Q16
+ */
+static const q16_t s_lut_out_back[ANIM_LUT_SEGMENTS + 1] = {
+    0, 4713, 9224, 13539, 17662, 21595, 25344, 28913,
+    32304, 35524, 38575, 41461, 44187, 46757, 49175, 51444,
+    53570, 55555, 57404, 59122, 60711, 62177, 63523, 64753,
+    65871, 66882, 67789, 68597, 69309, 69929, 70463, 70913,
+    71283, 71579, 71803, 71960, 72054, 72089, 72070, 71999,
+    71881, 71721, 71521, 71288, 71023, 70732, 70418, 70086,
+    69739, 69382, 69019, 68653, 68289, 67931, 67583, 67249,
+    66933, 66638, 66370, 66132, 65928, 65763, 65639, 65563,
+    65536,
+};
+
+/**
+ * @brief easeOutBounce 查找表, Q16
+ */
+static const q16_t s_lut_out_bounce[ANIM_LUT_SEGMENTS + 1] = {
+    0, 121, 484, 1089, 1936, 3025, 4356, 5929,
+    7744, 9801, 12100, 14641, 17424, 20449, 23716, 27225,
+    30976, 34969, 39204, 43681, 48400, 53361, 58564, 64009,
+    63552, 61033, 58756, 56721, 54928, 53377, 52068, 51001,
+    50176, 49593, 49252, 49153, 49296, 49681, 50308, 51177,
+    52288, 53641, 55236, 57073, 59152, 61473, 64036, 64921,
+    63744, 62809, 62116, 61665, 61456, 61489, 61764, 62281,
+    63040, 64041, 65284, 65041, 64656, 64513, 64612, 64953,
+    65536,
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static q16_t q16_mul(q16_t a, q16_t b);
+static q16_t lut_lookup(const q16_t *lut, q16_t t);
+static Anim_Tween_t *tween_find(const int16_t *target);
+static Anim_Tween_t *tween_claim(int16_t *target, int16_t to);
+static bool spring_step(Anim_Tween_t *tw);
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 定点数乘法
+ * @param[in] a 乘数 (Q16)
+ * @param[in] b 乘数 (Q16)
+ * @return q16_t 乘积 (Q16)
+ */
+static q16_t q16_mul(q16_t a, q16_t b)
+{
+    return (q16_t)(((int64_t)a * b) >> 16);
+}
+
+/**
+ * @brief 在查找表中按进度取值, 相邻两点之间线性插值
+ * @param[in] lut 65 点查找表
+ * @param[in] t 进度 (Q16), 需已限制在 [0, Q16_ONE]
+ * @return q16_t 曲线值 (Q16)
+ */
+static q16_t lut_lookup(const q16_t *lut, q16_t t)
+{
+    uint32_t idx = (uint32_t)t >> ANIM_LUT_FRAC;
+    if (idx >= ANIM_LUT_SEGMENTS)
+    {
+        return lut[ANIM_LUT_SEGMENTS];
+    }
+    q16_t frac = (t & ((1 << ANIM_LUT_FRAC) - 1)) << ANIM_LUT_SHIFT;
+    return lut[idx] + q16_mul(lut[idx + 1] - lut[idx], frac);
+}
+
+/**
+ * @brief 根据已用时间计算动画进度
+ * @param[in] elapsed 已经过的时间 (ms)
+ * @param[in] duration 动画总时长 (ms)
+ * @return q16_t 动画进度, 范围 [0, Q16_ONE]
+ */
+q16_t Anim_Progress(uint32_t elapsed, uint32_t duration)
+{
+    if (duration == 0 || elapsed >= duration)
+    {
+        return Q16_ONE;
+    }
+    return (q16_t)(((uint64_t)elapsed << 16) / duration);
+}
+
+/**
+ * @brief 对动画进度施加缓动曲线
+ * @param[in] ease 缓动曲线类型
+ * @param[in] t 线性进度, 超出 [0, Q16_ONE] 的部分会被截断
+ * @return q16_t 缓动后的进度
+ */
+q16_t Anim_Ease(Anim_Ease_e ease, q16_t t)
+{
+    q16_t u;
+
+    if (t <= 0)
+    {
+        return 0;
+    }
+    if (t >= Q16_ONE)
+    {
+        return Q16_ONE;
+    }
+
+    switch (ease)
+    {
+    case ANIM_EASE_IN_QUAD:
+        return q16_mul(t, t);
+
+    case ANIM_EASE_OUT_QUAD:
+        u = Q16_ONE - t;
+        return Q16_ONE - q16_mul(u, u);
+
+    case ANIM_EASE_IN_OUT_QUAD:
+        if (t < Q16_HALF)
+        {
+            return 2 * q16_mul(t, t);
+        }
+        u = Q16_ONE - t;
+        return Q16_ONE - 2 * q16_mul(u, u);
+
+    case ANIM_EASE_IN_CUBIC:
+        return q16_mul(q16_mul(t, t), t);
+
+    case ANIM_EASE_OUT_CUBIC:
+        u = Q16_ONE - t;
+        return Q16_ONE - q16_mul(q16_mul(u, u), u);
+
+    case ANIM_EASE_IN_OUT_CUBIC:
+        if (t < Q16_HALF)
+        {
+            return 4 * q16_mul(q16_mul(t, t), t);
+        }
+        u = Q16_ONE - t;
+        return Q16_ONE - 4 * q16_mul(q16_mul(u, u), u);
+
+    case ANIM_EASE_OUT_BACK:
+        return lut_lookup(s_lut_out_back, t);
+
+    case ANIM_EASE_OUT_BOUNCE:
+        return lut_lookup(s_lut_out_bounce, t);
+
+    case ANIM_EASE_LINEAR:
+    default:
+        return t;
+    }
+}
+
+/**
+ * @brief 整数线性插值
+ * @param[in] a 起始值
+ * @param[in] b 结束值
+ * @param[in] t 插值进度 (Q16)
+ * @return int16_t 插值结果
+ */
+int16_t Anim_Lerp(int16_t a, int16_t b, q16_t t)
+{
+    int32_t diff = (int32_t)b - a;
+    return (int16_t)(a + (int32_t)(((int64_t)diff * t + Q16_HALF) >> 16));
+}
+
+/**
+ * @brief 查找绑定到指定变量的补间
+ * @param[in] target 被驱动的变量, 传入 NULL 时查找空闲槽位
+ * @return Anim_Tween_t* 找到的槽位, 未找到返回 NULL
+ */
+static Anim_Tween_t *tween_find(const int16_t *target)
+{
+    for (uint8_t i = 0; i < ANIM_TWEEN_POOL_SIZE; i++)
+    {
+        if (s_tweens[i].target == target)
+        {
+            return &s_tweens[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 为变量取得一个槽位: 已绑定该变量的槽位, 或一个空闲槽位
+ * @param[in,out] target 被驱动的变量
+ * @param[in] to 目标值, 动画池已满时直接写入变量
+ * @return Anim_Tween_t* 槽位, 参数错误、动画池已满或动画已关闭返回 NULL
+ */
+static Anim_Tween_t *tween_claim(int16_t *target, int16_t to)
+{
+    Anim_Tween_t *tw;
+
+    if (target == NULL)
+    {
+        return NULL;
+    }
+
+    tw = tween_find(target);
+    if (s_reduced)
+    {
+        if (tw != NULL)
+        {
+            tw->target = NULL; // 该变量上已有的补间不再继续
+        }
+        *target = to;
+        return NULL;
+    }
+    if (tw == NULL)
+    {
+        tw = tween_find(NULL);
+    }
+    if (tw == NULL)
+    {
+        *target = to; // 动画池已满, 直接跳到终点
+    }
+    return tw;
+}
+
+/**
+ * @brief 弹簧积分一步
+ * @param[in,out] tw 弹簧所在的槽位
+ * @return bool 已停在目标上返回 true
+ */
+static bool spring_step(Anim_Tween_t *tw)
+{
+    int32_t err = ((int32_t)tw->to << 8) - tw->pos;
+
+    tw->vel += q16_mul(SPRING_K, err) - q16_mul(SPRING_D, tw->vel);
+    tw->pos += q16_mul(SPRING_DT, tw->vel);
+
+    err = ((int32_t)tw->to << 8) - tw->pos;
+    if (err > -SPRING_REST_POS && err < SPRING_REST_POS && tw->vel > -SPRING_REST_VEL && tw->vel < SPRING_REST_VEL)
+    {
+        tw->pos = (int32_t)tw->to << 8;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 启动一个绑定到 int16_t 变量的补间动画
+ * @param[in,out] target 被驱动的变量
+ * @param[in] to 目标值
+ * @param[in] duration 动画时长 (ms)
+ * @param[in] ease 缓动曲线类型
+ * @return bool 启动成功返回 true, 动画池已满返回 false
+ */
+bool Anim_Tween_Start(int16_t *target, int16_t to, uint32_t duration, Anim_Ease_e ease)
+{
+    Anim_Tween_t *tw = tween_claim(target, to);
+
+    if (tw == NULL)
+    {
+        return false;
+    }
+
+    tw->target = target;
+    tw->from = *target;
+    tw->to = to;
+    tw->ease = ease;
+    tw->start_time = HAL_GetTick();
+    tw->duration = Anim_Scaled(duration);
+    tw->spring = false;
+    return true;
+}
+
+/**
+ * @brief 用临界阻尼弹簧把 int16_t 变量驱动到目标值
+ * @param[in,out] target 被驱动的变量
+ * @param[in] to 目标值
+ * @return bool 启动成功返回 true, 动画池已满返回 false
+ */
+bool Anim_Spring_Start(int16_t *target, int16_t to)
+{
+    return Anim_Spring_Kick(target, to, 0);
+}
+
+/**
+ * @brief 给弹簧驱动的变量叠加一个速度
+ * @param[in,out] target 被驱动的变量
+ * @param[in] to 目标值
+ * @param[in] velocity 叠加的速度 (像素/秒)
+ * @return bool 启动成功返回 true, 动画池已满返回 false
+ */
+bool Anim_Spring_Kick(int16_t *target, int16_t to, int16_t velocity)
+{
+    Anim_Tween_t *tw = tween_claim(target, to);
+
+    if (tw == NULL)
+    {
+        return false;
+    }
+
+    if (tw->target != target || !tw->spring)
+    {
+        // 新的弹簧从当前值静止出发
+        tw->target = target;
+        tw->spring = true;
+        tw->pos = (int32_t)*target << 8;
+        tw->vel = 0;
+        tw->start_time = HAL_GetTick();
+    }
+    tw->to = to;
+    tw->vel += (int32_t)velocity << 8;
+    return true;
+}
+
+/**
+ * @brief 停止绑定到指定变量的补间动画
+ * @param[in] target 被驱动的变量
+ * @return 无
+ */
+void Anim_Tween_Stop(int16_t *target)
+{
+    Anim_Tween_t *tw = (target != NULL) ? tween_find(target) : NULL;
+    if (tw != NULL)
+    {
+        tw->target = NULL;
+    }
+}
+
+/**
+ * @brief 停止所有补间动画
+ * @return 无
+ */
+void Anim_Tween_Stop_All(void)
+{
+    for (uint8_t i = 0; i < ANIM_TWEEN_POOL_SIZE; i++)
+    {
+        s_tweens[i].target = NULL;
+    }
+}
+
+/**
+ * @brief 关闭或恢复动画
+ * @param[in] reason 原因 (Anim_Reduced_e)
+ * @param[in] on 为 true 时关闭动画
+ * @return 无
+ */
+void Anim_Set_Reduced(Anim_Reduced_e reason, bool on)
+{
+    if (on)
+    {
+        s_reduced |= (uint8_t)reason;
+    }
+    else
+    {
+        s_reduced &= (uint8_t)~reason;
+    }
+}
+
+/**
+ * @brief 设置动画时长的比例
+ * @param[in] percent 比例 (%), 为0时按100处理
+ * @return 无
+ */
+void Anim_Set_Time_Scale(uint8_t percent)
+{
+    s_time_pct = (percent != 0) ? percent : 100;
+}
+
+/**
+ * @brief 按动画时长的比例换算时长
+ * @param[in] duration 原时长 (ms)
+ * @return uint32_t 换算后的时长 (ms)
+ */
+uint32_t Anim_Scaled(uint32_t duration)
+{
+    return (s_time_pct == 100) ? duration : duration * s_time_pct / 100U;
+}
+
+/**
+ * @brief 查询动画是否已关闭
+ * @return bool 已关闭返回 true
+ */
+bool Anim_Reduced(void)
+{
+    return s_reduced != 0;
+}
+
+/**
+ * @brief 推进所有活动的补间动画和弹簧
+ * @details 到达终点的补间会写入目标值并释放槽位。弹簧按固定步长补算到 now,
+ *          停稳后同样释放槽位。
+ * @param[in] now 当前帧的时间戳 (ms)
+ * @return bool 本次是否有变量被更新
+ */
+bool Anim_Tween_Tick(uint32_t now)
+{
+    bool updated = false;
+
+    for (uint8_t i = 0; i < ANIM_TWEEN_POOL_SIZE; i++)
+    {
+        Anim_Tween_t *tw = &s_tweens[i];
+        if (tw->target == NULL)
+        {
+            continue;
+        }
+
+        if (tw->spring)
+        {
+            bool rest = false;
+            // 本帧时间戳可能早于弹簧在本帧中途的启动时刻, 此时不积分
+            if ((int32_t)(now - tw->start_time) > ANIM_SPRING_STEP_MS * ANIM_SPRING_MAX_STEPS)
+            {
+                tw->start_time = now - (uint32_t)ANIM_SPRING_STEP_MS * ANIM_SPRING_MAX_STEPS;
+            }
+            while (!rest && (int32_t)(now - tw->start_time) >= ANIM_SPRING_STEP_MS)
+            {
+                tw->start_time += ANIM_SPRING_STEP_MS;
+                rest = spring_step(tw);
+            }
+            *tw->target = (int16_t)((tw->pos + 128) >> 8);
+            if (rest)
+            {
+                tw->target = NULL;
+            }
+            updated = true;
+            continue;
+        }
+
+        q16_t t = Anim_Progress(now - tw->start_time, tw->duration);
+        *tw->target = Anim_Lerp(tw->from, tw->to, Anim_Ease(tw->ease, t));
+        if (t >= Q16_ONE)
+        {
+            tw->target = NULL;
+        }
+        updated = true;
+    }
+    return updated;
+}
+
+/**
+ * @brief 查询指定变量是否有活动的补间动画
+ * @param[in] target 被驱动的变量
+ * @return bool 有活动补间返回 true
+ */
+bool Anim_Tween_Is_Active(const int16_t *target)
+{
+    return (target != NULL) && (tween_find(target) != NULL);
+}
+
+/**
+ * @brief 查询是否还有任何活动的补间动画
+ * @return bool 有活动补间返回 true
+ */
+bool Anim_Tween_Any_Active(void)
+{
+    for (uint8_t i = 0; i < ANIM_TWEEN_POOL_SIZE; i++)
+    {
+        if (s_tweens[i].target != NULL)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @}
+ */
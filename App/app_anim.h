@@ -0,0 +1,198 @@
+/**
+ * @file      app_anim.h
+ * @brief     定点数动画/缓动函数库头文件
+ * @details   STM32F103 没有 FPU, 动画插值全部使用 Q16 定点数 (1.0 = 65536),
+ *            缓动曲线通过整数乘法或预计算查找表求值, 不依赖软件浮点库。
+ *            另提供一个固定大小的补间动画池, 由页面管理器每帧统一推进。
+ *            池中的槽位也可以驱动临界阻尼弹簧: 目标改变时保留当前速度, 动画中途重新设定目标
+ *            不会产生速度突变, 编码器转得再快, 运动也是连续的。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.3
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_ANIM_H
+#define __APP_ANIM_H
+
+#include "stdint.h"
+#include <stdbool.h>
+
+/** @defgroup Anim_Q16 Q16 定点数 */
+/** @{ */
+typedef int32_t q16_t;              ///< Q16.16 定点数
+
+#define Q16_ONE         (1L << 16)  ///< 定点数 1.0
+#define Q16_HALF        (Q16_ONE / 2) ///< 定点数 0.5
+#define Q16_FROM_INT(x) ((q16_t)(x) << 16) ///< 整数转定点数
+/** @} */
+
+#define ANIM_TWEEN_POOL_SIZE 4 ///< 补间动画池的容量 (同时活动的补间数)
+
+/** @defgroup Anim_Spring_Config 弹簧参数 */
+/** @{ */
+#define ANIM_SPRING_OMEGA     30  ///< 弹簧的固有角频率 (rad/s), 一次 16 像素的移动约 200ms 停稳
+#define ANIM_SPRING_STEP_MS   5   ///< 积分的固定步长 (ms), 与帧率无关
+#define ANIM_SPRING_MAX_STEPS 20  ///< 一帧内最多补算的步数, 更长的停顿 (如阻塞的 I2C) 不再追赶
+#define ANIM_SPRING_REST_PX_S 4   ///< 速度低于该值 (像素/秒) 且离目标不足 1/4 像素时停在目标上
+/** @} */
+
+/**
+ * @brief 缓动曲线类型
+ */
+typedef enum
+{
+    ANIM_EASE_LINEAR = 0,   ///< 线性
+    ANIM_EASE_IN_QUAD,      ///< 二次, 先慢后快
+    ANIM_EASE_OUT_QUAD,     ///< 二次, 先快后慢
+    ANIM_EASE_IN_OUT_QUAD,  ///< 二次, 两端慢中间快
+    ANIM_EASE_IN_CUBIC,     ///< 三次, 先慢后快
+    ANIM_EASE_OUT_CUBIC,    ///< 三次, 先快后慢
+    ANIM_EASE_IN_OUT_CUBIC, ///< 三次, 两端慢中间快
+    ANIM_EASE_OUT_BACK,     ///< 冲过终点后回弹 (查找表)
+    ANIM_EASE_OUT_BOUNCE,   ///< 落地弹跳 (查找表)
+} Anim_Ease_e;
+
+/**
+ * @brief 根据已用时间计算动画进度
+ * @param[in] elapsed 已经过的时间 (ms)
+ * @param[in] duration 动画总时长 (ms), 为0时直接返回1.0
+ * @return q16_t 动画进度, 范围 [0, Q16_ONE]
+ */
+q16_t Anim_Progress(uint32_t elapsed, uint32_t duration);
+
+/**
+ * @brief 对动画进度施加缓动曲线
+ * @param[in] ease 缓动曲线类型
+ * @param[in] t 线性进度, 范围 [0, Q16_ONE]
+ * @return q16_t 缓动后的进度 (回弹类曲线中途会超过 Q16_ONE)
+ */
+q16_t Anim_Ease(Anim_Ease_e ease, q16_t t);
+
+/**
+ * @brief 整数线性插值
+ * @param[in] a 起始值
+ * @param[in] b 结束值
+ * @param[in] t 插值进度 (Q16)
+ * @return int16_t 插值结果, 四舍五入到整数
+ */
+int16_t Anim_Lerp(int16_t a, int16_t b, q16_t t);
+
+/** @defgroup Anim_Tween 补间动画池 */
+/** @{ */
+
+/**
+ * @brief 启动一个绑定到 int16_t 变量的补间动画
+ * @details 起点为变量的当前值。若该变量已有活动的补间, 则从当前值重新开始。
+ * @param[in,out] target 被驱动的变量
+ * @param[in] to 目标值
+ * @param[in] duration 动画时长 (ms)
+ * @param[in] ease 缓动曲线类型
+ * @return bool 启动结果
+ *         - @retval true 启动成功
+ *         - @retval false 动画池已满或动画已关闭, 变量被直接设置为目标值
+ */
+bool Anim_Tween_Start(int16_t *target, int16_t to, uint32_t duration, Anim_Ease_e ease);
+
+/**
+ * @brief 用临界阻尼弹簧把 int16_t 变量驱动到目标值
+ * @details 变量已由弹簧驱动时只改变目标, 位置和速度保持连续; 否则从变量的当前值静止出发
+ *          (取代该变量上已有的补间)。弹簧按 ANIM_SPRING_STEP_MS 的固定步长积分,
+ *          每步两次定点乘法, 不会冲过目标。
+ * @param[in,out] target 被驱动的变量
+ * @param[in] to 目标值
+ * @return bool 启动结果
+ *         - @retval true 启动成功
+ *         - @retval false 动画池已满或动画已关闭, 变量被直接设置为目标值
+ */
+bool Anim_Spring_Start(int16_t *target, int16_t to);
+
+/**
+ * @brief 给弹簧驱动的变量叠加一个速度
+ * @details 与 Anim_Spring_Start 相同地设定目标, 再把 velocity 加到当前速度上。
+ *          目标不变时即为一次回弹: 变量朝速度方向冲出约 velocity / (e * ANIM_SPRING_OMEGA) 像素后回到目标。
+ * @param[in,out] target 被驱动的变量
+ * @param[in] to 目标值
+ * @param[in] velocity 叠加的速度 (像素/秒)
+ * @return bool 动画池已满或动画已关闭返回 false, 变量被直接设置为目标值
+ */
+bool Anim_Spring_Kick(int16_t *target, int16_t to, int16_t velocity);
+
+/**
+ * @brief 停止绑定到指定变量的补间动画, 变量保持当前值
+ * @details 同时适用于弹簧。
+ * @param[in] target 被驱动的变量
+ * @return 无
+ */
+void Anim_Tween_Stop(int16_t *target);
+
+/**
+ * @brief 停止所有补间动画
+ * @return 无
+ */
+void Anim_Tween_Stop_All(void);
+
+/**
+ * @brief 关闭动画的原因 (可同时存在)
+ */
+typedef enum
+{
+    ANIM_REDUCED_BATTERY = 0x01, ///< 低电量模式
+    ANIM_REDUCED_LOAD    = 0x02, ///< 页面管理器的画质调节降到了最低一级 (帧时间超出预算)
+} Anim_Reduced_e;
+
+/**
+ * @brief 关闭或恢复动画
+ * @details 关闭期间新启动的补间和弹簧直接把变量设为目标值 (与动画池已满时相同), 已在运行的照常结束;
+ *          页面管理器不再播放切换动画, 表盘的数字不再翻页。各个原因分别设置, 全部撤销后才恢复动画。
+ * @param[in] reason 原因 (Anim_Reduced_e)
+ * @param[in] on 为 true 时关闭动画
+ * @return 无
+ */
+void Anim_Set_Reduced(Anim_Reduced_e reason, bool on);
+
+/**
+ * @brief 设置动画时长的比例
+ * @details 之后启动的补间按比例缩放时长 (已在运行的不变), 页面切换动画和页面内按时间计算的动画用 Anim_Scaled() 换算。
+ *          由性能配置 (app_perf) 设置, 默认为 100%。弹簧的时长由刚度决定, 不受影响。
+ * @param[in] percent 比例 (%), 为0时按100处理
+ * @return 无
+ */
+void Anim_Set_Time_Scale(uint8_t percent);
+
+/**
+ * @brief 按动画时长的比例换算时长
+ * @param[in] duration 原时长 (ms)
+ * @return uint32_t 换算后的时长 (ms)
+ */
+uint32_t Anim_Scaled(uint32_t duration);
+
+/**
+ * @brief 查询动画是否已关闭
+ * @return bool 因任一原因被 Anim_Set_Reduced 关闭时返回 true
+ */
+bool Anim_Reduced(void);
+
+/**
+ * @brief 推进所有活动的补间动画和弹簧, 由页面管理器每帧调用一次
+ * @param[in] now 当前帧的时间戳 (ms), 不早于此前启动的补间的开始时间
+ * @return bool 本次是否有变量被更新 (含到达终点的最后一帧)
+ */
+bool Anim_Tween_Tick(uint32_t now);
+
+/**
+ * @brief 查询指定变量是否有活动的补间动画 (含弹簧)
+ * @param[in] target 被驱动的变量
+ * @return bool 有活动补间返回 true
+ */
+bool Anim_Tween_Is_Active(const int16_t *target);
+
+/**
+ * @brief 查询是否还有任何活动的补间动画
+ * @return bool 有活动补间返回 true
+ */
+bool Anim_Tween_Any_Active(void);
+
+/** @} */
+
+#endif /* __APP_ANIM_H */
@@ -0,0 +1,390 @@
+/**
+ * @file      app_asset.c
+ * @brief     外部闪存资源区实现
+ * @details   资源区在闪存中的地址 = 闪存容量 - APP_ASSET_SECTORS 个扇区，区内按资源块中的偏移直接寻址。
+ *            缓存块以资源区内的块号为标签，各资源共用，与 eeprom_bd 一样按使用时间戳替换最久未使用的块。
+ *            索引在校验时读入 RAM (每个资源8字节)，读取资源时只计算地址，不再访问索引。
+ *            擦除和写入 (远程命令) 开始后立即标记为不可用并清空缓存，此后读到的内容可能是写了一半的资源块。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_asset.h"
+#include "app_store.h"
+#include <string.h>
+
+/**
+ * @addtogroup AppAsset
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define ASSET_REGION_SIZE (APP_ASSET_SECTORS * W25Q_SECTOR_SIZE) ///< 资源区的字节数
+#define ASSET_NO_BLOCK    0xFFFFU ///< 空缓存块的标签
+#define ASSET_SETTLE_MS   3U      ///< 读取前等待页编程结束的最长时间 (擦除期间不等待完)
+
+/** 编译期检查：缓存块不跨越闪存页，块号放得进标签 */
+typedef char asset_block_check[(W25Q_PAGE_SIZE % APP_ASSET_BLOCK_SIZE == 0 &&
+                                 ASSET_REGION_SIZE / APP_ASSET_BLOCK_SIZE < ASSET_NO_BLOCK) ? 1 : -1];
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 缓存块
+ */
+typedef struct {
+    uint16_t block;                     ///< 资源区内的块号，ASSET_NO_BLOCK 为空
+    uint16_t stamp;                     ///< 最近一次使用的时间戳，用于替换
+    uint8_t data[APP_ASSET_BLOCK_SIZE]; ///< 块数据
+} Asset_Line_t;
+
+/**
+ * @brief 索引项
+ */
+typedef struct {
+    uint32_t offset; ///< 相对资源块起点的偏移
+    uint32_t size;   ///< 长度，0 为不存在
+} Asset_Entry_t;
+
+/* Private variables ---------------------------------------------------------*/
+#if W25Q_ENABLE
+static Asset_Line_t asset_lines[APP_ASSET_CACHE_BLOCKS]; ///< 缓存块
+static Asset_Entry_t asset_index[APP_ASSET_COUNT];      ///< 各资源的位置
+static uint8_t asset_tx[APP_ASSET_WRITE_MAX];           ///< 页编程的数据，DMA 发送期间保持不变
+static uint32_t asset_base;                             ///< 资源区的闪存地址
+static uint32_t asset_blob;                             ///< 已校验的资源块长度，0 为不可用
+static uint16_t asset_clock;                            ///< 使用时间戳的计数
+static bool asset_present;                              ///< 闪存足够大，资源区存在
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+#if W25Q_ENABLE
+static uint32_t get_u32(const uint8_t *p);
+static void asset_flush(void);
+static bool asset_settle(void);
+static const uint8_t *asset_block(uint16_t block);
+static bool asset_copy(uint32_t pos, uint8_t *out, uint16_t len);
+#endif
+
+/* Private Function implementations ------------------------------------------*/
+#if W25Q_ENABLE
+
+/**
+ * @brief 以小端读出一个字
+ * @param[in] p 源
+ * @return uint32_t 数值
+ */
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief 清空缓存，资源区标记为不可用
+ * @return 无
+ */
+static void asset_flush(void)
+{
+    asset_blob = 0;
+    for (uint8_t i = 0; i < APP_ASSET_CACHE_BLOCKS; i++) {
+        asset_lines[i].block = ASSET_NO_BLOCK;
+    }
+}
+
+/**
+ * @brief 等待页编程结束
+ * @return bool 闪存空闲返回 true；超过 ASSET_SETTLE_MS 仍忙 (正在擦除) 返回 false
+ */
+static bool asset_settle(void)
+{
+    uint32_t start = HAL_GetTick();
+
+    while (W25Q_Is_Busy()) {
+        if (HAL_GetTick() - start > ASSET_SETTLE_MS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 取得一个块的缓存，未命中时替换最久未使用的块并从闪存读入
+ * @param[in] block 资源区内的块号
+ * @return const uint8_t* 块数据，读取失败时为 NULL (被替换的块已清空)
+ */
+static const uint8_t *asset_block(uint16_t block)
+{
+    Asset_Line_t *victim = &asset_lines[0];
+    uint16_t oldest = 0;
+
+    for (uint8_t i = 0; i < APP_ASSET_CACHE_BLOCKS; i++) {
+        Asset_Line_t *line = &asset_lines[i];
+        uint16_t age = (uint16_t)(asset_clock - line->stamp);
+
+        if (line->block == block) {
+            line->stamp = ++asset_clock;
+            return line->data;
+        }
+        if (line->block == ASSET_NO_BLOCK) {
+            age = 0xFFFF; // 空块优先
+        }
+        if (i == 0 || age > oldest) {
+            victim = line;
+            oldest = age;
+        }
+    }
+
+    victim->block = ASSET_NO_BLOCK;
+    if (!asset_settle() ||
+        W25Q_Read(asset_base + (uint32_t)block * APP_ASSET_BLOCK_SIZE, victim->data, APP_ASSET_BLOCK_SIZE) != HAL_OK) {
+        return NULL;
+    }
+    victim->block = block;
+    victim->stamp = ++asset_clock;
+    return victim->data;
+}
+
+/**
+ * @brief 经缓存读出资源区中的一段数据
+ * @details 跨越缓存块的读取逐块拷贝。
+ * @param[in] pos 资源区内的偏移
+ * @param[out] out 输出缓冲区
+ * @param[in] len 长度
+ * @return bool 读取成功返回 true
+ */
+static bool asset_copy(uint32_t pos, uint8_t *out, uint16_t len)
+{
+    while (len > 0) {
+        const uint8_t *data = asset_block((uint16_t)(pos / APP_ASSET_BLOCK_SIZE));
+        uint16_t at = (uint16_t)(pos % APP_ASSET_BLOCK_SIZE);
+        uint16_t n = (uint16_t)(APP_ASSET_BLOCK_SIZE - at);
+
+        if (data == NULL) {
+            return false;
+        }
+        if (n > len) {
+            n = len;
+        }
+        memcpy(out, &data[at], n);
+        out += n;
+        pos += n;
+        len -= n;
+    }
+    return true;
+}
+
+#endif
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 初始化资源区
+ * @return 无
+ */
+void app_asset_init(void)
+{
+#if W25Q_ENABLE
+    uint16_t sectors = W25Q_Sector_Count();
+
+    asset_present = sectors >= APP_ASSET_SECTORS + 3U; // 长期数据记录至少需要3个扇区
+    asset_base = asset_present ? (uint32_t)(sectors - APP_ASSET_SECTORS) * W25Q_SECTOR_SIZE : 0;
+    app_asset_mount();
+#endif
+}
+
+/**
+ * @brief 校验资源块并读入索引
+ * @details 块长度之外的缓存块内容不参与校验，按块读出后只累加有效的部分。
+ * @return bool 资源块有效返回 true
+ */
+bool app_asset_mount(void)
+{
+#if W25Q_ENABLE
+    uint8_t header[APP_ASSET_HEADER_SIZE];
+    uint32_t length;
+    uint16_t count;
+    uint16_t crc = 0xFFFF;
+
+    asset_flush();
+    if (!asset_present || !asset_settle() || W25Q_Read(asset_base, header, sizeof(header)) != HAL_OK) {
+        return false;
+    }
+    length = get_u32(&header[4]);
+    count = (uint16_t)(header[8] | (header[9] << 8));
+    if (get_u32(header) != APP_ASSET_MAGIC || length > ASSET_REGION_SIZE ||
+        length < APP_ASSET_HEADER_SIZE + (uint32_t)count * APP_ASSET_ENTRY_SIZE) {
+        return false;
+    }
+
+    for (uint32_t pos = 0; pos < length; pos += APP_ASSET_BLOCK_SIZE) {
+        const uint8_t *data = asset_block((uint16_t)(pos / APP_ASSET_BLOCK_SIZE));
+        uint32_t first = (pos == 0) ? APP_ASSET_HEADER_SIZE : 0;
+        uint32_t last = (length - pos < APP_ASSET_BLOCK_SIZE) ? length - pos : APP_ASSET_BLOCK_SIZE;
+
+        if (data == NULL) {
+            asset_flush();
+            return false;
+        }
+        crc = app_store_crc16_update(crc, &data[first], (uint16_t)(last - first));
+    }
+    if (crc != (uint16_t)(header[10] | (header[11] << 8))) {
+        asset_flush();
+        return false;
+    }
+
+    for (uint8_t id = 0; id < APP_ASSET_COUNT; id++) {
+        uint32_t at = APP_ASSET_HEADER_SIZE + (uint32_t)id * APP_ASSET_ENTRY_SIZE;
+        uint8_t entry[APP_ASSET_ENTRY_SIZE];
+
+        asset_index[id].offset = 0;
+        asset_index[id].size = 0;
+        if (id >= count) {
+            continue; // 旧工具生成的块中没有这个资源
+        }
+        if (!asset_copy(at, entry, sizeof(entry))) {
+            asset_flush();
+            return false;
+        }
+        if (get_u32(entry) <= length && get_u32(&entry[4]) <= length - get_u32(entry)) {
+            asset_index[id].offset = get_u32(entry);
+            asset_index[id].size = get_u32(&entry[4]);
+        }
+    }
+    asset_blob = length;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 查询资源区是否可用
+ * @return bool 资源块已校验通过返回 true
+ */
+bool app_asset_ready(void)
+{
+#if W25Q_ENABLE
+    return asset_blob != 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 获取资源的长度
+ * @param[in] id 资源编号
+ * @return uint32_t 长度
+ */
+uint32_t app_asset_size(App_Asset_Id_e id)
+{
+#if W25Q_ENABLE
+    return (asset_blob != 0 && id < APP_ASSET_COUNT) ? asset_index[id].size : 0;
+#else
+    (void)id;
+    return 0;
+#endif
+}
+
+/**
+ * @brief 读取资源中的一段数据
+ * @param[in] id 资源编号
+ * @param[in] offset 资源内的偏移
+ * @param[out] buf 输出缓冲区
+ * @param[in] len 长度
+ * @return bool 读取成功返回 true
+ */
+bool app_asset_read(App_Asset_Id_e id, uint32_t offset, void *buf, uint16_t len)
+{
+#if W25Q_ENABLE
+    if (app_asset_size(id) < len || offset > app_asset_size(id) - len) {
+        return false;
+    }
+    return asset_copy(asset_index[id].offset + offset, buf, len);
+#else
+    (void)id;
+    (void)offset;
+    (void)buf;
+    (void)len;
+    return false;
+#endif
+}
+
+/**
+ * @brief 获取资源区的容量
+ * @return uint32_t 字节数
+ */
+uint32_t app_asset_region_size(void)
+{
+#if W25Q_ENABLE
+    return asset_present ? ASSET_REGION_SIZE : 0;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief 获取已校验的资源块的长度
+ * @return uint32_t 块长度
+ */
+uint32_t app_asset_blob_size(void)
+{
+#if W25Q_ENABLE
+    return asset_blob;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief 擦除资源区中的一个扇区
+ * @param[in] offset 资源区内的偏移
+ * @return HAL_StatusTypeDef 执行结果
+ */
+HAL_StatusTypeDef app_asset_erase(uint32_t offset)
+{
+#if W25Q_ENABLE
+    if (!asset_present || offset >= ASSET_REGION_SIZE || offset % W25Q_SECTOR_SIZE != 0) {
+        return HAL_ERROR;
+    }
+    if (W25Q_Is_Busy()) {
+        return HAL_BUSY;
+    }
+    asset_flush();
+    return W25Q_Erase_Sector(asset_base + offset);
+#else
+    (void)offset;
+    return HAL_ERROR;
+#endif
+}
+
+/**
+ * @brief 写入资源区
+ * @param[in] offset 资源区内的偏移
+ * @param[in] data 数据
+ * @param[in] len 长度
+ * @return HAL_StatusTypeDef 执行结果
+ */
+HAL_StatusTypeDef app_asset_program(uint32_t offset, const uint8_t *data, uint8_t len)
+{
+#if W25Q_ENABLE
+    if (!asset_present || len == 0 || len > APP_ASSET_WRITE_MAX || offset >= ASSET_REGION_SIZE ||
+        offset % W25Q_PAGE_SIZE + len > W25Q_PAGE_SIZE) {
+        return HAL_ERROR;
+    }
+    if (W25Q_Is_Busy()) {
+        return HAL_BUSY; // 也保证了上一次的 asset_tx 已发送完
+    }
+    asset_flush();
+    memcpy(asset_tx, data, len);
+    return W25Q_Program(asset_base + offset, asset_tx, len);
+#else
+    (void)offset;
+    (void)data;
+    (void)len;
+    return HAL_ERROR;
+#endif
+}
+
+/** @} */
@@ -0,0 +1,133 @@
+/**
+ * @file      app_asset.h
+ * @brief     外部闪存资源区头文件
+ * @details   很少使用的大块只读数据 (农历表等) 可以不编入内部 Flash，而由 Tools/asset_pack.py 打包成一个资源块，
+ *            经远程控制协议写入 SPI NOR 闪存 (W25Q_ENABLE) 最后的 APP_ASSET_SECTORS 个扇区，长期数据记录使用其余的扇区。
+ *            资源块的格式 (多字节字段为小端)：
+ *            - 块头 (12)：标识 (4) 块长度 (4，含块头) 资源数 (2) CRC-16 (2，块头之后的全部字节)；
+ *            - 索引：每个资源一项，偏移 (4，相对块的起点) 长度 (4)，按 App_Asset_Id_e 的顺序；
+ *            - 各资源的数据。
+ *            页面和模块按编号读取资源，数据经 APP_ASSET_CACHE_BLOCKS 个 APP_ASSET_BLOCK_SIZE 字节的 RAM 缓存块读出，
+ *            缓存块按最近使用顺序替换：第一次使用时顺序读入整块 (DMA，64 字节约30us)，之后反复访问的数据只读 RAM。
+ *            块中的资源数少于 APP_ASSET_COUNT 时 (旧工具生成)，缺少的资源长度为 0。
+ *            W25Q_ENABLE 为 0、没有检测到闪存或资源块无效时所有读取失败，使用资源的模块按没有数据处理。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_ASSET_H
+#define __APP_ASSET_H
+
+#include "main.h"
+#include "w25q.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppAsset 外部闪存资源
+ * @brief 外部闪存中按编号读取的只读资源和它的 RAM 缓存。
+ * @{
+ */
+
+/**
+ * @defgroup AppAsset_Config 外部闪存资源配置
+ * @{
+ */
+#define APP_ASSET_MAGIC        0x54535341U ///< 块头的标识 ("ASST")
+#define APP_ASSET_SECTORS      16U         ///< 资源区的扇区数 (64KB)，位于闪存的末尾
+#define APP_ASSET_HEADER_SIZE  12U         ///< 块头的长度
+#define APP_ASSET_ENTRY_SIZE   8U          ///< 索引项的长度
+#define APP_ASSET_BLOCK_SIZE   64U         ///< 缓存块的大小，须为 W25Q_PAGE_SIZE 的约数
+#define APP_ASSET_CACHE_BLOCKS 4U          ///< 缓存块数
+#define APP_ASSET_WRITE_MAX    16U         ///< app_asset_program 一次写入的最大长度 (远程请求帧的限制)
+#ifndef APP_ASSET_LUNAR
+#define APP_ASSET_LUNAR        0           ///< 为 1 时农历表不编入固件，从资源区读取 (没有资源块时不显示农历)
+#endif
+/** @} */
+
+#if APP_ASSET_LUNAR && !W25Q_ENABLE
+#error "APP_ASSET_LUNAR requires W25Q_ENABLE (the table is read from the external flash)"
+#endif
+
+/**
+ * @brief 资源编号，与 Tools/asset_pack.py 中的顺序一致
+ */
+typedef enum {
+    APP_ASSET_LUNAR_YEARS = 0, ///< 农历 1999~2099 年的表项 (各4，见 app_lunar.c)
+    APP_ASSET_COUNT            ///< 资源数
+} App_Asset_Id_e;
+
+/**
+ * @brief 初始化资源区
+ * @details 须在 app_datalog_init() (初始化闪存) 之后调用，随后校验资源块 (见 app_asset_mount)。
+ * @return 无
+ */
+void app_asset_init(void);
+
+/**
+ * @brief 校验资源块并读入索引
+ * @details 读出块头，再按块长度顺序读出其余部分计算 CRC (经缓存块，每KB约0.5ms)，通过后读入索引并清空缓存。
+ *          写入新的资源块后由远程命令调用。
+ * @return bool 资源块有效返回 true
+ */
+bool app_asset_mount(void);
+
+/**
+ * @brief 查询资源区是否可用
+ * @return bool 资源块已校验通过返回 true
+ */
+bool app_asset_ready(void);
+
+/**
+ * @brief 获取资源的长度
+ * @param[in] id 资源编号
+ * @return uint32_t 长度，资源不存在或资源区不可用时为 0
+ */
+uint32_t app_asset_size(App_Asset_Id_e id);
+
+/**
+ * @brief 读取资源中的一段数据
+ * @details 经缓存块读出，未命中时从闪存读入整块 (阻塞，DMA)。闪存正在擦除或编程时未命中的读取失败，调用者稍后重试。
+ * @param[in] id 资源编号
+ * @param[in] offset 资源内的偏移
+ * @param[out] buf 输出缓冲区
+ * @param[in] len 长度
+ * @return bool 读取成功返回 true；越界、资源区不可用或闪存忙时返回 false
+ */
+bool app_asset_read(App_Asset_Id_e id, uint32_t offset, void *buf, uint16_t len);
+
+/**
+ * @brief 获取资源区的容量
+ * @return uint32_t 字节数，没有检测到闪存时为 0
+ */
+uint32_t app_asset_region_size(void);
+
+/**
+ * @brief 获取已校验的资源块的长度
+ * @return uint32_t 块长度，资源区不可用时为 0
+ */
+uint32_t app_asset_blob_size(void);
+
+/**
+ * @brief 擦除资源区中的一个扇区
+ * @details 发出命令后立即返回 (最长约400ms，由芯片自行完成)。资源区随即不可用，直到下一次 app_asset_mount()。
+ * @param[in] offset 资源区内的偏移，须与扇区对齐
+ * @return HAL_StatusTypeDef HAL_OK 已开始；HAL_BUSY 闪存忙；HAL_ERROR 参数无效或没有闪存
+ */
+HAL_StatusTypeDef app_asset_erase(uint32_t offset);
+
+/**
+ * @brief 写入资源区
+ * @details 数据先拷贝到内部缓冲区再发出页编程，调用者的缓冲区随即可以复用。资源区随即不可用，直到下一次 app_asset_mount()。
+ * @param[in] offset 资源区内的偏移
+ * @param[in] data 数据
+ * @param[in] len 长度 (1~APP_ASSET_WRITE_MAX)，不能跨越页边界
+ * @return HAL_StatusTypeDef HAL_OK 已开始；HAL_BUSY 闪存忙；HAL_ERROR 参数无效或没有闪存
+ */
+HAL_StatusTypeDef app_asset_program(uint32_t offset, const uint8_t *data, uint8_t len);
+
+/** @} */
+
+#endif /* __APP_ASSET_H */
@@ -0,0 +1,315 @@
+/**
+ * @file      app_astro.c
+ * @brief     日出日落和月相
+ * @details   太阳的计算在当地视正午 (由经度估计) 进行：
+ *            - 平近点角 M 以 2^32 为一周累加 (每天的增量为整数，溢出即取模)，其余角度以 2^16 为一周；
+ *            - 中心差 C = 1.9148°·sin M + 0.0200°·sin 2M，黄经 λ = M + C + 282.9372°，赤纬 sin δ = sin λ·sin 23.44°；
+ *            - 时角 cos ω = (sin(-0.833°) - sin φ·sin δ) / (cos φ·cos δ)，-0.833° 为大气折射与日面半径；
+ *            - 真正午 = 12:00 - 经度·4分钟 + 7.632分钟·sin M - 9.936分钟·sin 2λ (时差)。
+ *            日出日落换算到本地标准时间后再按各自时刻应用夏令时。
+ *            月龄以 2000-01-06 18:14 UTC 的新月为参考，按平均朔望月 29.530589 天取模，在当天正午计算。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_astro.h"
+#include "app_settings.h"
+#include "app_world.h"
+#include "app_bus.h"
+#include "app_fmt.h"
+#include "DS3231.h"
+#include "time_core.h"
+
+/**
+ * @addtogroup AppAstro
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define ASTRO_Q15            32768      ///< Q15 的 1.0
+#define ASTRO_TURN           65536      ///< 一周 (2^16 角度单位)
+#define ASTRO_M0             4265488311U ///< J2000.0 时的平近点角 357.5291° (2^32 为一周)
+#define ASTRO_M_RATE         11758669   ///< 平近点角每天的增量 0.98560028° (2^32 为一周)
+#define ASTRO_LAMBDA_OFFSET  51507      ///< 黄经相对平近点角的偏移 180° + 102.9372° (近日点黄经)
+#define ASTRO_C1_Q4          5577       ///< 中心差的一次项 1.9148° (2^16 为一周，Q4)
+#define ASTRO_C2_Q4          58         ///< 中心差的二次项 0.0200° (2^16 为一周，Q4)
+#define ASTRO_SIN_EPS        13034      ///< sin 23.44° (黄赤交角，Q15)
+#define ASTRO_SIN_H0         (-476)     ///< sin(-0.833°) (日出日落时太阳中心的高度，Q15)
+#define ASTRO_EOT_M_S        458        ///< 时差的 sin M 项 (秒)
+#define ASTRO_EOT_L_S        596        ///< 时差的 sin 2λ 项 (秒)
+#define ASTRO_MOON_REF       497640     ///< 参考新月 2000-01-06 18:14 UTC 的纪元秒
+#define ASTRO_MOON_SYNODIC   2551443    ///< 平均朔望月 (秒)
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief 四分之一周的正弦表 (Q15)
+ * @details 第 i 项为 sin(i * 90° / 64) * 32767，查表时在相邻两项之间线性插值，误差小于 1e-4。
+ */
+static const int16_t astro_sin_q15[65] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179,
+    7962, 8739, 9512, 10278, 11039, 11793, 12539, 13279, 14010, 14732,
+    15446, 16151, 16846, 17530, 18204, 18868, 19519, 20159, 20787, 21403,
+    22005, 22594, 23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956, 30273, 30571,
+    30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521,
+    32609, 32678, 32728, 32757, 32767,
+};
+
+/**
+ * @brief 月相的显示名称，与 App_Astro_Moon_e 一一对应
+ */
+static const char *const astro_moon_names[APP_ASTRO_MOON_COUNT] = {
+    "New", "Wax Cres", "1st Qtr", "Wax Gib", "Full", "Wan Gib", "3rd Qtr", "Wan Cres",
+};
+
+static App_Astro_t astro;          ///< 当天的结果
+static char astro_sun_text[13];    ///< 日出日落的显示文字
+static char astro_moon_text[16];   ///< 月相的显示文字
+static uint32_t astro_day;         ///< 结果对应的本地日期 (2000-01-01 起的天数)
+static uint8_t astro_home;         ///< 结果对应的本地城市
+static bool astro_dst;             ///< 结果对应的夏令时开关
+static App_Bus_Sub_t astro_subs[2]; ///< 日期和设置变化的订阅
+
+/* Private function prototypes -----------------------------------------------*/
+static int16_t astro_sin(uint16_t a);
+static int16_t astro_cos(uint16_t a);
+static uint16_t astro_acos(int32_t c);
+static uint16_t astro_local_min(uint32_t day, int32_t std_s, bool dst_enabled);
+static void astro_compute_sun(uint32_t day, int16_t lat_d, int16_t lon_d, int16_t utc_min, bool dst_enabled);
+static void astro_compute_moon(uint32_t day, int16_t utc_min);
+static void astro_format(void);
+static void astro_refresh(App_Bus_Topic_e topic, void *arg);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 正弦
+ * @param[in] a 角度 (2^16 为一周)
+ * @return int16_t sin a (Q15)
+ */
+static int16_t astro_sin(uint16_t a)
+{
+    uint16_t x = a & 0x3FFFU;
+    uint16_t i;
+    int32_t v;
+
+    if (a & 0x4000U) {
+        x = (uint16_t)(0x4000U - x); // 第二、四象限镜像
+    }
+    i = x >> 8;
+    v = astro_sin_q15[i];
+    if (i < 64) {
+        v += ((int32_t)(astro_sin_q15[i + 1] - astro_sin_q15[i]) * (x & 0xFFU)) >> 8;
+    }
+    return (int16_t)((a & 0x8000U) ? -v : v);
+}
+
+/**
+ * @brief 余弦
+ * @param[in] a 角度 (2^16 为一周)
+ * @return int16_t cos a (Q15)
+ */
+static int16_t astro_cos(uint16_t a)
+{
+    return astro_sin((uint16_t)(a + 0x4000U));
+}
+
+/**
+ * @brief 反余弦
+ * @details 余弦在 [0, 半周] 上单调递减，二分查找 15 次。
+ * @param[in] c 余弦值 (Q15，-32767 ~ 32767)
+ * @return uint16_t 角度 (0 ~ 半周，2^16 为一周)
+ */
+static uint16_t astro_acos(int32_t c)
+{
+    uint16_t lo = 0, hi = ASTRO_TURN / 2;
+
+    while (hi - lo > 1) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (astro_cos(mid) > c) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief 把当天的本地标准时间换算为应用夏令时后的分钟数
+ * @param[in] day 本地日期 (2000-01-01 起的天数)
+ * @param[in] std_s 当天 0 点起的本地标准时间 (秒，可超出一天的范围)
+ * @param[in] dst_enabled 是否应用夏令时
+ * @return uint16_t 本地时间在一天中的分钟数 (0~1439)
+ */
+static uint16_t astro_local_min(uint32_t day, int32_t std_s, bool dst_enabled)
+{
+    Epoch_t std = (Epoch_t)((int32_t)(day * TIME_SECS_PER_DAY) + std_s);
+    Epoch_t local = Time_Apply_Dst(std, dst_enabled);
+
+    return (uint16_t)((local % TIME_SECS_PER_DAY) / 60U);
+}
+
+/**
+ * @brief 计算日出日落
+ * @param[in] day 本地日期 (2000-01-01 起的天数)
+ * @param[in] lat_d 纬度 (0.1°)
+ * @param[in] lon_d 经度 (0.1°)
+ * @param[in] utc_min 标准时间的 UTC 偏移 (分钟)
+ * @param[in] dst_enabled 是否应用夏令时
+ * @return 无
+ */
+static void astro_compute_sun(uint32_t day, int16_t lat_d, int16_t lon_d, int16_t utc_min, bool dst_enabled)
+{
+    // 当地视正午相对 J2000.0 (2000-01-01 12:00 UTC) 的分钟数
+    int32_t t_min = (int32_t)day * 1440 - lon_d * 2 / 5;
+    uint32_t m32 = ASTRO_M0 + (uint32_t)((int64_t)t_min * ASTRO_M_RATE / 1440);
+    uint16_t m = (uint16_t)(m32 >> 16);
+    int32_t sin_m = astro_sin(m);
+    int32_t c = (ASTRO_C1_Q4 * sin_m + ASTRO_C2_Q4 * astro_sin((uint16_t)(2U * m))) / (ASTRO_Q15 * 16);
+    uint16_t lambda = (uint16_t)(m + c + ASTRO_LAMBDA_OFFSET);
+    int32_t sin_dec = (int32_t)astro_sin(lambda) * ASTRO_SIN_EPS / ASTRO_Q15;
+    uint16_t dec = (uint16_t)(ASTRO_TURN / 4 - astro_acos(sin_dec)); // asin
+    uint16_t phi = (uint16_t)((int32_t)lat_d * ASTRO_TURN / 3600);
+    int32_t num = ASTRO_SIN_H0 - (int32_t)astro_sin(phi) * sin_dec / ASTRO_Q15;
+    int32_t den = (int32_t)astro_cos(phi) * astro_cos(dec) / ASTRO_Q15;
+    int32_t noon_s, w_s;
+
+    if (num >= den) {
+        astro.sun = APP_ASTRO_SUN_POLAR_NIGHT;
+        return;
+    }
+    if (num <= -den) {
+        astro.sun = APP_ASTRO_SUN_MIDNIGHT_SUN;
+        return;
+    }
+    astro.sun = APP_ASTRO_SUN_NORMAL;
+
+    // 真正午 (本地标准时间，当天 0 点起的秒数) 和半昼长
+    noon_s = 43200 - lon_d * 24 + utc_min * 60 +
+             (ASTRO_EOT_M_S * sin_m - ASTRO_EOT_L_S * astro_sin((uint16_t)(2U * lambda))) / ASTRO_Q15;
+    w_s = (int32_t)astro_acos(num * ASTRO_Q15 / den) * 675 / 512; // 一周 = 86400 秒
+    astro.sunrise_min = astro_local_min(day, noon_s - w_s, dst_enabled);
+    astro.sunset_min = astro_local_min(day, noon_s + w_s, dst_enabled);
+}
+
+/**
+ * @brief 计算当天正午的月相
+ * @param[in] day 本地日期 (2000-01-01 起的天数)
+ * @param[in] utc_min 标准时间的 UTC 偏移 (分钟)
+ * @return 无
+ */
+static void astro_compute_moon(uint32_t day, int16_t utc_min)
+{
+    int64_t since = (int64_t)day * TIME_SECS_PER_DAY + 43200 - utc_min * 60 - ASTRO_MOON_REF;
+    uint32_t age = (uint32_t)(((since % ASTRO_MOON_SYNODIC) + ASTRO_MOON_SYNODIC) % ASTRO_MOON_SYNODIC);
+    uint16_t angle = (uint16_t)((uint64_t)age * ASTRO_TURN / ASTRO_MOON_SYNODIC);
+
+    astro.moon_age = (uint8_t)(age / TIME_SECS_PER_DAY);
+    astro.moon_phase = (uint8_t)(((age * 8U + ASTRO_MOON_SYNODIC / 2) / ASTRO_MOON_SYNODIC) % APP_ASTRO_MOON_COUNT);
+    astro.moon_illum = (uint8_t)(((32767 - astro_cos(angle)) * 100 + 32767) / 65534);
+}
+
+/**
+ * @brief 生成显示用的文字
+ * @return 无
+ */
+static void astro_format(void)
+{
+    char *p;
+
+    if (astro.sun == APP_ASTRO_SUN_NORMAL) {
+        p = fmt_u2(astro_sun_text, astro.sunrise_min / 60);
+        p = fmt_char(p, ':');
+        p = fmt_u2(p, astro.sunrise_min % 60);
+        p = fmt_char(p, '-');
+        p = fmt_u2(p, astro.sunset_min / 60);
+        p = fmt_char(p, ':');
+        fmt_u2(p, astro.sunset_min % 60);
+    } else {
+        fmt_str(astro_sun_text, (astro.sun == APP_ASTRO_SUN_POLAR_NIGHT) ? "Polar night" : "Midnight sun");
+    }
+
+    p = fmt_str(astro_moon_text, astro_moon_names[astro.moon_phase]);
+    p = fmt_char(p, ' ');
+    p = fmt_uint(p, astro.moon_illum, 1);
+    fmt_char(p, '%');
+}
+
+/**
+ * @brief 日期或设置变化的通知
+ * @details 本地日期、本地城市或夏令时开关与上一次计算时不同才重新计算。
+ * @param[in] topic 未使用
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void astro_refresh(App_Bus_Topic_e topic, void *arg)
+{
+    DS3231_Cache_Snap_t snap;
+    uint8_t home = g_app_settings.world_home;
+    bool dst_enabled = g_app_settings.dst_enabled;
+    int16_t lat_d, lon_d, utc_min;
+    uint32_t day;
+
+    (void)topic;
+    (void)arg;
+    if (!DS3231_Cache_Get(&snap) || !app_world_city_location(home, &lat_d, &lon_d, &utc_min)) {
+        return;
+    }
+    day = Time_Apply_Dst(snap.epoch, dst_enabled) / TIME_SECS_PER_DAY;
+    if (astro.valid && day == astro_day && home == astro_home && dst_enabled == astro_dst) {
+        return;
+    }
+
+    astro_day = day;
+    astro_home = home;
+    astro_dst = dst_enabled;
+    astro_compute_sun(day, lat_d, lon_d, utc_min, dst_enabled);
+    astro_compute_moon(day, utc_min);
+    astro_format();
+    astro.valid = true;
+    astro.seq++;
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 订阅日期和设置的变化
+ * @return 无
+ */
+void app_astro_init(void)
+{
+    app_bus_subscribe(&astro_subs[0], APP_BUS_TIME_DAY, astro_refresh, NULL);
+    app_bus_subscribe(&astro_subs[1], APP_BUS_SETTINGS_CHANGED, astro_refresh, NULL);
+}
+
+/**
+ * @brief 获取当天的计算结果
+ * @return const App_Astro_t* 缓存的结果
+ */
+const App_Astro_t *app_astro_get(void)
+{
+    return &astro;
+}
+
+/**
+ * @brief 获取日出日落的显示文字
+ * @return const char* 文字
+ */
+const char *app_astro_sun_text(void)
+{
+    return astro_sun_text;
+}
+
+/**
+ * @brief 获取月相的显示文字
+ * @return const char* 文字
+ */
+const char *app_astro_moon_text(void)
+{
+    return astro_moon_text;
+}
+
+/** @} */
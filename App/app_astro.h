@@ -0,0 +1,94 @@
+/**
+ * @file      app_astro.h
+ * @brief     日出日落和月相头文件
+ * @details   位置取本地城市 (g_app_settings.world_home) 的坐标 (app_world)。
+ *            结果每天只计算一次：收到 APP_BUS_TIME_DAY (本地日期变化) 或设置变化 (本地城市、夏令时) 时
+ *            重新计算并缓存，同时生成显示用的文字；表盘只读取缓存，每秒没有额外的开销。
+ *            计算全部为定点运算 (芯片没有 FPU)：角度以 2^16 (或 2^32) 为一周，三角函数由 Q15 的四分之一周正弦表插值，
+ *            反余弦用二分查找。太阳位置按近似公式 (平近点角、中心差、黄经、赤纬、时差)，日出日落误差约 1~2 分钟；
+ *            月龄按平均朔望月由参考新月推算，误差在半天以内。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_ASTRO_H
+#define __APP_ASTRO_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppAstro 日出日落和月相
+ * @brief 每天计算一次的天文信息。
+ * @{
+ */
+
+/**
+ * @brief 当天太阳的情况
+ */
+typedef enum {
+    APP_ASTRO_SUN_NORMAL = 0,  ///< 有日出和日落
+    APP_ASTRO_SUN_POLAR_NIGHT, ///< 极夜 (全天不升起)
+    APP_ASTRO_SUN_MIDNIGHT_SUN ///< 极昼 (全天不落下)
+} App_Astro_Sun_e;
+
+/**
+ * @brief 月相
+ */
+typedef enum {
+    APP_ASTRO_MOON_NEW = 0,         ///< 新月
+    APP_ASTRO_MOON_WAXING_CRESCENT, ///< 娥眉月
+    APP_ASTRO_MOON_FIRST_QUARTER,   ///< 上弦月
+    APP_ASTRO_MOON_WAXING_GIBBOUS,  ///< 盈凸月
+    APP_ASTRO_MOON_FULL,            ///< 满月
+    APP_ASTRO_MOON_WANING_GIBBOUS,  ///< 亏凸月
+    APP_ASTRO_MOON_LAST_QUARTER,    ///< 下弦月
+    APP_ASTRO_MOON_WANING_CRESCENT, ///< 残月
+    APP_ASTRO_MOON_COUNT
+} App_Astro_Moon_e;
+
+/**
+ * @brief 一天的计算结果
+ */
+typedef struct {
+    bool valid;           ///< 是否已计算 (时间缓存同步之前为 false)
+    uint8_t seq;          ///< 每次重新计算后加一，供显示判断是否需要重绘
+    uint8_t sun;          ///< 太阳的情况 (App_Astro_Sun_e)
+    uint8_t moon_phase;   ///< 月相 (App_Astro_Moon_e)
+    uint8_t moon_age;     ///< 月龄 (天，0~29)
+    uint8_t moon_illum;   ///< 月面照亮的比例 (%)
+    uint16_t sunrise_min; ///< 日出时刻 (本地时间，当天 0 点起的分钟数)，sun 为 APP_ASTRO_SUN_NORMAL 时有效
+    uint16_t sunset_min;  ///< 日落时刻 (本地时间，当天 0 点起的分钟数)
+} App_Astro_t;
+
+/**
+ * @brief 订阅日期和设置的变化
+ * @details 计算在第一次收到 APP_BUS_TIME_DAY (时间缓存同步后的第一分钟) 时进行。
+ * @return 无
+ */
+void app_astro_init(void);
+
+/**
+ * @brief 获取当天的计算结果
+ * @return const App_Astro_t* 缓存的结果
+ */
+const App_Astro_t *app_astro_get(void);
+
+/**
+ * @brief 获取日出日落的显示文字
+ * @return const char* 如 "06:12-18:03"，极夜和极昼时为 "Polar night" 和 "Midnight sun"，未计算时为空字符串
+ */
+const char *app_astro_sun_text(void);
+
+/**
+ * @brief 获取月相的显示文字
+ * @return const char* 如 "1st Qtr 52%"，未计算时为空字符串
+ */
+const char *app_astro_moon_text(void);
+
+/** @} */
+
+#endif /* __APP_ASTRO_H */
@@ -0,0 +1,217 @@
+/**
+ * @file      app_baro.c
+ * @brief     气压采样与趋势
+ * @details   测量由一个可推迟的软件定时器触发，定时器回调只请求测量，总线事务在 BMP280_Poll 中推进。
+ *            气压样本以 0.1hPa 存为 uint16_t (0 表示该时刻没有测量结果)，APP_BARO_SAMPLES 个样本共 74 字节，
+ *            样本时刻跟随温度历史：app_history_seq 每增加一次记入一个样本，历史因时间跳变连续补入多个样本时
+ *            这里也补入同样多个空样本。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_baro.h"
+#include "BMP280.h"
+#include "app_bus.h"
+#include "app_timer.h"
+
+/**
+ * @addtogroup AppBaro
+ * @{
+ */
+
+#if BMP280_ENABLE
+
+/* Private variables ---------------------------------------------------------*/
+static App_Timer_t baro_timer;                  ///< 下一次触发测量
+static uint16_t baro_ring[APP_BARO_SAMPLES];    ///< 气压样本 (0.1hPa)，0 为空
+static uint8_t baro_head;                       ///< 下一个样本写入的位置
+static uint8_t baro_count;                      ///< 已记录的样本数 (不超过 APP_BARO_SAMPLES)
+static uint32_t baro_seq;                       ///< 上一次记入样本时温度历史的样本总数
+static uint16_t baro_now;                       ///< 当前气压 (0.1hPa)，0 为尚无结果
+
+/* Private function prototypes -----------------------------------------------*/
+static void baro_start_due(void *arg);
+static void baro_push(uint16_t dhpa);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 采样定时器到期，请求一次测量
+ * @details 初始化未完成或上一次测量还在进行时定时器立即重新到期，下一次主循环重试；传感器无应答时不再重试。
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void baro_start_due(void *arg)
+{
+    HAL_StatusTypeDef ret = BMP280_StartMeasurement();
+
+    (void)arg;
+    if (ret == HAL_BUSY) {
+        app_timer_start(&baro_timer, 0, 0, baro_start_due, NULL, APP_TIMER_DEFERRABLE);
+    } else if (ret == HAL_OK) {
+        app_timer_start(&baro_timer, APP_BARO_INTERVAL_MS, 0, baro_start_due, NULL, APP_TIMER_DEFERRABLE);
+    }
+}
+
+/**
+ * @brief 记入一个气压样本
+ * @param[in] dhpa 气压 (0.1hPa)，0 为该时刻没有结果
+ * @return 无
+ */
+static void baro_push(uint16_t dhpa)
+{
+    baro_ring[baro_head] = dhpa;
+    baro_head = (uint8_t)((baro_head + 1U) % APP_BARO_SAMPLES);
+    if (baro_count < APP_BARO_SAMPLES) {
+        baro_count++;
+    }
+}
+
+#endif /* BMP280_ENABLE */
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 初始化气压采样
+ * @return 无
+ */
+void app_baro_init(void)
+{
+#if BMP280_ENABLE
+    BMP280_Begin(&hi2c1);
+    app_timer_start(&baro_timer, 0, 0, baro_start_due, NULL, APP_TIMER_DEFERRABLE);
+#endif
+}
+
+/**
+ * @brief 气压维护函数
+ * @return 无
+ */
+void app_baro_service(void)
+{
+#if BMP280_ENABLE
+    uint32_t seq = app_history_seq();
+
+    if (BMP280_Poll()) {
+        const BMP280_Data_t *raw = BMP280_Get_Last();
+        uint16_t dhpa = (uint16_t)((raw->pressure_pa + 5U) / 10U);
+
+        if (dhpa != baro_now) {
+            baro_now = dhpa;
+            app_bus_publish(APP_BUS_PRESSURE_UPDATED);
+        }
+    }
+
+    if (seq != baro_seq) {
+        uint32_t gap = seq - baro_seq;
+        bool fresh = baro_now != 0 && HAL_GetTick() - BMP280_Get_Last()->timestamp <= APP_BARO_STALE_MS;
+
+        if (baro_seq == 0 || gap > APP_BARO_SAMPLES) {
+            baro_count = 0; // 第一次记录 (历史可能从检查点恢复了很多样本) 或时间跳过了整个记录
+            gap = 1;
+        }
+        while (--gap > 0) {
+            baro_push(0);
+        }
+        baro_push(fresh ? baro_now : 0);
+        baro_seq = seq;
+    }
+#endif
+}
+
+/**
+ * @brief 查询是否有测量正在进行
+ * @return bool 正在测量返回 true
+ */
+bool app_baro_busy(void)
+{
+#if BMP280_ENABLE
+    return BMP280_Is_Measuring();
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 获取当前气压
+ * @param[out] dhpa 气压 (0.1hPa)
+ * @return bool 已有测量结果时返回 true
+ */
+bool app_baro_get(uint16_t *dhpa)
+{
+#if BMP280_ENABLE
+    *dhpa = baro_now;
+    return baro_now != 0;
+#else
+    (void)dhpa;
+    return false;
+#endif
+}
+
+/**
+ * @brief 获取气压倾向
+ * @details 从最新的样本起向前找最早的有效样本，跨度不足 APP_BARO_MIN_SPAN 个间隔时返回未知，
+ *          否则把变化量按比例折算到三小时后分级。
+ * @param[out] delta 三小时的变化量 (0.1hPa)，可为 NULL
+ * @return App_Baro_Trend_e 倾向
+ */
+App_Baro_Trend_e app_baro_trend(int16_t *delta)
+{
+    int32_t d = 0;
+    App_Baro_Trend_e trend = APP_BARO_TREND_UNKNOWN;
+#if BMP280_ENABLE
+    uint16_t newest, oldest = 0;
+    uint16_t span = 0;
+
+    if (app_baro_history(0, &newest)) {
+        for (uint16_t age = APP_BARO_SAMPLES - 1U; age >= APP_BARO_MIN_SPAN; age--) {
+            if (app_baro_history(age, &oldest)) {
+                span = age;
+                break;
+            }
+        }
+    }
+    if (span != 0) {
+        int32_t mag;
+
+        d = ((int32_t)newest - oldest) * (int32_t)(APP_BARO_SAMPLES - 1U) / span;
+        mag = (d < 0) ? -d : d;
+        if (mag < APP_BARO_STEADY_DHPA) {
+            trend = APP_BARO_TREND_STEADY;
+        } else if (mag < APP_BARO_FAST_DHPA) {
+            trend = (d > 0) ? APP_BARO_TREND_RISING : APP_BARO_TREND_FALLING;
+        } else {
+            trend = (d > 0) ? APP_BARO_TREND_RISING_FAST : APP_BARO_TREND_FALLING_FAST;
+        }
+    }
+#endif
+    if (delta != NULL) {
+        *delta = (int16_t)d;
+    }
+    return trend;
+}
+
+/**
+ * @brief 按采样先后读取记录的气压
+ * @param[in] age 0为最新的样本
+ * @param[out] dhpa 气压 (0.1hPa)
+ * @return bool 该样本存在且当时有测量结果时返回 true
+ */
+bool app_baro_history(uint16_t age, uint16_t *dhpa)
+{
+#if BMP280_ENABLE
+    if (age >= baro_count) {
+        return false;
+    }
+    *dhpa = baro_ring[(baro_head + APP_BARO_SAMPLES - 1U - age) % APP_BARO_SAMPLES];
+    return *dhpa != 0;
+#else
+    (void)age;
+    (void)dhpa;
+    return false;
+#endif
+}
+
+/** @} */
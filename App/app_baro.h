@@ -0,0 +1,101 @@
+/**
+ * @file      app_baro.h
+ * @brief     气压采样与趋势头文件
+ * @details   由传感器任务调度 BMP280 的强制模式测量 (每 APP_BARO_INTERVAL_MS 一次，可推迟，熄屏时不为它唤醒)，
+ *            新的结果换算为 0.1hPa，数值变化时发布 APP_BUS_PRESSURE_UPDATED。
+ *            温度历史每记录一个样本 (app_history_seq 增加)，这里同时把当前气压记入一个覆盖最近三小时的环形缓冲区，
+ *            两者的样本时刻一致。气压趋势取三小时的变化量 (不足三小时但已有一小时以上时按比例折算)，
+ *            按气象上常用的三小时气压倾向分为平稳、上升、下降和快速上升、快速下降。
+ *            温度历史的 EEPROM 检查点和 AT24C32 的其余区域都已分配，气压记录只保存在 RAM 中，复位后重新积累。
+ *            BMP280_ENABLE 为 0 时所有函数为空操作，查询函数返回无数据。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_BARO_H
+#define __APP_BARO_H
+
+#include "main.h"
+#include "app_history.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppBaro 气压趋势
+ * @brief 气压的定时采样、三小时记录和倾向判断。
+ * @{
+ */
+
+/**
+ * @defgroup AppBaro_Config 气压趋势配置
+ * @{
+ */
+#define APP_BARO_INTERVAL_MS  60000U ///< 两次测量的间隔 (每次在总线上约16字节)
+#define APP_BARO_TREND_S      10800U ///< 气压倾向的时间跨度 (3小时)
+#define APP_BARO_SAMPLES      (APP_BARO_TREND_S / APP_HISTORY_PERIOD_S + 1U) ///< 记录的样本数 (含两端)
+#define APP_BARO_MIN_SPAN     12U    ///< 折算趋势所需的最少样本间隔数 (1小时)
+#define APP_BARO_STEADY_DHPA  10     ///< 三小时变化小于该值 (0.1hPa) 时为平稳
+#define APP_BARO_FAST_DHPA    36     ///< 三小时变化不小于该值 (0.1hPa) 时为快速变化
+#define APP_BARO_STALE_MS     (3U * APP_BARO_INTERVAL_MS) ///< 超过该时间没有新结果时不再记入样本
+/** @} */
+
+/**
+ * @brief 三小时气压倾向
+ */
+typedef enum {
+    APP_BARO_TREND_UNKNOWN = 0, ///< 记录不足一小时或传感器未启用
+    APP_BARO_TREND_STEADY,      ///< 平稳
+    APP_BARO_TREND_RISING,      ///< 上升
+    APP_BARO_TREND_FALLING,     ///< 下降
+    APP_BARO_TREND_RISING_FAST, ///< 快速上升
+    APP_BARO_TREND_FALLING_FAST ///< 快速下降 (常预示天气转坏)
+} App_Baro_Trend_e;
+
+/**
+ * @brief 初始化气压采样
+ * @details 开始 BMP280 的非阻塞初始化，初始化完成后立即第一次测量。须在 I2C_Bus_Init 之后调用。
+ * @return 无
+ */
+void app_baro_init(void);
+
+/**
+ * @brief 气压维护函数，在传感器任务中 app_history_service() 之后调用
+ * @details 推进 BMP280 的初始化和测量，得到新结果时更新当前气压，温度历史记录了新样本时记入气压样本。
+ * @return 无
+ */
+void app_baro_service(void);
+
+/**
+ * @brief 查询是否有测量正在进行
+ * @details 测量期间主循环保持每个 SysTick 推进一次，不进入停止模式 (最长约 BMP280_MEASURE_TIME_MS)。
+ * @return bool 正在测量返回 true
+ */
+bool app_baro_busy(void);
+
+/**
+ * @brief 获取当前气压
+ * @param[out] dhpa 气压 (0.1hPa)
+ * @return bool 已有测量结果时返回 true
+ */
+bool app_baro_get(uint16_t *dhpa);
+
+/**
+ * @brief 获取气压倾向
+ * @param[out] delta 三小时的变化量 (0.1hPa)，可为 NULL；不足三小时时为按比例折算的值
+ * @return App_Baro_Trend_e 倾向
+ */
+App_Baro_Trend_e app_baro_trend(int16_t *delta);
+
+/**
+ * @brief 按采样先后读取记录的气压
+ * @param[in] age 0为最新的样本，1为上一个，依此类推
+ * @param[out] dhpa 气压 (0.1hPa)
+ * @return bool 该样本存在且当时有测量结果时返回 true
+ */
+bool app_baro_history(uint16_t age, uint16_t *dhpa);
+
+/** @} */
+
+#endif /* __APP_BARO_H */
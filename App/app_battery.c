@@ -0,0 +1,165 @@
+/**
+ * @file      app_battery.c
+ * @brief     低电量模式
+ * @details   电压低通的状态以 2^APP_BATTERY_IIR_SHIFT 倍保存，第一次测量直接作为初值，上电即按实际电压分级。
+ *            各项功耗设置只在等级变化时调用一次对应模块的接口，模块自己在之后的每一帧 (或每次计算目标) 时生效。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_battery.h"
+#include "app_anim.h"
+#include "app_bright.h"
+#include "app_bus.h"
+#include "app_display.h"
+#include "app_sensor.h"
+#include "app_timer.h"
+#include "supply.h"
+
+/**
+ * @addtogroup AppBattery
+ * @{
+ */
+
+/* Private variables ---------------------------------------------------------*/
+static App_Timer_t sample_timer;                  ///< 测量的周期定时器 (可推迟)
+static App_Battery_Level_e level = APP_BATTERY_OK; ///< 当前的电量等级
+static uint32_t mv_state;                         ///< 低通状态 (mV << APP_BATTERY_IIR_SHIFT)，0 表示尚未测量
+static uint16_t mv_out;                           ///< 滤波后的电压 (mV)
+static uint8_t percent = 100;                     ///< 电量百分比
+
+/**
+ * @brief 各等级的帧周期下限 (ms)，按 App_Battery_Level_e 索引
+ */
+static const uint16_t level_frame_ms[] = {0, APP_BATTERY_LOW_FRAME_MS, APP_BATTERY_CRITICAL_FRAME_MS};
+
+/**
+ * @brief 各等级的最高对比度，按 App_Battery_Level_e 索引
+ */
+static const uint8_t level_contrast[] = {255, APP_BATTERY_LOW_CONTRAST, APP_BATTERY_CRITICAL_CONTRAST};
+
+/* Private function prototypes -----------------------------------------------*/
+static void battery_sample_due(void *arg);
+static App_Battery_Level_e battery_classify(uint16_t mv);
+static uint8_t battery_percent(uint16_t mv);
+static void battery_apply(App_Battery_Level_e lv);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 测量定时器到期，开始一次测量
+ * @details 上一次测量还在转换时跳过这一次。
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void battery_sample_due(void *arg)
+{
+    (void)arg;
+    (void)Supply_Start();
+}
+
+/**
+ * @brief 按电压和当前等级确定新的等级
+ * @details 进入较低一级按阈值判断，已处于该级时须再高出 APP_BATTERY_HYST_MV 才回到较高一级。
+ * @param[in] mv 滤波后的电压 (mV)
+ * @return App_Battery_Level_e 新的等级
+ */
+static App_Battery_Level_e battery_classify(uint16_t mv)
+{
+    uint16_t low = APP_BATTERY_LOW_MV + ((level >= APP_BATTERY_LOW) ? APP_BATTERY_HYST_MV : 0);
+    uint16_t critical = APP_BATTERY_CRITICAL_MV + ((level >= APP_BATTERY_CRITICAL) ? APP_BATTERY_HYST_MV : 0);
+
+    if (mv < critical) {
+        return APP_BATTERY_CRITICAL;
+    }
+    if (mv < low) {
+        return APP_BATTERY_LOW;
+    }
+    return APP_BATTERY_OK;
+}
+
+/**
+ * @brief 电压换算为电量百分比
+ * @param[in] mv 滤波后的电压 (mV)
+ * @return uint8_t 电量 (0~100)
+ */
+static uint8_t battery_percent(uint16_t mv)
+{
+    if (mv <= APP_BATTERY_EMPTY_MV) {
+        return 0;
+    }
+    if (mv >= APP_BATTERY_FULL_MV) {
+        return 100;
+    }
+    return (uint8_t)((uint32_t)(mv - APP_BATTERY_EMPTY_MV) * 100U / (APP_BATTERY_FULL_MV - APP_BATTERY_EMPTY_MV));
+}
+
+/**
+ * @brief 按等级设置帧率、动画、对比度和温湿度采样
+ * @param[in] lv 电量等级
+ * @return 无
+ */
+static void battery_apply(App_Battery_Level_e lv)
+{
+    bool saving = (lv != APP_BATTERY_OK);
+
+    Page_Manager_Set_Frame_Floor(level_frame_ms[lv]);
+    Anim_Set_Reduced(ANIM_REDUCED_BATTERY, saving);
+    app_bright_set_cap(level_contrast[lv]);
+    app_sensor_set_economy(saving);
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+void app_battery_init(void)
+{
+    app_timer_start(&sample_timer, 0, APP_BATTERY_SAMPLE_MS, battery_sample_due, NULL, APP_TIMER_DEFERRABLE);
+}
+
+void app_battery_service(void)
+{
+    App_Battery_Level_e next;
+    uint8_t pct;
+    uint16_t mv;
+
+    if (!Supply_Take(&mv)) {
+        return;
+    }
+    if (mv_state == 0) {
+        mv_state = (uint32_t)mv << APP_BATTERY_IIR_SHIFT;
+    } else {
+        mv_state = mv_state - (mv_state >> APP_BATTERY_IIR_SHIFT) + mv;
+    }
+    mv_out = (uint16_t)(mv_state >> APP_BATTERY_IIR_SHIFT);
+
+    next = battery_classify(mv_out);
+    pct = battery_percent(mv_out);
+    if (next == level && pct == percent) {
+        return;
+    }
+    if (next != level) {
+        level = next;
+        battery_apply(level);
+    }
+    percent = pct;
+    app_bus_publish(APP_BUS_SUPPLY_CHANGED);
+}
+
+App_Battery_Level_e app_battery_level(void)
+{
+    return level;
+}
+
+uint16_t app_battery_mv(void)
+{
+    return mv_out;
+}
+
+uint8_t app_battery_percent(void)
+{
+    return percent;
+}
+
+/** @} */
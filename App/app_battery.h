@@ -0,0 +1,93 @@
+/**
+ * @file      app_battery.h
+ * @brief     低电量模式头文件
+ * @details   软件定时器每 APP_BATTERY_SAMPLE_MS 触发一次供电电压测量 (见 supply.h，ADC 内部参考通道经 DMA 读取)，
+ *            结果经一阶低通后按两级阈值分为正常、电量低和电量极低，进入较低一级立即生效，
+ *            回到较高一级需要高出阈值 APP_BATTERY_HYST_MV，电压在阈值附近波动时不会来回切换。
+ *            低于正常时降低功耗：
+ *            - 限制帧率 (帧周期下限 APP_BATTERY_LOW_FRAME_MS / APP_BATTERY_CRITICAL_FRAME_MS)；
+ *            - 关闭页面切换动画、补间动画和数字翻页 (直接显示结果)；
+ *            - 限制对比度 (APP_BATTERY_LOW_CONTRAST / APP_BATTERY_CRITICAL_CONTRAST)；
+ *            - 温湿度固定按最长间隔采样。
+ *            等级或电量百分比变化时发布 APP_BUS_SUPPLY_CHANGED，主页面在电量变低时提示，
+ *            远程命令 REMOTE_CMD_GET_SUPPLY 返回电压、百分比和等级。
+ *            百分比按 APP_BATTERY_EMPTY_MV 到 APP_BATTERY_FULL_MV 线性换算，阈值按所用电池修改。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_BATTERY_H
+#define __APP_BATTERY_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppBattery 低电量模式
+ * @brief 按供电电压分级降低刷新率、动画和亮度。
+ * @{
+ */
+
+/**
+ * @defgroup AppBattery_Config 低电量模式配置
+ * @{
+ */
+#define APP_BATTERY_SAMPLE_MS         30000 ///< 测量间隔 (ms)，定时器可推迟，熄屏时随唤醒进行
+#define APP_BATTERY_IIR_SHIFT         2     ///< 电压低通的系数为 1/2^n
+#define APP_BATTERY_FULL_MV           3300  ///< 电量 100% 对应的电压 (mV)
+#define APP_BATTERY_EMPTY_MV          2800  ///< 电量 0% 对应的电压 (mV)
+#define APP_BATTERY_LOW_MV            3100  ///< 低于该电压进入电量低 (mV)
+#define APP_BATTERY_CRITICAL_MV       2950  ///< 低于该电压进入电量极低 (mV)
+#define APP_BATTERY_HYST_MV           50    ///< 回到较高一级需要高出阈值的电压 (mV)
+#define APP_BATTERY_LOW_FRAME_MS      50    ///< 电量低时的帧周期下限 (ms)，即最高 20FPS
+#define APP_BATTERY_CRITICAL_FRAME_MS 200   ///< 电量极低时的帧周期下限 (ms)，即最高 5FPS
+#define APP_BATTERY_LOW_CONTRAST      64    ///< 电量低时的最高对比度
+#define APP_BATTERY_CRITICAL_CONTRAST 8     ///< 电量极低时的最高对比度
+/** @} */
+
+/**
+ * @brief 电量等级
+ */
+typedef enum {
+    APP_BATTERY_OK = 0,   ///< 正常 (或尚未测量)
+    APP_BATTERY_LOW,      ///< 电量低
+    APP_BATTERY_CRITICAL  ///< 电量极低
+} App_Battery_Level_e;
+
+/**
+ * @brief 初始化低电量模式并立即开始第一次测量
+ * @details 须在 Supply_Init() 之后调用。
+ * @return 无
+ */
+void app_battery_init(void);
+
+/**
+ * @brief 处理完成的测量并在等级变化时调整功耗设置，需在主循环中周期调用
+ * @return 无
+ */
+void app_battery_service(void);
+
+/**
+ * @brief 获取当前的电量等级
+ * @return App_Battery_Level_e 电量等级
+ */
+App_Battery_Level_e app_battery_level(void);
+
+/**
+ * @brief 获取滤波后的供电电压
+ * @return uint16_t 电压 (mV)，尚未测量时为0
+ */
+uint16_t app_battery_mv(void);
+
+/**
+ * @brief 获取电量百分比
+ * @return uint8_t 电量 (0~100)，尚未测量时为100
+ */
+uint8_t app_battery_percent(void);
+
+/** @} */
+
+#endif /* __APP_BATTERY_H */
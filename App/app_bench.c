@@ -0,0 +1,444 @@
+/**
+ * @file      app_bench.c
+ * @brief     板上微基准测试实现
+ * @details   每个用例先执行一次准备函数 (不计时)，再把被测操作重复执行，每次单独用 CYCCNT 计时，
+ *            统计最小/平均/最大周期数。中断 (SysTick、编码器、SQW) 照常响应，偶尔计入某一次的耗时，
+ *            因此比较两个版本时以最小值为准，平均值和最大值用于发现偶发的等待。
+ *            总线用例会等待事务全部完成后才结束计时，测量结果包括I2C传输时间。
+ *            输出格式 (每行一个用例，列宽固定)：
+ *            [bench] <用例名> n=<次数> min=<周期> avg=<周期> max=<周期>
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_bench.h"
+
+#if APP_BENCH_ENABLE
+
+#include "app_display.h"
+#include "DS3231.h"
+#include "AT24C32.h"
+#include "i2c_bus.h"
+#include "u8g2_stm32_hal.h"
+#include "uart.h"
+#include <stdio.h>
+
+/**
+ * @addtogroup AppBench
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define BENCH_TEXT            "12:34:56" ///< 字符串用例使用的文本 (主页面时钟的宽度)
+#define BENCH_NAME_WIDTH      "-20"      ///< 用例名的列宽 (printf 格式)
+#define BENCH_FLUSH_TIMEOUT   100        ///< 整帧异步刷新的超时时间 (ms)
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 一个用例的统计
+ */
+typedef struct {
+    uint32_t min;  ///< 最短耗时 (周期)
+    uint32_t max;  ///< 最长耗时 (周期)
+    uint64_t sum;  ///< 总耗时 (周期)
+} Bench_Stat_t;
+
+/**
+ * @brief 一个用例
+ */
+typedef struct {
+    const char *name;         ///< 用例名
+    uint16_t runs;            ///< 重复次数
+    void (*setup)(void);      ///< 准备函数 (不计时)，可为NULL
+    void (*run)(uint16_t i);  ///< 被测操作，i 为第几次
+} Bench_Case_t;
+
+/* Private function prototypes -----------------------------------------------*/
+static void bench_wait_bus(void);
+static void bench_print(const char *name, uint16_t runs, const Bench_Stat_t *s);
+static void bench_measure(const char *name, uint16_t runs, void (*run)(uint16_t i));
+static void setup_font(void);
+static void setup_eeprom(void);
+static void setup_stock(void);
+static void setup_bitband(void);
+static void setup_fast_i2c(void);
+static void setup_hal_i2c(void);
+static void run_set_font(uint16_t i);
+static void run_str_width(uint16_t i);
+static void run_draw_str(uint16_t i);
+static void run_draw_box(uint16_t i);
+static void run_draw_pixels(uint16_t i);
+static void run_draw_hline(uint16_t i);
+static void run_draw_vline(uint16_t i);
+static void run_draw_line(uint16_t i);
+static void run_draw_circle(uint16_t i);
+static void run_clear_buffer(uint16_t i);
+static void run_send_buffer(uint16_t i);
+#if U8G2_BUFFER_MODE == 0
+static void run_flush_async(uint16_t i);
+#endif
+static void run_rtc_get_time(uint16_t i);
+static void run_eeprom_write(uint16_t i);
+static void run_page_draw(uint16_t i);
+
+/* Private variables ---------------------------------------------------------*/
+static u8g2_t *bench_u8g2;                     ///< 被测的u8g2实例
+static uint8_t bench_page[AT24C32_PAGE_SIZE];  ///< 页写入用例写回的原有数据
+static volatile uint32_t bench_sink;           ///< 接收被测函数的返回值，防止调用被优化掉
+
+/**
+ * @brief 固定用例表，输出顺序与此相同
+ */
+static const Bench_Case_t bench_cases[] = {
+    {"u8g2_SetFont",        APP_BENCH_RUNS,    NULL,           run_set_font},
+    {"u8g2_GetStrWidth",    APP_BENCH_RUNS,    setup_font,     run_str_width},
+    {"u8g2_DrawStr",        APP_BENCH_RUNS,    setup_font,     run_draw_str},
+    {"u8g2_DrawBox",        APP_BENCH_RUNS,    NULL,           run_draw_box},
+    {"DrawPixel x64",       APP_BENCH_RUNS,    setup_stock,    run_draw_pixels},
+    {"DrawPixel x64/bb",    APP_BENCH_RUNS,    setup_bitband,  run_draw_pixels},
+    {"u8g2_DrawHLine",      APP_BENCH_RUNS,    setup_stock,    run_draw_hline},
+    {"u8g2_DrawHLine/bb",   APP_BENCH_RUNS,    setup_bitband,  run_draw_hline},
+    {"u8g2_DrawVLine",      APP_BENCH_RUNS,    setup_stock,    run_draw_vline},
+    {"u8g2_DrawVLine/bb",   APP_BENCH_RUNS,    setup_bitband,  run_draw_vline},
+    {"u8g2_DrawLine",       APP_BENCH_RUNS,    setup_stock,    run_draw_line},
+    {"u8g2_DrawLine/bb",    APP_BENCH_RUNS,    setup_bitband,  run_draw_line},
+    {"u8g2_DrawCircle",     APP_BENCH_RUNS,    setup_stock,    run_draw_circle},
+    {"u8g2_DrawCircle/bb",  APP_BENCH_RUNS,    setup_bitband,  run_draw_circle},
+    {"u8g2_ClearBuffer",    APP_BENCH_RUNS,    NULL,           run_clear_buffer},
+    {"u8g2_SendBuffer",     APP_BENCH_IO_RUNS, setup_fast_i2c, run_send_buffer},
+    {"u8g2_SendBuffer/hal", APP_BENCH_IO_RUNS, setup_hal_i2c,  run_send_buffer},
+#if U8G2_BUFFER_MODE == 0
+    {"flush_async",         APP_BENCH_IO_RUNS, setup_fast_i2c, run_flush_async},
+    {"flush_async/hal",     APP_BENCH_IO_RUNS, setup_hal_i2c,  run_flush_async},
+#endif
+    {"DS3231_GetTime",      APP_BENCH_IO_RUNS, NULL,           run_rtc_get_time},
+    {"AT24C32_WritePage",   APP_BENCH_IO_RUNS, setup_eeprom,   run_eeprom_write},
+};
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 等待总线队列中的事务全部完成
+ * @return 无
+ */
+static void bench_wait_bus(void)
+{
+    while (!I2C_Bus_Is_Idle()) {
+        I2C_Bus_Service();
+    }
+}
+
+/**
+ * @brief 输出一行结果并等待发送完成
+ * @param[in] name 用例名
+ * @param[in] runs 重复次数
+ * @param[in] s 统计
+ * @return 无
+ */
+static void bench_print(const char *name, uint16_t runs, const Bench_Stat_t *s)
+{
+    printf("[bench] %" BENCH_NAME_WIDTH "s n=%-4u min=%-9lu avg=%-9lu max=%lu\r\n", name, (unsigned)runs,
+           (unsigned long)s->min, (unsigned long)(s->sum / runs), (unsigned long)s->max);
+    UART_Printf_Flush();
+    while (!UART_Printf_Is_Idle()) {
+    }
+}
+
+/**
+ * @brief 重复执行被测操作并输出统计
+ * @param[in] name 用例名
+ * @param[in] runs 重复次数
+ * @param[in] run 被测操作
+ * @return 无
+ */
+static void bench_measure(const char *name, uint16_t runs, void (*run)(uint16_t i))
+{
+    Bench_Stat_t s = {UINT32_MAX, 0, 0};
+
+    for (uint16_t i = 0; i < runs; i++) {
+        uint32_t start = DWT->CYCCNT;
+        run(i);
+        uint32_t cycles = DWT->CYCCNT - start;
+
+        s.sum += cycles;
+        if (cycles < s.min) {
+            s.min = cycles;
+        }
+        if (cycles > s.max) {
+            s.max = cycles;
+        }
+    }
+    bench_print(name, runs, &s);
+}
+
+/**
+ * @brief 字符串用例的准备：选择主时钟字体并清空缓冲区
+ * @return 无
+ */
+static void setup_font(void)
+{
+    u8g2_SetFont(bench_u8g2, CLOCK_FONT);
+    u8g2_ClearBuffer(bench_u8g2);
+}
+
+/**
+ * @brief 页写入用例的准备：读出原有数据，之后每次原样写回
+ * @return 无
+ */
+static void setup_eeprom(void)
+{
+    AT24C32_ReadPage(APP_BENCH_EEPROM_ADDR, bench_page, sizeof(bench_page));
+}
+
+/**
+ * @brief 绘图用例的准备：使用 u8g2 自带的像素写入
+ * @return 无
+ */
+static void setup_stock(void)
+{
+    u8g2_stm32_SetBitband(bench_u8g2, false);
+}
+
+/**
+ * @brief 绘图用例的准备：使用位带像素写入 (U8G2_BITBAND 为 0 时与 setup_stock 相同)
+ * @return 无
+ */
+static void setup_bitband(void)
+{
+    u8g2_stm32_SetBitband(bench_u8g2, true);
+}
+
+/**
+ * @brief 整帧发送用例的准备：显示器写事务走寄存器级路径 (I2C_BUS_FAST_TX 为 0 时与 setup_hal_i2c 相同)
+ * @return 无
+ */
+static void setup_fast_i2c(void)
+{
+    I2C_Bus_Set_Fast(true);
+}
+
+/**
+ * @brief 整帧发送用例的准备：显示器写事务走 HAL 的 DMA 传输
+ * @return 无
+ */
+static void setup_hal_i2c(void)
+{
+    I2C_Bus_Set_Fast(false);
+}
+
+/**
+ * @brief 设置字体
+ * @details u8g2 在字体没有变化时直接返回，因此在两种字体之间交替。
+ * @param[in] i 第几次
+ * @return 无
+ */
+static void run_set_font(uint16_t i)
+{
+    u8g2_SetFont(bench_u8g2, (i & 1U) ? CLOCK_FONT : DATE_TEMP_FONT);
+}
+
+/**
+ * @brief 计算字符串宽度
+ * @param[in] i 第几次 (未使用)
+ * @return 无
+ */
+static void run_str_width(uint16_t i)
+{
+    (void)i;
+    bench_sink = u8g2_GetStrWidth(bench_u8g2, BENCH_TEXT);
+}
+
+/**
+ * @brief 绘制字符串
+ * @param[in] i 第几次 (未使用)
+ * @return 无
+ */
+static void run_draw_str(uint16_t i)
+{
+    (void)i;
+    bench_sink = u8g2_DrawStr(bench_u8g2, 0, 40, BENCH_TEXT);
+}
+
+/**
+ * @brief 绘制半屏大小的实心方框
+ * @param[in] i 第几次 (未使用)
+ * @return 无
+ */
+static void run_draw_box(uint16_t i)
+{
+    (void)i;
+    u8g2_DrawBox(bench_u8g2, 32, 16, 64, 32);
+}
+
+/**
+ * @brief 逐个绘制 64 个点 (斜线上，每次下移一行)
+ * @param[in] i 第几次
+ * @return 无
+ */
+static void run_draw_pixels(uint16_t i)
+{
+    for (uint8_t k = 0; k < 64; k++) {
+        u8g2_DrawPixel(bench_u8g2, k * 2U, (uint8_t)((k + i) & 63U));
+    }
+}
+
+/**
+ * @brief 绘制整屏宽的水平线 (每个像素在不同的字节中)
+ * @param[in] i 第几次
+ * @return 无
+ */
+static void run_draw_hline(uint16_t i)
+{
+    u8g2_DrawHLine(bench_u8g2, 0, (uint8_t)(i & 63U), 128);
+}
+
+/**
+ * @brief 绘制整屏高的垂直线 (每8个像素在同一字节中)
+ * @param[in] i 第几次
+ * @return 无
+ */
+static void run_draw_vline(uint16_t i)
+{
+    u8g2_DrawVLine(bench_u8g2, (uint8_t)(i & 127U), 0, 64);
+}
+
+/**
+ * @brief 从屏幕中心画一条指针长度的斜线 (表盘指针的画法)，方向随次数变化
+ * @param[in] i 第几次
+ * @return 无
+ */
+static void run_draw_line(uint16_t i)
+{
+    u8g2_DrawLine(bench_u8g2, 64, 32, (uint8_t)(34U + (i % 61U)), 4);
+}
+
+/**
+ * @brief 绘制半径 30 的圆 (表盘外圈的大小)
+ * @param[in] i 第几次 (未使用)
+ * @return 无
+ */
+static void run_draw_circle(uint16_t i)
+{
+    (void)i;
+    u8g2_DrawCircle(bench_u8g2, 64, 32, 30, U8G2_DRAW_ALL);
+}
+
+/**
+ * @brief 清空绘图缓冲区
+ * @param[in] i 第几次 (未使用)
+ * @return 无
+ */
+static void run_clear_buffer(uint16_t i)
+{
+    (void)i;
+    u8g2_ClearBuffer(bench_u8g2);
+}
+
+/**
+ * @brief 经字节回调阻塞发送缓冲区 (整帧模式下为整屏，分页模式下为当前条带)
+ * @param[in] i 第几次 (未使用)
+ * @return 无
+ */
+static void run_send_buffer(uint16_t i)
+{
+    (void)i;
+    u8g2_SendBuffer(bench_u8g2);
+    bench_wait_bus();
+}
+
+#if U8G2_BUFFER_MODE == 0
+/**
+ * @brief 使影子副本失效后异步刷新整帧并等待完成 (页面管理器每帧使用的路径，全部页都有变化时)
+ * @param[in] i 第几次 (未使用)
+ * @return 无
+ */
+static void run_flush_async(uint16_t i)
+{
+    (void)i;
+    u8g2_stm32_InvalidateShadow();
+    u8g2_stm32_SendBufferAsync(bench_u8g2);
+    u8g2_stm32_WaitFlush(BENCH_FLUSH_TIMEOUT);
+}
+#endif
+
+/**
+ * @brief 阻塞读取 DS3231 时间
+ * @param[in] i 第几次 (未使用)
+ * @return 无
+ */
+static void run_rtc_get_time(uint16_t i)
+{
+    Time_t t;
+
+    (void)i;
+    DS3231_GetTime(&t);
+    bench_sink = t.second;
+}
+
+/**
+ * @brief 阻塞写入一页 EEPROM 并等待内部写周期结束
+ * @details 写周期由总线队列以 ACK 轮询等待，排在下一个事务之前，因此计时到总线空闲为止。
+ * @param[in] i 第几次 (未使用)
+ * @return 无
+ */
+static void run_eeprom_write(uint16_t i)
+{
+    (void)i;
+    bench_sink = AT24C32_WritePage(APP_BENCH_EEPROM_ADDR, bench_page, sizeof(bench_page));
+    bench_wait_bus();
+}
+
+/**
+ * @brief 把当前页面完整绘制到缓冲区
+ * @param[in] i 第几次 (未使用)
+ * @return 无
+ */
+static void run_page_draw(uint16_t i)
+{
+    (void)i;
+    Page_Manager_Draw_Current();
+}
+
+/**
+ * @brief 运行全部基准测试并输出结果
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @return 无
+ */
+void app_bench_run(u8g2_t *u8g2)
+{
+    char name[24];
+
+    bench_u8g2 = u8g2;
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    bench_wait_bus(); // 初始化时提交的后台读取 (设置、日志) 不计入第一个总线用例
+
+    printf("[bench] begin clk=%luMHz\r\n", (unsigned long)(SystemCoreClock / 1000000U));
+    for (uint8_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++) {
+        const Bench_Case_t *c = &bench_cases[i];
+        if (c->setup) {
+            c->setup();
+        }
+        bench_measure(c->name, c->runs, c->run);
+    }
+    u8g2_stm32_SetBitband(u8g2, U8G2_BITBAND != 0); // 页面用例使用实际运行时的实现
+    I2C_Bus_Set_Fast(true);
+
+    // 页面只进入一次、不执行 loop，draw 看到的是刚进入时的数据
+    for (uint8_t id = 0; id < PAGE_COUNT; id++) {
+        const Page_Base *page = Page_Get(id);
+        snprintf(name, sizeof(name), "draw:%s", page->page_name);
+        Page_Manager_Go_Page(page);
+        bench_measure(name, APP_BENCH_RUNS, run_page_draw);
+    }
+    Page_Manager_Go_Home();
+
+    printf("[bench] end\r\n");
+    UART_Printf_Flush();
+}
+
+/** @} */
+
+#endif /* APP_BENCH_ENABLE */
@@ -0,0 +1,55 @@
+/**
+ * @file      app_bench.h
+ * @brief     板上微基准测试头文件
+ * @details   在 "Table Clock Bench" 构建目标 (APP_BENCH_ENABLE 为 1) 中，初始化完成后、进入主循环之前
+ *            把一组固定的操作各重复执行若干次，用 DWT->CYCCNT 测量每次的耗时，
+ *            经 uart.c 的 DMA printf 输出一张表 (每个用例一行)：
+ *            u8g2 的设置字体、字符串宽度、绘制字符串、方框和清空缓冲区，
+ *            点、水平/垂直线、斜线和圆 (u8g2 自带的像素写入和位带写入各测一次，后者的用例名带 /bb)，
+ *            整帧发送 (显示器写事务的寄存器级路径和 HAL 路径各测一次，后者的用例名带 /hal)，
+ *            DS3231 读时间、AT24C32 页写入，以及每个页面的 draw。
+ *            输出中不含时间戳和计数以外的变量，两次运行 (或两个版本的固件) 的结果可以直接 diff。
+ *            测量在设置加载完成之前进行，页面按默认设置绘制，结果不受 EEPROM 中的设置影响。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_BENCH_H
+#define __APP_BENCH_H
+
+#include "main.h"
+#include "u8g2.h"
+#include <stdint.h>
+
+/**
+ * @defgroup AppBench 板上微基准测试
+ * @brief 启动时测量一组固定操作的CPU周期数并经串口输出。
+ * @{
+ */
+
+/**
+ * @defgroup AppBench_Config 板上微基准测试配置
+ * @{
+ */
+#ifndef APP_BENCH_ENABLE
+#define APP_BENCH_ENABLE      0      ///< 为 1 时启动后运行基准测试 (由 "Table Clock Bench" 目标的预定义宏打开)
+#endif
+#define APP_BENCH_RUNS        100    ///< 纯计算用例 (绘图、字体) 的重复次数
+#define APP_BENCH_IO_RUNS     16     ///< 总线用例 (整帧发送、读时间、页写入) 的重复次数
+#define APP_BENCH_EEPROM_ADDR 0x0FE0 ///< 页写入用例使用的页 (app_drift 日志的最后一页，读出后原样写回)
+/** @} */
+
+/**
+ * @brief 运行全部基准测试并输出结果
+ * @details 阻塞执行，耗时约数秒；每输出一行等待串口发送完成，结果不会因发送缓冲区满而丢失。
+ *          结束时回到主页面。须在 Page_Manager_Init() 之后调用。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @return 无
+ */
+void app_bench_run(u8g2_t *u8g2);
+
+/** @} */
+
+#endif /* __APP_BENCH_H */
@@ -0,0 +1,278 @@
+/**
+ * @file      app_bright.c
+ * @brief     屏幕亮度调度
+ * @details   目标对比度每秒按设置、时段和环境光计算一次；当前对比度每 APP_BRIGHT_STEP_MS
+ *            最多变化一个步长，数值改变时才发送命令 (一条 3 字节的 I2C 事务)，与画面的刷新互不影响。
+ *            反色状态在计算目标时一起确定，变化时发送一条 2 字节的命令事务。
+ * @author    SandOcean
+ * @date      2025-09-27
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_bright.h"
+#include "app_settings.h"
+#include "u8g2_stm32_hal.h"
+#include "DS3231.h"
+
+/**
+ * @addtogroup AppBright
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define BRIGHT_TARGET_PERIOD_MS 1000 ///< 重新计算目标对比度的周期
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t level;             ///< 当前已发送的对比度
+static uint8_t target;            ///< 目标对比度
+static bool fading;               ///< 是否处于熄屏渐暗
+static uint32_t last_step;        ///< 上一步的时间戳
+static uint32_t last_target;      ///< 上一次计算目标的时间戳
+static uint8_t max_level = 255;   ///< 对比度上限 (低电量)
+static bool inverted;             ///< 显示控制器当前是否反色
+
+/* Private function prototypes -----------------------------------------------*/
+static bool bright_is_night(void);
+static uint8_t bright_target(void);
+static void bright_apply(uint8_t value);
+static bool bright_want_invert(void);
+static void bright_invert(bool on, bool force);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 当前时间是否处于夜间时段
+ * @return bool 夜间 (APP_BRIGHT_NIGHT_HOUR 到第二天 APP_BRIGHT_DAY_HOUR) 返回 true
+ */
+static bool bright_is_night(void)
+{
+    Time_t now;
+
+    DS3231_DST_GetCachedTime(&now, g_app_settings.dst_enabled);
+    return now.hour >= APP_BRIGHT_NIGHT_HOUR || now.hour < APP_BRIGHT_DAY_HOUR;
+}
+
+/**
+ * @brief 按设置、时段和环境光计算目标对比度
+ * @return uint8_t 目标对比度 (不超过上限)
+ */
+static uint8_t bright_target(void)
+{
+    Time_t now;
+    uint32_t value;
+
+    switch (g_app_settings.brightness) {
+        case BRIGHT_HIGH:   value = APP_BRIGHT_LEVEL_HIGH; break;
+        case BRIGHT_MEDIUM: value = APP_BRIGHT_LEVEL_MEDIUM; break;
+        case BRIGHT_LOW:    value = APP_BRIGHT_LEVEL_LOW; break;
+        default:            value = 0; break;
+    }
+    if (value != 0) {
+        return (value > max_level) ? max_level : (uint8_t)value;
+    }
+
+    DS3231_DST_GetCachedTime(&now, g_app_settings.dst_enabled);
+    if (now.hour >= APP_BRIGHT_DAY_HOUR && now.hour < APP_BRIGHT_EVENING_HOUR) {
+        value = APP_BRIGHT_LEVEL_HIGH;
+    } else if (now.hour >= APP_BRIGHT_EVENING_HOUR && now.hour < APP_BRIGHT_NIGHT_HOUR) {
+        value = APP_BRIGHT_LEVEL_MEDIUM;
+    } else {
+        value = APP_BRIGHT_LEVEL_LOW;
+    }
+
+    // 环境光只会调暗，且不低于夜间亮度
+    value = value * app_bright_ambient() / 255U;
+    if (value < APP_BRIGHT_LEVEL_LOW) {
+        value = APP_BRIGHT_LEVEL_LOW;
+    }
+    return (value > max_level) ? max_level : (uint8_t)value;
+}
+
+/**
+ * @brief 发送对比度命令
+ * @param[in] value 对比度
+ * @return 无
+ */
+static void bright_apply(uint8_t value)
+{
+    level = value;
+    u8g2_SetContrast(&u8g2, value);
+}
+
+/**
+ * @brief 按显示模式和时段确定是否反色
+ * @return bool 需要反色返回 true
+ */
+static bool bright_want_invert(void)
+{
+    switch (g_app_settings.display_mode) {
+        case DISPLAY_MODE_INVERT: return true;
+        case DISPLAY_MODE_NIGHT:  return bright_is_night();
+        default:                  return false;
+    }
+}
+
+/**
+ * @brief 设置显示控制器的反色
+ * @param[in] on 为 true 时反色 (0xA7)，否则正常显示 (0xA6)
+ * @param[in] force 为 true 时即使状态没有变化也发送 (初始化时控制器的状态未知)
+ * @return 无
+ */
+static void bright_invert(bool on, bool force)
+{
+    u8x8_t *u8x8 = u8g2_GetU8x8(&u8g2);
+
+    if (on == inverted && !force) {
+        return;
+    }
+    inverted = on;
+    u8x8_cad_StartTransfer(u8x8);
+    u8x8_cad_SendCmd(u8x8, on ? 0xA7 : 0xA6);
+    u8x8_cad_EndTransfer(u8x8);
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 初始化亮度调度
+ * @return 无
+ */
+void app_bright_init(void)
+{
+    fading = false;
+    target = bright_target();
+    last_target = HAL_GetTick();
+    last_step = last_target;
+    bright_apply(target);
+    bright_invert(bright_want_invert(), true);
+}
+
+/**
+ * @brief 亮度调度维护函数
+ * @details 设置在后台加载完成、远程修改或时段切换后，最迟一秒内开始渐变到新的亮度，反色在同一时刻切换。
+ * @return 无
+ */
+void app_bright_service(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint8_t step;
+    uint8_t next;
+
+    if (!fading && now - last_target >= BRIGHT_TARGET_PERIOD_MS) {
+        last_target = now;
+        target = bright_target();
+        bright_invert(bright_want_invert(), false);
+    }
+    if (level == target || now - last_step < APP_BRIGHT_STEP_MS) {
+        return;
+    }
+    last_step = now;
+
+    step = fading ? APP_BRIGHT_FADE_STEP : APP_BRIGHT_RAMP_STEP;
+    if (level < target) {
+        next = (target - level > step) ? (uint8_t)(level + step) : target;
+    } else {
+        next = (level - target > step) ? (uint8_t)(level - step) : target;
+    }
+    bright_apply(next);
+}
+
+/**
+ * @brief 开始熄屏前的渐暗
+ * @return 无
+ */
+void app_bright_fade_out(void)
+{
+    fading = true;
+    target = 0;
+}
+
+/**
+ * @brief 查询是否正在熄屏渐暗或已渐暗完成
+ * @return bool 正在渐暗或已渐暗返回 true
+ */
+bool app_bright_is_fading(void)
+{
+    return fading;
+}
+
+/**
+ * @brief 查询熄屏渐暗是否已完成
+ * @return bool 已完成返回 true
+ */
+bool app_bright_is_faded(void)
+{
+    return fading && level == 0;
+}
+
+/**
+ * @brief 取消渐暗，恢复到当前时段的亮度
+ * @param[in] immediate 为 true 时直接设定，不渐变
+ * @return 无
+ */
+void app_bright_wake(bool immediate)
+{
+    fading = false;
+    target = bright_target();
+    last_target = HAL_GetTick();
+    if (immediate) {
+        bright_apply(target);
+        bright_invert(bright_want_invert(), false);
+    }
+}
+
+/**
+ * @brief 直接设定固定的对比度
+ * @param[in] value 对比度
+ * @return 无
+ */
+void app_bright_hold(uint8_t value)
+{
+    if (value > max_level) {
+        value = max_level;
+    }
+    fading = false;
+    target = value;
+    bright_apply(value);
+    bright_invert(false, false); // 低功耗时钟只点亮数字，反色会点亮整个屏幕
+}
+
+/**
+ * @brief 设置修改后立即重新计算目标对比度和反色
+ * @return 无
+ */
+void app_bright_refresh(void)
+{
+    if (fading) {
+        return;
+    }
+    last_target = HAL_GetTick();
+    target = bright_target();
+    bright_invert(bright_want_invert(), false);
+}
+
+/**
+ * @brief 设置对比度的上限
+ * @param[in] cap 对比度上限
+ * @return 无
+ */
+void app_bright_set_cap(uint8_t cap)
+{
+    max_level = cap;
+    if (!fading && target > cap) {
+        target = cap; // 低功耗时钟的固定对比度随之降低，已经低于上限的不变
+    }
+}
+
+/**
+ * @brief 获取环境光亮度 (弱定义)
+ * @details 默认实现没有传感器，返回 255。
+ * @return uint8_t 环境光亮度 (0~255)
+ */
+__weak uint8_t app_bright_ambient(void)
+{
+    return 255;
+}
+
+/** @} */
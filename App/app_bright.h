@@ -0,0 +1,124 @@
+/**
+ * @file      app_bright.h
+ * @brief     屏幕亮度调度头文件
+ * @details   按设置中的亮度模式和RTC缓存的当前时间计算目标对比度 (SSD1306 的 0x81 命令)，
+ *            当前对比度按固定速率逐步逼近目标，每一步只发送一条 u8g2_SetContrast 命令，不需要重绘画面。
+ *            自动模式下一天分为白天、傍晚、夜间三个时段，可选地再按环境光调暗 (见 app_bright_ambient)。
+ *            自动熄屏时先把对比度渐变到最低再关闭显示器，渐变过程中有输入则恢复亮度。
+ *            设置中的显示模式 (Display_Mode_e) 与目标对比度一起计算，需要时发送一条反色命令 (0xA6/0xA7)，
+ *            由显示控制器反色，画面不需要重绘；夜间反色与自动亮度使用相同的夜间时段。
+ * @author    SandOcean
+ * @date      2025-09-27
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_BRIGHT_H
+#define __APP_BRIGHT_H
+
+#include "main.h"
+#include "app_type.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppBright 亮度调度
+ * @brief 按时段和环境光平滑地调节屏幕对比度。
+ * @{
+ */
+
+/**
+ * @defgroup AppBright_Config 亮度调度配置
+ * @{
+ */
+#define APP_BRIGHT_DAY_HOUR      7   ///< 白天时段的开始时刻 (时)
+#define APP_BRIGHT_EVENING_HOUR  19  ///< 傍晚时段的开始时刻 (时)
+#define APP_BRIGHT_NIGHT_HOUR    22  ///< 夜间时段的开始时刻 (时)，持续到第二天白天开始
+#define APP_BRIGHT_LEVEL_HIGH    255 ///< 高亮度 (白天) 的对比度
+#define APP_BRIGHT_LEVEL_MEDIUM  96  ///< 中亮度 (傍晚) 的对比度
+#define APP_BRIGHT_LEVEL_LOW     8   ///< 低亮度 (夜间) 的对比度
+#define APP_BRIGHT_STEP_MS       20  ///< 渐变时每一步的间隔 (ms)，每步发送一条对比度命令
+#define APP_BRIGHT_RAMP_STEP     4   ///< 时段切换时每一步的对比度变化量，255 到 8 约1.2秒
+#define APP_BRIGHT_FADE_STEP     8   ///< 熄屏渐暗时每一步的对比度变化量，从最亮约0.6秒
+/** @} */
+
+/**
+ * @brief 初始化亮度调度
+ * @details 按当前设置和时间直接设定对比度和反色，不渐变。须在 u8g2Init() 之后调用。
+ * @return 无
+ */
+void app_bright_init(void);
+
+/**
+ * @brief 亮度调度维护函数，需在屏幕点亮时于主循环中周期调用
+ * @details 每秒重新计算一次目标对比度和是否反色 (跟随设置和时段的变化)，每 APP_BRIGHT_STEP_MS 向目标推进一步。
+ * @return 无
+ */
+void app_bright_service(void);
+
+/**
+ * @brief 开始熄屏前的渐暗
+ * @details 对比度渐变到0，完成后 app_bright_is_faded() 返回 true，由调用者关闭显示器。
+ * @return 无
+ */
+void app_bright_fade_out(void);
+
+/**
+ * @brief 查询是否正在熄屏渐暗或已渐暗完成
+ * @return bool 调用过 app_bright_fade_out() 且尚未唤醒时返回 true
+ */
+bool app_bright_is_fading(void);
+
+/**
+ * @brief 查询熄屏渐暗是否已完成
+ * @return bool 对比度已降到0时返回 true
+ */
+bool app_bright_is_faded(void);
+
+/**
+ * @brief 取消渐暗，恢复到当前时段的亮度
+ * @details 熄屏后唤醒时立即设定对比度 (在关闭省电模式之前调用，点亮时即为正常亮度)；
+ *          渐暗过程中有输入时从当前对比度渐变回来。
+ * @param[in] immediate 为 true 时直接设定，不渐变
+ * @return 无
+ */
+void app_bright_wake(bool immediate);
+
+/**
+ * @brief 直接设定固定的对比度
+ * @details 用于低功耗时钟：此后不调用 app_bright_service()，对比度保持不变，
+ *          直到 app_bright_wake() 恢复按设置和时段调度。期间不反色 (只点亮数字)。
+ * @param[in] value 对比度
+ * @return 无
+ */
+void app_bright_hold(uint8_t value);
+
+/**
+ * @brief 设置修改后立即重新计算目标对比度和反色
+ * @details 屏幕点亮时由设置修改的通知调用，新的显示模式立即生效 (一条命令，不重绘)，亮度从当前值渐变过去。
+ *          熄屏渐暗中不处理。
+ * @return 无
+ */
+void app_bright_refresh(void);
+
+/**
+ * @brief 设置对比度的上限
+ * @details 低电量模式下使用，对所有亮度模式和低功耗时钟的固定对比度都有效；
+ *          下一次计算目标时 (最迟一秒后) 开始渐变到不超过上限的亮度。默认为 255 (不限制)。
+ * @param[in] cap 对比度上限
+ * @return 无
+ */
+void app_bright_set_cap(uint8_t cap);
+
+/**
+ * @brief 获取环境光亮度 (弱定义)
+ * @details 自动模式下目标对比度再乘以该值 / 255。板上没有光传感器，默认返回 255 (不调暗)；
+ *          加装光敏电阻并启用 LIGHT_ENABLE 时由 app_main.c 按 light 模块的亮度等级重新定义，返回 0 (最暗) ~ 255 (最亮)。
+ *          每秒调用一次 (等级变化时另由 app_bright_refresh 立即调用)，实现中不应阻塞。
+ * @return uint8_t 环境光亮度
+ */
+uint8_t app_bright_ambient(void);
+
+/** @} */
+
+#endif /* __APP_BRIGHT_H */
@@ -0,0 +1,120 @@
+/**
+ * @file      app_bus.c
+ * @brief     数据变化的发布/订阅总线
+ * @details   每个主题一条订阅者单链表，订阅插入表头。待处理位掩码在中断和主循环之间共享，
+ *            置位和取走都在关中断的几条指令内完成。分发期间回调可能退订任意订阅者，
+ *            下一个待通知的节点保存在 walk_next 中，被退订的恰好是它时向后移动一个。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_bus.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup AppBus
+ * @{
+ */
+
+/* Private variables ---------------------------------------------------------*/
+static App_Bus_Sub_t *bus_heads[APP_BUS_TOPIC_COUNT]; ///< 各主题的订阅者链表头
+static volatile uint32_t bus_pending;                 ///< 待分发的主题 (按主题编号的位)
+static App_Bus_Sub_t *walk_next;                      ///< 分发中下一个待通知的订阅者
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t bus_take(void);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 取走全部待处理位
+ * @return uint32_t 待分发的主题
+ */
+static uint32_t bus_take(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t topics;
+
+    __disable_irq();
+    topics = bus_pending;
+    bus_pending = 0;
+    __set_PRIMASK(primask);
+    return topics;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+void app_bus_subscribe(App_Bus_Sub_t *sub, App_Bus_Topic_e topic, App_Bus_Cb_t cb, void *arg)
+{
+    if (topic >= APP_BUS_TOPIC_COUNT) {
+        return;
+    }
+    app_bus_unsubscribe(sub);
+    sub->cb = cb;
+    sub->arg = arg;
+    sub->topic = (uint8_t)topic;
+    sub->next = bus_heads[topic];
+    bus_heads[topic] = sub;
+    sub->linked = true;
+}
+
+void app_bus_unsubscribe(App_Bus_Sub_t *sub)
+{
+    App_Bus_Sub_t **pp;
+
+    if (!sub->linked) {
+        return;
+    }
+    for (pp = &bus_heads[sub->topic]; *pp != NULL; pp = &(*pp)->next) {
+        if (*pp == sub) {
+            *pp = sub->next;
+            break;
+        }
+    }
+    if (walk_next == sub) {
+        walk_next = sub->next;
+    }
+    sub->next = NULL;
+    sub->linked = false;
+}
+
+void app_bus_publish(App_Bus_Topic_e topic)
+{
+    uint32_t primask;
+
+    if (topic >= APP_BUS_TOPIC_COUNT) {
+        return;
+    }
+    primask = __get_PRIMASK();
+    __disable_irq();
+    bus_pending |= 1UL << topic;
+    __set_PRIMASK(primask);
+}
+
+void app_bus_service(void)
+{
+    uint32_t topics = bus_take();
+
+    for (uint8_t t = 0; topics != 0; t++, topics >>= 1) {
+        if (!(topics & 1U)) {
+            continue;
+        }
+        // 回调中新订阅的插在表头，本次遍历不会经过，从下一次分发开始通知
+        App_Bus_Sub_t *sub = bus_heads[t];
+        while (sub != NULL) {
+            walk_next = sub->next;
+            sub->cb((App_Bus_Topic_e)t, sub->arg); // 回调可能退订任意订阅者
+            sub = walk_next;
+        }
+        walk_next = NULL;
+    }
+}
+
+bool app_bus_pending(void)
+{
+    return bus_pending != 0;
+}
+
+/** @} */
@@ -0,0 +1,107 @@
+/**
+ * @file      app_bus.h
+ * @brief     数据变化的发布/订阅总线头文件
+ * @details   数据源在值变化时发布一个主题 (时间进入新的一秒、一分钟或一天、温湿度滤波结果或越限状态变化、设置被修改、电量变化、环境光等级变化、气压变化)，
+ *            订阅者只在收到通知时工作，不必每一轮都重新读取数据源再比较。
+ *            发布只是把主题的待处理位置位 (可在中断中调用)，通知在主循环调用 app_bus_service() 时
+ *            依次交给该主题的全部订阅者，同一主题在两次分发之间发布多次只通知一次。
+ *            订阅者结构体由使用者分配 (通常为模块内的静态变量)，页面在 enter 中订阅、在 exit 中退订，不使用动态内存。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_BUS_H
+#define __APP_BUS_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppBus 数据总线
+ * @brief 按主题通知数据变化，订阅者静态分配。
+ * @{
+ */
+
+/**
+ * @brief 主题
+ */
+typedef enum {
+    APP_BUS_TIME_SECOND = 0,  ///< RTC时间缓存进入新的一秒 (包括被设置为新的时间)
+    APP_BUS_TIME_MINUTE,      ///< RTC时间缓存进入新的一分钟
+    APP_BUS_TIME_DAY,         ///< RTC时间缓存进入新的一天 (本地时间，已应用夏令时)
+    APP_BUS_SENSOR_UPDATED,   ///< 温湿度的滤波结果变化
+    APP_BUS_SETTINGS_CHANGED, ///< g_app_settings 被修改或加载完成
+    APP_BUS_SUPPLY_CHANGED,   ///< 电量等级或百分比变化 (见 app_battery.h)
+    APP_BUS_SENSOR_ALERT,     ///< 温湿度的越限状态变化 (见 app_sensor_alert)
+    APP_BUS_LIGHT_CHANGED,    ///< 环境光的亮度等级变化 (见 light.h，在 DMA 中断中发布)
+    APP_BUS_PRESSURE_UPDATED, ///< 气压的测量结果变化 (见 app_baro.h)
+    APP_BUS_NIGHT_CHANGED,    ///< 进入或离开夜间时段，或时段内的显示方式变化 (见 app_night.h)
+    APP_BUS_TOPIC_COUNT
+} App_Bus_Topic_e;
+
+/**
+ * @brief 通知回调
+ * @param[in] topic 发布的主题
+ * @param[in] arg 订阅时传入的参数
+ */
+typedef void (*App_Bus_Cb_t)(App_Bus_Topic_e topic, void *arg);
+
+/**
+ * @brief 订阅者
+ * @note 成员由本模块维护，使用者只需分配并在第一次使用前清零 (静态变量即可)。
+ */
+typedef struct App_Bus_Sub {
+    struct App_Bus_Sub *next; ///< 同一主题的下一个订阅者
+    App_Bus_Cb_t cb;          ///< 回调
+    void *arg;                ///< 回调参数
+    uint8_t topic;            ///< 订阅的主题
+    bool linked;              ///< 是否在主题的链表中
+} App_Bus_Sub_t;
+
+/**
+ * @brief 订阅主题
+ * @details 已订阅的先退订，再按新的参数订阅。可在回调中调用，新订阅者从下一次分发开始收到通知。
+ * @param[in,out] sub 订阅者
+ * @param[in] topic 主题
+ * @param[in] cb 回调
+ * @param[in] arg 回调参数
+ * @return 无
+ */
+void app_bus_subscribe(App_Bus_Sub_t *sub, App_Bus_Topic_e topic, App_Bus_Cb_t cb, void *arg);
+
+/**
+ * @brief 退订
+ * @details 未订阅时无操作。可在回调中调用 (包括退订其他订阅者)。
+ * @param[in,out] sub 订阅者
+ * @return 无
+ */
+void app_bus_unsubscribe(App_Bus_Sub_t *sub);
+
+/**
+ * @brief 发布主题
+ * @details 只置位主题的待处理位，可在中断中调用。订阅者在下一次 app_bus_service() 时收到通知。
+ * @param[in] topic 主题
+ * @return 无
+ */
+void app_bus_publish(App_Bus_Topic_e topic);
+
+/**
+ * @brief 把待处理的主题分发给订阅者，需在主循环中周期调用
+ * @details 先取走全部待处理位，按主题的顺序通知；回调中再发布的主题留到下一次分发。
+ * @return 无
+ */
+void app_bus_service(void);
+
+/**
+ * @brief 查询是否有尚未分发的主题
+ * @details 供主循环决定能否进入低功耗模式。
+ * @return bool 有待处理的主题时返回 true
+ */
+bool app_bus_pending(void);
+
+/** @} */
+
+#endif /* __APP_BUS_H */
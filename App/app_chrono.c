@@ -0,0 +1,305 @@
+/**
+ * @file      app_chrono.c
+ * @brief     秒表和倒计时
+ * @details   秒表运行时只记录开始的时间戳，累计时间在读取时计算；暂停时把这一段并入 sw_accum。
+ *            倒计时运行时记录到期的时间戳，同一个软件定时器先用于到期，再用于到期提示的超时。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_chrono.h"
+#include "app_timer.h"
+#include "app_fmt.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup AppChrono
+ * @{
+ */
+
+/* Private variables ---------------------------------------------------------*/
+static bool sw_running;          ///< 秒表是否在运行
+static uint32_t sw_start;        ///< 本段计时开始的时间戳
+static uint32_t sw_accum;        ///< 本段之前累计的时间 (ms)
+static uint32_t sw_lap_mark;     ///< 上一次计次时的累计时间 (ms)
+static uint32_t sw_last_split;   ///< 最近一次计次的分段时间 (ms)
+static uint8_t sw_laps;          ///< 计次的次数
+
+static App_Countdown_State_e cd_state = APP_COUNTDOWN_IDLE; ///< 倒计时的状态
+static uint32_t cd_duration_s = APP_COUNTDOWN_DEFAULT_S;    ///< 设定的倒计时时间 (s)
+static uint32_t cd_deadline;     ///< 运行中到期的时间戳
+static uint32_t cd_left;         ///< 暂停时的剩余时间 (ms)
+static App_Timer_t cd_timer;     ///< 到期定时器，提示期间为提示超时定时器
+
+/* Private function prototypes -----------------------------------------------*/
+static void countdown_expired(void *arg);
+static void countdown_ring_timeout(void *arg);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 倒计时到期
+ * @details 不可推迟的定时器，熄屏时停止模式在到期时刻被唤醒。
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void countdown_expired(void *arg)
+{
+    (void)arg;
+    cd_state = APP_COUNTDOWN_RINGING;
+    cd_left = 0;
+    app_timer_start(&cd_timer, APP_COUNTDOWN_RING_MS, 0, countdown_ring_timeout, NULL, 0);
+    app_countdown_ring(true);
+}
+
+/**
+ * @brief 到期提示无人响应，自动停止
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void countdown_ring_timeout(void *arg)
+{
+    (void)arg;
+    app_countdown_reset();
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 开始或继续秒表
+ * @return 无
+ */
+void app_stopwatch_start(void)
+{
+    if (!sw_running) {
+        sw_start = HAL_GetTick();
+        sw_running = true;
+    }
+}
+
+/**
+ * @brief 暂停秒表
+ * @return 无
+ */
+void app_stopwatch_stop(void)
+{
+    if (sw_running) {
+        sw_accum += HAL_GetTick() - sw_start;
+        sw_running = false;
+    }
+}
+
+/**
+ * @brief 秒表清零
+ * @return 无
+ */
+void app_stopwatch_reset(void)
+{
+    sw_running = false;
+    sw_accum = 0;
+    sw_lap_mark = 0;
+    sw_last_split = 0;
+    sw_laps = 0;
+}
+
+/**
+ * @brief 记录一次计次
+ * @return uint32_t 本次计次的分段时间 (ms)
+ */
+uint32_t app_stopwatch_lap(void)
+{
+    uint32_t elapsed;
+
+    if (!sw_running) {
+        return 0;
+    }
+    elapsed = app_stopwatch_elapsed();
+    sw_last_split = elapsed - sw_lap_mark;
+    sw_lap_mark = elapsed;
+    if (sw_laps < UINT8_MAX) {
+        sw_laps++;
+    }
+    return sw_last_split;
+}
+
+/**
+ * @brief 查询秒表是否在运行
+ * @return bool 运行中返回 true
+ */
+bool app_stopwatch_running(void)
+{
+    return sw_running;
+}
+
+/**
+ * @brief 获取秒表的累计时间
+ * @return uint32_t 累计时间 (ms)
+ */
+uint32_t app_stopwatch_elapsed(void)
+{
+    return sw_running ? sw_accum + (HAL_GetTick() - sw_start) : sw_accum;
+}
+
+/**
+ * @brief 获取最近一次计次
+ * @param[out] split 最近一次的分段时间 (ms)，可为 NULL
+ * @return uint8_t 计次的次数
+ */
+uint8_t app_stopwatch_last_lap(uint32_t *split)
+{
+    if (split != NULL) {
+        *split = sw_last_split;
+    }
+    return sw_laps;
+}
+
+/**
+ * @brief 设定倒计时的时间
+ * @param[in] seconds 倒计时的时间 (s)
+ * @return 无
+ */
+void app_countdown_set(uint32_t seconds)
+{
+    if (cd_state == APP_COUNTDOWN_IDLE) {
+        cd_duration_s = (seconds > APP_COUNTDOWN_MAX_S) ? APP_COUNTDOWN_MAX_S : seconds;
+    }
+}
+
+/**
+ * @brief 获取设定的倒计时时间
+ * @return uint32_t 倒计时的时间 (s)
+ */
+uint32_t app_countdown_duration(void)
+{
+    return cd_duration_s;
+}
+
+/**
+ * @brief 开始或继续倒计时
+ * @return 无
+ */
+void app_countdown_start(void)
+{
+    uint32_t left;
+
+    if (cd_state == APP_COUNTDOWN_IDLE) {
+        left = cd_duration_s * 1000U;
+    } else if (cd_state == APP_COUNTDOWN_PAUSED) {
+        left = cd_left;
+    } else {
+        return;
+    }
+    if (left == 0) {
+        return;
+    }
+    cd_deadline = HAL_GetTick() + left;
+    cd_state = APP_COUNTDOWN_RUNNING;
+    app_timer_start(&cd_timer, left, 0, countdown_expired, NULL, 0);
+}
+
+/**
+ * @brief 暂停倒计时
+ * @return 无
+ */
+void app_countdown_pause(void)
+{
+    if (cd_state == APP_COUNTDOWN_RUNNING) {
+        cd_left = app_countdown_remaining();
+        cd_state = APP_COUNTDOWN_PAUSED;
+        app_timer_stop(&cd_timer);
+    }
+}
+
+/**
+ * @brief 停止倒计时
+ * @return 无
+ */
+void app_countdown_reset(void)
+{
+    bool ringing = (cd_state == APP_COUNTDOWN_RINGING);
+
+    app_timer_stop(&cd_timer);
+    cd_state = APP_COUNTDOWN_IDLE;
+    if (ringing) {
+        app_countdown_ring(false);
+    }
+}
+
+/**
+ * @brief 获取倒计时的状态
+ * @return App_Countdown_State_e 当前状态
+ */
+App_Countdown_State_e app_countdown_state(void)
+{
+    return cd_state;
+}
+
+/**
+ * @brief 获取倒计时的剩余时间
+ * @details 运行中按到期时间戳计算，定时器回调之前已过到期时刻的部分记为0。
+ * @return uint32_t 剩余时间 (ms)
+ */
+uint32_t app_countdown_remaining(void)
+{
+    int32_t left;
+
+    switch (cd_state) {
+        case APP_COUNTDOWN_IDLE:
+            return cd_duration_s * 1000U;
+        case APP_COUNTDOWN_RUNNING:
+            left = (int32_t)(cd_deadline - HAL_GetTick());
+            return (left > 0) ? (uint32_t)left : 0;
+        default:
+            return cd_left;
+    }
+}
+
+/**
+ * @brief 查询秒表或倒计时是否在计时
+ * @return bool 有任何一个在运行时返回 true
+ */
+bool app_chrono_busy(void)
+{
+    return sw_running || cd_state == APP_COUNTDOWN_RUNNING || cd_state == APP_COUNTDOWN_RINGING;
+}
+
+/**
+ * @brief 把时间格式化为秒表的显示格式
+ * @param[out] dst 目标缓冲区 (至少9字节)
+ * @param[in] ms 时间 (ms)
+ * @return char* 字符串结尾的位置
+ */
+char *app_chrono_format(char *dst, uint32_t ms)
+{
+    uint32_t s = ms / 1000U;
+    char *p;
+
+    if (s < 100U * 60U) {
+        p = fmt_u2(dst, (uint16_t)(s / 60U));
+        p = fmt_char(p, ':');
+        p = fmt_u2(p, (uint16_t)(s % 60U));
+        p = fmt_char(p, '.');
+        return fmt_u2(p, (uint16_t)(ms % 1000U / 10U));
+    }
+    uint32_t h = s / 3600U;
+    p = fmt_u2(dst, (uint16_t)((h > 99U) ? 99U : h));
+    p = fmt_char(p, ':');
+    p = fmt_u2(p, (uint16_t)(s / 60U % 60U));
+    p = fmt_char(p, ':');
+    return fmt_u2(p, (uint16_t)(s % 60U));
+}
+
+/**
+ * @brief 倒计时到期提示开始和停止的通知 (弱定义)
+ * @details 默认实现为空。
+ * @param[in] on 开始提示为 true，停止为 false
+ * @return 无
+ */
+__weak void app_countdown_ring(bool on)
+{
+    (void)on;
+}
+
+/** @} */
@@ -0,0 +1,164 @@
+/**
+ * @file      app_chrono.h
+ * @brief     秒表和倒计时头文件
+ * @details   秒表和倒计时都以 HAL_GetTick() 的时间戳计时：SysTick 是一直运行的硬件计数器，
+ *            不需要主循环逐次累加，页面只在绘制时读取一次当前值。停止模式期间 SysTick 停止，
+ *            由 app_power 按 DS3231 的 SQW 脉冲补回 (被按键唤醒时在下一个脉冲补回)，
+ *            因此熄屏后照常计时；秒表或倒计时运行时主循环熄屏后保持1Hz方波，不切换为每分钟闹钟。
+ *            倒计时的到期由一个不可推迟的 app_timer 触发，熄屏时停止模式在到期时刻被唤醒，
+ *            不需要主循环每一轮比较剩余时间。计时状态只在 RAM 中，离开页面后继续运行，复位后清零。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_CHRONO_H
+#define __APP_CHRONO_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppChrono 秒表和倒计时
+ * @brief 基于系统滴答的秒表与由软件定时器触发到期的倒计时。
+ * @{
+ */
+
+/**
+ * @defgroup AppChrono_Config 秒表和倒计时配置
+ * @{
+ */
+#define APP_COUNTDOWN_MAX_S     (99UL * 60 + 59)  ///< 倒计时的最长时间 (s)，显示为 "MM:SS"
+#define APP_COUNTDOWN_DEFAULT_S (5UL * 60)        ///< 上电后倒计时的默认时间 (s)
+#define APP_COUNTDOWN_RING_MS   (60UL * 1000)     ///< 倒计时到期后无人响应时提示的持续时间 (ms)
+/** @} */
+
+/**
+ * @brief 倒计时的状态
+ */
+typedef enum {
+    APP_COUNTDOWN_IDLE = 0, ///< 未开始，剩余时间为设定的时间
+    APP_COUNTDOWN_RUNNING,  ///< 运行中
+    APP_COUNTDOWN_PAUSED,   ///< 已暂停
+    APP_COUNTDOWN_RINGING   ///< 已到期，正在提示
+} App_Countdown_State_e;
+
+/**
+ * @brief 开始或继续秒表
+ * @return 无
+ */
+void app_stopwatch_start(void);
+
+/**
+ * @brief 暂停秒表
+ * @return 无
+ */
+void app_stopwatch_stop(void);
+
+/**
+ * @brief 秒表清零 (同时清除计次)
+ * @return 无
+ */
+void app_stopwatch_reset(void);
+
+/**
+ * @brief 记录一次计次
+ * @details 只在秒表运行时有效。
+ * @return uint32_t 本次计次的分段时间 (ms)，即距上一次计次 (或开始) 的时间
+ */
+uint32_t app_stopwatch_lap(void);
+
+/**
+ * @brief 查询秒表是否在运行
+ * @return bool 运行中返回 true
+ */
+bool app_stopwatch_running(void);
+
+/**
+ * @brief 获取秒表的累计时间
+ * @return uint32_t 累计时间 (ms)
+ */
+uint32_t app_stopwatch_elapsed(void);
+
+/**
+ * @brief 获取最近一次计次
+ * @param[out] split 最近一次的分段时间 (ms)，可为 NULL
+ * @return uint8_t 计次的次数，0 表示没有计次 (超过255次时保持255)
+ */
+uint8_t app_stopwatch_last_lap(uint32_t *split);
+
+/**
+ * @brief 设定倒计时的时间
+ * @details 只在未开始 (APP_COUNTDOWN_IDLE) 时有效，超过 APP_COUNTDOWN_MAX_S 时取最大值。
+ * @param[in] seconds 倒计时的时间 (s)
+ * @return 无
+ */
+void app_countdown_set(uint32_t seconds);
+
+/**
+ * @brief 获取设定的倒计时时间
+ * @return uint32_t 倒计时的时间 (s)
+ */
+uint32_t app_countdown_duration(void);
+
+/**
+ * @brief 开始或继续倒计时
+ * @details 未开始时从设定的时间开始，暂停时从剩余时间继续；设定时间为0时无操作。
+ * @return 无
+ */
+void app_countdown_start(void);
+
+/**
+ * @brief 暂停倒计时
+ * @return 无
+ */
+void app_countdown_pause(void);
+
+/**
+ * @brief 停止倒计时 (包括到期提示)，剩余时间恢复为设定的时间
+ * @return 无
+ */
+void app_countdown_reset(void);
+
+/**
+ * @brief 获取倒计时的状态
+ * @return App_Countdown_State_e 当前状态
+ */
+App_Countdown_State_e app_countdown_state(void);
+
+/**
+ * @brief 获取倒计时的剩余时间
+ * @return uint32_t 剩余时间 (ms)，到期后为0
+ */
+uint32_t app_countdown_remaining(void);
+
+/**
+ * @brief 查询秒表或倒计时是否在计时 (或正在提示)
+ * @details 为 true 时熄屏后保持1Hz方波，使按键唤醒丢失的系统滴答能在下一秒补回。
+ * @return bool 有任何一个在运行时返回 true
+ */
+bool app_chrono_busy(void);
+
+/**
+ * @brief 把时间格式化为秒表的显示格式
+ * @details 不足100分钟时为 "MM:SS.cc" (1/100秒)，之后为 "HH:MM:SS"，小时最多显示到99。
+ * @param[out] dst 目标缓冲区 (至少9字节)
+ * @param[in] ms 时间 (ms)
+ * @return char* 字符串结尾 ('\0') 的位置
+ */
+char *app_chrono_format(char *dst, uint32_t ms);
+
+/**
+ * @brief 倒计时到期提示开始和停止的通知 (弱定义，默认为空)
+ * @details 在软件定时器回调 (主循环上下文) 中调用。应用层重新定义后点亮屏幕并显示倒计时页面；
+ *          停止包括按键停止、app_countdown_reset() 和超过 APP_COUNTDOWN_RING_MS 自动停止。
+ * @param[in] on 开始提示为 true，停止为 false
+ * @return 无
+ */
+void app_countdown_ring(bool on);
+
+/** @} */
+
+#endif /* __APP_CHRONO_H */
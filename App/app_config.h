@@ -45,4 +45,37 @@
 #define ANIM_DURATION_ZOOM  600  ///< 页面元素放大/缩小的动画时长
 /** @} */
 
+/** 
+ * @defgroup Power_Config 低功耗配置
+ * @brief 定义了主循环空闲时进入低功耗模式的参数
+ * @{ 
+ */
+#define POWER_STOP_MARGIN_MS 5    ///< 距下一个SQW脉冲不足该时间时不再进入停止模式
+#define POWER_KEEP_DEBUG     0    ///< 为1时低功耗模式下保持SWD调试连接 (电流更大，仅调试时使用)
+#define POWER_AMBIENT_ENABLE 1    ///< 自动熄屏超时后进入低功耗时钟 (1) 还是关闭显示器 (0)
+#define POWER_AMBIENT_LEVEL  1    ///< 低功耗时钟的对比度
+#define POWER_CLOCK_SCALING  1    ///< 为1时界面空闲期间系统时钟从 72MHz (PLL) 降为 8MHz (HSE)，RTOS 配置下不启用
+#define POWER_CLOCK_HOLD_MS  300  ///< 最后一次输入、动画或远程控制之后保持全速的时间
+#define POWER_TICKLESS       1    ///< 为1时睡眠模式期间停止 1kHz 的 SysTick，到截止时间才唤醒并补回 uwTick，RTOS 配置下不启用
+#define POWER_TICKLESS_MIN_MS 2   ///< 距截止时间不足该值时按普通的睡眠模式等待下一个滴答
+#define POWER_PVD_ENABLE     1    ///< 为1时用电源电压检测 (PVD) 在掉电前保存尚未写入的设置和页面堆栈
+#define POWER_PVD_LEVEL      PWR_PVDLEVEL_7 ///< 掉电检测阈值 (2.9V)，须高于 EEPROM 写入所需的最低电压
+/** @} */
+
+/**
+ * @defgroup Power_Current 各状态的电流
+ * @brief 耗电估算 (Power_Estimate_uAh_Day) 使用的典型值 (uA)，换用实测值后估算即为本机的结果
+ * @{
+ */
+#define POWER_UA_RUN_FAST     24000 ///< MCU 以 72MHz 运行
+#define POWER_UA_RUN_SLOW     5000  ///< MCU 以 8MHz 运行
+#define POWER_UA_SLEEP        3000  ///< 睡眠模式 (外设时钟保持)
+#define POWER_UA_STOP         30    ///< 停止模式 (低功耗调压器)
+#define POWER_UA_DISPLAY_ON   8000  ///< 屏幕点亮 (时钟画面约 15% 的像素点亮)
+#define POWER_UA_DISPLAY_DIM  1500  ///< 低功耗时钟 (最低对比度)
+#define POWER_UA_DISPLAY_OFF  10    ///< 显示器关闭
+#define POWER_UA_I2C_BUSY     700   ///< I2C 事务进行中，两条线上拉电阻的平均电流
+#define POWER_UA_BOARD        150   ///< 始终存在的部分 (DS3231、AHT20 待机、稳压器静态电流)
+/** @} */
+
 #endif /* __APP_CONFIG_H */
@@ -0,0 +1,626 @@
+/**
+ * @file      app_datalog.c
+ * @brief     外部闪存长期数据记录实现
+ * @details   写入位置由当前页的起始位置 (dl_head) 和页缓冲区中的字节数 (dl_fill) 表示，其中前 dl_flushed 字节已编程。
+ *            页缓冲区中 dl_flushed 之后的部分按追加顺序编程，编程期间 DMA 只读取已有的字节，新记录写在它们之后，
+ *            不需要等待；只有换页 (清空页缓冲区) 前须等这一页全部写完。
+ *            每一页的索引项在该页的第一条记录追加时放入待写区，编程时先于这一页的数据，
+ *            断电后索引项可能指向空页，但有数据的页一定有索引项。扇区的标识和序号与第1页的索引项一起写入，
+ *            没有写入标识的扇区启动时不认为是日志的一部分 (其中也没有数据)。
+ *            “下一个扇区已擦除”在擦除命令发出时即置位，之后的编程命令由驱动等到擦除结束才发出。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_datalog.h"
+#include "app_asset.h"
+#include "app_history.h"
+#include "app_baro.h"
+#include <string.h>
+
+/**
+ * @addtogroup AppDatalog
+ * @{
+ */
+
+#if W25Q_ENABLE
+
+#define DATALOG_INDEX_EPOCH 8U          ///< 索引块中第1页首条记录纪元秒的偏移 (之前为标识和序号)
+#define DATALOG_INDEX_SIZE  (DATALOG_INDEX_EPOCH + 4U * (APP_DATALOG_PAGES - 1U)) ///< 索引块的长度
+#define DATALOG_NONE        0xFFFFFFFFU ///< 已擦除的字
+#define POS_SEQ(pos)        ((pos) / W25Q_SECTOR_SIZE) ///< 位置所在扇区的序号
+#define POS_PAGE(pos)       (((pos) % W25Q_SECTOR_SIZE) / W25Q_PAGE_SIZE) ///< 位置在扇区中的页
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t dl_page[W25Q_PAGE_SIZE]; ///< 当前页的缓冲区
+static uint8_t dl_index[12];            ///< 待写的索引项 (打开扇区时为标识、序号和第1页的纪元秒)
+static uint8_t dl_index_len;            ///< 待写索引项的长度，0 为没有
+static uint32_t dl_index_addr;          ///< 待写索引项的闪存地址
+static uint32_t dl_head;                ///< 当前页的起始位置
+static uint16_t dl_fill;                ///< 页缓冲区中的字节数
+static uint16_t dl_flushed;             ///< 其中已编程的字节数
+static uint32_t dl_dirty_ms;            ///< 最早的未编程数据写入页缓冲区的时刻
+static uint32_t dl_oldest;              ///< 最早的有效扇区的序号
+static uint32_t dl_next;                ///< 下一个要打开的扇区的序号
+static uint16_t dl_sectors;             ///< 扇区数，0 为不可用
+static bool dl_open;                    ///< 已打开扇区 (dl_head 有效)
+static bool dl_indexed;                 ///< 当前页的索引项已写入或已放入待写区
+static bool dl_next_erased;             ///< 下一个扇区已擦除 (或已发出擦除命令)
+static bool dl_erasing;                 ///< 擦除命令发出后尚未确认闪存空闲
+static uint32_t dl_history_seq;         ///< 上一次看到的温度历史样本总数
+
+/* Private function prototypes -----------------------------------------------*/
+static void put_u32(uint8_t *p, uint32_t v);
+static uint32_t get_u32(const uint8_t *p);
+static uint32_t datalog_addr(uint32_t pos);
+static bool datalog_erasing(void);
+static bool datalog_wait_idle(void);
+static bool datalog_load(uint32_t pos, uint8_t *buf, uint16_t len);
+static int8_t datalog_peek(uint32_t *pos, uint8_t *hdr, uint32_t end);
+static bool datalog_locate(uint32_t seq);
+static void datalog_pump(void);
+static bool datalog_settle(void);
+static bool datalog_advance(void);
+static void datalog_log_sample(void);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 以小端写入一个字
+ * @param[out] p 目标
+ * @param[in] v 数值
+ * @return 无
+ */
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief 以小端读出一个字
+ * @param[in] p 源
+ * @return uint32_t 数值
+ */
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief 把位置换算为闪存地址
+ * @param[in] pos 位置
+ * @return uint32_t 闪存地址
+ */
+static uint32_t datalog_addr(uint32_t pos)
+{
+    return (POS_SEQ(pos) % dl_sectors) * W25Q_SECTOR_SIZE + pos % W25Q_SECTOR_SIZE;
+}
+
+/**
+ * @brief 查询擦除是否还在进行
+ * @return bool 正在擦除返回 true
+ */
+static bool datalog_erasing(void)
+{
+    if (dl_erasing && !W25Q_Is_Busy()) {
+        dl_erasing = false;
+    }
+    return dl_erasing;
+}
+
+/**
+ * @brief 等待上一次页编程结束
+ * @return bool 闪存空闲返回 true；正在擦除或等待超时返回 false
+ */
+static bool datalog_wait_idle(void)
+{
+    uint32_t start = HAL_GetTick();
+
+    while (W25Q_Is_Busy()) {
+        if (datalog_erasing() || HAL_GetTick() - start > APP_DATALOG_SETTLE_MS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 读出一段日志 (不跨页)，当前页从页缓冲区读出
+ * @param[in] pos 位置
+ * @param[out] buf 输出
+ * @param[in] len 长度
+ * @return bool 成功返回 true
+ */
+static bool datalog_load(uint32_t pos, uint8_t *buf, uint16_t len)
+{
+    if (dl_open && pos >= dl_head && pos - dl_head < W25Q_PAGE_SIZE) {
+        memcpy(buf, &dl_page[pos - dl_head], len);
+        return true;
+    }
+    return datalog_wait_idle() && W25Q_Read(datalog_addr(pos), buf, len) == HAL_OK;
+}
+
+/**
+ * @brief 找到位置处或之后的第一条记录并读出记录头
+ * @details 跳过索引块和页末的空闲部分。
+ * @param[in,out] pos 起始位置，找到时为该记录的位置，到达末尾时为 end
+ * @param[out] hdr 记录头 (APP_DATALOG_HEADER_SIZE 字节)
+ * @param[in] end 末尾位置
+ * @return int8_t 1 找到；0 到达末尾；-1 读取失败
+ */
+static int8_t datalog_peek(uint32_t *pos, uint8_t *hdr, uint32_t end)
+{
+    uint32_t p = *pos;
+
+    while (p < end) {
+        uint16_t in = (uint16_t)(p % W25Q_PAGE_SIZE);
+
+        if (POS_PAGE(p) == 0) {
+            p += W25Q_PAGE_SIZE - in;
+            continue;
+        }
+        if (in + APP_DATALOG_HEADER_SIZE <= W25Q_PAGE_SIZE) {
+            if (!datalog_load(p, hdr, APP_DATALOG_HEADER_SIZE)) {
+                return -1;
+            }
+            if (hdr[0] != APP_DATALOG_END && in + APP_DATALOG_HEADER_SIZE + hdr[1] <= W25Q_PAGE_SIZE) {
+                *pos = p;
+                return 1;
+            }
+        }
+        p += W25Q_PAGE_SIZE - in; // 本页结束
+    }
+    *pos = end;
+    return 0;
+}
+
+/**
+ * @brief 在启动时找到当前扇区中的写入位置
+ * @details 最后一个有索引项的页读入页缓冲区，逐条跳过记录；遇到长度越出本页的记录 (编程时断电) 时认为这一页已满。
+ * @param[in] seq 序号最大的扇区
+ * @return bool 成功返回 true
+ */
+static bool datalog_locate(uint32_t seq)
+{
+    uint8_t index[DATALOG_INDEX_SIZE - DATALOG_INDEX_EPOCH];
+    uint32_t base = seq * W25Q_SECTOR_SIZE;
+    uint8_t page = 1;
+    uint16_t off = 0;
+
+    if (W25Q_Read(datalog_addr(base) + DATALOG_INDEX_EPOCH, index, sizeof(index)) != HAL_OK) {
+        return false;
+    }
+    for (uint8_t p = 2; p < APP_DATALOG_PAGES; p++) {
+        if (get_u32(&index[4U * (p - 1U)]) != DATALOG_NONE) {
+            page = p;
+        }
+    }
+    dl_head = base + page * W25Q_PAGE_SIZE;
+    if (W25Q_Read(datalog_addr(dl_head), dl_page, W25Q_PAGE_SIZE) != HAL_OK) {
+        return false;
+    }
+    while (off + APP_DATALOG_HEADER_SIZE <= W25Q_PAGE_SIZE && dl_page[off] != APP_DATALOG_END) {
+        if (off + APP_DATALOG_HEADER_SIZE + dl_page[off + 1] > W25Q_PAGE_SIZE) {
+            off = W25Q_PAGE_SIZE;
+            break;
+        }
+        off += APP_DATALOG_HEADER_SIZE + dl_page[off + 1];
+    }
+    dl_fill = off;
+    dl_flushed = off;
+    dl_open = true;
+    dl_indexed = true;
+    return true;
+}
+
+/**
+ * @brief 闪存空闲时发出下一个编程命令 (先索引项，后页缓冲区中的新数据)
+ * @return 无
+ */
+static void datalog_pump(void)
+{
+    if (W25Q_Is_Busy()) {
+        return;
+    }
+    dl_erasing = false; // 之后的忙只可能来自编程
+    if (dl_index_len != 0) {
+        if (W25Q_Program(dl_index_addr, dl_index, dl_index_len) != HAL_BUSY) {
+            dl_index_len = 0;
+        }
+    } else if (dl_flushed != dl_fill) {
+        if (W25Q_Program(datalog_addr(dl_head) + dl_flushed, &dl_page[dl_flushed],
+                         (uint16_t)(dl_fill - dl_flushed)) != HAL_BUSY) {
+            dl_flushed = dl_fill;
+        }
+    }
+}
+
+/**
+ * @brief 把当前页全部写入闪存
+ * @return bool 已写完且 DMA 已结束返回 true；正在擦除或等待超时返回 false
+ */
+static bool datalog_settle(void)
+{
+    uint32_t start = HAL_GetTick();
+
+    while (dl_index_len != 0 || dl_flushed != dl_fill || W25Q_Is_Transferring()) {
+        if (datalog_erasing() || HAL_GetTick() - start > APP_DATALOG_SETTLE_MS) {
+            return false;
+        }
+        datalog_pump();
+    }
+    return true;
+}
+
+/**
+ * @brief 换到下一页，当前扇区已写满或尚未打开扇区时打开下一个扇区
+ * @return bool 成功返回 true
+ */
+static bool datalog_advance(void)
+{
+    if (!datalog_settle()) {
+        return false;
+    }
+    if (dl_open && POS_PAGE(dl_head) + 1U < APP_DATALOG_PAGES) {
+        dl_head += W25Q_PAGE_SIZE;
+    } else {
+        if (!dl_next_erased) {
+            return false;
+        }
+        dl_head = dl_next * W25Q_SECTOR_SIZE + W25Q_PAGE_SIZE;
+        dl_next++;
+        dl_next_erased = false;
+        dl_open = true;
+    }
+    memset(dl_page, 0xFF, sizeof(dl_page));
+    dl_fill = 0;
+    dl_flushed = 0;
+    dl_indexed = false;
+    return true;
+}
+
+/**
+ * @brief 温度历史记录了新样本时追加一条样本记录
+ * @details 从 0 变为非 0 (启动后检查点恢复或第一次采样) 时只记下样本总数；一次增加多个样本时只记录最新的一个。
+ * @return 无
+ */
+static void datalog_log_sample(void)
+{
+    uint32_t seq = app_history_seq();
+    uint8_t payload[6];
+    uint16_t dhpa = 0;
+
+    if (seq == dl_history_seq) {
+        return;
+    }
+    if (dl_history_seq != 0) {
+        for (uint8_t s = 0; s < HISTORY_SERIES_COUNT; s++) {
+            int16_t v = INT16_MIN;
+
+            (void)app_history_get((History_Series_e)s, 0, &v);
+            payload[2 * s] = (uint8_t)v;
+            payload[2 * s + 1] = (uint8_t)((uint16_t)v >> 8);
+        }
+        (void)app_baro_history(0, &dhpa);
+        payload[4] = (uint8_t)dhpa;
+        payload[5] = (uint8_t)(dhpa >> 8);
+        (void)app_datalog_append(APP_DATALOG_SAMPLE, app_history_newest_epoch(), payload, sizeof(payload));
+    }
+    dl_history_seq = seq;
+}
+
+typedef char datalog_sample_check[(HISTORY_SERIES_COUNT == 2) ? 1 : -1]; ///< 样本负载按两个温度序列排列
+
+#endif /* W25Q_ENABLE */
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 初始化长期数据记录
+ * @details 有标识且序号与环中位置相符的扇区为有效扇区，序号最小的为最旧，最大的为当前扇区。
+ *          没有有效扇区时从序号0 (第0个扇区) 开始，第一条记录追加前先擦除它。
+ * @return 无
+ */
+void app_datalog_init(void)
+{
+#if W25Q_ENABLE
+    uint16_t sectors;
+    uint32_t oldest = 0;
+    uint32_t head = 0;
+    bool found = false;
+
+    memset(dl_page, 0xFF, sizeof(dl_page));
+    if (!W25Q_Init() || W25Q_Sector_Count() < APP_ASSET_SECTORS + 3U) {
+        return;
+    }
+    sectors = (uint16_t)(W25Q_Sector_Count() - APP_ASSET_SECTORS); // 末尾的扇区为资源区 (app_asset)
+    for (uint16_t i = 0; i < sectors; i++) {
+        uint8_t h[DATALOG_INDEX_EPOCH];
+        uint32_t seq;
+
+        if (W25Q_Read((uint32_t)i * W25Q_SECTOR_SIZE, h, sizeof(h)) != HAL_OK) {
+            return;
+        }
+        seq = get_u32(&h[4]);
+        if (get_u32(h) != APP_DATALOG_MAGIC || seq % sectors != i) {
+            continue;
+        }
+        if (!found || seq > head) {
+            head = seq;
+        }
+        if (!found || seq < oldest) {
+            oldest = seq;
+        }
+        found = true;
+    }
+
+    dl_sectors = sectors;
+    dl_oldest = oldest;
+    dl_next = found ? head + 1U : 0;
+    dl_next_erased = false; // 下一个扇区可能已部分写入 (打开后、写入标识前断电)，总是重新擦除
+    if (found && !datalog_locate(head)) {
+        dl_sectors = 0;
+    }
+#endif
+}
+
+/**
+ * @brief 长期数据记录维护函数
+ * @details 有待写的索引项或页缓冲区中的数据到期时编程，否则在闪存空闲时擦除下一个扇区。
+ *          擦除的扇区中原有的是序号小 dl_sectors 的旧扇区，最早的有效扇区随之后移。
+ * @return 无
+ */
+void app_datalog_service(void)
+{
+#if W25Q_ENABLE
+    if (dl_sectors == 0) {
+        return;
+    }
+    datalog_log_sample();
+
+    if (dl_index_len != 0 || (dl_flushed != dl_fill && HAL_GetTick() - dl_dirty_ms >= APP_DATALOG_FLUSH_MS)) {
+        datalog_pump();
+    } else if (!dl_next_erased && !W25Q_Is_Busy()) {
+        if (W25Q_Erase_Sector(datalog_addr(dl_next * W25Q_SECTOR_SIZE)) == HAL_OK) {
+            dl_next_erased = true;
+            dl_erasing = true;
+            if (dl_next - dl_oldest >= dl_sectors) {
+                dl_oldest = dl_next - dl_sectors + 1U;
+            }
+        }
+    }
+#endif
+}
+
+/**
+ * @brief 追加一条记录
+ * @param[in] type 记录类型
+ * @param[in] epoch 纪元秒
+ * @param[in] data 负载
+ * @param[in] len 负载长度
+ * @return bool 已追加返回 true
+ */
+bool app_datalog_append(uint8_t type, uint32_t epoch, const void *data, uint8_t len)
+{
+#if W25Q_ENABLE
+    uint8_t *rec;
+
+    if (dl_sectors == 0 || type == APP_DATALOG_END || len > APP_DATALOG_PAYLOAD_MAX) {
+        return false;
+    }
+    if (!dl_open || dl_fill + APP_DATALOG_HEADER_SIZE + len > W25Q_PAGE_SIZE) {
+        if (!datalog_advance()) {
+            return false;
+        }
+    }
+    if (!dl_indexed) {
+        uint32_t base = datalog_addr(POS_SEQ(dl_head) * W25Q_SECTOR_SIZE);
+        uint8_t page = (uint8_t)POS_PAGE(dl_head);
+
+        if (page == 1) {
+            put_u32(&dl_index[0], APP_DATALOG_MAGIC);
+            put_u32(&dl_index[4], POS_SEQ(dl_head));
+            put_u32(&dl_index[8], epoch);
+            dl_index_len = 12;
+            dl_index_addr = base;
+        } else {
+            put_u32(&dl_index[0], epoch);
+            dl_index_len = 4;
+            dl_index_addr = base + DATALOG_INDEX_EPOCH + 4U * (page - 1U);
+        }
+        dl_indexed = true;
+    }
+    if (dl_flushed == dl_fill) {
+        dl_dirty_ms = HAL_GetTick();
+    }
+    rec = &dl_page[dl_fill];
+    rec[0] = type;
+    rec[1] = len;
+    put_u32(&rec[2], epoch);
+    memcpy(&rec[APP_DATALOG_HEADER_SIZE], data, len);
+    dl_fill += APP_DATALOG_HEADER_SIZE + len;
+    return true;
+#else
+    (void)type;
+    (void)epoch;
+    (void)data;
+    (void)len;
+    return false;
+#endif
+}
+
+/**
+ * @brief 查询是否有闪存传输正在进行
+ * @return bool 正在传输返回 true
+ */
+bool app_datalog_busy(void)
+{
+    return W25Q_Is_Transferring();
+}
+
+/**
+ * @brief 查询是否可用
+ * @return bool 可用返回 true
+ */
+bool app_datalog_ready(void)
+{
+#if W25Q_ENABLE
+    return dl_sectors != 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 获取记录的范围
+ * @param[out] oldest 最早的位置
+ * @param[out] end 末尾位置
+ * @return 无
+ */
+void app_datalog_range(uint32_t *oldest, uint32_t *end)
+{
+#if W25Q_ENABLE
+    *oldest = dl_oldest * W25Q_SECTOR_SIZE + W25Q_PAGE_SIZE;
+    *end = dl_open ? dl_head + dl_fill : *oldest;
+#else
+    *oldest = 0;
+    *end = 0;
+#endif
+}
+
+/**
+ * @brief 按时间查找
+ * @details 二分查找最后一个首条纪元秒不晚于 epoch 的扇区 (尚未写入标识的当前扇区读到 0xFFFFFFFF，视为更晚)，
+ *          在它的索引块中找到最后一个不晚于 epoch 的页，再从该页逐条向后比较。
+ * @param[in] epoch 纪元秒
+ * @param[out] pos 位置
+ * @return bool 成功返回 true
+ */
+bool app_datalog_find(uint32_t epoch, uint32_t *pos)
+{
+#if W25Q_ENABLE
+    uint8_t index[DATALOG_INDEX_SIZE - DATALOG_INDEX_EPOCH];
+    uint8_t hdr[APP_DATALOG_HEADER_SIZE];
+    uint32_t oldest, end, lo, hi, p;
+    uint8_t page = 1;
+
+    if (dl_sectors == 0) {
+        return false;
+    }
+    app_datalog_range(&oldest, &end);
+    *pos = oldest;
+    if (oldest == end) {
+        return true;
+    }
+
+    lo = dl_oldest;
+    hi = POS_SEQ(dl_head);
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo + 1U) / 2U;
+
+        if (!datalog_load(mid * W25Q_SECTOR_SIZE + DATALOG_INDEX_EPOCH, index, 4)) {
+            return false;
+        }
+        if (get_u32(index) <= epoch) {
+            lo = mid;
+        } else {
+            hi = mid - 1U;
+        }
+    }
+    if (!datalog_load(lo * W25Q_SECTOR_SIZE + DATALOG_INDEX_EPOCH, index, sizeof(index))) {
+        return false;
+    }
+    for (uint8_t i = 2; i < APP_DATALOG_PAGES; i++) {
+        uint32_t v = get_u32(&index[4U * (i - 1U)]);
+
+        if (v != DATALOG_NONE && v <= epoch) {
+            page = i;
+        }
+    }
+
+    p = lo * W25Q_SECTOR_SIZE + page * W25Q_PAGE_SIZE;
+    for (;;) {
+        int8_t r = datalog_peek(&p, hdr, end);
+
+        if (r < 0) {
+            return false;
+        }
+        if (r == 0 || get_u32(&hdr[2]) >= epoch) {
+            break;
+        }
+        p += APP_DATALOG_HEADER_SIZE + hdr[1];
+    }
+    *pos = p;
+    return true;
+#else
+    (void)epoch;
+    *pos = 0;
+    return false;
+#endif
+}
+
+/**
+ * @brief 按顺序读出完整的记录
+ * @param[in,out] pos 起始位置
+ * @param[out] buf 输出缓冲区
+ * @param[in] max 缓冲区的长度
+ * @return int16_t 写入的字节数，失败返回 -1
+ */
+int16_t app_datalog_read(uint32_t *pos, uint8_t *buf, uint16_t max)
+{
+#if W25Q_ENABLE
+    uint8_t hdr[APP_DATALOG_HEADER_SIZE];
+    uint32_t oldest, end, p;
+    uint16_t n = 0;
+
+    if (dl_sectors == 0) {
+        return -1;
+    }
+    app_datalog_range(&oldest, &end);
+    p = *pos;
+    if (p < oldest) {
+        p = oldest; // 更早的扇区已被覆盖
+    } else if (p > end) {
+        p = end;
+    }
+
+    for (;;) {
+        int8_t r = datalog_peek(&p, hdr, end);
+        uint16_t len;
+
+        if (r <= 0) {
+            if (r < 0 && n == 0) {
+                return -1;
+            }
+            break;
+        }
+        len = APP_DATALOG_HEADER_SIZE + hdr[1];
+        if (n + len > max) {
+            break;
+        }
+        memcpy(&buf[n], hdr, APP_DATALOG_HEADER_SIZE);
+        if (hdr[1] != 0 && !datalog_load(p + APP_DATALOG_HEADER_SIZE, &buf[n + APP_DATALOG_HEADER_SIZE], hdr[1])) {
+            if (n == 0) {
+                return -1;
+            }
+            break;
+        }
+        n += len;
+        p += len;
+    }
+    *pos = p;
+    return (int16_t)n;
+#else
+    (void)pos;
+    (void)buf;
+    (void)max;
+    return -1;
+#endif
+}
+
+/** @} */
@@ -0,0 +1,131 @@
+/**
+ * @file      app_datalog.h
+ * @brief     外部闪存长期数据记录头文件
+ * @details   温度历史在 RAM 中只保留24小时，接上 SPI NOR 闪存 (W25Q_ENABLE) 后每个历史样本另外追加到闪存中，
+ *            2MB 的 W25Q16 按每5分钟一条可以保存十年以上。闪存最后的 APP_ASSET_SECTORS 个扇区留给资源区 (app_asset.h)，
+ *            其余的扇区作为环形日志。记录只追加、不修改，以 4KB 扇区为单位：
+ *            - 每个扇区的第0页为索引块：标识 (4) 扇区序号 (4)，之后第1~15页各一个首条记录的纪元秒 (4)。
+ *              序号每打开一个新扇区加一，扇区在环中的位置 = 序号 % 扇区数；索引项在该页写入第一条记录时编程
+ *              (NOR 只能把 1 改为 0，同一页中尚未编程的字节仍可写入)。
+ *            - 第1~15页存放记录：类型 (1) 负载长度 (1) 纪元秒 (4, 标准时间) 负载，多字节字段为小端。
+ *              记录不跨页，页中剩余的空间放不下下一条时留空 (0xFF)，读取时类型为 0xFF 即本页结束。
+ *            - 记录的位置 = 序号 * 4096 + 扇区内的偏移，环形覆盖后位置仍然递增，导出时以它作为游标。
+ *            写入先进入 RAM 中的一页缓冲区，页满 (下一条放不下) 或最早的未写入数据已等待 APP_DATALOG_FLUSH_MS 时
+ *            把新增的部分编程到闪存 (一次页编程，DMA 发送约0.12ms，芯片编程约0.7ms，期间不占用 CPU)。
+ *            当前扇区打开后立即在空闲时擦除下一个扇区 (最长约400ms，由芯片自行完成)，环形写满时这一步丢弃最旧的扇区，
+ *            写到扇区末尾时下一个扇区总是已经擦除。
+ *            启动时读出各扇区的前8字节 (2MB 时512次，约5ms) 找到序号最大的扇区，再从它的索引块找到最后一页，
+ *            读入页缓冲区并逐条跳过记录，在第一个空闲位置继续追加。
+ *            按时间查询：在扇区的序号范围内按首条记录的纪元秒二分查找 (读 log2(扇区数) 个索引块的一个字)，
+ *            再从该扇区的索引块找到页，最后在一页之内逐条比较。时间被往回调整后纪元秒不再单调，查询只能找到其中一段。
+ *            W25Q_ENABLE 为 0 或没有检测到闪存时所有函数为空操作，查询返回无数据。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_DATALOG_H
+#define __APP_DATALOG_H
+
+#include "main.h"
+#include "w25q.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppDatalog 长期数据记录
+ * @brief 外部 SPI NOR 闪存上的只追加环形日志。
+ * @{
+ */
+
+/**
+ * @defgroup AppDatalog_Config 长期数据记录配置
+ * @{
+ */
+#define APP_DATALOG_MAGIC       0x474F4C44U ///< 索引块的标识 ("DLOG")
+#define APP_DATALOG_FLUSH_MS    60000U      ///< 未写入的数据最多在 RAM 中停留的时间 (断电时丢失的最多是这一段)
+#define APP_DATALOG_SETTLE_MS   5U          ///< 需要换页或读取时等待上一次页编程结束的最长时间
+#define APP_DATALOG_HEADER_SIZE 6U          ///< 记录头的长度 (类型、负载长度、纪元秒)
+#define APP_DATALOG_PAYLOAD_MAX (W25Q_PAGE_SIZE - APP_DATALOG_HEADER_SIZE) ///< 一条记录负载的最大长度
+#define APP_DATALOG_PAGES       (W25Q_SECTOR_SIZE / W25Q_PAGE_SIZE) ///< 每个扇区的页数 (含索引块)
+/** @} */
+
+/**
+ * @brief 记录类型
+ */
+typedef enum {
+    APP_DATALOG_SAMPLE = 0x01, ///< 温度历史的样本：AHT20 温度 DS3231 温度 (各2，0.1°C，无结果为 INT16_MIN) 气压 (2，0.1hPa，0 为无结果)
+    APP_DATALOG_END    = 0xFF  ///< 已擦除，页中记录的结尾 (不能作为类型写入)
+} App_Datalog_Type_e;
+
+/**
+ * @brief 初始化长期数据记录
+ * @details 初始化闪存，检测到后扫描各扇区找到写入位置 (阻塞约5ms)。须在 HAL 和时钟初始化之后、app_asset_init() 之前调用。
+ * @return 无
+ */
+void app_datalog_init(void);
+
+/**
+ * @brief 长期数据记录维护函数，在存储任务中调用
+ * @details 温度历史记录了新样本时追加一条 APP_DATALOG_SAMPLE (启动后第一次看到的样本可能是检查点恢复的，不记录)；
+ *          到期时编程页缓冲区中的新数据，闪存空闲时擦除下一个扇区。
+ * @return 无
+ */
+void app_datalog_service(void);
+
+/**
+ * @brief 追加一条记录
+ * @details 记录先写入页缓冲区。当前页放不下时先把这一页写完 (最多等待 APP_DATALOG_SETTLE_MS) 再换到下一页；
+ *          闪存正在擦除 (换页时) 或下一个扇区尚未擦除完 (换扇区时) 时丢弃这条记录。
+ * @param[in] type 记录类型，不能为 APP_DATALOG_END
+ * @param[in] epoch 纪元秒 (标准时间)
+ * @param[in] data 负载
+ * @param[in] len 负载长度，不超过 APP_DATALOG_PAYLOAD_MAX
+ * @return bool 已追加返回 true
+ */
+bool app_datalog_append(uint8_t type, uint32_t epoch, const void *data, uint8_t len);
+
+/**
+ * @brief 查询是否有闪存传输正在进行
+ * @details 传输期间不能进入停止模式 (DMA 随时钟停止)，最长约0.12ms。编程和擦除由芯片自行完成，不影响停止模式。
+ * @return bool 正在传输返回 true
+ */
+bool app_datalog_busy(void);
+
+/**
+ * @brief 查询是否可用
+ * @return bool 检测到闪存并已找到写入位置返回 true
+ */
+bool app_datalog_ready(void);
+
+/**
+ * @brief 获取记录的范围
+ * @param[out] oldest 最早一条记录的位置 (不早于它的第一条)
+ * @param[out] end 最新一条记录之后的位置，等于 oldest 时没有记录
+ * @return 无
+ */
+void app_datalog_range(uint32_t *oldest, uint32_t *end);
+
+/**
+ * @brief 按时间查找
+ * @param[in] epoch 纪元秒 (标准时间)
+ * @param[out] pos 第一条不早于 epoch 的记录的位置 (都早于它时为末尾位置，都晚于它时为最早的位置)
+ * @return bool 查找成功返回 true；不可用或闪存正在擦除时返回 false
+ */
+bool app_datalog_find(uint32_t epoch, uint32_t *pos);
+
+/**
+ * @brief 按顺序读出完整的记录
+ * @details 记录按原样 (记录头 + 负载) 依次写入 buf，放不下的记录留到下一次。
+ *          位置早于最早的记录时从最早的记录开始，页中尚未写入闪存的记录从页缓冲区读出。
+ * @param[in,out] pos 起始位置，返回时为下一条记录的位置
+ * @param[out] buf 输出缓冲区
+ * @param[in] max 缓冲区的长度
+ * @return int16_t 写入的字节数 (0 为没有更多记录)；不可用或闪存正在擦除时返回 -1
+ */
+int16_t app_datalog_read(uint32_t *pos, uint8_t *buf, uint16_t max);
+
+/** @} */
+
+#endif /* __APP_DATALOG_H */
@@ -11,9 +11,16 @@
 
 #include "app_display.h"
 #include "u8g2_stm32_hal.h"
+#include "fb_dma.h"
+#include "app_anim.h"
+#include "app_i18n.h"
+#include "app_perf.h"
 #include <string.h>
 #include <stdbool.h>
 #include "input.h"
+#include "profiler.h"
+#include "trace.h"
+#include "mark.h"
 
 /**
  * @defgroup PageManager 页面管理器
@@ -21,7 +28,24 @@
  */
 
 /* Private defines -----------------------------------------------------------*/
-#define PAGE_HISTORY_MAX_DEPTH 8 ///< 页面历史堆栈的最大深度
+#define PAGE_HISTORY_MAX_DEPTH 8 ///< 页面历史堆栈的最大深度 (每层1字节)
+#define PAGE_DATA_SLOTS 2        ///< 页面私有数据区的槽位数 (当前页面和切换动画中的另一个页面)
+#define SCREEN_WIDTH  128        ///< 屏幕宽度
+#define SCREEN_HEIGHT 64         ///< 屏幕高度
+#define STR_WIDTH_CACHE_SIZE 16  ///< 字符串宽度缓存的条目数 (须为2的幂)
+#define PAGE_ANIM_DURATION_MS 250 ///< 切换动画的时长 (再按性能配置的比例缩放)
+#define PAGE_FRAME_MIN_MS 16     ///< 帧周期的下限 (帧率上限约60FPS)
+#define PAGE_FRAME_QUANTUM_MS 4  ///< 帧周期按此粒度向上取整，刷新时间的小幅波动不会使周期来回跳动
+#define PAGE_LOGIC_STEP_MS 5     ///< 页面 loop 的固定调用周期，与重绘无关
+#define PAGE_TRANS_HW_SCROLL 1   ///< 整帧模式下上下滑动的切换动画用显示起始行 (硬件滚动) 实现，0 为按软件平移整帧
+#define PAGE_OVERLAY_DEPTH 2     ///< 同时存在的提示框数
+#define PAGE_TOAST_LINES 2       ///< 提示框的最大行数
+#define PAGE_TOAST_LINE_MAX 40   ///< 多行提示框中一行的最大字节数 (含结尾的0)
+#define PAGE_NAV_QUEUE_DEPTH 4   ///< 切换动画期间可以排队的导航请求数
+#define PAGE_BUILD_BUDGET_US 4000 ///< 分帧绘制时每次主循环用于绘制的时间预算 (DWT 计时)
+#define PAGE_QUALITY_GAP_MS 100   ///< 与上一帧相隔不超过该值的帧才算连续运动，计入画质调节
+#define PAGE_QUALITY_DOWN_FRAMES 4 ///< 帧耗时连续超出预算这么多帧后降一级
+#define PAGE_QUALITY_UP_FRAMES 60  ///< 帧耗时连续低于上一级预算的 3/4 这么多帧后升一级
 
 /* Private types -------------------------------------------------------------*/
 /**
@@ -32,62 +56,1907 @@ typedef enum {
     MANAGER_STATE_ANIMATING ///< 动画状态，以最快速度工作以保证动画流畅
 } Manager_State_e;
 
+/**
+ * @brief 分帧绘制的状态 (Page_Build_Begin)
+ */
+typedef enum {
+    PAGE_BUILD_NONE = 0,  ///< 不在分帧绘制
+    PAGE_BUILD_REQUESTED, ///< 页面的下一次整屏重绘分多次完成
+    PAGE_BUILD_RUNNING    ///< 正在分帧绘制，缓冲区中的画面尚未完成，不发送
+} Page_Build_e;
+
+/**
+ * @brief 切换动画期间排队的一个导航请求
+ */
+typedef struct {
+    const Page_Base* page;        ///< 目标页面，NULL 表示返回上一页 (执行时再从历史堆栈中取出)
+    bool record_history;          ///< 是否把当前页面记录到历史堆栈中
+    Page_Transition_e transition; ///< 切换动画效果
+} Nav_Cmd_t;
+
+/**
+ * @brief 字符串宽度缓存的一个条目
+ * @details 以 (字体, 内容哈希, 长度) 为键，与字符串存放在哪里无关，
+ *          因此每帧重新格式化到栈上缓冲区的字符串只要内容不变也能命中。
+ */
+typedef struct {
+    const uint8_t* font; ///< 字体，NULL 表示空条目
+    uint32_t hash;       ///< 字符串内容的 FNV-1a 哈希
+    uint8_t len;         ///< 字符串长度
+    u8g2_uint_t width;   ///< u8g2_GetStrWidth 的结果
+} Str_Width_Entry_t;
+
+/**
+ * @brief 页面注册表中的一项 (位于Flash)
+ */
+typedef struct {
+    const Page_Base* page;    ///< 页面实例
+    uint8_t parent;           ///< 父页面ID，PAGE_ID_NONE 表示顶层页面
+    uint16_t refresh_rate_ms; ///< 两次重绘之间的最小间隔 (毫秒)
+} Page_Info_t;
+
+/**
+ * @brief 切换动画一帧的几何参数
+ * @details 由 _Trans_Geometry() 按效果和进度计算，整帧模式和分页模式共用。
+ */
+typedef struct {
+    int16_t from_x;      ///< 旧页面的X偏移
+    int16_t from_y;      ///< 旧页面的Y偏移
+    int16_t to_x;        ///< 新页面的X偏移
+    int16_t to_y;        ///< 新页面的Y偏移
+    Page_Rect_t to_clip; ///< 新页面可见的区域，绘制新页面前先清空
+    uint8_t fade_level;  ///< 抖动淡入的级别 (0~16)，仅淡入效果使用
+} Trans_Frame_t;
+
+/**
+ * @brief 页面的运行状态 (位于RAM，每个页面7字节)
+ * @details 只有当前页面会按刷新间隔重绘，上次刷新时间由管理器统一保存一份，不按页面存放。
+ */
+typedef struct {
+    Page_Rect_t dirty_rect;     ///< 失效区域，为各次失效区域的并集
+    bool dirty;                 ///< 页面是否已失效，需要重绘
+    uint8_t resume;             ///< 页面记录的恢复状态 (Page_Resume_Set)
+    bool resume_pending;        ///< 页面堆栈恢复后尚未进入过，下一次进入时取回 resume
+    uint16_t refresh_ms;        ///< 页面运行时设置的重绘间隔 (Page_Set_Refresh)，0 表示按注册表
+} Page_State_t;
+
+/**
+ * @brief 提示框 (覆盖层) 栈中的一项
+ */
+typedef struct {
+    const char* text;       ///< 提示文字，行之间用 '\n' 分隔
+    uint32_t start;         ///< 开始显示的时间戳
+    uint32_t duration;      ///< 显示时长 (ms)
+    Page_Toast_Done_t done; ///< 关闭时调用，可为NULL
+    Page_Rect_t rect;       ///< 提示框占用的屏幕区域
+    uint8_t lines;          ///< 行数
+} Page_Overlay_t;
+
+/**
+ * @brief 页面私有数据区的一个槽位
+ */
+typedef union {
+    uint8_t bytes[PAGE_DATA_SIZE]; ///< 数据
+    uint32_t align_u32;            ///< 仅用于对齐
+    void* align_ptr;               ///< 仅用于对齐
+} Page_Data_Slot_t;
+
 /* Private variables ---------------------------------------------------------*/
 /**
- * @brief 页面管理器内部状态结构体
+ * @brief 页面注册表，由 PAGE_TABLE 生成，按页面ID索引
+ */
+static const Page_Info_t g_page_table[PAGE_COUNT] = {
+#define PAGE_X_INFO(id, name, parent, refresh_ms) \
+    [PAGE_ID_##id] = { &g_page_##name, PAGE_ID_##parent, refresh_ms },
+    PAGE_TABLE(PAGE_X_INFO)
+#undef PAGE_X_INFO
+};
+
+static Page_State_t g_page_state[PAGE_COUNT]; ///< 各页面的运行状态，按页面ID索引
+
+static Page_Data_Slot_t g_page_data[PAGE_DATA_SLOTS];  ///< 页面私有数据区
+static uint8_t g_page_data_owner[PAGE_DATA_SLOTS];     ///< 各槽位当前分配给的页面ID
+
+/**
+ * @brief 页面管理器内部状态结构体
+ */
+static struct {
+    u8g2_t* u8g2;                   ///< 指向u8g2实例的指针
+    const Page_Base* current_page;  ///< 指向当前活动页面的指针
+
+    Manager_State_e state;          ///< 管理器当前状态
+    const Page_Base* page_from;     ///< 动画的来源页面
+    const Page_Base* page_to;       ///< 动画的目标页面
+    uint32_t anim_start_time;       ///< 动画开始的时间戳
+    uint32_t anim_duration;         ///< 动画总时长
+    bool anim_first_frame;          ///< 动画的第一帧尚未绘制 (不受帧率限制)
+    Page_Transition_e transition;   ///< 当前切换动画的效果
+    
+    uint8_t history_stack[PAGE_HISTORY_MAX_DEPTH];    ///< 存储历史页面ID的数组
+    int8_t history_depth;                             ///< 当前堆栈深度 (或叫栈顶指针)
+
+    Nav_Cmd_t nav_queue[PAGE_NAV_QUEUE_DEPTH];        ///< 切换动画期间到来的导航请求，动画结束后依次执行
+    uint8_t nav_count;                                ///< 排队的导航请求数
+    Input_Event_Data_t held_event;                    ///< 动画期间取出但不是返回键的事件，动画结束后第一个交给页面
+    bool held_valid;                                  ///< held_event 有效
+
+    uint32_t frame_last;            ///< 上一帧所在的帧时刻 (按帧周期对齐，不一定是实际的绘制时间)
+    uint32_t logic_last;            ///< 上一次调用页面 loop 的逻辑时刻
+    uint32_t now;                   ///< 当前帧开始时的时间戳 (Page_Now)
+    bool in_frame;                  ///< 是否正在执行 Page_Manager_Loop
+    bool buffer_valid;              ///< 绘图缓冲区中是否为当前页面的完整画面 (局部重绘的前提)
+    bool ahead;                     ///< 缓冲区中是提前绘制的画面，到 ahead_due 才发送 (Page_Render_Ahead)
+    uint32_t ahead_due;             ///< 提前绘制的画面的发送时刻
+    uint8_t build;                  ///< 分帧绘制的状态 (Page_Build_e)
+    bool build_slice;               ///< 正在执行分帧绘制的一段 (Page_Build_Active)
+    bool build_done;                ///< 页面已报告画面完成 (Page_Build_Done)
+    uint32_t build_start;           ///< 这一段开始时的 DWT->CYCCNT
+    uint32_t build_limit;           ///< 这一段的时间预算 (CPU周期)
+    uint16_t frame_floor;           ///< 帧周期的附加下限 (ms)，低电量时限制帧率，0 表示不限制
+    bool drawn;                     ///< 这一次循环绘制了一帧 (计入画质调节)
+    uint8_t quality;                ///< 动画画质等级 (Page_Quality_e)
+    uint8_t quality_down;           ///< 连续超出预算的帧数
+    uint8_t quality_up;             ///< 连续低于上一级预算 3/4 的帧数
+    uint32_t quality_cost_x4;       ///< 连续运动中帧耗时 (us) 的滑动平均，放大4倍
+    uint32_t quality_last;          ///< 上一个计入的帧的时间戳
+    int16_t strip_y0;               ///< 当前正在绘制的条带上边界 (包含)
+    int16_t strip_y1;               ///< 当前正在绘制的条带下边界 (不包含)
+    uint32_t input_ts;              ///< 尚未画入任何一帧的输入中最早的时间戳
+    bool input_armed;               ///< input_ts 有效：有输入改变了画面，等待下一帧
+    uint32_t frame_input_ts;        ///< 绘图缓冲区中的画面所响应的输入时间戳，随该帧发送
+    bool frame_input_valid;         ///< frame_input_ts 有效
+
+} g_page_manager;
+
+static Str_Width_Entry_t g_str_width_cache[STR_WIDTH_CACHE_SIZE]; ///< 字符串宽度缓存 (直接映射)
+
+/**
+ * @brief 提示框栈，只显示栈顶的一项，各项按自己的时长关闭
+ * @details 提示框属于当前页面，页面切换时全部丢弃。整帧模式下提示框画在页面画面之上，
+ *          其下方的整页行先保存到 g_anim_snapshot (静止时不用于切换动画)，关闭或页面重绘前拷回，
+ *          页面不需要为提示框的出现和消失重绘，刷新也只发送这几页中变化的字节。
+ *          分页模式下没有整帧缓冲区，提示框在每个条带中页面绘制之后绘制，出现和消失时使其区域失效。
+ */
+static struct {
+    Page_Overlay_t stack[PAGE_OVERLAY_DEPTH]; ///< 提示框，下标越大越靠上
+    uint8_t count;                            ///< 提示框数
+#if U8G2_BUFFER_MODE == 0
+    bool changed;    ///< 栈顶已变化，需要重新合成到绘图缓冲区
+    bool composited; ///< 绘图缓冲区中已画有栈顶的提示框
+    uint8_t page0;   ///< 已保存的第一页 (8行)
+    uint8_t page1;   ///< 已保存的最后一页之后
+#endif
+} g_overlay;
+
+#if U8G2_PANEL_COUNT > 1
+/**
+ * @brief 登记的副显示器
+ */
+static struct {
+    u8g2_t* u8g2;            ///< 副显示器的 u8g2 实例，为 NULL 表示空位
+    Page_Panel_Draw_t draw;  ///< 绘制函数
+    uint32_t interval;       ///< 两次绘制的最小间隔 (ms)
+    uint32_t last;           ///< 上一次绘制的时刻
+} g_panels[U8G2_PANEL_COUNT - 1];
+#endif
+
+#if U8G2_BUFFER_MODE == 0
+/**
+ * @brief 切换动画来源页面的画面快照
+ * @details 切换开始时从绘图缓冲区拷贝一次，动画期间平移或抖动混合后拼入每一帧，
+ *          来源页面不再逐帧调用 loop/draw。分页模式下没有整帧缓冲区，来源页面仍逐帧绘制。
+ */
+static uint8_t g_anim_snapshot[U8G2_FRAME_BUF_SIZE];
+
+/**
+ * @brief 4x4 有序抖动 (Bayer) 阈值矩阵，淡入级别大于阈值的像素取新页面
+ */
+static const uint8_t g_bayer4[4][4] = {
+    { 0,  8,  2, 10},
+    {12,  4, 14,  6},
+    { 3, 11,  1,  9},
+    {15,  7, 13,  5},
+};
+#elif APP_DLIST_ACTIVE
+/**
+ * @brief 本帧已录制的页面 (下标0为当前页面或动画的来源页面，1为动画的目标页面)
+ * @details 为 NULL 时该页面没有录制 (或命令区不足)，仍逐条带执行 draw。
+ */
+static const Page_Base* g_dlist_page[2];
+static App_DList_Seg_t g_dlist_seg[2]; ///< 与 g_dlist_page 对应的命令段
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static void _Switch_Page_Internal(const Page_Base* new_page, bool record_history, Page_Transition_e transition);
+static void _Bind_Page_Data(const Page_Base* page, const Page_Base* keep);
+static const Page_Base* _Back_Target(bool pop);
+static bool _Nav_Reverse(Page_Transition_e transition);
+static void _Nav_Push(const Page_Base* page, bool record_history, Page_Transition_e transition);
+static void _Nav_Run_Queue(void);
+static void _Dispatch_Nav_Input(void);
+static void _Input_Arm(const Input_Event_Data_t* event);
+static void _Input_Note(const Page_Base* page, const Input_Event_Data_t* event);
+static void _Input_Latch(void);
+static void _Input_Submit(void);
+#if U8G2_BUFFER_MODE == 0
+static void _Render_Begin(void);
+static void _Render_End(void);
+static void _Render_Send(void);
+static void _Snapshot_Current(void);
+static void _Composite_Snapshot(int16_t dx, int16_t dy);
+static void _Mix_Snapshot(uint8_t level);
+static void _Splice_Snapshot(int16_t y0, int16_t y1);
+static bool _Render_Scroll(const Trans_Frame_t* f);
+#else
+static void _Render_Strips(int16_t y0, int16_t y1, const Page_Base* page, const Trans_Frame_t* f);
+#if APP_DLIST_ACTIVE
+static void _Record_Frame(int16_t y0, int16_t y1, const Page_Base* page, const Trans_Frame_t* f);
+static void _Record_Page(uint8_t slot, const Page_Base* page, int16_t x, int16_t y);
+#endif
+#endif
+static void _Draw_Page(const Page_Base* page, int16_t x, int16_t y);
+static void _Draw_Incoming(const Trans_Frame_t* f);
+static void _Trans_Geometry(Page_Transition_e transition, q16_t progress, Trans_Frame_t* f);
+static void _Render_Transition_Begin(const Trans_Frame_t* f);
+static void _Render_Transition(const Trans_Frame_t* f);
+static uint32_t _Frame_Interval(uint32_t min_interval);
+static bool _Frame_Due(uint32_t now, uint32_t min_interval);
+static bool _Anim_Frame_Due(uint32_t now);
+static bool _Logic_Step_Due(uint32_t now);
+static uint32_t _Quality_Budget_Us(uint8_t quality);
+static void _Quality_Set(uint8_t quality);
+static void _Quality_Sample(uint32_t now, uint32_t cycles);
+static void _Render_Page(const Page_Base* page);
+#if U8G2_BUFFER_MODE == 0
+static bool _Build_Slice(const Page_Base* page);
+#endif
+static void _Dispatch_Input(const Page_Base* page);
+static void _Page_Manager_Step(void);
+#if U8G2_PANEL_COUNT > 1
+static void _Panels_Step(uint32_t now);
+#endif
+static void _Xor_Span(uint8_t* p, uint8_t* end, uint8_t mask);
+static uint8_t _Tile_Byte(const uint8_t* tiles, int16_t w, int16_t pages, int16_t col, int32_t row);
+static const char* _Overlay_Line(const char* text, uint8_t n, char* buf);
+static void _Overlay_Layout(Page_Overlay_t* o);
+static void _Overlay_Draw(const Page_Overlay_t* o);
+static void _Overlay_Changed(const Page_Rect_t* r);
+static void _Overlay_Pop(uint8_t i);
+static void _Overlay_Tick(uint32_t now);
+static void _Overlay_Clear(void);
+#if U8G2_BUFFER_MODE == 0
+static void _Overlay_Remove(void);
+static void _Overlay_Apply(void);
+static void _Render_Overlay(void);
+#endif
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief  为即将进入的页面分配私有数据槽位
+ * @details 选择 keep 未占用的槽位并清零，与原先的静态 .bss 变量一样，页面首次看到的是全零数据。
+ *          页面上一次设置的重绘间隔随数据一起作废，恢复为注册表中的值。
+ * @param[in] page 即将进入的页面
+ * @param[in] keep 需要保留数据的页面 (切换动画中的来源页面)，可为NULL
+ * @return 无
+ */
+static void _Bind_Page_Data(const Page_Base* page, const Page_Base* keep) {
+    uint8_t slot = (keep && g_page_data_owner[0] == keep->id) ? 1 : 0;
+
+    // 另一个槽位如果恰好还登记着该页面 (上一次动画留下的)，解除登记
+    for (uint8_t i = 0; i < PAGE_DATA_SLOTS; i++) {
+        if (g_page_data_owner[i] == page->id) {
+            g_page_data_owner[i] = PAGE_ID_NONE;
+        }
+    }
+    memset(&g_page_data[slot], 0, sizeof(g_page_data[slot]));
+    g_page_data_owner[slot] = page->id;
+    g_page_state[page->id].refresh_ms = 0;
+}
+
+/**
+ * @brief  取得返回操作的目标页面
+ * @details 优先取历史堆栈的栈顶，堆栈为空时取注册表中的父页面。
+ *          切换动画期间以正在进入的页面为当前页面。
+ * @param[in] pop 为 true 时从历史堆栈中弹出栈顶
+ * @return const Page_Base* 目标页面，顶层页面上为 NULL
+ */
+static const Page_Base* _Back_Target(bool pop) {
+    const Page_Base* current = (g_page_manager.state == MANAGER_STATE_ANIMATING) ?
+                               g_page_manager.page_to : g_page_manager.current_page;
+
+    if (g_page_manager.history_depth > 0) {
+        uint8_t id = g_page_manager.history_stack[g_page_manager.history_depth - 1];
+        if (pop) {
+            g_page_manager.history_depth--;
+        }
+        return Page_Get(id);
+    }
+    return current ? Page_Get(g_page_table[current->id].parent) : NULL;
+}
+
+/**
+ * @brief  把进行中的切换动画就地反向，回到来源页面
+ * @details 从当前偏移处以相同速度退回：滑动换成相反方向，淡入淡出保持不变，
+ *          已播放的时长换算为反向动画的剩余时长，画面没有跳变。
+ *          正在进入的页面退出，来源页面重新进入 (与普通的切换一样拿到全零的私有数据)。
+ *          整帧模式下先把正在进入的页面完整绘制为快照，它成为退出的一方。
+ *          PUSH (旧页面不动) 没有对应的反向效果，另外请求无动画切换时也不反向，由调用者排队。
+ * @param[in] transition 请求的切换动画效果 (只用于判断是否为无动画切换)
+ * @return bool 已反向返回 true
+ */
+static bool _Nav_Reverse(Page_Transition_e transition) {
+    const Page_Base* back = g_page_manager.page_from;
+    const Page_Base* leaving = g_page_manager.page_to;
+    uint32_t now = HAL_GetTick();
+    uint32_t elapsed = now - g_page_manager.anim_start_time;
+    Page_Transition_e reverse;
+
+    switch (g_page_manager.transition) {
+    case PAGE_TRANS_SLIDE_LEFT:  reverse = PAGE_TRANS_SLIDE_RIGHT; break;
+    case PAGE_TRANS_SLIDE_RIGHT: reverse = PAGE_TRANS_SLIDE_LEFT;  break;
+    case PAGE_TRANS_SLIDE_UP:    reverse = PAGE_TRANS_SLIDE_DOWN;  break;
+    case PAGE_TRANS_SLIDE_DOWN:  reverse = PAGE_TRANS_SLIDE_UP;    break;
+    case PAGE_TRANS_FADE:        reverse = PAGE_TRANS_FADE;        break;
+    default:                     return false;
+    }
+    if (!back || !leaving || transition == PAGE_TRANS_NONE || elapsed >= g_page_manager.anim_duration) {
+        return false; // 动画即将结束时排队，结束后再正常切换
+    }
+
+#if U8G2_BUFFER_MODE == 0
+    _Render_Begin();
+    g_page_manager.strip_y0 = 0;
+    g_page_manager.strip_y1 = SCREEN_HEIGHT;
+    _Draw_Page(leaving, 0, 0);
+    Fb_Dma_Copy(g_anim_snapshot, u8g2_GetBufferPtr(g_page_manager.u8g2), sizeof(g_anim_snapshot));
+#endif
+
+    if (leaving->exit) {
+        leaving->exit(leaving);
+    }
+    Anim_Tween_Stop_All();
+    _Bind_Page_Data(back, leaving);
+    if (back->enter) {
+        back->enter(back);
+    }
+
+    g_page_manager.page_from = leaving;
+    g_page_manager.page_to = back;
+    g_page_manager.transition = reverse;
+    g_page_manager.anim_start_time = now - (g_page_manager.anim_duration - elapsed);
+    g_page_manager.anim_first_frame = true;
+    g_page_manager.logic_last = now - PAGE_LOGIC_STEP_MS;
+    g_page_manager.buffer_valid = false;
+    g_page_manager.build = PAGE_BUILD_NONE;
+    Fb_Dma_Wait(); // 快照的拷贝与 exit/enter 同时进行
+    return true;
+}
+
+/**
+ * @brief  把导航请求排入队列，切换动画结束后执行
+ * @details 队列已满时丢弃最早的请求，最后的请求 (通常决定了用户最终要去的页面) 总是保留。
+ * @param[in] page 目标页面，NULL 表示返回上一页
+ * @param[in] record_history 是否记录历史
+ * @param[in] transition 切换动画效果
+ * @return 无
+ */
+static void _Nav_Push(const Page_Base* page, bool record_history, Page_Transition_e transition) {
+    if (g_page_manager.nav_count >= PAGE_NAV_QUEUE_DEPTH) {
+        memmove(&g_page_manager.nav_queue[0], &g_page_manager.nav_queue[1],
+                (PAGE_NAV_QUEUE_DEPTH - 1) * sizeof(Nav_Cmd_t));
+        g_page_manager.nav_count--;
+    }
+    Nav_Cmd_t* cmd = &g_page_manager.nav_queue[g_page_manager.nav_count++];
+    cmd->page = page;
+    cmd->record_history = record_history;
+    cmd->transition = transition;
+}
+
+/**
+ * @brief  依次执行排队的导航请求，直到有一个启动了切换动画
+ * @details 在切换动画结束、当前页面已经是目标页面之后调用。新的动画从上一个动画结束的位置开始，
+ *          中间页面不单独画出静止的一帧。无动画的请求立即完成，继续执行下一个。
+ * @return 无
+ */
+static void _Nav_Run_Queue(void) {
+    while (g_page_manager.nav_count > 0 && g_page_manager.state == MANAGER_STATE_IDLE) {
+        Nav_Cmd_t cmd = g_page_manager.nav_queue[0];
+        g_page_manager.nav_count--;
+        memmove(&g_page_manager.nav_queue[0], &g_page_manager.nav_queue[1],
+                g_page_manager.nav_count * sizeof(Nav_Cmd_t));
+        if (cmd.page) {
+            _Switch_Page_Internal(cmd.page, cmd.record_history, cmd.transition);
+        } else {
+            _Switch_Page_Internal(_Back_Target(true), false, cmd.transition);
+        }
+    }
+}
+
+/**
+ * @brief  内部页面切换函数
+ * @details 处理页面切换的核心逻辑，包括调用退出/进入函数和启动切换动画。
+ *          切换动画期间到来的请求不丢弃：回到来源页面的请求就地反向 (_Nav_Reverse)，
+ *          其余的排队，动画结束后接着执行。
+ * @param[in] new_page 要切换到的新页面
+ * @param[in] record_history 是否将当前页面记录到历史堆栈中
+ * @param[in] transition 切换动画效果
+ * @return 无
+ */
+static void _Switch_Page_Internal(const Page_Base* new_page, bool record_history, Page_Transition_e transition) {
+    if (!new_page) {
+        return;
+    }
+    if (g_page_manager.state == MANAGER_STATE_ANIMATING) {
+        if (g_page_manager.nav_count == 0) {
+            if (new_page == g_page_manager.page_to) {
+                return; // 已经在去往该页面
+            }
+            if (new_page == g_page_manager.page_from && _Nav_Reverse(transition)) {
+                if (record_history && g_page_manager.history_depth < PAGE_HISTORY_MAX_DEPTH) {
+                    g_page_manager.history_stack[g_page_manager.history_depth++] = g_page_manager.page_from->id;
+                }
+                return;
+            }
+        }
+        _Nav_Push(new_page, record_history, transition);
+        return;
+    }
+    if (new_page == g_page_manager.current_page) {
+        return;
+    }
+
+    _Overlay_Clear(); // 须在快照之前，提示框下方保存的像素在快照缓冲区中
+
+    if (record_history) {
+        if (g_page_manager.current_page && g_page_manager.history_depth < PAGE_HISTORY_MAX_DEPTH) {
+            g_page_manager.history_stack[g_page_manager.history_depth] = g_page_manager.current_page->id;
+            g_page_manager.history_depth++;
+        }
+    }
+
+    if (Anim_Reduced()) {
+        transition = PAGE_TRANS_NONE; // 动画已关闭 (低电量或画质降到最低)，直接切换
+    } else if (transition == PAGE_TRANS_FADE && g_page_manager.quality >= PAGE_QUALITY_CUT) {
+        transition = PAGE_TRANS_NONE; // 逐像素混合的淡入代价最高，以直接切换代替
+    }
+
+#if U8G2_BUFFER_MODE == 0
+    if (g_page_manager.current_page && transition != PAGE_TRANS_NONE) {
+        _Snapshot_Current(); // 须在 exit 之前，缓冲区无效时还要让旧页面再绘制一次
+    }
+#else
+    if (transition == PAGE_TRANS_FADE) {
+        transition = PAGE_TRANS_NONE; // 分页模式下没有整帧快照可供混合
+    }
+#endif
+
+    if (g_page_manager.current_page && g_page_manager.current_page->exit) {
+        g_page_manager.current_page->exit(g_page_manager.current_page);
+    }
+
+    Anim_Tween_Stop_All(); // 旧页面的补间不再需要，新页面在 enter 中按需启动
+
+    _Bind_Page_Data(new_page, g_page_manager.current_page);
+    if (new_page->enter) {
+        new_page->enter(new_page);
+    }
+    Fb_Dma_Wait(); // 快照的拷贝与 exit/enter 同时进行
+
+    g_page_manager.buffer_valid = false;
+    g_page_manager.ahead = false;
+    g_page_manager.build = PAGE_BUILD_NONE; // 未完成的画面随页面一起作废
+
+    if (transition == PAGE_TRANS_NONE) {
+        // 立即切换，下一次循环按常规逻辑整屏重绘新页面
+        g_page_manager.current_page = new_page;
+        Page_Invalidate(new_page);
+        return;
+    }
+
+    g_page_manager.page_from = g_page_manager.current_page;
+    g_page_manager.page_to = new_page;
+    g_page_manager.transition = transition;
+    g_page_manager.anim_start_time = HAL_GetTick();
+    g_page_manager.anim_duration = Anim_Scaled((g_page_manager.quality >= PAGE_QUALITY_SHORT) ? PAGE_ANIM_DURATION_MS / 2
+                                                                                             : PAGE_ANIM_DURATION_MS);
+    g_page_manager.anim_first_frame = true;
+    g_page_manager.logic_last = g_page_manager.anim_start_time - PAGE_LOGIC_STEP_MS; // 新页面的 loop 立即运行一次
+    g_page_manager.state = MANAGER_STATE_ANIMATING;
+}
+
+#if U8G2_BUFFER_MODE == 0
+
+/**
+ * @brief  开始绘制一帧
+ * @details 由 DMA 清空u8g2绘图缓冲区，提交后立即返回，绘制前 (_Draw_Page 等) 再等待完成。
+ *          上一帧由独立的发送缓冲区异步刷新，因此无需等待 (U8G2_DIRTY_CRC 时直接发送绘图缓冲区，先等它发完)。
+ * @return 无
+ */
+static void _Render_Begin(void) {
+    u8g2_stm32_DrawBegin();
+    Fb_Dma_Fill(u8g2_GetBufferPtr(g_page_manager.u8g2), 0, U8G2_FRAME_BUF_SIZE);
+}
+
+/**
+ * @brief  结束绘制一帧
+ * @details 启动DMA异步刷新后立即返回，主循环可以继续处理输入和动画逻辑。
+ * @return 无
+ */
+static void _Render_End(void) {
+    Fb_Dma_Wait(); // 缓冲区中的拷贝 (提示框、快照拼接) 完成后才是完整的一帧
+    _Input_Latch();
+    if (g_page_manager.ahead) {
+        return; // 提前绘制的画面到 ahead_due 才发送
+    }
+    _Render_Send();
+}
+
+/**
+ * @brief  发送绘图缓冲区中已完成的一帧
+ * @details 画面所响应的输入时间戳随帧交给显示驱动。
+ * @return 无
+ */
+static void _Render_Send(void) {
+    _Input_Submit();
+    u8g2_stm32_SendBufferAsync(g_page_manager.u8g2);
+}
+
+/**
+ * @brief  把当前页面的画面保存为切换动画的快照
+ * @details 绘图缓冲区中通常就是当前页面的完整画面，直接拷贝；
+ *          缓冲区无效时 (如刚回到主页面尚未重绘) 先让当前页面完整绘制一遍，但不发送。
+ *          拷贝由 DMA 进行，调用者在页面的 exit/enter 之后等待完成。
+ * @return 无
+ */
+static void _Snapshot_Current(void) {
+    if (!g_page_manager.buffer_valid) {
+        _Render_Begin();
+        g_page_manager.strip_y0 = 0;
+        g_page_manager.strip_y1 = SCREEN_HEIGHT;
+        _Draw_Page(g_page_manager.current_page, 0, 0);
+    }
+    Fb_Dma_Copy(g_anim_snapshot, u8g2_GetBufferPtr(g_page_manager.u8g2), sizeof(g_anim_snapshot));
+}
+
+/**
+ * @brief  把快照平移 (dx, dy) 后写入绘图缓冲区
+ * @details 显存按页存放 (每页 128 列，每列一个字节、纵向8个像素)。
+ *          水平平移即逐页拷贝 (由 DMA 进行，提交后立即返回)；垂直平移时把一列的 8 个字节拼成 64 位整体移位。
+ *          移出屏幕的部分丢弃，空出的部分清零，因此不需要先清空缓冲区。
+ * @param[in] dx 向右平移的列数 (负数向左)
+ * @param[in] dy 向下平移的行数 (负数向上)
+ * @return 无
+ */
+static void _Composite_Snapshot(int16_t dx, int16_t dy) {
+    uint8_t* buf = u8g2_GetBufferPtr(g_page_manager.u8g2);
+
+    u8g2_stm32_DrawBegin();
+    if (dy == 0) {
+        Fb_Dma_Shift(buf, g_anim_snapshot, U8G2_FRAME_PAGES, U8G2_FRAME_PAGE_WIDTH, dx);
+        return;
+    }
+
+    for (int16_t x = 0; x < SCREEN_WIDTH; x++) {
+        int16_t sx = x - dx;
+        uint64_t col = 0;
+        if (sx >= 0 && sx < SCREEN_WIDTH && dy < SCREEN_HEIGHT && dy > -SCREEN_HEIGHT) {
+            for (uint8_t page = 0; page < U8G2_FRAME_PAGES; page++) {
+                col |= (uint64_t)g_anim_snapshot[page * U8G2_FRAME_PAGE_WIDTH + sx] << (page * 8);
+            }
+            col = (dy > 0) ? (col << dy) : (col >> -dy); // bit0 为最上一行
+        }
+        for (uint8_t page = 0; page < U8G2_FRAME_PAGES; page++) {
+            buf[page * U8G2_FRAME_PAGE_WIDTH + x] = (uint8_t)(col >> (page * 8));
+        }
+    }
+}
+
+/**
+ * @brief  按有序抖动把快照混合进绘图缓冲区 (淡入效果)
+ * @details 绘图缓冲区中已绘制好新页面。阈值矩阵每 4 行/列重复，一个显存字节覆盖 8 行，
+ *          因此只需按列号的低2位预先算出 4 个字节掩码，掩码为 1 的像素保留新页面，其余取快照。
+ * @param[in] level 淡入级别，0 为全部旧页面，16 为全部新页面
+ * @return 无
+ */
+static void _Mix_Snapshot(uint8_t level) {
+    uint8_t* buf = u8g2_GetBufferPtr(g_page_manager.u8g2);
+    uint8_t mask[4];
+
+    for (uint8_t xm = 0; xm < 4; xm++) {
+        mask[xm] = 0;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            if (g_bayer4[bit & 3][xm] < level) {
+                mask[xm] |= (uint8_t)(1U << bit);
+            }
+        }
+    }
+    for (uint16_t i = 0; i < U8G2_FRAME_BUF_SIZE; i++) {
+        uint8_t m = mask[i & 3]; // 每页 128 列是 4 的倍数，i 的低2位即列号的低2位
+        buf[i] = (uint8_t)((buf[i] & m) | (g_anim_snapshot[i] & (uint8_t)~m));
+    }
+}
+
+/**
+ * @brief  用快照替换绘图缓冲区的 y0~y1 行 (不平移)
+ * @param[in] y0 起始行 (包含)
+ * @param[in] y1 结束行 (不包含)
+ * @return 无
+ */
+static void _Splice_Snapshot(int16_t y0, int16_t y1) {
+    uint8_t* buf = u8g2_GetBufferPtr(g_page_manager.u8g2);
+
+    for (uint8_t page = 0; page < U8G2_FRAME_PAGES; page++) {
+        int16_t r0 = page * 8;
+        int16_t a = (y0 > r0) ? y0 - r0 : 0;
+        int16_t b = (y1 < r0 + 8) ? y1 - r0 : 8;
+        if (a >= b) {
+            continue;
+        }
+        uint8_t m = (uint8_t)((0xFFU << a) & (0xFFU >> (8 - b))); // 本页中属于快照的行
+        uint8_t* dst = buf + page * U8G2_FRAME_PAGE_WIDTH;
+        const uint8_t* src = g_anim_snapshot + page * U8G2_FRAME_PAGE_WIDTH;
+        if (m == 0xFF) {
+            Fb_Dma_Copy(dst, src, U8G2_FRAME_PAGE_WIDTH); // 其他页由 CPU 同时合并，互不重叠
+            continue;
+        }
+        for (uint8_t x = 0; x < U8G2_FRAME_PAGE_WIDTH; x++) {
+            dst[x] = (uint8_t)((dst[x] & (uint8_t)~m) | (src[x] & m));
+        }
+    }
+}
+
+/**
+ * @brief  用显示起始行绘制上下滑动的一帧
+ * @details 屏幕第 r 行显示显存第 (r + start) % 64 行。向上滑动 d 行时，令 start = d，
+ *          显存第 d 行及以下仍是旧页面 (显示在屏幕上部)，第 0~d-1 行换成新页面的同一行 (绕回显示在底部)；
+ *          向下滑动时 start = 64 - d，显存的后 d 行换成新页面。两个页面都不需要平移，
+ *          显存中每一帧只有新露出的几行与上一帧不同，脏区刷新只发送这几行所在的页。
+ *          动画结束时 d = 64，起始行回到 0，显存中正好是新页面。
+ *          绘图缓冲区已由 _Render_Transition_Begin() 清空。
+ * @param[in] f 切换动画的一帧
+ * @return bool 已绘制返回 true；不是上下滑动或没有来源页面时返回 false
+ */
+static bool _Render_Scroll(const Trans_Frame_t* f) {
+#if PAGE_TRANS_HW_SCROLL
+    int16_t d;
+
+    if (!g_page_manager.page_from) {
+        return false;
+    }
+    if (g_page_manager.transition == PAGE_TRANS_SLIDE_UP) {
+        d = -f->from_y;
+        _Draw_Page(g_page_manager.page_to, 0, 0);
+        _Splice_Snapshot(d, SCREEN_HEIGHT);
+        u8g2_stm32_SetStartLine((uint8_t)(d % SCREEN_HEIGHT));
+    } else if (g_page_manager.transition == PAGE_TRANS_SLIDE_DOWN) {
+        d = f->from_y;
+        _Draw_Page(g_page_manager.page_to, 0, 0);
+        _Splice_Snapshot(0, SCREEN_HEIGHT - d);
+        u8g2_stm32_SetStartLine((uint8_t)((SCREEN_HEIGHT - d) % SCREEN_HEIGHT));
+    } else {
+        return false;
+    }
+    _Render_End();
+    return true;
+#else
+    (void)f;
+    return false;
+#endif
+}
+
+#else
+
+/**
+ * @brief  逐条带绘制并发送一帧 (分页模式)
+ * @details 只处理与 y0~y1 行相交的条带。每个条带先清空绘图缓冲区，让页面完整地绘制一遍
+ *          (条带外的像素由 u8g2 丢弃，页面可用 Page_Strip_Visible() 提前跳过)，再阻塞发送。
+ *          条带内整行重绘，因此不需要裁剪窗口。切换动画时两个页面都按偏移实时绘制。
+ * @param[in] y0 需要重绘的上边界 (包含)
+ * @param[in] y1 需要重绘的下边界 (不包含)
+ * @param[in] page 要绘制的页面 (f 为 NULL 时使用)
+ * @param[in] f 切换动画的一帧，为NULL时只绘制 page
+ * @return 无
+ */
+static void _Render_Strips(int16_t y0, int16_t y1, const Page_Base* page, const Trans_Frame_t* f) {
+    uint8_t first = y0 / U8G2_STRIP_HEIGHT;
+    uint8_t last = (y1 - 1) / U8G2_STRIP_HEIGHT;
+
+    _Input_Latch(); // 条带边画边发，没有提前绘制
+    _Input_Submit();
+#if APP_DLIST_ACTIVE
+    if (last > first) {
+        _Record_Frame(first * U8G2_STRIP_HEIGHT, (last + 1) * U8G2_STRIP_HEIGHT, page, f);
+    }
+#endif
+    for (uint8_t strip = first; strip <= last; strip++) {
+        u8g2_SetBufferCurrTileRow(g_page_manager.u8g2, strip * U8G2_STRIP_PAGES);
+        u8g2_ClearBuffer(g_page_manager.u8g2);
+        g_page_manager.strip_y0 = strip * U8G2_STRIP_HEIGHT;
+        g_page_manager.strip_y1 = g_page_manager.strip_y0 + U8G2_STRIP_HEIGHT;
+        if (f) {
+            _Draw_Page(g_page_manager.page_from, f->from_x, f->from_y);
+            _Draw_Incoming(f);
+        } else {
+            _Draw_Page(page, 0, 0);
+            if (g_overlay.count > 0) {
+                _Overlay_Draw(&g_overlay.stack[g_overlay.count - 1]);
+            }
+        }
+        u8g2_stm32_SendStrip(g_page_manager.u8g2, strip == last);
+    }
+#if APP_DLIST_ACTIVE
+    g_dlist_page[0] = NULL;
+    g_dlist_page[1] = NULL;
+#endif
+}
+
+#if APP_DLIST_ACTIVE
+/**
+ * @brief  把一帧中要绘制的页面各执行一次 draw 并录制
+ * @details 录制时的条带取本帧要重绘的全部条带，页面的 Page_Strip_Visible() 只剔除其外的内容。
+ *          切换动画的目标页面与逐条带绘制时一样在其可见区域的裁剪窗口内录制。
+ * @param[in] y0 要重绘的第一个条带的上边界
+ * @param[in] y1 要重绘的最后一个条带的下边界
+ * @param[in] page 要绘制的页面 (f 为 NULL 时使用)
+ * @param[in] f 切换动画的一帧，为NULL时只录制 page
+ * @return 无
+ */
+static void _Record_Frame(int16_t y0, int16_t y1, const Page_Base* page, const Trans_Frame_t* f) {
+    app_dlist_reset();
+    g_page_manager.strip_y0 = y0;
+    g_page_manager.strip_y1 = y1;
+    if (f) {
+        const Page_Rect_t* r = &f->to_clip;
+        _Record_Page(0, g_page_manager.page_from, f->from_x, f->from_y);
+        if (r->x0 < r->x1 && r->y0 < r->y1) {
+            u8g2_SetClipWindow(g_page_manager.u8g2, r->x0, r->y0, r->x1, r->y1);
+            _Record_Page(1, g_page_manager.page_to, f->to_x, f->to_y);
+            u8g2_SetMaxClipWindow(g_page_manager.u8g2);
+        }
+    } else {
+        _Record_Page(0, page, 0, 0);
+    }
+}
+
+/**
+ * @brief  录制一个页面的 draw
+ * @param[in] slot 录制结果的下标
+ * @param[in] page 页面，可为NULL
+ * @param[in] x X偏移
+ * @param[in] y Y偏移
+ * @return 无
+ */
+static void _Record_Page(uint8_t slot, const Page_Base* page, int16_t x, int16_t y) {
+    g_dlist_page[slot] = NULL;
+    if (page && page->draw) {
+        app_dlist_record_begin();
+        _Draw_Page(page, x, y);
+        if (app_dlist_record_end(&g_dlist_seg[slot])) {
+            g_dlist_page[slot] = page;
+        }
+    }
+}
+#endif
+
+#endif /* U8G2_BUFFER_MODE == 0 */
+
+/**
+ * @brief  调用页面的 draw 回调
+ * @param[in] page 页面，可为NULL
+ * @param[in] x X偏移
+ * @param[in] y Y偏移
+ * @return 无
+ */
+static void _Draw_Page(const Page_Base* page, int16_t x, int16_t y) {
+    Fb_Dma_Wait(); // 清空、快照平移等提交给 DMA 的操作须在绘制之前完成
+    if (page && page->draw) {
+        PROF_BEGIN(PROF_SEC_DRAW);
+        MARK_BEGIN(DRAW);
+#if APP_DLIST_ACTIVE
+        // 本帧已录制的页面只回放与当前条带相交的命令
+        for (uint8_t i = 0; i < 2; i++) {
+            if (g_dlist_page[i] == page) {
+                app_dlist_replay(g_page_manager.u8g2, &g_dlist_seg[i],
+                                 g_page_manager.strip_y0, g_page_manager.strip_y1);
+                MARK_END(DRAW);
+                PROF_END(PROF_SEC_DRAW);
+                return;
+            }
+        }
+#endif
+        Page_Manager_DrawCallback(page);
+        page->draw(page, g_page_manager.u8g2, x, y);
+        MARK_END(DRAW);
+        PROF_END(PROF_SEC_DRAW);
+    }
+}
+
+/**
+ * @brief  在切换动画的一帧中绘制新页面
+ * @details 先清空新页面可见的区域 (覆盖式效果下旧页面仍在下面)，再在该区域的裁剪窗口内绘制。
+ * @param[in] f 切换动画的一帧
+ * @return 无
+ */
+static void _Draw_Incoming(const Trans_Frame_t* f) {
+    const Page_Rect_t* r = &f->to_clip;
+    if (r->x0 >= r->x1 || r->y0 >= r->y1) {
+        return;
+    }
+    Fb_Dma_Wait();
+    u8g2_SetDrawColor(g_page_manager.u8g2, 0);
+    u8g2_DrawBox(g_page_manager.u8g2, r->x0, r->y0, r->x1 - r->x0, r->y1 - r->y0);
+    u8g2_SetDrawColor(g_page_manager.u8g2, 1);
+    u8g2_SetClipWindow(g_page_manager.u8g2, r->x0, r->y0, r->x1, r->y1);
+    _Draw_Page(g_page_manager.page_to, f->to_x, f->to_y);
+    u8g2_SetMaxClipWindow(g_page_manager.u8g2);
+}
+
+/**
+ * @brief  计算切换动画一帧的几何参数
+ * @param[in] transition 切换动画效果
+ * @param[in] progress 动画进度 (Q16, 0 到 Q16_ONE)
+ * @param[out] f 计算结果
+ * @return 无
+ */
+static void _Trans_Geometry(Page_Transition_e transition, q16_t progress, Trans_Frame_t* f) {
+    int16_t sx = Anim_Lerp(0, SCREEN_WIDTH, progress);
+    int16_t sy = Anim_Lerp(0, SCREEN_HEIGHT, progress);
+
+    memset(f, 0, sizeof(*f));
+    f->to_clip.x1 = SCREEN_WIDTH;
+    f->to_clip.y1 = SCREEN_HEIGHT;
+
+    switch (transition) {
+    case PAGE_TRANS_SLIDE_LEFT:
+        f->from_x = -sx;
+        f->to_x = SCREEN_WIDTH - sx;
+        f->to_clip.x0 = (uint8_t)f->to_x;
+        break;
+    case PAGE_TRANS_SLIDE_RIGHT:
+        f->from_x = sx;
+        f->to_x = sx - SCREEN_WIDTH;
+        f->to_clip.x1 = (uint8_t)sx;
+        break;
+    case PAGE_TRANS_SLIDE_UP:
+        f->from_y = -sy;
+        f->to_y = SCREEN_HEIGHT - sy;
+        f->to_clip.y0 = (uint8_t)f->to_y;
+        break;
+    case PAGE_TRANS_SLIDE_DOWN:
+        f->from_y = sy;
+        f->to_y = sy - SCREEN_HEIGHT;
+        f->to_clip.y1 = (uint8_t)sy;
+        break;
+    case PAGE_TRANS_PUSH:
+        f->to_x = SCREEN_WIDTH - sx;
+        f->to_clip.x0 = (uint8_t)f->to_x;
+        break;
+    case PAGE_TRANS_FADE:
+    default:
+        f->fade_level = (uint8_t)(((uint32_t)progress * 17U) >> 16);
+        if (f->fade_level > 16) {
+            f->fade_level = 16;
+        }
+        break;
+    }
+}
+
+/**
+ * @brief  准备切换动画一帧的底图
+ * @details 整帧模式下清空绘图缓冲区，或把快照平移到绘图缓冲区 (左右滑动、覆盖)。
+ *          水平平移和清空由 DMA 进行，提交后立即返回，调用者可以在此期间运行新页面的 loop，
+ *          _Render_Transition() 在绘制前等待完成。分页模式下为空操作。
+ * @param[in] f 切换动画的一帧
+ * @return 无
+ */
+static void _Render_Transition_Begin(const Trans_Frame_t* f) {
+#if U8G2_BUFFER_MODE == 0
+    bool composite = g_page_manager.page_from && g_page_manager.transition != PAGE_TRANS_FADE;
+
+#if PAGE_TRANS_HW_SCROLL
+    if (g_page_manager.transition == PAGE_TRANS_SLIDE_UP || g_page_manager.transition == PAGE_TRANS_SLIDE_DOWN) {
+        composite = false; // 上下滑动改用显示起始行，快照在绘制新页面后拼入
+    }
+#endif
+    if (composite) {
+        _Composite_Snapshot(f->from_x, f->from_y);
+    } else {
+        _Render_Begin();
+    }
+#else
+    (void)f;
+#endif
+}
+
+/**
+ * @brief  绘制并发送切换动画的一帧
+ * @details 整帧模式下旧页面取自快照，只有新页面实时绘制，上下滑动改用显示起始行 (_Render_Scroll)，
+ *          底图须已由 _Render_Transition_Begin() 准备好；分页模式下两个页面都实时绘制。
+ * @param[in] f 切换动画的一帧
+ * @return 无
+ */
+static void _Render_Transition(const Trans_Frame_t* f) {
+    g_page_manager.strip_y0 = 0;
+    g_page_manager.strip_y1 = SCREEN_HEIGHT;
+#if U8G2_BUFFER_MODE == 0
+    u8g2_stm32_SetStartLine(0);
+    if (_Render_Scroll(f)) {
+        return;
+    }
+    if (g_page_manager.transition == PAGE_TRANS_FADE) {
+        _Draw_Page(g_page_manager.page_to, 0, 0);
+        if (g_page_manager.page_from) {
+            _Mix_Snapshot(f->fade_level);
+        }
+    } else {
+        _Draw_Incoming(f);
+    }
+    _Render_End();
+#else
+    _Render_Strips(0, SCREEN_HEIGHT, NULL, f);
+#endif
+}
+
+/**
+ * @brief  计算当前的帧周期
+ * @details 取实测刷新时间 (DWT 计时) 加 1/8 余量，按 PAGE_FRAME_QUANTUM_MS 向上取整，
+ *          不小于 PAGE_FRAME_MIN_MS (页面要求更短的间隔时以页面的为准)，也不小于调用者给出的最小间隔，
+ *          设置了 Page_Manager_Set_Frame_Floor() 或性能配置限制了帧周期时还不小于其中较大的下限。
+ *          画质降到 PAGE_QUALITY_SKIP 及以下时，要求逐帧重绘的页面和切换动画的帧周期加倍。
+ *          总线频率或画面内容改变后，滑动平均在几帧内收敛，帧周期随之调整。
+ * @param[in] min_interval 页面要求的最小重绘间隔 (ms)
+ * @return uint32_t 帧周期 (ms)
+ */
+static uint32_t _Frame_Interval(uint32_t min_interval) {
+    uint32_t us = u8g2_stm32_GetFrameTimeUs();
+    uint32_t period = (us + us / 8 + 999U) / 1000U;
+    uint32_t floor = (min_interval < PAGE_FRAME_MIN_MS) ? min_interval : PAGE_FRAME_MIN_MS;
+
+    period = (period + PAGE_FRAME_QUANTUM_MS - 1) / PAGE_FRAME_QUANTUM_MS * PAGE_FRAME_QUANTUM_MS;
+    if (period < floor) {
+        period = floor;
+    }
+    uint32_t limit = app_perf()->frame_floor_ms;
+    if (limit < g_page_manager.frame_floor) {
+        limit = g_page_manager.frame_floor;
+    }
+    if (period < limit) {
+        period = limit; // 页面要求的更短间隔 (灰度) 同样受限，灰度会因跟不上而自行回退
+    }
+    if (g_page_manager.quality >= PAGE_QUALITY_SKIP && min_interval <= PAGE_FRAME_MIN_MS) {
+        period *= 2; // 逐帧运动的页面和切换动画跳过中间帧，按需重绘的静态页面不受影响
+    }
+    return (period > min_interval) ? period : min_interval;
+}
+
+/**
+ * @brief  判断是否到了绘制下一帧的时刻
+ * @details 帧时刻按帧周期等间隔排列，不随每次循环的实际时间漂移。
+ *          整帧模式下帧时刻到达时上一帧尚未发完，则放弃这一帧等待下一个帧时刻，不积压总线送不完的画面；
+ *          落后超过一个周期 (页面长时间没有变化) 时不追赶，从当前时刻重新对齐。
+ *          所有动画的进度都按时间计算，跳过的帧只降低帧率，不会使动画变慢。
+ * @param[in] now 当前时间戳
+ * @param[in] min_interval 页面要求的最小重绘间隔 (ms)
+ * @return bool 本次循环应绘制一帧返回 true
+ */
+static bool _Frame_Due(uint32_t now, uint32_t min_interval) {
+    uint32_t period = _Frame_Interval(min_interval);
+
+    if (now - g_page_manager.frame_last < period) {
+        return false;
+    }
+    g_page_manager.frame_last += period;
+    if (now - g_page_manager.frame_last >= period) {
+        g_page_manager.frame_last = now;
+    }
+#if U8G2_BUFFER_MODE == 0
+    if (u8g2_stm32_IsFlushBusy()) {
+        PROF_COUNT(PROF_CNT_FRAME_SKIP);
+        return false;
+    }
+#endif
+    return true;
+}
+
+/**
+ * @brief  切换动画的帧率限制
+ * @details 第一帧立即绘制并作为帧时刻的起点，之后按 _Frame_Due() 的节拍绘制。
+ * @param[in] now 当前时间戳
+ * @return bool 本次循环应绘制一帧返回 true
+ */
+static bool _Anim_Frame_Due(uint32_t now) {
+    if (g_page_manager.anim_first_frame) {
+        g_page_manager.anim_first_frame = false;
+        g_page_manager.frame_last = now;
+        return true;
+    }
+    return _Frame_Due(now, 0);
+}
+
+/**
+ * @brief  判断是否到了调用页面 loop 的时刻
+ * @details loop 以 PAGE_LOGIC_STEP_MS 的固定周期运行，不受重绘快慢的影响。
+ *          各页面在 loop 中按读取到的时间推进状态，错过的步不补调。
+ * @param[in] now 当前时间戳
+ * @return bool 本次循环应调用 loop 返回 true
+ */
+static bool _Logic_Step_Due(uint32_t now) {
+    if (now - g_page_manager.logic_last < PAGE_LOGIC_STEP_MS) {
+        return false;
+    }
+    g_page_manager.logic_last += PAGE_LOGIC_STEP_MS;
+    if (now - g_page_manager.logic_last >= PAGE_LOGIC_STEP_MS) {
+        g_page_manager.logic_last = now;
+    }
+    return true;
+}
+
+/**
+ * @brief  一个画质等级的帧耗时预算
+ * @details 预算是该等级下运动的帧周期：PAGE_QUALITY_SKIP 及以下帧周期加倍，预算也加倍。
+ * @param[in] quality 画质等级
+ * @return uint32_t 预算 (us)
+ */
+static uint32_t _Quality_Budget_Us(uint8_t quality) {
+    uint32_t budget = PAGE_FRAME_MIN_MS * 1000U;
+
+    return (quality >= PAGE_QUALITY_SKIP) ? budget * 2 : budget;
+}
+
+/**
+ * @brief  切换画质等级
+ * @details 最低一级关闭补间 (Anim_Set_Reduced)，离开时恢复，与低电量模式的关闭互不影响。
+ * @param[in] quality 新的画质等级
+ * @return 无
+ */
+static void _Quality_Set(uint8_t quality) {
+    g_page_manager.quality = quality;
+    g_page_manager.quality_down = 0;
+    g_page_manager.quality_up = 0;
+    Anim_Set_Reduced(ANIM_REDUCED_LOAD, quality >= PAGE_QUALITY_OFF);
+}
+
+/**
+ * @brief  按一帧的实测耗时调节画质
+ * @details 帧耗时取这一次循环的 CPU 时间 (DWT 计时，包括页面 loop 和绘制) 与平均刷新时间中较大者：
+ *          整帧模式下刷新与下一帧的绘制并行，两者中较慢的一方决定帧率。
+ *          只统计连续运动中的帧，按需重绘的静态页面 (如每秒一次的局部重绘) 不代表动画的负载。
+ *          滑动平均超出当前等级的预算 PAGE_QUALITY_DOWN_FRAMES 帧后降一级，
+ *          低于上一级预算的 3/4 持续 PAGE_QUALITY_UP_FRAMES 帧后升一级；升降之间的差距避免在两级之间来回切换。
+ * @param[in] now 这一帧的时间戳
+ * @param[in] cycles 这一次循环的 CPU 周期数
+ * @return 无
+ */
+static void _Quality_Sample(uint32_t now, uint32_t cycles) {
+    uint32_t gap = now - g_page_manager.quality_last;
+    uint32_t us = cycles / (SystemCoreClock / 1000000U);
+    uint32_t flush = u8g2_stm32_GetFrameTimeUs();
+    uint32_t cost;
+    uint8_t q = g_page_manager.quality;
+
+    g_page_manager.quality_last = now;
+    if (gap > PAGE_QUALITY_GAP_MS) {
+        return; // 运动的第一帧 (包括快照等一次性开销) 不计入
+    }
+    if (us < flush) {
+        us = flush;
+    }
+    g_page_manager.quality_cost_x4 += us - g_page_manager.quality_cost_x4 / 4;
+    cost = g_page_manager.quality_cost_x4 / 4;
+
+    g_page_manager.quality_down = (cost > _Quality_Budget_Us(q)) ? (uint8_t)(g_page_manager.quality_down + 1) : 0;
+    g_page_manager.quality_up = (q > PAGE_QUALITY_FULL && cost < _Quality_Budget_Us((uint8_t)(q - 1)) * 3 / 4)
+                                    ? (uint8_t)(g_page_manager.quality_up + 1) : 0;
+    if (q < PAGE_QUALITY_OFF && g_page_manager.quality_down >= PAGE_QUALITY_DOWN_FRAMES) {
+        _Quality_Set((uint8_t)(q + 1));
+    } else if (g_page_manager.quality_up >= PAGE_QUALITY_UP_FRAMES) {
+        _Quality_Set((uint8_t)(q - 1));
+    }
+}
+
+/**
+ * @brief  重绘一个已失效的静止页面
+ * @details 绘图缓冲区中已有该页面的完整画面且失效区域不是全屏时，只清除失效区域，
+ *          并在裁剪窗口内重绘，区域外的像素保持上一帧的内容。
+ *          分页模式下只重绘与失效区域相交的条带。
+ * @param[in] page 要重绘的页面
+ * @return 无
+ */
+static void _Render_Page(const Page_Base* page) {
+    Page_State_t* st = &g_page_state[page->id];
+    Page_Rect_t r = st->dirty_rect;
+    bool full = !g_page_manager.buffer_valid ||
+                (r.x0 == 0 && r.y0 == 0 && r.x1 >= SCREEN_WIDTH && r.y1 >= SCREEN_HEIGHT);
+
+    st->dirty = false;
+
+#if U8G2_BUFFER_MODE == 0
+    u8g2_stm32_SetStartLine(0); // 切换动画可能留下了非零的起始行 (如动画被回到主页面打断)
+    _Overlay_Remove();          // 局部重绘须在页面原来的画面上进行
+    if (full) {
+        _Render_Begin();
+        g_page_manager.strip_y0 = 0;
+        g_page_manager.strip_y1 = SCREEN_HEIGHT;
+        if (g_page_manager.build == PAGE_BUILD_REQUESTED) {
+            g_page_manager.build = PAGE_BUILD_RUNNING;
+            g_page_manager.buffer_valid = false;
+            if (!_Build_Slice(page)) {
+                return; // 其余部分在之后的主循环中接着绘制 (_Page_Manager_Step)
+            }
+        } else {
+            _Draw_Page(page, 0, 0);
+        }
+    } else {
+        Fb_Dma_Wait(); // 提示框下方像素的恢复须先完成
+        u8g2_SetDrawColor(g_page_manager.u8g2, 0);
+        u8g2_DrawBox(g_page_manager.u8g2, r.x0, r.y0, r.x1 - r.x0, r.y1 - r.y0);
+        u8g2_SetDrawColor(g_page_manager.u8g2, 1);
+        u8g2_SetClipWindow(g_page_manager.u8g2, r.x0, r.y0, r.x1, r.y1);
+        g_page_manager.strip_y0 = r.y0;
+        g_page_manager.strip_y1 = r.y1;
+        _Draw_Page(page, 0, 0);
+        u8g2_SetMaxClipWindow(g_page_manager.u8g2);
+    }
+    _Overlay_Apply();
+    _Render_End();
+#else
+    if (full) {
+        r.y0 = 0;
+        r.y1 = SCREEN_HEIGHT;
+    }
+    _Render_Strips(r.y0, r.y1, page, NULL);
+#endif
+
+    g_page_manager.buffer_valid = true;
+}
+
+#if U8G2_BUFFER_MODE == 0
+/**
+ * @brief  执行分帧绘制的一段
+ * @details 在 PAGE_BUILD_BUDGET_US 的预算内调用页面的 draw，页面用 Page_Build_Yield() 判断何时停下。
+ *          页面报告完成后合成提示框并发送，否则缓冲区保持原样，下一次主循环接着绘制。
+ * @param[in] page 当前页面
+ * @return bool 画面已完成并发送返回 true
+ */
+static bool _Build_Slice(const Page_Base* page) {
+    g_page_manager.build_start = DWT->CYCCNT;
+    g_page_manager.build_limit = PAGE_BUILD_BUDGET_US * (SystemCoreClock / 1000000U);
+    g_page_manager.build_done = false;
+    g_page_manager.build_slice = true;
+    _Draw_Page(page, 0, 0);
+    g_page_manager.build_slice = false;
+    if (!g_page_manager.build_done) {
+        return false;
+    }
+    g_page_manager.build = PAGE_BUILD_NONE;
+    _Overlay_Apply();
+    _Render_End();
+    g_page_manager.buffer_valid = true;
+    return true;
+}
+#endif
+
+/**
+ * @brief  把队列中所有待处理的输入事件依次分发给页面
+ * @details 在 loop/draw 之前调用，一帧内处理完全部积压的输入，输入延迟不超过一帧。
+ *          某个事件触发了页面切换时立即停止，剩余事件留在队列中，
+ *          切换动画期间不消费输入 (返回键除外，见 _Dispatch_Nav_Input)，动画结束后再交给新页面。
+ *          返回键长按作为全局手势在此统一处理，不交给页面。
+ *          有提示框时事件不交给页面，返回键关闭栈顶的提示框 (与超时关闭相同，调用其回调)。
+ *          改变了画面的事件记下时间戳，随下一帧交给显示驱动统计输入延迟。
+ * @param[in] page 接收事件的页面
+ * @return 无
+ */
+static void _Dispatch_Input(const Page_Base* page) {
+    Input_Event_Data_t event;
+
+    // 上限防止中断持续产生事件时卡在这里
+    for (uint8_t n = 0; n < INPUT_FIFO_SIZE; n++) {
+        if (g_page_manager.state != MANAGER_STATE_IDLE || g_page_manager.current_page != page) {
+            return;
+        }
+        if (g_page_manager.held_valid) {
+            event = g_page_manager.held_event;
+            g_page_manager.held_valid = false;
+        } else if (!input_get_event(&event)) {
+            return;
+        }
+        if (event.event == INPUT_EVENT_LONG_PRESS && event.value == INPUT_EVENT_BACK_PRESSED) {
+            // 全局手势：长按返回键直接回到主页面
+            Page_Manager_Go_Home();
+        } else if (g_overlay.count > 0) {
+            // 提示框显示期间页面不接收输入，返回键提前关闭栈顶的提示框
+            if (event.event == INPUT_EVENT_BACK_PRESSED) {
+                _Overlay_Pop(g_overlay.count - 1);
+            }
+        } else if (page->action) {
+            page->action(page, g_page_manager.u8g2, &event);
+        }
+        _Input_Note(page, &event);
+    }
+}
+
+/**
+ * @brief  切换动画期间处理返回键
+ * @details 返回键单击作为导航请求立即交给 Go_Back_Page()：目标是来源页面时动画就地反向，
+ *          否则排队，不必等动画结束才开始响应。遇到其他事件时停止，
+ *          取出的那一个暂存在 held_event 中，动画结束后先于队列中的事件交给新页面。
+ * @return 无
+ */
+static void _Dispatch_Nav_Input(void) {
+    Input_Event_Data_t event;
+
+    for (uint8_t n = 0; n < INPUT_FIFO_SIZE && !g_page_manager.held_valid; n++) {
+        if (!input_get_event(&event)) {
+            return;
+        }
+        if (event.event != INPUT_EVENT_BACK_PRESSED) {
+            g_page_manager.held_event = event;
+            g_page_manager.held_valid = true;
+            return;
+        }
+        Go_Back_Page();
+        _Input_Arm(&event); // 动画逐帧绘制，下一帧即是响应
+    }
+}
+
+/**
+ * @brief  记下一个改变了画面的输入事件
+ * @details 只保留尚未画入任何一帧的事件中最早的一个，一帧的延迟从它算起。
+ * @param[in] event 输入事件
+ * @return 无
+ */
+static void _Input_Arm(const Input_Event_Data_t* event) {
+    if (!g_page_manager.input_armed) {
+        g_page_manager.input_ts = event->timestamp;
+        g_page_manager.input_armed = true;
+    }
+}
+
+/**
+ * @brief  处理完一个输入事件后判断它是否需要新的一帧
+ * @details 页面失效、提示框变化或开始了页面切换时，下一帧就是对该事件的响应；
+ *          页面忽略的事件 (画面不变) 不计入输入延迟。
+ * @param[in] page 接收事件的页面
+ * @param[in] event 输入事件
+ * @return 无
+ */
+static void _Input_Note(const Page_Base* page, const Input_Event_Data_t* event) {
+    bool changed = g_page_state[page->id].dirty ||
+                   g_page_manager.state != MANAGER_STATE_IDLE || g_page_manager.current_page != page;
+
+#if U8G2_BUFFER_MODE == 0
+    changed = changed || g_overlay.changed;
+#endif
+    if (changed) {
+        _Input_Arm(event);
+    }
+}
+
+/**
+ * @brief  一帧画面完成，把等待中的输入交给这一帧
+ * @return 无
+ */
+static void _Input_Latch(void) {
+    if (g_page_manager.input_armed && !g_page_manager.frame_input_valid) {
+        g_page_manager.frame_input_ts = g_page_manager.input_ts;
+        g_page_manager.frame_input_valid = true;
+    }
+    g_page_manager.input_armed = false;
+}
+
+/**
+ * @brief  发送一帧之前把它所响应的输入时间戳交给显示驱动
+ * @details 帧发送完成时驱动记录从输入到画面到达屏幕的延迟 (Profiler_Record_Input)。
+ * @return 无
+ */
+static void _Input_Submit(void) {
+    if (g_page_manager.frame_input_valid) {
+        g_page_manager.frame_input_valid = false;
+        u8g2_stm32_SetInputStamp(g_page_manager.frame_input_ts);
+    }
+}
+
+/**
+ * @brief  使整个页面失效，请求重绘
+ * @param[in] page 指向页面的指针
+ * @return 无
+ */
+void Page_Invalidate(const Page_Base* page) {
+    Page_Invalidate_Rect(page, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+
+/**
+ * @brief  使页面的一个矩形区域失效，请求局部重绘
+ * @details 区域会被裁剪到屏幕范围内，并与之前尚未重绘的失效区域合并。
+ * @param[in] page 指向页面的指针
+ * @param[in] x 区域左上角X坐标
+ * @param[in] y 区域左上角Y坐标
+ * @param[in] w 区域宽度
+ * @param[in] h 区域高度
+ * @return 无
+ */
+void Page_Invalidate_Rect(const Page_Base* page, int16_t x, int16_t y, int16_t w, int16_t h) {
+    if (!page || page->id >= PAGE_COUNT) return;
+
+    int16_t x0 = (x < 0) ? 0 : x;
+    int16_t y0 = (y < 0) ? 0 : y;
+    int16_t x1 = (x + w > SCREEN_WIDTH) ? SCREEN_WIDTH : x + w;
+    int16_t y1 = (y + h > SCREEN_HEIGHT) ? SCREEN_HEIGHT : y + h;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    Page_State_t* st = &g_page_state[page->id];
+    if (!st->dirty) {
+        st->dirty_rect.x0 = (uint8_t)x0;
+        st->dirty_rect.y0 = (uint8_t)y0;
+        st->dirty_rect.x1 = (uint8_t)x1;
+        st->dirty_rect.y1 = (uint8_t)y1;
+        st->dirty = true;
+    } else {
+        if (x0 < st->dirty_rect.x0) st->dirty_rect.x0 = (uint8_t)x0;
+        if (y0 < st->dirty_rect.y0) st->dirty_rect.y0 = (uint8_t)y0;
+        if (x1 > st->dirty_rect.x1) st->dirty_rect.x1 = (uint8_t)x1;
+        if (y1 > st->dirty_rect.y1) st->dirty_rect.y1 = (uint8_t)y1;
+    }
+}
+
+/**
+ * @brief  设置页面的重绘间隔
+ * @param[in] page 指向页面的指针
+ * @param[in] ms 两次重绘之间的最小间隔 (毫秒)，0 恢复为注册表中的值
+ * @return 无
+ */
+void Page_Set_Refresh(const Page_Base* page, uint16_t ms) {
+    if (!page || page->id >= PAGE_COUNT) return;
+
+    g_page_state[page->id].refresh_ms = ms;
+}
+
+/**
+ * @brief  提前绘制页面在某一时刻的画面，到时才发送
+ * @param[in] page 指向页面的指针 (须为当前页面)
+ * @param[in] due 画面应当出现的时刻
+ * @return bool 已安排提前绘制返回 true
+ */
+bool Page_Render_Ahead(const Page_Base* page, uint32_t due) {
+#if U8G2_BUFFER_MODE == 0
+    if (page && page == g_page_manager.current_page && g_page_manager.state == MANAGER_STATE_IDLE &&
+        (int32_t)(due - Page_Now()) > 0) {
+        g_page_manager.ahead = true;
+        g_page_manager.ahead_due = due;
+        return true;
+    }
+#else
+    (void)page;
+    (void)due;
+#endif
+    return false;
+}
+
+/**
+ * @brief  请求页面的下一次整屏重绘分多帧完成
+ * @param[in] page 指向页面的指针
+ * @return 无
+ */
+void Page_Build_Begin(const Page_Base* page) {
+    if (!page || page->id >= PAGE_COUNT) return;
+
+#if U8G2_BUFFER_MODE == 0
+    if (page == g_page_manager.current_page) {
+        g_page_manager.build = PAGE_BUILD_REQUESTED; // 正在绘制的画面从头开始
+    }
+#endif
+    Page_Invalidate(page);
+}
+
+/**
+ * @brief  查询本次 draw 是否为分帧绘制的一段
+ * @return bool 是返回 true
+ */
+bool Page_Build_Active(void) {
+    return g_page_manager.build_slice;
+}
+
+/**
+ * @brief  查询分帧绘制的这一段是否已用完时间预算
+ * @return bool 应当停下返回 true
+ */
+bool Page_Build_Yield(void) {
+    return g_page_manager.build_slice && DWT->CYCCNT - g_page_manager.build_start >= g_page_manager.build_limit;
+}
+
+/**
+ * @brief  报告分帧绘制的画面已经完成
+ * @param[in] page 指向页面的指针
+ * @return 无
+ */
+void Page_Build_Done(const Page_Base* page) {
+    if (g_page_manager.build_slice && page == g_page_manager.current_page) {
+        g_page_manager.build_done = true;
+    }
+}
+
+/**
+ * @brief  获取当前正在绘制的条带
+ * @param[out] y0 条带上边界 (包含)
+ * @param[out] y1 条带下边界 (不包含)
+ * @return 无
+ */
+void Page_Get_Strip(int16_t* y0, int16_t* y1) {
+    *y0 = g_page_manager.strip_y0;
+    *y1 = g_page_manager.strip_y1;
+}
+
+/**
+ * @brief  临时改变当前的条带
+ * @param[in] y0 条带上边界 (包含)
+ * @param[in] y1 条带下边界 (不包含)
+ * @return 无
+ */
+void Page_Set_Strip(int16_t y0, int16_t y1) {
+    g_page_manager.strip_y0 = y0;
+    g_page_manager.strip_y1 = y1;
+}
+
+/**
+ * @brief  判断一段像素行是否与当前条带相交
+ * @param[in] y 上边界
+ * @param[in] h 高度
+ * @return bool 相交返回 true
+ */
+bool Page_Strip_Visible(int16_t y, int16_t h) {
+    return y < g_page_manager.strip_y1 && y + h > g_page_manager.strip_y0;
+}
+
+/**
+ * @brief  判断以 y 为基线的一行文字是否与当前条带相交
+ * @details 文字占用基线以上 ascent 行、基线以下 -descent 行，多算基线所在的一行作为余量。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] y 基线
+ * @return bool 相交返回 true
+ */
+bool Page_Strip_Text_Visible(u8g2_t *u8g2, int16_t y) {
+    int16_t ascent = u8g2_GetAscent(u8g2);
+    int16_t descent = u8g2_GetDescent(u8g2);
+    return Page_Strip_Visible(y - ascent, ascent - descent + 1);
+}
+
+/**
+ * @brief  把一段连续字节与同一个位掩码异或
+ * @details 首尾不满4字节对齐的部分逐字节处理，中间按32位字处理，每次翻转4列。
+ * @param[in,out] p 起始地址
+ * @param[in] end 结束地址 (不包含)
+ * @param[in] mask 每个字节要翻转的位
+ * @return 无
+ */
+static void _Xor_Span(uint8_t* p, uint8_t* end, uint8_t mask) {
+    uint32_t mask32 = mask * 0x01010101U;
+
+    while (p < end && ((uintptr_t)p & 3U) != 0) {
+        *p++ ^= mask;
+    }
+    while (end - p >= 4) {
+        *(uint32_t*)p ^= mask32;
+        p += 4;
+    }
+    while (p < end) {
+        *p++ ^= mask;
+    }
+}
+
+/**
+ * @brief  将绘图缓冲区中的一个矩形区域反色
+ * @details SSD1306 的显存按页组织，每字节是一列中的8行 (低位在上)。矩形在每一页中占用的行
+ *          对应同一个位掩码，一页内的整段列只需与该掩码异或，不必逐像素处理。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 左上角X坐标
+ * @param[in] y 左上角Y坐标
+ * @param[in] w 宽度
+ * @param[in] h 高度
+ * @return 无
+ */
+void Page_Invert_Rect(u8g2_t *u8g2, int16_t x, int16_t y, int16_t w, int16_t h) {
+#if APP_DLIST_ACTIVE
+    if (app_dlist_recording()) {
+        app_dlist_add_invert(x, y, w, h);
+        return;
+    }
+#endif
+    int32_t buf_y0 = (int32_t)u8g2_GetBufferCurrTileRow(u8g2) * 8;
+    int32_t buf_y1 = buf_y0 + (int32_t)u8g2_GetBufferTileHeight(u8g2) * 8;
+    int32_t x0 = x;
+    int32_t y0 = y;
+    int32_t x1 = (int32_t)x + w;
+    int32_t y1 = (int32_t)y + h;
+
+    // 依次裁剪到屏幕、裁剪窗口和当前条带
+    if (x0 < 0) x0 = 0;
+    if (x0 < u8g2->clip_x0) x0 = u8g2->clip_x0;
+    if (x1 > SCREEN_WIDTH) x1 = SCREEN_WIDTH;
+    if (x1 > u8g2->clip_x1) x1 = u8g2->clip_x1;
+    if (y0 < buf_y0) y0 = buf_y0;
+    if (y0 < u8g2->clip_y0) y0 = u8g2->clip_y0;
+    if (y1 > buf_y1) y1 = buf_y1;
+    if (y1 > u8g2->clip_y1) y1 = u8g2->clip_y1;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    uint8_t* buf = u8g2_GetBufferPtr(u8g2);
+    for (int32_t py = y0 & ~7; py < y1; py += 8) {
+        uint8_t mask = 0xFF;
+        if (py < y0) {
+            mask &= (uint8_t)(0xFF << (y0 - py));
+        }
+        if (py + 8 > y1) {
+            mask &= (uint8_t)(0xFF >> (py + 8 - y1));
+        }
+        uint8_t* row = buf + (py - buf_y0) / 8 * SCREEN_WIDTH;
+        _Xor_Span(row + x0, row + x1, mask);
+    }
+}
+
+/**
+ * @brief  取出页式位图中从指定行开始的8行
+ * @param[in] tiles 位图
+ * @param[in] w 位图宽度
+ * @param[in] pages 位图页数
+ * @param[in] col 列
+ * @param[in] row 起始行，可以为负或超出位图，超出的部分为0
+ * @return uint8_t bit0 为第 row 行
+ */
+static uint8_t _Tile_Byte(const uint8_t* tiles, int16_t w, int16_t pages, int16_t col, int32_t row) {
+    int32_t page = row >> 3; // 负数向下取整
+    uint8_t bit = (uint8_t)(row & 7);
+    uint8_t v = 0;
+
+    if (page >= 0 && page < pages) {
+        v = (uint8_t)(tiles[page * w + col] >> bit);
+    }
+    if (bit != 0 && page + 1 >= 0 && page + 1 < pages) {
+        v |= (uint8_t)(tiles[(page + 1) * w + col] << (8 - bit));
+    }
+    return v;
+}
+
+/**
+ * @brief  把页式位图写入绘图缓冲区
+ * @details 裁剪方式与 Page_Invert_Rect 相同。整页可见且与显存页对齐时直接 memcpy，
+ *          其余的页 (未对齐或被裁掉部分行) 每列一次读改写。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 左上角X坐标
+ * @param[in] y 左上角Y坐标
+ * @param[in] w 宽度
+ * @param[in] h 高度 (8的倍数)
+ * @param[in] tiles 位图
+ * @return 无
+ */
+void Page_Draw_Tiles(u8g2_t *u8g2, int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *tiles) {
+#if APP_DLIST_ACTIVE
+    if (app_dlist_recording()) {
+        app_dlist_add_tiles(x, y, w, h, tiles);
+        return;
+    }
+#endif
+    int32_t buf_y0 = (int32_t)u8g2_GetBufferCurrTileRow(u8g2) * 8;
+    int32_t buf_y1 = buf_y0 + (int32_t)u8g2_GetBufferTileHeight(u8g2) * 8;
+    int16_t pages = h / 8;
+    int32_t x0 = x;
+    int32_t y0 = y;
+    int32_t x1 = (int32_t)x + w;
+    int32_t y1 = (int32_t)y + pages * 8;
+
+    if (x0 < 0) x0 = 0;
+    if (x0 < u8g2->clip_x0) x0 = u8g2->clip_x0;
+    if (x1 > SCREEN_WIDTH) x1 = SCREEN_WIDTH;
+    if (x1 > u8g2->clip_x1) x1 = u8g2->clip_x1;
+    if (y0 < buf_y0) y0 = buf_y0;
+    if (y0 < u8g2->clip_y0) y0 = u8g2->clip_y0;
+    if (y1 > buf_y1) y1 = buf_y1;
+    if (y1 > u8g2->clip_y1) y1 = u8g2->clip_y1;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    uint8_t* buf = u8g2_GetBufferPtr(u8g2);
+    int16_t c0 = (int16_t)(x0 - x);
+    int16_t n = (int16_t)(x1 - x0);
+    for (int32_t py = y0 & ~7; py < y1; py += 8) {
+        uint8_t mask = 0xFF;
+        if (py < y0) {
+            mask &= (uint8_t)(0xFF << (y0 - py));
+        }
+        if (py + 8 > y1) {
+            mask &= (uint8_t)(0xFF >> (py + 8 - y1));
+        }
+        uint8_t* dst = buf + (py - buf_y0) / 8 * SCREEN_WIDTH + x0;
+        int32_t row = py - y; // 本页第0行在位图中的行
+        if (mask == 0xFF && (row & 7) == 0) {
+            memcpy(dst, tiles + (row >> 3) * w + c0, (size_t)n);
+            continue;
+        }
+        for (int16_t c = 0; c < n; c++) {
+            uint8_t v = _Tile_Byte(tiles, w, pages, c0 + c, row);
+            dst[c] = (uint8_t)((dst[c] & (uint8_t)~mask) | (v & mask));
+        }
+    }
+}
+
+/**
+ * @brief  获取字符串在当前字体下的像素宽度 (带缓存)
+ * @details 计算一次哈希只需逐字节扫描字符串，比 u8g2_GetStrWidth 逐个字形查找字体表快得多。
+ *          缓存为直接映射，冲突时覆盖旧条目。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] str 字符串
+ * @return u8g2_uint_t 像素宽度
+ */
+u8g2_uint_t Page_Str_Width(u8g2_t *u8g2, const char* str) {
+    uint32_t hash = 2166136261U;
+    uint8_t len = 0;
+
+    for (const char* c = str; *c; c++, len++) {
+        hash = (hash ^ (uint8_t)*c) * 16777619U;
+    }
+    hash ^= (uint32_t)(uintptr_t)u8g2->font;
+
+    Str_Width_Entry_t* e = &g_str_width_cache[(hash ^ (hash >> 16)) & (STR_WIDTH_CACHE_SIZE - 1)];
+    if (e->font != u8g2->font || e->hash != hash || e->len != len) {
+        e->font = u8g2->font;
+        e->hash = hash;
+        e->len = len;
+        e->width = u8g2_GetStrWidth(u8g2, str);
+    }
+    return e->width;
+}
+
+/**
+ * @brief  取出提示文字中的一行
+ * @param[in] text 提示文字
+ * @param[in] n 行号 (从0开始)
+ * @param[out] buf 行缓冲区 (PAGE_TOAST_LINE_MAX 字节)，最后一行直接返回原文中的位置
+ * @return const char* 该行的文字，没有该行时返回 NULL
+ */
+static const char* _Overlay_Line(const char* text, uint8_t n, char* buf) {
+    const char* end;
+    size_t len;
+
+    while (n--) {
+        text = strchr(text, '\n');
+        if (!text) {
+            return NULL;
+        }
+        text++;
+    }
+    end = strchr(text, '\n');
+    if (!end) {
+        return text;
+    }
+    len = (size_t)(end - text);
+    if (len >= PAGE_TOAST_LINE_MAX) {
+        len = PAGE_TOAST_LINE_MAX - 1;
+    }
+    memcpy(buf, text, len);
+    buf[len] = '\0';
+    return buf;
+}
+
+/**
+ * @brief  按文字计算提示框的大小和位置 (屏幕中央)
+ * @param[in,out] o 提示框，text 已设置
+ * @return 无
  */
-static struct {
-    u8g2_t* u8g2;                   ///< 指向u8g2实例的指针
-    Page_Base* current_page;        ///< 指向当前活动页面的指针
+static void _Overlay_Layout(Page_Overlay_t* o) {
+    u8g2_t* u8g2 = g_page_manager.u8g2;
+    char buf[PAGE_TOAST_LINE_MAX];
+    const char* line;
+    uint16_t w = 0;
+    uint16_t h;
 
-    Manager_State_e state;          ///< 管理器当前状态
-    Page_Base* page_from;           ///< 动画的来源页面
-    Page_Base* page_to;             ///< 动画的目标页面
-    uint32_t anim_start_time;       ///< 动画开始的时间戳
-    uint32_t anim_duration;         ///< 动画总时长
-    
-    Page_Base* history_stack[PAGE_HISTORY_MAX_DEPTH]; ///< 存储历史页面的数组
-    int8_t history_depth;                             ///< 当前堆栈深度 (或叫栈顶指针)
+    u8g2_SetFont(u8g2, app_i18n_font(PROMPT_FONT));
+    o->lines = 0;
+    while (o->lines < PAGE_TOAST_LINES && (line = _Overlay_Line(o->text, o->lines, buf)) != NULL) {
+        uint16_t lw = app_i18n_width(u8g2, line);
+        if (lw > w) {
+            w = lw;
+        }
+        o->lines++;
+    }
+    w += 10;
+    if (w > SCREEN_WIDTH) {
+        w = SCREEN_WIDTH;
+    }
+    h = 4 + 12 * o->lines;
+    o->rect.x0 = (uint8_t)((SCREEN_WIDTH - w) / 2);
+    o->rect.y0 = (uint8_t)((SCREEN_HEIGHT - h) / 2);
+    o->rect.x1 = (uint8_t)(o->rect.x0 + w);
+    o->rect.y1 = (uint8_t)(o->rect.y0 + h);
+}
 
-} g_page_manager;
+/**
+ * @brief  绘制带边框的提示框
+ * @details 使用 PROMPT_FONT，文字按当前语言经 app_i18n 绘制，背景清空后覆盖下方内容。
+ * @param[in] o 提示框
+ * @return 无
+ */
+static void _Overlay_Draw(const Page_Overlay_t* o) {
+    u8g2_t* u8g2 = g_page_manager.u8g2;
+    const Page_Rect_t* r = &o->rect;
+    char buf[PAGE_TOAST_LINE_MAX];
 
-/* Private function prototypes -----------------------------------------------*/
-static void _Switch_Page_Internal(Page_Base* new_page, bool record_history);
+    Fb_Dma_Wait(); // 提示框下方的像素须已保存
+    u8g2_SetFont(u8g2, app_i18n_font(PROMPT_FONT));
+    u8g2_SetDrawColor(u8g2, 0); // 背景涂黑
+    u8g2_DrawBox(u8g2, r->x0, r->y0, r->x1 - r->x0, r->y1 - r->y0);
+    u8g2_SetDrawColor(u8g2, 1); // 边框和文字用白色
+    u8g2_DrawFrame(u8g2, r->x0, r->y0, r->x1 - r->x0, r->y1 - r->y0);
+    for (uint8_t i = 0; i < o->lines; i++) {
+        const char* line = _Overlay_Line(o->text, i, buf);
+        if (line) {
+            app_i18n_draw(u8g2, r->x0 + 5, r->y0 + 12 * (i + 1), line);
+        }
+    }
+}
 
-/* Function implementations --------------------------------------------------*/
+/**
+ * @brief  提示框栈发生变化后请求更新画面
+ * @details 整帧模式下只标记重新合成；分页模式下使变化的区域和新的栈顶区域失效。
+ * @param[in] r 出现或消失的提示框的区域
+ * @return 无
+ */
+static void _Overlay_Changed(const Page_Rect_t* r) {
+#if U8G2_BUFFER_MODE == 0
+    (void)r;
+    g_overlay.changed = true;
+#else
+    Page_Invalidate_Rect(g_page_manager.current_page, r->x0, r->y0, r->x1 - r->x0, r->y1 - r->y0);
+    if (g_overlay.count > 0) {
+        const Page_Rect_t* top = &g_overlay.stack[g_overlay.count - 1].rect;
+        Page_Invalidate_Rect(g_page_manager.current_page, top->x0, top->y0, top->x1 - top->x0, top->y1 - top->y0);
+    }
+#endif
+}
 
 /**
- * @brief  内部页面切换函数
- * @details 处理页面切换的核心逻辑，包括调用退出/进入函数和启动切换动画。
- * @param[in] new_page 要切换到的新页面
- * @param[in] record_history 是否将当前页面记录到历史堆栈中
+ * @brief  关闭一个提示框并调用其回调
+ * @param[in] i 在栈中的下标
  * @return 无
  */
-static void _Switch_Page_Internal(Page_Base* new_page, bool record_history) {
-    if (!new_page || new_page == g_page_manager.current_page || g_page_manager.state == MANAGER_STATE_ANIMATING) {
-        return;
+static void _Overlay_Pop(uint8_t i) {
+    Page_Toast_Done_t done = g_overlay.stack[i].done;
+    Page_Rect_t r = g_overlay.stack[i].rect;
+
+    g_overlay.count--;
+    memmove(&g_overlay.stack[i], &g_overlay.stack[i + 1], (g_overlay.count - i) * sizeof(g_overlay.stack[0]));
+    _Overlay_Changed(&r);
+    if (done) {
+        done(g_page_manager.current_page);
     }
+}
 
-    if (record_history) {
-        if (g_page_manager.current_page && g_page_manager.history_depth < PAGE_HISTORY_MAX_DEPTH) {
-            g_page_manager.history_stack[g_page_manager.history_depth] = g_page_manager.current_page;
-            g_page_manager.history_depth++;
+/**
+ * @brief  关闭到时的提示框
+ * @details 每次最多关闭一个，回调可能切换了页面，其余的在下一次循环中检查。
+ * @param[in] now 当前时间戳
+ * @return 无
+ */
+static void _Overlay_Tick(uint32_t now) {
+    for (uint8_t i = g_overlay.count; i-- > 0;) {
+        if (now - g_overlay.stack[i].start >= g_overlay.stack[i].duration) {
+            _Overlay_Pop(i);
+            return;
         }
     }
+}
 
-    if (g_page_manager.current_page && g_page_manager.current_page->exit) {
-        g_page_manager.current_page->exit(g_page_manager.current_page);
+/**
+ * @brief  丢弃全部提示框 (页面切换时)，不调用回调
+ * @return 无
+ */
+static void _Overlay_Clear(void) {
+#if U8G2_BUFFER_MODE == 0
+    _Overlay_Remove();
+    Fb_Dma_Wait();
+    g_overlay.changed = false;
+#endif
+    g_overlay.count = 0;
+}
+
+#if U8G2_BUFFER_MODE == 0
+/**
+ * @brief  从绘图缓冲区中去掉已合成的提示框
+ * @details 把保存的页面像素拷回提示框所在的整页行，拷贝由 DMA 进行，之后的绘制会等待它完成。
+ * @return 无
+ */
+static void _Overlay_Remove(void) {
+    uint16_t off = g_overlay.page0 * SCREEN_WIDTH;
+
+    u8g2_stm32_DrawBegin(); // 页面的局部重绘和只更新提示框都从这里开始改写缓冲区
+    if (!g_overlay.composited) {
+        return;
     }
+    Fb_Dma_Copy(u8g2_GetBufferPtr(g_page_manager.u8g2) + off, g_anim_snapshot + off,
+                (g_overlay.page1 - g_overlay.page0) * SCREEN_WIDTH);
+    g_overlay.composited = false;
+}
 
-    if (new_page->enter) {
-        new_page->enter(new_page);
+/**
+ * @brief  把栈顶的提示框合成到绘图缓冲区
+ * @details 先保存提示框所在整页行的页面像素，再绘制提示框。缓冲区中须是不含提示框的页面画面。
+ * @return 无
+ */
+static void _Overlay_Apply(void) {
+    const Page_Overlay_t* o;
+    uint16_t off;
+
+    g_overlay.changed = false;
+    if (g_overlay.count == 0) {
+        return;
     }
+    o = &g_overlay.stack[g_overlay.count - 1];
+    g_overlay.page0 = o->rect.y0 / 8;
+    g_overlay.page1 = (o->rect.y1 + 7) / 8;
+    off = g_overlay.page0 * SCREEN_WIDTH;
+    Fb_Dma_Copy(g_anim_snapshot + off, u8g2_GetBufferPtr(g_page_manager.u8g2) + off,
+                (g_overlay.page1 - g_overlay.page0) * SCREEN_WIDTH);
+    g_overlay.composited = true;
+    _Overlay_Draw(o);
+}
 
-    g_page_manager.page_from = g_page_manager.current_page;
-    g_page_manager.page_to = new_page;
-    g_page_manager.anim_start_time = HAL_GetTick();
-    g_page_manager.anim_duration = 250;
-    g_page_manager.state = MANAGER_STATE_ANIMATING;
+/**
+ * @brief  页面未失效、只有提示框变化时更新画面
+ * @details 恢复旧提示框下方的像素，合成新的栈顶后发送，只有这几页中变化的字节被刷新。
+ *          绘图缓冲区中没有完整的页面画面时改为整页重绘。
+ * @return 无
+ */
+static void _Render_Overlay(void) {
+    if (!g_page_manager.buffer_valid) {
+        Page_Invalidate(g_page_manager.current_page);
+        _Render_Page(g_page_manager.current_page);
+        return;
+    }
+    _Overlay_Remove();
+    _Overlay_Apply();
+    _Render_End();
+}
+#endif
+
+/**
+ * @brief  在当前页面上显示一个提示框
+ * @param[in] text 提示文字
+ * @param[in] duration_ms 显示时长
+ * @param[in] done 关闭时的回调
+ * @return 无
+ */
+void Page_Toast(const char* text, uint32_t duration_ms, Page_Toast_Done_t done) {
+    Page_Overlay_t* o;
+
+    if (g_overlay.count == PAGE_OVERLAY_DEPTH) {
+        // 栈满时丢弃最早的一项，不调用其回调
+        memmove(&g_overlay.stack[0], &g_overlay.stack[1], (PAGE_OVERLAY_DEPTH - 1) * sizeof(g_overlay.stack[0]));
+        g_overlay.count--;
+    }
+    o = &g_overlay.stack[g_overlay.count++];
+    o->text = text;
+    o->start = Page_Now();
+    o->duration = duration_ms;
+    o->done = done;
+    _Overlay_Layout(o);
+    _Overlay_Changed(&o->rect);
+}
+
+/**
+ * @brief  提示框关闭后返回上一页
+ * @param[in] page 当前页面 (未使用)
+ * @return 无
+ */
+void Page_Toast_Back(const Page_Base* page) {
+    (void)page;
+    Go_Back_Page();
+}
+
+/**
+ * @brief  查询当前是否有提示框
+ * @return bool 有提示框返回 true
+ */
+bool Page_Toast_Active(void) {
+    return g_overlay.count > 0;
 }
 
 /**
@@ -100,9 +1969,15 @@ void Page_Manager_Init(u8g2_t* u8g2_ptr) {
     g_page_manager.u8g2 = u8g2_ptr;
     g_page_manager.history_depth = 0;
     g_page_manager.current_page = &g_page_main;
+    g_page_manager.buffer_valid = false;
+    g_page_manager.strip_y0 = 0;
+    g_page_manager.strip_y1 = SCREEN_HEIGHT;
+    memset(g_page_data_owner, PAGE_ID_NONE, sizeof(g_page_data_owner));
+    _Bind_Page_Data(g_page_manager.current_page, NULL);
     if (g_page_manager.current_page->enter) {
         g_page_manager.current_page->enter(g_page_manager.current_page);
     }
+    Page_Invalidate(g_page_manager.current_page);
 }
 
 /**
@@ -111,8 +1986,36 @@ void Page_Manager_Init(u8g2_t* u8g2_ptr) {
  * @param[in] new_page 指向目标页面的指针
  * @return 无
  */
-void Switch_Page(Page_Base* new_page) {
-    _Switch_Page_Internal(new_page, true);
+void Switch_Page(const Page_Base* new_page) {
+    _Switch_Page_Internal(new_page, true, PAGE_TRANS_SLIDE_LEFT);
+}
+
+/**
+ * @brief  以指定的动画效果切换到页面
+ * @param[in] new_page 指向目标页面的指针
+ * @param[in] transition 切换动画效果
+ * @return 无
+ */
+void Switch_Page_Ex(const Page_Base* new_page, Page_Transition_e transition) {
+    _Switch_Page_Internal(new_page, true, transition);
+}
+
+/**
+ * @brief  按ID切换到指定的页面
+ * @param[in] id 目标页面ID
+ * @return 无
+ */
+void Switch_Page_Id(uint8_t id) {
+    _Switch_Page_Internal(Page_Get(id), true, PAGE_TRANS_SLIDE_LEFT);
+}
+
+/**
+ * @brief  按ID获取页面实例
+ * @param[in] id 页面ID
+ * @return const Page_Base* 页面实例，ID 无效时返回 NULL
+ */
+const Page_Base* Page_Get(uint8_t id) {
+    return (id < PAGE_COUNT) ? g_page_table[id].page : NULL;
 }
 
 /**
@@ -122,95 +2025,300 @@ void Switch_Page(Page_Base* new_page) {
  */
 void Page_Manager_Loop(void)
 {
+    TRACE(TRACE_EV_FRAME_BEGIN, 0);
+    MARK_BEGIN(FRAME);
+    PROF_BEGIN(PROF_SEC_FRAME);
+    uint32_t start = DWT->CYCCNT;
+    g_page_manager.now = HAL_GetTick();
+    g_page_manager.in_frame = true;
+    g_page_manager.drawn = false;
+    _Page_Manager_Step();
+    g_page_manager.in_frame = false;
+    if (g_page_manager.drawn) {
+        _Quality_Sample(g_page_manager.now, DWT->CYCCNT - start);
+    }
+    PROF_END(PROF_SEC_FRAME);
+    MARK_END(FRAME);
+    TRACE(TRACE_EV_FRAME_END, 0);
+}
+
+#if U8G2_PANEL_COUNT > 1
+/**
+ * @brief  驱动登记的副显示器
+ * @details 每个副显示器按自己的间隔绘制，与主显示器的帧周期和切换动画无关。
+ *          上一帧仍在发送时不绘制 (不排队)，主显示器的帧始终优先占用总线。
+ * @param[in] now 当前帧的时间戳
+ * @return 无
+ */
+static void _Panels_Step(uint32_t now) {
+    for (uint8_t i = 0; i < U8G2_PANEL_COUNT - 1; i++) {
+        u8g2_t* u8g2 = g_panels[i].u8g2;
+        if (u8g2 == NULL) {
+            continue;
+        }
+        u8g2_stm32_Service(u8g2);
+        if (u8g2_stm32_PanelIsBusy(u8g2) || (now - g_panels[i].last) < g_panels[i].interval) {
+            continue;
+        }
+        g_panels[i].last = now;
+        u8g2_ClearBuffer(u8g2);
+        g_panels[i].draw(u8g2);
+        u8g2_stm32_SendBufferAsync(u8g2);
+    }
+}
+
+/**
+ * @brief  登记一个由页面管理器驱动的副显示器
+ * @param[in] u8g2 副显示器的 u8g2 实例
+ * @param[in] draw 绘制函数
+ * @param[in] interval_ms 两次绘制的最小间隔 (ms)
+ * @return 无
+ */
+void Page_Manager_Add_Panel(u8g2_t* u8g2, Page_Panel_Draw_t draw, uint32_t interval_ms) {
+    for (uint8_t i = 0; i < U8G2_PANEL_COUNT - 1; i++) {
+        if (g_panels[i].u8g2 == NULL) {
+            g_panels[i].draw = draw;
+            g_panels[i].interval = interval_ms;
+            g_panels[i].last = HAL_GetTick() - interval_ms; // 下一轮立即绘制
+            g_panels[i].u8g2 = u8g2;
+            return;
+        }
+    }
+}
+#endif
+
+/**
+ * @brief  页面管理器单步逻辑
+ * @details Page_Manager_Loop 的实际内容，拆分出来以便在所有返回路径上统一计时。
+ * @return 无
+ */
+static void _Page_Manager_Step(void)
+{
+#if U8G2_BUFFER_MODE == 0
+    // 提前画好的一帧到时立即发送，不等帧时刻
+    if (g_page_manager.ahead && (int32_t)(g_page_manager.now - g_page_manager.ahead_due) >= 0) {
+        g_page_manager.ahead = false;
+        g_page_manager.frame_last = g_page_manager.now;
+        _Render_Send();
+    }
+    // 上一帧发送期间被推迟的画面在这里补发；缓冲区中是提前绘制的画面时留到发送时刻一起发出
+    if (!g_page_manager.ahead) {
+        u8g2_stm32_Service(g_page_manager.u8g2);
+    }
+#endif
+#if U8G2_PANEL_COUNT > 1
+    _Panels_Step(g_page_manager.now);
+#endif
+
+    uint32_t now = g_page_manager.now;
+
+    // 统一推进所有补间动画
+    bool tweened = Anim_Tween_Tick(now);
+
     // 优先处理动画状态
     if (g_page_manager.state == MANAGER_STATE_ANIMATING) {
-        uint32_t elapsed = HAL_GetTick() - g_page_manager.anim_start_time;
+        uint32_t elapsed = now - g_page_manager.anim_start_time;
 
         // 动画结束
         if (elapsed >= g_page_manager.anim_duration) {
             g_page_manager.state = MANAGER_STATE_IDLE;
             g_page_manager.current_page = g_page_manager.page_to;
-            
-            // 动画结束后，立即强制刷新一次最终画面
+
+            // 动画期间排队的导航请求接着执行，新的动画从这一帧的位置开始
+            _Nav_Run_Queue();
+            if (g_page_manager.state != MANAGER_STATE_IDLE) {
+                return;
+            }
+
+            // 把动画期间积压的输入交给新页面，它可能再次触发切换
+            if (g_page_manager.current_page) {
+                _Dispatch_Input(g_page_manager.current_page);
+            }
+            if (g_page_manager.state != MANAGER_STATE_IDLE) {
+                return;
+            }
+
+            // 动画结束后，立即强制刷新一次最终画面，并以此作为新页面的帧时刻起点
             if (g_page_manager.current_page && g_page_manager.current_page->draw) {
-                 u8g2_FirstPage(g_page_manager.u8g2);
-                 do {
-                     g_page_manager.current_page->draw(g_page_manager.current_page, g_page_manager.u8g2, 0, 0);
-                 } while (u8g2_NextPage(g_page_manager.u8g2));
+                 Page_Invalidate(g_page_manager.current_page);
+                 g_page_manager.frame_last = now;
+                 _Render_Page(g_page_manager.current_page);
             }
             return;
         }
 
         // 动画进行中
-        float progress = (float)elapsed / g_page_manager.anim_duration;
-        int16_t screen_width = u8g2_GetDisplayWidth(g_page_manager.u8g2);
-        int16_t from_x = -(int16_t)(screen_width * progress);
-        int16_t to_x = screen_width - (int16_t)(screen_width * progress);
+        // 返回键不等动画结束，可能使动画反向
+        _Dispatch_Nav_Input();
+        elapsed = now - g_page_manager.anim_start_time;
 
-        if (g_page_manager.page_from && g_page_manager.page_from->loop) {
-            g_page_manager.page_from->loop(g_page_manager.page_from);
+        // 先提交这一帧的底图 (DMA 清空或平移快照)，在它完成之前运行新页面的逻辑
+        const Page_Base* to = g_page_manager.page_to;
+        Trans_Frame_t frame;
+        bool frame_due = _Anim_Frame_Due(now);
+        if (frame_due) {
+            _Trans_Geometry(g_page_manager.transition, Anim_Progress(elapsed, g_page_manager.anim_duration), &frame);
+            _Render_Transition_Begin(&frame);
         }
-        if (g_page_manager.page_to && g_page_manager.page_to->loop) {
+
+        // 旧页面已经离开，只运行新页面的逻辑 (旧页面的 loop 可能还会发起传感器读取等操作)
+        if (g_page_manager.page_to && g_page_manager.page_to->loop && _Logic_Step_Due(now)) {
+            PROF_BEGIN(PROF_SEC_PAGE_LOOP);
             g_page_manager.page_to->loop(g_page_manager.page_to);
+            PROF_END(PROF_SEC_PAGE_LOOP);
         }
 
-        // 同时绘制旧页面和新页面，并施加位移以产生动画
-        u8g2_FirstPage(g_page_manager.u8g2);
-        do {
-            if (g_page_manager.page_from && g_page_manager.page_from->draw) {
-                g_page_manager.page_from->draw(g_page_manager.page_from, g_page_manager.u8g2, from_x, 0);
-            }
-            if (g_page_manager.page_to && g_page_manager.page_to->draw) {
-                g_page_manager.page_to->draw(g_page_manager.page_to, g_page_manager.u8g2, to_x, 0);
+        if (frame_due) {
+            if (g_page_manager.page_to != to) {
+                _Render_Transition_Begin(&frame); // loop 中返回使动画反向，快照已经换成另一个页面
             }
-        } while (u8g2_NextPage(g_page_manager.u8g2));
+            _Render_Transition(&frame);
+            g_page_manager.drawn = true;
+        }
 
     } 
     // 如果是静止状态，则按常规逻辑工作
     else { 
-        Page_Base* current = g_page_manager.current_page;
+        const Page_Base* current = g_page_manager.current_page;
         if (!current) return;
 
-        // 处理输入事件
-        Input_Event_Data_t event;
-        if (input_get_event(&event)) {
-            if (current->action) {
-                current->action(current, g_page_manager.u8g2, &event);
-            }
+        // 一次处理完所有积压的输入事件
+        _Dispatch_Input(current);
+        if (g_page_manager.state != MANAGER_STATE_IDLE || g_page_manager.current_page != current) {
+            return; // 输入触发了页面切换，下一次循环从动画开始
+        }
+
+        // 到时的提示框在页面 loop 之前关闭，其回调可能返回上一页
+        _Overlay_Tick(now);
+        if (g_page_manager.state != MANAGER_STATE_IDLE || g_page_manager.current_page != current) {
+            return;
+        }
+
+        // 补间动画仍在运行时逐帧重绘，全部结束后自然回落到按需重绘
+        if (tweened) {
+            Page_Invalidate(current);
         }
 
-        // 调用当前页面的循环逻辑
-        if (current->loop) {
+        // 按固定步长调用当前页面的循环逻辑
+        if (current->loop && _Logic_Step_Due(now)) {
+            PROF_BEGIN(PROF_SEC_PAGE_LOOP);
             current->loop(current);
+            PROF_END(PROF_SEC_PAGE_LOOP);
+        }
+
+#if U8G2_BUFFER_MODE == 0
+        // 分帧绘制中的画面每次循环接着画一段，期间的失效和提示框变化留到画面完成之后
+        if (g_page_manager.build == PAGE_BUILD_RUNNING) {
+            _Build_Slice(current);
+            return;
         }
+#endif
 
-        // 根据页面的刷新率判断是否需要重绘
-        uint32_t now = HAL_GetTick();
-        if (now - current->last_refresh_time >= current->refresh_rate_ms) {
-            current->last_refresh_time = now;
-            
-            if (current->draw) {
-                u8g2_FirstPage(g_page_manager.u8g2);
-                do {
-                    current->draw(current, g_page_manager.u8g2, 0, 0);
-                } while (u8g2_NextPage(g_page_manager.u8g2));
+        // 只有页面失效时才重绘，帧周期取 refresh_rate_ms 与总线能承受的周期中较大者
+        Page_State_t* st = &g_page_state[current->id];
+        uint32_t refresh = st->refresh_ms ? st->refresh_ms : g_page_table[current->id].refresh_rate_ms;
+        bool overlay_changed = false;
+        bool ahead = false;
+#if U8G2_BUFFER_MODE == 0
+        overlay_changed = g_overlay.changed; // 只有提示框变化时不重绘页面
+        ahead = g_page_manager.ahead;        // 提前绘制的画面不发送，不受帧率限制
+#endif
+        if ((st->dirty || overlay_changed) && (ahead || _Frame_Due(now, refresh))) {
+            if (ahead) {
+                g_page_manager.now = g_page_manager.ahead_due; // 画面属于发送的时刻
             }
+            if (st->dirty && current->draw) {
+                _Render_Page(current);
+                g_page_manager.drawn = true;
+            }
+#if U8G2_BUFFER_MODE == 0
+            else {
+                _Render_Overlay();
+            }
+#endif
+            g_page_manager.now = now;
         }
     }
 }
 
 /**
  * @brief  返回到上一个页面
- * @details 从历史堆栈中弹出上一个页面，并启动切换动画。
+ * @details 使用向右滑动的动画，与前进方向相反。
  * @return 无
  */
 void Go_Back_Page(void) {
-    if (g_page_manager.history_depth > 0) {
-        g_page_manager.history_depth--;
-        Page_Base* last_page = g_page_manager.history_stack[g_page_manager.history_depth];
-        
-        _Switch_Page_Internal(last_page, false); // false 表示不记录这次返回操作到历史
+    Go_Back_Page_Ex(PAGE_TRANS_SLIDE_RIGHT);
+}
+
+/**
+ * @brief  以指定的动画效果返回到上一个页面
+ * @details 从历史堆栈中弹出上一个页面，并启动切换动画。
+ *          历史记录为空 (超出堆栈深度或经 Go_Home 清空) 时返回注册表中的父页面。
+ * @param[in] transition 切换动画效果
+ * @return 无
+ */
+void Go_Back_Page_Ex(Page_Transition_e transition) {
+    if (g_page_manager.state == MANAGER_STATE_ANIMATING) {
+        // 目标是来源页面时就地反向；否则排队，历史堆栈到执行时才弹出，不会在被拒绝时丢失一层
+        if (g_page_manager.nav_count == 0 && g_page_manager.page_from &&
+            _Back_Target(false) == g_page_manager.page_from && _Nav_Reverse(transition)) {
+            (void)_Back_Target(true);
+        } else {
+            _Nav_Push(NULL, false, transition);
+        }
+        return;
+    }
+
+    _Switch_Page_Internal(_Back_Target(true), false, transition); // false 表示不记录这次返回操作到历史
+}
+
+/**
+ * @brief  获取当前帧的时间戳
+ * @return uint32_t 时间戳 (ms)
+ */
+uint32_t Page_Now(void) {
+    return g_page_manager.in_frame ? g_page_manager.now : HAL_GetTick();
+}
+
+/**
+ * @brief  记录页面的恢复状态
+ * @param[in] page 页面实例
+ * @param[in] value 状态值
+ * @return 无
+ */
+void Page_Resume_Set(const Page_Base* page, uint8_t value) {
+    g_page_state[page->id].resume = value;
+}
+
+/**
+ * @brief  在页面进入函数中取回恢复状态
+ * @param[in] page 页面实例
+ * @param[in] def 正常进入时使用的值
+ * @return uint8_t 状态值
+ */
+uint8_t Page_Resume_Get(const Page_Base* page, uint8_t def) {
+    Page_State_t* st = &g_page_state[page->id];
+
+    if (!st->resume_pending) {
+        st->resume = def; // 正常进入，之后记录的是本次进入的状态
+        return def;
+    }
+    st->resume_pending = false;
+    return st->resume;
+}
+
+/**
+ * @brief  获取页面的私有数据
+ * @param[in] page 页面
+ * @return void* 页面私有数据，页面未分配槽位时返回 NULL
+ */
+void* Page_Data(const Page_Base* page) {
+    for (uint8_t i = 0; i < PAGE_DATA_SLOTS; i++) {
+        if (g_page_data_owner[i] == page->id) {
+            return g_page_data[i].bytes;
+        }
     }
+    return NULL;
 }
 
 /**
@@ -221,22 +2329,202 @@ void Go_Back_Page(void) {
  */
 void Page_Manager_Go_Home(void)
 {
-    if (g_page_manager.current_page == &g_page_main && g_page_manager.state == MANAGER_STATE_IDLE) {
+    Page_Manager_Go_Page(&g_page_main);
+}
+
+/**
+ * @brief  强制切换到指定页面
+ * @param[in] page 目标页面
+ * @return 无
+ */
+void Page_Manager_Go_Page(const Page_Base* page)
+{
+    if (!page || (g_page_manager.current_page == page && g_page_manager.state == MANAGER_STATE_IDLE)) {
         return;
     }
 
-    if (g_page_manager.current_page && g_page_manager.current_page->exit) {
-        g_page_manager.current_page->exit(g_page_manager.current_page);
+    // 切换动画期间来源页面已经退出过，退出的应是正在进入的页面
+    const Page_Base* leaving = (g_page_manager.state == MANAGER_STATE_ANIMATING) ?
+                               g_page_manager.page_to : g_page_manager.current_page;
+    if (leaving && leaving->exit) {
+        leaving->exit(leaving);
     }
 
     g_page_manager.history_depth = 0;
+    g_page_manager.nav_count = 0;
+    Anim_Tween_Stop_All();
+    _Overlay_Clear();
 
-    g_page_manager.current_page = &g_page_main;
+    g_page_manager.current_page = page;
     g_page_manager.state = MANAGER_STATE_IDLE;
+    g_page_manager.buffer_valid = false;
+    g_page_manager.ahead = false;
+    g_page_manager.build = PAGE_BUILD_NONE; // 未完成的画面随页面一起作废
 
+    memset(g_page_data_owner, PAGE_ID_NONE, sizeof(g_page_data_owner));
+    _Bind_Page_Data(g_page_manager.current_page, NULL);
     if (g_page_manager.current_page->enter) {
         g_page_manager.current_page->enter(g_page_manager.current_page);
     }
+    Page_Invalidate(g_page_manager.current_page);
+
+    // 历史记录已清空，恢复堆栈时留下的、尚未取回的状态不再有效
+    for (uint8_t i = 0; i < PAGE_COUNT; i++) {
+        g_page_state[i].resume_pending = false;
+    }
+}
+
+/**
+ * @brief  查询是否正在播放页面切换动画
+ * @return bool 切换动画进行中返回 true
+ */
+bool Page_Manager_Is_Animating(void)
+{
+    return g_page_manager.state == MANAGER_STATE_ANIMATING;
+}
+
+/**
+ * @brief  页面管理器下一次需要运行的时刻
+ * @details 切换动画、补间动画、分帧绘制、等待帧时刻的重绘和被推迟的发送每个滴答检查一次；
+ *          其余时间只有页面 loop 按 PAGE_LOGIC_STEP_MS 的步长运行，提前绘制的画面到发送时刻运行。
+ * @param[in] now 当前时间戳
+ * @return uint32_t 下一次需要调用 Page_Manager_Loop 的时间戳
+ */
+uint32_t Page_Manager_Next_Due(uint32_t now)
+{
+    const Page_Base* current = g_page_manager.current_page;
+    bool busy = g_page_manager.state != MANAGER_STATE_IDLE || current == NULL || Anim_Tween_Any_Active() ||
+                g_page_state[current->id].dirty || U8G2_PANEL_COUNT > 1;
+#if U8G2_BUFFER_MODE == 0
+    busy = busy || g_page_manager.build == PAGE_BUILD_RUNNING || g_overlay.changed || u8g2_stm32_IsFlushBusy();
+#endif
+    if (busy) {
+        return now + 1;
+    }
+
+    uint32_t due = g_page_manager.logic_last + PAGE_LOGIC_STEP_MS;
+#if U8G2_BUFFER_MODE == 0
+    if (g_page_manager.ahead && (int32_t)(g_page_manager.ahead_due - due) < 0) {
+        due = g_page_manager.ahead_due;
+    }
+#endif
+    return due;
+}
+
+/**
+ * @brief  设置帧周期的附加下限
+ * @param[in] ms 下限 (ms)，0 表示不限制
+ * @return 无
+ */
+void Page_Manager_Set_Frame_Floor(uint16_t ms)
+{
+    g_page_manager.frame_floor = ms;
+}
+
+/**
+ * @brief  查询当前的动画画质等级
+ * @return Page_Quality_e 画质等级
+ */
+Page_Quality_e Page_Manager_Quality(void)
+{
+    return (Page_Quality_e)g_page_manager.quality;
+}
+
+/**
+ * @brief  把当前页面完整绘制到绘图缓冲区，不发送到屏幕
+ * @details 条带缓冲模式下依次绘制每个条带，缓冲区中最后留下的是最后一个条带。
+ *          缓冲区不再与屏幕一致，下一帧整屏重绘。
+ * @return 无
+ */
+void Page_Manager_Draw_Current(void)
+{
+    const Page_Base* page = g_page_manager.current_page;
+
+#if U8G2_BUFFER_MODE == 0
+    _Render_Begin();
+    g_page_manager.strip_y0 = 0;
+    g_page_manager.strip_y1 = SCREEN_HEIGHT;
+    _Draw_Page(page, 0, 0);
+#else
+    for (uint8_t strip = 0; strip < SCREEN_HEIGHT / U8G2_STRIP_HEIGHT; strip++) {
+        u8g2_SetBufferCurrTileRow(g_page_manager.u8g2, strip * U8G2_STRIP_PAGES);
+        u8g2_ClearBuffer(g_page_manager.u8g2);
+        g_page_manager.strip_y0 = strip * U8G2_STRIP_HEIGHT;
+        g_page_manager.strip_y1 = g_page_manager.strip_y0 + U8G2_STRIP_HEIGHT;
+        _Draw_Page(page, 0, 0);
+    }
+#endif
+    g_page_manager.buffer_valid = false;
+    Page_Invalidate(page);
+}
+
+/**
+ * @brief  导出页面堆栈
+ * @param[out] ids 页面ID
+ * @param[out] values 各页面的恢复状态
+ * @param[in] max 最多导出的项数
+ * @return uint8_t 导出的项数
+ */
+uint8_t Page_Manager_Save_Stack(uint8_t* ids, uint8_t* values, uint8_t max) {
+    const Page_Base* top = (g_page_manager.state == MANAGER_STATE_ANIMATING) ? g_page_manager.page_to
+                                                                             : g_page_manager.current_page;
+    uint8_t depth = (uint8_t)g_page_manager.history_depth;
+    uint8_t skip;
+    uint8_t n = 0;
+
+    if (max == 0 || !top) {
+        return 0;
+    }
+    skip = (depth + 1 > max) ? depth + 1 - max : 0; // 放不下时丢弃最早的历史记录
+    for (uint8_t i = skip; i < depth; i++) {
+        ids[n] = g_page_manager.history_stack[i];
+        values[n] = g_page_state[ids[n]].resume;
+        n++;
+    }
+    ids[n] = top->id;
+    values[n] = g_page_state[top->id].resume;
+    return n + 1;
+}
+
+/**
+ * @brief  恢复页面堆栈
+ * @param[in] ids 页面ID
+ * @param[in] values 各页面的恢复状态
+ * @param[in] count 项数
+ * @return bool 已恢复返回 true
+ */
+bool Page_Manager_Restore_Stack(const uint8_t* ids, const uint8_t* values, uint8_t count) {
+    if (count == 0 || count > PAGE_HISTORY_MAX_DEPTH + 1) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (ids[i] >= PAGE_COUNT) {
+            return false;
+        }
+    }
+
+    // 先进入栈顶页面 (清空历史记录)，再写入其下的各项
+    g_page_state[ids[count - 1]].resume = values[count - 1];
+    g_page_state[ids[count - 1]].resume_pending = true;
+    Page_Manager_Go_Page(g_page_table[ids[count - 1]].page);
+    g_page_state[ids[count - 1]].resume_pending = false; // 已经是当前页面时不会再进入
+    for (uint8_t i = 0; i + 1 < count; i++) {
+        g_page_manager.history_stack[i] = ids[i];
+        g_page_state[ids[i]].resume = values[i];
+        g_page_state[ids[i]].resume_pending = true;
+    }
+    g_page_manager.history_depth = (int8_t)(count - 1);
+    return true;
+}
+
+/**
+ * @brief  页面 draw 回调的调用通知 (弱定义)
+ * @param[in] page 即将绘制的页面
+ * @return 无
+ */
+__weak void Page_Manager_DrawCallback(const Page_Base* page)
+{
+    (void)page;
 }
 
 /**
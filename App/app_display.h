@@ -19,26 +19,107 @@
 #include "u8g2.h"
 #include "u8x8.h"
 #include "u8g2_stm32_hal.h"
+#include "app_dlist.h"
 #include "input.h"
 #include "string.h"
 #include "stdint.h"
+#include "stdbool.h"
 
-/** @defgroup UI_Fonts UI 字体定义 */
-/** @{ */
+/**
+ * @defgroup UI_Fonts_Config UI 字体配置
+ * @{
+ */
+#define APP_DISPLAY_FONT_SUBSET 0 ///< 为1时使用 Tools/font_subset.py 生成的子集字体 (App/app_fonts.c，需加入工程)
+/** @} */
+
+#if APP_DISPLAY_FONT_SUBSET
+#include "app_fonts.h"
+#define APP_FONT(name) app_font_##name  ///< 只含界面用到的字形的子集字体
+#else
+#define APP_FONT(name) u8g2_font_##name ///< u8g2 的完整字体
+#endif
+
+/**
+ * @defgroup UI_Fonts UI 字体定义
+ * @details 用 APP_FONT() 定义的字体参与裁剪；主时钟的数字字体本身只有数字，直接使用 u8g2 字体。
+ *          改用新的字体后，开启裁剪时需重新运行 Tools/font_subset.py。
+ * @{
+ */
 #define CLOCK_FONT u8g2_font_logisoso24_tn      ///< 主时钟界面使用的大号数字字体
-#define DATE_TEMP_FONT u8g2_font_6x10_tf        ///< 用于显示日期、温度等信息的小号字体
-#define MENU_FONT u8g2_font_ncenB10_tr        ///< 菜单选项使用的字体
-#define INFO_FONT_SMALL u8g2_font_profont12_tf   ///< 关于页面使用的小字体
-#define INFO_FONT_BIG u8g2_font_t0_15_tf        ///< 关于页面使用的字体
-#define DATE_FONT_LABEL u8g2_font_profont12_tf  ///< 日期设置页面标签使用的字体
-#define DATE_FONT_VALUE_SMALL u8g2_font_ncenB14_tr ///< 日期设置页面值使用的小字体
-#define DATE_FONT_VALUE_LARGE u8g2_font_inb16_mr  ///< 日期设置页面值使用的大字体
-#define TIME_FONT_LABEL u8g2_font_profont12_tf  ///< 时间设置页面标签使用的字体
-#define TIME_FONT_VALUE_SMALL u8g2_font_ncenB14_tr ///< 时间设置页面值使用的小字体
-#define TIME_FONT_VALUE_LARGE u8g2_font_inb16_mr  ///< 时间设置页面值使用的大字体
-#define PROMPT_FONT u8g2_font_profont12_tf      ///< 用于显示提示信息的字体
+#define DATE_TEMP_FONT APP_FONT(6x10_tf)        ///< 用于显示日期、温度等信息的小号字体
+#define MENU_FONT APP_FONT(ncenB10_tr)        ///< 菜单选项使用的字体
+#define INFO_FONT_SMALL APP_FONT(profont12_tf)   ///< 关于页面使用的小字体
+#define INFO_FONT_BIG APP_FONT(t0_15_tf)        ///< 关于页面使用的字体
+#define DATE_FONT_LABEL APP_FONT(profont12_tf)  ///< 日期设置页面标签使用的字体
+#define DATE_FONT_VALUE_SMALL APP_FONT(ncenB14_tr) ///< 日期设置页面值使用的小字体
+#define DATE_FONT_VALUE_LARGE APP_FONT(inb16_mr)  ///< 日期设置页面值使用的大字体
+#define TIME_FONT_LABEL APP_FONT(profont12_tf)  ///< 时间设置页面标签使用的字体
+#define TIME_FONT_VALUE_SMALL APP_FONT(ncenB14_tr) ///< 时间设置页面值使用的小字体
+#define TIME_FONT_VALUE_LARGE APP_FONT(inb16_mr)  ///< 时间设置页面值使用的大字体
+#define PROMPT_FONT APP_FONT(profont12_tf)      ///< 用于显示提示信息的字体
+#define ALARM_FONT_LIST APP_FONT(profont12_tf)  ///< 闹钟列表和编辑页面标签使用的等宽字体
+#define ALARM_FONT_VALUE APP_FONT(ncenB14_tr)    ///< 闹钟编辑页面时和分使用的字体
+#define CALENDAR_FONT APP_FONT(4x6_tf)          ///< 月历的星期名称和日期数字使用的小字体
+#define APP_I18N_FONT APP_FONT(wqy12_t_gb2312) ///< 中文界面文字的字体 (只能裁剪后使用，见 app_i18n.h)
+/** @} */
+
+/**
+ * @defgroup Page_Registry 页面注册表
+ * @brief 全部页面在编译期登记于此，管理器据此生成页面ID、父页面关系和刷新策略表 (均位于Flash)。
+ * @details 每一项为 X(ID, 实例名, 父页面ID, 最小重绘间隔ms)：
+ *          - ID 生成 PAGE_ID_<ID>，页面实例的 .id 须与之对应；
+ *          - 实例名对应页面文件中定义的 g_page_<实例名>；
+ *          - 父页面为 NONE 表示顶层页面，历史记录为空时 Go_Back_Page() 返回到父页面；
+ *          - 重绘间隔为两次重绘之间的最小间隔，0 表示尽可能快。
+ *          新增页面时在此添加一项并在页面文件中定义对应的实例即可。
+ * @{
+ */
+#define PAGE_TABLE(X) \
+    X(MAIN,      main,      NONE,      100)   /* 时钟只需每100ms检查一次 */   \
+    X(MAIN_MENU, main_menu, MAIN,      30)    /* 列表动画 ~33FPS */           \
+    X(DISPLAY,   display,   MAIN_MENU, 30)                                   \
+    X(INFO,      info,      MAIN_MENU, 10000) /* 静态页面 */                  \
+    X(TIME_SET,  time_set,  MAIN_MENU, 16)    /* ~60FPS */                    \
+    X(TIME_DATE, time_date, TIME_SET,  16)                                   \
+    X(TIME_TIME, time_time, TIME_SET,  16)                                   \
+    X(TIME_DST,  time_dst,  TIME_SET,  30)                                   \
+    X(LANGUAGE,  language,  DISPLAY,   30)                                   \
+    X(AUTO_OFF,  auto_off,  DISPLAY,   30)                                   \
+    X(DIAG,      diag,      INFO,      200)   /* 数据每秒更新，由 loop 标脏 */ \
+    X(AMBIENT,   ambient,   MAIN,      1000)  /* 低功耗时钟，每分钟重绘一次 */ \
+    X(ALARM,     alarm,     MAIN_MENU, 16)    /* 老虎机滚动 ~60FPS */         \
+    X(ALARM_RING, alarm_ring, MAIN,    100)   /* 响铃提示每500ms闪烁一次 */ \
+    X(HISTORY,   history,   MAIN,      1000)  /* 每5分钟一个样本，只重绘最新的一列 */ \
+    X(STOPWATCH, stopwatch, MAIN_MENU, 20)    /* 1/100秒只重绘变化的数字 */   \
+    X(COUNTDOWN, countdown, MAIN_MENU, 20)                                   \
+    X(WORLD,     world,     MAIN_MENU, 30)    /* 列表动画 ~33FPS，各行只在分钟变化时重绘 */ \
+    X(CALENDAR,  calendar,  MAIN,      30)    /* 翻月滚动 ~33FPS，静止时每天重绘一次 */
+
+/**
+ * @brief 页面ID，由 PAGE_TABLE 生成
+ */
+typedef enum {
+#define PAGE_X_ID(id, name, parent, refresh_ms) PAGE_ID_##id,
+    PAGE_TABLE(PAGE_X_ID)
+#undef PAGE_X_ID
+    PAGE_COUNT,           ///< 页面总数
+    PAGE_ID_NONE = 0xFF   ///< 无页面 (用作顶层页面的父页面)
+} Page_Id_e;
 /** @} */
 
+/**
+ * @brief 页面切换动画效果
+ */
+typedef enum {
+    PAGE_TRANS_NONE = 0,     ///< 无动画，立即切换
+    PAGE_TRANS_SLIDE_LEFT,   ///< 两个页面一起向左滑动 (Switch_Page 的默认效果)
+    PAGE_TRANS_SLIDE_RIGHT,  ///< 两个页面一起向右滑动 (Go_Back_Page 的默认效果)
+    PAGE_TRANS_SLIDE_UP,     ///< 两个页面一起向上滑动
+    PAGE_TRANS_SLIDE_DOWN,   ///< 两个页面一起向下滑动
+    PAGE_TRANS_PUSH,         ///< 旧页面不动，新页面从右侧滑入覆盖
+    PAGE_TRANS_FADE          ///< 有序抖动淡入 (仅整帧模式，分页模式下退化为无动画)
+} Page_Transition_e;
+
 /**
  * @brief 向前声明页面基类结构体
  * @details 允许在函数指针类型定义中引用 Page_Base 自身。
@@ -52,19 +133,19 @@ struct Page_Base;
  * @brief 页面进入函数指针类型
  * @param[in] page 指向当前页面实例的指针
  */
-typedef void (*Page_Enter_f)(struct Page_Base* page);
+typedef void (*Page_Enter_f)(const struct Page_Base* page);
 
 /**
  * @brief 页面退出函数指针类型
  * @param[in] page 指向当前页面实例的指针
  */
-typedef void (*Page_Exit_f)(struct Page_Base* page);
+typedef void (*Page_Exit_f)(const struct Page_Base* page);
 
 /**
  * @brief 页面循环逻辑函数指针类型
  * @param[in] page 指向当前页面实例的指针
  */
-typedef void (*Page_Loop_f)(struct Page_Base* page);
+typedef void (*Page_Loop_f)(const struct Page_Base* page);
 
 /**
  * @brief 页面绘制函数指针类型
@@ -73,7 +154,7 @@ typedef void (*Page_Loop_f)(struct Page_Base* page);
  * @param[in] x_offset 绘制的X轴偏移量，用于实现动画
  * @param[in] y_offset 绘制的Y轴偏移量，用于实现动画
  */
-typedef void (*Page_Draw_f)(struct Page_Base* page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+typedef void (*Page_Draw_f)(const struct Page_Base* page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
 
 /**
  * @brief 页面动作处理函数指针类型
@@ -81,12 +162,25 @@ typedef void (*Page_Draw_f)(struct Page_Base* page, u8g2_t *u8g2, int16_t x_offs
  * @param[in] u8g2 指向u8g2实例的指针
  * @param[in] event 指向输入事件数据的指针
  */
-typedef void (*Page_Action_f)(struct Page_Base* page, u8g2_t *u8g2, const Input_Event_Data_t* event);
+typedef void (*Page_Action_f)(const struct Page_Base* page, u8g2_t *u8g2, const Input_Event_Data_t* event);
 
 /** @} */
 
 /**
- * @brief 页面基类结构体，定义了一个页面的所有行为和属性
+ * @brief 屏幕上的矩形区域
+ * @details 坐标已裁剪到屏幕范围内 (0~128)，用8位存放以减小每个页面的运行状态。
+ */
+typedef struct {
+    uint8_t x0; ///< 左边界 (包含)
+    uint8_t y0; ///< 上边界 (包含)
+    uint8_t x1; ///< 右边界 (不包含)
+    uint8_t y1; ///< 下边界 (不包含)
+} Page_Rect_t;
+
+/**
+ * @brief 页面基类结构体，定义了一个页面的所有行为
+ * @details 页面实例定义为 const，整体位于Flash。父页面和刷新间隔登记在 PAGE_TABLE 中，
+ *          失效区域、上次刷新时间等运行状态由管理器按页面ID保存在RAM中。
  */
 typedef struct Page_Base {
     Page_Enter_f  enter;            ///< 进入此页面时调用的函数，用于初始化
@@ -96,24 +190,33 @@ typedef struct Page_Base {
     Page_Action_f action;           ///< 处理输入事件或动作的函数
     
     const char*   page_name;        ///< 页面的名称，用于调试
-    struct Page_Base* parent_page;  ///< 指向父页面的指针，用于实现“返回”功能
-    
-    uint32_t      refresh_rate_ms;  ///< 页面的建议刷新率（毫秒），0表示尽可能快
-    uint32_t      last_refresh_time;///< 上次刷新的时间戳
+    uint8_t       id;               ///< 页面ID (Page_Id_e)，须与 PAGE_TABLE 中的登记一致
+    const void*   desc;             ///< 通用页面引擎的描述 (如 ui_option 的 UI_Option_t)，其余页面为 NULL
 } Page_Base;
 
+/**
+ * @defgroup Page_Data_Arena 页面私有数据区
+ * @brief 页面的私有数据不再各自静态分配，而是由管理器从两个槽位中分配。
+ * @details 任一时刻只有当前页面和切换动画中的另一个页面是活动的，因此两个槽位就够用。
+ *          进入页面时为其分配另一页面未占用的槽位并清零，页面在 enter 中初始化自己的数据，
+ *          之后在各回调中通过 Page_Data() 取得。离开后数据不保留。
+ * @{
+ */
+#define PAGE_DATA_SIZE 96 ///< 每个槽位的字节数，须不小于最大的页面私有数据结构体
+
+/**
+ * @brief 编译期检查页面私有数据结构体能否放入一个槽位，放不下时编译报错
+ * @param type 页面私有数据结构体类型
+ */
+#define PAGE_DATA_CHECK(type) \
+    typedef char type##_must_fit_in_page_data[(sizeof(type) <= PAGE_DATA_SIZE) ? 1 : -1]
+/** @} */
+
 /** @defgroup Global_Pages 全局页面实例声明 */
 /** @{ */
-extern Page_Base g_page_main; 
-extern Page_Base g_page_main_menu;  
-extern Page_Base g_page_display; 
-extern Page_Base g_page_info; 
-extern Page_Base g_page_time_set; 
-extern Page_Base g_page_time_date; 
-extern Page_Base g_page_time_time; 
-extern Page_Base g_page_time_dst; 
-extern Page_Base g_page_language; 
-extern Page_Base g_page_auto_off;
+#define PAGE_X_EXTERN(id, name, parent, refresh_ms) extern const Page_Base g_page_##name;
+PAGE_TABLE(PAGE_X_EXTERN)
+#undef PAGE_X_EXTERN
 /** @} */
 
 
@@ -137,18 +240,283 @@ void Page_Manager_Loop(void);
 /**
  * @brief 切换到指定的页面
  * @details 会调用当前页面的exit函数和新页面的enter函数。
+ *          切换动画期间调用时不会被丢弃：目标是动画的来源页面时动画从当前位置反向退回，
+ *          其余请求排队 (最多 4 个)，当前动画结束后从结束的位置接着切换。
  * @param[in] new_page 指向要切换到的目标页面的指针
  * @return 无
  */
-void Switch_Page(Page_Base* new_page);
+void Switch_Page(const Page_Base* new_page);
 
 /**
- * @brief 返回到当前页面的父页面
- * @details 如果当前页面没有定义父页面，则此函数无效。
+ * @brief 以指定的动画效果切换到页面
+ * @details 与 Switch_Page() 相同，Switch_Page() 使用 PAGE_TRANS_SLIDE_LEFT。
+ * @param[in] new_page 指向要切换到的目标页面的指针
+ * @param[in] transition 切换动画效果
+ * @return 无
+ */
+void Switch_Page_Ex(const Page_Base* new_page, Page_Transition_e transition);
+
+/**
+ * @brief 按ID切换到指定的页面
+ * @details 与 Switch_Page() 相同，供菜单等用ID表驱动跳转的场合使用。ID 无效时无操作。
+ * @param[in] id 目标页面ID (Page_Id_e)
+ * @return 无
+ */
+void Switch_Page_Id(uint8_t id);
+
+/**
+ * @brief 按ID获取页面实例
+ * @param[in] id 页面ID (Page_Id_e)
+ * @return const Page_Base* 页面实例，ID 无效时返回 NULL
+ */
+const Page_Base* Page_Get(uint8_t id);
+
+/**
+ * @brief 返回到上一个页面
+ * @details 优先返回历史记录中的上一个页面；历史记录为空时返回 PAGE_TABLE 中登记的父页面，
+ *          顶层页面上调用无效。切换动画期间的处理与 Switch_Page() 相同，排队的返回请求到执行时才弹出历史记录。
+ *          动画期间按下的返回键不等动画结束，由页面管理器直接调用本函数 (滑入途中按返回键即原路退回)。
  * @return 无
  */
 void Go_Back_Page(void);
 
+/**
+ * @brief 以指定的动画效果返回到上一个页面
+ * @details 与 Go_Back_Page() 相同，Go_Back_Page() 使用 PAGE_TRANS_SLIDE_RIGHT。
+ * @param[in] transition 切换动画效果
+ * @return 无
+ */
+void Go_Back_Page_Ex(Page_Transition_e transition);
+
+/**
+ * @brief 使整个页面失效，请求重绘
+ * @details 页面在 loop/action 中状态发生变化时调用；动画进行中每次 loop 都调用即可
+ *          按 refresh_rate_ms 的节奏逐帧重绘。管理器只在页面失效时才会重绘。
+ * @param[in] page 指向页面的指针
+ * @return 无
+ */
+void Page_Invalidate(const Page_Base* page);
+
+/**
+ * @brief 使页面的一个矩形区域失效，请求局部重绘
+ * @details 管理器只清除并重绘该区域 (通过裁剪窗口)，区域外的像素保持不变。
+ * @param[in] page 指向页面的指针
+ * @param[in] x 区域左上角X坐标
+ * @param[in] y 区域左上角Y坐标
+ * @param[in] w 区域宽度
+ * @param[in] h 区域高度
+ * @return 无
+ */
+void Page_Invalidate_Rect(const Page_Base* page, int16_t x, int16_t y, int16_t w, int16_t h);
+
+/**
+ * @brief 在运行时改变页面的重绘间隔
+ * @details 覆盖 PAGE_TABLE 中的 refresh_ms，直到页面下一次进入 (或以 0 恢复)。
+ *          可以低于帧周期的下限 PAGE_FRAME_MIN_MS，但仍不短于总线发送一帧所需的时间。
+ * @param[in] page 指向页面的指针
+ * @param[in] ms 两次重绘之间的最小间隔 (毫秒)，0 恢复为注册表中的值
+ * @return 无
+ */
+void Page_Set_Refresh(const Page_Base* page, uint16_t ms);
+
+/**
+ * @brief 提前绘制页面在某一时刻的画面，到时才发送
+ * @details 页面在 loop 中已把自己的状态推进到 due 时刻 (如下一秒的时间) 并使变化的区域失效，
+ *          本帧随即绘制 (不受帧率限制，Page_Now() 返回 due，动画按该时刻计算进度)，但画面留在缓冲区中不发送；
+ *          到 due 时第一件事就是发送，关键路径上只剩总线传输。到时之前页面再失效时继续画在这一帧上。
+ *          页面切换时取消。只在整帧模式下支持，分页模式或当前不是该页面时返回 false，页面应照常显示当前状态。
+ * @param[in] page 指向页面的指针 (须为当前页面)
+ * @param[in] due 画面应当出现的时刻 (HAL_GetTick() 时间戳，须在将来)
+ * @return bool 已安排提前绘制返回 true
+ */
+bool Page_Render_Ahead(const Page_Base* page, uint32_t due);
+
+/**
+ * @brief 请求页面的下一次整屏重绘分多帧完成
+ * @details 用于一次画不完的页面 (如整条温度曲线)：重绘开始时清空缓冲区，之后每次主循环调用一次 draw，
+ *          每次在 PAGE_BUILD_BUDGET_US 的预算内绘制一段 (Page_Build_Yield)，画面完成 (Page_Build_Done) 之前不发送，
+ *          屏幕上保持上一帧。期间输入分发、页面 loop 和补间动画照常以全速运行，页面的失效和提示框变化留到画面完成后处理。
+ *          再次调用时从头开始，页面切换时取消。页面须在调用前把自己的绘制进度复位。
+ *          只在整帧模式下分帧，分页模式下与 Page_Invalidate() 相同 (Page_Build_Active() 总是返回 false)。
+ * @param[in] page 指向页面的指针
+ * @return 无
+ */
+void Page_Build_Begin(const Page_Base* page);
+
+/**
+ * @brief 查询本次 draw 是否为分帧绘制的一段
+ * @details 为 true 时页面从上一段停下的位置接着绘制 (缓冲区中保留着已画好的部分)；
+ *          为 false 时 (普通重绘、切换动画、分页模式) 页面应照常一次画完。
+ * @return bool 是返回 true
+ */
+bool Page_Build_Active(void);
+
+/**
+ * @brief 查询分帧绘制的这一段是否已用完时间预算
+ * @details 页面每画完一部分调用一次，返回 true 时记下进度并从 draw 返回。不在分帧绘制时总是返回 false。
+ * @return bool 应当停下返回 true
+ */
+bool Page_Build_Yield(void);
+
+/**
+ * @brief 报告分帧绘制的画面已经完成
+ * @details 页面画完最后一部分时调用，管理器随即合成提示框并发送这一帧。不在分帧绘制时没有作用。
+ * @param[in] page 指向页面的指针
+ * @return 无
+ */
+void Page_Build_Done(const Page_Base* page);
+
+/**
+ * @brief 获取当前正在绘制的条带
+ * @details 只能在 draw 回调中调用。分页模式 (U8G2_BUFFER_MODE 为 1/2) 下一帧按条带绘制多次，
+ *          每次只有条带内的像素有效；整帧模式下为本次重绘的失效行范围，通常是整个屏幕。
+ *          分页模式开启 APP_DLIST_ENABLE 时 draw 每帧只执行一次 (录制)，此时为本帧要重绘的全部条带。
+ * @param[out] y0 条带上边界 (包含，屏幕坐标)
+ * @param[out] y1 条带下边界 (不包含，屏幕坐标)
+ * @return 无
+ */
+void Page_Get_Strip(int16_t* y0, int16_t* y1);
+
+/**
+ * @brief 临时改变当前的条带
+ * @details 供离屏绘制 (ui_canvas.h) 使用：在 draw 回调中绘制到另一块缓冲区之前设为整段，之后用
+ *          Page_Get_Strip 保存的值恢复，Page_Strip_Visible 等判断随之改变。
+ * @param[in] y0 条带上边界 (包含，屏幕坐标)
+ * @param[in] y1 条带下边界 (不包含，屏幕坐标)
+ * @return 无
+ */
+void Page_Set_Strip(int16_t y0, int16_t y1);
+
+/**
+ * @brief 判断一段像素行是否与当前条带相交
+ * @details draw 回调可据此跳过当前条带之外的字形和图形，分页模式下避免每个条带都把
+ *          整页重绘一遍。只能在 draw 回调中调用。
+ * @param[in] y 上边界 (屏幕坐标，已加上 y_offset)
+ * @param[in] h 高度
+ * @return bool 相交返回 true
+ */
+bool Page_Strip_Visible(int16_t y, int16_t h);
+
+/**
+ * @brief 判断以 y 为基线的一行文字是否与当前条带相交
+ * @details 按当前字体的上升/下降高度估算文字占用的行，须先调用 u8g2_SetFont()。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] y 基线 (屏幕坐标，已加上 y_offset)
+ * @return bool 相交返回 true
+ */
+bool Page_Strip_Text_Visible(u8g2_t *u8g2, int16_t y);
+
+/**
+ * @brief 将绘图缓冲区中的一个矩形区域反色
+ * @details 用于列表的选中高亮：先正常绘制全部文字，再反色高亮条所在的矩形，文字只需绘制一次。
+ *          结果与"画实心框 + 在框内用颜色0重绘文字"相同。
+ *          矩形会被裁剪到屏幕、当前裁剪窗口和当前条带 (分页模式) 的范围内。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 左上角X坐标 (屏幕坐标，已加上 x_offset)
+ * @param[in] y 左上角Y坐标 (屏幕坐标，已加上 y_offset)
+ * @param[in] w 宽度
+ * @param[in] h 高度
+ * @return 无
+ */
+void Page_Invert_Rect(u8g2_t *u8g2, int16_t x, int16_t y, int16_t w, int16_t h);
+
+/**
+ * @brief 把按 SSD1306 页式布局存放的位图写入绘图缓冲区
+ * @details 位图第 p 页 (8行) 的第 c 列为 tiles[p * w + c]，bit0 为该页的第一行，与显存的字节布局相同。
+ *          以不透明方式写入 (位图中为0的像素清零)，不受绘图颜色影响。Y坐标与显存页对齐时
+ *          每页整行 memcpy，否则每列由相邻两页移位拼出。位图会被裁剪到屏幕、当前裁剪窗口和当前条带内。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 左上角X坐标 (屏幕坐标，已加上 x_offset)
+ * @param[in] y 左上角Y坐标 (屏幕坐标，已加上 y_offset)
+ * @param[in] w 宽度 (列数)
+ * @param[in] h 高度，须为8的倍数
+ * @param[in] tiles 位图 (通常位于Flash)，在本帧绘制结束前须保持有效
+ * @return 无
+ */
+void Page_Draw_Tiles(u8g2_t *u8g2, int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *tiles);
+
+/**
+ * @brief 获取字符串在当前字体下的像素宽度 (带缓存)
+ * @details 结果与 u8g2_GetStrWidth 相同。以字体和字符串内容为键缓存，
+ *          内容不变的字符串 (标签、提示文字、每秒才变化的时间日期) 不必每帧重新扫描字体。
+ * @param[in] u8g2 指向u8g2实例的指针 (须已设置字体)
+ * @param[in] str 字符串
+ * @return u8g2_uint_t 像素宽度
+ */
+u8g2_uint_t Page_Str_Width(u8g2_t *u8g2, const char* str);
+
+/**
+ * @brief 提示框关闭时的回调
+ * @param[in] page 显示提示框的页面
+ */
+typedef void (*Page_Toast_Done_t)(const Page_Base* page);
+
+#define PAGE_TOAST_MS 1000 ///< 保存成功等提示框的默认显示时长 (ms)
+
+/**
+ * @brief 在当前页面上显示提示框 (保存成功、读取失败等反馈信息)
+ * @details 提示框由页面管理器绘制在屏幕中央，使用 PROMPT_FONT，文字按当前语言经 app_i18n 绘制。
+ *          显示期间页面照常运行和重绘，但不接收输入；到时或按返回键时关闭并调用 done。
+ *          提示框的出现和消失不需要页面重绘：整帧模式下恢复其下方保存的像素，
+ *          分页模式下只重绘提示框所在的区域。切换页面时提示框被丢弃，不调用 done。
+ *          已有提示框时新的提示框显示在上面，栈满时丢弃最早的一个。
+ * @param[in] text 提示文字 (须在显示期间保持有效)，可用 '\n' 分为最多2行
+ * @param[in] duration_ms 显示时长
+ * @param[in] done 关闭时的回调，可为NULL
+ * @return 无
+ */
+void Page_Toast(const char *text, uint32_t duration_ms, Page_Toast_Done_t done);
+
+/**
+ * @brief 提示框关闭后返回上一页，可作为 Page_Toast 的 done
+ * @param[in] page 显示提示框的页面
+ * @return 无
+ */
+void Page_Toast_Back(const Page_Base* page);
+
+/**
+ * @brief 查询当前是否有提示框
+ * @return bool 有提示框返回 true
+ */
+bool Page_Toast_Active(void);
+
+/**
+ * @brief 获取页面的私有数据
+ * @details 只能在页面自己的回调中调用，槽位大小为 PAGE_DATA_SIZE，按指针对齐。
+ * @param[in] page 页面
+ * @return void* 页面私有数据，页面未处于活动状态时返回 NULL
+ */
+void* Page_Data(const Page_Base* page);
+
+/**
+ * @brief 获取当前帧的时间戳
+ * @details 页面管理器在每次 Page_Manager_Loop 开始时读取一次时间，同一帧内的输入处理、
+ *          页面 loop 和 draw 都看到同一个值，各元素的动画不会因为读取时刻不同而错开。
+ *          在帧之外 (如主循环直接切换页面时的 enter 回调) 调用时返回实时的 HAL_GetTick()。
+ * @return uint32_t 时间戳 (ms)
+ */
+uint32_t Page_Now(void);
+
+/**
+ * @brief 记录页面的恢复状态
+ * @details 管理器为每个页面ID保存一个值，页面在用户改变选中项、焦点等状态时调用。
+ *          熄屏前该值随页面堆栈一起保存 (见 app_resume.h)，恢复后页面进入时由 Page_Resume_Get() 取回。
+ * @param[in] page 页面实例
+ * @param[in] value 状态值 (如列表的选中项索引)
+ * @return 无
+ */
+void Page_Resume_Set(const Page_Base* page, uint8_t value);
+
+/**
+ * @brief 在页面进入函数中取回恢复状态
+ * @details 页面经 Page_Manager_Restore_Stack() 恢复后第一次进入时返回记录的值，其余情况返回 def
+ *          (并把记录的值改为 def)，因此正常进入页面的行为不变。
+ * @param[in] page 页面实例
+ * @param[in] def 正常进入时使用的值
+ * @return uint8_t 状态值
+ */
+uint8_t Page_Resume_Get(const Page_Base* page, uint8_t def);
+
 /**
  * @brief 强制返回到主页面
  * @details 清空所有页面历史记录，并立即将当前页面设置为主页面，无切换动画。
@@ -157,6 +525,121 @@ void Go_Back_Page(void);
  */
 void Page_Manager_Go_Home(void);
 
+/**
+ * @brief 强制切换到指定页面
+ * @details 与 Page_Manager_Go_Home() 相同，清空历史记录并立即切换，无切换动画，
+ *          进行中的切换动画也会被中止。用于进入低功耗时钟等不经过菜单的页面。
+ * @param[in] page 目标页面，为 NULL 时无操作
+ * @return 无
+ */
+void Page_Manager_Go_Page(const Page_Base* page);
+
+/**
+ * @brief 查询是否正在播放页面切换动画
+ * @return bool 切换动画进行中返回 true
+ */
+bool Page_Manager_Is_Animating(void);
+
+/**
+ * @brief 查询页面管理器下一次需要运行的时刻
+ * @details 供主循环决定屏幕点亮时的空闲时长：静止的页面只需要按 loop 的固定步长 (5ms) 运行，
+ *          动画、重绘和发送期间每个滴答都要运行。输入由中断唤醒主循环，不在其中考虑。
+ * @param[in] now 当前时间戳 (HAL_GetTick())
+ * @return uint32_t 下一次需要调用 Page_Manager_Loop 的时间戳，不晚于 now + 5
+ */
+uint32_t Page_Manager_Next_Due(uint32_t now);
+
+/**
+ * @brief 设置帧周期的附加下限
+ * @details 低电量模式下限制帧率：之后每一帧的周期都不短于该值，包括切换动画和页面要求的更短间隔。
+ *          动画的进度按时间计算，只是帧数变少。
+ * @param[in] ms 下限 (ms)，0 表示不限制
+ * @return 无
+ */
+void Page_Manager_Set_Frame_Floor(uint16_t ms);
+
+/**
+ * @brief 动画画质等级，由页面管理器按实测的帧时间自动调节
+ * @details 连续运动 (切换动画、补间、页面逐帧重绘的缩放等) 的帧耗时 (绘制的 CPU 时间与刷新时间中较大者)
+ *          的滑动平均持续超出预算时降一级，持续低于上一级预算的 3/4 后再升一级。
+ *          动画的进度始终按时间计算，任何等级下运动都按时结束，降级只减少细节。
+ */
+typedef enum {
+    PAGE_QUALITY_FULL = 0, ///< 全部细节
+    PAGE_QUALITY_SKIP,     ///< 运动中的帧周期加倍，跳过中间的缩放帧
+    PAGE_QUALITY_CUT,      ///< 另外以在中点切换字体代替连续缩放，淡入切换改为直接切换
+    PAGE_QUALITY_SHORT,    ///< 另外把切换动画缩短一半
+    PAGE_QUALITY_OFF,      ///< 另外关闭补间和切换动画 (Anim_Set_Reduced)
+} Page_Quality_e;
+
+/**
+ * @brief 查询当前的动画画质等级
+ * @details 页面据此决定是否绘制代价高的效果，如 UI_Slot_Draw_Zoom 在 PAGE_QUALITY_CUT 及以下不再缩放。
+ * @return Page_Quality_e 画质等级
+ */
+Page_Quality_e Page_Manager_Quality(void);
+
+/**
+ * @brief 把当前页面完整绘制到绘图缓冲区，不发送到屏幕
+ * @details 用于测量页面 draw 的耗时 (板上基准测试)。绘制后当前页面被标记为整屏失效。
+ * @return 无
+ */
+void Page_Manager_Draw_Current(void);
+
+/**
+ * @brief 导出页面堆栈
+ * @details 按从栈底 (最早的历史记录) 到当前页面的顺序给出页面ID和各自记录的恢复状态。
+ *          超过 max 项时丢弃最早的历史记录。切换动画进行中时以目标页面为当前页面。
+ * @param[out] ids 页面ID
+ * @param[out] values 各页面的恢复状态 (Page_Resume_Set)
+ * @param[in] max 最多导出的项数
+ * @return uint8_t 导出的项数 (至少为1)
+ */
+uint8_t Page_Manager_Save_Stack(uint8_t* ids, uint8_t* values, uint8_t max);
+
+/**
+ * @brief 恢复页面堆栈
+ * @details 与 Page_Manager_Go_Page() 一样立即切换到最后一项 (无动画)，之前的各项写入历史记录；
+ *          这些页面下一次进入时 Page_Resume_Get() 返回对应的值。
+ *          数据无效 (页面ID越界、项数为0或超过历史深度) 时不做任何修改。
+ * @param[in] ids 页面ID，顺序与 Page_Manager_Save_Stack() 相同
+ * @param[in] values 各页面的恢复状态
+ * @param[in] count 项数
+ * @return bool 已恢复返回 true
+ */
+bool Page_Manager_Restore_Stack(const uint8_t* ids, const uint8_t* values, uint8_t count);
+
+/**
+ * @brief 页面 draw 回调的调用通知 (弱定义，默认为空)
+ * @details 管理器每次调用页面的 draw 回调之前调用，可被覆盖用于统计 (如主机端渲染基准)。
+ * @param[in] page 即将绘制的页面
+ * @return 无
+ */
+void Page_Manager_DrawCallback(const Page_Base* page);
+
+#if U8G2_PANEL_COUNT > 1
+/**
+ * @brief 副显示器的绘制函数
+ * @details 在主循环中调用，绘图缓冲区已清空。画面与上一次相同时不产生任何总线传输。
+ * @param[in] u8g2 副显示器的 u8g2 实例
+ * @return 无
+ */
+typedef void (*Page_Panel_Draw_t)(u8g2_t* u8g2);
+
+/**
+ * @brief 登记一个由页面管理器驱动的副显示器
+ * @details 副显示器不参与页面切换和输入分发，每轮主循环中：先补发被推迟的帧，
+ *          上一帧已发完且距上次绘制不少于 interval_ms 时清空缓冲区、调用 draw 并异步刷新。
+ *          刷新只发送变化的列区间，总线上的开销与画面的变化频率成正比，而不是与绘制频率成正比。
+ *          须先用 u8g2_stm32_PanelInit() 初始化该实例；登记已满时无操作。
+ * @param[in] u8g2 副显示器的 u8g2 实例
+ * @param[in] draw 绘制函数
+ * @param[in] interval_ms 两次绘制的最小间隔 (ms)
+ * @return 无
+ */
+void Page_Manager_Add_Panel(u8g2_t* u8g2, Page_Panel_Draw_t draw, uint32_t interval_ms);
+#endif
+
 /** @} */
 
 #endif /* __APP_DISPLAY_H */
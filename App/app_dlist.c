@@ -0,0 +1,424 @@
+/**
+ * @file      app_dlist.c
+ * @brief     分页模式下的绘图命令录制与回放
+ * @details   命令按录制顺序紧密排列在命令区中，每条命令为一个 Dlist_Cmd_t，字符串命令的内容
+ *            (含结尾的 0) 紧跟在后面，整条命令按4字节对齐。绘图命令在录制时算出影响的行范围，
+ *            回放时与条带比较，不相交的直接跳过。
+ *            本文件用 (u8g2_DrawStr)(...) 的写法调用 u8g2 的原函数，不经过 app_dlist.h 中的替换宏。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_dlist.h"
+
+#if APP_DLIST_ACTIVE
+
+#include "app_display.h"
+#include "app_glyph_cache.h"
+#include <string.h>
+
+/**
+ * @addtogroup AppDList
+ * @{
+ */
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 命令类型
+ */
+typedef enum {
+    DLIST_OP_FONT,       ///< 设置字体 (arg.ptr)
+    DLIST_OP_COLOR,      ///< 设置绘图颜色 (x)
+    DLIST_OP_CLIP,       ///< 设置裁剪窗口 (x, y, w, h 为 x0, y0, x1, y1)
+    DLIST_OP_CLIP_MAX,   ///< 取消裁剪窗口
+    DLIST_OP_STR,        ///< u8g2_DrawStr
+    DLIST_OP_UTF8,       ///< u8g2_DrawUTF8
+    DLIST_OP_CACHED_STR, ///< Glyph_Cache_DrawStr
+    DLIST_OP_SCALED_STR, ///< Glyph_Cache_DrawStr_Scaled (arg.u 为比例)
+    DLIST_OP_GLYPH,      ///< u8g2_DrawGlyph (arg.u 为编码)
+    DLIST_OP_BOX,        ///< u8g2_DrawBox
+    DLIST_OP_FRAME,      ///< u8g2_DrawFrame
+    DLIST_OP_HLINE,      ///< u8g2_DrawHLine
+    DLIST_OP_VLINE,      ///< u8g2_DrawVLine
+    DLIST_OP_INVERT,     ///< Page_Invert_Rect
+    DLIST_OP_BLIT,       ///< 位图 (arg.ptr 为 App_DList_Blit_t)
+    DLIST_OP_TILES,      ///< Page_Draw_Tiles (arg.ptr 为位图)
+} Dlist_Op_e;
+
+/**
+ * @brief 一条命令 (字符串命令后接字符串内容)
+ */
+typedef struct {
+    uint8_t op;      ///< 命令类型 (Dlist_Op_e)
+    uint8_t size;    ///< 整条命令占用的字节数
+    int16_t y0;      ///< 影响的首行 (包含)，状态命令不使用
+    int16_t y1;      ///< 影响的末行 (不包含)
+    int16_t x;       ///< 参数 X
+    int16_t y;       ///< 参数 Y
+    int16_t w;       ///< 参数宽度
+    int16_t h;       ///< 参数高度
+    union {
+        const void *ptr;
+        uint32_t u;
+    } arg;           ///< 附加参数
+} Dlist_Cmd_t;
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t dlist_arena[APP_DLIST_ARENA_SIZE / 4]; ///< 命令区 (按字对齐)
+static uint16_t dlist_used;     ///< 命令区已使用的字节数
+static uint16_t dlist_begin;    ///< 正在录制的命令段的起点
+static bool dlist_recording;    ///< 是否正在录制
+static bool dlist_overflow;     ///< 正在录制的命令段是否因命令区不足而作废
+
+/* Private function prototypes -----------------------------------------------*/
+static Dlist_Cmd_t *dlist_add(uint8_t op, int16_t x, int16_t y, int16_t w, int16_t h, const char *str);
+static void dlist_text_rows(u8g2_t *u8g2, Dlist_Cmd_t *cmd);
+static u8g2_uint_t dlist_advance(u8g2_t *u8g2, const char *str, bool utf8);
+static void dlist_exec(u8g2_t *u8g2, const Dlist_Cmd_t *cmd);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 在命令区末尾追加一条命令
+ * @details 影响范围默认取 y~y+h，文字命令由调用者修正。
+ * @param[in] op 命令类型
+ * @param[in] x 参数 X
+ * @param[in] y 参数 Y
+ * @param[in] w 参数宽度
+ * @param[in] h 参数高度
+ * @param[in] str 附带的字符串，可为NULL
+ * @return Dlist_Cmd_t* 新命令；命令区不足时返回 NULL，并使本段录制作废
+ */
+static Dlist_Cmd_t *dlist_add(uint8_t op, int16_t x, int16_t y, int16_t w, int16_t h, const char *str)
+{
+    size_t len = str ? strlen(str) + 1 : 0;
+    size_t size = (sizeof(Dlist_Cmd_t) + len + 3U) & ~3U;
+    Dlist_Cmd_t *cmd;
+
+    if (dlist_overflow || size > 0xFF || dlist_used + size > sizeof(dlist_arena)) {
+        dlist_overflow = true;
+        return NULL;
+    }
+    cmd = (Dlist_Cmd_t *)((uint8_t *)dlist_arena + dlist_used);
+    cmd->op = op;
+    cmd->size = (uint8_t)size;
+    cmd->x = x;
+    cmd->y = y;
+    cmd->w = w;
+    cmd->h = h;
+    cmd->y0 = y;
+    cmd->y1 = y + h;
+    cmd->arg.u = 0;
+    if (len) {
+        memcpy(cmd + 1, str, len);
+    }
+    dlist_used += (uint16_t)size;
+    return cmd;
+}
+
+/**
+ * @brief 按当前字体的外框设置文字命令的影响范围
+ * @details 取字体中所有字形的外框 (比 ascent/descent 略大)，不会漏掉超出参考高度的字形。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in,out] cmd 命令，y 为基线
+ * @return 无
+ */
+static void dlist_text_rows(u8g2_t *u8g2, Dlist_Cmd_t *cmd)
+{
+    cmd->y1 = cmd->y - u8g2->font_info.y_offset + 1;
+    cmd->y0 = cmd->y1 - u8g2->font_info.max_char_height - 1;
+}
+
+/**
+ * @brief 计算字符串的步进宽度 (各字形步进之和，与 u8g2_DrawStr 的返回值相同)
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] str 字符串
+ * @param[in] utf8 是否按 UTF-8 解码
+ * @return u8g2_uint_t 步进宽度
+ */
+static u8g2_uint_t dlist_advance(u8g2_t *u8g2, const char *str, bool utf8)
+{
+    u8g2_uint_t w = 0;
+
+    if (utf8) {
+        u8x8_utf8_init(u8g2_GetU8x8(u8g2));
+    }
+    for (; *str; str++) {
+        uint16_t e = utf8 ? u8x8_utf8_next(u8g2_GetU8x8(u8g2), (uint8_t)*str) : (uint8_t)*str;
+        if (e == 0x0FFFF) {
+            break;
+        }
+        if (e != 0x0FFFE) {
+            w += u8g2_GetGlyphWidth(u8g2, e);
+        }
+    }
+    return w;
+}
+
+/**
+ * @brief 执行一条命令
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] cmd 命令
+ * @return 无
+ */
+static void dlist_exec(u8g2_t *u8g2, const Dlist_Cmd_t *cmd)
+{
+    const char *str = (const char *)(cmd + 1);
+
+    switch (cmd->op) {
+    case DLIST_OP_FONT:
+        (u8g2_SetFont)(u8g2, (const uint8_t *)cmd->arg.ptr);
+        break;
+    case DLIST_OP_COLOR:
+        (u8g2_SetDrawColor)(u8g2, (uint8_t)cmd->x);
+        break;
+    case DLIST_OP_CLIP:
+        (u8g2_SetClipWindow)(u8g2, (u8g2_uint_t)cmd->x, (u8g2_uint_t)cmd->y, (u8g2_uint_t)cmd->w, (u8g2_uint_t)cmd->h);
+        break;
+    case DLIST_OP_CLIP_MAX:
+        (u8g2_SetMaxClipWindow)(u8g2);
+        break;
+    case DLIST_OP_STR:
+        (u8g2_DrawStr)(u8g2, (u8g2_uint_t)cmd->x, (u8g2_uint_t)cmd->y, str);
+        break;
+    case DLIST_OP_UTF8:
+        (u8g2_DrawUTF8)(u8g2, (u8g2_uint_t)cmd->x, (u8g2_uint_t)cmd->y, str);
+        break;
+    case DLIST_OP_CACHED_STR:
+        Glyph_Cache_DrawStr(u8g2, cmd->x, cmd->y, str);
+        break;
+    case DLIST_OP_SCALED_STR:
+        Glyph_Cache_DrawStr_Scaled(u8g2, cmd->x, cmd->y, str, cmd->arg.u);
+        break;
+    case DLIST_OP_GLYPH:
+        (u8g2_DrawGlyph)(u8g2, (u8g2_uint_t)cmd->x, (u8g2_uint_t)cmd->y, (uint16_t)cmd->arg.u);
+        break;
+    case DLIST_OP_BOX:
+        (u8g2_DrawBox)(u8g2, (u8g2_uint_t)cmd->x, (u8g2_uint_t)cmd->y, (u8g2_uint_t)cmd->w, (u8g2_uint_t)cmd->h);
+        break;
+    case DLIST_OP_FRAME:
+        (u8g2_DrawFrame)(u8g2, (u8g2_uint_t)cmd->x, (u8g2_uint_t)cmd->y, (u8g2_uint_t)cmd->w, (u8g2_uint_t)cmd->h);
+        break;
+    case DLIST_OP_HLINE:
+        (u8g2_DrawHLine)(u8g2, (u8g2_uint_t)cmd->x, (u8g2_uint_t)cmd->y, (u8g2_uint_t)cmd->w);
+        break;
+    case DLIST_OP_VLINE:
+        (u8g2_DrawVLine)(u8g2, (u8g2_uint_t)cmd->x, (u8g2_uint_t)cmd->y, (u8g2_uint_t)cmd->h);
+        break;
+    case DLIST_OP_INVERT:
+        Page_Invert_Rect(u8g2, cmd->x, cmd->y, cmd->w, cmd->h);
+        break;
+    case DLIST_OP_BLIT:
+        ((App_DList_Blit_t)cmd->arg.ptr)(u8g2, cmd->x, cmd->y);
+        break;
+    case DLIST_OP_TILES:
+        Page_Draw_Tiles(u8g2, cmd->x, cmd->y, cmd->w, cmd->h, (const uint8_t *)cmd->arg.ptr);
+        break;
+    default:
+        break;
+    }
+}
+
+/* Function implementations --------------------------------------------------*/
+
+void app_dlist_reset(void)
+{
+    dlist_used = 0;
+}
+
+void app_dlist_record_begin(void)
+{
+    dlist_begin = dlist_used;
+    dlist_overflow = false;
+    dlist_recording = true;
+}
+
+bool app_dlist_record_end(App_DList_Seg_t *seg)
+{
+    dlist_recording = false;
+    if (dlist_overflow) {
+        dlist_used = dlist_begin; // 作废的命令段不占用命令区
+        return false;
+    }
+    seg->begin = dlist_begin;
+    seg->end = dlist_used;
+    return true;
+}
+
+bool app_dlist_recording(void)
+{
+    return dlist_recording;
+}
+
+void app_dlist_replay(u8g2_t *u8g2, const App_DList_Seg_t *seg, int16_t y0, int16_t y1)
+{
+    const uint8_t *p = (const uint8_t *)dlist_arena + seg->begin;
+    const uint8_t *end = (const uint8_t *)dlist_arena + seg->end;
+
+    while (p < end) {
+        const Dlist_Cmd_t *cmd = (const Dlist_Cmd_t *)p;
+        if (cmd->op <= DLIST_OP_CLIP_MAX || (cmd->y0 < y1 && cmd->y1 > y0)) {
+            dlist_exec(u8g2, cmd);
+        }
+        p += cmd->size;
+    }
+}
+
+u8g2_uint_t app_dlist_add_cached_str(u8g2_t *u8g2, int16_t x, int16_t y, const char *str)
+{
+    Dlist_Cmd_t *cmd = dlist_add(DLIST_OP_CACHED_STR, x, y, 0, 0, str);
+    if (cmd) {
+        dlist_text_rows(u8g2, cmd);
+    }
+    return dlist_advance(u8g2, str, false);
+}
+
+void app_dlist_add_scaled_str(int16_t x, int16_t y, const char *str, uint32_t scale, int16_t top, int16_t h)
+{
+    Dlist_Cmd_t *cmd = dlist_add(DLIST_OP_SCALED_STR, x, y, 0, 0, str);
+    if (cmd) {
+        cmd->arg.u = scale;
+        cmd->y0 = top;
+        cmd->y1 = top + h;
+    }
+}
+
+void app_dlist_add_invert(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    dlist_add(DLIST_OP_INVERT, x, y, w, h, NULL);
+}
+
+void app_dlist_add_blit(App_DList_Blit_t fn, int16_t x, int16_t top, int16_t h)
+{
+    Dlist_Cmd_t *cmd = dlist_add(DLIST_OP_BLIT, x, top, 0, h, NULL);
+    if (cmd) {
+        cmd->arg.ptr = (const void *)fn;
+    }
+}
+
+void app_dlist_add_tiles(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *tiles)
+{
+    Dlist_Cmd_t *cmd = dlist_add(DLIST_OP_TILES, x, y, w, h, NULL);
+    if (cmd) {
+        cmd->arg.ptr = tiles;
+    }
+}
+
+u8g2_uint_t app_dlist_draw_str(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str)
+{
+    Dlist_Cmd_t *cmd;
+
+    if (!dlist_recording) {
+        return (u8g2_DrawStr)(u8g2, x, y, str);
+    }
+    cmd = dlist_add(DLIST_OP_STR, (int16_t)x, (int16_t)y, 0, 0, str);
+    if (cmd) {
+        dlist_text_rows(u8g2, cmd);
+    }
+    return dlist_advance(u8g2, str, false);
+}
+
+u8g2_uint_t app_dlist_draw_utf8(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str)
+{
+    Dlist_Cmd_t *cmd;
+
+    if (!dlist_recording) {
+        return (u8g2_DrawUTF8)(u8g2, x, y, str);
+    }
+    cmd = dlist_add(DLIST_OP_UTF8, (int16_t)x, (int16_t)y, 0, 0, str);
+    if (cmd) {
+        dlist_text_rows(u8g2, cmd);
+    }
+    return dlist_advance(u8g2, str, true);
+}
+
+u8g2_uint_t app_dlist_draw_glyph(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, uint16_t encoding)
+{
+    Dlist_Cmd_t *cmd;
+
+    if (!dlist_recording) {
+        return (u8g2_DrawGlyph)(u8g2, x, y, encoding);
+    }
+    cmd = dlist_add(DLIST_OP_GLYPH, (int16_t)x, (int16_t)y, 0, 0, NULL);
+    if (cmd) {
+        cmd->arg.u = encoding;
+        dlist_text_rows(u8g2, cmd);
+    }
+    return (u8g2_uint_t)u8g2_GetGlyphWidth(u8g2, encoding);
+}
+
+void app_dlist_draw_box(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h)
+{
+    if (!dlist_recording) {
+        (u8g2_DrawBox)(u8g2, x, y, w, h);
+        return;
+    }
+    dlist_add(DLIST_OP_BOX, (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h, NULL);
+}
+
+void app_dlist_draw_frame(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h)
+{
+    if (!dlist_recording) {
+        (u8g2_DrawFrame)(u8g2, x, y, w, h);
+        return;
+    }
+    dlist_add(DLIST_OP_FRAME, (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h, NULL);
+}
+
+void app_dlist_draw_hline(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w)
+{
+    if (!dlist_recording) {
+        (u8g2_DrawHLine)(u8g2, x, y, w);
+        return;
+    }
+    dlist_add(DLIST_OP_HLINE, (int16_t)x, (int16_t)y, (int16_t)w, 1, NULL);
+}
+
+void app_dlist_draw_vline(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t h)
+{
+    if (!dlist_recording) {
+        (u8g2_DrawVLine)(u8g2, x, y, h);
+        return;
+    }
+    dlist_add(DLIST_OP_VLINE, (int16_t)x, (int16_t)y, 1, (int16_t)h, NULL);
+}
+
+void app_dlist_set_font(u8g2_t *u8g2, const uint8_t *font)
+{
+    Dlist_Cmd_t *cmd;
+
+    (u8g2_SetFont)(u8g2, font);
+    if (dlist_recording && (cmd = dlist_add(DLIST_OP_FONT, 0, 0, 0, 0, NULL)) != NULL) {
+        cmd->arg.ptr = font;
+    }
+}
+
+void app_dlist_set_draw_color(u8g2_t *u8g2, uint8_t color)
+{
+    (u8g2_SetDrawColor)(u8g2, color);
+    if (dlist_recording) {
+        dlist_add(DLIST_OP_COLOR, color, 0, 0, 0, NULL);
+    }
+}
+
+void app_dlist_set_clip_window(u8g2_t *u8g2, u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t x1, u8g2_uint_t y1)
+{
+    (u8g2_SetClipWindow)(u8g2, x0, y0, x1, y1);
+    if (dlist_recording) {
+        dlist_add(DLIST_OP_CLIP, (int16_t)x0, (int16_t)y0, (int16_t)x1, (int16_t)y1, NULL);
+    }
+}
+
+void app_dlist_set_max_clip_window(u8g2_t *u8g2)
+{
+    (u8g2_SetMaxClipWindow)(u8g2);
+    if (dlist_recording) {
+        dlist_add(DLIST_OP_CLIP_MAX, 0, 0, 0, 0, NULL);
+    }
+}
+
+/** @} */
+
+#endif /* APP_DLIST_ACTIVE */
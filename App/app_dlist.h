@@ -0,0 +1,181 @@
+/**
+ * @file      app_dlist.h
+ * @brief     分页模式下的绘图命令录制与回放头文件
+ * @details   分页显存模式 (U8G2_BUFFER_MODE 为 1/2) 下每个条带都要把页面完整地绘制一遍，
+ *            页面 draw 中的格式化、插值、宽度测量和分支判断每帧重复 8 次 (或 4 次)。
+ *            开启 APP_DLIST_ENABLE 后，页面管理器在一帧开始时把 draw 执行一次并录制成绘图命令
+ *            (字符串、矩形、线段、位图等)，之后每个条带只回放与该条带相交的命令，
+ *            draw 的执行次数与条带数无关。
+ *
+ *            录制对页面透明：本头文件由 app_display.h 包含，开启后把页面代码中的 u8g2 绘图函数
+ *            替换为同名参数的 app_dlist_* 函数，不在录制时直接调用 u8g2，录制时只记录命令。
+ *            字体、绘图颜色和裁剪窗口在录制时照常设置 (页面要用它们测量文字宽度和保存裁剪窗口)，
+ *            同时也记录下来在回放时重新设置。直接写显存的函数 (字形缓存、数值滚动位图、
+ *            Page_Invert_Rect、Page_Draw_Tiles) 在录制时调用本模块的 app_dlist_add_* 记录命令。
+ *            字符串的内容复制到命令区中，页面可以继续使用栈上的缓冲区。
+ *
+ *            命令区的容量不足时该页面的录制作废，这一帧退回为逐条带执行 draw，画面不受影响。
+ *            整帧模式下不需要录制，本模块不参与编译。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_DLIST_H
+#define __APP_DLIST_H
+
+#include "u8g2.h"
+#include "u8g2_stm32_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppDList 绘图命令录制
+ * @brief 把页面的一次 draw 录制成命令，按条带回放。
+ * @{
+ */
+
+/**
+ * @defgroup AppDList_Config 绘图命令录制配置
+ * @{
+ */
+#ifndef APP_DLIST_ENABLE
+#define APP_DLIST_ENABLE 0 ///< 为1时在分页模式下录制并回放页面的绘图命令 (整帧模式下无效)
+#endif
+#define APP_DLIST_ARENA_SIZE 512 ///< 命令区大小 (字节)，切换动画中两个页面共用，每条命令约 20 字节加字符串长度
+/** @} */
+
+/** @brief 本模块是否生效 (只在分页模式下) */
+#define APP_DLIST_ACTIVE (APP_DLIST_ENABLE && U8G2_BUFFER_MODE != 0)
+
+#if APP_DLIST_ACTIVE
+
+/**
+ * @brief 一个页面录制得到的命令段
+ */
+typedef struct {
+    uint16_t begin; ///< 第一条命令在命令区中的偏移
+    uint16_t end;   ///< 最后一条命令之后的偏移
+} App_DList_Seg_t;
+
+/**
+ * @brief 直接写显存的位图绘制函数，回放时以录制时的参数调用
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 位图左端X坐标
+ * @param[in] top 位图顶端Y坐标
+ */
+typedef void (*App_DList_Blit_t)(u8g2_t *u8g2, int16_t x, int16_t top);
+
+/**
+ * @brief 清空命令区，每帧录制前调用
+ * @return 无
+ */
+void app_dlist_reset(void);
+
+/**
+ * @brief 开始录制，之后的绘图调用只记录命令
+ * @return 无
+ */
+void app_dlist_record_begin(void);
+
+/**
+ * @brief 结束录制
+ * @param[out] seg 录制得到的命令段
+ * @return bool 录制完整返回 true；命令区不足时返回 false，该段不能回放
+ */
+bool app_dlist_record_end(App_DList_Seg_t *seg);
+
+/**
+ * @brief 查询是否正在录制
+ * @return bool 正在录制返回 true
+ */
+bool app_dlist_recording(void);
+
+/**
+ * @brief 回放一个命令段
+ * @details 状态命令 (字体、颜色、裁剪窗口) 全部执行，绘图命令只执行影响范围与 y0~y1 相交的。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] seg 命令段
+ * @param[in] y0 当前条带的上边界 (包含)
+ * @param[in] y1 当前条带的下边界 (不包含)
+ * @return 无
+ */
+void app_dlist_replay(u8g2_t *u8g2, const App_DList_Seg_t *seg, int16_t y0, int16_t y1);
+
+/**
+ * @name 录制直接写显存的绘制
+ * @details 只在 app_dlist_recording() 为 true 时调用，回放时以相同参数调用原函数。
+ * @{
+ */
+/**
+ * @brief 录制一次 Glyph_Cache_DrawStr
+ * @return u8g2_uint_t 字符串的步进宽度 (与实际绘制的返回值相同)
+ */
+u8g2_uint_t app_dlist_add_cached_str(u8g2_t *u8g2, int16_t x, int16_t y, const char *str);
+/**
+ * @brief 录制一次 Glyph_Cache_DrawStr_Scaled，top 和 h 为缩放后位图的顶端和高度
+ * @return 无
+ */
+void app_dlist_add_scaled_str(int16_t x, int16_t y, const char *str, uint32_t scale, int16_t top, int16_t h);
+/**
+ * @brief 录制一次 Page_Invert_Rect
+ * @return 无
+ */
+void app_dlist_add_invert(int16_t x, int16_t y, int16_t w, int16_t h);
+/**
+ * @brief 录制一次位图绘制，位图须保持不变直到这一帧的回放结束
+ * @param[in] fn 绘制函数
+ * @param[in] x 位图左端X坐标
+ * @param[in] top 位图顶端Y坐标
+ * @param[in] h 位图高度
+ * @return 无
+ */
+void app_dlist_add_blit(App_DList_Blit_t fn, int16_t x, int16_t top, int16_t h);
+/**
+ * @brief 录制一次 Page_Draw_Tiles，位图须保持不变直到这一帧的回放结束
+ * @return 无
+ */
+void app_dlist_add_tiles(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *tiles);
+/** @} */
+
+/**
+ * @name 可录制的 u8g2 函数
+ * @details 参数和返回值与同名的 u8g2 函数相同，不在录制时直接调用 u8g2。
+ *          录制时绘制字符串返回的步进宽度由字体计算，与实际绘制的结果相同。
+ * @{
+ */
+u8g2_uint_t app_dlist_draw_str(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str);
+u8g2_uint_t app_dlist_draw_utf8(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str);
+u8g2_uint_t app_dlist_draw_glyph(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, uint16_t encoding);
+void app_dlist_draw_box(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h);
+void app_dlist_draw_frame(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h);
+void app_dlist_draw_hline(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w);
+void app_dlist_draw_vline(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t h);
+void app_dlist_set_font(u8g2_t *u8g2, const uint8_t *font);
+void app_dlist_set_draw_color(u8g2_t *u8g2, uint8_t color);
+void app_dlist_set_clip_window(u8g2_t *u8g2, u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t x1, u8g2_uint_t y1);
+void app_dlist_set_max_clip_window(u8g2_t *u8g2);
+/** @} */
+
+/*
+ * 页面代码中的 u8g2 绘图调用改为可录制的版本。本模块自身用 (u8g2_DrawStr)(...) 的写法调用原函数，
+ * 不受这些宏影响；不包含 app_display.h 的驱动层代码也不受影响。
+ */
+#define u8g2_DrawStr(u8g2, x, y, str)               app_dlist_draw_str(u8g2, x, y, str)
+#define u8g2_DrawUTF8(u8g2, x, y, str)              app_dlist_draw_utf8(u8g2, x, y, str)
+#define u8g2_DrawGlyph(u8g2, x, y, encoding)        app_dlist_draw_glyph(u8g2, x, y, encoding)
+#define u8g2_DrawBox(u8g2, x, y, w, h)              app_dlist_draw_box(u8g2, x, y, w, h)
+#define u8g2_DrawFrame(u8g2, x, y, w, h)            app_dlist_draw_frame(u8g2, x, y, w, h)
+#define u8g2_DrawHLine(u8g2, x, y, w)               app_dlist_draw_hline(u8g2, x, y, w)
+#define u8g2_DrawVLine(u8g2, x, y, h)               app_dlist_draw_vline(u8g2, x, y, h)
+#define u8g2_SetFont(u8g2, font)                    app_dlist_set_font(u8g2, font)
+#define u8g2_SetDrawColor(u8g2, color)              app_dlist_set_draw_color(u8g2, color)
+#define u8g2_SetClipWindow(u8g2, x0, y0, x1, y1)    app_dlist_set_clip_window(u8g2, x0, y0, x1, y1)
+#define u8g2_SetMaxClipWindow(u8g2)                 app_dlist_set_max_clip_window(u8g2)
+
+#endif /* APP_DLIST_ACTIVE */
+
+/** @} */
+
+#endif /* __APP_DLIST_H */
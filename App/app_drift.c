@@ -0,0 +1,254 @@
+/**
+ * @file      app_drift.c
+ * @brief     DS3231 走时漂移估计与老化偏移修正
+ * @details   每次对时后芯片与参考时间一致，下一次对时前测得的误差就是这段时间内的漂移。
+ *            把各次误差累加起来，得到"如果从未对时"的累计误差 y 随时间 x 的变化，
+ *            其斜率即频率偏差。拟合使用 64 位整数的最小二乘，x 以分钟为单位以免溢出。
+ *            日志格式 (60字节)：| 魔法数 (4) | 参考时间 x8 (32) | 累计误差 x8 (16) | 条数 (1) | 老化偏移 (1) | 保留 (2) | CRC-32 (4) |，
+ *            RAM 副本就是 app_persist 镜像中的区域。旧版本写入的日志在保留的位置是 CRC-16，读取时同样接受。
+ * @author    SandOcean
+ * @date      2025-09-24
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_drift.h"
+#include "app_persist.h"
+#include "eeprom_bd.h"
+#include <stddef.h> // For offsetof
+#include <string.h>
+
+/**
+ * @addtogroup AppDrift
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define DRIFT_LOG_MAGIC 0x44524654U ///< 日志的魔法数 ("DRFT")
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 保存在 EEPROM 中的漂移日志
+ */
+typedef struct {
+    uint32_t magic;                      ///< 魔法数，固定为 DRIFT_LOG_MAGIC
+    Epoch_t ref[APP_DRIFT_POINTS];       ///< 各次对时的参考时间
+    int16_t error[APP_DRIFT_POINTS];     ///< 各次对时时的累计误差 (秒，芯片减参考)，第一条恒为0
+    uint8_t count;                       ///< 有效记录数
+    int8_t aging;                        ///< 最近一次写入芯片的老化偏移
+    uint16_t legacy_crc;                 ///< 旧版本日志的 CRC-16/CCITT (新日志中保留为0)
+    uint32_t crc;                        ///< 前面所有字段的 CRC-32
+} Drift_Log_t;
+
+/** 编译期检查：日志必须放得进预留的两页 */
+typedef char drift_log_size_check[(sizeof(Drift_Log_t) <= APP_DRIFT_LOG_SIZE) ? 1 : -1];
+
+/* Private variables ---------------------------------------------------------*/
+static Drift_Log_t *const drift_log = APP_PERSIST_MIRROR(Drift_Log_t, APP_DRIFT_BASE_ADDR); ///< 日志的RAM副本
+static bool drift_loaded;                ///< 日志是否已校验 (读取失败或无效时为空日志)
+static volatile bool drift_dirty;        ///< 日志有改动尚未保存
+static volatile bool drift_saving;       ///< 是否有刷新在进行
+
+/* Private function prototypes -----------------------------------------------*/
+static void drift_load(void);
+static void drift_save_cb(HAL_StatusTypeDef status, void *ctx);
+static void drift_try_save(void);
+static void drift_restart(Epoch_t ref);
+static void drift_append(Epoch_t ref, int32_t error);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 持久区读取完成后校验日志
+ * @details 读取失败、魔法数或 CRC 不对 (首次使用或写入被打断) 时从空日志开始。
+ * @return 无
+ */
+static void drift_load(void)
+{
+    App_Persist_State_e state = app_persist_state();
+
+    if (state != APP_PERSIST_READY && state != APP_PERSIST_FAILED) {
+        return;
+    }
+    if (state != APP_PERSIST_READY || drift_log->magic != DRIFT_LOG_MAGIC || drift_log->count > APP_DRIFT_POINTS ||
+        !app_persist_verify(drift_log, offsetof(Drift_Log_t, crc), offsetof(Drift_Log_t, legacy_crc))) {
+        memset(drift_log, 0, sizeof(*drift_log));
+    }
+    drift_log->legacy_crc = 0;
+    drift_loaded = true;
+}
+
+/**
+ * @brief 保存的完成回调 (I2C中断上下文)
+ * @param[in] status 写任务结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void drift_save_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+
+    if (status != HAL_OK) {
+        drift_dirty = true; // 由 app_drift_service() 重试
+    }
+    drift_saving = false;
+}
+
+/**
+ * @brief 日志有改动时尝试启动保存
+ * @details 写入块设备的缓存后启动刷新，只有内容变化的字节才会写出。其他模块的刷新正在进行时
+ *          保留改动标志，下次重试时缓存已与新内容一致，不会重复写入。
+ * @return 无
+ */
+static void drift_try_save(void)
+{
+    if (!drift_dirty || drift_saving) {
+        return;
+    }
+    drift_log->magic = DRIFT_LOG_MAGIC;
+    drift_log->crc = app_persist_crc(drift_log, offsetof(Drift_Log_t, crc));
+
+    drift_saving = true;
+    drift_dirty = false;
+    if (EEPROM_BD_Write(APP_DRIFT_BASE_ADDR, drift_log, sizeof(Drift_Log_t)) != HAL_OK ||
+        EEPROM_BD_Flush_Async(drift_save_cb, NULL) != HAL_OK) {
+        drift_saving = false;
+        drift_dirty = true;
+    }
+}
+
+/**
+ * @brief 以一次对时为起点重新开始记录
+ * @param[in] ref 对时的参考时间
+ * @return 无
+ */
+static void drift_restart(Epoch_t ref)
+{
+    drift_log->ref[0] = ref;
+    drift_log->error[0] = 0;
+    drift_log->count = 1;
+}
+
+/**
+ * @brief 追加一次对时的记录
+ * @details 日志已满时丢弃最旧的一条，并把累计误差整体平移使第一条仍为0 (不影响斜率)。
+ * @param[in] ref 对时的参考时间
+ * @param[in] error 本次对时前芯片的误差 (秒)
+ * @return 无
+ */
+static void drift_append(Epoch_t ref, int32_t error)
+{
+    int16_t total = (int16_t)(drift_log->error[drift_log->count - 1] + error);
+
+    if (drift_log->count == APP_DRIFT_POINTS) {
+        int16_t base = drift_log->error[1];
+        for (uint8_t i = 0; i + 1 < APP_DRIFT_POINTS; i++) {
+            drift_log->ref[i] = drift_log->ref[i + 1];
+            drift_log->error[i] = (int16_t)(drift_log->error[i + 1] - base);
+        }
+        total = (int16_t)(total - base);
+        drift_log->count--;
+    }
+    drift_log->ref[drift_log->count] = ref;
+    drift_log->error[drift_log->count] = total;
+    drift_log->count++;
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 漂移修正维护函数，需在主循环中周期调用
+ * @return 无
+ */
+void app_drift_service(void)
+{
+    if (!drift_loaded) {
+        drift_load();
+    }
+    drift_try_save();
+}
+
+/**
+ * @brief 按当前日志估计芯片的频率偏差
+ * @details 斜率 = (nΣxy - ΣxΣy) / (nΣx² - (Σx)²)，x 为分钟、y 为秒，
+ *          换算到 0.1ppm 时再乘以 10^7/60 并四舍五入。
+ * @param[out] ppm_x10 频率偏差，单位0.1ppm，正值表示走快
+ * @return bool 记录条数或跨度不足时返回 false
+ */
+bool app_drift_estimate(int16_t *ppm_x10)
+{
+    uint8_t n = drift_log->count;
+    int64_t sx = 0, sy = 0, sxx = 0, sxy = 0;
+    int64_t num, den, q;
+
+    if (!drift_loaded || n < APP_DRIFT_MIN_POINTS || drift_log->ref[n - 1] - drift_log->ref[0] < APP_DRIFT_MIN_SPAN_S) {
+        return false;
+    }
+    for (uint8_t i = 0; i < n; i++) {
+        int64_t x = (drift_log->ref[i] - drift_log->ref[0]) / 60;
+        int64_t y = drift_log->error[i];
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    num = (n * sxy - sx * sy) * 10000000LL;
+    den = (n * sxx - sx * sx) * 60;
+    if (den <= 0) {
+        return false;
+    }
+    q = (num >= 0) ? (num + den / 2) / den : (num - den / 2) / den;
+    if (q > INT16_MAX) {
+        q = INT16_MAX;
+    } else if (q < INT16_MIN) {
+        q = INT16_MIN;
+    }
+    *ppm_x10 = (int16_t)q;
+    return true;
+}
+
+/**
+ * @brief 时间被设置的回调，记录对时误差并在需要时修正老化偏移
+ * @details 覆盖 DS3231.c 中的弱定义。误差过大、参考时间倒退或日志为空时视为手动调整，
+ *          以本次对时为起点重新记录。修正写入芯片后同样重新记录，之前的误差属于旧的老化偏移。
+ * @param[in] rtc_before 写入前芯片的时间 (纪元秒)
+ * @param[in] ref 写入的新时间 (纪元秒)
+ * @return 无
+ */
+void DS3231_TimeSetCallback(Epoch_t rtc_before, Epoch_t ref)
+{
+    int32_t error = (int32_t)(rtc_before - ref);
+    int16_t ppm_x10;
+    int8_t aging;
+
+    if (!drift_loaded) {
+        return;
+    }
+
+    if (drift_log->count == 0 || ref < drift_log->ref[drift_log->count - 1] ||
+        error > APP_DRIFT_MAX_ERROR_S || error < -APP_DRIFT_MAX_ERROR_S) {
+        drift_restart(ref);
+    } else {
+        drift_append(ref, error);
+
+        // 老化偏移每 LSB 约 0.1ppm，走快 (误差为正) 时增大偏移使振荡器变慢
+        if (app_drift_estimate(&ppm_x10) && ppm_x10 != 0 && DS3231_GetAgingOffset(&aging) == HAL_OK) {
+            int16_t next = (int16_t)(aging + ppm_x10);
+            if (next > INT8_MAX) {
+                next = INT8_MAX;
+            } else if (next < INT8_MIN) {
+                next = INT8_MIN;
+            }
+            if (next != aging && DS3231_SetAgingOffset((int8_t)next) == HAL_OK) {
+                drift_log->aging = (int8_t)next;
+                drift_restart(ref);
+            }
+        }
+    }
+
+    drift_dirty = true;
+    drift_try_save();
+}
+
+/** @} */
@@ -0,0 +1,57 @@
+/**
+ * @file      app_drift.h
+ * @brief     DS3231 走时漂移估计与老化偏移修正头文件
+ * @details   每次通过 DS3231_SetTime() 或 DS3231_SetTimeSync() 对时，记录 (参考时间, 对时前芯片的误差)。
+ *            误差累加后对时间做整数最小二乘拟合，斜率即为芯片的频率偏差 (ppm)，
+ *            记录跨度足够长时把它换算为老化偏移 (1 LSB 约 0.1ppm) 写入 DS3231 的 0x10 寄存器，
+ *            之后重新开始记录。日志保存在 AT24C32 的最后两页，与 app_store 的槽位分开。
+ * @author    SandOcean
+ * @date      2025-09-24
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_DRIFT_H
+#define __APP_DRIFT_H
+
+#include "main.h"
+#include "DS3231.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppDrift 漂移修正
+ * @brief 根据历次对时的误差自动修正 DS3231 的老化偏移。
+ * @{
+ */
+
+/**
+ * @defgroup AppDrift_Config 漂移修正配置
+ * @{
+ */
+#define APP_DRIFT_BASE_ADDR   0x0FC0             ///< 日志在 AT24C32 中的地址 (最后两页，紧接 app_alarm 的闹钟表)
+#define APP_DRIFT_LOG_SIZE    64                 ///< 日志占用的字节数
+#define APP_DRIFT_POINTS      8                  ///< 日志保存的对时记录数，写满后丢弃最旧的一条
+#define APP_DRIFT_MIN_POINTS  3                  ///< 开始修正前至少需要的记录数
+#define APP_DRIFT_MIN_SPAN_S  (14UL * 86400UL)   ///< 开始修正前记录至少跨越的时间 (1秒的分辨率下约 0.8ppm)
+#define APP_DRIFT_MAX_ERROR_S 60                 ///< 误差超过该值的对时视为手动调整，重新开始记录
+/** @} */
+
+/**
+ * @brief 漂移修正维护函数，需在主循环中周期调用
+ * @details 启动时 app_persist 的读取完成后校验日志，之前的对时不参与估计；
+ *          日志有改动而 EEPROM 写任务正忙 (如正在保存设置) 时，在这里重试保存。
+ * @return 无
+ */
+void app_drift_service(void);
+
+/**
+ * @brief 按当前日志估计芯片的频率偏差
+ * @param[out] ppm_x10 频率偏差，单位0.1ppm，正值表示走快
+ * @return bool 记录不足以估计时返回 false
+ */
+bool app_drift_estimate(int16_t *ppm_x10);
+
+/** @} */
+
+#endif /* __APP_DRIFT_H */
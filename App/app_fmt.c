@@ -0,0 +1,137 @@
+/**
+ * @file      app_fmt.c
+ * @brief     轻量级整数格式化函数库
+ * @details   Cortex-M3 有硬件除法，逐位取余即可；两位数不经过临时缓冲区，直接写入两个字符。
+ * @author    SandOcean
+ * @date      2025-09-23
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_fmt.h"
+
+/**
+ * @addtogroup AppFmt
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define FMT_UINT_MAX_DIGITS 10 ///< uint32_t 的最大十进制位数
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 输出无符号整数，不足 min_digits 位时在前面补零
+ * @param[out] dst 输出缓冲区
+ * @param[in] value 数值
+ * @param[in] min_digits 最少位数
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+char *fmt_uint(char *dst, uint32_t value, uint8_t min_digits)
+{
+    char tmp[FMT_UINT_MAX_DIGITS];
+    uint8_t n = 0;
+
+    if (min_digits > FMT_UINT_MAX_DIGITS) {
+        min_digits = FMT_UINT_MAX_DIGITS;
+    }
+
+    // 从低位到高位写入临时缓冲区，再倒序拷贝
+    do {
+        tmp[n++] = (char)('0' + value % 10U);
+        value /= 10U;
+    } while (value != 0U);
+    while (n < min_digits) {
+        tmp[n++] = '0';
+    }
+    while (n > 0) {
+        *dst++ = tmp[--n];
+    }
+    *dst = '\0';
+    return dst;
+}
+
+/**
+ * @brief 输出两位补零的整数
+ * @param[out] dst 输出缓冲区
+ * @param[in] value 数值
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+char *fmt_u2(char *dst, uint16_t value)
+{
+    if (value >= 100U) {
+        return fmt_uint(dst, value, 2);
+    }
+    dst[0] = (char)('0' + value / 10U);
+    dst[1] = (char)('0' + value % 10U);
+    dst[2] = '\0';
+    return dst + 2;
+}
+
+/**
+ * @brief 输出四位补零的整数
+ * @param[out] dst 输出缓冲区
+ * @param[in] value 数值
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+char *fmt_u4(char *dst, uint16_t value)
+{
+    if (value >= 10000U) {
+        return fmt_uint(dst, value, 4);
+    }
+    fmt_u2(dst, value / 100U);
+    return fmt_u2(dst + 2, value % 100U);
+}
+
+/**
+ * @brief 输出一位小数的定点数
+ * @param[out] dst 输出缓冲区
+ * @param[in] tenths 以 0.1 为单位的数值
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+char *fmt_q1(char *dst, int32_t tenths)
+{
+    uint32_t abs_val;
+
+    if (tenths < 0) {
+        *dst++ = '-';
+        abs_val = (uint32_t)(-(int64_t)tenths);
+    } else {
+        abs_val = (uint32_t)tenths;
+    }
+    dst = fmt_uint(dst, abs_val / 10U, 1);
+    dst[0] = '.';
+    dst[1] = (char)('0' + abs_val % 10U);
+    dst[2] = '\0';
+    return dst + 2;
+}
+
+/**
+ * @brief 输出一个字符
+ * @param[out] dst 输出缓冲区
+ * @param[in] c 字符
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+char *fmt_char(char *dst, char c)
+{
+    dst[0] = c;
+    dst[1] = '\0';
+    return dst + 1;
+}
+
+/**
+ * @brief 输出一个字符串
+ * @param[out] dst 输出缓冲区
+ * @param[in] s 字符串
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+char *fmt_str(char *dst, const char *s)
+{
+    while (*s) {
+        *dst++ = *s++;
+    }
+    *dst = '\0';
+    return dst;
+}
+
+/** @} */
@@ -0,0 +1,82 @@
+/**
+ * @file      app_fmt.h
+ * @brief     轻量级整数格式化函数库头文件
+ * @details   界面刷新路径上只需要定长补零的整数和一位小数的定点数，
+ *            用这几个函数代替 sprintf，不链接 C 库的 printf 实现，每次格式化也只需几十个周期。
+ *            所有函数都在输出末尾写入 '\0'，并返回指向该 '\0' 的指针，便于连续拼接：
+ *            @code
+ *            char *p = fmt_u2(buf, hour);
+ *            p = fmt_char(p, ':');
+ *            p = fmt_u2(p, minute);
+ *            @endcode
+ *            调用者负责保证缓冲区足够大。
+ * @author    SandOcean
+ * @date      2025-09-23
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_FMT_H
+#define __APP_FMT_H
+
+#include <stdint.h>
+
+/**
+ * @defgroup AppFmt 整数格式化
+ * @brief 提供了不依赖 printf 的数字格式化功能。
+ * @{
+ */
+
+/**
+ * @brief 输出无符号整数，不足 min_digits 位时在前面补零
+ * @param[out] dst 输出缓冲区
+ * @param[in] value 数值
+ * @param[in] min_digits 最少位数 (0 与 1 相同)
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+char *fmt_uint(char *dst, uint32_t value, uint8_t min_digits);
+
+/**
+ * @brief 输出两位补零的整数 (相当于 "%02u")，用于时、分、秒、月、日
+ * @param[out] dst 输出缓冲区，至少3字节
+ * @param[in] value 数值，超过99时按实际位数输出
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+char *fmt_u2(char *dst, uint16_t value);
+
+/**
+ * @brief 输出四位补零的整数 (相当于 "%04u")，用于年份
+ * @param[out] dst 输出缓冲区，至少5字节
+ * @param[in] value 数值
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+char *fmt_u4(char *dst, uint16_t value);
+
+/**
+ * @brief 输出一位小数的定点数
+ * @details 数值以 0.1 为单位，例如 -53 输出 "-5.3"，7 输出 "0.7"。
+ * @param[out] dst 输出缓冲区
+ * @param[in] tenths 以 0.1 为单位的数值
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+char *fmt_q1(char *dst, int32_t tenths);
+
+/**
+ * @brief 输出一个字符
+ * @param[out] dst 输出缓冲区
+ * @param[in] c 字符
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+char *fmt_char(char *dst, char c);
+
+/**
+ * @brief 输出一个字符串 (不含结尾的 '\0')
+ * @param[out] dst 输出缓冲区
+ * @param[in] s 字符串
+ * @return char* 指向输出末尾 '\0' 的指针
+ */
+char *fmt_str(char *dst, const char *s);
+
+/** @} */
+
+#endif /* __APP_FMT_H */
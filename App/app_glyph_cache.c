@@ -0,0 +1,650 @@
+/**
+ * @file      app_glyph_cache.c
+ * @brief     大号数字字形缓存
+ * @details   字形按 u8g2 字体格式自行解码 (字形头的位域 + 0/1 游程编码)，解码结果按列存放：
+ *            SSD1306 的显存每字节是竖直方向的8个像素，一列32位字右移/左移后正好落在各页的字节上，
+ *            每列每页只需一次读改写。只支持 U8G2_R0 方向 (显存为 vertical_top_lsb 布局)。
+ *            同一字体的各字形都以字体的数字外框顶端为第0行存放，外框顶端落在页边界上时
+ *            所有字形都不需要移位，整字节可见的页直接写入，不读取显存。
+ *            字体按第一次使用的顺序依次占用共用列池，缓存的字体不会被换出。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.3
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_glyph_cache.h"
+#include "app_dlist.h"
+#include <string.h>
+
+/**
+ * @addtogroup GlyphCache
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define GLYPH_FIRST    '0'                        ///< 第一个缓存的字符
+#define GLYPH_COUNT    11                         ///< '0'~'9' 和 ':' (':' 紧跟在 '9' 之后)
+#define GLYPH_INDEX(c) ((uint8_t)((c) - GLYPH_FIRST)) ///< 字符到缓存下标
+#define GLYPH_COLS(f, g) (&glyph_pool[(f)->base + (g)->col]) ///< 字形位图的第一列
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 一个已解码的字形
+ */
+typedef struct {
+    uint8_t col;     ///< 位图在字体所占列池中的起始列
+    uint8_t width;   ///< 位图宽度，0 表示空白字形
+    uint8_t height;  ///< 位图高度
+    int8_t x_off;    ///< 位图左端相对于光标的偏移
+    int8_t y_top;    ///< 位图顶端相对于基线的偏移 (向上为负)
+    int8_t advance;  ///< 光标步进宽度
+} Glyph_t;
+
+/**
+ * @brief 一个字体的缓存
+ */
+typedef struct {
+    const uint8_t *font;                    ///< 字体，NULL 表示空槽
+    bool usable;                            ///< 解码是否成功，失败的字体也占一个槽以免反复解码
+    int8_t top;                             ///< 数字外框 (各字形位图的并集) 顶端相对于基线的偏移，即各列 bit0 所在的行
+    uint8_t height;                         ///< 数字外框的高度
+    uint16_t base;                          ///< 字体在共用列池中的起始列
+    Glyph_t glyph[GLYPH_COUNT];             ///< 各字形
+} Glyph_Font_t;
+
+/**
+ * @brief 字形数据的位读取器 (u8g2 字体按字节内低位在前的顺序打包)
+ */
+typedef struct {
+    const uint8_t *ptr; ///< 当前字节
+    uint8_t bit;        ///< 当前字节中已读的位数
+} Bit_Reader_t;
+
+/* Private variables ---------------------------------------------------------*/
+static Glyph_Font_t glyph_fonts[GLYPH_CACHE_FONTS];
+static uint32_t glyph_pool[GLYPH_CACHE_POOL_TOTAL]; ///< 共用列池，每列一个字，bit0 为最上一行
+static uint16_t glyph_pool_used;                   ///< 列池中已分配的列数
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t read_bits(Bit_Reader_t *r, uint8_t cnt);
+static int8_t read_signed_bits(Bit_Reader_t *r, uint8_t cnt);
+static bool decode_glyph(u8g2_t *u8g2, Glyph_Font_t *f, uint8_t index, uint8_t *next_col);
+static Glyph_Font_t *find_font(u8g2_t *u8g2);
+static bool str_cached(const char *str);
+static void blit_cols(u8g2_t *u8g2, const uint32_t *cols, uint8_t width, uint8_t r0, uint8_t r1, int16_t x, int16_t top);
+static uint32_t row_bits(int16_t r0, int16_t r1);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 读取无符号位域
+ * @param[in,out] r 读取器
+ * @param[in] cnt 位数 (不超过8)
+ * @return uint8_t 位域的值
+ */
+static uint8_t read_bits(Bit_Reader_t *r, uint8_t cnt)
+{
+    uint16_t val = (uint16_t)(r->ptr[0] >> r->bit);
+    uint8_t end = r->bit + cnt;
+
+    if (end >= 8) {
+        r->ptr++;
+        if (end > 8) {
+            val |= (uint16_t)r->ptr[0] << (8 - r->bit);
+        }
+        end -= 8;
+    }
+    r->bit = end;
+    return (uint8_t)(val & ((1U << cnt) - 1U));
+}
+
+/**
+ * @brief 读取有符号位域 (u8g2 以偏移 2^(cnt-1) 存储)
+ * @param[in,out] r 读取器
+ * @param[in] cnt 位数
+ * @return int8_t 位域的值
+ */
+static int8_t read_signed_bits(Bit_Reader_t *r, uint8_t cnt)
+{
+    return (int8_t)((int16_t)read_bits(r, cnt) - (int16_t)(1 << (cnt - 1)));
+}
+
+/**
+ * @brief 解码当前字体中的一个字形到列池
+ * @details 字形头依次为宽、高、X偏移、Y偏移、步进宽度，之后是若干组
+ *          (a 个背景像素, b 个前景像素, 是否重复) 的游程，按行从上到下、从左到右填充。
+ * @param[in] u8g2 指向u8g2实例的指针 (当前字体即被缓存的字体)
+ * @param[in,out] f 字体缓存
+ * @param[in] index 字形下标
+ * @param[in,out] next_col 字体的下一个空闲列 (相对 f->base)
+ * @return bool 成功返回 true；字形过大或列池不足返回 false
+ */
+static bool decode_glyph(u8g2_t *u8g2, Glyph_Font_t *f, uint8_t index, uint8_t *next_col)
+{
+    const u8g2_font_info_t *info = &u8g2->font_info;
+    const uint8_t *data = u8g2_font_get_glyph_data(u8g2, GLYPH_FIRST + index);
+    Glyph_t *g = &f->glyph[index];
+    Bit_Reader_t r;
+    uint8_t w, h, lx = 0, ly = 0;
+
+    if (data == NULL) {
+        return false;
+    }
+
+    r.ptr = data;
+    r.bit = 0;
+    w = read_bits(&r, info->bits_per_char_width);
+    h = read_bits(&r, info->bits_per_char_height);
+    g->x_off = read_signed_bits(&r, info->bits_per_char_x);
+    g->y_top = (int8_t)(-(int16_t)(h + read_signed_bits(&r, info->bits_per_char_y)));
+    g->advance = read_signed_bits(&r, info->bits_per_delta_x);
+    g->width = w;
+    g->height = h;
+    g->col = *next_col;
+
+    if (w == 0) {
+        return true;
+    }
+    if (h > GLYPH_CACHE_MAX_HEIGHT || (uint16_t)*next_col + w > GLYPH_CACHE_POOL_COLS ||
+        f->base + *next_col + w > GLYPH_CACHE_POOL_TOTAL) {
+        return false;
+    }
+
+    uint32_t *cols = GLYPH_COLS(f, g);
+    memset(cols, 0, w * sizeof(uint32_t));
+    *next_col += w;
+
+    while (ly < h) {
+        uint8_t a = read_bits(&r, info->bits_per_0);
+        uint8_t b = read_bits(&r, info->bits_per_1);
+        do {
+            for (uint8_t n = 0; n < a + b; n++) {
+                if (n >= a && ly < h) {
+                    cols[lx] |= 1UL << ly;
+                }
+                if (++lx == w) {
+                    lx = 0;
+                    ly++;
+                }
+            }
+        } while (read_bits(&r, 1) != 0);
+    }
+    return true;
+}
+
+/**
+ * @brief 查找当前字体的缓存，不存在时新建
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @return Glyph_Font_t* 可用的缓存；字体不可缓存或缓存已满时返回 NULL
+ */
+static Glyph_Font_t *find_font(u8g2_t *u8g2)
+{
+    Glyph_Font_t *f;
+    uint8_t next_col = 0;
+
+    for (uint8_t i = 0; i < GLYPH_CACHE_FONTS; i++) {
+        f = &glyph_fonts[i];
+        if (f->font == u8g2->font) {
+            return f->usable ? f : NULL;
+        }
+        if (f->font == NULL) {
+            break;
+        }
+    }
+    if (f->font != NULL) {
+        return NULL; // 缓存已满
+    }
+
+    f->font = u8g2->font;
+    f->usable = false;
+    f->base = glyph_pool_used;
+    for (uint8_t i = 0; i < GLYPH_COUNT; i++) {
+        if (!decode_glyph(u8g2, f, i, &next_col)) {
+            return NULL; // 已解码的列没有计入 glyph_pool_used，留给下一个字体
+        }
+    }
+
+    // 数字外框，各字形的列移到以外框顶端为第0行
+    int16_t top = 0;
+    int16_t bottom = 0;
+    bool first = true;
+    for (uint8_t i = 0; i < GLYPH_COUNT; i++) {
+        const Glyph_t *g = &f->glyph[i];
+        if (g->width && (first || g->y_top < top)) {
+            top = g->y_top;
+        }
+        if (g->width && (first || g->y_top + g->height > bottom)) {
+            bottom = g->y_top + g->height;
+        }
+        first = first && !g->width;
+    }
+    if (bottom - top > GLYPH_CACHE_MAX_HEIGHT) {
+        return NULL;
+    }
+    for (uint8_t i = 0; i < GLYPH_COUNT; i++) {
+        const Glyph_t *g = &f->glyph[i];
+        uint32_t *cols = GLYPH_COLS(f, g);
+        for (uint8_t c = 0; c < g->width; c++) {
+            cols[c] <<= g->y_top - top;
+        }
+    }
+    f->top = (int8_t)top;
+    f->height = (uint8_t)(bottom - top);
+
+    glyph_pool_used += next_col;
+    f->usable = true;
+    return f;
+}
+
+/**
+ * @brief 判断字符串是否全部由缓存的字符组成
+ * @param[in] str 字符串
+ * @return bool 可以用缓存绘制返回 true
+ */
+static bool str_cached(const char *str)
+{
+    for (; *str; str++) {
+        if (GLYPH_INDEX(*str) >= GLYPH_COUNT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 把按列存放的位图写入显存
+ * @details 字形和缩放后的字符串共用。 可见区域取 u8g2 当前条带与裁剪窗口的交集 (user_x0/x1/y0/y1)。
+ *          非透明字体模式下，位图第 r0~r1 行范围内的背景像素按 u8g2 的规则画成相反的颜色。
+ *          位图顶端落在页边界上时每页正好是列字中的一个字节，非透明模式下整字节可见的页直接写入。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] cols 位图，每列一个字，bit0 为最上一行
+ * @param[in] width 位图宽度
+ * @param[in] r0 位图内容的第一行
+ * @param[in] r1 位图内容的最后一行之后 (不超过32)
+ * @param[in] x 位图左端X坐标
+ * @param[in] top 位图顶端 (第0行) 的Y坐标
+ * @return 无
+ */
+static void blit_cols(u8g2_t *u8g2, const uint32_t *cols, uint8_t width, uint8_t r0, uint8_t r1, int16_t x, int16_t top)
+{
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+    if (!u8g2->is_page_clip_window_intersection) {
+        return;
+    }
+#endif
+    int16_t y0 = (top + r0 > (int16_t)u8g2->user_y0) ? top + r0 : (int16_t)u8g2->user_y0;
+    int16_t y1 = (top + r1 < (int16_t)u8g2->user_y1) ? top + r1 : (int16_t)u8g2->user_y1;
+    int16_t c0 = ((int16_t)u8g2->user_x0 > x) ? (int16_t)u8g2->user_x0 - x : 0;
+    int16_t c1 = ((int16_t)u8g2->user_x1 < x + width) ? (int16_t)u8g2->user_x1 - x : width;
+    if (y0 >= y1 || c0 >= c1) {
+        return;
+    }
+
+    // 只保留可见的行
+    uint32_t row_mask = (0xFFFFFFFFUL >> (32 - (y1 - y0))) << (y0 - top);
+    uint8_t color = u8g2->draw_color;
+    bool solid = (u8g2->font_decode.is_transparent == 0);
+    int16_t rel = top - (int16_t)u8g2->pixel_curr_row;     // 位图顶端在绘图缓冲区中的行
+    bool store = solid && color != 2 && (rel & 7) == 0;    // 整字节可见的页可以直接写入
+    int16_t page0 = (y0 - (int16_t)u8g2->pixel_curr_row) >> 3;
+    int16_t page1 = (y1 - 1 - (int16_t)u8g2->pixel_curr_row) >> 3;
+    uint16_t stride = u8g2->pixel_buf_width;
+
+    for (int16_t c = c0; c < c1; c++) {
+        uint32_t fg = cols[c] & row_mask;
+        uint32_t bg = solid ? (row_mask & ~fg) : 0;
+        uint8_t *dst = u8g2->tile_buf_ptr + page0 * stride + x + c;
+
+        for (int16_t page = page0; page <= page1; page++, dst += stride) {
+            int16_t shift = page * 8 - rel;                 // 对齐时为8的倍数且不为负
+            if (store && (uint8_t)(row_mask >> shift) == 0xFF) {
+                *dst = (uint8_t)((color != 0) ? fg >> shift : ~(fg >> shift));
+                continue;
+            }
+            uint8_t fb = (uint8_t)(shift >= 0 ? fg >> shift : fg << -shift);
+            uint8_t bb = (uint8_t)(shift >= 0 ? bg >> shift : bg << -shift);
+
+            if (color == 0) {
+                *dst = (uint8_t)((*dst & ~fb) | bb);
+            } else if (color == 1) {
+                *dst = (uint8_t)((*dst | fb) & ~bb);
+            } else {
+                *dst = (uint8_t)((*dst ^ fb) & ~bb);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 列位图中第 r0 行到第 r1 行 (不包含) 的掩码
+ * @param[in] r0 起始行 (0~32)
+ * @param[in] r1 结束行 (r0~32)
+ * @return uint32_t 掩码
+ */
+static uint32_t row_bits(int16_t r0, int16_t r1)
+{
+    uint32_t upto = (r1 >= 32) ? 0xFFFFFFFFUL : ((1UL << r1) - 1);
+    uint32_t below = (r0 >= 32) ? 0xFFFFFFFFUL : ((1UL << r0) - 1);
+    return upto & ~below;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 用缓存绘制一个字符串
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 字符串左端X坐标
+ * @param[in] y 基线Y坐标
+ * @param[in] str 要绘制的字符串
+ * @return u8g2_uint_t 字符串的步进宽度
+ */
+u8g2_uint_t Glyph_Cache_DrawStr(u8g2_t *u8g2, int16_t x, int16_t y, const char *str)
+{
+    Glyph_Font_t *f = (u8g2->cb == U8G2_R0) ? find_font(u8g2) : NULL;
+    int16_t start = x;
+
+#if APP_DLIST_ACTIVE
+    if (app_dlist_recording()) {
+        return app_dlist_add_cached_str(u8g2, x, y, str);
+    }
+#endif
+    if (f == NULL || !str_cached(str)) {
+        return u8g2_DrawStr(u8g2, x, y, str);
+    }
+
+    for (; *str; str++) {
+        const Glyph_t *g = &f->glyph[GLYPH_INDEX(*str)];
+        if (g->width) {
+            uint8_t r0 = (uint8_t)(g->y_top - f->top);
+            blit_cols(u8g2, GLYPH_COLS(f, g), g->width, r0, (uint8_t)(r0 + g->height), x + g->x_off, y + f->top);
+        }
+        x += g->advance;
+    }
+    return (u8g2_uint_t)(x - start);
+}
+
+/**
+ * @brief 用缓存计算字符串的像素宽度
+ * @details 与 u8g2_GetStrWidth 的算法一致：各字形步进之和，最后一个字形改用其位图右端。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] str 字符串
+ * @return u8g2_uint_t 像素宽度
+ */
+u8g2_uint_t Glyph_Cache_GetStrWidth(u8g2_t *u8g2, const char *str)
+{
+    Glyph_Font_t *f = find_font(u8g2);
+    const Glyph_t *g = NULL;
+    int16_t w = 0;
+
+    if (f == NULL || !str_cached(str)) {
+        return u8g2_GetStrWidth(u8g2, str);
+    }
+
+    for (; *str; str++) {
+        g = &f->glyph[GLYPH_INDEX(*str)];
+        w += g->advance;
+    }
+    if (g && g->width) {
+        w += g->width + g->x_off - g->advance;
+    }
+    return (u8g2_uint_t)w;
+}
+
+/**
+ * @brief 获取已缓存字体的数字外框
+ * @param[in] font 字体
+ * @param[out] top 外框顶端相对于基线的偏移
+ * @param[out] height 外框高度
+ * @return bool 字体已缓存且可用时返回 true
+ */
+bool Glyph_Cache_Font_Box(const uint8_t *font, int8_t *top, uint8_t *height)
+{
+    for (uint8_t i = 0; i < GLYPH_CACHE_FONTS && glyph_fonts[i].font != NULL; i++) {
+        const Glyph_Font_t *f = &glyph_fonts[i];
+        if (f->font == font && f->usable) {
+            *top = f->top;
+            *height = f->height;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 把基线移到使外框顶端落在页边界上的最近位置
+ * @param[in] y 基线Y坐标
+ * @param[in] top 外框顶端相对于基线的偏移
+ * @return int16_t 移动后的基线Y坐标
+ */
+int16_t Glyph_Cache_Page_Baseline(int16_t y, int8_t top)
+{
+    int16_t rem = (int16_t)((y + top) & 7);
+
+    return (rem <= 4) ? (int16_t)(y - rem) : (int16_t)(y + 8 - rem);
+}
+
+/**
+ * @brief 把字符串按列光栅化到调用者的缓冲区
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] str 字符串
+ * @param[in] top 第0行相对于基线的偏移
+ * @param[out] cols 列缓冲区
+ * @param[in] max_cols 列缓冲区的容量
+ * @return int16_t 写入的列数，失败返回 -1
+ */
+int16_t Glyph_Cache_Rasterize(u8g2_t *u8g2, const char *str, int8_t top, uint32_t *cols, uint8_t max_cols)
+{
+    Glyph_Font_t *f = find_font(u8g2);
+    int16_t width;
+    int16_t x = 0;
+
+    if (f == NULL || !str_cached(str)) {
+        return -1;
+    }
+    width = (int16_t)Glyph_Cache_GetStrWidth(u8g2, str);
+    if (width > max_cols) {
+        return -1;
+    }
+    memset(cols, 0, (size_t)width * sizeof(uint32_t));
+
+    for (; *str; str++) {
+        const Glyph_t *g = &f->glyph[GLYPH_INDEX(*str)];
+        int16_t shift = f->top - top;
+
+        for (uint8_t c = 0; c < g->width; c++) {
+            int16_t dst = x + g->x_off + c;
+            uint32_t bits = GLYPH_COLS(f, g)[c];
+            if (dst < 0 || dst >= width || shift <= -32 || shift >= 32) {
+                continue;
+            }
+            cols[dst] |= (shift >= 0) ? bits << shift : bits >> -shift;
+        }
+        x += g->advance;
+    }
+    return width;
+}
+
+/**
+ * @brief 按比例缩放后绘制一个字符串
+ * @details 取样点取目标像素的中心，(d + 1/2) * 源尺寸 / 目标尺寸，源和目标的四边对齐。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 字符串左端X坐标
+ * @param[in] y 基线Y坐标
+ * @param[in] str 要绘制的字符串
+ * @param[in] scale 缩放比例 (Q16)
+ * @return int16_t 缩放后的像素宽度，失败返回 -1
+ */
+int16_t Glyph_Cache_DrawStr_Scaled(u8g2_t *u8g2, int16_t x, int16_t y, const char *str, uint32_t scale)
+{
+    Glyph_Font_t *f = (u8g2->cb == U8G2_R0) ? find_font(u8g2) : NULL;
+    uint32_t src[GLYPH_CACHE_SCALE_COLS];
+    uint32_t dst[GLYPH_CACHE_SCALE_COLS];
+    uint8_t col_map[GLYPH_CACHE_SCALE_COLS];
+    uint8_t row_map[32];
+    int16_t top = 0;
+    int16_t bottom = 0;
+    int16_t w, h, dw, dh;
+    uint32_t step;
+
+    if (f == NULL || !str_cached(str) || scale > 0x10000UL) {
+        return -1;
+    }
+
+    // 字符串位图的上下边界
+    for (const char *s = str; *s; s++) {
+        const Glyph_t *g = &f->glyph[GLYPH_INDEX(*s)];
+        if (g->width) {
+            if (g->y_top < top) {
+                top = g->y_top;
+            }
+            if (g->y_top + g->height > bottom) {
+                bottom = g->y_top + g->height;
+            }
+        }
+    }
+    h = bottom - top;
+    w = Glyph_Cache_Rasterize(u8g2, str, (int8_t)top, src, GLYPH_CACHE_SCALE_COLS);
+    if (w < 0 || h > 32) {
+        return -1;
+    }
+
+    dw = (int16_t)((w * scale + 0x8000UL) >> 16);
+    dh = (int16_t)((h * scale + 0x8000UL) >> 16);
+    if (dw == 0 || dh == 0) {
+        return dw;
+    }
+#if APP_DLIST_ACTIVE
+    if (app_dlist_recording()) {
+        app_dlist_add_scaled_str(x, y, str, scale, y - (int16_t)(((uint32_t)(-top) * scale + 0x8000UL) >> 16), dh);
+        return dw;
+    }
+#endif
+
+    // 目标列/行到源列/行的映射，Q16 步长
+    step = ((uint32_t)w << 16) / (uint32_t)dw;
+    for (int16_t c = 0; c < dw; c++) {
+        col_map[c] = (uint8_t)((c * step + step / 2) >> 16);
+    }
+    step = ((uint32_t)h << 16) / (uint32_t)dh;
+    for (int16_t r = 0; r < dh; r++) {
+        row_map[r] = (uint8_t)((r * step + step / 2) >> 16);
+    }
+
+    for (int16_t c = 0; c < dw; c++) {
+        uint32_t s = src[col_map[c]];
+        uint32_t d = 0;
+        if (s != 0) {
+            for (int16_t r = 0; r < dh; r++) {
+                d |= ((s >> row_map[r]) & 1UL) << r;
+            }
+        }
+        dst[c] = d;
+    }
+
+    // 顶端到基线的距离按同一比例缩放，基线保持不动
+    blit_cols(u8g2, dst, (uint8_t)dw, 0, (uint8_t)dh, x, y - (int16_t)(((uint32_t)(-top) * scale + 0x8000UL) >> 16));
+    return dw;
+}
+
+/**
+ * @brief 以翻页牌的一帧绘制一个字符从 from 变为 to
+ * @details 翻动的半张牌高度按进度线性变化，压扁时第 k 行取样源半张牌的第 (k + 1/2) * 半高 / 当前高度 行。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 字符左端X坐标
+ * @param[in] y 基线Y坐标
+ * @param[in] from 原来的字符
+ * @param[in] to 新的字符
+ * @param[in] phase 翻页进度 (Q16)
+ * @return int16_t to 的步进宽度，失败返回 -1
+ */
+int16_t Glyph_Cache_DrawFlip(u8g2_t *u8g2, int16_t x, int16_t y, char from, char to, uint32_t phase)
+{
+    Glyph_Font_t *f = (u8g2->cb == U8G2_R0) ? find_font(u8g2) : NULL;
+    const char str[3] = {from, to, 0};
+    const char one[2][2] = {{from, 0}, {to, 0}};
+    uint32_t src[2][GLYPH_CACHE_FLIP_COLS];
+    uint32_t dst[GLYPH_CACHE_FLIP_COLS];
+    int16_t w[2];
+    int16_t top = 0;
+    int16_t bottom = 0;
+    int16_t h, mid, width, r0, r1, half;
+    uint8_t flap;          // 翻动的半张牌取自哪个字形 (0 为 from，1 为 to)
+    uint32_t keep_old, keep_new;
+
+#if APP_DLIST_ACTIVE
+    if (app_dlist_recording()) {
+        return -1;
+    }
+#endif
+    if (f == NULL || !str_cached(str)) {
+        return -1;
+    }
+
+    // 两个字形共同的上下边界
+    for (uint8_t k = 0; k < 2; k++) {
+        const Glyph_t *g = &f->glyph[GLYPH_INDEX(str[k])];
+        if (g->width) {
+            if (g->y_top < top) {
+                top = g->y_top;
+            }
+            if (g->y_top + g->height > bottom) {
+                bottom = g->y_top + g->height;
+            }
+        }
+    }
+    h = bottom - top;
+    for (uint8_t k = 0; k < 2; k++) {
+        w[k] = Glyph_Cache_Rasterize(u8g2, one[k], (int8_t)top, src[k], GLYPH_CACHE_FLIP_COLS);
+    }
+    if (w[0] < 0 || w[1] < 0 || h > 32) {
+        return -1;
+    }
+    width = (w[0] > w[1]) ? w[0] : w[1];
+    for (uint8_t k = 0; k < 2; k++) {
+        memset(&src[k][w[k]], 0, (size_t)(width - w[k]) * sizeof(uint32_t));
+    }
+
+    mid = h / 2;
+    if (phase >= 0x10000UL) {
+        phase = 0x10000UL;
+    }
+    if (phase < 0x8000UL) {
+        // 前半程：上半张牌 (from) 压扁在 r0~mid 行，上方露出 to，下半部分仍是 from
+        int16_t hf = (int16_t)(((uint32_t)mid * (0x10000UL - phase * 2) + 0x8000UL) >> 16);
+        r0 = mid - hf;
+        r1 = mid;
+        half = mid;
+        flap = 0;
+        keep_new = row_bits(0, r0);
+        keep_old = row_bits(mid, h);
+    } else {
+        // 后半程：上半部分已是 to，下半张牌 (to) 在 mid~r1 行展开，下方仍是 from
+        int16_t hb = (int16_t)(((uint32_t)(h - mid) * (phase * 2 - 0x10000UL) + 0x8000UL) >> 16);
+        r0 = mid;
+        r1 = mid + hb;
+        half = h - mid;
+        flap = 1;
+        keep_new = row_bits(0, mid);
+        keep_old = row_bits(r1, h);
+    }
+
+    for (int16_t c = 0; c < width; c++) {
+        uint32_t d = (src[0][c] & keep_old) | (src[1][c] & keep_new);
+        uint32_t s = src[flap][c];
+        if (s != 0) {
+            int16_t base = flap ? mid : 0;
+            for (int16_t r = r0; r < r1; r++) {
+                int16_t k = (int16_t)(base + ((2 * (r - r0) + 1) * half) / (2 * (r1 - r0)));
+                d |= ((s >> k) & 1UL) << r;
+            }
+        }
+        dst[c] = d;
+    }
+
+    blit_cols(u8g2, dst, (uint8_t)width, 0, (uint8_t)h, x, y + top);
+    return f->glyph[GLYPH_INDEX(to)].advance;
+}
+
+/** @} */
@@ -0,0 +1,130 @@
+/**
+ * @file      app_glyph_cache.h
+ * @brief     大号数字字形缓存头文件
+ * @details   u8g2 每次绘制字符串都要在字体表中查找字形并重新做 RLE 解码，大号数字字体
+ *            (如主页面的 CLOCK_FONT) 每帧都重复这部分开销。本模块在第一次使用某个字体时
+ *            把 '0'~'9' 和 ':' 共 11 个字形解码为按列存放的 1bpp 位图 (每列一个32位字，
+ *            bit0 为最上一行)，之后直接以字为单位移位写入 u8g2 的页式显存。
+ *            支持整帧与分页两种显存模式，遵守当前的裁剪窗口、绘图颜色和字体的透明模式。
+ *            字符串中含有其他字符、字体不可缓存或显示器旋转时，自动回退到 u8g2_DrawStr。
+ *            各字体的位图从一个共用的列池中按实际宽度分配，小字体 (如日历的日期数字) 只占几十列。
+ *            另外提供缩放绘制和翻页牌动画的单帧绘制，都直接由缓存的位图合成，不经过字体表。
+ *            同一字体的字形共用一个数字外框 (Glyph_Cache_Font_Box)，基线按 Glyph_Cache_Page_Baseline
+ *            放置时外框顶端落在 SSD1306 的页边界上，绘制时每页直接写入一个字节，不移位、不读取显存。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.3
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_GLYPH_CACHE_H
+#define __APP_GLYPH_CACHE_H
+
+#include "u8g2.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup GlyphCache 字形缓存
+ * @brief 提供了大号数字字体的预解码绘制功能。
+ * @{
+ */
+
+/**
+ * @defgroup GlyphCache_Config 字形缓存配置
+ * @{
+ */
+#define GLYPH_CACHE_FONTS      4   ///< 可同时缓存的字体数 (CLOCK_FONT、设置页面的大号数值字体和日历的数字)
+#define GLYPH_CACHE_POOL_COLS  176 ///< 每个字体的位图列数上限 (11 个字形宽度之和)
+#define GLYPH_CACHE_POOL_TOTAL 352 ///< 各字体共用的列池大小 (列)，用完后新的字体回退到 u8g2_DrawStr
+#define GLYPH_CACHE_MAX_HEIGHT 32  ///< 可缓存字形的最大高度 (一列一个32位字)
+#define GLYPH_CACHE_SCALE_COLS 64  ///< 缩放绘制时字符串的最大宽度 (缩放前，像素)
+#define GLYPH_CACHE_FLIP_COLS  32  ///< 翻页绘制时一个字形的最大宽度 (像素)
+/** @} */
+
+/**
+ * @brief 用缓存绘制一个字符串
+ * @details 与 u8g2_DrawStr 的效果相同，使用当前字体，基线定位 (u8g2 默认)。
+ *          当前字体第一次被调用时解码并缓存，缓存满或字体不可缓存时回退到 u8g2_DrawStr。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 字符串左端X坐标
+ * @param[in] y 基线Y坐标
+ * @param[in] str 要绘制的字符串
+ * @return u8g2_uint_t 字符串的步进宽度 (与 u8g2_DrawStr 的返回值相同)
+ */
+u8g2_uint_t Glyph_Cache_DrawStr(u8g2_t *u8g2, int16_t x, int16_t y, const char *str);
+
+/**
+ * @brief 用缓存计算字符串的像素宽度
+ * @details 与 u8g2_GetStrWidth 的结果相同，不需要遍历字体表。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] str 字符串
+ * @return u8g2_uint_t 像素宽度
+ */
+u8g2_uint_t Glyph_Cache_GetStrWidth(u8g2_t *u8g2, const char *str);
+
+/**
+ * @brief 获取字体的数字外框
+ * @details 外框是 11 个字形位图的并集，只对已经缓存过 (至少绘制过一次) 的字体有效。
+ * @param[in] font 字体，如 u8g2_font_logisoso24_tn
+ * @param[out] top 外框顶端相对于基线的偏移 (向上为负)
+ * @param[out] height 外框高度
+ * @return bool 字体已缓存且可用时返回 true，否则输出不变
+ */
+bool Glyph_Cache_Font_Box(const uint8_t *font, int8_t *top, uint8_t *height);
+
+/**
+ * @brief 把基线移到使外框顶端落在页边界上的最近位置
+ * @details 两个方向距离相同时向上移动。
+ * @param[in] y 基线Y坐标
+ * @param[in] top 外框顶端相对于基线的偏移 (Glyph_Cache_Font_Box 的输出)
+ * @return int16_t 移动后的基线Y坐标，(返回值 + top) 是8的倍数
+ */
+int16_t Glyph_Cache_Page_Baseline(int16_t y, int8_t top);
+
+/**
+ * @brief 把字符串按列光栅化到调用者的缓冲区
+ * @details 使用当前字体，每列一个32位字，bit0 为基线上方第 -top 行，超出32行的部分被截掉。
+ *          供需要反复绘制同一段文字的控件 (如 ui_slot) 预先生成位图，之后不再访问字体。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] str 字符串
+ * @param[in] top 第0行相对于基线的偏移 (向上为负)
+ * @param[out] cols 列缓冲区，第0列为字符串左端
+ * @param[in] max_cols 列缓冲区的容量
+ * @return int16_t 写入的列数 (字符串的像素宽度)；字体不可缓存、含其他字符或缓冲区不足时返回 -1
+ */
+int16_t Glyph_Cache_Rasterize(u8g2_t *u8g2, const char *str, int8_t top, uint32_t *cols, uint8_t max_cols);
+
+/**
+ * @brief 按比例缩放后绘制一个字符串
+ * @details 最近邻缩放：先用 Glyph_Cache_Rasterize 得到原尺寸的位图，再按 Q16 定点步长预先算出
+ *          每个目标列和目标行对应的源列和源行，逐列取样后写入显存。基线位置不变，左端对齐到 x。
+ *          用于缩放动画，不涉及浮点运算。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 字符串左端X坐标
+ * @param[in] y 基线Y坐标
+ * @param[in] str 要绘制的字符串
+ * @param[in] scale 缩放比例 (Q16，65536 为原尺寸，不超过原尺寸)
+ * @return int16_t 缩放后的像素宽度；字体不可缓存、显示器旋转或字符串过长时返回 -1，此时什么也不画
+ */
+int16_t Glyph_Cache_DrawStr_Scaled(u8g2_t *u8g2, int16_t x, int16_t y, const char *str, uint32_t scale);
+
+/**
+ * @brief 以翻页牌的一帧绘制一个字符从 from 变为 to
+ * @details 两个字形以共同的上下边界对齐，中线为翻页的转轴。前半程上半张牌 (from 的上半部分) 绕转轴向下翻，
+ *          在竖直方向上被压扁到转轴，露出后面 to 的上半部分；后半程下半张牌 (to 的下半部分) 从转轴向下展开，
+ *          盖住 from 的下半部分。压扁和展开按行最近邻取样，只处理翻动的那几行，其余行整列按掩码合成。
+ *          显示列表录制期间不绘制，返回 -1，调用者按普通字符绘制。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 字符左端X坐标 (光标位置)
+ * @param[in] y 基线Y坐标
+ * @param[in] from 原来的字符
+ * @param[in] to 新的字符
+ * @param[in] phase 翻页进度 (Q16，0 为 from，65536 为 to)
+ * @return int16_t to 的步进宽度；字体不可缓存、字符不在缓存中、显示器旋转或字形过宽时返回 -1，此时什么也不画
+ */
+int16_t Glyph_Cache_DrawFlip(u8g2_t *u8g2, int16_t x, int16_t y, char from, char to, uint32_t phase);
+
+/** @} */
+
+#endif /* __APP_GLYPH_CACHE_H */
@@ -0,0 +1,387 @@
+/**
+ * @file      app_history.c
+ * @brief     温度历史记录
+ * @details   环形缓冲区比保留的样本多一个块：写到某个块的第一个位置 (覆盖该块的绝对值) 时，
+ *            该块中上一圈的样本都已超过24小时，因此保留的样本总能从所在块的绝对值累加得到。
+ *            最低、最高温度各用一个单调队列，队列中只存样本在环形缓冲区中的位置，
+ *            比较时按位置读出温度。检查点直接写出RAM中的缓冲区，写入期间暂停采样。
+ *            检查点格式 (704字节)：| 魔法数 (4) | 样本总数 (4) | 最新样本的周期 (4) | 写位置 (2) | 样本数 (2) |
+ *            绝对值 x2x19 (76) | 差值 x2x304 (608) | CRC-32 (4) |，历史记录本身就是 app_persist 镜像中的区域。
+ *            旧版本写入的检查点在 CRC-32 的位置是 CRC-16 (2) 和填充 (2)，读取时同样接受。
+ * @author    SandOcean
+ * @date      2025-09-30
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_history.h"
+#include "app_persist.h"
+#include "DS3231.h"
+#include "AT24C32.h"
+#include "app_sensor.h"
+#include <stddef.h> // For offsetof
+#include <string.h>
+
+/**
+ * @addtogroup AppHistory
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define HISTORY_LOG_MAGIC 0x48495354U                              ///< 检查点的魔法数 ("HIST")
+#define HISTORY_RING      (APP_HISTORY_SAMPLES + APP_HISTORY_BLOCK) ///< 环形缓冲区的样本数
+#define HISTORY_BLOCKS    (HISTORY_RING / APP_HISTORY_BLOCK)       ///< 绝对值的个数
+#define HISTORY_NO_SLOT   0xFFFFFFFFU                              ///< 尚未记录过样本
+#define HISTORY_DELTA_MAX 127                                      ///< 单个差值的最大幅度 (0.1°C)
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 历史记录，同时是写入 EEPROM 的检查点
+ */
+typedef struct {
+    uint32_t magic;                                           ///< 魔法数，固定为 HISTORY_LOG_MAGIC
+    uint32_t seq;                                             ///< 已记录的样本总数
+    uint32_t slot;                                            ///< 最新样本所在的采样周期 (纪元秒 / 周期)
+    uint16_t head;                                            ///< 下一个样本的写位置
+    uint16_t count;                                           ///< 保留的样本数
+    int16_t key[HISTORY_SERIES_COUNT][HISTORY_BLOCKS];        ///< 每块第一个样本的温度 (0.1°C)
+    int8_t delta[HISTORY_SERIES_COUNT][HISTORY_RING];         ///< 各样本与前一个样本之差 (0.1°C)
+    uint32_t crc;                                             ///< 前面所有字段的 CRC-32 (旧版本为 CRC-16/CCITT 加2字节填充)
+} History_Log_t;
+
+/**
+ * @brief 单调队列，存放样本在环形缓冲区中的位置
+ * @details 最低温度的队列从头到尾温度递增，最高温度的队列递减，队头即为结果。
+ */
+typedef struct {
+    uint16_t pos[APP_HISTORY_SAMPLES]; ///< 样本位置 (按 front 起的循环顺序)
+    uint16_t front;                    ///< 队头下标
+    uint16_t len;                      ///< 队列长度
+} History_Deque_t;
+
+/** 编译期检查：检查点必须放得进预留的页，环形缓冲区须由整块组成 */
+typedef char history_log_size_check[(sizeof(History_Log_t) <= APP_HISTORY_LOG_SIZE) ? 1 : -1];
+typedef char history_ring_check[(HISTORY_RING % APP_HISTORY_BLOCK == 0) ? 1 : -1];
+
+/* Private variables ---------------------------------------------------------*/
+static History_Log_t *const history = APP_PERSIST_MIRROR(History_Log_t, APP_HISTORY_BASE_ADDR); ///< 历史记录
+static History_Deque_t deque_min[HISTORY_SERIES_COUNT];  ///< 最低温度的单调队列
+static History_Deque_t deque_max[HISTORY_SERIES_COUNT];  ///< 最高温度的单调队列
+static int16_t newest[HISTORY_SERIES_COUNT];             ///< 最新样本的温度
+static uint8_t since_checkpoint;                         ///< 上一次写入检查点之后记录的样本数
+static bool ready;                                       ///< 检查点已校验 (或已清空)，可以采样
+static volatile bool saving;                             ///< 是否有写任务在进行
+
+/* Private function prototypes -----------------------------------------------*/
+static void history_save_cb(HAL_StatusTypeDef status, void *ctx);
+static void history_try_save(void);
+static void history_reset(void);
+static void history_restore(void);
+static int16_t history_value(uint8_t series, uint16_t pos);
+static uint16_t history_age(uint16_t pos);
+static void deque_push(History_Deque_t *dq, uint8_t series, uint16_t pos, bool is_min);
+static void history_append(const int16_t value[HISTORY_SERIES_COUNT]);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 检查点写入的完成回调 (I2C中断上下文)
+ * @param[in] status 写任务结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void history_save_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+
+    if (status != HAL_OK) {
+        since_checkpoint = APP_HISTORY_CHECKPOINT; // 由 app_history_service() 重试
+    }
+    saving = false;
+}
+
+/**
+ * @brief 到了检查点时尝试启动写入
+ * @details 直接写出 history，写入完成前 app_history_service() 不会修改它。
+ * @return 无
+ */
+static void history_try_save(void)
+{
+    if (since_checkpoint < APP_HISTORY_CHECKPOINT || saving) {
+        return;
+    }
+    history->magic = HISTORY_LOG_MAGIC;
+    history->crc = app_persist_crc(history, offsetof(History_Log_t, crc));
+
+    saving = true;
+    since_checkpoint = 0;
+    if (AT24C32_WritePage_Async(APP_HISTORY_BASE_ADDR, (uint8_t *)history, sizeof(History_Log_t),
+                                history_save_cb, NULL) != HAL_OK) {
+        saving = false;
+        since_checkpoint = APP_HISTORY_CHECKPOINT;
+    }
+}
+
+/**
+ * @brief 清空历史记录
+ * @return 无
+ */
+static void history_reset(void)
+{
+    memset(history, 0, sizeof(*history));
+    history->slot = HISTORY_NO_SLOT;
+    for (uint8_t s = 0; s < HISTORY_SERIES_COUNT; s++) {
+        deque_min[s].len = 0;
+        deque_max[s].len = 0;
+    }
+}
+
+/**
+ * @brief 校验读到的检查点，有效时重建单调队列
+ * @details 队列按时间顺序重新推入全部样本，只在启动时进行一次。持久区读取失败时清空历史记录。
+ * @return 无
+ */
+static void history_restore(void)
+{
+    uint16_t count = history->count;
+
+    if (app_persist_state() != APP_PERSIST_READY || history->magic != HISTORY_LOG_MAGIC || history->head >= HISTORY_RING ||
+        count > APP_HISTORY_SAMPLES || (count == 0 && history->slot != HISTORY_NO_SLOT) ||
+        !app_persist_verify(history, offsetof(History_Log_t, crc), offsetof(History_Log_t, crc))) {
+        history_reset();
+        return;
+    }
+
+    for (uint8_t s = 0; s < HISTORY_SERIES_COUNT; s++) {
+        deque_min[s].len = 0;
+        deque_max[s].len = 0;
+        for (uint16_t age = count; age > 0; age--) {
+            uint16_t pos = (uint16_t)((history->head + HISTORY_RING - age) % HISTORY_RING);
+            deque_push(&deque_min[s], s, pos, true);
+            deque_push(&deque_max[s], s, pos, false);
+        }
+        if (count > 0) {
+            newest[s] = history_value(s, (uint16_t)((history->head + HISTORY_RING - 1) % HISTORY_RING));
+        }
+    }
+}
+
+/**
+ * @brief 读出一个位置上的温度
+ * @details 从所在块的绝对值开始累加差值，最多 APP_HISTORY_BLOCK-1 次。
+ * @param[in] series 数据序列
+ * @param[in] pos 环形缓冲区中的位置 (须为保留的样本)
+ * @return int16_t 温度 (0.1°C)
+ */
+static int16_t history_value(uint8_t series, uint16_t pos)
+{
+    uint16_t start = pos - pos % APP_HISTORY_BLOCK;
+    int16_t value = history->key[series][start / APP_HISTORY_BLOCK];
+
+    for (uint16_t i = start + 1; i <= pos; i++) {
+        value = (int16_t)(value + history->delta[series][i]);
+    }
+    return value;
+}
+
+/**
+ * @brief 计算一个位置上样本的新旧
+ * @param[in] pos 环形缓冲区中的位置
+ * @return uint16_t 0为最新的样本
+ */
+static uint16_t history_age(uint16_t pos)
+{
+    return (uint16_t)((history->head + HISTORY_RING - 1 - pos) % HISTORY_RING);
+}
+
+/**
+ * @brief 把新样本推入单调队列
+ * @details 先从队头移出超过24小时的样本，再从队尾移出不可能再成为结果的样本
+ *          (最低温度队列中不低于新样本的，最高温度队列中不高于新样本的)。
+ * @param[in,out] dq 单调队列
+ * @param[in] series 数据序列
+ * @param[in] pos 新样本的位置 (须已写入)
+ * @param[in] is_min 为 true 时为最低温度的队列
+ * @return 无
+ */
+static void deque_push(History_Deque_t *dq, uint8_t series, uint16_t pos, bool is_min)
+{
+    int16_t value = history_value(series, pos);
+
+    while (dq->len > 0 && history_age(dq->pos[dq->front]) >= APP_HISTORY_SAMPLES) {
+        dq->front = (uint16_t)((dq->front + 1) % APP_HISTORY_SAMPLES);
+        dq->len--;
+    }
+    while (dq->len > 0) {
+        int16_t back = history_value(series, dq->pos[(dq->front + dq->len - 1) % APP_HISTORY_SAMPLES]);
+        if (is_min ? (back < value) : (back > value)) {
+            break;
+        }
+        dq->len--;
+    }
+    dq->pos[(dq->front + dq->len) % APP_HISTORY_SAMPLES] = pos;
+    dq->len++;
+}
+
+/**
+ * @brief 记录一个样本
+ * @details 差值超出 int8_t 的范围时截断，记录的温度分几次追上实际值。
+ * @param[in] value 各序列的温度 (0.1°C)
+ * @return 无
+ */
+static void history_append(const int16_t value[HISTORY_SERIES_COUNT])
+{
+    uint16_t pos = history->head;
+
+    for (uint8_t s = 0; s < HISTORY_SERIES_COUNT; s++) {
+        int16_t d = (history->count == 0) ? 0 : (int16_t)(value[s] - newest[s]);
+        if (d > HISTORY_DELTA_MAX) {
+            d = HISTORY_DELTA_MAX;
+        } else if (d < -HISTORY_DELTA_MAX) {
+            d = -HISTORY_DELTA_MAX;
+        }
+        newest[s] = (history->count == 0) ? value[s] : (int16_t)(newest[s] + d);
+        history->delta[s][pos] = (int8_t)d;
+        if (pos % APP_HISTORY_BLOCK == 0) {
+            history->key[s][pos / APP_HISTORY_BLOCK] = newest[s];
+        }
+    }
+
+    history->head = (uint16_t)((pos + 1) % HISTORY_RING);
+    if (history->count < APP_HISTORY_SAMPLES) {
+        history->count++;
+    }
+    history->seq++;
+    for (uint8_t s = 0; s < HISTORY_SERIES_COUNT; s++) {
+        deque_push(&deque_min[s], s, pos, true);
+        deque_push(&deque_max[s], s, pos, false);
+    }
+    if (since_checkpoint < APP_HISTORY_CHECKPOINT) {
+        since_checkpoint++;
+    }
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 历史记录维护函数，需在主循环中周期调用
+ * @return bool 本次调用记录了新样本时返回 true
+ */
+bool app_history_service(void)
+{
+    int16_t value[HISTORY_SERIES_COUNT];
+    const AHT20_Data_t *aht;
+    int16_t temp_x4;
+    uint32_t slot;
+
+    if (!ready) {
+        App_Persist_State_e state = app_persist_state();
+        if (state != APP_PERSIST_READY && state != APP_PERSIST_FAILED) {
+            return false;
+        }
+        history_restore();
+        ready = true;
+    }
+
+    history_try_save();
+    if (saving) {
+        return false; // 写入期间缓冲区必须保持不变
+    }
+
+    slot = DS3231_GetCachedEpoch() / APP_HISTORY_PERIOD_S;
+    if (history->slot != HISTORY_NO_SLOT && slot <= history->slot) {
+        return false;
+    }
+    aht = app_sensor_get();
+    if (!aht->valid) {
+        return false;
+    }
+    value[HISTORY_SERIES_AHT20] = (int16_t)((aht->temperature_cdeg + (aht->temperature_cdeg >= 0 ? 5 : -5)) / 10);
+    if (DS3231_GetTemperature_x4(&temp_x4) == HAL_OK) {
+        value[HISTORY_SERIES_RTC] = (int16_t)(temp_x4 * 5 / 2);
+    } else if (history->count > 0) {
+        value[HISTORY_SERIES_RTC] = newest[HISTORY_SERIES_RTC];
+    } else {
+        return false;
+    }
+
+    // 断电或停止采样期间缺失的周期用最后一个值填充，超过24小时则重新开始
+    if (history->slot != HISTORY_NO_SLOT) {
+        if (slot - history->slot > APP_HISTORY_SAMPLES) {
+            history_reset();
+        } else {
+            for (uint32_t missing = slot - history->slot - 1; missing > 0; missing--) {
+                history_append(newest);
+            }
+        }
+    }
+    history_append(value);
+    history->slot = slot;
+    return true;
+}
+
+/**
+ * @brief 获取已记录的样本总数
+ * @return uint32_t 样本总数
+ */
+uint32_t app_history_seq(void)
+{
+    return ready ? history->seq : 0;
+}
+
+/**
+ * @brief 获取最新样本的时间
+ * @return uint32_t 纪元秒，没有样本时为 0
+ */
+uint32_t app_history_newest_epoch(void)
+{
+    if (app_history_count() == 0 || history->slot == HISTORY_NO_SLOT) {
+        return 0;
+    }
+    return history->slot * APP_HISTORY_PERIOD_S;
+}
+
+/**
+ * @brief 获取当前保留的样本数
+ * @return uint16_t 样本数
+ */
+uint16_t app_history_count(void)
+{
+    return ready ? history->count : 0;
+}
+
+/**
+ * @brief 读取一个样本
+ * @param[in] series 数据序列
+ * @param[in] age 样本的新旧，0为最新的样本
+ * @param[out] value 温度 (0.1°C)
+ * @return bool 序列无效或 age 不小于保留的样本数时返回 false
+ */
+bool app_history_get(History_Series_e series, uint16_t age, int16_t *value)
+{
+    if ((unsigned)series >= HISTORY_SERIES_COUNT || age >= app_history_count()) {
+        return false;
+    }
+    *value = history_value((uint8_t)series, (uint16_t)((history->head + HISTORY_RING - 1 - age) % HISTORY_RING));
+    return true;
+}
+
+/**
+ * @brief 获取保留的样本中的最低和最高温度
+ * @param[in] series 数据序列
+ * @param[out] min 最低温度 (0.1°C)
+ * @param[out] max 最高温度 (0.1°C)
+ * @return bool 没有样本时返回 false
+ */
+bool app_history_min_max(History_Series_e series, int16_t *min, int16_t *max)
+{
+    if ((unsigned)series >= HISTORY_SERIES_COUNT || app_history_count() == 0) {
+        return false;
+    }
+    *min = history_value((uint8_t)series, deque_min[series].pos[deque_min[series].front]);
+    *max = history_value((uint8_t)series, deque_max[series].pos[deque_max[series].front]);
+    return true;
+}
+
+/** @} */
@@ -0,0 +1,100 @@
+/**
+ * @file      app_history.h
+ * @brief     温度历史记录头文件
+ * @details   每 APP_HISTORY_PERIOD_S 秒 (按RTC时间对齐) 记录一次 AHT20 和 DS3231 的温度，保留最近24小时。
+ *            样本以相邻两次之差 (int8_t，单位0.1°C) 存放在RAM的环形缓冲区中，每 APP_HISTORY_BLOCK 个样本
+ *            另存一个绝对值，随机读取任一样本最多累加 APP_HISTORY_BLOCK-1 个差值。
+ *            24小时内的最低和最高温度由单调队列维护，每个样本的入队和出队均摊为常数时间。
+ *            缓冲区每 APP_HISTORY_CHECKPOINT 个样本在后台写入一次 AT24C32，复位后从检查点恢复，
+ *            断电期间缺失的样本以断电前的最后一个值填充。
+ * @author    SandOcean
+ * @date      2025-09-30
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_HISTORY_H
+#define __APP_HISTORY_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppHistory 温度历史
+ * @brief 24小时温度记录与最低、最高温度。
+ * @{
+ */
+
+/**
+ * @defgroup AppHistory_Config 温度历史配置
+ * @{
+ */
+#define APP_HISTORY_PERIOD_S     300    ///< 采样周期 (秒)
+#define APP_HISTORY_SAMPLES      288    ///< 保留的样本数 (24小时)
+#define APP_HISTORY_BLOCK        16     ///< 每隔多少个样本存一个绝对值
+#define APP_HISTORY_CHECKPOINT   12     ///< 每隔多少个样本写入一次 EEPROM (1小时)
+#define APP_HISTORY_BASE_ADDR    0x0CE0 ///< 检查点在 AT24C32 中的地址 (紧接 app_usage 的计数区，须与页对齐)
+#define APP_HISTORY_LOG_SIZE     704    ///< 检查点占用的字节数 (22页)
+/** @} */
+
+/**
+ * @brief 记录的数据序列
+ */
+typedef enum {
+    HISTORY_SERIES_AHT20 = 0, ///< AHT20 测得的环境温度
+    HISTORY_SERIES_RTC,       ///< DS3231 内部的温度传感器
+    HISTORY_SERIES_COUNT      ///< 序列个数
+} History_Series_e;
+
+/**
+ * @brief 历史记录维护函数，需在主循环中周期调用 (包括熄屏期间，每分钟唤醒一次已足够)
+ * @details 启动时 app_persist 的读取完成后校验检查点，之前不采样；缓存时间进入新的采样周期且 AHT20 已有 (滤波后的) 测量结果时记录一个样本，
+ *          读取一次 DS3231 的温度寄存器 (阻塞，约0.1ms)；按需启动检查点的写入。
+ *          时间倒退时等待追上，向前跳过24小时以上时清空记录。
+ * @return bool 本次调用记录了新样本时返回 true
+ */
+bool app_history_service(void);
+
+/**
+ * @brief 获取已记录的样本总数
+ * @details 自首次记录起递增 (从检查点恢复时继续计数)，页面用它判断是否有新样本和确定样本所在的列。
+ * @return uint32_t 样本总数
+ */
+uint32_t app_history_seq(void);
+
+/**
+ * @brief 获取最新样本的时间
+ * @details 样本按周期连续 (断电期间的样本已填充)，序号为 k 的样本的时间为
+ *          该值 - (app_history_seq() - 1 - k) * APP_HISTORY_PERIOD_S。
+ * @return uint32_t 最新样本所在采样周期开始的纪元秒 (标准时间)，没有样本时为 0
+ */
+uint32_t app_history_newest_epoch(void);
+
+/**
+ * @brief 获取当前保留的样本数
+ * @return uint16_t 样本数 (0 ~ APP_HISTORY_SAMPLES)
+ */
+uint16_t app_history_count(void);
+
+/**
+ * @brief 读取一个样本
+ * @param[in] series 数据序列
+ * @param[in] age 样本的新旧，0为最新的样本
+ * @param[out] value 温度 (0.1°C)
+ * @return bool 序列无效或 age 不小于保留的样本数时返回 false
+ */
+bool app_history_get(History_Series_e series, uint16_t age, int16_t *value);
+
+/**
+ * @brief 获取保留的样本中的最低和最高温度
+ * @param[in] series 数据序列
+ * @param[out] min 最低温度 (0.1°C)
+ * @param[out] max 最高温度 (0.1°C)
+ * @return bool 没有样本时返回 false
+ */
+bool app_history_min_max(History_Series_e series, int16_t *min, int16_t *max);
+
+/** @} */
+
+#endif /* __APP_HISTORY_H */
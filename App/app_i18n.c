@@ -0,0 +1,99 @@
+/**
+ * @file      app_i18n.c
+ * @brief     界面文字的多语言字符串表
+ * @details   字符串表按 [语言][编号] 排成指针数组，由 APP_I18N_STRINGS 展开，整表位于Flash。
+ *            中文文本用 u8g2_DrawUTF8 绘制；英文文本都是 ASCII，仍走 u8g2_DrawStr 和宽度缓存。
+ * @author    SandOcean
+ * @date      2025-10-07
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_i18n.h"
+#include "app_config.h"
+#include "app_settings.h"
+
+/**
+ * @addtogroup AppI18n
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define I18N_LANGUAGES 2 ///< 语言数 (LANGUAGE_EN、LANGUAGE_CN)
+
+/* Private variables ---------------------------------------------------------*/
+#define I18N_EN(id, en, cn) en,
+#define I18N_CN(id, en, cn) cn,
+static const char *const i18n_strings[I18N_LANGUAGES][STR_COUNT] = {
+    [LANGUAGE_EN] = { APP_I18N_STRINGS(I18N_EN) },
+    [LANGUAGE_CN] = { APP_I18N_STRINGS(I18N_CN) },
+};
+#undef I18N_EN
+#undef I18N_CN
+
+static const uint8_t *i18n_width_font[STR_COUNT]; ///< 各编号上次测量宽度时的字体，NULL 为未测量
+static uint8_t i18n_width_lang[STR_COUNT];        ///< 各编号上次测量宽度时的语言
+static uint8_t i18n_width[STR_COUNT];             ///< 各编号上次测量的宽度 (屏幕宽128像素，一字节足够)
+
+/* Function implementations --------------------------------------------------*/
+
+const char *app_str(App_Str_t id)
+{
+    if ((unsigned)id >= STR_COUNT) {
+        return "";
+    }
+    return i18n_strings[app_i18n_language()][id];
+}
+
+uint8_t app_i18n_language(void)
+{
+#if APP_I18N_CJK
+    return (g_app_settings.language == LANGUAGE_CN) ? LANGUAGE_CN : LANGUAGE_EN;
+#else
+    return LANGUAGE_EN;
+#endif
+}
+
+const uint8_t *app_i18n_font(const uint8_t *font)
+{
+#if APP_I18N_CJK
+    if (app_i18n_language() == LANGUAGE_CN) {
+        return APP_I18N_FONT;
+    }
+#endif
+    return font;
+}
+
+u8g2_uint_t app_i18n_draw(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str)
+{
+    if (app_i18n_language() == LANGUAGE_CN) {
+        return u8g2_DrawUTF8(u8g2, x, y, str);
+    }
+    return u8g2_DrawStr(u8g2, x, y, str);
+}
+
+u8g2_uint_t app_i18n_width(u8g2_t *u8g2, const char *str)
+{
+    if (app_i18n_language() == LANGUAGE_CN) {
+        return u8g2_GetUTF8Width(u8g2, str);
+    }
+    return Page_Str_Width(u8g2, str);
+}
+
+u8g2_uint_t app_str_width(u8g2_t *u8g2, App_Str_t id)
+{
+    uint8_t lang = app_i18n_language();
+
+    if ((unsigned)id >= STR_COUNT) {
+        return 0;
+    }
+    if (i18n_width_font[id] != u8g2->font || i18n_width_lang[id] != lang) {
+        u8g2_uint_t width = app_i18n_width(u8g2, i18n_strings[lang][id]);
+        i18n_width_font[id] = u8g2->font;
+        i18n_width_lang[id] = lang;
+        i18n_width[id] = (width > 0xFF) ? 0xFF : (uint8_t)width;
+    }
+    return i18n_width[id];
+}
+
+/** @} */
@@ -0,0 +1,166 @@
+/**
+ * @file      app_i18n.h
+ * @brief     界面文字的多语言字符串表
+ * @details   每条界面文字有一个编号 (App_Str_t)，各语言的文本在 APP_I18N_STRINGS 中并排书写，
+ *            app_str() 按当前语言和编号直接下标取出，不做字符串查找。
+ *            中文文本为 UTF-8 编码，使用 APP_I18N_FONT 绘制。完整的中文字库放不进 Flash，
+ *            该字体须由 Tools/font_subset.py 裁剪为只含字符串表中用到的汉字，
+ *            因此只有开启 APP_DISPLAY_FONT_SUBSET 时中文才可用，否则一律显示英文。
+ *            绘制表中文字时用 app_i18n_font() 选择字体，再用 app_i18n_draw() 和 app_i18n_width()
+ *            绘制和测量，英文时与 u8g2_DrawStr / Page_Str_Width 相同。
+ * @author    SandOcean
+ * @date      2025-10-07
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_I18N_H
+#define __APP_I18N_H
+
+#include "app_display.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppI18n 多语言文字
+ * @brief 按编号索引的界面字符串表。
+ * @{
+ */
+
+/**
+ * @defgroup AppI18n_Config 多语言配置
+ * @{
+ */
+#define APP_I18N_CJK APP_DISPLAY_FONT_SUBSET ///< 中文是否可用 (需要裁剪后的中文字体)
+/** @} */
+
+/**
+ * @brief 字符串表，每项为 X(编号, 英文, 中文)
+ * @details 新增文字时在此添加一项，并重新运行 Tools/font_subset.py 生成中文字形。
+ */
+#define APP_I18N_STRINGS(X)                                  \
+    X(MENU_DISPLAY,     "Display",             "显示")         \
+    X(MENU_TIME_SET,    "Time Set",            "时间设置")     \
+    X(MENU_ALARM,       "Alarm",               "闹钟")         \
+    X(MENU_STOPWATCH,   "Stopwatch",           "秒表")         \
+    X(MENU_TIMER,       "Timer",               "倒计时")       \
+    X(MENU_WORLD,       "World",               "世界时钟")     \
+    X(MENU_INFO,        "Info",                "关于")         \
+    X(MENU_LANGUAGE,    "Language",            "语言")         \
+    X(MENU_AUTO_OFF,    "Auto-Off",            "自动熄屏")     \
+    X(MENU_DATE,        "Date",                "日期")         \
+    X(MENU_TIME,        "Time",                "时间")         \
+    X(MENU_DST,         "DST",                 "夏令时")       \
+    X(MENU_FACE,        "Face: ",              "表盘: ")       \
+    X(FACE_DIGITAL,     "Digital",             "数字")         \
+    X(FACE_ANALOG,      "Analog",              "指针")         \
+    X(FACE_SIMPLE,      "Simple",              "简洁")         \
+    X(FACE_ASTRO,       "Sun/Moon",            "日月")         \
+    X(MENU_MODE,        "Mode: ",              "模式: ")       \
+    X(MODE_NORMAL,      "Normal",              "正常")         \
+    X(MODE_INVERT,      "Inverted",            "反色")         \
+    X(MODE_NIGHT,       "Night",               "夜间反色")     \
+    X(MENU_PERF,        "Perf: ",              "性能: ")       \
+    X(PERF_ECO,         "Eco",                 "省电")         \
+    X(PERF_BALANCED,    "Balanced",            "均衡")         \
+    X(PERF_SMOOTH,      "Smooth",              "流畅")         \
+    X(LANG_EN,          "English",             "English")      \
+    X(LANG_CN,          "Chinese",             "简体中文")     \
+    X(OFF,              "Off",                 "关")           \
+    X(ON,               "On",                  "开")           \
+    X(DST_RULE,         "Rule: ",              "规则: ")       \
+    X(WORLD_HOME,       "Home: ",              "本地: ")       \
+    X(AUTO_OFF_NEVER,   "Never",               "从不")         \
+    X(AUTO_OFF_30S,     "30s",                 "30秒")         \
+    X(AUTO_OFF_1MIN,    "1min",                "1分钟")        \
+    X(AUTO_OFF_5MIN,    "5min",                "5分钟")        \
+    X(AUTO_OFF_10MIN,   "10min",               "10分钟")       \
+    X(WEEK_MON,         "MON",                 "周一")         \
+    X(WEEK_TUE,         "TUE",                 "周二")         \
+    X(WEEK_WED,         "WED",                 "周三")         \
+    X(WEEK_THU,         "THU",                 "周四")         \
+    X(WEEK_FRI,         "FRI",                 "周五")         \
+    X(WEEK_SAT,         "SAT",                 "周六")         \
+    X(WEEK_SUN,         "SUN",                 "周日")         \
+    X(MSG_SETTINGS_SAVED, "Settings Saved!",   "设置已保存")   \
+    X(MSG_DATE_SAVED,   "Date Saved!",         "日期已保存")   \
+    X(MSG_TIME_SAVED,   "Time Saved!",         "时间已保存")   \
+    X(MSG_ALARM_SAVED,  "Alarm Saved!",        "闹钟已保存")   \
+    X(MSG_SAVE_FAILED,  "Save Failed!",        "保存失败")     \
+    X(MSG_LOAD_FAILED,  "Setting load failed", "设置读取失败") \
+    X(MSG_BATTERY_LOW,  "Battery low",         "电量低")       \
+    X(MSG_BATTERY_CRITICAL, "Battery critical", "电量极低")    \
+    X(MSG_TOO_COLD,     "Too cold",            "温度过低")     \
+    X(MSG_TOO_WARM,     "Too warm",            "温度过高")     \
+    X(MSG_TOO_DRY,      "Too dry",             "湿度过低")     \
+    X(MSG_TOO_HUMID,    "Too humid",           "湿度过高")     \
+    X(MSG_NO_DATA,      "No data yet",         "暂无数据")     \
+    X(MSG_TIME_UP,      "Time's up!",          "时间到")       \
+    X(LABEL_YEAR,       "Year",                "年")           \
+    X(LABEL_MONTH,      "Mon",                 "月")           \
+    X(LABEL_DAY,        "Day",                 "日")           \
+    X(LABEL_HOUR,       "Hour",                "时")           \
+    X(LABEL_MINUTE,     "Min",                 "分")           \
+    X(LABEL_SECOND,     "Sec",                 "秒")
+
+/**
+ * @brief 字符串编号
+ */
+typedef enum {
+#define APP_I18N_ID(id, en, cn) STR_##id,
+    APP_I18N_STRINGS(APP_I18N_ID)
+#undef APP_I18N_ID
+    STR_COUNT ///< 字符串数量
+} App_Str_t;
+
+/**
+ * @brief 获取当前语言下的文本
+ * @param[in] id 字符串编号
+ * @return const char* 文本 (位于Flash)，编号越界时返回空字符串
+ */
+const char *app_str(App_Str_t id);
+
+/**
+ * @brief 获取实际使用的语言
+ * @return uint8_t LANGUAGE_EN 或 LANGUAGE_CN，中文不可用时总是 LANGUAGE_EN
+ */
+uint8_t app_i18n_language(void);
+
+/**
+ * @brief 为表中文字选择字体
+ * @param[in] font 英文时使用的字体
+ * @return const uint8_t* 中文时为 APP_I18N_FONT，否则为 font
+ */
+const uint8_t *app_i18n_font(const uint8_t *font);
+
+/**
+ * @brief 绘制表中文字 (当前字体须由 app_i18n_font() 选择)
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 起点X坐标
+ * @param[in] y 基线Y坐标
+ * @param[in] str 文本
+ * @return u8g2_uint_t 绘制的像素宽度
+ */
+u8g2_uint_t app_i18n_draw(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str);
+
+/**
+ * @brief 测量表中文字的像素宽度 (当前字体须由 app_i18n_font() 选择)
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] str 文本
+ * @return u8g2_uint_t 像素宽度，英文时经 Page_Str_Width 缓存
+ */
+u8g2_uint_t app_i18n_width(u8g2_t *u8g2, const char *str);
+
+/**
+ * @brief 获取表中文字在当前字体下的像素宽度 (按编号缓存)
+ * @details 每个编号记住上次测量时的字体和宽度，字体 (或语言) 不变时直接返回，
+ *          不扫描字符串也不查找字形。当前字体须由 app_i18n_font() 选择。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] id 字符串编号
+ * @return u8g2_uint_t 像素宽度
+ */
+u8g2_uint_t app_str_width(u8g2_t *u8g2, App_Str_t id);
+
+/** @} */
+
+#endif /* __APP_I18N_H */
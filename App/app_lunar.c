@@ -0,0 +1,332 @@
+/**
+ * @file      app_lunar.c
+ * @brief     农历日期
+ * @details   表中每个农历年一个字：
+ *            - 位 0~12：该年各月 (按顺序，闰月紧跟在同名的月之后) 是否为大月 (30 天)，小月为 29 天；
+ *            - 位 13~16：闰几月，0 为没有闰月；
+ *            - 位 17~21：正月初一相对公历 1 月 21 日的天数 (春节都在 1 月 21 日到 2 月 20 日之间)。
+ *            换算时先求公历日期所在年份的春节，早于春节则属于上一个农历年，再从正月起逐月减去各月的天数。
+ *            APP_ASSET_LUNAR 为 1 时表不编入固件，表项从外部闪存的资源区 (APP_ASSET_LUNAR_YEARS) 读取，
+ *            读不到时 (没有资源块、闪存正在擦除) 视为没有农历日期，之后每分钟重试一次。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_lunar.h"
+#include "app_asset.h"
+#include "app_settings.h"
+#include "app_i18n.h"
+#include "app_bus.h"
+#include "app_fmt.h"
+#include "DS3231.h"
+#include "time_core.h"
+
+/**
+ * @addtogroup AppLunar
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define LUNAR_YEAR_MIN       1999 ///< 表中的第一个农历年
+#define LUNAR_YEAR_MAX       2099 ///< 表中的最后一个农历年
+#define LUNAR_LEAP_SHIFT     13   ///< 闰月所在的位
+#define LUNAR_NEW_YEAR_SHIFT 17   ///< 春节偏移所在的位
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief 农历 1999~2099 年的各月大小、闰月和春节
+ * @note Tools/asset_pack.py 从这里读出表项生成资源 APP_ASSET_LUNAR_YEARS，须保持每行的格式
+ */
+#if !APP_ASSET_LUNAR
+static const uint32_t lunar_years[LUNAR_YEAR_MAX - LUNAR_YEAR_MIN + 1] = {
+    0x340749, 0x1E0693, 0x06952B, 0x2C052B, 0x160A5B, 0x02555A, 0x26056A, 0x10FB55, 0x380BA4, 0x220B49,  // 1999-2008
+    0x0ABA93, 0x300A95, 0x1A052D, 0x048AAD, 0x280AB5, 0x1535AA, 0x3A05D2, 0x240DA5, 0x0EDD4A, 0x340D4A,  // 2009-2018
+    0x1E0C95, 0x08952E, 0x2C0556, 0x160AB5, 0x0255B2, 0x2806D2, 0x10CEA5, 0x360725, 0x20064B, 0x0AAC97,  // 2019-2028
+    0x2E0CAB, 0x1A055A, 0x046AD6, 0x2A0B69, 0x157752, 0x3A0B52, 0x240B25, 0x0EDA4B, 0x320A4B, 0x1C04AB,  // 2029-2038
+    0x06A55B, 0x2C05AD, 0x160B6A, 0x025B52, 0x280D92, 0x12FD25, 0x360D25, 0x200A55, 0x0AB4AD, 0x3004B6,  // 2039-2048
+    0x1805B5, 0x046DAA, 0x2A0EC9, 0x171E92, 0x3A0E92, 0x240D26, 0x0ECA56, 0x320A57, 0x1C04D6, 0x0686D5,  // 2049-2058
+    0x2C0755, 0x180749, 0x006E93, 0x260693, 0x10F52B, 0x36052B, 0x1E0A5B, 0x0AB55A, 0x30056A, 0x1A0B65,  // 2059-2068
+    0x04974A, 0x2A0B4A, 0x151A95, 0x3A0A95, 0x22052D, 0x0CCAAD, 0x320AB5, 0x1E05AA, 0x068BA5, 0x2C0DA5,  // 2069-2078
+    0x180D4A, 0x027C95, 0x260C96, 0x10F94E, 0x360556, 0x200AB5, 0x0AB5B2, 0x3006D2, 0x1A0EA5, 0x068E4A,  // 2079-2088
+    0x28068B, 0x130C97, 0x3804AB, 0x22055B, 0x0CCAD6, 0x320B6A, 0x1E0752, 0x089725, 0x2C0B45, 0x160A8B,  // 2089-2098
+    0x00549B,  // 2099
+};
+#endif
+
+static const char *const lunar_month_names[12] = {
+    "正", "二", "三", "四", "五", "六", "七", "八", "九", "十", "冬", "腊",
+};
+
+static const char *const lunar_digits[10] = {
+    "一", "二", "三", "四", "五", "六", "七", "八", "九", "十",
+};
+
+static App_Lunar_Date_t lunar;  ///< 今天的农历日期
+static bool lunar_valid;        ///< lunar 是否已换算
+static uint8_t lunar_seq_no;    ///< 每次换算后加一
+static uint32_t lunar_days;     ///< lunar 对应的公历日期 (2000-01-01 起的天数)
+static char lunar_text[16];     ///< 显示文字 (UTF-8，最长为 "闰十二月廿九")
+static App_Bus_Sub_t lunar_sub; ///< 日期变化的订阅
+#if APP_ASSET_LUNAR
+static App_Bus_Sub_t lunar_retry_sub; ///< 每分钟的订阅，读不到表项时重试
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static bool lunar_info(uint16_t year, uint32_t *info);
+static bool lunar_new_year(uint16_t year, uint32_t *days);
+static uint8_t lunar_month_days(uint32_t info, uint8_t index);
+static uint8_t lunar_month_count(uint32_t info);
+static void lunar_set_month(App_Lunar_Date_t *d, uint32_t info);
+static bool lunar_next_day(App_Lunar_Date_t *d);
+static void lunar_format(void);
+static void lunar_refresh(App_Bus_Topic_e topic, void *arg);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 获取一个农历年的表项
+ * @details 资源中的表项为小端的字，与 Cortex-M3 的字节序相同，直接读入。
+ * @param[in] year 农历年 (LUNAR_YEAR_MIN~LUNAR_YEAR_MAX)
+ * @param[out] info 表项
+ * @return bool 读不到资源时返回 false
+ */
+static bool lunar_info(uint16_t year, uint32_t *info)
+{
+#if APP_ASSET_LUNAR
+    return app_asset_read(APP_ASSET_LUNAR_YEARS, (uint32_t)(year - LUNAR_YEAR_MIN) * sizeof(*info), info, sizeof(*info));
+#else
+    *info = lunar_years[year - LUNAR_YEAR_MIN];
+    return true;
+#endif
+}
+
+/**
+ * @brief 获取正月初一的公历日期
+ * @param[in] year 农历年
+ * @param[out] days 2000-01-01 起的天数 (1999 年为负数，按无符号数回绕)
+ * @return bool 读不到表项时返回 false
+ */
+static bool lunar_new_year(uint16_t year, uint32_t *days)
+{
+    uint32_t info;
+
+    if (!lunar_info(year, &info)) {
+        return false;
+    }
+    *days = Time_Days_From_Civil(year, 1, 21) + ((info >> LUNAR_NEW_YEAR_SHIFT) & 0x1FU);
+    return true;
+}
+
+/**
+ * @brief 获取一个月的天数
+ * @param[in] info 该农历年的表项
+ * @param[in] index 月在该年中的序号
+ * @return uint8_t 29 或 30
+ */
+static uint8_t lunar_month_days(uint32_t info, uint8_t index)
+{
+    return (uint8_t)(29U + ((info >> index) & 1U));
+}
+
+/**
+ * @brief 获取一年中月的个数
+ * @param[in] info 该农历年的表项
+ * @return uint8_t 有闰月时为 13，否则为 12
+ */
+static uint8_t lunar_month_count(uint32_t info)
+{
+    return (info & (0xFU << LUNAR_LEAP_SHIFT)) ? 13 : 12;
+}
+
+/**
+ * @brief 由月的序号求月份和是否为闰月
+ * @param[in,out] d 农历日期 (year、index 有效)
+ * @param[in] info 该农历年的表项
+ * @return 无
+ */
+static void lunar_set_month(App_Lunar_Date_t *d, uint32_t info)
+{
+    uint8_t leap = (uint8_t)((info >> LUNAR_LEAP_SHIFT) & 0xFU);
+
+    d->leap = (leap != 0 && d->index == leap);
+    d->month = (uint8_t)((leap != 0 && d->index >= leap) ? d->index : d->index + 1);
+}
+
+/**
+ * @brief 农历日期前进一天
+ * @param[in,out] d 农历日期
+ * @return bool 超出表的范围或读不到表项时返回 false
+ */
+static bool lunar_next_day(App_Lunar_Date_t *d)
+{
+    uint32_t info;
+
+    if (!lunar_info(d->year, &info)) {
+        return false;
+    }
+    if (++d->day <= lunar_month_days(info, d->index)) {
+        return true;
+    }
+    d->day = 1;
+    if (++d->index >= lunar_month_count(info)) {
+        if (d->year >= LUNAR_YEAR_MAX || !lunar_info((uint16_t)(d->year + 1), &info)) {
+            return false;
+        }
+        d->year++;
+        d->index = 0;
+    }
+    lunar_set_month(d, info);
+    return true;
+}
+
+/**
+ * @brief 生成显示用的文字
+ * @details 日的写法：初一~初十，十一~十九，二十，廿一~廿九，三十。
+ * @return 无
+ */
+static void lunar_format(void)
+{
+    char *p = lunar_text;
+    uint8_t day = lunar.day;
+
+    if (lunar.leap) {
+        p = fmt_str(p, "闰");
+    }
+    p = fmt_str(p, lunar_month_names[lunar.month - 1]);
+    p = fmt_str(p, "月");
+    if (day == 20 || day == 30) {
+        p = fmt_str(p, lunar_digits[day / 10 - 1]);
+        fmt_str(p, "十");
+        return;
+    }
+    p = fmt_str(p, (day <= 10) ? "初" : (day < 20) ? "十" : "廿");
+    fmt_str(p, lunar_digits[(day - 1) % 10]);
+}
+
+/**
+ * @brief 本地日期变化的通知
+ * @details 日期比上一次换算时前进一天时直接加一天，否则 (启动、对时或夏令时开关改变) 重新查表。
+ * @param[in] topic 未使用
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void lunar_refresh(App_Bus_Topic_e topic, void *arg)
+{
+    DS3231_Cache_Snap_t snap;
+    uint32_t days;
+    bool valid;
+
+    (void)topic;
+    (void)arg;
+    if (!DS3231_Cache_Get(&snap)) {
+        return;
+    }
+    days = Time_Apply_Dst(snap.epoch, g_app_settings.dst_enabled) / TIME_SECS_PER_DAY;
+    if (lunar_valid && days == lunar_days) {
+        return;
+    }
+
+    if (lunar_valid && days == lunar_days + 1) {
+        valid = lunar_next_day(&lunar);
+    } else {
+        valid = app_lunar_from_days(days, &lunar);
+    }
+    if (!valid && !lunar_valid && days == lunar_days) {
+        return; // 重试仍然失败，显示不变
+    }
+    lunar_valid = valid;
+    lunar_days = days;
+    if (lunar_valid) {
+        lunar_format();
+    }
+    lunar_seq_no++;
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 订阅本地日期的变化
+ * @return 无
+ */
+void app_lunar_init(void)
+{
+    app_bus_subscribe(&lunar_sub, APP_BUS_TIME_DAY, lunar_refresh, NULL);
+#if APP_ASSET_LUNAR
+    app_bus_subscribe(&lunar_retry_sub, APP_BUS_TIME_MINUTE, lunar_refresh, NULL);
+#endif
+}
+
+/**
+ * @brief 把公历日期换算为农历日期
+ * @param[in] days 公历日期 (2000-01-01 起的天数)
+ * @param[out] out 农历日期
+ * @return bool 超出表的范围或读不到表项时返回 false
+ */
+bool app_lunar_from_days(uint32_t days, App_Lunar_Date_t *out)
+{
+    uint16_t year;
+    uint8_t month, day;
+    uint32_t info, start;
+    int32_t offset;
+
+    Time_Civil_From_Days(days, &year, &month, &day);
+    if (year > LUNAR_YEAR_MAX || !lunar_new_year(year, &start)) {
+        return false;
+    }
+    offset = (int32_t)(days - start);
+    if (offset < 0) {
+        year--; // 春节之前属于上一个农历年
+        if (!lunar_new_year(year, &start)) {
+            return false;
+        }
+        offset = (int32_t)(days - start);
+    }
+
+    if (!lunar_info(year, &info)) {
+        return false;
+    }
+    out->year = year;
+    out->index = 0;
+    while (offset >= lunar_month_days(info, out->index)) {
+        offset -= lunar_month_days(info, out->index);
+        out->index++;
+    }
+    out->day = (uint8_t)(offset + 1);
+    lunar_set_month(out, info);
+    return true;
+}
+
+/**
+ * @brief 获取今天的农历日期
+ * @param[out] out 农历日期
+ * @return bool 尚未换算时返回 false
+ */
+bool app_lunar_today(App_Lunar_Date_t *out)
+{
+    if (lunar_valid) {
+        *out = lunar;
+    }
+    return lunar_valid;
+}
+
+/**
+ * @brief 获取今天的农历日期的序号
+ * @return uint8_t 序号
+ */
+uint8_t app_lunar_seq(void)
+{
+    return lunar_seq_no;
+}
+
+/**
+ * @brief 获取今天的农历日期的显示文字
+ * @return const char* 文字
+ */
+const char *app_lunar_text(void)
+{
+    return (lunar_valid && app_i18n_language() == LANGUAGE_CN) ? lunar_text : "";
+}
+
+/** @} */
@@ -0,0 +1,76 @@
+/**
+ * @file      app_lunar.h
+ * @brief     农历日期头文件
+ * @details   支持农历 1999 年正月初一 (公历 1999-02-16) 到 2099 年，覆盖 DS3231 的公历 2000~2099 年。
+ *            每个农历年在Flash中占一个字 (各月大小、闰月和春节的公历日期)，整表约 400 字节。
+ *            换算只查一次表并逐月累加 (最多 13 个月)，与日期无关；结果在本地日期变化 (APP_BUS_TIME_DAY) 时
+ *            更新一次并缓存，日期前进一天时直接在缓存上加一天。显示文字为中文 (如 "闰四月十五")，
+ *            用中文界面字体 (APP_I18N_FONT) 绘制，英文界面下为空字符串。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_LUNAR_H
+#define __APP_LUNAR_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppLunar 农历日期
+ * @brief 查表换算的农历日期。
+ * @{
+ */
+
+/**
+ * @brief 农历日期
+ */
+typedef struct {
+    uint16_t year;  ///< 农历年 (正月初一所在的公历年)
+    uint8_t month;  ///< 月 (1~12)
+    uint8_t day;    ///< 日 (1~30)
+    bool leap;      ///< 是否为闰月
+    uint8_t index;  ///< 该月在农历年中的序号 (0 起，闰月算作单独的一个月)
+} App_Lunar_Date_t;
+
+/**
+ * @brief 订阅本地日期的变化
+ * @details 第一次换算在时间缓存同步后的第一个 APP_BUS_TIME_DAY 时进行。
+ * @return 无
+ */
+void app_lunar_init(void);
+
+/**
+ * @brief 把公历日期换算为农历日期
+ * @param[in] days 公历日期 (2000-01-01 起的天数，Time_Days_From_Civil)
+ * @param[out] out 农历日期
+ * @return bool 超出表的范围或读不到表项 (APP_ASSET_LUNAR) 时返回 false
+ */
+bool app_lunar_from_days(uint32_t days, App_Lunar_Date_t *out);
+
+/**
+ * @brief 获取今天的农历日期
+ * @param[out] out 农历日期
+ * @return bool 尚未换算时返回 false
+ */
+bool app_lunar_today(App_Lunar_Date_t *out);
+
+/**
+ * @brief 获取今天的农历日期的序号
+ * @details 每次换算后加一，供显示判断是否需要重绘。
+ * @return uint8_t 序号
+ */
+uint8_t app_lunar_seq(void);
+
+/**
+ * @brief 获取今天的农历日期的显示文字
+ * @return const char* 如 "腊月初八"、"闰四月十五"，尚未换算或界面不是中文时为空字符串
+ */
+const char *app_lunar_text(void);
+
+/** @} */
+
+#endif /* __APP_LUNAR_H */
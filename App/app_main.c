@@ -1,19 +1,63 @@
 /**
  * @file      app_main.c
  * @brief     应用层主文件
- * @details   本文件整合了项目应用层的各文件内容，并实现了自动熄屏逻辑。
+ * @details   本文件整合了项目应用层的各文件内容，并实现了自动熄屏逻辑 (熄屏前由 app_bright 渐暗)。
+ *            自动熄屏倒计时和温湿度采样由 app_timer 的软件定时器驱动，主循环的各项工作由 app_sched 按优先级调度。
+ *            夜间时段 (app_night) 内不论有无操作都熄屏，操作只点亮 APP_NIGHT_WAKE_MS。
  * @author    SandOcean
- * @date      2025-09-17
- * @version   1.1
+ * @date      2025-10-08
+ * @version   1.3
  * @copyright Copyright (c) 2025 SandOcean
  */ 
 
 #include "app_main.h"
 #include "app_settings.h"
+#include "app_persist.h"
+#include "app_drift.h"
+#include "app_alarm.h"
+#include "app_chrono.h"
+#include "app_baro.h"
+#include "app_history.h"
+#include "app_datalog.h"
+#include "app_asset.h"
+#include "app_usage.h"
+#include "app_astro.h"
+#include "app_lunar.h"
+#include "app_sound.h"
+#include "app_sensor.h"
+#include "app_battery.h"
+#include "app_timer.h"
+#include "app_bus.h"
+#include "app_sched.h"
+#include "app_remote.h"
+#include "app_mirror.h"
+#include "app_resume.h"
+#include "app_bench.h"
+#include "app_soak.h"
+#include "app_panel.h"
+#include "ui_gray.h"
 #include "DS3231.h"
 #include "AHT20.h"
+#include "i2c_bus.h"
+#include "radio_time.h"
+#include "supply.h"
+#include "light.h"
+#include "fb_dma.h"
+#include "timebase.h"
+#include "app_power.h"
+#include "usb_cdc.h"
+#include "app_bright.h"
+#include "app_perf.h"
+#include "app_night.h"
+#include "profiler.h"
+#include "trace.h"
+#include "mark.h"
 #include "input.h"
+#include "input_replay.h"
 #include "app_display.h"
+#include "app_anim.h"
+#include "app_i18n.h"
+#include "app_fmt.h"
 #include <stdbool.h>
 
 /**
@@ -22,21 +66,98 @@
  * @{
  */
 
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 屏幕状态
+ */
+typedef enum {
+    SCREEN_ON = 0,  ///< 屏幕点亮，正常显示页面
+    SCREEN_AMBIENT, ///< 低功耗时钟：最低对比度，每分钟重绘一次，其余时间停止模式
+    SCREEN_OFF      ///< 显示器关闭，主页仍每分钟在关闭的屏幕上重绘，点亮时立即可见
+} Screen_State_e;
+
+/**
+ * @brief 主循环的任务，枚举值即在任务表中的下标和优先级 (0最高)
+ */
+enum {
+    TASK_INPUT = 0, ///< 用户活动、唤醒和自动熄屏
+    TASK_SYSTEM,    ///< RTC时间缓存、闹钟、授时接收、I2C总线队列、数据总线
+    TASK_UI,        ///< 亮度调度和页面绘制
+    TASK_SENSOR,    ///< 软件定时器、温湿度测量、温度历史和供电电压
+    TASK_STORE,     ///< 设置加载、对时误差日志和使用统计
+    TASK_TELEMETRY, ///< 远程命令、性能统计和跟踪
+    TASK_COUNT
+};
+
+#define TASK_EV_INPUT APP_SCHED_EV_USER ///< 输入中断有新事件
+#define TASK_EV_RADIO APP_SCHED_EV_USER ///< 授时接收中断交出了一帧
+#define TASK_EV_SUPPLY APP_SCHED_EV_USER ///< 供电电压测量完成
+#define TASK_EV_LIGHT APP_SCHED_EV_USER ///< 环境光等级变化，待分发
+
 /* Private variables ---------------------------------------------------------*/
-static uint32_t last_activity_time = 0; ///< 记录最后一次用户活动的时间戳
-static bool is_screen_on = true;        ///< 记录当前屏幕是否点亮
+static Screen_State_e screen_state = SCREEN_ON; ///< 记录当前的屏幕状态
 static uint32_t auto_off_timeout_ms = 0;  ///< 自动熄屏的超时时间 (ms)，0表示永不熄屏
 bool g_settings_load_failed = false;    ///< 指示设置加载是否失败的全局标志
+static uint32_t last_sensor_start = 0;  ///< 上一次触发温湿度测量的时间戳
+static App_Timer_t sensor_timer;        ///< 下一次触发温湿度测量 (可推迟，熄屏时不为它唤醒)
+static App_Timer_t auto_off_timer;      ///< 自动熄屏倒计时，最后一次活动时重新开始
+static bool sensor_started = false;     ///< 是否已经触发过第一次测量
+static bool settings_ready = false;     ///< 后台设置加载是否已完成
+static bool wake_input_held = false;    ///< 唤醒屏幕的那次操作尚未结束，其间产生的输入事件全部丢弃
+static App_Bus_Sub_t settings_sub;      ///< 设置变化时重新读取自动熄屏时间
+static App_Bus_Sub_t alert_sub;         ///< 温湿度越限状态变化时提示
+static App_Bus_Sub_t light_sub;         ///< 环境光等级变化时重新计算亮度
+static App_Bus_Sub_t night_sub;         ///< 进入或离开夜间时段时熄屏或点亮
+static uint8_t alert_shown = 0;         ///< 已经提示过的越限状态 (App_Sensor_Alert_e 的位)
+static char alert_text[32];             ///< 越限提示的文字，提示框显示期间须保持有效
+static Epoch_t time_published;          ///< 上一次发布时间主题时缓存中的纪元秒
+static bool time_published_valid = false; ///< time_published 是否有效
+static uint32_t time_published_day;       ///< 上一次发布时间主题时的本地日期 (2000-01-01 起的天数)
 
 /* Private function prototypes -----------------------------------------------*/
+static void task_input(uint32_t events);
+static void task_system(uint32_t events);
+static void task_ui(uint32_t events);
+static void task_sensor(uint32_t events);
+static void task_store(uint32_t events);
+static void task_telemetry(uint32_t events);
 static void update_auto_off_timeout(void);
+static void restart_auto_off(void);
+static void settings_changed(App_Bus_Topic_e topic, void *arg);
+static void light_changed(App_Bus_Topic_e topic, void *arg);
+static void night_changed(App_Bus_Topic_e topic, void *arg);
+static void alert_changed(App_Bus_Topic_e topic, void *arg);
+static void show_sensor_alert(void);
+static void publish_time(void);
+static void auto_off_expired(void *arg);
+static void sensor_start_due(void *arg);
 static void check_user_activity(void);
+static void wake_screen(void);
 static void handle_auto_off(void);
+static void enter_screen_idle(void);
+static void handle_alarm(void);
+static void handle_sensor(void);
+static void handle_settings(void);
+static uint32_t next_deadline(void);
+static bool idle_allow_stop(void);
+
+/**
+ * @brief 任务表，全部为轮询式 (每一轮都运行一次)
+ */
+static const App_Sched_Task_t app_tasks[TASK_COUNT] = {
+    [TASK_INPUT]     = { task_input,     "input",     true },
+    [TASK_SYSTEM]    = { task_system,    "system",    true },
+    [TASK_UI]        = { task_ui,        "ui",        true },
+    [TASK_SENSOR]    = { task_sensor,    "sensor",    true },
+    [TASK_STORE]     = { task_store,     "store",     true },
+    [TASK_TELEMETRY] = { task_telemetry, "telemetry", true },
+};
 
 /**
  * @brief 将设置中的索引转换为具体的超时毫秒数
  * @details 从全局设置 `g_app_settings` 中读取 `auto_off` 索引，
  *          并将其转换为对应的毫秒数，存入静态变量 `auto_off_timeout_ms`。
+ *          夜间时段内不超过 APP_NIGHT_WAKE_MS (设置为 "Never" 时也是)。
  * @return 无
  */
 static void update_auto_off_timeout(void)
@@ -50,107 +171,778 @@ static void update_auto_off_timeout(void)
         case 4: auto_off_timeout_ms = 600000; break;     // 4: 10min
         default: auto_off_timeout_ms = 0; break;
     }
+    if (app_night_active() && (auto_off_timeout_ms == 0 || auto_off_timeout_ms > APP_NIGHT_WAKE_MS)) {
+        auto_off_timeout_ms = APP_NIGHT_WAKE_MS;
+    }
+}
+
+/**
+ * @brief 重新开始自动熄屏倒计时
+ * @details 超时时间在设置变化的通知中更新，设置为 "Never" 时停止倒计时。
+ * @return 无
+ */
+static void restart_auto_off(void)
+{
+    if (auto_off_timeout_ms == 0) {
+        app_timer_stop(&auto_off_timer);
+    } else {
+        app_timer_start(&auto_off_timer, auto_off_timeout_ms, 0, auto_off_expired, NULL, 0);
+    }
+}
+
+/**
+ * @brief 设置被修改或加载完成的通知
+ * @details 重新读取自动熄屏时间；亮屏时按新的时间重新开始倒计时 (用户或远程命令刚刚修改了它)，
+ *          并立即应用新的亮度模式和显示模式。
+ * @param[in] topic 未使用
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void settings_changed(App_Bus_Topic_e topic, void *arg)
+{
+    (void)topic;
+    (void)arg;
+    update_auto_off_timeout();
+    if (screen_state == SCREEN_ON) {
+        restart_auto_off();
+        app_bright_refresh();
+    }
+}
+
+/**
+ * @brief 环境光等级变化的通知
+ * @details 亮屏时立即重新计算目标对比度，从当前值渐变过去 (不必等到每秒一次的重新计算)。
+ * @param[in] topic 未使用
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void light_changed(App_Bus_Topic_e topic, void *arg)
+{
+    (void)topic;
+    (void)arg;
+    if (screen_state == SCREEN_ON) {
+        app_bright_refresh();
+    }
+}
+
+/**
+ * @brief 进入或离开夜间时段的通知
+ * @details 进入时按时段内的亮屏时间重新计算超时，亮屏时立即开始渐暗 (响铃期间由 handle_alarm() 推迟)，
+ *          渐暗完成后 enter_screen_idle() 按时段的显示方式熄屏；已经熄屏时保持不变，下一次熄屏时按新的显示方式。
+ *          离开时点亮屏幕并回到熄屏前的页面，之后按设置的自动熄屏时间倒计时。
+ * @param[in] topic 未使用
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void night_changed(App_Bus_Topic_e topic, void *arg)
+{
+    (void)topic;
+    (void)arg;
+    update_auto_off_timeout();
+    if (app_night_active()) {
+        if (screen_state == SCREEN_ON) {
+            app_timer_stop(&auto_off_timer);
+            auto_off_expired(NULL);
+        }
+        return;
+    }
+    if (screen_state != SCREEN_ON) {
+        wake_screen();
+        if (!app_resume_restore()) {
+            Page_Manager_Go_Home(); // 从低功耗时钟换回主页
+        }
+    }
+    restart_auto_off();
+}
+
+/**
+ * @brief 温湿度越限状态变化的通知
+ * @param[in] topic 未使用
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void alert_changed(App_Bus_Topic_e topic, void *arg)
+{
+    (void)topic;
+    (void)arg;
+    show_sensor_alert();
+}
+
+/**
+ * @brief 新出现的温湿度越限弹出提示
+ * @details 只提示新置位的状态 (同时出现多个时提示第一个)，持续越限或解除时不提示。
+ *          熄屏和低功耗时钟期间不提示，点亮时提示仍未解除的越限；期间已经解除的不再提示。
+ * @return 无
+ */
+static void show_sensor_alert(void)
+{
+    static const struct {
+        uint8_t bit;
+        App_Str_t str;
+    } alert_msgs[] = {
+        {APP_SENSOR_ALERT_TEMP_LOW,  STR_MSG_TOO_COLD},
+        {APP_SENSOR_ALERT_TEMP_HIGH, STR_MSG_TOO_WARM},
+        {APP_SENSOR_ALERT_HUMI_LOW,  STR_MSG_TOO_DRY},
+        {APP_SENSOR_ALERT_HUMI_HIGH, STR_MSG_TOO_HUMID},
+    };
+    const AHT20_Data_t *env = app_sensor_get();
+    uint8_t alert = app_sensor_alert();
+    uint8_t raised;
+    char *p;
+
+    if (screen_state != SCREEN_ON) {
+        alert_shown &= alert; // 期间解除的状态再次出现时重新提示
+        return;
+    }
+    raised = alert & (uint8_t)~alert_shown;
+    alert_shown = alert;
+    for (uint8_t i = 0; i < sizeof(alert_msgs) / sizeof(alert_msgs[0]); i++) {
+        if (raised & alert_msgs[i].bit) {
+            p = fmt_str(alert_text, app_str(alert_msgs[i].str));
+            p = fmt_char(p, '\n');
+            if (alert_msgs[i].bit & (APP_SENSOR_ALERT_TEMP_LOW | APP_SENSOR_ALERT_TEMP_HIGH)) {
+                fmt_char(fmt_q1(p, env->temperature_cdeg / 10), 'C');
+            } else {
+                fmt_char(fmt_q1(p, env->humidity_pm), '%');
+            }
+            Page_Toast(alert_text, 3000, NULL);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 时间缓存进入新的一秒、一分钟或一天时发布时间主题
+ * @details 比较的是缓存中的纪元秒，SQW脉冲推进和设置时间都算作变化；缓存尚未同步时不发布。
+ * @return 无
+ */
+static void publish_time(void)
+{
+    DS3231_Cache_Snap_t snap;
+
+    if (!DS3231_Cache_Get(&snap) || (time_published_valid && snap.epoch == time_published)) {
+        return;
+    }
+    app_bus_publish(APP_BUS_TIME_SECOND);
+    if (!time_published_valid || snap.epoch / 60 != time_published / 60) {
+        uint32_t day = Time_Apply_Dst(snap.epoch, g_app_settings.dst_enabled) / TIME_SECS_PER_DAY;
+
+        app_bus_publish(APP_BUS_TIME_MINUTE);
+        // 日期只可能在整分钟时变化 (包括夏令时切换和对时)
+        if (!time_published_valid || day != time_published_day) {
+            app_bus_publish(APP_BUS_TIME_DAY);
+            time_published_day = day;
+        }
+    }
+    time_published = snap.epoch;
+    time_published_valid = true;
+}
+
+/**
+ * @brief 自动熄屏倒计时到期
+ * @details 开始渐暗，渐暗完成后由 handle_auto_off() 进入熄屏状态。
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void auto_off_expired(void *arg)
+{
+    (void)arg;
+    if (screen_state == SCREEN_ON && !app_bright_is_fading()) {
+        app_bright_fade_out();
+    }
 }
 
 /**
  * @brief 检查并处理用户输入活动
- * @details 如果检测到任何用户输入事件，则重置最后活动时间戳。
- *          如果屏幕当前是关闭的，则此次输入将仅用于唤醒屏幕，事件本身会被清除。
+ * @details 如果检测到任何用户输入事件，则重新开始自动熄屏倒计时。
+ *          如果屏幕当前是关闭的或处于低功耗时钟，则此次操作将仅用于唤醒屏幕并回到熄屏前的页面 (见 app_resume.h)：
+ *          按键或编码器的第一个边沿启动扫描后立即唤醒，不等待消抖和单击/双击判定产生事件；
+ *          直到扫描停止 (按键松开、编码器静止) 之前产生的事件都会被清除，防止其被页面逻辑处理。
  * @return 无
  */
 static void check_user_activity(void)
 {
+    // 熄屏时扫描定时器只会由 EXTI 边沿启动
+    if (screen_state != SCREEN_ON && !input_is_idle()) {
+        wake_screen();
+        if (!app_resume_restore()) {
+            Page_Manager_Go_Home(); // 从低功耗时钟换回主页
+        }
+        wake_input_held = true;
+        restart_auto_off();
+    }
+    if (wake_input_held) {
+        input_clear_events();
+        wake_input_held = !input_is_idle();
+        return;
+    }
+
     // 检查是否有输入事件
     if (input_count_events() > 0) {
-        last_activity_time = HAL_GetTick(); // 重置活动时间
-
-        // 如果屏幕已关闭，则本次输入仅用于唤醒
-        if (!is_screen_on) {
-            u8g2_SetPowerSave(&u8g2, 0); // 点亮屏幕
-            is_screen_on = true;
-            
-            // 清除本次输入事件，防止其被页面逻辑处理
+        if (app_bright_is_fading()) {
+            // 熄屏渐暗过程中的输入同样只用于唤醒，亮度渐变回来
+            app_bright_wake(false);
             input_clear_events();
         }
-        // 每次活动后，重新加载一次超时设置，以防用户刚刚修改了它
-        update_auto_off_timeout();
+        // 每次活动后重新开始倒计时
+        restart_auto_off();
+    }
+}
+
+/**
+ * @brief 从熄屏或低功耗时钟恢复亮屏
+ * @details 恢复对比度和秒脉冲，不切换页面。熄屏期间主页一直在关闭的屏幕上按分钟重绘，
+ *          显示器的显存和驱动的影子副本都是最新一帧，点亮命令发出后画面立即可见，不需要重新绘制和上传。
+ *          每分钟闹钟期间缓存只在整分推进，唤醒时在后台与RTC重新同步一次，同步完成后的下一帧更新秒数。
+ * @return 无
+ */
+static void wake_screen(void)
+{
+    if (screen_state != SCREEN_ON) {
+        app_usage_wakeup();
+    }
+    app_bright_wake(true); // 先恢复对比度，点亮时即为正常亮度
+    if (screen_state == SCREEN_OFF) {
+        u8g2_SetPowerSave(&u8g2, 0); // 点亮屏幕
+#if APP_PANEL_ENABLE
+        app_panel_power(true);
+#endif
+#if UI_GRAY_ENABLE
+        UI_Gray_Allow(true);
+#endif
     }
+    screen_state = SCREEN_ON;
+    Power_Set_Display(POWER_DISPLAY_ON);
+    DS3231_EnableSqw1Hz();
+    DS3231_Cache_Resync();
+    show_sensor_alert();
 }
 
 /**
- * @brief 处理自动熄屏的计时和执行
- * @details 检查当前时间与最后活动时间的差值是否超过设定的超时阈值。
- *          如果超时，则调用u8g2的节电函数关闭屏幕，并将页面强制返回主页。
+ * @brief 处理自动熄屏的执行
+ * @details 倒计时到期时 auto_off_expired() 开始渐暗，渐暗完成后在这里进入低功耗时钟或关闭屏幕。
  * @return 无
  */
 static void handle_auto_off(void)
 {
-    // 如果设置为 "Never" (0) 或屏幕已经关闭，则不做任何操作
-    if (auto_off_timeout_ms == 0 || !is_screen_on) {
+    // 屏幕已经关闭或处于低功耗时钟，或者没有在渐暗，不做任何操作
+    if (screen_state != SCREEN_ON || !app_bright_is_fading()) {
+        return;
+    }
+
+    // 倒计时被重新开始 (响铃、远程修改设置) 或改为 "Never" 时恢复亮度
+    if (app_timer_active(&auto_off_timer) || auto_off_timeout_ms == 0) {
+        app_bright_wake(false);
+    } else if (app_bright_is_faded()) {
+        enter_screen_idle();
+    }
+}
+
+/**
+ * @brief 渐暗完成后进入熄屏状态
+ * @details POWER_AMBIENT_ENABLE 为1时切换到低功耗时钟页面并以 POWER_AMBIENT_LEVEL 的对比度常亮；
+ *          为0时调用u8g2的节电函数关闭屏幕，并将页面强制返回主页 (显存保持，之后仍按分钟重绘)。
+ *          夜间时段内按时段的显示方式 (app_night_mode) 选择两者之一。
+ *          两种状态下都只需要分钟级的时间，RTC 的 INT/SQW 引脚切换为每分钟一次的闹钟中断，
+ *          主循环在两次闹钟 (或输入) 之间保持停止模式；切换失败或秒表、倒计时在运行时仍按秒脉冲唤醒。
+ *          尚未写入的设置修改在此时立即开始写入，页面堆栈保存到备份寄存器。
+ * @return 无
+ */
+static void enter_screen_idle(void)
+{
+    if (!app_chrono_busy()) {
+        DS3231_EnableMinuteAlarm(); // 秒表或倒计时在运行时保持秒脉冲，按键唤醒丢失的滴答在下一秒补回
+    }
+    app_settings_flush(); // 之后大部分时间处于停止模式，不再等待安静期
+    app_resume_save();    // 页面堆栈即将被清空，唤醒时从备份寄存器恢复
+
+    if (app_night_active() ? (app_night_mode() == NIGHT_MODE_AMBIENT) : POWER_AMBIENT_ENABLE) {
+        app_bright_hold(POWER_AMBIENT_LEVEL);
+        // 清空页面堆栈并直接换成低功耗时钟，下一次循环绘制
+        Page_Manager_Go_Page(&g_page_ambient);
+        screen_state = SCREEN_AMBIENT;
+        Power_Set_Display(POWER_DISPLAY_DIM);
         return;
     }
+    u8g2_SetPowerSave(&u8g2, 1); // 关闭屏幕
+#if APP_PANEL_ENABLE
+    app_panel_power(false);
+#endif
+#if UI_GRAY_ENABLE
+    UI_Gray_Allow(false); // 关闭的屏幕上只需按分钟重绘实心数字
+#endif
+    screen_state = SCREEN_OFF;
+    Power_Set_Display(POWER_DISPLAY_OFF);
+    // 熄屏后，清空页面堆栈，返回到主时钟界面；主页在关闭的屏幕上继续绘制，点亮时即为当前时间
+    Page_Manager_Go_Home();
+}
 
-    // 检查是否超时
-    if (HAL_GetTick() - last_activity_time > auto_off_timeout_ms) {
-        u8g2_SetPowerSave(&u8g2, 1); // 关闭屏幕
-        is_screen_on = false;
-        // 熄屏后，清空页面堆栈，返回到主时钟界面
-        Page_Manager_Go_Home();
+/**
+ * @brief 处理闹钟响铃
+ * @details 开始响铃时点亮屏幕并切换到响铃页面 (清空页面堆栈)；
+ *          响铃 (或倒计时到期提示) 期间不计入自动熄屏，渐暗中途响铃时恢复亮度。
+ * @return 无
+ */
+static void handle_alarm(void)
+{
+    if (app_alarm_service()) {
+        if (screen_state != SCREEN_ON) {
+            wake_screen();
+            app_resume_clear(); // 响铃结束后回到主页，不再恢复熄屏前的页面
+        }
+        Page_Manager_Go_Page(&g_page_alarm_ring);
+    }
+    if (app_alarm_is_ringing() || app_countdown_state() == APP_COUNTDOWN_RINGING) {
+        restart_auto_off();
+        if (app_bright_is_fading()) {
+            app_bright_wake(false);
+        }
     }
 }
 
+/**
+ * @brief 倒计时到期提示的通知 (覆盖 app_chrono 的弱定义)
+ * @details 与闹钟响铃相同：开始提示时点亮屏幕并切换到倒计时页面 (清空页面堆栈)，
+ *          提示期间的自动熄屏由 handle_alarm() 推迟，声音由 app_sound 播放。在 app_timer_service() 中调用。
+ * @param[in] on 开始提示为 true，停止为 false
+ * @return 无
+ */
+void app_countdown_ring(bool on)
+{
+    app_sound_countdown(on);
+    if (!on) {
+        return;
+    }
+    if (screen_state != SCREEN_ON) {
+        wake_screen();
+        app_resume_clear();
+    }
+    Page_Manager_Go_Page(&g_page_countdown);
+}
+
+/**
+ * @brief 采样定时器到期，触发一次温湿度测量
+ * @details 初始化 (上电等待、校准) 未完成或上一次测量还在进行时 AHT20_StartMeasurement 返回 HAL_BUSY，
+ *          定时器立即重新到期，下一次主循环重试。
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void sensor_start_due(void *arg)
+{
+    (void)arg;
+    if (AHT20_Is_Measuring() || AHT20_StartMeasurement() != HAL_OK) {
+        app_timer_start(&sensor_timer, 0, 0, sensor_start_due, NULL, APP_TIMER_DEFERRABLE);
+        return;
+    }
+    last_sensor_start = HAL_GetTick();
+    sensor_started = true;
+    app_timer_start(&sensor_timer, app_sensor_interval(), 0, sensor_start_due, NULL, APP_TIMER_DEFERRABLE);
+}
+
+/**
+ * @brief 推进温湿度传感器的非阻塞测量
+ * @details 测量由 sensor_timer 按 app_sensor_interval() 给出的间隔触发 (读数变化时较密，稳定时逐渐放宽)，
+ *          这里在每次主循环中轮询结果。调度与当前页面无关，熄屏时同样进行。
+ *          每次得到的新结果经 app_sensor 滤波，页面只读取滤波后的缓存值，不会再因等待转换而卡顿。
+ *          滤波后的间隔可能变化，下一次测量从这次的触发时刻起按新间隔重新排定。
+ * @return 无
+ */
+static void handle_sensor(void)
+{
+    if (AHT20_Poll()) { // 同时推进传感器的非阻塞初始化
+        uint32_t elapsed = HAL_GetTick() - last_sensor_start;
+        uint32_t interval;
+
+        app_sensor_update(AHT20_Get_Last(), screen_state == SCREEN_ON);
+        interval = app_sensor_interval();
+        app_timer_start(&sensor_timer, (interval > elapsed) ? interval - elapsed : 0, 0,
+                        sensor_start_due, NULL, APP_TIMER_DEFERRABLE);
+    }
+}
+
+/**
+ * @brief 推进设置的后台加载
+ * @details 加载完成前使用默认设置；完成后应用自动熄屏设置并在需要时提示加载失败，
+ *          页面在下一次循环中按新设置 (如夏令时) 重绘。加载成功时恢复复位前保存在备份寄存器中的页面堆栈。
+ * @return 无
+ */
+static void handle_settings(void)
+{
+    App_Settings_Load_e result;
+
+    if (settings_ready) {
+        return;
+    }
+    result = app_settings_service();
+    if (result == APP_SETTINGS_LOAD_PENDING) {
+        return;
+    }
+
+    settings_ready = true;
+    if (result == APP_SETTINGS_LOAD_DEFAULTS) {
+        g_settings_load_failed = true;
+    } else if (screen_state == SCREEN_ON) {
+        app_resume_restore(); // 复位前保存的页面堆栈 (页面可能用到设置，等加载完成后再进入)
+    }
+    // 自动熄屏时间由加载完成时发布的设置通知更新
+}
+
+/**
+ * @brief 计算主循环下一次需要工作的时间
+ * @details 亮屏时截止时间为页面管理器下一次需要运行的时刻 (Page_Manager_Next_Due)：静止的页面只需要
+ *          按 loop 的步长运行，时间变化和输入由中断唤醒，自动熄屏计时在软件定时器中；
+ *          动画和重绘期间仍每个 SysTick 运行一次。熄屏时只剩温湿度采样，截止时间为下一次采样，
+ *          测量进行中则需要每个 SysTick 轮询一次结果。熄屏和低功耗时钟时不为采样单独唤醒，
+ *          截止时间为一个RTC脉冲周期之后 (或更早到期的不可推迟的软件定时器)，
+ *          采样定时器可推迟，在到期后的第一次唤醒时进行 (每分钟闹钟时约每分钟一次)；
+ *          低功耗时钟的一帧尚未发送完时等待刷新完成。
+ * @return uint32_t 截止时间 (HAL_GetTick() 时间戳)
+ */
+static uint32_t next_deadline(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    if (app_bus_pending()) {
+        return now; // 还有尚未分发的通知
+    }
+    if (AHT20_Is_Measuring() || app_baro_busy() || !sensor_started || !settings_ready) {
+        return now + 1; // 启动阶段的后台初始化也需要每个 SysTick 推进一次
+    }
+    if (Input_Replay_Mode() == INPUT_REPLAY_PLAYING) {
+        return now + 1; // 回放的事件按毫秒到期
+    }
+#if U8G2_BUFFER_MODE == 0
+    if (u8g2_stm32_IsFlushBusy()) {
+        return now + 1; // 低功耗时钟的一帧还在发送 (或等待补发)
+    }
+#endif
+    uint32_t deadline = now + DS3231_SQW_Get_Period();
+    uint32_t expires;
+    if (screen_state == SCREEN_ON) {
+        deadline = Page_Manager_Next_Due(now);
+    }
+    if (app_timer_next(&expires) && (int32_t)(expires - deadline) < 0) {
+        deadline = expires;
+    }
+    return deadline;
+}
+
+/**
+ * @brief 空闲时能否进入停止模式
+ * @details 只在屏幕熄灭或低功耗时钟时允许；温湿度和气压测量、供电电压测量、串口通信 (含时间信标)、外部闪存的 DMA 传输、输入回放和对时写入期间需要保持时钟。
+ * @return bool 允许时返回 true
+ */
+static bool idle_allow_stop(void)
+{
+    return screen_state != SCREEN_ON && !AHT20_Is_Measuring() && !app_baro_busy() && !Supply_Is_Busy() && !app_remote_holds_uart() &&
+           !app_datalog_busy() && Input_Replay_Mode() != INPUT_REPLAY_PLAYING && !DS3231_SetTimeSync_Pending();
+}
+
+/**
+ * @brief 输入任务：按键采样、用户活动与自动熄屏
+ * @details 按键由 DMA 采样时 (INPUT_SCAN_DMA) 每一轮先处理新的采样，主循环运行时不必等 DMA 中断。
+ * @param[in] events 未使用
+ * @return 无
+ */
+static void task_input(uint32_t events)
+{
+    (void)events;
+    input_service();
+    check_user_activity();
+    handle_auto_off();
+}
+
+/**
+ * @brief 系统任务：RTC时间缓存与时间主题、闹钟、授时接收、I2C总线队列和数据总线的分发
+ * @param[in] events 未使用
+ * @return 无
+ */
+static void task_system(uint32_t events)
+{
+    (void)events;
+    DS3231_Cache_Service();
+    publish_time();
+    handle_alarm();
+    Radio_Time_Service(); // 帧须在边沿后几十毫秒内写入RTC，排在总线队列之前
+    I2C_Bus_Service(); // 启动被推迟的I2C事务，处理超时
+    app_bus_service(); // 在界面任务之前分发，页面在本轮就能看到变化
+}
+
+/**
+ * @brief 界面任务：亮度调度和页面管理器
+ * @details 屏幕点亮时按时段渐变亮度；低功耗时钟的对比度固定，页面每分钟重绘一次。
+ *          显示器关闭时同样每分钟重绘主页 (只发送变化的部分)，使唤醒时显存中已经是当前画面。
+ * @param[in] events 未使用
+ * @return 无
+ */
+static void task_ui(uint32_t events)
+{
+    (void)events;
+    if (screen_state == SCREEN_ON) {
+        app_bright_service();
+    }
+#if APP_SOAK_ENABLE
+    uint32_t t0 = Timebase_Us();
+    Page_Manager_Loop();
+    uint32_t dt = Timebase_Us() - t0;
+    if (dt >= APP_SOAK_FRAME_MIN_US) {
+        app_soak_frame(dt); // 没有绘制的循环只有几十微秒，不计入
+    }
+#else
+    Page_Manager_Loop();
+#endif
+}
+
+/**
+ * @brief 传感器任务：软件定时器、温湿度测量、温度历史、气压和供电电压
+ * @details 屏幕关闭时也保持采样。供电电压由定时器触发测量，完成后在这里分级并调整功耗设置。
+ * @param[in] events 未使用
+ * @return 无
+ */
+static void task_sensor(uint32_t events)
+{
+    (void)events;
+    PROF_BEGIN(PROF_SEC_SENSOR);
+    app_timer_service();
+    handle_sensor();
+    app_history_service();
+    app_baro_service(); // 气压样本跟随温度历史的样本时刻
+    app_battery_service();
+    PROF_END(PROF_SEC_SENSOR);
+}
+
+/**
+ * @brief 存储任务：设置加载完成后应用新设置，推进持久区的启动读取，保存对时误差日志、使用统计和长期数据记录
+ * @param[in] events 未使用
+ * @return 无
+ */
+static void task_store(uint32_t events)
+{
+    (void)events;
+    PROF_BEGIN(PROF_SEC_STORE);
+    handle_settings();
+#if APP_SOAK_ENABLE
+    if (settings_ready) {
+        app_soak_service(); // 写入设置须在加载完成之后
+    }
+#endif
+    app_persist_service();
+    app_drift_service();
+    app_usage_service();
+    app_datalog_service(); // 温度历史的新样本同时追加到外部闪存
+    PROF_END(PROF_SEC_STORE);
+}
+
+/**
+ * @brief 遥测任务：远程命令、性能统计、跟踪记录和屏幕镜像
+ * @details 远程修改设置后立即应用自动熄屏时间 (从修改时起重新计时)。
+ *          关闭 PROFILER_ENABLE / TRACE_ENABLE 时性能统计和跟踪为空，屏幕镜像只在主机请求后发送。
+ * @param[in] events 未使用
+ * @return 无
+ */
+static void task_telemetry(uint32_t events)
+{
+    (void)events;
+    if (app_remote_service()) {
+        restart_auto_off();
+    }
+    Profiler_Service();
+    Trace_Service();
+    app_mirror_service();
+}
 
 /**
  * @brief 应用主初始化函数
  * @details 此函数封装了所有硬件和软件模块的初始化过程，包括：
+ *          - I2C 总线事务队列
  *          - DS3231 RTC模块
  *          - AHT20 温湿度传感器
- *          - u8g2 显示库
+ *          - u8g2 显示库和显存批量操作 (DMA1 通道7)
  *          - 输入设备 (旋钮编码器)
  *          - 页面管理器
- *          - 加载应用设置
+ *          - 串口远程控制 (DMA循环接收)
+ *          - USB 虚拟串口 (主机打开后代替 USART1)
+ *          - 加载应用设置、漂移日志和闹钟表
+ *          各设备的上电等待都从复位开始计时，因此先启动不需要等待的部分：
+ *          读取RTC后只启动 AHT20 初始化和设置加载 (在主循环中后台完成)，
+ *          最后由 u8g2Init 等到显示器应答后初始化并绘制第一帧时钟界面。
  * @return 无
  */
 void app_main_init(void)
 {
-
-    u8g2Init(&u8g2);
+#if APP_SOAK_ENABLE
+    app_soak_init(); // 耐久测试构建：先把 uwTick 拨到回绕之前
+#endif
+    Profiler_Init();
+    Trace_Init();
+    Mark_Init();
+    I2C_Bus_Init(&hi2c1); // 所有I2C设备共用的事务队列，须最先初始化
     DS3231_Init(&hi2c1);
-    if (app_settings_init() == false) {
-        g_settings_load_failed = true;
-    }
-    AHT20_Init(&hi2c1);
-    Page_Manager_Init(&u8g2);
+    DS3231_EnableSqw1Hz();
+    DS3231_Cache_Resync(); // 第一帧之前必须拿到时间
+    AHT20_Begin(&hi2c1); // 上电等待和校准在 AHT20_Poll 中推进
+    app_timer_start(&sensor_timer, 0, 0, sensor_start_due, NULL, APP_TIMER_DEFERRABLE); // 初始化完成后立即第一次测量
+    app_baro_init(); // BMP280_ENABLE 为 0 时为空操作
+    app_settings_init_async(); // EEPROM 扫描在后台进行，完成前使用默认设置
+    app_persist_load_async(); // 使用统计、温度历史、闹钟表和漂移日志一次读入，完成前不响铃、不采样，对时不参与漂移估计
+    app_datalog_init(); // W25Q_ENABLE 为 0 时为空操作，否则扫描外部闪存的扇区 (约5ms)
+    app_asset_init(); // 同上，否则校验闪存末尾的资源块 (每KB约0.5ms)
+    app_astro_init(); // 日出日落和月相在时间同步后的第一个 APP_BUS_TIME_DAY 时计算
+    app_lunar_init(); // 农历日期同上，之后每天加一天
+    app_sound_init(); // 蜂鸣器和整点报时，响铃由闹钟和倒计时通知
+    app_sched_init(app_tasks, TASK_COUNT); // 须在输入中断开始发送事件之前
     input_init(&htim3, &htim2);
+    Radio_Time_Init();
+    Supply_Init();
+    Light_Init(); // 启用时 ADC1 由它持续采样，供电电压也从它的序列中取得
+    app_battery_init(); // 第一次测量立即开始，电量低时启动后的第一轮主循环即进入低电量模式
+    Power_Init();
+    app_remote_init();
+    USB_CDC_Init(); // 须在串口接收启动之后，打开虚拟串口时由它切换接收
+    Fb_Dma_Init(); // 页面管理器清空和拷贝显存时使用
+    u8g2Init(&u8g2); // 只等待到显示器应答为止，期间 EEPROM 扫描照常进行
+    app_resume_init();
+    app_bright_init(); // 设置加载完成前按默认的自动亮度，之后在一秒内渐变到设置的亮度
+    app_perf_init(); // 设置加载完成前按均衡配置，之后每次设置变化时更新动画时长比例
+    app_night_init(); // 时间同步后的第一个 APP_BUS_TIME_DAY 时判断，之后只在时段的边界上由定时器唤醒
+    Page_Manager_Init(&u8g2);
+#if APP_PANEL_ENABLE
+    app_panel_init(); // 副显示器没有应答时只使用主显示器
+#endif
 
-    // 初始化最后活动时间
-    last_activity_time = HAL_GetTick();
-    // 根据设置更新超时时间
+    // 根据设置开始自动熄屏倒计时，之后每次设置变化时更新
+    app_bus_subscribe(&settings_sub, APP_BUS_SETTINGS_CHANGED, settings_changed, NULL);
+    app_bus_subscribe(&alert_sub, APP_BUS_SENSOR_ALERT, alert_changed, NULL);
+    app_bus_subscribe(&light_sub, APP_BUS_LIGHT_CHANGED, light_changed, NULL);
+    app_bus_subscribe(&night_sub, APP_BUS_NIGHT_CHANGED, night_changed, NULL);
     update_auto_off_timeout();
-    is_screen_on = true; // 初始时屏幕点亮
+    restart_auto_off();
+    screen_state = SCREEN_ON; // 初始时屏幕点亮
+#if APP_BENCH_ENABLE
+    app_bench_run(&u8g2); // 基准测试构建：设置加载完成之前测量，结果不受保存的设置影响
+#endif
 }
 
 /**
  * @brief 应用主循环函数
- * @details 该函数应在STM32主循环 `while(1)` 中被周期性调用。它负责：
- *          1. 检查用户活动以实现屏幕唤醒和重置自动熄屏计时器。
- *          2. 处理自动熄屏倒计时和执行熄屏操作。
- *          3. 在屏幕点亮时，驱动页面管理器的主循环。
+ * @details 该函数应在STM32主循环 `while(1)` 中被周期性调用。每次调用由 app_sched 运行一轮任务
+ *          (见 app_tasks，按优先级从高到低)：
+ *          - 输入：检查用户活动以实现屏幕唤醒和重置自动熄屏计时器，渐暗完成后熄屏；输入中断另外唤醒本任务。
+ *          - 系统：维护由SQW中断推进的RTC时间缓存，到时响铃，维护I2C总线队列 (推迟的事务和超时)。
+ *          - 界面：在屏幕点亮时调度屏幕亮度，点亮或处于低功耗时钟时驱动页面管理器的主循环。
+ *          - 传感器：执行到期的软件定时器 (温湿度采样、供电电压测量、自动熄屏倒计时)，推进温湿度测量，记录温度历史，按供电电压调整功耗设置。
+ *          - 存储：推进启动时的后台设置加载，保存对时误差日志。
+ *          - 遥测：执行串口收到的远程命令，周期性输出性能统计，串口空闲时发送跟踪记录。
+ *          每个任务运行前都重新选择，后台任务再慢，输入到达后最多等待一个正在运行的任务。
+ *          一轮结束后没有待处理事件时进入低功耗模式：亮屏时睡眠，熄屏或低功耗时钟时停止，由 EXTI/SQW 唤醒。
  * @return 无
  */
 void app_main_loop(void)
 {
-    // 1. 检查用户输入，并在有活动时重置计时器
-    check_user_activity();
+    PROF_COUNT(PROF_CNT_LOOP);
 
-    // 2. 处理自动熄屏逻辑
-    handle_auto_off();
+    // 收到输入或有动画时先切回全速，再处理本轮的任务；录制和回放期间保持全速，使两次运行的时序相同
+    Power_Clock_Service(!input_is_idle() || Anim_Tween_Any_Active() ||
+                        Page_Manager_Is_Animating() || app_remote_is_active() ||
+                        Input_Replay_Mode() != INPUT_REPLAY_OFF);
+
+    app_sched_run();
+
+    // 等待下一次中断或截止时间；一轮中途收到的事件留到下一轮立即处理
+    Power_Idle(app_sched_pending() ? HAL_GetTick() : next_deadline(), idle_allow_stop());
+}
+
+#if APP_SCHED_RTOS
+/**
+ * @brief 轮询式任务线程下一次运行的时刻
+ * @details 重新定义 app_sched.c 中的弱函数，与主循环配置中的睡眠截止时间相同。
+ * @return uint32_t HAL_GetTick() 时间戳
+ */
+uint32_t app_sched_poll_deadline(void)
+{
+    return next_deadline();
+}
+
+/**
+ * @brief 内核空闲时睡眠
+ * @details 重新定义 app_sched.c 中的弱函数，与主循环配置一样由 Power_Idle 选择睡眠或停止模式。
+ * @param[in] ticks 内核允许睡眠的最长时间 (ms)
+ * @return 无
+ */
+void app_sched_idle_callback(uint32_t ticks)
+{
+    Power_Idle(HAL_GetTick() + ticks, idle_allow_stop());
+}
+#endif
 
-    // 3. 只有在屏幕点亮时才更新和绘制UI
-    if (is_screen_on) {
-        Page_Manager_Loop();
+/**
+ * @brief 新的输入事件入队 (中断上下文)
+ * @details 重新定义 input.c 中的弱函数，唤醒输入任务。
+ * @return 无
+ */
+void input_event_callback(void)
+{
+    app_sched_signal(TASK_INPUT, TASK_EV_INPUT);
+}
+
+/**
+ * @brief 授时接收交出了一帧 (中断上下文)
+ * @details 重新定义 radio_time.c 中的弱函数，唤醒系统任务，使帧在边沿之后尽快写入RTC。
+ * @return 无
+ */
+void Radio_Frame_Callback(void)
+{
+    app_sched_signal(TASK_SYSTEM, TASK_EV_RADIO);
+}
+
+/**
+ * @brief 供电电压测量完成 (DMA 中断上下文)
+ * @details 重新定义 supply.c 中的弱函数，唤醒传感器任务。
+ * @return 无
+ */
+void Supply_Done_Callback(void)
+{
+    app_sched_signal(TASK_SENSOR, TASK_EV_SUPPLY);
+}
+
+#if LIGHT_ENABLE
+/**
+ * @brief 环境光等级变化 (DMA 中断上下文)
+ * @details 重新定义 light.c 中的弱函数，发布 APP_BUS_LIGHT_CHANGED 并唤醒分发它的系统任务。
+ * @return 无
+ */
+void Light_Changed_Callback(void)
+{
+    app_bus_publish(APP_BUS_LIGHT_CHANGED);
+    app_sched_signal(TASK_SYSTEM, TASK_EV_LIGHT);
+}
+
+/**
+ * @brief 环境光亮度 (覆盖 app_bright 的弱定义)
+ * @details 等级 0 为 1/LIGHT_LEVELS，最高一级为 255 (不调暗)。只读取中断中算好的等级，不访问 ADC。
+ * @return uint8_t 环境光亮度
+ */
+uint8_t app_bright_ambient(void)
+{
+    return (uint8_t)((Light_Get_Level() + 1U) * 255U / LIGHT_LEVELS);
+}
+#endif
+
+#if POWER_PVD_ENABLE
+/**
+ * @brief 供电电压即将不足 (PVD 中断上下文)
+ * @details 重新定义 app_power.c 中的弱函数。先写备份寄存器 (约 1us，有 VBAT 时复位后仍在)，
+ *          再以一次页写入保存安静期内尚未写入的设置。熄屏状态下页面堆栈已在熄屏时保存，不再覆盖。
+ * @return 无
+ */
+void Power_Fail_Callback(void)
+{
+    if (screen_state == SCREEN_ON) {
+        app_resume_save();
     }
+    app_settings_power_fail();
 }
+#endif
 
 /**
  * @}
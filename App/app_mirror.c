@@ -0,0 +1,244 @@
+/**
+ * @file      app_mirror.c
+ * @brief     远程屏幕镜像实现
+ * @details   每个区间单独成帧，帧中带有页和起始列，主机不需要按顺序收到所有帧；
+ *            帧序号只用于发现丢帧。屏幕上大片的空白和实心区域在 RLE 后只有几个字节，
+ *            时钟页面每秒的变化通常只有几十字节。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_mirror.h"
+#include "app_store.h"
+#include "cobs.h"
+#include "uart.h"
+#include "u8g2_stm32_hal.h"
+
+/**
+ * @addtogroup AppMirror
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define MIRROR_HEADER_SIZE  5    ///< 类型 + 序号 + 起始行 + 页 + 起始列
+#define MIRROR_RLE_MAX      (U8G2_FRAME_PAGE_WIDTH + 1) ///< 一页 RLE 后的最大长度 (全部为原样字节时)
+#define MIRROR_PAYLOAD_MAX  (MIRROR_HEADER_SIZE + MIRROR_RLE_MAX + 2) ///< 最长的负载
+#define MIRROR_FRAME_MAX    (COBS_ENCODED_MAX(MIRROR_PAYLOAD_MAX) + 2) ///< 最长的帧 (含前后分隔符)
+#define MIRROR_LITERAL_MAX  128  ///< 一个原样段的最大长度
+#define MIRROR_RUN_MIN      3    ///< 编为重复段的最短长度
+#define MIRROR_RUN_MAX      (MIRROR_RUN_MIN + 0x7F) ///< 一个重复段的最大长度
+#define MIRROR_LINE_UNKNOWN 0xFF ///< 主机不知道当前的起始行
+
+#if U8G2_BUFFER_MODE == 0
+
+/* Private variables ---------------------------------------------------------*/
+static bool mirror_on;                          ///< 是否正在镜像
+static uint32_t lease_start;                    ///< 最近一次开始或续约的时间戳
+static uint8_t mirror_seq;                      ///< 下一帧的序号
+static uint8_t line_sent;                       ///< 最近一次发出的起始行
+static uint8_t mirror_payload[MIRROR_PAYLOAD_MAX]; ///< 正在组装的负载
+static uint8_t mirror_frame[MIRROR_FRAME_MAX];     ///< 编码后的帧
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t *rle_literal(uint8_t *dst, const uint8_t *src, uint8_t len);
+static uint16_t rle_encode(const uint8_t *src, uint8_t len, uint8_t *dst);
+static bool mirror_send(const uint8_t *row, uint8_t line, uint8_t page, uint8_t x0, uint8_t x1);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 输出原样段
+ * @details 超过 MIRROR_LITERAL_MAX 时拆成多段。
+ * @param[out] dst 输出位置
+ * @param[in] src 原样字节
+ * @param[in] len 长度
+ * @return uint8_t* 输出结尾的位置
+ */
+static uint8_t *rle_literal(uint8_t *dst, const uint8_t *src, uint8_t len)
+{
+    while (len > 0) {
+        uint8_t n = (len > MIRROR_LITERAL_MAX) ? MIRROR_LITERAL_MAX : len;
+        *dst++ = (uint8_t)(n - 1);
+        for (uint8_t i = 0; i < n; i++) {
+            *dst++ = src[i];
+        }
+        src += n;
+        len -= n;
+    }
+    return dst;
+}
+
+/**
+ * @brief RLE 压缩一段字节
+ * @details 连续 MIRROR_RUN_MIN 个以上相同的字节编为重复段 (2 字节)，其余并入原样段。
+ *          每个重复段至少节省 1 字节，多出的只有原样段的控制字节，一页 (128 字节) 最多 129 字节。
+ * @param[in] src 输入
+ * @param[in] len 输入长度 (不超过 U8G2_FRAME_PAGE_WIDTH)
+ * @param[out] dst 输出 (至少 MIRROR_RLE_MAX 字节)
+ * @return uint16_t 输出长度
+ */
+static uint16_t rle_encode(const uint8_t *src, uint8_t len, uint8_t *dst)
+{
+    uint8_t *out = dst;
+    uint8_t lit = 0;
+    uint8_t i = 0;
+
+    while (i < len) {
+        uint8_t run = 1;
+        while (i + run < len && src[i + run] == src[i] && run < MIRROR_RUN_MAX) {
+            run++;
+        }
+        if (run >= MIRROR_RUN_MIN) {
+            out = rle_literal(out, &src[lit], i - lit);
+            *out++ = (uint8_t)(0x80 | (run - MIRROR_RUN_MIN));
+            *out++ = src[i];
+            lit = i + run;
+        }
+        i += run;
+    }
+    out = rle_literal(out, &src[lit], len - lit);
+    return (uint16_t)(out - dst);
+}
+
+/**
+ * @brief 把一个区间组成一帧写入串口发送缓冲区
+ * @param[in] row 该页在影子副本中的起点
+ * @param[in] line 起始行
+ * @param[in] page 页号
+ * @param[in] x0 区间起点
+ * @param[in] x1 区间终点 (不含)
+ * @return bool 已写入返回 true，发送缓冲区放不下时返回 false
+ */
+static bool mirror_send(const uint8_t *row, uint8_t line, uint8_t page, uint8_t x0, uint8_t x1)
+{
+    uint16_t len = MIRROR_HEADER_SIZE;
+    uint16_t crc;
+    uint16_t frame_len;
+
+    mirror_payload[0] = MIRROR_FRAME_TAG;
+    mirror_payload[1] = mirror_seq;
+    mirror_payload[2] = line;
+    mirror_payload[3] = page;
+    mirror_payload[4] = x0;
+    len += rle_encode(&row[x0], x1 - x0, &mirror_payload[len]);
+    crc = app_store_crc16(mirror_payload, len);
+    mirror_payload[len++] = (uint8_t)crc;
+    mirror_payload[len++] = (uint8_t)(crc >> 8);
+
+    mirror_frame[0] = 0x00;
+    frame_len = (uint16_t)(1 + COBS_Encode(mirror_payload, len, &mirror_frame[1]));
+    mirror_frame[frame_len++] = 0x00;
+
+    if (!UART_Write(mirror_frame, frame_len)) {
+        return false;
+    }
+    mirror_seq++;
+    return true;
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 开始镜像或续约
+ * @param[in] keyframe 是否整屏重发
+ * @return bool 成功返回 true
+ */
+bool app_mirror_start(bool keyframe)
+{
+    lease_start = HAL_GetTick();
+    if (!mirror_on || keyframe) {
+        mirror_on = true;
+        line_sent = MIRROR_LINE_UNKNOWN;
+        u8g2_stm32_CaptureEnable(true);
+    }
+    return true;
+}
+
+/**
+ * @brief 停止镜像
+ * @return 无
+ */
+void app_mirror_stop(void)
+{
+    mirror_on = false;
+    u8g2_stm32_CaptureEnable(false);
+}
+
+/**
+ * @brief 查询是否正在镜像
+ * @return bool 正在镜像返回 true
+ */
+bool app_mirror_active(void)
+{
+    return mirror_on;
+}
+
+/**
+ * @brief 发送变化的区间，需在主循环中周期调用
+ * @details 区间写入发送缓冲区后才清除，写不下时保留并与之后的变化合并。
+ * @return 无
+ */
+void app_mirror_service(void)
+{
+    const uint8_t *shadow;
+    uint8_t line, page, x0, x1;
+
+    if (!mirror_on) {
+        return;
+    }
+    if (HAL_GetTick() - lease_start > MIRROR_LEASE_MS) {
+        app_mirror_stop();
+        return;
+    }
+    if (!UART_Printf_Is_Idle()) {
+        return;
+    }
+
+    shadow = u8g2_stm32_GetShadow(&line);
+    for (uint8_t n = 0; n < MIRROR_BATCH; n++) {
+        bool dirty = u8g2_stm32_CaptureNext(&page, &x0, &x1);
+        if (!dirty) {
+            if (line == line_sent) {
+                break;
+            }
+            page = 0; // 只有起始行变化
+            x0 = 0;
+            x1 = 0;
+        }
+        if (!mirror_send(&shadow[page * U8G2_FRAME_PAGE_WIDTH], line, page, x0, x1)) {
+            break;
+        }
+        line_sent = line;
+        if (dirty) {
+            u8g2_stm32_CaptureDone(page);
+        }
+    }
+}
+
+#else /* U8G2_BUFFER_MODE != 0 */
+
+/* 分页模式下没有影子副本，镜像不可用 */
+bool app_mirror_start(bool keyframe)
+{
+    (void)keyframe;
+    return false;
+}
+
+void app_mirror_stop(void)
+{
+}
+
+bool app_mirror_active(void)
+{
+    return false;
+}
+
+void app_mirror_service(void)
+{
+}
+
+#endif /* U8G2_BUFFER_MODE */
+
+/** @} */
@@ -0,0 +1,73 @@
+/**
+ * @file      app_mirror.h
+ * @brief     远程屏幕镜像头文件
+ * @details   把屏幕画面经串口 (或 USB 虚拟串口) 送到主机，由 Tools/screen_mirror.py 显示。
+ *            画面取自显示适配层的影子副本，由画面捕获 (u8g2_stm32_CaptureNext) 给出每页变化的列区间，
+ *            只发送变化的部分；开始镜像或主机请求关键帧时整屏发送一次。
+ *            帧格式与跟踪帧相同为 0x00 + COBS(负载) + 0x00，
+ *            负载 = | 0xF1 | 序号 (1) | 起始行 (1) | 页 (1) | 起始列 (1) | RLE 数据 | CRC-16 (2, 小端) |，
+ *            CRC 与远程控制协议相同。RLE 数据解码后为该页从起始列开始的连续字节：
+ *            控制字节 c < 0x80 时后跟 c+1 个原样字节，c >= 0x80 时后跟一个字节，重复 c-0x80+3 次。
+ *            只有起始行变化时发送一个没有数据的帧。
+ *            镜像以租约方式开启：由远程控制命令 REMOTE_CMD_MIRROR 开始或续约，超过 MIRROR_LEASE_MS
+ *            没有续约时自动停止，主机程序退出后不会一直占用串口。只支持整帧模式 (U8G2_BUFFER_MODE 为 0)。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_MIRROR_H
+#define __APP_MIRROR_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppMirror 远程屏幕镜像
+ * @brief 把影子副本中变化的区间压缩后经串口发送。
+ * @{
+ */
+
+/**
+ * @defgroup AppMirror_Config 远程屏幕镜像配置
+ * @{
+ */
+#define MIRROR_FRAME_TAG 0xF1 ///< 镜像帧的类型字节 (跟踪帧为 0xF0，远程控制的应答为 0x81~0xC0)
+#define MIRROR_LEASE_MS  5000 ///< 最近一次开始或续约之后镜像保持的时间 (ms)
+#define MIRROR_BATCH     3    ///< 每次调用最多发送的区间数 (最长的帧约 140 字节，3 帧放得进发送缓冲区)
+/** @} */
+
+/**
+ * @brief 开始镜像或续约
+ * @details 尚未开始或 keyframe 为 true 时下一次发送整屏。
+ * @param[in] keyframe 是否整屏重发 (主机发现丢帧时请求)
+ * @return bool 开始或续约成功返回 true，分页模式下不支持，返回 false
+ */
+bool app_mirror_start(bool keyframe);
+
+/**
+ * @brief 停止镜像
+ * @return 无
+ */
+void app_mirror_stop(void);
+
+/**
+ * @brief 查询是否正在镜像
+ * @return bool 正在镜像返回 true
+ */
+bool app_mirror_active(void);
+
+/**
+ * @brief 发送变化的区间，需在主循环中周期调用
+ * @details 只在串口发送缓冲区为空时发送，每个区间整帧写入发送缓冲区，不等待发送完成，
+ *          缓冲区放不下时留到下一次调用；最多发送 MIRROR_BATCH 个区间，不阻塞主循环。
+ *          未发出的变化与之后的刷新合并，主机总是得到最新的画面。
+ * @return 无
+ */
+void app_mirror_service(void);
+
+/** @} */
+
+#endif /* __APP_MIRROR_H */
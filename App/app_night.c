@@ -0,0 +1,121 @@
+/**
+ * @file      app_night.c
+ * @brief     夜间时段实现
+ * @details   开始时刻晚于结束时刻的时段跨过午夜 (如 23:00~07:00)，两者相同或超出范围时视为不使用。
+ *            每次判断都按时间缓存的纪元秒加上这一秒 (或这一分钟) 已经过去的时间计算本地时刻，
+ *            定时器装入到下一个边界的毫秒数；对时但日期不变时，在下一个边界 (或设置修改) 时校正。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_night.h"
+#include "app_settings.h"
+#include "app_timer.h"
+#include "app_bus.h"
+#include "DS3231.h"
+#include "time_core.h"
+
+/**
+ * @addtogroup AppNight
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define NIGHT_SLOT_SECS (APP_NIGHT_SLOT_MIN * 60UL) ///< 一个半小时序号对应的秒数
+
+/* Private variables ---------------------------------------------------------*/
+static Night_Mode_e night_state = NIGHT_MODE_OFF; ///< 当前的状态 (时段外为 NIGHT_MODE_OFF)
+static App_Timer_t night_timer;                   ///< 下一个边界
+static App_Bus_Sub_t night_settings_sub;          ///< 设置修改时重新判断
+static App_Bus_Sub_t night_day_sub;               ///< 本地日期变化时重新判断
+
+/* Private function prototypes -----------------------------------------------*/
+static void night_evaluate(void);
+static void night_due(void *arg);
+static void night_refresh(App_Bus_Topic_e topic, void *arg);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 按当前时间判断是否处于时段内，并装入下一个边界
+ * @details 时间缓存尚未同步时不做判断，同步后由第一个 APP_BUS_TIME_DAY 触发。
+ * @return 无
+ */
+static void night_evaluate(void)
+{
+    DS3231_Cache_Snap_t snap;
+    uint8_t mode = APP_NIGHT_MODE(g_app_settings.night_rule);
+    uint32_t start = APP_NIGHT_START(g_app_settings.night_rule) * NIGHT_SLOT_SECS;
+    uint32_t end = g_app_settings.night_end * NIGHT_SLOT_SECS;
+    Night_Mode_e state = NIGHT_MODE_OFF;
+
+    if (!DS3231_Cache_Get(&snap)) {
+        return;
+    }
+    if (mode == NIGHT_MODE_OFF || mode >= NIGHT_MODE_COUNT || start == end ||
+        start >= TIME_SECS_PER_DAY || end >= TIME_SECS_PER_DAY) {
+        app_timer_stop(&night_timer);
+    } else {
+        uint32_t elapsed_ms = HAL_GetTick() - snap.edge_ms;
+        uint32_t now = (Time_Apply_Dst(snap.epoch, g_app_settings.dst_enabled) + elapsed_ms / 1000) % TIME_SECS_PER_DAY;
+        bool inside = (start < end) ? (now >= start && now < end) : (now >= start || now < end);
+        uint32_t next = inside ? end : start; // 不会等于 now，到下一个边界至少还有1秒
+
+        if (inside) {
+            state = (Night_Mode_e)mode;
+        }
+        app_timer_start(&night_timer, ((next + TIME_SECS_PER_DAY - now) % TIME_SECS_PER_DAY) * 1000 - elapsed_ms % 1000,
+                        0, night_due, NULL, 0);
+    }
+    if (state != night_state) {
+        night_state = state;
+        app_bus_publish(APP_BUS_NIGHT_CHANGED);
+    }
+}
+
+/**
+ * @brief 到达边界 (由 app_timer_service 调用)
+ * @details 按 RTC 时间重新判断，定时器提前到期时状态不变，重新装入剩余的时间。
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void night_due(void *arg)
+{
+    (void)arg;
+    night_evaluate();
+}
+
+/**
+ * @brief 设置修改或本地日期变化的通知
+ * @param[in] topic 未使用
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void night_refresh(App_Bus_Topic_e topic, void *arg)
+{
+    (void)topic;
+    (void)arg;
+    night_evaluate();
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+void app_night_init(void)
+{
+    app_bus_subscribe(&night_settings_sub, APP_BUS_SETTINGS_CHANGED, night_refresh, NULL);
+    app_bus_subscribe(&night_day_sub, APP_BUS_TIME_DAY, night_refresh, NULL);
+}
+
+bool app_night_active(void)
+{
+    return night_state != NIGHT_MODE_OFF;
+}
+
+Night_Mode_e app_night_mode(void)
+{
+    return night_state;
+}
+
+/** @} */
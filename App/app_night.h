@@ -0,0 +1,72 @@
+/**
+ * @file      app_night.h
+ * @brief     夜间时段头文件
+ * @details   设置中的夜间时段 (如 23:00~07:00) 内不论有无操作都熄屏，按显示方式关闭显示器或显示低功耗时钟，
+ *            期间的操作只点亮 APP_NIGHT_WAKE_MS，之后再次熄屏；离开时段时自动点亮。
+ *            时段的边界是本地时间 (已应用夏令时) 的整半小时，只在整分钟上判断：
+ *            每次判断后把下一个边界装入一个软件定时器 (app_timer，不可推迟)，主循环不逐轮检查，
+ *            熄屏期间停止模式一直保持到边界 (或输入、每分钟重绘)。定时器到期时按 RTC 时间重新判断，
+ *            提前到期 (时基补偿的误差) 时重新装入剩余的时间；设置修改和本地日期变化 (对时、夏令时切换) 时也重新判断。
+ *            状态变化时发布 APP_BUS_NIGHT_CHANGED，熄屏和唤醒由 app_main 处理。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_NIGHT_H
+#define __APP_NIGHT_H
+
+#include "main.h"
+#include "app_type.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppNight 夜间时段
+ * @brief 按时间表熄屏的时段。
+ * @{
+ */
+
+/**
+ * @defgroup AppNight_Config 夜间时段配置
+ * @{
+ */
+#define APP_NIGHT_SLOT_MIN      30    ///< 边界的粒度 (分钟)
+#define APP_NIGHT_SLOTS         48    ///< 一天中的边界数，开始和结束时刻的取值为 0 ~ APP_NIGHT_SLOTS-1
+#define APP_NIGHT_DEFAULT_START 46    ///< 默认的开始时刻 (23:00)
+#define APP_NIGHT_DEFAULT_END   14    ///< 默认的结束时刻 (07:00)
+#define APP_NIGHT_WAKE_MS       30000 ///< 时段内操作后的亮屏时间 (ms)，自动熄屏时间更短时按自动熄屏时间
+/** @} */
+
+/**
+ * @brief 由显示方式和开始时刻组成 Settings_t::night_rule
+ * @param mode 显示方式 (Night_Mode_e)
+ * @param start 开始时刻 (半小时序号)
+ */
+#define APP_NIGHT_RULE(mode, start) ((uint8_t)(((mode) << 6) | (start)))
+#define APP_NIGHT_MODE(rule)        ((uint8_t)((rule) >> 6))   ///< night_rule 中的显示方式
+#define APP_NIGHT_START(rule)       ((uint8_t)((rule) & 0x3F)) ///< night_rule 中的开始时刻
+
+/**
+ * @brief 初始化夜间时段
+ * @details 订阅设置修改和本地日期变化，时间缓存同步后的第一个 APP_BUS_TIME_DAY 时第一次判断。
+ * @return 无
+ */
+void app_night_init(void);
+
+/**
+ * @brief 查询当前是否处于夜间时段
+ * @return bool 处于启用的时段内返回 true
+ */
+bool app_night_active(void);
+
+/**
+ * @brief 获取时段内的显示方式
+ * @return Night_Mode_e 处于时段内时为设置的显示方式，否则为 NIGHT_MODE_OFF
+ */
+Night_Mode_e app_night_mode(void);
+
+/** @} */
+
+#endif /* __APP_NIGHT_H */
@@ -0,0 +1,169 @@
+/**
+ * @file      app_panel.c
+ * @brief     副显示器实现
+ * @details   绘制函数每次都画出完整的画面 (缓冲区已被页面管理器清空)，不记录上一次画了什么：
+ *            与屏幕当前内容的比较由 u8g2_stm32_SendBufferAsync 的脏区跟踪完成，
+ *            没有变化的页不发送，变化的页只发送变化的列区间。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_panel.h"
+
+#if APP_PANEL_ENABLE
+
+#include "app_display.h"
+#include "app_settings.h"
+#include "app_history.h"
+#include "app_fmt.h"
+
+/**
+ * @addtogroup AppPanel
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define PANEL_WIDTH      128 ///< 屏幕宽度
+#define PANEL_HEADER_Y   10  ///< 标题行的基线Y坐标
+#define PANEL_TIME_Y     44  ///< 时区时钟的基线Y坐标
+#define PANEL_DATE_Y     62  ///< 时区日期的基线Y坐标
+#define PANEL_GRAPH_Y0   14  ///< 温度曲线区域顶部的Y坐标
+#define PANEL_GRAPH_H    50  ///< 温度曲线区域的高度
+#define PANEL_MIN_SPAN   20  ///< 温度曲线纵轴的最小范围 (0.1°C)
+
+/* Private function prototypes -----------------------------------------------*/
+static void panel_draw(u8g2_t *u8g2);
+#if APP_PANEL_VIEW == APP_PANEL_VIEW_ZONE
+static void panel_draw_zone(u8g2_t *u8g2);
+#else
+static void panel_draw_history(u8g2_t *u8g2);
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+static u8g2_t panel_u8g2;  ///< 副显示器的u8g2实例
+static bool panel_ready;   ///< 初始化成功并已登记到页面管理器
+
+/* Function implementations --------------------------------------------------*/
+
+#if APP_PANEL_VIEW == APP_PANEL_VIEW_ZONE
+/**
+ * @brief 绘制第二时区的时间和日期
+ * @details 按分钟显示，一分钟内每次绘制的画面相同，只有分钟变化时才有数据发送。
+ * @param[in] u8g2 副显示器的u8g2实例
+ * @return 无
+ */
+static void panel_draw_zone(u8g2_t *u8g2)
+{
+    Time_t now;
+    Time_t zone;
+    char buf[12];
+    char *p;
+
+    DS3231_DST_GetCachedTime(&now, g_app_settings.dst_enabled);
+    Time_From_Epoch(Time_To_Epoch(&now) + (Epoch_t)((int32_t)APP_PANEL_ZONE_OFFSET_MIN * 60), &zone);
+
+    u8g2_SetFont(u8g2, DATE_TEMP_FONT);
+    u8g2_DrawStr(u8g2, 0, PANEL_HEADER_Y, APP_PANEL_ZONE_LABEL);
+
+    p = fmt_u2(buf, zone.hour);
+    p = fmt_char(p, ':');
+    fmt_u2(p, zone.minute);
+    u8g2_SetFont(u8g2, CLOCK_FONT);
+    u8g2_DrawStr(u8g2, (PANEL_WIDTH - u8g2_GetStrWidth(u8g2, buf)) / 2, PANEL_TIME_Y, buf);
+
+    p = fmt_u4(buf, zone.year);
+    p = fmt_char(p, '-');
+    p = fmt_u2(p, zone.month);
+    p = fmt_char(p, '-');
+    fmt_u2(p, zone.day);
+    u8g2_SetFont(u8g2, DATE_TEMP_FONT);
+    u8g2_DrawStr(u8g2, (PANEL_WIDTH - u8g2_GetStrWidth(u8g2, buf)) / 2, PANEL_DATE_Y, buf);
+}
+#else
+/**
+ * @brief 绘制 AHT20 最近的温度曲线
+ * @details 每列一个样本，最新的样本在最右列；纵轴为24小时的最低到最高温度。
+ *          画面只在记录新样本时变化 (每 APP_HISTORY_PERIOD_S 一次)，此时整条曲线左移一列，各页整页发送。
+ * @param[in] u8g2 副显示器的u8g2实例
+ * @return 无
+ */
+static void panel_draw_history(u8g2_t *u8g2)
+{
+    int16_t min, max, value;
+    int16_t y_prev = -1;
+    char buf[14];
+    char *p;
+
+    u8g2_SetFont(u8g2, DATE_TEMP_FONT);
+    u8g2_DrawStr(u8g2, 0, PANEL_HEADER_Y, "Room");
+    if (!app_history_min_max(HISTORY_SERIES_AHT20, &min, &max)) {
+        return;
+    }
+    p = fmt_q1(buf, min);
+    p = fmt_char(p, '-');
+    fmt_q1(p, max);
+    u8g2_DrawStr(u8g2, PANEL_WIDTH - u8g2_GetStrWidth(u8g2, buf), PANEL_HEADER_Y, buf);
+    if (max - min < PANEL_MIN_SPAN) {
+        max = (int16_t)(min + PANEL_MIN_SPAN);
+    }
+
+    for (int16_t x = 0; x < PANEL_WIDTH; x++) {
+        if (!app_history_get(HISTORY_SERIES_AHT20, (uint16_t)(PANEL_WIDTH - 1 - x), &value)) {
+            continue; // 样本不足一屏时左侧留空
+        }
+        int16_t y = (int16_t)(PANEL_GRAPH_Y0 + PANEL_GRAPH_H - 1 -
+                              (int32_t)(value - min) * (PANEL_GRAPH_H - 1) / (max - min));
+        if (y_prev < 0) {
+            u8g2_DrawPixel(u8g2, x, y);
+        } else {
+            u8g2_DrawLine(u8g2, x - 1, y_prev, x, y);
+        }
+        y_prev = y;
+    }
+}
+#endif
+
+/**
+ * @brief 副显示器的绘制函数 (由页面管理器调用)
+ * @param[in] u8g2 副显示器的u8g2实例
+ * @return 无
+ */
+static void panel_draw(u8g2_t *u8g2)
+{
+#if APP_PANEL_VIEW == APP_PANEL_VIEW_ZONE
+    panel_draw_zone(u8g2);
+#else
+    panel_draw_history(u8g2);
+#endif
+}
+
+/**
+ * @brief 初始化副显示器并登记到页面管理器
+ * @return 无
+ */
+void app_panel_init(void)
+{
+    if (u8g2_stm32_PanelInit(&panel_u8g2, APP_PANEL_ADDR) != HAL_OK) {
+        return; // 没有接副显示器
+    }
+    Page_Manager_Add_Panel(&panel_u8g2, panel_draw, APP_PANEL_REFRESH_MS);
+    panel_ready = true;
+}
+
+/**
+ * @brief 打开或关闭副显示器
+ * @param[in] on 打开为 true
+ * @return 无
+ */
+void app_panel_power(bool on)
+{
+    if (panel_ready) {
+        u8g2_SetPowerSave(&panel_u8g2, on ? 0 : 1);
+    }
+}
+
+/** @} */
+
+#endif /* APP_PANEL_ENABLE */
@@ -0,0 +1,69 @@
+/**
+ * @file      app_panel.h
+ * @brief     副显示器头文件
+ * @details   第二块 128x64 SSD1306 与主显示器接在同一条 I2C 总线上 (地址 0x3D，8位地址 0x7A)，
+ *            显示一项与主界面无关的读数：第二时区的时间，或 AHT20 最近的温度曲线。
+ *            副显示器由页面管理器按 APP_PANEL_REFRESH_MS 绘制 (见 Page_Manager_Add_Panel)，
+ *            刷新与主显示器一样只发送变化的列区间：时区时钟每分钟只有几个数字的列变化，
+ *            温度曲线每个采样周期才变化一次，其余时间的绘制不产生总线传输。
+ *            需要 U8G2_PANEL_COUNT 不小于 2 (多占用约 2KB RAM)。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_PANEL_H
+#define __APP_PANEL_H
+
+#include "main.h"
+#include "u8g2_stm32_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppPanel 副显示器
+ * @brief 第二块屏上的第二时区时钟或温度曲线。
+ * @{
+ */
+
+#define APP_PANEL_VIEW_ZONE    0 ///< 第二时区的时间和日期
+#define APP_PANEL_VIEW_HISTORY 1 ///< AHT20 最近的温度曲线和24小时最低、最高温度
+
+/**
+ * @defgroup AppPanel_Config 副显示器配置
+ * @{
+ */
+#ifndef APP_PANEL_ENABLE
+#define APP_PANEL_ENABLE          0      ///< 为 1 时驱动副显示器 (同时须把 U8G2_PANEL_COUNT 设为 2)
+#endif
+#define APP_PANEL_ADDR            0x7A   ///< 副显示器的8位I2C地址 (模块地址跳线选 0x3D)
+#define APP_PANEL_VIEW            APP_PANEL_VIEW_ZONE ///< 显示的内容
+#define APP_PANEL_REFRESH_MS      1000   ///< 两次绘制的最小间隔 (ms)
+#define APP_PANEL_ZONE_OFFSET_MIN (-480) ///< 第二时区相对主时钟显示时间 (含夏令时) 的偏移 (分钟)
+#define APP_PANEL_ZONE_LABEL      "UTC"  ///< 第二时区的名称
+/** @} */
+
+#if APP_PANEL_ENABLE && U8G2_PANEL_COUNT < 2
+#error "APP_PANEL_ENABLE requires U8G2_PANEL_COUNT >= 2"
+#endif
+
+/**
+ * @brief 初始化副显示器并登记到页面管理器
+ * @details 须在 u8g2Init() 和 Page_Manager_Init() 之后调用。显示器无应答时不登记，主显示器照常工作。
+ * @return 无
+ */
+void app_panel_init(void);
+
+/**
+ * @brief 打开或关闭副显示器
+ * @details 随主显示器熄屏和点亮。关闭期间仍按间隔在关闭的屏幕上绘制，点亮时即为当前画面。
+ *          初始化失败时为空操作。
+ * @param[in] on 打开为 true
+ * @return 无
+ */
+void app_panel_power(bool on);
+
+/** @} */
+
+#endif /* __APP_PANEL_H */
@@ -0,0 +1,71 @@
+/**
+ * @file      app_perf.c
+ * @brief     性能配置实现
+ * @details   省电配置把帧率限制在约30FPS、动画缩短到 60%、温湿度变化时的采样间隔加倍为30秒，
+ *            输入后只保持 100ms 的全速；流畅配置不限帧率、动画延长到 120%，输入后保持 1.5 秒全速
+ *            (连续操作之间不来回切换时钟)。均衡配置与原来的编译期常量相同。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_perf.h"
+#include "app_anim.h"
+#include "app_bus.h"
+#include "app_config.h"
+#include "app_sensor.h"
+#include "app_settings.h"
+
+/**
+ * @addtogroup AppPerf
+ * @{
+ */
+
+/* Private variables ---------------------------------------------------------*/
+///< 各性能配置的参数，按 Perf_Profile_e 索引
+static const App_Perf_t perf_table[PERF_PROFILE_COUNT] = {
+    [PERF_PROFILE_ECO]      = { STR_PERF_ECO,      33, 60,  30000,                      100 },
+    [PERF_PROFILE_BALANCED] = { STR_PERF_BALANCED, 0,  100, APP_SENSOR_INTERVAL_MIN_MS, POWER_CLOCK_HOLD_MS },
+    [PERF_PROFILE_SMOOTH]   = { STR_PERF_SMOOTH,   0,  120, APP_SENSOR_INTERVAL_MIN_MS, 1500 },
+};
+
+static App_Bus_Sub_t perf_sub; ///< 设置修改的订阅
+
+/* Private function prototypes -----------------------------------------------*/
+static void perf_apply(App_Bus_Topic_e topic, void *arg);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 设置修改的通知：把动画时长比例交给补间动画池
+ * @param[in] topic 未使用
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void perf_apply(App_Bus_Topic_e topic, void *arg)
+{
+    (void)topic;
+    (void)arg;
+    Anim_Set_Time_Scale(app_perf()->anim_pct);
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+void app_perf_init(void)
+{
+    app_bus_subscribe(&perf_sub, APP_BUS_SETTINGS_CHANGED, perf_apply, NULL);
+    perf_apply(APP_BUS_SETTINGS_CHANGED, NULL);
+}
+
+const App_Perf_t *app_perf(void)
+{
+    return app_perf_get(g_app_settings.perf_profile);
+}
+
+const App_Perf_t *app_perf_get(uint8_t profile)
+{
+    return &perf_table[(profile < PERF_PROFILE_COUNT) ? profile : PERF_PROFILE_BALANCED];
+}
+
+/** @} */
@@ -0,0 +1,66 @@
+/**
+ * @file      app_perf.h
+ * @brief     性能配置头文件
+ * @details   帧率、动画时长、温湿度采样间隔和时钟调速原来都是编译期常量，这里按设置中的性能配置
+ *            (Perf_Profile_e，在“显示”菜单中切换) 集中为一张参数表，各模块在用到时读取当前配置：
+ *            - 页面管理器：帧周期的下限 (与低电量模式的下限取较大者)；
+ *            - 补间动画：所有补间、页面切换动画和页面内按时间计算的动画 (Anim_Scaled) 的时长比例；
+ *            - 温湿度采样：读数变化时的采样间隔 (指数退避的起点)；
+ *            - 时钟调速：最后一次忙碌之后保持 72MHz 的时间。
+ *            均衡配置的参数与原来的常量相同。修改设置后随 APP_BUS_SETTINGS_CHANGED 立即生效。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_PERF_H
+#define __APP_PERF_H
+
+#include "main.h"
+#include "app_type.h"
+#include "app_i18n.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppPerf 性能配置
+ * @brief 以流畅度换取功耗的运行时参数。
+ * @{
+ */
+
+/**
+ * @brief 一个性能配置的参数
+ */
+typedef struct {
+    App_Str_t name;         ///< 名称
+    uint16_t frame_floor_ms; ///< 帧周期的下限 (ms)，0 为不限制 (仍受总线速度和页面的重绘间隔限制)
+    uint8_t anim_pct;       ///< 动画时长的比例 (%)
+    uint16_t sensor_min_ms; ///< 温湿度读数变化时的采样间隔 (ms)，不大于 APP_SENSOR_INTERVAL_MAX_MS 的一半
+    uint16_t clock_hold_ms; ///< 最后一次输入、动画或远程控制之后保持全速的时间 (ms)
+} App_Perf_t;
+
+/**
+ * @brief 初始化性能配置
+ * @details 订阅设置修改的通知，把当前配置的动画时长比例交给补间动画池。在 app_settings_init_async() 之后调用。
+ * @return 无
+ */
+void app_perf_init(void);
+
+/**
+ * @brief 获取当前的性能配置
+ * @details 设置尚未加载完成时为默认的均衡配置。
+ * @return const App_Perf_t* 参数 (只读)
+ */
+const App_Perf_t *app_perf(void);
+
+/**
+ * @brief 获取一个性能配置的参数
+ * @param[in] profile 性能配置 (Perf_Profile_e)，越界时返回均衡配置
+ * @return const App_Perf_t* 参数 (只读)
+ */
+const App_Perf_t *app_perf_get(uint8_t profile);
+
+/** @} */
+
+#endif /* __APP_PERF_H */
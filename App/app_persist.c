@@ -0,0 +1,165 @@
+/**
+ * @file      app_persist.c
+ * @brief     持久区目录与启动加载
+ * @details   目录由各模块头文件中的地址组成，编译期检查各区域依次相接、与页对齐并放得进镜像。
+ *            读取直接使用 AT24C32 而不经过 eeprom_bd：一次读入的 30 页放不进块设备的缓存，
+ *            镜像本身就是各模块的 RAM 副本。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_persist.h"
+#include "app_usage.h"
+#include "app_history.h"
+#include "app_alarm.h"
+#include "app_drift.h"
+#include "hw_crc.h"
+#include <string.h>
+
+/**
+ * @addtogroup AppPersist
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define PERSIST_USAGE_END (APP_USAGE_TALLY_ADDR + AT24C32_PAGE_SIZE) ///< 使用统计区的结束地址 (小时计数页之后)
+
+/** 编译期检查：各区域依次相接直到 EEPROM 末尾，每个区域都从页边界开始 */
+typedef char persist_base_check[(APP_USAGE_BASE_ADDR == APP_PERSIST_BASE_ADDR) ? 1 : -1];
+typedef char persist_usage_check[(PERSIST_USAGE_END == APP_HISTORY_BASE_ADDR) ? 1 : -1];
+typedef char persist_history_check[(APP_HISTORY_BASE_ADDR + APP_HISTORY_LOG_SIZE == APP_ALARM_BASE_ADDR) ? 1 : -1];
+typedef char persist_alarm_check[(APP_ALARM_BASE_ADDR + APP_ALARM_TABLE_SIZE == APP_DRIFT_BASE_ADDR) ? 1 : -1];
+typedef char persist_drift_check[(APP_DRIFT_BASE_ADDR + APP_DRIFT_LOG_SIZE == APP_PERSIST_END_ADDR) ? 1 : -1];
+typedef char persist_align_check[(APP_PERSIST_BASE_ADDR % AT24C32_PAGE_SIZE == 0 &&
+                                  APP_HISTORY_BASE_ADDR % AT24C32_PAGE_SIZE == 0 &&
+                                  APP_ALARM_BASE_ADDR % AT24C32_PAGE_SIZE == 0 &&
+                                  APP_DRIFT_BASE_ADDR % AT24C32_PAGE_SIZE == 0) ? 1 : -1];
+
+/* Private variables ---------------------------------------------------------*/
+uint32_t app_persist_image[APP_PERSIST_SIZE / 4]; ///< 持久区的 RAM 镜像
+
+static App_Persist_State_e persist_state; ///< 加载状态
+static volatile bool read_done;           ///< 读取已完成
+static volatile bool read_ok;             ///< 读取是否成功
+static bool read_retry;                   ///< 读取未能提交或失败，须重新提交
+static uint8_t read_failures;             ///< 已失败的读取次数
+static uint32_t retry_at;                 ///< 上一次提交 (或失败) 的时间
+
+/* Private function prototypes -----------------------------------------------*/
+static void persist_read_cb(HAL_StatusTypeDef status, void *ctx);
+static void persist_submit(void);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 读取的完成回调 (I2C中断上下文)
+ * @details 只记录结果，各区域的校验在所属模块的维护函数中进行。
+ * @param[in] status 事务结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void persist_read_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+
+    read_ok = (status == HAL_OK);
+    read_done = true;
+}
+
+/**
+ * @brief 提交覆盖全部持久区的一次读取
+ * @return 无
+ */
+static void persist_submit(void)
+{
+    read_done = false;
+    retry_at = HAL_GetTick();
+    read_retry = (AT24C32_ReadPage_Async(APP_PERSIST_BASE_ADDR, (uint8_t *)app_persist_image, APP_PERSIST_SIZE,
+                                         persist_read_cb, NULL) != HAL_OK);
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 计算一条记录的 CRC-32
+ * @param[in] record 记录 (4 字节对齐)
+ * @param[in] size CRC 覆盖的字节数 (4 的倍数)
+ * @return uint32_t CRC-32
+ */
+uint32_t app_persist_crc(const void *record, uint16_t size)
+{
+    return HW_CRC32((const uint32_t *)record, (uint16_t)(size / 4U));
+}
+
+/**
+ * @brief 校验一条记录
+ * @param[in] record 记录 (4 字节对齐)
+ * @param[in] size CRC-32 覆盖的字节数 (4 的倍数)
+ * @param[in] legacy_size 旧格式中 CRC-16 覆盖的字节数
+ * @return bool 任一种校验通过时返回 true
+ */
+bool app_persist_verify(const void *record, uint16_t size, uint16_t legacy_size)
+{
+    const uint8_t *p = (const uint8_t *)record;
+    uint32_t crc;
+    uint16_t legacy;
+
+    memcpy(&crc, p + size, sizeof(crc));
+    if (crc == app_persist_crc(record, size)) {
+        return true;
+    }
+    memcpy(&legacy, p + legacy_size, sizeof(legacy));
+    return legacy == app_store_crc16(record, legacy_size);
+}
+
+/**
+ * @brief 开始在后台读取全部持久区
+ * @return 无
+ */
+void app_persist_load_async(void)
+{
+    persist_state = APP_PERSIST_LOADING;
+    read_failures = 0;
+    persist_submit();
+}
+
+/**
+ * @brief 持久区维护函数，需在主循环中周期调用
+ * @details 总线队列已满时不计入失败次数。
+ * @return 无
+ */
+void app_persist_service(void)
+{
+    if (persist_state != APP_PERSIST_LOADING) {
+        return;
+    }
+    if (read_done) {
+        read_done = false;
+        if (read_ok) {
+            persist_state = APP_PERSIST_READY;
+            return;
+        }
+        if (++read_failures >= APP_PERSIST_TRIES) {
+            persist_state = APP_PERSIST_FAILED;
+            return;
+        }
+        read_retry = true;
+        retry_at = HAL_GetTick();
+    }
+    if (read_retry && HAL_GetTick() - retry_at >= APP_PERSIST_RETRY_MS) {
+        persist_submit();
+    }
+}
+
+/**
+ * @brief 查询加载状态
+ * @return App_Persist_State_e 加载状态
+ */
+App_Persist_State_e app_persist_state(void)
+{
+    return persist_state;
+}
+
+/** @} */
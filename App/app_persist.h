@@ -0,0 +1,112 @@
+/**
+ * @file      app_persist.h
+ * @brief     持久区目录与启动加载头文件
+ * @details   AT24C32 中 app_store 的槽位之后是各模块固定位置的持久区，依次相接、与页对齐：
+ *            | 区域 | 地址 | 大小 | 所属模块 |
+ *            | 使用统计 | 0x0C40 | 160 (5页) | app_usage |
+ *            | 温度历史检查点 | 0x0CE0 | 704 (22页) | app_history |
+ *            | 闹钟表 | 0x0FA0 | 32 (1页) | app_alarm |
+ *            | 漂移日志 | 0x0FC0 | 64 (2页) | app_drift |
+ *            启动时用一次顺序读取 (AT24C32 读取时地址跨页自动递增) 把整段 960 字节读入 RAM 中的镜像，
+ *            各模块直接把镜像中自己的区域当作 RAM 副本使用并就地校验，不另设接收缓冲区、不拷贝。
+ *            镜像按 4 字节对齐，各区域的偏移都是页大小的倍数，记录可以直接交给硬件 CRC 单元校验。
+ *            读取失败时隔 APP_PERSIST_RETRY_MS 重试，共 APP_PERSIST_TRIES 次。
+ *            各区域的记录以 CRC-32 结尾 (硬件 CRC 单元只支持 CRC-32)；旧版本固件写入的记录以 CRC-16/CCITT 结尾，
+ *            读取时同样接受，下一次保存时改写为新的格式。
+ *            app_store 的槽位不在其中：扫描 3KB 的槽位只为找出一条最新记录，不值得在 RAM 中保留整片镜像。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_PERSIST_H
+#define __APP_PERSIST_H
+
+#include "main.h"
+#include "app_store.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppPersist 持久区
+ * @brief 各模块持久区的目录、一次读入的 RAM 镜像和加载状态。
+ * @{
+ */
+
+/**
+ * @defgroup AppPersist_Config 持久区配置
+ * @{
+ */
+#define APP_PERSIST_BASE_ADDR (APP_STORE_BASE_ADDR + APP_STORE_SLOT_COUNT * APP_STORE_SLOT_SIZE) ///< 第一个持久区的地址 (紧接 app_store 的槽位)
+#define APP_PERSIST_END_ADDR  0x1000 ///< 最后一个持久区的结束地址 (AT24C32 的容量)
+#define APP_PERSIST_SIZE      (APP_PERSIST_END_ADDR - APP_PERSIST_BASE_ADDR) ///< 镜像的字节数
+#define APP_PERSIST_TRIES     3      ///< 读取失败时总共尝试的次数
+#define APP_PERSIST_RETRY_MS  1000   ///< 两次尝试之间的间隔 (ms)，EEPROM 不应答时不占满总线
+/** @} */
+
+/**
+ * @brief 加载状态
+ */
+typedef enum {
+    APP_PERSIST_IDLE = 0, ///< 尚未开始读取
+    APP_PERSIST_LOADING,  ///< 正在读取 (包括等待重试)
+    APP_PERSIST_READY,    ///< 镜像已读入，各区域的内容由所属模块校验
+    APP_PERSIST_FAILED,   ///< 全部尝试都失败，镜像内容无意义
+} App_Persist_State_e;
+
+/** 持久区的 RAM 镜像，镜像中的偏移等于 EEPROM 地址减去 APP_PERSIST_BASE_ADDR */
+extern uint32_t app_persist_image[APP_PERSIST_SIZE / 4];
+
+/**
+ * @brief 取得镜像中一个持久区的指针
+ * @details 结果是地址常量，可用于初始化静态指针。
+ * @param type 区域中记录的类型
+ * @param addr 区域在 EEPROM 中的地址
+ */
+#define APP_PERSIST_MIRROR(type, addr) \
+    ((type *)(void *)((uint8_t *)app_persist_image + ((addr) - APP_PERSIST_BASE_ADDR)))
+
+/**
+ * @brief 计算一条记录的 CRC-32
+ * @details 由硬件 CRC 单元计算，只能在主循环中调用。
+ * @param[in] record 记录 (4 字节对齐，镜像中的区域都满足)
+ * @param[in] size CRC 覆盖的字节数，即记录中 CRC-32 字段的偏移 (4 的倍数)
+ * @return uint32_t CRC-32
+ */
+uint32_t app_persist_crc(const void *record, uint16_t size);
+
+/**
+ * @brief 校验一条记录
+ * @details 先检查偏移 size 处的 CRC-32；不符时再按旧版本的格式检查偏移 legacy_size 处覆盖其前全部字节的 CRC-16。
+ *          只能在主循环中调用。
+ * @param[in] record 记录 (4 字节对齐)
+ * @param[in] size CRC-32 覆盖的字节数 (4 的倍数)
+ * @param[in] legacy_size 旧格式中 CRC-16 覆盖的字节数
+ * @return bool 任一种校验通过时返回 true
+ */
+bool app_persist_verify(const void *record, uint16_t size, uint16_t legacy_size);
+
+/**
+ * @brief 开始在后台读取全部持久区
+ * @details 只提交一个总线事务，读取完成前各模块不使用镜像中的内容。
+ * @return 无
+ */
+void app_persist_load_async(void);
+
+/**
+ * @brief 持久区维护函数，需在主循环中周期调用
+ * @details 读取未能提交或失败时在这里重试。
+ * @return 无
+ */
+void app_persist_service(void);
+
+/**
+ * @brief 查询加载状态
+ * @return App_Persist_State_e 加载状态
+ */
+App_Persist_State_e app_persist_state(void);
+
+/** @} */
+
+#endif /* __APP_PERSIST_H */
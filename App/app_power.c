@@ -0,0 +1,612 @@
+/**
+ * @file      app_power.c
+ * @brief     低功耗管理模块
+ * @details   停止模式下 SysTick 和所有高速时钟都会停止，唤醒后需要：
+ *            - 重新配置 HSE/PLL (唤醒后系统运行在 HSI 上)；
+ *            - 把停止期间丢失的时间补回 uwTick，否则熄屏计时、传感器采样周期都会变慢。
+ *            停止模式只在下一个SQW脉冲之前进入，被SQW唤醒时补偿的时间是精确的；
+ *            被按键唤醒时无法得知停止了多久，先不补偿，记下下一个脉冲应有的时间戳，
+ *            该脉冲到来时 (Power_Sqw_Edge) 再把差值一次补上，之后的 HAL_GetTick() 又与RTC一致
+ *            (秒表和倒计时据此在停止模式中照常计时)。脉冲到来之前方波周期被改变
+ *            (唤醒后从每分钟闹钟切回1Hz方波) 时无法推算，放弃补偿，误差小于一个周期。
+ *            时钟调速在 PLL (72MHz) 和 HSE (8MHz) 之间切换 SYSCLK，APB1/APB2 跟随 HCLK，
+ *            使用 APB 时钟计时的外设 (TIM1、TIM2、TIM4、I2C1、USART1) 在切换后按新频率重新设置；
+ *            TIM3 为编码器接口，与时钟无关。RTOS 配置下内核节拍依赖 SysTick 的固定频率，不调速。
+ *            USB 总线活动期间外设需要 PLL 提供的 48MHz，既不降频也不进入停止模式；
+ *            总线挂起 (包括拔掉电缆) 后恢复正常，主机的恢复或复位信号经 EXTI18 唤醒停止模式。
+ *            USART1 在停止模式中不工作，RX 线 (PA10) 的下降沿经 EXTI10 唤醒，与按键唤醒相同地在下一个脉冲补偿滴答；
+ *            时钟恢复期间到达的字节丢失，远程协议在这之后保持串口工作一段时间，主机重发的请求照常处理。
+ *            掉电检测 (PVD) 经 EXTI16 的双边沿中断通知，停止模式中同样有效。电压跌落时只调用一次回调；
+ *            之后电压又恢复 (短暂跌落) 时，回调已经停止了总线调度，直接复位系统重新开始。
+ *            累计时间在每次状态切换时按微秒时基记账 (都在关中断时进行)。屏幕状态可能几个小时不变，
+ *            每次 MCU 状态切换时一起结算，单次的差值不会超过微秒时基约71分钟的回绕周期；
+ *            按键唤醒停止模式后在下一个脉冲补回的时间计入停止模式。
+ *            无滴答睡眠 (POWER_TICKLESS)：距截止时间还有几毫秒时，睡眠期间停止1ms的 SysTick 中断，
+ *            把一次重载设为到截止时间所在的毫秒边界，唤醒后按计数器走过的计数补回 uwTick，毫秒的相位保持不变。
+ *            截止时间取自软件定时器的下一次到期和页面管理器的下一步，亮屏静止时每5ms才唤醒一次；
+ *            更长的空闲 (熄屏) 仍由停止模式和 DS3231 的SQW脉冲计时。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.7
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_power.h"
+#include "app_config.h"
+#include "app_perf.h"
+#include "app_remote.h"
+#include "app_sched.h"
+#include "DS3231.h"
+#include "i2c_bus.h"
+#include "input.h"
+#include "radio_time.h"
+#include "light.h"
+#include "audio.h"
+#include "profiler.h"
+#include "timebase.h"
+#include "trace.h"
+#include "mark.h"
+#include "uart.h"
+#include "usb_cdc.h"
+#include "u8g2_stm32_hal.h"
+#include <string.h>
+
+/**
+ * @addtogroup AppPower
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#if POWER_CLOCK_SCALING && !APP_SCHED_RTOS
+#define POWER_CLOCK_GOVERNOR 1 ///< 是否启用时钟调速
+#else
+#define POWER_CLOCK_GOVERNOR 0
+#endif
+
+#if POWER_TICKLESS && !APP_SCHED_RTOS && REMOTE_BEACON_ROLE != REMOTE_BEACON_FOLLOWER
+#define POWER_TICKLESS_IDLE 1 ///< 是否启用无滴答睡眠 (RTOS 的内核节拍由 SysTick 提供；时间信标的从机在串口中断中读取 uwTick)
+#else
+#define POWER_TICKLESS_IDLE 0
+#endif
+#define POWER_TICKLESS_STOP_COUNTS 48 ///< 无滴答睡眠前后 SysTick 停止计数的 CPU 周期数 (估计值，与时钟频率无关)
+
+#if U8G2_BUFFER_MODE == 0
+#define POWER_DISPLAY_IDLE() (!u8g2_stm32_IsFlushBusy()) ///< 显示帧是否发送完毕
+#else
+#define POWER_DISPLAY_IDLE() true // 分页模式下条带在绘制时阻塞发送，主循环中没有进行中的帧
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+#if POWER_CLOCK_GOVERNOR
+static bool clock_slow;          ///< 当前是否运行在 HSE 8MHz 上
+static uint32_t clock_busy_ms;   ///< 最后一次需要全速运行的时间戳
+static uint32_t clock_tick_frac; ///< 切换时 SysTick 被重装而丢掉的不足1ms的时间累计 (us)
+#endif
+static bool stop_edge_pending;    ///< 上一次停止模式被按键唤醒，等待下一个SQW脉冲补偿系统滴答
+static uint32_t stop_edge_due;    ///< 下一个SQW脉冲应有的时间戳 (按停止期间没有丢失滴答计算)
+static uint32_t stop_edge_period; ///< 进入停止模式时的方波周期，脉冲到来前周期改变则放弃补偿
+#if POWER_PVD_ENABLE
+static volatile bool power_failed; ///< 已检测到掉电并调用过回调
+#endif
+static uint64_t res_us[POWER_RES_COUNT];         ///< 各项的累计时间 (us)，I2C 忙碌一项取自 I2C_Bus_Get_Busy_Us()
+static uint8_t res_mcu = POWER_RES_RUN_FAST;     ///< MCU 当前的状态 (复位后以 72MHz 运行)
+static uint8_t res_display = POWER_RES_DISPLAY_ON; ///< 屏幕当前的状态
+static uint32_t res_mcu_us;                      ///< MCU 进入当前状态的时刻 (微秒时基，复位时为0)
+static uint32_t res_display_us;                  ///< 屏幕进入当前状态的时刻
+
+/**
+ * @brief 各项的电流 (uA)，按 Power_Res_e 索引
+ */
+static const uint16_t res_ua[POWER_RES_COUNT] = {
+    [POWER_RES_RUN_FAST]    = POWER_UA_RUN_FAST,
+    [POWER_RES_RUN_SLOW]    = POWER_UA_RUN_SLOW,
+    [POWER_RES_SLEEP]       = POWER_UA_SLEEP,
+    [POWER_RES_STOP]        = POWER_UA_STOP,
+    [POWER_RES_DISPLAY_ON]  = POWER_UA_DISPLAY_ON,
+    [POWER_RES_DISPLAY_DIM] = POWER_UA_DISPLAY_DIM,
+    [POWER_RES_DISPLAY_OFF] = POWER_UA_DISPLAY_OFF,
+    [POWER_RES_I2C_BUSY]    = POWER_UA_I2C_BUSY,
+};
+
+/* Private function prototypes -----------------------------------------------*/
+#if POWER_PVD_ENABLE
+void PVD_IRQHandler(void);
+#endif
+static bool Stop_Allowed(uint32_t now, uint32_t deadline, uint32_t *until_edge);
+static uint8_t Res_Run_State(void);
+static void Res_Account(uint8_t mcu);
+static void Res_Snapshot(uint64_t us[POWER_RES_COUNT]);
+static void Enter_Stop(uint32_t until_edge);
+#if POWER_TICKLESS_IDLE
+static void Enter_Sleep_Tickless(uint32_t ms);
+#endif
+#if POWER_CLOCK_GOVERNOR
+static void Clock_Config(bool slow);
+static void Clock_Switch(bool slow);
+#endif
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 当前时钟下运行状态的分项
+ * @return uint8_t POWER_RES_RUN_FAST 或 POWER_RES_RUN_SLOW
+ */
+static uint8_t Res_Run_State(void)
+{
+#if POWER_CLOCK_GOVERNOR
+    return clock_slow ? POWER_RES_RUN_SLOW : POWER_RES_RUN_FAST;
+#else
+    return POWER_RES_RUN_FAST;
+#endif
+}
+
+/**
+ * @brief 结算到当前时刻的累计时间，并切换 MCU 的状态
+ * @note 调用时中断已关闭。
+ * @param[in] mcu MCU 的新状态 (可与当前相同，只结算)
+ * @return 无
+ */
+static void Res_Account(uint8_t mcu)
+{
+    uint32_t now = Timebase_Us();
+
+    res_us[res_mcu] += now - res_mcu_us;
+    res_us[res_display] += now - res_display_us;
+    res_mcu_us = now;
+    res_display_us = now;
+    res_mcu = mcu;
+}
+
+/**
+ * @brief 读取到当前时刻为止的各项累计时间
+ * @param[out] us 各项的累计时间 (us)
+ * @return 无
+ */
+static void Res_Snapshot(uint64_t us[POWER_RES_COUNT])
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    Res_Account(res_mcu);
+    memcpy(us, res_us, sizeof(res_us));
+    __set_PRIMASK(primask);
+    us[POWER_RES_I2C_BUSY] = I2C_Bus_Get_Busy_Us();
+}
+
+/**
+ * @brief 判断当前能否进入停止模式
+ * @details 停止模式下定时器和DMA都不工作，因此要求：
+ *          - 输入扫描已停止且队列为空 (之后的输入只能来自 EXTI)；
+ *          - I2C 总线和串口DMA上没有进行中或排队中的传输；
+ *          - USB 总线已挂起或没有连接；
+ *          - 不在授时接收窗口内 (TIM4 测量脉冲宽度)；
+ *          - 蜂鸣器没有在播放 (TIM1 和 DMA 送出波形)；
+ *          - SQW 方波正常，且下一个脉冲不早于截止时间 (唤醒时间受脉冲限制)。
+ *          串口接收不在其中：停止期间 RX 线的起始位会唤醒 MCU，最近有过通信时调用者不允许停止模式。
+ * @param[in] now 当前时间戳
+ * @param[in] deadline 截止时间
+ * @param[out] until_edge 距离下一个SQW脉冲的时间 (ms)
+ * @return bool 可以进入返回 true
+ */
+static bool Stop_Allowed(uint32_t now, uint32_t deadline, uint32_t *until_edge)
+{
+    uint32_t edge_ms;
+    uint32_t since_edge;
+    uint32_t period = DS3231_SQW_Get_Period();
+
+    if (!input_is_idle() || !I2C_Bus_Is_Idle() || !UART_Printf_Is_Idle() || USB_CDC_Is_Active() ||
+        Radio_Is_Receiving() || Audio_Is_Playing()) {
+        return false;
+    }
+    if (!DS3231_SQW_Get_Last_Edge(&edge_ms)) {
+        return false; // 没有方波就没有定时唤醒源，也无法补偿系统滴答
+    }
+
+    since_edge = now - edge_ms;
+    if (since_edge + POWER_STOP_MARGIN_MS >= period) {
+        return false; // 脉冲马上就到，睡眠等待即可
+    }
+
+    *until_edge = period - since_edge;
+    return deadline - now >= *until_edge;
+}
+
+/**
+ * @brief 进入停止模式并在唤醒后恢复时钟
+ * @note 调用时中断已关闭：唤醒中断保持挂起，直到时钟和 uwTick 恢复后才执行，
+ *       因此 SQW 中断里记录的脉冲时间戳是补偿后的值。
+ * @param[in] until_edge 进入时距离下一个SQW脉冲的时间 (ms)
+ * @return 无
+ */
+static void Enter_Stop(uint32_t until_edge)
+{
+    uint32_t due = HAL_GetTick() + until_edge;
+
+    Res_Account(POWER_RES_STOP);
+    Light_Suspend(); // 停止模式中 ADC 保持上电会增加电流
+    UART_Rx_Wake_Arm();
+    HAL_SuspendTick();
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+#if POWER_CLOCK_GOVERNOR
+    Clock_Config(clock_slow); // 唤醒后系统时钟为 HSI，恢复为停止前的频率
+#else
+    SystemClock_Config(); // 唤醒后系统时钟为 HSI，重新切回 HSE + PLL
+#endif
+    HAL_ResumeTick();
+    Light_Resume();
+    (void)UART_Rx_Wake_Disarm(); // 由 RX 唤醒时远程协议随之把串口保持 REMOTE_ACTIVE_MS
+
+    if (__HAL_GPIO_EXTI_GET_IT(RTC_SQW_Pin) != RESET) {
+        uwTick += until_edge;
+        stop_edge_pending = false; // 按上一个脉冲计算的 until_edge 已包含之前未补的部分
+    } else {
+        stop_edge_pending = true;
+        stop_edge_due = due;
+        stop_edge_period = DS3231_SQW_Get_Period();
+    }
+    Res_Account(Res_Run_State()); // 被按键唤醒时停止的时间还没有补回，在 Power_Sqw_Edge() 中补记
+}
+
+#if POWER_TICKLESS_IDLE
+/**
+ * @brief 停止 SysTick 中断的睡眠模式
+ * @details SysTick 以 HCLK 计数，每毫秒 LOAD + 1 个计数。停止计数器后，把一次重载设为本毫秒剩余的计数
+ *          加上 ms - 1 个整毫秒 (24位计数器在 72MHz 时最多约233ms，8MHz 时约2s，超过时提前唤醒)，
+ *          到期正好落在第 ms 个毫秒边界上。唤醒后：
+ *          - 到期唤醒：最后一毫秒由挂起的 SysTick 中断照常加上，这里补回之前的 ms - 1；
+ *          - 被其他中断提前唤醒：按走过的计数补回经过的毫秒边界数。
+ *          两种情况都把下一次重载设为到下一个毫秒边界的剩余计数，计数器启动后再恢复1ms的重载值
+ *          (新的 LOAD 在下一次重载时才生效)。挂起期间的 SysTick 中断只执行一次，跳过的毫秒里不执行 DS3231_Tick_Handler，
+ *          因此对时写入等待秒边界时不使用本函数。
+ * @note 调用时中断已关闭，SysTick 中断没有挂起。
+ * @param[in] ms 距截止时间的毫秒数 (不小于 POWER_TICKLESS_MIN_MS)
+ * @return 无
+ */
+static void Enter_Sleep_Tickless(uint32_t ms)
+{
+    uint32_t per_ms = SysTick->LOAD + 1U;
+    uint32_t ctrl = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    uint32_t max_ms = (SysTick_LOAD_RELOAD_Msk - per_ms) / per_ms;
+    uint32_t left, reload, val, next;
+
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+    left = SysTick->VAL;
+    if (left == 0) {
+        left = per_ms; // 刚数到0，这一毫秒的中断已挂起 (调用者已排除)，按整毫秒处理
+    }
+    if (ms > max_ms) {
+        ms = max_ms;
+    }
+    reload = left + (ms - 1U) * per_ms - 1U - POWER_TICKLESS_STOP_COUNTS;
+    SysTick->LOAD = reload;
+    SysTick->VAL = 0; // 同时清除 COUNTFLAG，计数器从 reload 开始
+    SysTick->CTRL = ctrl;
+
+    __WFI();
+
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk; // 写入不清除 COUNTFLAG
+    val = SysTick->VAL;
+    if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) {
+        uint32_t since = reload - val; // 到期重载之后走过的计数
+        uwTick += ms - 1U;
+        next = (since < per_ms) ? per_ms - since : 1U;
+    } else {
+        uint32_t elapsed = reload - val + POWER_TICKLESS_STOP_COUNTS;
+        if (elapsed < left) {
+            next = left - elapsed;
+        } else {
+            elapsed -= left;
+            uwTick += 1U + elapsed / per_ms;
+            next = per_ms - elapsed % per_ms;
+        }
+    }
+    next = (next > POWER_TICKLESS_STOP_COUNTS + 1U) ? next - POWER_TICKLESS_STOP_COUNTS : 2U;
+
+    SysTick->LOAD = next - 1U;
+    SysTick->VAL = 0;
+    SysTick->CTRL = ctrl;
+    SysTick->LOAD = per_ms - 1U;
+}
+#endif
+
+#if POWER_CLOCK_GOVERNOR
+/**
+ * @brief 配置系统时钟
+ * @details 慢速时 SYSCLK 直接取自 HSE，AHB/APB1/APB2 都不分频 (PCLK1 不超过 36MHz 的限制自然满足)，
+ *          Flash 为零等待，切换完成后关闭PLL；快速时由 SystemClock_Config() 恢复 PLL x9 的配置。
+ *          从停止模式唤醒后 HSE 已关闭，因此慢速配置也先打开 HSE。
+ * @param[in] slow true 为 8MHz，false 为 72MHz
+ * @return 无
+ */
+static void Clock_Config(bool slow)
+{
+    RCC_OscInitTypeDef osc = {0};
+    RCC_ClkInitTypeDef clk = {0};
+
+    if (!slow) {
+        SystemClock_Config();
+        return;
+    }
+
+    osc.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+    osc.HSEState = RCC_HSE_ON;
+    osc.PLL.PLLState = RCC_PLL_NONE;
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK) {
+        Error_Handler();
+    }
+
+    clk.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+    clk.SYSCLKSource = RCC_SYSCLKSOURCE_HSE;
+    clk.AHBCLKDivider = RCC_SYSCLK_DIV1;
+    clk.APB1CLKDivider = RCC_HCLK_DIV1;
+    clk.APB2CLKDivider = RCC_HCLK_DIV1;
+    if (HAL_RCC_ClockConfig(&clk, FLASH_LATENCY_0) != HAL_OK) {
+        Error_Handler();
+    }
+
+    osc.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+    osc.PLL.PLLState = RCC_PLL_OFF;
+    (void)HAL_RCC_OscConfig(&osc);
+}
+
+/**
+ * @brief 切换系统时钟并重新设置依赖 APB 时钟的外设
+ * @details HAL_RCC_ClockConfig 以新频率重装 SysTick 并清零计数值，当前这一毫秒已走过的部分会丢失，
+ *          切换前把它累计到 clock_tick_frac 中，满1ms时补给 uwTick，HAL_GetTick() 不会因频繁切换而变慢。
+ *          切换后立即记录跟踪事件，解码脚本据此改变之后时间戳的换算频率。
+ * @note 调用时中断已关闭，I2C 总线、串口发送和屏幕刷新都空闲。
+ * @param[in] slow true 为 8MHz，false 为 72MHz
+ * @return 无
+ */
+static void Clock_Switch(bool slow)
+{
+    uint32_t load = SysTick->LOAD + 1U;
+
+    Res_Account(slow ? POWER_RES_RUN_SLOW : POWER_RES_RUN_FAST); // 到现在为止按原来的频率运行
+    clock_tick_frac += (load - SysTick->VAL) * 1000U / load;
+    if (clock_tick_frac >= 1000U) {
+        clock_tick_frac -= 1000U;
+        uwTick++;
+    }
+
+    Clock_Config(slow);
+    clock_slow = slow;
+    TRACE(TRACE_EV_CLOCK, SystemCoreClock / 1000000U);
+
+    input_clock_changed();
+    Radio_Clock_Changed();
+    Audio_Clock_Changed();
+    Light_Clock_Changed();
+    I2C_Bus_Clock_Changed();
+    UART_Clock_Changed();
+    Profiler_Set_Clock(SystemCoreClock);
+}
+#endif
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 初始化低功耗管理模块
+ * @details PWR 时钟已在 HAL_MspInit 中打开，这里处理调试接口和掉电检测。
+ * @return 无
+ */
+void Power_Init(void)
+{
+#if POWER_PVD_ENABLE
+    PWR_PVDTypeDef pvd = {
+        .PVDLevel = POWER_PVD_LEVEL,
+        .Mode = PWR_PVD_MODE_IT_RISING_FALLING,
+    };
+#endif
+
+#if POWER_KEEP_DEBUG
+    HAL_DBGMCU_EnableDBGSleepMode();
+    HAL_DBGMCU_EnableDBGStopMode();
+#else
+    HAL_DBGMCU_DisableDBGSleepMode();
+    HAL_DBGMCU_DisableDBGStopMode();
+#endif
+
+#if POWER_CLOCK_GOVERNOR
+    clock_busy_ms = HAL_GetTick();
+#endif
+
+#if POWER_PVD_ENABLE
+    HAL_PWR_ConfigPVD(&pvd);
+    HAL_PWR_EnablePVD();
+    HAL_NVIC_SetPriority(PVD_IRQn, IRQ_PRIO_POWER, 0);
+    HAL_NVIC_EnableIRQ(PVD_IRQn);
+#endif
+}
+
+/**
+ * @brief 在下一个截止时间之前进入低功耗模式
+ * @param[in] deadline 下一次需要主循环处理的时间
+ * @param[in] allow_stop 调用者是否允许进入停止模式
+ * @return 无
+ */
+void Power_Idle(uint32_t deadline, bool allow_stop)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t until_edge;
+
+    if ((int32_t)(deadline - now) <= 0) {
+        return;
+    }
+
+    // 关中断后再做判断：判断之后到来的中断会保持挂起，WFI 会立即返回，不会被睡过去
+    __disable_irq();
+    PROF_BEGIN(PROF_SEC_IDLE);
+    TRACE(TRACE_EV_IDLE_BEGIN, allow_stop);
+    MARK_BEGIN(SLEEP);
+
+    if (allow_stop && Stop_Allowed(now, deadline, &until_edge)) {
+        Enter_Stop(until_edge);
+    } else if (input_count_events() == 0) {
+        Res_Account(POWER_RES_SLEEP);
+#if POWER_TICKLESS_IDLE
+        if (deadline - now >= POWER_TICKLESS_MIN_MS && !(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) &&
+            !DS3231_SetTimeSync_Pending()) {
+            Enter_Sleep_Tickless(deadline - now);
+        } else {
+            __WFI();
+        }
+#else
+        __WFI();
+#endif
+        Res_Account(Res_Run_State());
+    }
+
+    MARK_END(SLEEP);
+    TRACE(TRACE_EV_IDLE_END, 0);
+    PROF_END(PROF_SEC_IDLE);
+    __enable_irq();
+}
+
+/**
+ * @brief SQW脉冲到来时补偿按键唤醒丢失的系统滴答
+ * @details 停止模式只持续到下一个脉冲之前，脉冲的真实时刻就是进入时算出的 stop_edge_due，
+ *          与脉冲到来时 HAL_GetTick() 的差值即停止期间丢失的时间。差值须在一个周期之内。
+ * @return 无
+ */
+void Power_Sqw_Edge(void)
+{
+    uint32_t lost;
+
+    if (!stop_edge_pending) {
+        return;
+    }
+    stop_edge_pending = false;
+    lost = stop_edge_due - HAL_GetTick();
+    if (DS3231_SQW_Get_Period() == stop_edge_period && (int32_t)lost > 0 && lost < stop_edge_period) {
+        uwTick += lost;
+        // 补回的时间属于之前的停止模式，当前状态的起点随之后移
+        res_us[POWER_RES_STOP] += (uint64_t)lost * 1000U;
+        res_mcu_us += lost * 1000U;
+    }
+}
+
+/**
+ * @brief 按界面是否忙碌调整系统时钟
+ * @param[in] busy 是否需要全速运行
+ * @return 无
+ */
+void Power_Clock_Service(bool busy)
+{
+#if POWER_CLOCK_GOVERNOR
+    uint32_t now = HAL_GetTick();
+    bool slow;
+
+    if (busy || USB_CDC_Is_Active()) {
+        clock_busy_ms = now; // USB 需要 PLL 提供的 48MHz
+    }
+    slow = !busy && now - clock_busy_ms >= app_perf()->clock_hold_ms;
+    if (slow == clock_slow) {
+        return;
+    }
+
+    // 切换期间外设时序不一致，关中断后确认没有进行中的传输，之后提交的传输会按新时序进行
+    __disable_irq();
+    if (I2C_Bus_Is_Idle() && UART_Printf_Is_Idle() && POWER_DISPLAY_IDLE()) {
+        Clock_Switch(slow);
+    }
+    __enable_irq();
+#else
+    (void)busy;
+#endif
+}
+
+/**
+ * @brief 记录屏幕状态的切换
+ * @param[in] state 新的屏幕状态
+ * @return 无
+ */
+void Power_Set_Display(Power_Display_e state)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t now;
+
+    __disable_irq();
+    now = Timebase_Us();
+    res_us[res_display] += now - res_display_us;
+    res_display_us = now;
+    res_display = (uint8_t)(POWER_RES_DISPLAY_ON + state);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 获取启动以来各项的累计时间
+ * @param[out] ms 各项的累计时间 (ms)
+ * @return 无
+ */
+void Power_Get_Residency(uint32_t ms[POWER_RES_COUNT])
+{
+    uint64_t us[POWER_RES_COUNT];
+
+    Res_Snapshot(us);
+    for (uint8_t i = 0; i < POWER_RES_COUNT; i++) {
+        ms[i] = (uint32_t)(us[i] / 1000U);
+    }
+}
+
+/**
+ * @brief 按累计时间估算每天的耗电
+ * @return uint32_t 每天的耗电 (uAh)
+ */
+uint32_t Power_Estimate_uAh_Day(void)
+{
+    uint64_t us[POWER_RES_COUNT];
+    uint64_t total;
+    uint64_t charge; // uA·us
+
+    Res_Snapshot(us);
+    total = us[POWER_RES_RUN_FAST] + us[POWER_RES_RUN_SLOW] + us[POWER_RES_SLEEP] + us[POWER_RES_STOP];
+    if (total == 0) {
+        return 0;
+    }
+    charge = total * POWER_UA_BOARD;
+    for (uint8_t i = 0; i < POWER_RES_COUNT; i++) {
+        charge += us[i] * res_ua[i];
+    }
+    return (uint32_t)(charge / total * 24U);
+}
+
+/**
+ * @brief 掉电回调的默认实现
+ * @return 无
+ */
+__weak void Power_Fail_Callback(void)
+{
+}
+
+#if POWER_PVD_ENABLE
+/**
+ * @brief PVD 中断 (EXTI16)
+ * @return 无
+ */
+void PVD_IRQHandler(void)
+{
+    HAL_PWR_PVD_IRQHandler();
+}
+
+/**
+ * @brief 供电电压越过掉电检测阈值 (PVD 中断上下文)
+ * @details PVDO 置位表示电压低于阈值。重新定义 HAL 中的弱函数。
+ * @return 无
+ */
+void HAL_PWR_PVDCallback(void)
+{
+    if (__HAL_PWR_GET_FLAG(PWR_FLAG_PVDO)) {
+        if (!power_failed) {
+            power_failed = true;
+            TRACE(TRACE_EV_POWER_FAIL, 0);
+            Power_Fail_Callback();
+        }
+    } else if (power_failed) {
+        NVIC_SystemReset(); // 短暂跌落后电压恢复，总线已被回调接管，从头开始
+    }
+}
+#endif
+
+/** @} */
@@ -0,0 +1,130 @@
+/**
+ * @file      app_power.h
+ * @brief     低功耗管理头文件
+ * @details   主循环在没有工作时调用本模块进入低功耗模式：
+ *            - 亮屏或距离截止时间较近时，使用睡眠模式 (__WFI)，任何中断都会唤醒，
+ *              睡眠期间停止1ms的 SysTick 中断，只在截止时间唤醒一次 (POWER_TICKLESS)；
+ *            - 熄屏且所有外设空闲时，使用停止模式，由按键/编码器 EXTI、串口 RX 线的下降沿或 DS3231 SQW 方波唤醒。
+ *            另外在界面空闲 (没有输入和动画) 时把系统时钟从 72MHz 降为 8MHz，有工作时再切回。
+ *            POWER_PVD_ENABLE 为1时监视供电电压，低于 POWER_PVD_LEVEL 时调用 Power_Fail_Callback()
+ *            保存状态，电压恢复后复位系统。
+ *            启动以来各运行状态 (全速、降频、睡眠、停止)、各屏幕状态和I2C总线忙碌的累计时间由状态切换时记账，
+ *            乘以 app_config.h 中各状态的电流即得到每天耗电的估算值，用来比较各项优化对电池寿命的影响。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.5
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_POWER_H
+#define __APP_POWER_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppPower 低功耗管理
+ * @brief 根据下一个截止时间选择睡眠或停止模式。
+ * @{
+ */
+
+/**
+ * @brief 累计时间的分项
+ * @details 前四项为 MCU 的状态，任一时刻恰好处于其中之一；之后三项为屏幕的状态；I2C 忙碌与前两组重叠。
+ */
+typedef enum {
+    POWER_RES_RUN_FAST = 0, ///< 以 72MHz 运行
+    POWER_RES_RUN_SLOW,     ///< 以降频后的 8MHz 运行
+    POWER_RES_SLEEP,        ///< 睡眠模式
+    POWER_RES_STOP,         ///< 停止模式
+    POWER_RES_DISPLAY_ON,   ///< 屏幕点亮
+    POWER_RES_DISPLAY_DIM,  ///< 低功耗时钟
+    POWER_RES_DISPLAY_OFF,  ///< 显示器关闭
+    POWER_RES_I2C_BUSY,     ///< I2C 总线上有事务在执行
+    POWER_RES_COUNT
+} Power_Res_e;
+
+/**
+ * @brief 屏幕状态，用于累计时间
+ */
+typedef enum {
+    POWER_DISPLAY_ON = 0, ///< 点亮
+    POWER_DISPLAY_DIM,    ///< 低功耗时钟
+    POWER_DISPLAY_OFF     ///< 关闭
+} Power_Display_e;
+
+/**
+ * @brief 初始化低功耗管理模块
+ * @return 无
+ */
+void Power_Init(void);
+
+/**
+ * @brief 在下一个截止时间之前进入低功耗模式
+ * @details 截止时间已到时立即返回。睡眠模式在下一个中断后返回 (最多一个 SysTick)；
+ *          POWER_TICKLESS 为1且截止时间在 POWER_TICKLESS_MIN_MS 之后时睡眠期间不产生 SysTick，
+ *          最晚在截止时间返回，返回时 uwTick 已补回睡眠的时间。
+ *          停止模式在下一个 EXTI 边沿 (按键、编码器、SQW 或串口 RX) 后返回，并恢复系统时钟、补偿停止期间的系统滴答。
+ *          不会由本函数自己等到截止时间，调用者应在返回后重新执行一遍主循环。
+ * @param[in] deadline 下一次需要主循环处理的时间 (HAL_GetTick() 时间戳)
+ * @param[in] allow_stop 调用者是否允许进入停止模式 (如屏幕已关闭、没有测量在进行)
+ * @return 无
+ */
+void Power_Idle(uint32_t deadline, bool allow_stop);
+
+/**
+ * @brief SQW脉冲通知
+ * @details 停止模式被按键 (而不是SQW脉冲) 唤醒时系统滴答少计了停止的时间，在之后的第一个脉冲时补上。
+ *          需在 SQW 的 EXTI 回调中、DS3231_SQW_IRQ_Handler() 之前调用，使记录的脉冲时间戳是补偿后的值。
+ * @return 无
+ */
+void Power_Sqw_Edge(void);
+
+/**
+ * @brief 按界面是否忙碌调整系统时钟
+ * @details busy 为 true 时立即切回 72MHz (HSE + PLL)；连续不忙超过性能配置的保持时间 (均衡时为 POWER_CLOCK_HOLD_MS) 后切换为 HSE 直接驱动的 8MHz。
+ *          USB 总线活动时视为忙碌。只在 I2C 总线、串口发送和屏幕刷新都空闲时切换，否则留到下一轮。切换后重新设置
+ *          TIM2 预分频、TIM4 和 TIM1 (蜂鸣器) 的分频、I2C1 时序和 USART1 波特率，并通知性能分析模块新的频率。
+ *          POWER_CLOCK_SCALING 为 0 或使用 RTOS 配置时为空操作。需在主循环每轮开始时调用。
+ * @param[in] busy 是否有输入、页面动画或远程控制需要全速运行
+ * @return 无
+ */
+void Power_Clock_Service(bool busy);
+
+/**
+ * @brief 记录屏幕状态的切换
+ * @details 由熄屏和唤醒的逻辑在改变屏幕状态时调用，之后的时间计入新的状态。启动时为点亮。
+ * @param[in] state 新的屏幕状态
+ * @return 无
+ */
+void Power_Set_Display(Power_Display_e state);
+
+/**
+ * @brief 获取启动以来各项的累计时间
+ * @details 正在进行的状态计入到调用时刻为止。
+ * @param[out] ms 各项的累计时间 (ms)，按 Power_Res_e 索引，长度 POWER_RES_COUNT
+ * @return 无
+ */
+void Power_Get_Residency(uint32_t ms[POWER_RES_COUNT]);
+
+/**
+ * @brief 按累计时间估算每天的耗电
+ * @details 各项的时间占比乘以 app_config.h 中该项的电流 (POWER_UA_*) 后相加，再加上始终存在的 POWER_UA_BOARD，
+ *          得到启动以来的平均电流，乘以24小时。只反映启动以来的使用情况，刚启动时偏差较大。
+ * @return uint32_t 每天的耗电 (uAh)
+ */
+uint32_t Power_Estimate_uAh_Day(void);
+
+/**
+ * @brief 供电电压跌落到掉电检测阈值以下时的回调
+ * @details 在 PVD 中断中调用，每次掉电只调用一次，默认为空实现。应用层可重新定义，在电源电容维持的
+ *          几毫秒内完成必要的写入 (中断优先级与 I2C 相同，回调期间总线中断不会执行，不能等待队列中的事务)。
+ *          电压回到阈值以上时系统复位，回调中可以放弃任何外设的当前状态。
+ * @return 无
+ */
+void Power_Fail_Callback(void);
+
+/** @} */
+
+#endif /* __APP_POWER_H */
@@ -0,0 +1,1038 @@
+/**
+ * @file      app_remote.c
+ * @brief     串口对时与远程控制协议实现
+ * @details   DMA 在 UART 的环形缓冲区中不停地写入，本模块只记录读到的位置：
+ *            扫描到帧分隔符 0x00 后，把这一帧原地做 COBS 解码 (解码结果不会比编码长，
+ *            写入位置始终落后于读取位置)，再按偏移直接从缓冲区中读取各字段，全程不复制。
+ *            帧可能跨越缓冲区末尾，所有访问都按缓冲区长度取模。
+ *            主机一次发送的数据不应超过缓冲区长度，否则未处理的帧会被DMA覆盖 (表现为CRC错误)。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.4
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_remote.h"
+#include "app_asset.h"
+#include "app_battery.h"
+#include "app_datalog.h"
+#include "app_history.h"
+#include "app_mirror.h"
+#include "app_night.h"
+#include "app_power.h"
+#include "app_sensor.h"
+#include "app_settings.h"
+#include "app_store.h"
+#include "app_usage.h"
+#include "boot.h"
+#include "cobs.h"
+#include "input_replay.h"
+#include "DS3231.h"
+#include "profiler.h"
+#include "uart.h"
+#include "usb_cdc.h"
+
+/**
+ * @addtogroup AppRemote
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define REMOTE_REPLY_FLAG   0x80 ///< 应答命令码的最高位
+#define REMOTE_HEADER_SIZE  2    ///< 命令 + 序号
+#define REMOTE_CRC_SIZE     2    ///< CRC-16
+#define REMOTE_LANGUAGES    2    ///< 支持的语言数 (0: English, 1: 中文)
+#define REMOTE_REPLY_MAX    (REMOTE_HEADER_SIZE + 1 + 6 + 16 * PROF_SEC_COUNT + REMOTE_CRC_SIZE) ///< 最长的应答负载 (性能统计)
+#define REMOTE_BEACON_SIZE  (REMOTE_HEADER_SIZE + 4 + REMOTE_CRC_SIZE) ///< 时间信标的负载长度
+
+#define RING_AT(pos) ((uint16_t)((pos) % UART_RX_RING_SIZE)) ///< 环形缓冲区下标取模
+
+/** 编译期检查：最长的应答编码后 (外加分隔符) 必须放得进发送缓冲区 */
+typedef char remote_tx_size_check[(COBS_ENCODED_MAX(REMOTE_REPLY_MAX) + 1 <= REMOTE_TX_FRAME_MAX) ? 1 : -1];
+
+/** 编译期检查：最长的资源写入请求编码后 (外加分隔符) 不超过请求帧的长度限制 */
+typedef char remote_asset_write_check[(COBS_ENCODED_MAX(REMOTE_HEADER_SIZE + 4 + APP_ASSET_WRITE_MAX + REMOTE_CRC_SIZE) + 1 <=
+                                       REMOTE_RX_FRAME_MAX) ? 1 : -1];
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 解码后留在接收缓冲区中的一帧
+ */
+typedef struct {
+    const uint8_t *ring; ///< 接收缓冲区
+    uint16_t start;      ///< 负载在缓冲区中的起始位置
+    uint16_t len;        ///< 负载长度 (含命令、序号和CRC)
+} Remote_Frame_t;
+
+/* Private variables ---------------------------------------------------------*/
+static uint16_t rx_tail;                      ///< 当前帧在缓冲区中的起点
+static uint16_t rx_scan;                      ///< 下一个要扫描的位置
+static bool rx_overlong;                      ///< 当前帧已超过 REMOTE_RX_FRAME_MAX，丢弃到下一个分隔符
+static bool rx_seen;                          ///< 是否收到过数据
+static uint32_t last_rx_ms;                   ///< 最近一次收到数据的时间戳
+
+static uint8_t reply[REMOTE_REPLY_MAX];       ///< 正在组装的应答负载
+static uint16_t reply_len;                    ///< 应答负载的长度
+static uint8_t tx_frame[REMOTE_TX_FRAME_MAX]; ///< 编码后的应答帧，写入发送缓冲区之前保持不变
+static uint16_t tx_pending;                   ///< 等待发送的应答帧长度，0 表示没有
+static bool boot_pending;                     ///< 已接受 REMOTE_CMD_BOOT，应答发完后复位
+#if REMOTE_BEACON_ROLE == REMOTE_BEACON_MASTER
+static Epoch_t beacon_sent;                   ///< 上一次广播信标的纪元秒
+#elif REMOTE_BEACON_ROLE == REMOTE_BEACON_FOLLOWER
+static bool beacon_synced;                    ///< 是否已按信标对过时
+static uint32_t beacon_sync_ms;               ///< 上一次按信标对时的时间戳
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static uint16_t cobs_decode_ring(uint8_t *ring, uint16_t start, uint16_t len);
+static uint8_t frame_u8(const Remote_Frame_t *f, uint16_t i);
+static uint16_t frame_u16(const Remote_Frame_t *f, uint16_t i);
+static bool frame_crc_ok(const Remote_Frame_t *f);
+static void reply_begin(uint8_t cmd, uint8_t seq);
+static void reply_u8(uint8_t v);
+static void reply_u16(uint16_t v);
+static void reply_u32(uint32_t v);
+static void reply_varint(uint32_t v);
+static void reply_send(void);
+static void tx_try(void);
+static Remote_Status_e cmd_set_time(const Remote_Frame_t *f, uint16_t dlen);
+static Remote_Status_e cmd_put_settings(const Remote_Frame_t *f, uint16_t dlen, bool *changed);
+static Remote_Status_e cmd_get_profile(void);
+static Remote_Status_e cmd_get_power(void);
+static Remote_Status_e cmd_get_history(const Remote_Frame_t *f, uint16_t dlen);
+static Remote_Status_e cmd_log_read(const Remote_Frame_t *f, uint16_t dlen);
+static Remote_Status_e cmd_mirror(const Remote_Frame_t *f, uint16_t dlen);
+static Remote_Status_e cmd_input_mode(const Remote_Frame_t *f, uint16_t dlen);
+static Remote_Status_e cmd_input_read(const Remote_Frame_t *f, uint16_t dlen);
+static Remote_Status_e cmd_input_write(const Remote_Frame_t *f, uint16_t dlen);
+static Remote_Status_e cmd_boot(const Remote_Frame_t *f, uint16_t dlen);
+static Remote_Status_e cmd_asset_info(const Remote_Frame_t *f, uint16_t dlen);
+static Remote_Status_e cmd_asset_write(const Remote_Frame_t *f, uint16_t dlen, bool erase);
+static void beacon_send(void);
+static void beacon_receive(const Remote_Frame_t *f, uint16_t end, uint16_t wire_len);
+static bool handle_frame(uint16_t start, uint16_t len);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 在接收缓冲区中原地进行 COBS 解码
+ * @details 每个编码块的首字节 c 表示之后有 c-1 个非零字节，c 不为 0xFF 且不是最后一块时
+ *          块后隐含一个 0。输出位置始终落后于输入位置，可以直接覆盖。
+ * @param[in,out] ring 接收缓冲区
+ * @param[in] start 帧的起始位置
+ * @param[in] len 编码后的长度 (不含分隔符)
+ * @return uint16_t 解码后的长度，编码错误时返回 0
+ */
+static uint16_t cobs_decode_ring(uint8_t *ring, uint16_t start, uint16_t len)
+{
+    uint16_t in = 0;
+    uint16_t out = 0;
+
+    while (in < len) {
+        uint8_t code = ring[RING_AT(start + in)];
+        in++;
+        if (code == 0 || in + code - 1 > len) {
+            return 0;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            ring[RING_AT(start + out)] = ring[RING_AT(start + in)];
+            out++;
+            in++;
+        }
+        if (code != 0xFF && in < len) {
+            ring[RING_AT(start + out)] = 0;
+            out++;
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief 读取帧中的一个字节
+ * @param[in] f 帧
+ * @param[in] i 负载中的偏移
+ * @return uint8_t 字节
+ */
+static uint8_t frame_u8(const Remote_Frame_t *f, uint16_t i)
+{
+    return f->ring[RING_AT(f->start + i)];
+}
+
+/**
+ * @brief 读取帧中的一个小端16位数
+ * @param[in] f 帧
+ * @param[in] i 负载中的偏移
+ * @return uint16_t 数值
+ */
+static uint16_t frame_u16(const Remote_Frame_t *f, uint16_t i)
+{
+    return (uint16_t)(frame_u8(f, i) | ((uint16_t)frame_u8(f, i + 1) << 8));
+}
+
+/**
+ * @brief 校验帧的 CRC
+ * @details 帧跨越缓冲区末尾时分两段计算。
+ * @param[in] f 帧
+ * @return bool CRC 正确返回 true
+ */
+static bool frame_crc_ok(const Remote_Frame_t *f)
+{
+    uint16_t body = f->len - REMOTE_CRC_SIZE;
+    uint16_t first = UART_RX_RING_SIZE - f->start;
+    uint16_t crc;
+
+    if (first >= body) {
+        crc = app_store_crc16(&f->ring[f->start], body);
+    } else {
+        crc = app_store_crc16(&f->ring[f->start], first);
+        crc = app_store_crc16_update(crc, f->ring, body - first);
+    }
+    return crc == frame_u16(f, body);
+}
+
+/**
+ * @brief 开始组装应答
+ * @details 状态字节先填为 REMOTE_OK，命令处理完后再改写。
+ * @param[in] cmd 请求的命令码
+ * @param[in] seq 请求的序号
+ * @return 无
+ */
+static void reply_begin(uint8_t cmd, uint8_t seq)
+{
+    reply[0] = cmd | REMOTE_REPLY_FLAG;
+    reply[1] = seq;
+    reply[2] = REMOTE_OK;
+    reply_len = REMOTE_HEADER_SIZE + 1;
+}
+
+/**
+ * @brief 向应答追加一个字节
+ * @param[in] v 数值
+ * @return 无
+ */
+static void reply_u8(uint8_t v)
+{
+    if (reply_len < REMOTE_REPLY_MAX - REMOTE_CRC_SIZE) {
+        reply[reply_len++] = v;
+    }
+}
+
+/**
+ * @brief 向应答追加一个小端16位数
+ * @param[in] v 数值
+ * @return 无
+ */
+static void reply_u16(uint16_t v)
+{
+    reply_u8((uint8_t)v);
+    reply_u8((uint8_t)(v >> 8));
+}
+
+/**
+ * @brief 向应答追加一个小端32位数
+ * @param[in] v 数值
+ * @return 无
+ */
+static void reply_u32(uint32_t v)
+{
+    reply_u16((uint16_t)v);
+    reply_u16((uint16_t)(v >> 16));
+}
+
+/**
+ * @brief 向应答追加一个 varint (每字节7位，低位在前)
+ * @param[in] v 数值
+ * @return 无
+ */
+static void reply_varint(uint32_t v)
+{
+    while (v >= 0x80U) {
+        reply_u8((uint8_t)(v | 0x80U));
+        v >>= 7;
+    }
+    reply_u8((uint8_t)v);
+}
+
+/**
+ * @brief 为应答加上 CRC，编码后开始发送
+ * @return 无
+ */
+static void reply_send(void)
+{
+    uint16_t crc = app_store_crc16(reply, reply_len);
+
+    reply[reply_len++] = (uint8_t)crc;
+    reply[reply_len++] = (uint8_t)(crc >> 8);
+
+    tx_pending = COBS_Encode(reply, reply_len, tx_frame);
+    tx_frame[tx_pending++] = 0x00; // 帧分隔符
+    tx_try();
+}
+
+/**
+ * @brief 把等待中的应答整帧写入串口发送缓冲区
+ * @details 空间不足 (如正在输出性能报告) 时保留到下一次调用，帧不会被截断或与文本输出交错。
+ * @return 无
+ */
+static void tx_try(void)
+{
+    if (tx_pending != 0 && UART_Write(tx_frame, tx_pending)) {
+        tx_pending = 0;
+    }
+}
+
+/**
+ * @brief 执行对时命令
+ * @details 星期由日期计算，不需要主机提供。可选的毫秒字段是发送时刻在这一秒中的位置，
+ *          据此推算这一秒开始的时刻，写入安排在之后的整秒上 (DS3231_SetTimeSync)；省略时这一秒从收到帧时开始。
+ *          写入完成后触发漂移日志的记录。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_set_time(const Remote_Frame_t *f, uint16_t dlen)
+{
+    Time_t t;
+    uint16_t ms = 0;
+
+    if (dlen != 7 && dlen != 9) {
+        return REMOTE_ERR_LENGTH;
+    }
+    if (dlen == 9) {
+        ms = frame_u16(f, 9);
+    }
+    t.year = frame_u16(f, 2);
+    t.month = frame_u8(f, 4);
+    t.day = frame_u8(f, 5);
+    t.hour = frame_u8(f, 6);
+    t.minute = frame_u8(f, 7);
+    t.second = frame_u8(f, 8);
+
+    if (t.year < TIME_EPOCH_YEAR || t.year > 2099 || t.month < 1 || t.month > 12 ||
+        t.day < 1 || t.day > Time_Days_In_Month(t.year, t.month) ||
+        t.hour > 23 || t.minute > 59 || t.second > 59 || ms > 999) {
+        return REMOTE_ERR_ARG;
+    }
+    if (DS3231_SetTimeSync(Time_To_Epoch(&t), HAL_GetTick() - ms) != HAL_OK) {
+        return REMOTE_ERR_BUSY;
+    }
+    return REMOTE_OK;
+}
+
+/**
+ * @brief 执行下发设置命令
+ * @details 新设置立即生效，安静期后在后台写入EEPROM，与在设置页面中修改的效果相同。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @param[out] changed 设置被修改时置为 true
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_put_settings(const Remote_Frame_t *f, uint16_t dlen, bool *changed)
+{
+    uint8_t language, auto_off, dst_enabled, dst_zone, brightness, display_mode;
+    uint8_t env_alert = g_app_settings.env_alert;
+    uint8_t temp_low = g_app_settings.temp_low, temp_high = g_app_settings.temp_high;
+    uint8_t humi_low = g_app_settings.humi_low, humi_high = g_app_settings.humi_high;
+    uint8_t night_mode = APP_NIGHT_MODE(g_app_settings.night_rule);
+    uint8_t night_start = APP_NIGHT_START(g_app_settings.night_rule), night_end = g_app_settings.night_end;
+
+    if ((dlen < 4 || dlen > 6) && dlen != 11 && dlen != 14) {
+        return REMOTE_ERR_LENGTH;
+    }
+    language = frame_u8(f, 2);
+    auto_off = frame_u8(f, 3);
+    dst_enabled = frame_u8(f, 4);
+    dst_zone = frame_u8(f, 5);
+    brightness = (dlen >= 5) ? frame_u8(f, 6) : g_app_settings.brightness; // 旧版上位机不发送亮度
+    display_mode = (dlen >= 6) ? frame_u8(f, 7) : g_app_settings.display_mode; // 协议版本7之前没有显示模式
+    if (dlen >= 11) { // 协议版本10之前没有越限提醒
+        env_alert = frame_u8(f, 8);
+        temp_low = frame_u8(f, 9);
+        temp_high = frame_u8(f, 10);
+        humi_low = frame_u8(f, 11);
+        humi_high = frame_u8(f, 12);
+    }
+    if (dlen == 14) { // 协议版本16之前没有夜间时段
+        night_mode = frame_u8(f, 13);
+        night_start = frame_u8(f, 14);
+        night_end = frame_u8(f, 15);
+    }
+
+    if (language >= REMOTE_LANGUAGES || auto_off > TIME_10MIN || dst_enabled > 1 ||
+        dst_zone >= Time_Dst_Zone_Count() || brightness >= BRIGHT_MODE_COUNT || display_mode >= DISPLAY_MODE_COUNT ||
+        env_alert > 1 || temp_high > APP_SENSOR_ALERT_TEMP_MAX || temp_low >= temp_high ||
+        humi_high > 100 || humi_low >= humi_high ||
+        night_mode >= NIGHT_MODE_COUNT || night_start >= APP_NIGHT_SLOTS || night_end >= APP_NIGHT_SLOTS) {
+        return REMOTE_ERR_ARG;
+    }
+    // 加载完成前修改会被加载结果覆盖
+    if (app_settings_service() == APP_SETTINGS_LOAD_PENDING) {
+        return REMOTE_ERR_BUSY;
+    }
+
+    g_app_settings.language = language;
+    g_app_settings.auto_off = (Auto_Off_e)auto_off;
+    g_app_settings.dst_enabled = (dst_enabled != 0);
+    g_app_settings.dst_zone = dst_zone;
+    g_app_settings.brightness = brightness;
+    g_app_settings.display_mode = display_mode;
+    g_app_settings.env_alert = env_alert;
+    g_app_settings.temp_low = temp_low;
+    g_app_settings.temp_high = temp_high;
+    g_app_settings.humi_low = humi_low;
+    g_app_settings.humi_high = humi_high;
+    g_app_settings.night_rule = APP_NIGHT_RULE(night_mode, night_start);
+    g_app_settings.night_end = night_end;
+    Time_Dst_Select_Zone(dst_zone);
+    *changed = true;
+
+    app_settings_mark_dirty();
+    return REMOTE_OK;
+}
+
+/**
+ * @brief 执行读取性能统计命令
+ * @details 返回上一个统计窗口锁存的结果，与串口文本报告是同一份数据。
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_get_profile(void)
+{
+    Profiler_Summary_t sum;
+    uint16_t load_pm;
+    uint32_t window_ms = Profiler_Get_Load(&load_pm);
+
+    if (window_ms == 0) {
+        return PROFILER_ENABLE ? REMOTE_ERR_BUSY : REMOTE_ERR_UNSUPPORTED;
+    }
+    reply_u32(window_ms);
+    reply_u16(load_pm);
+    for (uint8_t sec = 0; sec < PROF_SEC_COUNT; sec++) {
+        if (!Profiler_Get_Summary((Profiler_Section_e)sec, &sum)) {
+            break;
+        }
+        reply_u32(sum.count);
+        reply_u32(sum.min_us);
+        reply_u32(sum.avg_us);
+        reply_u32(sum.max_us);
+    }
+    return REMOTE_OK;
+}
+
+/**
+ * @brief 执行读取功耗统计命令
+ * @details 累计时间从启动时开始，不依赖性能分析模块。
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_get_power(void)
+{
+    uint32_t ms[POWER_RES_COUNT];
+
+    Power_Get_Residency(ms);
+    for (uint8_t i = 0; i < POWER_RES_COUNT; i++) {
+        reply_u32(ms[i]);
+    }
+    reply_u32(Power_Estimate_uAh_Day());
+    return REMOTE_OK;
+}
+
+/**
+ * @brief 执行读取温度历史命令
+ * @details 直接从RAM中的环形缓冲区 (即 EEPROM 检查点的镜像) 读出，一帧最多放满应答缓冲区，
+ *          每次请求只做几十次累加，不会推迟界面。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_get_history(const Remote_Frame_t *f, uint16_t dlen)
+{
+    int16_t prev[HISTORY_SERIES_COUNT] = {0};
+    uint32_t seq = app_history_seq();
+    uint32_t from;
+    uint16_t n_at;
+    uint8_t max = 0xFF;
+    uint8_t n = 0;
+
+    if (dlen != 4 && dlen != 5) {
+        return REMOTE_ERR_LENGTH;
+    }
+    from = (uint32_t)frame_u16(f, 2) | ((uint32_t)frame_u16(f, 4) << 16);
+    if (dlen == 5) {
+        max = frame_u8(f, 6);
+    }
+    if (from < seq - app_history_count()) {
+        from = seq - app_history_count(); // 更早的样本已被覆盖
+    } else if (from > seq) {
+        from = seq;
+    }
+
+    reply_u32(from);
+    reply_u32(seq);
+    reply_u32(app_history_newest_epoch());
+    reply_u16(APP_HISTORY_PERIOD_S);
+    n_at = reply_len;
+    reply_u8(0);
+
+    // 每个差值最多3字节 (int16_t 之差的 zigzag 不超过 17 位)
+    while (from + n < seq && n < max &&
+           reply_len + 3U * HISTORY_SERIES_COUNT <= REMOTE_REPLY_MAX - REMOTE_CRC_SIZE) {
+        uint16_t age = (uint16_t)(seq - 1U - (from + n));
+        for (uint8_t s = 0; s < HISTORY_SERIES_COUNT; s++) {
+            int16_t v = 0;
+            int32_t d;
+
+            app_history_get((History_Series_e)s, age, &v);
+            d = (int32_t)v - prev[s];
+            reply_varint(((uint32_t)d << 1) ^ (uint32_t)(d >> 31));
+            prev[s] = v;
+        }
+        n++;
+    }
+    reply[n_at] = n;
+    return REMOTE_OK;
+}
+
+/**
+ * @brief 执行读取长期数据记录命令
+ * @details 按纪元秒查找时先经索引块定位 (见 app_datalog.h)，之后按原样复制记录，一帧最多放满应答缓冲区。
+ *          闪存正在擦除扇区 (最长约400ms) 时返回忙，采集端稍后重试。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_log_read(const Remote_Frame_t *f, uint16_t dlen)
+{
+    uint32_t oldest, end, pos;
+    uint8_t mode;
+    int16_t n;
+
+    if (dlen != 5) {
+        return REMOTE_ERR_LENGTH;
+    }
+    if (!app_datalog_ready()) {
+        return REMOTE_ERR_UNSUPPORTED;
+    }
+    mode = frame_u8(f, 2);
+    pos = (uint32_t)frame_u16(f, 3) | ((uint32_t)frame_u16(f, 5) << 16);
+    if (mode > 1) {
+        return REMOTE_ERR_ARG;
+    }
+    if (mode == 1 && !app_datalog_find(pos, &pos)) {
+        return REMOTE_ERR_BUSY;
+    }
+
+    app_datalog_range(&oldest, &end);
+    reply_u32(oldest);
+    reply_u32(end);
+    reply_u32(0); // 下一位置，读完后填入
+    n = app_datalog_read(&pos, &reply[reply_len], (uint16_t)(REMOTE_REPLY_MAX - REMOTE_CRC_SIZE - reply_len));
+    if (n < 0) {
+        return REMOTE_ERR_BUSY;
+    }
+    reply_len -= 4;
+    reply_u32(pos);
+    reply_len += (uint16_t)n;
+    return REMOTE_OK;
+}
+
+/**
+ * @brief 执行屏幕镜像命令
+ * @details 镜像以租约方式运行，主机应在 MIRROR_LEASE_MS 内重复发送开始命令续约。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_mirror(const Remote_Frame_t *f, uint16_t dlen)
+{
+    uint8_t mode;
+
+    if (dlen != 1) {
+        return REMOTE_ERR_LENGTH;
+    }
+    mode = frame_u8(f, 2);
+    if (mode > 2) {
+        return REMOTE_ERR_ARG;
+    }
+    if (mode == 0) {
+        app_mirror_stop();
+        return REMOTE_OK;
+    }
+    return app_mirror_start(mode == 2) ? REMOTE_OK : REMOTE_ERR_UNSUPPORTED;
+}
+
+/**
+ * @brief 执行输入录制与回放的模式命令
+ * @details 没有录制内容时不能开始回放。应答当前的模式和事件数。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_input_mode(const Remote_Frame_t *f, uint16_t dlen)
+{
+    uint8_t mode;
+
+    if (dlen != 1) {
+        return REMOTE_ERR_LENGTH;
+    }
+    mode = frame_u8(f, 2);
+    if (mode == INPUT_REPLAY_OFF) {
+        Input_Replay_Stop();
+    } else if (mode == INPUT_REPLAY_RECORDING) {
+        Input_Replay_Record();
+    } else if (mode != INPUT_REPLAY_PLAYING || !Input_Replay_Play()) {
+        return REMOTE_ERR_ARG;
+    }
+    reply_u8((uint8_t)Input_Replay_Mode());
+    reply_u8(Input_Replay_Count());
+    return REMOTE_OK;
+}
+
+/**
+ * @brief 执行读取录制事件的命令
+ * @details 起始序号不小于事件数时只返回事件数，主机据此结束读取。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_input_read(const Remote_Frame_t *f, uint16_t dlen)
+{
+    Input_Replay_Rec_t rec;
+    uint8_t index;
+
+    if (dlen != 1) {
+        return REMOTE_ERR_LENGTH;
+    }
+    index = frame_u8(f, 2);
+    reply_u8(Input_Replay_Count());
+    for (uint8_t n = 0; n < REMOTE_INPUT_READ_MAX && Input_Replay_Get(index + n, &rec); n++) {
+        reply_u16(rec.dt_ms);
+        reply_u16(rec.event);
+        reply_u16((uint16_t)rec.value);
+        reply_u16((uint16_t)rec.accel_value);
+    }
+    return REMOTE_OK;
+}
+
+/**
+ * @brief 执行写入录制事件的命令
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_input_write(const Remote_Frame_t *f, uint16_t dlen)
+{
+    Input_Replay_Rec_t rec;
+
+    if (dlen != 9) {
+        return REMOTE_ERR_LENGTH;
+    }
+    if (Input_Replay_Mode() != INPUT_REPLAY_OFF) {
+        return REMOTE_ERR_BUSY;
+    }
+    rec.dt_ms = frame_u16(f, 3);
+    rec.event = frame_u16(f, 5);
+    rec.value = (int16_t)frame_u16(f, 7);
+    rec.accel_value = (int16_t)frame_u16(f, 9);
+    if (rec.event > INPUT_EVENT_DOUBLE_CLICK) {
+        return REMOTE_ERR_ARG;
+    }
+    return Input_Replay_Put(frame_u8(f, 2), &rec) ? REMOTE_OK : REMOTE_ERR_ARG;
+}
+
+/**
+ * @brief 执行进入引导程序的命令
+ * @details 数据必须是 "BOOT"，防止误码或错发的帧让时钟停下来。复位在应答发送完毕后进行
+ *          (app_remote_service)，USB 虚拟串口上的请求也一样，之后的传输在 USART1 上进行。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_boot(const Remote_Frame_t *f, uint16_t dlen)
+{
+    static const char key[4] = {'B', 'O', 'O', 'T'};
+
+    if (dlen != sizeof(key)) {
+        return REMOTE_ERR_LENGTH;
+    }
+    for (uint8_t i = 0; i < sizeof(key); i++) {
+        if (frame_u8(f, REMOTE_HEADER_SIZE + i) != (uint8_t)key[i]) {
+            return REMOTE_ERR_ARG;
+        }
+    }
+    if (!APP_BOOTLOADER) {
+        return REMOTE_ERR_UNSUPPORTED;
+    }
+    boot_pending = true;
+    return REMOTE_OK;
+}
+
+/**
+ * @brief 执行查询资源区的命令
+ * @details 写入工具在写完资源块后带参数 1 调用，重新校验 (读出整个块，每KB约0.5ms) 后应答块长度。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_asset_info(const Remote_Frame_t *f, uint16_t dlen)
+{
+    if (dlen > 1) {
+        return REMOTE_ERR_LENGTH;
+    }
+    if (app_asset_region_size() == 0) {
+        return REMOTE_ERR_UNSUPPORTED;
+    }
+    if (dlen == 1) {
+        if (frame_u8(f, 2) != 1) {
+            return REMOTE_ERR_ARG;
+        }
+        if (W25Q_Is_Busy()) {
+            return REMOTE_ERR_BUSY; // 最后一次编程或擦除尚未结束
+        }
+        app_asset_mount();
+    }
+    reply_u32(app_asset_region_size());
+    reply_u32(app_asset_blob_size());
+    reply_u8(APP_ASSET_COUNT);
+    return REMOTE_OK;
+}
+
+/**
+ * @brief 执行擦除或写入资源区的命令
+ * @details 闪存忙 (上一次擦除或编程、长期数据记录的写入) 时返回忙，写入工具稍后重发。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @param[in] erase true 为擦除扇区，false 为写入数据
+ * @return Remote_Status_e 执行结果
+ */
+static Remote_Status_e cmd_asset_write(const Remote_Frame_t *f, uint16_t dlen, bool erase)
+{
+    uint8_t data[APP_ASSET_WRITE_MAX];
+    uint32_t offset;
+    HAL_StatusTypeDef status;
+
+    if (erase ? dlen != 4 : (dlen <= 4 || dlen > 4 + APP_ASSET_WRITE_MAX)) {
+        return REMOTE_ERR_LENGTH;
+    }
+    if (app_asset_region_size() == 0) {
+        return REMOTE_ERR_UNSUPPORTED;
+    }
+    offset = (uint32_t)frame_u16(f, 2) | ((uint32_t)frame_u16(f, 4) << 16);
+    if (erase) {
+        status = app_asset_erase(offset);
+    } else {
+        for (uint16_t i = 0; i < dlen - 4; i++) {
+            data[i] = frame_u8(f, 6 + i);
+        }
+        status = app_asset_program(offset, data, (uint8_t)(dlen - 4));
+    }
+    if (status == HAL_BUSY) {
+        return REMOTE_ERR_BUSY;
+    }
+    return (status == HAL_OK) ? REMOTE_OK : REMOTE_ERR_ARG;
+}
+
+/**
+ * @brief 主机在每分钟的秒边沿广播时间信标
+ * @details 只在发送缓冲区为空时发送，DMA 立即开始发送，写入之前量出的秒边沿之后的延迟就是起始位的时刻，
+ *          作为序号字段发给从机；主循环的处理延迟因此不影响精度。输出繁忙超过 REMOTE_BEACON_LATE_MS 时放弃这一分钟。
+ *          USB 虚拟串口打开时不发送 (主机上的工具不认识不请自来的帧)。
+ * @return 无
+ */
+static void beacon_send(void)
+{
+#if REMOTE_BEACON_ROLE == REMOTE_BEACON_MASTER
+    DS3231_Cache_Snap_t snap;
+    uint32_t late;
+
+    if (tx_pending != 0 || !UART_Printf_Is_Idle() || USB_CDC_Is_Open() || !DS3231_Cache_Get(&snap) ||
+        snap.ticks == 0 || snap.epoch % REMOTE_BEACON_PERIOD_S != 0 || snap.epoch == beacon_sent) {
+        return;
+    }
+    late = HAL_GetTick() - snap.edge_ms;
+    beacon_sent = snap.epoch;
+    if (late > REMOTE_BEACON_LATE_MS) {
+        return;
+    }
+    reply[0] = REMOTE_CMD_BEACON;
+    reply[1] = (uint8_t)late;
+    reply_len = REMOTE_HEADER_SIZE;
+    reply_u32(snap.epoch);
+    reply_send();
+#endif
+}
+
+/**
+ * @brief 从机处理收到的时间信标
+ * @details 空闲中断记下的位置须正好在这一帧的分隔符之后，否则时间戳属于后来的数据，丢弃这一次。
+ *          偏差 = 本机缓存中主机这一秒开始时刻的时间 - 信标的时间。
+ * @param[in] f 帧
+ * @param[in] end 分隔符之后的位置
+ * @param[in] wire_len 帧在线上的字节数 (含分隔符)
+ * @return 无
+ */
+static void beacon_receive(const Remote_Frame_t *f, uint16_t end, uint16_t wire_len)
+{
+#if REMOTE_BEACON_ROLE == REMOTE_BEACON_FOLLOWER
+    DS3231_Cache_Snap_t snap;
+    Epoch_t epoch;
+    uint16_t pos;
+    uint32_t idle_ms;
+    uint32_t second_ms;
+    int32_t diff_s;
+    int32_t err_ms;
+    bool resync;
+
+    if (f->len != REMOTE_BEACON_SIZE || !UART_Rx_Idle_Stamp(&pos, &idle_ms) || pos != end ||
+        DS3231_SetTimeSync_Pending()) {
+        return;
+    }
+    epoch = (Epoch_t)frame_u16(f, 2) | ((Epoch_t)frame_u16(f, 4) << 16);
+
+    // 空闲在最后一个字节之后再过一个字符时间产生；起始位之前还有主机的发送延迟
+    second_ms = idle_ms - ((uint32_t)(wire_len + 1U) * UART_Char_Us() + 500U) / 1000U - frame_u8(f, 1);
+
+    if (!DS3231_Cache_Get(&snap)) {
+        resync = true;
+    } else {
+        diff_s = (int32_t)(snap.epoch - epoch);
+        if (diff_s > 86400 || diff_s < -86400) {
+            resync = true;
+        } else {
+            err_ms = diff_s * 1000 + (int32_t)(second_ms - snap.edge_ms);
+            resync = (err_ms >= REMOTE_BEACON_STEP_MS || err_ms <= -REMOTE_BEACON_STEP_MS) || !beacon_synced ||
+                     HAL_GetTick() - beacon_sync_ms >= REMOTE_BEACON_SYNC_S * 1000UL;
+        }
+    }
+    if (resync && DS3231_SetTimeSync(epoch, second_ms) == HAL_OK) {
+        beacon_synced = true;
+        beacon_sync_ms = HAL_GetTick();
+    }
+#else
+    (void)f;
+    (void)end;
+    (void)wire_len;
+#endif
+}
+
+/**
+ * @brief 解码、校验并执行一帧
+ * @details 解码失败或 CRC 错误的帧没有可信的序号，直接丢弃不应答，由主机超时重发。
+ *          时间信标是广播，不应答。
+ * @param[in] start 帧在接收缓冲区中的起点
+ * @param[in] len 编码后的长度
+ * @return bool 执行了修改设置的命令时返回 true
+ */
+static bool handle_frame(uint16_t start, uint16_t len)
+{
+    Remote_Frame_t f;
+    Remote_Status_e status;
+    Time_t t;
+    bool changed = false;
+    uint8_t cmd;
+    uint16_t dlen;
+
+    f.ring = UART_Rx_Ring();
+    f.start = start;
+    f.len = cobs_decode_ring(UART_Rx_Ring(), start, len);
+    if (f.len < REMOTE_HEADER_SIZE + REMOTE_CRC_SIZE || !frame_crc_ok(&f)) {
+        return false;
+    }
+
+    cmd = frame_u8(&f, 0);
+    if (cmd == REMOTE_CMD_BEACON) {
+        beacon_receive(&f, RING_AT(start + len + 1), len + 1);
+        return false;
+    }
+    dlen = f.len - REMOTE_HEADER_SIZE - REMOTE_CRC_SIZE;
+    reply_begin(cmd, frame_u8(&f, 1));
+
+    switch (cmd) {
+        case REMOTE_CMD_PING:
+            status = REMOTE_OK;
+            reply_u8(REMOTE_PROTOCOL_VERSION);
+            break;
+        case REMOTE_CMD_GET_TIME:
+            status = REMOTE_OK;
+            DS3231_GetCachedTime(&t);
+            reply_u16(t.year);
+            reply_u8(t.month);
+            reply_u8(t.day);
+            reply_u8(t.hour);
+            reply_u8(t.minute);
+            reply_u8(t.second);
+            reply_u8(t.week);
+            break;
+        case REMOTE_CMD_SET_TIME:
+            status = cmd_set_time(&f, dlen);
+            break;
+        case REMOTE_CMD_GET_SETTINGS:
+            status = REMOTE_OK;
+            reply_u8(g_app_settings.language);
+            reply_u8((uint8_t)g_app_settings.auto_off);
+            reply_u8(g_app_settings.dst_enabled ? 1 : 0);
+            reply_u8(g_app_settings.dst_zone);
+            reply_u8(g_app_settings.brightness);
+            reply_u8(g_app_settings.display_mode);
+            reply_u8(g_app_settings.env_alert);
+            reply_u8(g_app_settings.temp_low);
+            reply_u8(g_app_settings.temp_high);
+            reply_u8(g_app_settings.humi_low);
+            reply_u8(g_app_settings.humi_high);
+            reply_u8(APP_NIGHT_MODE(g_app_settings.night_rule));
+            reply_u8(APP_NIGHT_START(g_app_settings.night_rule));
+            reply_u8(g_app_settings.night_end);
+            break;
+        case REMOTE_CMD_PUT_SETTINGS:
+            status = cmd_put_settings(&f, dlen, &changed);
+            break;
+        case REMOTE_CMD_GET_PROFILE:
+            status = cmd_get_profile();
+            break;
+        case REMOTE_CMD_GET_POWER:
+            status = cmd_get_power();
+            break;
+        case REMOTE_CMD_GET_SUPPLY:
+            status = REMOTE_OK;
+            reply_u16(app_battery_mv());
+            reply_u8(app_battery_percent());
+            reply_u8((uint8_t)app_battery_level());
+            break;
+        case REMOTE_CMD_GET_USAGE:
+            status = REMOTE_OK;
+            for (uint8_t i = 0; i < APP_USAGE_COUNT; i++) {
+                reply_u32(app_usage_get((App_Usage_e)i));
+            }
+            break;
+        case REMOTE_CMD_GET_HISTORY:
+            status = cmd_get_history(&f, dlen);
+            break;
+        case REMOTE_CMD_LOG_READ:
+            status = cmd_log_read(&f, dlen);
+            break;
+        case REMOTE_CMD_MIRROR:
+            status = cmd_mirror(&f, dlen);
+            break;
+        case REMOTE_CMD_INPUT_MODE:
+            status = cmd_input_mode(&f, dlen);
+            break;
+        case REMOTE_CMD_INPUT_READ:
+            status = cmd_input_read(&f, dlen);
+            break;
+        case REMOTE_CMD_INPUT_WRITE:
+            status = cmd_input_write(&f, dlen);
+            break;
+        case REMOTE_CMD_BOOT:
+            status = cmd_boot(&f, dlen);
+            break;
+        case REMOTE_CMD_ASSET_INFO:
+            status = cmd_asset_info(&f, dlen);
+            break;
+        case REMOTE_CMD_ASSET_ERASE:
+            status = cmd_asset_write(&f, dlen, true);
+            break;
+        case REMOTE_CMD_ASSET_WRITE:
+            status = cmd_asset_write(&f, dlen, false);
+            break;
+        default:
+            status = REMOTE_ERR_COMMAND;
+            break;
+    }
+
+    if (status != REMOTE_OK) {
+        reply_len = REMOTE_HEADER_SIZE + 1; // 出错时只返回状态
+    }
+    reply[REMOTE_HEADER_SIZE] = (uint8_t)status;
+    reply_send();
+    return changed;
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 初始化远程控制并启动串口DMA循环接收
+ * @return 无
+ */
+void app_remote_init(void)
+{
+    rx_tail = 0;
+    rx_scan = 0;
+    rx_overlong = false;
+    rx_seen = false;
+    tx_pending = 0;
+    boot_pending = false;
+    UART_Rx_Start();
+}
+
+/**
+ * @brief 解析已收到的帧并执行命令，需在主循环中周期调用
+ * @return bool 本次执行了修改设置的命令时返回 true
+ */
+bool app_remote_service(void)
+{
+    uint8_t events = UART_Rx_Take_Events();
+    const uint8_t *ring = UART_Rx_Ring();
+    bool changed = false;
+    uint16_t head;
+
+    if (events & UART_RX_EVENT_RESET) {
+        rx_tail = 0; // 重新启动后DMA从头写入，之前未处理的数据作废
+        rx_scan = 0;
+        rx_overlong = false;
+    }
+    if (events & (UART_RX_EVENT_DATA | UART_RX_EVENT_WAKE)) {
+        rx_seen = true; // 唤醒的那一帧已不完整，之后的宽限期内不再进入停止模式，主机重发的请求照常处理
+        last_rx_ms = HAL_GetTick();
+    }
+
+    tx_try();
+    beacon_send();
+#if APP_BOOTLOADER
+    if (boot_pending && tx_pending == 0 && UART_Printf_Is_Idle()) {
+        Boot_Request(); // 不返回
+    }
+#endif
+    head = UART_Rx_Head();
+
+    // 上一帧的应答发出去之前不处理下一帧，这段数据留在缓冲区中
+    while (tx_pending == 0 && rx_scan != head) {
+        if (ring[rx_scan] == 0x00) {
+            uint16_t len = RING_AT(rx_scan + UART_RX_RING_SIZE - rx_tail);
+            if (!rx_overlong && len != 0) {
+                changed |= handle_frame(rx_tail, len);
+            }
+            rx_overlong = false;
+            rx_scan = RING_AT(rx_scan + 1);
+            rx_tail = rx_scan;
+        } else {
+            rx_scan = RING_AT(rx_scan + 1);
+            if (RING_AT(rx_scan + UART_RX_RING_SIZE - rx_tail) >= REMOTE_RX_FRAME_MAX) {
+                rx_overlong = true; // 不可能是有效的请求，只找下一个分隔符
+                rx_tail = rx_scan;
+            }
+        }
+    }
+    return changed;
+}
+
+/**
+ * @brief 串口最近是否有通信
+ * @return bool 在 REMOTE_ACTIVE_MS 内收到过数据或还有应答未发送完时返回 true
+ */
+bool app_remote_is_active(void)
+{
+    if (tx_pending != 0 || !UART_Printf_Is_Idle()) {
+        return true;
+    }
+    return rx_seen && HAL_GetTick() - last_rx_ms < REMOTE_ACTIVE_MS;
+}
+
+/**
+ * @brief 是否需要串口保持工作
+ * @return bool 串口最近有通信或启用了时间信标时返回 true
+ */
+bool app_remote_holds_uart(void)
+{
+    return REMOTE_BEACON_ROLE != REMOTE_BEACON_OFF || app_remote_is_active();
+}
+
+/** @} */
@@ -0,0 +1,129 @@
+/**
+ * @file      app_remote.h
+ * @brief     串口对时与远程控制协议头文件
+ * @details   USART1 上的二进制帧协议，用于批量设置时钟 (对时、下发设置) 和读取性能统计。
+ *            帧格式：COBS(负载) + 0x00，负载 = | 命令 (1) | 序号 (1) | 数据 (N) | CRC-16 (2, 小端) |，
+ *            CRC 为 CRC-16/CCITT，覆盖命令到数据的全部字节。
+ *            应答的命令为请求命令 | 0x80，序号原样返回，数据的第一个字节为 Remote_Status_e。
+ *            多字节字段均为小端。接收使用DMA循环缓冲区，帧在缓冲区中原地解码和解析，不复制。
+ *            时间信标：多台时钟的 USART1 接在同一条总线 (或 RS-485 收发器) 上时，编为主机的一台在每分钟的
+ *            SQW 秒边沿广播一帧 REMOTE_CMD_BEACON，其余编为从机的只接收不应答。从机在空闲中断中记下帧结束的时刻，
+ *            减去帧在线上的时间得到起始位的时刻，再减去主机写在帧中的发送延迟，就是主机这一秒开始的时刻；
+ *            与自己的时间缓存比较，偏差超过 REMOTE_BEACON_STEP_MS 或距上一次对时已满 REMOTE_BEACON_SYNC_S 时
+ *            按这一时刻对时 (与对时命令相同，同时为漂移日志记录一点)。每分钟只有一帧 (约1ms)，不另外需要时间基准。
+ *            温度历史导出 (REMOTE_CMD_GET_HISTORY)：每个值 (0.1°C) 与本帧中同一序列的前一个值之差 (第一个样本与 0 之差)
+ *            按 zigzag ((d << 1) ^ (d >> 31)) 映射为无符号数，再以 varint (每字节低7位，最高位为1表示后面还有) 编码，
+ *            温度缓慢变化时每个值只占1字节。一帧放不下时只返回前一部分，采集端以 首个样本的序号 + 样本数 作为下一次的
+ *            起始序号，直到等于样本总数；起始序号早于保留的最早样本时从最早的样本开始 (首个样本的序号大于请求的值)，
+ *            样本总数小于上一次读到的值说明记录已清空，应从 0 重新读取。
+ *            长期数据记录导出 (REMOTE_CMD_LOG_READ)：第一次按纪元秒请求，之后以应答中的下一位置按位置请求，
+ *            下一位置等于末尾位置时已读完；请求的位置早于最早位置 (扇区已被覆盖) 时从最早的记录开始。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.4
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_REMOTE_H
+#define __APP_REMOTE_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppRemote 远程控制
+ * @brief 实现了串口帧的接收、校验和命令分发。
+ * @{
+ */
+
+/**
+ * @defgroup AppRemote_Config 远程控制配置
+ * @{
+ */
+#define REMOTE_PROTOCOL_VERSION 16   ///< 协议版本，由 REMOTE_CMD_PING 返回 (2: 设置中增加亮度; 3: 屏幕镜像; 4: 输入录制与回放; 5: 功耗统计; 6: 供电电压; 7: 设置中增加显示模式; 8: 使用统计; 9: 对时增加毫秒; 10: 设置中增加温湿度越限提醒; 11: 进入引导程序; 12: 时间信标; 13: 温度历史导出; 14: 长期数据记录导出; 15: 资源区写入; 16: 设置中增加夜间时段)
+#define REMOTE_RX_FRAME_MAX     32   ///< 请求帧 (编码后) 的最大长度，更长的帧直接丢弃
+#define REMOTE_TX_FRAME_MAX     224  ///< 应答帧 (编码后) 的最大长度 (性能统计的应答最长)
+#define REMOTE_ACTIVE_MS        5000 ///< 最近一次收到数据或被 RX 线唤醒后的这段时间内不进入停止模式 (停止模式下串口不工作)
+#define REMOTE_INPUT_READ_MAX   8    ///< REMOTE_CMD_INPUT_READ 一次最多返回的录制事件数
+
+#define REMOTE_BEACON_OFF       0    ///< 不发送也不接收时间信标
+#define REMOTE_BEACON_MASTER    1    ///< 每分钟广播时间信标
+#define REMOTE_BEACON_FOLLOWER  2    ///< 按收到的时间信标对时
+#ifndef REMOTE_BEACON_ROLE
+#define REMOTE_BEACON_ROLE      REMOTE_BEACON_OFF ///< 本机在时间信标中的角色；不为 OFF 时不进入停止模式 (串口须一直工作)
+#endif
+#define REMOTE_BEACON_PERIOD_S  60    ///< 主机广播的间隔 (s)，在纪元秒为其整数倍的秒边沿发送
+#define REMOTE_BEACON_LATE_MS   200   ///< 主机在秒边沿之后这段时间内仍未能发送 (输出繁忙) 时放弃这一次
+#define REMOTE_BEACON_STEP_MS   20    ///< 从机的偏差达到该值时立即对时
+#define REMOTE_BEACON_SYNC_S    21600 ///< 偏差较小时从机对时的最短间隔 (s)，与无线电授时相同，避免每分钟写入漂移日志
+/** @} */
+
+/**
+ * @brief 命令码
+ */
+typedef enum {
+    REMOTE_CMD_PING         = 0x01, ///< 请求：无；应答：协议版本 (1)
+    REMOTE_CMD_GET_TIME     = 0x10, ///< 请求：无；应答：年 (2) 月 日 时 分 秒 星期 (标准时间)
+    REMOTE_CMD_SET_TIME     = 0x11, ///< 请求：年 (2) 月 日 时 分 秒 (标准时间) [毫秒 (2)，可省略]；应答：无 (在之后的整秒写入)
+    REMOTE_CMD_BEACON       = 0x12, ///< 广播：序号字段为起始位距这一秒开始的毫秒数，数据为纪元秒 (4，标准时间)；不应答 (负载共8字节)
+    REMOTE_CMD_GET_SETTINGS = 0x20, ///< 请求：无；应答：语言 自动熄屏 夏令时开关 夏令时规则 亮度 显示模式 越限提醒开关 温度下限 上限 (℃) 湿度下限 上限 (%RH) 夜间时段的显示方式 (Night_Mode_e) 开始 结束 (半小时序号 0~47)
+    REMOTE_CMD_PUT_SETTINGS = 0x21, ///< 请求：语言 自动熄屏 夏令时开关 夏令时规则 [亮度 [显示模式 [越限提醒的5项 [夜间时段的3项]]]，可省略]；应答：无 (保存在后台完成)
+    REMOTE_CMD_GET_PROFILE  = 0x30, ///< 请求：无；应答：窗口长度 (4) 负载千分比 (2)，之后每个代码段 次数 最短 平均 最长 (各4，us)
+    REMOTE_CMD_GET_POWER    = 0x31, ///< 请求：无；应答：各功耗状态的累计时间 (各4，ms，按 Power_Res_e 的顺序) 每天耗电的估算 (4，uAh)
+    REMOTE_CMD_GET_SUPPLY   = 0x32, ///< 请求：无；应答：供电电压 (2，mV，0 为尚未测量) 电量百分比 等级 (App_Battery_Level_e)
+    REMOTE_CMD_GET_USAGE    = 0x33, ///< 请求：无；应答：各项使用统计 (各4，按 App_Usage_e 的顺序，小时数为整小时)
+    REMOTE_CMD_GET_HISTORY  = 0x34, ///< 请求：起始序号 (4) [最多样本数，可省略]；应答：首个样本的序号 (4) 样本总数 (4) 最新样本的纪元秒 (4) 周期 (2，s) 样本数 (1)，之后每个样本按 History_Series_e 的顺序各一个差值 (见文件说明)
+    REMOTE_CMD_LOG_READ     = 0x35, ///< 请求：方式 (0 按位置，1 按纪元秒) 值 (4)；应答：最早位置 (4) 末尾位置 (4) 下一位置 (4)，之后为按原样复制的记录 (见 app_datalog.h)
+    REMOTE_CMD_MIRROR       = 0x40, ///< 请求：模式 (0 停止，1 开始或续约，2 开始并整屏重发)；应答：无，画面以镜像帧发送 (见 app_mirror.h)
+    REMOTE_CMD_INPUT_MODE   = 0x50, ///< 请求：模式 (0 停止，1 开始录制，2 开始回放)；应答：当前模式 事件数
+    REMOTE_CMD_INPUT_READ   = 0x51, ///< 请求：起始序号；应答：事件数，之后最多 REMOTE_INPUT_READ_MAX 条录制事件 (各8，见 input_replay.h)
+    REMOTE_CMD_INPUT_WRITE  = 0x52, ///< 请求：序号 录制事件 (8)，序号为0时先清空，否则须按顺序追加；应答：无
+    REMOTE_CMD_BOOT         = 0x60, ///< 请求："BOOT" (4)；应答：无，应答发出后复位进入引导程序的升级模式 (见 Boot/boot.h)
+    REMOTE_CMD_ASSET_INFO   = 0x70, ///< 请求：[1 为先重新校验资源块，可省略]；应答：资源区容量 (4) 已校验的块长度 (4，0 为无效) 固件认识的资源数 (1)
+    REMOTE_CMD_ASSET_ERASE  = 0x71, ///< 请求：资源区内的偏移 (4，扇区对齐)；应答：无 (擦除在后台进行，期间写入返回忙)
+    REMOTE_CMD_ASSET_WRITE  = 0x72, ///< 请求：资源区内的偏移 (4) 数据 (1~APP_ASSET_WRITE_MAX，不跨页)；应答：无 (见 app_asset.h)
+} Remote_Cmd_e;
+
+/**
+ * @brief 应答状态
+ */
+typedef enum {
+    REMOTE_OK = 0,          ///< 成功
+    REMOTE_ERR_LENGTH,      ///< 数据长度与命令不符
+    REMOTE_ERR_ARG,         ///< 参数超出范围
+    REMOTE_ERR_BUSY,        ///< 设置尚未加载完成、上一次保存尚未结束或上一次对时正在写入
+    REMOTE_ERR_COMMAND,     ///< 未知命令
+    REMOTE_ERR_UNSUPPORTED, ///< 该固件未包含此功能 (如关闭了 PROFILER_ENABLE、分页模式下的屏幕镜像、没有外部闪存时的 REMOTE_CMD_LOG_READ 和资源区命令，或不带引导程序的构建收到 REMOTE_CMD_BOOT)
+} Remote_Status_e;
+
+/**
+ * @brief 初始化远程控制并启动串口DMA循环接收
+ * @return 无
+ */
+void app_remote_init(void);
+
+/**
+ * @brief 解析已收到的帧并执行命令，需在主循环中周期调用
+ * @details 上一帧的应答还没发送出去时暂停解析，后面的帧留在接收缓冲区中。
+ * @return bool 本次执行了修改设置的命令时返回 true，调用者应重新应用设置 (如自动熄屏时间)
+ */
+bool app_remote_service(void);
+
+/**
+ * @brief 串口最近是否有通信
+ * @details 停止模式被 RX 线唤醒也算作收到数据：唤醒时丢失了字节的请求得不到应答，主机超时重发时串口已在工作。
+ * @return bool 在 REMOTE_ACTIVE_MS 内收到过数据或还有应答未发送完时返回 true
+ */
+bool app_remote_is_active(void);
+
+/**
+ * @brief 是否需要串口保持工作
+ * @details 串口最近有通信，或本机在时间信标中担任主机或从机时返回 true，调用者此时不应进入停止模式。
+ * @return bool 不能停止串口时返回 true
+ */
+bool app_remote_holds_uart(void);
+
+/** @} */
+
+#endif /* __APP_REMOTE_H */
@@ -0,0 +1,143 @@
+/**
+ * @file      app_resume.c
+ * @brief     界面上下文的断电保持
+ * @details   记录格式 (每个备份寄存器16位)：
+ *            - DR1：高8位为 APP_RESUME_MAGIC，低8位为页面数；
+ *            - DR2~DR5：页面ID，每个寄存器两个，低字节在前，从栈底到当前页面；
+ *            - DR6~DR9：与页面ID对应的恢复状态，排列相同；
+ *            - DR10：DR1~DR9 的校验 (累加和取反)。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_resume.h"
+#include "app_display.h"
+
+/**
+ * @addtogroup AppResume
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define RESUME_DR(i)     ((&BKP->DR1)[(i)])       ///< 第 i 个备份数据寄存器 (0 为 DR1)
+#define RESUME_HEADER    0                        ///< 记录头所在的寄存器
+#define RESUME_IDS       1                        ///< 页面ID的第一个寄存器
+#define RESUME_VALUES    (RESUME_IDS + APP_RESUME_DEPTH / 2)    ///< 恢复状态的第一个寄存器
+#define RESUME_SUM       (RESUME_VALUES + APP_RESUME_DEPTH / 2) ///< 校验所在的寄存器
+
+#if RESUME_SUM >= 10 || (APP_RESUME_DEPTH % 2) != 0
+#error "APP_RESUME_DEPTH must be even and fit in BKP_DR1..DR10"
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static uint16_t resume_sum(void);
+static void resume_write_bytes(uint8_t reg, const uint8_t *bytes);
+static void resume_read_bytes(uint8_t reg, uint8_t *bytes);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 计算记录的校验值
+ * @return uint16_t DR1~DR9 的16位累加和取反
+ */
+static uint16_t resume_sum(void)
+{
+    uint16_t sum = 0;
+
+    for (uint8_t i = RESUME_HEADER; i < RESUME_SUM; i++) {
+        sum += (uint16_t)RESUME_DR(i);
+    }
+    return (uint16_t)~sum;
+}
+
+/**
+ * @brief 把 APP_RESUME_DEPTH 个字节写入连续的寄存器
+ * @param[in] reg 第一个寄存器
+ * @param[in] bytes 数据
+ * @return 无
+ */
+static void resume_write_bytes(uint8_t reg, const uint8_t *bytes)
+{
+    for (uint8_t i = 0; i < APP_RESUME_DEPTH / 2; i++) {
+        RESUME_DR(reg + i) = (uint32_t)bytes[2 * i] | ((uint32_t)bytes[2 * i + 1] << 8);
+    }
+}
+
+/**
+ * @brief 从连续的寄存器读出 APP_RESUME_DEPTH 个字节
+ * @param[in] reg 第一个寄存器
+ * @param[out] bytes 数据
+ * @return 无
+ */
+static void resume_read_bytes(uint8_t reg, uint8_t *bytes)
+{
+    for (uint8_t i = 0; i < APP_RESUME_DEPTH / 2; i++) {
+        uint16_t v = (uint16_t)RESUME_DR(reg + i);
+        bytes[2 * i] = (uint8_t)v;
+        bytes[2 * i + 1] = (uint8_t)(v >> 8);
+    }
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 初始化，打开备份寄存器的时钟和写访问
+ * @details PWR 时钟已在 HAL_MspInit 中打开。写访问 (DBP) 一直保持打开，片内RTC (rtc_lse) 同样需要。
+ * @return 无
+ */
+void app_resume_init(void)
+{
+    __HAL_RCC_BKP_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+}
+
+/**
+ * @brief 把当前页面堆栈写入备份寄存器
+ * @return 无
+ */
+void app_resume_save(void)
+{
+    uint8_t ids[APP_RESUME_DEPTH] = {0};
+    uint8_t values[APP_RESUME_DEPTH] = {0};
+    uint8_t count = Page_Manager_Save_Stack(ids, values, APP_RESUME_DEPTH);
+
+    RESUME_DR(RESUME_HEADER) = ((uint32_t)APP_RESUME_MAGIC << 8) | count;
+    resume_write_bytes(RESUME_IDS, ids);
+    resume_write_bytes(RESUME_VALUES, values);
+    RESUME_DR(RESUME_SUM) = resume_sum();
+}
+
+/**
+ * @brief 从备份寄存器恢复页面堆栈
+ * @return bool 已恢复返回 true
+ */
+bool app_resume_restore(void)
+{
+    uint16_t header = (uint16_t)RESUME_DR(RESUME_HEADER);
+    uint8_t ids[APP_RESUME_DEPTH];
+    uint8_t values[APP_RESUME_DEPTH];
+    uint8_t count = (uint8_t)header;
+
+    if ((header >> 8) != APP_RESUME_MAGIC || count > APP_RESUME_DEPTH ||
+        (uint16_t)RESUME_DR(RESUME_SUM) != resume_sum()) {
+        return false;
+    }
+    resume_read_bytes(RESUME_IDS, ids);
+    resume_read_bytes(RESUME_VALUES, values);
+    app_resume_clear();
+
+    return Page_Manager_Restore_Stack(ids, values, count);
+}
+
+/**
+ * @brief 清除备份寄存器中的记录
+ * @return 无
+ */
+void app_resume_clear(void)
+{
+    RESUME_DR(RESUME_HEADER) = 0;
+}
+
+/** @} */
@@ -0,0 +1,65 @@
+/**
+ * @file      app_resume.h
+ * @brief     界面上下文的断电保持头文件
+ * @details   熄屏前把页面堆栈 (页面ID和各页面的选中项、焦点等恢复状态) 写入 STM32F103 的
+ *            备份数据寄存器 BKP_DR1~DR10，唤醒或复位后从中恢复，不访问 EEPROM，也没有 I2C 传输。
+ *            备份寄存器由 VBAT 供电，系统复位和停止模式下保持；VBAT 未接电池时断电后丢失，
+ *            此时校验不通过，界面从主页开始。一条记录只恢复一次，恢复后即清除，
+ *            某个页面引起的复位不会在下一次启动时反复进入同一个页面。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_RESUME_H
+#define __APP_RESUME_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppResume 界面上下文保持
+ * @brief 用备份寄存器保存和恢复页面堆栈。
+ * @{
+ */
+
+/**
+ * @defgroup AppResume_Config 界面上下文保持配置
+ * @{
+ */
+#define APP_RESUME_DEPTH 8    ///< 最多保存的页面数 (含当前页面)，更早的历史记录被丢弃
+#define APP_RESUME_MAGIC 0xC5 ///< 记录头的标识，修改记录格式时须更换
+/** @} */
+
+/**
+ * @brief 初始化，打开备份寄存器的时钟和写访问
+ * @return 无
+ */
+void app_resume_init(void);
+
+/**
+ * @brief 把当前页面堆栈写入备份寄存器
+ * @details 在熄屏、页面堆栈被清空之前调用。只有寄存器写入，耗时约 1us。
+ * @return 无
+ */
+void app_resume_save(void);
+
+/**
+ * @brief 从备份寄存器恢复页面堆栈
+ * @details 记录有效时立即切换到保存时的页面 (无动画)，历史记录和各页面的恢复状态一并恢复，然后清除记录。
+ * @return bool 已恢复返回 true，没有有效记录时返回 false (页面不变)
+ */
+bool app_resume_restore(void);
+
+/**
+ * @brief 清除备份寄存器中的记录
+ * @details 界面不经过恢复就离开熄屏状态时 (如闹钟响铃) 调用，避免之后的复位恢复过期的页面。
+ * @return 无
+ */
+void app_resume_clear(void);
+
+/** @} */
+
+#endif /* __APP_RESUME_H */
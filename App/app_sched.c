@@ -0,0 +1,241 @@
+/**
+ * @file      app_sched.c
+ * @brief     协作式任务调度
+ * @details   待处理事件掩码在中断和主循环之间共享，置位和取走都在关中断的几条指令内完成。
+ *            选择任务时从下标0开始找第一个有事件且本轮未达到运行上限的任务，任务数很少，线性查找即可。
+ *            RTOS 配置下事件存放在线程标志中 (最高位是内核的错误标志，事件不能使用)，
+ *            线程栈静态分配，控制块由内核的对象池提供。
+ * @author    SandOcean
+ * @date      2025-10-03
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_sched.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup AppSched
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define SCHED_FLAGS_MASK 0x7FFFFFFFUL ///< RTOS 配置下可用作事件的线程标志
+
+/* Private variables ---------------------------------------------------------*/
+static const App_Sched_Task_t *sched_tasks = NULL;           ///< 任务表
+static uint8_t sched_count = 0;                              ///< 任务数
+#if APP_SCHED_RTOS
+static osThreadId_t sched_threads[APP_SCHED_MAX_TASKS];      ///< 各任务的线程
+static osMutexId_t sched_lock;                               ///< 任务函数运行期间持有，保持运行到完成的语义
+static uint64_t sched_stacks[APP_SCHED_MAX_TASKS][APP_SCHED_RTOS_STACK / 8]; ///< 线程栈 (8字节对齐)
+#else
+static volatile uint32_t sched_pending[APP_SCHED_MAX_TASKS]; ///< 各任务待处理的事件
+static uint8_t sched_runs[APP_SCHED_MAX_TASKS];              ///< 各任务本轮已运行的次数
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+#if APP_SCHED_RTOS
+static void sched_thread(void *argument);
+#else
+static int8_t sched_pick(void);
+static uint32_t sched_take(uint8_t task);
+#endif
+
+/* Private Function implementations ------------------------------------------*/
+
+#if APP_SCHED_RTOS
+
+/**
+ * @brief 任务线程
+ * @details 轮询式任务等到 app_sched_poll_deadline() 为止，期间收到的事件提前唤醒它；
+ *          其他任务一直等待事件。
+ * @param[in] argument 任务下标
+ * @return 无
+ */
+static void sched_thread(void *argument)
+{
+    const App_Sched_Task_t *task = &sched_tasks[(uint32_t)argument];
+
+    for (;;) {
+        uint32_t timeout = osWaitForever;
+        uint32_t events;
+
+        if (task->poll) {
+            int32_t wait = (int32_t)(app_sched_poll_deadline() - HAL_GetTick());
+            timeout = (wait > 0) ? (uint32_t)wait : 0U;
+        }
+        events = osThreadFlagsWait(SCHED_FLAGS_MASK, osFlagsWaitAny, timeout);
+        if (events & ~SCHED_FLAGS_MASK) {
+            events = 0; // 超时
+        }
+        if (task->poll) {
+            events |= APP_SCHED_EV_POLL;
+        }
+        if (events == 0) {
+            continue;
+        }
+
+        osMutexAcquire(sched_lock, osWaitForever);
+        task->run(events);
+        osMutexRelease(sched_lock);
+    }
+}
+
+#else
+
+
+/**
+ * @brief 选出有事件的最高优先级任务
+ * @return int8_t 任务下标，没有可运行的任务时为 -1
+ */
+static int8_t sched_pick(void)
+{
+    for (uint8_t i = 0; i < sched_count; i++) {
+        if (sched_pending[i] != 0 && sched_runs[i] < APP_SCHED_RUNS_PER_PASS) {
+            return (int8_t)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 取走任务的全部待处理事件
+ * @param[in] task 任务下标
+ * @return uint32_t 事件
+ */
+static uint32_t sched_take(uint8_t task)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t events;
+
+    __disable_irq();
+    events = sched_pending[task];
+    sched_pending[task] = 0;
+    __set_PRIMASK(primask);
+    return events;
+}
+
+#endif /* APP_SCHED_RTOS */
+
+/* Function implementations --------------------------------------------------*/
+
+#if APP_SCHED_RTOS
+
+void app_sched_init(const App_Sched_Task_t *tasks, uint8_t count)
+{
+    static const osMutexAttr_t lock_attr = { .name = "sched", .attr_bits = osMutexPrioInherit };
+
+    osKernelInitialize();
+    sched_lock = osMutexNew(&lock_attr);
+    sched_tasks = tasks;
+    sched_count = 0;
+    count = (count > APP_SCHED_MAX_TASKS) ? APP_SCHED_MAX_TASKS : count;
+    for (uint8_t i = 0; i < count; i++) {
+        osThreadAttr_t attr = {
+            .name = tasks[i].name,
+            .stack_mem = sched_stacks[i],
+            .stack_size = sizeof(sched_stacks[i]),
+            .priority = (osPriority_t)(APP_SCHED_RTOS_PRIO - i),
+        };
+        sched_threads[i] = osThreadNew(sched_thread, (void *)(uint32_t)i, &attr);
+    }
+    sched_count = count; // 线程都建好之后才接受事件
+}
+
+void app_sched_signal(uint8_t task, uint32_t events)
+{
+    if (task >= sched_count || sched_threads[task] == NULL) {
+        return;
+    }
+    osThreadFlagsSet(sched_threads[task], events & SCHED_FLAGS_MASK);
+}
+
+void app_sched_run(void)
+{
+    osKernelStart(); // 不再返回
+}
+
+bool app_sched_pending(void)
+{
+    return false;
+}
+
+void app_sched_idle(void)
+{
+    uint32_t ticks = osKernelSuspend();
+    uint32_t start = HAL_GetTick();
+
+    if (ticks > 0) {
+        app_sched_idle_callback(ticks);
+    }
+    osKernelResume(HAL_GetTick() - start); // HAL 时基在停止模式后已由 app_power 补偿
+}
+
+__weak uint32_t app_sched_poll_deadline(void)
+{
+    return HAL_GetTick() + 1;
+}
+
+__weak void app_sched_idle_callback(uint32_t ticks)
+{
+    (void)ticks;
+    __WFI();
+}
+
+#else
+
+void app_sched_init(const App_Sched_Task_t *tasks, uint8_t count)
+{
+    sched_tasks = tasks;
+    sched_count = (count > APP_SCHED_MAX_TASKS) ? APP_SCHED_MAX_TASKS : count;
+    for (uint8_t i = 0; i < APP_SCHED_MAX_TASKS; i++) {
+        sched_pending[i] = 0;
+        sched_runs[i] = 0;
+    }
+}
+
+void app_sched_signal(uint8_t task, uint32_t events)
+{
+    uint32_t primask;
+
+    if (task >= sched_count) {
+        return;
+    }
+    primask = __get_PRIMASK();
+    __disable_irq();
+    sched_pending[task] |= events;
+    __set_PRIMASK(primask);
+}
+
+void app_sched_run(void)
+{
+    int8_t task;
+
+    for (uint8_t i = 0; i < sched_count; i++) {
+        sched_runs[i] = 0;
+        if (sched_tasks[i].poll) {
+            app_sched_signal(i, APP_SCHED_EV_POLL);
+        }
+    }
+
+    while ((task = sched_pick()) >= 0) {
+        uint32_t events = sched_take((uint8_t)task);
+        sched_runs[task]++;
+        sched_tasks[task].run(events);
+    }
+}
+
+bool app_sched_pending(void)
+{
+    for (uint8_t i = 0; i < sched_count; i++) {
+        if (sched_pending[i] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif /* APP_SCHED_RTOS */
+
+/** @} */
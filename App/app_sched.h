@@ -0,0 +1,134 @@
+/**
+ * @file      app_sched.h
+ * @brief     协作式任务调度头文件
+ * @details   静态任务表，表中的下标即优先级 (0最高)。每个任务有一个待处理事件的位掩码，
+ *            app_sched_signal() 置位 (可在中断中调用)，调度器每次选出有事件的最高优先级任务，
+ *            取走它的全部事件后运行到返回为止 (不抢占)。因此一个高优先级任务从被唤醒到运行，
+ *            最多等待一个正在运行的低优先级任务，与其余后台任务的数量无关。
+ *            轮询式的任务在每一轮开始时收到 APP_SCHED_EV_POLL，一轮中没有任务有事件时本轮结束，
+ *            调用者随后可以进入低功耗模式。
+ *            APP_SCHED_RTOS 为 1 时改用 CMSIS-RTOS2：每个任务是一个线程，事件即线程标志，
+ *            任务函数在一个共享互斥量内运行，仍然是运行到完成的语义 (应用层代码无需改为线程安全)，
+ *            区别在于空闲时由内核的无滴答空闲决定睡眠时间。该配置需要另外加入内核 (RTX5 或 FreeRTOS 的 CMSIS-RTOS2 封装)。
+ * @author    SandOcean
+ * @date      2025-10-03
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_SCHED_H
+#define __APP_SCHED_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppSched 任务调度
+ * @brief 带优先级的运行到完成式调度器。
+ * @{
+ */
+
+/**
+ * @defgroup AppSched_Config 任务调度配置
+ * @{
+ */
+#define APP_SCHED_MAX_TASKS    8 ///< 任务表的最大长度
+#define APP_SCHED_RUNS_PER_PASS 4 ///< 每个任务在一轮中最多运行的次数，防止不断收到事件的任务饿死低优先级任务
+#ifndef APP_SCHED_RTOS
+#define APP_SCHED_RTOS         0 ///< 为 1 时任务作为 CMSIS-RTOS2 线程运行 (需要内核)，为 0 时为主循环
+#endif
+#define APP_SCHED_RTOS_STACK   512 ///< RTOS 配置下每个任务线程的栈大小 (字节)
+#define APP_SCHED_RTOS_PRIO    osPriorityHigh ///< RTOS 配置下最高优先级任务的线程优先级，之后依次减一
+/** @} */
+
+#if APP_SCHED_RTOS
+#include "cmsis_os2.h"
+#endif
+
+/**
+ * @defgroup AppSched_Events 任务事件
+ * @{
+ */
+#define APP_SCHED_EV_POLL  0x00000001UL ///< 每一轮开始时发给轮询式任务
+#define APP_SCHED_EV_USER  0x00000002UL ///< 第一个由使用者定义的事件位，之后依次左移
+/** @} */
+
+/**
+ * @brief 任务函数
+ * @param[in] events 本次运行取走的事件
+ */
+typedef void (*App_Sched_Fn_t)(uint32_t events);
+
+/**
+ * @brief 任务描述
+ */
+typedef struct {
+    App_Sched_Fn_t run; ///< 任务函数
+    const char *name;   ///< 任务名称，用于调试
+    bool poll;          ///< 是否每一轮都收到 APP_SCHED_EV_POLL
+} App_Sched_Task_t;
+
+/**
+ * @brief 登记任务表
+ * @param[in] tasks 任务表 (须一直有效，通常为 const 数组)，下标即优先级
+ * @param[in] count 任务数，不超过 APP_SCHED_MAX_TASKS
+ * @return 无
+ */
+void app_sched_init(const App_Sched_Task_t *tasks, uint8_t count);
+
+/**
+ * @brief 向任务发送事件
+ * @details 只是把事件位并入任务的待处理掩码，可在中断中调用。任务在下一次被选中时一次取走全部事件。
+ * @param[in] task 任务在表中的下标
+ * @param[in] events 事件位
+ * @return 无
+ */
+void app_sched_signal(uint8_t task, uint32_t events);
+
+/**
+ * @brief 运行一轮
+ * @note RTOS 配置下启动内核，不再返回。
+ * @details 先向轮询式任务发送 APP_SCHED_EV_POLL，然后反复运行有事件的最高优先级任务，
+ *          直到没有任务有事件 (或都已达到本轮的运行次数上限)。每个任务运行前都重新选择，
+ *          所以中断在一轮中途发来的高优先级事件在当前任务返回后立即得到处理。
+ * @return 无
+ */
+void app_sched_run(void);
+
+/**
+ * @brief 查询是否有任务还有待处理的事件
+ * @details 用于在一轮结束后决定能否进入低功耗模式。RTOS 配置下始终返回 false。
+ * @return bool 有待处理事件时返回 true
+ */
+bool app_sched_pending(void);
+
+#if APP_SCHED_RTOS
+/**
+ * @brief 无滴答空闲，由内核的空闲线程循环调用
+ * @details 挂起内核滴答，调用 app_sched_idle_callback() 睡眠到下一个内核定时事件 (或被中断提前唤醒)，
+ *          再按实际经过的时间恢复内核滴答。RTX5 中在 osRtxIdleThread() 里调用，
+ *          FreeRTOS 中在 vApplicationIdleHook() 里调用 (此时关闭 configUSE_TICKLESS_IDLE)。
+ * @return 无
+ */
+void app_sched_idle(void);
+
+/**
+ * @brief 轮询式任务下一次运行的时刻 (回调)
+ * @details 默认为下一个毫秒，应用层可重新定义为自己的截止时间，使熄屏时线程不必每毫秒唤醒。
+ * @return uint32_t HAL_GetTick() 时间戳
+ */
+uint32_t app_sched_poll_deadline(void);
+
+/**
+ * @brief 空闲时睡眠 (回调)
+ * @details 默认执行 __WFI()，应用层可重新定义以进入停止模式。
+ * @param[in] ticks 内核允许睡眠的最长时间 (毫秒，内核滴答须为1kHz)
+ * @return 无
+ */
+void app_sched_idle_callback(uint32_t ticks);
+#endif
+
+/** @} */
+
+#endif /* __APP_SCHED_H */
@@ -0,0 +1,304 @@
+/**
+ * @file      app_sensor.c
+ * @brief     温湿度滤波与采样调度
+ * @details   温度和湿度各用一个通道：三点中值窗口、以 2^SENSOR_STATE_SHIFT 倍保存的IIR状态
+ *            (避免小步长被移位截断) 和带回差的输出。每次测量只做几次比较、移位和加法。
+ *            发热补偿在滤波之前进行，屏幕发热的一阶模型按两次测量的时间差推进一步
+ *            (步长不超过时间常数，线性近似)，只在测量时计算一次。
+ *            采样间隔按指数退避：变化时回到性能配置的最短间隔 (均衡时为 APP_SENSOR_INTERVAL_MIN_MS)，稳定时每次加倍，
+ *            从最短到最长需要五次测量；读数稳定时每小时只测量15次，固定30秒采样时为120次。
+ *            越限判断使用滤波后的输出，每个上下限各有一个状态位，进入时超过界限即可，解除时需回到区间内超过回差。
+ * @author    SandOcean
+ * @date      2025-10-01
+ * @version   1.2
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_sensor.h"
+#include "DS3231.h"
+#include "app_bus.h"
+#include "app_settings.h"
+#include "app_perf.h"
+#include "profiler.h"
+
+/**
+ * @addtogroup AppSensor
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define SENSOR_STATE_SHIFT 4 ///< IIR 状态的小数位数
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 一个测量量的滤波状态
+ */
+typedef struct {
+    int16_t window[3]; ///< 最近三次的测量值，window[0] 最新
+    int32_t state;     ///< IIR 状态 (测量值 << SENSOR_STATE_SHIFT)
+    int16_t out;       ///< 当前输出
+} Sensor_Channel_t;
+
+/* Private variables ---------------------------------------------------------*/
+static Sensor_Channel_t temp_channel;  ///< 温度通道 (0.01℃)
+static Sensor_Channel_t humi_channel;  ///< 湿度通道 (0.1%RH)
+static AHT20_Data_t filtered;          ///< 滤波后的结果
+static uint32_t interval = APP_SENSOR_INTERVAL_MIN_MS; ///< 下一次测量的间隔 (ms)
+static bool economy;                   ///< 省电采样，总是按最长间隔
+static int32_t heat_state;             ///< 屏幕发热的温升 (0.01℃ << SENSOR_STATE_SHIFT)
+static int16_t offset;                 ///< 最近一次扣除的总温升 (0.01℃)
+static uint32_t last_timestamp;        ///< 上一次测量的时间戳，用于推进发热模型
+static uint8_t alert;                  ///< 越限状态 (App_Sensor_Alert_e 的位)
+
+/* Private function prototypes -----------------------------------------------*/
+static int16_t median3(int16_t a, int16_t b, int16_t c);
+static void channel_reset(Sensor_Channel_t *ch, int16_t value);
+static bool channel_update(Sensor_Channel_t *ch, int16_t value, int16_t hyst, int16_t move);
+static uint32_t sensor_fps(void);
+static int16_t sensor_heat(const AHT20_Data_t *raw, bool screen_on, bool first);
+static uint8_t alert_band(uint8_t state, uint8_t low_bit, uint8_t high_bit, int32_t value,
+                          int32_t low, int32_t high, int32_t hyst);
+static void sensor_alert_update(void);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 三个数的中值
+ * @return int16_t 中值
+ */
+static int16_t median3(int16_t a, int16_t b, int16_t c)
+{
+    if (a > b) {
+        int16_t t = a;
+        a = b;
+        b = t;
+    }
+    if (b > c) {
+        b = c;
+    }
+    return (a > b) ? a : b;
+}
+
+/**
+ * @brief 以一个测量值填满通道
+ * @param[out] ch 通道
+ * @param[in] value 测量值
+ * @return 无
+ */
+static void channel_reset(Sensor_Channel_t *ch, int16_t value)
+{
+    ch->window[0] = value;
+    ch->window[1] = value;
+    ch->window[2] = value;
+    ch->state = (int32_t)value * (1L << SENSOR_STATE_SHIFT);
+    ch->out = value;
+}
+
+/**
+ * @brief 向通道输入一个测量值
+ * @param[in,out] ch 通道
+ * @param[in] value 测量值
+ * @param[in] hyst 输出的回差
+ * @param[in] move 中值与滤波状态相差多少算作变化
+ * @return bool 读数在变化时返回 true
+ */
+static bool channel_update(Sensor_Channel_t *ch, int16_t value, int16_t hyst, int16_t move)
+{
+    int32_t x;
+    int32_t y;
+    int32_t diff;
+
+    ch->window[2] = ch->window[1];
+    ch->window[1] = ch->window[0];
+    ch->window[0] = value;
+
+    // y += (x - y) / 2^n，状态带小数位，右移对负数向下取整，误差不累积
+    x = (int32_t)median3(ch->window[0], ch->window[1], ch->window[2]) * (1L << SENSOR_STATE_SHIFT);
+    diff = x - ch->state;
+    ch->state += diff >> APP_SENSOR_IIR_SHIFT;
+
+    y = (ch->state + (1L << (SENSOR_STATE_SHIFT - 1))) >> SENSOR_STATE_SHIFT;
+    if (y - ch->out >= hyst || ch->out - y >= hyst) {
+        ch->out = (int16_t)y;
+    }
+    return diff >= (int32_t)move * (1L << SENSOR_STATE_SHIFT) || -diff >= (int32_t)move * (1L << SENSOR_STATE_SHIFT);
+}
+
+/**
+ * @brief 获取当前的刷新帧率
+ * @return uint32_t 上一个速率窗口内发送到屏幕的帧数 (每秒)
+ */
+static uint32_t sensor_fps(void)
+{
+    Profiler_Live_t live;
+
+    if (!Profiler_Get_Live(&live)) {
+        return APP_SENSOR_COMP_FPS_NOMINAL;
+    }
+    return live.rate[PROF_CNT_FRAME];
+}
+
+/**
+ * @brief 计算本次测量需要扣除的温升
+ * @param[in] raw 测量结果
+ * @param[in] screen_on 屏幕是否点亮
+ * @param[in] first 是否为第一次测量 (上电时还没有发热)
+ * @return int16_t 温升 (0.01℃)
+ */
+static int16_t sensor_heat(const AHT20_Data_t *raw, bool screen_on, bool first)
+{
+    int32_t target = 0;
+    uint32_t dt_s;
+    int32_t heat;
+
+    // 屏幕发热：heat += (target - heat) * dt / tau，dt 不超过 tau
+    if (screen_on) {
+        target = (APP_SENSOR_COMP_BASE + APP_SENSOR_COMP_PER_FPS * (int32_t)sensor_fps()) * (1L << SENSOR_STATE_SHIFT);
+    }
+    dt_s = first ? 0 : (raw->timestamp - last_timestamp) / 1000U;
+    if (dt_s > APP_SENSOR_COMP_TAU_S) {
+        dt_s = APP_SENSOR_COMP_TAU_S;
+    }
+    heat_state += (target - heat_state) * (int32_t)dt_s / APP_SENSOR_COMP_TAU_S;
+    last_timestamp = raw->timestamp;
+    heat = heat_state >> SENSOR_STATE_SHIFT;
+
+#if APP_SENSOR_COMP_RTC_Q8 > 0
+    // 板上温差：只补偿 AHT20 比 DS3231 片上温度高出的部分
+    int16_t temp_x4;
+    if (DS3231_GetTemperature_x4(&temp_x4) == HAL_OK) {
+        int32_t gradient = raw->temperature_cdeg - heat - (int32_t)temp_x4 * 25;
+        if (gradient > 0) {
+            heat += gradient * APP_SENSOR_COMP_RTC_Q8 / 256;
+        }
+    }
+#endif
+    return (int16_t)heat;
+}
+
+/**
+ * @brief 按一个区间更新上下限的越限位
+ * @param[in] state 当前的越限状态
+ * @param[in] low_bit 低于下限的位
+ * @param[in] high_bit 高于上限的位
+ * @param[in] value 滤波后的值
+ * @param[in] low 下限
+ * @param[in] high 上限
+ * @param[in] hyst 回差
+ * @return uint8_t 新的越限状态
+ */
+static uint8_t alert_band(uint8_t state, uint8_t low_bit, uint8_t high_bit, int32_t value,
+                          int32_t low, int32_t high, int32_t hyst)
+{
+    if (value < low) {
+        state |= low_bit;
+    } else if (value >= low + hyst) {
+        state &= (uint8_t)~low_bit;
+    }
+    if (value > high) {
+        state |= high_bit;
+    } else if (value <= high - hyst) {
+        state &= (uint8_t)~high_bit;
+    }
+    return state;
+}
+
+/**
+ * @brief 把滤波后的结果与设置中的舒适区间比较
+ * @details 状态变化时发布 APP_BUS_SENSOR_ALERT；提醒关闭时状态清零。
+ * @return 无
+ */
+static void sensor_alert_update(void)
+{
+    uint8_t next = 0;
+
+    if (g_app_settings.env_alert) {
+        next = alert_band(alert, APP_SENSOR_ALERT_TEMP_LOW, APP_SENSOR_ALERT_TEMP_HIGH, filtered.temperature_cdeg,
+                          (int32_t)g_app_settings.temp_low * 100, (int32_t)g_app_settings.temp_high * 100,
+                          APP_SENSOR_ALERT_HYST_T);
+        next = alert_band(next, APP_SENSOR_ALERT_HUMI_LOW, APP_SENSOR_ALERT_HUMI_HIGH, filtered.humidity_pm,
+                          (int32_t)g_app_settings.humi_low * 10, (int32_t)g_app_settings.humi_high * 10,
+                          APP_SENSOR_ALERT_HYST_H);
+    }
+    if (next != alert) {
+        alert = next;
+        app_bus_publish(APP_BUS_SENSOR_ALERT);
+    }
+}
+
+/* Function implementations --------------------------------------------------*/
+
+void app_sensor_update(const AHT20_Data_t *raw, bool screen_on)
+{
+    int16_t temp;
+    int32_t humi;
+    AHT20_Data_t prev = filtered;
+
+    if (!raw->valid) {
+        return;
+    }
+
+    // 扣除温升；空气被加热后相对湿度偏低，按每0.01℃约0.065‰的比例加回
+    offset = sensor_heat(raw, screen_on, !filtered.valid);
+    temp = (int16_t)(raw->temperature_cdeg - offset);
+    humi = raw->humidity_pm + (int32_t)raw->humidity_pm * offset * 65 / 100000;
+    if (humi > 1000) {
+        humi = 1000;
+    }
+
+    if (!filtered.valid) {
+        channel_reset(&temp_channel, temp);
+        channel_reset(&humi_channel, (int16_t)humi);
+        filtered.temperature_cdeg = temp;
+        filtered.humidity_pm = (uint16_t)humi;
+        filtered.valid = true;
+    } else {
+        // 两个通道都要更新，不能短路
+        bool moving = channel_update(&temp_channel, temp, APP_SENSOR_TEMP_HYST, APP_SENSOR_MOVE_TEMP);
+        moving |= channel_update(&humi_channel, (int16_t)humi, APP_SENSOR_HUMI_HYST, APP_SENSOR_MOVE_HUMI);
+        filtered.temperature_cdeg = temp_channel.out;
+        filtered.humidity_pm = (uint16_t)humi_channel.out;
+
+        if (moving) {
+            interval = app_perf()->sensor_min_ms;
+        } else if (interval < APP_SENSOR_INTERVAL_MAX_MS / 2) {
+            interval *= 2;
+        } else {
+            interval = APP_SENSOR_INTERVAL_MAX_MS;
+        }
+    }
+    filtered.timestamp = raw->timestamp;
+
+    if (!prev.valid || prev.temperature_cdeg != filtered.temperature_cdeg ||
+        prev.humidity_pm != filtered.humidity_pm) {
+        app_bus_publish(APP_BUS_SENSOR_UPDATED);
+    }
+    sensor_alert_update();
+}
+
+const AHT20_Data_t *app_sensor_get(void)
+{
+    return &filtered;
+}
+
+uint32_t app_sensor_interval(void)
+{
+    return economy ? APP_SENSOR_INTERVAL_MAX_MS : interval;
+}
+
+void app_sensor_set_economy(bool on)
+{
+    economy = on;
+}
+
+uint8_t app_sensor_alert(void)
+{
+    return alert;
+}
+
+int16_t app_sensor_offset(void)
+{
+    return offset;
+}
+
+/** @} */
@@ -0,0 +1,121 @@
+/**
+ * @file      app_sensor.h
+ * @brief     温湿度滤波与采样调度头文件
+ * @details   AHT20 每次得到新的测量结果后交给本模块：先扣除整机发热造成的偏高 (见下)，
+ *            再取最近三次测量的中值去掉单次的跳变，
+ *            再经过一阶IIR低通 (系数为 1/2^APP_SENSOR_IIR_SHIFT，只用移位) 平滑，
+ *            输出值与滤波器状态相差超过回差时才更新，避免显示在两个相邻的数字之间来回跳动。
+ *            页面和温度历史只读取滤波后的结果。
+ *            下一次测量的间隔也由本模块决定：读数在变化时按最短间隔采样，稳定时间隔逐次加倍直到最长间隔。
+ *            AHT20 紧挨着 MCU 和 OLED，亮屏 (尤其是动画帧率高) 时读数偏高。发热补偿由两部分组成：
+ *            - 屏幕发热：稳态温升为 APP_SENSOR_COMP_BASE + APP_SENSOR_COMP_PER_FPS × 帧率，
+ *              按时间常数 APP_SENSOR_COMP_TAU_S 随亮屏时间上升、熄屏后回落 (一阶模型)；
+ *            - 板上温差：AHT20 比 DS3231 的片上温度高出的部分乘以 APP_SENSOR_COMP_RTC_Q8/256，
+ *              反映屏幕之外的热源 (MCU、供电)。
+ *            湿度按温升同时修正 (室温附近温度每升高1℃相对湿度约下降6.5%)。
+ *            补偿系数与外壳和布局有关，默认值只是一个起点，可对照外部温度计调整。
+ *            每次滤波后的结果都与设置中的舒适区间比较 (熄屏和停止模式中唤醒测量的那一次同样进行)，
+ *            越限状态带回差，状态变化时发布 APP_BUS_SENSOR_ALERT，提示由订阅者负责。
+ * @author    SandOcean
+ * @date      2025-10-01
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_SENSOR_H
+#define __APP_SENSOR_H
+
+#include "main.h"
+#include "AHT20.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppSensor 温湿度滤波
+ * @brief 发热补偿、中值加一阶低通的整数滤波器，以及随变化速度调整的采样间隔。
+ * @{
+ */
+
+/**
+ * @defgroup AppSensor_Config 温湿度滤波配置
+ * @{
+ */
+#define APP_SENSOR_IIR_SHIFT   1  ///< IIR 系数为 1/2^n，时间常数约为两个采样间隔
+#define APP_SENSOR_TEMP_HYST   5  ///< 温度输出的回差 (0.01℃)，为显示的最后一位的一半
+#define APP_SENSOR_HUMI_HYST   2  ///< 湿度输出的回差 (0.1%RH)
+#define APP_SENSOR_INTERVAL_MIN_MS  15000  ///< 读数变化时的采样间隔 (ms)
+#define APP_SENSOR_INTERVAL_MAX_MS  240000 ///< 读数稳定时的最长采样间隔 (ms)，须小于温度历史的采样周期
+#define APP_SENSOR_MOVE_TEMP   10 ///< 中值与滤波状态相差多少算作变化 (0.01℃)
+#define APP_SENSOR_MOVE_HUMI   5  ///< 中值与滤波状态相差多少算作变化 (0.1%RH)
+#define APP_SENSOR_COMP_BASE      60  ///< 亮屏不刷新时的稳态温升 (0.01℃)
+#define APP_SENSOR_COMP_PER_FPS   2   ///< 每帧/秒增加的稳态温升 (0.01℃)
+#define APP_SENSOR_COMP_TAU_S     600 ///< 屏幕发热的时间常数 (秒)
+#define APP_SENSOR_COMP_RTC_Q8    64  ///< 板上温差的补偿比例 (/256)，为0时不读取 DS3231
+#define APP_SENSOR_COMP_FPS_NOMINAL 30 ///< 性能分析关闭 (PROFILER_ENABLE 为0) 时亮屏假定的帧率
+#define APP_SENSOR_ALERT_HYST_T   50  ///< 温度越限的回差 (0.01℃)：回到区间内这么多才解除
+#define APP_SENSOR_ALERT_HYST_H   20  ///< 湿度越限的回差 (0.1%RH)
+#define APP_SENSOR_ALERT_TEMP_MAX 50  ///< 设置中舒适温度上下限的最大值 (℃)
+/** @} */
+
+/**
+ * @brief 越限状态的位
+ */
+typedef enum {
+    APP_SENSOR_ALERT_TEMP_LOW  = 0x01, ///< 温度低于下限
+    APP_SENSOR_ALERT_TEMP_HIGH = 0x02, ///< 温度高于上限
+    APP_SENSOR_ALERT_HUMI_LOW  = 0x04, ///< 湿度低于下限
+    APP_SENSOR_ALERT_HUMI_HIGH = 0x08  ///< 湿度高于上限
+} App_Sensor_Alert_e;
+
+/**
+ * @brief 输入一次新的测量结果
+ * @details 先按亮屏状态、帧率和 DS3231 的温度扣除发热 (阻塞读取一次 DS3231 的温度寄存器)，
+ *          第一次测量直接作为输出，之后按中值、低通、回差的顺序更新输出。无效的结果被忽略。
+ *          温度或湿度的中值离滤波状态较远时采样间隔回到最短，否则加倍 (不超过最长间隔)。
+ * @param[in] raw 传感器驱动缓存的测量结果
+ * @param[in] screen_on 屏幕是否点亮 (低功耗时钟不算点亮)
+ * @return 无
+ */
+void app_sensor_update(const AHT20_Data_t *raw, bool screen_on);
+
+/**
+ * @brief 获取滤波后的温湿度
+ * @details 时间戳为最后一次输入的测量时间；尚无测量时 valid 为 false。
+ * @return const AHT20_Data_t* 指向滤波结果的指针
+ */
+const AHT20_Data_t *app_sensor_get(void);
+
+/**
+ * @brief 获取下一次测量的间隔
+ * @details 由主循环的采样调度使用，与当前页面和屏幕状态无关。
+ *          熄屏时 MCU 约每分钟唤醒一次，实际间隔不短于唤醒周期。
+ * @return uint32_t 距上一次触发的间隔 (ms)
+ */
+uint32_t app_sensor_interval(void);
+
+/**
+ * @brief 开启或关闭省电采样
+ * @details 开启期间 app_sensor_interval() 总是返回 APP_SENSOR_INTERVAL_MAX_MS (低电量模式)，
+ *          退避状态照常更新，关闭后回到按读数变化计算的间隔。
+ * @param[in] on 为 true 时开启
+ * @return 无
+ */
+void app_sensor_set_economy(bool on);
+
+/**
+ * @brief 获取当前的越限状态
+ * @details 超出 g_app_settings 中的舒适区间时置位，回到区间内超过回差才清除；提醒关闭时为0。
+ *          在每次新的滤波结果之后更新，变化时发布 APP_BUS_SENSOR_ALERT。
+ * @return uint8_t App_Sensor_Alert_e 的位
+ */
+uint8_t app_sensor_alert(void);
+
+/**
+ * @brief 获取最近一次扣除的发热温升
+ * @return int16_t 温升 (0.01℃)
+ */
+int16_t app_sensor_offset(void);
+
+/** @} */
+
+#endif /* __APP_SENSOR_H */
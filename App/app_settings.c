@@ -2,6 +2,18 @@
  * @file      app_settings.c
  * @brief     应用程序设置管理模块
  * @details   此文件实现了应用程序设置管理功能，包括设置数据的加载、保存和校验和验证。
+ *            设置作为一条记录追加到 app_store 的日志式存储中 (记录自带 CRC-16)，每次保存写入不同的槽位；
+ *            旧版本固件直接写在 APP_SETTINGS_ADDRESS 的数据在首次启动时迁移过来。
+ *            记录的数据是 TLV 格式：| 标记 (1) | 格式版本 (1) | { 标签 (1) | 长度 (1) | 值 } ... |，
+ *            之后未使用的字节为 0xFF。长度为 n 的条目依次给出标签 t、t+1 … t+n-1 的值 (格式版本 2 起)，
+ *            标签连续的成员合并为一个条目，每个成员只占1字节；格式版本 1 的条目长度都是1，按同样的规则读取。
+ *            加载时逐个值查找 settings_fields 表，记录中没有的成员取表中的默认值，
+ *            不认识的标签 (较新固件写入的成员) 跳过，因此增加成员不会使旧记录失效。
+ *            旧固件直接保存的 Settings_t 结构体 (第一个字节是魔法数的最低字节) 仍按魔法数和校验和读取。
+ *            页面修改设置后只做标记，由 app_settings_service() 在安静期后写入当时的完整副本；
+ *            写入期间的新修改在写完后再合并写入一次。
+ *            每次标记时同时把编码后的记录交给 app_store_arm()，电源即将失效时 app_settings_power_fail()
+ *            不必等待安静期，直接以一次页写入保存；正常写入完成且没有新的修改后取消预备。
  * @author    SandOcean
  * @date      2025-08-25
  * @version   1.0
@@ -9,7 +21,14 @@
  */
 
 #include "app_settings.h"
+#include "app_store.h"
+#include "app_bus.h"
+#include "app_sensor.h"
+#include "app_tzdb.h"
+#include "app_night.h"
+#include "AT24C32.h"
 #include <stddef.h> // For offsetof
+#include <string.h>
 
 /**
  * @defgroup AppSettings 应用设置管理
@@ -17,6 +36,60 @@
  * @{
  */
 
+/* Private defines -----------------------------------------------------------*/
+/**
+ * @defgroup AppSettings_Tags 设置记录的标签
+ * @note 标签写入EEPROM后含义不能再改变；删除的成员不要复用它的标签。
+ * @{
+ */
+#define SETTINGS_TAG_LANGUAGE   0x01 ///< 语言
+#define SETTINGS_TAG_AUTO_OFF   0x02 ///< 自动熄屏时间
+#define SETTINGS_TAG_DST        0x03 ///< 夏令时开关
+#define SETTINGS_TAG_DST_ZONE   0x04 ///< 夏令时规则
+#define SETTINGS_TAG_BRIGHTNESS 0x05 ///< 亮度模式
+#define SETTINGS_TAG_CLOCK_FACE 0x06 ///< 表盘样式
+#define SETTINGS_TAG_DISPLAY    0x07 ///< 显示模式
+#define SETTINGS_TAG_WORLD_HOME 0x08 ///< 世界时钟：本地所在的城市
+#define SETTINGS_TAG_WORLD_CITY 0x09 ///< 世界时钟：第一个城市，其余城市的标签依次递增 (共 WORLD_SLOT_COUNT 个，0x09~0x0C)
+#define SETTINGS_TAG_ENV_ALERT  0x0D ///< 温湿度越限提醒开关
+#define SETTINGS_TAG_TEMP_LOW   0x0E ///< 舒适温度的下限
+#define SETTINGS_TAG_TEMP_HIGH  0x0F ///< 舒适温度的上限
+#define SETTINGS_TAG_HUMI_LOW   0x10 ///< 舒适湿度的下限
+#define SETTINGS_TAG_HUMI_HIGH  0x11 ///< 舒适湿度的上限
+#define SETTINGS_TAG_PERF       0x12 ///< 性能配置
+#define SETTINGS_TAG_NIGHT_RULE 0x13 ///< 夜间时段的显示方式和开始时刻
+#define SETTINGS_TAG_NIGHT_END  0x14 ///< 夜间时段的结束时刻
+#define SETTINGS_TAG_END        0xFF ///< 记录中未使用的字节
+/** @} */
+
+#define SETTINGS_TLV_HEADER     2    ///< 标记和格式版本占用的字节数
+#define SETTINGS_RUN_MAX        1    ///< 编码后的条目数上限 (标签须连续分配，删除成员留下的空缺会多占一个条目，记录已经放不下)
+#define SETTINGS_LEGACY_SIZE    offsetof(Settings_t, env_alert) ///< 旧格式的结构体记录最多包含的字节数 (之后的成员是 TLV 格式才有的)
+
+/**
+ * @brief 定义一个保存在记录中的成员
+ * @param tag 标签
+ * @param member Settings_t 的成员名
+ * @param def 记录中没有该成员时的默认值
+ * @param max 允许的最大值，越界的值按缺失处理
+ */
+#define SETTINGS_FIELD(tag, member, def, max) \
+    { (tag), (uint8_t)offsetof(Settings_t, member), (uint8_t)sizeof(((Settings_t *)0)->member), (def), (max) }
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 保存在记录中的一个成员
+ * @details 值在记录中占1字节。成员本身可以更宽 (如大小由编译器决定的枚举)，按小端序只使用最低字节。
+ */
+typedef struct
+{
+    uint8_t tag;    ///< 标签
+    uint8_t offset; ///< 在 Settings_t 中的偏移
+    uint8_t size;   ///< 成员的大小 (字节)
+    uint8_t def;    ///< 默认值
+    uint8_t max;    ///< 最大值
+} Settings_Field_t;
+
 /* Public variables ----------------------------------------------------------*/
 /**
  * @brief 全局应用程序设置实例的定义和默认值
@@ -28,7 +101,21 @@ Settings_t g_app_settings = {
     .language = 0,        ///< 默认语言：中文
     .auto_off = NEVER,    ///< 默认自动关机：关闭
     .dst_enabled = false, ///< 默认夏令时：关闭
-    .checksum = 0
+    .checksum = 0,
+    .dst_zone = TIME_DST_ZONE_DEFAULT, ///< 默认夏令时规则：北美
+    .brightness = BRIGHT_AUTO, ///< 默认亮度：按时段自动调节
+    .clock_face = CLOCK_FACE_DIGITAL, ///< 默认表盘：数字
+    .display_mode = DISPLAY_MODE_NORMAL, ///< 默认显示模式：不反色
+    .world_home = WORLD_CITY_BEIJING, ///< 默认本地城市：北京
+    .world_city = {WORLD_CITY_LONDON, WORLD_CITY_NEW_YORK, WORLD_CITY_TOKYO, WORLD_CITY_SYDNEY}, ///< 默认世界时钟城市
+    .env_alert = 1,  ///< 默认温湿度越限提醒：开启
+    .temp_low = 18,  ///< 默认舒适温度：18~28℃
+    .temp_high = 28,
+    .humi_low = 30,  ///< 默认舒适湿度：30~70%RH
+    .humi_high = 70,
+    .perf_profile = PERF_PROFILE_BALANCED, ///< 默认性能配置：均衡
+    .night_rule = APP_NIGHT_RULE(NIGHT_MODE_OFF, APP_NIGHT_DEFAULT_START), ///< 默认夜间时段：不使用 (启用时为 23:00~07:00)
+    .night_end = APP_NIGHT_DEFAULT_END
 };
 
 /**
@@ -36,10 +123,78 @@ Settings_t g_app_settings = {
  */
 uint8_t g_is_screen_off = 0;          
 
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief 保存在记录中的成员表
+ * @details 夏令时规则的上限取决于内置规则表，加载后另行检查。
+ */
+static const Settings_Field_t settings_fields[] = {
+    SETTINGS_FIELD(SETTINGS_TAG_LANGUAGE,       language,      LANGUAGE_EN,           LANGUAGE_CN),
+    SETTINGS_FIELD(SETTINGS_TAG_AUTO_OFF,       auto_off,      NEVER,                 TIME_10MIN),
+    SETTINGS_FIELD(SETTINGS_TAG_DST,            dst_enabled,   0,                     1),
+    SETTINGS_FIELD(SETTINGS_TAG_DST_ZONE,       dst_zone,      TIME_DST_ZONE_DEFAULT, 0xFE),
+    SETTINGS_FIELD(SETTINGS_TAG_BRIGHTNESS,     brightness,    BRIGHT_AUTO,           BRIGHT_MODE_COUNT - 1),
+    SETTINGS_FIELD(SETTINGS_TAG_CLOCK_FACE,     clock_face,    CLOCK_FACE_DIGITAL,    CLOCK_FACE_COUNT - 1),
+    SETTINGS_FIELD(SETTINGS_TAG_DISPLAY,        display_mode,  DISPLAY_MODE_NORMAL,   DISPLAY_MODE_COUNT - 1),
+    SETTINGS_FIELD(SETTINGS_TAG_WORLD_HOME,     world_home,    WORLD_CITY_BEIJING,    APP_TZDB_COUNT - 1),
+    SETTINGS_FIELD(SETTINGS_TAG_WORLD_CITY + 0, world_city[0], WORLD_CITY_LONDON,     APP_TZDB_COUNT - 1),
+    SETTINGS_FIELD(SETTINGS_TAG_WORLD_CITY + 1, world_city[1], WORLD_CITY_NEW_YORK,   APP_TZDB_COUNT - 1),
+    SETTINGS_FIELD(SETTINGS_TAG_WORLD_CITY + 2, world_city[2], WORLD_CITY_TOKYO,      APP_TZDB_COUNT - 1),
+    SETTINGS_FIELD(SETTINGS_TAG_WORLD_CITY + 3, world_city[3], WORLD_CITY_SYDNEY,     APP_TZDB_COUNT - 1),
+    SETTINGS_FIELD(SETTINGS_TAG_ENV_ALERT,      env_alert,     1,                     1),
+    SETTINGS_FIELD(SETTINGS_TAG_TEMP_LOW,       temp_low,      18,                    APP_SENSOR_ALERT_TEMP_MAX),
+    SETTINGS_FIELD(SETTINGS_TAG_TEMP_HIGH,      temp_high,     28,                    APP_SENSOR_ALERT_TEMP_MAX),
+    SETTINGS_FIELD(SETTINGS_TAG_HUMI_LOW,       humi_low,      30,                    100),
+    SETTINGS_FIELD(SETTINGS_TAG_HUMI_HIGH,      humi_high,     70,                    100),
+    SETTINGS_FIELD(SETTINGS_TAG_PERF,           perf_profile,  PERF_PROFILE_BALANCED, PERF_PROFILE_COUNT - 1),
+    SETTINGS_FIELD(SETTINGS_TAG_NIGHT_RULE,     night_rule,    APP_NIGHT_RULE(NIGHT_MODE_OFF, APP_NIGHT_DEFAULT_START),
+                   APP_NIGHT_RULE(NIGHT_MODE_COUNT - 1, APP_NIGHT_SLOTS - 1)),
+    SETTINGS_FIELD(SETTINGS_TAG_NIGHT_END,      night_end,     APP_NIGHT_DEFAULT_END, APP_NIGHT_SLOTS - 1),
+};
+
+#define SETTINGS_FIELD_COUNT (sizeof(settings_fields) / sizeof(settings_fields[0])) ///< 成员表的长度
+
+///< 世界时钟城市的默认值 (迁移旧格式时使用)，与 settings_fields 中的默认值一致
+static const uint8_t world_city_defaults[WORLD_SLOT_COUNT] = {WORLD_CITY_LONDON, WORLD_CITY_NEW_YORK,
+                                                              WORLD_CITY_TOKYO, WORLD_CITY_SYDNEY};
+
+/**
+ * @brief 异步保存任务
+ * @details 追加写入在总线回调中完成，页面通过 app_settings_save_status() 查询结果。
+ */
+static struct
+{
+    volatile App_Settings_Save_e state;   ///< 当前状态
+    uint8_t record[APP_STORE_PAYLOAD_MAX]; ///< 编码后的待写入记录，写入期间须保持有效
+} save_job = { .state = APP_SETTINGS_SAVE_IDLE };
+
+/**
+ * @brief 延迟写入的状态
+ */
+static struct
+{
+    volatile bool dirty;   ///< 有尚未开始写入的修改
+    uint32_t since;        ///< 最后一次修改的时间戳
+} commit;
+
+static bool load_started = false;                                ///< 是否已开始加载
+static App_Settings_Load_e load_state = APP_SETTINGS_LOAD_PENDING; ///< 加载结果
+
+/** 编译期检查：所有成员编码后必须能放进一条记录，旧格式的结构体也按一条记录读取 */
+typedef char settings_size_check[(SETTINGS_TLV_HEADER + 2 * SETTINGS_RUN_MAX + SETTINGS_FIELD_COUNT <= APP_STORE_PAYLOAD_MAX) ? 1 : -1];
+typedef char settings_struct_check[(SETTINGS_LEGACY_SIZE <= APP_STORE_PAYLOAD_MAX) ? 1 : -1];
+typedef char settings_world_check[(WORLD_SLOT_COUNT == 4) ? 1 : -1]; ///< 与 settings_fields 中世界时钟城市的条目数一致
+
 /* Private function prototypes -----------------------------------------------*/
 static uint8_t __checksum(Settings_t *settings);
-static HAL_StatusTypeDef settings_save(Settings_t *settings);
-static HAL_StatusTypeDef settings_load(Settings_t *settings);
+static void settings_defaults(Settings_t *settings);
+static uint8_t settings_encode(const Settings_t *settings, uint8_t *buf);
+static void settings_decode(Settings_t *settings, const uint8_t *buf, uint8_t size);
+static HAL_StatusTypeDef settings_load_legacy(Settings_t *settings);
+static bool settings_valid(const Settings_t *settings);
+static void save_job_write_cb(HAL_StatusTypeDef status, void *ctx);
+static App_Settings_Load_e settings_finish_load(void);
+static void settings_commit(bool force);
 
 /* Private Function implementations ------------------------------------------*/
 
@@ -61,31 +216,203 @@ static uint8_t __checksum(Settings_t *settings)
 }
 
 /**
- * @brief 将设置数据写入EEPROM (底层硬件操作)
- * @param[in] settings 指向待写入的设置结构体的指针
- * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ * @brief 把成员表中的所有成员设为默认值
+ * @param[out] settings 指向设置结构体的指针
+ * @return 无
+ */
+static void settings_defaults(Settings_t *settings)
+{
+    for (uint8_t i = 0; i < SETTINGS_FIELD_COUNT; i++) {
+        const Settings_Field_t *f = &settings_fields[i];
+        uint8_t *p = (uint8_t *)settings + f->offset;
+
+        memset(p, 0, f->size);
+        *p = f->def;
+    }
+    settings->magic_number = APP_SETTINGS_MAGIC_NUMBER;
+}
+
+/**
+ * @brief 把设置编码为 TLV 记录
+ * @param[in] settings 指向设置结构体的指针
+ * @param[out] buf 记录缓冲区 (APP_STORE_PAYLOAD_MAX 字节)
+ * @return uint8_t 记录长度
  */
-static HAL_StatusTypeDef settings_save(Settings_t *settings)
+static uint8_t settings_encode(const Settings_t *settings, uint8_t *buf)
 {
-    return AT24C32_WritePage(APP_SETTINGS_ADDRESS, (uint8_t*)settings, sizeof(Settings_t));
+    uint8_t n = 0;
+    uint8_t run = 0; // 当前条目的长度字节的位置，0 为还没有条目
+
+    buf[n++] = APP_SETTINGS_TLV_MARK;
+    buf[n++] = APP_SETTINGS_SCHEMA;
+    for (uint8_t i = 0; i < SETTINGS_FIELD_COUNT; i++) {
+        const Settings_Field_t *f = &settings_fields[i];
+
+        if (run == 0 || f->tag != (uint8_t)(buf[run - 1] + buf[run])) {
+            buf[n++] = f->tag; // 标签不连续，开始新的条目
+            run = n;
+            buf[n++] = 0;
+        }
+        buf[run]++;
+        buf[n++] = *((const uint8_t *)settings + f->offset); // 小端序的最低字节
+    }
+    return n;
 }
 
+/**
+ * @brief 逐个条目读取 TLV 记录
+ * @details 只写入记录中存在且值有效的成员；条目中的第 k 个值属于标签 (条目标签 + k)，
+ *          不认识的标签跳过，条目越过记录末尾时停止。
+ * @param[in,out] settings 指向设置结构体的指针 (调用前填好默认值)
+ * @param[in] buf 记录
+ * @param[in] size 记录缓冲区大小
+ * @return 无
+ */
+static void settings_decode(Settings_t *settings, const uint8_t *buf, uint8_t size)
+{
+    uint8_t pos = SETTINGS_TLV_HEADER;
+
+    while (pos + 2 <= size && buf[pos] != SETTINGS_TAG_END) {
+        uint8_t tag = buf[pos];
+        uint8_t len = buf[pos + 1];
+
+        if (pos + 2 + len > size) {
+            break; // 截断的条目
+        }
+        for (uint8_t k = 0; k < len; k++) {
+            uint8_t value = buf[pos + 2 + k];
+            for (uint8_t i = 0; i < SETTINGS_FIELD_COUNT; i++) {
+                const Settings_Field_t *f = &settings_fields[i];
+                if (f->tag == (uint8_t)(tag + k) && value <= f->max) {
+                    uint8_t *p = (uint8_t *)settings + f->offset;
+                    memset(p, 0, f->size);
+                    *p = value;
+                    break;
+                }
+            }
+        }
+        pos = (uint8_t)(pos + 2 + len);
+    }
+}
 
 /**
- * @brief 从EEPROM读取设置数据 (底层硬件操作)
+ * @brief 从旧版本的固定地址读取设置数据 (底层硬件操作)
  * @param[out] settings 指向用于存储读取数据的设置结构体的指针
  * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
  */
-static HAL_StatusTypeDef settings_load(Settings_t *settings)
+static HAL_StatusTypeDef settings_load_legacy(Settings_t *settings)
+{
+    settings_defaults(settings); // 旧格式之后增加的成员
+    return AT24C32_ReadPage(APP_SETTINGS_ADDRESS, (uint8_t*)settings, SETTINGS_LEGACY_SIZE);
+}
+
+/**
+ * @brief 检查魔法数和校验和
+ * @param[in] settings 指向设置结构体的指针
+ * @return bool 数据有效返回 true
+ */
+static bool settings_valid(const Settings_t *settings)
+{
+    if (settings->magic_number != APP_SETTINGS_MAGIC_NUMBER) {
+        return false; // 魔法数不对，数据无效
+    }
+    return settings->checksum == __checksum((Settings_t *)settings); // 校验和不对，数据已损坏
+}
+
+/**
+ * @brief 异步保存的写入完成回调 (I2C中断上下文)，成功后更新设置
+ * @param[in] status 追加写入的结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void save_job_write_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+
+    if (status == HAL_OK) {
+        if (!commit.dirty) {
+            app_store_disarm(); // 预备的记录已经写入
+        }
+        save_job.state = APP_SETTINGS_SAVE_OK;
+    } else {
+        commit.dirty = true; // 稍后重试
+        commit.since = HAL_GetTick();
+        save_job.state = APP_SETTINGS_SAVE_FAILED;
+    }
+}
+
+/**
+ * @brief 有尚未写入的修改时开始写入
+ * @details 编码结果与记录存储RAM副本中的最新记录相同时 (如改过又改回)，不访问 EEPROM。
+ * @param[in] force 为 true 时不等待安静期
+ * @return 无
+ */
+static void settings_commit(bool force)
+{
+    uint8_t latest[APP_STORE_PAYLOAD_MAX];
+    uint8_t record[APP_STORE_PAYLOAD_MAX];
+    uint8_t len;
+
+    if (!commit.dirty || load_state == APP_SETTINGS_LOAD_PENDING || save_job.state == APP_SETTINGS_SAVE_BUSY) {
+        return;
+    }
+    if (!force && HAL_GetTick() - commit.since < APP_SETTINGS_COMMIT_DELAY_MS) {
+        return;
+    }
+
+    commit.dirty = false; // 先清除，写入期间的新修改重新置位
+    len = settings_encode(&g_app_settings, record);
+    memset(latest, SETTINGS_TAG_END, sizeof(latest));
+    if (app_store_read(latest, sizeof(latest)) && memcmp(latest, record, len) == 0) {
+        app_store_disarm();
+        return;
+    }
+    if (!app_settings_save_async(&g_app_settings)) {
+        commit.dirty = true; // EEPROM 正被其他模块写入，下一次调用重试
+    }
+}
+
+/**
+ * @brief 记录存储扫描完成后加载设置
+ * @details 存储中没有记录时，再尝试旧版本固定地址上的数据，有效则迁移为一条新记录。
+ *          都失败时使用默认设置并保存。保存在后台进行，不等待其完成。
+ * @return App_Settings_Load_e 加载结果
+ */
+static App_Settings_Load_e settings_finish_load(void)
 {
-    return AT24C32_ReadPage(APP_SETTINGS_ADDRESS, (uint8_t*)settings, sizeof(Settings_t));
+    Settings_t legacy;
+
+    if(app_settings_load(&g_app_settings) == true) {
+        Time_Dst_Select_Zone(g_app_settings.dst_zone);
+        return APP_SETTINGS_LOAD_OK;
+    }
+    if (settings_load_legacy(&legacy) == HAL_OK && settings_valid(&legacy)) {
+        legacy.dst_zone = TIME_DST_ZONE_DEFAULT; // 旧版本没有这几个成员
+        legacy.brightness = BRIGHT_AUTO;
+        legacy.clock_face = CLOCK_FACE_DIGITAL;
+        legacy.display_mode = DISPLAY_MODE_NORMAL;
+        legacy.world_home = WORLD_CITY_BEIJING;
+        memcpy(legacy.world_city, world_city_defaults, sizeof(legacy.world_city));
+        g_app_settings = legacy;
+        Time_Dst_Select_Zone(g_app_settings.dst_zone);
+        app_settings_save_async(&g_app_settings); // 迁移到记录存储，之后的保存不再写这个地址
+        return APP_SETTINGS_LOAD_OK;
+    }
+
+    settings_defaults(&g_app_settings);
+    Time_Dst_Select_Zone(g_app_settings.dst_zone);
+
+    app_settings_save_async(&g_app_settings);
+    return APP_SETTINGS_LOAD_DEFAULTS;
 }
 
 /* Public Function implementations -------------------------------------------*/
 
 /**
- * @brief 初始化应用设置
- * @details 尝试从EEPROM加载设置。如果加载失败（数据无效或首次启动），
+ * @brief 初始化应用设置 (阻塞)
+ * @details 等价于 app_settings_init_async() 后反复调用 app_settings_service() 直到完成。
+ *          扫描记录存储后尝试加载设置；存储中没有记录时，再尝试旧版本固定地址上的数据，
+ *          有效则迁移为一条新记录。都失败（数据无效或首次启动）时，
  *          则将全局设置 `g_app_settings` 初始化为默认值，并将其保存到EEPROM。
  * @return bool 初始化结果
  *         - @retval true 已成功加载现有有效设置。
@@ -93,80 +420,181 @@ static HAL_StatusTypeDef settings_load(Settings_t *settings)
  */
 bool app_settings_init(void)
 {
-    if(app_settings_load(&g_app_settings) == false) {
-        g_app_settings.magic_number = APP_SETTINGS_MAGIC_NUMBER;
-        g_app_settings.language = 0;
-        g_app_settings.auto_off = NEVER;
-        g_app_settings.checksum = __checksum(&g_app_settings);
+    app_settings_init_async();
+    while (app_settings_service() == APP_SETTINGS_LOAD_PENDING) {
+        I2C_Bus_Service();
+    }
+    return load_state == APP_SETTINGS_LOAD_OK;
+}
 
-        app_settings_save(&g_app_settings);
-        return false; 
+/**
+ * @brief 开始在后台加载应用设置
+ * @details 立即返回。加载完成前 `g_app_settings` 保持默认值。
+ * @return 无
+ */
+void app_settings_init_async(void)
+{
+    load_started = true;
+    load_state = APP_SETTINGS_LOAD_PENDING;
+    app_store_init_async();
+}
+
+/**
+ * @brief 推进后台加载和延迟写入，需在主循环中周期调用
+ * @return App_Settings_Load_e 加载结果，完成后一直返回同一结果
+ */
+App_Settings_Load_e app_settings_service(void)
+{
+    app_store_service();
+    if (load_started && load_state == APP_SETTINGS_LOAD_PENDING) {
+        if (app_store_is_ready()) {
+            load_state = settings_finish_load();
+            app_bus_publish(APP_BUS_SETTINGS_CHANGED);
+        }
     }
-    else {return true;}
+    settings_commit(false);
+    return load_state;
+}
+
+/**
+ * @brief 标记 `g_app_settings` 已被修改
+ * @return 无
+ */
+void app_settings_mark_dirty(void)
+{
+    uint8_t record[APP_STORE_PAYLOAD_MAX];
+
+    commit.since = HAL_GetTick();
+    commit.dirty = true;
+    app_bus_publish(APP_BUS_SETTINGS_CHANGED);
+    if (load_state != APP_SETTINGS_LOAD_PENDING) {
+        app_store_arm(record, settings_encode(&g_app_settings, record)); // 加载完成前的设置不可信，不预备
+    }
+}
+
+/**
+ * @brief 电源即将失效时保存尚未写入的修改 (可在中断中调用)
+ * @return bool 没有尚未写入的修改或已写入返回 true
+ */
+bool app_settings_power_fail(void)
+{
+    return app_store_write_armed() == HAL_OK;
+}
 
+/**
+ * @brief 立即开始写入尚未保存的修改
+ * @return bool 没有尚未写完的修改时返回 true
+ */
+bool app_settings_flush(void)
+{
+    settings_commit(true);
+    return !commit.dirty && save_job.state != APP_SETTINGS_SAVE_BUSY;
 }
 
 /**
  * @brief 从EEPROM加载应用设置
- * @details 从AT24C32 EEPROM中读取设置数据，并进行数据完整性验证：
- *          1. 检查I2C读取是否成功。
- *          2. 检查魔法数是否正确。
- *          3. 验证校验和是否匹配。
+ * @details 取记录存储中最新的一条记录 (启动时由 app_store_init() 扫描并缓存，已通过 CRC 校验)：
+ *          - TLV 格式：先取默认值，再逐个条目写入记录中存在的成员；
+ *          - 旧格式 (直接保存的结构体)：检查魔法数和校验和，校验和之后的成员在旧记录中可能是填充字节。
  * @param[out] settings 指向设置结构体的指针，用于存储加载的数据
  * @return bool 加载结果
  *         - @retval true 加载成功，数据有效
- *         - @retval false 加载失败，数据无效或已损坏
+ *         - @retval false 加载失败，没有记录或数据无效
  */
 bool app_settings_load(Settings_t *settings)
 {
-    if(settings_load(settings) != HAL_OK) return false; // 先把数据读出来
+    uint8_t buf[APP_STORE_PAYLOAD_MAX];
+    Settings_t temp;
 
-    // 检查魔法数和校验和
-    if (settings->magic_number != APP_SETTINGS_MAGIC_NUMBER) {
-        return false; // 魔法数不对，数据无效
+    memset(buf, SETTINGS_TAG_END, sizeof(buf)); // 比缓冲区短的记录，其余部分视为未使用
+    if (!app_store_read(buf, sizeof(buf))) return false;
+
+    if (buf[0] == APP_SETTINGS_TLV_MARK) {
+        settings_defaults(&temp);
+        settings_decode(&temp, buf, sizeof(buf));
+    } else {
+        settings_defaults(&temp);
+        memcpy(&temp, buf, SETTINGS_LEGACY_SIZE);
+        if (!settings_valid(&temp)) {
+            return false;
+        }
+    }
+    if (temp.dst_zone >= Time_Dst_Zone_Count()) {
+        temp.dst_zone = TIME_DST_ZONE_DEFAULT;
+    }
+    if (temp.brightness >= BRIGHT_MODE_COUNT) {
+        temp.brightness = BRIGHT_AUTO;
+    }
+    if (temp.clock_face >= CLOCK_FACE_COUNT) {
+        temp.clock_face = CLOCK_FACE_DIGITAL;
+    }
+    if (temp.display_mode >= DISPLAY_MODE_COUNT) {
+        temp.display_mode = DISPLAY_MODE_NORMAL;
     }
-    if (settings->checksum != __checksum(settings)) {
-        return false; // 校验和不对，数据已损坏
+    if (app_tzdb_zone(temp.world_home) == NULL) {
+        temp.world_home = WORLD_CITY_BEIJING; // 包括空位 (WORLD_CITY_NONE)
     }
-    
+    for (uint8_t i = 0; i < WORLD_SLOT_COUNT; i++) {
+        if (app_tzdb_zone(temp.world_city[i]) == NULL) {
+            temp.world_city[i] = WORLD_CITY_NONE;
+        }
+    }
+
+    *settings = temp;
     return true; // 数据有效，加载成功
 }
 
 /**
- * @brief 保存应用设置到EEPROM
- * @details 这是一个安全的保存函数，执行以下步骤：
- *          1. 自动计算并更新待保存数据的校验和。
- *          2. 将数据写入EEPROM。
- *          3. 立即从EEPROM读回数据进行验证。
- *          4. 只有在读回的数据与写入的数据完全一致时，才认为保存成功。
- * @param[in,out] settings 指向设置结构体的指针。函数会更新其 `checksum` 成员并保存。
+ * @brief 保存应用设置到EEPROM (阻塞)
+ * @details 把设置编码为 TLV 记录后追加到EEPROM。
+ *          记录自带 CRC，写入不完整时启动扫描会回退到上一条记录，因此不再读回比较。
+ * @param[in] settings 指向设置结构体的指针
  * @return bool 保存结果
- *         - @retval true 保存并验证成功
- *         - @retval false 保存失败或验证失败
+ *         - @retval true 保存成功
+ *         - @retval false 保存失败
  */
 bool app_settings_save(Settings_t *settings)
 {
-    Settings_t temp_to_write = *settings; // 1. 复制一份数据，避免修改原始的 g_app_settings
-
-    // 2. 在副本上计算并设置校验和
-    temp_to_write.checksum = __checksum(&temp_to_write);
-    
-    // 3. 将带有正确校验和的副本写入EEPROM
-    settings_save(&temp_to_write);
-    HAL_Delay(10); 
-
-    // 4. 为了验证，再读回来到另一个临时变量
-    Settings_t temp_read_back;
-    settings_load(&temp_read_back);
-    
-    // 5. 比较写入的副本和读回的数据
-    if (memcmp(&temp_to_write, &temp_read_back, sizeof(Settings_t)) == 0) {
-        // 验证成功后，才更新全局变量 g_app_settings 的内容
-        *settings = temp_to_write;
-        return true;
-    } else {
+    uint8_t record[APP_STORE_PAYLOAD_MAX];
+    uint8_t len = settings_encode(settings, record);
+
+    return app_store_append(record, len) == HAL_OK;
+}
+
+/**
+ * @brief 异步保存应用设置到EEPROM
+ * @details 与 app_settings_save() 的步骤相同，但函数立即返回，写入在后台由总线队列完成。
+ *          调用时即编码，之后对设置的修改不影响本次写入。
+ * @param[in] settings 指向设置结构体的指针
+ * @return bool 任务是否已启动
+ *         - @retval true 已启动，之后通过 app_settings_save_status() 查询结果
+ *         - @retval false 上一次保存尚未完成或EEPROM忙
+ */
+bool app_settings_save_async(Settings_t *settings)
+{
+    uint8_t len;
+
+    if (save_job.state == APP_SETTINGS_SAVE_BUSY) {
         return false;
     }
+
+    len = settings_encode(settings, save_job.record);
+    save_job.state = APP_SETTINGS_SAVE_BUSY;
+
+    if (app_store_append_async(save_job.record, len, save_job_write_cb, NULL) != HAL_OK) {
+        save_job.state = APP_SETTINGS_SAVE_FAILED;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 查询最近一次异步保存的状态
+ * @return App_Settings_Save_e 保存状态
+ */
+App_Settings_Save_e app_settings_save_status(void)
+{
+    return save_job.state;
 }
 
 /**
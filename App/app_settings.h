@@ -17,17 +17,39 @@
 #include "stdint.h"
 #include <stdbool.h>
 
-#define APP_SETTINGS_ADDRESS      0x0000      ///< 设置信息在AT24C32中存储的起始地址
+#define APP_SETTINGS_ADDRESS      0x0000      ///< 旧版本固件存储设置信息的固定地址，仅用于迁移 (现由 app_store 管理)
 #define APP_SETTINGS_MAGIC_NUMBER 0xDEADBEEF  ///< 设置数据的魔法数，用于验证数据有效性
+#define APP_SETTINGS_COMMIT_DELAY_MS 3000     ///< 最后一次修改后等待多久再写入EEPROM，期间的连续修改合并为一次写入
+#define APP_SETTINGS_TLV_MARK     0x53        ///< TLV 格式记录的第一个字节 ('S')，与旧格式魔法数的最低字节 (0xEF) 区分
+#define APP_SETTINGS_SCHEMA       2           ///< TLV 记录的格式版本，只在条目的编码方式改变时增加 (增加成员不需要；2: 标签连续的成员合并为一个条目)
 
 /**
  * @brief 全局应用程序设置实例
  * @details 该变量在内存中维护当前的应用设置。
- *          通过调用 `app_settings_load()` 从EEPROM加载，
- *          并通过 `app_settings_save()` 保存回EEPROM。
+ *          通过调用 `app_settings_load()` 从EEPROM加载。修改后调用 `app_settings_mark_dirty()`，
+ *          由后台在安静期后写回EEPROM (也可用 `app_settings_save()` 立即保存)。
  */
 extern Settings_t g_app_settings;
 
+/**
+ * @brief 异步保存的状态
+ */
+typedef enum {
+    APP_SETTINGS_SAVE_IDLE = 0, ///< 尚未发起过异步保存
+    APP_SETTINGS_SAVE_BUSY,     ///< 正在写入或校验
+    APP_SETTINGS_SAVE_OK,       ///< 最近一次保存成功
+    APP_SETTINGS_SAVE_FAILED    ///< 最近一次保存失败
+} App_Settings_Save_e;
+
+/**
+ * @brief 后台加载的结果
+ */
+typedef enum {
+    APP_SETTINGS_LOAD_PENDING = 0, ///< 尚未完成 (正在扫描EEPROM)
+    APP_SETTINGS_LOAD_OK,          ///< 已加载有效设置
+    APP_SETTINGS_LOAD_DEFAULTS     ///< 未找到有效设置，已改用默认设置并保存
+} App_Settings_Load_e;
+
 /**
  * @brief 初始化应用设置
  * @details 尝试从EEPROM加载现有设置。如果加载失败（例如首次启动或数据损坏），
@@ -38,16 +60,51 @@ extern Settings_t g_app_settings;
  */
 bool app_settings_init(void);
 
+/**
+ * @brief 开始在后台加载应用设置
+ * @details 立即返回，EEPROM 扫描由总线队列在后台完成，启动时无需等待。
+ *          加载完成前 `g_app_settings` 保持默认值，之后需周期调用 app_settings_service()。
+ * @return 无
+ */
+void app_settings_init_async(void);
+
+/**
+ * @brief 推进后台加载和延迟写入，需在主循环中周期调用
+ * @return App_Settings_Load_e 加载结果，完成后一直返回同一结果
+ */
+App_Settings_Load_e app_settings_service(void);
+
+/**
+ * @brief 标记 `g_app_settings` 已被修改
+ * @details 立即返回，不访问EEPROM。最后一次修改 APP_SETTINGS_COMMIT_DELAY_MS 后，
+ *          app_settings_service() 把当时的全部设置作为一条记录写入 (写入失败时稍后重试)，
+ *          因此连续翻看选项只产生一次写入。加载完成后，编码的记录同时交给 app_store_arm() 预备，
+ *          安静期内掉电也不会丢失修改。
+ *          同时发布 APP_BUS_SETTINGS_CHANGED，依赖设置的模块在通知中重新读取。
+ * @return 无
+ */
+void app_settings_mark_dirty(void);
+
+/**
+ * @brief 电源即将失效时保存尚未写入的修改 (阻塞，可在中断中调用)
+ * @details 由掉电检测中断调用，以一次页写入 (约 1ms 加 5ms 写周期) 追加最后一次标记时的设置，
+ *          不等待安静期，也不等待进行中的写入。之后 EEPROM 所在的总线停止调度，直到复位。
+ * @return bool 没有尚未写入的修改或已写入返回 true
+ */
+bool app_settings_power_fail(void);
+
+/**
+ * @brief 立即开始写入尚未保存的修改 (不等待安静期)
+ * @details 用于熄屏进入停止模式之前。写入本身仍在后台完成。
+ * @return bool 没有尚未写完的修改时返回 true
+ */
+bool app_settings_flush(void);
+
 /**
  * @brief 保存应用设置到EEPROM
- * @details 将设置数据保存到AT24C32 EEPROM中，包括：
- *          - 魔法数验证
- *          - 语言设置
- *          - 主题设置  
- *          - 自动关机设置
- *          - 校验和
- * @param[in,out] settings 指向设置结构体的指针
- * @note 保存前会自动计算并更新校验和
+ * @details 把设置编码为 TLV 记录 (每个成员一个 标签/长度/值 条目) 后作为一条新记录追加到EEPROM，
+ *          记录的 CRC 由记录存储计算。
+ * @param[in] settings 指向设置结构体的指针
  * @return bool 保存结果
  *         - @retval true 保存成功
  *         - @retval false 保存失败（例如EEPROM写入错误）
@@ -56,15 +113,32 @@ bool app_settings_save(Settings_t *settings);
 
 /**
  * @brief 从EEPROM加载应用设置
- * @details 从AT24C32 EEPROM中读取设置数据，并进行数据完整性验证：
- *          - 检查魔法数是否正确
- *          - 验证校验和是否匹配
+ * @details 读取最新的一条记录 (已通过记录存储的 CRC 校验)：
+ *          - TLV 格式：记录中没有的成员 (旧固件写入的记录) 和越界的值取默认值，不认识的标签跳过；
+ *          - 旧格式 (直接保存的结构体)：检查魔法数和校验和。
  * @param[out] settings 指向设置结构体的指针，用于存储加载的数据
  * @return bool 加载结果
  *         - @retval true 加载成功，数据有效
- *         - @retval false 加载失败，数据无效或已损坏
+ *         - @retval false 加载失败，没有记录或旧格式数据已损坏
  * @note 如果加载失败，建议调用 `app_settings_init()` 和 `app_settings_save()` 来创建一套新的默认设置。
  */
 bool app_settings_load(Settings_t *settings);
 
+/**
+ * @brief 异步保存应用设置到EEPROM
+ * @details 立即返回，追加写入 (一次页写入，ACK 轮询等待写周期) 在后台完成，
+ *          界面在此期间保持刷新。适合在页面的按键处理中调用。
+ * @param[in,out] settings 指向设置结构体的指针，保存期间应保持有效
+ * @return bool 任务是否已启动
+ *         - @retval true 已启动，通过 app_settings_save_status() 查询结果
+ *         - @retval false 上一次保存尚未完成或无法启动写入
+ */
+bool app_settings_save_async(Settings_t *settings);
+
+/**
+ * @brief 查询最近一次异步保存的状态
+ * @return App_Settings_Save_e 保存状态
+ */
+App_Settings_Save_e app_settings_save_status(void);
+
 #endif /* __APP_SETTINGS_H */
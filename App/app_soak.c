@@ -0,0 +1,311 @@
+/**
+ * @file      app_soak.c
+ * @brief     长时间耐久测试 (soak)
+ * @details   导航脚本在初始化时写入输入回放的缓冲区，之后每一轮只需回到主页面再开始回放。
+ *            时间都用 `HAL_GetTick()` 的差值计算，回绕前后照常到期；测试的运行时间由每次调用之间的
+ *            差值累加得到，不受回绕影响。帧耗时按固定宽度的桶统计，百分位取所在桶的上限。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_soak.h"
+
+#if APP_SOAK_ENABLE
+
+#include "app_display.h"
+#include "app_settings.h"
+#include "input_replay.h"
+#include "profiler.h"
+#include "AHT20.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @addtogroup AppSoak
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define SOAK_MENU_ITEMS 7 ///< 主菜单的项数，每一轮依次进入每一项
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 导航脚本中的一步
+ */
+typedef struct {
+    uint8_t event; ///< 事件类型 (Input_Event_t)
+    int8_t value;  ///< 事件值
+} Soak_Step_t;
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief 主页面上的一段：查看温度曲线和月历 (翻月后返回)，然后进入主菜单
+ */
+static const Soak_Step_t soak_home[] = {
+    { INPUT_EVENT_ENCODER, 1 },  { INPUT_EVENT_BACK_PRESSED, 0 },
+    { INPUT_EVENT_ENCODER, -1 }, { INPUT_EVENT_ENCODER, 1 },
+    { INPUT_EVENT_ENCODER, -1 }, { INPUT_EVENT_BACK_PRESSED, 0 },
+    { INPUT_EVENT_COMFIRM_PRESSED, 0 },
+};
+
+/**
+ * @brief 主菜单中的一段，重复 SOAK_MENU_ITEMS 次：移到下一项，进入后来回旋转，再返回
+ * @details 子页面中只旋转不确认，不修改时间、闹钟等设置；倒计时的时长加减后不变。
+ */
+static const Soak_Step_t soak_item[] = {
+    { INPUT_EVENT_ENCODER, 1 },  { INPUT_EVENT_COMFIRM_PRESSED, 0 },
+    { INPUT_EVENT_ENCODER, 1 },  { INPUT_EVENT_ENCODER, 1 },
+    { INPUT_EVENT_ENCODER, -1 }, { INPUT_EVENT_ENCODER, -1 },
+    { INPUT_EVENT_BACK_PRESSED, 0 },
+};
+
+typedef char soak_script_check[(sizeof(soak_home) / sizeof(soak_home[0]) +
+                                SOAK_MENU_ITEMS * sizeof(soak_item) / sizeof(soak_item[0]) + 1 <=
+                                INPUT_REPLAY_CAPACITY) ? 1 : -1];
+
+static uint32_t soak_hist[APP_SOAK_FRAME_BINS]; ///< 帧耗时直方图
+static App_Soak_Report_t soak;                  ///< 累计的计数 (帧耗时分布在取报告时计算)
+static uint32_t soak_elapsed_ms;                ///< 测试已运行的时间
+static uint32_t soak_last_ms;                   ///< 上一次调用维护函数的时间戳
+static uint32_t soak_save_ms;                   ///< 上一次写入设置的时间戳
+static uint32_t soak_sensor_ms;                 ///< 上一次启动测量的时间戳
+static uint32_t soak_report_ms;                 ///< 上一次输出报告的时间戳
+static uint32_t soak_report_frames;             ///< 上一次输出报告时的帧数
+static bool soak_saving;                        ///< 是否有一次设置写入尚未确认结果
+static bool soak_started;                       ///< 是否已开始第一轮导航
+
+/* Private function prototypes -----------------------------------------------*/
+static void soak_put(uint8_t *n, const Soak_Step_t *steps, uint8_t count);
+static uint32_t soak_percentile(uint32_t permille);
+static void soak_save(uint32_t now);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 把一段脚本追加到输入回放的缓冲区
+ * @param[in,out] n 下一个事件的序号
+ * @param[in] steps 脚本
+ * @param[in] count 步数
+ * @return 无
+ */
+static void soak_put(uint8_t *n, const Soak_Step_t *steps, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        Input_Replay_Rec_t rec;
+
+        rec.dt_ms = APP_SOAK_STEP_MS;
+        rec.event = steps[i].event;
+        rec.value = steps[i].value;
+        rec.accel_value = steps[i].value;
+        (void)Input_Replay_Put((*n)++, &rec);
+    }
+}
+
+/**
+ * @brief 求帧耗时的百分位
+ * @param[in] permille 百分位 (千分比)
+ * @return uint32_t 该百分位所在桶的上限 (us)，最后一个桶为最长的帧耗时
+ */
+static uint32_t soak_percentile(uint32_t permille)
+{
+    uint64_t rank = ((uint64_t)soak.frames * permille + 999U) / 1000U;
+    uint64_t seen = 0;
+
+    if (soak.frames == 0) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < APP_SOAK_FRAME_BINS - 1; i++) {
+        seen += soak_hist[i];
+        if (seen >= rank) {
+            uint32_t top = (uint32_t)(i + 1) * APP_SOAK_FRAME_BIN_US;
+            return (top < soak.max_us) ? top : soak.max_us;
+        }
+    }
+    return soak.max_us;
+}
+
+/**
+ * @brief 统计上一次设置写入的结果，到期时再写入一次
+ * @param[in] now 当前时间戳
+ * @return 无
+ */
+static void soak_save(uint32_t now)
+{
+    App_Settings_Save_e status = app_settings_save_status();
+
+    if (soak_saving && status != APP_SETTINGS_SAVE_BUSY) {
+        if (status == APP_SETTINGS_SAVE_OK) {
+            soak.saves++;
+        } else {
+            soak.save_fails++;
+        }
+        soak_saving = false;
+    }
+    if (!soak_saving && now - soak_save_ms >= APP_SOAK_SAVE_MS) {
+        // 完整写入一条记录 (内容相同也写)，EEPROM 正被其他模块写入时下一次重试
+        if (app_settings_save_async(&g_app_settings)) {
+            soak_saving = true;
+            soak_save_ms = now;
+        }
+    }
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 初始化耐久测试
+ * @return 无
+ */
+void app_soak_init(void)
+{
+    uint8_t n = 0;
+
+    uwTick = 0U - APP_SOAK_TICK_LEAD_MS;
+    memset(&soak, 0, sizeof(soak));
+    memset(soak_hist, 0, sizeof(soak_hist));
+    soak_elapsed_ms = 0;
+    soak_last_ms = soak_save_ms = soak_sensor_ms = soak_report_ms = uwTick;
+    soak_report_frames = 0;
+    soak_saving = false;
+    soak_started = false;
+
+    soak_put(&n, soak_home, sizeof(soak_home) / sizeof(soak_home[0]));
+    for (uint8_t k = 0; k < SOAK_MENU_ITEMS; k++) {
+        soak_put(&n, soak_item, sizeof(soak_item) / sizeof(soak_item[0]));
+    }
+    soak_put(&n, &soak_item[sizeof(soak_item) / sizeof(soak_item[0]) - 1], 1); // 从主菜单返回主页面
+}
+
+/**
+ * @brief 耐久测试维护函数
+ * @return 无
+ */
+void app_soak_service(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    if (now < soak_last_ms) {
+        soak.tick_wraps++;
+    }
+    soak_elapsed_ms += now - soak_last_ms;
+    soak_last_ms = now;
+
+    if (Input_Replay_Mode() == INPUT_REPLAY_OFF) {
+        if (soak_started) {
+            soak.tours++;
+        }
+        soak_started = true;
+        Page_Manager_Go_Home(); // 上一轮中途失去同步 (事件落在切换动画中) 时也从主页面重新开始
+        (void)Input_Replay_Play();
+    }
+
+    soak_save(now);
+
+    if (now - soak_sensor_ms >= APP_SOAK_SENSOR_MS) {
+        soak_sensor_ms = now;
+        if (!AHT20_Is_Measuring() && AHT20_StartMeasurement() == HAL_OK) {
+            soak.sensor_reads++; // 结果由主循环的 AHT20_Poll 取走
+        } else {
+            soak.sensor_busy++;
+        }
+    }
+
+    if (now - soak_report_ms >= APP_SOAK_REPORT_MS) {
+        soak_report_ms = now;
+        if (soak.frames == soak_report_frames) {
+            soak.fail |= APP_SOAK_FAIL_STALL;
+        }
+        soak_report_frames = soak.frames;
+        app_soak_print();
+    }
+}
+
+/**
+ * @brief 记录一帧的耗时
+ * @param[in] us 耗时 (us)
+ * @return 无
+ */
+void app_soak_frame(uint32_t us)
+{
+    uint32_t bin = us / APP_SOAK_FRAME_BIN_US;
+
+    soak_hist[(bin < APP_SOAK_FRAME_BINS) ? bin : APP_SOAK_FRAME_BINS - 1]++;
+    soak.frames++;
+    if (us > soak.max_us) {
+        soak.max_us = us;
+    }
+}
+
+/**
+ * @brief 取得当前的报告
+ * @param[out] out 报告
+ * @return bool 判定为通过时返回 true
+ */
+bool app_soak_report(App_Soak_Report_t *out)
+{
+    Profiler_Live_t live;
+
+    *out = soak;
+    out->elapsed_s = soak_elapsed_ms / 1000U;
+    out->p50_us = soak_percentile(500);
+    out->p90_us = soak_percentile(900);
+    out->p99_us = soak_percentile(990);
+    if (Profiler_Get_Live(&live)) {
+        out->input_drops = live.total[PROF_CNT_INPUT_DROP];
+        out->eeprom_writes = live.total[PROF_CNT_EEPROM_WRITE];
+        out->stack_used = live.stack_used;
+        out->input_p50_ms = live.input_p50_ms;
+        out->input_p95_ms = live.input_p95_ms;
+        out->input_p99_ms = live.input_p99_ms;
+        for (uint8_t i = 0; i < PROFILER_I2C_DEVICES; i++) {
+            out->i2c_errors += live.i2c[i].errors;
+            out->i2c_timeouts += live.i2c[i].timeouts;
+        }
+    }
+
+    if (out->input_drops != 0) {
+        out->fail |= APP_SOAK_FAIL_DROP;
+    }
+    if (out->i2c_errors != 0 || out->i2c_timeouts != 0) {
+        out->fail |= APP_SOAK_FAIL_I2C;
+    }
+    if (out->save_fails != 0) {
+        out->fail |= APP_SOAK_FAIL_SAVE;
+    }
+    if (out->p99_us > APP_SOAK_FRAME_LIMIT_US) {
+        out->fail |= APP_SOAK_FAIL_FRAME;
+    }
+    if (out->stack_used > APP_SOAK_STACK_LIMIT) {
+        out->fail |= APP_SOAK_FAIL_STACK;
+    }
+    if (out->input_p99_ms > APP_SOAK_INPUT_LIMIT_MS) {
+        out->fail |= APP_SOAK_FAIL_INPUT;
+    }
+    return out->fail == 0;
+}
+
+/**
+ * @brief 经 printf 输出当前的报告
+ * @return 无
+ */
+void app_soak_print(void)
+{
+    App_Soak_Report_t r;
+    bool pass = app_soak_report(&r);
+
+    printf("[soak] t=%lus tours=%lu frames=%lu p50=%lu p90=%lu p99=%lu max=%luus input=%lu/%lu/%lums\r\n",
+           (unsigned long)r.elapsed_s, (unsigned long)r.tours, (unsigned long)r.frames, (unsigned long)r.p50_us,
+           (unsigned long)r.p90_us, (unsigned long)r.p99_us, (unsigned long)r.max_us, (unsigned long)r.input_p50_ms,
+           (unsigned long)r.input_p95_ms, (unsigned long)r.input_p99_ms);
+    printf("[soak] saves=%lu/%lu sensor=%lu/%lu drops=%lu i2c_err=%lu i2c_to=%lu ee=%lu stack=%lu wraps=%lu %s %02x\r\n",
+           (unsigned long)r.saves, (unsigned long)r.save_fails, (unsigned long)r.sensor_reads,
+           (unsigned long)r.sensor_busy, (unsigned long)r.input_drops, (unsigned long)r.i2c_errors,
+           (unsigned long)r.i2c_timeouts, (unsigned long)r.eeprom_writes, (unsigned long)r.stack_used,
+           (unsigned long)r.tick_wraps, pass ? "PASS" : "FAIL", (unsigned)r.fail);
+}
+
+/** @} */
+
+#endif /* APP_SOAK_ENABLE */
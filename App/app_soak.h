@@ -0,0 +1,138 @@
+/**
+ * @file      app_soak.h
+ * @brief     长时间耐久测试 (soak) 头文件
+ * @details   有些问题只在连续运行几天后才出现：输入队列溢出、I2C 超时、EEPROM 写入次数、
+ *            `HAL_GetTick()` 时间差在 32 位回绕前后的比较。耐久测试构建 (APP_SOAK_ENABLE 为 1) 以加速的节奏
+ *            连续运行几个小时：
+ *            - 导航：借用输入回放 (input_replay) 反复播放一段固定的导航脚本，每一轮从主页面开始，
+ *              依次进入主菜单的各项、滚动后返回，只旋转、进入和返回，不在设置页面中确认；
+ *            - 保存：每 APP_SOAK_SAVE_MS 把当前设置完整写入一次 (app_settings_save_async)；
+ *            - 采样：每 APP_SOAK_SENSOR_MS 启动一次温湿度测量，结果照常由主循环取走；
+ *            - 时间回绕：初始化时把 uwTick 设为回绕前 APP_SOAK_TICK_LEAD_MS，启动后不久就经过一次回绕。
+ *            每 APP_SOAK_REPORT_MS 经 printf 输出一份报告 (两行)：帧耗时的 P50/P90/P99/最大值，输入到画面延迟的 P50/P95/P99，
+ *            保存、采样、输入丢弃、I2C 错误和超时、EEPROM 写入次数、主栈最大使用量和经过的回绕次数，
+ *            最后是累计的判定 PASS 或 FAIL 及原因，每个版本的测试结果就是最后一份报告。
+ *            错误计数、EEPROM 写入次数、栈水位和输入延迟取自性能分析模块 (PROFILER_ENABLE 为 0 时为0)。
+ *            同一模块也链接进主机仿真：table_clock_bench --soak 小时数 以虚拟时钟运行，
+ *            页面静止时时钟直接跳到下一次需要运行的时刻，几个小时的测试在几分钟内完成。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_SOAK_H
+#define __APP_SOAK_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppSoak 耐久测试
+ * @brief 以加速的节奏长时间运行导航、保存和采样，周期性输出帧耗时分布和错误计数。
+ * @{
+ */
+
+/**
+ * @defgroup AppSoak_Config 耐久测试配置
+ * @{
+ */
+#ifndef APP_SOAK_ENABLE
+#define APP_SOAK_ENABLE         0       ///< 为 1 时运行耐久测试 (在构建目标的预定义宏中加入 APP_SOAK_ENABLE=1)
+#endif
+#define APP_SOAK_STEP_MS        350     ///< 导航脚本中相邻两个输入事件的间隔 (足够让列表和切换动画播完)
+#define APP_SOAK_SAVE_MS        20000   ///< 设置完整写入一次的间隔
+#define APP_SOAK_SENSOR_MS      1000    ///< 启动温湿度测量的间隔
+#define APP_SOAK_REPORT_MS      600000  ///< 输出报告的间隔 (10 分钟)
+#define APP_SOAK_TICK_LEAD_MS   60000U  ///< 初始化时 uwTick 距 32 位回绕的毫秒数
+#define APP_SOAK_FRAME_MIN_US   100     ///< 短于该值的 Page_Manager_Loop 没有绘制，不计入帧耗时 (目标板)
+#define APP_SOAK_FRAME_BIN_US   500     ///< 帧耗时直方图每个桶的宽度
+#define APP_SOAK_FRAME_BINS     64      ///< 直方图的桶数，最后一个桶不设上限
+#define APP_SOAK_FRAME_LIMIT_US 40000   ///< P99 帧耗时的上限，超过时判定失败
+#define APP_SOAK_STACK_LIMIT    (PROFILER_STACK_SIZE * 7 / 8) ///< 主栈使用量的上限，超过时判定失败
+#define APP_SOAK_INPUT_LIMIT_MS 100     ///< P99 输入到画面延迟的上限，超过时判定失败
+/** @} */
+
+/**
+ * @defgroup AppSoak_Fail 耐久测试的失败原因
+ * @{
+ */
+#define APP_SOAK_FAIL_DROP   0x01 ///< 输入队列溢出
+#define APP_SOAK_FAIL_I2C    0x02 ///< I2C 总线错误或事务超时
+#define APP_SOAK_FAIL_SAVE   0x04 ///< 设置写入失败
+#define APP_SOAK_FAIL_FRAME  0x08 ///< P99 帧耗时超过 APP_SOAK_FRAME_LIMIT_US
+#define APP_SOAK_FAIL_STACK  0x10 ///< 主栈使用量超过 APP_SOAK_STACK_LIMIT
+#define APP_SOAK_FAIL_STALL  0x20 ///< 一个报告周期内没有绘制任何帧 (界面停止或屏幕被意外关闭)
+#define APP_SOAK_FAIL_INPUT  0x40 ///< P99 输入到画面延迟超过 APP_SOAK_INPUT_LIMIT_MS
+/** @} */
+
+/**
+ * @brief 一份耐久测试报告，除帧耗时分布外都是测试开始以来的累计值
+ */
+typedef struct {
+    uint32_t elapsed_s;     ///< 测试已运行的时间 (s)
+    uint32_t tours;         ///< 播放完的导航脚本轮数
+    uint32_t frames;        ///< 计入的帧数
+    uint32_t p50_us;        ///< 帧耗时的中位数 (所在桶的上限)
+    uint32_t p90_us;        ///< 帧耗时的 P90
+    uint32_t p99_us;        ///< 帧耗时的 P99
+    uint32_t max_us;        ///< 最长的帧耗时
+    uint32_t input_p50_ms;  ///< 输入到画面延迟的中位数 (启动以来，性能分析模块统计)
+    uint32_t input_p95_ms;  ///< 输入到画面延迟的 P95
+    uint32_t input_p99_ms;  ///< 输入到画面延迟的 P99
+    uint32_t saves;         ///< 成功的设置写入次数
+    uint32_t save_fails;    ///< 失败的设置写入次数
+    uint32_t sensor_reads;  ///< 启动的温湿度测量次数
+    uint32_t sensor_busy;   ///< 到期时传感器未就绪而跳过的次数
+    uint32_t input_drops;   ///< 输入队列溢出丢弃的事件数
+    uint32_t i2c_errors;    ///< I2C 总线错误次数 (各设备之和)
+    uint32_t i2c_timeouts;  ///< I2C 事务超时次数 (各设备之和)
+    uint32_t eeprom_writes; ///< EEPROM 页写入次数
+    uint32_t stack_used;    ///< 主栈的最大使用量 (字节)
+    uint32_t tick_wraps;    ///< uwTick 经过的回绕次数
+    uint8_t fail;           ///< 失败原因 (APP_SOAK_FAIL_*)，0 为通过
+} App_Soak_Report_t;
+
+#if APP_SOAK_ENABLE
+
+/**
+ * @brief 初始化耐久测试
+ * @details 把 uwTick 拨到回绕之前并写入导航脚本，须在其他模块初始化 (记录时间戳) 之前调用。
+ * @return 无
+ */
+void app_soak_init(void);
+
+/**
+ * @brief 耐久测试维护函数，设置加载完成后在主循环中周期调用
+ * @details 导航脚本播放完时回到主页面重新播放，到期时写入设置、启动测量和输出报告。
+ * @return 无
+ */
+void app_soak_service(void);
+
+/**
+ * @brief 记录一帧的耗时
+ * @details 由调用 Page_Manager_Loop 的一方测量并在该次循环绘制了帧时调用。
+ * @param[in] us 产生该帧的那次 Page_Manager_Loop 的耗时 (us)
+ * @return 无
+ */
+void app_soak_frame(uint32_t us);
+
+/**
+ * @brief 取得当前的报告
+ * @param[out] out 报告
+ * @return bool 判定为通过时返回 true
+ */
+bool app_soak_report(App_Soak_Report_t *out);
+
+/**
+ * @brief 经 printf 输出当前的报告
+ * @return 无
+ */
+void app_soak_print(void);
+
+#endif /* APP_SOAK_ENABLE */
+
+/** @} */
+
+#endif /* __APP_SOAK_H */
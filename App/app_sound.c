@@ -0,0 +1,159 @@
+/**
+ * @file      app_sound.c
+ * @brief     提示音
+ * @details   报时的每个音符分为几段，频率不变而占空比逐段减半，听起来是敲击后衰减的钟声；
+ *            占空比的变化由 DMA 随每段的 CCR1 一起写入，与音调一样不需要 CPU。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_sound.h"
+#include "app_alarm.h"
+#include "app_settings.h"
+#include "app_bus.h"
+#include "DS3231.h"
+#include "time_core.h"
+#include "audio.h"
+
+/**
+ * @addtogroup AppSound
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define SOUND_RING_HZ 2093U ///< 响铃音的频率 (C7)
+
+/**
+ * @brief 一段占空比为 1/div 的音调 (div 为 2 时与 AUDIO_TONE 相同)
+ * @param hz 频率 (Hz)
+ * @param ms 持续时间 (ms)
+ * @param div 占空比的分母
+ */
+#define SOUND_NOTE(hz, ms, div) { (uint16_t)(AUDIO_TICK_HZ / (hz) - 1U), (uint16_t)((hz) * (ms) / 1000U - 1U), \
+                                  (uint16_t)(AUDIO_TICK_HZ / (hz) / (div)) }
+
+/**
+ * @brief 一个渐弱的钟声音符 (五段，共 500ms)
+ * @param hz 频率 (Hz)
+ */
+#define SOUND_BELL(hz) SOUND_NOTE(hz, 100, 2), SOUND_NOTE(hz, 100, 4), SOUND_NOTE(hz, 100, 8), \
+                       SOUND_NOTE(hz, 100, 16), SOUND_NOTE(hz, 100, 32)
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief 响铃音：四声 100ms 的短音后停 600ms，循环播放
+ */
+static const Audio_Step_t sound_ring[] = {
+    AUDIO_TONE(SOUND_RING_HZ, 100), AUDIO_REST(100),
+    AUDIO_TONE(SOUND_RING_HZ, 100), AUDIO_REST(100),
+    AUDIO_TONE(SOUND_RING_HZ, 100), AUDIO_REST(100),
+    AUDIO_TONE(SOUND_RING_HZ, 100), AUDIO_REST(200),
+    AUDIO_REST(200), AUDIO_REST(200),
+};
+
+/**
+ * @brief 整点报时："叮咚" (G5、E5)
+ */
+static const Audio_Step_t sound_chime[] = {
+    SOUND_BELL(784U),
+    SOUND_BELL(659U),
+    AUDIO_END,
+};
+
+static bool alarm_on;              ///< 闹钟正在响铃
+static bool countdown_on;          ///< 倒计时正在提示
+static bool chime_valid;           ///< chime_last_minute 是否有效
+static uint32_t chime_last_minute; ///< 上一次通知时的本地时间 (纪元分钟)
+static App_Bus_Sub_t sound_sub;    ///< 每分钟时间变化的订阅
+
+/* Private function prototypes -----------------------------------------------*/
+static void sound_ring_update(void);
+static void sound_minute(App_Bus_Topic_e topic, void *arg);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 按闹钟和倒计时的状态开始或停止响铃音
+ * @details 两者之一开始时从头播放，两者都停止时才停止 (报时在响铃期间不播放，停止的只会是响铃音)。
+ * @return 无
+ */
+static void sound_ring_update(void)
+{
+    if (alarm_on || countdown_on) {
+        Audio_Play_Tune(sound_ring, sizeof(sound_ring) / sizeof(sound_ring[0]), true);
+    } else {
+        Audio_Stop();
+    }
+}
+
+/**
+ * @brief 每分钟时间变化的通知
+ * @details 本地时间比上一次通知时前进一分钟且到达整点时报时，其他变化 (启动、对时、夏令时切换) 只记录时间。
+ * @param[in] topic 未使用
+ * @param[in] arg 未使用
+ * @return 无
+ */
+static void sound_minute(App_Bus_Topic_e topic, void *arg)
+{
+    DS3231_Cache_Snap_t snap;
+    uint32_t minute;
+    uint8_t hour;
+    bool stepped;
+
+    (void)topic;
+    (void)arg;
+    if (!DS3231_Cache_Get(&snap)) {
+        return;
+    }
+    minute = (uint32_t)(Time_Apply_Dst(snap.epoch, g_app_settings.dst_enabled) / 60U);
+    stepped = chime_valid && minute == chime_last_minute + 1U;
+    chime_last_minute = minute;
+    chime_valid = true;
+
+    if (!APP_SOUND_CHIME_ENABLE || !stepped || minute % 60U != 0) {
+        return;
+    }
+    hour = (uint8_t)(minute / 60U % 24U);
+    if (hour < APP_SOUND_CHIME_FROM || hour > APP_SOUND_CHIME_TO || alarm_on || countdown_on) {
+        return;
+    }
+    Audio_Play_Tune(sound_chime, sizeof(sound_chime) / sizeof(sound_chime[0]), false);
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 初始化蜂鸣器并订阅每分钟的时间变化
+ * @return 无
+ */
+void app_sound_init(void)
+{
+    Audio_Init();
+    app_bus_subscribe(&sound_sub, APP_BUS_TIME_MINUTE, sound_minute, NULL);
+}
+
+/**
+ * @brief 倒计时到期提示的声音
+ * @param[in] on 开始提示为 true，停止为 false
+ * @return 无
+ */
+void app_sound_countdown(bool on)
+{
+    countdown_on = on;
+    sound_ring_update();
+}
+
+/**
+ * @brief 闹钟响铃的通知 (覆盖 app_alarm 的弱定义)
+ * @param[in] on 开始响铃为 true，停止为 false
+ * @return 无
+ */
+void app_alarm_ring(bool on)
+{
+    alarm_on = on;
+    sound_ring_update();
+}
+
+/** @} */
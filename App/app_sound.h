@@ -0,0 +1,55 @@
+/**
+ * @file      app_sound.h
+ * @brief     提示音头文件
+ * @details   在蜂鸣器驱动 (audio.h) 上实现闹钟、倒计时的响铃和整点报时。
+ *            闹钟响铃由 app_alarm 在缓存时间到达 DS3231 闹钟1 的时刻时通知 (熄屏时由闹钟1 的中断唤醒)，
+ *            响铃音为循环播放的 "嘀嘀嘀嘀" 音调序列，直到停止响铃为止；闹钟和倒计时同时响铃时共用一个声音。
+ *            整点报时在本地时间 (应用夏令时之后) 的每个整点播放两声渐弱的 "叮咚"，
+ *            只在时间连续走到整点时报时 (上电、对时和夏令时切换跳到整点时不报)，响铃期间不报。
+ *            所有声音都是 Flash 中的常量表，由 DMA 送入 TIM1，播放期间不占用主循环。
+ *            AUDIO_ENABLE 为 0 时没有声音，只保留屏幕提示。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_SOUND_H
+#define __APP_SOUND_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppSound 提示音
+ * @brief 响铃和整点报时。
+ * @{
+ */
+
+/**
+ * @defgroup AppSound_Config 提示音配置
+ * @{
+ */
+#define APP_SOUND_CHIME_ENABLE 1  ///< 为 1 时整点报时
+#define APP_SOUND_CHIME_FROM   8  ///< 报时的第一个整点 (本地时间)
+#define APP_SOUND_CHIME_TO     22 ///< 报时的最后一个整点 (含)，之后到 APP_SOUND_CHIME_FROM 之前为安静时段
+/** @} */
+
+/**
+ * @brief 初始化蜂鸣器并订阅每分钟的时间变化 (整点报时)
+ * @return 无
+ */
+void app_sound_init(void);
+
+/**
+ * @brief 倒计时到期提示的声音
+ * @details 在 app_countdown_ring() 中调用。
+ * @param[in] on 开始提示为 true，停止为 false
+ * @return 无
+ */
+void app_sound_countdown(bool on);
+
+/** @} */
+
+#endif /* __APP_SOUND_H */
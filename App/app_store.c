@@ -0,0 +1,506 @@
+/**
+ * @file      app_store.c
+ * @brief     EEPROM 日志式记录存储
+ * @details   槽位按顺序循环使用，新记录总是写在最新记录的下一个槽位，写满后从头覆盖最旧的记录。
+ *            记录格式 (32字节，与 EEPROM 页对齐)：
+ *            | 序号 (4) | 版本 (1) | 长度 (1) | 数据 (24) | CRC-16 (2) |
+ *            CRC 覆盖前 30 字节。出厂全 0xFF 的槽位和旧版本直接写在 0x0000 的设置数据都不会通过校验。
+ *            写入后只读回槽位末尾的 2 字节 CRC 与写入的值比较 (前面的数据在同一次页写入中，CRC 写对时它们也已写入)，
+ *            不一致时不前进槽位，最新记录保持不变。
+ *            预备记录 (app_store_arm) 只保存数据，序号、槽位和 CRC 在掉电写入时按当时的下一个槽位填写，
+ *            因此期间的正常追加不会使它过期；掉电时正在写入的槽位与它相同，被中止的写入由它覆盖。
+ * @author    SandOcean
+ * @date      2025-09-22
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_store.h"
+#include <stddef.h> // For offsetof
+#include <string.h>
+
+/**
+ * @addtogroup AppStore
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define STORE_SEQ_ERASED  0xFFFFFFFFU ///< 未写过的槽位的序号
+#define STORE_SCAN_SLOTS  4           ///< 启动扫描时每次读取的槽位数
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 一条记录 (恰好占一个槽位)
+ */
+typedef struct {
+    uint32_t seq;                           ///< 记录序号，越大越新
+    uint8_t version;                        ///< 记录格式版本
+    uint8_t length;                         ///< 有效数据长度
+    uint8_t payload[APP_STORE_PAYLOAD_MAX]; ///< 数据
+    uint16_t crc;                           ///< 前面所有字段的 CRC-16/CCITT
+} Store_Record_t;
+
+/** 编译期检查：记录必须正好占满一个槽位 */
+typedef char store_record_size_check[(sizeof(Store_Record_t) == APP_STORE_SLOT_SIZE) ? 1 : -1];
+
+/* Private variables ---------------------------------------------------------*/
+static Store_Record_t store_latest;      ///< 最新有效记录的RAM副本
+static bool store_valid = false;         ///< store_latest 是否有效
+static uint8_t store_next_slot = 0;      ///< 下一次写入的槽位
+static uint32_t store_next_seq = 1;      ///< 下一条记录的序号
+
+static Store_Record_t store_pending;     ///< 正在写入的记录，写入期间必须保持有效
+static volatile bool store_busy = false; ///< 是否有异步追加在进行
+static I2C_Bus_Callback_t store_cb;      ///< 异步追加的完成回调
+static void *store_ctx;                  ///< 回调上下文
+static uint16_t store_verify_crc;        ///< 写入后读回的 CRC
+static volatile bool store_verify_retry = false; ///< 读回因队列已满未能提交，等待 app_store_service() 重试
+
+static Store_Record_t store_armed;       ///< 掉电时写入的预备记录 (只有长度和数据有效)
+static volatile bool store_armed_valid = false; ///< 是否有预备记录
+
+/**
+ * @brief 启动扫描的状态
+ * @details 扫描在总线回调中逐块推进，每块 STORE_SCAN_SLOTS 个槽位。
+ */
+static struct {
+    volatile bool busy;                      ///< 扫描是否在进行
+    volatile bool retry;                     ///< 上一块因队列已满未能提交，等待 app_store_service() 重试
+    uint8_t base;                            ///< 当前块的第一个槽位
+    uint8_t best_slot;                       ///< 目前找到的最新记录所在槽位
+    Store_Record_t buf[STORE_SCAN_SLOTS];    ///< 接收缓冲区
+} store_scan;
+
+/* Private function prototypes -----------------------------------------------*/
+static bool store_record_valid(const Store_Record_t *rec);
+static uint16_t store_slot_addr(uint8_t slot);
+static HAL_StatusTypeDef store_prepare(const void *data, uint8_t size);
+static void store_seal(Store_Record_t *rec, uint8_t size);
+static void store_commit(void);
+static void store_finish(HAL_StatusTypeDef status);
+static HAL_StatusTypeDef store_verify_submit(void);
+static void store_write_cb(HAL_StatusTypeDef status, void *ctx);
+static void store_verify_cb(HAL_StatusTypeDef status, void *ctx);
+static HAL_StatusTypeDef store_scan_submit(void);
+static void store_scan_cb(HAL_StatusTypeDef status, void *ctx);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 判断一条记录是否完整有效
+ * @param[in] rec 记录
+ * @return bool 有效返回 true
+ */
+static bool store_record_valid(const Store_Record_t *rec)
+{
+    if (rec->seq == STORE_SEQ_ERASED || rec->version != APP_STORE_VERSION ||
+        rec->length > APP_STORE_PAYLOAD_MAX) {
+        return false;
+    }
+    return rec->crc == app_store_crc16((const uint8_t *)rec, offsetof(Store_Record_t, crc));
+}
+
+/**
+ * @brief 槽位号转换为 EEPROM 地址
+ * @param[in] slot 槽位号
+ * @return uint16_t 槽位起始地址
+ */
+static uint16_t store_slot_addr(uint8_t slot)
+{
+    return (uint16_t)(APP_STORE_BASE_ADDR + (uint16_t)slot * APP_STORE_SLOT_SIZE);
+}
+
+/**
+ * @brief 在 store_pending 中组装下一条记录
+ * @param[in] data 数据
+ * @param[in] size 数据长度
+ * @return HAL_StatusTypeDef 参数错误返回 HAL_ERROR，有追加在进行返回 HAL_BUSY
+ */
+static HAL_StatusTypeDef store_prepare(const void *data, uint8_t size)
+{
+    if (data == NULL || size > APP_STORE_PAYLOAD_MAX) {
+        return HAL_ERROR;
+    }
+    if (store_busy || store_scan.busy) {
+        return HAL_BUSY; // 扫描完成前不知道下一个槽位
+    }
+
+    memset(&store_pending, 0xFF, sizeof(store_pending));
+    memcpy(store_pending.payload, data, size);
+    store_seal(&store_pending, size);
+    return HAL_OK;
+}
+
+/**
+ * @brief 为已填入数据的记录写入下一个序号、版本、长度和 CRC
+ * @param[in,out] rec 记录
+ * @param[in] size 数据长度
+ * @return 无
+ */
+static void store_seal(Store_Record_t *rec, uint8_t size)
+{
+    rec->seq = store_next_seq;
+    rec->version = APP_STORE_VERSION;
+    rec->length = size;
+    rec->crc = app_store_crc16((const uint8_t *)rec, offsetof(Store_Record_t, crc));
+}
+
+/**
+ * @brief 写入成功后把 store_pending 设为最新记录，并前进到下一个槽位
+ * @return 无
+ */
+static void store_commit(void)
+{
+    store_latest = store_pending;
+    store_valid = true;
+    store_next_seq = store_pending.seq + 1;
+    store_next_slot = (uint8_t)((store_next_slot + 1) % APP_STORE_SLOT_COUNT);
+}
+
+/**
+ * @brief 结束异步追加并调用完成回调
+ * @param[in] status 追加结果
+ * @return 无
+ */
+static void store_finish(HAL_StatusTypeDef status)
+{
+    if (status == HAL_OK) {
+        store_commit();
+    }
+    store_busy = false;
+    if (store_cb != NULL) {
+        store_cb(status, store_ctx);
+    }
+}
+
+/**
+ * @brief 提交读回 CRC 的读操作
+ * @details 总线在 EEPROM 重新应答 (写周期结束) 后才执行它。
+ * @return HAL_StatusTypeDef I2C_Bus_Submit 的结果
+ */
+static HAL_StatusTypeDef store_verify_submit(void)
+{
+    return AT24C32_ReadPage_Async((uint16_t)(store_slot_addr(store_next_slot) + offsetof(Store_Record_t, crc)),
+                                  (uint8_t *)&store_verify_crc, sizeof(store_verify_crc), store_verify_cb, NULL);
+}
+
+/**
+ * @brief 异步追加的写入完成回调 (I2C中断上下文)
+ * @details 写入成功后读回 CRC 确认。
+ * @param[in] status 写入结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void store_write_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+
+    if (status != HAL_OK) {
+        store_finish(status);
+        return;
+    }
+    store_verify_retry = (store_verify_submit() != HAL_OK);
+}
+
+/**
+ * @brief 读回 CRC 的完成回调 (I2C中断上下文)
+ * @param[in] status 读取结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void store_verify_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+
+    if (status == HAL_OK && store_verify_crc != store_pending.crc) {
+        status = HAL_ERROR; // 写入未生效 (如写保护或写周期中掉电)
+    }
+    store_finish(status);
+}
+
+/**
+ * @brief 提交扫描的当前块
+ * @return HAL_StatusTypeDef I2C_Bus_Submit 的结果
+ */
+static HAL_StatusTypeDef store_scan_submit(void)
+{
+    return AT24C32_ReadPage_Async(store_slot_addr(store_scan.base), (uint8_t *)store_scan.buf,
+                                  sizeof(store_scan.buf), store_scan_cb, NULL);
+}
+
+/**
+ * @brief 扫描中每一块的读取完成回调 (I2C中断上下文)
+ * @details 处理本块的记录后提交下一块；全部读完后确定下一次写入的槽位。
+ * @param[in] status 读取结果，失败的块视为无效，不影响其余槽位
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void store_scan_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+
+    // 最后一块可能越过槽位区，多读的部分属于闹钟表等其他区域，不参与比较
+    for (uint8_t i = 0; status == HAL_OK && i < STORE_SCAN_SLOTS && store_scan.base + i < APP_STORE_SLOT_COUNT; i++) {
+        const Store_Record_t *rec = &store_scan.buf[i];
+        if (store_record_valid(rec) && (!store_valid || (int32_t)(rec->seq - store_latest.seq) > 0)) {
+            store_latest = *rec;
+            store_valid = true;
+            store_scan.best_slot = (uint8_t)(store_scan.base + i);
+        }
+    }
+
+    store_scan.base += STORE_SCAN_SLOTS;
+    if (store_scan.base < APP_STORE_SLOT_COUNT) {
+        // 不能跳过任何一块，否则可能选中较旧的记录并覆盖更新的记录
+        store_scan.retry = (store_scan_submit() != HAL_OK);
+        return;
+    }
+
+    if (store_valid) {
+        store_next_slot = (uint8_t)((store_scan.best_slot + 1) % APP_STORE_SLOT_COUNT);
+        store_next_seq = store_latest.seq + 1;
+    } else {
+        store_next_slot = 0;
+        store_next_seq = 1;
+    }
+    store_scan.busy = false;
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 计算 CRC-16/CCITT (多项式 0x1021，初值 0xFFFF)
+ * @details 记录存储和其他自行管理 EEPROM 区域的模块 (如 app_drift) 共用。
+ * @param[in] data 数据
+ * @param[in] len 长度
+ * @return uint16_t CRC 值
+ */
+uint16_t app_store_crc16(const void *data, uint16_t len)
+{
+    return app_store_crc16_update(0xFFFF, data, len);
+}
+
+/**
+ * @brief 在已有的 CRC 值上继续计算 CRC-16/CCITT
+ * @param[in] crc 之前的 CRC 值 (第一段为 0xFFFF)
+ * @param[in] data 数据
+ * @param[in] len 长度
+ * @return uint16_t CRC 值
+ */
+uint16_t app_store_crc16_update(uint16_t crc, const void *data, uint16_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    while (len--) {
+        crc ^= (uint16_t)(*p++) << 8;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief 开始在后台扫描记录存储
+ * @return HAL_StatusTypeDef 已开始返回 HAL_OK，已在扫描中返回 HAL_BUSY
+ */
+HAL_StatusTypeDef app_store_init_async(void)
+{
+    if (store_scan.busy) {
+        return HAL_BUSY;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq(); // 回调可能在提交返回前执行，关中断保证 retry 标志不被覆盖
+
+    store_valid = false;
+    store_scan.base = 0;
+    store_scan.best_slot = 0;
+    store_scan.busy = true;
+    store_scan.retry = (store_scan_submit() != HAL_OK);
+
+    __set_PRIMASK(primask);
+    return HAL_OK;
+}
+
+/**
+ * @brief 查询启动扫描是否已完成
+ * @return bool 完成返回 true
+ */
+bool app_store_is_ready(void)
+{
+    return !store_scan.busy;
+}
+
+/**
+ * @brief 记录存储维护函数，需在主循环中周期调用
+ * @return 无
+ */
+void app_store_service(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (store_scan.busy && store_scan.retry) {
+        store_scan.retry = (store_scan_submit() != HAL_OK);
+    }
+    if (store_busy && store_verify_retry) {
+        store_verify_retry = (store_verify_submit() != HAL_OK);
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 初始化记录存储 (阻塞)
+ * @return bool 是否找到有效记录
+ */
+bool app_store_init(void)
+{
+    app_store_init_async();
+    while (!app_store_is_ready()) {
+        app_store_service();
+        I2C_Bus_Service();
+    }
+    return store_valid;
+}
+
+/**
+ * @brief 读取最新的记录
+ * @param[out] data 数据缓冲区
+ * @param[in] size 缓冲区大小
+ * @return bool 有有效记录返回 true
+ */
+bool app_store_read(void *data, uint8_t size)
+{
+    bool valid;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq(); // 异步追加在中断中更新 store_latest
+
+    valid = store_valid;
+    if (valid) {
+        memcpy(data, store_latest.payload, (store_latest.length < size) ? store_latest.length : size);
+    }
+
+    __set_PRIMASK(primask);
+    return valid;
+}
+
+/**
+ * @brief 追加一条记录 (阻塞)
+ * @param[in] data 要保存的数据
+ * @param[in] size 数据长度
+ * @return HAL_StatusTypeDef 写入结果
+ */
+HAL_StatusTypeDef app_store_append(const void *data, uint8_t size)
+{
+    HAL_StatusTypeDef status = store_prepare(data, size);
+
+    if (status != HAL_OK) {
+        return status;
+    }
+    status = AT24C32_WritePage(store_slot_addr(store_next_slot), (uint8_t *)&store_pending, APP_STORE_SLOT_SIZE);
+    if (status == HAL_OK) {
+        status = AT24C32_ReadPage((uint16_t)(store_slot_addr(store_next_slot) + offsetof(Store_Record_t, crc)),
+                                  (uint8_t *)&store_verify_crc, sizeof(store_verify_crc));
+    }
+    if (status == HAL_OK && store_verify_crc != store_pending.crc) {
+        status = HAL_ERROR;
+    }
+    if (status == HAL_OK) {
+        store_commit();
+    }
+    return status;
+}
+
+/**
+ * @brief 追加一条记录 (非阻塞)
+ * @param[in] data 要保存的数据
+ * @param[in] size 数据长度
+ * @param[in] cb 写入完成回调
+ * @param[in] ctx 回调上下文
+ * @return HAL_StatusTypeDef 写入是否已启动
+ */
+HAL_StatusTypeDef app_store_append_async(const void *data, uint8_t size, I2C_Bus_Callback_t cb, void *ctx)
+{
+    HAL_StatusTypeDef status = store_prepare(data, size);
+
+    if (status != HAL_OK) {
+        return status;
+    }
+    store_cb = cb;
+    store_ctx = ctx;
+    store_verify_retry = false;
+    store_busy = true;
+
+    status = AT24C32_WritePage_Async(store_slot_addr(store_next_slot), (uint8_t *)&store_pending,
+                                     APP_STORE_SLOT_SIZE, store_write_cb, NULL);
+    if (status != HAL_OK) {
+        store_busy = false;
+    }
+    return status;
+}
+
+/**
+ * @brief 预备一条掉电时写入的记录
+ * @param[in] data 数据
+ * @param[in] size 数据长度
+ * @return HAL_StatusTypeDef 参数错误返回 HAL_ERROR
+ */
+HAL_StatusTypeDef app_store_arm(const void *data, uint8_t size)
+{
+    if (data == NULL || size > APP_STORE_PAYLOAD_MAX) {
+        return HAL_ERROR;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq(); // 掉电中断可能随时读取预备记录
+
+    memset(&store_armed, 0xFF, sizeof(store_armed));
+    memcpy(store_armed.payload, data, size);
+    store_armed.length = size;
+    store_armed_valid = true;
+
+    __set_PRIMASK(primask);
+    return HAL_OK;
+}
+
+/**
+ * @brief 取消预备记录
+ * @return 无
+ */
+void app_store_disarm(void)
+{
+    store_armed_valid = false;
+}
+
+/**
+ * @brief 掉电时写入预备记录 (可在中断中调用)
+ * @return HAL_StatusTypeDef 没有预备记录或写入成功返回 HAL_OK，启动扫描未完成返回 HAL_BUSY
+ */
+HAL_StatusTypeDef app_store_write_armed(void)
+{
+    HAL_StatusTypeDef status;
+    uint16_t addr;
+
+    if (!store_armed_valid) {
+        return HAL_OK;
+    }
+    if (store_scan.busy) {
+        return HAL_BUSY; // 不知道下一个槽位，写入可能覆盖最新的记录
+    }
+
+    store_seal(&store_armed, store_armed.length);
+    addr = store_slot_addr(store_next_slot);
+    status = AT24C32_WritePage_Emergency(addr, (const uint8_t *)&store_armed, APP_STORE_SLOT_SIZE);
+    if (status == HAL_OK) {
+        store_busy = false; // 被中止的异步追加不再回调
+        store_pending = store_armed;
+        store_commit();
+        store_armed_valid = false;
+    }
+    return status;
+}
+
+/** @} */
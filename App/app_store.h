@@ -0,0 +1,152 @@
+/**
+ * @file      app_store.h
+ * @brief     EEPROM 日志式记录存储头文件
+ * @details   把 AT24C32 划分为若干个与页对齐的 32 字节槽位，每次保存只追加写入下一个槽位，
+ *            不再反复改写同一地址。每条记录带有递增的序号和 CRC，启动时扫描全部槽位，
+ *            取序号最大的有效记录。写入被打断 (掉电) 的记录 CRC 不通过，会自动回退到上一条，
+ *            因此写后只需读回 2 字节的 CRC 确认写入生效，不需要读回整条记录；每个单元的擦写次数也降为原来的 1/槽位数。
+ *            最新记录在RAM中有一份副本，读取不访问 EEPROM。
+ * @author    SandOcean
+ * @date      2025-09-22
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_STORE_H
+#define __APP_STORE_H
+
+#include "main.h"
+#include "AT24C32.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppStore 记录存储
+ * @brief 提供了带磨损均衡的追加式持久化存储。
+ * @{
+ */
+
+/**
+ * @defgroup AppStore_Config 记录存储配置
+ * @{
+ */
+#define APP_STORE_BASE_ADDR   0x0000 ///< 存储区在 AT24C32 中的起始地址 (须与页对齐)
+#define APP_STORE_SLOT_COUNT  98     ///< 槽位数，其后5页 (0x0C40 起) 留给 app_usage 的使用统计，再后22页 (0x0CE0 起) 留给 app_history 的检查点，再后一页 (0x0FA0) 留给 app_alarm 的闹钟表，最后两页 (0x0FC0 起) 留给 app_drift 的漂移日志
+#define APP_STORE_SLOT_SIZE   32     ///< 槽位大小，等于 EEPROM 页大小，一条记录只需一次页写入
+#define APP_STORE_VERSION     1      ///< 记录格式版本
+#define APP_STORE_PAYLOAD_MAX 24     ///< 单条记录的最大数据长度
+/** @} */
+
+/**
+ * @brief 初始化记录存储 (阻塞)
+ * @details 扫描全部槽位，找出序号最大的有效记录并缓存在RAM中，同时确定下一次写入的槽位。
+ *          整片读取约需 100ms，仅在启动时调用一次。
+ * @return bool 是否找到有效记录
+ */
+bool app_store_init(void);
+
+/**
+ * @brief 开始在后台扫描记录存储
+ * @details 与 app_store_init() 相同，但立即返回，扫描以 EEPROM 优先级逐块进行，
+ *          不影响显示刷新。扫描完成前追加写入会返回 HAL_BUSY。
+ * @return HAL_StatusTypeDef 已开始返回 HAL_OK，已在扫描中返回 HAL_BUSY
+ */
+HAL_StatusTypeDef app_store_init_async(void);
+
+/**
+ * @brief 查询启动扫描是否已完成
+ * @return bool 完成返回 true (之后 app_store_read() 的结果才有意义)
+ */
+bool app_store_is_ready(void);
+
+/**
+ * @brief 记录存储维护函数，需在主循环中周期调用
+ * @details 总线队列已满导致扫描的某一块或追加后的 CRC 读回未能提交时，在这里重试。
+ * @return 无
+ */
+void app_store_service(void);
+
+/**
+ * @brief 读取最新的记录
+ * @details 从RAM缓存中拷贝，不访问EEPROM。记录比 size 短时 (旧版本写入的记录)，
+ *          多出的部分保持不变，调用者可预先填入默认值。
+ * @param[out] data 数据缓冲区
+ * @param[in] size 缓冲区大小
+ * @return bool 有有效记录返回 true
+ */
+bool app_store_read(void *data, uint8_t size);
+
+/**
+ * @brief 追加一条记录 (阻塞)
+ * @details 写入后读回 CRC，与写入的值不一致时返回 HAL_ERROR，最新记录保持不变。
+ * @param[in] data 要保存的数据
+ * @param[in] size 数据长度，不超过 APP_STORE_PAYLOAD_MAX
+ * @return HAL_StatusTypeDef 写入结果
+ */
+HAL_StatusTypeDef app_store_append(const void *data, uint8_t size);
+
+/**
+ * @brief 追加一条记录 (非阻塞)
+ * @details 数据在调用时被拷贝，调用者的缓冲区无需保持有效。写入并读回 CRC 确认后记录才成为最新记录，
+ *          CRC 不一致时以 HAL_ERROR 调用回调。
+ * @param[in] data 要保存的数据
+ * @param[in] size 数据长度，不超过 APP_STORE_PAYLOAD_MAX
+ * @param[in] cb 写入完成回调 (I2C中断上下文)，可为NULL
+ * @param[in] ctx 回调上下文
+ * @return HAL_StatusTypeDef
+ *         - @retval HAL_OK 写入已启动
+ *         - @retval HAL_BUSY 上一次追加尚未完成
+ *         - @retval HAL_ERROR 参数错误
+ */
+HAL_StatusTypeDef app_store_append_async(const void *data, uint8_t size, I2C_Bus_Callback_t cb, void *ctx);
+
+/**
+ * @brief 预备一条掉电时写入的记录
+ * @details 数据在调用时被拷贝，不访问 EEPROM。再次调用替换之前的预备记录。
+ *          电源即将失效时由 app_store_write_armed() 以一次页写入追加它，不需要在中断里再编码数据。
+ * @param[in] data 要保存的数据
+ * @param[in] size 数据长度，不超过 APP_STORE_PAYLOAD_MAX
+ * @return HAL_StatusTypeDef 参数错误返回 HAL_ERROR
+ */
+HAL_StatusTypeDef app_store_arm(const void *data, uint8_t size);
+
+/**
+ * @brief 取消预备记录
+ * @details 预备的数据已经由正常的追加写入后调用，可以在中断中调用。
+ * @return 无
+ */
+void app_store_disarm(void);
+
+/**
+ * @brief 掉电时写入预备记录 (阻塞，可在中断中调用)
+ * @details 经 AT24C32_WritePage_Emergency 写入下一个槽位，中止进行中的异步追加 (不再回调)。
+ *          调用后 EEPROM 所在的总线不再调度，只应在即将掉电时调用。不读回 CRC：
+ *          写入未完成时记录的 CRC 不通过，启动时回退到上一条记录。
+ * @return HAL_StatusTypeDef
+ *         - @retval HAL_OK 没有预备记录，或已写入
+ *         - @retval HAL_BUSY 启动扫描未完成，不知道下一个槽位
+ *         - @retval HAL_ERROR/HAL_TIMEOUT 写入失败
+ */
+HAL_StatusTypeDef app_store_write_armed(void);
+
+/**
+ * @brief 计算 CRC-16/CCITT (多项式 0x1021，初值 0xFFFF)
+ * @param[in] data 数据
+ * @param[in] len 长度
+ * @return uint16_t CRC 值
+ */
+uint16_t app_store_crc16(const void *data, uint16_t len);
+
+/**
+ * @brief 在已有的 CRC 值上继续计算 CRC-16/CCITT
+ * @details 用于分段的数据 (如环形缓冲区中跨越末尾的一帧)，各段依次调用的结果与整体计算相同。
+ * @param[in] crc 之前的 CRC 值 (第一段为 0xFFFF)
+ * @param[in] data 数据
+ * @param[in] len 长度
+ * @return uint16_t CRC 值
+ */
+uint16_t app_store_crc16_update(uint16_t crc, const void *data, uint16_t len);
+
+/** @} */
+
+#endif /* __APP_STORE_H */
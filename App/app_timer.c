@@ -0,0 +1,164 @@
+/**
+ * @file      app_timer.c
+ * @brief     软件定时器
+ * @details   槽位链表用 next/pprev 连接，摘除节点不需要知道它在哪个槽位。
+ *            app_timer_service() 遍历链表期间回调可能停止任意定时器，下一个待检查的节点保存在 walk_next 中，
+ *            被停止的恰好是它时向后移动一个。最早到期时刻的缓存只在可能变晚时作废，下次查询时重新扫描。
+ * @author    SandOcean
+ * @date      2025-10-02
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_timer.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup AppTimer
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define TIMER_SLOT_MASK (APP_TIMER_SLOTS - 1U) ///< 槽位下标掩码
+
+/* Private variables ---------------------------------------------------------*/
+static App_Timer_t *slots[APP_TIMER_SLOTS]; ///< 各槽位的链表头
+static uint32_t service_last;               ///< 上一次 app_timer_service() 的时刻
+static App_Timer_t *walk_next;              ///< 遍历中下一个待检查的节点
+static bool next_valid;                     ///< next_has/next_expires 是否有效
+static bool next_has;                       ///< 是否有运行中的不可推迟定时器
+static uint32_t next_expires;               ///< 最早的到期时刻
+
+/* Private function prototypes -----------------------------------------------*/
+static void timer_insert(App_Timer_t *timer);
+static void timer_unlink(App_Timer_t *timer);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 按到期时刻把定时器插入对应槽位的表头
+ * @param[in,out] timer 定时器 (未在链表中)
+ * @return 无
+ */
+static void timer_insert(App_Timer_t *timer)
+{
+    App_Timer_t **head = &slots[(timer->expires / APP_TIMER_SLOT_MS) & TIMER_SLOT_MASK];
+
+    timer->next = *head;
+    if (*head != NULL) {
+        (*head)->pprev = &timer->next;
+    }
+    *head = timer;
+    timer->pprev = head;
+
+    if (next_valid && !(timer->flags & APP_TIMER_DEFERRABLE) &&
+        (!next_has || (int32_t)(timer->expires - next_expires) < 0)) {
+        next_has = true;
+        next_expires = timer->expires;
+    }
+}
+
+/**
+ * @brief 把定时器从链表中摘除
+ * @param[in,out] timer 定时器 (在链表中)
+ * @return 无
+ */
+static void timer_unlink(App_Timer_t *timer)
+{
+    if (walk_next == timer) {
+        walk_next = timer->next;
+    }
+    *timer->pprev = timer->next;
+    if (timer->next != NULL) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+
+    if (!(timer->flags & APP_TIMER_DEFERRABLE) && next_has && timer->expires == next_expires) {
+        next_valid = false; // 可能是最早的那个，下次查询时重新扫描
+    }
+}
+
+/* Function implementations --------------------------------------------------*/
+
+void app_timer_start(App_Timer_t *timer, uint32_t delay_ms, uint32_t period_ms,
+                     App_Timer_Cb_t cb, void *arg, uint8_t flags)
+{
+    if (timer->pprev != NULL) {
+        timer_unlink(timer);
+    }
+    timer->expires = HAL_GetTick() + delay_ms;
+    timer->period = period_ms;
+    timer->cb = cb;
+    timer->arg = arg;
+    timer->flags = flags;
+    timer_insert(timer);
+}
+
+void app_timer_stop(App_Timer_t *timer)
+{
+    if (timer->pprev != NULL) {
+        timer_unlink(timer);
+    }
+}
+
+bool app_timer_active(const App_Timer_t *timer)
+{
+    return timer->pprev != NULL;
+}
+
+void app_timer_service(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t slot = service_last / APP_TIMER_SLOT_MS;
+    uint32_t count = now / APP_TIMER_SLOT_MS - slot;
+
+    // 包括上一次所在的槽位 (其中可能有当时还没到期的定时器)；停止模式等跳过一圈以上时每个槽位检查一次
+    if (count >= APP_TIMER_SLOTS) {
+        count = APP_TIMER_SLOTS - 1U;
+    }
+    service_last = now;
+
+    for (uint32_t i = 0; i <= count; i++, slot++) {
+        App_Timer_t *timer = slots[slot & TIMER_SLOT_MASK];
+
+        while (timer != NULL) {
+            walk_next = timer->next;
+            if ((int32_t)(now - timer->expires) >= 0) {
+                timer_unlink(timer);
+                if (timer->period != 0) {
+                    timer->expires += timer->period;
+                    if ((int32_t)(now - timer->expires) >= 0) {
+                        timer->expires = now + timer->period; // 错过了不止一个周期
+                    }
+                    timer_insert(timer);
+                }
+                timer->cb(timer->arg); // 回调可能重新启动或停止任意定时器
+            }
+            timer = walk_next;
+        }
+    }
+    walk_next = NULL;
+}
+
+bool app_timer_next(uint32_t *expires)
+{
+    if (!next_valid) {
+        next_has = false;
+        for (uint32_t i = 0; i < APP_TIMER_SLOTS; i++) {
+            for (const App_Timer_t *timer = slots[i]; timer != NULL; timer = timer->next) {
+                if (!(timer->flags & APP_TIMER_DEFERRABLE) &&
+                    (!next_has || (int32_t)(timer->expires - next_expires) < 0)) {
+                    next_has = true;
+                    next_expires = timer->expires;
+                }
+            }
+        }
+        next_valid = true;
+    }
+    *expires = next_expires;
+    return next_has;
+}
+
+/** @} */
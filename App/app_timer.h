@@ -0,0 +1,111 @@
+/**
+ * @file      app_timer.h
+ * @brief     软件定时器头文件
+ * @details   散列时间轮：定时器按到期时刻 (ms) 除以 APP_TIMER_SLOT_MS 后的低位放入 APP_TIMER_SLOTS 个槽位之一，
+ *            每个槽位是一个双向链表，启动和停止都是常数时间。主循环调用 app_timer_service() 时
+ *            只检查从上一次调用到现在经过的槽位，到期的定时器在主循环上下文中执行回调。
+ *            超过一圈 (APP_TIMER_SLOTS × APP_TIMER_SLOT_MS) 的定时器留在槽位中，每经过一圈检查一次。
+ *            定时器结构体由使用者分配 (通常为模块内的静态变量)，不使用动态内存。
+ *            可推迟的定时器 (APP_TIMER_DEFERRABLE) 不参与 app_timer_next()，熄屏时不会为它单独唤醒，
+ *            到期后在下一次唤醒时执行。
+ * @author    SandOcean
+ * @date      2025-10-02
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_TIMER_H
+#define __APP_TIMER_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppTimer 软件定时器
+ * @brief 单次和周期回调，常数时间的启动和停止。
+ * @{
+ */
+
+/**
+ * @defgroup AppTimer_Config 软件定时器配置
+ * @{
+ */
+#define APP_TIMER_SLOTS    16  ///< 时间轮的槽位数，必须是2的幂
+#define APP_TIMER_SLOT_MS  64  ///< 每个槽位对应的时间 (ms)，一圈约1秒
+/** @} */
+
+/**
+ * @defgroup AppTimer_Flags 软件定时器标志
+ * @{
+ */
+#define APP_TIMER_DEFERRABLE 0x01U ///< 可推迟：不参与 app_timer_next()，低功耗时不为它唤醒
+/** @} */
+
+/**
+ * @brief 定时器回调
+ * @param[in] arg 启动时传入的参数
+ */
+typedef void (*App_Timer_Cb_t)(void *arg);
+
+/**
+ * @brief 软件定时器
+ * @note 成员由本模块维护，使用者只需分配并在第一次使用前清零 (静态变量即可)。
+ */
+typedef struct App_Timer {
+    struct App_Timer *next;   ///< 槽位链表的下一个
+    struct App_Timer **pprev; ///< 指向上一个节点的 next (或槽位表头)，为 NULL 时未启动
+    uint32_t expires;         ///< 到期时刻 (HAL_GetTick() 时间戳)
+    uint32_t period;          ///< 周期 (ms)，0为单次
+    App_Timer_Cb_t cb;        ///< 回调
+    void *arg;                ///< 回调参数
+    uint8_t flags;            ///< APP_TIMER_DEFERRABLE 等标志
+} App_Timer_t;
+
+/**
+ * @brief 启动 (或重新启动) 定时器
+ * @details 已在运行的定时器先被停止，再按新的参数启动。可在回调中调用。
+ * @param[in,out] timer 定时器
+ * @param[in] delay_ms 距第一次到期的时间 (ms)
+ * @param[in] period_ms 之后的周期 (ms)，0为单次
+ * @param[in] cb 回调
+ * @param[in] arg 回调参数
+ * @param[in] flags APP_TIMER_DEFERRABLE 或 0
+ * @return 无
+ */
+void app_timer_start(App_Timer_t *timer, uint32_t delay_ms, uint32_t period_ms,
+                     App_Timer_Cb_t cb, void *arg, uint8_t flags);
+
+/**
+ * @brief 停止定时器
+ * @details 未启动的定时器无操作。可在回调中调用 (包括停止其他定时器)。
+ * @param[in,out] timer 定时器
+ * @return 无
+ */
+void app_timer_stop(App_Timer_t *timer);
+
+/**
+ * @brief 查询定时器是否在运行
+ * @param[in] timer 定时器
+ * @return bool 已启动且尚未到期 (或为周期定时器) 时返回 true
+ */
+bool app_timer_active(const App_Timer_t *timer);
+
+/**
+ * @brief 执行到期的定时器，需在主循环中周期调用
+ * @details 周期定时器按到期时刻累加周期重新排队；错过多个周期时 (如停止模式) 只执行一次，从当前时刻重新计算。
+ * @return 无
+ */
+void app_timer_service(void);
+
+/**
+ * @brief 获取最早的到期时刻，供低功耗管理计算截止时间
+ * @details 不计入可推迟的定时器。结果被缓存，只在最早的定时器被停止或执行后重新扫描一遍。
+ * @param[out] expires 最早的到期时刻 (HAL_GetTick() 时间戳)
+ * @return bool 没有运行中的 (不可推迟的) 定时器时返回 false
+ */
+bool app_timer_next(uint32_t *expires);
+
+/** @} */
+
+#endif /* __APP_TIMER_H */
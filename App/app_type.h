@@ -29,6 +29,90 @@ typedef enum {
     TIME_10MIN,     ///< 10分钟后自动熄屏
 } Auto_Off_e;
 
+/**
+ * @brief 屏幕亮度枚举
+ * @details 自动模式按当前时间在白天、傍晚、夜间三档之间平滑过渡，其余为固定亮度。
+ */
+typedef enum {
+    BRIGHT_AUTO = 0,  ///< 按时段自动调节
+    BRIGHT_HIGH,      ///< 固定为高亮度
+    BRIGHT_MEDIUM,    ///< 固定为中亮度
+    BRIGHT_LOW,       ///< 固定为低亮度
+    BRIGHT_MODE_COUNT ///< 亮度模式的个数
+} Bright_Mode_e;
+
+/**
+ * @brief 显示模式枚举
+ * @details 反色由显示控制器完成 (SSD1306 的 0xA6/0xA7 命令)，页面的绘制不变。
+ *          夜间反色跟随亮度调度的夜间时段。
+ */
+typedef enum {
+    DISPLAY_MODE_NORMAL = 0, ///< 亮字暗底
+    DISPLAY_MODE_INVERT,     ///< 总是反色 (暗字亮底)
+    DISPLAY_MODE_NIGHT,      ///< 只在夜间时段反色
+    DISPLAY_MODE_COUNT       ///< 显示模式的个数
+} Display_Mode_e;
+
+/**
+ * @brief 性能配置枚举
+ * @details 各配置的帧率下限、动画时长、采样间隔和时钟调速参数见 app_perf.c 中的配置表。
+ */
+typedef enum {
+    PERF_PROFILE_ECO = 0,  ///< 省电：约30FPS，动画缩短，温湿度采样间隔加倍，空闲后很快降频
+    PERF_PROFILE_BALANCED, ///< 均衡 (默认)
+    PERF_PROFILE_SMOOTH,   ///< 流畅：动画稍长，输入后保持全速更久
+    PERF_PROFILE_COUNT     ///< 性能配置的个数
+} Perf_Profile_e;
+
+/**
+ * @brief 夜间时段的显示方式枚举
+ * @details 时段内不论有无操作都按这里的方式熄屏 (见 app_night.h)，保存在 Settings_t::night_rule 的高2位。
+ */
+typedef enum {
+    NIGHT_MODE_OFF = 0, ///< 不使用夜间时段
+    NIGHT_MODE_DARK,    ///< 时段内关闭显示器
+    NIGHT_MODE_AMBIENT, ///< 时段内显示低功耗时钟
+    NIGHT_MODE_COUNT    ///< 显示方式的个数
+} Night_Mode_e;
+
+/**
+ * @brief 主页面表盘样式枚举
+ * @details 与 ui_face.c 中的表盘表一一对应。
+ */
+typedef enum {
+    CLOCK_FACE_DIGITAL = 0, ///< 数字表盘
+    CLOCK_FACE_ANALOG,      ///< 指针表盘
+    CLOCK_FACE_SIMPLE,      ///< 简洁表盘 (时、分和日期)
+    CLOCK_FACE_ASTRO,       ///< 日月表盘 (时、分、日出日落和月相)
+    CLOCK_FACE_COUNT        ///< 表盘样式的个数
+} Clock_Face_e;
+
+/**
+ * @brief 世界时钟的常用城市
+ * @details 城市就是内置时区库 (app_tzdb) 中的时区，设置中保存的是时区编号 (0 ~ APP_TZDB_COUNT-1)。
+ *          这里是时区库的前 15 项，与旧版本固件的城市表一致，用作默认值；其他时区由 Tools/tz_zones.txt 追加在后面。
+ */
+typedef enum {
+    WORLD_CITY_BEIJING = 0, ///< 北京 (UTC+8)
+    WORLD_CITY_TOKYO,       ///< 东京 (UTC+9)
+    WORLD_CITY_SYDNEY,      ///< 悉尼 (UTC+10，澳大利亚东南部夏令时)
+    WORLD_CITY_AUCKLAND,    ///< 奥克兰 (UTC+12，新西兰夏令时)
+    WORLD_CITY_DELHI,       ///< 新德里 (UTC+5:30)
+    WORLD_CITY_DUBAI,       ///< 迪拜 (UTC+4)
+    WORLD_CITY_MOSCOW,      ///< 莫斯科 (UTC+3)
+    WORLD_CITY_BERLIN,      ///< 柏林 (UTC+1，中欧夏令时)
+    WORLD_CITY_PARIS,       ///< 巴黎 (UTC+1，中欧夏令时)
+    WORLD_CITY_LONDON,      ///< 伦敦 (UTC+0，英国夏令时)
+    WORLD_CITY_UTC,         ///< 协调世界时
+    WORLD_CITY_NEW_YORK,    ///< 纽约 (UTC-5，北美夏令时)
+    WORLD_CITY_CHICAGO,     ///< 芝加哥 (UTC-6，北美夏令时)
+    WORLD_CITY_DENVER,      ///< 丹佛 (UTC-7，北美夏令时)
+    WORLD_CITY_LOS_ANGELES, ///< 洛杉矶 (UTC-8，北美夏令时)
+    WORLD_CITY_NONE         ///< 世界时钟中不显示城市的一行 (旧版本固件的取值，在时区库中是空位)
+} World_City_e;
+
+#define WORLD_SLOT_COUNT 4 ///< 世界时钟中可配置的城市数
+
 /**
  * @brief 应用设置结构体
  * @details 定义了需要持久化保存到EEPROM的所有设置项。
@@ -40,6 +124,20 @@ typedef struct {
     bool dst_enabled;       ///< 夏令时 (Daylight Saving Time) 是否启用
 
     uint8_t checksum;       ///< 校验和，用于验证数据完整性
+    uint8_t dst_zone;       ///< 夏令时规则的序号 (Time_Dst_Get_Zone)。位于校验和之后以兼容旧记录，记录本身有CRC保护
+    uint8_t brightness;     ///< 屏幕亮度模式 (Bright_Mode_e)。旧记录中这里是填充字节 (0)，正好对应自动模式
+    uint8_t clock_face;     ///< 主页面的表盘样式 (Clock_Face_e)
+    uint8_t display_mode;   ///< 显示模式 (Display_Mode_e)
+    uint8_t world_home;     ///< 本地所在的城市 (时区编号，app_tzdb)，决定芯片中的本地标准时间对应的 UTC 偏移
+    uint8_t world_city[WORLD_SLOT_COUNT]; ///< 世界时钟显示的城市 (时区编号，WORLD_CITY_NONE 为空行)
+    uint8_t env_alert;      ///< 温湿度越限提醒是否开启 (见 app_sensor_alert)
+    uint8_t temp_low;       ///< 舒适温度的下限 (℃)
+    uint8_t temp_high;      ///< 舒适温度的上限 (℃)
+    uint8_t humi_low;       ///< 舒适湿度的下限 (%RH)
+    uint8_t humi_high;      ///< 舒适湿度的上限 (%RH)
+    uint8_t perf_profile;   ///< 性能配置 (Perf_Profile_e)
+    uint8_t night_rule;     ///< 夜间时段：高2位为显示方式 (Night_Mode_e)，低6位为开始时刻 (半小时序号 0~47，见 APP_NIGHT_RULE)
+    uint8_t night_end;      ///< 夜间时段的结束时刻 (半小时序号 0~47)
 } Settings_t;
 
 
@@ -0,0 +1,147 @@
+/**
+ * @file      app_tzdb.c
+ * @brief     内置时区库
+ * @details   表本身在生成的 app_tzdb_data.c 中，这里只有按编号的访问、二分查找和列表的数据源。
+ *            名称按字节序 (strcmp) 排序，与 Tools/tz_gen.py 的排序一致。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_tzdb.h"
+#include <string.h>
+
+/**
+ * @addtogroup AppTzdb
+ * @{
+ */
+
+/* Private variables ---------------------------------------------------------*/
+extern const App_Tzdb_Zone_t app_tzdb_zones[APP_TZDB_COUNT]; ///< 时区表 (按编号)
+extern const uint8_t app_tzdb_by_name[APP_TZDB_LIST_COUNT];  ///< 按名称排序的时区编号
+extern const char app_tzdb_pool[APP_TZDB_POOL_SIZE];         ///< 字符串池，偏移 0 处为 "--"
+
+/** 编译期检查：编号保存在设置的一个字节中，0xFF 为无效值 */
+typedef char app_tzdb_count_check[(APP_TZDB_COUNT <= APP_TZDB_ID_NONE) ? 1 : -1];
+
+/* Private function prototypes -----------------------------------------------*/
+static int16_t tzdb_search(const char *name);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 在按名称排序的编号表上二分查找
+ * @param[in] name 名称
+ * @return int16_t 列表中的位置，未找到时返回 -1
+ */
+static int16_t tzdb_search(const char *name)
+{
+    uint16_t lo = 0;
+    uint16_t hi = APP_TZDB_LIST_COUNT;
+
+    while (lo < hi) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2U);
+        int cmp = strcmp(name, &app_tzdb_pool[app_tzdb_zones[app_tzdb_by_name[mid]].name]);
+
+        if (cmp == 0) {
+            return (int16_t)mid;
+        }
+        if (cmp < 0) {
+            hi = mid;
+        } else {
+            lo = (uint16_t)(mid + 1U);
+        }
+    }
+    return -1;
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 按编号获取时区
+ * @param[in] id 时区编号
+ * @return const App_Tzdb_Zone_t* 时区，无效时返回 NULL
+ */
+const App_Tzdb_Zone_t *app_tzdb_zone(uint8_t id)
+{
+    if (id >= APP_TZDB_COUNT || app_tzdb_zones[id].dst_zone == APP_TZDB_DST_GAP) {
+        return NULL;
+    }
+    return &app_tzdb_zones[id];
+}
+
+/**
+ * @brief 获取时区的显示名称
+ * @param[in] id 时区编号
+ * @return const char* 名称，无效时返回 "--"
+ */
+const char *app_tzdb_name(uint8_t id)
+{
+    const App_Tzdb_Zone_t *zone = app_tzdb_zone(id);
+
+    return &app_tzdb_pool[(zone != NULL) ? zone->name : 0];
+}
+
+/**
+ * @brief 按显示名称查找时区
+ * @param[in] name 名称
+ * @return uint8_t 时区编号，未找到时返回 APP_TZDB_ID_NONE
+ */
+uint8_t app_tzdb_find(const char *name)
+{
+    int16_t index = tzdb_search(name);
+
+    return (index < 0) ? APP_TZDB_ID_NONE : app_tzdb_by_name[index];
+}
+
+/**
+ * @brief 选择列表的项目数
+ * @param[in] ctx 未使用
+ * @return uint16_t 项目数
+ */
+uint16_t app_tzdb_list_count(const void *ctx)
+{
+    (void)ctx;
+    return APP_TZDB_LIST_COUNT;
+}
+
+/**
+ * @brief 选择列表中一项的文本
+ * @param[in] ctx 未使用
+ * @param[in] index 列表中的位置
+ * @return const char* 时区名称
+ */
+const char *app_tzdb_list_text(const void *ctx, uint16_t index)
+{
+    (void)ctx;
+    return app_tzdb_name(app_tzdb_list_id(index));
+}
+
+/**
+ * @brief 选择列表中一项对应的时区编号
+ * @param[in] index 列表中的位置
+ * @return uint8_t 时区编号
+ */
+uint8_t app_tzdb_list_id(uint16_t index)
+{
+    return (index < APP_TZDB_LIST_COUNT) ? app_tzdb_by_name[index] : APP_TZDB_ID_NONE;
+}
+
+/**
+ * @brief 时区在选择列表中的位置
+ * @param[in] id 时区编号
+ * @return uint16_t 列表中的位置
+ */
+uint16_t app_tzdb_list_index(uint8_t id)
+{
+    int16_t index;
+
+    if (app_tzdb_zone(id) == NULL) {
+        return 0;
+    }
+    index = tzdb_search(app_tzdb_name(id));
+    return (index < 0) ? 0 : (uint16_t)index;
+}
+
+/** @} */
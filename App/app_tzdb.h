@@ -0,0 +1,102 @@
+/**
+ * @file      app_tzdb.h
+ * @brief     内置时区库头文件
+ * @details   时区表由 Tools/tz_gen.py 从 tzdata 生成 (app_tzdb_data.c)，全部在 Flash 中：
+ *            每个时区 8 字节 (名称在字符串池中的偏移、以 15 分钟为单位的标准时间 UTC 偏移、
+ *            time_core 的夏令时规则序号和坐标)，名称集中在一个去重的字符串池中，另有一张按名称排序的编号表。
+ *            时区的编号就是它在 Tools/tz_zones.txt 中的行序号，保存在设置中；前 15 个与 World_City_e 一致，
+ *            编号 WORLD_CITY_NONE 是旧版本固件的空行，在表中保留为空位。
+ *            按名称查找是在排序表上的二分查找；选择列表的数据源回调 (app_tzdb_list_count、app_tzdb_list_text)
+ *            直接取 Flash 中的名称，列表控件只访问可见的行，几百个时区与几项的菜单占用同样的 RAM 和帧时间。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_TZDB_H
+#define __APP_TZDB_H
+
+#include "app_tzdb_data.h"
+#include "time_core.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppTzdb 时区库
+ * @brief Flash 中的时区表、按名称的二分查找和选择列表的数据源。
+ * @{
+ */
+
+#define APP_TZDB_DST_GAP  0xFE ///< 时区表中空位的夏令时字段 (不是有效的时区)
+#define APP_TZDB_ID_NONE  0xFF ///< 无效的时区编号 (app_tzdb_find 未找到时)
+
+/**
+ * @brief 时区表中的一项
+ */
+typedef struct {
+    uint16_t name;    ///< 名称在字符串池中的偏移
+    int8_t utc_q;     ///< 标准时间的 UTC 偏移 (15 分钟)
+    uint8_t dst_zone; ///< 夏令时规则 (Time_Dst_Get_Zone 的序号)，TIME_DST_ZONE_NONE 为不使用，APP_TZDB_DST_GAP 为空位
+    int16_t lat_d;    ///< 纬度 (0.1°，北纬为正)
+    int16_t lon_d;    ///< 经度 (0.1°，东经为正)
+} App_Tzdb_Zone_t;
+
+#define APP_TZDB_UTC_MIN(zone) ((int16_t)((zone)->utc_q * 15)) ///< 时区标准时间的 UTC 偏移 (分钟)
+
+/**
+ * @brief 按编号获取时区
+ * @param[in] id 时区编号
+ * @return const App_Tzdb_Zone_t* 时区，编号无效或为空位时返回 NULL
+ */
+const App_Tzdb_Zone_t *app_tzdb_zone(uint8_t id);
+
+/**
+ * @brief 获取时区的显示名称
+ * @param[in] id 时区编号
+ * @return const char* 名称 (Flash 中的常量)，编号无效或为空位时返回 "--"
+ */
+const char *app_tzdb_name(uint8_t id);
+
+/**
+ * @brief 按显示名称查找时区
+ * @details 在按名称排序的编号表上二分查找，区分大小写。
+ * @param[in] name 名称，如 "Berlin"
+ * @return uint8_t 时区编号，未找到时返回 APP_TZDB_ID_NONE
+ */
+uint8_t app_tzdb_find(const char *name);
+
+/**
+ * @brief 选择列表的项目数 (UI_List_Count_Fn)
+ * @param[in] ctx 未使用
+ * @return uint16_t APP_TZDB_LIST_COUNT
+ */
+uint16_t app_tzdb_list_count(const void *ctx);
+
+/**
+ * @brief 选择列表中一项的文本 (UI_List_Text_Fn)
+ * @details 列表按名称的字母顺序排列。
+ * @param[in] ctx 未使用
+ * @param[in] index 列表中的位置
+ * @return const char* 时区名称
+ */
+const char *app_tzdb_list_text(const void *ctx, uint16_t index);
+
+/**
+ * @brief 选择列表中一项对应的时区编号
+ * @param[in] index 列表中的位置
+ * @return uint8_t 时区编号，index 越界时返回 APP_TZDB_ID_NONE
+ */
+uint8_t app_tzdb_list_id(uint16_t index);
+
+/**
+ * @brief 时区在选择列表中的位置
+ * @details 以时区的名称二分查找，用于打开列表时选中当前的时区。
+ * @param[in] id 时区编号
+ * @return uint16_t 列表中的位置，编号无效或为空位时返回 0
+ */
+uint16_t app_tzdb_list_index(uint8_t id);
+
+/** @} */
+
+#endif /* __APP_TZDB_H */
@@ -0,0 +1,312 @@
+/* 由 Tools/tz_gen.py 根据 Tools/tz_zones.txt 和 tzdata 生成，请勿手工修改。收录的时区改动后重新运行该脚本。 */
+
+#include "app_tzdb.h"
+
+/* { 名称, UTC 偏移 (15 分钟), 夏令时规则, 纬度 (0.1°), 经度 (0.1°) } */
+const App_Tzdb_Zone_t app_tzdb_zones[APP_TZDB_COUNT] = {
+    {  194,   32, TIME_DST_ZONE_NONE,   399,  1164}, /*   0 Asia/Shanghai */
+    { 1870,   36, TIME_DST_ZONE_NONE,   357,  1397}, /*   1 Asia/Tokyo */
+    { 1769,   40, 3,                   -339,  1512}, /*   2 Australia/Sydney, AU */
+    {  141,   48, 4,                   -368,  1748}, /*   3 Pacific/Auckland, NZ */
+    {  519,   22, TIME_DST_ZONE_NONE,   286,   772}, /*   4 Asia/Kolkata */
+    {  551,   16, TIME_DST_ZONE_NONE,   252,   553}, /*   5 Asia/Dubai */
+    { 1267,   12, TIME_DST_ZONE_NONE,   558,   376}, /*   6 Europe/Moscow */
+    {  224,    4, 1,                    525,   134}, /*   7 Europe/Berlin, EU */
+    { 1416,    4, 1,                    489,    24}, /*   8 Europe/Paris, EU */
+    { 1056,    0, 2,                    515,    -1}, /*   9 Europe/London, UK */
+    { 1914,    0, TIME_DST_ZONE_NONE,   515,     0}, /*  10 Etc/UTC */
+    { 1297,  -20, 0,                    407,  -740}, /*  11 America/New_York, US */
+    {  419,  -24, 0,                    419,  -876}, /*  12 America/Chicago, US */
+    {  525,  -28, 0,                    397, -1050}, /*  13 America/Denver, US */
+    { 1017,  -32, 0,                    341, -1182}, /*  14 America/Los_Angeles, US */
+    {    0,    0, APP_TZDB_DST_GAP,       0,     0}, /*  15 (空位) */
+    {   73,    4, 1,                    425,    15}, /*  16 Europe/Andorra, EU */
+    {  874,   18, TIME_DST_ZONE_NONE,   345,   692}, /*  17 Asia/Kabul */
+    { 1863,    4, 1,                    413,   198}, /*  18 Europe/Tirane, EU */
+    { 2068,   16, TIME_DST_ZONE_NONE,   402,   445}, /*  19 Asia/Yerevan */
+    {  339,  -12, TIME_DST_ZONE_NONE,  -346,  -584}, /*  20 America/Argentina/Buenos_Aires */
+    { 1382,  -44, TIME_DST_ZONE_NONE,  -143, -1707}, /*  21 Pacific/Pago_Pago */
+    { 1966,    4, 1,                    482,   163}, /*  22 Europe/Vienna, EU */
+    {  768,   40, 3,                   -429,  1473}, /*  23 Australia/Hobart, AU */
+    { 1185,   40, 3,                   -378,  1450}, /*  24 Australia/Melbourne, AU */
+    {  299,   38, 3,                   -320,  1414}, /*  25 Australia/Broken_Hill, AU */
+    {  290,   40, TIME_DST_ZONE_NONE,  -275,  1530}, /*  26 Australia/Brisbane */
+    { 1040,   40, TIME_DST_ZONE_NONE,  -203,  1490}, /*  27 Australia/Lindeman */
+    {   16,   38, 3,                   -349,  1386}, /*  28 Australia/Adelaide, AU */
+    {  512,   38, TIME_DST_ZONE_NONE,  -125,  1308}, /*  29 Australia/Darwin */
+    { 1422,   32, TIME_DST_ZONE_NONE,  -320,  1158}, /*  30 Australia/Perth */
+    {  600,   35, TIME_DST_ZONE_NONE,  -317,  1289}, /*  31 Australia/Eucla */
+    {  164,   16, TIME_DST_ZONE_NONE,   404,   498}, /*  32 Asia/Baku */
+    {  177,  -16, TIME_DST_ZONE_NONE,   131,  -596}, /*  33 America/Barbados */
+    {  540,   24, TIME_DST_ZONE_NONE,   237,   904}, /*  34 Asia/Dhaka */
+    {  311,    4, 1,                    508,    43}, /*  35 Europe/Brussels, EU */
+    { 1708,    8, 5,                    427,   233}, /*  36 Europe/Sofia, EE */
+    {  231,  -16, 0,                    323,  -648}, /*  37 Atlantic/Bermuda, US */
+    { 1022,  -16, TIME_DST_ZONE_NONE,  -165,  -682}, /*  38 America/La_Paz */
+    { 1327,   -8, TIME_DST_ZONE_NONE,   -38,  -324}, /*  39 America/Noronha */
+    {  202,  -12, TIME_DST_ZONE_NONE,   -14,  -485}, /*  40 America/Belem */
+    {  635,  -12, TIME_DST_ZONE_NONE,   -37,  -385}, /*  41 America/Fortaleza */
+    { 1572,  -12, TIME_DST_ZONE_NONE,   -80,  -349}, /*  42 America/Recife */
+    {  158,  -12, TIME_DST_ZONE_NONE,  -130,  -385}, /*  43 America/Bahia */
+    { 1654,  -12, TIME_DST_ZONE_NONE,  -235,  -466}, /*  44 America/Sao_Paulo */
+    {  352,  -16, TIME_DST_ZONE_NONE,  -204,  -546}, /*  45 America/Campo_Grande */
+    {  496,  -16, TIME_DST_ZONE_NONE,  -156,  -561}, /*  46 America/Cuiaba */
+    { 1483,  -16, TIME_DST_ZONE_NONE,   -88,  -639}, /*  47 America/Porto_Velho */
+    {  254,  -16, TIME_DST_ZONE_NONE,    28,  -607}, /*  48 America/Boa_Vista */
+    { 1124,  -16, TIME_DST_ZONE_NONE,   -31,  -600}, /*  49 America/Manaus */
+    { 1591,  -20, TIME_DST_ZONE_NONE,  -100,  -678}, /*  50 America/Rio_Branco */
+    { 1841,   24, TIME_DST_ZONE_NONE,   275,   896}, /*  51 Asia/Thimphu */
+    { 1214,   12, TIME_DST_ZONE_NONE,   539,   276}, /*  52 Europe/Minsk */
+    {  217,  -24, TIME_DST_ZONE_NONE,   175,  -882}, /*  53 America/Belize */
+    { 1742,  -14, 0,                    476,  -527}, /*  54 America/St_Johns, US */
+    {  728,  -16, 0,                    446,  -636}, /*  55 America/Halifax, US */
+    { 1229,  -16, 0,                    461,  -648}, /*  56 America/Moncton, US */
+    { 1892,  -20, 0,                    436,  -794}, /*  57 America/Toronto, US */
+    {  799,  -20, 0,                    637,  -685}, /*  58 America/Iqaluit, US */
+    { 2030,  -24, 0,                    499,  -972}, /*  59 America/Winnipeg, US */
+    { 1579,  -24, TIME_DST_ZONE_NONE,   504, -1046}, /*  60 America/Regina */
+    {  573,  -28, 0,                    536, -1135}, /*  61 America/Edmonton, US */
+    { 2010,  -28, TIME_DST_ZONE_NONE,   607, -1350}, /*  62 America/Whitehorse */
+    { 1956,  -32, 0,                    493, -1231}, /*  63 America/Vancouver, US */
+    { 2076,    4, 1,                    474,    85}, /*  64 Europe/Zurich, EU */
+    {    3,    0, TIME_DST_ZONE_NONE,    53,   -40}, /*  65 Africa/Abidjan */
+    { 1562,  -40, TIME_DST_ZONE_NONE,  -212, -1598}, /*  66 Pacific/Rarotonga */
+    { 1514,  -12, TIME_DST_ZONE_NONE,  -532,  -709}, /*  67 America/Punta_Arenas */
+    { 1940,   24, TIME_DST_ZONE_NONE,   438,   876}, /*  68 Asia/Urumqi */
+    {  264,  -20, TIME_DST_ZONE_NONE,    46,  -741}, /*  69 America/Bogota */
+    {  485,  -24, TIME_DST_ZONE_NONE,    99,  -841}, /*  70 America/Costa_Rica */
+    {  379,   -4, TIME_DST_ZONE_NONE,   149,  -235}, /*  71 Atlantic/Cape_Verde */
+    { 1306,    8, 5,                    352,   334}, /*  72 Asia/Nicosia, EE */
+    {  614,    8, 5,                    351,   340}, /*  73 Asia/Famagusta, EE */
+    { 1495,    4, 1,                    501,   144}, /*  74 Europe/Prague, EU */
+    { 1640,  -16, TIME_DST_ZONE_NONE,   185,  -699}, /*  75 America/Santo_Domingo */
+    {   25,    4, TIME_DST_ZONE_NONE,   368,    30}, /*  76 Africa/Algiers */
+    {  711,  -20, TIME_DST_ZONE_NONE,   -22,  -798}, /*  77 America/Guayaquil */
+    {  645,  -24, TIME_DST_ZONE_NONE,    -9,  -896}, /*  78 Pacific/Galapagos */
+    { 1790,    8, 5,                    594,   248}, /*  79 Europe/Tallinn, EE */
+    { 1077,    4, 1,                    404,   -37}, /*  80 Europe/Madrid, EU */
+    {  406,    4, 1,                    359,   -53}, /*  81 Africa/Ceuta, EU */
+    {  365,    0, 2,                    281,  -154}, /*  82 Atlantic/Canary, UK */
+    {  736,    8, 5,                    602,   250}, /*  83 Europe/Helsinki, EE */
+    {  630,   48, TIME_DST_ZONE_NONE,  -181,  1784}, /*  84 Pacific/Fiji */
+    { 1751,  -12, TIME_DST_ZONE_NONE,  -517,  -578}, /*  85 Atlantic/Stanley */
+    {  962,   44, TIME_DST_ZONE_NONE,    53,  1630}, /*  86 Pacific/Kosrae */
+    {  624,    0, 2,                    620,   -68}, /*  87 Atlantic/Faroe, UK */
+    { 1814,   16, TIME_DST_ZONE_NONE,   417,   448}, /*  88 Asia/Tbilisi */
+    {  398,  -12, TIME_DST_ZONE_NONE,    49,  -523}, /*  89 America/Cayenne */
+    {  663,    4, 1,                    361,   -54}, /*  90 Europe/Gibraltar, EU */
+    { 1849,  -16, 0,                    766,  -688}, /*  91 America/Thule, US */
+    {  127,    8, 5,                    380,   237}, /*  92 Europe/Athens, EE */
+    { 1714,   -8, TIME_DST_ZONE_NONE,  -543,  -365}, /*  93 Atlantic/South_Georgia */
+    {  701,  -24, TIME_DST_ZONE_NONE,   146,  -905}, /*  94 America/Guatemala */
+    {  696,   40, TIME_DST_ZONE_NONE,   135,  1448}, /*  95 Pacific/Guam */
+    {  247,    0, TIME_DST_ZONE_NONE,   118,  -156}, /*  96 Africa/Bissau */
+    {  721,  -16, TIME_DST_ZONE_NONE,    68,  -582}, /*  97 America/Guyana */
+    {  775,   32, TIME_DST_ZONE_NONE,   223,  1142}, /*  98 Asia/Hong_Kong */
+    { 1822,  -24, TIME_DST_ZONE_NONE,   141,  -872}, /*  99 America/Tegucigalpa */
+    { 1468,  -20, 0,                    185,  -723}, /* 100 America/Port-au-Prince, US */
+    {  330,    4, 1,                    475,   191}, /* 101 Europe/Budapest, EU */
+    {  824,   28, TIME_DST_ZONE_NONE,   -62,  1068}, /* 102 Asia/Jakarta */
+    { 1445,   28, TIME_DST_ZONE_NONE,     0,  1093}, /* 103 Asia/Pontianak */
+    { 1092,   32, TIME_DST_ZONE_NONE,   -51,  1194}, /* 104 Asia/Makassar */
+    {  840,   36, TIME_DST_ZONE_NONE,   -25,  1407}, /* 105 Asia/Jayapura */
+    {  557,    0, 2,                    533,   -62}, /* 106 Europe/Dublin, UK */
+    {  412,   24, TIME_DST_ZONE_NONE,   -73,   724}, /* 107 Indian/Chagos */
+    {  150,   12, TIME_DST_ZONE_NONE,   334,   444}, /* 108 Asia/Baghdad */
+    { 1834,   14, TIME_DST_ZONE_NONE,   357,   514}, /* 109 Asia/Tehran */
+    { 1609,    4, 1,                    419,   125}, /* 110 Europe/Rome, EU */
+    {  832,  -20, TIME_DST_ZONE_NONE,   180,  -768}, /* 111 America/Jamaica */
+    {   40,   12, TIME_DST_ZONE_NONE,   320,   359}, /* 112 Asia/Amman */
+    { 1274,   12, TIME_DST_ZONE_NONE,   -13,   368}, /* 113 Africa/Nairobi */
+    {  239,   24, TIME_DST_ZONE_NONE,   429,   746}, /* 114 Asia/Bishkek */
+    { 1798,   48, TIME_DST_ZONE_NONE,    14,  1730}, /* 115 Pacific/Tarawa */
+    {  902,   52, TIME_DST_ZONE_NONE,   -28, -1717}, /* 116 Pacific/Kanton */
+    {  945,   56, TIME_DST_ZONE_NONE,    19, -1573}, /* 117 Pacific/Kiritimati */
+    { 1527,   36, TIME_DST_ZONE_NONE,   390,  1258}, /* 118 Asia/Pyongyang */
+    { 1681,   36, TIME_DST_ZONE_NONE,   376,  1270}, /* 119 Asia/Seoul */
+    {   33,   20, TIME_DST_ZONE_NONE,   432,   770}, /* 120 Asia/Almaty */
+    { 1552,   20, TIME_DST_ZONE_NONE,   448,   655}, /* 121 Asia/Qyzylorda */
+    { 1543,   20, TIME_DST_ZONE_NONE,   532,   636}, /* 122 Asia/Qostanay */
+    {   92,   20, TIME_DST_ZONE_NONE,   503,   572}, /* 123 Asia/Aqtobe */
+    {   86,   20, TIME_DST_ZONE_NONE,   445,   503}, /* 124 Asia/Aqtau */
+    {  134,   20, TIME_DST_ZONE_NONE,   471,   519}, /* 125 Asia/Atyrau */
+    { 1372,   20, TIME_DST_ZONE_NONE,   512,   514}, /* 126 Asia/Oral */
+    {  466,   22, TIME_DST_ZONE_NONE,    69,   798}, /* 127 Asia/Colombo */
+    { 1237,    0, TIME_DST_ZONE_NONE,    63,  -108}, /* 128 Africa/Monrovia */
+    { 1973,    8, 5,                    547,   253}, /* 129 Europe/Vilnius, EE */
+    { 1586,    8, 5,                    570,   241}, /* 130 Europe/Riga, EE */
+    { 1900,    8, TIME_DST_ZONE_NONE,   329,   132}, /* 131 Africa/Tripoli */
+    {  437,    8, 1,                    470,   288}, /* 132 Europe/Chisinau, EU */
+    { 1002,   48, TIME_DST_ZONE_NONE,    91,  1673}, /* 133 Pacific/Kwajalein */
+    { 2047,   26, TIME_DST_ZONE_NONE,   168,   962}, /* 134 Asia/Yangon */
+    { 1918,   32, TIME_DST_ZONE_NONE,   479,  1069}, /* 135 Asia/Ulaanbaatar */
+    {  794,   28, TIME_DST_ZONE_NONE,   480,   916}, /* 136 Asia/Hovd */
+    { 1063,   32, TIME_DST_ZONE_NONE,   222,  1135}, /* 137 Asia/Macau */
+    { 1155,  -16, TIME_DST_ZONE_NONE,   146,  -611}, /* 138 America/Martinique */
+    { 1110,    4, 1,                    359,   145}, /* 139 Europe/Malta, EU */
+    { 1166,   16, TIME_DST_ZONE_NONE,  -202,   575}, /* 140 Indian/Mauritius */
+    { 1101,   20, TIME_DST_ZONE_NONE,    42,   735}, /* 141 Indian/Maldives */
+    { 1202,  -24, TIME_DST_ZONE_NONE,   194,  -992}, /* 142 America/Mexico_City */
+    {  372,  -20, TIME_DST_ZONE_NONE,   211,  -868}, /* 143 America/Cancun */
+    { 1195,  -24, TIME_DST_ZONE_NONE,   210,  -896}, /* 144 America/Merida */
+    { 1246,  -24, TIME_DST_ZONE_NONE,   257, -1003}, /* 145 America/Monterrey */
+    {  427,  -24, TIME_DST_ZONE_NONE,   286, -1061}, /* 146 America/Chihuahua */
+    {  452,  -28, 0,                    317, -1065}, /* 147 America/Ciudad_Juarez, US */
+    { 1176,  -28, TIME_DST_ZONE_NONE,   232, -1064}, /* 148 America/Mazatlan */
+    {  745,  -28, TIME_DST_ZONE_NONE,   291, -1110}, /* 149 America/Hermosillo */
+    { 1855,  -32, 0,                    325, -1170}, /* 150 America/Tijuana, US */
+    {  994,   32, TIME_DST_ZONE_NONE,    16,  1103}, /* 151 Asia/Kuching */
+    { 1138,    8, TIME_DST_ZONE_NONE,  -260,   326}, /* 152 Africa/Maputo */
+    { 2021,    8, TIME_DST_ZONE_NONE,  -226,   171}, /* 153 Africa/Windhoek */
+    { 1335,   44, TIME_DST_ZONE_NONE,  -223,  1664}, /* 154 Pacific/Noumea */
+    { 1319,   44, 3,                   -290,  1680}, /* 155 Pacific/Norfolk, AU */
+    { 1029,    4, TIME_DST_ZONE_NONE,    64,    34}, /* 156 Africa/Lagos */
+    { 1116,  -24, TIME_DST_ZONE_NONE,   122,  -863}, /* 157 America/Managua */
+    {  917,   23, TIME_DST_ZONE_NONE,   277,   853}, /* 158 Asia/Kathmandu */
+    { 1282,   48, TIME_DST_ZONE_NONE,    -5,  1669}, /* 159 Pacific/Nauru */
+    { 1314,  -44, TIME_DST_ZONE_NONE,  -190, -1699}, /* 160 Pacific/Niue */
+    { 1398,  -20, TIME_DST_ZONE_NONE,    90,  -795}, /* 161 America/Panama */
+    { 1035,  -20, TIME_DST_ZONE_NONE,  -120,  -770}, /* 162 America/Lima */
+    { 1776,  -40, TIME_DST_ZONE_NONE,  -175, -1496}, /* 163 Pacific/Tahiti */
+    { 1145,  -38, TIME_DST_ZONE_NONE,   -90, -1395}, /* 164 Pacific/Marquesas */
+    {  655,  -36, TIME_DST_ZONE_NONE,  -231, -1350}, /* 165 Pacific/Gambier */
+    { 1455,   40, TIME_DST_ZONE_NONE,   -95,  1472}, /* 166 Pacific/Port_Moresby */
+    {  277,   44, TIME_DST_ZONE_NONE,   -62,  1556}, /* 167 Pacific/Bougainville */
+    { 1131,   32, TIME_DST_ZONE_NONE,   146,  1210}, /* 168 Asia/Manila */
+    {  909,   20, TIME_DST_ZONE_NONE,   249,   670}, /* 169 Asia/Karachi */
+    { 2003,    4, 1,                    522,   210}, /* 170 Europe/Warsaw, EU */
+    { 1220,  -12, 0,                    470,  -563}, /* 171 America/Miquelon, US */
+    { 1436,  -32, TIME_DST_ZONE_NONE,  -251, -1301}, /* 172 Pacific/Pitcairn */
+    { 1502,  -16, TIME_DST_ZONE_NONE,   185,  -661}, /* 173 America/Puerto_Rico */
+    { 1049,    0, 2,                    387,   -91}, /* 174 Europe/Lisbon, UK */
+    { 1069,    0, 2,                    326,  -169}, /* 175 Atlantic/Madeira, UK */
+    { 1392,   36, TIME_DST_ZONE_NONE,    73,  1345}, /* 176 Pacific/Palau */
+    {  118,  -12, TIME_DST_ZONE_NONE,  -253,  -577}, /* 177 America/Asuncion */
+    { 1537,   12, TIME_DST_ZONE_NONE,   253,   515}, /* 178 Asia/Qatar */
+    {  320,    8, 5,                    444,   261}, /* 179 Europe/Bucharest, EE */
+    {  208,    4, 1,                    448,   205}, /* 180 Europe/Belgrade, EU */
+    {  880,    8, TIME_DST_ZONE_NONE,   547,   205}, /* 181 Europe/Kaliningrad */
+    { 1687,   12, TIME_DST_ZONE_NONE,   450,   341}, /* 182 Europe/Simferopol */
+    {  956,   12, TIME_DST_ZONE_NONE,   586,   496}, /* 183 Europe/Kirov */
+    { 1993,   12, TIME_DST_ZONE_NONE,   487,   444}, /* 184 Europe/Volgograd */
+    {  108,   16, TIME_DST_ZONE_NONE,   464,   480}, /* 185 Europe/Astrakhan */
+    { 1673,   16, TIME_DST_ZONE_NONE,   516,   460}, /* 186 Europe/Saratov */
+    { 1930,   16, TIME_DST_ZONE_NONE,   543,   484}, /* 187 Europe/Ulyanovsk */
+    { 1623,   16, TIME_DST_ZONE_NONE,   532,   502}, /* 188 Europe/Samara */
+    { 2054,   20, TIME_DST_ZONE_NONE,   568,   606}, /* 189 Asia/Yekaterinburg */
+    { 1367,   24, TIME_DST_ZONE_NONE,   550,   734}, /* 190 Asia/Omsk */
+    { 1355,   28, TIME_DST_ZONE_NONE,   550,   829}, /* 191 Asia/Novosibirsk */
+    {  186,   28, TIME_DST_ZONE_NONE,   534,   838}, /* 192 Asia/Barnaul */
+    { 1876,   28, TIME_DST_ZONE_NONE,   565,   850}, /* 193 Asia/Tomsk */
+    { 1342,   28, TIME_DST_ZONE_NONE,   538,   871}, /* 194 Asia/Novokuznetsk */
+    {  969,   28, TIME_DST_ZONE_NONE,   560,   928}, /* 195 Asia/Krasnoyarsk */
+    {  807,   32, TIME_DST_ZONE_NONE,   523,  1043}, /* 196 Asia/Irkutsk */
+    {  446,   36, TIME_DST_ZONE_NONE,   520,  1135}, /* 197 Asia/Chita */
+    { 2039,   36, TIME_DST_ZONE_NONE,   620,  1297}, /* 198 Asia/Yakutsk */
+    {  927,   36, TIME_DST_ZONE_NONE,   627,  1356}, /* 199 Asia/Khandyga */
+    { 1981,   40, TIME_DST_ZONE_NONE,   432,  1319}, /* 200 Asia/Vladivostok */
+    { 1947,   40, TIME_DST_ZONE_NONE,   646,  1432}, /* 201 Asia/Ust-Nera */
+    { 1084,   44, TIME_DST_ZONE_NONE,   596,  1508}, /* 202 Asia/Magadan */
+    { 1614,   44, TIME_DST_ZONE_NONE,   470,  1427}, /* 203 Asia/Sakhalin */
+    { 1728,   44, TIME_DST_ZONE_NONE,   675,  1537}, /* 204 Asia/Srednekolymsk */
+    {  892,   48, TIME_DST_ZONE_NONE,   530,  1586}, /* 205 Asia/Kamchatka */
+    {   56,   48, TIME_DST_ZONE_NONE,   648,  1775}, /* 206 Asia/Anadyr */
+    { 1602,   12, TIME_DST_ZONE_NONE,   246,   467}, /* 207 Asia/Riyadh */
+    {  684,   44, TIME_DST_ZONE_NONE,   -95,  1602}, /* 208 Pacific/Guadalcanal */
+    {  936,    8, TIME_DST_ZONE_NONE,   156,   325}, /* 209 Africa/Khartoum */
+    { 1698,   32, TIME_DST_ZONE_NONE,    13,  1038}, /* 210 Asia/Singapore */
+    { 1405,  -12, TIME_DST_ZONE_NONE,    58,  -552}, /* 211 America/Paramaribo */
+    {  862,    8, TIME_DST_ZONE_NONE,    48,   316}, /* 212 Africa/Juba */
+    { 1664,    0, TIME_DST_ZONE_NONE,     3,    67}, /* 213 Africa/Sao_Tome */
+    {  588,  -24, TIME_DST_ZONE_NONE,   137,  -892}, /* 214 America/El_Salvador */
+    {  503,   12, TIME_DST_ZONE_NONE,   335,   363}, /* 215 Asia/Damascus */
+    {  673,  -20, 0,                    215,  -711}, /* 216 America/Grand_Turk, US */
+    { 1288,    4, TIME_DST_ZONE_NONE,   121,   150}, /* 217 Africa/Ndjamena */
+    {  169,   28, TIME_DST_ZONE_NONE,   138,  1005}, /* 218 Asia/Bangkok */
+    {  564,   20, TIME_DST_ZONE_NONE,   386,   688}, /* 219 Asia/Dushanbe */
+    {  606,   52, TIME_DST_ZONE_NONE,   -94, -1712}, /* 220 Pacific/Fakaofo */
+    {  546,   36, TIME_DST_ZONE_NONE,   -86,  1256}, /* 221 Asia/Dili */
+    {   99,   20, TIME_DST_ZONE_NONE,   380,   584}, /* 222 Asia/Ashgabat */
+    { 1908,    4, TIME_DST_ZONE_NONE,   368,   102}, /* 223 Africa/Tunis */
+    { 1882,   52, TIME_DST_ZONE_NONE,  -211, -1752}, /* 224 Pacific/Tongatapu */
+    {  815,   12, TIME_DST_ZONE_NONE,   410,   290}, /* 225 Europe/Istanbul */
+    { 1783,   32, TIME_DST_ZONE_NONE,   250,  1215}, /* 226 Asia/Taipei */
+    { 1012,    8, 5,                    504,   305}, /* 227 Europe/Kyiv, EE */
+    {  532,  -20, 0,                    423,  -830}, /* 228 America/Detroit, US */
+    {  271,  -28, 0,                    436, -1162}, /* 229 America/Boise, US */
+    { 1428,  -28, TIME_DST_ZONE_NONE,   334, -1121}, /* 230 America/Phoenix */
+    {   63,  -36, 0,                    612, -1499}, /* 231 America/Anchorage, US */
+    {  867,  -36, 0,                    583, -1344}, /* 232 America/Juneau, US */
+    {   11,  -40, 0,                    519, -1767}, /* 233 America/Adak, US */
+    {  785,  -40, TIME_DST_ZONE_NONE,   213, -1579}, /* 234 Pacific/Honolulu */
+    { 1256,  -12, TIME_DST_ZONE_NONE,  -349,  -562}, /* 235 America/Montevideo */
+    { 1630,   20, TIME_DST_ZONE_NONE,   397,   668}, /* 236 Asia/Samarkand */
+    { 1805,   20, TIME_DST_ZONE_NONE,   413,   693}, /* 237 Asia/Tashkent */
+    {  390,  -16, TIME_DST_ZONE_NONE,   105,  -669}, /* 238 America/Caracas */
+    {  756,   28, TIME_DST_ZONE_NONE,   108,  1067}, /* 239 Asia/Ho_Chi_Minh */
+    {  582,   44, TIME_DST_ZONE_NONE,  -177,  1684}, /* 240 Pacific/Efate */
+    {   81,   52, TIME_DST_ZONE_NONE,  -138, -1717}, /* 241 Pacific/Apia */
+    {  849,    8, TIME_DST_ZONE_NONE,  -262,   280}, /* 242 Africa/Johannesburg */
+    {   46,    4, 1,                    524,    49}, /* 243 Europe/Amsterdam, EU */
+    {  474,    4, 1,                    557,   126}, /* 244 Europe/Copenhagen, EU */
+    { 1377,    4, 1,                    599,   108}, /* 245 Europe/Oslo, EU */
+    { 1759,    4, 1,                    593,   180}, /* 246 Europe/Stockholm, EU */
+    {  981,   32, TIME_DST_ZONE_NONE,    32,  1017}, /* 247 Asia/Kuala_Lumpur */
+};
+
+/* 按名称排序的时区编号 */
+const uint8_t app_tzdb_by_name[APP_TZDB_LIST_COUNT] = {
+     65, 233,  28,  76, 120, 112, 243, 206, 231,  16, 241, 124, 123, 222, 185, 177,
+     92, 125,   3, 108,  43,  32, 218,  33, 192,   0,  40, 180,  53,   7,  37, 114,
+     96,  48,  69, 229, 167,  26,  25,  35, 179, 101,  20,  45,  82, 143,  71, 238,
+     89,  81, 107,  12, 146, 132, 197, 147, 127, 244,  70,  46, 215,  29,   4,  13,
+    228,  34, 221,   5, 106, 219,  61, 240, 214,  31, 220,  73,  87,  84,  41,  78,
+    165,  90, 216, 208,  95,  94,  77,  97,  55,  83, 149, 239,  23,  98, 234, 136,
+     58, 196, 225, 102, 111, 105, 242, 212, 232,  17, 181, 205, 116, 169, 158, 199,
+    209, 117, 183,  86, 195, 247, 151, 133, 227,  14,  38, 156, 162,  27, 174,   9,
+    137, 175,  80, 202, 104, 141, 139, 157,  49, 168, 152, 164, 138, 140, 148,  24,
+    144, 142,  52, 171,  56, 128, 145, 235,   6, 113, 159, 217,  11,  72, 160, 155,
+     39, 154, 194, 191, 190, 126, 245,  21, 176, 161, 211,   8,  30, 230, 172, 103,
+    166, 100,  47,  74, 173,  67, 118, 178, 122, 121,  66,  42,  60, 130,  50, 207,
+    110, 203, 188, 236,  75,  44, 213, 186, 119, 182, 210,  36,  93, 204,  54,  85,
+    246,   2, 163, 226,  79, 115, 237,  88,  99, 109,  51,  91, 150,  18,   1, 193,
+    224,  57, 131, 223,  10, 135, 187,  68, 201,  63,  22, 129, 200, 184, 170,  62,
+    153,  59, 198, 134, 189,  19,  64,
+};
+
+/* 字符串池 */
+const char app_tzdb_pool[APP_TZDB_POOL_SIZE] =
+    "--\0Abidjan\0Adak\0Adelaide\0Algiers\0Almaty\0Amman\0Amsterdam\0Anadyr\0"
+    "Anchorage\0Andorra\0Apia\0Aqtau\0Aqtobe\0Ashgabat\0Astrakhan\0Asuncion\0"
+    "Athens\0Atyrau\0Auckland\0Baghdad\0Bahia\0Baku\0Bangkok\0Barbados\0"
+    "Barnaul\0Beijing\0Belem\0Belgrade\0Belize\0Berlin\0Bermuda\0Bishkek\0"
+    "Bissau\0Boa Vista\0Bogota\0Boise\0Bougainville\0Brisbane\0Broken Hill\0"
+    "Brussels\0Bucharest\0Budapest\0Buenos Aires\0Campo Grande\0Canary\0"
+    "Cancun\0Cape Verde\0Caracas\0Cayenne\0Ceuta\0Chagos\0Chicago\0"
+    "Chihuahua\0Chisinau\0Chita\0Ciudad Juarez\0Colombo\0Copenhagen\0"
+    "Costa Rica\0Cuiaba\0Damascus\0Darwin\0Delhi\0Denver\0Detroit\0Dhaka\0"
+    "Dili\0Dubai\0Dublin\0Dushanbe\0Edmonton\0Efate\0El Salvador\0Eucla\0"
+    "Fakaofo\0Famagusta\0Faroe\0Fiji\0Fortaleza\0Galapagos\0Gambier\0"
+    "Gibraltar\0Grand Turk\0Guadalcanal\0Guam\0Guatemala\0Guayaquil\0Guyana\0"
+    "Halifax\0Helsinki\0Hermosillo\0Ho Chi Minh\0Hobart\0Hong Kong\0"
+    "Honolulu\0Hovd\0Iqaluit\0Irkutsk\0Istanbul\0Jakarta\0Jamaica\0Jayapura\0"
+    "Johannesburg\0Juba\0Juneau\0Kabul\0Kaliningrad\0Kamchatka\0Kanton\0"
+    "Karachi\0Kathmandu\0Khandyga\0Khartoum\0Kiritimati\0Kirov\0Kosrae\0"
+    "Krasnoyarsk\0Kuala Lumpur\0Kuching\0Kwajalein\0Kyiv\0L.A.\0La Paz\0"
+    "Lagos\0Lima\0Lindeman\0Lisbon\0London\0Macau\0Madeira\0Madrid\0Magadan\0"
+    "Makassar\0Maldives\0Malta\0Managua\0Manaus\0Manila\0Maputo\0Marquesas\0"
+    "Martinique\0Mauritius\0Mazatlan\0Melbourne\0Merida\0Mexico City\0Minsk\0"
+    "Miquelon\0Moncton\0Monrovia\0Monterrey\0Montevideo\0Moscow\0Nairobi\0"
+    "Nauru\0Ndjamena\0New York\0Nicosia\0Niue\0Norfolk\0Noronha\0Noumea\0"
+    "Novokuznetsk\0Novosibirsk\0Omsk\0Oral\0Oslo\0Pago Pago\0Palau\0Panama\0"
+    "Paramaribo\0Paris\0Perth\0Phoenix\0Pitcairn\0Pontianak\0Port Moresby\0"
+    "Port-au-Prince\0Porto Velho\0Prague\0Puerto Rico\0Punta Arenas\0"
+    "Pyongyang\0Qatar\0Qostanay\0Qyzylorda\0Rarotonga\0Recife\0Regina\0Riga\0"
+    "Rio Branco\0Riyadh\0Rome\0Sakhalin\0Samara\0Samarkand\0Santo Domingo\0"
+    "Sao Paulo\0Sao Tome\0Saratov\0Seoul\0Simferopol\0Singapore\0Sofia\0"
+    "South Georgia\0Srednekolymsk\0St Johns\0Stanley\0Stockholm\0Sydney\0"
+    "Tahiti\0Taipei\0Tallinn\0Tarawa\0Tashkent\0Tbilisi\0Tegucigalpa\0"
+    "Tehran\0Thimphu\0Thule\0Tijuana\0Tirane\0Tokyo\0Tomsk\0Tongatapu\0"
+    "Toronto\0Tripoli\0Tunis\0UTC\0Ulaanbaatar\0Ulyanovsk\0Urumqi\0Ust-Nera\0"
+    "Vancouver\0Vienna\0Vilnius\0Vladivostok\0Volgograd\0Warsaw\0Whitehorse\0"
+    "Windhoek\0Winnipeg\0Yakutsk\0Yangon\0Yekaterinburg\0Yerevan\0Zurich";
@@ -0,0 +1,10 @@
+/* 由 Tools/tz_gen.py 根据 Tools/tz_zones.txt 和 tzdata 生成，请勿手工修改。收录的时区改动后重新运行该脚本。 */
+
+#ifndef __APP_TZDB_DATA_H
+#define __APP_TZDB_DATA_H
+
+#define APP_TZDB_COUNT      248U ///< 时区表的项数 (编号的上限，含空位)
+#define APP_TZDB_LIST_COUNT 247U ///< 选择列表中的时区数 (不含空位)
+#define APP_TZDB_POOL_SIZE  2083U ///< 字符串池的字节数
+
+#endif /* __APP_TZDB_DATA_H */
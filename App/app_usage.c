@@ -0,0 +1,361 @@
+/**
+ * @file      app_usage.c
+ * @brief     使用统计
+ * @details   live 中是当前的计数，各数据源按启动以来的累计值读取，与上次读到的值之差计入 live，
+ *            因此计数区读取完成之前发生的事件在读取完成后同样计入。
+ *            完整记录格式 (52字节，占两页)：| 魔法数 (2) | 序号 (2) | 计数 x11 (44) | CRC-32 (4) |
+ *            (旧版本写入的记录在 CRC-32 的位置是 CRC-16 (2) 和填充 (2)，读取时同样接受)。
+ *            小时计数页格式 (32字节)：| 所属完整记录的序号 (2) | 通电小时 (15) | 亮屏小时 (15) |，
+ *            每满一小时从低位起清除一位，读取时按已清除的位数计入 (写入被打断的字节只少计)。
+ *            写入新的完整记录后再把小时计数页改写为全1 并标上新的序号；两次写入之间掉电时，
+ *            小时计数页的序号与完整记录不符而被忽略，其中的小时已包含在新的完整记录中。
+ *            两个槽位和小时计数页都直接使用 app_persist 镜像中的区域，写入也从镜像中写出。
+ *            持久区读取失败时不写入，以免用启动以来的计数覆盖 EEPROM 中的记录。
+ *            同一时间只有一个写任务，完成回调只记录结果，后续的写入在 app_usage_service() 中进行。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_usage.h"
+#include "app_persist.h"
+#include "app_power.h"
+#include "AT24C32.h"
+#include <stddef.h> // For offsetof
+#include <string.h>
+
+/**
+ * @addtogroup AppUsage
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define USAGE_MAGIC       0x5553U   ///< 完整记录的魔法数 ("US")
+#define USAGE_MS_PER_HOUR 3600000UL ///< 每小时的毫秒数
+#define USAGE_HOURS       2         ///< 按小时计数的项数 (APP_USAGE_POWER_HOURS 和 APP_USAGE_SCREEN_HOURS)
+#define USAGE_TALLY_BYTES 15        ///< 小时计数页中每项占用的字节数
+#define USAGE_TALLY_BITS  (USAGE_TALLY_BYTES * 8) ///< 小时计数页中每项可记录的小时数
+#define USAGE_SLOT(i)     APP_PERSIST_MIRROR(Usage_Record_t, APP_USAGE_BASE_ADDR + (i) * APP_USAGE_RECORD_SIZE) ///< 镜像中的一个槽位
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 完整记录
+ */
+typedef struct {
+    uint16_t magic;                  ///< 魔法数，固定为 USAGE_MAGIC
+    uint16_t seq;                    ///< 序号，较新的记录较大 (按16位回绕比较)
+    uint32_t value[APP_USAGE_COUNT]; ///< 各项计数
+    uint32_t crc;                    ///< 前面所有字段的 CRC-32 (旧版本为 CRC-16/CCITT 加2字节填充)
+} Usage_Record_t;
+
+/**
+ * @brief 进行中的写任务
+ */
+typedef enum {
+    USAGE_JOB_NONE = 0, ///< 没有写任务
+    USAGE_JOB_RECORD,   ///< 写入完整记录
+    USAGE_JOB_ERASE,    ///< 把小时计数页改写为全1
+    USAGE_JOB_TALLY,    ///< 在小时计数页中清除新满的小时
+} Usage_Job_e;
+
+/** 编译期检查：记录必须放得进预留的两页，一批的小时数不能超过小时计数页的容量 */
+typedef char usage_record_size_check[(sizeof(Usage_Record_t) <= APP_USAGE_RECORD_SIZE) ? 1 : -1];
+typedef char usage_tally_size_check[(2 + USAGE_HOURS * USAGE_TALLY_BYTES <= AT24C32_PAGE_SIZE) ? 1 : -1];
+typedef char usage_batch_check[(APP_USAGE_BATCH_HOURS > 0 && APP_USAGE_BATCH_HOURS <= USAGE_TALLY_BITS) ? 1 : -1];
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t live[APP_USAGE_COUNT];     ///< 当前的计数
+static uint32_t last_src[APP_USAGE_COUNT]; ///< 上次读到的数据源累计值
+static uint32_t acc_ms[USAGE_HOURS];       ///< 尚不足一小时的时间 (ms)
+static uint32_t last_poll;                 ///< 上次读取数据源的时间
+static uint8_t *const tally = APP_PERSIST_MIRROR(uint8_t, APP_USAGE_TALLY_ADDR); ///< 小时计数页的内容
+static uint16_t base_seq;                  ///< 当前完整记录的序号
+static uint8_t next_slot;                  ///< 下一个完整记录写入的槽位 (0或1)
+static uint32_t base_hours[USAGE_HOURS];   ///< 当前完整记录中的小时数
+static uint8_t tally_hours[USAGE_HOURS];   ///< 小时计数页中已写入的小时数
+static bool tally_erase;                   ///< 小时计数页须先改写为全1
+static bool loaded;                        ///< 计数区是否已计入 live
+static Usage_Job_e job;                    ///< 进行中的写任务
+static uint8_t job_hours[USAGE_HOURS];     ///< 小时计数写入完成后已写入的小时数
+static volatile bool job_done;             ///< 写任务已完成
+static volatile bool job_ok;               ///< 写任务是否成功
+
+/* Private function prototypes -----------------------------------------------*/
+static void usage_write_cb(HAL_StatusTypeDef status, void *ctx);
+static void usage_load(void);
+static uint8_t usage_tally_count(uint8_t h);
+static void usage_accumulate(App_Usage_e id, uint32_t source);
+static void usage_poll(void);
+static bool usage_write(Usage_Job_e next, uint16_t addr, uint8_t *data, uint16_t size);
+static void usage_job_finish(void);
+static void usage_schedule(void);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 写任务的完成回调 (I2C中断上下文)
+ * @param[in] status 写任务结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void usage_write_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+
+    job_ok = (status == HAL_OK);
+    job_done = true;
+}
+
+/**
+ * @brief 持久区读取完成后计入计数区
+ * @details 两个槽位中取序号较新的有效记录，把记录和小时计数页中已写入的小时计入 live。
+ * @return 无
+ */
+static void usage_load(void)
+{
+    const uint32_t *stored = NULL;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        const Usage_Record_t *rec = USAGE_SLOT(i);
+        if (rec->magic == USAGE_MAGIC &&
+            app_persist_verify(rec, offsetof(Usage_Record_t, crc), offsetof(Usage_Record_t, crc)) &&
+            (stored == NULL || (int16_t)(rec->seq - base_seq) > 0)) {
+            stored = rec->value;
+            base_seq = rec->seq;
+            next_slot = (uint8_t)(i ^ 1U);
+        }
+    }
+
+    tally_erase = (tally[0] != (uint8_t)base_seq || tally[1] != (uint8_t)(base_seq >> 8));
+    for (uint8_t h = 0; h < USAGE_HOURS; h++) {
+        base_hours[h] = (stored != NULL) ? stored[h] : 0;
+        tally_hours[h] = tally_erase ? 0 : usage_tally_count(h);
+        live[h] += tally_hours[h];
+    }
+    if (stored != NULL) {
+        for (uint8_t i = 0; i < APP_USAGE_COUNT; i++) {
+            live[i] += stored[i];
+        }
+    }
+    loaded = true;
+}
+
+/**
+ * @brief 统计小时计数页中一项已清除的位数
+ * @param[in] h 按小时计数的项
+ * @return uint8_t 已清除的位数
+ */
+static uint8_t usage_tally_count(uint8_t h)
+{
+    const uint8_t *p = &tally[2 + h * USAGE_TALLY_BYTES];
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < USAGE_TALLY_BYTES; i++) {
+        for (uint8_t b = (uint8_t)~p[i]; b != 0; b &= (uint8_t)(b - 1)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 把数据源累计值的增量计入一项计数
+ * @param[in] id 计数项
+ * @param[in] source 数据源的累计值，按小时计数的项为毫秒
+ * @return 无
+ */
+static void usage_accumulate(App_Usage_e id, uint32_t source)
+{
+    uint32_t delta = source - last_src[id];
+
+    last_src[id] = source;
+    if (id < USAGE_HOURS) {
+        acc_ms[id] += delta;
+        while (acc_ms[id] >= USAGE_MS_PER_HOUR) {
+            acc_ms[id] -= USAGE_MS_PER_HOUR;
+            live[id]++;
+        }
+    } else {
+        live[id] += delta;
+    }
+}
+
+/**
+ * @brief 读取全部数据源
+ * @details 通电时间取 HAL_GetTick() (停止模式后已补偿)，亮屏时间取 POWER_RES_DISPLAY_ON 的累计时间。
+ * @return 无
+ */
+static void usage_poll(void)
+{
+    uint32_t ms[POWER_RES_COUNT];
+
+    Power_Get_Residency(ms);
+    usage_accumulate(APP_USAGE_POWER_HOURS, last_poll);
+    usage_accumulate(APP_USAGE_SCREEN_HOURS, ms[POWER_RES_DISPLAY_ON]);
+    usage_accumulate(APP_USAGE_EEPROM_WRITES, AT24C32_Get_Write_Count());
+    for (uint8_t e = INPUT_EVENT_NONE + 1; e < INPUT_EVENT_COUNT; e++) {
+        usage_accumulate((App_Usage_e)(APP_USAGE_INPUT_FIRST + e - 1), input_get_event_count((Input_Event_t)e));
+    }
+}
+
+/**
+ * @brief 提交一个写任务
+ * @param[in] next 写任务的类型
+ * @param[in] addr 起始地址
+ * @param[in] data 数据，须保持有效直到任务完成
+ * @param[in] size 数据大小
+ * @return bool 提交成功返回 true，EEPROM 正忙时返回 false (之后重试)
+ */
+static bool usage_write(Usage_Job_e next, uint16_t addr, uint8_t *data, uint16_t size)
+{
+    job_done = false;
+    if (AT24C32_WritePage_Async(addr, data, size, usage_write_cb, NULL) != HAL_OK) {
+        return false;
+    }
+    job = next;
+    return true;
+}
+
+/**
+ * @brief 处理完成的写任务
+ * @details 失败时不改变状态，由 usage_schedule() 重新生成同样的写入。
+ * @return 无
+ */
+static void usage_job_finish(void)
+{
+    const Usage_Record_t *record = USAGE_SLOT(next_slot);
+    Usage_Job_e done = job;
+
+    job = USAGE_JOB_NONE;
+    job_done = false;
+    if (!job_ok) {
+        return;
+    }
+
+    switch (done) {
+    case USAGE_JOB_RECORD:
+        base_seq = record->seq;
+        next_slot ^= 1U;
+        base_hours[APP_USAGE_POWER_HOURS] = record->value[APP_USAGE_POWER_HOURS];
+        base_hours[APP_USAGE_SCREEN_HOURS] = record->value[APP_USAGE_SCREEN_HOURS];
+        tally_erase = true;
+        break;
+    case USAGE_JOB_ERASE:
+        tally_erase = false;
+        tally_hours[APP_USAGE_POWER_HOURS] = 0;
+        tally_hours[APP_USAGE_SCREEN_HOURS] = 0;
+        break;
+    case USAGE_JOB_TALLY:
+        tally_hours[APP_USAGE_POWER_HOURS] = job_hours[APP_USAGE_POWER_HOURS];
+        tally_hours[APP_USAGE_SCREEN_HOURS] = job_hours[APP_USAGE_SCREEN_HOURS];
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief 决定下一个写入
+ * @details 优先级：改写小时计数页 > 满一批时的完整记录 > 新满的小时。
+ *          小时计数只在通电小时数增加时写入 (亮屏小时数随之一起写入)，每小时最多一次。
+ * @return 无
+ */
+static void usage_schedule(void)
+{
+    Usage_Record_t *record = USAGE_SLOT(next_slot);
+    uint32_t since[USAGE_HOURS];
+    uint8_t lo = AT24C32_PAGE_SIZE;
+    uint8_t hi = 0;
+
+    if (tally_erase) {
+        memset(tally, 0xFF, AT24C32_PAGE_SIZE);
+        tally[0] = (uint8_t)base_seq;
+        tally[1] = (uint8_t)(base_seq >> 8);
+        (void)usage_write(USAGE_JOB_ERASE, APP_USAGE_TALLY_ADDR, tally, AT24C32_PAGE_SIZE);
+        return;
+    }
+
+    for (uint8_t h = 0; h < USAGE_HOURS; h++) {
+        since[h] = live[h] - base_hours[h];
+        if (since[h] > USAGE_TALLY_BITS) {
+            since[h] = USAGE_TALLY_BITS;
+        }
+    }
+    if (since[APP_USAGE_POWER_HOURS] >= APP_USAGE_BATCH_HOURS) {
+        memcpy(record->value, live, sizeof(record->value));
+        record->magic = USAGE_MAGIC;
+        record->seq = (uint16_t)(base_seq + 1U);
+        record->crc = app_persist_crc(record, offsetof(Usage_Record_t, crc));
+        (void)usage_write(USAGE_JOB_RECORD, (uint16_t)(APP_USAGE_BASE_ADDR + next_slot * APP_USAGE_RECORD_SIZE),
+                          (uint8_t *)record, sizeof(Usage_Record_t));
+        return;
+    }
+    if (since[APP_USAGE_POWER_HOURS] <= tally_hours[APP_USAGE_POWER_HOURS]) {
+        return;
+    }
+
+    for (uint8_t h = 0; h < USAGE_HOURS; h++) {
+        uint8_t *p = &tally[2 + h * USAGE_TALLY_BYTES];
+        for (uint8_t i = tally_hours[h]; i < since[h]; i++) {
+            uint8_t pos = (uint8_t)((p - tally) + i / 8);
+            tally[pos] &= (uint8_t)~(1U << (i % 8));
+            lo = (pos < lo) ? pos : lo;
+            hi = (pos > hi) ? pos : hi;
+        }
+        job_hours[h] = (uint8_t)since[h];
+    }
+    (void)usage_write(USAGE_JOB_TALLY, (uint16_t)(APP_USAGE_TALLY_ADDR + lo), &tally[lo], (uint16_t)(hi - lo + 1));
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 使用统计维护函数，需在主循环中周期调用
+ * @return 无
+ */
+void app_usage_service(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    if (!loaded && app_persist_state() == APP_PERSIST_READY) {
+        usage_load();
+    }
+    if (job != USAGE_JOB_NONE && job_done) {
+        usage_job_finish();
+    }
+
+    if (now - last_poll < APP_USAGE_POLL_MS) {
+        return;
+    }
+    last_poll = now;
+    usage_poll();
+    if (loaded && job == USAGE_JOB_NONE) {
+        usage_schedule();
+    }
+}
+
+/**
+ * @brief 记录一次唤醒
+ * @return 无
+ */
+void app_usage_wakeup(void)
+{
+    live[APP_USAGE_WAKEUPS]++;
+}
+
+/**
+ * @brief 获取一项计数
+ * @param[in] id 计数项
+ * @return uint32_t 计数值，id 无效时为0
+ */
+uint32_t app_usage_get(App_Usage_e id)
+{
+    if ((unsigned)id >= APP_USAGE_COUNT) {
+        return 0;
+    }
+    return live[id];
+}
+
+/** @} */
@@ -0,0 +1,81 @@
+/**
+ * @file      app_usage.h
+ * @brief     使用统计头文件
+ * @details   累计整个寿命期间的通电小时数、亮屏小时数、各类输入事件数、唤醒次数和 EEPROM 写周期数。
+ *            计数在 RAM 中进行 (备份寄存器已全部用于 app_resume)，数据源都按启动以来的累计值提供
+ *            (通电和亮屏时间来自 Power_Get_Residency，输入事件来自 input_get_event_count，写周期来自 AT24C32_Get_Write_Count)。
+ *            EEPROM 中的计数区 (5页，紧接 app_store 的槽位) 由两部分组成：
+ *            - 两个交替写入的完整记录 (各两页，带序号和 CRC)，每通电 APP_USAGE_BATCH_HOURS 小时写入一次，
+ *              写入被打断时保留另一个；
+ *            - 一页小时计数：通电和亮屏每满一小时在其中清除一位 (一元计数)，每小时只需写入变化的一两个字节。
+ *            掉电时最多丢失不足一小时的时间和上一个完整记录之后的事件计数。
+ *            远程命令 REMOTE_CMD_GET_USAGE 返回全部计数。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_USAGE_H
+#define __APP_USAGE_H
+
+#include "main.h"
+#include "input.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppUsage 使用统计
+ * @brief 寿命期间的使用计数，分批写入 EEPROM。
+ * @{
+ */
+
+/**
+ * @defgroup AppUsage_Config 使用统计配置
+ * @{
+ */
+#define APP_USAGE_BASE_ADDR   0x0C40 ///< 计数区在 AT24C32 中的地址 (紧接 app_store 的槽位，须与页对齐)
+#define APP_USAGE_RECORD_SIZE 64     ///< 每个完整记录占用的字节数 (两页)
+#define APP_USAGE_TALLY_ADDR  (APP_USAGE_BASE_ADDR + 2 * APP_USAGE_RECORD_SIZE) ///< 小时计数页的地址
+#define APP_USAGE_BATCH_HOURS 24     ///< 每通电多少小时写入一次完整记录 (不超过小时计数页的容量 120)
+#define APP_USAGE_POLL_MS     1000   ///< 读取各数据源的间隔 (ms)
+/** @} */
+
+/**
+ * @brief 计数项
+ */
+typedef enum {
+    APP_USAGE_POWER_HOURS = 0, ///< 通电小时数
+    APP_USAGE_SCREEN_HOURS,    ///< 亮屏小时数 (不含低功耗时钟)
+    APP_USAGE_WAKEUPS,         ///< 从熄屏或低功耗时钟唤醒的次数
+    APP_USAGE_EEPROM_WRITES,   ///< EEPROM 写周期 (页写入) 次数
+    APP_USAGE_INPUT_FIRST,     ///< INPUT_EVENT_BACK_PRESSED 的次数，其后按 Input_Event_t 的顺序排列各类输入事件
+    APP_USAGE_COUNT = APP_USAGE_INPUT_FIRST + INPUT_EVENT_COUNT - 1 ///< 计数项的个数
+} App_Usage_e;
+
+/**
+ * @brief 使用统计维护函数，需在主循环中周期调用 (包括熄屏期间)
+ * @details 启动时 app_persist 的读取完成后把计数区计入 live (之前数据源照常累计，完成后一并计入)；
+ *          每 APP_USAGE_POLL_MS 读取一次数据源；满一小时时写入小时计数，满一批时写入完整记录。
+ *          EEPROM 写任务正忙时在之后的调用中重试。
+ * @return 无
+ */
+void app_usage_service(void);
+
+/**
+ * @brief 记录一次唤醒
+ * @return 无
+ */
+void app_usage_wakeup(void);
+
+/**
+ * @brief 获取一项计数
+ * @details 计数区读取完成之前只含本次启动以来的部分。
+ * @param[in] id 计数项
+ * @return uint32_t 计数值，id 无效时为0
+ */
+uint32_t app_usage_get(App_Usage_e id);
+
+/** @} */
+
+#endif /* __APP_USAGE_H */
@@ -0,0 +1,144 @@
+/**
+ * @file      app_world.c
+ * @brief     世界时钟
+ * @details   偏移的有效区间按本地标准时间保存：城市的夏令时区间 [from, until) 换算回本地标准时间，
+ *            本地标准时间落在区间外 (过了切换时刻、跨年或时间被调整) 时重新计算。
+ *            所有城市的偏移都是整分钟，各行的分钟与本地时间同时变化。
+ *            城市的 UTC 偏移、夏令时规则和坐标取自内置时区库 (app_tzdb)。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_world.h"
+#include "app_settings.h"
+#include "app_tzdb.h"
+
+/**
+ * @addtogroup AppWorld
+ * @{
+ */
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 世界时钟中一行的缓存
+ */
+typedef struct {
+    bool valid;            ///< 缓存是否已计算
+    uint8_t city;          ///< 计算时的城市
+    uint8_t home;          ///< 计算时的本地城市
+    int32_t offset_s;      ///< 该城市本地时间与本地标准时间之差 (s)
+    Epoch_t from;          ///< offset_s 有效区间的起点 (本地标准时间，含)
+    Epoch_t until;         ///< offset_s 有效区间的终点 (本地标准时间，不含)
+    Time_Dst_Cache_t dst;  ///< 该城市的夏令时缓存
+} World_Slot_t;
+
+/* Private variables ---------------------------------------------------------*/
+static World_Slot_t world_slots[WORLD_SLOT_COUNT]; ///< 各行的缓存
+
+/* Private function prototypes -----------------------------------------------*/
+static void world_update(World_Slot_t *s, uint8_t city, uint8_t home, Epoch_t home_std);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 重新计算一行的偏移和有效区间
+ * @param[out] s 行的缓存
+ * @param[in] city 城市
+ * @param[in] home 本地城市
+ * @param[in] home_std 本地标准时间的纪元秒
+ * @return 无
+ */
+static void world_update(World_Slot_t *s, uint8_t city, uint8_t home, Epoch_t home_std)
+{
+    const App_Tzdb_Zone_t *c = app_tzdb_zone(city);
+    int32_t std_diff = (int32_t)(APP_TZDB_UTC_MIN(c) - APP_TZDB_UTC_MIN(app_tzdb_zone(home))) * 60; // 两地标准时间之差 (s)
+    Epoch_t city_std = home_std + (Epoch_t)std_diff;
+    Epoch_t from, until;
+
+    if (!s->valid || s->city != city) {
+        Time_Dst_Cache_Init(&s->dst, c->dst_zone);
+    }
+    s->valid = true;
+    s->city = city;
+    s->home = home;
+    s->offset_s = std_diff;
+    if (Time_Dst_Cache_In(&s->dst, city_std)) {
+        s->offset_s += (int32_t)Time_Dst_Get_Zone(c->dst_zone)->offset_min * 60;
+    }
+
+    Time_Dst_Cache_Span(&s->dst, city_std, &from, &until);
+    if (c->dst_zone == TIME_DST_ZONE_NONE) {
+        s->from = 0;
+        s->until = 0xFFFFFFFFU;
+    } else {
+        s->from = from - (Epoch_t)std_diff;
+        s->until = until - (Epoch_t)std_diff;
+    }
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 获取城市的显示名称
+ * @param[in] city 城市 (时区编号)
+ * @return const char* 名称
+ */
+const char *app_world_city_name(uint8_t city)
+{
+    return app_tzdb_name(city);
+}
+
+/**
+ * @brief 获取城市的坐标和标准时间的 UTC 偏移
+ * @param[in] city 城市
+ * @param[out] lat_d 纬度 (0.1°)
+ * @param[out] lon_d 经度 (0.1°)
+ * @param[out] utc_min UTC 偏移 (分钟)
+ * @return bool city 无效时返回 false
+ */
+bool app_world_city_location(uint8_t city, int16_t *lat_d, int16_t *lon_d, int16_t *utc_min)
+{
+    const App_Tzdb_Zone_t *zone = app_tzdb_zone(city);
+
+    if (zone == NULL) {
+        return false;
+    }
+    *lat_d = zone->lat_d;
+    *lon_d = zone->lon_d;
+    *utc_min = APP_TZDB_UTC_MIN(zone);
+    return true;
+}
+
+/**
+ * @brief 计算世界时钟中一行的本地时间
+ * @param[in] slot 行号
+ * @param[in] home_std 本地标准时间的纪元秒
+ * @param[out] local 该城市的本地时间的纪元秒
+ * @return bool 该行没有城市时返回 false
+ */
+bool app_world_local(uint8_t slot, Epoch_t home_std, Epoch_t *local)
+{
+    World_Slot_t *s;
+    uint8_t city;
+    uint8_t home = g_app_settings.world_home;
+
+    if (slot >= WORLD_SLOT_COUNT) {
+        return false;
+    }
+    city = g_app_settings.world_city[slot];
+    if (app_tzdb_zone(city) == NULL || app_tzdb_zone(home) == NULL) {
+        return false;
+    }
+
+    s = &world_slots[slot];
+    if (!s->valid || s->city != city || s->home != home || home_std < s->from || home_std >= s->until) {
+        world_update(s, city, home, home_std);
+    }
+    *local = home_std + (Epoch_t)s->offset_s;
+    return true;
+}
+
+/** @} */
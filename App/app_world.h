@@ -0,0 +1,60 @@
+/**
+ * @file      app_world.h
+ * @brief     世界时钟头文件
+ * @details   芯片中保存的是本地标准时间，设置中的本地城市 (world_home) 给出它的 UTC 偏移。
+ *            每个城市的时间由同一个缓存的纪元秒加上一个偏移得到：偏移 = 两地标准时间之差 + 该城市的夏令时，
+ *            连同它保持不变的区间 (到下一次夏令时切换或年底) 一起缓存，区间内每秒只需一次比较和一次加法，
+ *            不读取芯片。每个城市有独立的 Time_Dst_Cache_t，切换时刻每年只计算一次。
+ *            城市或本地城市改变后，下一次读取时自动重新计算。
+ *            城市就是内置时区库 (app_tzdb) 中的时区，以时区编号表示。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __APP_WORLD_H
+#define __APP_WORLD_H
+
+#include "app_type.h"
+#include "time_core.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AppWorld 世界时钟
+ * @brief 由本地标准时间推算各城市的本地时间。
+ * @{
+ */
+
+/**
+ * @brief 获取城市的显示名称
+ * @param[in] city 城市 (时区编号)
+ * @return const char* 名称，WORLD_CITY_NONE 和无效值返回 "--"
+ */
+const char *app_world_city_name(uint8_t city);
+
+/**
+ * @brief 获取城市的坐标和标准时间的 UTC 偏移
+ * @details 本地城市 (g_app_settings.world_home) 的坐标同时是日出日落计算 (app_astro) 使用的位置。
+ * @param[in] city 城市 (时区编号)
+ * @param[out] lat_d 纬度 (0.1°，北纬为正)
+ * @param[out] lon_d 经度 (0.1°，东经为正)
+ * @param[out] utc_min 标准时间的 UTC 偏移 (分钟)
+ * @return bool city 无效时返回 false
+ */
+bool app_world_city_location(uint8_t city, int16_t *lat_d, int16_t *lon_d, int16_t *utc_min);
+
+/**
+ * @brief 计算世界时钟中一行的本地时间
+ * @details 城市取自 g_app_settings.world_city[slot]，本地城市取自 g_app_settings.world_home。
+ * @param[in] slot 行号 (0 ~ WORLD_SLOT_COUNT-1)
+ * @param[in] home_std 本地标准时间 (DS3231_GetCachedEpoch) 的纪元秒
+ * @param[out] local 该城市的本地时间 (已应用夏令时) 的纪元秒
+ * @return bool 该行没有城市或 slot 无效时返回 false
+ */
+bool app_world_local(uint8_t slot, Epoch_t home_std, Epoch_t *local);
+
+/** @} */
+
+#endif /* __APP_WORLD_H */
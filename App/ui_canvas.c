@@ -0,0 +1,236 @@
+/**
+ * @file      ui_canvas.c
+ * @brief     离屏画布
+ * @details   画布与绘图缓冲区的布局相同 (每页 128 字节，bit0 为最上一行)，绘制时按 U8G2_FRAME_PAGES 页一段
+ *            把 u8g2 的 tile_buf_ptr 指向画布，位带像素写入和字形缓存都经这个指针寻址，不需要另一个 u8g2 实例。
+ *            视窗的复制与老虎机控件的位图复制相同：起始行与页边界对齐时每列一个字节，
+ *            不对齐时每个目标字节由相邻两页移位拼成。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "ui_canvas.h"
+#include "app_display.h"
+#include <string.h>
+
+/**
+ * @addtogroup UI_Canvas
+ * @{
+ */
+
+#define UI_CANVAS_ACTIVE (UI_CANVAS_ENABLE && U8G2_BUFFER_MODE == 0) ///< 画布是否参与编译
+
+typedef char canvas_pages_check[(UI_CANVAS_PAGES % U8G2_FRAME_PAGES == 0) ? 1 : -1]; ///< 每一段都须在画布之内
+
+/* Private variables ---------------------------------------------------------*/
+#if UI_CANVAS_ACTIVE
+static uint8_t canvas_buf[UI_CANVAS_PAGES][U8G2_FRAME_PAGE_WIDTH]; ///< 画布
+static const void *canvas_owner; ///< 当前内容的使用者，NULL 为无内容
+static uint32_t canvas_key;      ///< 当前内容的键值
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+#if UI_CANVAS_ACTIVE
+static uint8_t UI_Canvas_Byte(int16_t col, int16_t row);
+#endif
+
+/* Private Function implementations ------------------------------------------*/
+
+#if UI_CANVAS_ACTIVE
+/**
+ * @brief 取出画布中从指定行开始的8行
+ * @param[in] col 列
+ * @param[in] row 起始行，可以为负或超出画布，超出的部分为0
+ * @return uint8_t bit0 为第 row 行
+ */
+static uint8_t UI_Canvas_Byte(int16_t col, int16_t row)
+{
+    int16_t page;
+    uint8_t bit;
+    uint8_t v;
+
+    if (row <= -8 || row >= UI_CANVAS_ROWS)
+    {
+        return 0;
+    }
+    if (row < 0)
+    {
+        return (uint8_t)(canvas_buf[0][col] << -row);
+    }
+    page = row >> 3;
+    bit = (uint8_t)(row & 7);
+    v = (uint8_t)(canvas_buf[page][col] >> bit);
+    if (bit != 0 && page + 1 < UI_CANVAS_PAGES)
+    {
+        v |= (uint8_t)(canvas_buf[page + 1][col] << (8 - bit));
+    }
+    return v;
+}
+#endif
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 查询画布是否已是指定的内容
+ * @param[in] owner 使用者
+ * @param[in] key 内容键值
+ * @return bool 已按该使用者和键值绘制返回 true
+ */
+bool UI_Canvas_Ready(const void *owner, uint32_t key)
+{
+#if UI_CANVAS_ACTIVE
+    return canvas_owner != NULL && canvas_owner == owner && canvas_key == key;
+#else
+    (void)owner;
+    (void)key;
+    return false;
+#endif
+}
+
+/**
+ * @brief 绘制画布
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] owner 使用者
+ * @param[in] key 内容键值
+ * @param[in] rows 内容的行数
+ * @param[in] draw 绘制函数
+ * @param[in] ctx 传给绘制函数的上下文
+ * @return bool 已绘制返回 true
+ */
+bool UI_Canvas_Render(u8g2_t *u8g2, const void *owner, uint32_t key, uint16_t rows,
+                      UI_Canvas_Draw_f draw, const void *ctx)
+{
+#if UI_CANVAS_ACTIVE
+    uint8_t *saved_buf = u8g2->tile_buf_ptr;
+    u8g2_uint_t saved_x0 = u8g2->clip_x0;
+    u8g2_uint_t saved_y0 = u8g2->clip_y0;
+    u8g2_uint_t saved_x1 = u8g2->clip_x1;
+    u8g2_uint_t saved_y1 = u8g2->clip_y1;
+    int16_t strip_y0, strip_y1;
+    uint8_t pages = (uint8_t)((rows + 7) / 8);
+
+    if (u8g2->cb != U8G2_R0 || rows > UI_CANVAS_ROWS)
+    {
+        return false;
+    }
+
+    // 段内的绘制不受这一帧局部重绘的裁剪窗口和条带限制
+    Page_Get_Strip(&strip_y0, &strip_y1);
+    Page_Set_Strip(0, U8G2_FRAME_PAGES * 8);
+    u8g2_SetMaxClipWindow(u8g2);
+    memset(canvas_buf, 0, (size_t)pages * U8G2_FRAME_PAGE_WIDTH);
+    for (uint8_t page = 0; page < pages; page += U8G2_FRAME_PAGES)
+    {
+        u8g2->tile_buf_ptr = canvas_buf[page];
+        draw(u8g2, (int16_t)-(page * 8), ctx);
+    }
+    u8g2->tile_buf_ptr = saved_buf;
+    u8g2_SetClipWindow(u8g2, saved_x0, saved_y0, saved_x1, saved_y1);
+    Page_Set_Strip(strip_y0, strip_y1);
+
+    canvas_owner = owner;
+    canvas_key = key;
+    return true;
+#else
+    (void)u8g2;
+    (void)owner;
+    (void)key;
+    (void)rows;
+    (void)draw;
+    (void)ctx;
+    return false;
+#endif
+}
+
+/**
+ * @brief 丢弃画布的内容
+ * @return 无
+ */
+void UI_Canvas_Reset(void)
+{
+#if UI_CANVAS_ACTIVE
+    canvas_owner = NULL;
+#endif
+}
+
+/**
+ * @brief 把画布的一个视窗复制到显存
+ * @details 可见区域取 u8g2 当前条带与裁剪窗口的交集 (user_x0/x1/y0/y1)，与字形缓存相同。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 画布第0列的X坐标
+ * @param[in] y 视窗顶端的Y坐标
+ * @param[in] h 视窗的高度
+ * @param[in] src_y 视窗顶端在画布中的行
+ * @return 无
+ */
+void UI_Canvas_Blit(u8g2_t *u8g2, int16_t x, int16_t y, int16_t h, int16_t src_y)
+{
+#if UI_CANVAS_ACTIVE
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+    if (!u8g2->is_page_clip_window_intersection)
+    {
+        return;
+    }
+#endif
+    int16_t y0 = (y > (int16_t)u8g2->user_y0) ? y : (int16_t)u8g2->user_y0;
+    int16_t y1 = (y + h < (int16_t)u8g2->user_y1) ? y + h : (int16_t)u8g2->user_y1;
+    int16_t c0 = ((int16_t)u8g2->user_x0 > x) ? (int16_t)u8g2->user_x0 - x : 0;
+    int16_t c1 = ((int16_t)u8g2->user_x1 < x + U8G2_FRAME_PAGE_WIDTH) ? (int16_t)u8g2->user_x1 - x
+                                                                      : U8G2_FRAME_PAGE_WIDTH;
+    if (y0 >= y1 || c0 >= c1)
+    {
+        return;
+    }
+
+    int16_t buf_row = (int16_t)u8g2->pixel_curr_row;
+    int16_t page0 = (y0 - buf_row) >> 3;
+    int16_t page1 = (y1 - 1 - buf_row) >> 3;
+    uint16_t stride = u8g2->pixel_buf_width;
+    uint8_t color = u8g2->draw_color;
+
+    for (int16_t page = page0; page <= page1; page++)
+    {
+        int16_t row = buf_row + page * 8; // 本页第0行的屏幕Y坐标
+        int16_t src = src_y + row - y;    // 对应的画布行
+        uint8_t mask = 0xFF;
+        uint8_t *dst = u8g2->tile_buf_ptr + page * stride + x;
+
+        // 去掉可见区域之外的行
+        if (row < y0)
+        {
+            mask &= (uint8_t)(0xFF << (y0 - row));
+        }
+        if (row + 8 > y1)
+        {
+            mask &= (uint8_t)(0xFF >> (row + 8 - y1));
+        }
+
+        for (int16_t c = c0; c < c1; c++)
+        {
+            uint8_t fb = UI_Canvas_Byte(c, src) & mask;
+            if (color == 0)
+            {
+                dst[c] &= (uint8_t)~fb;
+            }
+            else if (color == 1)
+            {
+                dst[c] |= fb;
+            }
+            else
+            {
+                dst[c] ^= fb;
+            }
+        }
+    }
+#else
+    (void)u8g2;
+    (void)x;
+    (void)y;
+    (void)h;
+    (void)src_y;
+#endif
+}
+
+/** @} */
@@ -0,0 +1,99 @@
+/**
+ * @file      ui_canvas.h
+ * @brief     离屏画布头文件
+ * @details   比屏幕更高的内容 (如月历翻月时上下相接的两个月) 先完整绘制到一块离屏画布上，
+ *            之后每一帧只把画布中的一个视窗 (viewport) 复制到显存，上下滚动只是改变视窗的起始行，
+ *            内容本身不再重新绘制。画布按 SSD1306 的页式布局存放，宽度与屏幕相同，高 UI_CANVAS_PAGES 页。
+ *            绘制时把 u8g2 的绘图缓冲区指针临时指向画布的一段 (每段与屏幕同高)，页面原有的绘制函数
+ *            (u8g2、字形缓存、Page_Invert_Rect) 不需要修改，只是按段传入不同的Y偏移。
+ *            整屏的上下滚动由页面管理器用 SSD1306 的显示起始行完成 (PAGE_TRANS_HW_SCROLL)，
+ *            起始行移动的是整块屏幕，页面内固定的标题等区域不能随之滚动，本控件用于这种局部的视窗。
+ *            同一时刻只有一个使用者，画布以使用者指针和键值标识当前内容。
+ *            UI_CANVAS_ENABLE 为 0 (默认，画布占用 UI_CANVAS_PAGES * 128 字节 RAM) 或分页显存模式下
+ *            UI_Canvas_Render 返回 false，页面按原方式逐帧绘制。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __UI_CANVAS_H
+#define __UI_CANVAS_H
+
+#include "u8g2.h"
+#include "u8g2_stm32_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup UI_Canvas 离屏画布
+ * @brief 绘制一次、逐帧只复制视窗的滚动内容。
+ * @{
+ */
+
+/**
+ * @defgroup UI_Canvas_Config 离屏画布配置
+ * @{
+ */
+#ifndef UI_CANVAS_ENABLE
+#define UI_CANVAS_ENABLE 0  ///< 为 1 时启用离屏画布 (仅整帧显存模式)
+#endif
+#define UI_CANVAS_PAGES  16 ///< 画布的高度 (8像素一页，16页为 128x128)
+#define UI_CANVAS_ROWS   (UI_CANVAS_PAGES * 8) ///< 画布的行数
+/** @} */
+
+/**
+ * @brief 画布内容的绘制函数
+ * @details 与页面的 draw 相同地使用 u8g2 绘制，画布第0行位于屏幕坐标 top 处。
+ *          每次调用只有与屏幕同高的一段可见，其余部分被裁剪。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] top 画布第0行的Y坐标
+ * @param[in] ctx UI_Canvas_Render 传入的上下文
+ */
+typedef void (*UI_Canvas_Draw_f)(u8g2_t *u8g2, int16_t top, const void *ctx);
+
+/**
+ * @brief 查询画布是否已是指定的内容
+ * @param[in] owner 使用者 (通常为页面实例)
+ * @param[in] key 使用者定义的内容键值
+ * @return bool 已按该使用者和键值绘制返回 true，此时不需要重新调用 UI_Canvas_Render
+ */
+bool UI_Canvas_Ready(const void *owner, uint32_t key);
+
+/**
+ * @brief 绘制画布
+ * @details 清空画布的前 rows 行后按段调用 draw，期间裁剪窗口为整个屏幕，条带覆盖整段，结束后恢复。
+ *          须在页面的 draw 中调用 (绘图缓冲区中正在生成一帧)。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] owner 使用者
+ * @param[in] key 内容键值，之后 UI_Canvas_Ready(owner, key) 返回 true
+ * @param[in] rows 内容的行数，不超过 UI_CANVAS_ROWS
+ * @param[in] draw 绘制函数
+ * @param[in] ctx 传给绘制函数的上下文
+ * @return bool 已绘制返回 true；未启用、分页显存模式、显示器旋转或 rows 过大时返回 false，由调用者逐帧绘制
+ */
+bool UI_Canvas_Render(u8g2_t *u8g2, const void *owner, uint32_t key, uint16_t rows,
+                      UI_Canvas_Draw_f draw, const void *ctx);
+
+/**
+ * @brief 丢弃画布的内容
+ * @return 无
+ */
+void UI_Canvas_Reset(void);
+
+/**
+ * @brief 把画布的一个视窗复制到显存
+ * @details 画布第 src_y 行起的 h 行写到屏幕第 y 行起，画布第0列位于屏幕X坐标 x。
+ *          以透明方式写入，遵守当前的裁剪窗口和绘图颜色。画布之外的行为空。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 画布第0列的X坐标
+ * @param[in] y 视窗顶端的Y坐标
+ * @param[in] h 视窗的高度
+ * @param[in] src_y 视窗顶端在画布中的行，可为负
+ * @return 无
+ */
+void UI_Canvas_Blit(u8g2_t *u8g2, int16_t x, int16_t y, int16_t h, int16_t src_y);
+
+/** @} */
+
+#endif /* __UI_CANVAS_H */
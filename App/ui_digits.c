@@ -0,0 +1,105 @@
+/**
+ * @file      ui_digits.c
+ * @brief     逐字符局部刷新的大号数字
+ * @details   更新时从两端向中间比较新旧文字，得到变化的字符范围 [i0, i1)，
+ *            按上一次绘制时记录的字符位置使这一段失效。每个字符单独经字形缓存绘制，
+ *            绘制时顺便记录位置，供下一次更新使用。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "ui_digits.h"
+#include "app_glyph_cache.h"
+#include <string.h>
+
+/**
+ * @addtogroup UI_Digits
+ * @{
+ */
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 初始化显示状态
+ * @param[out] d 显示状态
+ * @param[in] top 失效区域的顶端Y坐标
+ * @param[in] h 失效区域的高度
+ * @return 无
+ */
+void UI_Digits_Init(UI_Digits_t *d, uint8_t top, uint8_t h)
+{
+    d->text[0] = '\0';
+    d->drawn = 0;
+    d->top = top;
+    d->h = h;
+}
+
+/**
+ * @brief 更新文字，并使变化的字符失效
+ * @param[in,out] d 显示状态
+ * @param[in] page 所属页面
+ * @param[in] text 新的文字
+ * @return 无
+ */
+void UI_Digits_Set(UI_Digits_t *d, const Page_Base *page, const char *text)
+{
+    size_t n = strlen(text);
+    uint8_t len = (uint8_t)((n > UI_DIGITS_MAX) ? UI_DIGITS_MAX : n);
+
+    if (d->drawn != 0 && d->drawn == len)
+    {
+        // 通常只有最后一两位变化，只刷新变化的那几个字符
+        uint8_t i0 = 0, i1 = len;
+        while (i0 < i1 && text[i0] == d->text[i0]) i0++;
+        while (i1 > i0 && text[i1 - 1] == d->text[i1 - 1]) i1--;
+        if (i0 < i1)
+        {
+            int16_t x0 = d->x[i0] - UI_DIGITS_PAD;
+            int16_t x1 = d->x[i1] + UI_DIGITS_PAD;
+            Page_Invalidate_Rect(page, x0, d->top, x1 - x0, d->h);
+        }
+    }
+    else if (d->drawn != 0 || len != strlen(d->text) || memcmp(text, d->text, len) != 0)
+    {
+        Page_Invalidate_Rect(page, 0, d->top, 128, d->h);
+    }
+    memcpy(d->text, text, len);
+    d->text[len] = '\0';
+}
+
+/**
+ * @brief 绘制文字，并记录各字符的位置
+ * @param[in,out] d 显示状态
+ * @param[in] page 所属页面
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 左端X坐标
+ * @param[in] y 基线Y坐标
+ * @param[in] x_offset X方向偏移
+ * @param[in] y_offset Y方向偏移
+ * @return 无
+ */
+void UI_Digits_Draw(UI_Digits_t *d, const Page_Base *page, u8g2_t *u8g2, int16_t x, int16_t y,
+                    int16_t x_offset, int16_t y_offset)
+{
+    uint8_t len = (uint8_t)strlen(d->text);
+    bool moved = d->drawn == len && d->x[0] != x;
+    char ch[2] = {0, 0};
+
+    for (uint8_t i = 0; i < len; i++)
+    {
+        d->x[i] = (uint8_t)x;
+        ch[0] = d->text[i];
+        x += Glyph_Cache_DrawStr(u8g2, x + x_offset, y + y_offset, ch);
+    }
+    d->x[len] = (uint8_t)x;
+    d->drawn = len;
+    if (moved)
+    {
+        // 整串移动后局部区域之外的旧像素需要在下一帧补刷
+        Page_Invalidate_Rect(page, 0, d->top, 128, d->h);
+    }
+}
+
+/** @} */
@@ -0,0 +1,83 @@
+/**
+ * @file      ui_digits.h
+ * @brief     逐字符局部刷新的大号数字头文件
+ * @details   秒表、倒计时这类每 10ms 变化一次的大号数字，每次通常只有最后一两位变化。
+ *            本控件记住上一次绘制的文字和各字符的X坐标，文字更新时只使变化的那几个字符所在的列失效，
+ *            页面管理器只重绘并发送这几个字符的区域 (整帧模式下按页只发送变化的字节)。
+ *            字符经字形缓存逐个绘制，缓存之外的字符 (如 '.') 由字形缓存自动回退到 u8g2_DrawStr。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __UI_DIGITS_H
+#define __UI_DIGITS_H
+
+#include "app_display.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup UI_Digits 大号数字
+ * @brief 逐字符失效的大号数字控件。
+ * @{
+ */
+
+/**
+ * @defgroup UI_Digits_Config 大号数字配置
+ * @{
+ */
+#define UI_DIGITS_MAX 9 ///< 文字的最大长度 (字符)
+#define UI_DIGITS_PAD 2 ///< 局部刷新时左右多留的像素，覆盖字形超出步进宽度的部分
+/** @} */
+
+/**
+ * @brief 大号数字的显示状态，放在页面私有数据中
+ */
+typedef struct
+{
+    char text[UI_DIGITS_MAX + 1];  ///< 当前文字
+    uint8_t x[UI_DIGITS_MAX + 1];  ///< 上一次绘制时各字符的起始X坐标 (不含偏移，最后一项为右端)
+    uint8_t drawn;                 ///< x 中的字符数，0 表示尚未绘制
+    uint8_t top;                   ///< 失效区域的顶端Y坐标
+    uint8_t h;                     ///< 失效区域的高度
+} UI_Digits_t;
+
+/**
+ * @brief 初始化显示状态
+ * @param[out] d 显示状态
+ * @param[in] top 失效区域的顶端Y坐标 (包含字形的全部行)
+ * @param[in] h 失效区域的高度
+ * @return 无
+ */
+void UI_Digits_Init(UI_Digits_t *d, uint8_t top, uint8_t h);
+
+/**
+ * @brief 更新文字，并使变化的字符失效
+ * @details 与上一次绘制的文字长度相同时只使变化的字符失效；长度不同或尚未绘制时使整行失效。
+ * @param[in,out] d 显示状态
+ * @param[in] page 所属页面
+ * @param[in] text 新的文字，超过 UI_DIGITS_MAX 的部分被截断
+ * @return 无
+ */
+void UI_Digits_Set(UI_Digits_t *d, const Page_Base *page, const char *text);
+
+/**
+ * @brief 绘制文字，并记录各字符的位置
+ * @details 须已设置好字体。整串比上一次绘制时移动 (比例字体下宽度变化) 时补刷整行。
+ * @param[in,out] d 显示状态
+ * @param[in] page 所属页面
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 左端X坐标 (不含偏移)
+ * @param[in] y 基线Y坐标 (不含偏移)
+ * @param[in] x_offset X方向偏移
+ * @param[in] y_offset Y方向偏移
+ * @return 无
+ */
+void UI_Digits_Draw(UI_Digits_t *d, const Page_Base *page, u8g2_t *u8g2, int16_t x, int16_t y,
+                    int16_t x_offset, int16_t y_offset);
+
+/** @} */
+
+#endif /* __UI_DIGITS_H */
@@ -0,0 +1,1063 @@
+/**
+ * @file      ui_face.c
+ * @brief     数据驱动的表盘
+ * @details   更新时先把全部数据源格式化到栈上，与显示状态中上一次的文字逐个比较，
+ *            得到变化的数据源集合 (每个数据源一位)，再遍历字段表使绑定到这些数据源的字段失效。
+ *            绘制时按字段表顺序绘制，相邻字段字体相同时不重复设置。
+ *            指针表盘的端点由60项的Q15正弦表换算，用整数 Bresenham 算法画线，
+ *            同一行 (列) 上连续的像素合并为一条水平 (竖直) 线；只有秒针移动时
+ *            只使新旧两个秒针位置的外接矩形失效。
+ *            秒进度圆环的像素顺序由中点画圆算法得到的八分圆表 (每列一个Y值) 按八个对称方向展开，从12点顺时针排列，
+ *            横条则从左到右；更新时只使新增像素的外接矩形失效，绘制时只画已覆盖的像素，分钟翻转时整个字段清除一次。
+ *            翻页动画只记下变化的字符和开始时刻，动画期间每次更新使这几个字符失效，
+ *            绘制时由字形缓存按进度合成新旧两个字形 (Glyph_Cache_DrawFlip)，表盘其余部分不重绘。
+ *            UI_FACE_PAGE_ALIGN 为 1 时大号数字的基线按字体外框对齐到页边界，失效区域和灰度区域
+ *            取外框所占的整页，而不是字段表中的失效区域。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.1
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "ui_face.h"
+#include "app_type.h"
+#include "app_glyph_cache.h"
+#include "app_anim.h"
+#include "app_fmt.h"
+#include "app_astro.h"
+#include "app_lunar.h"
+#include <string.h>
+
+/**
+ * @addtogroup UI_Face
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define UI_FACE_DIGIT_PAD 2    ///< 局部刷新大号数字时左右多留的像素，覆盖字形超出步进宽度的部分
+#define UI_FACE_ALL       0xFFFF ///< 全部数据源都视为变化
+#define UI_FACE_BIT(src)  (1U << (src)) ///< 数据源在变化集合中的位
+#define UI_FACE_I18N(src) ((src) == UI_FACE_SRC_WEEK || (src) == UI_FACE_SRC_LUNAR) ///< 按界面语言绘制的数据源
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief 数字表盘：大号时间、分割线和秒进度横条、星期和日期、温湿度
+ */
+static const UI_Face_Field_t face_digital[] = {
+    {UI_FACE_DIGITS, UI_FACE_SRC_TIME, UI_FACE_CENTER, 64, 28, 0, CLOCK_FONT, NULL, UI_FACE_BOX(0, 0, 128, 32)},
+    {UI_FACE_HLINE, UI_FACE_SRC_NONE, UI_FACE_LEFT, 0, 36, 128, NULL, NULL, UI_FACE_BOX(0, 36, 128, 1)},
+    {UI_FACE_BAR, UI_FACE_SRC_NONE, UI_FACE_LEFT, 0, 38, 128, NULL, NULL, UI_FACE_BOX(0, 38, 128, 1)},
+    {UI_FACE_TEXT, UI_FACE_SRC_WEEK, UI_FACE_LEFT, 2, 50, 0, DATE_TEMP_FONT, NULL, UI_FACE_BOX(0, 40, 64, 13)},
+    {UI_FACE_TEXT, UI_FACE_SRC_DATE, UI_FACE_RIGHT, 126, 50, 0, DATE_TEMP_FONT, NULL, UI_FACE_BOX(64, 40, 64, 13)},
+    {UI_FACE_TEXT, UI_FACE_SRC_TEMP, UI_FACE_LEFT, 2, 62, 0, DATE_TEMP_FONT, "T:", UI_FACE_BOX(0, 53, 62, 11)},
+    {UI_FACE_TEXT, UI_FACE_SRC_HUMI, UI_FACE_LEFT, 62, 62, 0, DATE_TEMP_FONT, "H:", UI_FACE_BOX(62, 53, 66, 11)},
+};
+
+/**
+ * @brief 指针表盘：左侧表盘和外圈的秒进度圆环，右侧为星期、日期 (月-日) 和温湿度
+ */
+static const UI_Face_Field_t face_analog[] = {
+    {UI_FACE_DIAL, UI_FACE_SRC_TIME, UI_FACE_LEFT, 32, 32, 30, NULL, NULL, UI_FACE_BOX(0, 0, 64, 64)},
+    {UI_FACE_ARC, UI_FACE_SRC_NONE, UI_FACE_LEFT, 32, 32, 31, NULL, NULL, UI_FACE_BOX(0, 0, 64, 64)},
+    {UI_FACE_TEXT, UI_FACE_SRC_WEEK, UI_FACE_LEFT, 72, 14, 0, DATE_TEMP_FONT, NULL, UI_FACE_BOX(66, 0, 62, 16)},
+    {UI_FACE_TEXT, UI_FACE_SRC_DATE_MD, UI_FACE_LEFT, 72, 28, 0, DATE_TEMP_FONT, NULL, UI_FACE_BOX(66, 16, 62, 16)},
+    {UI_FACE_TEXT, UI_FACE_SRC_TEMP, UI_FACE_LEFT, 72, 46, 0, DATE_TEMP_FONT, "T:", UI_FACE_BOX(66, 36, 62, 12)},
+    {UI_FACE_TEXT, UI_FACE_SRC_HUMI, UI_FACE_LEFT, 72, 60, 0, DATE_TEMP_FONT, "H:", UI_FACE_BOX(66, 50, 62, 14)},
+};
+
+/**
+ * @brief 简洁表盘：只有时、分、日期和农历 (只在中文界面显示)，每分钟刷新一次
+ */
+static const UI_Face_Field_t face_simple[] = {
+    {UI_FACE_DIGITS, UI_FACE_SRC_TIME_HM, UI_FACE_CENTER, 64, 32, 0, CLOCK_FONT, NULL, UI_FACE_BOX(0, 4, 128, 32)},
+    {UI_FACE_TEXT, UI_FACE_SRC_DATE, UI_FACE_CENTER, 64, 49, 0, DATE_TEMP_FONT, NULL, UI_FACE_BOX(0, 39, 128, 12)},
+    {UI_FACE_TEXT, UI_FACE_SRC_LUNAR, UI_FACE_CENTER, 64, 63, 0, DATE_TEMP_FONT, NULL, UI_FACE_BOX(0, 52, 128, 12)},
+};
+
+/**
+ * @brief 日月表盘：时、分，日出日落和日期 (月-日)，月相；天文信息每天只计算和重绘一次
+ */
+static const UI_Face_Field_t face_astro[] = {
+    {UI_FACE_DIGITS, UI_FACE_SRC_TIME_HM, UI_FACE_CENTER, 64, 28, 0, CLOCK_FONT, NULL, UI_FACE_BOX(0, 0, 128, 32)},
+    {UI_FACE_HLINE, UI_FACE_SRC_NONE, UI_FACE_LEFT, 0, 36, 128, NULL, NULL, UI_FACE_BOX(0, 36, 128, 1)},
+    {UI_FACE_TEXT, UI_FACE_SRC_SUN, UI_FACE_LEFT, 2, 50, 0, DATE_TEMP_FONT, NULL, UI_FACE_BOX(0, 40, 90, 13)},
+    {UI_FACE_TEXT, UI_FACE_SRC_DATE_MD, UI_FACE_RIGHT, 126, 50, 0, DATE_TEMP_FONT, NULL, UI_FACE_BOX(90, 40, 38, 13)},
+    {UI_FACE_TEXT, UI_FACE_SRC_MOON, UI_FACE_LEFT, 2, 62, 0, DATE_TEMP_FONT, NULL, UI_FACE_BOX(0, 53, 128, 11)},
+};
+
+#define UI_FACE_DEF(str, fields) {str, fields, (uint8_t)(sizeof(fields) / sizeof(fields[0]))}
+
+/**
+ * @brief 全部表盘，按 Clock_Face_e 的顺序
+ */
+static const UI_Face_t ui_faces[] = {
+    [CLOCK_FACE_DIGITAL] = UI_FACE_DEF(STR_FACE_DIGITAL, face_digital),
+    [CLOCK_FACE_ANALOG] = UI_FACE_DEF(STR_FACE_ANALOG, face_analog),
+    [CLOCK_FACE_SIMPLE] = UI_FACE_DEF(STR_FACE_SIMPLE, face_simple),
+    [CLOCK_FACE_ASTRO] = UI_FACE_DEF(STR_FACE_ASTRO, face_astro),
+};
+
+typedef char ui_faces_check[(sizeof(ui_faces) / sizeof(ui_faces[0]) == CLOCK_FACE_COUNT) ? 1 : -1];
+
+/**
+ * @brief 60等分圆周的正弦表 (Q15)
+ * @details 第 i 项为 sin(i * 6°) * 32767，余弦取第 (i + 15) % 60 项。
+ *          位置 0 指向12点，顺时针增加，与秒、分的数值一致。
+ */
+static const int16_t face_sin_q15[60] = {
+    0, 3425, 6813, 10126, 13328, 16383, 19260, 21925, 24351, 26509,
+    28377, 29934, 31163, 32051, 32587, 32767, 32587, 32051, 31163, 29934,
+    28377, 26509, 24351, 21925, 19260, 16383, 13328, 10126, 6813, 3425,
+    0, -3425, -6813, -10126, -13328, -16383, -19260, -21925, -24351, -26509,
+    -28377, -29934, -31163, -32051, -32587, -32767, -32587, -32051, -31163, -29934,
+    -28377, -26509, -24351, -21925, -19260, -16383, -13328, -10126, -6813, -3425,
+};
+
+static int16_t dial_r;         ///< 正在绘制的指针表盘的刻度半径
+static uint8_t dial_hands[3];  ///< 时、分、秒针的位置 (0~59)，分页模式下录制为位图命令，回放时从这里读取
+
+static uint8_t arc_oct[UI_FACE_ARC_R_MAX * 3 / 4]; ///< 八分圆表：12点到1点半之间第 i 列 (X = i) 的像素到圆心的Y距离
+static uint8_t arc_n;                              ///< arc_oct 的项数
+static int16_t arc_r = -1;                         ///< arc_oct 对应的半径，-1 表示尚未生成
+static const UI_Face_Field_t *sweep_field;         ///< 正在绘制的秒进度字段，分页模式下回放时从这里读取
+static uint8_t sweep_count;                        ///< 正在绘制的秒进度已覆盖的像素数
+
+/* Private function prototypes -----------------------------------------------*/
+static int16_t UI_Face_Digits_Row(const UI_Face_Field_t *f, int16_t *row, int16_t *rows);
+static void UI_Face_Invalidate_Box(const UI_Face_State_t *st, const UI_Face_Field_t *f, const Page_Base *page);
+static void UI_Face_Invalidate_Chars(const UI_Face_State_t *st, const UI_Face_Field_t *f, const Page_Base *page,
+                                     uint8_t i0, uint8_t i1);
+#if UI_FACE_FLIP_ENABLE
+static void UI_Face_Invalidate_Flip(const UI_Face_State_t *st, const UI_Face_Field_t *f, const Page_Base *page);
+#endif
+static const char *UI_Face_Text(const UI_Face_State_t *st, uint8_t src, char *buf);
+static int16_t UI_Face_Align(const UI_Face_Field_t *f, int16_t w);
+static void UI_Face_Point(uint8_t pos, int16_t len, int16_t *x, int16_t *y);
+static void UI_Face_Invalidate_Sec(const UI_Face_State_t *st, const UI_Face_Field_t *f, const Page_Base *page,
+                                   uint8_t pos);
+static void UI_Face_Line(u8g2_t *u8g2, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+static void UI_Face_Dial_Blit(u8g2_t *u8g2, int16_t x, int16_t top);
+static void UI_Face_Draw_Digits(UI_Face_State_t *st, const UI_Face_Field_t *f, const Page_Base *page,
+                                u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+static void UI_Face_Draw_Dial(const UI_Face_State_t *st, const UI_Face_Field_t *f, u8g2_t *u8g2,
+                              int16_t x_offset, int16_t y_offset);
+static void UI_Face_Arc_Table(int16_t r);
+static uint8_t UI_Face_Sweep_Total(const UI_Face_Field_t *f);
+static void UI_Face_Sweep_Pixel(const UI_Face_Field_t *f, uint8_t k, int16_t *x, int16_t *y);
+static void UI_Face_Sweep_Blit(u8g2_t *u8g2, int16_t x, int16_t top);
+static void UI_Face_Draw_Sweep(const UI_Face_State_t *st, const UI_Face_Field_t *f, u8g2_t *u8g2,
+                               int16_t x_offset, int16_t y_offset);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 大号数字字段的基线和所占的行
+ * @details UI_FACE_PAGE_ALIGN 为 1 且字体已缓存时，基线移到外框顶端所在的页边界，
+ *          所占的行是外框覆盖的整页；否则为字段表中的基线和失效区域。
+ * @param[in] f 大号数字字段
+ * @param[out] row 所占的第一行 (页的倍数)
+ * @param[out] rows 所占的行数 (页的倍数)
+ * @return int16_t 基线Y坐标
+ */
+static int16_t UI_Face_Digits_Row(const UI_Face_Field_t *f, int16_t *row, int16_t *rows)
+{
+    *row = f->box.page * 8;
+    *rows = f->box.pages * 8;
+#if UI_FACE_PAGE_ALIGN
+    int8_t top;
+    uint8_t height;
+    if (Glyph_Cache_Font_Box(f->font, &top, &height))
+    {
+        int16_t y = Glyph_Cache_Page_Baseline(f->y, top);
+        *row = y + top;
+        *rows = (int16_t)((height + 7) & ~7);
+        return y;
+    }
+#endif
+    return f->y;
+}
+
+/**
+ * @brief 使字段的整个失效区域失效
+ * @param[in] st 显示状态 (提供防烧屏偏移)
+ * @param[in] f 字段
+ * @param[in] page 所属页面
+ * @return 无
+ */
+static void UI_Face_Invalidate_Box(const UI_Face_State_t *st, const UI_Face_Field_t *f, const Page_Base *page)
+{
+    int16_t row = f->box.page * 8;
+    int16_t rows = f->box.pages * 8;
+
+    if (f->kind == UI_FACE_DIGITS)
+    {
+        (void)UI_Face_Digits_Row(f, &row, &rows);
+    }
+    Page_Invalidate_Rect(page, f->box.x + st->dx, row + st->dy, f->box.w, rows);
+}
+
+/**
+ * @brief 使大号数字中第 i0 到第 i1 个字符 (不包含) 失效
+ * @details 按上一次绘制时记录的字符位置，左右各多留 UI_FACE_DIGIT_PAD 像素。
+ * @param[in] st 显示状态
+ * @param[in] f 大号数字字段
+ * @param[in] page 所属页面
+ * @param[in] i0 第一个字符
+ * @param[in] i1 最后一个字符之后 (不超过 digit_len)
+ * @return 无
+ */
+static void UI_Face_Invalidate_Chars(const UI_Face_State_t *st, const UI_Face_Field_t *f, const Page_Base *page,
+                                     uint8_t i0, uint8_t i1)
+{
+    int16_t x0 = st->digit_x[i0] - UI_FACE_DIGIT_PAD;
+    int16_t x1 = st->digit_x[i1] + UI_FACE_DIGIT_PAD;
+    int16_t row, rows;
+    (void)UI_Face_Digits_Row(f, &row, &rows);
+    Page_Invalidate_Rect(page, x0 + st->dx, row + st->dy, x1 - x0, rows);
+}
+
+#if UI_FACE_FLIP_ENABLE
+/**
+ * @brief 使正在翻页的字符失效
+ * @param[in] st 显示状态
+ * @param[in] f 大号数字字段
+ * @param[in] page 所属页面
+ * @return 无
+ */
+static void UI_Face_Invalidate_Flip(const UI_Face_State_t *st, const UI_Face_Field_t *f, const Page_Base *page)
+{
+    uint8_t i0 = 0, i1 = st->digit_len;
+
+    while (i0 < i1 && !(st->flip_mask & (1U << i0))) i0++;
+    while (i1 > i0 && !(st->flip_mask & (1U << (i1 - 1)))) i1--;
+    if (i0 < i1)
+    {
+        UI_Face_Invalidate_Chars(st, f, page, i0, i1);
+    }
+}
+#endif
+
+/**
+ * @brief 获取数据源当前显示的文字
+ * @param[in] st 显示状态
+ * @param[in] src 数据源
+ * @param[out] buf 需要截取时使用的缓冲区 (至少6字节)
+ * @return const char* 文字
+ */
+static const char *UI_Face_Text(const UI_Face_State_t *st, uint8_t src, char *buf)
+{
+    switch (src)
+    {
+    case UI_FACE_SRC_TIME:
+        return st->time;
+    case UI_FACE_SRC_TIME_HM:
+        memcpy(buf, st->time, 5);
+        buf[5] = '\0';
+        return buf;
+    case UI_FACE_SRC_DATE:
+        return st->date;
+    case UI_FACE_SRC_DATE_MD:
+        return st->date + 5; // 跳过 "YYYY-"
+    case UI_FACE_SRC_WEEK:
+        return (st->week != 0) ? app_str((App_Str_t)(STR_WEEK_MON + st->week - 1)) : "";
+    case UI_FACE_SRC_TEMP:
+        return st->temp;
+    case UI_FACE_SRC_HUMI:
+        return st->humi;
+    case UI_FACE_SRC_SUN:
+        return app_astro_sun_text();
+    case UI_FACE_SRC_MOON:
+        return app_astro_moon_text();
+    case UI_FACE_SRC_LUNAR:
+        return app_lunar_text();
+    default:
+        return "";
+    }
+}
+
+/**
+ * @brief 按对齐方式计算文字的左端X坐标
+ * @param[in] f 字段
+ * @param[in] w 文字宽度
+ * @return int16_t 左端X坐标
+ */
+static int16_t UI_Face_Align(const UI_Face_Field_t *f, int16_t w)
+{
+    if (f->align == UI_FACE_CENTER)
+    {
+        return f->x - w / 2;
+    }
+    if (f->align == UI_FACE_RIGHT)
+    {
+        return f->x - w;
+    }
+    return f->x;
+}
+
+/**
+ * @brief 计算指针表盘上一个位置相对圆心的偏移
+ * @param[in] pos 位置 (0~59，0 指向12点)
+ * @param[in] len 到圆心的距离 (像素)
+ * @param[out] x X方向偏移
+ * @param[out] y Y方向偏移
+ * @return 无
+ */
+static void UI_Face_Point(uint8_t pos, int16_t len, int16_t *x, int16_t *y)
+{
+    *x = (int16_t)(((int32_t)len * face_sin_q15[pos] + 0x4000) >> 15);
+    *y = (int16_t)-(((int32_t)len * face_sin_q15[(pos + 15) % 60] + 0x4000) >> 15);
+}
+
+/**
+ * @brief 使秒针在一个位置上覆盖的区域失效
+ * @details 取秒针两端的外接矩形并向外多留1像素，重绘时该区域内的刻度和其他指针一并补画。
+ * @param[in] st 显示状态 (提供防烧屏偏移)
+ * @param[in] f 指针表盘字段
+ * @param[in] page 所属页面
+ * @param[in] pos 秒针位置 (0~59)
+ * @return 无
+ */
+static void UI_Face_Invalidate_Sec(const UI_Face_State_t *st, const UI_Face_Field_t *f, const Page_Base *page,
+                                   uint8_t pos)
+{
+    int16_t x0, y0, x1, y1;
+
+    UI_Face_Point(pos, f->w - 4, &x0, &y0);
+    UI_Face_Point((uint8_t)((pos + 30) % 60), f->w / 5, &x1, &y1);
+    if (x0 > x1)
+    {
+        int16_t t = x0; x0 = x1; x1 = t;
+    }
+    if (y0 > y1)
+    {
+        int16_t t = y0; y0 = y1; y1 = t;
+    }
+    Page_Invalidate_Rect(page, f->x + x0 - 1 + st->dx, f->y + y0 - 1 + st->dy, x1 - x0 + 3, y1 - y0 + 3);
+}
+
+/**
+ * @brief 用整数 Bresenham 算法画线
+ * @details 沿主方向逐像素推进，同一行 (或同一列) 上连续的像素合并为一条水平线 (或竖直线) 绘制，
+ *          指针接近水平或竖直时只需几次绘制调用。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x0 起点X坐标
+ * @param[in] y0 起点Y坐标
+ * @param[in] x1 终点X坐标
+ * @param[in] y1 终点Y坐标
+ * @return 无
+ */
+static void UI_Face_Line(u8g2_t *u8g2, int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    int16_t dx = x1 - x0;
+    int16_t dy = y1 - y0;
+    int16_t adx = dx < 0 ? -dx : dx;
+    int16_t ady = dy < 0 ? -dy : dy;
+
+    if (adx >= ady)
+    {
+        // X为主方向：从左向右推进，每行一条水平线
+        if (dx < 0)
+        {
+            x0 = x1;
+            y0 = y1;
+            x1 = x0 + adx;
+            dy = -dy;
+        }
+        int16_t sy = dy < 0 ? -1 : 1;
+        int16_t err = adx / 2;
+        int16_t run = x0;
+        for (int16_t x = x0; x <= x1; x++)
+        {
+            err -= ady;
+            if (err < 0 || x == x1)
+            {
+                u8g2_DrawHLine(u8g2, run, y0, x - run + 1);
+                run = x + 1;
+                y0 += sy;
+                err += adx;
+            }
+        }
+    }
+    else
+    {
+        // Y为主方向：从上向下推进，每列一条竖直线
+        if (dy < 0)
+        {
+            x0 = x1;
+            y0 = y1;
+            y1 = y0 + ady;
+            dx = -dx;
+        }
+        int16_t sx = dx < 0 ? -1 : 1;
+        int16_t err = ady / 2;
+        int16_t run = y0;
+        for (int16_t y = y0; y <= y1; y++)
+        {
+            err -= adx;
+            if (err < 0 || y == y1)
+            {
+                u8g2_DrawVLine(u8g2, x0, run, y - run + 1);
+                run = y + 1;
+                x0 += sx;
+                err += ady;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 绘制指针表盘的刻度和指针
+ * @details 半径和指针位置取自 dial_r、dial_hands。分页模式下作为位图命令录制，
+ *          回放时在每个条带中调用，条带之外的像素由 u8g2 裁掉。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 圆心X坐标
+ * @param[in] top 表盘区域顶端Y坐标 (圆心上方 dial_r + 1 行)
+ * @return 无
+ */
+static void UI_Face_Dial_Blit(u8g2_t *u8g2, int16_t x, int16_t top)
+{
+    int16_t cy = top + dial_r + 1;
+    int16_t x0, y0, x1, y1;
+
+    // 刻度：每5分钟一个，3、6、9、12点更长
+    for (uint8_t pos = 0; pos < 60; pos += 5)
+    {
+        UI_Face_Point(pos, dial_r, &x0, &y0);
+        UI_Face_Point(pos, (pos % 15 == 0) ? dial_r - 5 : dial_r - 2, &x1, &y1);
+        UI_Face_Line(u8g2, x + x0, cy + y0, x + x1, cy + y1);
+    }
+
+    // 时针加粗一像素 (沿次方向平移后再画一次)
+    UI_Face_Point(dial_hands[0], dial_r / 2, &x1, &y1);
+    UI_Face_Line(u8g2, x, cy, x + x1, cy + y1);
+    if (face_sin_q15[dial_hands[0]] > 23170 || face_sin_q15[dial_hands[0]] < -23170) // |sin| > sin45°，接近水平
+    {
+        UI_Face_Line(u8g2, x, cy + 1, x + x1, cy + y1 + 1);
+    }
+    else
+    {
+        UI_Face_Line(u8g2, x + 1, cy, x + x1 + 1, cy + y1);
+    }
+
+    UI_Face_Point(dial_hands[1], dial_r * 3 / 4, &x1, &y1);
+    UI_Face_Line(u8g2, x, cy, x + x1, cy + y1);
+
+    UI_Face_Point(dial_hands[2], dial_r - 4, &x0, &y0);
+    UI_Face_Point((uint8_t)((dial_hands[2] + 30) % 60), dial_r / 5, &x1, &y1);
+    UI_Face_Line(u8g2, x + x1, cy + y1, x + x0, cy + y0);
+
+    u8g2_DrawBox(u8g2, x - 1, cy - 1, 3, 3);
+}
+
+/**
+ * @brief 绘制大号数字字段
+ * @details 逐字符绘制并记录各字符的位置，供下一次更新只刷新变化的字符。
+ * @param[in,out] st 显示状态
+ * @param[in] f 字段
+ * @param[in] page 所属页面
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset X方向偏移
+ * @param[in] y_offset Y方向偏移
+ * @return 无
+ */
+static void UI_Face_Draw_Digits(UI_Face_State_t *st, const UI_Face_Field_t *f, const Page_Base *page,
+                                u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    char buf[6];
+    const char *text = UI_Face_Text(st, f->source, buf);
+    uint8_t len = (uint8_t)strlen(text);
+    // 大号数字走字形缓存，避免每帧重新查表解码
+    int16_t x = UI_Face_Align(f, (int16_t)Glyph_Cache_GetStrWidth(u8g2, text));
+    int16_t row, rows;
+    int16_t y = UI_Face_Digits_Row(f, &row, &rows) + y_offset;
+
+    if (len >= sizeof(st->digit_x))
+    {
+        st->digit_len = 0;
+        Glyph_Cache_DrawStr(u8g2, x + x_offset, y, text);
+        return;
+    }
+
+    bool moved = st->digit_len == len && st->digit_x[0] != x;
+    char ch[2] = {0, 0};
+#if UI_FACE_FLIP_ENABLE
+    uint32_t phase = (uint32_t)Anim_Ease(ANIM_EASE_IN_QUAD, Anim_Progress(Page_Now() - st->flip_start, UI_FACE_FLIP_MS));
+#endif
+    for (uint8_t i = 0; i < len; i++)
+    {
+        st->digit_x[i] = (uint8_t)x;
+#if UI_FACE_FLIP_ENABLE
+        if (st->flip_mask & (1U << i))
+        {
+            int16_t advance = Glyph_Cache_DrawFlip(u8g2, x + x_offset, y, st->flip_from[i], text[i], phase);
+            if (advance >= 0)
+            {
+                x += advance;
+                continue;
+            }
+        }
+#endif
+        ch[0] = text[i];
+        x += Glyph_Cache_DrawStr(u8g2, x + x_offset, y, ch);
+    }
+    st->digit_x[len] = (uint8_t)x;
+    st->digit_len = len;
+    if (moved)
+    {
+        // 比例字体下总宽度变化会使整串移动，局部区域之外的旧像素需要在下一帧补刷
+        UI_Face_Invalidate_Box(st, f, page);
+    }
+#if UI_GRAY_ENABLE
+    UI_Gray_Apply(&st->gray, page, u8g2, f->box.x + x_offset, row + y_offset, f->box.w, rows);
+#endif
+}
+
+/**
+ * @brief 绘制指针表盘字段
+ * @param[in] st 显示状态
+ * @param[in] f 字段
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset X方向偏移
+ * @param[in] y_offset Y方向偏移
+ * @return 无
+ */
+static void UI_Face_Draw_Dial(const UI_Face_State_t *st, const UI_Face_Field_t *f, u8g2_t *u8g2,
+                              int16_t x_offset, int16_t y_offset)
+{
+    uint8_t hour = (uint8_t)((st->time[0] - '0') * 10 + (st->time[1] - '0'));
+    uint8_t minute = (uint8_t)((st->time[3] - '0') * 10 + (st->time[4] - '0'));
+    int16_t x = f->x + x_offset;
+    int16_t top = f->y - f->w - 1 + y_offset;
+
+    dial_r = f->w;
+    dial_hands[0] = (uint8_t)((hour % 12) * 5 + minute / 12);
+    dial_hands[1] = (uint8_t)(minute % 60);
+    dial_hands[2] = (uint8_t)(st->second % 60);
+#if APP_DLIST_ACTIVE
+    if (app_dlist_recording())
+    {
+        app_dlist_add_blit(UI_Face_Dial_Blit, x, top, 2 * f->w + 3);
+        return;
+    }
+#endif
+    UI_Face_Dial_Blit(u8g2, x, top);
+}
+
+/**
+ * @brief 生成半径 r 的八分圆表
+ * @details 中点画圆算法从12点开始沿X递增，直到对角线；只用整数加减。半径与上一次相同时不重新生成。
+ * @param[in] r 半径 (不超过 UI_FACE_ARC_R_MAX)
+ * @return 无
+ */
+static void UI_Face_Arc_Table(int16_t r)
+{
+    int16_t x = 0, y = r, d = 1 - r;
+
+    if (r == arc_r)
+    {
+        return;
+    }
+    arc_r = r;
+    arc_n = 0;
+    while (x <= y && arc_n < sizeof(arc_oct))
+    {
+        arc_oct[arc_n++] = (uint8_t)y;
+        x++;
+        if (d < 0)
+        {
+            d += 2 * x + 1;
+        }
+        else
+        {
+            y--;
+            d += 2 * (x - y) + 1;
+        }
+    }
+}
+
+/**
+ * @brief 秒进度字段的像素总数
+ * @details 圆环每个象限由一个正向的八分圆 (arc_n 个) 和一个反向的八分圆 (去掉轴上的一个) 组成。
+ * @param[in] f 秒进度字段
+ * @return uint8_t 像素总数
+ */
+static uint8_t UI_Face_Sweep_Total(const UI_Face_Field_t *f)
+{
+    if (f->kind == UI_FACE_BAR)
+    {
+        return (uint8_t)f->w;
+    }
+    UI_Face_Arc_Table(f->w);
+    return (uint8_t)(4 * (2 * arc_n - 1));
+}
+
+/**
+ * @brief 秒进度的第 k 个像素相对字段锚点的偏移
+ * @details 圆环按 k 所在的象限和八分圆对八分圆表中的 (i, arc_oct[i]) 做交换和取反，12点为第 0 个，顺时针排列。
+ *          调用前须已由 UI_Face_Sweep_Total() 生成八分圆表。
+ * @param[in] f 秒进度字段
+ * @param[in] k 像素序号 (小于像素总数)
+ * @param[out] x X方向偏移
+ * @param[out] y Y方向偏移
+ * @return 无
+ */
+static void UI_Face_Sweep_Pixel(const UI_Face_Field_t *f, uint8_t k, int16_t *x, int16_t *y)
+{
+    if (f->kind == UI_FACE_BAR)
+    {
+        *x = k;
+        *y = 0;
+        return;
+    }
+
+    uint8_t len = (uint8_t)(2 * arc_n - 1);
+    uint8_t quad = (uint8_t)(k / len);
+    uint8_t m = (uint8_t)(k % len);
+    bool odd = (m >= arc_n);
+    uint8_t i = odd ? (uint8_t)(len - m) : m; // 反向的八分圆从对角线回到轴上 (不含轴上的一点)
+    int16_t a = i, b = arc_oct[i];
+    int16_t u, v;
+
+    // 第一象限 (12点到3点)：正向为 (a, -b)，反向为 (b, -a)；其余象限依次旋转90°
+    u = odd ? b : a;
+    v = odd ? -a : -b;
+    switch (quad)
+    {
+    case 0: *x = u;  *y = v;  break;
+    case 1: *x = -v; *y = u;  break;
+    case 2: *x = -u; *y = -v; break;
+    default: *x = v; *y = -u; break;
+    }
+}
+
+/**
+ * @brief 绘制秒进度已覆盖的像素
+ * @details 字段和像素数取自 sweep_field、sweep_count。分页模式下作为位图命令录制，
+ *          回放时在每个条带中调用，条带和局部重绘区域之外的像素由 u8g2 裁掉。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 锚点X坐标
+ * @param[in] top 字段顶端Y坐标 (圆环为圆心上方 w 行)
+ * @return 无
+ */
+static void UI_Face_Sweep_Blit(u8g2_t *u8g2, int16_t x, int16_t top)
+{
+    const UI_Face_Field_t *f = sweep_field;
+    int16_t y = (f->kind == UI_FACE_ARC) ? top + f->w : top;
+    int16_t dx, dy;
+
+    if (f->kind == UI_FACE_BAR)
+    {
+        if (sweep_count != 0)
+        {
+            u8g2_DrawHLine(u8g2, x, y, sweep_count);
+        }
+        return;
+    }
+    (void)UI_Face_Sweep_Total(f);
+    for (uint8_t k = 0; k < sweep_count; k++)
+    {
+        UI_Face_Sweep_Pixel(f, k, &dx, &dy);
+        u8g2_DrawPixel(u8g2, x + dx, y + dy);
+    }
+}
+
+/**
+ * @brief 绘制秒进度字段
+ * @param[in] st 显示状态
+ * @param[in] f 字段
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset X方向偏移
+ * @param[in] y_offset Y方向偏移
+ * @return 无
+ */
+static void UI_Face_Draw_Sweep(const UI_Face_State_t *st, const UI_Face_Field_t *f, u8g2_t *u8g2,
+                               int16_t x_offset, int16_t y_offset)
+{
+    int16_t r = (f->kind == UI_FACE_ARC) ? f->w : 0;
+    int16_t top = f->y - r + y_offset;
+
+    if (st->sweep == 0 || !Page_Strip_Visible(top, 2 * r + 1))
+    {
+        return;
+    }
+    sweep_field = f;
+    sweep_count = st->sweep;
+#if APP_DLIST_ACTIVE
+    if (app_dlist_recording())
+    {
+        app_dlist_add_blit(UI_Face_Sweep_Blit, f->x + x_offset, top, 2 * r + 1);
+        return;
+    }
+#endif
+    UI_Face_Sweep_Blit(u8g2, f->x + x_offset, top);
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 获取表盘
+ * @param[in] index 表盘序号 (Clock_Face_e)，越界时返回第一个表盘
+ * @return const UI_Face_t* 表盘
+ */
+const UI_Face_t *UI_Face_Get(uint8_t index)
+{
+    return &ui_faces[(index < CLOCK_FACE_COUNT) ? index : CLOCK_FACE_DIGITAL];
+}
+
+/**
+ * @brief 使显示状态失效，下一次更新重绘整个表盘
+ * @param[out] st 显示状态
+ * @return 无
+ */
+void UI_Face_Reset(UI_Face_State_t *st)
+{
+    st->valid = false;
+    st->week = 0;
+    st->digit_len = 0;
+    st->sweep = 0;
+#if UI_FACE_FLIP_ENABLE
+    st->flip_mask = 0;
+#endif
+}
+
+/**
+ * @brief 查询表盘是否有按帧推进的动画
+ * @param[in] st 显示状态
+ * @return bool 正在翻页或以灰度显示时返回 true
+ */
+bool UI_Face_Animating(const UI_Face_State_t *st)
+{
+    bool busy = false;
+
+#if UI_FACE_FLIP_ENABLE
+    busy |= (st->flip_mask != 0 || st->flip_fast);
+#endif
+#if UI_GRAY_ENABLE
+    busy |= st->gray.active;
+#endif
+    (void)st;
+    return busy;
+}
+
+/**
+ * @brief 按当前数据更新显示状态，并使内容变化的字段失效
+ * @param[in,out] st 显示状态
+ * @param[in] face 表盘
+ * @param[in] page 所属页面
+ * @param[in] now 当前时间
+ * @param[in] temp_d 温度 (0.1℃)
+ * @param[in] humi_d 湿度 (0.1%RH)
+ * @param[in] dx 表盘整体的X方向偏移 (防烧屏)
+ * @param[in] dy 表盘整体的Y方向偏移 (防烧屏)
+ * @return 无
+ */
+void UI_Face_Update(UI_Face_State_t *st, const UI_Face_t *face, const Page_Base *page, const Time_t *now,
+                    int16_t temp_d, uint16_t humi_d, int16_t dx, int16_t dy)
+{
+    char time[sizeof(st->time)], date[sizeof(st->date)], temp[sizeof(st->temp)], humi[sizeof(st->humi)];
+    uint8_t astro_seq = app_astro_get()->seq; // 天文信息和农历由各自的模块每天计算一次，这里只比较序号
+    uint8_t lunar_seq = app_lunar_seq();
+    uint16_t changed = 0;
+    char *p;
+
+    p = fmt_u2(time, now->hour);
+    p = fmt_char(p, ':');
+    p = fmt_u2(p, now->minute);
+    p = fmt_char(p, ':');
+    fmt_u2(p, now->second);
+
+    p = fmt_u4(date, now->year);
+    p = fmt_char(p, '-');
+    p = fmt_u2(p, now->month);
+    p = fmt_char(p, '-');
+    fmt_u2(p, now->day);
+
+    fmt_str(fmt_q1(temp, temp_d), "\260C");
+    fmt_char(fmt_q1(humi, humi_d), '%');
+
+    // 防烧屏移动时页面整屏重绘，这里只记下新的偏移
+    st->dx = (int8_t)dx;
+    st->dy = (int8_t)dy;
+
+    // 只有数据源发生变化的字段才失效
+    if (!st->valid)
+    {
+        changed = UI_FACE_ALL;
+    }
+    else
+    {
+        if (strcmp(time, st->time) != 0) changed |= UI_FACE_BIT(UI_FACE_SRC_TIME);
+        if (strncmp(time, st->time, 5) != 0) changed |= UI_FACE_BIT(UI_FACE_SRC_TIME_HM);
+        if (strcmp(date, st->date) != 0) changed |= UI_FACE_BIT(UI_FACE_SRC_DATE);
+        if (strcmp(date + 5, st->date + 5) != 0) changed |= UI_FACE_BIT(UI_FACE_SRC_DATE_MD);
+        if (now->week >= 1 && now->week <= 7 && now->week != st->week) changed |= UI_FACE_BIT(UI_FACE_SRC_WEEK);
+        if (strcmp(temp, st->temp) != 0) changed |= UI_FACE_BIT(UI_FACE_SRC_TEMP);
+        if (strcmp(humi, st->humi) != 0) changed |= UI_FACE_BIT(UI_FACE_SRC_HUMI);
+        if (astro_seq != st->astro) changed |= UI_FACE_BIT(UI_FACE_SRC_SUN) | UI_FACE_BIT(UI_FACE_SRC_MOON);
+        if (lunar_seq != st->lunar) changed |= UI_FACE_BIT(UI_FACE_SRC_LUNAR);
+    }
+
+    for (uint8_t i = 0; changed != 0 && i < face->count; i++)
+    {
+        const UI_Face_Field_t *f = &face->fields[i];
+
+        if (!(changed & UI_FACE_BIT(f->source)))
+        {
+            continue;
+        }
+        if (f->kind == UI_FACE_DIGITS && st->valid && st->digit_len != 0 &&
+            st->digit_len == ((f->source == UI_FACE_SRC_TIME_HM) ? 5 : strlen(time)))
+        {
+            // 通常只有最后一位变化，按上一次绘制的字符位置只刷新变化的那几个字符
+            uint8_t i0 = 0, i1 = st->digit_len;
+            while (i0 < i1 && time[i0] == st->time[i0]) i0++;
+            while (i1 > i0 && time[i1 - 1] == st->time[i1 - 1]) i1--;
+            if (i0 < i1)
+            {
+                UI_Face_Invalidate_Chars(st, f, page, i0, i1);
+#if UI_FACE_FLIP_ENABLE
+                // 只有值变化的字符翻页；上一次还没翻完的字符直接显示为结果
+                UI_Face_Invalidate_Flip(st, f, page);
+                st->flip_mask = 0;
+                for (uint8_t k = i0; k < i1 && !Anim_Reduced(); k++) // 动画已关闭时直接显示结果
+                {
+                    if (time[k] != st->time[k])
+                    {
+                        st->flip_from[k] = st->time[k];
+                        st->flip_mask |= (uint16_t)(1U << k);
+                    }
+                }
+                st->flip_start = Page_Now();
+#endif
+            }
+        }
+        else if (f->kind == UI_FACE_DIAL && st->valid && !(changed & UI_FACE_BIT(UI_FACE_SRC_TIME_HM)))
+        {
+            // 时针和分针每分钟才动一次；其余时间只有秒针移动
+            UI_Face_Invalidate_Sec(st, f, page, st->second);
+            UI_Face_Invalidate_Sec(st, f, page, now->second % 60);
+        }
+        else
+        {
+            UI_Face_Invalidate_Box(st, f, page);
+        }
+    }
+
+    strcpy(st->time, time);
+    strcpy(st->date, date);
+    strcpy(st->temp, temp);
+    strcpy(st->humi, humi);
+    if (now->week >= 1 && now->week <= 7)
+    {
+        st->week = now->week;
+    }
+    st->second = (uint8_t)(now->second % 60);
+    st->astro = astro_seq;
+    st->lunar = lunar_seq;
+    st->valid = true;
+
+#if UI_GRAY_ENABLE || UI_FACE_FLIP_ENABLE
+    const UI_Face_Field_t *digits = NULL;
+    for (uint8_t i = 0; digits == NULL && i < face->count; i++)
+    {
+        if (face->fields[i].kind == UI_FACE_DIGITS)
+        {
+            digits = &face->fields[i];
+        }
+    }
+#endif
+
+#if UI_FACE_FLIP_ENABLE
+    // 翻页期间逐帧重绘变化的字符，结束时再画一次静止的结果
+    if (st->flip_mask != 0)
+    {
+        if (digits == NULL || st->digit_len == 0)
+        {
+            st->flip_mask = 0;
+        }
+        else
+        {
+            UI_Face_Invalidate_Flip(st, digits, page);
+            if (Page_Now() - st->flip_start >= UI_FACE_FLIP_MS)
+            {
+                st->flip_mask = 0;
+            }
+        }
+    }
+#endif
+
+#if UI_GRAY_ENABLE
+    // 灰度随大号数字字段，没有该字段的表盘保持页面原本的重绘间隔
+    if (digits != NULL)
+    {
+        int16_t row, rows;
+        (void)UI_Face_Digits_Row(digits, &row, &rows);
+        UI_Gray_Tick(&st->gray, page, digits->box.x + st->dx, row + st->dy, digits->box.w, rows);
+    }
+    else
+    {
+        UI_Gray_Stop(&st->gray, page);
+    }
+#endif
+
+#if UI_FACE_FLIP_ENABLE
+    // 灰度运行时页面的重绘间隔已经更短，不再改动
+#if UI_GRAY_ENABLE
+    bool gray_active = st->gray.active;
+#else
+    bool gray_active = false;
+#endif
+    if (!gray_active && (st->flip_mask != 0 || st->flip_fast))
+    {
+        Page_Set_Refresh(page, (st->flip_mask != 0) ? UI_FACE_FLIP_FRAME_MS : 0);
+    }
+    st->flip_fast = (st->flip_mask != 0);
+#endif
+}
+
+/**
+ * @brief 推进秒进度，并使新覆盖的像素失效
+ * @param[in,out] st 显示状态
+ * @param[in] face 表盘
+ * @param[in] page 所属页面
+ * @param[in] minute_ms 这一分钟已经过去的毫秒数 (0~59999)
+ * @return 无
+ */
+void UI_Face_Sweep(UI_Face_State_t *st, const UI_Face_t *face, const Page_Base *page, uint16_t minute_ms)
+{
+    const UI_Face_Field_t *f = NULL;
+
+    for (uint8_t i = 0; f == NULL && i < face->count; i++)
+    {
+        if (face->fields[i].kind == UI_FACE_ARC || face->fields[i].kind == UI_FACE_BAR)
+        {
+            f = &face->fields[i];
+        }
+    }
+    if (f == NULL || !st->valid)
+    {
+        return;
+    }
+
+    uint16_t ticks = 60000 / UI_FACE_SWEEP_TICK_MS;
+    uint16_t tick = (minute_ms < 60000) ? (uint16_t)(minute_ms / UI_FACE_SWEEP_TICK_MS) : (uint16_t)(ticks - 1);
+    uint8_t total = UI_Face_Sweep_Total(f);
+    uint8_t count = (uint8_t)((uint32_t)total * tick / ticks);
+
+    if (count == st->sweep)
+    {
+        return;
+    }
+    if (count < st->sweep)
+    {
+        // 分钟翻转 (或对时回退)：整个字段清除一次，之后从头增长
+        UI_Face_Invalidate_Box(st, f, page);
+    }
+    else
+    {
+        // 只有新覆盖的像素所在的块需要重绘和发送
+        int16_t x0 = INT16_MAX, y0 = INT16_MAX, x1 = INT16_MIN, y1 = INT16_MIN;
+        int16_t x, y;
+        for (uint8_t k = st->sweep; k < count; k++)
+        {
+            UI_Face_Sweep_Pixel(f, k, &x, &y);
+            if (x < x0) x0 = x;
+            if (x > x1) x1 = x;
+            if (y < y0) y0 = y;
+            if (y > y1) y1 = y;
+        }
+        Page_Invalidate_Rect(page, f->x + x0 + st->dx, f->y + y0 + st->dy, x1 - x0 + 1, y1 - y0 + 1);
+    }
+    st->sweep = count;
+}
+
+/**
+ * @brief 绘制表盘
+ * @param[in,out] st 显示状态 (记录大号数字的字符位置)
+ * @param[in] face 表盘
+ * @param[in] page 所属页面 (大号数字整体移动时补刷)
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset X方向偏移 (含防烧屏偏移)
+ * @param[in] y_offset Y方向偏移 (含防烧屏偏移)
+ * @return 无
+ */
+void UI_Face_Draw(UI_Face_State_t *st, const UI_Face_t *face, const Page_Base *page, u8g2_t *u8g2,
+                  int16_t x_offset, int16_t y_offset)
+{
+    const uint8_t *font = NULL;
+    char buf[6];
+
+    if (!st->valid)
+    {
+        return;
+    }
+    for (uint8_t i = 0; i < face->count; i++)
+    {
+        const UI_Face_Field_t *f = &face->fields[i];
+        const uint8_t *want = UI_FACE_I18N(f->source) ? app_i18n_font(f->font) : f->font;
+
+        if (want != NULL && want != font)
+        {
+            font = want;
+            u8g2_SetFont(u8g2, font);
+        }
+
+        switch (f->kind)
+        {
+        case UI_FACE_DIGITS:
+            if (Page_Strip_Text_Visible(u8g2, f->y + y_offset))
+            {
+                UI_Face_Draw_Digits(st, f, page, u8g2, x_offset, y_offset);
+            }
+            break;
+
+        case UI_FACE_HLINE:
+            if (Page_Strip_Visible(f->y + y_offset, 1))
+            {
+                u8g2_DrawHLine(u8g2, f->x + x_offset, f->y + y_offset, f->w);
+            }
+            break;
+
+        case UI_FACE_DIAL:
+            UI_Face_Draw_Dial(st, f, u8g2, x_offset, y_offset);
+            break;
+
+        case UI_FACE_ARC:
+        case UI_FACE_BAR:
+            UI_Face_Draw_Sweep(st, f, u8g2, x_offset, y_offset);
+            break;
+
+        default:
+            if (Page_Strip_Text_Visible(u8g2, f->y + y_offset))
+            {
+                const char *text = UI_Face_Text(st, f->source, buf);
+                bool i18n = UI_FACE_I18N(f->source);
+                int16_t w = 0;
+                if (f->align != UI_FACE_LEFT)
+                {
+                    w = (int16_t)(i18n ? app_i18n_width(u8g2, text) : Page_Str_Width(u8g2, text));
+                    if (f->prefix)
+                    {
+                        w += (int16_t)Page_Str_Width(u8g2, f->prefix);
+                    }
+                }
+                int16_t x = UI_Face_Align(f, w) + x_offset;
+                if (f->prefix)
+                {
+                    x += u8g2_DrawStr(u8g2, x, f->y + y_offset, f->prefix);
+                }
+                if (i18n)
+                {
+                    app_i18n_draw(u8g2, x, f->y + y_offset, text);
+                }
+                else
+                {
+                    u8g2_DrawStr(u8g2, x, f->y + y_offset, text);
+                }
+            }
+            break;
+        }
+    }
+}
+
+/** @} */
@@ -0,0 +1,231 @@
+/**
+ * @file      ui_face.h
+ * @brief     数据驱动的表盘头文件
+ * @details   主页面的表盘由 const 表描述：每个表盘是一组字段，字段绑定一个数据源 (时间、日期、
+ *            星期、温度、湿度、日出日落、月相、农历)，给出字体、锚点和失效区域。渲染器记住上一次显示的各数据源，
+ *            更新时只使数据源发生变化的字段失效，并只绘制与条带相交的字段。
+ *            失效区域在编译时按 SSD1306 的页 (8行) 取整，与整帧模式的显存差分和分页模式的条带边界对齐。
+ *            新增表盘只需在 ui_face.c 的表中添加一项，不需要新的绘制代码；
+ *            大号数字 (逐字符局部刷新) 和指针表盘 (每秒只刷新秒针) 是两种特殊字段，每个表盘最多各用一个。
+ *            UI_GRAY_ENABLE 为 1 时大号数字的边缘以时间抖动的灰度显示 (见 ui_gray.h)。
+ *            UI_FACE_FLIP_ENABLE 为 1 时大号数字中值变化的字符以翻页牌动画切换，只有这几个字符的列在动画期间重绘。
+ *            秒进度 (圆环或横条) 在一分钟内连续增长，每 UI_FACE_SWEEP_TICK_MS 只使新覆盖的像素失效，每个表盘最多用一个。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __UI_FACE_H
+#define __UI_FACE_H
+
+#include "app_display.h"
+#include "app_i18n.h"
+#include "ui_gray.h"
+#include "time_core.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup UI_Face 表盘
+ * @brief 由 const 表描述的主页面表盘及其局部刷新。
+ * @{
+ */
+
+/**
+ * @defgroup UI_Face_Config 表盘配置
+ * @{
+ */
+#ifndef UI_FACE_FLIP_ENABLE
+#define UI_FACE_FLIP_ENABLE   1   ///< 为 1 时大号数字变化的字符以翻页牌动画切换
+#endif
+#ifndef UI_FACE_PAGE_ALIGN
+#define UI_FACE_PAGE_ALIGN    0   ///< 为 1 时大号数字的基线移到使字体外框顶端落在页边界上 (最多移动4像素)，字形整字节写入
+#endif
+#define UI_FACE_FLIP_MS       200 ///< 翻页动画的时长 (ms)
+#define UI_FACE_FLIP_FRAME_MS 20  ///< 翻页期间页面的重绘间隔 (ms)
+#define UI_FACE_SWEEP_TICK_MS 100 ///< 秒进度的步长 (ms)，每分钟 60000 / UI_FACE_SWEEP_TICK_MS 步
+#define UI_FACE_ARC_R_MAX     32  ///< 秒进度圆环的最大半径 (像素)，决定八分圆表的长度
+/** @} */
+
+/**
+ * @brief 字段的数据源
+ */
+typedef enum
+{
+    UI_FACE_SRC_NONE = 0, ///< 无 (静态元素)
+    UI_FACE_SRC_TIME,     ///< 时间 "HH:MM:SS"
+    UI_FACE_SRC_TIME_HM,  ///< 时间 "HH:MM"，每分钟变化一次
+    UI_FACE_SRC_DATE,     ///< 日期 "YYYY-MM-DD"
+    UI_FACE_SRC_DATE_MD,  ///< 日期 "MM-DD"
+    UI_FACE_SRC_WEEK,     ///< 星期，按当前语言取文字
+    UI_FACE_SRC_TEMP,     ///< 温度 "23.5°C"
+    UI_FACE_SRC_HUMI,     ///< 湿度 "45.0%"
+    UI_FACE_SRC_SUN,      ///< 日出日落 "06:12-18:03"，每天变化一次 (app_astro)
+    UI_FACE_SRC_MOON,     ///< 月相 "1st Qtr 52%"，每天变化一次 (app_astro)
+    UI_FACE_SRC_LUNAR,    ///< 农历日期 "腊月初八"，每天变化一次 (app_lunar)，只在中文界面显示
+    UI_FACE_SRC_COUNT     ///< 数据源的个数
+} UI_Face_Src_e;
+
+/**
+ * @brief 字段的类型
+ */
+typedef enum
+{
+    UI_FACE_TEXT = 0, ///< 文字：font 字体，(x, y) 为锚点和基线
+    UI_FACE_DIGITS,   ///< 大号数字：经字形缓存绘制，在 x ± w/2 范围内居中，只刷新变化的字符
+    UI_FACE_HLINE,    ///< 水平线：从 (x, y) 开始，长度 w
+    UI_FACE_DIAL,     ///< 指针表盘：圆心 (x, y)，刻度半径 w，数据源须为 UI_FACE_SRC_TIME
+    UI_FACE_ARC,      ///< 秒进度圆环：圆心 (x, y)，半径 w (不超过 UI_FACE_ARC_R_MAX)，从12点顺时针增长，数据源为 UI_FACE_SRC_NONE
+    UI_FACE_BAR       ///< 秒进度横条：从 (x, y) 向右增长，长度 w，数据源为 UI_FACE_SRC_NONE
+} UI_Face_Kind_e;
+
+/**
+ * @brief 文字的对齐方式 (以 x 为锚点)
+ */
+typedef enum
+{
+    UI_FACE_LEFT = 0, ///< 左对齐
+    UI_FACE_CENTER,   ///< 居中
+    UI_FACE_RIGHT     ///< 右对齐
+} UI_Face_Align_e;
+
+/**
+ * @brief 字段的失效区域，行方向以页 (8行) 为单位
+ */
+typedef struct
+{
+    uint8_t x;     ///< 左端X坐标
+    uint8_t w;     ///< 宽度 (像素)
+    uint8_t page;  ///< 首页
+    uint8_t pages; ///< 页数
+} UI_Face_Box_t;
+
+/**
+ * @brief 由像素矩形得到覆盖它的页对齐区域 (编译时求值)
+ */
+#define UI_FACE_BOX(x, y, w, h) \
+    { (x), (w), (uint8_t)((y) / 8), (uint8_t)(((y) + (h) + 7) / 8 - (y) / 8) }
+
+/**
+ * @brief 表盘上的一个字段
+ */
+typedef struct
+{
+    uint8_t kind;         ///< 字段类型 (UI_Face_Kind_e)
+    uint8_t source;       ///< 数据源 (UI_Face_Src_e)
+    uint8_t align;        ///< 文字的对齐方式 (UI_Face_Align_e)
+    int16_t x;            ///< 锚点X坐标
+    int16_t y;            ///< 锚点Y坐标 (文字为基线)
+    int16_t w;            ///< 长度、宽度或半径，见 UI_Face_Kind_e
+    const uint8_t *font;  ///< 字体，NULL 时不设置；星期按当前语言由 app_i18n_font() 选择
+    const char *prefix;   ///< 绘制在数据之前的固定文字 (如 "T:")，可为NULL
+    UI_Face_Box_t box;    ///< 数据源变化时失效的区域
+} UI_Face_Field_t;
+
+/**
+ * @brief 一个表盘
+ */
+typedef struct
+{
+    App_Str_t name;                ///< 表盘名称
+    const UI_Face_Field_t *fields; ///< 字段表
+    uint8_t count;                 ///< 字段数
+} UI_Face_t;
+
+/**
+ * @brief 表盘的显示状态，放在页面私有数据中
+ * @details 保存各数据源上一次显示的文字，更新时逐个比较得到变化的数据源。
+ */
+typedef struct
+{
+    char time[12];   ///< "HH:MM:SS"
+    char date[12];   ///< "YYYY-MM-DD"
+    char temp[8];    ///< 温度
+    char humi[8];    ///< 湿度
+    uint8_t week;    ///< 星期 (1~7)，0 表示无效
+    uint8_t second;  ///< time 中的秒，指针表盘据此刷新秒针
+    uint8_t sweep;   ///< 秒进度已经覆盖的像素数
+    uint8_t astro;   ///< 上一次显示的天文信息的序号 (App_Astro_t.seq)
+    uint8_t lunar;   ///< 上一次显示的农历日期的序号 (app_lunar_seq)
+    int8_t dx;       ///< 上一次更新时的防烧屏X方向偏移
+    int8_t dy;       ///< 上一次更新时的防烧屏Y方向偏移
+    bool valid;      ///< 上面的字段是否有效，为 false 时下一次更新使全部字段失效
+    uint8_t digit_x[9]; ///< 大号数字上一次绘制时各字符的起始X坐标 (最后一项为右端)
+    uint8_t digit_len;  ///< digit_x 中的字符数，0 表示无效
+#if UI_GRAY_ENABLE
+    UI_Gray_t gray;     ///< 大号数字的灰度边缘
+#endif
+#if UI_FACE_FLIP_ENABLE
+    char flip_from[9];   ///< 正在翻页的各字符原来的字符
+    uint16_t flip_mask;  ///< 正在翻页的字符 (每个字符一位)，0 表示没有翻页
+    uint32_t flip_start; ///< 翻页开始的时刻
+    bool flip_fast;      ///< 页面的重绘间隔已改为 UI_FACE_FLIP_FRAME_MS
+#endif
+} UI_Face_State_t;
+
+/**
+ * @brief 获取表盘
+ * @param[in] index 表盘序号 (Clock_Face_e)，越界时返回第一个表盘
+ * @return const UI_Face_t* 表盘
+ */
+const UI_Face_t *UI_Face_Get(uint8_t index);
+
+/**
+ * @brief 使显示状态失效，下一次更新重绘整个表盘
+ * @param[out] st 显示状态
+ * @return 无
+ */
+void UI_Face_Reset(UI_Face_State_t *st);
+
+/**
+ * @brief 查询表盘是否有按帧推进的动画
+ * @details 翻页和灰度在 UI_Face_Update() 中逐帧推进；没有动画时，数据不变的更新可以省去。
+ * @param[in] st 显示状态
+ * @return bool 正在翻页 (或刚翻完、尚未恢复重绘间隔) 或以灰度显示时返回 true
+ */
+bool UI_Face_Animating(const UI_Face_State_t *st);
+
+/**
+ * @brief 按当前数据更新显示状态，并使内容变化的字段失效
+ * @param[in,out] st 显示状态
+ * @param[in] face 表盘
+ * @param[in] page 所属页面
+ * @param[in] now 当前时间
+ * @param[in] temp_d 温度 (0.1℃)
+ * @param[in] humi_d 湿度 (0.1%RH)
+ * @param[in] dx 表盘整体的X方向偏移 (防烧屏)
+ * @param[in] dy 表盘整体的Y方向偏移 (防烧屏)
+ * @return 无
+ */
+void UI_Face_Update(UI_Face_State_t *st, const UI_Face_t *face, const Page_Base *page, const Time_t *now,
+                    int16_t temp_d, uint16_t humi_d, int16_t dx, int16_t dy);
+
+/**
+ * @brief 推进秒进度，并使新覆盖的像素失效
+ * @details 按 UI_FACE_SWEEP_TICK_MS 的步长换算覆盖的像素数，增加时只使新增像素的外接矩形失效；
+ *          减少 (分钟翻转或对时) 时使整个字段失效一次，从头增长。表盘没有秒进度字段或显示状态无效时无操作。
+ * @param[in,out] st 显示状态
+ * @param[in] face 表盘
+ * @param[in] page 所属页面
+ * @param[in] minute_ms 这一分钟已经过去的毫秒数 (0~59999)
+ * @return 无
+ */
+void UI_Face_Sweep(UI_Face_State_t *st, const UI_Face_t *face, const Page_Base *page, uint16_t minute_ms);
+
+/**
+ * @brief 绘制表盘
+ * @param[in,out] st 显示状态 (记录大号数字的字符位置)
+ * @param[in] face 表盘
+ * @param[in] page 所属页面 (大号数字整体移动时补刷)
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset X方向偏移 (含防烧屏偏移)
+ * @param[in] y_offset Y方向偏移 (含防烧屏偏移)
+ * @return 无
+ */
+void UI_Face_Draw(UI_Face_State_t *st, const UI_Face_t *face, const Page_Base *page, u8g2_t *u8g2,
+                  int16_t x_offset, int16_t y_offset);
+
+/** @} */
+
+#endif /* __UI_FACE_H */
@@ -0,0 +1,238 @@
+/**
+ * @file      ui_gray.c
+ * @brief     大号数字的时间抖动灰度
+ * @details   灰色像素每次绘制时由缓冲区中的实心像素重新计算，不保存第二个位平面：
+ *            按页从上到下处理，每页一列为一个字节 (bit0 为顶行)，上下邻点由字节移位并拼上相邻页的边界位得到，
+ *            左右邻点为相邻列的字节。写回推迟到整页算完之后，左右邻点读到的总是原始像素；
+ *            上一页已经写回，其灰色像素由 gray_mask 中保留的掩码去掉。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "ui_gray.h"
+
+#if UI_GRAY_ENABLE
+
+#include <string.h>
+
+/**
+ * @addtogroup UI_Gray
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define GRAY_WIDTH  128 ///< 屏幕宽度 (整帧缓冲区每页的字节数)
+#define GRAY_HEIGHT 64  ///< 屏幕高度
+
+/* Private variables ---------------------------------------------------------*/
+static bool ui_gray_allowed = true;      ///< 是否允许灰度 (熄屏时禁止)
+static uint8_t gray_mask[GRAY_WIDTH];   ///< 正在处理的页各列的灰色像素，处理下一页时为上一页的
+
+/* Private function prototypes -----------------------------------------------*/
+static bool UI_Gray_Fill(uint8_t *buf, int16_t x0, int16_t x1, int16_t y0, int16_t y1, bool set);
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 计算区域内的灰色像素
+ * @param[in,out] buf 整帧绘图缓冲区
+ * @param[in] x0 左端X坐标 (包含，已裁剪到屏幕)
+ * @param[in] x1 右端X坐标 (不包含)
+ * @param[in] y0 顶端Y坐标 (包含)
+ * @param[in] y1 底端Y坐标 (不包含)
+ * @param[in] set 为 true 时把灰色像素写入缓冲区 (奇数帧)，为 false 时只判断有没有
+ * @return bool 区域内有灰色像素返回 true
+ */
+static bool UI_Gray_Fill(uint8_t *buf, int16_t x0, int16_t x1, int16_t y0, int16_t y1, bool set)
+{
+    bool any = false;
+
+    memset(&gray_mask[x0], 0, (size_t)(x1 - x0)); // 区域上方的页没有写入灰色像素
+    for (int16_t py = y0 & ~7; py < y1; py += 8)
+    {
+        uint8_t rows = 0xFF;
+        if (py < y0)
+        {
+            rows &= (uint8_t)(0xFF << (y0 - py));
+        }
+        if (py + 8 > y1)
+        {
+            rows &= (uint8_t)(0xFF >> (py + 8 - y1));
+        }
+
+        uint8_t *cur = buf + py / 8 * GRAY_WIDTH;
+        const uint8_t *above = (py > 0) ? cur - GRAY_WIDTH : NULL;
+        const uint8_t *below = (py + 8 < GRAY_HEIGHT) ? cur + GRAY_WIDTH : NULL;
+        uint8_t left = (x0 > 0) ? cur[x0 - 1] : 0;
+
+        for (int16_t x = x0; x < x1; x++)
+        {
+            uint8_t b = cur[x];
+            uint8_t right = (x + 1 < GRAY_WIDTH) ? cur[x + 1] : 0;
+            uint8_t up = (uint8_t)(b << 1);
+            uint8_t down = (uint8_t)(b >> 1);
+
+            if (above)
+            {
+                up |= (uint8_t)((above[x] & (uint8_t)~gray_mask[x]) >> 7);
+            }
+            if (below)
+            {
+                down |= (uint8_t)(below[x] << 7);
+            }
+            gray_mask[x] = (uint8_t)(~b & (left | right) & (up | down) & rows);
+            any |= (gray_mask[x] != 0);
+            left = b;
+        }
+
+        if (set)
+        {
+            for (int16_t x = x0; x < x1; x++)
+            {
+                cur[x] |= gray_mask[x];
+            }
+        }
+        else
+        {
+            memset(&gray_mask[x0], 0, (size_t)(x1 - x0)); // 没有写回，下一页看到的上一页是原样
+        }
+    }
+    return any;
+}
+
+/**
+ * @brief 允许或禁止灰度
+ * @param[in] on 允许为 true
+ * @return 无
+ */
+void UI_Gray_Allow(bool on)
+{
+    ui_gray_allowed = on;
+}
+
+/**
+ * @brief 停止灰度，恢复页面的重绘间隔
+ * @param[in,out] g 运行状态
+ * @param[in] page 所属页面
+ * @return 无
+ */
+void UI_Gray_Stop(UI_Gray_t *g, const Page_Base *page)
+{
+    if (g->active)
+    {
+        g->active = false;
+        Page_Set_Refresh(page, 0);
+    }
+    g->phase = 0;
+    g->pending = false;
+}
+
+/**
+ * @brief 灰度的逻辑步进，在页面 loop 中调用
+ * @param[in,out] g 运行状态
+ * @param[in] page 所属页面
+ * @param[in] x 区域左端X坐标 (屏幕坐标)
+ * @param[in] y 区域顶端Y坐标
+ * @param[in] w 区域宽度
+ * @param[in] h 区域高度
+ * @return 无
+ */
+void UI_Gray_Tick(UI_Gray_t *g, const Page_Base *page, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    uint32_t now = Page_Now();
+    bool allow = ui_gray_allowed && !Page_Manager_Is_Animating();
+
+    if (!g->active)
+    {
+        if (allow && (g->late < UI_GRAY_LATE_FRAMES || (int32_t)(now - g->retry_at) >= 0))
+        {
+            g->active = true;
+            g->late = 0;
+            g->phase = 0;
+            g->toggled = now;
+            g->pending = true;
+            Page_Set_Refresh(page, UI_GRAY_FRAME_MS);
+            Page_Invalidate_Rect(page, x, y, w, h); // 先画一次，得到有没有灰色像素
+        }
+        return;
+    }
+
+    if (!allow)
+    {
+        if (g->phase != 0)
+        {
+            Page_Invalidate_Rect(page, x, y, w, h);
+        }
+        UI_Gray_Stop(g, page);
+        return;
+    }
+    if (now - g->toggled < UI_GRAY_FRAME_MS)
+    {
+        return;
+    }
+
+    // 上一次请求的帧没有按时画出，或发送一帧已接近帧周期，继续下去灰色像素会明显闪烁
+    if (g->pending || u8g2_stm32_GetFrameTimeUs() > UI_GRAY_FLUSH_MAX_US)
+    {
+        if (++g->late >= UI_GRAY_LATE_FRAMES)
+        {
+            if (g->phase != 0)
+            {
+                Page_Invalidate_Rect(page, x, y, w, h);
+            }
+            UI_Gray_Stop(g, page);
+            g->retry_at = now + UI_GRAY_RETRY_MS;
+            return;
+        }
+    }
+    else
+    {
+        g->late = 0;
+    }
+
+    g->toggled = now;
+    if (g->has_gray)
+    {
+        g->phase ^= 1;
+        g->pending = true;
+        Page_Invalidate_Rect(page, x, y, w, h);
+    }
+}
+
+/**
+ * @brief 在已绘制的数字上补出当前位平面的灰色像素
+ * @param[in,out] g 运行状态
+ * @param[in] page 所属页面
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 区域左端X坐标 (屏幕坐标)
+ * @param[in] y 区域顶端Y坐标
+ * @param[in] w 区域宽度
+ * @param[in] h 区域高度
+ * @return 无
+ */
+void UI_Gray_Apply(UI_Gray_t *g, const Page_Base *page, u8g2_t *u8g2, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    int16_t x0 = (x < 0) ? 0 : x;
+    int16_t y0 = (y < 0) ? 0 : y;
+    int16_t x1 = (x + w > GRAY_WIDTH) ? GRAY_WIDTH : x + w;
+    int16_t y1 = (y + h > GRAY_HEIGHT) ? GRAY_HEIGHT : y + h;
+
+    if (!g->active || x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+    if (u8g2->clip_x0 > x0 || u8g2->clip_x1 < x1 || u8g2->clip_y0 > y0 || u8g2->clip_y1 < y1)
+    {
+        // 区域外的灰色像素属于另一个位平面，补刷整个区域使两者一致
+        Page_Invalidate_Rect(page, x, y, w, h);
+        return;
+    }
+    g->has_gray = UI_Gray_Fill(u8g2_GetBufferPtr(u8g2), x0, x1, y0, y1, g->phase != 0);
+    g->pending = false;
+}
+
+/** @} */
+
+#endif /* UI_GRAY_ENABLE */
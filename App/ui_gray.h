@@ -0,0 +1,112 @@
+/**
+ * @file      ui_gray.h
+ * @brief     大号数字的时间抖动灰度头文件
+ * @details   SSD1306 只有单色像素。本模块在大号数字的笔画拐角处补出一层灰色像素 (50% 占空比)，
+ *            得到 灭/灰/亮 三级的平滑边缘：灰色像素只在奇数帧点亮，两个位平面以 UI_GRAY_FRAME_MS
+ *            交替 (默认 100Hz 切换，50Hz 闪烁周期，人眼看到的是半亮)。
+ *            每次切换只使数字区域失效；整帧模式的显存差分只发送含灰色像素的列，实心像素不产生传输。
+ *            实测刷新时间超过一帧可用时间的 2/3、或切换请求的帧没能按时画出时，连续
+ *            UI_GRAY_LATE_FRAMES 次后回退为普通实心数字，UI_GRAY_RETRY_MS 后再尝试。
+ *            需要整帧模式 (U8G2_BUFFER_MODE 为 0) 和足够快的总线：400kHz 下四页全宽的灰色列约需
+ *            12ms，通常会回退，总线超频到 800kHz~1MHz 时才能保持。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __UI_GRAY_H
+#define __UI_GRAY_H
+
+#include "app_display.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup UI_Gray 时间抖动灰度
+ * @brief 大号数字边缘的三级灰度，两个位平面逐帧交替。
+ * @{
+ */
+
+/**
+ * @defgroup UI_Gray_Config 时间抖动灰度配置
+ * @{
+ */
+#ifndef UI_GRAY_ENABLE
+#define UI_GRAY_ENABLE      0     ///< 为 1 时主页面的大号数字以灰度边缘显示
+#endif
+#define UI_GRAY_FRAME_MS    10    ///< 两个位平面交替的间隔 (ms)
+#define UI_GRAY_FLUSH_MAX_US (UI_GRAY_FRAME_MS * 1000U * 2 / 3) ///< 平均刷新时间超过该值 (us) 视为跟不上
+#define UI_GRAY_LATE_FRAMES 8     ///< 连续这么多次跟不上时回退为实心数字
+#define UI_GRAY_RETRY_MS    60000 ///< 回退后到下一次尝试的间隔 (ms)
+/** @} */
+
+#if UI_GRAY_ENABLE && U8G2_BUFFER_MODE != 0
+#error "UI_GRAY_ENABLE requires U8G2_BUFFER_MODE 0"
+#endif
+
+/**
+ * @brief 灰度的运行状态，放在页面私有数据中
+ * @details 全零为未启用，下一次 UI_Gray_Tick() 时开始。
+ */
+typedef struct
+{
+    uint32_t toggled;  ///< 上一次切换位平面的时刻
+    uint32_t retry_at; ///< 回退后重新尝试的时刻
+    uint8_t phase;     ///< 当前位平面：0 只有实心像素，1 另外点亮灰色像素
+    uint8_t late;      ///< 连续跟不上的次数，达到 UI_GRAY_LATE_FRAMES 表示已回退
+    bool active;       ///< 正在以灰度显示，页面的重绘间隔为 UI_GRAY_FRAME_MS
+    bool has_gray;     ///< 上一次绘制时区域内有灰色像素 (没有时不切换)
+    bool pending;      ///< 上一次切换请求的帧尚未画出
+} UI_Gray_t;
+
+/**
+ * @brief 允许或禁止灰度
+ * @details 熄屏时禁止，灰度退回实心像素，不再每帧重绘关闭的屏幕；默认允许。
+ * @param[in] on 允许为 true
+ * @return 无
+ */
+void UI_Gray_Allow(bool on);
+
+/**
+ * @brief 灰度的逻辑步进，在页面 loop 中调用
+ * @details 按 UI_GRAY_FRAME_MS 切换位平面并使区域失效，检查刷新是否跟得上，
+ *          跟不上或切换动画期间退回实心像素。
+ * @param[in,out] g 运行状态
+ * @param[in] page 所属页面
+ * @param[in] x 区域左端X坐标 (屏幕坐标)
+ * @param[in] y 区域顶端Y坐标
+ * @param[in] w 区域宽度
+ * @param[in] h 区域高度
+ * @return 无
+ */
+void UI_Gray_Tick(UI_Gray_t *g, const Page_Base *page, int16_t x, int16_t y, int16_t w, int16_t h);
+
+/**
+ * @brief 停止灰度，恢复页面的重绘间隔
+ * @details 不使区域失效，调用者已经要整体重绘时使用。
+ * @param[in,out] g 运行状态
+ * @param[in] page 所属页面
+ * @return 无
+ */
+void UI_Gray_Stop(UI_Gray_t *g, const Page_Base *page);
+
+/**
+ * @brief 在已绘制的数字上补出当前位平面的灰色像素
+ * @details 在 draw 回调中、数字绘制之后调用。灰色像素为本身熄灭、左右至少一个邻点和上下至少一个邻点点亮的像素
+ *          (笔画的内拐角和斜边的台阶)，由绘图缓冲区中的实心像素逐页计算。
+ *          裁剪窗口没有覆盖整个区域时 (局部重绘几个字符) 不计算，并使整个区域在下一帧重绘。
+ * @param[in,out] g 运行状态
+ * @param[in] page 所属页面
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 区域左端X坐标 (屏幕坐标)
+ * @param[in] y 区域顶端Y坐标
+ * @param[in] w 区域宽度
+ * @param[in] h 区域高度
+ * @return 无
+ */
+void UI_Gray_Apply(UI_Gray_t *g, const Page_Base *page, u8g2_t *u8g2, int16_t x, int16_t y, int16_t w, int16_t h);
+
+/** @} */
+
+#endif /* __UI_GRAY_H */
@@ -0,0 +1,186 @@
+/**
+ * @file      ui_icon.c
+ * @brief     菜单图标
+ * @details   图集中每个图标为 UI_ICON_H / 8 页，每页 UI_ICON_W 字节，第 c 列第 r 行的像素
+ *            为 atlas[图标][r >> 3][c] 的第 (r & 7) 位，与 SSD1306 显存的字节布局相同。
+ *            每个图标上方注释中的点阵即其图形 (第2~13行，'#' 为亮，其余四行为空)，修改图形后按此规则重新换算。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "ui_icon.h"
+#include "app_display.h"
+
+/**
+ * @addtogroup UI_Icon
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define UI_ICON_PAGES (UI_ICON_H / 8) ///< 图标的页数
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief 图标图集 (位于Flash)
+ */
+static const uint8_t ui_icon_atlas[UI_ICON_COUNT][UI_ICON_PAGES][UI_ICON_W] = {
+    /* UI_ICON_DISPLAY
+     * ############
+     * #..........#
+     * #..........#
+     * #..........#
+     * #..........#
+     * #..........#
+     * #..........#
+     * ############
+     * .....##.....
+     * .....##.....
+     * ...######...
+     * ............
+     */
+    [UI_ICON_DISPLAY] = {
+        {0xFC, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0xFC},
+        {0x03, 0x02, 0x02, 0x12, 0x12, 0x1E, 0x1E, 0x12, 0x12, 0x02, 0x02, 0x03}},
+    /* UI_ICON_CLOCK
+     * ....####....
+     * ..##....##..
+     * .#........#.
+     * .#...#....#.
+     * #....#.....#
+     * #....#.....#
+     * #....####..#
+     * #..........#
+     * .#........#.
+     * .#........#.
+     * ..##....##..
+     * ....####....
+     */
+    [UI_ICON_CLOCK] = {
+        {0xC0, 0x30, 0x08, 0x08, 0x04, 0xE4, 0x04, 0x04, 0x08, 0x08, 0x30, 0xC0},
+        {0x03, 0x0C, 0x10, 0x10, 0x20, 0x21, 0x21, 0x21, 0x11, 0x10, 0x0C, 0x03}},
+    /* UI_ICON_ALARM
+     * .....##.....
+     * ....####....
+     * ...#....#...
+     * ..#......#..
+     * ..#......#..
+     * ..#......#..
+     * ..#......#..
+     * .#........#.
+     * .#........#.
+     * ############
+     * ............
+     * .....##.....
+     */
+    [UI_ICON_ALARM] = {
+        {0x00, 0x00, 0xE0, 0x10, 0x08, 0x0C, 0x0C, 0x08, 0x10, 0xE0, 0x00, 0x00},
+        {0x08, 0x0E, 0x09, 0x08, 0x08, 0x28, 0x28, 0x08, 0x08, 0x09, 0x0E, 0x08}},
+    /* UI_ICON_INFO
+     * ....####....
+     * ..##....##..
+     * .#...##...#.
+     * .#........#.
+     * #....##....#
+     * #....##....#
+     * #....##....#
+     * #....##....#
+     * .#...##...#.
+     * .#........#.
+     * ..##....##..
+     * ....####....
+     */
+    [UI_ICON_INFO] = {
+        {0xC0, 0x30, 0x08, 0x08, 0x04, 0xD4, 0xD4, 0x04, 0x08, 0x08, 0x30, 0xC0},
+        {0x03, 0x0C, 0x10, 0x10, 0x20, 0x27, 0x27, 0x20, 0x10, 0x10, 0x0C, 0x03}},
+    /* UI_ICON_LANGUAGE
+     * ....####....
+     * ..##.##.##..
+     * .#..#..#..#.
+     * .#..#..#..#.
+     * ############
+     * #...#..#...#
+     * #...#..#...#
+     * ############
+     * .#..#..#..#.
+     * .#..#..#..#.
+     * ..##.##.##..
+     * ....####....
+     */
+    [UI_ICON_LANGUAGE] = {
+        {0xC0, 0x70, 0x48, 0x48, 0xF4, 0x4C, 0x4C, 0xF4, 0x48, 0x48, 0x70, 0xC0},
+        {0x03, 0x0E, 0x12, 0x12, 0x2F, 0x32, 0x32, 0x2F, 0x12, 0x12, 0x0E, 0x03}},
+    /* UI_ICON_AUTO_OFF
+     * .....##.....
+     * .....##.....
+     * ..#..##..#..
+     * .##..##..##.
+     * ##...##...##
+     * #....##....#
+     * #..........#
+     * #..........#
+     * ##........##
+     * .##......##.
+     * ..########..
+     * ....####....
+     */
+    [UI_ICON_AUTO_OFF] = {
+        {0xC0, 0x60, 0x30, 0x00, 0x00, 0xFC, 0xFC, 0x00, 0x00, 0x30, 0x60, 0xC0},
+        {0x07, 0x0C, 0x18, 0x10, 0x30, 0x30, 0x30, 0x30, 0x10, 0x18, 0x0C, 0x07}},
+    /* UI_ICON_STOPWATCH
+     * ....####....
+     * .....##.....
+     * ..########..
+     * .#...##...#.
+     * #....##....#
+     * #....##....#
+     * #....##....#
+     * #..........#
+     * #..........#
+     * .#........#.
+     * ..########..
+     * ............
+     */
+    [UI_ICON_STOPWATCH] = {
+        {0xC0, 0x20, 0x10, 0x10, 0x14, 0xFC, 0xFC, 0x14, 0x10, 0x10, 0x20, 0xC0},
+        {0x07, 0x08, 0x10, 0x10, 0x10, 0x11, 0x11, 0x10, 0x10, 0x10, 0x08, 0x07}},
+    /* UI_ICON_TIMER
+     * ############
+     * .#........#.
+     * ..#......#..
+     * ...#....#...
+     * ....#..#....
+     * .....##.....
+     * .....##.....
+     * ....#..#....
+     * ...#.##.#...
+     * ..#.####.#..
+     * .##########.
+     * ############
+     */
+    [UI_ICON_TIMER] = {
+        {0x04, 0x0C, 0x14, 0x24, 0x44, 0x84, 0x84, 0x44, 0x24, 0x14, 0x0C, 0x04},
+        {0x20, 0x30, 0x38, 0x34, 0x3A, 0x3D, 0x3D, 0x3A, 0x34, 0x38, 0x30, 0x20}},
+};
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 绘制图标
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 左上角X坐标
+ * @param[in] y 左上角Y坐标
+ * @param[in] icon 图标编号
+ * @return 无
+ */
+void UI_Icon_Draw(u8g2_t *u8g2, int16_t x, int16_t y, UI_Icon_e icon)
+{
+    if ((unsigned)icon >= UI_ICON_COUNT)
+    {
+        return;
+    }
+    Page_Draw_Tiles(u8g2, x, y, UI_ICON_W, UI_ICON_H, &ui_icon_atlas[icon][0][0]);
+}
+
+/** @} */
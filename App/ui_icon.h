@@ -0,0 +1,64 @@
+/**
+ * @file      ui_icon.h
+ * @brief     菜单图标头文件
+ * @details   菜单项前的小图标。全部图标编译进Flash中的一张图集，按 SSD1306 的页式布局 (每字节竖直8个像素)
+ *            存放，绘制时由 Page_Draw_Tiles 直接写入显存：与显存页对齐时每页一次 memcpy，
+ *            不经过字体解码，比绘制一个字形还省。图标高度为两页，菜单行高同为16像素，
+ *            从页边界开始的菜单行上的图标总是对齐的，只有列表滚动的动画过程中才需要移位拼接。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __UI_ICON_H
+#define __UI_ICON_H
+
+#include "u8g2.h"
+#include <stdint.h>
+
+/**
+ * @defgroup UI_Icon 菜单图标
+ * @brief 提供了页式布局的图标图集。
+ * @{
+ */
+
+/**
+ * @defgroup UI_Icon_Config 菜单图标配置
+ * @{
+ */
+#define UI_ICON_W 12 ///< 图标宽度 (像素)
+#define UI_ICON_H 16 ///< 图标高度 (像素，8的倍数)，图形位于中间的12行
+/** @} */
+
+/**
+ * @brief 图标编号，即图集中的下标
+ */
+typedef enum
+{
+    UI_ICON_DISPLAY,  ///< 显示器
+    UI_ICON_CLOCK,    ///< 时钟
+    UI_ICON_ALARM,    ///< 闹铃
+    UI_ICON_INFO,     ///< 信息
+    UI_ICON_LANGUAGE, ///< 地球
+    UI_ICON_AUTO_OFF, ///< 电源
+    UI_ICON_STOPWATCH, ///< 秒表
+    UI_ICON_TIMER,    ///< 沙漏
+    UI_ICON_COUNT,    ///< 图标数量
+    UI_ICON_NONE = UI_ICON_COUNT ///< 无图标
+} UI_Icon_e;
+
+/**
+ * @brief 绘制图标
+ * @details 以不透明方式写入 UI_ICON_W x UI_ICON_H 的区域，遵守当前的裁剪窗口和条带 (分页模式)。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 左上角X坐标 (已加上X方向偏移)
+ * @param[in] y 左上角Y坐标 (已加上Y方向偏移)
+ * @param[in] icon 图标编号，UI_ICON_NONE 时不绘制
+ * @return 无
+ */
+void UI_Icon_Draw(u8g2_t *u8g2, int16_t x, int16_t y, UI_Icon_e icon);
+
+/** @} */
+
+#endif /* __UI_ICON_H */
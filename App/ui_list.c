@@ -0,0 +1,235 @@
+/**
+ * @file      ui_list.c
+ * @brief     通用列表控件
+ * @details   列表内容的坐标以列表区域顶部为原点：第 i 行位于 i * item_h，
+ *            屏幕上的位置为 cfg->y + i * item_h - scroll_y。
+ *            选中项和可见区域的顶部 (top) 是离散的目标状态，bar_y 和 scroll_y 由弹簧
+ *            从当前值驱动到目标，动画中途再次移动时只重新设定目标，保留当前速度。
+ *            首尾的回弹是给滚动弹簧一个朝旋转方向的速度，冲出约 UI_LIST_EDGE_PX 后回到原位。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.3
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "ui_list.h"
+#include "app_display.h"
+#include "app_i18n.h"
+#include "app_anim.h"
+#include "ui_marquee.h"
+
+/**
+ * @addtogroup UI_List
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define UI_LIST_EDGE_VEL (UI_LIST_EDGE_PX * ANIM_SPRING_OMEGA * 2718 / 1000) ///< 冲出 UI_LIST_EDGE_PX 所需的初速度 (e·ω·距离，像素/秒)
+
+/* Private function prototypes -----------------------------------------------*/
+static uint16_t UI_List_Count(const UI_List_t *list);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 获取列表的项目数
+ * @param[in] list 列表
+ * @return uint16_t 项目数
+ */
+static uint16_t UI_List_Count(const UI_List_t *list)
+{
+    return list->cfg->count(list->ctx);
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 初始化列表
+ * @param[out] list 列表
+ * @param[in] cfg 布局和数据源
+ * @param[in] ctx 传给数据源回调的上下文
+ * @param[in] selected 初始选中的项目索引
+ * @return 无
+ */
+void UI_List_Init(UI_List_t *list, const UI_List_Config_t *cfg, const void *ctx, uint16_t selected)
+{
+    uint16_t count;
+
+    list->cfg = cfg;
+    list->ctx = ctx;
+
+    count = UI_List_Count(list);
+    if (selected >= count)
+    {
+        selected = (count > 0) ? (uint16_t)(count - 1) : 0;
+    }
+    list->selected = selected;
+    list->top = (selected >= cfg->rows) ? (uint16_t)(selected - cfg->rows + 1) : 0;
+    list->bar_y = (int16_t)(selected * cfg->item_h);
+    list->scroll_y = (int16_t)(list->top * cfg->item_h);
+    if (cfg->marquee)
+    {
+        UI_Marquee_Reset();
+    }
+}
+
+/**
+ * @brief 移动选中项
+ * @param[in,out] list 列表
+ * @param[in] delta 移动的项目数
+ * @return bool 选中项是否改变
+ */
+bool UI_List_Move(UI_List_t *list, int16_t delta)
+{
+    const UI_List_Config_t *cfg = list->cfg;
+    int32_t count = UI_List_Count(list);
+    int32_t index = (int32_t)list->selected + delta;
+    uint16_t old_top = list->top;
+
+    if (count == 0 || delta == 0)
+    {
+        return false;
+    }
+
+    if (cfg->wrap)
+    {
+        index = ((index % count) + count) % count;
+    }
+    else if (index < 0 || index >= count)
+    {
+        index = (index < 0) ? 0 : count - 1;
+        if (index == list->selected)
+        {
+            // 已在首尾：把列表朝旋转方向推出几个像素，再弹回原位
+            Anim_Spring_Kick(&list->scroll_y, (int16_t)(list->top * cfg->item_h),
+                             (delta > 0) ? UI_LIST_EDGE_VEL : -UI_LIST_EDGE_VEL);
+            return false;
+        }
+    }
+
+    if (index == list->selected)
+    {
+        return false;
+    }
+    list->selected = (uint16_t)index;
+    if (cfg->marquee)
+    {
+        UI_Marquee_Reset(); // 新的选中项从文本开头开始
+    }
+
+    // 选中项移出可见区域时滚动列表，使其成为可见区域的第一行或最后一行
+    if (list->selected < list->top)
+    {
+        list->top = list->selected;
+    }
+    else if (list->selected >= list->top + cfg->rows)
+    {
+        list->top = (uint16_t)(list->selected - cfg->rows + 1);
+    }
+
+    if (list->top != old_top)
+    {
+        Anim_Spring_Start(&list->scroll_y, (int16_t)(list->top * cfg->item_h));
+    }
+    Anim_Spring_Start(&list->bar_y, (int16_t)(list->selected * cfg->item_h));
+    return true;
+}
+
+/**
+ * @brief 绘制列表
+ * @details 从 scroll_y 所在的行开始，画到列表区域底部为止，其余的项目不会被访问。
+ * @param[in] list 列表
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+void UI_List_Draw(const UI_List_t *list, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    const UI_List_Config_t *cfg = list->cfg;
+    uint16_t count = UI_List_Count(list);
+    int16_t area_y0 = cfg->y + y_offset;
+    int16_t area_y1 = area_y0 + cfg->rows * cfg->item_h;
+    bool clip = (count > cfg->rows) || (list->scroll_y != 0);
+    u8g2_uint_t saved_x0 = u8g2->clip_x0;
+    u8g2_uint_t saved_y0 = u8g2->clip_y0;
+    u8g2_uint_t saved_x1 = u8g2->clip_x1;
+    u8g2_uint_t saved_y1 = u8g2->clip_y1;
+    uint16_t first;
+    int16_t row_y;
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (clip)
+    {
+        // 滚动中的行不能画到列表区域之外，与当前的裁剪窗口 (局部重绘) 取交集
+        int32_t y0 = (area_y0 > (int32_t)saved_y0) ? area_y0 : (int32_t)saved_y0;
+        int32_t y1 = (area_y1 < (int32_t)saved_y1) ? area_y1 : (int32_t)saved_y1;
+        if (y0 < 0)
+        {
+            y0 = 0;
+        }
+        if (y1 <= y0)
+        {
+            return;
+        }
+        u8g2_SetClipWindow(u8g2, saved_x0, (u8g2_uint_t)y0, saved_x1, (u8g2_uint_t)y1);
+    }
+
+    first = (list->scroll_y > 0) ? (uint16_t)(list->scroll_y / cfg->item_h) : 0;
+    row_y = area_y0 + first * cfg->item_h - list->scroll_y;
+
+    u8g2_SetFont(u8g2, app_i18n_font(cfg->font));
+    u8g2_SetDrawColor(u8g2, 1);
+    for (uint16_t i = first; i < count && row_y < area_y1; i++, row_y += cfg->item_h)
+    {
+        int16_t baseline = row_y + cfg->baseline;
+        if (Page_Strip_Text_Visible(u8g2, baseline))
+        {
+            int16_t right = cfg->x + cfg->w - UI_LIST_VALUE_PAD + x_offset;
+            const char *value = cfg->value ? cfg->value(list->ctx, i) : NULL;
+            if (value)
+            {
+                right -= app_i18n_width(u8g2, value);
+                app_i18n_draw(u8g2, right, baseline, value);
+                right -= UI_LIST_VALUE_GAP;
+            }
+            if (cfg->marquee && i == list->selected)
+            {
+                UI_Marquee_Draw(u8g2, cfg->text_x + x_offset, baseline, right - (cfg->text_x + x_offset), cfg->text(list->ctx, i));
+            }
+            else
+            {
+                app_i18n_draw(u8g2, cfg->text_x + x_offset, baseline, cfg->text(list->ctx, i));
+            }
+        }
+        if (cfg->icon && Page_Strip_Visible(row_y, cfg->item_h))
+        {
+            // 行高与图标同为两页时，未滚动的行上图标与显存页对齐，整页复制
+            UI_Icon_Draw(u8g2, cfg->icon_x + x_offset, row_y + (cfg->item_h - UI_ICON_H) / 2, cfg->icon(list->ctx, i));
+        }
+    }
+
+    // 文字已全部绘制，把选中项所在的矩形反色得到高亮条
+    Page_Invert_Rect(u8g2, cfg->x + x_offset, area_y0 + list->bar_y - list->scroll_y, cfg->w, cfg->item_h);
+
+    if (clip)
+    {
+        u8g2_SetClipWindow(u8g2, saved_x0, saved_y0, saved_x1, saved_y1);
+    }
+}
+
+/**
+ * @brief 查询列表是否正在播放动画
+ * @param[in] list 列表
+ * @return bool 高亮条或滚动的补间未结束时返回 true
+ */
+bool UI_List_Is_Animating(const UI_List_t *list)
+{
+    return Anim_Tween_Is_Active(&list->bar_y) || Anim_Tween_Is_Active(&list->scroll_y);
+}
+
+/** @} */
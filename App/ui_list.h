@@ -0,0 +1,141 @@
+/**
+ * @file      ui_list.h
+ * @brief     通用列表控件头文件
+ * @details   各设置页面共用的选择列表：项目数和项目文本由页面通过回调按需提供，控件只保存
+ *            选中项和滚动位置，绘制时只访问可见的行，几十项的列表与三项的菜单每帧开销相同。
+ *            高亮条与滚动都由临界阻尼弹簧 (Anim_Spring_Start) 驱动，选中项超出可见区域时列表随之滚动；
+ *            动画过程中继续旋转编码器只改变弹簧的目标，位置和速度都是连续的，快速旋转时列表平滑地加速。
+ *            高亮条用 Page_Invert_Rect 反色得到，文字只绘制一次。
+ *            项目可以带图标 (ui_icon)，与文字一起画在行内，随高亮条一起反色。
+ *            项目还可以带一个右对齐的值文本 (如世界时钟的时间)，不同长度的名称后值仍然对齐。
+ *            开启 marquee 时，选中项的文本比文字到值文本 (或高亮条右端) 之间的宽度更长时以跑马灯 (ui_marquee) 滚动。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.3
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __UI_LIST_H
+#define __UI_LIST_H
+
+#include "u8g2.h"
+#include "ui_icon.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup UI_List 列表控件
+ * @brief 提供了虚拟化的选择列表。
+ * @{
+ */
+
+/**
+ * @defgroup UI_List_Config 列表控件配置
+ * @{
+ */
+#define UI_LIST_EDGE_PX   4   ///< 不循环的列表在首尾继续旋转时的回弹距离 (像素)
+#define UI_LIST_VALUE_PAD 3   ///< 值文本右端到高亮条右侧的距离 (像素)
+#define UI_LIST_VALUE_GAP 4   ///< 跑马灯文本右端到值文本左端的最小距离 (像素)
+/** @} */
+
+/**
+ * @brief 获取列表的项目数
+ * @param[in] ctx UI_List_Init 传入的上下文 (通常为页面数据)
+ * @return uint16_t 项目数
+ */
+typedef uint16_t (*UI_List_Count_Fn)(const void *ctx);
+
+/**
+ * @brief 获取一个项目的文本
+ * @param[in] ctx UI_List_Init 传入的上下文 (通常为页面数据)
+ * @param[in] index 项目索引
+ * @return const char* 项目文本，在本次绘制结束前须保持有效
+ */
+typedef const char *(*UI_List_Text_Fn)(const void *ctx, uint16_t index);
+
+/**
+ * @brief 获取一个项目的图标
+ * @param[in] ctx UI_List_Init 传入的上下文 (通常为页面数据)
+ * @param[in] index 项目索引
+ * @return UI_Icon_e 图标编号，UI_ICON_NONE 为不显示图标
+ */
+typedef UI_Icon_e (*UI_List_Icon_Fn)(const void *ctx, uint16_t index);
+
+/**
+ * @brief 列表的布局和数据源，通常定义为页面文件中的 const 常量
+ */
+typedef struct
+{
+    int16_t x;              ///< 高亮条左侧的X坐标
+    int16_t y;              ///< 列表区域顶部的Y坐标
+    int16_t w;              ///< 高亮条的像素宽度
+    int16_t text_x;         ///< 文字的X坐标
+    int16_t icon_x;         ///< 图标的X坐标 (icon 不为NULL时使用)，图标在行内竖直居中
+    uint8_t item_h;         ///< 每行的像素高度
+    uint8_t baseline;       ///< 文字基线相对行顶部的偏移
+    uint8_t rows;           ///< 可见的行数
+    bool wrap;              ///< 越过首尾时是否循环选择
+    const uint8_t *font;    ///< 项目文字的字体 (中文界面时换用 APP_I18N_FONT)
+    UI_List_Count_Fn count; ///< 项目数
+    UI_List_Text_Fn text;   ///< 项目文本
+    UI_List_Icon_Fn icon;   ///< 项目图标，可为NULL (纯文字列表)
+    UI_List_Text_Fn value;  ///< 项目的值文本，右对齐到高亮条右侧，可为NULL；返回 NULL 的项目不显示值
+    bool marquee;           ///< 选中项的文本超出可用宽度时以跑马灯滚动 (页面 loop 中须调用 UI_Marquee_Tick)
+} UI_List_Config_t;
+
+/**
+ * @brief 列表的运行状态，嵌入页面的私有数据中
+ */
+typedef struct
+{
+    const UI_List_Config_t *cfg; ///< 布局和数据源
+    const void *ctx;             ///< 传给数据源回调的上下文
+    uint16_t selected;           ///< 当前选中的项目索引
+    uint16_t top;                ///< 可见区域顶部的项目索引 (滚动的目标位置)
+    int16_t bar_y;               ///< 高亮条在列表内容中的Y坐标 (补间)
+    int16_t scroll_y;            ///< 列表内容向上滚动的像素数 (补间)
+} UI_List_t;
+
+/**
+ * @brief 初始化列表
+ * @details 选中项越界时取最后一项，并使选中项可见。高亮条和滚动位置直接就位，不播放动画。
+ * @param[out] list 列表
+ * @param[in] cfg 布局和数据源，须在列表使用期间保持有效
+ * @param[in] ctx 传给数据源回调的上下文
+ * @param[in] selected 初始选中的项目索引
+ * @return 无
+ */
+void UI_List_Init(UI_List_t *list, const UI_List_Config_t *cfg, const void *ctx, uint16_t selected);
+
+/**
+ * @brief 移动选中项
+ * @details 按配置循环或停在首尾，必要时滚动列表使选中项可见，并设定高亮条和滚动弹簧的目标。
+ *          不循环的列表在首尾继续旋转时列表轻微回弹，选中项不变。
+ * @param[in,out] list 列表
+ * @param[in] delta 移动的项目数 (编码器事件的 value)
+ * @return bool 选中项是否改变
+ */
+bool UI_List_Move(UI_List_t *list, int16_t delta);
+
+/**
+ * @brief 绘制列表
+ * @details 只绘制与可见区域和当前条带 (分页模式) 相交的行，然后反色高亮条。
+ *          列表可以滚动时，绘制被限制在列表区域内。
+ * @param[in] list 列表
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+void UI_List_Draw(const UI_List_t *list, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+
+/**
+ * @brief 查询列表是否正在播放动画
+ * @param[in] list 列表
+ * @return bool 高亮条或滚动的弹簧未停稳时返回 true
+ */
+bool UI_List_Is_Animating(const UI_List_t *list);
+
+/** @} */
+
+#endif /* __UI_LIST_H */
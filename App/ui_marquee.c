@@ -0,0 +1,408 @@
+/**
+ * @file      ui_marquee.c
+ * @brief     超宽文字的跑马灯控件
+ * @details   位图第 r 行存放在 strip[r >> 3][列] 的第 (r & 7) 位，与 SSD1306 显存的字节布局相同；
+ *            第0行是字体的最高字形顶端，相对基线的偏移为 text_top。
+ *            光栅化时把 u8g2 的绘图缓冲区临时换成位图 (缓冲区指针、宽度、条带行号和用户窗口)，
+ *            用 u8g2 自身的字形解码画一次，然后恢复，中文 (UTF-8) 与西文走同一条路径。
+ *            位图在水平方向以 cols + UI_MARQUEE_GAP 为周期重复：屏幕第 c 列取位图的第 (c - x + offset) % period 列，
+ *            超出 cols 的列为空白。复制时源列按列递增、到周期末尾回到0，每列每页一次读改写。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "ui_marquee.h"
+#include "app_i18n.h"
+#include <string.h>
+
+/**
+ * @addtogroup UI_Marquee
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define UI_MARQUEE_ROWS (UI_MARQUEE_PAGES * 8) ///< 位图的行数
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 控件状态
+ */
+typedef struct
+{
+    bool active;                                        ///< 有文字需要滚动 (UI_Marquee_Tick 使区域失效)
+    bool raster;                                        ///< 位图是否可用，false 时逐帧绘制字符串
+    uint8_t lang;                                       ///< 生成时的语言 (决定按 UTF-8 还是单字节绘制)
+    const uint8_t *font;                                ///< 生成时的字体
+    char text[UI_MARQUEE_TEXT_MAX];                     ///< 文字
+    int16_t cols;                                       ///< 文字的像素宽度 (位图的有效列数)
+    int16_t text_top;                                   ///< 位图第0行相对于基线的偏移
+    int16_t x;                                          ///< 最近一次绘制的可见区域左端X坐标
+    int16_t top;                                        ///< 最近一次绘制的位图第0行的Y坐标
+    int16_t w;                                          ///< 最近一次绘制的可见区域宽度
+    int16_t offset;                                     ///< 当前的滚动偏移 (像素，0 ~ 周期-1)
+    uint32_t start;                                     ///< 本轮滚动的起始时刻
+    uint8_t strip[UI_MARQUEE_PAGES][UI_MARQUEE_MAX_COLS]; ///< 位图
+} UI_Marquee_t;
+
+/* Private variables ---------------------------------------------------------*/
+static UI_Marquee_t marquee; ///< 唯一的跑马灯
+
+/* Private function prototypes -----------------------------------------------*/
+static bool UI_Marquee_Same(const u8g2_t *u8g2, const char *text);
+static void UI_Marquee_Fill(u8g2_t *u8g2, const char *text);
+static bool UI_Marquee_Raster(u8g2_t *u8g2);
+static uint8_t UI_Marquee_Byte(int16_t col, int16_t row);
+static void UI_Marquee_Blit(u8g2_t *u8g2, int16_t x, int16_t top);
+static void UI_Marquee_Draw_Text(u8g2_t *u8g2, int16_t x, int16_t y);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 判断文字、字体和语言是否与当前位图相同
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] text 文字
+ * @return bool 相同返回 true
+ */
+static bool UI_Marquee_Same(const u8g2_t *u8g2, const char *text)
+{
+    return marquee.font == u8g2->font && marquee.lang == app_i18n_language() &&
+           strncmp(marquee.text, text, UI_MARQUEE_TEXT_MAX - 1) == 0;
+}
+
+/**
+ * @brief 按文字和当前字体生成位图，并从开头开始滚动
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] text 文字
+ * @return 无
+ */
+static void UI_Marquee_Fill(u8g2_t *u8g2, const char *text)
+{
+    size_t n = strlen(text);
+
+    if (n > UI_MARQUEE_TEXT_MAX - 1)
+    {
+        // 截断在字符边界上，不留下半个 UTF-8 字符
+        n = UI_MARQUEE_TEXT_MAX - 1;
+        while (n > 0 && ((uint8_t)text[n] & 0xC0U) == 0x80U)
+        {
+            n--;
+        }
+    }
+    memcpy(marquee.text, text, n);
+    marquee.text[n] = '\0';
+    marquee.font = u8g2->font;
+    marquee.lang = app_i18n_language();
+    marquee.cols = (int16_t)app_i18n_width(u8g2, marquee.text);
+    marquee.text_top = (int16_t)-(u8g2->font_info.max_char_height + u8g2->font_info.y_offset);
+    marquee.raster = UI_Marquee_Raster(u8g2);
+    marquee.offset = 0;
+    marquee.start = Page_Now();
+}
+
+/**
+ * @brief 把文字光栅化到位图
+ * @details 绘图缓冲区临时指向位图，用户窗口为整个位图，绘制完成后恢复原来的缓冲区和窗口。
+ *          用括号调用 u8g2 的原函数，录制绘图命令 (app_dlist) 时也直接画到位图中。
+ * @param[in] u8g2 指向u8g2实例的指针 (当前字体即文字的字体)
+ * @return bool 成功返回 true
+ */
+static bool UI_Marquee_Raster(u8g2_t *u8g2)
+{
+    uint8_t *buf_ptr = u8g2->tile_buf_ptr;
+    uint8_t buf_height = u8g2->tile_buf_height;
+    uint8_t curr_row = u8g2->tile_curr_row;
+    u8g2_uint_t buf_width = u8g2->pixel_buf_width;
+    u8g2_uint_t pixel_height = u8g2->pixel_buf_height;
+    u8g2_uint_t pixel_row = u8g2->pixel_curr_row;
+    u8g2_uint_t user_x0 = u8g2->user_x0;
+    u8g2_uint_t user_x1 = u8g2->user_x1;
+    u8g2_uint_t user_y0 = u8g2->user_y0;
+    u8g2_uint_t user_y1 = u8g2->user_y1;
+    uint8_t color = u8g2->draw_color;
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+    uint8_t intersection = u8g2->is_page_clip_window_intersection;
+#endif
+    u8g2_uint_t baseline = (u8g2_uint_t)-marquee.text_top;
+
+    if (u8g2->cb != U8G2_R0 || u8g2->font_info.max_char_height > UI_MARQUEE_ROWS ||
+        marquee.cols <= 0 || marquee.cols > UI_MARQUEE_MAX_COLS)
+    {
+        return false;
+    }
+
+    memset(marquee.strip, 0, sizeof(marquee.strip));
+    u8g2->tile_buf_ptr = &marquee.strip[0][0];
+    u8g2->tile_buf_height = UI_MARQUEE_PAGES;
+    u8g2->tile_curr_row = 0;
+    u8g2->pixel_buf_width = UI_MARQUEE_MAX_COLS;
+    u8g2->pixel_buf_height = UI_MARQUEE_ROWS;
+    u8g2->pixel_curr_row = 0;
+    u8g2->user_x0 = 0;
+    u8g2->user_x1 = (u8g2_uint_t)marquee.cols;
+    u8g2->user_y0 = 0;
+    u8g2->user_y1 = UI_MARQUEE_ROWS;
+    u8g2->draw_color = 1;
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+    u8g2->is_page_clip_window_intersection = 1;
+#endif
+
+    if (marquee.lang == LANGUAGE_CN)
+    {
+        (u8g2_DrawUTF8)(u8g2, 0, baseline, marquee.text);
+    }
+    else
+    {
+        (u8g2_DrawStr)(u8g2, 0, baseline, marquee.text);
+    }
+
+    u8g2->tile_buf_ptr = buf_ptr;
+    u8g2->tile_buf_height = buf_height;
+    u8g2->tile_curr_row = curr_row;
+    u8g2->pixel_buf_width = buf_width;
+    u8g2->pixel_buf_height = pixel_height;
+    u8g2->pixel_curr_row = pixel_row;
+    u8g2->user_x0 = user_x0;
+    u8g2->user_x1 = user_x1;
+    u8g2->user_y0 = user_y0;
+    u8g2->user_y1 = user_y1;
+    u8g2->draw_color = color;
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+    u8g2->is_page_clip_window_intersection = intersection;
+#endif
+    return true;
+}
+
+/**
+ * @brief 取出位图中从指定行开始的8行
+ * @param[in] col 列 (0 ~ cols-1)
+ * @param[in] row 起始行，可以为负或超出位图，超出的部分为0
+ * @return uint8_t bit0 为第 row 行
+ */
+static uint8_t UI_Marquee_Byte(int16_t col, int16_t row)
+{
+    int16_t page;
+    uint8_t bit;
+    uint8_t v;
+
+    if (row <= -8 || row >= UI_MARQUEE_ROWS)
+    {
+        return 0;
+    }
+    if (row < 0)
+    {
+        return (uint8_t)(marquee.strip[0][col] << -row);
+    }
+    page = row >> 3;
+    bit = (uint8_t)(row & 7);
+    v = (uint8_t)(marquee.strip[page][col] >> bit);
+    if (bit != 0 && page + 1 < UI_MARQUEE_PAGES)
+    {
+        v |= (uint8_t)(marquee.strip[page + 1][col] << (8 - bit));
+    }
+    return v;
+}
+
+/**
+ * @brief 把位图按当前偏移复制到显存
+ * @details 可见区域取 [x, x + w)、u8g2 当前条带与裁剪窗口 (user_x0/x1/y0/y1) 的交集，与老虎机控件相同。
+ *          w 和偏移取自最近一次 UI_Marquee_Draw，录制的命令回放时两者不变。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 可见区域左端X坐标
+ * @param[in] top 位图第0行的Y坐标
+ * @return 无
+ */
+static void UI_Marquee_Blit(u8g2_t *u8g2, int16_t x, int16_t top)
+{
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+    if (!u8g2->is_page_clip_window_intersection)
+    {
+        return;
+    }
+#endif
+    int16_t y0 = (top > (int16_t)u8g2->user_y0) ? top : (int16_t)u8g2->user_y0;
+    int16_t y1 = (top + UI_MARQUEE_ROWS < (int16_t)u8g2->user_y1) ? top + UI_MARQUEE_ROWS : (int16_t)u8g2->user_y1;
+    int16_t x0 = (x > (int16_t)u8g2->user_x0) ? x : (int16_t)u8g2->user_x0;
+    int16_t x1 = (x + marquee.w < (int16_t)u8g2->user_x1) ? x + marquee.w : (int16_t)u8g2->user_x1;
+    if (y0 >= y1 || x0 >= x1)
+    {
+        return;
+    }
+
+    int16_t period = marquee.cols + UI_MARQUEE_GAP;
+    int16_t src0 = (int16_t)((x0 - x + marquee.offset) % period); // 可见区域第一列对应的位图列
+    int16_t buf_row = (int16_t)u8g2->pixel_curr_row;
+    int16_t page0 = (y0 - buf_row) >> 3;
+    int16_t page1 = (y1 - 1 - buf_row) >> 3;
+    uint16_t stride = u8g2->pixel_buf_width;
+    uint8_t color = u8g2->draw_color;
+
+    for (int16_t page = page0; page <= page1; page++)
+    {
+        int16_t row = buf_row + page * 8; // 本页第0行的屏幕Y坐标
+        uint8_t mask = 0xFF;
+        uint8_t *dst = u8g2->tile_buf_ptr + page * stride;
+        int16_t src = src0;
+
+        // 去掉可见区域之外的行
+        if (row < y0)
+        {
+            mask &= (uint8_t)(0xFF << (y0 - row));
+        }
+        if (row + 8 > y1)
+        {
+            mask &= (uint8_t)(0xFF >> (row + 8 - y1));
+        }
+
+        for (int16_t c = x0; c < x1; c++)
+        {
+            if (src < marquee.cols)
+            {
+                uint8_t fb = UI_Marquee_Byte(src, row - top) & mask;
+                if (color == 0)
+                {
+                    dst[c] &= (uint8_t)~fb;
+                }
+                else if (color == 1)
+                {
+                    dst[c] |= fb;
+                }
+                else
+                {
+                    dst[c] ^= fb;
+                }
+            }
+            if (++src == period)
+            {
+                src = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 没有位图时按偏移绘制字符串 (限制在可见区域内)
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 可见区域左端X坐标
+ * @param[in] y 基线Y坐标
+ * @return 无
+ */
+static void UI_Marquee_Draw_Text(u8g2_t *u8g2, int16_t x, int16_t y)
+{
+    u8g2_uint_t saved_x0 = u8g2->clip_x0;
+    u8g2_uint_t saved_y0 = u8g2->clip_y0;
+    u8g2_uint_t saved_x1 = u8g2->clip_x1;
+    u8g2_uint_t saved_y1 = u8g2->clip_y1;
+    int32_t x0 = (x > (int32_t)saved_x0) ? x : (int32_t)saved_x0;
+    int32_t x1 = (x + marquee.w < (int32_t)saved_x1) ? x + marquee.w : (int32_t)saved_x1;
+    int16_t start = x - marquee.offset;
+
+    if (x0 < 0)
+    {
+        x0 = 0;
+    }
+    if (x1 <= x0)
+    {
+        return;
+    }
+    u8g2_SetClipWindow(u8g2, (u8g2_uint_t)x0, saved_y0, (u8g2_uint_t)x1, saved_y1);
+    app_i18n_draw(u8g2, (u8g2_uint_t)start, (u8g2_uint_t)y, marquee.text);
+    if (start + marquee.cols + UI_MARQUEE_GAP < x + marquee.w)
+    {
+        app_i18n_draw(u8g2, (u8g2_uint_t)(start + marquee.cols + UI_MARQUEE_GAP), (u8g2_uint_t)y, marquee.text);
+    }
+    u8g2_SetClipWindow(u8g2, saved_x0, saved_y0, saved_x1, saved_y1);
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 停止滚动
+ * @return 无
+ */
+void UI_Marquee_Reset(void)
+{
+    marquee.active = false;
+    marquee.font = NULL;
+}
+
+/**
+ * @brief 跑马灯的逻辑步进
+ * @details 每轮先停 UI_MARQUEE_PAUSE_MS，再以 UI_MARQUEE_SPEED 滚过一个周期，回到开头时与停顿的画面相同。
+ * @param[in] page 所属页面
+ * @return 无
+ */
+void UI_Marquee_Tick(const Page_Base *page)
+{
+    uint32_t period, phase;
+    int16_t offset;
+
+    if (!marquee.active || Page_Manager_Is_Animating())
+    {
+        return;
+    }
+
+    period = (uint32_t)(marquee.cols + UI_MARQUEE_GAP);
+    phase = (Page_Now() - marquee.start) % (UI_MARQUEE_PAUSE_MS + period * 1000U / UI_MARQUEE_SPEED);
+    offset = (phase < UI_MARQUEE_PAUSE_MS) ? 0 : (int16_t)((phase - UI_MARQUEE_PAUSE_MS) * UI_MARQUEE_SPEED / 1000U);
+    if (offset >= (int16_t)period)
+    {
+        offset = 0;
+    }
+    if (offset != marquee.offset)
+    {
+        marquee.offset = offset;
+        Page_Invalidate_Rect(page, marquee.x, marquee.top, marquee.w, UI_MARQUEE_ROWS);
+    }
+}
+
+/**
+ * @brief 绘制一行可能超宽的文字
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 可见区域左端X坐标
+ * @param[in] y 基线Y坐标
+ * @param[in] w 可见区域宽度
+ * @param[in] text 文字
+ * @return 无
+ */
+void UI_Marquee_Draw(u8g2_t *u8g2, int16_t x, int16_t y, int16_t w, const char *text)
+{
+    if (!UI_Marquee_Same(u8g2, text))
+    {
+        if ((int16_t)app_i18n_width(u8g2, text) <= w)
+        {
+            marquee.active = false;
+            app_i18n_draw(u8g2, (u8g2_uint_t)x, (u8g2_uint_t)y, text);
+            return;
+        }
+        UI_Marquee_Fill(u8g2, text);
+    }
+    else if (!marquee.active)
+    {
+        // 停止后再次绘制同一段文字：从开头重新开始
+        marquee.offset = 0;
+        marquee.start = Page_Now();
+    }
+
+    marquee.active = true;
+    marquee.x = x;
+    marquee.top = y + marquee.text_top;
+    marquee.w = w;
+    if (!marquee.raster)
+    {
+        UI_Marquee_Draw_Text(u8g2, x, y);
+        return;
+    }
+#if APP_DLIST_ACTIVE
+    if (app_dlist_recording())
+    {
+        app_dlist_add_blit(UI_Marquee_Blit, x, marquee.top, UI_MARQUEE_ROWS);
+        return;
+    }
+#endif
+    UI_Marquee_Blit(u8g2, x, marquee.top);
+}
+
+/** @} */
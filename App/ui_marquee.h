@@ -0,0 +1,73 @@
+/**
+ * @file      ui_marquee.h
+ * @brief     超宽文字的跑马灯控件头文件
+ * @details   多语言文本和城市名称可能比可用的宽度更长，u8g2_DrawStr 只会把超出的部分裁掉。
+ *            本控件在文字变化时把整个字符串光栅化一次，存入一条横向的 1bpp 位图 (按 SSD1306 的页式布局存放)，
+ *            之后每一帧只按列偏移把位图复制到显存，不再解码字形；文字首尾之间留出 UI_MARQUEE_GAP 的空白后循环。
+ *            页面 loop 中调用 UI_Marquee_Tick，偏移改变时只使控件所在的那一行失效。
+ *            同一时刻只有一行文字在滚动 (通常是列表的选中项)，控件只有一份全局的位图。
+ *            显示器旋转、字体过高或文字超过位图宽度时退回为逐帧用 u8g2 绘制偏移后的字符串。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __UI_MARQUEE_H
+#define __UI_MARQUEE_H
+
+#include "app_display.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup UI_Marquee 跑马灯控件
+ * @brief 提供了预光栅化、按列偏移复制的滚动文字。
+ * @{
+ */
+
+/**
+ * @defgroup UI_Marquee_Config 跑马灯控件配置
+ * @{
+ */
+#define UI_MARQUEE_MAX_COLS 240  ///< 位图的最大宽度 (像素)，不超过 255 (u8g2_uint_t 可能为8位)
+#define UI_MARQUEE_PAGES    2    ///< 位图的高度 (8像素一页)，须容纳字体的最大字形高度
+#define UI_MARQUEE_TEXT_MAX 48   ///< 文字的最大长度 (含结尾的 '\0')，更长的部分不显示
+#define UI_MARQUEE_GAP      24   ///< 文字末尾与下一轮开头之间的空白 (像素)
+#define UI_MARQUEE_SPEED    30   ///< 滚动速度 (像素/秒)
+#define UI_MARQUEE_PAUSE_MS 1500 ///< 每一轮开始前停在文字开头的时间 (ms)
+/** @} */
+
+/**
+ * @brief 停止滚动，文字改变 (如列表的选中项移动) 或页面进入时调用
+ * @details 之后的 UI_Marquee_Tick 不再使区域失效，下一次 UI_Marquee_Draw 从文字开头重新开始。
+ * @return 无
+ */
+void UI_Marquee_Reset(void);
+
+/**
+ * @brief 跑马灯的逻辑步进，在页面 loop 中调用
+ * @details 按 Page_Now() 计算偏移，改变时使最近一次绘制的区域 (宽度 w，高度 UI_MARQUEE_PAGES 页) 失效。
+ *          没有需要滚动的文字或切换动画进行中时无操作。
+ * @param[in] page 所属页面
+ * @return 无
+ */
+void UI_Marquee_Tick(const Page_Base *page);
+
+/**
+ * @brief 绘制一行可能超宽的文字
+ * @details 使用当前字体和绘图颜色，以透明方式绘制，遵守当前的裁剪窗口和条带 (分页模式)。
+ *          文字不超过 w 时与 app_i18n_draw 相同并停止滚动；超过时只在 [x, x + w) 内显示，
+ *          文字或字体与上一次不同时重新光栅化并从开头开始。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 可见区域左端X坐标
+ * @param[in] y 基线Y坐标
+ * @param[in] w 可见区域宽度
+ * @param[in] text 文字
+ * @return 无
+ */
+void UI_Marquee_Draw(u8g2_t *u8g2, int16_t x, int16_t y, int16_t w, const char *text);
+
+/** @} */
+
+#endif /* __UI_MARQUEE_H */
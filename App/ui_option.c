@@ -0,0 +1,184 @@
+/**
+ * @file      ui_option.c
+ * @brief     通用选项设置页面
+ * @details   页面数据只有列表状态、描述指针和 text 钩子的缓冲区。绑定的字段按描述中的偏移和字节数读写，
+ *            布尔、枚举和 uint8_t 字段都能直接绑定。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "ui_option.h"
+#include "app_settings.h"
+
+/**
+ * @addtogroup UI_Option
+ * @{
+ */
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 选项页面的私有数据
+ */
+typedef struct
+{
+    UI_List_t list;                ///< 选项列表
+    const UI_Option_t *opt;        ///< 页面的描述
+    char text[UI_OPTION_TEXT_MAX]; ///< text 钩子的缓冲区
+} Option_Data_t;
+
+/* Private variables ---------------------------------------------------------*/
+PAGE_DATA_CHECK(Option_Data_t); ///< 选项页面的数据由页面管理器在进入时分配 (Page_Data)
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t Option_Get(const UI_Option_t *opt);
+static void Option_Set(const UI_Option_t *opt, uint32_t value);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 读取绑定的字段
+ * @param[in] opt 页面的描述
+ * @return uint32_t 字段的值
+ */
+static uint32_t Option_Get(const UI_Option_t *opt)
+{
+    const uint8_t *p = (const uint8_t *)&g_app_settings + opt->offset;
+
+    switch (opt->size)
+    {
+    case 2:
+        return *(const uint16_t *)p;
+    case 4:
+        return *(const uint32_t *)p;
+    default:
+        return *p;
+    }
+}
+
+/**
+ * @brief 写入绑定的字段
+ * @param[in] opt 页面的描述
+ * @param[in] value 新的值 (选项索引)
+ * @return 无
+ */
+static void Option_Set(const UI_Option_t *opt, uint32_t value)
+{
+    uint8_t *p = (uint8_t *)&g_app_settings + opt->offset;
+
+    switch (opt->size)
+    {
+    case 2:
+        *(uint16_t *)p = (uint16_t)value;
+        break;
+    case 4:
+        *(uint32_t *)p = value;
+        break;
+    default:
+        *p = (uint8_t)value;
+        break;
+    }
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 列表的项目数回调
+ * @param[in] ctx 页面数据
+ * @return uint16_t 选项数
+ */
+uint16_t UI_Option_Count(const void *ctx)
+{
+    const Option_Data_t *data = ctx;
+
+    return data->opt->count;
+}
+
+/**
+ * @brief 列表的项目文本回调
+ * @param[in] ctx 页面数据
+ * @param[in] index 选项索引
+ * @return const char* 选项文字
+ */
+const char *UI_Option_Text(const void *ctx, uint16_t index)
+{
+    Option_Data_t *data = (Option_Data_t *)ctx; // 缓冲区属于页面数据，列表只保存 const 指针
+    const char *text = (data->opt->text != NULL) ? data->opt->text(index, data->text) : NULL;
+
+    return (text != NULL) ? text : app_str(data->opt->items[index]);
+}
+
+/**
+ * @brief 选项页面的进入函数
+ * @param[in] page 页面实例
+ * @return 无
+ */
+void UI_Option_Enter(const Page_Base *page)
+{
+    Option_Data_t *data = Page_Data(page);
+
+    data->opt = page->desc;
+    // 列表控件会滚动到使当前设置可见的位置
+    UI_List_Init(&data->list, &data->opt->list, data, (uint16_t)Option_Get(data->opt));
+}
+
+/**
+ * @brief 选项页面的绘制函数
+ * @param[in] page 页面实例
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+void UI_Option_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    Option_Data_t *data = Page_Data(page);
+
+    UI_List_Draw(&data->list, u8g2, x_offset, y_offset);
+}
+
+/**
+ * @brief 选项页面的事件处理函数
+ * @param[in] page 页面实例
+ * @param[in] u8g2 指向u8g2实例的指针 (未使用)
+ * @param[in] event 指向输入事件数据的指针
+ * @return 无
+ */
+void UI_Option_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event)
+{
+    Option_Data_t *data = Page_Data(page);
+    uint16_t index = data->list.selected;
+
+    (void)u8g2;
+    switch (event->event)
+    {
+    case INPUT_EVENT_ENCODER:
+        UI_List_Move(&data->list, event->value);
+        break;
+
+    case INPUT_EVENT_COMFIRM_PRESSED:
+        if (data->opt->confirm != NULL && data->opt->confirm(page, index))
+        {
+            break;
+        }
+        Option_Set(data->opt, index);
+        app_settings_mark_dirty(); // 稍后在后台与其他修改合并写入
+        if (data->opt->apply != NULL)
+        {
+            data->opt->apply(page, index);
+        }
+        Page_Toast(app_str(STR_MSG_SETTINGS_SAVED), PAGE_TOAST_MS, Page_Toast_Back); // 显示1秒后自动返回上一页
+        break;
+
+    case INPUT_EVENT_BACK_PRESSED:
+        Go_Back_Page();
+        break;
+
+    default:
+        break;
+    }
+}
+
+/** @} */
@@ -0,0 +1,147 @@
+/**
+ * @file      ui_option.h
+ * @brief     通用选项设置页面头文件
+ * @details   自动熄屏、语言、夏令时等设置页面都是同一个模式：一个选项列表，选中项对应 `g_app_settings`
+ *            中的一个字段，确认后写入字段、标记修改 (后台合并写入)、提示已保存并返回上一页。
+ *            本模块把这部分做成由 const 描述驱动的页面引擎：页面文件只写一张描述 (选项文字、列表位置、
+ *            绑定的字段和可选的钩子)，页面实例的 enter/draw/action 直接使用 UI_Option_Enter 等函数，
+ *            描述经 Page_Base 的 desc 取得。列表的滚动和高亮条动画由通用列表控件实现。
+ *            设置改变的通知 (APP_BUS_SETTINGS_CHANGED) 由 app_settings_mark_dirty 发布，
+ *            订阅者 (如自动熄屏时间) 照常更新，只在页面本身需要额外处理时才写 apply 钩子。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __UI_OPTION_H
+#define __UI_OPTION_H
+
+#include "app_display.h"
+#include "app_i18n.h"
+#include "app_type.h"
+#include "ui_list.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup UI_Option 选项设置页面
+ * @brief 由描述驱动的单选设置页面。
+ * @{
+ */
+
+/**
+ * @defgroup UI_Option_Config 选项页面配置
+ * @{
+ */
+#define UI_OPTION_TEXT_MAX 16  ///< text 钩子可用的缓冲区字节数 (含结尾的 '\0')
+#define UI_OPTION_LEFT_X   5   ///< 高亮条左侧的X坐标
+#define UI_OPTION_WIDTH    118 ///< 高亮条的像素宽度
+#define UI_OPTION_ITEM_H   16  ///< 每个选项的像素高度
+/** @} */
+
+/**
+ * @brief 取得一个选项的文字
+ * @details 用于随设置变化的选项 (如夏令时规则的名称)，每次绘制该行时调用。
+ * @param[in] index 选项索引
+ * @param[out] buf 可用的缓冲区，UI_OPTION_TEXT_MAX 字节
+ * @return const char* 选项文字；返回 NULL 时使用描述中的文字
+ */
+typedef const char *(*UI_Option_Text_f)(uint16_t index, char *buf);
+
+/**
+ * @brief 确认键的钩子，在写入字段之前调用
+ * @param[in] page 页面实例
+ * @param[in] index 选中的选项索引
+ * @return bool 已自行处理 (不写入字段、不提示保存) 时返回 true
+ */
+typedef bool (*UI_Option_Confirm_f)(const Page_Base *page, uint16_t index);
+
+/**
+ * @brief 应用钩子，在字段写入并标记修改之后、提示已保存之前调用
+ * @param[in] page 页面实例
+ * @param[in] index 写入字段的选项索引
+ */
+typedef void (*UI_Option_Apply_f)(const Page_Base *page, uint16_t index);
+
+/**
+ * @brief 选项页面的描述，位于 Flash
+ * @details 字段用 UI_OPTION_FIELD 绑定，字段的值就是选项索引。列表布局用 UI_OPTION_LIST 生成。
+ */
+typedef struct
+{
+    UI_List_Config_t list;       ///< 列表的布局，数据源为本模块
+    const App_Str_t *items;      ///< 各选项的文字
+    uint8_t count;               ///< 选项数
+    uint8_t offset;              ///< 绑定字段在 Settings_t 中的偏移
+    uint8_t size;                ///< 绑定字段的字节数 (1、2 或 4)
+    UI_Option_Text_f text;       ///< 选项文字的钩子，可为 NULL
+    UI_Option_Confirm_f confirm; ///< 确认键的钩子，可为 NULL
+    UI_Option_Apply_f apply;     ///< 应用钩子，可为 NULL
+} UI_Option_t;
+
+/**
+ * @brief 生成描述中绑定字段的两个成员
+ * @param field Settings_t 的成员名
+ */
+#define UI_OPTION_FIELD(field) \
+    .offset = (uint8_t)offsetof(Settings_t, field), .size = (uint8_t)sizeof(((Settings_t *)0)->field)
+
+/**
+ * @brief 生成描述中的列表布局
+ * @param top 列表顶部的Y坐标
+ * @param n 可见的行数，选项更多时列表滚动
+ */
+#define UI_OPTION_LIST(top, n) \
+    .list = { .x = UI_OPTION_LEFT_X, .y = (top), .w = UI_OPTION_WIDTH, .text_x = 15, \
+              .item_h = UI_OPTION_ITEM_H, .baseline = 12, .rows = (n), .wrap = true, \
+              .font = MENU_FONT, .count = UI_Option_Count, .text = UI_Option_Text }
+
+/**
+ * @brief 列表的项目数回调 (由 UI_OPTION_LIST 引用)
+ * @param[in] ctx 页面数据
+ * @return uint16_t 选项数
+ */
+uint16_t UI_Option_Count(const void *ctx);
+
+/**
+ * @brief 列表的项目文本回调 (由 UI_OPTION_LIST 引用)
+ * @param[in] ctx 页面数据
+ * @param[in] index 选项索引
+ * @return const char* 选项文字
+ */
+const char *UI_Option_Text(const void *ctx, uint16_t index);
+
+/**
+ * @brief 选项页面的进入函数，可直接作为 Page_Base 的 enter
+ * @details 列表选中绑定字段的当前值，并滚动使其可见。
+ * @param[in] page 页面实例，desc 为 UI_Option_t
+ * @return 无
+ */
+void UI_Option_Enter(const Page_Base *page);
+
+/**
+ * @brief 选项页面的绘制函数，可直接作为 Page_Base 的 draw
+ * @param[in] page 页面实例
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+void UI_Option_Draw(const Page_Base *page, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+
+/**
+ * @brief 选项页面的事件处理函数，可直接作为 Page_Base 的 action
+ * @details 编码器移动选中项；确认键先交给 confirm 钩子，未处理时写入字段、标记修改、调用 apply 钩子，
+ *          提示已保存后返回上一页；返回键返回上一页。
+ * @param[in] page 页面实例
+ * @param[in] u8g2 指向u8g2实例的指针 (未使用)
+ * @param[in] event 指向输入事件数据的指针
+ * @return 无
+ */
+void UI_Option_Action(const Page_Base *page, u8g2_t *u8g2, const Input_Event_Data_t *event);
+
+/** @} */
+
+#endif /* __UI_OPTION_H */
@@ -0,0 +1,391 @@
+/**
+ * @file      ui_slot.c
+ * @brief     老虎机式数值选择控件
+ * @details   位图第 r 行存放在 strip[r >> 3][列] 的第 (r & 7) 位，与 SSD1306 显存的字节布局相同。
+ *            第0行相对于当前值基线的偏移为 strip_top (= 字体顶端 - 行距)，三个值依次向下相隔一个行距。
+ *            绘制时目标显存的每个字节由位图中相邻两个字节移位拼出，每列每页一次读改写。
+ *            位图有两份，以指针交换：备用的一份在页面空闲时按预测的下一个值生成，编码器事件到来后
+ *            UI_Slot_Ready 直接换上，这一帧只剩复制位图和发送。
+ * @author    SandOcean
+ * @date      2025-09-26
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "ui_slot.h"
+#include "app_display.h"
+#include "app_glyph_cache.h"
+#include <string.h>
+
+/**
+ * @addtogroup UI_Slot
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define UI_SLOT_STRIP_ROWS (UI_SLOT_MAX_PAGES * 8) ///< 位图的行数
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 控件状态
+ */
+typedef struct
+{
+    uint32_t key;                                   ///< 当前位图对应的键值
+    bool valid;                                     ///< 是否已生成 (Reset 后为 false)
+    bool raster;                                    ///< 位图是否可用，false 时逐帧绘制字符串
+    const uint8_t *font;                            ///< 生成时的字体 (退回绘制时使用)
+    int16_t pitch;                                  ///< 行距
+    int16_t strip_top;                              ///< 位图第0行相对于当前值基线的偏移
+    int16_t cols;                                   ///< 位图的有效列数
+    int16_t width;                                  ///< 当前值的像素宽度
+    char text[UI_SLOT_ROWS][UI_SLOT_TEXT_MAX];      ///< 三个值的字符串 (退回绘制时使用)
+    uint8_t strip[UI_SLOT_MAX_PAGES][UI_SLOT_MAX_COLS]; ///< 位图
+} UI_Slot_t;
+
+/* Private variables ---------------------------------------------------------*/
+static UI_Slot_t slots[2];              ///< 当前位图和备用位图
+static UI_Slot_t *slot = &slots[0];     ///< 正在显示的位图
+static UI_Slot_t *spare = &slots[1];    ///< 预先生成的相邻值的位图 (UI_Slot_Prefetch)
+static u8g2_t *slot_u8g2;               ///< 最近一次生成时的u8g2实例，供预生成使用
+
+/* Private function prototypes -----------------------------------------------*/
+static void UI_Slot_Fill(UI_Slot_t *s, u8g2_t *u8g2, uint32_t key, const char *const text[UI_SLOT_ROWS], int16_t pitch);
+static bool UI_Slot_Raster(UI_Slot_t *s, u8g2_t *u8g2);
+static uint8_t UI_Slot_Byte(int16_t col, int16_t row);
+static void UI_Slot_Blit(u8g2_t *u8g2, int16_t x, int16_t top);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 按字符串和当前字体生成一份位图
+ * @param[out] s 目标位图
+ * @param[in] u8g2 指向u8g2实例的指针 (当前字体即数值的字体)
+ * @param[in] key 键值
+ * @param[in] text 上一个值、当前值和下一个值的字符串
+ * @param[in] pitch 相邻数值基线之间的距离
+ * @return 无
+ */
+static void UI_Slot_Fill(UI_Slot_t *s, u8g2_t *u8g2, uint32_t key, const char *const text[UI_SLOT_ROWS], int16_t pitch)
+{
+    for (uint8_t k = 0; k < UI_SLOT_ROWS; k++)
+    {
+        strncpy(s->text[k], text[k], UI_SLOT_TEXT_MAX - 1);
+        s->text[k][UI_SLOT_TEXT_MAX - 1] = '\0';
+    }
+    s->key = key;
+    s->valid = true;
+    s->font = u8g2->font;
+    s->pitch = pitch;
+    s->width = (int16_t)Glyph_Cache_GetStrWidth(u8g2, s->text[1]);
+    s->raster = UI_Slot_Raster(s, u8g2);
+}
+
+/**
+ * @brief 用字形缓存把三个值光栅化到位图
+ * @param[in,out] s 目标位图 (字符串和行距已填好)
+ * @param[in] u8g2 指向u8g2实例的指针 (当前字体即数值的字体)
+ * @return bool 成功返回 true
+ */
+static bool UI_Slot_Raster(UI_Slot_t *s, u8g2_t *u8g2)
+{
+    uint32_t cols[UI_SLOT_MAX_COLS];
+    int8_t top = (int8_t)-(u8g2->font_info.max_char_height + u8g2->font_info.y_offset);
+
+    if (u8g2->cb != U8G2_R0 || 2 * s->pitch + 32 > UI_SLOT_STRIP_ROWS)
+    {
+        return false;
+    }
+
+    memset(s->strip, 0, sizeof(s->strip));
+    s->strip_top = top - s->pitch;
+    s->cols = 0;
+
+    for (uint8_t k = 0; k < UI_SLOT_ROWS; k++)
+    {
+        int16_t n = Glyph_Cache_Rasterize(u8g2, s->text[k], top, cols, UI_SLOT_MAX_COLS);
+        int16_t row = k * s->pitch;
+        uint8_t page = (uint8_t)(row >> 3);
+
+        if (n < 0)
+        {
+            return false;
+        }
+        for (int16_t c = 0; c < n; c++)
+        {
+            // 32行的列向下移到所在的行，最多跨5个字节
+            uint64_t bits = (uint64_t)cols[c] << (row & 7);
+            for (uint8_t j = 0; j < 5 && page + j < UI_SLOT_MAX_PAGES; j++)
+            {
+                s->strip[page + j][c] |= (uint8_t)(bits >> (8 * j));
+            }
+        }
+        if (n > s->cols)
+        {
+            s->cols = n;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 取出位图中从指定行开始的8行
+ * @param[in] col 列
+ * @param[in] row 起始行，可以为负或超出位图，超出的部分为0
+ * @return uint8_t bit0 为第 row 行
+ */
+static uint8_t UI_Slot_Byte(int16_t col, int16_t row)
+{
+    int16_t page;
+    uint8_t bit;
+    uint8_t v;
+
+    if (row <= -8 || row >= UI_SLOT_STRIP_ROWS)
+    {
+        return 0;
+    }
+    if (row < 0)
+    {
+        return (uint8_t)(slot->strip[0][col] << -row);
+    }
+    page = row >> 3;
+    bit = (uint8_t)(row & 7);
+    v = (uint8_t)(slot->strip[page][col] >> bit);
+    if (bit != 0 && page + 1 < UI_SLOT_MAX_PAGES)
+    {
+        v |= (uint8_t)(slot->strip[page + 1][col] << (8 - bit));
+    }
+    return v;
+}
+
+/**
+ * @brief 把位图复制到显存
+ * @details 可见区域取 u8g2 当前条带与裁剪窗口的交集 (user_x0/x1/y0/y1)，与字形缓存相同。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 位图左端X坐标
+ * @param[in] top 位图第0行的Y坐标
+ * @return 无
+ */
+static void UI_Slot_Blit(u8g2_t *u8g2, int16_t x, int16_t top)
+{
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+    if (!u8g2->is_page_clip_window_intersection)
+    {
+        return;
+    }
+#endif
+    int16_t y0 = (top > (int16_t)u8g2->user_y0) ? top : (int16_t)u8g2->user_y0;
+    int16_t y1 = (top + UI_SLOT_STRIP_ROWS < (int16_t)u8g2->user_y1) ? top + UI_SLOT_STRIP_ROWS : (int16_t)u8g2->user_y1;
+    int16_t c0 = ((int16_t)u8g2->user_x0 > x) ? (int16_t)u8g2->user_x0 - x : 0;
+    int16_t c1 = ((int16_t)u8g2->user_x1 < x + slot->cols) ? (int16_t)u8g2->user_x1 - x : slot->cols;
+    if (y0 >= y1 || c0 >= c1)
+    {
+        return;
+    }
+
+    int16_t buf_row = (int16_t)u8g2->pixel_curr_row;
+    int16_t page0 = (y0 - buf_row) >> 3;
+    int16_t page1 = (y1 - 1 - buf_row) >> 3;
+    uint16_t stride = u8g2->pixel_buf_width;
+    uint8_t color = u8g2->draw_color;
+
+    for (int16_t page = page0; page <= page1; page++)
+    {
+        int16_t row = buf_row + page * 8; // 本页第0行的屏幕Y坐标
+        uint8_t mask = 0xFF;
+        uint8_t *dst = u8g2->tile_buf_ptr + page * stride + x;
+
+        // 去掉可见区域之外的行
+        if (row < y0)
+        {
+            mask &= (uint8_t)(0xFF << (y0 - row));
+        }
+        if (row + 8 > y1)
+        {
+            mask &= (uint8_t)(0xFF >> (row + 8 - y1));
+        }
+
+        for (int16_t c = c0; c < c1; c++)
+        {
+            uint8_t fb = UI_Slot_Byte(c, row - top) & mask;
+            if (color == 0)
+            {
+                dst[c] &= (uint8_t)~fb;
+            }
+            else if (color == 1)
+            {
+                dst[c] |= fb;
+            }
+            else
+            {
+                dst[c] ^= fb;
+            }
+        }
+    }
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 丢弃已生成的位图
+ * @return 无
+ */
+void UI_Slot_Reset(void)
+{
+    slot->valid = false;
+    spare->valid = false;
+}
+
+/**
+ * @brief 查询位图是否已按指定键值生成
+ * @param[in] key 键值
+ * @return bool 当前位图或备用位图已按该键值生成返回 true
+ */
+bool UI_Slot_Ready(uint32_t key)
+{
+    if (slot->valid && slot->key == key)
+    {
+        return true;
+    }
+    if (spare->valid && spare->key == key)
+    {
+        // 命中预生成的位图：交换两份位图，原来的位图留作反向旋转时的备用
+        UI_Slot_t *t = slot;
+        slot = spare;
+        spare = t;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 生成位图
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] key 键值
+ * @param[in] text 上一个值、当前值和下一个值的字符串
+ * @param[in] pitch 相邻数值基线之间的距离
+ * @return 无
+ */
+void UI_Slot_Build(u8g2_t *u8g2, uint32_t key, const char *const text[UI_SLOT_ROWS], int16_t pitch)
+{
+    slot_u8g2 = u8g2;
+    UI_Slot_Fill(slot, u8g2, key, text, pitch);
+}
+
+/**
+ * @brief 在备用位图中预先生成相邻值的位图
+ * @param[in] key 键值
+ * @param[in] text 三个值的字符串
+ * @return 无
+ */
+void UI_Slot_Prefetch(uint32_t key, const char *const text[UI_SLOT_ROWS])
+{
+    u8g2_t *u8g2 = slot_u8g2;
+    const uint8_t *saved_font;
+
+    if (!slot->valid || slot->key == key || (spare->valid && spare->key == key) || u8g2 == NULL)
+    {
+        return;
+    }
+
+    // 页面循环中可能已设置了其他字体，生成后恢复
+    saved_font = u8g2->font;
+    u8g2_SetFont(u8g2, slot->font);
+    UI_Slot_Fill(spare, u8g2, key, text, slot->pitch);
+    if (saved_font != NULL)
+    {
+        u8g2_SetFont(u8g2, saved_font);
+    }
+}
+
+/**
+ * @brief 获取当前值的像素宽度
+ * @return int16_t 像素宽度
+ */
+int16_t UI_Slot_Width(void)
+{
+    return slot->width;
+}
+
+/**
+ * @brief 绘制位图
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 左端X坐标
+ * @param[in] y 当前值的基线Y坐标
+ * @param[in] offset 滚动动画的Y方向偏移
+ * @return 无
+ */
+void UI_Slot_Draw(u8g2_t *u8g2, int16_t x, int16_t y, int16_t offset)
+{
+    int16_t baseline = y + offset;
+
+    if (!slot->valid)
+    {
+        return;
+    }
+    if (slot->raster)
+    {
+#if APP_DLIST_ACTIVE
+        if (app_dlist_recording())
+        {
+            app_dlist_add_blit(UI_Slot_Blit, x, baseline + slot->strip_top, UI_SLOT_STRIP_ROWS);
+            return;
+        }
+#endif
+        UI_Slot_Blit(u8g2, x, baseline + slot->strip_top);
+        return;
+    }
+
+    // 没有位图：逐个绘制，滚出当前条带的值跳过
+    u8g2_SetFont(u8g2, slot->font);
+    for (uint8_t k = 0; k < UI_SLOT_ROWS; k++)
+    {
+        int16_t row_y = baseline + (k - 1) * slot->pitch;
+        if (Page_Strip_Text_Visible(u8g2, row_y))
+        {
+            u8g2_DrawStr(u8g2, x, row_y, slot->text[k]);
+        }
+    }
+}
+
+/**
+ * @brief 绘制聚焦动画中按比例缩放的数值
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] small_font 未聚焦时的字体
+ * @param[in] large_font 聚焦时的字体
+ * @param[in] cx 数值中心的X坐标
+ * @param[in] y 基线Y坐标
+ * @param[in] str 数值字符串
+ * @param[in] p 动画进度 (Q16)
+ * @return bool 已绘制返回 true
+ */
+bool UI_Slot_Draw_Zoom(u8g2_t *u8g2, const uint8_t *small_font, const uint8_t *large_font,
+                       int16_t cx, int16_t y, const char *str, q16_t p)
+{
+    int32_t small_ascent, large_ascent;
+    uint32_t scale0, scale;
+    int16_t width;
+
+    if (Page_Manager_Quality() >= PAGE_QUALITY_CUT)
+    {
+        return false; // 帧时间超出预算，由调用者在中点切换字体
+    }
+    u8g2_SetFont(u8g2, small_font);
+    small_ascent = u8g2->font_info.ascent_A;
+    u8g2_SetFont(u8g2, large_font);
+    large_ascent = u8g2->font_info.ascent_A;
+    if (small_ascent <= 0 || large_ascent <= 0 || small_ascent > large_ascent)
+    {
+        return false;
+    }
+
+    // 起始比例使数字高度与小字体相同，随进度线性增大到1
+    scale0 = (uint32_t)((small_ascent << 16) / large_ascent);
+    scale = scale0 + (uint32_t)(((int64_t)(Q16_ONE - scale0) * p) >> 16);
+
+    width = (int16_t)((Glyph_Cache_GetStrWidth(u8g2, str) * scale + 0x8000UL) >> 16);
+    return Glyph_Cache_DrawStr_Scaled(u8g2, cx - width / 2, y, str, scale) >= 0;
+}
+
+/** @} */
@@ -0,0 +1,111 @@
+/**
+ * @file      ui_slot.h
+ * @brief     老虎机式数值选择控件头文件
+ * @details   日期和时间设置页面聚焦某一项时，显示上一个值、当前值和下一个值，旋转编码器时三者一起滚动。
+ *            本控件在数值变化时把这三个值一次性光栅化成一条竖直的 1bpp 位图 (按 SSD1306 的页式布局存放)，
+ *            滚动动画的每一帧只需把位图按偏移量复制到显存，不再格式化数值、查询宽度或解码字形。
+ *            位图由字形缓存生成；字体不可缓存或显示器旋转时退回为逐帧用 u8g2_DrawStr 绘制三个值。
+ *            同一时刻只有一个数值处于聚焦状态，控件只有一份全局的当前位图，另有一份备用位图：
+ *            页面空闲时用 UI_Slot_Prefetch 按上一次的旋转方向预先生成下一个值的位图，
+ *            旋转后 UI_Slot_Ready 命中备用位图时直接交换，事件到来的这一帧不再光栅化。
+ * @author    SandOcean
+ * @date      2025-09-26
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __UI_SLOT_H
+#define __UI_SLOT_H
+
+#include "u8g2.h"
+#include "app_anim.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup UI_Slot 老虎机控件
+ * @brief 提供了预光栅化的滚动数值显示。
+ * @{
+ */
+
+/**
+ * @defgroup UI_Slot_Config 老虎机控件配置
+ * @{
+ */
+#define UI_SLOT_ROWS      3  ///< 位图中的数值个数 (上一个、当前、下一个)
+#define UI_SLOT_MAX_COLS  64 ///< 位图的最大宽度 (像素)，4位年份加余量
+#define UI_SLOT_MAX_PAGES 10 ///< 位图的最大高度 (8像素一页)，须容纳 2 * 行距 + 字形高度
+#define UI_SLOT_TEXT_MAX  8  ///< 每个数值字符串的最大长度 (含结尾的 '\0')
+/** @} */
+
+/**
+ * @brief 丢弃已生成的位图，页面进入时调用，避免与其他页面的键值混淆
+ * @return 无
+ */
+void UI_Slot_Reset(void);
+
+/**
+ * @brief 查询位图是否已按指定键值生成
+ * @param[in] key 页面定义的键值，通常由聚焦的项目和当前值组成
+ * @return bool 已生成返回 true，此时不需要重新调用 UI_Slot_Build
+ */
+bool UI_Slot_Ready(uint32_t key);
+
+/**
+ * @brief 生成位图
+ * @details 使用当前字体。text[0] 位于当前值上方一个行距，text[2] 位于下方一个行距，三个值左端对齐。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] key 键值，之后 UI_Slot_Ready(key) 返回 true
+ * @param[in] text 上一个值、当前值和下一个值的字符串
+ * @param[in] pitch 相邻数值基线之间的距离 (像素)
+ * @return 无
+ */
+void UI_Slot_Build(u8g2_t *u8g2, uint32_t key, const char *const text[UI_SLOT_ROWS], int16_t pitch);
+
+/**
+ * @brief 在备用位图中预先生成下一个值的位图
+ * @details 在页面循环 (不绘制时) 调用。使用最近一次 UI_Slot_Build 的u8g2实例、字体和行距，
+ *          之后 UI_Slot_Ready(key) 交换两份位图并返回 true。当前位图或备用位图已是该键值时无操作，
+ *          尚未生成过当前位图时也无操作。
+ * @param[in] key 预测的下一个值对应的键值
+ * @param[in] text 该值的上一个值、该值和下一个值的字符串
+ * @return 无
+ */
+void UI_Slot_Prefetch(uint32_t key, const char *const text[UI_SLOT_ROWS]);
+
+/**
+ * @brief 获取当前值的像素宽度，用于居中
+ * @return int16_t 像素宽度
+ */
+int16_t UI_Slot_Width(void);
+
+/**
+ * @brief 绘制位图
+ * @details 以透明方式写入显存，遵守当前的裁剪窗口、条带 (分页模式) 和绘图颜色。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x 左端X坐标
+ * @param[in] y 当前值的基线Y坐标 (不含滚动偏移)
+ * @param[in] offset 滚动动画的Y方向偏移
+ * @return 无
+ */
+void UI_Slot_Draw(u8g2_t *u8g2, int16_t x, int16_t y, int16_t offset);
+
+/**
+ * @brief 绘制聚焦动画中按比例缩放的数值
+ * @details 用大字体按比例缩小绘制：进度为0时字高与小字体相同，进度为1时为大字体原尺寸，
+ *          缩放动画的每一帧尺寸连续变化，而不是在中点突然换成大字体。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] small_font 未聚焦时的字体，只用于确定起始尺寸
+ * @param[in] large_font 聚焦时的字体
+ * @param[in] cx 数值中心的X坐标
+ * @param[in] y 基线Y坐标
+ * @param[in] str 数值字符串
+ * @param[in] p 动画进度 (Q16，0 为小字体尺寸，Q16_ONE 为大字体尺寸)
+ * @return bool 已绘制返回 true；字体不可缓存、显示器旋转或画质降到 PAGE_QUALITY_CUT 及以下时返回 false，由调用者按原方式绘制
+ */
+bool UI_Slot_Draw_Zoom(u8g2_t *u8g2, const uint8_t *small_font, const uint8_t *large_font,
+                       int16_t cx, int16_t y, const char *str, q16_t p);
+
+/** @} */
+
+#endif /* __UI_SLOT_H */
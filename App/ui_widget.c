@@ -0,0 +1,412 @@
+/**
+ * @file      ui_widget.c
+ * @brief     保留模式控件树
+ * @details   控件的屏幕位置由所在分组的位置和偏移累加得到，控件表中父控件排在前面，
+ *            绘制时按表的顺序一次遍历就能依次求出每个控件的位置和是否隐藏，不需要递归。
+ *            可见性按 u8g2 的用户裁剪窗口 (列) 和页面管理器的当前条带 (行) 判断，与字形缓存的裁剪一致。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "ui_widget.h"
+#include "ui_slot.h"
+#include "app_i18n.h"
+#include "app_fmt.h"
+#include <string.h>
+
+/**
+ * @addtogroup UI_Widget
+ * @{
+ */
+
+/* Private function prototypes -----------------------------------------------*/
+static bool Widget_Origin(const UI_Widget_Tree_t *tree, uint8_t id, int16_t *x, int16_t *y);
+static void Widget_Text(const UI_Widget_t *w, const UI_Widget_State_t *s, char *buf, const char **text);
+static void Widget_Draw_Text(u8g2_t *u8g2, const UI_Widget_t *w, const char *text, int16_t x, int16_t y);
+static void Widget_Draw_Graph(u8g2_t *u8g2, const UI_Widget_t *w, const UI_Widget_State_t *s, int16_t x, int16_t y);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 求控件在页面上的位置
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @param[out] x 区域左端 (不含屏幕偏移)
+ * @param[out] y 区域顶端 (不含屏幕偏移)
+ * @return bool 控件及其所在的分组都没有隐藏时返回 true
+ */
+static bool Widget_Origin(const UI_Widget_Tree_t *tree, uint8_t id, int16_t *x, int16_t *y)
+{
+    bool shown = !tree->state[id].hidden;
+
+    *x = tree->nodes[id].x;
+    *y = tree->nodes[id].y;
+    for (uint8_t p = tree->nodes[id].parent; p < tree->count; p = tree->nodes[p].parent)
+    {
+        *x += tree->nodes[p].x + tree->state[p].dx;
+        *y += tree->nodes[p].y + tree->state[p].dy;
+        shown = shown && !tree->state[p].hidden;
+    }
+    return shown;
+}
+
+/**
+ * @brief 取得 LABEL 或 VALUE 显示的文字
+ * @param[in] w 控件描述
+ * @param[in] s 控件属性
+ * @param[out] buf VALUE 格式化的缓冲区，至少 UI_WIDGET_TEXT_MAX 字节
+ * @param[out] text 显示的文字
+ * @return 无
+ */
+static void Widget_Text(const UI_Widget_t *w, const UI_Widget_State_t *s, char *buf, const char **text)
+{
+    char *p = buf;
+    int32_t v;
+
+    if (w->kind == UI_WIDGET_LABEL)
+    {
+        *text = (s->v.text != NULL) ? s->v.text : ((w->text != NULL) ? w->text : "");
+        return;
+    }
+    v = s->v.value;
+    if (w->arg == 1)
+    {
+        p = fmt_q1(p, v);
+    }
+    else
+    {
+        if (v < 0)
+        {
+            p = fmt_char(p, '-');
+            v = -v;
+        }
+        p = fmt_uint(p, (uint32_t)v, 1);
+    }
+    if (w->text != NULL && strlen(w->text) < (size_t)(UI_WIDGET_TEXT_MAX - (p - buf)))
+    {
+        fmt_str(p, w->text);
+    }
+    *text = buf;
+}
+
+/**
+ * @brief 在区域内按对齐方式绘制一行文字
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] w 控件描述
+ * @param[in] text 文字
+ * @param[in] x 区域左端 (屏幕坐标)
+ * @param[in] y 区域顶端 (屏幕坐标)
+ * @return 无
+ */
+static void Widget_Draw_Text(u8g2_t *u8g2, const UI_Widget_t *w, const char *text, int16_t x, int16_t y)
+{
+    bool i18n = (w->flags & UI_WIDGET_I18N) != 0;
+    int16_t width;
+
+    if (w->font != NULL)
+    {
+        u8g2_SetFont(u8g2, i18n ? app_i18n_font(w->font) : w->font);
+    }
+    if (w->align != UI_WIDGET_LEFT)
+    {
+        width = (int16_t)(i18n ? app_i18n_width(u8g2, text) : Page_Str_Width(u8g2, text));
+        x += (w->align == UI_WIDGET_CENTER) ? (w->w - width) / 2 : w->w - width;
+    }
+    if (i18n)
+    {
+        app_i18n_draw(u8g2, x, y + w->base, text);
+    }
+    else
+    {
+        u8g2_DrawStr(u8g2, x, y + w->base, text);
+    }
+}
+
+/**
+ * @brief 绘制曲线
+ * @details 按序列的最小、最大值缩放到区域的高度，相邻点之间画线段；所有点相同时画在区域中间。
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] w 控件描述
+ * @param[in] s 控件属性
+ * @param[in] x 区域左端 (屏幕坐标)
+ * @param[in] y 区域顶端 (屏幕坐标)
+ * @return 无
+ */
+static void Widget_Draw_Graph(u8g2_t *u8g2, const UI_Widget_t *w, const UI_Widget_State_t *s, int16_t x, int16_t y)
+{
+    const int16_t *v = (const int16_t *)s->v.data;
+    int16_t lo, hi;
+    int32_t range;
+    int16_t px = 0, py = 0;
+
+    if (v == NULL || s->n < 2 || w->w < 2 || w->h < 2)
+    {
+        return;
+    }
+    lo = hi = v[0];
+    for (uint8_t i = 1; i < s->n; i++)
+    {
+        if (v[i] < lo) lo = v[i];
+        if (v[i] > hi) hi = v[i];
+    }
+    range = (int32_t)hi - lo;
+    for (uint8_t i = 0; i < s->n; i++)
+    {
+        int16_t cx = (int16_t)(x + (int32_t)i * (w->w - 1) / (s->n - 1));
+        int16_t cy = (range == 0) ? (int16_t)(y + w->h / 2)
+                                  : (int16_t)(y + w->h - 1 - ((int32_t)v[i] - lo) * (w->h - 1) / range);
+        if (i > 0)
+        {
+            u8g2_DrawLine(u8g2, px, py, cx, cy);
+        }
+        px = cx;
+        py = cy;
+    }
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 把全部属性恢复为初始值，并使整页失效
+ * @param[in] tree 控件树
+ * @return 无
+ */
+void UI_Widget_Init(const UI_Widget_Tree_t *tree)
+{
+    memset(tree->state, 0, tree->count * sizeof(tree->state[0]));
+    for (uint8_t i = 0; i < tree->count; i++)
+    {
+        if (tree->nodes[i].kind == UI_WIDGET_ICON)
+        {
+            tree->state[i].v.value = tree->nodes[i].arg;
+        }
+    }
+    Page_Invalidate(tree->page);
+}
+
+/**
+ * @brief 设置 LABEL 的文字
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @param[in] text 文字，NULL 恢复为描述中的文字
+ * @return 无
+ */
+void UI_Widget_Set_Text(const UI_Widget_Tree_t *tree, uint8_t id, const char *text)
+{
+    if (tree->state[id].v.text != text)
+    {
+        tree->state[id].v.text = text;
+        UI_Widget_Damage(tree, id);
+    }
+}
+
+/**
+ * @brief 设置 VALUE 的数值、ICON 的图标编号或 SLOT 的位图键值
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @param[in] value 新的值
+ * @return 无
+ */
+void UI_Widget_Set_Value(const UI_Widget_Tree_t *tree, uint8_t id, int32_t value)
+{
+    if (tree->state[id].v.value != value)
+    {
+        tree->state[id].v.value = value;
+        UI_Widget_Damage(tree, id);
+    }
+}
+
+/**
+ * @brief 设置 LIST 的列表或 GRAPH 的序列
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @param[in] data UI_List_t 或 int16_t 序列
+ * @param[in] n 序列的点数
+ * @return 无
+ */
+void UI_Widget_Set_Data(const UI_Widget_Tree_t *tree, uint8_t id, const void *data, uint8_t n)
+{
+    if (tree->state[id].v.data != data || tree->state[id].n != n)
+    {
+        tree->state[id].v.data = data;
+        tree->state[id].n = n;
+        UI_Widget_Damage(tree, id);
+    }
+}
+
+/**
+ * @brief 设置 GROUP 的偏移或 SLOT 的滚动偏移
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @param[in] dx X方向偏移
+ * @param[in] dy Y方向偏移
+ * @return 无
+ */
+void UI_Widget_Set_Offset(const UI_Widget_Tree_t *tree, uint8_t id, int8_t dx, int8_t dy)
+{
+    UI_Widget_State_t *s = &tree->state[id];
+
+    if (s->dx == dx && s->dy == dy)
+    {
+        return;
+    }
+    if (tree->nodes[id].kind == UI_WIDGET_GROUP)
+    {
+        UI_Widget_Damage(tree, id); // 移动前的位置
+    }
+    s->dx = dx;
+    s->dy = dy;
+    UI_Widget_Damage(tree, id);
+}
+
+/**
+ * @brief 显示或隐藏控件
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @param[in] hidden 为 true 时隐藏
+ * @return 无
+ */
+void UI_Widget_Set_Hidden(const UI_Widget_Tree_t *tree, uint8_t id, bool hidden)
+{
+    if (tree->state[id].hidden == hidden)
+    {
+        return;
+    }
+    if (hidden)
+    {
+        UI_Widget_Damage(tree, id); // 隐藏之后不再失效，先擦除原来的区域
+    }
+    tree->state[id].hidden = hidden;
+    UI_Widget_Damage(tree, id);
+}
+
+/**
+ * @brief 使控件的区域失效
+ * @details 分组的偏移不改变它自己的区域 (偏移只作用于子控件)，这里按子控件所在的位置使区域失效。
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @return 无
+ */
+void UI_Widget_Damage(const UI_Widget_Tree_t *tree, uint8_t id)
+{
+    const UI_Widget_t *w = &tree->nodes[id];
+    int16_t x, y;
+
+    if (!Widget_Origin(tree, id, &x, &y))
+    {
+        return;
+    }
+    if (w->kind == UI_WIDGET_GROUP)
+    {
+        x += tree->state[id].dx;
+        y += tree->state[id].dy;
+    }
+    Page_Invalidate_Rect(tree->page, x, y, w->w, w->h);
+}
+
+/**
+ * @brief 推进控件树中的动画
+ * @param[in] tree 控件树
+ * @return 无
+ */
+void UI_Widget_Tick(const UI_Widget_Tree_t *tree)
+{
+    for (uint8_t i = 0; i < tree->count; i++)
+    {
+        const UI_List_t *list = (const UI_List_t *)tree->state[i].v.data;
+
+        if (tree->nodes[i].kind == UI_WIDGET_LIST && list != NULL && UI_List_Is_Animating(list))
+        {
+            UI_Widget_Damage(tree, i);
+        }
+    }
+}
+
+/**
+ * @brief 绘制控件树
+ * @param[in] tree 控件树
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+void UI_Widget_Draw(const UI_Widget_Tree_t *tree, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset)
+{
+    int16_t ox[UI_WIDGET_MAX], oy[UI_WIDGET_MAX];
+    bool shown[UI_WIDGET_MAX];
+    char buf[UI_WIDGET_TEXT_MAX];
+    uint8_t count = (tree->count < UI_WIDGET_MAX) ? tree->count : UI_WIDGET_MAX;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const UI_Widget_t *w = &tree->nodes[i];
+        const UI_Widget_State_t *s = &tree->state[i];
+        uint8_t p = w->parent;
+        int16_t x, y;
+        const char *text;
+
+        ox[i] = w->x;
+        oy[i] = w->y;
+        shown[i] = !s->hidden;
+        if (p < i)
+        {
+            ox[i] += ox[p] + tree->state[p].dx;
+            oy[i] += oy[p] + tree->state[p].dy;
+            shown[i] = shown[i] && shown[p];
+        }
+        x = ox[i] + x_offset;
+        y = oy[i] + y_offset;
+
+        // 隐藏的控件、分组本身和区域之外的控件都不绘制
+        if (!shown[i] || w->kind == UI_WIDGET_GROUP || x >= (int16_t)u8g2->user_x1 ||
+            x + w->w <= (int16_t)u8g2->user_x0 || !Page_Strip_Visible(y, w->h))
+        {
+            continue;
+        }
+        switch (w->kind)
+        {
+        case UI_WIDGET_LABEL:
+        case UI_WIDGET_VALUE:
+            Widget_Text(w, s, buf, &text);
+            Widget_Draw_Text(u8g2, w, text, x, y);
+            break;
+        case UI_WIDGET_LIST:
+            if (s->v.data != NULL)
+            {
+                UI_List_Draw((const UI_List_t *)s->v.data, u8g2, x_offset, y_offset);
+            }
+            break;
+        case UI_WIDGET_SLOT:
+            if (UI_Slot_Ready((uint32_t)s->v.value))
+            {
+                UI_Slot_Draw(u8g2, x, y + w->base, s->dy);
+            }
+            break;
+        case UI_WIDGET_ICON:
+            UI_Icon_Draw(u8g2, x, y, (UI_Icon_e)s->v.value);
+            break;
+        case UI_WIDGET_GRAPH:
+            Widget_Draw_Graph(u8g2, w, s, x, y);
+            break;
+        case UI_WIDGET_FILL:
+            u8g2_DrawBox(u8g2, x, y, w->w, w->h);
+            break;
+        case UI_WIDGET_CUSTOM:
+            if (w->draw != NULL)
+            {
+                w->draw(tree->page, u8g2, x_offset, y_offset);
+            }
+            break;
+        default:
+            break;
+        }
+        if (w->flags & UI_WIDGET_INVERT)
+        {
+            Page_Invert_Rect(u8g2, x, y, w->w, w->h);
+        }
+    }
+}
+
+/** @} */
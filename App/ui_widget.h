@@ -0,0 +1,217 @@
+/**
+ * @file      ui_widget.h
+ * @brief     保留模式控件树头文件
+ * @details   页面的 draw 原本都是立即模式：每次重绘把自己的全部内容画一遍。本模块提供可选的保留模式：
+ *            页面用一张 const 控件表 (Flash) 描述布局，控件的属性 (文字、数值、图标、数据、偏移、隐藏)
+ *            保存在一个小的 RAM 数组中，由设置函数修改；属性真正改变时设置函数用 Page_Invalidate_Rect
+ *            使该控件的区域失效，管理器合并失效区域、清除并裁剪后调用 draw，draw 中的 UI_Widget_Draw
+ *            只绘制与裁剪窗口和当前条带相交的控件，显存差分随后只发送变化的字节。
+ *            页面不再自己计算哪些区域需要刷新，draw 也不再逐项判断可见性，新页面只需写控件表和几个设置调用。
+ *            控件表中父控件 (分组) 必须排在子控件之前，子控件的坐标相对所在分组，分组可以整体移动或隐藏。
+ *            已有的立即模式页面不需要修改；要在控件树中复用立即模式的绘制代码，使用兼容控件 UI_WIDGET_CUSTOM，
+ *            它在自己的区域与重绘区域相交时调用原来的绘制函数。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __UI_WIDGET_H
+#define __UI_WIDGET_H
+
+#include "app_display.h"
+#include "ui_list.h"
+#include "ui_icon.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup UI_Widget 控件树
+ * @brief 带失效区域跟踪的保留模式控件。
+ * @{
+ */
+
+/**
+ * @defgroup UI_Widget_Config 控件树配置
+ * @{
+ */
+#define UI_WIDGET_MAX      16   ///< 一棵控件树的最大控件数
+#define UI_WIDGET_ROOT     0xFF ///< parent 取该值表示控件直接位于页面上
+#define UI_WIDGET_TEXT_MAX 16   ///< VALUE 控件格式化后的最大长度 (含后缀和结尾的 '\0')
+/** @} */
+
+/**
+ * @brief 控件类型
+ */
+typedef enum
+{
+    UI_WIDGET_GROUP = 0, ///< 分组：子控件的坐标相对它，随它一起移动和隐藏，本身不绘制
+    UI_WIDGET_LABEL,     ///< 文字：初始为 text，可用 UI_Widget_Set_Text 替换
+    UI_WIDGET_VALUE,     ///< 数值：按 arg 位小数格式化，后接 text (单位)
+    UI_WIDGET_LIST,      ///< 列表：绘制 UI_Widget_Set_Data 给出的 UI_List_t，布局由列表自己的配置决定
+    UI_WIDGET_SLOT,      ///< 老虎机：数值为位图的键值，位图由页面用 UI_Slot_Build 生成，偏移为滚动量
+    UI_WIDGET_ICON,      ///< 图标：数值为图标编号 (UI_Icon_e)，初始为 arg
+    UI_WIDGET_GRAPH,     ///< 曲线：UI_Widget_Set_Data 给出的 int16_t 序列，按最小最大值缩放到区域内
+    UI_WIDGET_FILL,      ///< 实心矩形：分隔线、进度条底色等
+    UI_WIDGET_CUSTOM     ///< 兼容控件：区域与重绘区域相交时调用立即模式的绘制函数 draw
+} UI_Widget_Kind_e;
+
+/**
+ * @brief 文字在控件区域内的对齐方式
+ */
+typedef enum
+{
+    UI_WIDGET_LEFT = 0, ///< 左对齐
+    UI_WIDGET_CENTER,   ///< 居中
+    UI_WIDGET_RIGHT     ///< 右对齐
+} UI_Widget_Align_e;
+
+/**
+ * @defgroup UI_Widget_Flags 控件标志
+ * @{
+ */
+#define UI_WIDGET_I18N   0x01 ///< 文字是界面文字表中的文字，用 app_i18n_font() 和 app_i18n_draw() 绘制
+#define UI_WIDGET_INVERT 0x02 ///< 绘制后把整个区域反色 (选中的项目等)
+/** @} */
+
+/**
+ * @brief 控件的描述，位于 Flash
+ */
+typedef struct
+{
+    uint8_t kind;        ///< 控件类型 (UI_Widget_Kind_e)
+    uint8_t parent;      ///< 所在分组在表中的下标，须小于本控件的下标；UI_WIDGET_ROOT 为页面本身
+    uint8_t align;       ///< 文字的对齐方式 (UI_Widget_Align_e)
+    uint8_t flags;       ///< 标志 (UI_WIDGET_I18N 等)
+    int16_t x;           ///< 区域左端，相对所在分组
+    int16_t y;           ///< 区域顶端，相对所在分组
+    uint8_t w;           ///< 区域宽度，须覆盖控件绘制的全部像素
+    uint8_t h;           ///< 区域高度
+    uint8_t base;        ///< 文字基线相对区域顶端的偏移 (LABEL、VALUE、SLOT)
+    uint8_t arg;         ///< VALUE 的小数位数 (0 或 1)；ICON 的初始图标
+    const uint8_t *font; ///< 字体，NULL 时沿用当前字体
+    const char *text;    ///< LABEL 的初始文字；VALUE 的后缀，可为 NULL
+    Page_Draw_f draw;    ///< CUSTOM 的绘制函数，参数与页面的 draw 相同
+} UI_Widget_t;
+
+/**
+ * @brief 控件的属性，位于 RAM
+ */
+typedef struct
+{
+    union
+    {
+        const char *text; ///< LABEL：当前文字，NULL 时为描述中的 text
+        int32_t value;    ///< VALUE：数值；SLOT：位图的键值；ICON：图标编号
+        const void *data; ///< LIST：UI_List_t；GRAPH：int16_t 序列
+    } v;
+    int8_t dx;     ///< GROUP 的X方向偏移
+    int8_t dy;     ///< GROUP 的Y方向偏移；SLOT 的滚动偏移
+    uint8_t n;     ///< GRAPH 的点数
+    bool hidden;   ///< 是否隐藏 (分组隐藏时其中的控件一起隐藏)
+} UI_Widget_State_t;
+
+/**
+ * @brief 一棵控件树
+ * @details 通常在页面文件中定义为 const，属性数组为同一文件中的静态数组，两者都不占用页面私有数据。
+ */
+typedef struct
+{
+    const UI_Widget_t *nodes; ///< 控件表
+    UI_Widget_State_t *state; ///< 各控件的属性，与控件表一一对应
+    const Page_Base *page;    ///< 所属页面，属性改变时使其中的区域失效
+    uint8_t count;            ///< 控件数，不超过 UI_WIDGET_MAX
+} UI_Widget_Tree_t;
+
+/**
+ * @brief 把全部属性恢复为初始值，并使整页失效
+ * @details 页面进入时调用。
+ * @param[in] tree 控件树
+ * @return 无
+ */
+void UI_Widget_Init(const UI_Widget_Tree_t *tree);
+
+/**
+ * @brief 设置 LABEL 的文字
+ * @details 指针不同时才失效。文字须在显示期间保持有效；同一缓冲区中的内容改变时改用 UI_Widget_Damage。
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @param[in] text 文字，NULL 恢复为描述中的文字
+ * @return 无
+ */
+void UI_Widget_Set_Text(const UI_Widget_Tree_t *tree, uint8_t id, const char *text);
+
+/**
+ * @brief 设置 VALUE 的数值、ICON 的图标编号或 SLOT 的位图键值
+ * @details 数值不变时不失效。
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @param[in] value 新的值
+ * @return 无
+ */
+void UI_Widget_Set_Value(const UI_Widget_Tree_t *tree, uint8_t id, int32_t value);
+
+/**
+ * @brief 设置 LIST 的列表或 GRAPH 的序列
+ * @details 数据须在显示期间保持有效；数据本身改变时 (列表移动、序列新增一点) 改用 UI_Widget_Damage。
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @param[in] data UI_List_t 或 int16_t 序列
+ * @param[in] n 序列的点数 (LIST 不使用)
+ * @return 无
+ */
+void UI_Widget_Set_Data(const UI_Widget_Tree_t *tree, uint8_t id, const void *data, uint8_t n);
+
+/**
+ * @brief 设置 GROUP 的偏移或 SLOT 的滚动偏移
+ * @details 分组移动时移动前后的区域都失效。
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @param[in] dx X方向偏移 (SLOT 不使用)
+ * @param[in] dy Y方向偏移
+ * @return 无
+ */
+void UI_Widget_Set_Offset(const UI_Widget_Tree_t *tree, uint8_t id, int8_t dx, int8_t dy);
+
+/**
+ * @brief 显示或隐藏控件
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @param[in] hidden 为 true 时隐藏
+ * @return 无
+ */
+void UI_Widget_Set_Hidden(const UI_Widget_Tree_t *tree, uint8_t id, bool hidden);
+
+/**
+ * @brief 使控件的区域失效
+ * @details 用于属性之外的内容改变：LABEL 缓冲区中的文字、列表的选中项、曲线的数据、兼容控件的内容。
+ *          隐藏的控件不失效。
+ * @param[in] tree 控件树
+ * @param[in] id 控件下标
+ * @return 无
+ */
+void UI_Widget_Damage(const UI_Widget_Tree_t *tree, uint8_t id);
+
+/**
+ * @brief 推进控件树中的动画
+ * @details 在页面的 loop 中调用：高亮条或滚动的弹簧未停稳的列表使自己的区域失效。
+ * @param[in] tree 控件树
+ * @return 无
+ */
+void UI_Widget_Tick(const UI_Widget_Tree_t *tree);
+
+/**
+ * @brief 绘制控件树
+ * @details 在页面的 draw 中调用。按表中的顺序绘制，跳过隐藏的控件和区域不与当前裁剪窗口、条带相交的控件；
+ *          管理器只清除了失效区域，与之相交的未改变的控件也会重绘，因此区域之外的像素保持不变。
+ * @param[in] tree 控件树
+ * @param[in] u8g2 指向u8g2实例的指针
+ * @param[in] x_offset 屏幕的X方向偏移
+ * @param[in] y_offset 屏幕的Y方向偏移
+ * @return 无
+ */
+void UI_Widget_Draw(const UI_Widget_Tree_t *tree, u8g2_t *u8g2, int16_t x_offset, int16_t y_offset);
+
+/** @} */
+
+#endif /* __UI_WIDGET_H */
@@ -0,0 +1,696 @@
+/**
+ * @file      boot.c
+ * @brief     引导程序
+ * @details   直接操作寄存器，不使用 HAL，代码在 3KB 以内。
+ *            快速路径：复位后只读取信箱、记录页和返回键，设置 VTOR 和 MSP 后跳转，时钟仍为复位后的 HSI 8MHz，
+ *            从复位到进入应用程序不到 1ms (主要是启动代码清零接收缓冲区)。
+ *            升级模式：切换到 HSE 倍频的 72MHz (HSE 起振失败时保持 HSI)，USART1 由 DMA 循环接收。
+ *            F1 擦写 Flash 期间 CPU 从 Flash 取指被挂起，但 DMA 写 SRAM 不受影响，因此擦写第 N 块时
+ *            第 N+1 块 (主机最多领先 BOOT_WINDOW 块) 继续进入接收缓冲区，链路不需要停下来等待 Flash。
+ *            帧在接收缓冲区中原地解码 (与 app_remote 相同)，写块时直接从缓冲区读出半字写入 Flash。
+ *            升级结束后以软件复位进入应用程序，应用程序看到的是复位状态的时钟和外设。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "boot.h"
+#include "cobs.h"
+
+/**
+ * @addtogroup Boot
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define BOOT_REPLY_FLAG   0x80        ///< 应答命令码的最高位
+#define BOOT_HEADER_SIZE  2           ///< 命令 + 序号
+#define BOOT_CRC_SIZE     2           ///< CRC-16
+#define BOOT_REPLY_MAX    (BOOT_HEADER_SIZE + 1 + 2 * BOOT_QUERY_MAX + BOOT_CRC_SIZE) ///< 最长的应答负载 (查询)
+#define BOOT_RX_FRAME_MAX COBS_ENCODED_MAX(BOOT_HEADER_SIZE + 2 + BOOT_PAGE_SIZE + BOOT_CRC_SIZE) ///< 最长的请求帧 (写块，编码后)
+#define BOOT_KEY_PIN      3U          ///< 返回键 (PA3，低电平有效，即 main.h 中的 KEY_BCK)
+#define BOOT_RAM_END      0x20005000U ///< RAM 结束地址 (20KB)
+#define BOOT_HSE_TIMEOUT  0x20000U    ///< 等待 HSE 起振的循环次数 (8MHz 下约 50ms)
+
+#define RING_AT(pos) ((uint16_t)((pos) & (BOOT_RX_RING_SIZE - 1U))) ///< 环形缓冲区下标取模
+
+/** 编译期检查：接收缓冲区为 2 的幂，且在原地解码一个写块帧时还能容纳窗口内的其余帧 */
+typedef char boot_ring_size_check[((BOOT_RX_RING_SIZE & (BOOT_RX_RING_SIZE - 1U)) == 0 &&
+                                   BOOT_RX_RING_SIZE >= (BOOT_WINDOW + 1U) * (BOOT_RX_FRAME_MAX + 1U)) ? 1 : -1];
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 解码后留在接收缓冲区中的一帧
+ */
+typedef struct {
+    uint16_t start; ///< 负载在缓冲区中的起始位置
+    uint16_t len;   ///< 负载长度 (含命令、序号和CRC)
+} Boot_Frame_t;
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t rx_ring[BOOT_RX_RING_SIZE];              ///< DMA 循环接收缓冲区
+static uint16_t rx_tail;                               ///< 当前帧在缓冲区中的起点
+static uint16_t rx_scan;                               ///< 下一个要扫描的位置
+static bool rx_overlong;                               ///< 当前帧过长，丢弃到下一个分隔符
+static uint8_t reply[BOOT_REPLY_MAX];                  ///< 正在组装的应答负载
+static uint16_t reply_len;                             ///< 应答负载的长度
+static uint8_t tx_frame[COBS_ENCODED_MAX(BOOT_REPLY_MAX) + 1]; ///< 编码后的应答帧
+static volatile uint32_t boot_ms;                      ///< SysTick 毫秒计数
+static uint32_t clock_hz;                              ///< 升级模式下的系统时钟
+static bool image_open;                                ///< 已执行 BOOT_CMD_BEGIN，可以写块
+static uint32_t image_size;                            ///< BOOT_CMD_BEGIN 给出的映像长度
+static uint16_t image_crc;                             ///< BOOT_CMD_BEGIN 给出的映像 CRC
+
+/* Private function prototypes -----------------------------------------------*/
+static uint16_t crc16_update(uint16_t crc, uint8_t byte);
+static uint16_t crc16_flash(uint32_t addr, uint32_t len);
+static bool record_valid(void);
+static bool key_held(void);
+static void jump_to_app(void);
+static void clock_init(void);
+static void uart_init(void);
+static void uart_send(const uint8_t *data, uint16_t len);
+static bool flash_wait(void);
+static bool flash_erase(uint32_t addr);
+static bool flash_write(uint32_t addr, uint16_t v);
+static uint16_t cobs_decode_ring(uint16_t start, uint16_t len);
+static uint8_t frame_u8(const Boot_Frame_t *f, uint16_t i);
+static uint16_t frame_u16(const Boot_Frame_t *f, uint16_t i);
+static uint32_t frame_u32(const Boot_Frame_t *f, uint16_t i);
+static void reply_u8(uint8_t v);
+static void reply_u16(uint16_t v);
+static void reply_u32(uint32_t v);
+static Boot_Status_e cmd_begin(const Boot_Frame_t *f, uint16_t dlen);
+static Boot_Status_e cmd_query(const Boot_Frame_t *f, uint16_t dlen);
+static Boot_Status_e cmd_write(const Boot_Frame_t *f, uint16_t dlen);
+static Boot_Status_e cmd_commit(uint16_t dlen);
+static bool handle_frame(uint16_t start, uint16_t len);
+static bool boot_service(void);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief CRC-16/CCITT 加入一个字节 (与 app_store_crc16 相同，初值 0xFFFF)
+ * @param[in] crc 之前的 CRC 值
+ * @param[in] byte 字节
+ * @return uint16_t CRC 值
+ */
+static uint16_t crc16_update(uint16_t crc, uint8_t byte)
+{
+    crc ^= (uint16_t)byte << 8;
+    for (uint8_t i = 0; i < 8; i++) {
+        crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+/**
+ * @brief 计算一段 Flash 的 CRC-16
+ * @param[in] addr 起始地址
+ * @param[in] len 长度
+ * @return uint16_t CRC 值
+ */
+static uint16_t crc16_flash(uint32_t addr, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t *)addr;
+    uint16_t crc = 0xFFFF;
+
+    while (len--) {
+        crc = crc16_update(crc, *p++);
+    }
+    return crc;
+}
+
+/**
+ * @brief 检查应用程序记录和向量表
+ * @details 记录只在映像校验通过后写入，这里不重新计算 CRC；另外检查栈顶和复位向量的范围，
+ *          防止记录有效但映像被调试器改写后跳到无效地址。
+ * @return bool 可以跳转时返回 true
+ */
+static bool record_valid(void)
+{
+    const Boot_Record_t *rec = (const Boot_Record_t *)BOOT_RECORD_ADDR;
+    const uint32_t *vec = (const uint32_t *)BOOT_APP_BASE;
+
+    return rec->magic == BOOT_RECORD_MAGIC && rec->size != 0 && rec->size <= BOOT_APP_MAX &&
+           rec->crc_inv == (uint16_t)~rec->crc &&
+           vec[0] > SRAM_BASE && vec[0] <= BOOT_RAM_END &&
+           vec[1] >= BOOT_APP_BASE && vec[1] < BOOT_FLASH_END;
+}
+
+/**
+ * @brief 读取返回键是否按下
+ * @details 引脚配置为上拉输入，等待上拉稳定后读取，之后恢复 GPIOA 的复位状态。
+ * @return bool 按下返回 true
+ */
+static bool key_held(void)
+{
+    bool held;
+
+    RCC->APB2ENR |= RCC_APB2ENR_IOPAEN;
+    GPIOA->ODR = 1U << BOOT_KEY_PIN;
+    GPIOA->CRL = (GPIOA->CRL & ~(0xFU << (BOOT_KEY_PIN * 4U))) | (0x8U << (BOOT_KEY_PIN * 4U)); // 上拉输入
+    for (volatile uint16_t i = 0; i < 200; i++) {
+    }
+    held = (GPIOA->IDR & (1U << BOOT_KEY_PIN)) == 0;
+
+    GPIOA->CRL = 0x44444444U;
+    GPIOA->ODR = 0;
+    RCC->APB2ENR &= ~RCC_APB2ENR_IOPAEN;
+    return held;
+}
+
+/**
+ * @brief 跳转到应用程序
+ * @details 只在快速路径 (没有打开任何中断和外设) 上调用。
+ * @return 无 (不返回)
+ */
+static void jump_to_app(void)
+{
+    const uint32_t *vec = (const uint32_t *)BOOT_APP_BASE;
+    void (*entry)(void) = (void (*)(void))vec[1];
+
+    SCB->VTOR = BOOT_APP_BASE;
+    __set_MSP(vec[0]);
+    entry();
+}
+
+/**
+ * @brief 切换到 72MHz (HSE 8MHz x9)
+ * @details 与应用程序的 SystemClock_Config 相同；HSE 起振失败时保持 HSI 8MHz，波特率按实际时钟计算。
+ * @return 无
+ */
+static void clock_init(void)
+{
+    uint32_t timeout = BOOT_HSE_TIMEOUT;
+
+    clock_hz = 8000000U;
+    RCC->CR |= RCC_CR_HSEON;
+    while ((RCC->CR & RCC_CR_HSERDY) == 0) {
+        if (--timeout == 0) {
+            RCC->CR &= ~RCC_CR_HSEON;
+            return;
+        }
+    }
+
+    FLASH->ACR = FLASH_ACR_PRFTBE | (2U << FLASH_ACR_LATENCY_Pos); // 72MHz 需要2个等待周期
+    RCC->CFGR = RCC_CFGR_PLLSRC | RCC_CFGR_PLLMULL9 | RCC_CFGR_PPRE1_DIV2;
+    RCC->CR |= RCC_CR_PLLON;
+    while ((RCC->CR & RCC_CR_PLLRDY) == 0) {
+    }
+    RCC->CFGR |= RCC_CFGR_SW_PLL;
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL) {
+    }
+    clock_hz = 72000000U;
+}
+
+/**
+ * @brief 配置 USART1 和 DMA1 通道5 的循环接收
+ * @details PA9 复用推挽输出，PA10 上拉输入 (与 usart.c 的引脚相同)。发送由 CPU 查询完成 (应答只有十几个字节)。
+ * @return 无
+ */
+static void uart_init(void)
+{
+    RCC->APB2ENR |= RCC_APB2ENR_IOPAEN | RCC_APB2ENR_USART1EN;
+    RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+    GPIOA->CRH = (GPIOA->CRH & ~0xFF0U) | 0x8B0U;
+    GPIOA->ODR |= 1U << 10;
+
+    DMA1_Channel5->CPAR = (uint32_t)&USART1->DR;
+    DMA1_Channel5->CMAR = (uint32_t)rx_ring;
+    DMA1_Channel5->CNDTR = BOOT_RX_RING_SIZE;
+    DMA1_Channel5->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_EN;
+
+    USART1->BRR = (clock_hz + BOOT_UART_BAUD / 2U) / BOOT_UART_BAUD;
+    USART1->CR3 = USART_CR3_DMAR;
+    USART1->CR1 = USART_CR1_UE | USART_CR1_TE | USART_CR1_RE;
+}
+
+/**
+ * @brief 查询方式发送数据，等待最后一个字节发送完毕
+ * @param[in] data 数据
+ * @param[in] len 长度
+ * @return 无
+ */
+static void uart_send(const uint8_t *data, uint16_t len)
+{
+    while (len--) {
+        while ((USART1->SR & USART_SR_TXE) == 0) {
+        }
+        USART1->DR = *data++;
+    }
+    while ((USART1->SR & USART_SR_TC) == 0) {
+    }
+}
+
+/**
+ * @brief 等待 Flash 操作完成并清除状态
+ * @return bool 没有编程错误和写保护错误时返回 true
+ */
+static bool flash_wait(void)
+{
+    uint32_t sr;
+
+    while (FLASH->SR & FLASH_SR_BSY) {
+    }
+    sr = FLASH->SR;
+    FLASH->SR = FLASH_SR_EOP | FLASH_SR_PGERR | FLASH_SR_WRPRTERR;
+    return (sr & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR)) == 0;
+}
+
+/**
+ * @brief 擦除一页
+ * @param[in] addr 页的起始地址
+ * @return bool 成功返回 true
+ */
+static bool flash_erase(uint32_t addr)
+{
+    bool ok;
+
+    FLASH->CR |= FLASH_CR_PER;
+    FLASH->AR = addr;
+    FLASH->CR |= FLASH_CR_STRT;
+    ok = flash_wait();
+    FLASH->CR &= ~FLASH_CR_PER;
+    return ok;
+}
+
+/**
+ * @brief 写入一个半字并读回比较
+ * @param[in] addr 地址 (已擦除)
+ * @param[in] v 数值
+ * @return bool 成功返回 true
+ */
+static bool flash_write(uint32_t addr, uint16_t v)
+{
+    bool ok;
+
+    FLASH->CR |= FLASH_CR_PG;
+    *(volatile uint16_t *)addr = v;
+    ok = flash_wait();
+    FLASH->CR &= ~FLASH_CR_PG;
+    return ok && *(volatile const uint16_t *)addr == v;
+}
+
+/**
+ * @brief 在接收缓冲区中原地做 COBS 解码
+ * @details 与 app_remote.c 相同，输出位置始终落后于输入位置。
+ * @param[in] start 帧的起始位置
+ * @param[in] len 编码后的长度 (不含分隔符)
+ * @return uint16_t 解码后的长度，编码错误时返回 0
+ */
+static uint16_t cobs_decode_ring(uint16_t start, uint16_t len)
+{
+    uint16_t in = 0;
+    uint16_t out = 0;
+
+    while (in < len) {
+        uint8_t code = rx_ring[RING_AT(start + in)];
+        in++;
+        if (code == 0 || in + code - 1 > len) {
+            return 0;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            rx_ring[RING_AT(start + out)] = rx_ring[RING_AT(start + in)];
+            out++;
+            in++;
+        }
+        if (code != 0xFF && in < len) {
+            rx_ring[RING_AT(start + out)] = 0;
+            out++;
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief 读取帧中的一个字节
+ * @param[in] f 帧
+ * @param[in] i 负载中的偏移
+ * @return uint8_t 字节
+ */
+static uint8_t frame_u8(const Boot_Frame_t *f, uint16_t i)
+{
+    return rx_ring[RING_AT(f->start + i)];
+}
+
+/**
+ * @brief 读取帧中的一个小端16位数
+ * @param[in] f 帧
+ * @param[in] i 负载中的偏移
+ * @return uint16_t 数值
+ */
+static uint16_t frame_u16(const Boot_Frame_t *f, uint16_t i)
+{
+    return (uint16_t)(frame_u8(f, i) | ((uint16_t)frame_u8(f, i + 1) << 8));
+}
+
+/**
+ * @brief 读取帧中的一个小端32位数
+ * @param[in] f 帧
+ * @param[in] i 负载中的偏移
+ * @return uint32_t 数值
+ */
+static uint32_t frame_u32(const Boot_Frame_t *f, uint16_t i)
+{
+    return frame_u16(f, i) | ((uint32_t)frame_u16(f, i + 2) << 16);
+}
+
+/**
+ * @brief 向应答追加一个字节
+ * @param[in] v 数值
+ * @return 无
+ */
+static void reply_u8(uint8_t v)
+{
+    if (reply_len < BOOT_REPLY_MAX - BOOT_CRC_SIZE) {
+        reply[reply_len++] = v;
+    }
+}
+
+/**
+ * @brief 向应答追加一个小端16位数
+ * @param[in] v 数值
+ * @return 无
+ */
+static void reply_u16(uint16_t v)
+{
+    reply_u8((uint8_t)v);
+    reply_u8((uint8_t)(v >> 8));
+}
+
+/**
+ * @brief 向应答追加一个小端32位数
+ * @param[in] v 数值
+ * @return 无
+ */
+static void reply_u32(uint32_t v)
+{
+    reply_u16((uint16_t)v);
+    reply_u16((uint16_t)(v >> 16));
+}
+
+/**
+ * @brief 开始一次升级
+ * @details 先擦除记录页，之后无论传输在何处中断，复位后都停留在引导程序中，重新连接后可以续传。
+ *          已写入的块保持不变，主机用 BOOT_CMD_QUERY 找出需要重写的块。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @return Boot_Status_e 执行结果
+ */
+static Boot_Status_e cmd_begin(const Boot_Frame_t *f, uint16_t dlen)
+{
+    const uint32_t *rec = (const uint32_t *)BOOT_RECORD_ADDR;
+    uint32_t size;
+
+    if (dlen != 6) {
+        return BOOT_ERR_LENGTH;
+    }
+    size = frame_u32(f, 2);
+    if (size == 0 || size > BOOT_APP_MAX) {
+        return BOOT_ERR_ARG;
+    }
+    for (uint8_t i = 0; i < sizeof(Boot_Record_t) / 4; i++) {
+        if (rec[i] != 0xFFFFFFFFU) {
+            if (!flash_erase(BOOT_RECORD_ADDR)) {
+                return BOOT_ERR_FLASH;
+            }
+            break;
+        }
+    }
+    image_size = size;
+    image_crc = frame_u16(f, 6);
+    image_open = true;
+    return BOOT_OK;
+}
+
+/**
+ * @brief 返回各块当前内容的 CRC
+ * @details 按整块计算 (映像的最后一块由主机用 0xFF 补齐后比较)。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @return Boot_Status_e 执行结果
+ */
+static Boot_Status_e cmd_query(const Boot_Frame_t *f, uint16_t dlen)
+{
+    uint16_t first;
+    uint8_t count;
+
+    if (dlen != 3) {
+        return BOOT_ERR_LENGTH;
+    }
+    first = frame_u16(f, 2);
+    count = frame_u8(f, 4);
+    if (count == 0 || count > BOOT_QUERY_MAX || ((uint32_t)first + count) * BOOT_PAGE_SIZE > BOOT_APP_MAX) {
+        return BOOT_ERR_ARG;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        reply_u16(crc16_flash(BOOT_APP_BASE + ((uint32_t)first + i) * BOOT_PAGE_SIZE, BOOT_PAGE_SIZE));
+    }
+    return BOOT_OK;
+}
+
+/**
+ * @brief 写入一块
+ * @details 内容与 Flash 中相同时直接应答 (续传或重发的块)，页已是空白时跳过擦除，值为 0xFFFF 的半字不写。
+ *          每个半字写入后读回比较。擦写期间后续的帧由 DMA 继续接收。
+ * @param[in] f 帧
+ * @param[in] dlen 数据长度
+ * @return Boot_Status_e 执行结果
+ */
+static Boot_Status_e cmd_write(const Boot_Frame_t *f, uint16_t dlen)
+{
+    const uint16_t *page;
+    uint32_t addr;
+    uint16_t block;
+    bool same = true;
+    bool blank = true;
+
+    if (dlen != 2 + BOOT_PAGE_SIZE) {
+        return BOOT_ERR_LENGTH;
+    }
+    if (!image_open) {
+        return BOOT_ERR_STATE;
+    }
+    block = frame_u16(f, 2);
+    if ((uint32_t)block * BOOT_PAGE_SIZE >= image_size) {
+        return BOOT_ERR_ARG;
+    }
+    reply_u16(block);
+
+    addr = BOOT_APP_BASE + (uint32_t)block * BOOT_PAGE_SIZE;
+    page = (const uint16_t *)addr;
+    for (uint16_t i = 0; i < BOOT_PAGE_SIZE / 2; i++) {
+        same &= page[i] == frame_u16(f, 4 + 2 * i);
+        blank &= page[i] == 0xFFFF;
+    }
+    if (same) {
+        return BOOT_OK;
+    }
+    if (!blank && !flash_erase(addr)) {
+        return BOOT_ERR_FLASH;
+    }
+    for (uint16_t i = 0; i < BOOT_PAGE_SIZE / 2; i++) {
+        uint16_t v = frame_u16(f, 4 + 2 * i);
+        if (v != 0xFFFF && !flash_write(addr + 2U * i, v)) {
+            return BOOT_ERR_FLASH;
+        }
+    }
+    return BOOT_OK;
+}
+
+/**
+ * @brief 校验整个映像并写入记录
+ * @param[in] dlen 数据长度
+ * @return Boot_Status_e 执行结果
+ */
+static Boot_Status_e cmd_commit(uint16_t dlen)
+{
+    Boot_Record_t rec;
+    const uint16_t *half = (const uint16_t *)&rec;
+
+    if (dlen != 0) {
+        return BOOT_ERR_LENGTH;
+    }
+    if (!image_open) {
+        return BOOT_ERR_STATE;
+    }
+    if (crc16_flash(BOOT_APP_BASE, image_size) != image_crc) {
+        return BOOT_ERR_VERIFY;
+    }
+
+    rec.magic = BOOT_RECORD_MAGIC;
+    rec.size = image_size;
+    rec.crc = image_crc;
+    rec.crc_inv = (uint16_t)~image_crc;
+    for (uint8_t i = 0; i < sizeof(rec) / 2; i++) {
+        if (!flash_write(BOOT_RECORD_ADDR + 2U * i, half[i])) {
+            return BOOT_ERR_FLASH;
+        }
+    }
+    image_open = false;
+    return record_valid() ? BOOT_OK : BOOT_ERR_VERIFY;
+}
+
+/**
+ * @brief 解码、校验并执行一帧，发送应答
+ * @details 解码失败或 CRC 错误的帧直接丢弃不应答，由主机超时重发。
+ * @param[in] start 帧在接收缓冲区中的起点
+ * @param[in] len 编码后的长度
+ * @return bool 应答发出后需要复位进入应用程序时返回 true
+ */
+static bool handle_frame(uint16_t start, uint16_t len)
+{
+    Boot_Frame_t f;
+    Boot_Status_e status;
+    uint16_t crc = 0xFFFF;
+    uint16_t body;
+    uint16_t dlen;
+    uint8_t cmd;
+
+    f.start = start;
+    f.len = cobs_decode_ring(start, len);
+    if (f.len < BOOT_HEADER_SIZE + BOOT_CRC_SIZE) {
+        return false;
+    }
+    body = f.len - BOOT_CRC_SIZE;
+    for (uint16_t i = 0; i < body; i++) {
+        crc = crc16_update(crc, frame_u8(&f, i));
+    }
+    if (crc != frame_u16(&f, body)) {
+        return false;
+    }
+
+    cmd = frame_u8(&f, 0);
+    dlen = body - BOOT_HEADER_SIZE;
+    reply[0] = cmd | BOOT_REPLY_FLAG;
+    reply[1] = frame_u8(&f, 1);
+    reply_len = BOOT_HEADER_SIZE + 1;
+
+    switch (cmd) {
+        case BOOT_CMD_INFO:
+            status = BOOT_OK;
+            reply_u8(BOOT_PROTOCOL_VERSION);
+            reply_u16(BOOT_PAGE_SIZE);
+            reply_u32(BOOT_APP_BASE);
+            reply_u32(BOOT_APP_MAX);
+            reply_u8(BOOT_WINDOW);
+            reply_u8(record_valid() ? 1 : 0);
+            break;
+        case BOOT_CMD_BEGIN:
+            status = cmd_begin(&f, dlen);
+            break;
+        case BOOT_CMD_QUERY:
+            status = cmd_query(&f, dlen);
+            break;
+        case BOOT_CMD_WRITE:
+            status = cmd_write(&f, dlen);
+            break;
+        case BOOT_CMD_COMMIT:
+            status = cmd_commit(dlen);
+            break;
+        case BOOT_CMD_RUN:
+            status = (dlen != 0) ? BOOT_ERR_LENGTH : (record_valid() ? BOOT_OK : BOOT_ERR_STATE);
+            break;
+        default:
+            status = BOOT_ERR_COMMAND;
+            break;
+    }
+
+    if (status != BOOT_OK) {
+        reply_len = BOOT_HEADER_SIZE + 1; // 出错时只返回状态
+    }
+    reply[BOOT_HEADER_SIZE] = (uint8_t)status;
+    crc = 0xFFFF;
+    for (uint16_t i = 0; i < reply_len; i++) {
+        crc = crc16_update(crc, reply[i]);
+    }
+    reply[reply_len++] = (uint8_t)crc;
+    reply[reply_len++] = (uint8_t)(crc >> 8);
+
+    len = COBS_Encode(reply, reply_len, tx_frame);
+    tx_frame[len++] = 0x00; // 帧分隔符
+    uart_send(tx_frame, len);
+
+    return status == BOOT_OK && (cmd == BOOT_CMD_COMMIT || cmd == BOOT_CMD_RUN);
+}
+
+/**
+ * @brief 扫描接收缓冲区并处理完整的帧
+ * @return bool 处理了至少一个帧时返回 true
+ */
+static bool boot_service(void)
+{
+    uint16_t head = RING_AT(BOOT_RX_RING_SIZE - DMA1_Channel5->CNDTR);
+    bool handled = false;
+
+    while (rx_scan != head) {
+        if (rx_ring[rx_scan] == 0x00) {
+            uint16_t len = RING_AT(rx_scan - rx_tail);
+            if (!rx_overlong && len != 0) {
+                if (handle_frame(rx_tail, len)) {
+                    NVIC_SystemReset(); // 信箱已清除，复位后走快速路径
+                }
+                handled = true;
+            }
+            rx_overlong = false;
+            rx_scan = RING_AT(rx_scan + 1);
+            rx_tail = rx_scan;
+        } else {
+            rx_scan = RING_AT(rx_scan + 1);
+            if (RING_AT(rx_scan - rx_tail) > BOOT_RX_FRAME_MAX) {
+                rx_overlong = true; // 不可能是有效的请求，只找下一个分隔符
+                rx_tail = rx_scan;
+            }
+        }
+    }
+    return handled;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief SysTick 中断，毫秒计数
+ * @return 无
+ */
+void SysTick_Handler(void)
+{
+    boot_ms++;
+}
+
+/**
+ * @brief 引导程序入口
+ * @details 由应用程序请求进入 (信箱) 且记录仍有效时，BOOT_IDLE_MS 内没有收到有效帧就复位回到应用程序；
+ *          按住返回键或记录无效时一直停留，直到升级完成或收到 BOOT_CMD_RUN。
+ * @return int 不返回
+ */
+int main(void)
+{
+    volatile uint32_t *mailbox = (volatile uint32_t *)BOOT_MAILBOX_ADDR;
+    bool requested = (*mailbox == BOOT_MAILBOX_MAGIC);
+    uint32_t last_ms = 0;
+
+    *mailbox = 0;
+    if (!requested && record_valid() && !key_held()) {
+        jump_to_app();
+    }
+
+    clock_init();
+    uart_init();
+    FLASH->KEYR = FLASH_KEY1;
+    FLASH->KEYR = FLASH_KEY2;
+    SysTick_Config(clock_hz / 1000U);
+
+    for (;;) {
+        if (boot_service()) {
+            last_ms = boot_ms;
+        }
+        if (requested && record_valid() && boot_ms - last_ms >= BOOT_IDLE_MS) {
+            NVIC_SystemReset();
+        }
+    }
+}
+
+/** @} */
@@ -0,0 +1,113 @@
+/**
+ * @file      boot.h
+ * @brief     引导程序与固件升级协议头文件
+ * @details   Flash 布局 (STM32F103C8，64KB，每页 1KB)：
+ *            - 0x08000000~0x08000BFF：引导程序 (Table Clock Boot 目标)；
+ *            - 0x08000C00~0x08000FFF：应用程序记录页 (Boot_Record_t)，只在整个映像校验通过后写入；
+ *            - 0x08001000~0x0800FFFF：应用程序 (Table Clock App 目标，定义 APP_BOOTLOADER=1)。
+ *            复位后引导程序检查 RAM 开头的信箱、返回键和记录页，没有升级请求且记录有效时立即跳转到应用程序
+ *            (只配置一次键盘引脚，不初始化时钟和外设)。进入升级模式的三种方式：
+ *            应用程序收到 REMOTE_CMD_BOOT 后写信箱并复位、复位时按住返回键、记录无效 (从未写入或升级被打断)。
+ *            升级协议与 app_remote 的帧格式相同：COBS(负载) + 0x00，负载 = | 命令 | 序号 | 数据 | CRC-16 |，
+ *            应答的命令为请求命令 | 0x80，数据的第一个字节为 Boot_Status_e。协议只在 USART1 上运行；
+ *            USB 虚拟串口只能用来发送 REMOTE_CMD_BOOT，之后由 USART1 完成传输。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __BOOT_H
+#define __BOOT_H
+
+#include "stm32f1xx.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup Boot 引导程序
+ * @brief 提供了引导程序的 Flash 布局、升级协议和应用程序进入引导程序的方法。
+ * @{
+ */
+
+/**
+ * @defgroup Boot_Config 引导程序配置
+ * @details BOOT_APP_BASE 必须与 Table Clock App 目标的 IROM1 起始地址一致，
+ *          引导程序的最大长度必须与 MDK-ARM/Table Clock Boot.sct 一致。
+ * @{
+ */
+#ifndef APP_BOOTLOADER
+#define APP_BOOTLOADER      0           ///< 为 1 时应用程序链接在引导程序之后，并支持 REMOTE_CMD_BOOT
+#endif
+#define BOOT_FLASH_BASE     0x08000000U ///< Flash 起始地址
+#define BOOT_FLASH_END      0x08010000U ///< Flash 结束地址 (不含)
+#define BOOT_PAGE_SIZE      1024U       ///< Flash 页大小，也是升级的块大小
+#define BOOT_SIZE           0x1000U     ///< 引导程序占用的空间 (含记录页)
+#define BOOT_RECORD_ADDR    (BOOT_FLASH_BASE + BOOT_SIZE - BOOT_PAGE_SIZE) ///< 应用程序记录页
+#define BOOT_APP_BASE       (BOOT_FLASH_BASE + BOOT_SIZE)                  ///< 应用程序的向量表
+#define BOOT_APP_MAX        (BOOT_FLASH_END - BOOT_APP_BASE)               ///< 应用程序的最大长度
+#define BOOT_MAILBOX_ADDR   0x20000000U ///< 信箱 (RAM 的第一个字，引导程序的 RAM 从 0x20000020 开始，不会覆盖)
+#define BOOT_MAILBOX_MAGIC  0x424F4F54U ///< 信箱中的升级请求 ("BOOT")
+#define BOOT_RECORD_MAGIC   0x41505031U ///< 记录页的魔法数 ("APP1")
+#define BOOT_UART_BAUD      115200U     ///< 升级时 USART1 的波特率 (与应用程序相同，最高可用 460800)
+#define BOOT_IDLE_MS        10000U      ///< 由应用程序请求进入、记录仍有效时，这段时间没有收到有效帧就回到应用程序
+#define BOOT_RX_RING_SIZE   4096U       ///< DMA 循环接收缓冲区 (2 的幂，至少容纳 BOOT_WINDOW 个写块帧)
+#define BOOT_WINDOW         2U          ///< 主机最多连续发送而未收到应答的写块帧数
+#define BOOT_QUERY_MAX      16U         ///< BOOT_CMD_QUERY 一次最多查询的块数
+#define BOOT_PROTOCOL_VERSION 1         ///< 升级协议版本，由 BOOT_CMD_INFO 返回
+/** @} */
+
+/**
+ * @brief 升级协议命令码
+ */
+typedef enum {
+    BOOT_CMD_INFO   = 0x01, ///< 请求：无；应答：协议版本 块大小 (2) 应用程序地址 (4) 最大长度 (4) 窗口 记录是否有效
+    BOOT_CMD_BEGIN  = 0x02, ///< 请求：映像长度 (4) 映像的 CRC-16 (2)；应答：无 (记录页被擦除，应用程序不再启动)
+    BOOT_CMD_QUERY  = 0x03, ///< 请求：起始块 (2) 块数 (1~BOOT_QUERY_MAX)；应答：各块当前内容的 CRC-16 (各2)
+    BOOT_CMD_WRITE  = 0x04, ///< 请求：块号 (2) 数据 (BOOT_PAGE_SIZE)；应答：块号 (2)，内容相同时不擦写
+    BOOT_CMD_COMMIT = 0x05, ///< 请求：无；应答：无，整个映像校验通过后写入记录，应答发出后复位进入应用程序
+    BOOT_CMD_RUN    = 0x06, ///< 请求：无；应答：无，记录有效时在应答发出后复位进入应用程序
+} Boot_Cmd_e;
+
+/**
+ * @brief 升级协议应答状态 (前五项与 Remote_Status_e 相同)
+ */
+typedef enum {
+    BOOT_OK = 0,         ///< 成功
+    BOOT_ERR_LENGTH,     ///< 数据长度与命令不符
+    BOOT_ERR_ARG,        ///< 参数超出范围 (长度为0或过长、块号超出映像)
+    BOOT_ERR_STATE,      ///< 尚未执行 BOOT_CMD_BEGIN，或记录无效时请求运行
+    BOOT_ERR_COMMAND,    ///< 未知命令
+    BOOT_ERR_FLASH,      ///< 擦除或写入失败 (写入后读回不一致)
+    BOOT_ERR_VERIFY,     ///< 提交时整个映像的 CRC 与 BOOT_CMD_BEGIN 给出的不符
+} Boot_Status_e;
+
+/**
+ * @brief 应用程序记录 (位于 BOOT_RECORD_ADDR)
+ * @details 只在提交时、整个映像的 CRC 校验通过后写入，启动时不再重新计算 CRC。
+ */
+typedef struct {
+    uint32_t magic;   ///< BOOT_RECORD_MAGIC
+    uint32_t size;    ///< 映像长度 (字节)
+    uint16_t crc;     ///< 映像的 CRC-16/CCITT
+    uint16_t crc_inv; ///< crc 取反，防止半写入的记录被当作有效
+} Boot_Record_t;
+
+#if APP_BOOTLOADER
+
+/**
+ * @brief 复位进入引导程序的升级模式 (应用程序中调用)
+ * @details 复位不清除 RAM，引导程序的变量和栈不占用这个字，由它读取后清除。
+ * @return 无 (不返回)
+ */
+static inline void Boot_Request(void)
+{
+    *(volatile uint32_t *)BOOT_MAILBOX_ADDR = BOOT_MAILBOX_MAGIC;
+    NVIC_SystemReset();
+}
+
+#endif /* APP_BOOTLOADER */
+
+/** @} */
+
+#endif /* __BOOT_H */
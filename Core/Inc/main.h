@@ -41,7 +41,19 @@ extern "C" {
 
 /* Exported constants --------------------------------------------------------*/
 /* USER CODE BEGIN EC */
-
+/**
+ * @brief 中断抢占优先级规划 (NVIC_PRIORITYGROUP_4：4位抢占优先级，没有子优先级，数值小的优先)
+ * @details 渲染和页面逻辑都在主循环中，任何中断都能打断它们；这里的分级决定中断之间谁能打断谁。
+ *          CubeMX 生成的外设在 .ioc 中按同样的数值配置，手写初始化的外设使用这些宏。
+ *          同一级的中断不能互相打断，各级处理函数的耗时都应远小于更高一级所能容忍的延迟。
+ * @{
+ */
+#define IRQ_PRIO_POWER      0U  ///< 掉电检测 (PVD)：须在电压跌到复位阈值之前停止写入
+#define IRQ_PRIO_INPUT      1U  ///< 按键扫描 (TIM2 或其采样 DMA)、按键/编码器/SQW 的 EXTI、电波授时的脉冲捕获 (TIM4)
+#define IRQ_PRIO_BUS        2U  ///< I2C1/I2C2 的事件和错误中断及其 DMA 完成，显示器的 SPI DMA 完成
+#define IRQ_PRIO_SERIAL     3U  ///< USART1 及其 DMA 通道、USB；uart.c 的临界区只屏蔽到这一级
+#define IRQ_PRIO_BACKGROUND 4U  ///< 显存拷贝 DMA (fb_dma)、电源电压和环境光采样的 ADC DMA、蜂鸣器的 DMA (audio)、外部闪存的 SPI DMA (w25q)
+/** @} */
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
@@ -53,20 +65,27 @@ extern "C" {
 void Error_Handler(void);
 
 /* USER CODE BEGIN EFP */
+void SystemClock_Config(void);
 
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
 #define KEY_CON_Pin GPIO_PIN_1
 #define KEY_CON_GPIO_Port GPIOA
+#define KEY_CON_EXTI_IRQn EXTI1_IRQn
 #define KEY_BCK_Pin GPIO_PIN_3
 #define KEY_BCK_GPIO_Port GPIOA
+#define KEY_BCK_EXTI_IRQn EXTI3_IRQn
 #define KEY_EN_Pin GPIO_PIN_5
 #define KEY_EN_GPIO_Port GPIOA
+#define KEY_EN_EXTI_IRQn EXTI9_5_IRQn
 #define EA_Pin GPIO_PIN_6
 #define EA_GPIO_Port GPIOA
 #define EB_Pin GPIO_PIN_7
 #define EB_GPIO_Port GPIOA
+#define RTC_SQW_Pin GPIO_PIN_0
+#define RTC_SQW_GPIO_Port GPIOB
+#define RTC_SQW_EXTI_IRQn EXTI0_IRQn
 
 /* USER CODE BEGIN Private defines */
 
@@ -2,13 +2,19 @@
  * @file      u8g2_stm32_hal.h
  * @brief     U8g2图形库与STM32 HAL库的适配层头文件
  * @details   本头文件提供了U8g2图形库与STM32 HAL库之间的接口，包括：
- *            - I2C通信回调函数声明
+ *            - I2C和SPI通信回调函数声明 (由 U8G2_TRANSPORT 选择)
+ *            - 整帧异步刷新 (含脏区跟踪、显示起始行和整帧快速上传) 函数声明
+ *            - 显示器的驱动配置 (扫描行数、预充电和 VCOMH) 函数声明
+ *            - 画面捕获 (远程镜像) 函数声明
+ *            - 副显示器 (同一总线上地址不同的第二块屏) 的登记和刷新函数声明
+ *            - 分页模式下的条带发送函数声明
  *            - GPIO和延时回调函数声明
+ *            - 位带方式的像素写入 (u8g2 的 ll_hvline 回调)
  *            - U8g2初始化函数声明
  *            - 外部I2C句柄声明
  * @author    Sandocean
- * @date      2025-08-25
- * @version   1.0
+ * @date      2025-10-08
+ * @version   1.4
  * @copyright Copyright (c) 2025 SandOcean
  */
 
@@ -17,6 +23,169 @@
 
 #include "u8g2.h"
 #include "main.h"
+#include <stdbool.h>
+
+#define U8G2_FRAME_PAGE_WIDTH 128                                       ///< 每页的字节数 (列数)
+#define U8G2_FRAME_PAGES      8                                         ///< 页数 (64行 / 8)
+#define U8G2_FRAME_BUF_SIZE   (U8G2_FRAME_PAGE_WIDTH * U8G2_FRAME_PAGES) ///< 整帧显存大小
+
+/**
+ * @brief 显存模式
+ * @details - 0: 整帧缓冲 (_f)，绘图缓冲区 1KB，另有 1KB 影子副本 (U8G2_DIRTY_CRC 为 1 时改为 128 字节的 CRC)，异步脏区刷新；
+ *          - 1/2: 分页缓冲 (_1/_2)，绘图缓冲区只有 1/2 页 (128/256 字节)，不需要影子副本。
+ *            一帧按条带绘制多次，每个条带绘制完后阻塞发送，页面可用 Page_Strip_Visible()
+ *            跳过条带之外的内容。
+ *          可在编译选项中覆盖。
+ */
+#ifndef U8G2_BUFFER_MODE
+#define U8G2_BUFFER_MODE      0
+#endif
+
+#if U8G2_BUFFER_MODE == 0
+#define U8G2_STRIP_PAGES      U8G2_FRAME_PAGES                          ///< 每个条带的页数
+#elif U8G2_BUFFER_MODE == 1 || U8G2_BUFFER_MODE == 2
+#define U8G2_STRIP_PAGES      U8G2_BUFFER_MODE
+#else
+#error "U8G2_BUFFER_MODE must be 0, 1 or 2"
+#endif
+#define U8G2_STRIP_HEIGHT     (U8G2_STRIP_PAGES * 8)                    ///< 每个条带的像素行数
+
+#define U8G2_TRANSPORT_I2C    0 ///< 显示器接口: I2C1 (PB6/PB7)
+#define U8G2_TRANSPORT_SPI    1 ///< 显示器接口: 4线SPI (SPI1 重映射)
+#define U8G2_TRANSPORT_I2C2   2 ///< 显示器接口: 独立的 I2C2 (PB10/PB11)
+
+/**
+ * @brief 显示器接口
+ * @details - U8G2_TRANSPORT_I2C: 与 DS3231/AT24C32/AHT20 共用 I2C1，所有传输经 i2c_bus 以最高优先级排队；
+ *          - U8G2_TRANSPORT_SPI: SPI 版 SSD1306。SCK/MOSI 为 PB3/PB5 (SPI1 重映射，PA5/PA7 已用于按键和编码器)，
+ *            整帧经 DMA1 通道3 发送，18MHz 下一帧约 0.5ms，显示器不再占用 I2C 总线。
+ *          - U8G2_TRANSPORT_I2C2: I2C 版 SSD1306 单独接在 I2C2 (PB10/PB11)，DS3231/AT24C32/AHT20 留在 I2C1。
+ *            传输仍经 i2c_bus 排队，但在另一条总线上，与传感器和 RTC 的事务同时进行。
+ *            I2C2_TX 只能使用 DMA1 通道4，与 USART1_TX 冲突，该模式下串口发送改为中断驱动。
+ *          可在编译选项中覆盖。
+ */
+#ifndef U8G2_TRANSPORT
+#define U8G2_TRANSPORT        U8G2_TRANSPORT_I2C
+#endif
+
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+#define U8G2_SPI_CS_GPIO_Port  GPIOA                   ///< 片选 (低有效)
+#define U8G2_SPI_CS_Pin        GPIO_PIN_15
+#define U8G2_SPI_DC_GPIO_Port  GPIOB                   ///< 数据/命令选择 (高为显存数据)
+#define U8G2_SPI_DC_Pin        GPIO_PIN_4
+#define U8G2_SPI_RES_GPIO_Port GPIOB                   ///< 复位 (低有效)
+#define U8G2_SPI_RES_Pin       GPIO_PIN_8
+/**
+ * @brief SPI1 时钟分频 (APB2 72MHz)
+ * @details 默认 4 分频即 18MHz。SSD1306 数据手册给出的最小时钟周期为 100ns (10MHz)，
+ *          常见模块在 18MHz 下工作正常，画面出现错位时改为 SPI_BAUDRATEPRESCALER_8 (9MHz)。
+ */
+#ifndef U8G2_SPI_PRESCALER
+#define U8G2_SPI_PRESCALER     SPI_BAUDRATEPRESCALER_4
+#endif
+#elif U8G2_TRANSPORT != U8G2_TRANSPORT_I2C && U8G2_TRANSPORT != U8G2_TRANSPORT_I2C2
+#error "U8G2_TRANSPORT must be U8G2_TRANSPORT_I2C, U8G2_TRANSPORT_SPI or U8G2_TRANSPORT_I2C2"
+#endif
+
+/**
+ * @brief 显示器数量 (含主显示器)
+ * @details 大于 1 时可用 u8g2_stm32_PanelInit() 登记同一总线上 I2C 地址不同的副显示器 (如 0x3D)。
+ *          每个副显示器各有 1KB 绘图缓冲区和 1KB 影子副本 (共约 2KB RAM，U8G2_DIRTY_CRC 时影子副本换成 128 字节的 CRC)，脏区比较和按页提交与主显示器相同，
+ *          总线上只传送变化的列区间。仅支持整帧模式和 I2C 接口。可在编译选项中覆盖。
+ */
+#ifndef U8G2_PANEL_COUNT
+#define U8G2_PANEL_COUNT      1
+#endif
+#if U8G2_PANEL_COUNT < 1 || (U8G2_PANEL_COUNT > 1 && (U8G2_BUFFER_MODE != 0 || U8G2_TRANSPORT == U8G2_TRANSPORT_SPI))
+#error "U8G2_PANEL_COUNT > 1 requires U8G2_BUFFER_MODE 0 and an I2C transport"
+#endif
+
+/**
+ * @brief 以硬件 CRC 代替影子副本检测变化
+ * @details 为 0 时每个显示器保留 1KB 影子副本，逐字节比较得到每页精确的变化列区间，刷新从影子副本发送，
+ *          发送期间可以绘制下一帧。为 1 时每页分为 U8G2_CRC_SEGS 段，每段由 CRC 单元计算 CRC-32
+ *          (一帧 32 段，每段 8 个字，整帧约 20us)，只保存上一帧的 CRC (128 字节)，CRC 变化的段所在的列区间
+ *          直接从绘图缓冲区发送，节省约 900 字节 RAM。代价：
+ *          - 区间按段对齐，比逐字节比较的结果宽一些 (最多多发约 2 * 31 字节/页)；
+ *          - 刷新期间绘图缓冲区不能修改，绘制前须调用 u8g2_stm32_DrawBegin() 等待上一帧发完；
+ *          - 两段不同的内容 CRC 相同的概率约 2^-32，此时该段不会刷新，直到内容再次变化。
+ *          仅用于整帧模式。可在编译选项中覆盖。
+ */
+#ifndef U8G2_DIRTY_CRC
+#define U8G2_DIRTY_CRC        0
+#endif
+#define U8G2_CRC_SEGS         4                                         ///< CRC 模式下每页的段数
+#define U8G2_CRC_SEG_WIDTH    (U8G2_FRAME_PAGE_WIDTH / U8G2_CRC_SEGS)   ///< 每段的字节数 (4 的倍数)
+#if U8G2_DIRTY_CRC && U8G2_BUFFER_MODE != 0
+#error "U8G2_DIRTY_CRC requires U8G2_BUFFER_MODE 0"
+#endif
+
+/**
+ * @brief 绘图缓冲区的像素写入方式
+ * @details 为 1 时 u8g2 的水平/垂直线回调 (ll_hvline，画点、直线、圆和表盘指针最终都经过它) 改用
+ *          Cortex-M3 的 SRAM 位带别名区：画线颜色为 0/1 时每个像素一条写别名字的指令，
+ *          u8g2 自带的实现 (u8g2_ll_hvline_vertical_top_lsb) 每个像素要做或、异或两次读改写。
+ *          为 0 时使用 u8g2 自带的实现。两者的结果完全相同，板上微基准测试 (app_bench) 分别测量两种实现。
+ *          主机仿真没有位带别名区，须设为 0。可在编译选项中覆盖。
+ */
+#ifndef U8G2_BITBAND
+#define U8G2_BITBAND          1
+#endif
+
+/**
+ * @brief 整帧模式下的 R0 专用画线路径
+ * @details 显示方向固定为 U8G2_R0，u8g2 的画线接口却总要经过方向回调 (cb->draw_l90) 和按条带换算行号。
+ *          为 1 时 u8g2_DrawPixel/DrawHLine/DrawVLine/DrawBox 被替换为本文件中的内联实现：
+ *          直接按用户窗口裁剪 (与 u8g2_DrawHVLine 的裁剪规则相同) 后调用 ll_hvline，
+ *          方框按列画垂直线 (配合位带实现时每列每页只写一次)。坐标正常 (含部分超出屏幕) 时结果与 u8g2 的实现相同。
+ *          分页模式有条带偏移，不使用本路径；文字、圆和斜线在 u8g2 内部绘制，仍走 u8g2 的通用路径。
+ *          可在编译选项中覆盖。
+ */
+#ifndef U8G2_R0_FAST
+#define U8G2_R0_FAST          1
+#endif
+
+/**
+ * @brief 倒装安装
+ * @details 为 1 时初始化后发送段重映射和 COM 扫描方向命令 (0xA0/0xC0，默认方向为 0xA1/0xC8)，
+ *          由显示控制器把画面旋转 180°，绘图仍按 U8G2_R0 进行，不需要软件旋转 (U8G2_R2)。
+ *          副显示器同样设置。可在编译选项中覆盖。
+ */
+#ifndef U8G2_FLIP
+#define U8G2_FLIP             0
+#endif
+
+/**
+ * @defgroup U8g2_Band 低功耗驱动配置
+ * @brief U8G2_PROFILE_BAND 扫描的显存范围和驱动电压，可在编译选项中覆盖。
+ * @details 默认的第2~5页 (第16~47行) 容纳低功耗时钟 24 像素高的数字和上下的空白。
+ *          预充电 0x22 (两个阶段各2个时钟，复位值) 和 VCOMH 0x00 (约 0.65Vcc) 都低于 u8g2 初始化的 0xF1 和 0x40，
+ *          配合最低对比度使每个像素的驱动电流更小。电荷泵 (0x8D) 只有开、关两档，显示时必须打开，不在配置中。
+ * @{
+ */
+#ifndef U8G2_BAND_FIRST_PAGE
+#define U8G2_BAND_FIRST_PAGE  2    ///< 扫描的第一页
+#endif
+#ifndef U8G2_BAND_PAGES
+#define U8G2_BAND_PAGES       4    ///< 扫描的页数
+#endif
+#ifndef U8G2_BAND_PRECHARGE
+#define U8G2_BAND_PRECHARGE   0x22 ///< 预充电周期 (0xD9 的参数)
+#endif
+#ifndef U8G2_BAND_VCOMH
+#define U8G2_BAND_VCOMH       0x00 ///< COM 取消选择电平 (0xDB 的参数)
+#endif
+/** @} */
+
+/**
+ * @brief 显示器的驱动配置
+ */
+typedef enum
+{
+    U8G2_PROFILE_FULL = 0, ///< 扫描全部64行，预充电和 VCOMH 为 u8g2 初始化的值
+    U8G2_PROFILE_BAND,     ///< 只扫描 U8G2_BAND_FIRST_PAGE 起的 U8G2_BAND_PAGES 页，较低的预充电和 VCOMH (低功耗时钟)
+    U8G2_PROFILE_COUNT     ///< 配置个数
+} U8g2_Profile_e;
 
 extern u8g2_t u8g2; ///< 全局U8g2实例
 
@@ -40,6 +209,19 @@ uint8_t u8x8_stm32_gpio_and_delay(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
  */
 uint8_t u8x8_byte_stm32_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+/**
+ * @brief U8g2的SPI通信回调函数
+ * @details 阻塞发送，用于初始化序列和命令；整帧数据由 u8g2_stm32_SendBufferAsync 经 DMA 发送。
+ * @param[in] u8x8 U8g2显示对象指针
+ * @param[in] msg 消息类型
+ * @param[in] arg_int 整数参数
+ * @param[in] arg_ptr 指针参数
+ * @return 操作结果，1表示成功，0表示失败
+ */
+uint8_t u8x8_byte_stm32_hw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+#endif
+
 /**
  * @brief 初始化U8g2显示对象
  * @param[out] u8g2 指向U8g2显示对象的指针
@@ -47,6 +229,299 @@ uint8_t u8x8_byte_stm32_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
  */
 void u8g2Init(u8g2_t *u8g2);
 
+#if U8G2_BUFFER_MODE == 0
+
+/**
+ * @brief 异步刷新整帧显存 (只发送与上一帧不同的部分), 立即返回
+ * @param[in] u8g2 指向U8g2显示对象的指针
+ * @return HAL_StatusTypeDef 刷新已启动返回 HAL_OK, 上一帧未发完返回 HAL_BUSY (本帧稍后补发)
+ */
+HAL_StatusTypeDef u8g2_stm32_SendBufferAsync(u8g2_t *u8g2);
+
+/**
+ * @brief 补发刷新期间被推迟的帧, 需在主循环中调用
+ * @param[in] u8g2 指向U8g2显示对象的指针
+ */
+void u8g2_stm32_Service(u8g2_t *u8g2);
+
+/**
+ * @brief 使影子副本失效, 下一次刷新将整帧发送
+ */
+void u8g2_stm32_InvalidateShadow(void);
+
+/**
+ * @brief 设置下一帧的显示起始行 (SSD1306 硬件纵向滚动), 随该帧的显存数据一起提交
+ * @param[in] line 起始行 (0-63), 屏幕第 r 行显示显存第 (r + line) % 64 行
+ */
+void u8g2_stm32_SetStartLine(uint8_t line);
+
+/**
+ * @brief 查询整帧异步刷新是否仍在进行
+ * @return bool 正在刷新返回 true
+ */
+bool u8g2_stm32_IsFlushBusy(void);
+
+/**
+ * @brief 阻塞等待整帧异步刷新完成
+ * @param[in] timeout 超时时间 (ms)
+ * @return HAL_StatusTypeDef 完成返回 HAL_OK
+ */
+HAL_StatusTypeDef u8g2_stm32_WaitFlush(uint32_t timeout);
+
+/**
+ * @brief 开始修改主显示器的绘图缓冲区之前调用
+ * @details U8G2_DIRTY_CRC 为 1 时刷新直接从绘图缓冲区发送, 须等待上一帧发完 (含待补发的帧) 再绘制;
+ *          为 0 时为空操作。
+ */
+void u8g2_stm32_DrawBegin(void);
+
+/**
+ * @brief 开启或关闭画面捕获, 开启时所有页整页标记为待取
+ * @param[in] on 开启为 true
+ */
+void u8g2_stm32_CaptureEnable(bool on);
+
+/**
+ * @brief 取得下一个待取的变化区间 (多次刷新的变化已合并), 不清除
+ * @param[out] page 页号
+ * @param[out] x0 区间起点
+ * @param[out] x1 区间终点 (不含)
+ * @return bool 有待取区间返回 true
+ */
+bool u8g2_stm32_CaptureNext(uint8_t *page, uint8_t *x0, uint8_t *x1);
+
+/**
+ * @brief 清除一页的待取区间
+ * @param[in] page 页号 (0-7)
+ */
+void u8g2_stm32_CaptureDone(uint8_t page);
+
+/**
+ * @brief 读取屏幕当前内容的影子副本 (只读)
+ * @details U8G2_DIRTY_CRC 为 1 时没有影子副本, 返回主显示器的绘图缓冲区。
+ * @param[out] start_line 该帧的显示起始行, 可为 NULL
+ * @return const uint8_t* 影子副本 (U8G2_FRAME_BUF_SIZE 字节)
+ */
+const uint8_t *u8g2_stm32_GetShadow(uint8_t *start_line);
+
+/**
+ * @brief 初始化并登记一个副显示器
+ * @details 副显示器使用自己的绘图缓冲区和影子副本 (U8G2_PANEL_COUNT - 1 个)，之后用
+ *          u8g2_stm32_SendBufferAsync() 和 u8g2_stm32_Service() 刷新，总是按页以 I2C_BUS_PRIO_PANEL 提交，
+ *          不会以整帧事务长时间占住总线，主显示器的帧可以插在它的页之间。须在 u8g2Init() 之后调用。
+ * @param[out] u8g2 副显示器的 u8g2 实例
+ * @param[in] i2c_address 8位I2C地址 (如 0x7A)
+ * @return HAL_StatusTypeDef 成功返回 HAL_OK，没有空位或显示器无应答返回 HAL_ERROR
+ */
+HAL_StatusTypeDef u8g2_stm32_PanelInit(u8g2_t *u8g2, uint8_t i2c_address);
+
+/**
+ * @brief 查询某个显示器的刷新是否仍在进行
+ * @param[in] u8g2 显示器的 u8g2 实例
+ * @return bool 正在刷新或有待补发的帧时返回 true，未登记的实例返回 false
+ */
+bool u8g2_stm32_PanelIsBusy(u8g2_t *u8g2);
+
+/**
+ * @brief 使某个显示器的影子副本失效, 下一次刷新将整帧发送
+ * @param[in] u8g2 显示器的 u8g2 实例
+ */
+void u8g2_stm32_PanelInvalidate(u8g2_t *u8g2);
+
+#else
+
+/**
+ * @brief 阻塞发送当前条带 (分页模式)
+ * @details 条带由 u8g2_SetBufferCurrTileRow() 选定。
+ * @param[in] u8g2 指向U8g2显示对象的指针
+ * @param[in] last 是否为本帧最后一个条带, 为 true 时发送完调用完成回调
+ */
+void u8g2_stm32_SendStrip(u8g2_t *u8g2, bool last);
+
+#endif /* U8G2_BUFFER_MODE */
+
+/**
+ * @brief 设置主显示器下一帧的驱动配置
+ * @details 与起始行一样在该帧的显存数据之后以一次命令 (复用率 0xA8、显示偏移 0xD3、预充电 0xD9、VCOMH 0xDB，
+ *          共8字节) 发送，与原来相同时不发送。U8G2_PROFILE_BAND 下只比较和发送扫描范围内的页，
+ *          范围之外的显存保持原样 (不显示)，影子副本仍与之一致，切回 U8G2_PROFILE_FULL 的那一帧按差异补发；
+ *          显存第 y 行显示在屏幕第 y + shift 行，改变 shift 即可整体上下移动画面而不重绘。
+ *          仅支持整帧模式，分页模式下返回 HAL_ERROR 且不改变显示器。
+ * @param[in] profile 驱动配置
+ * @param[in] shift U8G2_PROFILE_BAND 下画面在屏幕上的纵向偏移 (行)，须使扫描范围留在 0~63 行内；FULL 时忽略
+ * @return HAL_StatusTypeDef 已记下返回 HAL_OK，参数无效或不支持时返回 HAL_ERROR
+ */
+HAL_StatusTypeDef u8g2_stm32_SetProfile(U8g2_Profile_e profile, int8_t shift);
+
+/**
+ * @brief 校准显示器的 I2C 速率
+ * @details 在保底速率和校准上限之间找出显示器能可靠应答的最高速率，由 u8g2Init 调用。
+ *          运行中调用时先等待当前帧发送完，之后应重新初始化显示器。
+ *          SPI 接口不校准，返回固定的 SPI 时钟。
+ * @param[in] u8g2 指向U8g2显示对象的指针
+ * @return uint32_t 显示器使用的速率 (Hz)
+ */
+uint32_t u8g2_stm32_CalibrateSpeed(u8g2_t *u8g2);
+
+/**
+ * @brief 选择绘图缓冲区的像素写入方式
+ * @details 打开时把 u8g2 的 ll_hvline 回调换成位带实现，关闭时恢复 u8g2 自带的实现。
+ *          u8g2Init 和 u8g2_stm32_PanelInit 按 U8G2_BITBAND 设置，基准测试用它比较两种实现。
+ *          U8G2_BITBAND 为 0 时总是使用 u8g2 自带的实现。
+ * @param[in,out] u8g2 指向U8g2显示对象的指针 (须已调用 u8g2_Setup_*)
+ * @param[in] on 为 true 时使用位带实现
+ */
+void u8g2_stm32_SetBitband(u8g2_t *u8g2, bool on);
+
+/**
+ * @brief 查询最近几帧的平均刷新时间 (滑动平均)
+ * @return uint32_t 从开始发送到最后一页发送完成的平均时间 (ms, 向上取整)
+ */
+uint32_t u8g2_stm32_GetFrameTime(void);
+
+/**
+ * @brief 查询最近几帧的平均刷新时间 (滑动平均, DWT 计时)
+ * @return uint32_t 从开始发送到最后一页发送完成的平均时间 (us)
+ */
+uint32_t u8g2_stm32_GetFrameTimeUs(void);
+
+/**
+ * @brief 为主显示器的下一帧附上输入事件的时间戳
+ * @details 该帧开始发送时随帧保存，最后一个事务完成时把到达屏幕的延迟交给 Profiler_Record_Input。
+ *          上一次的时间戳尚未随帧发出 (如上一帧仍在发送、本帧被推迟) 时保留较早的一个。
+ * @param[in] ms 输入事件的时间戳 (HAL_GetTick)
+ */
+void u8g2_stm32_SetInputStamp(uint32_t ms);
+
+/**
+ * @brief 整帧刷新完成回调 (弱定义, 整帧模式下在中断上下文中调用, 分页模式下在调用者上下文中调用)
+ */
+void u8g2_stm32_FlushCpltCallback(void);
+
 extern I2C_HandleTypeDef hi2c1;
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+extern SPI_HandleTypeDef hspi1;
+extern DMA_HandleTypeDef hdma_spi1_tx;
+#elif U8G2_TRANSPORT == U8G2_TRANSPORT_I2C2
+extern I2C_HandleTypeDef hi2c2;
+extern DMA_HandleTypeDef hdma_i2c2_tx;
+#endif
+
+#if U8G2_R0_FAST && U8G2_BUFFER_MODE == 0
+
+/**
+ * @brief 把区间 [*a, *a + *len) 裁剪到 [c, d)
+ * @details 与 u8g2 内部的 u8g2_clip_intersection2 相同：起点加长度溢出时 (负坐标按无符号传入) 按从 c 开始处理。
+ * @param[in,out] a 起点
+ * @param[in,out] len 长度
+ * @param[in] c 窗口起点 (含)
+ * @param[in] d 窗口终点 (不含)
+ * @return uint8_t 有交集返回1，否则返回0
+ */
+__STATIC_INLINE uint8_t u8g2_stm32_R0Clip(u8g2_uint_t *a, u8g2_uint_t *len, u8g2_uint_t c, u8g2_uint_t d)
+{
+    u8g2_uint_t x0 = *a;
+    u8g2_uint_t x1 = (u8g2_uint_t)(x0 + *len);
+
+    if (x0 > x1)
+    {
+        if (x0 < d)
+        {
+            x1 = (u8g2_uint_t)(d - 1);
+        }
+        else
+        {
+            x0 = c;
+        }
+    }
+    if (x0 >= d || x1 <= c)
+    {
+        return 0;
+    }
+    if (x0 < c)
+    {
+        x0 = c;
+    }
+    if (x1 > d)
+    {
+        x1 = d;
+    }
+    *a = x0;
+    *len = (u8g2_uint_t)(x1 - x0);
+    return 1;
+}
+
+/**
+ * @brief R0 整帧模式的水平/垂直线：按用户窗口裁剪后直接调用 ll_hvline
+ * @param[in,out] u8g2 U8g2显示对象指针
+ * @param[in] x 起点列
+ * @param[in] y 起点行
+ * @param[in] len 长度
+ * @param[in] dir 0 为水平，1 为垂直
+ * @return 无
+ */
+__STATIC_INLINE void u8g2_stm32_R0DrawHVLine(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len, uint8_t dir)
+{
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+    if (u8g2->is_page_clip_window_intersection == 0)
+    {
+        return;
+    }
+#endif
+    if (len == 0)
+    {
+        return;
+    }
+    if (dir == 0)
+    {
+        if (y < u8g2->user_y0 || y >= u8g2->user_y1 || !u8g2_stm32_R0Clip(&x, &len, u8g2->user_x0, u8g2->user_x1))
+        {
+            return;
+        }
+    }
+    else
+    {
+        if (x < u8g2->user_x0 || x >= u8g2->user_x1 || !u8g2_stm32_R0Clip(&y, &len, u8g2->user_y0, u8g2->user_y1))
+        {
+            return;
+        }
+    }
+    u8g2->ll_hvline(u8g2, x, y, len, dir); // 整帧模式的 pixel_curr_row 恒为0
+}
+
+/**
+ * @brief R0 整帧模式的方框：裁剪后按列画垂直线
+ * @param[in,out] u8g2 U8g2显示对象指针
+ * @param[in] x 左上角列
+ * @param[in] y 左上角行
+ * @param[in] w 宽度
+ * @param[in] h 高度
+ * @return 无
+ */
+__STATIC_INLINE void u8g2_stm32_R0DrawBox(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h)
+{
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+    if (u8g2->is_page_clip_window_intersection == 0)
+    {
+        return;
+    }
+#endif
+    if (w == 0 || h == 0 || !u8g2_stm32_R0Clip(&x, &w, u8g2->user_x0, u8g2->user_x1) ||
+        !u8g2_stm32_R0Clip(&y, &h, u8g2->user_y0, u8g2->user_y1))
+    {
+        return;
+    }
+    for (; w != 0; w--, x++)
+    {
+        u8g2->ll_hvline(u8g2, x, y, h, 1);
+    }
+}
+
+#define u8g2_DrawHLine(u8g2, x, y, w) u8g2_stm32_R0DrawHVLine((u8g2), (x), (y), (w), 0)
+#define u8g2_DrawVLine(u8g2, x, y, h) u8g2_stm32_R0DrawHVLine((u8g2), (x), (y), (h), 1)
+#define u8g2_DrawPixel(u8g2, x, y)    u8g2_stm32_R0DrawHVLine((u8g2), (x), (y), 1, 0)
+#define u8g2_DrawBox(u8g2, x, y, w, h) u8g2_stm32_R0DrawBox((u8g2), (x), (y), (w), (h))
+
+#endif /* U8G2_R0_FAST */
 
 #endif /* __U8G2_STM32_HAL_H */
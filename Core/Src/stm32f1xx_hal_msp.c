@@ -77,7 +77,12 @@ void HAL_MspInit(void)
   __HAL_AFIO_REMAP_SWJ_NOJTAG();
 
   /* USER CODE BEGIN MspInit 1 */
-
+  /* 中断优先级规划见 main.h 的 IRQ_PRIO_*：全部4位用作抢占优先级 (HAL_Init 已设置，这里明确写出，
+   * 不依赖 HAL 的默认值)。各级从高到低为：掉电检测 > 输入采样 (TIM2/EXTI/TIM4) > I2C 和显示器 DMA 完成
+   * > 串口/USB > 后台 DMA (显存拷贝、ADC) > SysTick (TICK_INT_PRIORITY，最低)，主循环中的渲染可被任何中断打断。
+   * CubeMX 生成的外设在 .ioc 中按这些数值配置，手写初始化的外设直接使用宏；
+   * 按键扫描的实际响应延迟由 PROF_SEC_IRQ_LAT 测量，显示在诊断页面的 I2C 视图中。 */
+  HAL_NVIC_SetPriorityGrouping(NVIC_PRIORITYGROUP_4);
   /* USER CODE END MspInit 1 */
 }
 
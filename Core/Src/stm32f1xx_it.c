@@ -23,6 +23,11 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "input.h"
+#include "DS3231.h"
+#include "app_power.h"
+#include "u8g2_stm32_hal.h"
+#include "profiler.h"
+#include "i2c_bus.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -56,9 +61,12 @@
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern DMA_HandleTypeDef hdma_i2c1_tx;
+extern I2C_HandleTypeDef hi2c1;
 extern TIM_HandleTypeDef htim2;
 extern DMA_HandleTypeDef hdma_usart1_rx;
 extern DMA_HandleTypeDef hdma_usart1_tx;
+extern PCD_HandleTypeDef hpcd_USB_FS;
 extern UART_HandleTypeDef huart1;
 /* USER CODE BEGIN EV */
 
@@ -191,6 +199,7 @@ void SysTick_Handler(void)
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+  DS3231_Tick_Handler();
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -202,13 +211,59 @@ void SysTick_Handler(void)
 /* please refer to the startup file (startup_stm32f1xx.s).                    */
 /******************************************************************************/
 
+/**
+  * @brief This function handles EXTI line0 interrupt.
+  */
+void EXTI0_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI0_IRQn 0 */
+
+  /* USER CODE END EXTI0_IRQn 0 */
+  HAL_GPIO_EXTI_IRQHandler(RTC_SQW_Pin);
+  /* USER CODE BEGIN EXTI0_IRQn 1 */
+
+  /* USER CODE END EXTI0_IRQn 1 */
+}
+
+/**
+  * @brief This function handles EXTI line1 interrupt.
+  */
+void EXTI1_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI1_IRQn 0 */
+
+  /* USER CODE END EXTI1_IRQn 0 */
+  HAL_GPIO_EXTI_IRQHandler(KEY_CON_Pin);
+  /* USER CODE BEGIN EXTI1_IRQn 1 */
+
+  /* USER CODE END EXTI1_IRQn 1 */
+}
+
+/**
+  * @brief This function handles EXTI line3 interrupt.
+  */
+void EXTI3_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI3_IRQn 0 */
+
+  /* USER CODE END EXTI3_IRQn 0 */
+  HAL_GPIO_EXTI_IRQHandler(KEY_BCK_Pin);
+  /* USER CODE BEGIN EXTI3_IRQn 1 */
+
+  /* USER CODE END EXTI3_IRQn 1 */
+}
+
 /**
   * @brief This function handles DMA1 channel4 global interrupt.
   */
 void DMA1_Channel4_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Channel4_IRQn 0 */
-
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_I2C2
+  // 通道4 在双总线版本中交给 I2C2_TX，USART1 发送改为中断驱动
+  HAL_DMA_IRQHandler(&hdma_i2c2_tx);
+  return;
+#endif
   /* USER CODE END DMA1_Channel4_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart1_tx);
   /* USER CODE BEGIN DMA1_Channel4_IRQn 1 */
@@ -230,20 +285,104 @@ void DMA1_Channel5_IRQHandler(void)
   /* USER CODE END DMA1_Channel5_IRQn 1 */
 }
 
+/**
+  * @brief This function handles DMA1 channel6 global interrupt.
+  */
+void DMA1_Channel6_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel6_IRQn 0 */
+  PROF_ISR_BEGIN();
+  /* USER CODE END DMA1_Channel6_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_i2c1_tx);
+  /* USER CODE BEGIN DMA1_Channel6_IRQn 1 */
+  PROF_ISR_END();
+  /* USER CODE END DMA1_Channel6_IRQn 1 */
+}
+
+/**
+  * @brief This function handles USB low priority or CAN RX0 interrupts.
+  */
+void USB_LP_CAN1_RX0_IRQHandler(void)
+{
+  /* USER CODE BEGIN USB_LP_CAN1_RX0_IRQn 0 */
+
+  /* USER CODE END USB_LP_CAN1_RX0_IRQn 0 */
+  HAL_PCD_IRQHandler(&hpcd_USB_FS);
+  /* USER CODE BEGIN USB_LP_CAN1_RX0_IRQn 1 */
+
+  /* USER CODE END USB_LP_CAN1_RX0_IRQn 1 */
+}
+
+/**
+  * @brief This function handles EXTI line[9:5] interrupts.
+  */
+void EXTI9_5_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI9_5_IRQn 0 */
+  PROF_ISR_BEGIN();
+  /* USER CODE END EXTI9_5_IRQn 0 */
+  HAL_GPIO_EXTI_IRQHandler(KEY_EN_Pin);
+  /* USER CODE BEGIN EXTI9_5_IRQn 1 */
+  // 编码器的两相 (PA6/PA7) 由 input 模块另行配置为双边沿 EXTI
+  HAL_GPIO_EXTI_IRQHandler(EA_Pin);
+  HAL_GPIO_EXTI_IRQHandler(EB_Pin);
+  PROF_ISR_END();
+  /* USER CODE END EXTI9_5_IRQn 1 */
+}
+
 /**
   * @brief This function handles TIM2 global interrupt.
   */
 void TIM2_IRQHandler(void)
 {
   /* USER CODE BEGIN TIM2_IRQn 0 */
-
+  PROF_IRQ_LATENCY(PROF_SEC_IRQ_LAT, TIM2); // 第一条语句：计数值即从更新事件到这里的延迟 (us)
+  PROF_ISR_BEGIN();
   /* USER CODE END TIM2_IRQn 0 */
   HAL_TIM_IRQHandler(&htim2);
   /* USER CODE BEGIN TIM2_IRQn 1 */
-
+  PROF_ISR_END();
   /* USER CODE END TIM2_IRQn 1 */
 }
 
+/**
+  * @brief This function handles I2C1 event interrupt.
+  */
+void I2C1_EV_IRQHandler(void)
+{
+  /* USER CODE BEGIN I2C1_EV_IRQn 0 */
+  PROF_ISR_BEGIN();
+  if (I2C_Bus_EV_IRQHandler(&hi2c1))
+  {
+    PROF_ISR_END();
+    return; // 显示器写事务的寄存器级路径，不经过 HAL 的状态机
+  }
+  /* USER CODE END I2C1_EV_IRQn 0 */
+  HAL_I2C_EV_IRQHandler(&hi2c1);
+  /* USER CODE BEGIN I2C1_EV_IRQn 1 */
+  PROF_ISR_END();
+  /* USER CODE END I2C1_EV_IRQn 1 */
+}
+
+/**
+  * @brief This function handles I2C1 error interrupt.
+  */
+void I2C1_ER_IRQHandler(void)
+{
+  /* USER CODE BEGIN I2C1_ER_IRQn 0 */
+  PROF_ISR_BEGIN();
+  if (I2C_Bus_ER_IRQHandler(&hi2c1))
+  {
+    PROF_ISR_END();
+    return;
+  }
+  /* USER CODE END I2C1_ER_IRQn 0 */
+  HAL_I2C_ER_IRQHandler(&hi2c1);
+  /* USER CODE BEGIN I2C1_ER_IRQn 1 */
+  PROF_ISR_END();
+  /* USER CODE END I2C1_ER_IRQn 1 */
+}
+
 /**
   * @brief This function handles USART1 global interrupt.
   */
@@ -258,8 +397,57 @@ void USART1_IRQHandler(void)
   /* USER CODE END USART1_IRQn 1 */
 }
 
+/**
+  * @brief This function handles USB wake-up interrupt through EXTI line 18.
+  */
+void USBWakeUp_IRQHandler(void)
+{
+  /* USER CODE BEGIN USBWakeUp_IRQn 0 */
+  // 只用于把 MCU 从停止模式唤醒，恢复和复位由 USB 中断处理
+  /* USER CODE END USBWakeUp_IRQn 0 */
+  /* Clear EXTI pending bit */
+  __HAL_USB_WAKEUP_EXTI_CLEAR_FLAG();
+  /* USER CODE BEGIN USBWakeUp_IRQn 1 */
+
+  /* USER CODE END USBWakeUp_IRQn 1 */
+}
+
 /* USER CODE BEGIN 1 */
 
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+/**
+  * @brief This function handles DMA1 channel3 global interrupt (SPI1_TX，SPI 版显示器).
+  */
+void DMA1_Channel3_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_spi1_tx);
+}
+#elif U8G2_TRANSPORT == U8G2_TRANSPORT_I2C2
+/**
+  * @brief This function handles I2C2 event interrupt (双总线版本的显示器).
+  */
+void I2C2_EV_IRQHandler(void)
+{
+  if (I2C_Bus_EV_IRQHandler(&hi2c2))
+  {
+    return;
+  }
+  HAL_I2C_EV_IRQHandler(&hi2c2);
+}
+
+/**
+  * @brief This function handles I2C2 error interrupt.
+  */
+void I2C2_ER_IRQHandler(void)
+{
+  if (I2C_Bus_ER_IRQHandler(&hi2c2))
+  {
+    return;
+  }
+  HAL_I2C_ER_IRQHandler(&hi2c2);
+}
+#endif
+
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
     if(htim == &htim2)
@@ -271,4 +459,19 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 
 }
 
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    if(GPIO_Pin == RTC_SQW_Pin)
+    {
+      // DS3231 的 1Hz 方波，先补偿按键唤醒时少计的滴答，再推进 RAM 中缓存的时间
+      Power_Sqw_Edge();
+      DS3231_SQW_IRQ_Handler();
+    }
+    else
+    {
+      // 按键或编码器边沿，唤醒输入扫描
+      input_exti_irq_handler(GPIO_Pin);
+    }
+}
+
 /* USER CODE END 1 */
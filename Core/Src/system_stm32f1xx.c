@@ -95,7 +95,13 @@
      remap of boot address selected */
 /* #define USER_VECT_TAB_ADDRESS */
 
-#if defined(USER_VECT_TAB_ADDRESS)
+/* Table Clock App 目标 (APP_BOOTLOADER=1) 链接在引导程序之后，向量表位于 BOOT_APP_BASE */
+#if defined(APP_BOOTLOADER) && APP_BOOTLOADER
+#include "boot.h"
+#define USER_VECT_TAB_ADDRESS
+#define VECT_TAB_BASE_ADDRESS   FLASH_BASE
+#define VECT_TAB_OFFSET         (BOOT_APP_BASE - FLASH_BASE)
+#elif defined(USER_VECT_TAB_ADDRESS)
 /*!< Uncomment the following line if you need to relocate your vector Table
      in Sram else user remap will be done in Flash. */
 /* #define VECT_TAB_SRAM */
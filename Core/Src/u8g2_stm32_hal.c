@@ -2,17 +2,242 @@
  * @file      u8g2_stm32_hal.c
  * @brief     U8g2图形库与STM32 HAL库的适配层实现
  * @details   本文件实现了U8g2图形库与STM32 HAL库之间的接口，包括：
- *            - I2C通信回调函数实现
+ *            - I2C通信回调函数实现 (经总线队列的双缓冲发送)
+ *            - SPI通信回调函数实现和整帧 DMA 发送 (U8G2_TRANSPORT 为 SPI 时)
+ *            - 整帧异步刷新 (按页链式提交总线事务, 完成后回调)
+ *            - 脏区跟踪 (与上一帧比较, 每页只发送变化的列区间; U8G2_DIRTY_CRC 时改为比较每段的硬件 CRC)
+ *            - 整帧快速上传 (水平寻址模式, 1024 字节在一次事务中发完)
+ *            - 显示起始行 (硬件纵向滚动, 随整帧一起提交)
+ *            - 驱动配置 (只扫描部分行并降低预充电和 VCOMH, 随整帧一起提交)
+ *            - 画面捕获 (累积整帧模式下各页的变化区间, 供远程镜像读取影子副本)
+ *            - 输入延迟 (随帧保存输入事件的时间戳, 发送完成时记录到性能分析模块)
+ *            - 副显示器 (U8G2_PANEL_COUNT > 1 时) 各自的绘图缓冲区、影子副本和按页刷新
+ *            - 分页模式 (U8G2_BUFFER_MODE 为 1/2 时) 的条带阻塞发送
  *            - GPIO和延时回调函数实现
- *            - U8g2初始化函数实现
+ *            - 位带方式的像素写入 (替换 u8g2 的 ll_hvline 回调)
+ *            - U8g2初始化函数实现 (含上电应答探测、显示器 I2C 速率校准和一次事务的初始化序列)
  * @author    Sandocean
- * @date      2025-08-25
- * @version   1.0
- * @note      本适配层专为STM32 HAL库设计，支持I2C通信的OLED显示器
+ * @date      2025-10-08
+ * @version   1.13
+ * @note      本适配层专为STM32 HAL库设计，支持I2C和4线SPI通信的OLED显示器。
+ *            I2C1 与 DS3231/AT24C32/AHT20 共用, 所有传输都经由 i2c_bus 模块以最高优先级排队。
+ *            SPI1 只连接显示器, 由本文件初始化 (不在 CubeMX 工程中), 整帧模式下帧数据经 DMA 发送。
+ *            U8G2_TRANSPORT_I2C2 时显示器独占 I2C2, 同样由本文件初始化, 并作为第二条总线登记到 i2c_bus。
  * @copyright Copyright (c) 2025 SandOcean
  */
 
 #include "u8g2_stm32_hal.h"
+#include "i2c_bus.h"
+#include "profiler.h"
+#include "trace.h"
+#include "mark.h"
+#if U8G2_DIRTY_CRC
+#include "hw_crc.h"
+#endif
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+
+#define U8G2_I2C_CHUNK_SIZE   32   ///< 字节回调单次传输的最大长度
+#define U8G2_I2C_TIMEOUT_MS   100  ///< 字节回调等待缓冲区可用的超时时间
+#define U8G2_POWER_UP_MAX_MS  150  ///< 等待显示器应答的最长时间 (从MCU复位算起)，仍无应答时照常初始化
+#ifndef U8G2_POWER_UP_MS
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+#define U8G2_POWER_UP_MS      U8G2_POWER_UP_MAX_MS ///< SPI 接口没有应答可以探测，固定等待
+#else
+#define U8G2_POWER_UP_MS      20   ///< 开始探测显示器应答的时间 (从MCU复位算起)
+#endif
+#endif
+#define U8G2_POWER_UP_POLL_MS 5    ///< 两次探测之间的间隔
+#ifndef U8G2_INIT_BURST
+#define U8G2_INIT_BURST       (U8G2_TRANSPORT != U8G2_TRANSPORT_SPI) ///< 为 1 时以一次 I2C 事务发送整个初始化序列 (SPI 接口须按 u8x8 的时序复位)
+#endif
+#define U8G2_HAS_RESET_PIN    (U8G2_TRANSPORT == U8G2_TRANSPORT_SPI) ///< 模块是否连接了 RES 引脚 (SPI 版模块引出了 RES)，未连接时跳过 u8x8 复位时序中的延时
+#define U8G2_SPI_TIMEOUT_MS   10   ///< SPI 阻塞发送的超时时间
+#define U8G2_I2C_MIN_HZ       400000 ///< 显示器的保底 SCL 速率 (Hz)，与其他设备相同
+#ifndef U8G2_I2C_MAX_HZ
+#define U8G2_I2C_MAX_HZ       800000 ///< 速率校准尝试的最高速率 (Hz)，不大于 U8G2_I2C_MIN_HZ 时不校准
+#endif
+
+#define SSD1306_CTRL_CMD      0x00 ///< 控制字节: 后续均为命令
+#define SSD1306_CTRL_DATA     0x40 ///< 控制字节: 后续均为显存数据
+#define SSD1306_START_LINE    0x40 ///< 命令: 显示起始行 (低6位为行号)
+#define SSD1306_NOP           0xE3 ///< 命令: 空操作
+#define SSD1306_ADDR_MODE     0x20 ///< 命令: 显存寻址模式 (后跟1字节模式)
+#define SSD1306_ADDR_HORIZ    0x00 ///< 寻址模式: 水平, 写到窗口末列后自动转到下一页
+#define SSD1306_ADDR_PAGE     0x02 ///< 寻址模式: 页, 只在当前页内递增列地址
+#define SSD1306_COL_RANGE     0x21 ///< 命令: 列窗口 (后跟起始列和结束列, 水平寻址模式)
+#define SSD1306_PAGE_RANGE    0x22 ///< 命令: 页窗口 (后跟起始页和结束页, 水平寻址模式)
+#define SSD1306_MUX_RATIO     0xA8 ///< 命令: 复用率 (后跟扫描行数 - 1)
+#define SSD1306_DISP_OFFSET   0xD3 ///< 命令: 显示偏移 (后跟第0显示行所在的 COM)
+#define SSD1306_PRECHARGE     0xD9 ///< 命令: 预充电周期 (后跟两个阶段的时钟数)
+#define SSD1306_VCOMH         0xDB ///< 命令: VCOMH 电平 (后跟电平)
+#define SSD1306_DISPLAY_OFF   0xAE ///< 命令: 关闭显示
+#define SSD1306_DISPLAY_ON    0xAF ///< 命令: 打开显示
+#define SSD1306_CLOCK_DIV     0xD5 ///< 命令: 时钟分频和振荡频率 (后跟1字节)
+#define SSD1306_CHARGE_PUMP   0x8D ///< 命令: 电荷泵 (后跟 0x14 打开)
+#define SSD1306_SEG_REMAP     0xA0 ///< 命令: 段重映射 (最低位为1时第127列对应 SEG0)
+#define SSD1306_COM_SCAN      0xC0 ///< 命令: COM 扫描方向 (加 0x08 为反向)
+#define SSD1306_COM_PINS      0xDA ///< 命令: COM 引脚配置 (后跟1字节)
+#define SSD1306_CONTRAST      0x81 ///< 命令: 对比度 (后跟1字节)
+#define SSD1306_SCROLL_OFF    0x2E ///< 命令: 停止滚动
+#define SSD1306_RAM_ON        0xA4 ///< 命令: 按显存内容显示
+#define SSD1306_NORMAL        0xA6 ///< 命令: 不反色
+#define FULL_PRECHARGE        0xF1 ///< u8g2 初始化序列中的预充电周期
+#define FULL_VCOMH            0x40 ///< u8g2 初始化序列中的 VCOMH 电平
+#define START_LINE_UNKNOWN    0xFF ///< 控制器当前的起始行未知 (重新初始化后), 下一帧必须发送
+#define PROFILE_UNKNOWN       0xFF ///< 控制器当前的驱动配置未知 (重新初始化后), 下一帧必须发送
+#define ADDR_MODE_UNKNOWN     0xFF ///< 控制器当前的寻址模式未知 (重新初始化后), 下一帧必须设置
+#define FLUSH_TXN_OVERHEAD    8    ///< 按页发送时每页的固定开销 (两次起始和地址、控制字节、页地址命令), 按字节计
+#define BITBAND_SRAM_BASE     0x20000000UL ///< 位带区的 SRAM 起始地址
+#define BITBAND_ALIAS_BASE    0x22000000UL ///< SRAM 位带别名区的起始地址
+#if U8G2_DIRTY_CRC
+#define PANEL_TX_BUF(p)       u8g2_GetBufferPtr((p)->u8g2) ///< 刷新的数据来源: CRC 模式下直接发送绘图缓冲区
+#else
+#define PANEL_TX_BUF(p)       ((p)->frame_tx_buf)          ///< 刷新的数据来源: 影子副本
+#endif
+#define BITBAND_ALIAS(addr, bit) ((volatile uint32_t *)(BITBAND_ALIAS_BASE + (((uint32_t)(addr) - BITBAND_SRAM_BASE) << 5) + ((uint32_t)(bit) << 2))) ///< 字节 addr 第 bit 位的别名字
+
+/* Private types -------------------------------------------------------------*/
+
+#if U8G2_BUFFER_MODE == 0
+
+/**
+ * @brief 整帧异步刷新的阶段
+ */
+typedef enum
+{
+    FLUSH_IDLE = 0, ///< 空闲
+    FLUSH_CMD,      ///< 正在发送页地址命令
+    FLUSH_DATA,     ///< 正在发送一页显存数据
+    FLUSH_LINE      ///< 正在发送显示起始行命令 (所有页发完之后)
+} Flush_Phase_e;
+
+/**
+ * @brief 整帧异步刷新的状态
+ */
+typedef struct
+{
+    volatile Flush_Phase_e phase; ///< 当前阶段, 在中断中推进
+    volatile uint8_t page;        ///< 当前正在发送的页 (0-7)
+    uint8_t i2c_address;          ///< 显示器的8位I2C地址
+    bool pending;                 ///< 刷新进行中又收到了新帧, 等待 u8g2_stm32_Service 补发
+    bool full;                    ///< 本帧以水平寻址模式整帧发送
+    uint8_t cmd[10];              ///< 地址命令缓冲区 (帧末为驱动配置和起始行, 最多9字节)
+    uint8_t start_line;           ///< 本帧的显示起始行
+    uint8_t profile;              ///< 本帧的驱动配置 (U8g2_Profile_e)
+    int8_t shift;                 ///< 本帧的纵向偏移 (U8G2_PROFILE_BAND)
+    uint8_t dirty_x0[U8G2_FRAME_PAGES]; ///< 每页变化区间的起始列
+    uint8_t dirty_x1[U8G2_FRAME_PAGES]; ///< 每页变化区间的结束列 (不含), 等于起始列表示该页无变化
+} Flush_State_t;
+
+/**
+ * @brief 一个显示器的影子副本和刷新状态
+ * @details 主显示器 (panels[0]) 由 u8g2Init 登记, 其余由 u8g2_stm32_PanelInit 登记。
+ *          画面捕获、刷新时间统计和完成回调只针对主显示器。
+ */
+typedef struct
+{
+    u8g2_t *u8g2;                 ///< 显示器的 u8g2 实例, 为 NULL 表示未登记
+    Flush_State_t flush;          ///< 整帧异步刷新的状态
+#if U8G2_DIRTY_CRC
+    uint32_t seg_crc[U8G2_FRAME_PAGES][U8G2_CRC_SEGS]; ///< 屏幕上每段内容的 CRC-32
+#else
+    uint8_t frame_tx_buf[U8G2_FRAME_BUF_SIZE]; ///< 发送缓冲区, 同时是屏幕上当前内容的影子副本
+#endif
+    bool shadow_valid;            ///< 影子副本 (或 CRC) 是否与屏幕一致, 为 false 时整帧发送
+    bool paged;                   ///< 总是按页发送 (不以单个 1024 字节的事务整帧发送)
+    I2C_Bus_Prio_e prio;          ///< 刷新事务的总线优先级
+    uint8_t start_line_next;      ///< 下一帧要使用的显示起始行
+    uint8_t start_line_shown;     ///< 控制器当前的显示起始行 (u8x8 初始化后为0)
+    uint8_t addr_mode_shown;      ///< 控制器当前的寻址模式
+    uint8_t profile_next;         ///< 下一帧要使用的驱动配置
+    int8_t shift_next;            ///< 下一帧要使用的纵向偏移
+    uint8_t profile_shown;        ///< 控制器当前的驱动配置 (u8x8 初始化后为 U8G2_PROFILE_FULL)
+    int8_t shift_shown;           ///< 控制器当前的纵向偏移
+} Panel_t;
+
+#endif /* U8G2_BUFFER_MODE == 0 */
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint8_t i2c_tx_buf[2][U8G2_I2C_CHUNK_SIZE]; ///< 字节回调的双缓冲区
+static uint8_t i2c_tx_sel;                         ///< 当前正在填充的缓冲区
+static uint8_t i2c_tx_len;                         ///< 当前缓冲区已填充的字节数
+static volatile bool i2c_tx_busy[2];               ///< 缓冲区是否仍在总线队列中
+
+#if U8G2_BUFFER_MODE == 0
+static Panel_t panels[U8G2_PANEL_COUNT];           ///< 各显示器的刷新状态, panels[0] 为主显示器
+static bool capture_on;                            ///< 画面捕获是否开启
+static uint8_t capture_x0[U8G2_FRAME_PAGES];       ///< 每页尚未取走的变化区间起点
+static uint8_t capture_x1[U8G2_FRAME_PAGES];       ///< 每页尚未取走的变化区间终点 (不含), 不大于起点表示无变化
+static uint8_t capture_line;                       ///< 最近一帧的显示起始行
+#if U8G2_DIRTY_CRC
+static bool draw_open;                             ///< 主显示器的绘图缓冲区正在绘制 (DrawBegin 之后尚未提交), 画面捕获暂停
+#endif
+#if U8G2_PANEL_COUNT > 1
+static uint8_t panel_draw_buf[U8G2_PANEL_COUNT - 1][U8G2_FRAME_BUF_SIZE]; ///< 副显示器的绘图缓冲区 (_f 的缓冲区是所有实例共用的静态数组)
+#endif
+#endif
+static bool in_display_init;                       ///< 是否正在执行 u8g2_InitDisplay
+static uint32_t frame_start_cyc;                   ///< 当前帧开始发送时的 DWT 周期计数
+static uint32_t frame_time_x4;                     ///< 刷新时间的滑动平均 (us, 放大4倍)
+static uint32_t input_stamp_next;                  ///< 下一帧附带的输入时间戳
+static bool input_stamp_pending;                   ///< input_stamp_next 有效, 尚未随帧发出
+static uint32_t input_stamp_frame;                 ///< 正在发送的一帧附带的输入时间戳
+static bool input_stamp_sending;                   ///< 正在发送的一帧附带了输入时间戳
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+SPI_HandleTypeDef hspi1;                           ///< 显示器的 SPI 句柄
+DMA_HandleTypeDef hdma_spi1_tx;                    ///< SPI1 发送的 DMA 句柄 (DMA1 通道3)
+#elif U8G2_TRANSPORT == U8G2_TRANSPORT_I2C2
+I2C_HandleTypeDef hi2c2;                           ///< 显示器独占的 I2C2 句柄
+DMA_HandleTypeDef hdma_i2c2_tx;                    ///< I2C2 发送的 DMA 句柄 (DMA1 通道4)
+#endif
+#if U8G2_BUFFER_MODE != 0
+static bool strip_frame_started;                   ///< 本帧是否已发送过条带
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+
+static HAL_StatusTypeDef u8g2_stm32_submit(const I2C_Bus_Txn_t *txn);
+static void u8g2_stm32_chunk_cb(HAL_StatusTypeDef status, void *ctx);
+#if U8G2_BUFFER_MODE == 0 && U8G2_TRANSPORT != U8G2_TRANSPORT_SPI
+static HAL_StatusTypeDef u8g2_stm32_flush_next(Panel_t *p);
+static void u8g2_stm32_flush_cb(HAL_StatusTypeDef status, void *ctx);
+static uint8_t u8g2_stm32_diff_page(Panel_t *p, const uint8_t *src, uint8_t page);
+#endif
+#if U8G2_BUFFER_MODE == 0
+static bool u8g2_stm32_page_scanned(uint8_t profile, uint8_t page);
+static uint8_t u8g2_stm32_end_cmds(Panel_t *p);
+static Panel_t *u8g2_stm32_panel(u8g2_t *u8g2);
+static void u8g2_stm32_capture_mark(uint8_t page, uint8_t x0, uint8_t x1);
+#endif
+#if U8G2_BUFFER_MODE == 0 && U8G2_DIRTY_CRC
+static uint8_t u8g2_stm32_crc_page(Panel_t *p, const uint8_t *src, uint8_t page);
+#endif
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+static void u8g2_stm32_spi_init(void);
+#if U8G2_BUFFER_MODE == 0
+static HAL_StatusTypeDef u8g2_stm32_spi_flush(u8g2_t *u8g2);
+static void u8g2_stm32_spi_end_frame(void);
+static void u8g2_stm32_spi_abort(void);
+#endif
+#elif U8G2_TRANSPORT == U8G2_TRANSPORT_I2C2
+static void u8g2_stm32_i2c2_init(void);
+#endif
+static void u8g2_stm32_frame_start(void);
+static void u8g2_stm32_frame_done(void);
+static void u8g2_stm32_delay_cycles(uint32_t cycles);
+static void u8g2_stm32_delay_ms(uint32_t ms);
+#if U8G2_TRANSPORT != U8G2_TRANSPORT_SPI
+static void u8g2_stm32_wait_ready(u8g2_t *u8g2);
+#endif
+static void u8g2_stm32_init_controller(u8g2_t *u8g2, I2C_Bus_Prio_e prio);
+#if U8G2_BITBAND
+static void u8g2_stm32_ll_hvline_bitband(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len, uint8_t dir);
+#endif
+
+/* Function implementations --------------------------------------------------*/
 
 /**
  * @defgroup U8g2_HAL_Implementation U8g2 STM32 HAL Implementation
@@ -39,20 +264,18 @@ u8g2_t u8g2;
  */
 uint8_t u8x8_byte_stm32_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
-    static uint8_t buffer[32]; // 传输缓冲区
-    static uint8_t buf_idx;    // 缓冲区索引
     uint8_t *data;
 
     switch (msg)
     {
     case U8X8_MSG_BYTE_SEND:
         data = (uint8_t *)arg_ptr;
-        while (arg_int > 0)
+        if (i2c_tx_len + arg_int > U8G2_I2C_CHUNK_SIZE)
         {
-            buffer[buf_idx++] = *data;
-            data++;
-            arg_int--;
+            return 0; // 超出单次传输长度
         }
+        memcpy(&i2c_tx_buf[i2c_tx_sel][i2c_tx_len], data, arg_int);
+        i2c_tx_len += arg_int;
         break;
     case U8X8_MSG_BYTE_INIT:
         // I2C已由CubeMX初始化，此处无需操作
@@ -61,64 +284,95 @@ uint8_t u8x8_byte_stm32_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
         // 对于I2C，DC线（数据/命令选择）通常由I2C协议本身处理，此处无需操作
         break;
     case U8X8_MSG_BYTE_START_TRANSFER:
-        buf_idx = 0;
+        i2c_tx_len = 0;
         break;
     case U8X8_MSG_BYTE_END_TRANSFER:
-        // 关键! HAL库的I2C地址是7位的，而U8g2传入的是8位的（包含R/W位），需要右移一位
-        if (HAL_I2C_Master_Transmit(&hi2c1, (u8x8->i2c_address), buffer, buf_idx, 1000) != HAL_OK)
+    {
+        // 提交到总线队列后切换缓冲区; 下次轮到本缓冲区时, 它的上一次传输必须已经完成
+        I2C_Bus_Txn_t txn = {
+            .op = I2C_BUS_OP_TX,
+            .dev_addr = u8x8->i2c_address, // HAL库与U8g2均使用8位地址（包含R/W位），直接传入即可
+            .data = i2c_tx_buf[i2c_tx_sel],
+            .size = i2c_tx_len,
+            .cb = u8g2_stm32_chunk_cb,
+            .ctx = (void *)&i2c_tx_busy[i2c_tx_sel],
+        };
+        i2c_tx_busy[i2c_tx_sel] = true;
+        if (u8g2_stm32_submit(&txn) != HAL_OK)
         {
+            i2c_tx_busy[i2c_tx_sel] = false;
             return 0; // 传输失败
         }
+        i2c_tx_sel ^= 1; // 切换到另一个缓冲区继续填充
+
+        uint32_t tickstart = HAL_GetTick();
+        while (i2c_tx_busy[i2c_tx_sel])
+        {
+            if ((HAL_GetTick() - tickstart) > U8G2_I2C_TIMEOUT_MS)
+            {
+                return 0;
+            }
+            I2C_Bus_Service();
+        }
         break;
+    }
     default:
         return 0;
     }
     return 1;
 }
 
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+
 /**
- * @brief U8g2的GPIO和延时回调函数
- * @details U8g2库通过此函数请求GPIO操作（在此I2C实现中未使用）和延时。
- *          它处理毫秒、微秒和纳秒级别的延时请求。
+ * @brief U8g2的SPI通信回调函数
+ * @details 4线SPI: 由 u8x8 通过 SET_DC 切换命令/数据, 片选在一次传输的开始和结束时切换。
+ *          每次发送都是阻塞的, 只用于初始化序列、电源和对比度等命令以及分页模式的条带;
+ *          整帧模式下若 DMA 正在发送一帧, 开始传输前先等待它完成, 避免两者交错。
  * @param[in] u8x8 U8g2显示对象指针
- * @param[in] msg U8g2传递的消息类型 (e.g., U8X8_MSG_DELAY_MILLI)
- * @param[in] arg_int 消息相关的整数参数 (e.g., delay duration)
- * @param[in] arg_ptr 消息相关的指针参数 (未使用)
+ * @param[in] msg U8g2传递的消息类型
+ * @param[in] arg_int 消息相关的整数参数
+ * @param[in] arg_ptr 消息相关的指针参数
  * @return uint8_t 操作结果
  *         - @retval 1 成功
- *         - @retval 0 失败 (消息不被支持时)
+ *         - @retval 0 失败
  */
-uint8_t u8x8_stm32_gpio_and_delay(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+uint8_t u8x8_byte_stm32_hw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
     switch (msg)
     {
-    case U8X8_MSG_GPIO_AND_DELAY_INIT:
-        // GPIO已由CubeMX初始化，此处无需操作
-        break;
-    case U8X8_MSG_DELAY_MILLI:
-        HAL_Delay(arg_int);
-        break;
-    case U8X8_MSG_DELAY_10MICRO:
-        // 实现一个粗略的10us延时
-        for (uint16_t n = 0; n < 320; n++)
+    case U8X8_MSG_BYTE_SEND:
+        if (HAL_SPI_Transmit(&hspi1, (uint8_t *)arg_ptr, arg_int, U8G2_SPI_TIMEOUT_MS) != HAL_OK)
         {
-            __NOP();
+            return 0;
         }
         break;
-    case U8X8_MSG_DELAY_NANO:
-        // 实现一个粗略的纳秒级延时
-        __NOP();
+    case U8X8_MSG_BYTE_INIT:
+        // SPI1 已由 u8g2Init 初始化，这里只把片选置为无效
+        u8x8_gpio_SetCS(u8x8, u8x8->display_info->chip_disable_level);
         break;
-    // 以下GPIO操作对于纯I2C模式的SSD1306不是必需的，但最好保留
-    case U8X8_MSG_GPIO_CS:
-        // 片选，I2C模式下不需要
+    case U8X8_MSG_BYTE_SET_DC:
+        u8x8_gpio_SetDC(u8x8, arg_int);
         break;
-    case U8X8_MSG_GPIO_DC:
-        // 数据/命令选择，I2C模式下不需要
+    case U8X8_MSG_BYTE_START_TRANSFER:
+#if U8G2_BUFFER_MODE == 0
+    {
+        uint32_t tickstart = HAL_GetTick();
+        while (panels[0].flush.phase != FLUSH_IDLE)
+        {
+            if ((HAL_GetTick() - tickstart) > U8G2_I2C_TIMEOUT_MS)
+            {
+                return 0;
+            }
+        }
+    }
+#endif
+        u8x8_gpio_SetCS(u8x8, u8x8->display_info->chip_enable_level);
+        u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_DELAY_NANO, u8x8->display_info->post_chip_enable_wait_ns, NULL);
         break;
-    case U8X8_MSG_GPIO_RESET:
-        // 如果你的OLED有RESET引脚并且你连接了它
-        // HAL_GPIO_WritePin(OLED_RES_GPIO_Port, OLED_RES_Pin, arg_int);
+    case U8X8_MSG_BYTE_END_TRANSFER:
+        u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_DELAY_NANO, u8x8->display_info->pre_chip_disable_wait_ns, NULL);
+        u8x8_gpio_SetCS(u8x8, u8x8->display_info->chip_disable_level);
         break;
     default:
         return 0;
@@ -126,26 +380,1599 @@ uint8_t u8x8_stm32_gpio_and_delay(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
     return 1;
 }
 
+#endif /* U8G2_TRANSPORT == U8G2_TRANSPORT_SPI */
+
+#if U8G2_BUFFER_MODE == 0
+
 /**
- * @brief 初始化U8g2显示对象
- * @details 此函数执行U8g2的完整初始化流程：
- *          1. 调用 `u8g2_Setup_ssd1306_i2c_128x64_noname_f` 设置显示驱动和回调。
- *          2. 设置显示器的I2C地址。
- *          3. 调用 `u8g2_InitDisplay` 初始化显示控制器。
- *          4. 调用 `u8g2_SetPowerSave(0)` 唤醒显示器。
- *          5. 清空屏幕缓冲区并发送到屏幕。
- * @param[out] u8g2 指向待初始化的U8g2显示对象的指针
+ * @brief 异步刷新整帧显存
+ * @details 将 u8g2 绘图缓冲区与上一次发送的影子副本逐页比较, 只把每页中变化的列区间
+ *          拷贝到发送缓冲区, 然后立即返回。之后由总线完成回调按页 (列地址命令 + 变化的数据)
+ *          链式提交事务, 没有变化的页直接跳过, 期间调用者可以继续绘制下一帧。
+ *          若上一帧尚未发完, 本帧记为待发送并返回 HAL_BUSY, 由 u8g2_stm32_Service 在
+ *          上一帧结束后补发, 调用者不需要等待。若整帧都没有变化, 不产生任何总线传输。
+ *          变化的字节加上每页的事务开销不少于整帧时 (影子副本失效或几乎整屏变化),
+ *          改为水平寻址模式: 一次设置列/页窗口后, 以单个 0x40 控制字节在一次事务中
+ *          直接从发送缓冲区送出 1024 字节, 不再逐页提交。
+ *          SPI 接口下不做脏区比较, 有变化时总是整帧经 DMA 发送 (18MHz 下约 0.5ms)。
+ *          U8G2_DIRTY_CRC 为 1 时改为比较每段的 CRC, 变化区间按段对齐, 数据直接从绘图缓冲区发送,
+ *          发完之前不能绘制下一帧 (见 u8g2_stm32_DrawBegin)。
+ *          仅适用于 128x64 的 SSD1306 (列偏移为0)。
+ * @param[in] u8g2 指向U8g2显示对象的指针
+ * @return HAL_StatusTypeDef
+ *         - @retval HAL_OK 刷新已启动
+ *         - @retval HAL_BUSY 上一帧仍在发送, 本帧稍后补发
+ *         - @retval HAL_ERROR 提交总线事务失败
+ */
+HAL_StatusTypeDef u8g2_stm32_SendBufferAsync(u8g2_t *u8g2)
+{
+    Panel_t *p = u8g2_stm32_panel(u8g2);
+    bool primary = (p == &panels[0]);
+
+    if (p == NULL)
+    {
+        return HAL_ERROR;
+    }
+#if U8G2_DIRTY_CRC
+    if (primary)
+    {
+        draw_open = false; // 缓冲区中是完整的一帧
+    }
+#endif
+    if (p->flush.phase != FLUSH_IDLE)
+    {
+        p->flush.pending = true;
+        return HAL_BUSY;
+    }
+    p->flush.pending = false;
+
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+    (void)primary;
+    capture_line = p->start_line_next;
+    return u8g2_stm32_spi_flush(u8g2);
+#else
+    PROF_BEGIN(PROF_SEC_DISP_DIFF);
+    const uint8_t *src = u8g2_GetBufferPtr(u8g2);
+    uint16_t cost = 0;
+    p->flush.profile = p->profile_next;
+    p->flush.shift = p->shift_next;
+    for (uint8_t page = 0; page < U8G2_FRAME_PAGES; page++)
+    {
+        uint8_t width = 0;
+        if (u8g2_stm32_page_scanned(p->flush.profile, page))
+        {
+            width = u8g2_stm32_diff_page(p, src, page);
+        }
+        else
+        {
+            p->flush.dirty_x0[page] = 0; // 不扫描的页不发送, 影子副本仍与控制器的显存一致
+            p->flush.dirty_x1[page] = 0;
+        }
+        if (width > 0)
+        {
+            cost += width + FLUSH_TXN_OVERHEAD;
+            if (primary)
+            {
+                u8g2_stm32_capture_mark(page, p->flush.dirty_x0[page], p->flush.dirty_x1[page]);
+            }
+        }
+    }
+    p->flush.full = !p->paged && p->flush.profile == U8G2_PROFILE_FULL && (cost >= U8G2_FRAME_BUF_SIZE + FLUSH_TXN_OVERHEAD);
+    p->shadow_valid = p->shadow_valid || p->flush.profile == U8G2_PROFILE_FULL; // 只发送了部分页时其余页仍未知
+    p->flush.start_line = (p->flush.profile == U8G2_PROFILE_BAND) ? U8G2_BAND_FIRST_PAGE * 8 : p->start_line_next;
+    PROF_END(PROF_SEC_DISP_DIFF);
+
+    p->flush.i2c_address = u8x8_GetI2CAddress(u8g2_GetU8x8(u8g2));
+    p->flush.page = 0;
+    p->flush.phase = FLUSH_CMD;
+    if (primary)
+    {
+        capture_line = p->start_line_next;
+        PROF_BEGIN(PROF_SEC_DISP_TX);
+        TRACE(TRACE_EV_DISP_BEGIN, 0);
+        u8g2_stm32_frame_start();
+    }
+    return (u8g2_stm32_flush_next(p) == HAL_OK) ? HAL_OK : HAL_ERROR;
+#endif
+}
+
+/**
+ * @brief 补发刷新期间被推迟的帧, 需在主循环中调用
+ * @details 只在主循环中读取绘图缓冲区, 保证补发的是一帧完整的画面。
+ * @param[in] u8g2 指向U8g2显示对象的指针
  * @return 无
  */
-void u8g2Init(u8g2_t *u8g2)
+void u8g2_stm32_Service(u8g2_t *u8g2)
 {
-    HAL_Delay(150);                                                                                           // 确保显示器上电稳定
-    u8g2_Setup_ssd1306_i2c_128x64_noname_f(u8g2, U8G2_R0, u8x8_byte_stm32_hw_i2c, u8x8_stm32_gpio_and_delay); // 初始化 u8g2 结构体
-    u8g2_SetI2CAddress(u8g2, 0x78);                                                                           // 设置I2C地址
-    u8g2_InitDisplay(u8g2);                                                                                   // 根据所选的芯片进行初始化工作，初始化完成后，显示器处于关闭状态
-    u8g2_SetPowerSave(u8g2, 0);                                                                               // 打开显示器
+    Panel_t *p = u8g2_stm32_panel(u8g2);
+
+    if (p != NULL && p->flush.pending && p->flush.phase == FLUSH_IDLE)
+    {
+        u8g2_stm32_SendBufferAsync(u8g2);
+    }
+}
+
+/**
+ * @brief 使影子副本失效, 下一次刷新将整帧发送
+ * @details 显示器重新初始化或显存内容被其他途径改写后调用。起始行、寻址模式和驱动配置同样视为未知, 随下一帧重新发送。
+ * @return 无
+ */
+void u8g2_stm32_InvalidateShadow(void)
+{
+    Panel_t *p = &panels[0];
+
+    p->shadow_valid = false;
+    p->start_line_shown = START_LINE_UNKNOWN;
+    p->addr_mode_shown = ADDR_MODE_UNKNOWN;
+    p->profile_shown = PROFILE_UNKNOWN;
+}
+
+/**
+ * @brief 设置下一帧的显示起始行
+ * @details SSD1306 从显存的第 line 行开始扫描, 屏幕第 r 行显示显存第 (r + line) % 64 行。
+ *          起始行在该帧的显存数据全部发完后才发送 (与原来相同时不发送), 屏幕上的滚动与显存更新同步。
+ *          之后的每一帧都沿用该值, 直到再次设置。
+ * @param[in] line 起始行 (0-63)
+ * @return 无
+ */
+void u8g2_stm32_SetStartLine(uint8_t line)
+{
+    panels[0].start_line_next = line & 0x3F;
+}
+
+/**
+ * @brief 设置主显示器下一帧的驱动配置
+ * @details 复用率为 N 时控制器只扫描第 0~N-1 显示行, 显示偏移 D 把第0显示行放到 COM D,
+ *          起始行 S 使第0显示行显示显存第 S 行。BAND 取 S = 扫描范围的首行、D = S + shift,
+ *          显存第 y 行因此出现在屏幕第 y + shift 行, 范围之外的行不被驱动。
+ *          BAND 期间起始行固定为扫描范围的首行, u8g2_stm32_SetStartLine 的值在切回 FULL 后恢复。
+ * @param[in] profile 驱动配置
+ * @param[in] shift 纵向偏移 (行)
+ * @return HAL_StatusTypeDef 已记下返回 HAL_OK, 参数无效返回 HAL_ERROR
+ */
+HAL_StatusTypeDef u8g2_stm32_SetProfile(U8g2_Profile_e profile, int8_t shift)
+{
+    int16_t top = U8G2_BAND_FIRST_PAGE * 8 + shift;
+
+    if ((unsigned)profile >= U8G2_PROFILE_COUNT)
+    {
+        return HAL_ERROR;
+    }
+    if (profile == U8G2_PROFILE_FULL)
+    {
+        shift = 0;
+    }
+    else if (top < 0 || top + U8G2_BAND_PAGES * 8 > U8G2_FRAME_PAGES * 8)
+    {
+        return HAL_ERROR;
+    }
+    panels[0].profile_next = (uint8_t)profile;
+    panels[0].shift_next = shift;
+    return HAL_OK;
+}
+
+/**
+ * @brief 查询整帧异步刷新是否仍在进行
+ * @return bool 正在刷新或有待补发的帧时返回 true
+ */
+bool u8g2_stm32_IsFlushBusy(void)
+{
+    return panels[0].flush.phase != FLUSH_IDLE || panels[0].flush.pending;
+}
+
+/**
+ * @brief 阻塞等待整帧异步刷新完成
+ * @param[in] timeout 超时时间 (ms)
+ * @return HAL_StatusTypeDef 完成返回 HAL_OK, 超时返回 HAL_TIMEOUT
+ */
+HAL_StatusTypeDef u8g2_stm32_WaitFlush(uint32_t timeout)
+{
+    uint32_t tickstart = HAL_GetTick();
+
+    while (u8g2_stm32_IsFlushBusy())
+    {
+        if ((HAL_GetTick() - tickstart) > timeout)
+        {
+            return HAL_TIMEOUT;
+        }
+        u8g2_stm32_Service(&u8g2);
+        I2C_Bus_Service();
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief 开始修改主显示器的绘图缓冲区之前调用
+ * @details U8G2_DIRTY_CRC 为 1 时总线 (或 SPI 的 DMA) 直接从绘图缓冲区读取数据, 先等待上一帧
+ *          (含待补发的帧) 发完。页面管理器只在刷新空闲时绘制新的一帧, 通常不需要等待; 提前绘制
+ *          和切换动画的准备可能等待不超过一帧的发送时间。等待超时时影子副本失效, 下一帧整帧重发。
+ *          之后到下一次 u8g2_stm32_SendBufferAsync() 之前画面捕获暂停, 不会取走画了一半的画面。
+ *          U8G2_DIRTY_CRC 为 0 时刷新从影子副本发送, 为空操作。
+ * @return 无
+ */
+void u8g2_stm32_DrawBegin(void)
+{
+#if U8G2_DIRTY_CRC
+    if (u8g2_stm32_WaitFlush(U8G2_I2C_TIMEOUT_MS) != HAL_OK)
+    {
+        panels[0].shadow_valid = false;
+    }
+    draw_open = true;
+#endif
+}
+
+/**
+ * @brief 把一页的变化区间并入画面捕获的待取区间
+ * @param[in] page 页号 (0-7)
+ * @param[in] x0 变化区间起点
+ * @param[in] x1 变化区间终点 (不含)
+ * @return 无
+ */
+static void u8g2_stm32_capture_mark(uint8_t page, uint8_t x0, uint8_t x1)
+{
+    if (!capture_on || x0 >= x1)
+    {
+        return;
+    }
+    if (capture_x0[page] >= capture_x1[page])
+    {
+        capture_x0[page] = x0;
+        capture_x1[page] = x1;
+        return;
+    }
+    if (x0 < capture_x0[page])
+    {
+        capture_x0[page] = x0;
+    }
+    if (x1 > capture_x1[page])
+    {
+        capture_x1[page] = x1;
+    }
+}
+
+/**
+ * @brief 开启或关闭画面捕获
+ * @details 开启后每次刷新都把各页变化的列区间 (与脏区比较的结果相同) 并入待取区间,
+ *          多帧之间的变化合并为一个区间, 取走之前不会丢失。开启时 (包括已经开启时再次调用)
+ *          把所有页整页标记为待取, 使读取方得到一帧完整的画面。
+ * @param[in] on 开启为 true
+ * @return 无
+ */
+void u8g2_stm32_CaptureEnable(bool on)
+{
+    capture_on = on;
+    for (uint8_t page = 0; page < U8G2_FRAME_PAGES; page++)
+    {
+        capture_x0[page] = 0;
+        capture_x1[page] = on ? U8G2_FRAME_PAGE_WIDTH : 0;
+    }
+}
+
+/**
+ * @brief 取得下一个待取的变化区间
+ * @details 只查询, 不清除。区间中的数据从 u8g2_stm32_GetShadow() 的影子副本中读取,
+ *          处理完后调用 u8g2_stm32_CaptureDone() 清除; 两者之间不能刷新 (都在主循环中调用即可)。
+ * @param[out] page 页号
+ * @param[out] x0 区间起点
+ * @param[out] x1 区间终点 (不含)
+ * @return bool 有待取区间返回 true
+ */
+bool u8g2_stm32_CaptureNext(uint8_t *page, uint8_t *x0, uint8_t *x1)
+{
+#if U8G2_DIRTY_CRC
+    if (draw_open)
+    {
+        return false; // 读取的是绘图缓冲区, 等这一帧画完
+    }
+#endif
+    for (uint8_t p = 0; p < U8G2_FRAME_PAGES; p++)
+    {
+        if (capture_x0[p] < capture_x1[p])
+        {
+            *page = p;
+            *x0 = capture_x0[p];
+            *x1 = capture_x1[p];
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 清除一页的待取区间
+ * @param[in] page 页号 (0-7)
+ * @return 无
+ */
+void u8g2_stm32_CaptureDone(uint8_t page)
+{
+    capture_x0[page] = 0;
+    capture_x1[page] = 0;
+}
+
+/**
+ * @brief 读取屏幕当前内容的影子副本
+ * @details 影子副本即最近一次刷新的帧 (按 u8g2 的页格式, 每页 128 字节, 字节的低位在上)。
+ *          SPI 接口下同时是 DMA 的发送缓冲区, 只能读取。
+ *          U8G2_DIRTY_CRC 为 1 时没有影子副本, 返回主显示器的绘图缓冲区: 画面捕获有待取区间时
+ *          (不在绘制中) 其内容即最近一次提交的帧。
+ * @param[out] start_line 该帧的显示起始行, 可为 NULL
+ * @return const uint8_t* 影子副本 (U8G2_FRAME_BUF_SIZE 字节)
+ */
+const uint8_t *u8g2_stm32_GetShadow(uint8_t *start_line)
+{
+    if (start_line != NULL)
+    {
+        *start_line = capture_line;
+    }
+    return PANEL_TX_BUF(&panels[0]);
+}
+
+/**
+ * @brief 查找 u8g2 实例登记的显示器
+ * @param[in] u8g2 指向U8g2显示对象的指针
+ * @return Panel_t* 显示器, 未登记返回 NULL
+ */
+static Panel_t *u8g2_stm32_panel(u8g2_t *u8g2)
+{
+    for (uint8_t i = 0; i < U8G2_PANEL_COUNT; i++)
+    {
+        if (panels[i].u8g2 == u8g2)
+        {
+            return &panels[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 某页在给定的驱动配置下是否被扫描
+ * @param[in] profile 驱动配置 (U8g2_Profile_e)
+ * @param[in] page 页号 (0-7)
+ * @return bool 被扫描 (须比较和发送) 时返回 true
+ */
+static bool u8g2_stm32_page_scanned(uint8_t profile, uint8_t page)
+{
+    return profile != U8G2_PROFILE_BAND ||
+           (page >= U8G2_BAND_FIRST_PAGE && page < U8G2_BAND_FIRST_PAGE + U8G2_BAND_PAGES);
+}
+
+/**
+ * @brief 组装一帧显存数据之后的命令: 改变了的驱动配置和起始行
+ * @param[in,out] p 显示器, 命令写入 p->flush.cmd
+ * @return uint8_t 命令的字节数, 0 表示不需要发送
+ */
+static uint8_t u8g2_stm32_end_cmds(Panel_t *p)
+{
+    uint8_t n = 0;
+
+    if (p->flush.profile != p->profile_shown || p->flush.shift != p->shift_shown)
+    {
+        bool band = (p->flush.profile == U8G2_PROFILE_BAND);
+        p->flush.cmd[n++] = SSD1306_MUX_RATIO;
+        p->flush.cmd[n++] = band ? U8G2_BAND_PAGES * 8 - 1 : U8G2_FRAME_PAGES * 8 - 1;
+        p->flush.cmd[n++] = SSD1306_DISP_OFFSET;
+        p->flush.cmd[n++] = band ? (uint8_t)((U8G2_BAND_FIRST_PAGE * 8 + p->flush.shift) & 0x3F) : 0;
+        p->flush.cmd[n++] = SSD1306_PRECHARGE;
+        p->flush.cmd[n++] = band ? U8G2_BAND_PRECHARGE : FULL_PRECHARGE;
+        p->flush.cmd[n++] = SSD1306_VCOMH;
+        p->flush.cmd[n++] = band ? U8G2_BAND_VCOMH : FULL_VCOMH;
+    }
+    if (p->flush.start_line != p->start_line_shown)
+    {
+        p->flush.cmd[n++] = SSD1306_START_LINE | p->flush.start_line;
+    }
+    return n;
+}
+
+/**
+ * @brief 初始化并登记一个副显示器
+ * @details 流程与 u8g2Init 相同 (设置驱动、地址、速率校准、初始化控制器、清屏), 区别在于:
+ *          - 绘图缓冲区换成本文件中的 panel_draw_buf, 不与主显示器共用;
+ *          - 刷新总是按页提交 (不使用 1024 字节的整帧事务), 优先级为 I2C_BUS_PRIO_PANEL,
+ *            主显示器的帧和传感器/RTC 的事务可以插在它的两页之间;
+ *          - 不参与画面捕获、刷新时间统计和完成回调。
+ *          初始清屏没有得到应答时注销该显示器, 之后对它的刷新直接返回 HAL_ERROR。
+ *          U8G2_PANEL_COUNT 为 1 时总是返回 HAL_ERROR。
+ * @param[out] u8g2 副显示器的 u8g2 实例
+ * @param[in] i2c_address 8位I2C地址
+ * @return HAL_StatusTypeDef
+ *         - @retval HAL_OK 初始化完成
+ *         - @retval HAL_ERROR 没有空位或显示器无应答
+ *         - @retval HAL_TIMEOUT 初始清屏没有在 U8G2_I2C_TIMEOUT_MS 内完成
+ */
+HAL_StatusTypeDef u8g2_stm32_PanelInit(u8g2_t *u8g2, uint8_t i2c_address)
+{
+#if U8G2_PANEL_COUNT > 1
+    Panel_t *p = NULL;
+    uint8_t i;
+
+    for (i = 1; i < U8G2_PANEL_COUNT; i++)
+    {
+        if (panels[i].u8g2 == NULL || panels[i].u8g2 == u8g2)
+        {
+            p = &panels[i];
+            break;
+        }
+    }
+    if (p == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    u8g2_Setup_ssd1306_i2c_128x64_noname_f(u8g2, U8G2_R0, u8x8_byte_stm32_hw_i2c, u8x8_stm32_gpio_and_delay);
+    u8g2->tile_buf_ptr = panel_draw_buf[i - 1];
+    u8g2_stm32_SetBitband(u8g2, U8G2_BITBAND != 0);
+    u8g2_SetI2CAddress(u8g2, i2c_address);
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_I2C2
+    I2C_Bus_Attach(&hi2c2, i2c_address); // 与主显示器在同一条总线上
+#endif
+    memset(p, 0, sizeof(*p));
+    p->u8g2 = u8g2;
+    p->paged = true;
+    p->prio = I2C_BUS_PRIO_PANEL;
+    u8g2_stm32_CalibrateSpeed(u8g2);
+
+    u8g2_stm32_init_controller(u8g2, I2C_BUS_PRIO_PANEL);
     u8g2_ClearBuffer(u8g2);
+    u8g2_stm32_PanelInvalidate(u8g2);
+    u8g2_stm32_SendBufferAsync(u8g2);
+
+    uint32_t tickstart = HAL_GetTick();
+    while (u8g2_stm32_PanelIsBusy(u8g2))
+    {
+        if ((HAL_GetTick() - tickstart) > U8G2_I2C_TIMEOUT_MS)
+        {
+            return HAL_TIMEOUT;
+        }
+        I2C_Bus_Service();
+    }
+    if (!p->shadow_valid)
+    {
+        p->u8g2 = NULL; // 清屏失败 (无应答), 注销
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+#else
+    (void)u8g2;
+    (void)i2c_address;
+    return HAL_ERROR;
+#endif
+}
+
+/**
+ * @brief 查询某个显示器的刷新是否仍在进行
+ * @param[in] u8g2 显示器的 u8g2 实例
+ * @return bool 正在刷新或有待补发的帧时返回 true
+ */
+bool u8g2_stm32_PanelIsBusy(u8g2_t *u8g2)
+{
+    Panel_t *p = u8g2_stm32_panel(u8g2);
+
+    return p != NULL && (p->flush.phase != FLUSH_IDLE || p->flush.pending);
+}
+
+/**
+ * @brief 使某个显示器的影子副本失效, 下一次刷新将整帧发送
+ * @param[in] u8g2 显示器的 u8g2 实例
+ * @return 无
+ */
+void u8g2_stm32_PanelInvalidate(u8g2_t *u8g2)
+{
+    Panel_t *p = u8g2_stm32_panel(u8g2);
+
+    if (p != NULL)
+    {
+        p->shadow_valid = false;
+        p->start_line_shown = START_LINE_UNKNOWN;
+        p->addr_mode_shown = ADDR_MODE_UNKNOWN;
+        p->profile_shown = PROFILE_UNKNOWN;
+    }
+}
+
+#else
+
+/**
+ * @brief 阻塞发送当前条带 (分页模式)
+ * @details 经字节回调逐块提交到总线队列。返回时最后一块可能仍在队列中, 但数据已拷贝到
+ *          字节回调的缓冲区, 调用者可以立即清空绘图缓冲区绘制下一个条带。
+ *          分页模式没有影子副本, 条带总是整条发送。
+ * @param[in] u8g2 指向U8g2显示对象的指针
+ * @param[in] last 是否为本帧最后一个条带
+ * @return 无
+ */
+void u8g2_stm32_SendStrip(u8g2_t *u8g2, bool last)
+{
+    if (!strip_frame_started)
+    {
+        strip_frame_started = true;
+        u8g2_stm32_frame_start();
+    }
     u8g2_SendBuffer(u8g2);
+    if (last)
+    {
+        strip_frame_started = false;
+        u8g2_stm32_frame_done();
+    }
+}
+
+/**
+ * @brief 设置驱动配置 (分页模式不支持)
+ * @param[in] profile 未使用
+ * @param[in] shift 未使用
+ * @return HAL_StatusTypeDef 总是返回 HAL_ERROR
+ */
+HAL_StatusTypeDef u8g2_stm32_SetProfile(U8g2_Profile_e profile, int8_t shift)
+{
+    (void)profile;
+    (void)shift;
+    return HAL_ERROR;
+}
+
+#endif /* U8G2_BUFFER_MODE == 0 */
+
+#if U8G2_BITBAND
+/**
+ * @brief 位带方式的水平/垂直线 (u8g2 的 ll_hvline 回调)
+ * @details 显存为纵向字节、低位在上，坐标已由 u8g2 裁剪并换算到当前缓冲区内，len 不为0。
+ *          水平线的每个像素在相邻字节的同一位上，在别名区相隔 8 个字，颜色为 0/1 时逐个写入别名字
+ *          (读改写由总线完成)；颜色为 2 (异或) 时位带省不掉读取，逐字节异或一次。
+ *          垂直线按字节处理：覆盖整个字节时直接写入，只有一个像素时写别名字，其余按掩码读改写一次。
+ * @param[in] u8g2 指向U8g2显示对象的指针
+ * @param[in] x 起点列
+ * @param[in] y 起点行 (相对于当前缓冲区)
+ * @param[in] len 像素数
+ * @param[in] dir 0 为水平，1 为垂直
+ * @return 无
+ */
+static void u8g2_stm32_ll_hvline_bitband(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len, uint8_t dir)
+{
+    uint8_t *ptr = u8g2->tile_buf_ptr + (uint16_t)(y >> 3) * u8g2->pixel_buf_width + x;
+    uint8_t bit = (uint8_t)(y & 7U);
+    uint8_t color = u8g2->draw_color;
+
+    if (dir == 0)
+    {
+        if (color > 1)
+        {
+            uint8_t mask = (uint8_t)(1U << bit);
+            do
+            {
+                *ptr++ ^= mask;
+            } while (--len != 0);
+            return;
+        }
+        volatile uint32_t *alias = BITBAND_ALIAS(ptr, bit);
+        do
+        {
+            *alias = color;
+            alias += 8;
+        } while (--len != 0);
+        return;
+    }
+
+    while (len != 0)
+    {
+        uint8_t n = (uint8_t)(8U - bit); // 本字节中属于这条线的像素数
+        if (n > len)
+        {
+            n = (uint8_t)len;
+        }
+        uint8_t mask = (uint8_t)((0xFFU >> (8U - n)) << bit);
+        if (color > 1)
+        {
+            *ptr ^= mask;
+        }
+        else if (n == 8)
+        {
+            *ptr = color ? 0xFF : 0x00;
+        }
+        else if (n == 1)
+        {
+            *BITBAND_ALIAS(ptr, bit) = color;
+        }
+        else if (color)
+        {
+            *ptr |= mask;
+        }
+        else
+        {
+            *ptr &= (uint8_t)~mask;
+        }
+        len -= n;
+        ptr += u8g2->pixel_buf_width;
+        bit = 0;
+    }
+}
+#endif /* U8G2_BITBAND */
+
+/**
+ * @brief 选择绘图缓冲区的像素写入方式
+ * @param[in,out] u8g2 指向U8g2显示对象的指针
+ * @param[in] on 为 true 时使用位带实现
+ * @return 无
+ */
+void u8g2_stm32_SetBitband(u8g2_t *u8g2, bool on)
+{
+#if U8G2_BITBAND
+    u8g2->ll_hvline = on ? u8g2_stm32_ll_hvline_bitband : u8g2_ll_hvline_vertical_top_lsb;
+#else
+    (void)on;
+    u8g2->ll_hvline = u8g2_ll_hvline_vertical_top_lsb;
+#endif
+}
+
+/**
+ * @brief 查询最近几帧的平均刷新时间
+ * @details 从一帧开始发送到最后一页 (条带) 发送完成, 按 3/4 旧值 + 1/4 新值做滑动平均。
+ *          页面管理器据此选择帧周期, 避免绘制总线来不及发送的画面。
+ * @return uint32_t 平均刷新时间 (ms, 向上取整)
+ */
+uint32_t u8g2_stm32_GetFrameTime(void)
+{
+    return (u8g2_stm32_GetFrameTimeUs() + 999U) / 1000U;
+}
+
+/**
+ * @brief 查询最近几帧的平均刷新时间 (微秒)
+ * @details 用 DWT 周期计数器计时, 不受系统滴答 1ms 分辨率的限制, 可以区分 400kHz 下 ~25ms
+ *          的整帧刷新和只发送少量脏列的几毫秒刷新。
+ * @return uint32_t 平均刷新时间 (us)
+ */
+uint32_t u8g2_stm32_GetFrameTimeUs(void)
+{
+    return frame_time_x4 / 4;
+}
+
+/**
+ * @brief 为主显示器的下一帧附上输入事件的时间戳
+ * @param[in] ms 输入事件的时间戳
+ * @return 无
+ */
+void u8g2_stm32_SetInputStamp(uint32_t ms)
+{
+    if (!input_stamp_pending)
+    {
+        input_stamp_next = ms;
+        input_stamp_pending = true;
+    }
+}
+
+/**
+ * @brief 一帧开始发送, 记录起始时刻
+ * @details DWT 周期计数器可能还没有被性能分析或跟踪模块启动, 这里确保它在运行。
+ *          附带的输入时间戳随帧保存; 上一帧因总线错误没有发完时它的时间戳留给这一帧。
+ * @return 无
+ */
+static void u8g2_stm32_frame_start(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    frame_start_cyc = DWT->CYCCNT;
+    if (input_stamp_pending && !input_stamp_sending)
+    {
+        input_stamp_frame = input_stamp_next;
+        input_stamp_sending = true;
+    }
+    input_stamp_pending = false;
+    MARK_BEGIN(FLUSH);
+}
+
+/**
+ * @brief 一帧发送完成, 更新刷新时间统计和输入延迟并调用完成回调
+ * @return 无
+ */
+static void u8g2_stm32_frame_done(void)
+{
+    uint32_t us = (DWT->CYCCNT - frame_start_cyc) / (SystemCoreClock / 1000000U);
+
+    MARK_END(FLUSH);
+    frame_time_x4 = frame_time_x4 - frame_time_x4 / 4 + us;
+    PROF_COUNT(PROF_CNT_FRAME);
+    if (input_stamp_sending)
+    {
+        input_stamp_sending = false;
+        Profiler_Record_Input(HAL_GetTick() - input_stamp_frame);
+    }
+    u8g2_stm32_FlushCpltCallback();
+}
+
+/**
+ * @brief 整帧刷新完成回调
+ * @details 整帧模式下通常在 I2C 中断上下文中调用 (整帧无变化时在调用者上下文中调用),
+ *          分页模式下在发送最后一个条带的调用者上下文中调用。
+ *          默认为空实现, 应用层可重新定义。
+ * @return 无
+ */
+__weak void u8g2_stm32_FlushCpltCallback(void)
+{
+}
+
+/**
+ * @brief 以显示优先级提交一个总线事务, 队列满时短暂等待
+ * @param[in] txn 事务描述
+ * @return HAL_StatusTypeDef 提交结果
+ */
+static HAL_StatusTypeDef u8g2_stm32_submit(const I2C_Bus_Txn_t *txn)
+{
+    uint32_t tickstart = HAL_GetTick();
+    HAL_StatusTypeDef status;
+
+    while ((status = I2C_Bus_Submit(txn, I2C_BUS_PRIO_DISPLAY)) == HAL_BUSY)
+    {
+        if ((HAL_GetTick() - tickstart) > U8G2_I2C_TIMEOUT_MS)
+        {
+            return HAL_TIMEOUT;
+        }
+        I2C_Bus_Service();
+    }
+    return status;
+}
+
+/**
+ * @brief 字节回调缓冲区的传输完成回调
+ * @param[in] status 事务结果 (未使用, u8x8 无法处理异步错误)
+ * @param[in] ctx 指向该缓冲区忙碌标志的指针
+ * @return 无
+ */
+static void u8g2_stm32_chunk_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)status;
+    *(volatile bool *)ctx = false;
+}
+
+#if U8G2_BUFFER_MODE == 0 && U8G2_DIRTY_CRC
+
+typedef char u8g2_crc_seg_check[(U8G2_CRC_SEG_WIDTH % 4 == 0 && U8G2_CRC_SEG_WIDTH * U8G2_CRC_SEGS == U8G2_FRAME_PAGE_WIDTH) ? 1 : -1];
+
+/**
+ * @brief 计算一页中每段的 CRC, 与屏幕上的内容比较, 记录变化区间并更新保存的 CRC
+ * @details 变化区间从第一个变化的段的起点到最后一个变化的段的终点。CRC 单元按字读取,
+ *          绘图缓冲区不是4字节对齐时每段先拷贝到栈上。CRC 无效时整页视为变化。
+ * @param[in,out] p 显示器
+ * @param[in] src u8g2 绘图缓冲区
+ * @param[in] page 页号 (0-7)
+ * @return uint8_t 变化区间的宽度 (列数), 0 表示该页无变化
+ */
+static uint8_t u8g2_stm32_crc_page(Panel_t *p, const uint8_t *src, uint8_t page)
+{
+    const uint8_t *row = &src[page * U8G2_FRAME_PAGE_WIDTH];
+    bool aligned = ((uintptr_t)row & 3U) == 0;
+    uint32_t seg[U8G2_CRC_SEG_WIDTH / 4];
+    uint8_t first = U8G2_CRC_SEGS;
+    uint8_t last = 0;
+
+    for (uint8_t i = 0; i < U8G2_CRC_SEGS; i++)
+    {
+        const uint32_t *words = (const uint32_t *)(const void *)&row[i * U8G2_CRC_SEG_WIDTH];
+        uint32_t crc;
+
+        if (!aligned)
+        {
+            memcpy(seg, &row[i * U8G2_CRC_SEG_WIDTH], U8G2_CRC_SEG_WIDTH);
+            words = seg;
+        }
+        crc = HW_CRC32(words, U8G2_CRC_SEG_WIDTH / 4);
+        if (!p->shadow_valid || crc != p->seg_crc[page][i])
+        {
+            p->seg_crc[page][i] = crc;
+            if (first == U8G2_CRC_SEGS)
+            {
+                first = i;
+            }
+            last = i + 1;
+        }
+    }
+
+    if (first == U8G2_CRC_SEGS)
+    {
+        first = 0;
+    }
+    p->flush.dirty_x0[page] = first * U8G2_CRC_SEG_WIDTH;
+    p->flush.dirty_x1[page] = last * U8G2_CRC_SEG_WIDTH;
+    return (last - first) * U8G2_CRC_SEG_WIDTH;
+}
+
+#endif /* U8G2_BUFFER_MODE == 0 && U8G2_DIRTY_CRC */
+
+#if U8G2_BUFFER_MODE == 0 && U8G2_TRANSPORT != U8G2_TRANSPORT_SPI
+
+/**
+ * @brief 比较一页的绘图缓冲区与影子副本, 记录变化区间并更新影子副本 (U8G2_DIRTY_CRC 时比较 CRC)
+ * @param[in,out] p 显示器
+ * @param[in] src u8g2 绘图缓冲区
+ * @param[in] page 页号 (0-7)
+ * @return uint8_t 变化区间的宽度 (列数), 0 表示该页无变化
+ */
+static uint8_t u8g2_stm32_diff_page(Panel_t *p, const uint8_t *src, uint8_t page)
+{
+#if U8G2_DIRTY_CRC
+    return u8g2_stm32_crc_page(p, src, page);
+#else
+    const uint8_t *new_row = &src[page * U8G2_FRAME_PAGE_WIDTH];
+    uint8_t *old_row = &p->frame_tx_buf[page * U8G2_FRAME_PAGE_WIDTH];
+    uint8_t x0 = 0;
+    uint8_t x1 = U8G2_FRAME_PAGE_WIDTH;
+
+    if (p->shadow_valid)
+    {
+        while (x0 < U8G2_FRAME_PAGE_WIDTH && new_row[x0] == old_row[x0])
+        {
+            x0++;
+        }
+        while (x1 > x0 && new_row[x1 - 1] == old_row[x1 - 1])
+        {
+            x1--;
+        }
+    }
+
+    memcpy(&old_row[x0], &new_row[x0], x1 - x0);
+    p->flush.dirty_x0[page] = x0;
+    p->flush.dirty_x1[page] = x1;
+    return x1 - x0;
+#endif
+}
+
+/**
+ * @brief 推进整帧刷新状态机, 提交下一段总线事务
+ * @details 由 SendBufferAsync 和事务完成回调调用。发送命令前会跳过没有变化的页,
+ *          全部发完时调用完成回调。提交失败时放弃本帧。
+ *          整帧发送时只有一次窗口命令和一次 1024 字节的数据事务; 按页发送时每页一次页地址命令
+ *          和一次数据事务。两种方式所需的寻址模式与控制器当前不同时, 在地址命令前加上模式切换。
+ *          完成回调中提交的事务会被总线立即选中, 其他设备的事务只会插在两页之间。
+ *          各显示器的刷新互相独立, 以各自的优先级提交, 同一总线上的两个显示器的页交替发送。
+ * @param[in,out] p 显示器
+ * @return HAL_StatusTypeDef 提交失败返回对应错误码, 其余情况返回 HAL_OK
+ */
+static HAL_StatusTypeDef u8g2_stm32_flush_next(Panel_t *p)
+{
+    HAL_StatusTypeDef status;
+    uint8_t x0;
+    uint8_t n = 0;
+    I2C_Bus_Txn_t txn = {
+        .op = I2C_BUS_OP_MEM_WRITE,
+        .dev_addr = p->flush.i2c_address,
+        .mem_addr_size = I2C_MEMADD_SIZE_8BIT,
+        .cb = u8g2_stm32_flush_cb,
+        .ctx = p,
+    };
+
+    if (p->flush.phase == FLUSH_CMD)
+    {
+        while (!p->flush.full && p->flush.page < U8G2_FRAME_PAGES && p->flush.dirty_x0[p->flush.page] == p->flush.dirty_x1[p->flush.page])
+        {
+            p->flush.page++;
+        }
+        if (p->flush.page >= U8G2_FRAME_PAGES && (n = u8g2_stm32_end_cmds(p)) != 0)
+        {
+            p->flush.phase = FLUSH_LINE;
+            txn.mem_addr = SSD1306_CTRL_CMD;
+            txn.data = p->flush.cmd;
+            txn.size = n;
+            status = I2C_Bus_Submit(&txn, p->prio);
+            if (status != HAL_OK)
+            {
+                p->flush.phase = FLUSH_IDLE;
+                p->start_line_shown = START_LINE_UNKNOWN;
+                p->profile_shown = PROFILE_UNKNOWN;
+            }
+            return status;
+        }
+        if (p->flush.page >= U8G2_FRAME_PAGES)
+        {
+            p->flush.phase = FLUSH_IDLE;
+            if (p == &panels[0])
+            {
+                PROF_END(PROF_SEC_DISP_TX);
+                TRACE(TRACE_EV_DISP_END, 0);
+                u8g2_stm32_frame_done();
+            }
+            return HAL_OK;
+        }
+
+        if (p->flush.full)
+        {
+            if (p->addr_mode_shown != SSD1306_ADDR_HORIZ)
+            {
+                p->flush.cmd[n++] = SSD1306_ADDR_MODE;
+                p->flush.cmd[n++] = SSD1306_ADDR_HORIZ;
+            }
+            p->flush.cmd[n++] = SSD1306_COL_RANGE;  // 列窗口 0-127
+            p->flush.cmd[n++] = 0;
+            p->flush.cmd[n++] = U8G2_FRAME_PAGE_WIDTH - 1;
+            p->flush.cmd[n++] = SSD1306_PAGE_RANGE; // 页窗口 0-7, 同时把写指针复位到第0页第0列
+            p->flush.cmd[n++] = 0;
+            p->flush.cmd[n++] = U8G2_FRAME_PAGES - 1;
+        }
+        else
+        {
+            if (p->addr_mode_shown != SSD1306_ADDR_PAGE)
+            {
+                p->flush.cmd[n++] = SSD1306_ADDR_MODE;
+                p->flush.cmd[n++] = SSD1306_ADDR_PAGE;
+            }
+            x0 = p->flush.dirty_x0[p->flush.page];
+            p->flush.cmd[n++] = 0xB0 | p->flush.page;  // 页地址
+            p->flush.cmd[n++] = 0x00 | (x0 & 0x0F); // 列地址低4位
+            p->flush.cmd[n++] = 0x10 | (x0 >> 4);   // 列地址高4位
+        }
+        txn.mem_addr = SSD1306_CTRL_CMD;
+        txn.data = p->flush.cmd;
+        txn.size = n;
+    }
+    else if (p->flush.full)
+    {
+        txn.mem_addr = SSD1306_CTRL_DATA;
+        txn.data = PANEL_TX_BUF(p);
+        txn.size = U8G2_FRAME_BUF_SIZE;
+    }
+    else
+    {
+        x0 = p->flush.dirty_x0[p->flush.page];
+        txn.mem_addr = SSD1306_CTRL_DATA;
+        txn.data = &PANEL_TX_BUF(p)[p->flush.page * U8G2_FRAME_PAGE_WIDTH + x0];
+        txn.size = p->flush.dirty_x1[p->flush.page] - x0;
+    }
+
+    status = I2C_Bus_Submit(&txn, p->prio);
+    if (status != HAL_OK)
+    {
+        p->flush.phase = FLUSH_IDLE;
+        p->shadow_valid = false; // 屏幕内容已不可信, 下一帧整帧重发
+        p->addr_mode_shown = ADDR_MODE_UNKNOWN;
+    }
+    return status;
+}
+
+/**
+ * @brief 整帧刷新的事务完成回调 (地址命令、一页或整帧显存数据)
+ * @param[in] status 事务结果
+ * @param[in] ctx 所属显示器 (Panel_t)
+ * @return 无
+ */
+static void u8g2_stm32_flush_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    Panel_t *p = (Panel_t *)ctx;
+
+    if (status != HAL_OK)
+    {
+        // 放弃当前帧
+        p->flush.phase = FLUSH_IDLE;
+        p->shadow_valid = false;
+        p->start_line_shown = START_LINE_UNKNOWN;
+        p->addr_mode_shown = ADDR_MODE_UNKNOWN;
+        p->profile_shown = PROFILE_UNKNOWN;
+        return;
+    }
+
+    if (p->flush.phase == FLUSH_LINE)
+    {
+        // 驱动配置和起始行是一帧的最后一个事务
+        p->start_line_shown = p->flush.start_line;
+        p->profile_shown = p->flush.profile;
+        p->shift_shown = p->flush.shift;
+        p->flush.phase = FLUSH_CMD;
+    }
+    else if (p->flush.phase == FLUSH_CMD)
+    {
+        p->addr_mode_shown = p->flush.full ? SSD1306_ADDR_HORIZ : SSD1306_ADDR_PAGE;
+        p->flush.phase = FLUSH_DATA;
+    }
+    else
+    {
+        p->flush.page = p->flush.full ? U8G2_FRAME_PAGES : p->flush.page + 1;
+        p->flush.phase = FLUSH_CMD;
+    }
+    u8g2_stm32_flush_next(p);
+}
+
+#endif /* U8G2_BUFFER_MODE == 0 && U8G2_TRANSPORT != U8G2_TRANSPORT_SPI */
+
+#if U8G2_BUFFER_MODE == 0 && U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+
+/**
+ * @brief 以 SPI 发送一帧
+ * @details 绘图缓冲区与影子副本相同时只处理起始行。否则拷贝到发送缓冲区 (U8G2_DIRTY_CRC 时比较 CRC,
+ *          直接发送绘图缓冲区), 阻塞发送寻址模式和窗口命令
+ *          (不超过8字节), 再把 DC 置高, 以一次 DMA 传输发出 1024 字节后立即返回。
+ *          片选在整帧期间保持有效, 由 DMA 完成回调结束本帧。
+ * @param[in] u8g2 指向U8g2显示对象的指针
+ * @return HAL_StatusTypeDef
+ *         - @retval HAL_OK 发送已开始 (或无变化, 已完成)
+ *         - @retval HAL_ERROR 发送失败, 放弃本帧
+ */
+static HAL_StatusTypeDef u8g2_stm32_spi_flush(u8g2_t *u8g2)
+{
+    Panel_t *p = &panels[0];
+    const uint8_t *src = u8g2_GetBufferPtr(u8g2);
+    bool band = (p->profile_next == U8G2_PROFILE_BAND);
+    uint8_t first = band ? U8G2_BAND_FIRST_PAGE : 0;
+    uint8_t pages = band ? U8G2_BAND_PAGES : U8G2_FRAME_PAGES;
+    uint16_t offset = (uint16_t)first * U8G2_FRAME_PAGE_WIDTH;
+    uint16_t size = (uint16_t)pages * U8G2_FRAME_PAGE_WIDTH;
+    bool changed;
+    uint8_t n = 0;
+
+    // BAND 下只比较和发送扫描范围内的页, 其余页的影子副本仍与控制器的显存一致
+    PROF_BEGIN(PROF_SEC_DISP_DIFF);
+#if U8G2_DIRTY_CRC
+    changed = false;
+    for (uint8_t page = first; page < first + pages; page++)
+    {
+        changed = (u8g2_stm32_crc_page(p, src, page) > 0) || changed; // 每页都要更新 CRC
+    }
+#else
+    changed = !p->shadow_valid || memcmp(&p->frame_tx_buf[offset], &src[offset], size) != 0;
+#endif
+    if (changed)
+    {
+#if !U8G2_DIRTY_CRC
+        memcpy(&p->frame_tx_buf[offset], &src[offset], size);
+#endif
+        for (uint8_t page = first; page < first + pages; page++)
+        {
+            u8g2_stm32_capture_mark(page, 0, U8G2_FRAME_PAGE_WIDTH);
+        }
+    }
+    p->shadow_valid = p->shadow_valid || !band;
+    p->flush.profile = p->profile_next;
+    p->flush.shift = p->shift_next;
+    p->flush.start_line = band ? U8G2_BAND_FIRST_PAGE * 8 : p->start_line_next;
+    PROF_END(PROF_SEC_DISP_DIFF);
+
+    PROF_BEGIN(PROF_SEC_DISP_TX);
+    TRACE(TRACE_EV_DISP_BEGIN, 0);
+    u8g2_stm32_frame_start();
+    p->flush.phase = FLUSH_DATA;
+    HAL_GPIO_WritePin(U8G2_SPI_CS_GPIO_Port, U8G2_SPI_CS_Pin, GPIO_PIN_RESET);
+    if (!changed)
+    {
+        u8g2_stm32_spi_end_frame();
+        return HAL_OK;
+    }
+
+    if (p->addr_mode_shown != SSD1306_ADDR_HORIZ)
+    {
+        p->flush.cmd[n++] = SSD1306_ADDR_MODE;
+        p->flush.cmd[n++] = SSD1306_ADDR_HORIZ;
+    }
+    p->flush.cmd[n++] = SSD1306_COL_RANGE;
+    p->flush.cmd[n++] = 0;
+    p->flush.cmd[n++] = U8G2_FRAME_PAGE_WIDTH - 1;
+    p->flush.cmd[n++] = SSD1306_PAGE_RANGE;
+    p->flush.cmd[n++] = first;
+    p->flush.cmd[n++] = first + pages - 1;
+    HAL_GPIO_WritePin(U8G2_SPI_DC_GPIO_Port, U8G2_SPI_DC_Pin, GPIO_PIN_RESET);
+    if (HAL_SPI_Transmit(&hspi1, p->flush.cmd, n, U8G2_SPI_TIMEOUT_MS) != HAL_OK)
+    {
+        u8g2_stm32_spi_abort();
+        return HAL_ERROR;
+    }
+    p->addr_mode_shown = SSD1306_ADDR_HORIZ;
+
+    HAL_GPIO_WritePin(U8G2_SPI_DC_GPIO_Port, U8G2_SPI_DC_Pin, GPIO_PIN_SET);
+    if (HAL_SPI_Transmit_DMA(&hspi1, &PANEL_TX_BUF(p)[offset], size) != HAL_OK)
+    {
+        u8g2_stm32_spi_abort();
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief 结束一帧: 按需发送驱动配置和显示起始行, 释放片选并调用完成回调
+ * @details 与 I2C 相同, 两者在显存数据之后发送, 屏幕上的滚动与显存更新同步。
+ *          通常在 DMA 完成中断中调用, 命令最多9字节, 阻塞发送。
+ * @return 无
+ */
+static void u8g2_stm32_spi_end_frame(void)
+{
+    Panel_t *p = &panels[0];
+    uint8_t n = u8g2_stm32_end_cmds(p);
+
+    if (n != 0)
+    {
+        HAL_GPIO_WritePin(U8G2_SPI_DC_GPIO_Port, U8G2_SPI_DC_Pin, GPIO_PIN_RESET);
+        if (HAL_SPI_Transmit(&hspi1, p->flush.cmd, n, U8G2_SPI_TIMEOUT_MS) == HAL_OK)
+        {
+            p->start_line_shown = p->flush.start_line;
+            p->profile_shown = p->flush.profile;
+            p->shift_shown = p->flush.shift;
+        }
+        else
+        {
+            p->start_line_shown = START_LINE_UNKNOWN;
+            p->profile_shown = PROFILE_UNKNOWN;
+        }
+    }
+    HAL_GPIO_WritePin(U8G2_SPI_CS_GPIO_Port, U8G2_SPI_CS_Pin, GPIO_PIN_SET);
+    p->flush.phase = FLUSH_IDLE;
+    PROF_END(PROF_SEC_DISP_TX);
+    TRACE(TRACE_EV_DISP_END, 0);
+    u8g2_stm32_frame_done();
+}
+
+/**
+ * @brief 放弃当前帧, 下一帧整帧重发
+ * @return 无
+ */
+static void u8g2_stm32_spi_abort(void)
+{
+    Panel_t *p = &panels[0];
+
+    HAL_GPIO_WritePin(U8G2_SPI_CS_GPIO_Port, U8G2_SPI_CS_Pin, GPIO_PIN_SET);
+    p->flush.phase = FLUSH_IDLE;
+    p->shadow_valid = false;
+    p->start_line_shown = START_LINE_UNKNOWN;
+    p->addr_mode_shown = ADDR_MODE_UNKNOWN;
+    p->profile_shown = PROFILE_UNKNOWN;
+}
+
+/**
+ * @brief SPI 发送完成回调 (覆盖HAL弱定义, DMA 中断上下文)
+ * @param[in] hspi SPI 句柄
+ * @return 无
+ */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    if (hspi == &hspi1 && panels[0].flush.phase == FLUSH_DATA)
+    {
+        u8g2_stm32_spi_end_frame();
+    }
+}
+
+/**
+ * @brief SPI 错误回调 (覆盖HAL弱定义, DMA 中断上下文)
+ * @param[in] hspi SPI 句柄
+ * @return 无
+ */
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    if (hspi == &hspi1 && panels[0].flush.phase == FLUSH_DATA)
+    {
+        u8g2_stm32_spi_abort();
+    }
+}
+
+#endif /* U8G2_BUFFER_MODE == 0 && U8G2_TRANSPORT == U8G2_TRANSPORT_SPI */
+
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+
+/**
+ * @brief 初始化显示器的 SPI1、DMA 和控制引脚
+ * @details SPI 版是另一个硬件版本, 不在 CubeMX 工程中, 外设在这里直接配置:
+ *          SPI1 主机只发送, 模式0, 时钟由 U8G2_SPI_PRESCALER 决定; SCK/MOSI 重映射到 PB3/PB5
+ *          (JTAG 已关闭, 这两个引脚空闲); DMA1 通道3 为 SPI1_TX。片选、DC 和复位为推挽输出。
+ * @return 无
+ */
+static void u8g2_stm32_spi_init(void)
+{
+    GPIO_InitTypeDef gpio = {0};
+
+    __HAL_RCC_SPI1_CLK_ENABLE();
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_AFIO_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_AFIO_REMAP_SPI1_ENABLE();
+
+    HAL_GPIO_WritePin(U8G2_SPI_CS_GPIO_Port, U8G2_SPI_CS_Pin, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(U8G2_SPI_RES_GPIO_Port, U8G2_SPI_RES_Pin, GPIO_PIN_SET);
+    gpio.Mode = GPIO_MODE_OUTPUT_PP;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    gpio.Pin = U8G2_SPI_CS_Pin;
+    HAL_GPIO_Init(U8G2_SPI_CS_GPIO_Port, &gpio);
+    gpio.Pin = U8G2_SPI_DC_Pin;
+    HAL_GPIO_Init(U8G2_SPI_DC_GPIO_Port, &gpio);
+    gpio.Pin = U8G2_SPI_RES_Pin;
+    HAL_GPIO_Init(U8G2_SPI_RES_GPIO_Port, &gpio);
+
+    gpio.Mode = GPIO_MODE_AF_PP;
+    gpio.Pin = GPIO_PIN_3 | GPIO_PIN_5; // SCK, MOSI
+    HAL_GPIO_Init(GPIOB, &gpio);
+
+    hdma_spi1_tx.Instance = DMA1_Channel3;
+    hdma_spi1_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_spi1_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_spi1_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_spi1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_spi1_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_spi1_tx.Init.Mode = DMA_NORMAL;
+    hdma_spi1_tx.Init.Priority = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&hdma_spi1_tx) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(&hspi1, hdmatx, hdma_spi1_tx);
+    HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, IRQ_PRIO_BUS, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+
+    hspi1.Instance = SPI1;
+    hspi1.Init.Mode = SPI_MODE_MASTER;
+    hspi1.Init.Direction = SPI_DIRECTION_2LINES; // 只连接 MOSI, 接收溢出标志由 HAL 在发送结束时清除
+    hspi1.Init.DataSize = SPI_DATASIZE_8BIT;
+    hspi1.Init.CLKPolarity = SPI_POLARITY_LOW;
+    hspi1.Init.CLKPhase = SPI_PHASE_1EDGE;
+    hspi1.Init.NSS = SPI_NSS_SOFT;
+    hspi1.Init.BaudRatePrescaler = U8G2_SPI_PRESCALER;
+    hspi1.Init.FirstBit = SPI_FIRSTBIT_MSB;
+    hspi1.Init.TIMode = SPI_TIMODE_DISABLE;
+    hspi1.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
+    hspi1.Init.CRCPolynomial = 10;
+    if (HAL_SPI_Init(&hspi1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
+#endif /* U8G2_TRANSPORT == U8G2_TRANSPORT_SPI */
+
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_I2C2
+
+/**
+ * @brief 初始化显示器独占的 I2C2 和 DMA
+ * @details 双总线是另一个硬件版本, 不在 CubeMX 工程中, 外设在这里直接配置:
+ *          I2C2 主机 400kHz (其余参数与 I2C1 相同), SCL/SDA 为 PB10/PB11 复用开漏;
+ *          DMA1 通道4 为 I2C2_TX (与 USART1_TX 共用同一通道, 串口由 usart.c 放弃 DMA)。
+ *          事件和错误中断的优先级与 I2C1 相同。
+ * @return 无
+ */
+static void u8g2_stm32_i2c2_init(void)
+{
+    GPIO_InitTypeDef gpio = {0};
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_I2C2_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    gpio.Mode = GPIO_MODE_AF_OD;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    gpio.Pin = GPIO_PIN_10 | GPIO_PIN_11; // SCL, SDA
+    HAL_GPIO_Init(GPIOB, &gpio);
+
+    hdma_i2c2_tx.Instance = DMA1_Channel4;
+    hdma_i2c2_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_i2c2_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_i2c2_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_i2c2_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_i2c2_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_i2c2_tx.Init.Mode = DMA_NORMAL;
+    hdma_i2c2_tx.Init.Priority = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&hdma_i2c2_tx) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(&hi2c2, hdmatx, hdma_i2c2_tx);
+    HAL_NVIC_SetPriority(DMA1_Channel4_IRQn, IRQ_PRIO_BUS, 0); // 覆盖 dma.c 中 USART1_TX 的设置
+    HAL_NVIC_EnableIRQ(DMA1_Channel4_IRQn);
+    HAL_NVIC_SetPriority(I2C2_EV_IRQn, IRQ_PRIO_BUS, 0);
+    HAL_NVIC_EnableIRQ(I2C2_EV_IRQn);
+    HAL_NVIC_SetPriority(I2C2_ER_IRQn, IRQ_PRIO_BUS, 0);
+    HAL_NVIC_EnableIRQ(I2C2_ER_IRQn);
+
+    hi2c2.Instance = I2C2;
+    hi2c2.Init.ClockSpeed = 400000;
+    hi2c2.Init.DutyCycle = I2C_DUTYCYCLE_2;
+    hi2c2.Init.OwnAddress1 = 0;
+    hi2c2.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
+    hi2c2.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
+    hi2c2.Init.OwnAddress2 = 0;
+    hi2c2.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+    hi2c2.Init.NoStretchMode = I2C_NOSTRETCH_DISABLE;
+    if (HAL_I2C_Init(&hi2c2) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
+#endif /* U8G2_TRANSPORT == U8G2_TRANSPORT_I2C2 */
+
+/**
+ * @brief 按 DWT 周期计数器忙等待
+ * @details 周期数由调用者按 SystemCoreClock 换算，系统时钟调速后延时仍然准确；
+ *          DWT 可能还没有被性能分析或跟踪模块启动，这里确保它在运行。
+ * @param[in] cycles 等待的周期数
+ * @return 无
+ */
+static void u8g2_stm32_delay_cycles(uint32_t cycles)
+{
+    uint32_t start;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    start = DWT->CYCCNT;
+    while (DWT->CYCCNT - start < cycles)
+    {
+    }
+}
+
+/**
+ * @brief 毫秒延时, 等待期间继续推进总线队列并在两次滴答之间睡眠
+ * @details 用于 u8x8 复位时序中的毫秒等待 (带 RES 引脚的模块)。此时调度器还没有开始运行,
+ *          让出 CPU 的方式是推进其他模块已提交的I2C事务, 然后 WFI 等待下一个中断, 不再空转。
+ *          与 HAL_Delay 相同, 至少等待 ms 个完整的毫秒。
+ * @param[in] ms 等待的毫秒数
+ * @return 无
+ */
+static void u8g2_stm32_delay_ms(uint32_t ms)
+{
+    uint32_t tickstart = HAL_GetTick();
+
+    while ((HAL_GetTick() - tickstart) <= ms)
+    {
+        I2C_Bus_Service();
+        __WFI();
+    }
+}
+
+/**
+ * @brief U8g2的GPIO和延时回调函数
+ * @details U8g2库通过此函数请求GPIO操作 (片选、DC和复位, 只在SPI接口下使用) 和延时。
+ *          它处理毫秒、微秒和纳秒级别的延时请求: 微秒和纳秒延时按 DWT 周期计数,
+ *          毫秒延时睡眠等待并继续推进总线队列。
+ * @param[in] u8x8 U8g2显示对象指针
+ * @param[in] msg U8g2传递的消息类型 (e.g., U8X8_MSG_DELAY_MILLI)
+ * @param[in] arg_int 消息相关的整数参数 (e.g., delay duration)
+ * @param[in] arg_ptr 消息相关的指针参数 (未使用)
+ * @return uint8_t 操作结果
+ *         - @retval 1 成功
+ *         - @retval 0 失败 (消息不被支持时)
+ */
+uint8_t u8x8_stm32_gpio_and_delay(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    switch (msg)
+    {
+    case U8X8_MSG_GPIO_AND_DELAY_INIT:
+        // GPIO已由CubeMX初始化，此处无需操作
+        break;
+    case U8X8_MSG_DELAY_MILLI:
+#if !U8G2_HAS_RESET_PIN
+        if (in_display_init)
+        {
+            // 初始化中的毫秒延时来自 u8x8 的复位脉冲时序 (拉低/释放 RES 后各等待一段时间)，
+            // 没有 RES 引脚时只是白白等待，上电稳定时间已由 u8g2Init 保证
+            break;
+        }
+#endif
+        u8g2_stm32_delay_ms(arg_int);
+        break;
+    case U8X8_MSG_DELAY_10MICRO:
+        // arg_int 个10us，按当前的系统时钟换算为周期数，调速后仍然准确
+        u8g2_stm32_delay_cycles(10U * arg_int * (SystemCoreClock / 1000000U));
+        break;
+    case U8X8_MSG_DELAY_NANO:
+        // arg_int 纳秒，向上取整到整周期 (72MHz 下一个周期约14ns)
+        u8g2_stm32_delay_cycles((arg_int * (SystemCoreClock / 1000000U) + 999U) / 1000U);
+        break;
+    // 以下GPIO操作只在SPI接口下使用，I2C模式的SSD1306不需要
+    case U8X8_MSG_GPIO_CS:
+        // 片选
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+        HAL_GPIO_WritePin(U8G2_SPI_CS_GPIO_Port, U8G2_SPI_CS_Pin, arg_int ? GPIO_PIN_SET : GPIO_PIN_RESET);
+#endif
+        break;
+    case U8X8_MSG_GPIO_DC:
+        // 数据/命令选择
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+        HAL_GPIO_WritePin(U8G2_SPI_DC_GPIO_Port, U8G2_SPI_DC_Pin, arg_int ? GPIO_PIN_SET : GPIO_PIN_RESET);
+#endif
+        break;
+    case U8X8_MSG_GPIO_RESET:
+        // 复位，SPI 版模块引出了 RES
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+        HAL_GPIO_WritePin(U8G2_SPI_RES_GPIO_Port, U8G2_SPI_RES_Pin, arg_int ? GPIO_PIN_SET : GPIO_PIN_RESET);
+#endif
+        break;
+    default:
+        return 0;
+    }
+    return 1;
+}
+
+#if U8G2_TRANSPORT != U8G2_TRANSPORT_SPI
+/**
+ * @brief 速率校准的验证函数：发送一串空操作命令
+ * @details SSD1306 在 I2C 模式下不能读回显存或寄存器，只能以每个字节都得到应答作为通过的条件。
+ *          校准在 u8g2_InitDisplay 之前进行，即使个别字节被误收为其他命令，随后的初始化也会覆盖。
+ * @param[in] ctx 指向U8g2显示对象的指针
+ * @return HAL_StatusTypeDef 全部应答返回 HAL_OK
+ */
+static HAL_StatusTypeDef u8g2_stm32_verify(void *ctx)
+{
+    static uint8_t probe[U8G2_I2C_CHUNK_SIZE];
+    u8x8_t *u8x8 = u8g2_GetU8x8((u8g2_t *)ctx);
+
+    memset(probe, SSD1306_NOP, sizeof(probe));
+    probe[0] = SSD1306_CTRL_CMD;
+
+    I2C_Bus_Txn_t txn = {
+        .op = I2C_BUS_OP_TX,
+        .dev_addr = u8x8_GetI2CAddress(u8x8),
+        .data = probe,
+        .size = sizeof(probe),
+    };
+    return I2C_Bus_Transfer(&txn, I2C_BUS_PRIO_DISPLAY, U8G2_I2C_TIMEOUT_MS);
+}
+
+/**
+ * @brief 等待显示器开始应答
+ * @details 模块上的阻容复位释放之前控制器不应答地址，从 U8G2_POWER_UP_MS 起每 U8G2_POWER_UP_POLL_MS
+ *          发送一个空操作命令，得到应答即返回，最晚到复位后 U8G2_POWER_UP_MAX_MS。
+ *          等待期间 SLEEP 标记为高，逻辑分析仪上从复位到它变低即该模块实际需要的上电时间。
+ *          连续的无应答会使总线把显示器标记为降级，之后的探测按退避间隔放行，应答后即恢复。
+ * @param[in] u8g2 指向U8g2显示对象的指针 (已设置I2C地址)
+ * @return 无
+ */
+static void u8g2_stm32_wait_ready(u8g2_t *u8g2)
+{
+    static uint8_t probe[2] = {SSD1306_CTRL_CMD, SSD1306_NOP};
+
+    I2C_Bus_Txn_t txn = {
+        .op = I2C_BUS_OP_TX,
+        .dev_addr = u8x8_GetI2CAddress(u8g2_GetU8x8(u8g2)),
+        .data = probe,
+        .size = sizeof(probe),
+    };
+    MARK_BEGIN(SLEEP);
+    while (I2C_Bus_Transfer(&txn, I2C_BUS_PRIO_DISPLAY, U8G2_I2C_TIMEOUT_MS) != HAL_OK &&
+           HAL_GetTick() < U8G2_POWER_UP_MAX_MS)
+    {
+        u8g2_stm32_delay_ms(U8G2_POWER_UP_POLL_MS);
+    }
+    MARK_END(SLEEP);
+}
+#endif
+
+/**
+ * @brief 初始化显示控制器并打开显示
+ * @details U8G2_INIT_BURST 为 1 时把 u8g2 的 SSD1306 128x64 初始化序列 (含翻转方向和打开显示)
+ *          预先编码为一段以控制字节 0x00 开头的命令流，在一次事务中发完；u8x8 的命令层每条命令
+ *          都是一次单独的事务 (起始、地址、控制字节)，十几次事务之间还要等待上一次完成。
+ *          事务失败 (无应答) 时退回 u8g2_InitDisplay 逐条发送。初始化后控制器处于水平寻址模式。
+ * @param[in] u8g2 指向U8g2显示对象的指针
+ * @param[in] prio 初始化序列的总线优先级
+ * @return 无
+ */
+static void u8g2_stm32_init_controller(u8g2_t *u8g2, I2C_Bus_Prio_e prio)
+{
+#if U8G2_INIT_BURST
+    static const uint8_t init_seq[] = {
+        SSD1306_CTRL_CMD,
+        SSD1306_DISPLAY_OFF,
+        SSD1306_CLOCK_DIV, 0x80,
+        SSD1306_MUX_RATIO, 0x3F,
+        SSD1306_DISP_OFFSET, 0x00,
+        SSD1306_START_LINE,
+        SSD1306_CHARGE_PUMP, 0x14,
+        SSD1306_ADDR_MODE, SSD1306_ADDR_HORIZ,
+#if U8G2_FLIP
+        SSD1306_SEG_REMAP, SSD1306_COM_SCAN,            // 与 u8g2_SetFlipMode(1) 相同
+#else
+        SSD1306_SEG_REMAP | 0x01, SSD1306_COM_SCAN | 0x08,
+#endif
+        SSD1306_COM_PINS, 0x12,
+        SSD1306_CONTRAST, 0xCF,
+        SSD1306_PRECHARGE, FULL_PRECHARGE,
+        SSD1306_VCOMH, FULL_VCOMH,
+        SSD1306_SCROLL_OFF,
+        SSD1306_RAM_ON,
+        SSD1306_NORMAL,
+        SSD1306_DISPLAY_ON,
+    };
+    I2C_Bus_Txn_t txn = {
+        .op = I2C_BUS_OP_TX,
+        .dev_addr = u8x8_GetI2CAddress(u8g2_GetU8x8(u8g2)),
+        .data = (uint8_t *)init_seq, // DMA 直接从 Flash 读取
+        .size = sizeof(init_seq),
+    };
+
+    if (I2C_Bus_Transfer(&txn, prio, U8G2_I2C_TIMEOUT_MS) == HAL_OK)
+    {
+#if U8G2_FLIP
+        u8g2->u8x8.x_offset = u8g2->u8x8.display_info->flipmode_x_offset; // u8g2_SetFlipMode 另外改变的列偏移
+#endif
+        return;
+    }
+#else
+    (void)prio;
+#endif
+    in_display_init = true;
+    u8g2_InitDisplay(u8g2); // 初始化完成后，显示器处于关闭状态
+    in_display_init = false;
+#if U8G2_FLIP
+    u8g2_SetFlipMode(u8g2, 1); // 倒装：段重映射 0xA0、COM 扫描 0xC0，由控制器旋转画面
+#endif
+    u8g2_SetPowerSave(u8g2, 0);
+}
+
+/**
+ * @brief 校准显示器的 I2C 速率
+ * @details 在 U8G2_I2C_MIN_HZ 到 U8G2_I2C_MAX_HZ 之间找出显示器能可靠应答的最高速率 (留一档余量)，
+ *          之后的帧以该速率发送，其他设备的事务仍使用各自的速率。
+ *          u8g2Init 中自动调用；运行中调用时先等待当前帧发送完，之后应重新初始化显示器。
+ *          SPI 接口的时钟由 U8G2_SPI_PRESCALER 固定，不校准。
+ * @param[in] u8g2 指向U8g2显示对象的指针 (已设置I2C地址)
+ * @return uint32_t 显示器使用的速率 (Hz)
+ */
+uint32_t u8g2_stm32_CalibrateSpeed(u8g2_t *u8g2)
+{
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+    (void)u8g2;
+    return HAL_RCC_GetPCLK2Freq() / (2U << (U8G2_SPI_PRESCALER >> SPI_CR1_BR_Pos));
+#else
+    uint16_t addr = u8x8_GetI2CAddress(u8g2_GetU8x8(u8g2));
+
+    if (U8G2_I2C_MAX_HZ <= U8G2_I2C_MIN_HZ)
+    {
+        return I2C_Bus_Get_Speed(addr);
+    }
+#if U8G2_BUFFER_MODE == 0
+    u8g2_stm32_WaitFlush(U8G2_I2C_TIMEOUT_MS);
+#endif
+    return I2C_Bus_Calibrate(addr, U8G2_I2C_MIN_HZ, U8G2_I2C_MAX_HZ, u8g2_stm32_verify, u8g2);
+#endif
+}
+
+/**
+ * @brief 初始化U8g2显示对象
+ * @details 此函数执行U8g2的完整初始化流程：
+ *          0. 等待到复位后 U8G2_POWER_UP_MS (调用前其他设备的初始化时间计入其中)，I2C 接口再探测到显示器应答为止。
+ *          1. 按 U8G2_BUFFER_MODE 调用 `u8g2_Setup_ssd1306_i2c_128x64_noname_f/_1/_2` 设置显示驱动和回调
+ *             (SPI 接口先初始化 SPI1，再调用 `u8g2_Setup_ssd1306_128x64_noname_f/_1/_2`)。
+ *          2. 设置显示器的I2C地址 (I2C2 接口先初始化 I2C2 并登记为第二条总线)，校准显示器的I2C速率 (仅I2C接口)，
+ *             按 U8G2_BITBAND 选择像素写入方式。
+ *          3. 初始化显示控制器并打开显示器：I2C 接口以一次事务发送预先编码的初始化序列 (U8G2_INIT_BURST)，
+ *             否则调用 `u8g2_InitDisplay`，U8G2_FLIP 为 1 时再设置翻转方向，之后 `u8g2_SetPowerSave(0)`。
+ *          4. 清空屏幕缓冲区并发送到屏幕 (整帧模式下经整帧快速上传)。
+ * @param[out] u8g2 指向待初始化的U8g2显示对象的指针
+ * @return 无
+ */
+void u8g2Init(u8g2_t *u8g2)
+{
+    uint32_t now = HAL_GetTick();
+    if (now < U8G2_POWER_UP_MS)
+    {
+        HAL_Delay(U8G2_POWER_UP_MS - now);                                                                    // 确保显示器上电稳定 (其他设备初始化已用掉的时间不再重复等待)
+    }
+#if U8G2_BUFFER_MODE == 0
+    panels[0].u8g2 = u8g2;                                                                                    // 登记为主显示器
+    panels[0].prio = I2C_BUS_PRIO_DISPLAY;
+#endif
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+    u8g2_stm32_spi_init();
+#if U8G2_BUFFER_MODE == 0
+    u8g2_Setup_ssd1306_128x64_noname_f(u8g2, U8G2_R0, u8x8_byte_stm32_hw_spi, u8x8_stm32_gpio_and_delay);     // 初始化 u8g2 结构体
+#elif U8G2_BUFFER_MODE == 1
+    u8g2_Setup_ssd1306_128x64_noname_1(u8g2, U8G2_R0, u8x8_byte_stm32_hw_spi, u8x8_stm32_gpio_and_delay);
+#else
+    u8g2_Setup_ssd1306_128x64_noname_2(u8g2, U8G2_R0, u8x8_byte_stm32_hw_spi, u8x8_stm32_gpio_and_delay);
+#endif
+#else
+#if U8G2_BUFFER_MODE == 0
+    u8g2_Setup_ssd1306_i2c_128x64_noname_f(u8g2, U8G2_R0, u8x8_byte_stm32_hw_i2c, u8x8_stm32_gpio_and_delay); // 初始化 u8g2 结构体
+#elif U8G2_BUFFER_MODE == 1
+    u8g2_Setup_ssd1306_i2c_128x64_noname_1(u8g2, U8G2_R0, u8x8_byte_stm32_hw_i2c, u8x8_stm32_gpio_and_delay);
+#else
+    u8g2_Setup_ssd1306_i2c_128x64_noname_2(u8g2, U8G2_R0, u8x8_byte_stm32_hw_i2c, u8x8_stm32_gpio_and_delay);
+#endif
+    u8g2_SetI2CAddress(u8g2, 0x78);                                                                           // 设置I2C地址
+#if U8G2_TRANSPORT == U8G2_TRANSPORT_I2C2
+    u8g2_stm32_i2c2_init();
+    I2C_Bus_Attach(&hi2c2, 0x78);                                                                             // 显示器的事务改走 I2C2，与 I2C1 上的设备互不等待
+#endif
+    u8g2_stm32_wait_ready(u8g2);                                                                              // 等到显示器应答 (复位释放) 为止
+    u8g2_stm32_CalibrateSpeed(u8g2);                                                                          // 找出显示器可靠的最高速率，须在初始化显示控制器之前
+#endif
+    u8g2_stm32_SetBitband(u8g2, U8G2_BITBAND != 0);                                                          // 画点、画线改用位带写入
+    u8g2_stm32_init_controller(u8g2, I2C_BUS_PRIO_DISPLAY);                                                   // 初始化显示控制器并打开显示器
+#if U8G2_BUFFER_MODE == 0
+    u8g2_ClearBuffer(u8g2);
+    u8g2_stm32_InvalidateShadow();                                                                            // 控制器刚初始化，起始行和寻址模式都须重新发送
+    u8g2_stm32_SendBufferAsync(u8g2);                                                                         // 影子副本失效，以一次 1024 字节的事务整帧发送
+    u8g2_stm32_WaitFlush(U8G2_I2C_TIMEOUT_MS);
+#else
+    u8g2_ClearDisplay(u8g2);                                                                                  // 逐条带清屏
+#endif
 }
 
 /**
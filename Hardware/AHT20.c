@@ -2,13 +2,20 @@
  * @file      AHT20.c
  * @brief     温湿度传感器AHT20驱动文件
  * @details   本文件实现了AHT20的各种操作，包括初始化、复位和数据读取。
+ *            除阻塞读取外，还提供触发/轮询两步的非阻塞测量，以及非阻塞初始化 (上电等待、状态检查、校准等待)。
+ *            两者顺序写在同一个协程 (pt.h) 中，由 AHT20_Poll 推进，每次总线等待和设备延时都让出。
+ *            测量结果的缓存以顺序锁 (seqlock.h) 更新，AHT20_Read_Last 在任何不打断协程的上下文中都能读到完整的一组值。
  * @author    SandOcean
- * @date      2025-09-09
- * @version   1.0
+ * @date      2025-10-08
+ * @version   1.1
  * @copyright Copyright (c) 2025 SandOcean
  */
 
 #include "AHT20.h"
+#include "i2c_bus.h"
+#include "profiler.h"
+#include "pt.h"
+#include "seqlock.h"
 
 /**
  * @addtogroup AHT20_Driver
@@ -18,11 +25,72 @@
 /* Private variables ---------------------------------------------------------*/
 /**
  * @brief 用于保存I2C句柄的静态指针
- * @details 在 AHT20_Init 函数中被初始化，供模块内所有私有函数使用，
- *          避免了在每个函数调用中都传递 I2C 句柄。
+ * @details 在 AHT20_Init 函数中被初始化，同时作为驱动已初始化的标志。
+ *          实际传输经由 i2c_bus 模块的事务队列完成。
  */
 static I2C_HandleTypeDef *g_aht20_hi2c = NULL;
 
+/**
+ * @brief 非阻塞测量的状态
+ */
+static struct
+{
+    volatile bool measuring;        ///< 是否有测量正在进行 (已请求，尚未结束)
+    uint32_t start_time;            ///< 请求测量的时间戳
+    uint32_t next_poll;             ///< 下一次允许读取数据的时间戳
+    bool fresh;                     ///< 协程本次调用得到了新的测量结果
+    uint8_t trigger[3];             ///< 触发命令缓冲区 (异步发送期间须保持有效)
+    uint8_t rx[6];                  ///< 状态字节 + 5字节测量值
+} g_aht20_meas;
+
+static AHT20_Data_t g_aht20_last; ///< 最近一次测量结果的缓存
+static Seqlock_t g_aht20_last_lock; ///< g_aht20_last 的顺序锁
+
+/**
+ * @brief 初始化的阶段
+ */
+typedef enum
+{
+    AHT20_INIT_NONE = 0,    ///< 未调用初始化
+    AHT20_INIT_RUNNING,     ///< 非阻塞初始化在协程中进行
+    AHT20_INIT_READY,       ///< 可以测量
+    AHT20_INIT_FAILED       ///< 传感器无应答
+} AHT20_Init_Stage_e;
+
+/**
+ * @brief 初始化的状态
+ */
+static struct
+{
+    volatile AHT20_Init_Stage_e stage;      ///< 当前阶段
+    uint32_t wait_until;                    ///< 校准等待的截止时间
+    uint8_t buf[3];                         ///< 状态字节 / 初始化命令缓冲区
+} g_aht20_init;
+
+/**
+ * @brief 协程当前等待的总线事务
+ */
+static struct
+{
+    I2C_Bus_Op_e op;                        ///< I2C_BUS_OP_TX 或 I2C_BUS_OP_RX
+    uint8_t *data;                          ///< 数据缓冲区 (事务期间须保持有效)
+    uint16_t size;                          ///< 数据长度
+    volatile bool busy;                     ///< 事务是否在总线队列中
+    volatile HAL_StatusTypeDef status;      ///< 事务结果，HAL_BUSY 表示队列已满、尚未提交
+} g_aht20_xfer;
+
+static PT_t g_aht20_pt; ///< 初始化和测量的协程
+
+/* Private function prototypes -----------------------------------------------*/
+static HAL_StatusTypeDef AHT20_Read_Raw(uint8_t *read_buffer);
+static HAL_StatusTypeDef AHT20_Receive(uint8_t *p_data, uint16_t size);
+static void AHT20_Convert_Int(const uint8_t *raw, int16_t *temperature_cdeg, uint16_t *humidity_pm);
+static void AHT20_Xfer_Cb(HAL_StatusTypeDef status, void *ctx);
+static void AHT20_Xfer_Submit(void);
+static void AHT20_Xfer_Start(I2C_Bus_Op_e op, uint8_t *data, uint16_t size);
+static bool AHT20_Xfer_Done(void);
+static uint8_t AHT20_Thread(void);
+
 /* Private Function implementations ------------------------------------------*/
 
 /**
@@ -40,7 +108,30 @@ static HAL_StatusTypeDef AHT20_Send_Cmd(uint8_t cmd, uint8_t *p_data, uint16_t s
         tx_buffer[1] = p_data[0];
         tx_buffer[2] = p_data[1];
     }
-    return HAL_I2C_Master_Transmit(g_aht20_hi2c, AHT20_ADDRESS, tx_buffer, size + 1, HAL_MAX_DELAY);
+    I2C_Bus_Txn_t txn = {
+        .op = I2C_BUS_OP_TX,
+        .dev_addr = AHT20_ADDRESS,
+        .data = tx_buffer,
+        .size = size + 1,
+    };
+    return I2C_Bus_Transfer(&txn, I2C_BUS_PRIO_SENSOR, AHT20_I2C_TIMEOUT);
+}
+
+/**
+ * @brief 从AHT20读取若干字节 (阻塞)
+ * @param[out] p_data 接收缓冲区
+ * @param[in] size 读取长度
+ * @return HAL_StatusTypeDef - 总线事务结果
+ */
+static HAL_StatusTypeDef AHT20_Receive(uint8_t *p_data, uint16_t size)
+{
+    I2C_Bus_Txn_t txn = {
+        .op = I2C_BUS_OP_RX,
+        .dev_addr = AHT20_ADDRESS,
+        .data = p_data,
+        .size = size,
+    };
+    return I2C_Bus_Transfer(&txn, I2C_BUS_PRIO_SENSOR, AHT20_I2C_TIMEOUT);
 }
 
 /**
@@ -50,7 +141,57 @@ static HAL_StatusTypeDef AHT20_Send_Cmd(uint8_t cmd, uint8_t *p_data, uint16_t s
  */
 static HAL_StatusTypeDef AHT20_Read_Status(uint8_t *p_status)
 {
-    return HAL_I2C_Master_Receive(g_aht20_hi2c, AHT20_ADDRESS, p_status, 1, HAL_MAX_DELAY);
+    return AHT20_Receive(p_status, 1);
+}
+
+/**
+ * @brief 将6字节原始数据转换为整数温湿度
+ * @details 湿度 = raw * 1000 / 2^20 = raw * 125 >> 17 (0.1%RH);
+ *          温度 = raw * 20000 / 2^20 - 5000 = (raw * 625 >> 15) - 5000 (0.01℃)。
+ *          raw 为20位, 乘积不超过32位, 结果四舍五入。
+ * @param[in] raw 读取到的6字节数据 (状态 + 5字节测量值)
+ * @param[out] temperature_cdeg 温度 (0.01℃)
+ * @param[out] humidity_pm 相对湿度 (0.1%RH)
+ * @return 无
+ */
+static void AHT20_Convert_Int(const uint8_t *raw, int16_t *temperature_cdeg, uint16_t *humidity_pm)
+{
+    uint32_t raw_humi = ((uint32_t)raw[1] << 12) | ((uint32_t)raw[2] << 4) | (raw[3] >> 4);
+    uint32_t raw_temp = (((uint32_t)raw[3] & 0x0F) << 16) | ((uint32_t)raw[4] << 8) | raw[5];
+
+    *humidity_pm = (uint16_t)((raw_humi * 125u + (1u << 16)) >> 17);
+    *temperature_cdeg = (int16_t)((int32_t)((raw_temp * 625u + (1u << 14)) >> 15) - 5000);
+}
+
+/**
+ * @brief 触发一次测量并阻塞等待, 读取6字节原始数据
+ * @param[out] read_buffer 至少6字节的缓冲区
+ * @return HAL_StatusTypeDef HAL状态码
+ */
+static HAL_StatusTypeDef AHT20_Read_Raw(uint8_t *read_buffer)
+{
+    uint8_t trigger_params[2] = {0x33, 0x00};
+    HAL_StatusTypeDef ret;
+
+    // 1. 发送触发测量命令
+    ret = AHT20_Send_Cmd(AHT20_CMD_TRIGGER, trigger_params, 2);
+    if (ret != HAL_OK) {
+        return ret;
+    }
+
+    // 2. 延时等待测量完成 (官方建议>75ms)
+    HAL_Delay(AHT20_MEASURE_TIME_MS);
+
+    // 3. 循环读取状态，直到传感器不忙
+    do {
+        ret = AHT20_Receive(read_buffer, 6);
+        if (ret != HAL_OK) {
+            return ret;
+        }
+        HAL_Delay(AHT20_POLL_INTERVAL_MS); // 短暂延时避免频繁查询
+    } while ((read_buffer[0] & AHT20_STATUS_BUSY) != 0);
+
+    return HAL_OK;
 }
 
 /* Public Function implementations -------------------------------------------*/
@@ -67,10 +208,15 @@ HAL_StatusTypeDef AHT20_Init(I2C_HandleTypeDef *hi2c)
     uint8_t status = 0;
     HAL_StatusTypeDef ret;
 
-    HAL_Delay(40); // 上电后延时
+    // 上电时间从复位算起，之前的初始化已经等过的部分不再重复等待
+    uint32_t now = HAL_GetTick();
+    if (now < AHT20_POWER_UP_MS) {
+        HAL_Delay(AHT20_POWER_UP_MS - now);
+    }
 
     ret = AHT20_Read_Status(&status);
     if (ret != HAL_OK) {
+        g_aht20_init.stage = AHT20_INIT_FAILED;
         return ret;
     }
 
@@ -78,12 +224,38 @@ HAL_StatusTypeDef AHT20_Init(I2C_HandleTypeDef *hi2c)
     if ((status & AHT20_STATUS_CAL) == 0) {
         uint8_t init_params[2] = {0x08, 0x00};
         ret = AHT20_Send_Cmd(AHT20_CMD_INIT, init_params, 2);
-        HAL_Delay(300); // 初始化后需要延时
+        HAL_Delay(AHT20_CAL_TIME_MS); // 初始化后需要延时
     }
-    
+
+    g_aht20_init.stage = (ret == HAL_OK) ? AHT20_INIT_READY : AHT20_INIT_FAILED;
+    PT_INIT(&g_aht20_pt); // 协程直接进入测量循环
     return ret;
 }
 
+/**
+ * @brief 开始非阻塞初始化
+ * @details 只记录句柄后立即返回，上电等待、状态检查和校准等待都在 AHT20_Poll() 推进的协程中进行，
+ *          可以与显示初始化和首帧绘制重叠进行。
+ * @param[in] hi2c 指向目标I2C外设的HAL句柄指针
+ * @return 无
+ */
+void AHT20_Begin(I2C_HandleTypeDef *hi2c)
+{
+    g_aht20_hi2c = hi2c;
+    g_aht20_init.stage = AHT20_INIT_RUNNING;
+    g_aht20_xfer.busy = false;
+    PT_INIT(&g_aht20_pt);
+}
+
+/**
+ * @brief 查询传感器是否已完成初始化
+ * @return bool 可以开始测量返回 true
+ */
+bool AHT20_Is_Ready(void)
+{
+    return g_aht20_init.stage == AHT20_INIT_READY;
+}
+
 /**
  * @brief 软复位AHT20传感器
  * @return HAL_StatusTypeDef HAL状态码
@@ -108,42 +280,270 @@ HAL_StatusTypeDef AHT20_Read_Temp_Humi(float *temperature, float *humidity)
         return HAL_ERROR; // 未初始化
     }
 
-    uint8_t trigger_params[2] = {0x33, 0x00};
     uint8_t read_buffer[6] = {0};
-    uint32_t raw_humi = 0;
-    uint32_t raw_temp = 0;
-    HAL_StatusTypeDef ret;
-
-    // 1. 发送触发测量命令
-    ret = AHT20_Send_Cmd(AHT20_CMD_TRIGGER, trigger_params, 2);
+    HAL_StatusTypeDef ret = AHT20_Read_Raw(read_buffer);
     if (ret != HAL_OK) {
         return ret;
     }
 
-    // 2. 延时等待测量完成 (官方建议>75ms)
-    HAL_Delay(80);
-
-    // 3. 循环读取状态，直到传感器不忙
-    do {
-        ret = HAL_I2C_Master_Receive(g_aht20_hi2c, AHT20_ADDRESS, read_buffer, 6, HAL_MAX_DELAY);
-        if (ret != HAL_OK) {
-            return ret;
-        }
-        HAL_Delay(5); // 短暂延时避免频繁查询
-    } while ((read_buffer[0] & AHT20_STATUS_BUSY) != 0);
-
-    // 4. 转换数据
     // 湿度数据转换
-    raw_humi = ((uint32_t)read_buffer[1] << 12) | ((uint32_t)read_buffer[2] << 4) | (read_buffer[3] >> 4);
+    uint32_t raw_humi = ((uint32_t)read_buffer[1] << 12) | ((uint32_t)read_buffer[2] << 4) | (read_buffer[3] >> 4);
     *humidity = (float)raw_humi * 100.0f / 1048576.0f; // 1048576 = 2^20
 
     // 温度数据转换
-    raw_temp = (((uint32_t)read_buffer[3] & 0x0F) << 16) | ((uint32_t)read_buffer[4] << 8) | read_buffer[5];
+    uint32_t raw_temp = (((uint32_t)read_buffer[3] & 0x0F) << 16) | ((uint32_t)read_buffer[4] << 8) | read_buffer[5];
     *temperature = (float)raw_temp * 200.0f / 1048576.0f - 50.0f;
 
     return HAL_OK;
 }
 
+/**
+ * @brief 读取AHT20的温度和湿度值 (整数版本, 阻塞)
+ * @param[out] temperature_cdeg 温度 (0.01℃)
+ * @param[out] humidity_pm 相对湿度 (0.1%RH)
+ * @return HAL_StatusTypeDef HAL状态码
+ */
+HAL_StatusTypeDef AHT20_Read_Temp_Humi_Int(int16_t *temperature_cdeg, uint16_t *humidity_pm)
+{
+    if (g_aht20_hi2c == NULL) {
+        return HAL_ERROR; // 未初始化
+    }
+
+    uint8_t read_buffer[6] = {0};
+    HAL_StatusTypeDef ret = AHT20_Read_Raw(read_buffer);
+    if (ret != HAL_OK) {
+        return ret;
+    }
+
+    AHT20_Convert_Int(read_buffer, temperature_cdeg, humidity_pm);
+    return HAL_OK;
+}
+
+/**
+ * @brief 请求一次非阻塞测量
+ * @details 触发命令由下一次 AHT20_Poll() 发出。
+ * @return HAL_StatusTypeDef HAL状态码
+ *         - @retval HAL_OK 已请求
+ *         - @retval HAL_BUSY 上一次测量尚未完成，或初始化尚未完成
+ *         - @retval HAL_ERROR 未初始化
+ */
+HAL_StatusTypeDef AHT20_StartMeasurement(void)
+{
+    if (g_aht20_hi2c == NULL || g_aht20_init.stage == AHT20_INIT_FAILED) {
+        return HAL_ERROR;
+    }
+    if (g_aht20_meas.measuring || g_aht20_init.stage != AHT20_INIT_READY) {
+        return HAL_BUSY;
+    }
+
+    g_aht20_meas.start_time = HAL_GetTick();
+    g_aht20_meas.measuring = true;
+    return HAL_OK;
+}
+
+/**
+ * @brief 协程中总线事务的完成回调 (I2C中断上下文)
+ * @param[in] status 事务结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void AHT20_Xfer_Cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+    g_aht20_xfer.status = status;
+    g_aht20_xfer.busy = false;
+}
+
+/**
+ * @brief 把 g_aht20_xfer 描述的事务提交到总线队列
+ * @return 无
+ */
+static void AHT20_Xfer_Submit(void)
+{
+    I2C_Bus_Txn_t txn = {
+        .op = g_aht20_xfer.op,
+        .dev_addr = AHT20_ADDRESS,
+        .data = g_aht20_xfer.data,
+        .size = g_aht20_xfer.size,
+        .cb = AHT20_Xfer_Cb,
+    };
+
+    // 先置位再提交, 回调可能在提交返回之前就已执行
+    g_aht20_xfer.busy = true;
+    if (I2C_Bus_Submit(&txn, I2C_BUS_PRIO_SENSOR) != HAL_OK) {
+        g_aht20_xfer.status = HAL_BUSY; // 队列已满，由 AHT20_Xfer_Done() 重试
+        g_aht20_xfer.busy = false;
+    }
+}
+
+/**
+ * @brief 开始协程中的一个总线事务
+ * @param[in] op I2C_BUS_OP_TX 或 I2C_BUS_OP_RX
+ * @param[in] data 数据缓冲区 (静态变量)
+ * @param[in] size 数据长度
+ * @return 无
+ */
+static void AHT20_Xfer_Start(I2C_Bus_Op_e op, uint8_t *data, uint16_t size)
+{
+    g_aht20_xfer.op = op;
+    g_aht20_xfer.data = data;
+    g_aht20_xfer.size = size;
+    AHT20_Xfer_Submit();
+}
+
+/**
+ * @brief 协程的等待条件：当前事务是否已结束
+ * @details 提交时队列已满的事务在这里重新提交，每次调用最多重试一次。
+ * @return bool 已结束 (结果在 g_aht20_xfer.status 中) 返回 true
+ */
+static bool AHT20_Xfer_Done(void)
+{
+    if (g_aht20_xfer.busy) {
+        return false;
+    }
+    if (g_aht20_xfer.status == HAL_BUSY) {
+        AHT20_Xfer_Submit();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 初始化和测量的协程
+ * @details 非阻塞初始化完成后 (或阻塞的 AHT20_Init() 之后) 进入测量循环：
+ *          等待 AHT20_StartMeasurement() 的请求，发送触发命令，等待转换时间后一次读出状态和测量值，
+ *          传感器仍忙时每隔 AHT20_POLL_INTERVAL_MS 再读。读取失败或等待超过 AHT20_MEASURE_TIMEOUT 时
+ *          放弃本次测量, 缓存保持上一次的结果。
+ * @return uint8_t PT_WAITING 等协程返回值
+ */
+static uint8_t AHT20_Thread(void)
+{
+    PT_t *pt = &g_aht20_pt;
+
+    PT_BEGIN(pt);
+
+    if (g_aht20_init.stage == AHT20_INIT_RUNNING) {
+        // 1. 上电时间从复位算起
+        PT_WAIT_TICK(pt, AHT20_POWER_UP_MS);
+
+        // 2. 读取状态字节
+        AHT20_Xfer_Start(I2C_BUS_OP_RX, g_aht20_init.buf, 1);
+        PT_WAIT_UNTIL(pt, AHT20_Xfer_Done());
+        if (g_aht20_xfer.status != HAL_OK) {
+            g_aht20_init.stage = AHT20_INIT_FAILED;
+            PT_EXIT(pt);
+        }
+
+        // 3. 未校准时发送初始化命令，等待校准完成
+        if ((g_aht20_init.buf[0] & AHT20_STATUS_CAL) == 0) {
+            g_aht20_init.buf[0] = AHT20_CMD_INIT;
+            g_aht20_init.buf[1] = 0x08;
+            g_aht20_init.buf[2] = 0x00;
+            g_aht20_init.wait_until = HAL_GetTick() + AHT20_CAL_TIME_MS;
+            AHT20_Xfer_Start(I2C_BUS_OP_TX, g_aht20_init.buf, 3);
+            PT_WAIT_UNTIL(pt, AHT20_Xfer_Done());
+            if (g_aht20_xfer.status != HAL_OK) {
+                g_aht20_init.stage = AHT20_INIT_FAILED;
+                PT_EXIT(pt);
+            }
+            PT_WAIT_TICK(pt, g_aht20_init.wait_until);
+        }
+        g_aht20_init.stage = AHT20_INIT_READY;
+    }
+
+    for (;;) {
+        PT_WAIT_UNTIL(pt, g_aht20_meas.measuring);
+
+        // 1. 发送触发测量命令
+        g_aht20_meas.trigger[0] = AHT20_CMD_TRIGGER;
+        g_aht20_meas.trigger[1] = 0x33;
+        g_aht20_meas.trigger[2] = 0x00;
+        AHT20_Xfer_Start(I2C_BUS_OP_TX, g_aht20_meas.trigger, sizeof(g_aht20_meas.trigger));
+        PT_WAIT_UNTIL(pt, AHT20_Xfer_Done());
+        if (g_aht20_xfer.status != HAL_OK) {
+            g_aht20_meas.measuring = false;
+            continue;
+        }
+
+        // 2. 等待转换完成，状态字节与测量值一次读出，仍忙时稍后再读
+        g_aht20_meas.next_poll = g_aht20_meas.start_time + AHT20_MEASURE_TIME_MS;
+        for (;;) {
+            PT_WAIT_TICK(pt, g_aht20_meas.next_poll);
+            PROF_BEGIN(PROF_SEC_SENSOR_READ);
+            AHT20_Xfer_Start(I2C_BUS_OP_RX, g_aht20_meas.rx, sizeof(g_aht20_meas.rx));
+            PT_WAIT_UNTIL(pt, AHT20_Xfer_Done());
+            PROF_END(PROF_SEC_SENSOR_READ);
+            if (g_aht20_xfer.status != HAL_OK || (g_aht20_meas.rx[0] & AHT20_STATUS_BUSY) == 0 ||
+                HAL_GetTick() - g_aht20_meas.start_time > AHT20_MEASURE_TIMEOUT) {
+                break; // 读取失败、转换完成或传感器无响应
+            }
+            g_aht20_meas.next_poll = HAL_GetTick() + AHT20_POLL_INTERVAL_MS;
+        }
+
+        // 3. 转换结果
+        if (g_aht20_xfer.status == HAL_OK && (g_aht20_meas.rx[0] & AHT20_STATUS_BUSY) == 0) {
+            Seqlock_Write_Begin(&g_aht20_last_lock);
+            AHT20_Convert_Int(g_aht20_meas.rx, &g_aht20_last.temperature_cdeg, &g_aht20_last.humidity_pm);
+            g_aht20_last.timestamp = HAL_GetTick();
+            g_aht20_last.valid = true;
+            Seqlock_Write_End(&g_aht20_last_lock);
+            g_aht20_meas.fresh = true;
+        }
+        g_aht20_meas.measuring = false;
+    }
+
+    PT_END(pt);
+}
+
+/**
+ * @brief 推进非阻塞初始化和测量
+ * @return bool 本次调用是否得到了新的测量结果
+ */
+bool AHT20_Poll(void)
+{
+    if (g_aht20_init.stage == AHT20_INIT_NONE) {
+        return false;
+    }
+
+    g_aht20_meas.fresh = false;
+    AHT20_Thread();
+    return g_aht20_meas.fresh;
+}
+
+/**
+ * @brief 查询是否有测量正在进行
+ * @return bool 正在测量返回 true
+ */
+bool AHT20_Is_Measuring(void)
+{
+    return g_aht20_meas.measuring;
+}
+
+/**
+ * @brief 获取最近一次测量结果的缓存
+ * @return const AHT20_Data_t* 指向缓存结果的指针
+ */
+const AHT20_Data_t *AHT20_Get_Last(void)
+{
+    return &g_aht20_last;
+}
+
+/**
+ * @brief 拷贝最近一次测量结果的缓存
+ * @param[out] out 测量结果
+ * @return bool 已经有过一次成功的测量返回 true
+ */
+bool AHT20_Read_Last(AHT20_Data_t *out)
+{
+    uint32_t seq;
+
+    do {
+        seq = Seqlock_Read_Begin(&g_aht20_last_lock);
+        *out = g_aht20_last;
+    } while (Seqlock_Read_Retry(&g_aht20_last_lock, seq));
+    return out->valid;
+}
+
 /**
  * @}
  */
\ No newline at end of file
@@ -2,9 +2,11 @@
  * @file      AHT20.h
  * @brief     温湿度传感器AHT20驱动头文件
  * @details   定义了AHT20传感器的I2C地址、命令以及操作函数原型。
+ *            测量采用非阻塞方式: AHT20_StartMeasurement() 触发测量, 主循环反复调用
+ *            AHT20_Poll() 在转换完成后读取结果并缓存, 显示层只读取缓存值。
  * @author    SandOcean
- * @date      2025-09-09
- * @version   1.0
+ * @date      2025-10-08
+ * @version   1.1
  * @copyright Copyright (c) 2025 SandOcean
  */
 
@@ -13,6 +15,7 @@
 
 #include "main.h"
 #include "stdint.h"
+#include <stdbool.h>
 #include "i2c.h" // 确保包含了你的I2C头文件
 
 /**
@@ -26,8 +29,25 @@
  * @{ 
  */
 #define AHT20_ADDRESS (0x38 << 1)      ///< AHT20 I2C设备地址 (7位地址左移一位)
+#define AHT20_I2C_TIMEOUT      20      ///< 单次I2C传输的超时时间 (ms, 含在总线队列中的等待)
+#define AHT20_MEASURE_TIME_MS  80      ///< 触发后等待转换完成的时间 (官方建议>75ms)
+#define AHT20_POLL_INTERVAL_MS 5       ///< 转换未完成时再次查询的间隔
+#define AHT20_MEASURE_TIMEOUT  200     ///< 单次测量的最长等待时间, 超时后放弃
+#define AHT20_POWER_UP_MS      40      ///< 上电后可以通信的时间 (从MCU复位算起)
+#define AHT20_CAL_TIME_MS      300     ///< 发送初始化命令后等待校准完成的时间
 /** @} */
 
+/**
+ * @brief AHT20 缓存的测量结果
+ */
+typedef struct
+{
+    int16_t temperature_cdeg; ///< 温度 (0.01℃)
+    uint16_t humidity_pm;     ///< 相对湿度 (0.1%RH, 千分比)
+    uint32_t timestamp;       ///< 获得该结果时的系统时间戳 (ms)
+    bool valid;               ///< 是否已经有过一次成功的测量
+} AHT20_Data_t;
+
 /** 
  * @defgroup AHT20_Commands AHT20 命令
  * @{ 
@@ -53,6 +73,21 @@
  */
 HAL_StatusTypeDef AHT20_Init(I2C_HandleTypeDef *hi2c);
 
+/**
+ * @brief 开始非阻塞初始化
+ * @details 立即返回，上电等待、状态检查和校准等待在之后的 AHT20_Poll() 调用中完成。
+ *          完成前 AHT20_StartMeasurement() 返回 HAL_BUSY。
+ * @param[in] hi2c 指向目标I2C外设的HAL句柄指针
+ * @return 无
+ */
+void AHT20_Begin(I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief 查询传感器是否已完成初始化
+ * @return bool 可以开始测量返回 true
+ */
+bool AHT20_Is_Ready(void);
+
 /**
  * @brief 软复位AHT20传感器
  * @return HAL_StatusTypeDef HAL状态码
@@ -68,4 +103,49 @@ HAL_StatusTypeDef AHT20_Soft_Reset(void);
  */
 HAL_StatusTypeDef AHT20_Read_Temp_Humi(float *temperature, float *humidity);
 
+/**
+ * @brief 读取AHT20的温度和湿度值 (整数版本, 阻塞)
+ * @param[out] temperature_cdeg 温度 (0.01℃)
+ * @param[out] humidity_pm 相对湿度 (0.1%RH)
+ * @return HAL_StatusTypeDef HAL状态码
+ * @note 只使用移位和整数乘法完成换算, 不依赖软件浮点库。
+ */
+HAL_StatusTypeDef AHT20_Read_Temp_Humi_Int(int16_t *temperature_cdeg, uint16_t *humidity_pm);
+
+/**
+ * @brief 请求一次非阻塞测量
+ * @details 立即返回, 触发命令由下一次 AHT20_Poll() 发出, 之后需要周期性调用 AHT20_Poll()。
+ * @return HAL_StatusTypeDef HAL状态码, 上一次测量尚未完成或初始化尚未完成时返回 HAL_BUSY
+ */
+HAL_StatusTypeDef AHT20_StartMeasurement(void);
+
+/**
+ * @brief 推进非阻塞测量, 在主循环中调用
+ * @details 转换时间未到时直接返回; 到时后读取一次数据, 若传感器仍忙则等待下一次调用。
+ *          由 AHT20_Begin() 开始的初始化也在这里推进。
+ * @return bool 本次调用是否得到了新的测量结果
+ */
+bool AHT20_Poll(void);
+
+/**
+ * @brief 查询是否有测量正在进行
+ * @return bool 正在测量返回 true
+ */
+bool AHT20_Is_Measuring(void);
+
+/**
+ * @brief 获取最近一次测量结果的缓存
+ * @note 返回的是缓存本身，只能在推进测量的主循环中读取；其他上下文使用 AHT20_Read_Last()。
+ * @return const AHT20_Data_t* 指向缓存结果的指针
+ */
+const AHT20_Data_t *AHT20_Get_Last(void);
+
+/**
+ * @brief 拷贝最近一次测量结果的缓存
+ * @details 以顺序锁读取，温度、湿度和时间戳属于同一次测量。不可在打断 AHT20_Poll() 的中断中调用。
+ * @param[out] out 测量结果
+ * @return bool 已经有过一次成功的测量返回 true
+ */
+bool AHT20_Read_Last(AHT20_Data_t *out);
+
 #endif /* __AHT20_H */
@@ -0,0 +1,332 @@
+/**
+ * @file      AT24C32.c
+ * @brief     AT24C32 EEPROM 驱动实现
+ * @details   阻塞接口通过 I2C_Bus_Transfer 排队等待完成，异步接口直接提交到总线队列。
+ *            异步写任务同一时间只有一个，每块在上一块的完成回调中提交。
+ * @author    SandOcean
+ * @date      2025-10-06
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "AT24C32.h"
+#include "profiler.h"
+
+/**
+ * @addtogroup AT24C32_Driver
+ * @{
+ */
+
+/* Private variables ---------------------------------------------------------*/
+/**
+ * @brief 异步EEPROM写任务
+ * @details 按页拆分写入，每块在上一块的完成回调中提交，块之间的写周期由总线的 ACK 轮询处理。
+ */
+static struct
+{
+    volatile bool busy;       ///< 是否有写任务在进行
+    uint16_t addr;            ///< 下一块的起始地址
+    uint8_t *data;            ///< 下一块的数据指针
+    uint16_t remaining;       ///< 剩余字节数
+    I2C_Bus_Callback_t cb;    ///< 整个任务完成后的回调
+    void *ctx;                ///< 回调上下文
+} at24c32_job;
+
+static volatile uint32_t write_count; ///< 启动以来成功的页写入次数
+
+/* Private function prototypes -----------------------------------------------*/
+static HAL_StatusTypeDef at24c32_xfer(I2C_Bus_Op_e op, uint16_t mem_addr, uint8_t *data, uint16_t size);
+static uint16_t at24c32_chunk_size(uint16_t mem_addr, uint16_t remaining);
+static void at24c32_job_finish(HAL_StatusTypeDef status);
+static HAL_StatusTypeDef at24c32_job_submit(void);
+static void at24c32_job_cb(HAL_StatusTypeDef status, void *ctx);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 通过总线队列执行一次阻塞的存储器读写
+ * @param[in] op I2C_BUS_OP_MEM_WRITE 或 I2C_BUS_OP_MEM_READ
+ * @param[in] mem_addr 存储器地址
+ * @param[in,out] data 数据缓冲区
+ * @param[in] size 数据长度
+ * @return HAL_StatusTypeDef 事务结果
+ */
+static HAL_StatusTypeDef at24c32_xfer(I2C_Bus_Op_e op, uint16_t mem_addr, uint8_t *data, uint16_t size)
+{
+    I2C_Bus_Txn_t txn = {
+        .op = op,
+        .dev_addr = AT24C32_ADDRESS,
+        .mem_addr = mem_addr,
+        .mem_addr_size = I2C_MEMADD_SIZE_16BIT, // AT24C32的内存地址是16位的
+        .data = data,
+        .size = size,
+        // 写入后需要等待内部写周期，期间总线可以继续服务其他设备
+        .hold_ms = (op == I2C_BUS_OP_MEM_WRITE) ? AT24C32_WRITE_CYCLE_MS : 0,
+    };
+
+    HAL_StatusTypeDef status = I2C_Bus_Transfer(&txn, I2C_BUS_PRIO_STORAGE, AT24C32_I2C_TIMEOUT);
+
+    if (status == HAL_OK && op == I2C_BUS_OP_MEM_WRITE) {
+        PROF_COUNT(PROF_CNT_EEPROM_WRITE);
+        write_count++;
+    }
+    return status;
+}
+
+/**
+ * @brief 计算从指定地址开始、不跨页的最大写入长度
+ * @param[in] mem_addr 起始地址
+ * @param[in] remaining 剩余字节数
+ * @return uint16_t 本块的字节数
+ */
+static uint16_t at24c32_chunk_size(uint16_t mem_addr, uint16_t remaining)
+{
+    uint16_t bytes_to_page_end = AT24C32_PAGE_SIZE - (mem_addr % AT24C32_PAGE_SIZE);
+    return (remaining < bytes_to_page_end) ? remaining : bytes_to_page_end;
+}
+
+/**
+ * @brief 结束异步写任务并通知发起者
+ * @param[in] status 任务结果
+ * @return 无
+ */
+static void at24c32_job_finish(HAL_StatusTypeDef status)
+{
+    I2C_Bus_Callback_t cb = at24c32_job.cb;
+    void *ctx = at24c32_job.ctx;
+
+    at24c32_job.busy = false;
+    if (cb != NULL) {
+        cb(status, ctx);
+    }
+}
+
+/**
+ * @brief 提交异步写任务的下一块
+ * @return HAL_StatusTypeDef I2C_Bus_Submit 的结果
+ */
+static HAL_StatusTypeDef at24c32_job_submit(void)
+{
+    uint16_t chunk = at24c32_chunk_size(at24c32_job.addr, at24c32_job.remaining);
+    I2C_Bus_Txn_t txn = {
+        .op = I2C_BUS_OP_MEM_WRITE,
+        .dev_addr = AT24C32_ADDRESS,
+        .mem_addr = at24c32_job.addr,
+        .mem_addr_size = I2C_MEMADD_SIZE_16BIT,
+        .data = at24c32_job.data,
+        .size = chunk,
+        .hold_ms = AT24C32_WRITE_CYCLE_MS,
+        .cb = at24c32_job_cb,
+    };
+    HAL_StatusTypeDef status = I2C_Bus_Submit(&txn, I2C_BUS_PRIO_STORAGE);
+
+    if (status == HAL_OK) {
+        at24c32_job.addr += chunk;
+        at24c32_job.data += chunk;
+        at24c32_job.remaining -= chunk;
+    }
+    return status;
+}
+
+/**
+ * @brief 异步写任务中每一块的完成回调 (I2C中断上下文)
+ * @param[in] status 事务结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void at24c32_job_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+
+    if (status == HAL_OK) {
+        PROF_COUNT(PROF_CNT_EEPROM_WRITE);
+        write_count++;
+    }
+    if (status != HAL_OK || at24c32_job.remaining == 0) {
+        at24c32_job_finish(status);
+        return;
+    }
+    status = at24c32_job_submit();
+    if (status != HAL_OK) {
+        at24c32_job_finish(status); // 队列已满，放弃剩余部分，由发起者决定是否重试
+    }
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 在AT24C32 EEPROM指定地址写入一个字节
+ * @param[in] mem_addr 内存地址 (0x0000 - 0x0FFF)
+ * @param[in] data 要写入的数据字节
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef AT24C32_WriteByte(uint16_t mem_addr, uint8_t data)
+{
+    // 写周期由总线队列推迟后续访问，这里无需延时
+    return at24c32_xfer(I2C_BUS_OP_MEM_WRITE, mem_addr, &data, 1);
+}
+
+/**
+ * @brief 从AT24C32 EEPROM指定地址读取一个字节
+ * @param[in] mem_addr 内存地址 (0x0000 - 0x0FFF)
+ * @return uint8_t 读取到的数据字节
+ */
+uint8_t AT24C32_ReadByte(uint16_t mem_addr)
+{
+    uint8_t data = 0;
+    at24c32_xfer(I2C_BUS_OP_MEM_READ, mem_addr, &data, 1);
+    return data;
+}
+
+/**
+ * @brief 向AT24C32 EEPROM写入一页数据
+ * @details 实现了跨页写入的逻辑。如果写入数据超过一页的边界，会自动分块写入。
+ * @param[in] mem_addr 起始内存地址 (0x0000 - 0x0FFF)
+ * @param[in] data 要写入的数据指针
+ * @param[in] size 数据大小
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef AT24C32_WritePage(uint16_t mem_addr, uint8_t *data, uint16_t size)
+{
+    HAL_StatusTypeDef status = HAL_OK;
+    
+    uint16_t bytes_remaining = size;
+    uint16_t current_addr = mem_addr;
+    uint8_t *data_ptr = data;
+
+    // 循环写入，直到所有字节都写入完毕
+    while (bytes_remaining > 0)
+    {
+        // 1~2. 计算本次实际要写入的字节数：取“剩余字节数”和“到页末尾的字节数”中的较小值
+        uint16_t chunk_size = at24c32_chunk_size(current_addr, bytes_remaining);
+
+        // 3. 执行单页内的写入操作
+        status = at24c32_xfer(I2C_BUS_OP_MEM_WRITE, current_addr, data_ptr, chunk_size);
+        
+        // 4. 如果任何一次写入失败，立即中止并返回错误
+        if (status != HAL_OK) {
+            return status;
+        }
+
+        // 5. EEPROM内部写周期由总线队列保证：下一块的写入会等到设备重新应答后才启动，
+        //    期间显示刷新等其他事务照常进行
+
+        // 6. 更新变量，为下一次循环做准备
+        bytes_remaining -= chunk_size;
+        current_addr += chunk_size;
+        data_ptr += chunk_size;
+    }
+
+    return HAL_OK;
+}
+
+
+/**
+ * @brief 从AT24C32 EEPROM读取一段数据
+ * @param[in] mem_addr 起始内存地址 (0x0000 - 0x0FFF)
+ * @param[out] data 数据存储缓冲区指针
+ * @param[in] size 要读取的数据大小
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef AT24C32_ReadPage(uint16_t mem_addr, uint8_t *data, uint16_t size)
+{
+    return at24c32_xfer(I2C_BUS_OP_MEM_READ, mem_addr, data, size);
+}
+
+/**
+ * @brief 启动一个异步EEPROM写任务
+ * @param[in] mem_addr 起始内存地址 (0x0000 - 0x0FFF)
+ * @param[in] data 要写入的数据指针
+ * @param[in] size 数据大小
+ * @param[in] cb 完成回调
+ * @param[in] ctx 回调上下文
+ * @return HAL_StatusTypeDef 任务已启动返回 HAL_OK，已有任务在进行或队列已满返回 HAL_BUSY
+ */
+HAL_StatusTypeDef AT24C32_WritePage_Async(uint16_t mem_addr, uint8_t *data, uint16_t size,
+                                          I2C_Bus_Callback_t cb, void *ctx)
+{
+    HAL_StatusTypeDef status;
+
+    if (data == NULL || size == 0) {
+        return HAL_ERROR;
+    }
+    if (at24c32_job.busy) {
+        return HAL_BUSY;
+    }
+
+    at24c32_job.addr = mem_addr;
+    at24c32_job.data = data;
+    at24c32_job.remaining = size;
+    at24c32_job.cb = cb;
+    at24c32_job.ctx = ctx;
+    at24c32_job.busy = true;
+
+    status = at24c32_job_submit();
+    if (status != HAL_OK) {
+        at24c32_job.busy = false;
+    }
+    return status;
+}
+
+/**
+ * @brief 启动一个异步EEPROM读操作
+ * @param[in] mem_addr 起始内存地址 (0x0000 - 0x0FFF)
+ * @param[out] data 数据存储缓冲区指针
+ * @param[in] size 要读取的数据大小
+ * @param[in] cb 完成回调
+ * @param[in] ctx 回调上下文
+ * @return HAL_StatusTypeDef I2C_Bus_Submit 的结果
+ */
+HAL_StatusTypeDef AT24C32_ReadPage_Async(uint16_t mem_addr, uint8_t *data, uint16_t size,
+                                         I2C_Bus_Callback_t cb, void *ctx)
+{
+    I2C_Bus_Txn_t txn = {
+        .op = I2C_BUS_OP_MEM_READ,
+        .dev_addr = AT24C32_ADDRESS,
+        .mem_addr = mem_addr,
+        .mem_addr_size = I2C_MEMADD_SIZE_16BIT,
+        .data = data,
+        .size = size,
+        .cb = cb,
+        .ctx = ctx,
+    };
+
+    return I2C_Bus_Submit(&txn, I2C_BUS_PRIO_STORAGE);
+}
+
+/**
+ * @brief 查询异步写任务是否在进行
+ * @return bool 有写任务在进行时返回 true
+ */
+bool AT24C32_Is_Busy(void)
+{
+    return at24c32_job.busy;
+}
+
+/**
+ * @brief 获取启动以来成功的页写入次数
+ * @return uint32_t 页写入次数
+ */
+uint32_t AT24C32_Get_Write_Count(void)
+{
+    return write_count;
+}
+
+/**
+ * @brief 掉电前的紧急单页写入
+ * @param[in] mem_addr 起始内存地址
+ * @param[in] data 数据
+ * @param[in] size 数据大小
+ * @return HAL_StatusTypeDef 写入成功返回 HAL_OK
+ */
+HAL_StatusTypeDef AT24C32_WritePage_Emergency(uint16_t mem_addr, const uint8_t *data, uint16_t size)
+{
+    if (data == NULL || size == 0 || size > AT24C32_PAGE_SIZE ||
+        (mem_addr % AT24C32_PAGE_SIZE) + size > AT24C32_PAGE_SIZE) {
+        return HAL_ERROR;
+    }
+    return I2C_Bus_Emergency_Write(AT24C32_ADDRESS, mem_addr, I2C_MEMADD_SIZE_16BIT, data, size,
+                                   AT24C32_EMERGENCY_TIMEOUT_US);
+}
+
+/** @} */
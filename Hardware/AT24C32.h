@@ -0,0 +1,137 @@
+/**
+ * @file      AT24C32.h
+ * @brief     AT24C32 EEPROM 驱动头文件
+ * @details   DS3231 模块上附带的 4KB EEPROM，与 RTC 是两个独立的 I2C 设备，本驱动不依赖 DS3231 驱动的初始化。
+ *            所有访问都经由 i2c_bus 的事务队列 (EEPROM 优先级)，写入后总线按 AT24C32_WRITE_CYCLE_MS 推迟
+ *            发往本设备的事务并用 ACK 轮询提前结束写周期，期间 RTC、传感器和显示的事务照常进行。
+ *            异步写任务按页拆分，启动后可用 AT24C32_Is_Busy() 查询，也可以等待完成回调。
+ * @author    SandOcean
+ * @date      2025-10-06
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __AT24C32_H
+#define __AT24C32_H
+
+#include "main.h"
+#include "i2c_bus.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup AT24C32_Driver AT24C32 EEPROM 驱动
+ * @brief 提供了阻塞和异步的 EEPROM 读写。
+ * @{
+ */
+
+/**
+ * @defgroup AT24C32_Config AT24C32 配置参数
+ * @{
+ */
+#define AT24C32_ADDRESS        (0x57 << 1) ///< AT24C32 I2C设备地址 (7位地址左移一位)
+#define AT24C32_PAGE_SIZE      32          ///< 页大小 (字节)，一次写入不能跨页
+#define AT24C32_WRITE_CYCLE_MS 5           ///< 内部写周期的最大值 (ms)，总线会用 ACK 轮询提前结束
+#define AT24C32_I2C_TIMEOUT    1000        ///< 阻塞传输的超时时间 (ms)
+#define AT24C32_EMERGENCY_TIMEOUT_US 8000  ///< 紧急写入的时间上限 (us)，含等待上一次写周期结束
+/** @} */
+
+/**
+ * @defgroup AT24C32_Functions AT24C32 EEPROM 读写函数
+ * @{
+ */
+
+/**
+ * @brief 在AT24C32 EEPROM指定地址写入一个字节
+ * @param[in] mem_addr 内存地址 (0x0000 - 0x0FFF)
+ * @param[in] data 要写入的数据字节
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef AT24C32_WriteByte(uint16_t mem_addr, uint8_t data);
+
+/**
+ * @brief 从AT24C32 EEPROM指定地址读取一个字节
+ * @param[in] mem_addr 内存地址 (0x0000 - 0x0FFF)
+ * @return uint8_t 读取到的数据字节
+ */
+uint8_t AT24C32_ReadByte(uint16_t mem_addr);
+
+/**
+ * @brief 向AT24C32 EEPROM写入一页数据
+ * @param[in] mem_addr 起始内存地址 (0x0000 - 0x0FFF)
+ * @param[in] data 要写入的数据指针
+ * @param[in] size 数据大小，最大32字节
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ * @note 单次写入不能超过32字节且不能跨页 (e.g. from 0x1F to 0x20)。
+ */
+HAL_StatusTypeDef AT24C32_WritePage(uint16_t mem_addr, uint8_t *data, uint16_t size);
+
+/**
+ * @brief 从AT24C32 EEPROM读取一段数据
+ * @param[in] mem_addr 起始内存地址 (0x0000 - 0x0FFF)
+ * @param[out] data 数据存储缓冲区指针
+ * @param[in] size 要读取的数据大小
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef AT24C32_ReadPage(uint16_t mem_addr, uint8_t *data, uint16_t size);
+
+/**
+ * @brief 启动一个异步EEPROM写任务
+ * @details 数据按页拆分，逐块通过总线队列写入，函数立即返回。每块写完后总线用 ACK 轮询
+ *          等待写周期结束再提交下一块，期间显示刷新等其他事务照常进行。
+ *          同一时间只支持一个写任务。
+ * @param[in] mem_addr 起始内存地址 (0x0000 - 0x0FFF)
+ * @param[in] data 要写入的数据指针，必须保持有效直到回调被调用
+ * @param[in] size 数据大小，可以跨页
+ * @param[in] cb 全部写完或出错时的回调 (I2C中断上下文)，可为NULL
+ * @param[in] ctx 回调上下文
+ * @return HAL_StatusTypeDef
+ *         - @retval HAL_OK 任务已启动
+ *         - @retval HAL_BUSY 已有写任务在进行或总线队列已满
+ *         - @retval HAL_ERROR 参数错误
+ */
+HAL_StatusTypeDef AT24C32_WritePage_Async(uint16_t mem_addr, uint8_t *data, uint16_t size,
+                                          I2C_Bus_Callback_t cb, void *ctx);
+
+/**
+ * @brief 启动一个异步EEPROM读操作
+ * @param[in] mem_addr 起始内存地址 (0x0000 - 0x0FFF)
+ * @param[out] data 数据存储缓冲区指针，必须保持有效直到回调被调用
+ * @param[in] size 要读取的数据大小
+ * @param[in] cb 完成回调 (I2C中断上下文)，可为NULL
+ * @param[in] ctx 回调上下文
+ * @return HAL_StatusTypeDef 已加入总线队列返回 HAL_OK
+ */
+HAL_StatusTypeDef AT24C32_ReadPage_Async(uint16_t mem_addr, uint8_t *data, uint16_t size,
+                                         I2C_Bus_Callback_t cb, void *ctx);
+
+/**
+ * @brief 查询异步写任务是否在进行
+ * @details 与完成回调二选一：不方便在中断上下文中处理结果的发起者可以在主循环中轮询。
+ * @return bool 有写任务在进行时返回 true
+ */
+bool AT24C32_Is_Busy(void);
+
+/**
+ * @brief 获取启动以来成功的页写入次数
+ * @details 同步和异步写入的每一块 (每一个内部写周期) 各计一次，紧急写入不计入。
+ * @return uint32_t 页写入次数
+ */
+uint32_t AT24C32_Get_Write_Count(void);
+
+/**
+ * @brief 掉电前的紧急单页写入 (阻塞，可在中断中调用)
+ * @details 经 I2C_Bus_Emergency_Write 接管总线并轮询完成，不经过事务队列，不等待进行中的异步写任务
+ *          (该任务被中止，不再回调)。之后该总线不再调度，只应在即将掉电时使用。
+ * @param[in] mem_addr 起始内存地址，数据不能跨页
+ * @param[in] data 数据
+ * @param[in] size 数据大小 (不超过 AT24C32_PAGE_SIZE)
+ * @return HAL_StatusTypeDef 写入成功返回 HAL_OK (芯片的内部写周期在返回后进行，约 5ms)
+ */
+HAL_StatusTypeDef AT24C32_WritePage_Emergency(uint16_t mem_addr, const uint8_t *data, uint16_t size);
+
+/** @} */
+
+/** @} */
+
+#endif /* __AT24C32_H */
@@ -0,0 +1,458 @@
+/**
+ * @file      BMP280.c
+ * @brief     气压传感器BMP280/BME280驱动文件
+ * @details   初始化 (读取芯片 ID 和补偿参数) 和测量顺序写在同一个协程 (pt.h) 中，由 BMP280_Poll 推进，
+ *            每次总线等待和转换等待都让出，与 AHT20 驱动的结构相同。
+ *            补偿参数在初始化时一次读出 (24字节)，每次测量只有一个写事务 (启动转换) 和一个读事务。
+ *            补偿公式取自数据手册的 32 位定点版本：温度得到 t_fine 和 0.01℃，气压直接得到 Pa，
+ *            其中除法只有一次 32 位无符号除法 (Cortex-M3 的 UDIV)，不链接软件浮点库。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "BMP280.h"
+
+#if BMP280_ENABLE
+
+#include "i2c_bus.h"
+#include "profiler.h"
+#include "pt.h"
+#include "seqlock.h"
+
+/**
+ * @addtogroup BMP280_Driver
+ * @{
+ */
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 补偿参数 (数据手册中的 dig_T1 ~ dig_P9)
+ */
+typedef struct
+{
+    uint16_t t1;
+    int16_t t2;
+    int16_t t3;
+    uint16_t p1;
+    int16_t p2;
+    int16_t p3;
+    int16_t p4;
+    int16_t p5;
+    int16_t p6;
+    int16_t p7;
+    int16_t p8;
+    int16_t p9;
+} BMP280_Calib_t;
+
+/**
+ * @brief 初始化的阶段
+ */
+typedef enum
+{
+    BMP280_INIT_NONE = 0,   ///< 未调用初始化
+    BMP280_INIT_RUNNING,    ///< 非阻塞初始化在协程中进行
+    BMP280_INIT_READY,      ///< 可以测量
+    BMP280_INIT_FAILED      ///< 传感器无应答或芯片 ID 不符
+} BMP280_Init_Stage_e;
+
+/* Private variables ---------------------------------------------------------*/
+static I2C_HandleTypeDef *g_bmp280_hi2c = NULL; ///< I2C句柄，同时作为驱动已初始化的标志
+static BMP280_Calib_t g_bmp280_calib;           ///< 补偿参数
+
+/**
+ * @brief 初始化的状态
+ */
+static struct
+{
+    volatile BMP280_Init_Stage_e stage;     ///< 当前阶段
+    uint8_t chip_id;                        ///< 读到的芯片 ID
+    uint8_t buf[BMP280_CALIB_SIZE];         ///< 芯片 ID / 补偿参数缓冲区
+} g_bmp280_init;
+
+/**
+ * @brief 非阻塞测量的状态
+ */
+static struct
+{
+    volatile bool measuring;        ///< 是否有测量正在进行 (已请求，尚未结束)
+    uint32_t start_time;            ///< 请求测量的时间戳
+    uint32_t next_poll;             ///< 下一次允许读取数据的时间戳
+    bool fresh;                     ///< 协程本次调用得到了新的测量结果
+    uint8_t ctrl;                   ///< ctrl_meas 缓冲区 (异步发送期间须保持有效)
+    uint8_t rx[BMP280_BURST_SIZE];  ///< 0xF3~0xFC 的连续读取结果
+} g_bmp280_meas;
+
+static BMP280_Data_t g_bmp280_last;   ///< 最近一次测量结果的缓存
+static Seqlock_t g_bmp280_last_lock;  ///< g_bmp280_last 的顺序锁
+
+/**
+ * @brief 协程当前等待的总线事务
+ */
+static struct
+{
+    I2C_Bus_Op_e op;                        ///< I2C_BUS_OP_MEM_WRITE 或 I2C_BUS_OP_MEM_READ
+    uint8_t reg;                            ///< 起始寄存器地址
+    uint8_t *data;                          ///< 数据缓冲区 (事务期间须保持有效)
+    uint16_t size;                          ///< 数据长度
+    volatile bool busy;                     ///< 事务是否在总线队列中
+    volatile HAL_StatusTypeDef status;      ///< 事务结果，HAL_BUSY 表示队列已满、尚未提交
+} g_bmp280_xfer;
+
+static PT_t g_bmp280_pt; ///< 初始化和测量的协程
+
+/* Private function prototypes -----------------------------------------------*/
+static void BMP280_Parse_Calib(const uint8_t *raw);
+static int32_t BMP280_Compensate_T(int32_t adc_t, int32_t *t_fine);
+static uint32_t BMP280_Compensate_P(int32_t adc_p, int32_t t_fine);
+static void BMP280_Xfer_Cb(HAL_StatusTypeDef status, void *ctx);
+static void BMP280_Xfer_Submit(void);
+static void BMP280_Xfer_Start(I2C_Bus_Op_e op, uint8_t reg, uint8_t *data, uint16_t size);
+static bool BMP280_Xfer_Done(void);
+static uint8_t BMP280_Thread(void);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 解析补偿参数 (小端，依次为 dig_T1 ~ dig_P9)
+ * @param[in] raw 0x88 起的 24 字节
+ * @return 无
+ */
+static void BMP280_Parse_Calib(const uint8_t *raw)
+{
+    int16_t v[BMP280_CALIB_SIZE / 2];
+
+    for (uint8_t i = 0; i < BMP280_CALIB_SIZE / 2; i++) {
+        v[i] = (int16_t)((uint16_t)raw[2 * i] | ((uint16_t)raw[2 * i + 1] << 8));
+    }
+    g_bmp280_calib.t1 = (uint16_t)v[0];
+    g_bmp280_calib.t2 = v[1];
+    g_bmp280_calib.t3 = v[2];
+    g_bmp280_calib.p1 = (uint16_t)v[3];
+    g_bmp280_calib.p2 = v[4];
+    g_bmp280_calib.p3 = v[5];
+    g_bmp280_calib.p4 = v[6];
+    g_bmp280_calib.p5 = v[7];
+    g_bmp280_calib.p6 = v[8];
+    g_bmp280_calib.p7 = v[9];
+    g_bmp280_calib.p8 = v[10];
+    g_bmp280_calib.p9 = v[11];
+}
+
+/**
+ * @brief 温度补偿 (数据手册 32 位定点公式)
+ * @param[in] adc_t 20 位温度原始值
+ * @param[out] t_fine 供气压补偿使用的精细温度
+ * @return int32_t 温度 (0.01℃)
+ */
+static int32_t BMP280_Compensate_T(int32_t adc_t, int32_t *t_fine)
+{
+    const BMP280_Calib_t *c = &g_bmp280_calib;
+    int32_t var1, var2;
+
+    var1 = ((((adc_t >> 3) - ((int32_t)c->t1 << 1))) * (int32_t)c->t2) >> 11;
+    var2 = (((((adc_t >> 4) - (int32_t)c->t1) * ((adc_t >> 4) - (int32_t)c->t1)) >> 12) * (int32_t)c->t3) >> 14;
+    *t_fine = var1 + var2;
+    return (*t_fine * 5 + 128) >> 8;
+}
+
+/**
+ * @brief 气压补偿 (数据手册 32 位定点公式)
+ * @details 中间值都在 32 位以内，只有一次无符号除法，结果的分辨率为 1 Pa。
+ * @param[in] adc_p 20 位气压原始值
+ * @param[in] t_fine BMP280_Compensate_T 得到的精细温度
+ * @return uint32_t 气压 (Pa)，补偿参数无效时返回 0
+ */
+static uint32_t BMP280_Compensate_P(int32_t adc_p, int32_t t_fine)
+{
+    const BMP280_Calib_t *c = &g_bmp280_calib;
+    int32_t var1, var2;
+    uint32_t p;
+
+    var1 = (t_fine >> 1) - 64000;
+    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * (int32_t)c->p6;
+    var2 = var2 + ((var1 * (int32_t)c->p5) << 1);
+    var2 = (var2 >> 2) + ((int32_t)c->p4 << 16);
+    var1 = ((((int32_t)c->p3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + (((int32_t)c->p2 * var1) >> 1)) >> 18;
+    var1 = ((32768 + var1) * (int32_t)c->p1) >> 15;
+    if (var1 == 0) {
+        return 0; // 避免除以零 (补偿参数全为零，传感器未正确读出)
+    }
+    p = ((uint32_t)(1048576 - adc_p) - (uint32_t)(var2 >> 12)) * 3125U;
+    if (p < 0x80000000U) {
+        p = (p << 1) / (uint32_t)var1;
+    } else {
+        p = (p / (uint32_t)var1) * 2U;
+    }
+    var1 = ((int32_t)c->p9 * (int32_t)(((p >> 3) * (p >> 3)) >> 13)) >> 12;
+    var2 = ((int32_t)(p >> 2) * (int32_t)c->p8) >> 13;
+    return (uint32_t)((int32_t)p + ((var1 + var2 + c->p7) >> 4));
+}
+
+/**
+ * @brief 协程中总线事务的完成回调 (I2C中断上下文)
+ * @param[in] status 事务结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void BMP280_Xfer_Cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+    g_bmp280_xfer.status = status;
+    g_bmp280_xfer.busy = false;
+}
+
+/**
+ * @brief 把 g_bmp280_xfer 描述的事务提交到总线队列
+ * @return 无
+ */
+static void BMP280_Xfer_Submit(void)
+{
+    I2C_Bus_Txn_t txn = {
+        .op = g_bmp280_xfer.op,
+        .dev_addr = BMP280_ADDRESS,
+        .mem_addr = g_bmp280_xfer.reg,
+        .mem_addr_size = I2C_MEMADD_SIZE_8BIT,
+        .data = g_bmp280_xfer.data,
+        .size = g_bmp280_xfer.size,
+        .cb = BMP280_Xfer_Cb,
+    };
+
+    // 先置位再提交, 回调可能在提交返回之前就已执行
+    g_bmp280_xfer.busy = true;
+    if (I2C_Bus_Submit(&txn, I2C_BUS_PRIO_SENSOR) != HAL_OK) {
+        g_bmp280_xfer.status = HAL_BUSY; // 队列已满，由 BMP280_Xfer_Done() 重试
+        g_bmp280_xfer.busy = false;
+    }
+}
+
+/**
+ * @brief 开始协程中的一个总线事务
+ * @param[in] op I2C_BUS_OP_MEM_WRITE 或 I2C_BUS_OP_MEM_READ
+ * @param[in] reg 起始寄存器地址
+ * @param[in] data 数据缓冲区 (静态变量)
+ * @param[in] size 数据长度
+ * @return 无
+ */
+static void BMP280_Xfer_Start(I2C_Bus_Op_e op, uint8_t reg, uint8_t *data, uint16_t size)
+{
+    g_bmp280_xfer.op = op;
+    g_bmp280_xfer.reg = reg;
+    g_bmp280_xfer.data = data;
+    g_bmp280_xfer.size = size;
+    BMP280_Xfer_Submit();
+}
+
+/**
+ * @brief 协程的等待条件：当前事务是否已结束
+ * @details 提交时队列已满的事务在这里重新提交，每次调用最多重试一次。
+ * @return bool 已结束 (结果在 g_bmp280_xfer.status 中) 返回 true
+ */
+static bool BMP280_Xfer_Done(void)
+{
+    if (g_bmp280_xfer.busy) {
+        return false;
+    }
+    if (g_bmp280_xfer.status == HAL_BUSY) {
+        BMP280_Xfer_Submit();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 初始化和测量的协程
+ * @details 初始化读取芯片 ID (BMP280 或 BME280) 和补偿参数，BME280 关闭湿度通道。之后进入测量循环：
+ *          等待 BMP280_StartMeasurement() 的请求，写 ctrl_meas 启动一次强制模式转换，等待转换时间后
+ *          从 0xF3 连续读出 10 字节；状态仍为转换中或模式位尚未回到睡眠时每隔 BMP280_POLL_INTERVAL_MS 再读。
+ *          读取失败或等待超过 BMP280_MEASURE_TIMEOUT 时放弃本次测量, 缓存保持上一次的结果。
+ * @return uint8_t PT_WAITING 等协程返回值
+ */
+static uint8_t BMP280_Thread(void)
+{
+    PT_t *pt = &g_bmp280_pt;
+
+    PT_BEGIN(pt);
+
+    // 1. 上电时间从复位算起，之后读取芯片 ID
+    PT_WAIT_TICK(pt, BMP280_POWER_UP_MS);
+    BMP280_Xfer_Start(I2C_BUS_OP_MEM_READ, BMP280_REG_ID, g_bmp280_init.buf, 1);
+    PT_WAIT_UNTIL(pt, BMP280_Xfer_Done());
+    g_bmp280_init.chip_id = g_bmp280_init.buf[0];
+    if (g_bmp280_xfer.status != HAL_OK ||
+        (g_bmp280_init.chip_id != BMP280_CHIP_ID && g_bmp280_init.chip_id != BME280_CHIP_ID)) {
+        g_bmp280_init.stage = BMP280_INIT_FAILED;
+        PT_EXIT(pt);
+    }
+
+    // 2. 一次读出全部补偿参数
+    BMP280_Xfer_Start(I2C_BUS_OP_MEM_READ, BMP280_REG_CALIB, g_bmp280_init.buf, BMP280_CALIB_SIZE);
+    PT_WAIT_UNTIL(pt, BMP280_Xfer_Done());
+    if (g_bmp280_xfer.status != HAL_OK) {
+        g_bmp280_init.stage = BMP280_INIT_FAILED;
+        PT_EXIT(pt);
+    }
+    BMP280_Parse_Calib(g_bmp280_init.buf);
+
+    // 3. BME280 跳过湿度转换 (复位值即为跳过，这里写明以防模块被其他程序配置过)
+    if (g_bmp280_init.chip_id == BME280_CHIP_ID) {
+        g_bmp280_init.buf[0] = 0x00;
+        BMP280_Xfer_Start(I2C_BUS_OP_MEM_WRITE, BMP280_REG_CTRL_HUM, g_bmp280_init.buf, 1);
+        PT_WAIT_UNTIL(pt, BMP280_Xfer_Done());
+    }
+    g_bmp280_init.stage = BMP280_INIT_READY;
+
+    for (;;) {
+        PT_WAIT_UNTIL(pt, g_bmp280_meas.measuring);
+
+        // 1. 启动一次强制模式转换
+        g_bmp280_meas.ctrl = (uint8_t)((BMP280_OSRS_T << 5) | (BMP280_OSRS_P << 2) | BMP280_MODE_FORCED);
+        BMP280_Xfer_Start(I2C_BUS_OP_MEM_WRITE, BMP280_REG_CTRL_MEAS, &g_bmp280_meas.ctrl, 1);
+        PT_WAIT_UNTIL(pt, BMP280_Xfer_Done());
+        if (g_bmp280_xfer.status != HAL_OK) {
+            g_bmp280_meas.measuring = false;
+            continue;
+        }
+
+        // 2. 等待转换完成，状态与测量值一次读出，仍在转换时稍后再读
+        g_bmp280_meas.next_poll = g_bmp280_meas.start_time + BMP280_MEASURE_TIME_MS;
+        for (;;) {
+            PT_WAIT_TICK(pt, g_bmp280_meas.next_poll);
+            PROF_BEGIN(PROF_SEC_SENSOR_READ);
+            BMP280_Xfer_Start(I2C_BUS_OP_MEM_READ, BMP280_REG_STATUS, g_bmp280_meas.rx, BMP280_BURST_SIZE);
+            PT_WAIT_UNTIL(pt, BMP280_Xfer_Done());
+            PROF_END(PROF_SEC_SENSOR_READ);
+            if (g_bmp280_xfer.status != HAL_OK ||
+                ((g_bmp280_meas.rx[0] & BMP280_STATUS_MEASURING) == 0 &&
+                 (g_bmp280_meas.rx[1] & BMP280_MODE_MASK) == 0) ||
+                HAL_GetTick() - g_bmp280_meas.start_time > BMP280_MEASURE_TIMEOUT) {
+                break; // 读取失败、转换完成或传感器无响应
+            }
+            g_bmp280_meas.next_poll = HAL_GetTick() + BMP280_POLL_INTERVAL_MS;
+        }
+
+        // 3. 补偿 (rx[4..6] 为气压，rx[7..9] 为温度，各 20 位)
+        if (g_bmp280_xfer.status == HAL_OK && (g_bmp280_meas.rx[1] & BMP280_MODE_MASK) == 0) {
+            const uint8_t *d = g_bmp280_meas.rx;
+            int32_t adc_p = (int32_t)(((uint32_t)d[4] << 12) | ((uint32_t)d[5] << 4) | (d[6] >> 4));
+            int32_t adc_t = (int32_t)(((uint32_t)d[7] << 12) | ((uint32_t)d[8] << 4) | (d[9] >> 4));
+            int32_t t_fine;
+            int32_t t = BMP280_Compensate_T(adc_t, &t_fine);
+            uint32_t p = BMP280_Compensate_P(adc_p, t_fine);
+
+            if (p != 0) {
+                Seqlock_Write_Begin(&g_bmp280_last_lock);
+                g_bmp280_last.pressure_pa = p;
+                g_bmp280_last.temperature_cdeg = (int16_t)t;
+                g_bmp280_last.timestamp = HAL_GetTick();
+                g_bmp280_last.valid = true;
+                Seqlock_Write_End(&g_bmp280_last_lock);
+                g_bmp280_meas.fresh = true;
+            }
+        }
+        g_bmp280_meas.measuring = false;
+    }
+
+    PT_END(pt);
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 开始非阻塞初始化
+ * @param[in] hi2c 指向目标I2C外设的HAL句柄指针
+ * @return 无
+ */
+void BMP280_Begin(I2C_HandleTypeDef *hi2c)
+{
+    g_bmp280_hi2c = hi2c;
+    g_bmp280_init.stage = BMP280_INIT_RUNNING;
+    g_bmp280_xfer.busy = false;
+    PT_INIT(&g_bmp280_pt);
+}
+
+/**
+ * @brief 查询传感器是否已完成初始化
+ * @return bool 可以开始测量返回 true
+ */
+bool BMP280_Is_Ready(void)
+{
+    return g_bmp280_init.stage == BMP280_INIT_READY;
+}
+
+/**
+ * @brief 请求一次非阻塞测量
+ * @return HAL_StatusTypeDef HAL状态码
+ *         - @retval HAL_OK 已请求
+ *         - @retval HAL_BUSY 上一次测量尚未完成，或初始化尚未完成
+ *         - @retval HAL_ERROR 未初始化，或传感器无应答
+ */
+HAL_StatusTypeDef BMP280_StartMeasurement(void)
+{
+    if (g_bmp280_hi2c == NULL || g_bmp280_init.stage == BMP280_INIT_FAILED) {
+        return HAL_ERROR;
+    }
+    if (g_bmp280_meas.measuring || g_bmp280_init.stage != BMP280_INIT_READY) {
+        return HAL_BUSY;
+    }
+
+    g_bmp280_meas.start_time = HAL_GetTick();
+    g_bmp280_meas.measuring = true;
+    return HAL_OK;
+}
+
+/**
+ * @brief 推进非阻塞初始化和测量
+ * @return bool 本次调用是否得到了新的测量结果
+ */
+bool BMP280_Poll(void)
+{
+    if (g_bmp280_init.stage == BMP280_INIT_NONE) {
+        return false;
+    }
+
+    g_bmp280_meas.fresh = false;
+    BMP280_Thread();
+    return g_bmp280_meas.fresh;
+}
+
+/**
+ * @brief 查询是否有测量正在进行
+ * @return bool 正在测量返回 true
+ */
+bool BMP280_Is_Measuring(void)
+{
+    return g_bmp280_meas.measuring;
+}
+
+/**
+ * @brief 获取最近一次测量结果的缓存
+ * @return const BMP280_Data_t* 指向缓存结果的指针
+ */
+const BMP280_Data_t *BMP280_Get_Last(void)
+{
+    return &g_bmp280_last;
+}
+
+/**
+ * @brief 拷贝最近一次测量结果的缓存
+ * @param[out] out 测量结果
+ * @return bool 已经有过一次成功的测量返回 true
+ */
+bool BMP280_Read_Last(BMP280_Data_t *out)
+{
+    uint32_t seq;
+
+    do {
+        seq = Seqlock_Read_Begin(&g_bmp280_last_lock);
+        *out = g_bmp280_last;
+    } while (Seqlock_Read_Retry(&g_bmp280_last_lock, seq));
+    return out->valid;
+}
+
+/**
+ * @}
+ */
+
+#endif /* BMP280_ENABLE */
@@ -0,0 +1,131 @@
+/**
+ * @file      BMP280.h
+ * @brief     气压传感器BMP280/BME280驱动头文件
+ * @details   传感器与 AHT20、DS3231 共用 I2C1，只用强制模式 (forced mode)：每次测量写一次 ctrl_meas 启动单次转换，
+ *            转换结束后传感器自动回到睡眠模式，两次测量之间不耗电，也不占用总线。
+ *            转换时间到后用一个事务从状态寄存器 (0xF3) 连续读到温度数据的末尾 (0xFC)，
+ *            状态、气压和温度属于同一次转换。补偿按数据手册的 32 位定点公式计算，只用整数运算。
+ *            BME280 的湿度通道不启用 (湿度由 AHT20 测量)。测量流程与 AHT20 相同：BMP280_StartMeasurement() 请求，
+ *            主循环反复调用 BMP280_Poll() 推进，结果以顺序锁缓存。
+ *            每次测量在总线上约 16 字节 (400kHz 下不到 0.5ms)，按分钟采样时相对显示刷新可以忽略。
+ *            BMP280_ENABLE 为 0 (默认，板上没有气压传感器) 时本驱动不参与编译。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __BMP280_H
+#define __BMP280_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "i2c.h"
+
+/**
+ * @defgroup BMP280_Driver BMP280气压传感器驱动
+ * @brief 强制模式单次测量、一次读出全部数据寄存器和 32 位整数补偿。
+ * @{
+ */
+
+/**
+ * @defgroup BMP280_Config BMP280 配置参数
+ * @{
+ */
+#ifndef BMP280_ENABLE
+#define BMP280_ENABLE          0          ///< 为 1 时启用气压传感器 (需要在 I2C1 上接 BMP280 或 BME280 模块)
+#endif
+#define BMP280_ADDRESS         (0x76 << 1) ///< I2C设备地址 (SDO 接地；接 VDDIO 时为 0x77)
+#define BMP280_I2C_TIMEOUT     20         ///< 单次I2C传输的超时时间 (ms, 含在总线队列中的等待)
+#define BMP280_POWER_UP_MS     2          ///< 上电后可以通信的时间 (从MCU复位算起)
+#define BMP280_OSRS_T          1          ///< 温度过采样设置 (1: x1，温度只用于补偿)
+#define BMP280_OSRS_P          3          ///< 气压过采样设置 (3: x4，分辨率约 0.5 Pa)
+#define BMP280_MEASURE_TIME_MS 14         ///< 强制模式转换的最长时间 (x1/x4 过采样时为 13.3ms)
+#define BMP280_POLL_INTERVAL_MS 2         ///< 转换未完成时再次读取的间隔
+#define BMP280_MEASURE_TIMEOUT 50         ///< 单次测量的最长等待时间, 超时后放弃
+/** @} */
+
+/**
+ * @defgroup BMP280_Registers BMP280 寄存器
+ * @{
+ */
+#define BMP280_REG_CALIB       0x88  ///< 温度和气压的补偿参数 (0x88~0x9F，24字节)
+#define BMP280_REG_ID          0xD0  ///< 芯片 ID
+#define BMP280_REG_CTRL_HUM    0xF2  ///< 湿度过采样 (仅 BME280，写入后须再写 ctrl_meas 才生效)
+#define BMP280_REG_STATUS      0xF3  ///< 状态，从这里连续读到 0xFC 为一次完整的结果
+#define BMP280_REG_CTRL_MEAS   0xF4  ///< 过采样和工作模式
+#define BMP280_CALIB_SIZE      24    ///< 补偿参数的字节数
+#define BMP280_BURST_SIZE      10    ///< 状态、ctrl_meas、config、保留字节和 6 字节测量值
+#define BMP280_CHIP_ID         0x58  ///< BMP280 的芯片 ID
+#define BME280_CHIP_ID         0x60  ///< BME280 的芯片 ID
+#define BMP280_STATUS_MEASURING 0x08 ///< 状态位：转换进行中
+#define BMP280_MODE_MASK       0x03  ///< ctrl_meas 的模式位，转换结束后回到 0 (睡眠)
+#define BMP280_MODE_FORCED     0x01  ///< 强制模式：单次转换
+/** @} */
+
+/**
+ * @brief BMP280 缓存的测量结果
+ */
+typedef struct
+{
+    uint32_t pressure_pa;     ///< 气压 (Pa)，未经海拔修正
+    int16_t temperature_cdeg; ///< 传感器的温度 (0.01℃)，受电路板发热影响，只用于补偿
+    uint32_t timestamp;       ///< 获得该结果时的系统时间戳 (ms)
+    bool valid;               ///< 是否已经有过一次成功的测量
+} BMP280_Data_t;
+
+/**
+ * @brief 开始非阻塞初始化
+ * @details 立即返回，读取芯片 ID 和补偿参数在之后的 BMP280_Poll() 调用中完成。
+ *          完成前 BMP280_StartMeasurement() 返回 HAL_BUSY。
+ * @param[in] hi2c 指向目标I2C外设的HAL句柄指针
+ * @return 无
+ */
+void BMP280_Begin(I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief 查询传感器是否已完成初始化
+ * @return bool 可以开始测量返回 true
+ */
+bool BMP280_Is_Ready(void);
+
+/**
+ * @brief 请求一次非阻塞测量
+ * @details 立即返回, 启动转换的写操作由下一次 BMP280_Poll() 发出, 之后需要周期性调用 BMP280_Poll()。
+ * @return HAL_StatusTypeDef HAL状态码, 上一次测量尚未完成或初始化尚未完成时返回 HAL_BUSY，
+ *         传感器无应答或芯片 ID 不符时返回 HAL_ERROR
+ */
+HAL_StatusTypeDef BMP280_StartMeasurement(void);
+
+/**
+ * @brief 推进非阻塞初始化和测量, 在主循环中调用
+ * @details 转换时间未到时直接返回; 到时后一次读出状态和测量值, 仍在转换时等待下一次调用。
+ * @return bool 本次调用是否得到了新的测量结果
+ */
+bool BMP280_Poll(void);
+
+/**
+ * @brief 查询是否有测量正在进行
+ * @return bool 正在测量返回 true
+ */
+bool BMP280_Is_Measuring(void);
+
+/**
+ * @brief 获取最近一次测量结果的缓存
+ * @note 返回的是缓存本身，只能在推进测量的主循环中读取；其他上下文使用 BMP280_Read_Last()。
+ * @return const BMP280_Data_t* 指向缓存结果的指针
+ */
+const BMP280_Data_t *BMP280_Get_Last(void);
+
+/**
+ * @brief 拷贝最近一次测量结果的缓存
+ * @details 以顺序锁读取，气压、温度和时间戳属于同一次测量。不可在打断 BMP280_Poll() 的中断中调用。
+ * @param[out] out 测量结果
+ * @return bool 已经有过一次成功的测量返回 true
+ */
+bool BMP280_Read_Last(BMP280_Data_t *out);
+
+/** @} */
+
+#endif /* __BMP280_H */
@@ -2,18 +2,25 @@
  * @file      DS3231.c
  * @brief     DS3231实时时钟芯片驱动实现
  * @details   本文件实现了DS3231实时时钟芯片的完整驱动功能，包括：
- *            - 时间设置和读取
+ *            - 时间设置和读取，以及对齐到秒边界的对时写入
+ *            - 由SQW 1Hz中断推进的RAM时间缓存，以及不关中断的一致快照
+ *            - 以片内RTC (rtc_lse) 为备用时间源：芯片同步后校准计数器，方波或芯片失效时由计数器推进缓存
  *            - 温度读取
+ *            - 全部寄存器的单事务快照读取
  *            - 编译时间自动设置
- *            - AT24C32 EEPROM读写操作
  * @author    Sandocean
- * @date      2025-08-25
- * @version   1.0
+ * @date      2025-10-08
+ * @version   1.3
  * @note      本驱动基于STM32 HAL库实现，支持I2C通信
  * @copyright Copyright (c) 2025 SandOcean
  */
 
 #include "DS3231.h"
+#include "i2c_bus.h"
+#include "rtc_lse.h"
+#include "profiler.h"
+#include "seqlock.h"
+#include "trace.h"
 
 /**
  * @addtogroup DS3231_Driver
@@ -21,11 +28,81 @@
  */
 
 /* Private variables ---------------------------------------------------------*/
+#define DS3231_I2C_TIMEOUT 1000 ///< 阻塞传输的超时时间 (ms)
+
 /**
- * @brief 用于保存I2C句柄的静态指针
- * @details 在 DS3231_Init 函数中被初始化，供模块内所有函数使用。
+ * @defgroup DS3231_Build_Time 编译时间
+ * @brief 从 __DATE__ ("Mmm dd yyyy"，日期不足两位时前面是空格) 和 __TIME__ ("hh:mm:ss") 中按位置取出的字段。
+ * @{
  */
-static I2C_HandleTypeDef *ds3231_i2c;
+#define BUILD_DIGIT(s, i) ((s)[i] - '0')
+#define BUILD_YEAR   (BUILD_DIGIT(__DATE__, 7) * 1000 + BUILD_DIGIT(__DATE__, 8) * 100 + \
+                      BUILD_DIGIT(__DATE__, 9) * 10 + BUILD_DIGIT(__DATE__, 10))
+#define BUILD_MONTH  ((__DATE__[0] == 'J') ? ((__DATE__[1] == 'a') ? 1 : ((__DATE__[2] == 'n') ? 6 : 7)) : \
+                      (__DATE__[0] == 'F') ? 2 :                                                       \
+                      (__DATE__[0] == 'M') ? ((__DATE__[2] == 'r') ? 3 : 5) :                          \
+                      (__DATE__[0] == 'A') ? ((__DATE__[1] == 'p') ? 4 : 8) :                          \
+                      (__DATE__[0] == 'S') ? 9 :                                                       \
+                      (__DATE__[0] == 'O') ? 10 :                                                      \
+                      (__DATE__[0] == 'N') ? 11 : 12)
+#define BUILD_DAY    (((__DATE__[4] == ' ') ? 0 : BUILD_DIGIT(__DATE__, 4) * 10) + BUILD_DIGIT(__DATE__, 5))
+#define BUILD_HOUR   (BUILD_DIGIT(__TIME__, 0) * 10 + BUILD_DIGIT(__TIME__, 1))
+#define BUILD_MINUTE (BUILD_DIGIT(__TIME__, 3) * 10 + BUILD_DIGIT(__TIME__, 4))
+#define BUILD_SECOND (BUILD_DIGIT(__TIME__, 6) * 10 + BUILD_DIGIT(__TIME__, 7))
+/** @} */
+
+/**
+ * @brief RAM中的时间缓存
+ * @details epoch 由 SQW 中断加一 (每分钟闹钟模式下推进到下一个整分)，32位读写是原子的，主循环中读取不需要关中断。
+ *          需要同时读取多个字段 (epoch 与 last_edge_ms 等) 时经 lock 读取：SQW 中断是写者，
+ *          主循环中的写者 (同步、切换闹钟模式) 在关中断期间写入。
+ */
+static struct
+{
+    Seqlock_t lock;                 ///< epoch、valid、ticks、last_edge_ms 的顺序锁
+    volatile Epoch_t epoch;         ///< 缓存的标准时间 (未应用夏令时) 的纪元秒
+    bool valid;                     ///< 缓存是否已经与芯片同步过
+    volatile uint32_t ticks;        ///< 收到的SQW脉冲总数
+    volatile uint32_t last_edge_ms; ///< 最近一次SQW脉冲的时间戳
+    uint32_t sync_ticks;            ///< 上次同步时的脉冲计数
+    uint32_t last_sync_ms;          ///< 上次同步的时间戳
+    volatile bool resync_busy;      ///< 异步重新同步的读事务是否在队列中
+    uint32_t resync_ticks;          ///< 提交重新同步时的脉冲计数
+    uint8_t resync_rx[7];           ///< 异步重新同步的接收缓冲区
+    volatile bool minute_mode;      ///< INT/SQW 引脚是否为每分钟闹钟中断
+    volatile bool alarm_pending;    ///< 收到闹钟脉冲，等待主循环清除标志并同步
+#if RTC_LSE_ENABLE
+    volatile bool lse_pending;      ///< 缓存刚与芯片同步，等待下一个脉冲时写入片内RTC
+    uint32_t lse_check_ticks;       ///< 上次用片内RTC核对缓存时的脉冲计数
+#endif
+} ds3231_cache;
+
+/**
+ * @brief 对时写入的状态
+ */
+typedef enum {
+    SYNC_IDLE = 0, ///< 没有待写入的时间
+    SYNC_ARMED,    ///< 等待秒边界 (due_ms) 到来
+    SYNC_WRITING,  ///< 写事务已提交
+    SYNC_DONE      ///< 写入结束，等待主循环清除 OSF 并调用对时回调
+} Sync_State_e;
+
+/**
+ * @brief 对时写入
+ * @details 状态由调用者 (主循环，关中断)、SysTick 中断和 I2C 中断依次推进，同一时刻只有一方修改。
+ */
+static struct
+{
+    volatile uint8_t state; ///< Sync_State_e
+    uint32_t due_ms;        ///< 写入的时刻，即 epoch 这一秒开始的 HAL_GetTick() 时间戳
+    Epoch_t epoch;          ///< 在 due_ms 开始的一秒
+    uint8_t tx[7];          ///< epoch 编码后的时间寄存器
+    uint8_t retries;        ///< 剩余的重写次数
+    bool started;           ///< 已经提交过写事务 (rtc_before 和 ref 已记录)
+    bool written;           ///< 至少有一次写入成功
+    Epoch_t rtc_before;     ///< 第一次写入前缓存的时间
+    Epoch_t ref;            ///< 第一次写入的时间
+} ds3231_sync;
 
 /* Private Function implementations ------------------------------------------*/
 
@@ -39,70 +116,352 @@ static uint8_t decToBcd(uint8_t val)
     return (uint8_t)((val / 10 * 16) + (val % 10));
 }
 
+/**
+ * @brief BCD码高4位对应的十位数值
+ */
+static const uint8_t bcd_tens[16] = {0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 110, 120, 130, 140, 150};
+
 /**
  * @brief BCD码转换为十进制数
+ * @details 查表代替除法和取模 (Cortex-M3 的除法需要多个周期)。
  * @param[in] val 待转换的BCD码
  * @return uint8_t 转换后的十进制数
  */
 static uint8_t bcdToDec(uint8_t val)
 {
-    return (int)((val / 16 * 10) + (val % 16));
+    return (uint8_t)(bcd_tens[val >> 4] + (val & 0x0F));
+}
+
+/**
+ * @brief 通过总线队列执行一次阻塞的寄存器读写
+ * @param[in] dev_addr 设备地址 (DS3231_ADDRESS)
+ * @param[in] op I2C_BUS_OP_MEM_WRITE 或 I2C_BUS_OP_MEM_READ
+ * @param[in] mem_addr 寄存器地址
+ * @param[in,out] data 数据缓冲区
+ * @param[in] size 数据长度
+ * @return HAL_StatusTypeDef 事务结果
+ */
+static HAL_StatusTypeDef ds3231_xfer(uint16_t dev_addr, I2C_Bus_Op_e op, uint16_t mem_addr, uint8_t *data, uint16_t size)
+{
+    I2C_Bus_Txn_t txn = {
+        .op = op,
+        .dev_addr = dev_addr,
+        .mem_addr = mem_addr,
+        .mem_addr_size = I2C_MEMADD_SIZE_8BIT,
+        .data = data,
+        .size = size,
+    };
+
+    return I2C_Bus_Transfer(&txn, I2C_BUS_PRIO_SENSOR, DS3231_I2C_TIMEOUT);
+}
+
+/**
+ * @brief 将 Time_t 转换为时间寄存器 (0x00-0x06) 的BCD数据
+ * @param[in] time 时间
+ * @param[out] tx_data 7字节寄存器数据
+ * @return 无
+ */
+static void encode_time(const Time_t *time, uint8_t *tx_data)
+{
+    tx_data[0] = decToBcd(time->second);
+    tx_data[1] = decToBcd(time->minute);
+    tx_data[2] = decToBcd(time->hour);
+    tx_data[3] = decToBcd(time->week);
+    tx_data[4] = decToBcd(time->day);
+    tx_data[5] = decToBcd(time->month);
+    tx_data[6] = decToBcd(time->year - 2000); // DS3231年份只存后两位
+}
+
+/**
+ * @brief 将时间寄存器 (0x00-0x06) 的BCD数据转换为 Time_t
+ * @param[in] rx_data 7字节寄存器数据
+ * @param[out] time 转换结果
+ * @return 无
+ */
+static void decode_time(const uint8_t *rx_data, Time_t *time)
+{
+    time->second = bcdToDec(rx_data[0] & 0x7F);
+    time->minute = bcdToDec(rx_data[1] & 0x7F);
+    time->hour   = bcdToDec(rx_data[2] & 0x3F); // 芯片工作在24小时制
+    time->week   = bcdToDec(rx_data[3] & 0x07);
+    time->day    = bcdToDec(rx_data[4] & 0x3F);
+    time->month  = bcdToDec(rx_data[5] & 0x1F); // bit7 为世纪位
+    time->year   = bcdToDec(rx_data[6]) + 2000;
+}
+
+/**
+ * @brief 将闹钟寄存器的BCD数据转换为 DS3231_Alarm_t
+ * @details 每个寄存器的 bit7 为屏蔽位，日期寄存器的 bit6 为 DY/DT 位。
+ * @param[in] rx_data 闹钟寄存器数据 (闹钟1从秒开始，闹钟2从分钟开始)
+ * @param[in] count 寄存器数 (闹钟1为4，闹钟2为3)
+ * @param[out] alarm 转换结果
+ * @return 无
+ */
+static void decode_alarm(const uint8_t *rx_data, uint8_t count, DS3231_Alarm_t *alarm)
+{
+    const uint8_t *r = rx_data + count - 3; // 分、时、日三个寄存器
+
+    alarm->second = (count == 4) ? bcdToDec(rx_data[0] & 0x7F) : 0;
+    alarm->minute = bcdToDec(r[0] & 0x7F);
+    alarm->hour = bcdToDec(r[1] & 0x3F);
+    alarm->day_is_week = (r[2] & 0x40) != 0;
+    alarm->day = bcdToDec(r[2] & (alarm->day_is_week ? 0x07 : 0x3F));
+    alarm->mask = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (rx_data[i] & 0x80) {
+            alarm->mask |= (uint8_t)(1U << i);
+        }
+    }
+}
+
+/**
+ * @brief 将 DS3231_Alarm_t 编码为闹钟寄存器的BCD数据
+ * @details 与 decode_alarm 相反，芯片工作在24小时制。
+ * @param[in] alarm 闹钟设置
+ * @param[in] count 寄存器数 (闹钟1为4，闹钟2为3)
+ * @param[out] tx_data 闹钟寄存器数据
+ * @return 无
+ */
+static void encode_alarm(const DS3231_Alarm_t *alarm, uint8_t count, uint8_t *tx_data)
+{
+    uint8_t *r = tx_data + count - 3; // 分、时、日三个寄存器
+
+    if (count == 4) {
+        tx_data[0] = decToBcd(alarm->second);
+    }
+    r[0] = decToBcd(alarm->minute);
+    r[1] = decToBcd(alarm->hour);
+    r[2] = (uint8_t)(decToBcd(alarm->day) | (alarm->day_is_week ? 0x40 : 0));
+    for (uint8_t i = 0; i < count; i++) {
+        if (alarm->mask & (1U << i)) {
+            tx_data[i] |= 0x80;
+        }
+    }
+}
+
+/**
+ * @brief 用给定的时间覆盖缓存
+ * @details 若拷贝前刚好来了一个SQW脉冲 (ticks 与 ticks_before 不同)，
+ *          说明芯片已经进入下一秒，缓存需要随之推进。
+ * @param[in] time 从芯片读取或刚写入芯片的时间
+ * @param[in] ticks_before 读取芯片之前的脉冲计数
+ * @return 无
+ */
+static void cache_store(const Time_t *time, uint32_t ticks_before)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    Seqlock_Write_Begin(&ds3231_cache.lock);
+    ds3231_cache.epoch = Time_To_Epoch(time) + (ds3231_cache.ticks != ticks_before ? 1 : 0);
+    ds3231_cache.valid = true;
+    Seqlock_Write_End(&ds3231_cache.lock);
+    ds3231_cache.sync_ticks = ds3231_cache.ticks;
+#if RTC_LSE_ENABLE
+    ds3231_cache.lse_pending = true; // 读取时刻不在秒边界上，等下一个脉冲再校准片内RTC
+#endif
+    __set_PRIMASK(primask);
+
+    ds3231_cache.last_sync_ms = HAL_GetTick();
+}
+
+/**
+ * @brief 周期同步是否已到期
+ * @details 片内RTC未启用或未校准时每 DS3231_RESYNC_INTERVAL_S 个脉冲与芯片同步一次。
+ *          片内RTC已校准时芯片每 RTC_LSE_DISCIPLINE_S 才读一次，其间每 DS3231_RESYNC_INTERVAL_S 用计数器核对缓存：
+ *          计数器在秒脉冲时写入，下一次进位在这一秒之内的某个时刻，正常时比缓存多0或1秒；
+ *          超出这个范围说明漏掉了脉冲 (或计数器走偏了整秒)，立即与芯片同步。
+ *          缓存和计数器在同一次读锁中读取，期间来了脉冲时重读。
+ * @return bool 需要与芯片同步时返回 true
+ */
+static bool cache_resync_due(void)
+{
+    uint32_t elapsed = ds3231_cache.ticks - ds3231_cache.sync_ticks;
+#if RTC_LSE_ENABLE
+    uint32_t seq;
+    Epoch_t cached, counted;
+    bool ok;
+
+    do {
+        seq = Seqlock_Read_Begin(&ds3231_cache.lock);
+        cached = ds3231_cache.epoch;
+        ok = RTC_Lse_Read(&counted);
+    } while (Seqlock_Read_Retry(&ds3231_cache.lock, seq));
+    if (ok) {
+        if (ds3231_cache.ticks - ds3231_cache.lse_check_ticks < DS3231_RESYNC_INTERVAL_S) {
+            return elapsed >= RTC_LSE_DISCIPLINE_S;
+        }
+        ds3231_cache.lse_check_ticks = ds3231_cache.ticks;
+        return elapsed >= RTC_LSE_DISCIPLINE_S || counted < cached || counted > cached + 1;
+    }
+#endif
+    return elapsed >= DS3231_RESYNC_INTERVAL_S;
+}
+
+#if RTC_LSE_ENABLE
+/**
+ * @brief 由片内RTC推进缓存 (方波失效或芯片尚未读到时)
+ * @details 芯片同步后没有脉冲可等，立即校准计数器，相位误差不超过这次读取在秒内的位置。
+ * @return bool 片内RTC已校准、缓存已按计数器更新时返回 true
+ */
+static bool cache_follow_lse(void)
+{
+    Epoch_t counted;
+    uint32_t primask;
+
+    if (ds3231_cache.lse_pending) {
+        ds3231_cache.lse_pending = false;
+        (void)RTC_Lse_Write(ds3231_cache.epoch);
+        return ds3231_cache.valid; // 写入在后台完成，这一次不读取
+    }
+    if (!RTC_Lse_Read(&counted)) {
+        return false;
+    }
+    if (!ds3231_cache.valid || ds3231_cache.epoch != counted) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        Seqlock_Write_Begin(&ds3231_cache.lock);
+        ds3231_cache.epoch = counted;
+        ds3231_cache.valid = true;
+        Seqlock_Write_End(&ds3231_cache.lock);
+        __set_PRIMASK(primask);
+    }
+    return true;
 }
+#endif
 
 /**
- * @brief 获取指定年份和月份的天数
- * @details 考虑了闰年的情况。
- * @param[in] year 年份
- * @param[in] month 月份 (1-12)
- * @return uint8_t 该月的天数
+ * @brief 异步重新同步的读事务完成回调 (I2C中断上下文)
+ * @param[in] status 事务结果
+ * @param[in] ctx 未使用
+ * @return 无
  */
-static uint8_t get_days_in_month(uint16_t year, uint8_t month)
+static void cache_resync_cb(HAL_StatusTypeDef status, void *ctx)
 {
-    if (month == 2) {
-        bool is_leap = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
-        return is_leap ? 29 : 28;
-    } else if (month == 4 || month == 6 || month == 9 || month == 11) {
-        return 30;
+    (void)ctx;
+
+    if (status == HAL_OK) {
+        Time_t t;
+        PROF_END(PROF_SEC_RTC_READ);
+        decode_time(ds3231_cache.resync_rx, &t);
+        cache_store(&t, ds3231_cache.resync_ticks);
     } else {
-        return 31;
+        ds3231_cache.last_sync_ms = HAL_GetTick(); // 失败时同样限制重试频率
     }
+    ds3231_cache.resync_busy = false;
 }
 
 /**
- * @brief 判断给定日期是否在夏令时 (DST) 区间内
- * @details 这是一个简化的、基于固定月/日的北半球规则判断。
- *          具体规则由 `DST_START_MONTH`, `DST_START_DAY`, `DST_END_MONTH`, `DST_END_DAY` 宏定义决定。
- * @param[in] time 指向包含当前日期时间的Time_t结构体指针
- * @return bool 是否在夏令时区间内
- *         - @retval true 当前日期在夏令时区间内
- *         - @retval false 当前日期不在夏令时区间内
+ * @brief 清除状态寄存器的 OSF 标志
+ * @details 时间被重新设置后芯片上的时间又可信了。只改 OSF 位，闹钟标志和 EN32kHz 保持不变。
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
  */
-static bool is_in_dst_period(const Time_t *time)
+static HAL_StatusTypeDef clear_osf(void)
 {
-    // 规则：从 DST_START_MONTH 的 DST_START_DAY 到 DST_END_MONTH 的 DST_END_DAY
-    
-    // 1. 如果当前月份在开始和结束月份之间，则肯定是夏令时
-    //    例如，规则是3月到11月，现在是7月
-    if (time->month > DST_START_MONTH && time->month < DST_END_MONTH) {
-        return true;
+    uint8_t stat;
+    HAL_StatusTypeDef status;
+
+    status = ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_READ, DS3231_REG_STATUS, &stat, 1);
+    if (status != HAL_OK || (stat & DS3231_STAT_OSF) == 0) {
+        return status;
     }
+    stat &= (uint8_t)~DS3231_STAT_OSF;
+    return ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_WRITE, DS3231_REG_STATUS, &stat, 1);
+}
 
-    // 2. 如果当前月份是开始月份，则需要检查日期
-    //    例如，规则是3月10日开始，现在是3月15日
-    if (time->month == DST_START_MONTH && time->day >= DST_START_DAY) {
-        return true;
+/**
+ * @brief 安排在 due_ms 写入 epoch
+ * @details 在关中断或中断上下文中调用。编码在这里完成，SysTick 中断里只提交事务。
+ * @param[in] epoch 在 due_ms 开始的一秒
+ * @param[in] due_ms 写入的时刻
+ * @return 无
+ */
+static void sync_arm(Epoch_t epoch, uint32_t due_ms)
+{
+    Time_t t;
+
+    Time_From_Epoch(epoch, &t);
+    encode_time(&t, ds3231_sync.tx);
+    ds3231_sync.epoch = epoch;
+    ds3231_sync.due_ms = due_ms;
+    ds3231_sync.state = SYNC_ARMED;
+}
+
+/**
+ * @brief 在参考时间之后的下一个秒边界重写
+ * @details 重写次数用完时结束，接受最后一次写入的结果。
+ * @param[in] now 当前时间戳
+ * @return 无
+ */
+static void sync_retry(uint32_t now)
+{
+    Epoch_t epoch = ds3231_sync.epoch;
+    uint32_t due = ds3231_sync.due_ms;
+
+    if (ds3231_sync.retries == 0) {
+        ds3231_sync.state = SYNC_DONE;
+        return;
+    }
+    ds3231_sync.retries--;
+    do {
+        epoch++;
+        due += DS3231_SQW_PERIOD_MS;
+    } while ((int32_t)(now - due) >= 0);
+    sync_arm(epoch, due);
+}
+
+/**
+ * @brief 对时写事务完成回调 (I2C中断上下文)
+ * @details 写秒寄存器重启了芯片的分频链，这一秒从现在开始，下一个秒脉冲约在一秒之后。
+ *          缓存的时间和秒脉冲时刻在同一次写锁中更新，页面不会看到新时间配旧相位。
+ * @param[in] status 事务结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void sync_write_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t primask;
+
+    (void)ctx;
+    if (status != HAL_OK) {
+        sync_retry(now);
+        return;
     }
 
-    // 3. 如果当前月份是结束月份，则需要检查日期
-    //    例如，规则是11月3日结束，现在是11月1日
-    if (time->month == DST_END_MONTH && time->day < DST_END_DAY) {
-        return true;
+    primask = __get_PRIMASK();
+    __disable_irq();
+    Seqlock_Write_Begin(&ds3231_cache.lock);
+    ds3231_cache.epoch = ds3231_sync.epoch;
+    ds3231_cache.last_edge_ms = now;
+    ds3231_cache.valid = true;
+    Seqlock_Write_End(&ds3231_cache.lock);
+    ds3231_cache.sync_ticks = ds3231_cache.ticks;
+    __set_PRIMASK(primask);
+    ds3231_cache.last_sync_ms = now;
+    ds3231_sync.written = true;
+#if RTC_LSE_ENABLE
+    (void)RTC_Lse_Write(ds3231_sync.epoch); // 这一刻正是秒边界，片内RTC同时对时
+#endif
+
+    if ((int32_t)(now - ds3231_sync.due_ms) > DS3231_SYNC_MAX_LATE_MS) {
+        sync_retry(now); // 总线被占用，秒边界晚了，下一秒再写一次
+    } else {
+        ds3231_sync.state = SYNC_DONE;
     }
-    
-    // 4. 其他所有情况都不是夏令时
-    return false;
 }
 
+/**
+ * @brief 阻塞地从芯片读取时间并刷新缓存
+ * @return 无
+ */
+static void cache_resync_blocking(void)
+{
+    Time_t t;
+    uint32_t ticks_before = ds3231_cache.ticks;
+
+    DS3231_GetTime(&t);
+    cache_store(&t, ticks_before);
+}
 
 /* Public Function implementations -------------------------------------------*/
 
@@ -113,13 +472,16 @@ static bool is_in_dst_period(const Time_t *time)
 
 /**
  * @brief 初始化DS3231驱动
- * @details 保存I2C句柄以供模块内部其他函数使用。
+ * @details 所有传输都经由 i2c_bus 模块完成，调用前需先执行 I2C_Bus_Init。
+ *          句柄参数保留以兼容原有接口。
  * @param[in] hi2c I2C句柄指针
  * @return 无
  */
 void DS3231_Init(I2C_HandleTypeDef *hi2c)
 {
-    ds3231_i2c = hi2c;
+    (void)hi2c;
+    ds3231_cache.valid = false;
+    RTC_Lse_Init();
 }
 
 /**
@@ -130,17 +492,92 @@ void DS3231_Init(I2C_HandleTypeDef *hi2c)
  */
 void DS3231_SetTime(Time_t *time)
 {
+    Epoch_t rtc_before = DS3231_GetCachedEpoch();
     uint8_t tx_data[7];
-    tx_data[0] = decToBcd(time->second);
-    tx_data[1] = decToBcd(time->minute);
-    tx_data[2] = decToBcd(time->hour);
-    tx_data[3] = decToBcd(time->week);
-    tx_data[4] = decToBcd(time->day);
-    tx_data[5] = decToBcd(time->month);
-    tx_data[6] = decToBcd(time->year - 2000); // DS3231年份只存后两位
 
+    encode_time(time, tx_data);
     // 从寄存器地址0x00开始，连续写入7个字节
-    HAL_I2C_Mem_Write(ds3231_i2c, DS3231_ADDRESS, 0x00, I2C_MEMADD_SIZE_8BIT, tx_data, 7, 1000);
+    if (ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_WRITE, 0x00, tx_data, 7) != HAL_OK) {
+        return;
+    }
+
+    // 写秒寄存器会重启芯片的分频链，缓存直接采用新时间
+    cache_store(time, ds3231_cache.ticks);
+    (void)clear_osf();
+    DS3231_TimeSetCallback(rtc_before, Time_To_Epoch(time));
+}
+
+/**
+ * @brief 在秒边界上设置时间 (亚秒精度)
+ * @details 先把 ref_ms 推进到不早于现在的秒边界，epoch 随之增加相同的秒数，再交给 SysTick 计时。
+ * @param[in] epoch 标准时间的纪元秒
+ * @param[in] ref_ms epoch 这一秒开始时的时间戳
+ * @return HAL_StatusTypeDef 已安排返回 HAL_OK，上一次写事务尚未完成返回 HAL_BUSY
+ */
+HAL_StatusTypeDef DS3231_SetTimeSync(Epoch_t epoch, uint32_t ref_ms)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t primask;
+
+    if (ds3231_sync.state == SYNC_WRITING) {
+        return HAL_BUSY;
+    }
+    if ((int32_t)(now - ref_ms) > 0) {
+        uint32_t k = (now - ref_ms + DS3231_SQW_PERIOD_MS - 1U) / DS3231_SQW_PERIOD_MS;
+        epoch += k;
+        ref_ms += k * DS3231_SQW_PERIOD_MS;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    ds3231_sync.retries = DS3231_SYNC_RETRIES;
+    ds3231_sync.started = false;
+    ds3231_sync.written = false;
+    sync_arm(epoch, ref_ms);
+    __set_PRIMASK(primask);
+    return HAL_OK;
+}
+
+/**
+ * @brief 是否有尚未完成的对时写入
+ * @return bool 等待秒边界或写事务进行中时返回 true
+ */
+bool DS3231_SetTimeSync_Pending(void)
+{
+    return ds3231_sync.state == SYNC_ARMED || ds3231_sync.state == SYNC_WRITING;
+}
+
+/**
+ * @brief 对时写入的计时，需在 SysTick 中断中调用
+ * @details 没有待写入的时间时只比较一次状态。秒边界到来时以显示优先级 (队列中最高) 提交写事务，
+ *          总线上正在进行的事务结束后立即开始；队列已满时推迟到下一个秒边界。
+ * @return 无
+ */
+void DS3231_Tick_Handler(void)
+{
+    if (ds3231_sync.state != SYNC_ARMED || (int32_t)(HAL_GetTick() - ds3231_sync.due_ms) < 0) {
+        return;
+    }
+
+    I2C_Bus_Txn_t txn = {
+        .op = I2C_BUS_OP_MEM_WRITE,
+        .dev_addr = DS3231_ADDRESS,
+        .mem_addr = 0x00,
+        .mem_addr_size = I2C_MEMADD_SIZE_8BIT,
+        .data = ds3231_sync.tx,
+        .size = sizeof(ds3231_sync.tx),
+        .cb = sync_write_cb,
+    };
+
+    if (!ds3231_sync.started) {
+        ds3231_sync.started = true;
+        ds3231_sync.rtc_before = ds3231_cache.epoch;
+        ds3231_sync.ref = ds3231_sync.epoch;
+    }
+    ds3231_sync.state = SYNC_WRITING;
+    if (I2C_Bus_Submit(&txn, I2C_BUS_PRIO_DISPLAY) != HAL_OK) {
+        sync_retry(HAL_GetTick());
+    }
 }
 
 /**
@@ -153,15 +590,9 @@ void DS3231_GetTime(Time_t *time)
 {
     uint8_t rx_data[7];
     // 从寄存器地址0x00开始，连续读取7个字节
-    HAL_I2C_Mem_Read(ds3231_i2c, DS3231_ADDRESS, 0x00, I2C_MEMADD_SIZE_8BIT, rx_data, 7, 1000);
-
-    time->second = bcdToDec(rx_data[0]);
-    time->minute = bcdToDec(rx_data[1]);
-    time->hour   = bcdToDec(rx_data[2]);
-    time->week   = bcdToDec(rx_data[3]);
-    time->day    = bcdToDec(rx_data[4]);
-    time->month  = bcdToDec(rx_data[5]);
-    time->year   = bcdToDec(rx_data[6]) + 2000;
+    ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_READ, 0x00, rx_data, 7);
+
+    decode_time(rx_data, time);
 }
 
 /**
@@ -177,41 +608,10 @@ void DS3231_DST_GetTime(Time_t *time, bool dst_enabled)
     // 1. 首先，获取标准的、未经修改的硬件时间
     DS3231_GetTime(time);
 
-    // 2. 如果夏令时功能被禁用了，直接返回标准时间
-    if (!dst_enabled) {
-        return;
-    }
-
-    // 3. 如果夏令时已启用，判断当前日期是否在夏令时区间内
-    if (is_in_dst_period(time))
-    {
-        // 4. 在夏令时区间内，将小时数加一
-        time->hour += 1;
-
-        // 5. 处理小时进位（例如，从23:59跳到夏令时的00:59）
-        if (time->hour >= 24)
-        {
-            time->hour = 0; // 小时归零，进入下一天
-
-            // 星期进位 (1=周一, 7=周日)
-            time->week++;
-            if (time->week > 7) {
-                time->week = 1;
-            }
-
-            // 日期进位
-            time->day++;
-            if (time->day > get_days_in_month(time->year, time->month)) {
-                time->day = 1; // 日期归1，月份进位
-                time->month++;
-                if (time->month > 12) {
-                    time->month = 1; // 月份归1，年份进位
-                    time->year++;
-                }
-            }
-        }
+    // 2. 如果夏令时已启用，在纪元秒上加上偏移，进位由换算自然处理
+    if (dst_enabled) {
+        Time_From_Epoch(Time_Apply_Dst(Time_To_Epoch(time), true), time);
     }
-    // 如果不在夏令时区间内，则什么都不做，直接使用标准时间
 }
 
 /**
@@ -221,54 +621,183 @@ void DS3231_DST_GetTime(Time_t *time, bool dst_enabled)
  */
 float DS3231_GetTemperature(void)
 {
-    uint8_t temp_data[2];
+    uint8_t temp_data[2] = {0};
     // 读取温度寄存器 0x11 和 0x12
-    HAL_I2C_Mem_Read(ds3231_i2c, DS3231_ADDRESS, 0x11, I2C_MEMADD_SIZE_8BIT, temp_data, 2, 1000);
+    ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_READ, 0x11, temp_data, 2);
     // 整数部分在temp_data[0]，小数部分在temp_data[1]的高两位 (步进0.25)
     return (float)temp_data[0] + ((temp_data[1] >> 6) * 0.25f);
 }
 
+/**
+ * @brief 以整数读取DS3231内部温度传感器的温度值
+ * @details 温度寄存器为10位补码，高字节为整数部分，低字节高两位为小数部分。
+ * @param[out] temp_x4 温度，单位0.25°C (有符号)
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef DS3231_GetTemperature_x4(int16_t *temp_x4)
+{
+    uint8_t temp_data[2];
+    HAL_StatusTypeDef status;
+
+    status = ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_READ, 0x11, temp_data, 2);
+    if (status == HAL_OK) {
+        *temp_x4 = (int16_t)((int16_t)((temp_data[0] << 8) | temp_data[1]) >> 6);
+    }
+    return status;
+}
+
+
+/**
+ * @brief 一次读取并解码DS3231的全部寄存器
+ * @details 寄存器 0x00-0x12 在一次突发读取中完成，芯片在读取开始时锁存时间寄存器，
+ *          各字段之间不会出现进位不一致。
+ * @param[out] snap 解码结果
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态，失败时 snap 内容不变
+ */
+HAL_StatusTypeDef DS3231_Snapshot(DS3231_Snapshot_t *snap)
+{
+    uint8_t rx_data[DS3231_SNAPSHOT_SIZE];
+    HAL_StatusTypeDef status;
+
+    status = ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_READ, 0x00, rx_data, DS3231_SNAPSHOT_SIZE);
+    if (status != HAL_OK) {
+        return status;
+    }
+
+    decode_time(&rx_data[0x00], &snap->time);
+    decode_alarm(&rx_data[0x07], 4, &snap->alarm1);
+    decode_alarm(&rx_data[0x0B], 3, &snap->alarm2);
+    snap->control = rx_data[DS3231_REG_CONTROL];
+    snap->status = rx_data[DS3231_REG_STATUS];
+    snap->osf = (snap->status & DS3231_STAT_OSF) != 0;
+    snap->aging = (int8_t)rx_data[0x10];
+    // 温度为10位补码: 0x11 为整数部分，0x12 的高两位为小数部分 (步进0.25)
+    snap->temp_x4 = (int16_t)((int16_t)((rx_data[0x11] << 8) | rx_data[0x12]) >> 6);
+    return HAL_OK;
+}
+
+/**
+ * @brief 读取老化偏移寄存器
+ * @param[out] aging 老化偏移 (1 LSB 约 0.1ppm)
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef DS3231_GetAgingOffset(int8_t *aging)
+{
+    return ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_READ, DS3231_REG_AGING, (uint8_t *)aging, 1);
+}
+
+/**
+ * @brief 写入老化偏移寄存器并立即生效
+ * @details 先写老化偏移，再置位控制寄存器的 CONV 位启动温度转换，转换结束后新值生效。
+ * @param[in] aging 老化偏移 (正值使振荡器变慢)
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef DS3231_SetAgingOffset(int8_t aging)
+{
+    uint8_t ctrl;
+    HAL_StatusTypeDef status;
+
+    status = ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_WRITE, DS3231_REG_AGING, (uint8_t *)&aging, 1);
+    if (status != HAL_OK) {
+        return status;
+    }
+    status = ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_READ, DS3231_REG_CONTROL, &ctrl, 1);
+    if (status != HAL_OK) {
+        return status;
+    }
+    ctrl |= DS3231_CTRL_CONV;
+    return ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_WRITE, DS3231_REG_CONTROL, &ctrl, 1);
+}
+
+/**
+ * @brief 写入闹钟寄存器
+ * @param[in] index 闹钟编号 (1 或 2)
+ * @param[in] alarm 闹钟设置
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef DS3231_SetAlarm(uint8_t index, const DS3231_Alarm_t *alarm)
+{
+    uint8_t tx_data[4];
+    uint8_t count = (index == 1) ? 4 : 3;
+
+    if (index != 1 && index != 2) {
+        return HAL_ERROR;
+    }
+    encode_alarm(alarm, count, tx_data);
+    return ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_WRITE, (index == 1) ? DS3231_REG_ALARM1 : DS3231_REG_ALARM2,
+                       tx_data, count);
+}
+
+/**
+ * @brief 清除闹钟标志
+ * @details 读出状态寄存器，只把要清除的标志写0：OSF 和闹钟标志写1不改变原值，EN32kHz 须保持。
+ * @param[in] flags 要清除的标志
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef DS3231_ClearAlarmFlags(uint8_t flags)
+{
+    uint8_t stat;
+    HAL_StatusTypeDef status;
+
+    status = ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_READ, DS3231_REG_STATUS, &stat, 1);
+    if (status != HAL_OK) {
+        return status;
+    }
+    if ((stat & flags) == 0) {
+        return HAL_OK;
+    }
+
+    stat &= (uint8_t)~(flags & (DS3231_STAT_A1F | DS3231_STAT_A2F));
+    return ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_WRITE, DS3231_REG_STATUS, &stat, 1);
+}
+
+/**
+ * @brief 使能或禁止闹钟中断
+ * @param[in] index 闹钟编号 (1 或 2)
+ * @param[in] enable 是否使能
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef DS3231_EnableAlarmInterrupt(uint8_t index, bool enable)
+{
+    uint8_t bit = (index == 1) ? DS3231_CTRL_A1IE : DS3231_CTRL_A2IE;
+    uint8_t ctrl;
+    HAL_StatusTypeDef status;
+
+    if (index != 1 && index != 2) {
+        return HAL_ERROR;
+    }
+    status = ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_READ, DS3231_REG_CONTROL, &ctrl, 1);
+    if (status != HAL_OK) {
+        return status;
+    }
+    if (((ctrl & bit) != 0) == enable) {
+        return HAL_OK;
+    }
+
+    ctrl = (uint8_t)(enable ? (ctrl | bit) : (ctrl & ~bit));
+    return ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_WRITE, DS3231_REG_CONTROL, &ctrl, 1);
+}
 
 /**
  * @brief 从编译时间自动设置DS3231时间
  * @details 此函数在首次烧录或时间需要重置时非常有用，
- *          它会读取编译器在编译时刻的 `__DATE__` 和 `__TIME__` 宏，
- *          解析后将其写入DS3231。
+ *          它会读取编译器在编译时刻的 `__DATE__` ("Mmm dd yyyy") 和 `__TIME__` ("hh:mm:ss") 宏，
+ *          解析后将其写入DS3231。解析用 BUILD_* 宏按固定位置取字符，编译器直接折叠为常量，不链接 sscanf。
  * @return 无
  */
 void DS3231_SetTimeFromCompileTime(void)
 {
     Time_t t;
-    char month_str[4];
-
-    // 1. 定义与 %d 匹配的临时 int 变量
-    int day_temp, year_temp;
-    int hour_temp, minute_temp, second_temp;
-    
-    // 2. 使用临时变量的指针传给 sscanf
-    sscanf(__DATE__, "%s %d %d", month_str, &day_temp, &year_temp);
-    sscanf(__TIME__, "%d:%d:%d", &hour_temp, &minute_temp, &second_temp);
-
-    // 3. 将临时变量的值安全地赋值给结构体
-    t.day = (uint8_t)day_temp;
-    t.year = (uint16_t)year_temp;
-    t.hour = (uint8_t)hour_temp;
-    t.minute = (uint8_t)minute_temp;
-    t.second = (uint8_t)second_temp;
-
-    // 将月份字符串转换为数字 
-    const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
-    for (int i = 0; i < 12; i++)
-    {
-        if (strncmp(month_str, months[i], 3) == 0) 
-        {
-            t.month = i + 1;
-            break;
-        }
-    }
-    
-    // 星期需要自己计算或给个默认值
-    t.week = 1; 
+
+    t.year = (uint16_t)BUILD_YEAR;
+    t.month = (uint8_t)BUILD_MONTH;
+    t.day = (uint8_t)BUILD_DAY;
+    t.hour = (uint8_t)BUILD_HOUR;
+    t.minute = (uint8_t)BUILD_MINUTE;
+    t.second = (uint8_t)BUILD_SECOND;
+
+    // 由日期计算星期
+    t.week = Time_Weekday_From_Days(Time_Days_From_Civil(t.year, t.month, t.day));
 
     DS3231_SetTime(&t);
 }
@@ -276,100 +805,295 @@ void DS3231_SetTimeFromCompileTime(void)
 /** @} */
 
 /**
- * @addtogroup AT24C32_Functions
+ * @addtogroup DS3231_Cache_Functions
  * @{
  */
 
 /**
- * @brief 在AT24C32 EEPROM指定地址写入一个字节
- * @param[in] mem_addr 内存地址 (0x0000 - 0x0FFF)
- * @param[in] data 要写入的数据字节
+ * @brief 将DS3231的SQW引脚配置为1Hz方波输出
+ * @details 清除控制寄存器的 INTCN、RS1、RS2 位和闹钟2的中断使能，其余位 (包括闹钟1的中断使能) 保持不变。
+ *          从每分钟闹钟模式切换回来时，缓存在两次闹钟之间没有走动，调用者应随后重新同步。
  * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
  */
-HAL_StatusTypeDef AT24C32_WriteByte(uint16_t mem_addr, uint8_t data)
+HAL_StatusTypeDef DS3231_EnableSqw1Hz(void)
 {
-    // 关键！AT24C32的内存地址是16位的
-    HAL_StatusTypeDef status = HAL_I2C_Mem_Write(ds3231_i2c, AT24C32_ADDRESS, mem_addr, I2C_MEMADD_SIZE_16BIT, &data, 1, 1000);
-    HAL_Delay(5); // EEPROM写入后需要一个短暂的延时来完成内部操作
+    uint8_t ctrl;
+    HAL_StatusTypeDef status;
+
+    status = ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_READ, DS3231_REG_CONTROL, &ctrl, 1);
+    if (status != HAL_OK) {
+        return status;
+    }
+
+    ctrl &= (uint8_t)~(DS3231_CTRL_INTCN | DS3231_CTRL_RS1 | DS3231_CTRL_RS2 | DS3231_CTRL_A2IE);
+
+    status = ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_WRITE, DS3231_REG_CONTROL, &ctrl, 1);
+    if (status == HAL_OK) {
+        ds3231_cache.minute_mode = false;
+        ds3231_cache.alarm_pending = false;
+    }
     return status;
 }
 
 /**
- * @brief 从AT24C32 EEPROM指定地址读取一个字节
- * @param[in] mem_addr 内存地址 (0x0000 - 0x0FFF)
- * @return uint8_t 读取到的数据字节
+ * @brief 将DS3231的INT/SQW引脚配置为每分钟一次的闹钟2中断
+ * @details 先写闹钟、清除旧标志，最后置位 INTCN 和 A2IE 切换引脚，切换之前的最后一个秒脉冲仍按一秒计。
+ *          使能了闹钟1时应把它设在整分 (秒为0)，与闹钟2同时触发，只产生一个下降沿。
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef DS3231_EnableMinuteAlarm(void)
+{
+    DS3231_Alarm_t alarm = {.mask = 0x07}; // 屏蔽 A2M2~A2M4：每分钟秒寄存器归零时触发
+    uint8_t ctrl;
+    HAL_StatusTypeDef status;
+    uint32_t primask;
+
+    status = DS3231_SetAlarm(2, &alarm);
+    if (status == HAL_OK) {
+        status = DS3231_ClearAlarmFlags(DS3231_STAT_A1F | DS3231_STAT_A2F);
+    }
+    if (status == HAL_OK) {
+        status = ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_READ, DS3231_REG_CONTROL, &ctrl, 1);
+    }
+    if (status != HAL_OK) {
+        return status;
+    }
+
+    ctrl |= DS3231_CTRL_INTCN | DS3231_CTRL_A2IE;
+    status = ds3231_xfer(DS3231_ADDRESS, I2C_BUS_OP_MEM_WRITE, DS3231_REG_CONTROL, &ctrl, 1);
+    if (status != HAL_OK) {
+        return status;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    ds3231_cache.minute_mode = true;
+    ds3231_cache.alarm_pending = false;
+    if (ds3231_cache.valid) {
+        // 最近一次秒脉冲是缓存当前这一秒的开始，往前推到这一分钟的开始
+        Seqlock_Write_Begin(&ds3231_cache.lock);
+        ds3231_cache.last_edge_ms -= (uint32_t)(ds3231_cache.epoch % 60) * 1000U;
+        Seqlock_Write_End(&ds3231_cache.lock);
+    }
+    __set_PRIMASK(primask);
+    return HAL_OK;
+}
+
+/**
+ * @brief 请求从芯片读取时间，刷新RAM缓存
+ * @details 以异步事务提交，读取完成后在回调中更新缓存，调用者不等待总线。
+ *          上一次请求尚未完成时直接返回。
+ * @return 无
  */
-uint8_t AT24C32_ReadByte(uint16_t mem_addr)
+void DS3231_Cache_Resync(void)
 {
-    uint8_t data;
-    HAL_I2C_Mem_Read(ds3231_i2c, AT24C32_ADDRESS, mem_addr, I2C_MEMADD_SIZE_16BIT, &data, 1, 1000);
-    return data;
+    if (ds3231_cache.resync_busy) {
+        return;
+    }
+
+    I2C_Bus_Txn_t txn = {
+        .op = I2C_BUS_OP_MEM_READ,
+        .dev_addr = DS3231_ADDRESS,
+        .mem_addr = 0x00,
+        .mem_addr_size = I2C_MEMADD_SIZE_8BIT,
+        .data = ds3231_cache.resync_rx,
+        .size = sizeof(ds3231_cache.resync_rx),
+        .cb = cache_resync_cb,
+    };
+
+    ds3231_cache.resync_ticks = ds3231_cache.ticks;
+    ds3231_cache.resync_busy = true;
+    PROF_BEGIN(PROF_SEC_RTC_READ);
+    if (I2C_Bus_Submit(&txn, I2C_BUS_PRIO_SENSOR) != HAL_OK) {
+        ds3231_cache.resync_busy = false;
+    }
 }
 
 /**
- * @brief 向AT24C32 EEPROM写入一页数据
- * @details 实现了跨页写入的逻辑。如果写入数据超过一页的边界，会自动分块写入。
- * @param[in] mem_addr 起始内存地址 (0x0000 - 0x0FFF)
- * @param[in] data 要写入的数据指针
- * @param[in] size 数据大小
- * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ * @brief 维护时间缓存，需在主循环中周期调用
+ * @return 无
  */
-HAL_StatusTypeDef AT24C32_WritePage(uint16_t mem_addr, uint8_t *data, uint16_t size)
-{
-    const uint16_t PAGE_SIZE = 32;
-    HAL_StatusTypeDef status = HAL_OK;
-    
-    uint16_t bytes_remaining = size;
-    uint16_t current_addr = mem_addr;
-    uint8_t *data_ptr = data;
-
-    // 循环写入，直到所有字节都写入完毕
-    while (bytes_remaining > 0)
-    {
-        // 1. 计算当前页还剩下多少空间
-        uint16_t bytes_to_page_end = PAGE_SIZE - (current_addr % PAGE_SIZE);
-
-        // 2. 计算本次实际要写入的字节数
-        //    取“剩余字节数”和“到页末尾的字节数”中的较小值
-        uint16_t chunk_size = (bytes_remaining < bytes_to_page_end) ? bytes_remaining : bytes_to_page_end;
-
-        // 3. 执行单页内的写入操作
-        status = HAL_I2C_Mem_Write(ds3231_i2c, AT24C32_ADDRESS, current_addr, 
-                                   I2C_MEMADD_SIZE_16BIT, data_ptr, chunk_size, 1000);
-        
-        // 4. 如果任何一次写入失败，立即中止并返回错误
-        if (status != HAL_OK) {
-            return status;
+void DS3231_Cache_Service(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    RTC_Lse_Service(); // LSE 起振后完成片内RTC的配置
+
+    // 对时写入结束：清除 OSF，按第一次写入记录对时误差
+    if (ds3231_sync.state == SYNC_DONE) {
+        ds3231_sync.state = SYNC_IDLE;
+        if (ds3231_sync.written) {
+            (void)clear_osf();
+            DS3231_TimeSetCallback(ds3231_sync.rtc_before, ds3231_sync.ref);
         }
+    }
 
-        // 5. 等待EEPROM内部写周期完成 (非常重要)
-        HAL_Delay(5);
+    if (!ds3231_cache.valid) {
+#if RTC_LSE_ENABLE
+        (void)cache_follow_lse(); // 片内RTC已校准过时先用它的时间，芯片读到后再覆盖
+#endif
+        DS3231_Cache_Resync(); // 异步读取，读到之前页面按"时间未就绪"处理 (见 DS3231_Cache_Get)
+        return;
+    }
 
-        // 6. 更新变量，为下一次循环做准备
-        bytes_remaining -= chunk_size;
-        current_addr += chunk_size;
-        data_ptr += chunk_size;
+    // 闹钟模式：INT 在标志清除前保持低电平，不清除就没有下一次下降沿。
+    // 超过一个周期没有收到闹钟时同样清除并同步，避免错过一次边沿后缓存停止走动
+    if (ds3231_cache.minute_mode) {
+        if (ds3231_cache.alarm_pending ||
+            now - ds3231_cache.last_sync_ms > DS3231_ALARM_PERIOD_MS + DS3231_SQW_TIMEOUT_MS - DS3231_SQW_PERIOD_MS) {
+            ds3231_cache.alarm_pending = false;
+            (void)DS3231_ClearAlarmFlags(DS3231_STAT_A1F | DS3231_STAT_A2F);
+            cache_resync_blocking();
+        }
+        return;
     }
 
-    return HAL_OK;
+    if (cache_resync_due()) {
+        DS3231_Cache_Resync();
+        return;
+    }
+
+    if (now - ds3231_cache.last_edge_ms <= DS3231_SQW_TIMEOUT_MS) {
+        return;
+    }
+#if RTC_LSE_ENABLE
+    // 方波失效或芯片缺失：由片内RTC推进，芯片只在校准间隔到期时读取 (不应答时同样按这个间隔重试)
+    if (cache_follow_lse()) {
+        if (now - ds3231_cache.last_sync_ms >= RTC_LSE_DISCIPLINE_S * 1000UL) {
+            DS3231_Cache_Resync();
+        }
+        return;
+    }
+#endif
+    // 方波失效 (例如SQW未接线)：退化为低频轮询芯片，保证时间仍然走动
+    if (now - ds3231_cache.last_sync_ms >= DS3231_FALLBACK_POLL_MS) {
+        DS3231_Cache_Resync();
+    }
 }
 
+/**
+ * @brief 获取RAM中缓存的时间 (不访问I2C)
+ * @details 缓存尚未同步时会先从芯片读取一次。
+ * @param[out] time 指向Time_t结构体的指针，用于存储时间信息
+ * @return 无
+ */
+void DS3231_GetCachedTime(Time_t *time)
+{
+    Time_From_Epoch(DS3231_GetCachedEpoch(), time);
+}
 
 /**
- * @brief 从AT24C32 EEPROM读取一段数据
- * @param[in] mem_addr 起始内存地址 (0x0000 - 0x0FFF)
- * @param[out] data 数据存储缓冲区指针
- * @param[in] size 要读取的数据大小
- * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ * @brief 获取RAM中缓存的时间的纪元秒 (不访问I2C)
+ * @details 缓存尚未同步时会先从芯片读取一次。
+ * @return Epoch_t 标准时间 (未应用夏令时) 的纪元秒
+ */
+Epoch_t DS3231_GetCachedEpoch(void)
+{
+    if (!ds3231_cache.valid) {
+        cache_resync_blocking();
+    }
+    return ds3231_cache.epoch;
+}
+
+/**
+ * @brief 获取RAM时间缓存的一致快照 (不访问I2C，不关中断)
+ * @param[out] snap 快照
+ * @return bool 缓存已同步返回 true
  */
-HAL_StatusTypeDef AT24C32_ReadPage(uint16_t mem_addr, uint8_t *data, uint16_t size)
+bool DS3231_Cache_Get(DS3231_Cache_Snap_t *snap)
 {
-    return HAL_I2C_Mem_Read(ds3231_i2c, AT24C32_ADDRESS, mem_addr, I2C_MEMADD_SIZE_16BIT, data, size, 1000);
+    uint32_t seq;
+
+    do {
+        seq = Seqlock_Read_Begin(&ds3231_cache.lock);
+        snap->epoch = ds3231_cache.epoch;
+        snap->edge_ms = ds3231_cache.last_edge_ms;
+        snap->ticks = ds3231_cache.ticks;
+        snap->valid = ds3231_cache.valid;
+    } while (Seqlock_Read_Retry(&ds3231_cache.lock, seq));
+    return snap->valid;
 }
 
-/** 
- * @} 
+/**
+ * @brief 获取应用了夏令时规则的缓存时间 (不访问I2C)
+ * @param[out] time 指向Time_t结构体的指针，用于存储最终的时间信息
+ * @param[in] dst_enabled 一个布尔值，指示是否应启用夏令时计算
+ * @return 无
  */
+void DS3231_DST_GetCachedTime(Time_t *time, bool dst_enabled)
+{
+    Time_From_Epoch(Time_Apply_Dst(DS3231_GetCachedEpoch(), dst_enabled), time);
+}
+
+/**
+ * @brief SQW 1Hz 方波 (或每分钟闹钟) 中断处理函数
+ * @return 无
+ */
+void DS3231_SQW_IRQ_Handler(void)
+{
+    TRACE(TRACE_EV_RTC_SQW, 0);
+    Seqlock_Write_Begin(&ds3231_cache.lock);
+    ds3231_cache.ticks++;
+    ds3231_cache.last_edge_ms = HAL_GetTick();
+    if (ds3231_cache.minute_mode) {
+        // 闹钟在秒归零时触发，推进到下一个整分，秒数由随后的同步补上
+        ds3231_cache.alarm_pending = true;
+        if (ds3231_cache.valid) {
+            ds3231_cache.epoch = ds3231_cache.epoch - ds3231_cache.epoch % 60 + 60;
+        }
+    } else if (ds3231_cache.valid) {
+        ds3231_cache.epoch++;
+    }
+#if RTC_LSE_ENABLE
+    if (ds3231_cache.lse_pending && ds3231_cache.valid) {
+        ds3231_cache.lse_pending = false;
+        (void)RTC_Lse_Write(ds3231_cache.epoch); // 校准对齐到芯片的秒边界
+    }
+#endif
+    Seqlock_Write_End(&ds3231_cache.lock);
+}
+
+/**
+ * @brief 获取最近一次SQW脉冲的时间戳
+ * @param[out] edge_ms 最近一次脉冲的时间戳
+ * @return bool 方波正常工作时返回 true
+ */
+bool DS3231_SQW_Get_Last_Edge(uint32_t *edge_ms)
+{
+    DS3231_Cache_Snap_t snap;
+    uint32_t timeout = DS3231_SQW_Get_Period() + DS3231_SQW_TIMEOUT_MS - DS3231_SQW_PERIOD_MS;
+
+    DS3231_Cache_Get(&snap);
+    if (snap.ticks == 0 || HAL_GetTick() - snap.edge_ms > timeout) {
+        return false;
+    }
+    *edge_ms = snap.edge_ms;
+    return true;
+}
+
+/**
+ * @brief 获取当前的脉冲周期
+ * @return uint32_t 脉冲周期 (ms)
+ */
+uint32_t DS3231_SQW_Get_Period(void)
+{
+    return ds3231_cache.minute_mode ? DS3231_ALARM_PERIOD_MS : DS3231_SQW_PERIOD_MS;
+}
+
+/** @} */
+
+/**
+ * @brief 时间被设置的回调
+ * @details 默认为空实现，应用层可重新定义 (见 app_drift.c)。
+ * @param[in] rtc_before 写入前芯片的时间 (纪元秒)
+ * @param[in] ref 写入的新时间 (纪元秒)
+ * @return 无
+ */
+__weak void DS3231_TimeSetCallback(Epoch_t rtc_before, Epoch_t ref)
+{
+    (void)rtc_before;
+    (void)ref;
+}
 
 /**
  * @}
@@ -3,13 +3,15 @@
  * @brief     DS3231实时时钟芯片驱动头文件
  * @details   本头文件定义了DS3231实时时钟芯片驱动的接口，包括：
  *            - 时间结构体定义
- *            - 时间设置和读取函数声明
+ *            - 时间设置和读取函数声明，以及对齐到秒边界的对时写入
+ *            - 由SQW 1Hz中断推进的RAM时间缓存，以及不关中断的一致快照
+ *            - 启用片内RTC (rtc_lse.h) 时以它为备用时间源，芯片读取减少为每小时几次
  *            - 温度读取函数声明
+ *            - 全部寄存器的单事务快照读取
  *            - 编译时间自动设置函数声明
- *            - AT24C32 EEPROM读写函数声明
  * @author    Sandocean
- * @date      2025-08-25
- * @version   1.0
+ * @date      2025-10-08
+ * @version   1.3
  * @note      本驱动基于STM32 HAL库实现，支持I2C通信
  * @copyright Copyright (c) 2025 SandOcean
  */
@@ -19,12 +21,14 @@
 
 #include "main.h"
 #include "i2c.h"
+#include "i2c_bus.h"
+#include "time_core.h"
 #include <stdint.h>
 #include <stdbool.h>
 
 /**
  * @defgroup DS3231_Driver DS3231 RTC 驱动
- * @brief 提供了对DS3231实时时钟的控制，以及对其附带的AT24C32 EEPROM的读写功能。
+ * @brief 提供了对DS3231实时时钟的控制。模块上的 AT24C32 EEPROM 见 AT24C32.h。
  * @{
  */
 
@@ -33,33 +37,83 @@
  * @{ 
  */
 #define DS3231_ADDRESS (0x68 << 1)       ///< DS3231 I2C设备地址 (7位地址左移一位)
-#define AT24C32_ADDRESS (0x57 << 1)      ///< AT24C32 I2C设备地址 (7位地址左移一位)
+#define DS3231_REG_ALARM1  0x07          ///< 闹钟1寄存器起始地址 (秒、分、时、日)
+#define DS3231_REG_ALARM2  0x0B          ///< 闹钟2寄存器起始地址 (分、时、日)
+#define DS3231_REG_CONTROL 0x0E          ///< 控制寄存器地址
+#define DS3231_REG_STATUS  0x0F          ///< 状态寄存器地址
+#define DS3231_REG_AGING   0x10          ///< 老化偏移寄存器地址 (1 LSB 约 0.1ppm，正值使振荡器变慢)
+#define DS3231_SNAPSHOT_SIZE 0x13        ///< 快照读取的寄存器数 (0x00-0x12)
+#define DS3231_CTRL_A1IE   (1 << 0)      ///< 控制寄存器 A1IE 位 (闹钟1中断使能)
+#define DS3231_CTRL_A2IE   (1 << 1)      ///< 控制寄存器 A2IE 位 (闹钟2中断使能)
+#define DS3231_CTRL_INTCN  (1 << 2)      ///< 控制寄存器 INTCN 位 (1=中断输出, 0=方波输出)
+#define DS3231_CTRL_RS1    (1 << 3)      ///< 控制寄存器 RS1 位 (方波频率选择)
+#define DS3231_CTRL_RS2    (1 << 4)      ///< 控制寄存器 RS2 位 (方波频率选择)
+#define DS3231_CTRL_CONV   (1 << 5)      ///< 控制寄存器 CONV 位 (立即开始一次温度转换)
+#define DS3231_STAT_A1F    (1 << 0)      ///< 状态寄存器 A1F 位 (闹钟1已匹配, 写0清除)
+#define DS3231_STAT_A2F    (1 << 1)      ///< 状态寄存器 A2F 位 (闹钟2已匹配, 写0清除)
+#define DS3231_STAT_OSF    (1 << 7)      ///< 状态寄存器 OSF 位 (振荡器曾经停振, 时间不可信)
 /** @} */
 
-/** 
- * @defgroup DST_Config 夏令时配置
- * @brief 定义了夏令时的起止日期 (此为示例，具体规则可能因地区而异)
- * @{ 
+/**
+ * @defgroup DS3231_Cache_Config 时间缓存配置
+ * @{
+ */
+#define DS3231_RESYNC_INTERVAL_S 60      ///< 缓存与芯片重新同步的间隔 (SQW脉冲数, 即秒)
+#define DS3231_SQW_PERIOD_MS     1000    ///< 1Hz方波模式下 SQW 引脚的脉冲周期
+#define DS3231_ALARM_PERIOD_MS   60000   ///< 每分钟闹钟模式下 INT 引脚的脉冲周期
+#define DS3231_SQW_TIMEOUT_MS    1100    ///< 超过该时间没有SQW脉冲则认为方波失效 (闹钟模式下顺延一个周期之差)
+#define DS3231_FALLBACK_POLL_MS  200     ///< 方波失效时直接读取芯片的最小间隔 (ms)
+/** @} */
+
+/**
+ * @defgroup DS3231_Sync_Config 对时写入配置
+ * @{
  */
-#define DST_START_MONTH 3   ///< 夏令时开始月份 (3月)
-#define DST_START_DAY   10  ///< 夏令时开始日期 (10日)
-#define DST_END_MONTH   11  ///< 夏令时结束月份 (11月)
-#define DST_END_DAY     3   ///< 夏令时结束日期 (3日)
+#define DS3231_SYNC_MAX_LATE_MS  2       ///< 写入完成晚于秒边界超过该时间 (总线被占用) 时在下一秒重写
+#define DS3231_SYNC_RETRIES      3       ///< 最多重写的次数，之后接受最后一次的结果
 /** @} */
 
+/* 时间结构体 Time_t 与夏令时规则 (DST_Config) 定义在 time_core.h 中 */
+
 /**
- * @brief 时间结构体定义
- * @details 用于存储和传递年、月、日、时、分、秒、星期等时间信息
+ * @brief 闹钟寄存器的解码结果
+ * @details 闹钟2没有秒寄存器，second 恒为0。
  */
 typedef struct {
-    uint8_t hour;    ///< 小时 (0-23)
-    uint8_t minute;  ///< 分钟 (0-59)
-    uint8_t second;  ///< 秒 (0-59)
-    uint16_t year;   ///< 年份 (2000-2099)
-    uint8_t month;   ///< 月份 (1-12)
-    uint8_t day;     ///< 日期 (1-31)
-    uint8_t week;    ///< 星期 (1=周一, 7=周日)
-} Time_t;
+    uint8_t second;   ///< 秒 (0-59)
+    uint8_t minute;   ///< 分钟 (0-59)
+    uint8_t hour;     ///< 小时 (0-23)
+    uint8_t day;      ///< 日期 (1-31) 或星期 (1-7)，由 day_is_week 决定
+    bool day_is_week; ///< day 为星期 (DY/DT 位)
+    uint8_t mask;     ///< 匹配屏蔽位 A1M1~A1M4 / A2M2~A2M4，bit0 对应秒 (闹钟2为分钟)
+} DS3231_Alarm_t;
+
+/**
+ * @brief DS3231 全部寄存器 (0x00-0x12) 的一次快照
+ * @details 由 DS3231_Snapshot() 在一次I2C事务中读取并解码，
+ *          时间、闹钟、状态和温度属于同一时刻。
+ */
+typedef struct {
+    Time_t time;            ///< 当前时间 (未应用夏令时)
+    DS3231_Alarm_t alarm1;  ///< 闹钟1
+    DS3231_Alarm_t alarm2;  ///< 闹钟2
+    uint8_t control;        ///< 控制寄存器原始值
+    uint8_t status;         ///< 状态寄存器原始值
+    bool osf;               ///< 振荡器停振标志，为 true 时时间需要重新设置
+    int8_t aging;           ///< 老化偏移寄存器
+    int16_t temp_x4;        ///< 温度，单位0.25°C (有符号)
+} DS3231_Snapshot_t;
+
+/**
+ * @brief RAM时间缓存的一致快照
+ * @details 由 DS3231_Cache_Get() 以顺序锁读出，各字段属于同一个SQW脉冲之后的状态。
+ */
+typedef struct {
+    Epoch_t epoch;      ///< 标准时间 (未应用夏令时) 的纪元秒
+    uint32_t edge_ms;   ///< epoch 这一秒开始时的 HAL_GetTick() 时间戳 (每分钟闹钟模式下为这一分钟开始)
+    uint32_t ticks;     ///< 收到的SQW脉冲总数，0 表示还没有收到过脉冲
+    bool valid;         ///< 缓存是否已经与芯片同步过，为 false 时其余字段无意义
+} DS3231_Cache_Snap_t;
 
 /** 
  * @defgroup DS3231_Functions DS3231核心功能函数
@@ -80,6 +134,36 @@ void DS3231_Init(I2C_HandleTypeDef *hi2c);
  */
 void DS3231_SetTime(Time_t *time);
 
+/**
+ * @brief 在秒边界上设置时间 (亚秒精度)
+ * @details DS3231_SetTime() 立即写入，写秒寄存器会重启芯片的分频链，新的一秒从写入时刻开始，
+ *          与参考时间的秒边界最多相差1秒。本函数把写入安排在参考时间的下一个秒边界 (ref_ms 加整秒)，
+ *          由 DS3231_Tick_Handler() 在该毫秒以最高优先级提交写事务，写入的是那一刻开始的一秒，
+ *          芯片的秒边界与参考时间对齐到总线延迟 (通常在1ms以内)。总线被一帧显存占用、写入完成晚于
+ *          DS3231_SYNC_MAX_LATE_MS 时在下一个秒边界重写。写入后在中断中一次更新缓存的时间和秒脉冲时刻，
+ *          之后由 DS3231_Cache_Service() 清除 OSF 标志并调用 DS3231_TimeSetCallback()。
+ *          只改日期或时分时传入缓存快照的 epoch 和 edge_ms，芯片原有的秒相位保持不变。
+ *          再次调用会替换尚未写入的时间。
+ * @param[in] epoch 标准时间 (未应用夏令时) 的纪元秒
+ * @param[in] ref_ms epoch 这一秒开始时的 HAL_GetTick() 时间戳，可以是过去的时刻
+ * @return HAL_StatusTypeDef 已安排返回 HAL_OK，上一次写事务尚未完成返回 HAL_BUSY
+ */
+HAL_StatusTypeDef DS3231_SetTimeSync(Epoch_t epoch, uint32_t ref_ms);
+
+/**
+ * @brief 是否有尚未完成的对时写入
+ * @details 写入由 SysTick 计时，期间不能进入停止模式。
+ * @return bool 等待秒边界或写事务进行中时返回 true
+ */
+bool DS3231_SetTimeSync_Pending(void);
+
+/**
+ * @brief 对时写入的计时，需在 SysTick 中断中调用
+ * @note RTOS 配置下 HAL 时基改用 TIM 时，应在该 TIM 的中断中调用。
+ * @return 无
+ */
+void DS3231_Tick_Handler(void);
+
 /**
  * @brief 从DS3231获取当前时间和日期
  * @param[out] time 指向Time_t结构体的指针，用于存储读取的时间信息
@@ -89,8 +173,8 @@ void DS3231_GetTime(Time_t *time);
 
 /**
  * @brief 获取应用了夏令时规则的时间
- * @details 如果夏令时被启用且当前日期在夏令时区间内，
- *          此函数将在标准时间的基础上将小时数加一。
+ * @details 如果夏令时被启用且当前时刻在夏令时区间内，
+ *          此函数将在标准时间的基础上加上当前规则的偏移量 (见 Time_Dst_Select_Zone)。
  * @param[out] time 指向Time_t结构体的指针，用于存储最终的时间信息
  * @param[in] dst_enabled 一个布尔值，指示是否应启用夏令时计算
  * @return 无
@@ -103,6 +187,73 @@ void DS3231_DST_GetTime(Time_t *time, bool dst_enabled);
  */
 float DS3231_GetTemperature(void);
 
+/**
+ * @brief 以整数读取DS3231内部温度传感器的温度值
+ * @details 与快照中的 temp_x4 相同，支持零下的温度。阻塞读取两个寄存器。
+ * @param[out] temp_x4 温度，单位0.25°C (有符号)，失败时不变
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef DS3231_GetTemperature_x4(int16_t *temp_x4);
+
+/**
+ * @brief 一次读取并解码DS3231的全部寄存器
+ * @details 从 0x00 连续读取到 0x12，时间、闹钟、控制/状态和温度只需一次总线事务。
+ * @param[out] snap 解码结果
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态，失败时 snap 内容不变
+ */
+HAL_StatusTypeDef DS3231_Snapshot(DS3231_Snapshot_t *snap);
+
+/**
+ * @brief 读取老化偏移寄存器
+ * @param[out] aging 老化偏移 (1 LSB 约 0.1ppm)
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef DS3231_GetAgingOffset(int8_t *aging);
+
+/**
+ * @brief 写入老化偏移寄存器并立即生效
+ * @details 新值在下一次温度转换后才影响振荡器，写入后主动启动一次转换。
+ * @param[in] aging 老化偏移 (正值使振荡器变慢)
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef DS3231_SetAgingOffset(int8_t aging);
+
+/**
+ * @brief 写入闹钟寄存器
+ * @details 与 DS3231_Snapshot() 的解码相反：mask 的 bit0 对应闹钟1的秒 (闹钟2的分钟)，
+ *          置位表示该字段不参与匹配。闹钟2没有秒寄存器，second 被忽略。只写寄存器，不改变中断使能。
+ * @param[in] index 闹钟编号 (1 或 2)
+ * @param[in] alarm 闹钟设置
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态，编号无效时返回 HAL_ERROR
+ */
+HAL_StatusTypeDef DS3231_SetAlarm(uint8_t index, const DS3231_Alarm_t *alarm);
+
+/**
+ * @brief 清除闹钟标志
+ * @details 中断输出模式下 INT 引脚在标志清除前保持低电平。状态寄存器的其余位 (OSF、EN32kHz) 保持不变。
+ * @param[in] flags 要清除的标志 (DS3231_STAT_A1F、DS3231_STAT_A2F 的组合)
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ */
+HAL_StatusTypeDef DS3231_ClearAlarmFlags(uint8_t flags);
+
+/**
+ * @brief 使能或禁止闹钟中断
+ * @details 修改控制寄存器的 A1IE/A2IE 位。1Hz方波模式 (INTCN=0) 下闹钟只置位标志，不驱动引脚。
+ * @param[in] index 闹钟编号 (1 或 2)
+ * @param[in] enable 是否使能
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态，编号无效时返回 HAL_ERROR
+ */
+HAL_StatusTypeDef DS3231_EnableAlarmInterrupt(uint8_t index, bool enable);
+
+/**
+ * @brief 时间被设置的回调
+ * @details DS3231_SetTime() 写入成功后调用 (调用者上下文)，给出写入前芯片的时间和写入的新时间，
+ *          供漂移估计等模块使用。默认为空实现，应用层可重新定义。
+ * @param[in] rtc_before 写入前芯片的时间 (纪元秒)
+ * @param[in] ref 写入的新时间 (纪元秒)
+ */
+void DS3231_TimeSetCallback(Epoch_t rtc_before, Epoch_t ref);
+
 /**
  * @brief 从编译时间自动设置DS3231时间
  * @details 此函数在首次烧录或时间需要重置时非常有用，
@@ -113,48 +264,102 @@ void DS3231_SetTimeFromCompileTime(void);
 
 /** @} */
 
-/** 
- * @defgroup AT24C32_Functions AT24C32 EEPROM 读写函数
- * @{ 
+/**
+ * @defgroup DS3231_Cache_Functions 时间缓存函数
+ * @brief DS3231 的 SQW 引脚输出1Hz方波，每个下降沿在中断中将RAM中的时间加一秒。
+ *        页面读取缓存不产生任何I2C通信，缓存每分钟或唤醒时与芯片重新同步一次。
+ *        熄屏时可以把引脚切换为闹钟2的每分钟中断，MCU 每分钟只被唤醒一次，
+ *        每个下降沿把缓存推进到下一个整分，随后在主循环中清除标志并与芯片同步。
+ * @{
  */
 
 /**
- * @brief 在AT24C32 EEPROM指定地址写入一个字节
- * @param[in] mem_addr 内存地址 (0x0000 - 0x0FFF)
- * @param[in] data 要写入的数据字节
+ * @brief 将DS3231的SQW引脚配置为1Hz方波输出
  * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
  */
-HAL_StatusTypeDef AT24C32_WriteByte(uint16_t mem_addr, uint8_t data);
+HAL_StatusTypeDef DS3231_EnableSqw1Hz(void);
 
 /**
- * @brief 从AT24C32 EEPROM指定地址读取一个字节
- * @param[in] mem_addr 内存地址 (0x0000 - 0x0FFF)
- * @return uint8_t 读取到的数据字节
+ * @brief 将DS3231的INT/SQW引脚配置为每分钟一次的闹钟2中断
+ * @details 闹钟2屏蔽分、时、日，在每分钟的0秒触发；闹钟1的中断使能保持不变，两者共用 INT 引脚。切换期间缓存保持有效，
+ *          最近一个整分的时刻由最近一次秒脉冲推算，低功耗管理在第一次闹钟前即可进入停止模式。
+ *          调用 DS3231_EnableSqw1Hz() 恢复为1Hz方波。
+ * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态，失败时保持1Hz方波
  */
-uint8_t AT24C32_ReadByte(uint16_t mem_addr);
+HAL_StatusTypeDef DS3231_EnableMinuteAlarm(void);
 
 /**
- * @brief 向AT24C32 EEPROM写入一页数据
- * @param[in] mem_addr 起始内存地址 (0x0000 - 0x0FFF)
- * @param[in] data 要写入的数据指针
- * @param[in] size 数据大小，最大32字节
- * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
- * @note 单次写入不能超过32字节且不能跨页 (e.g. from 0x1F to 0x20)。
+ * @brief 请求从芯片读取时间，刷新RAM缓存
+ * @details 异步执行，读取完成后在I2C中断中更新缓存。
+ * @return 无
  */
-HAL_StatusTypeDef AT24C32_WritePage(uint16_t mem_addr, uint8_t *data, uint16_t size);
+void DS3231_Cache_Resync(void);
 
 /**
- * @brief 从AT24C32 EEPROM读取一段数据
- * @param[in] mem_addr 起始内存地址 (0x0000 - 0x0FFF)
- * @param[out] data 数据存储缓冲区指针
- * @param[in] size 要读取的数据大小
- * @return HAL_StatusTypeDef - HAL库返回的I2C操作状态
+ * @brief 维护时间缓存，需在主循环中周期调用
+ * @details 距上次同步满 DS3231_RESYNC_INTERVAL_S 秒时重新同步；
+ *          若 SQW 方波失效，则退化为每 DS3231_FALLBACK_POLL_MS 读取一次芯片。
+ *          启用片内RTC且计数器已校准时，重新同步的间隔延长为 RTC_LSE_DISCIPLINE_S，其间每分钟用计数器核对缓存；
+ *          方波失效或芯片不应答时缓存改由计数器推进，芯片同样只按 RTC_LSE_DISCIPLINE_S 的间隔读取。
+ *          每分钟闹钟模式下每次闹钟之后清除两个闹钟标志并阻塞地同步一次。
+ *          缓存尚未同步时只提交异步读取，不在主循环中等待总线。
+ * @return 无
  */
-HAL_StatusTypeDef AT24C32_ReadPage(uint16_t mem_addr, uint8_t *data, uint16_t size);
+void DS3231_Cache_Service(void);
 
-/** 
- * @} 
+/**
+ * @brief 获取RAM中缓存的时间 (不访问I2C)
+ * @param[out] time 指向Time_t结构体的指针，用于存储时间信息
+ * @return 无
  */
+void DS3231_GetCachedTime(Time_t *time);
+
+/**
+ * @brief 获取RAM中缓存的时间的纪元秒 (不访问I2C)
+ * @return Epoch_t 标准时间 (未应用夏令时) 的纪元秒
+ */
+Epoch_t DS3231_GetCachedEpoch(void);
+
+/**
+ * @brief 获取RAM时间缓存的一致快照 (不访问I2C，不关中断)
+ * @details 纪元秒和脉冲时间戳由SQW中断同时更新，分两次读取可能分属相邻的两秒；
+ *          本函数以顺序锁读取，读取期间恰好来了脉冲时重读。不可在中断中调用。
+ *          与 DS3231_GetCachedEpoch() 不同，缓存尚未同步时不会读取芯片。
+ * @param[out] snap 快照
+ * @return bool 缓存已同步返回 true
+ */
+bool DS3231_Cache_Get(DS3231_Cache_Snap_t *snap);
+
+/**
+ * @brief 获取应用了夏令时规则的缓存时间 (不访问I2C)
+ * @param[out] time 指向Time_t结构体的指针，用于存储最终的时间信息
+ * @param[in] dst_enabled 一个布尔值，指示是否应启用夏令时计算
+ * @return 无
+ */
+void DS3231_DST_GetCachedTime(Time_t *time, bool dst_enabled);
+
+/**
+ * @brief SQW 1Hz 方波 (或每分钟闹钟) 中断处理函数
+ * @note 应在 RTC_SQW 引脚的 EXTI 回调中调用。
+ * @return 无
+ */
+void DS3231_SQW_IRQ_Handler(void);
+
+/**
+ * @brief 获取最近一次SQW脉冲的时间戳
+ * @details 供低功耗管理推算下一个脉冲的到来时间。
+ * @param[out] edge_ms 最近一次脉冲的 HAL_GetTick() 时间戳
+ * @return bool 方波正常工作时返回 true；尚未收到脉冲或已超时返回 false
+ */
+bool DS3231_SQW_Get_Last_Edge(uint32_t *edge_ms);
+
+/**
+ * @brief 获取当前的脉冲周期
+ * @return uint32_t 1Hz方波模式下为 DS3231_SQW_PERIOD_MS，每分钟闹钟模式下为 DS3231_ALARM_PERIOD_MS
+ */
+uint32_t DS3231_SQW_Get_Period(void);
+
+/** @} */
 
 /**
  * @}
@@ -0,0 +1,276 @@
+/**
+ * @file      audio.c
+ * @brief     蜂鸣器音频驱动实现
+ * @details   开始播放时先装入一段 1ms 的静音前导：更新事件 (UG) 把前导送入影子寄存器，
+ *            同时发出的 DMA 请求把第一段写入预装载寄存器；之后每个更新事件都是 "上一段生效、下一段写入"。
+ *            由 UG 发出的第一个请求即使没有被响应，第一段也会在前导结束时写入，只是前导长一段，顺序不变。
+ *            循环播放时 DMA 回到表头继续，不循环时最后一项写入后的传输完成中断置位 OPM，
+ *            倒数第二段播完的更新事件把最后一项 (静音) 送入影子寄存器并停止计数。
+ *            计数器停止时 CNT 为 0、CCR1 为 0，PWM 模式1 的输出为低电平。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "audio.h"
+#include "mark.h"
+
+/**
+ * @addtogroup Audio
+ * @{
+ */
+
+#if AUDIO_ENABLE
+
+#if MARK_ENABLE
+#error "AUDIO_ENABLE and MARK_ENABLE both use PA8"
+#endif
+
+/* Private defines -----------------------------------------------------------*/
+#define AUDIO_PCM_ARR   255U ///< PCM 模式的周期 - 1 (8位采样)
+#define AUDIO_LEAD_ARR  (AUDIO_TICK_HZ / 1000U - 1U) ///< 音调序列前导的周期 - 1 (1ms)
+#define AUDIO_DBA_ARR   11U  ///< ARR 相对 TIM1->CR1 的字偏移 (DMA 突发的起始寄存器)
+#define AUDIO_DBL_STEP  2U   ///< 每次突发传输 3 个寄存器 (ARR、RCR、CCR1)
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 播放方式
+ */
+typedef enum {
+    AUDIO_MODE_NONE = 0, ///< 未播放过
+    AUDIO_MODE_TUNE,     ///< 音调序列
+    AUDIO_MODE_PCM       ///< PCM 片段
+} Audio_Mode_e;
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t audio_mode;     ///< 最近一次的播放方式 (时钟切换时据此重算分频)
+static uint16_t audio_rate_hz; ///< 最近一次 PCM 片段的采样率
+
+/* Private function prototypes -----------------------------------------------*/
+void DMA1_Channel2_IRQHandler(void);
+static uint32_t audio_timclk(void);
+static uint16_t audio_pcm_rcr(uint16_t rate_hz);
+static void audio_start(uint32_t cpar, uint32_t cmar, uint16_t cndtr, uint32_t ccr_dma,
+                        uint16_t psc, uint16_t arr, uint16_t rcr, uint32_t dcr);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 获取 TIM1 的计数时钟
+ * @details APB2 分频不为 1 时定时器时钟为 PCLK2 的两倍。
+ * @return uint32_t 定时器时钟 (Hz)
+ */
+static uint32_t audio_timclk(void)
+{
+    uint32_t timclk = HAL_RCC_GetPCLK2Freq();
+
+    if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_HCLK_DIV1 << 3) {
+        timclk *= 2U;
+    }
+    return timclk;
+}
+
+/**
+ * @brief 计算 PCM 模式的重复计数
+ * @param[in] rate_hz 采样率
+ * @return uint16_t RCR 的值 (0~255)
+ */
+static uint16_t audio_pcm_rcr(uint16_t rate_hz)
+{
+    uint32_t periods = (audio_timclk() / (AUDIO_PCM_ARR + 1U) + rate_hz / 2U) / rate_hz;
+
+    if (periods == 0) {
+        periods = 1;
+    } else if (periods > 256U) {
+        periods = 256U;
+    }
+    return (uint16_t)(periods - 1U);
+}
+
+/**
+ * @brief 设置 DMA 和 TIM1 并开始播放
+ * @details 前导为静音 (CCR1 为 0)，其周期和重复计数由调用者给出。
+ * @param[in] cpar DMA 的外设地址 (TIM1->DMAR 或 TIM1->CCR1)
+ * @param[in] cmar DMA 的存储器地址
+ * @param[in] cndtr 传输次数
+ * @param[in] ccr_dma DMA 通道的数据宽度、循环和中断设置
+ * @param[in] psc 预分频
+ * @param[in] arr 前导的周期 - 1
+ * @param[in] rcr 前导的重复计数
+ * @param[in] dcr DMA 突发的设置，0 为不使用突发
+ * @return 无
+ */
+static void audio_start(uint32_t cpar, uint32_t cmar, uint16_t cndtr, uint32_t ccr_dma,
+                        uint16_t psc, uint16_t arr, uint16_t rcr, uint32_t dcr)
+{
+    Audio_Stop();
+
+    DMA1->IFCR = DMA_IFCR_CGIF2;
+    DMA1_Channel2->CPAR = cpar;
+    DMA1_Channel2->CMAR = cmar;
+    DMA1_Channel2->CNDTR = cndtr;
+    DMA1_Channel2->CCR = ccr_dma | DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_PSIZE_0 | DMA_CCR_PL_1;
+    DMA1_Channel2->CCR |= DMA_CCR_EN;
+
+    TIM1->PSC = psc;
+    TIM1->ARR = arr;
+    TIM1->RCR = rcr;
+    TIM1->CCR1 = 0;
+    TIM1->DCR = dcr;
+    TIM1->DIER = TIM_DIER_CC1DE;
+    TIM1->EGR = TIM_EGR_UG; // 前导送入影子寄存器，同时请求第一段
+    TIM1->CR1 = TIM_CR1_ARPE | TIM_CR1_CEN;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief DMA1 通道2中断：最后一项已写入预装载寄存器
+ * @details 只在不循环时使能。置位 OPM 后计数器在正在播放的一段结束时停止，最后一项 (静音) 不再播放完整。
+ * @return 无
+ */
+void DMA1_Channel2_IRQHandler(void)
+{
+    DMA1->IFCR = DMA_IFCR_CGIF2;
+    TIM1->CR1 |= TIM_CR1_OPM;
+}
+
+#endif /* AUDIO_ENABLE */
+
+/**
+ * @brief 初始化蜂鸣器
+ * @details 输出比较使能预装载，CR2.CCDS 使 CC1 的 DMA 请求在更新事件发出 (TIM1_CH1 对应 DMA1 通道2)。
+ *          高级定时器的输出还需要置位 BDTR.MOE。
+ * @return 无
+ */
+void Audio_Init(void)
+{
+#if AUDIO_ENABLE
+    GPIO_InitTypeDef gpio = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_TIM1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    TIM1->CR1 = 0;
+    TIM1->CR2 = TIM_CR2_CCDS;
+    TIM1->CCMR1 = TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1PE;
+    TIM1->CCR1 = 0;
+    TIM1->CCER = TIM_CCER_CC1E;
+    TIM1->BDTR = TIM_BDTR_MOE;
+    TIM1->EGR = TIM_EGR_UG;
+
+    gpio.Pin = AUDIO_PIN;
+    gpio.Mode = GPIO_MODE_AF_PP;
+    gpio.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(AUDIO_PORT, &gpio);
+
+    DMA1_Channel2->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF2;
+    HAL_NVIC_SetPriority(DMA1_Channel2_IRQn, IRQ_PRIO_BACKGROUND, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+#endif
+}
+
+/**
+ * @brief 播放一个音调序列
+ * @details DMA 为 16 位到 16 位，每个更新事件突发写入一段 (3 个半字) 到 TIM1->DMAR。
+ * @param[in] steps 序列
+ * @param[in] count 段数
+ * @param[in] loop 是否循环播放
+ * @return bool 已开始播放返回 true
+ */
+bool Audio_Play_Tune(const Audio_Step_t *steps, uint16_t count, bool loop)
+{
+#if AUDIO_ENABLE
+    if (steps == NULL || count == 0 || count > 0xFFFFU / 3U) {
+        return false;
+    }
+    audio_mode = AUDIO_MODE_TUNE;
+    audio_start((uint32_t)&TIM1->DMAR, (uint32_t)steps, (uint16_t)(count * 3U),
+                DMA_CCR_MSIZE_0 | (loop ? DMA_CCR_CIRC : DMA_CCR_TCIE),
+                (uint16_t)(audio_timclk() / AUDIO_TICK_HZ - 1U), AUDIO_LEAD_ARR, 0,
+                (AUDIO_DBL_STEP << TIM_DCR_DBL_Pos) | (AUDIO_DBA_ARR << TIM_DCR_DBA_Pos));
+    return true;
+#else
+    (void)steps;
+    (void)count;
+    (void)loop;
+    return false;
+#endif
+}
+
+/**
+ * @brief 播放一个 PCM 片段
+ * @details DMA 为 8 位到 16 位 (高字节补零)，每个更新事件写入一个采样到 TIM1->CCR1，前导为一个静音采样。
+ * @param[in] samples 采样
+ * @param[in] count 采样数
+ * @param[in] rate_hz 采样率
+ * @return bool 已开始播放返回 true
+ */
+bool Audio_Play_Pcm(const uint8_t *samples, uint16_t count, uint16_t rate_hz)
+{
+#if AUDIO_ENABLE
+    if (samples == NULL || count == 0 || samples[count - 1U] != 0 || rate_hz < AUDIO_PCM_MIN_HZ) {
+        return false;
+    }
+    audio_mode = AUDIO_MODE_PCM;
+    audio_rate_hz = rate_hz;
+    audio_start((uint32_t)&TIM1->CCR1, (uint32_t)samples, count, DMA_CCR_TCIE,
+                0, AUDIO_PCM_ARR, audio_pcm_rcr(rate_hz), 0);
+    return true;
+#else
+    (void)samples;
+    (void)count;
+    (void)rate_hz;
+    return false;
+#endif
+}
+
+/**
+ * @brief 停止播放，输出低电平
+ * @details 先停止计数和 DMA 请求，再把 CCR1 清零并以 UG 送入影子寄存器 (同时清零 CNT)。
+ * @return 无
+ */
+void Audio_Stop(void)
+{
+#if AUDIO_ENABLE
+    TIM1->CR1 = 0;
+    TIM1->DIER = 0;
+    DMA1_Channel2->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF2;
+    TIM1->CCR1 = 0;
+    TIM1->EGR = TIM_EGR_UG;
+#endif
+}
+
+/**
+ * @brief 查询是否正在播放
+ * @return bool 正在播放返回 true
+ */
+bool Audio_Is_Playing(void)
+{
+#if AUDIO_ENABLE
+    return (TIM1->CR1 & TIM_CR1_CEN) != 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 系统时钟切换后重新设置 TIM1 的分频
+ * @return 无
+ */
+void Audio_Clock_Changed(void)
+{
+#if AUDIO_ENABLE
+    if (audio_mode == AUDIO_MODE_TUNE) {
+        TIM1->PSC = audio_timclk() / AUDIO_TICK_HZ - 1U;
+    } else if (audio_mode == AUDIO_MODE_PCM && Audio_Is_Playing()) {
+        TIM1->RCR = audio_pcm_rcr(audio_rate_hz);
+    }
+#endif
+}
+
+/** @} */
@@ -0,0 +1,127 @@
+/**
+ * @file      audio.h
+ * @brief     蜂鸣器音频驱动头文件
+ * @details   无源蜂鸣器 (经三极管) 接在 PA8 (TIM1_CH1)，TIM1 输出 PWM，DMA1 通道2 在每个更新事件
+ *            把下一段的参数写入 TIM1 的预装载寄存器 (CR2.CCDS = 1 时 CC1 的 DMA 请求在更新事件发出)，
+ *            数据直接取自 Flash 中的表，播放期间不需要 CPU：页面动画、总线事务和睡眠模式都不影响音调和节奏。
+ *            两种播放方式：
+ *            - 音调序列：计数频率为 AUDIO_TICK_HZ，每一段为 | ARR | RCR | CCR1 |，以 DMA 突发 (DCR/DMAR)
+ *              一次写入三个寄存器；一段持续 RCR + 1 个周期，即每段最多 256 个周期。可以循环播放 (闹钟)。
+ *            - PCM 片段：ARR 固定为 255 (72MHz 下载波约 281kHz，远超出听觉范围)，RCR 把更新事件分频到采样率，
+ *              每个采样 (8位无符号) 直接写入 CCR1 作为占空比。
+ *            最后一项写入预装载寄存器后的传输完成中断只置位单脉冲模式 (OPM)，计数器在正在播放的一段结束时自行停止，
+ *            整个序列只需要这一次中断。序列和片段的最后一项必须是静音 (CCR1 为 0)，计数器停在这一项上，输出保持低电平。
+ *            停止模式下定时器不工作，播放期间不进入停止模式；系统时钟切换后由 Audio_Clock_Changed() 重算分频。
+ *            TIM1 和 DMA1 通道2 不在 CubeMX 配置中，由本模块直接操作寄存器，中断服务函数也在本模块中。
+ *            AUDIO_ENABLE 为 0 (默认，板上没有蜂鸣器) 时所有函数为空操作。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __AUDIO_H
+#define __AUDIO_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup Audio 蜂鸣器音频
+ * @brief 提供了由 TIM1 PWM 和 DMA 播放音调序列和 PCM 片段的功能。
+ * @{
+ */
+
+/**
+ * @defgroup Audio_Config 蜂鸣器音频配置
+ * @details PA8 也是时序标记的 MARK_SLEEP 引脚，两者不能同时开启。
+ * @{
+ */
+#ifndef AUDIO_ENABLE
+#define AUDIO_ENABLE     0        ///< 为 1 时启用蜂鸣器 (需要在 PA8 接上无源蜂鸣器)
+#endif
+#define AUDIO_PORT       GPIOA    ///< 蜂鸣器所接的引脚 (TIM1_CH1)
+#define AUDIO_PIN        GPIO_PIN_8
+#define AUDIO_TICK_HZ    1000000U ///< 音调序列中 TIM1 的计数频率 (Hz)，须能整除定时器时钟 (8MHz 和 72MHz)
+#define AUDIO_PCM_MIN_HZ 1200U    ///< PCM 的最低采样率 (RCR 只有8位)
+/** @} */
+
+/**
+ * @brief 音调序列的一段，成员顺序与 TIM1 的 ARR、RCR、CCR1 寄存器相同 (DMA 突发依次写入)
+ */
+typedef struct {
+    uint16_t arr; ///< 周期 - 1 (计数值)
+    uint16_t rcr; ///< 持续的周期数 - 1 (0~255)
+    uint16_t ccr; ///< 高电平的计数值，0 为静音
+} Audio_Step_t;
+
+/**
+ * @brief 一段音调
+ * @details 持续的周期数 hz * ms / 1000 须在 1~256 之间 (如 1kHz 最长 256ms)，更长的音符重复写几段，
+ *          相同的频率在段与段之间连续，不会听到间断。
+ * @param hz 频率 (Hz)
+ * @param ms 持续时间 (ms)
+ */
+#define AUDIO_TONE(hz, ms) { (uint16_t)(AUDIO_TICK_HZ / (hz) - 1U), (uint16_t)((hz) * (ms) / 1000U - 1U), \
+                             (uint16_t)(AUDIO_TICK_HZ / (hz) / 2U) }
+
+/**
+ * @brief 一段静音 (1~256ms)
+ * @param ms 持续时间 (ms)
+ */
+#define AUDIO_REST(ms)     { (uint16_t)(AUDIO_TICK_HZ / 1000U - 1U), (uint16_t)((ms) - 1U), 0U }
+
+/** @brief 音调序列的结尾 (静音，计数器停在这一段上) */
+#define AUDIO_END          AUDIO_REST(1)
+
+/**
+ * @brief 初始化蜂鸣器
+ * @details 配置 PA8 为复用推挽输出、TIM1 CH1 为 PWM 模式1 (输出低电平)、DMA1 通道2 的中断。
+ *          AUDIO_ENABLE 为 0 时为空操作。
+ * @return 无
+ */
+void Audio_Init(void);
+
+/**
+ * @brief 播放一个音调序列
+ * @details 正在播放的声音被打断。循环播放时 DMA 为循环模式，直到 Audio_Stop() 为止，不产生中断。
+ * @param[in] steps 序列，须为 Flash 中的常量 (或在播放期间保持不变)，不循环时最后一项须为 AUDIO_END
+ * @param[in] count 段数
+ * @param[in] loop 是否循环播放
+ * @return bool 已开始播放返回 true；参数无效或 AUDIO_ENABLE 为 0 时返回 false
+ */
+bool Audio_Play_Tune(const Audio_Step_t *steps, uint16_t count, bool loop);
+
+/**
+ * @brief 播放一个 PCM 片段
+ * @details 正在播放的声音被打断。
+ * @param[in] samples 8位无符号采样，须在播放期间保持不变，最后一个采样须为 0
+ * @param[in] count 采样数
+ * @param[in] rate_hz 采样率 (AUDIO_PCM_MIN_HZ 以上)
+ * @return bool 已开始播放返回 true；参数无效或 AUDIO_ENABLE 为 0 时返回 false
+ */
+bool Audio_Play_Pcm(const uint8_t *samples, uint16_t count, uint16_t rate_hz);
+
+/**
+ * @brief 停止播放，输出低电平
+ * @return 无
+ */
+void Audio_Stop(void);
+
+/**
+ * @brief 查询是否正在播放
+ * @return bool 正在播放返回 true，此时不能进入停止模式
+ */
+bool Audio_Is_Playing(void);
+
+/**
+ * @brief 系统时钟切换后重新设置 TIM1 的分频
+ * @details 音调序列重算预分频，PCM 重算重复计数；两者都是预装载寄存器，在当前一段结束时生效。
+ * @return 无
+ */
+void Audio_Clock_Changed(void);
+
+/** @} */
+
+#endif /* __AUDIO_H */
@@ -0,0 +1,49 @@
+/**
+ * @file      cobs.c
+ * @brief     COBS 编码实现
+ * @details   每个编码块的首字节 c 表示之后有 c-1 个非零字节，c 不为 0xFF 时块后隐含一个 0。
+ * @author    SandOcean
+ * @date      2025-09-24
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "cobs.h"
+
+/**
+ * @addtogroup Cobs
+ * @{
+ */
+
+/**
+ * @brief COBS 编码
+ * @param[in] in 原始数据
+ * @param[in] len 原始长度
+ * @param[out] out 编码结果 (不含分隔符)，长度至少为 COBS_ENCODED_MAX(len)
+ * @return uint16_t 编码后的长度
+ */
+uint16_t COBS_Encode(const uint8_t *in, uint16_t len, uint8_t *out)
+{
+    uint16_t code_at = 0;
+    uint16_t o = 1;
+    uint8_t code = 1;
+
+    for (uint16_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[code_at] = code;
+            code_at = o++;
+            code = 1;
+        } else {
+            out[o++] = in[i];
+            if (++code == 0xFF) {
+                out[code_at] = code;
+                code_at = o++;
+                code = 1;
+            }
+        }
+    }
+    out[code_at] = code;
+    return o;
+}
+
+/** @} */
@@ -0,0 +1,39 @@
+/**
+ * @file      cobs.h
+ * @brief     COBS (Consistent Overhead Byte Stuffing) 编码头文件
+ * @details   编码后的数据不含 0x00，可以用 0x00 作为帧分隔符。每 254 字节最多多出 1 字节。
+ *            串口远程控制协议 (app_remote) 和二进制跟踪 (trace) 共用同一种帧格式。
+ * @author    SandOcean
+ * @date      2025-09-24
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __COBS_H
+#define __COBS_H
+
+#include <stdint.h>
+
+/**
+ * @defgroup Cobs COBS编码
+ * @brief 提供了串口帧的 COBS 编码。
+ * @{
+ */
+
+/**
+ * @brief 编码 len 字节数据所需的最大输出长度 (不含分隔符)
+ */
+#define COBS_ENCODED_MAX(len) ((len) + (len) / 254 + 1)
+
+/**
+ * @brief COBS 编码
+ * @param[in] in 原始数据
+ * @param[in] len 原始长度
+ * @param[out] out 编码结果 (不含分隔符)，长度至少为 COBS_ENCODED_MAX(len)
+ * @return uint16_t 编码后的长度
+ */
+uint16_t COBS_Encode(const uint8_t *in, uint16_t len, uint8_t *out);
+
+/** @} */
+
+#endif /* __COBS_H */
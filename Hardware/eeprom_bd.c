@@ -0,0 +1,575 @@
+/**
+ * @file      eeprom_bd.c
+ * @brief     AT24C32 块设备层
+ * @details   每个缓存页记录哪些字节已知 (valid) 和哪些字节尚未写出 (dirty)，脏字节一定是已知的。
+ *            刷新时每次取一页中从第一个脏字节开始、到最后一个脏字节或第一个未知字节为止的一段写出
+ *            (中间夹着的干净字节照原样重写)。写出的数据先拷贝到发送缓冲区，写入期间缓存页可以继续被修改；写入失败时把这一段重新标记为脏。
+ *            缓存的读写在主循环和 I2C 回调中都会发生，修改缓存的几条语句在关中断下完成。
+ * @author    SandOcean
+ * @date      2025-10-06
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "eeprom_bd.h"
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @addtogroup EEPROM_BD
+ * @{
+ */
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 缓存页
+ */
+typedef struct {
+    bool used;                         ///< 是否已分配给某一页
+    uint16_t page;                     ///< 页号 (地址 / EEPROM_BD_PAGE_SIZE)
+    uint16_t stamp;                    ///< 最近一次使用的时间戳，用于替换
+    uint32_t valid;                    ///< 已知字节的位图
+    uint32_t dirty;                    ///< 未写出字节的位图
+    bool flushing;                     ///< 有一段正在写出，此时不能被替换
+    uint8_t data[EEPROM_BD_PAGE_SIZE]; ///< 页数据
+} BD_Line_t;
+
+/** 编译期检查：位图按32位保存 */
+typedef char bd_page_size_check[(EEPROM_BD_PAGE_SIZE == 32) ? 1 : -1];
+
+/* Private variables ---------------------------------------------------------*/
+static BD_Line_t bd_lines[EEPROM_BD_CACHE_PAGES]; ///< 缓存页
+static uint16_t bd_clock;                         ///< 使用时间戳的计数
+
+/**
+ * @brief 刷新的状态
+ */
+static struct {
+    volatile bool busy;               ///< 是否有刷新在进行
+    uint8_t line;                     ///< 正在写出的缓存页
+    uint32_t mask;                    ///< 正在写出的字节
+    uint8_t buf[EEPROM_BD_PAGE_SIZE]; ///< 发送缓冲区
+    I2C_Bus_Callback_t cb;            ///< 完成回调
+    void *ctx;                        ///< 回调上下文
+} bd_flush;
+
+/**
+ * @brief 异步读的状态
+ */
+static struct {
+    volatile bool busy;    ///< 是否有读请求在进行
+    uint16_t addr;         ///< 起始地址
+    uint8_t *data;         ///< 调用者的缓冲区
+    uint16_t size;         ///< 长度
+    I2C_Bus_Callback_t cb; ///< 完成回调
+    void *ctx;             ///< 回调上下文
+} bd_read;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t bd_mask(uint8_t first, uint8_t count);
+static uint16_t bd_chunk(uint16_t addr, uint16_t size);
+static int8_t bd_alloc(uint16_t page);
+static bool bd_lookup(uint16_t addr, uint8_t *data, uint16_t size);
+static void bd_fill(uint16_t addr, uint8_t *data, uint16_t size);
+static bool bd_take_run(uint16_t *addr, uint8_t *count);
+static void bd_release_run(HAL_StatusTypeDef status);
+static HAL_StatusTypeDef bd_flush_next(void);
+static void bd_flush_finish(HAL_StatusTypeDef status);
+static void bd_flush_cb(HAL_StatusTypeDef status, void *ctx);
+static void bd_read_cb(HAL_StatusTypeDef status, void *ctx);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 生成一页内连续字节的位图
+ * @param[in] first 第一个字节在页内的偏移
+ * @param[in] count 字节数 (1 - 32)
+ * @return uint32_t 位图
+ */
+static uint32_t bd_mask(uint8_t first, uint8_t count)
+{
+    return ((count >= 32) ? 0xFFFFFFFFUL : ((1UL << count) - 1UL)) << first;
+}
+
+/**
+ * @brief 计算从 addr 开始、不越过页边界的长度
+ * @param[in] addr 地址
+ * @param[in] size 剩余长度
+ * @return uint16_t 本页内的长度
+ */
+static uint16_t bd_chunk(uint16_t addr, uint16_t size)
+{
+    uint16_t room = (uint16_t)(EEPROM_BD_PAGE_SIZE - addr % EEPROM_BD_PAGE_SIZE);
+    return (size < room) ? size : room;
+}
+
+/**
+ * @brief 取得一页的缓存页，没有时替换最久未使用的干净页
+ * @note 需在关中断下调用
+ * @param[in] page 页号
+ * @return int8_t 缓存页下标，所有缓存页都有未写出的数据时为 -1
+ */
+static int8_t bd_alloc(uint16_t page)
+{
+    int8_t victim = -1;
+    uint16_t oldest = 0;
+
+    for (uint8_t i = 0; i < EEPROM_BD_CACHE_PAGES; i++) {
+        BD_Line_t *line = &bd_lines[i];
+        uint16_t age = (uint16_t)(bd_clock - line->stamp);
+
+        if (line->used && line->page == page) {
+            line->stamp = ++bd_clock;
+            return (int8_t)i;
+        }
+        if (line->dirty != 0 || line->flushing) {
+            continue;
+        }
+        if (!line->used) {
+            age = 0xFFFF; // 未使用的页优先
+        }
+        if (victim < 0 || age > oldest) {
+            victim = (int8_t)i;
+            oldest = age;
+        }
+    }
+    if (victim >= 0) {
+        BD_Line_t *line = &bd_lines[victim];
+        line->used = true;
+        line->page = page;
+        line->valid = 0;
+        line->dirty = 0;
+        line->stamp = ++bd_clock;
+    }
+    return victim;
+}
+
+/**
+ * @brief 从缓存读取
+ * @note 需在关中断下调用
+ * @param[in] addr 起始地址
+ * @param[out] data 数据缓冲区
+ * @param[in] size 长度
+ * @return bool 请求的字节全部在缓存中时返回 true (否则缓冲区内容无意义)
+ */
+static bool bd_lookup(uint16_t addr, uint8_t *data, uint16_t size)
+{
+    while (size > 0) {
+        uint16_t n = bd_chunk(addr, size);
+        uint8_t off = (uint8_t)(addr % EEPROM_BD_PAGE_SIZE);
+        uint32_t mask = bd_mask(off, (uint8_t)n);
+        bool hit = false;
+
+        for (uint8_t i = 0; i < EEPROM_BD_CACHE_PAGES; i++) {
+            BD_Line_t *line = &bd_lines[i];
+            if (line->used && line->page == addr / EEPROM_BD_PAGE_SIZE && (line->valid & mask) == mask) {
+                memcpy(data, &line->data[off], n);
+                line->stamp = ++bd_clock;
+                hit = true;
+                break;
+            }
+        }
+        if (!hit) {
+            return false;
+        }
+        addr += n;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+/**
+ * @brief 把从 EEPROM 读到的数据合并进缓存
+ * @details 缓存中的脏字节比芯片中的新，反过来覆盖调用者缓冲区中的对应字节。
+ * @note 需在关中断下调用
+ * @param[in] addr 起始地址
+ * @param[in,out] data 读到的数据
+ * @param[in] size 长度
+ * @return 无
+ */
+static void bd_fill(uint16_t addr, uint8_t *data, uint16_t size)
+{
+    while (size > 0) {
+        uint16_t n = bd_chunk(addr, size);
+        uint8_t off = (uint8_t)(addr % EEPROM_BD_PAGE_SIZE);
+        int8_t idx = bd_alloc(addr / EEPROM_BD_PAGE_SIZE);
+
+        if (idx >= 0) {
+            BD_Line_t *line = &bd_lines[idx];
+            for (uint8_t i = 0; i < n; i++) {
+                uint32_t bit = 1UL << (off + i);
+                if (line->dirty & bit) {
+                    data[i] = line->data[off + i];
+                } else {
+                    line->data[off + i] = data[i];
+                    line->valid |= bit;
+                }
+            }
+        }
+        addr += n;
+        data += n;
+        size -= n;
+    }
+}
+
+/**
+ * @brief 取出下一段要写出的脏字节，拷贝到 bd_flush.buf
+ * @note 需在关中断下调用。取出的字节清除脏标记，之后须调用 bd_release_run()。
+ * @param[out] addr 这一段的起始地址
+ * @param[out] count 这一段的长度
+ * @return bool 没有脏字节时返回 false
+ */
+static bool bd_take_run(uint16_t *addr, uint8_t *count)
+{
+    for (uint8_t i = 0; i < EEPROM_BD_CACHE_PAGES; i++) {
+        BD_Line_t *line = &bd_lines[i];
+        uint8_t first = 0;
+        uint8_t last;
+
+        if (line->dirty == 0 || line->flushing) {
+            continue;
+        }
+        while (!(line->dirty & (1UL << first))) {
+            first++;
+        }
+        // 向后延伸到未知字节为止，再退回到最后一个脏字节 (脏字节都是已知的)
+        last = first;
+        while (last + 1 < EEPROM_BD_PAGE_SIZE && (line->valid & (1UL << (last + 1)))) {
+            last++;
+        }
+        while (!(line->dirty & (1UL << last))) {
+            last--;
+        }
+
+        *addr = (uint16_t)(line->page * EEPROM_BD_PAGE_SIZE + first);
+        *count = (uint8_t)(last - first + 1);
+        memcpy(bd_flush.buf, &line->data[first], *count);
+        bd_flush.line = i;
+        bd_flush.mask = bd_mask(first, *count) & line->dirty;
+        line->dirty &= ~bd_flush.mask;
+        line->flushing = true;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 一段写出结束，失败时重新标记为脏
+ * @note 需在关中断下调用
+ * @param[in] status 写入结果
+ * @return 无
+ */
+static void bd_release_run(HAL_StatusTypeDef status)
+{
+    BD_Line_t *line = &bd_lines[bd_flush.line];
+
+    if (status != HAL_OK) {
+        line->dirty |= bd_flush.mask;
+    }
+    line->flushing = false;
+}
+
+/**
+ * @brief 提交下一段，没有脏字节时结束刷新
+ * @return HAL_StatusTypeDef 提交结果，失败时这一段已重新标记为脏
+ */
+static HAL_StatusTypeDef bd_flush_next(void)
+{
+    HAL_StatusTypeDef status;
+    uint16_t addr;
+    uint8_t count;
+    bool more;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    more = bd_take_run(&addr, &count);
+    __set_PRIMASK(primask);
+
+    if (!more) {
+        bd_flush_finish(HAL_OK);
+        return HAL_OK;
+    }
+    status = AT24C32_WritePage_Async(addr, bd_flush.buf, count, bd_flush_cb, NULL);
+    if (status != HAL_OK) {
+        __disable_irq();
+        bd_release_run(status);
+        __set_PRIMASK(primask);
+    }
+    return status;
+}
+
+/**
+ * @brief 结束刷新并调用完成回调
+ * @param[in] status 刷新结果
+ * @return 无
+ */
+static void bd_flush_finish(HAL_StatusTypeDef status)
+{
+    I2C_Bus_Callback_t cb = bd_flush.cb;
+    void *ctx = bd_flush.ctx;
+
+    bd_flush.busy = false;
+    if (cb != NULL) {
+        cb(status, ctx);
+    }
+}
+
+/**
+ * @brief 一段写出的完成回调 (I2C中断上下文)
+ * @param[in] status 写任务结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void bd_flush_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+
+    bd_release_run(status);
+    if (status == HAL_OK) {
+        status = bd_flush_next();
+    }
+    if (status != HAL_OK) {
+        bd_flush_finish(status);
+    }
+}
+
+/**
+ * @brief 异步读的完成回调 (I2C中断上下文)
+ * @param[in] status 读取结果
+ * @param[in] ctx 未使用
+ * @return 无
+ */
+static void bd_read_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    I2C_Bus_Callback_t cb = bd_read.cb;
+    void *cb_ctx = bd_read.ctx;
+
+    (void)ctx;
+    if (status == HAL_OK) {
+        bd_fill(bd_read.addr, bd_read.data, bd_read.size);
+    }
+    bd_read.busy = false;
+    if (cb != NULL) {
+        cb(status, cb_ctx);
+    }
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 读取数据 (阻塞)
+ * @param[in] addr 起始地址
+ * @param[out] data 数据缓冲区
+ * @param[in] size 长度
+ * @return HAL_StatusTypeDef 读取结果
+ */
+HAL_StatusTypeDef EEPROM_BD_Read(uint16_t addr, void *data, uint16_t size)
+{
+    HAL_StatusTypeDef status;
+    bool hit;
+    uint32_t primask = __get_PRIMASK();
+
+    if (data == NULL || size == 0 || (uint32_t)addr + size > EEPROM_BD_SIZE) {
+        return HAL_ERROR;
+    }
+
+    __disable_irq();
+    hit = bd_lookup(addr, (uint8_t *)data, size);
+    __set_PRIMASK(primask);
+    if (hit) {
+        return HAL_OK;
+    }
+
+    status = AT24C32_ReadPage(addr, (uint8_t *)data, size);
+    if (status == HAL_OK) {
+        __disable_irq();
+        bd_fill(addr, (uint8_t *)data, size);
+        __set_PRIMASK(primask);
+    }
+    return status;
+}
+
+/**
+ * @brief 读取数据 (非阻塞)
+ * @param[in] addr 起始地址
+ * @param[out] data 数据缓冲区
+ * @param[in] size 长度
+ * @param[in] cb 完成回调
+ * @param[in] ctx 回调上下文
+ * @return HAL_StatusTypeDef 是否已开始
+ */
+HAL_StatusTypeDef EEPROM_BD_Read_Async(uint16_t addr, void *data, uint16_t size,
+                                       I2C_Bus_Callback_t cb, void *ctx)
+{
+    HAL_StatusTypeDef status;
+    bool hit;
+    uint32_t primask = __get_PRIMASK();
+
+    if (data == NULL || size == 0 || (uint32_t)addr + size > EEPROM_BD_SIZE) {
+        return HAL_ERROR;
+    }
+
+    __disable_irq();
+    hit = bd_lookup(addr, (uint8_t *)data, size);
+    if (!hit && bd_read.busy) {
+        __set_PRIMASK(primask);
+        return HAL_BUSY;
+    }
+    if (!hit) {
+        bd_read.busy = true;
+        bd_read.addr = addr;
+        bd_read.data = (uint8_t *)data;
+        bd_read.size = size;
+        bd_read.cb = cb;
+        bd_read.ctx = ctx;
+    }
+    __set_PRIMASK(primask);
+
+    if (hit) {
+        if (cb != NULL) {
+            cb(HAL_OK, ctx);
+        }
+        return HAL_OK;
+    }
+    status = AT24C32_ReadPage_Async(addr, (uint8_t *)data, size, bd_read_cb, NULL);
+    if (status != HAL_OK) {
+        bd_read.busy = false;
+    }
+    return status;
+}
+
+/**
+ * @brief 写入数据到缓存
+ * @param[in] addr 起始地址
+ * @param[in] data 数据
+ * @param[in] size 长度
+ * @return HAL_StatusTypeDef 写入结果
+ */
+HAL_StatusTypeDef EEPROM_BD_Write(uint16_t addr, const void *data, uint16_t size)
+{
+    const uint8_t *src = (const uint8_t *)data;
+    uint32_t primask = __get_PRIMASK();
+
+    if (data == NULL || size == 0 || (uint32_t)addr + size > EEPROM_BD_SIZE) {
+        return HAL_ERROR;
+    }
+
+    while (size > 0) {
+        uint16_t n = bd_chunk(addr, size);
+        uint8_t off = (uint8_t)(addr % EEPROM_BD_PAGE_SIZE);
+        int8_t idx;
+
+        __disable_irq();
+        idx = bd_alloc(addr / EEPROM_BD_PAGE_SIZE);
+        if (idx < 0) {
+            __set_PRIMASK(primask);
+            return HAL_BUSY;
+        }
+        for (uint8_t i = 0; i < n; i++) {
+            BD_Line_t *line = &bd_lines[idx];
+            uint32_t bit = 1UL << (off + i);
+            if (!(line->valid & bit) || line->data[off + i] != src[i]) {
+                line->data[off + i] = src[i];
+                line->valid |= bit;
+                line->dirty |= bit;
+            }
+        }
+        __set_PRIMASK(primask);
+
+        addr += n;
+        src += n;
+        size -= n;
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief 写出全部脏字节 (阻塞)
+ * @return HAL_StatusTypeDef 写入结果
+ */
+HAL_StatusTypeDef EEPROM_BD_Flush(void)
+{
+    HAL_StatusTypeDef status = HAL_OK;
+    uint16_t addr;
+    uint8_t count;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (bd_flush.busy) {
+        __set_PRIMASK(primask);
+        return HAL_BUSY;
+    }
+    bd_flush.busy = true;
+    bd_flush.cb = NULL;
+    __set_PRIMASK(primask);
+
+    for (;;) {
+        bool more;
+
+        __disable_irq();
+        more = bd_take_run(&addr, &count);
+        __set_PRIMASK(primask);
+        if (!more) {
+            break;
+        }
+
+        status = AT24C32_WritePage(addr, bd_flush.buf, count);
+        __disable_irq();
+        bd_release_run(status);
+        __set_PRIMASK(primask);
+        if (status != HAL_OK) {
+            break;
+        }
+    }
+    bd_flush.busy = false;
+    return status;
+}
+
+/**
+ * @brief 在后台写出全部脏字节
+ * @param[in] cb 完成回调
+ * @param[in] ctx 回调上下文
+ * @return HAL_StatusTypeDef 是否已开始
+ */
+HAL_StatusTypeDef EEPROM_BD_Flush_Async(I2C_Bus_Callback_t cb, void *ctx)
+{
+    HAL_StatusTypeDef status;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (bd_flush.busy) {
+        __set_PRIMASK(primask);
+        return HAL_BUSY;
+    }
+    bd_flush.busy = true;
+    bd_flush.cb = cb;
+    bd_flush.ctx = ctx;
+    __set_PRIMASK(primask);
+
+    status = bd_flush_next();
+    if (status != HAL_OK) {
+        bd_flush.busy = false; // 第一段就未能提交，不调用回调
+    }
+    return status;
+}
+
+/**
+ * @brief 查询是否有未写出的数据
+ * @return bool 有脏字节或刷新在进行时返回 true
+ */
+bool EEPROM_BD_Is_Dirty(void)
+{
+    if (bd_flush.busy) {
+        return true;
+    }
+    for (uint8_t i = 0; i < EEPROM_BD_CACHE_PAGES; i++) {
+        if (bd_lines[i].dirty != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @} */
@@ -0,0 +1,105 @@
+/**
+ * @file      eeprom_bd.h
+ * @brief     AT24C32 块设备层头文件
+ * @details   在 AT24C32 驱动之上提供按页 (32字节) 缓存的读写接口。写入只修改RAM中的缓存页，
+ *            与缓存内容相同的字节不标记为脏；同一页内先后写入的多个字段在刷新时合并为一次页写入，
+ *            内容没有变化的页不产生写周期。刷新 (EEPROM_BD_Flush_Async) 逐页写出全部脏字节，
+ *            一次刷新会把其他使用者在此期间写入的数据一起写出。
+ *            缓存页按最近使用顺序替换，含脏字节的页在写出前不会被替换。
+ *            通过本模块访问的区域不能再直接调用 AT24C32_* 函数写入，否则缓存内容会过期。
+ * @author    SandOcean
+ * @date      2025-10-06
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __EEPROM_BD_H
+#define __EEPROM_BD_H
+
+#include "main.h"
+#include "AT24C32.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup EEPROM_BD EEPROM块设备
+ * @brief 带页缓存和写合并的 AT24C32 读写接口。
+ * @{
+ */
+
+/**
+ * @defgroup EEPROM_BD_Config EEPROM块设备配置
+ * @{
+ */
+#define EEPROM_BD_PAGE_SIZE   32   ///< 缓存页大小，等于 AT24C32 的页大小
+#define EEPROM_BD_CACHE_PAGES 4    ///< 缓存页数
+#define EEPROM_BD_SIZE        4096 ///< 容量 (字节)
+/** @} */
+
+/**
+ * @brief 读取数据 (阻塞)
+ * @details 请求的字节都在缓存中时不访问 EEPROM；否则读取整段，并把结果填入缓存 (较新的脏字节保持不变)。
+ * @param[in] addr 起始地址
+ * @param[out] data 数据缓冲区
+ * @param[in] size 长度
+ * @return HAL_StatusTypeDef 读取结果
+ */
+HAL_StatusTypeDef EEPROM_BD_Read(uint16_t addr, void *data, uint16_t size);
+
+/**
+ * @brief 读取数据 (非阻塞)
+ * @details 与 EEPROM_BD_Read() 相同，但经总线队列读取，完成后调用回调。
+ *          请求的字节都在缓存中时在函数返回前调用回调。同一时间只支持一个读请求。
+ * @param[in] addr 起始地址
+ * @param[out] data 数据缓冲区，必须保持有效直到回调被调用
+ * @param[in] size 长度
+ * @param[in] cb 完成回调 (I2C中断上下文)，可为NULL
+ * @param[in] ctx 回调上下文
+ * @return HAL_StatusTypeDef
+ *         - @retval HAL_OK 已开始 (或已完成)
+ *         - @retval HAL_BUSY 上一个读请求尚未完成或总线队列已满
+ *         - @retval HAL_ERROR 参数错误
+ */
+HAL_StatusTypeDef EEPROM_BD_Read_Async(uint16_t addr, void *data, uint16_t size,
+                                       I2C_Bus_Callback_t cb, void *ctx);
+
+/**
+ * @brief 写入数据到缓存
+ * @details 不访问 EEPROM，之后需调用 EEPROM_BD_Flush() 或 EEPROM_BD_Flush_Async() 写出。
+ *          可以跨页。与缓存内容相同的字节不会被写出。
+ * @param[in] addr 起始地址
+ * @param[in] data 数据
+ * @param[in] size 长度
+ * @return HAL_StatusTypeDef
+ *         - @retval HAL_OK 已写入缓存
+ *         - @retval HAL_BUSY 缓存页都有未写出的数据，需先刷新 (已写入的前几页保留在缓存中)
+ *         - @retval HAL_ERROR 参数错误
+ */
+HAL_StatusTypeDef EEPROM_BD_Write(uint16_t addr, const void *data, uint16_t size);
+
+/**
+ * @brief 写出全部脏字节 (阻塞)
+ * @return HAL_StatusTypeDef 写入结果，失败时未写出的字节保持为脏
+ */
+HAL_StatusTypeDef EEPROM_BD_Flush(void);
+
+/**
+ * @brief 在后台写出全部脏字节
+ * @details 每次页写入完成后再写下一段，直到没有脏字节后调用回调。没有脏字节时在函数返回前调用回调。
+ * @param[in] cb 完成回调 (I2C中断上下文)，可为NULL
+ * @param[in] ctx 回调上下文
+ * @return HAL_StatusTypeDef
+ *         - @retval HAL_OK 已开始 (或已完成)
+ *         - @retval HAL_BUSY 已有刷新在进行或 EEPROM 写任务忙 (调用者稍后重试)
+ */
+HAL_StatusTypeDef EEPROM_BD_Flush_Async(I2C_Bus_Callback_t cb, void *ctx);
+
+/**
+ * @brief 查询是否有未写出的数据
+ * @return bool 有脏字节或刷新在进行时返回 true
+ */
+bool EEPROM_BD_Is_Dirty(void);
+
+/** @} */
+
+#endif /* __EEPROM_BD_H */
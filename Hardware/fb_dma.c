@@ -0,0 +1,285 @@
+/**
+ * @file      fb_dma.c
+ * @brief     显存批量操作模块实现
+ * @details   队列为单生产者环形缓冲区：主循环在 head 处写入，中断在 tail 处取走，两者只在关中断时修改对方读取的下标。
+ *            源、目标和长度都是4的倍数时按字传输，否则按字节；填充时源地址指向队列项中的填充字，不递增。
+ *            队列项在它的传输完成后才被释放，因此填充字在传输期间保持有效。
+ *            CPU 路径同样按字读写，首尾不对齐的部分逐字节处理 (MicroLIB 的 memset/memcpy 逐字节进行)。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "fb_dma.h"
+
+/**
+ * @addtogroup Fb_Dma
+ * @{
+ */
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 队列中的一项操作
+ */
+typedef struct {
+    uint32_t dst;     ///< 目标地址
+    uint32_t src;     ///< 源地址，填充时为0
+    uint32_t pattern; ///< 填充字 (4个相同的字节)
+    uint16_t len;     ///< 长度 (字节)
+} Fb_Dma_Op_t;
+
+/* Private variables ---------------------------------------------------------*/
+#if FB_DMA_ENABLE
+static Fb_Dma_Op_t fb_queue[FB_DMA_QUEUE]; ///< 操作队列
+static volatile uint8_t fb_head;           ///< 下一个写入的位置 (主循环修改)
+static volatile uint8_t fb_tail;           ///< 正在传输的一项 (中断修改)，等于 fb_head 时队列为空
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static void fb_submit(uint8_t *dst, const uint8_t *src, uint8_t value, uint16_t len);
+#if FB_DMA_ENABLE
+void DMA1_Channel7_IRQHandler(void);
+static void fb_start(const Fb_Dma_Op_t *op);
+#else
+static void fb_cpu_fill(uint8_t *dst, uint8_t value, uint16_t len);
+static void fb_cpu_copy(uint8_t *dst, const uint8_t *src, uint16_t len);
+#endif
+
+/* Private Function implementations ------------------------------------------*/
+
+#if FB_DMA_ENABLE
+
+/**
+ * @brief 按一项操作设置通道7 并开始传输
+ * @param[in] op 要执行的操作
+ * @return 无
+ */
+static void fb_start(const Fb_Dma_Op_t *op)
+{
+    uint32_t ccr = DMA_CCR_MEM2MEM | DMA_CCR_MINC | DMA_CCR_TCIE; // 优先级为低，方向为从 CPAR 读出写入 CMAR
+    bool word = ((op->dst | op->len | op->src) & 3U) == 0;
+
+    if (op->src != 0) {
+        ccr |= DMA_CCR_PINC;
+        DMA1_Channel7->CPAR = op->src;
+    } else {
+        DMA1_Channel7->CPAR = (uint32_t)&op->pattern;
+    }
+    DMA1_Channel7->CMAR = op->dst;
+    DMA1_Channel7->CNDTR = word ? (op->len >> 2) : op->len;
+    if (word) {
+        ccr |= DMA_CCR_PSIZE_1 | DMA_CCR_MSIZE_1;
+    }
+    DMA1_Channel7->CCR = ccr;
+    DMA1_Channel7->CCR = ccr | DMA_CCR_EN;
+}
+
+#else
+
+/**
+ * @brief CPU 路径：按字填充
+ * @param[out] dst 目标地址
+ * @param[in] value 填充的字节
+ * @param[in] len 长度 (字节)
+ * @return 无
+ */
+static void fb_cpu_fill(uint8_t *dst, uint8_t value, uint16_t len)
+{
+    uint32_t pattern = value * 0x01010101U;
+
+    while (len > 0 && ((uintptr_t)dst & 3U)) {
+        *dst++ = value;
+        len--;
+    }
+    for (; len >= 4; len -= 4, dst += 4) {
+        *(uint32_t *)dst = pattern;
+    }
+    while (len-- > 0) {
+        *dst++ = value;
+    }
+}
+
+/**
+ * @brief CPU 路径：源和目标对齐方式相同时按字拷贝，否则逐字节
+ * @param[out] dst 目标地址
+ * @param[in] src 源地址
+ * @param[in] len 长度 (字节)
+ * @return 无
+ */
+static void fb_cpu_copy(uint8_t *dst, const uint8_t *src, uint16_t len)
+{
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & 3U) == 0) {
+        while (len > 0 && ((uintptr_t)dst & 3U)) {
+            *dst++ = *src++;
+            len--;
+        }
+        for (; len >= 4; len -= 4, dst += 4, src += 4) {
+            *(uint32_t *)dst = *(const uint32_t *)src;
+        }
+    }
+    while (len-- > 0) {
+        *dst++ = *src++;
+    }
+}
+
+#endif /* FB_DMA_ENABLE */
+
+/**
+ * @brief 提交一项操作
+ * @details 队列满时等待中断释放一项。队列原本为空时直接启动传输，否则由中断接着启动。
+ * @param[out] dst 目标地址
+ * @param[in] src 源地址，为 NULL 时填充
+ * @param[in] value 填充的字节 (src 为 NULL 时使用)
+ * @param[in] len 长度 (字节)
+ * @return 无
+ */
+static void fb_submit(uint8_t *dst, const uint8_t *src, uint8_t value, uint16_t len)
+{
+#if FB_DMA_ENABLE
+    uint8_t head = fb_head;
+    uint8_t next = (uint8_t)((head + 1U) % FB_DMA_QUEUE);
+    Fb_Dma_Op_t *op = &fb_queue[head];
+    uint32_t primask;
+
+    if (len == 0) {
+        return;
+    }
+    while (next == fb_tail) {
+    }
+    op->dst = (uint32_t)dst;
+    op->src = (uint32_t)src;
+    op->pattern = value * 0x01010101U;
+    op->len = len;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    __DMB(); // CPU 此前对缓冲区的写入先于传输完成
+    if (fb_tail == head) {
+        fb_start(op);
+    }
+    fb_head = next;
+    __set_PRIMASK(primask);
+#else
+    if (src) {
+        fb_cpu_copy(dst, src, len);
+    } else {
+        fb_cpu_fill(dst, value, len);
+    }
+#endif
+}
+
+/* Function implementations --------------------------------------------------*/
+
+#if FB_DMA_ENABLE
+
+/**
+ * @brief DMA1 通道7中断：一项操作完成，启动队列中的下一项
+ * @return 无
+ */
+void DMA1_Channel7_IRQHandler(void)
+{
+    uint8_t tail = (uint8_t)((fb_tail + 1U) % FB_DMA_QUEUE);
+
+    DMA1->IFCR = DMA_IFCR_CGIF7;
+    DMA1_Channel7->CCR = 0;
+    fb_tail = tail;
+    if (tail != fb_head) {
+        fb_start(&fb_queue[tail]);
+    }
+}
+
+#endif /* FB_DMA_ENABLE */
+
+/**
+ * @brief 初始化显存批量操作
+ * @return 无
+ */
+void Fb_Dma_Init(void)
+{
+#if FB_DMA_ENABLE
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    DMA1_Channel7->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF7;
+    HAL_NVIC_SetPriority(DMA1_Channel7_IRQn, IRQ_PRIO_BACKGROUND, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+#endif
+}
+
+/**
+ * @brief 用同一个字节填充一段内存
+ * @param[out] dst 目标地址
+ * @param[in] value 填充的字节
+ * @param[in] len 长度 (字节)
+ * @return 无
+ */
+void Fb_Dma_Fill(uint8_t *dst, uint8_t value, uint16_t len)
+{
+    fb_submit(dst, NULL, value, len);
+}
+
+/**
+ * @brief 拷贝一段内存
+ * @param[out] dst 目标地址
+ * @param[in] src 源地址
+ * @param[in] len 长度 (字节)
+ * @return 无
+ */
+void Fb_Dma_Copy(uint8_t *dst, const uint8_t *src, uint16_t len)
+{
+    fb_submit(dst, src, 0, len);
+}
+
+/**
+ * @brief 把若干行按列平移后拷贝到目标，空出的列清零
+ * @param[out] dst 目标地址
+ * @param[in] src 源地址
+ * @param[in] rows 行数
+ * @param[in] width 每行的字节数
+ * @param[in] dx 向右平移的列数 (负数向左)
+ * @return 无
+ */
+void Fb_Dma_Shift(uint8_t *dst, const uint8_t *src, uint8_t rows, uint16_t width, int16_t dx)
+{
+    uint16_t shift = (uint16_t)((dx < 0) ? -dx : dx);
+    uint16_t n = (shift >= width) ? 0 : (uint16_t)(width - shift); // 每行保留的列数
+
+    for (uint8_t row = 0; row < rows; row++, dst += width, src += width) {
+        if (dx >= 0) {
+            Fb_Dma_Fill(dst, 0, width - n);
+            Fb_Dma_Copy(dst + (width - n), src, n);
+        } else {
+            Fb_Dma_Copy(dst, src + (width - n), n);
+            Fb_Dma_Fill(dst + n, 0, width - n);
+        }
+    }
+}
+
+/**
+ * @brief 等待已提交的操作全部完成
+ * @return 无
+ */
+void Fb_Dma_Wait(void)
+{
+#if FB_DMA_ENABLE
+    while (fb_tail != fb_head) {
+    }
+    __DMB(); // 之后的读取不会提前到传输完成之前
+#endif
+}
+
+/**
+ * @brief 是否有尚未完成的操作
+ * @return bool 队列非空返回 true
+ */
+bool Fb_Dma_Is_Busy(void)
+{
+#if FB_DMA_ENABLE
+    return fb_tail != fb_head;
+#else
+    return false;
+#endif
+}
+
+/** @} */
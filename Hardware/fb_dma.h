@@ -0,0 +1,95 @@
+/**
+ * @file      fb_dma.h
+ * @brief     显存批量操作模块头文件
+ * @details   用 DMA1 通道7 的存储器到存储器模式完成绘图缓冲区的清空、拷贝和按列平移：
+ *            调用者把操作放入队列后立即返回，传输完成中断中依次启动下一项，CPU 在此期间可以继续
+ *            处理页面逻辑，读写涉及的缓冲区之前调用 Fb_Dma_Wait() 等待全部完成。
+ *            队列中的操作按提交顺序执行，后一项可以依赖前一项的结果 (如先拷贝再在其上清空一部分)。
+ *            通道7 在本工程中没有其他用途 (I2C1 接收不使用 DMA)，软件优先级设为最低，
+ *            与显示器、串口和 I2C 的 DMA 同时请求时总是让出总线。
+ *            FB_DMA_ENABLE 为 0 (通道另作他用或主机仿真) 时，所有操作在调用时由 CPU 以字为单位完成。
+ *            DMA1 通道7 不在 CubeMX 配置中，由本模块直接操作寄存器，中断服务函数也在本模块中。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __FB_DMA_H
+#define __FB_DMA_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup Fb_Dma 显存批量操作
+ * @brief 用存储器到存储器 DMA 异步清空、拷贝和平移显存。
+ * @{
+ */
+
+/**
+ * @defgroup Fb_Dma_Config 显存批量操作配置
+ * @{
+ */
+#ifndef FB_DMA_ENABLE
+#define FB_DMA_ENABLE 1  ///< 为 1 时使用 DMA1 通道7，为 0 时全部由 CPU 完成
+#endif
+#define FB_DMA_QUEUE  24 ///< 队列长度，须能容纳一次整帧平移 (每页两项)，队列满时提交者等待
+/** @} */
+
+/**
+ * @brief 初始化显存批量操作
+ * @details 打开 DMA1 时钟并使能通道7 的中断，FB_DMA_ENABLE 为 0 时为空操作。
+ * @return 无
+ */
+void Fb_Dma_Init(void);
+
+/**
+ * @brief 用同一个字节填充一段内存
+ * @param[out] dst 目标地址
+ * @param[in] value 填充的字节
+ * @param[in] len 长度 (字节)
+ * @return 无
+ */
+void Fb_Dma_Fill(uint8_t *dst, uint8_t value, uint16_t len);
+
+/**
+ * @brief 拷贝一段内存
+ * @details 源和目标不能重叠，源在操作完成前不能修改。
+ * @param[out] dst 目标地址
+ * @param[in] src 源地址
+ * @param[in] len 长度 (字节)
+ * @return 无
+ */
+void Fb_Dma_Copy(uint8_t *dst, const uint8_t *src, uint16_t len);
+
+/**
+ * @brief 把若干行按列平移后拷贝到目标，空出的列清零
+ * @details 用于按页存放的显存 (每行即一页，每列一个字节)，每行提交一次拷贝和一次清零。
+ *          平移量的绝对值不小于行宽时整行清零。
+ * @param[out] dst 目标地址
+ * @param[in] src 源地址，不能与目标重叠
+ * @param[in] rows 行数
+ * @param[in] width 每行的字节数
+ * @param[in] dx 向右平移的列数 (负数向左)
+ * @return 无
+ */
+void Fb_Dma_Shift(uint8_t *dst, const uint8_t *src, uint8_t rows, uint16_t width, int16_t dx);
+
+/**
+ * @brief 等待已提交的操作全部完成
+ * @details 之后 CPU 读写的是操作完成后的内容。
+ * @return 无
+ */
+void Fb_Dma_Wait(void);
+
+/**
+ * @brief 是否有尚未完成的操作
+ * @return bool 队列非空返回 true
+ */
+bool Fb_Dma_Is_Busy(void);
+
+/** @} */
+
+#endif /* __FB_DMA_H */
@@ -0,0 +1,45 @@
+/**
+ * @file      hw_crc.c
+ * @brief     硬件 CRC 单元
+ * @details   HAL 的 CRC 模块未启用，这里直接操作 CRC->CR 和 CRC->DR。
+ *            时钟一直保持打开：CRC 单元没有可保存的状态，停止模式中不需要处理。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "hw_crc.h"
+#include <stdbool.h>
+
+/**
+ * @addtogroup HwCrc
+ * @{
+ */
+
+/* Private variables ---------------------------------------------------------*/
+static bool crc_clock_on; ///< CRC 单元的时钟是否已打开
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 计算一段数据的 CRC-32
+ * @param[in] words 数据 (4 字节对齐)
+ * @param[in] count 字数
+ * @return uint32_t CRC-32
+ */
+uint32_t HW_CRC32(const uint32_t *words, uint16_t count)
+{
+    if (!crc_clock_on) {
+        __HAL_RCC_CRC_CLK_ENABLE();
+        crc_clock_on = true;
+    }
+
+    CRC->CR = CRC_CR_RESET;
+    while (count-- > 0) {
+        CRC->DR = *words++;
+    }
+    return CRC->DR;
+}
+
+/** @} */
@@ -0,0 +1,38 @@
+/**
+ * @file      hw_crc.h
+ * @brief     硬件 CRC 单元头文件
+ * @details   STM32F1 的 CRC 单元只有一种固定的算法：CRC-32 (多项式 0x04C11DB7)，初值 0xFFFFFFFF，
+ *            按 32 位字从高位起运算，不反转、不异或输出 (即 CRC-32/MPEG-2 按字的小端读取)。
+ *            每写入一个字只需 4 个 AHB 周期，几百字节的记录校验不占用可觉察的时间。
+ *            输入按字给出，数据须 4 字节对齐、长度为 4 的倍数。
+ *            CRC 单元只有一组寄存器，只能在主循环中使用 (中断中不调用)。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __HW_CRC_H
+#define __HW_CRC_H
+
+#include "main.h"
+#include <stdint.h>
+
+/**
+ * @defgroup HwCrc 硬件 CRC
+ * @brief 用 CRC 单元计算一段字对齐数据的 CRC-32。
+ * @{
+ */
+
+/**
+ * @brief 计算一段数据的 CRC-32
+ * @details 第一次调用时打开 CRC 单元的时钟，每次调用前复位数据寄存器。
+ * @param[in] words 数据 (4 字节对齐)
+ * @param[in] count 字数
+ * @return uint32_t CRC-32
+ */
+uint32_t HW_CRC32(const uint32_t *words, uint16_t count);
+
+/** @} */
+
+#endif /* __HW_CRC_H */
@@ -0,0 +1,1365 @@
+/**
+ * @file      i2c_bus.c
+ * @brief     共享I2C总线管理模块实现
+ * @details   所有事务存放在一个固定大小的槽位池中，每次选择优先级最高、
+ *            同优先级中最早提交的事务启动。写操作走 DMA (I2C1_TX, DMA1 通道6)，
+ *            读操作走中断。HAL 的 I2C 完成/错误回调统一在本文件中定义，
+ *            事务结束后在中断里直接启动下一个事务，主循环不需要等待总线。
+ *
+ *            EEPROM 写入后芯片需要最长 5ms 的内部写周期，期间不会应答。
+ *            此类事务通过 hold_ms 声明最长忙碌时间，期间只推迟发往该设备的事务，
+ *            显示刷新等其他事务不受影响。同一时间只跟踪一个忙碌设备。
+ *            忙碌期内若有发往该设备的事务在等待，I2C_Bus_Service 会在总线空闲时
+ *            用 HAL_I2C_IsDeviceReady 探测设备地址 (ACK 轮询)，设备应答即提前结束忙碌期。
+ *
+ *            每个事务启动前按目标设备的速率表项重写 CCR 和 TRISE (只在速率变化时，需要先关闭外设)，
+ *            总线空闲时关闭外设只复位状态标志，CR2 (时钟频率、中断和 DMA 使能) 等配置保留。
+ *
+ *            每个事务 (包括 ACK 轮询) 结束时把字节数、占用总线的时间和结果 (成功、NACK、其他错误、
+ *            超时、轮询未应答) 按设备地址交给 profiler 统计。
+ *
+ *            事务的执行时间上限 = I2C_BUS_TXN_BASE_MS + 按速率传输 (数据 + 4 字节地址开销) 所需时间的
+ *            I2C_BUS_TXN_SLACK 倍，整帧显存在 400kHz 下约 48ms，传感器的几字节读写只有几毫秒。
+ *            超时 (从机卡在字节中间拉低 SDA 或无限延展时钟) 或外设的 BUSY 标志卡住 (启动返回 HAL_BUSY) 时，
+ *            把 SCL/SDA 临时切换为开漏 GPIO，发出最多 9 个 SCL 脉冲直到 SDA 释放，再发一个停止条件，
+ *            最后重新初始化外设。上电时 SDA 为低同样先做一次。
+ *            每条总线 (I2C 外设) 有各自的队列、当前事务、忙碌设备和速率状态，互不等待；
+ *            发往某个设备的事务由路由表决定走哪条总线，没有登记的设备走 I2C_Bus_Init 传入的第一条。
+ *            所有总线的完成回调都在各自的I2C中断中调用，回调中可以向另一条总线提交事务。
+ *            同一设备连续失败 I2C_BUS_DEGRADE_FAILS 次后降级：每个退避间隔只放行一个提交，
+ *            放行的事务失败则间隔加倍 (上限 I2C_BUS_BACKOFF_MAX_MS)，成功则恢复。
+ *
+ *            掉电前的紧急写入 (I2C_Bus_Emergency_Write) 不经过队列：停止该总线的调度，
+ *            中止正在进行的事务并恢复外设，然后以寄存器轮询的方式完成一次写入。
+ *            计时使用 DWT 周期计数器，在任何中断优先级下都不依赖 SysTick。
+ *
+ *            显示器的写事务 (DISPLAY/PANEL 优先级的发送，或 8 位存储地址的写入) 走寄存器级路径：
+ *            HAL_I2C_Mem_Write_DMA 在启动时轮询等待起始条件、地址和存储地址发送完毕 (在完成回调中启动时
+ *            就是在中断里忙等约 50us)，每个事件还要经过 HAL 的状态机。这里直接写 DMA 通道寄存器，
+ *            起始条件和地址阶段由事件中断各处理一次，随后 DMA 发送数据，DMA 完成后等待 BTF 发送停止条件，
+ *            一个事务只有 SB、ADDR、DMA 完成、BTF 四次中断。HAL 句柄的状态保持 READY，
+ *            错误、超时和恢复沿用与 HAL 路径相同的处理。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.4
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "i2c_bus.h"
+#include "profiler.h"
+#include "timebase.h"
+#include "trace.h"
+
+/**
+ * @addtogroup I2C_Bus
+ * @{
+ */
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 事务槽位
+ */
+typedef struct {
+    I2C_Bus_Txn_t txn; ///< 事务描述
+    uint32_t seq;      ///< 提交序号，用于同优先级内的先后顺序
+    uint8_t prio;      ///< 事务优先级
+    bool used;         ///< 槽位是否被占用
+} Bus_Slot_t;
+
+/**
+ * @brief 阻塞传输的完成标志
+ */
+typedef struct {
+    volatile bool done;
+    volatile HAL_StatusTypeDef status;
+} Bus_Wait_t;
+
+#define BUS_IDLE    (-1) ///< Bus_t.active: 总线空闲
+#define BUS_PROBING (-2) ///< Bus_t.active: 主循环正在对忙碌设备做 ACK 轮询
+
+/**
+ * @brief 寄存器级发送路径的阶段
+ */
+typedef enum {
+    BUS_FAST_NONE = 0, ///< 当前事务走 HAL (或总线空闲)
+    BUS_FAST_SB,       ///< 等待起始条件
+    BUS_FAST_ADDR,     ///< 等待地址应答
+    BUS_FAST_DMA,      ///< DMA 发送数据
+    BUS_FAST_BTF       ///< 等待最后一个字节发送完毕
+} Bus_Fast_e;
+
+/**
+ * @brief 一条总线的状态
+ */
+typedef struct {
+    I2C_HandleTypeDef *hi2c;     ///< 总线的HAL句柄
+    Bus_Slot_t slots[I2C_BUS_QUEUE_SIZE];
+    volatile int8_t active;      ///< 正在执行的槽位，或 BUS_IDLE/BUS_PROBING
+    uint32_t active_start;       ///< 当前事务的启动时间戳
+    uint32_t active_budget;      ///< 当前事务的执行时间上限 (ms)
+    uint32_t active_start_us;    ///< 当前事务的启动时间 (us)，用于统计总线占用时间
+    bool recover_pending;        ///< 外设的 BUSY 标志卡住，等总线空闲时恢复
+    bool halted;                 ///< 紧急写入接管了总线，不再启动任何事务
+    volatile uint8_t fast;       ///< 寄存器级发送路径的阶段 (Bus_Fast_e)
+    bool fast_head;              ///< 地址应答后是否先发送一个存储地址字节
+    uint8_t fast_mem;            ///< 存储地址
+    uint32_t speed_now;          ///< 外设当前配置的速率
+    GPIO_TypeDef *scl_port;      ///< 总线恢复时以 GPIO 方式驱动的引脚
+    uint16_t scl_pin;
+    GPIO_TypeDef *sda_port;
+    uint16_t sda_pin;
+    struct {
+        bool active;     ///< 是否有设备处于忙碌期
+        uint16_t addr;   ///< 忙碌设备的地址
+        uint32_t until;  ///< 忙碌期结束的时间戳
+        uint32_t polled; ///< 上次 ACK 轮询的时间戳
+    } hold;
+} Bus_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+static Bus_t buses[I2C_BUS_COUNT];            ///< 各条总线，buses[0] 为默认总线
+static uint8_t bus_count;                     ///< 已初始化的总线数
+static uint64_t bus_busy_us;                  ///< 所有总线上事务执行的累计时间 (us)
+static uint32_t bus_seq;                      ///< 下一个提交序号 (所有总线共用)
+static bool bus_fast_on = true;               ///< 显示器写事务是否走寄存器级路径
+
+static struct {
+    uint16_t addr;   ///< 设备地址
+    uint8_t bus;     ///< 所在总线在 buses 中的下标，0为空表项
+} bus_route[I2C_BUS_ROUTES];                  ///< 不在默认总线上的设备
+
+static struct {
+    uint16_t addr;   ///< 设备地址
+    uint32_t hz;     ///< 速率，0为空表项
+} bus_speed[I2C_BUS_PROFILES];                ///< 各设备的 SCL 速率
+
+static struct {
+    uint16_t addr;     ///< 设备地址，0为空表项
+    uint8_t fails;     ///< 连续失败次数，饱和于 UINT8_MAX
+    uint32_t backoff;  ///< 当前重试间隔 (ms)，0 表示未降级
+    uint32_t retry_at; ///< 下一次放行提交的时间戳
+} bus_health[I2C_BUS_HEALTH_DEVICES];         ///< 各设备的失败记录，按首次失败的顺序登记
+
+/* Private function prototypes -----------------------------------------------*/
+
+static Bus_t *bus_of_addr(uint16_t addr);
+static Bus_t *bus_of_handle(const I2C_HandleTypeDef *hi2c);
+static void bus_kick(Bus_t *b);
+static void bus_complete(Bus_t *b, HAL_StatusTypeDef status);
+static HAL_StatusTypeDef bus_start(Bus_t *b, const Bus_Slot_t *slot);
+static bool bus_fast_eligible(const Bus_t *b, const Bus_Slot_t *slot);
+static HAL_StatusTypeDef bus_fast_start(Bus_t *b, const I2C_Bus_Txn_t *txn);
+static void bus_fast_stop(Bus_t *b, HAL_StatusTypeDef status, uint32_t error);
+static void bus_fast_dma_cplt(DMA_HandleTypeDef *hdma);
+static void bus_fast_dma_error(DMA_HandleTypeDef *hdma);
+static bool bus_is_held(Bus_t *b, uint16_t addr);
+static bool bus_hold_has_waiter(const Bus_t *b);
+static void bus_poll_hold(Bus_t *b);
+static void bus_wait_cb(HAL_StatusTypeDef status, void *ctx);
+static void bus_apply_speed(Bus_t *b, uint16_t addr);
+static uint32_t bus_txn_budget(const I2C_Bus_Txn_t *txn);
+static void bus_recover(Bus_t *b);
+static void bus_health_update(uint16_t addr, bool ok);
+static bool bus_health_admit(uint16_t addr);
+static Bus_t *bus_setup(I2C_HandleTypeDef *hi2c);
+static HAL_StatusTypeDef bus_emerg_wait(I2C_TypeDef *i2c, uint32_t flag, uint32_t start, uint32_t limit);
+static HAL_StatusTypeDef bus_emerg_attempt(I2C_TypeDef *i2c, uint16_t dev_addr, uint16_t mem_addr,
+                                           uint16_t mem_addr_size, const uint8_t *data, uint16_t size,
+                                           uint32_t start, uint32_t limit);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 查找发往某个设备的事务所走的总线
+ * @param[in] addr 设备地址
+ * @return Bus_t* 路由表中登记的总线，没有登记时为默认总线；未初始化时为 NULL
+ */
+static Bus_t *bus_of_addr(uint16_t addr)
+{
+    for (uint8_t i = 0; i < I2C_BUS_ROUTES; i++) {
+        if (bus_route[i].bus != 0 && bus_route[i].addr == addr) {
+            return &buses[bus_route[i].bus];
+        }
+    }
+    return (bus_count > 0) ? &buses[0] : NULL;
+}
+
+/**
+ * @brief 查找HAL句柄对应的总线
+ * @param[in] hi2c HAL句柄
+ * @return Bus_t* 总线，不是本模块管理的外设时为 NULL
+ */
+static Bus_t *bus_of_handle(const I2C_HandleTypeDef *hi2c)
+{
+    for (uint8_t i = 0; i < bus_count; i++) {
+        if (buses[i].hi2c == hi2c) {
+            return &buses[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 判断设备当前是否处于忙碌期
+ * @param[in,out] b 总线
+ * @param[in] addr 设备地址
+ * @return bool 忙碌返回 true
+ */
+static bool bus_is_held(Bus_t *b, uint16_t addr)
+{
+    if (!b->hold.active) {
+        return false;
+    }
+    if ((int32_t)(HAL_GetTick() - b->hold.until) >= 0) {
+        b->hold.active = false;
+        return false;
+    }
+    return b->hold.addr == addr;
+}
+
+/**
+ * @brief 判断是否有事务在等待忙碌设备
+ * @param[in] b 总线
+ * @return bool 有返回 true
+ */
+static bool bus_hold_has_waiter(const Bus_t *b)
+{
+    for (uint8_t i = 0; i < I2C_BUS_QUEUE_SIZE; i++) {
+        if (b->slots[i].used && b->slots[i].txn.dev_addr == b->hold.addr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 把外设的 SCL 速率切换为发往某个设备时使用的速率
+ * @details 只能在总线空闲时调用。CCR 只允许在 PE=0 时修改，先等待上一个事务的停止条件发送完毕。
+ * @param[in,out] b 总线
+ * @param[in] addr 设备地址
+ * @return 无
+ */
+static void bus_apply_speed(Bus_t *b, uint16_t addr)
+{
+    uint32_t hz = I2C_Bus_Get_Speed(addr);
+    I2C_TypeDef *i2c = b->hi2c->Instance;
+    uint32_t pclk;
+
+    if (hz == b->speed_now) {
+        return;
+    }
+    for (uint16_t spin = 0; (i2c->CR1 & I2C_CR1_STOP) && spin < 1000; spin++) {
+    }
+
+    pclk = HAL_RCC_GetPCLK1Freq();
+    __HAL_I2C_DISABLE(b->hi2c);
+    i2c->TRISE = I2C_RISE_TIME(I2C_FREQRANGE(pclk), hz);
+    i2c->CCR = I2C_SPEED(pclk, hz, b->hi2c->Init.DutyCycle);
+    __HAL_I2C_ENABLE(b->hi2c);
+    b->speed_now = hz;
+}
+
+/**
+ * @brief 计算事务的执行时间上限
+ * @param[in] txn 事务描述
+ * @return uint32_t 上限 (ms)
+ */
+static uint32_t bus_txn_budget(const I2C_Bus_Txn_t *txn)
+{
+    uint32_t bits = ((uint32_t)txn->size + 4U) * 9U; // 地址、寄存器地址和重复起始的开销按 4 字节计
+    uint32_t hz = I2C_Bus_Get_Speed(txn->dev_addr);
+
+    return I2C_BUS_TXN_BASE_MS + (bits * 1000U * I2C_BUS_TXN_SLACK + hz - 1U) / hz;
+}
+
+/**
+ * @brief 释放被从机拉住的总线并重新初始化外设
+ * @details 从机在读操作的某个字节中间被打断 (复位、干扰) 时会一直拉低 SDA 等待剩余的时钟。
+ *          SCL 每发一个脉冲从机移出一位，最多 9 个脉冲后它会看到 NACK 而释放 SDA，
+ *          之后的停止条件让所有从机回到空闲状态。外设本身的状态由 DeInit/Init 清除。
+ *          引脚在重新初始化前切换回复用开漏 (CubeMX 生成的 MspInit 只处理 I2C1，其他总线的引脚由这里恢复)。
+ * @note 调用时需处于总线空闲或正在结束卡死的事务，耗时约 100us。
+ * @param[in,out] b 总线
+ * @return 无
+ */
+static void bus_recover(Bus_t *b)
+{
+    GPIO_InitTypeDef gpio = {0};
+    uint8_t pulses = 0;
+
+    b->fast = BUS_FAST_NONE; // 寄存器级路径的中断使能和 DMA 通道随外设一起复位
+    HAL_I2C_DeInit(b->hi2c);
+
+    HAL_GPIO_WritePin(b->scl_port, b->scl_pin, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(b->sda_port, b->sda_pin, GPIO_PIN_SET);
+    gpio.Mode = GPIO_MODE_OUTPUT_OD;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    gpio.Pin = b->scl_pin;
+    HAL_GPIO_Init(b->scl_port, &gpio);
+    gpio.Pin = b->sda_pin;
+    HAL_GPIO_Init(b->sda_port, &gpio);
+    Timebase_Delay_Us(I2C_BUS_RECOVER_HALF_US);
+
+    while (pulses < I2C_BUS_RECOVER_PULSES && HAL_GPIO_ReadPin(b->sda_port, b->sda_pin) == GPIO_PIN_RESET) {
+        HAL_GPIO_WritePin(b->scl_port, b->scl_pin, GPIO_PIN_RESET);
+        Timebase_Delay_Us(I2C_BUS_RECOVER_HALF_US);
+        HAL_GPIO_WritePin(b->scl_port, b->scl_pin, GPIO_PIN_SET);
+        Timebase_Delay_Us(I2C_BUS_RECOVER_HALF_US);
+        pulses++;
+    }
+
+    // 停止条件：SCL 为高时 SDA 由低变高
+    HAL_GPIO_WritePin(b->scl_port, b->scl_pin, GPIO_PIN_RESET);
+    Timebase_Delay_Us(I2C_BUS_RECOVER_HALF_US);
+    HAL_GPIO_WritePin(b->sda_port, b->sda_pin, GPIO_PIN_RESET);
+    Timebase_Delay_Us(I2C_BUS_RECOVER_HALF_US);
+    HAL_GPIO_WritePin(b->scl_port, b->scl_pin, GPIO_PIN_SET);
+    Timebase_Delay_Us(I2C_BUS_RECOVER_HALF_US);
+    HAL_GPIO_WritePin(b->sda_port, b->sda_pin, GPIO_PIN_SET);
+    Timebase_Delay_Us(I2C_BUS_RECOVER_HALF_US);
+    TRACE(TRACE_EV_I2C_RECOVER,
+          pulses | ((uint16_t)(HAL_GPIO_ReadPin(b->sda_port, b->sda_pin) == GPIO_PIN_SET) << 8));
+
+    gpio.Mode = GPIO_MODE_AF_OD;
+    gpio.Pin = b->scl_pin;
+    HAL_GPIO_Init(b->scl_port, &gpio);
+    gpio.Pin = b->sda_pin;
+    HAL_GPIO_Init(b->sda_port, &gpio);
+    HAL_I2C_Init(b->hi2c);
+    b->speed_now = b->hi2c->Init.ClockSpeed;
+    b->recover_pending = false;
+}
+
+/**
+ * @brief 按事务结果更新设备的失败记录
+ * @param[in] addr 设备地址
+ * @param[in] ok 事务是否成功
+ * @return 无
+ */
+static void bus_health_update(uint16_t addr, bool ok)
+{
+    for (uint8_t i = 0; i < I2C_BUS_HEALTH_DEVICES; i++) {
+        if (bus_health[i].addr == 0) {
+            if (ok) {
+                return; // 从未失败过的设备不占表项
+            }
+            bus_health[i].addr = addr;
+        }
+        if (bus_health[i].addr != addr) {
+            continue;
+        }
+
+        if (ok) {
+            bus_health[i].fails = 0;
+            bus_health[i].backoff = 0;
+            return;
+        }
+        if (bus_health[i].fails != UINT8_MAX) {
+            bus_health[i].fails++;
+        }
+        if (bus_health[i].fails >= I2C_BUS_DEGRADE_FAILS) {
+            uint32_t backoff = bus_health[i].backoff * 2U;
+            if (backoff < I2C_BUS_BACKOFF_MIN_MS) {
+                backoff = I2C_BUS_BACKOFF_MIN_MS;
+            } else if (backoff > I2C_BUS_BACKOFF_MAX_MS) {
+                backoff = I2C_BUS_BACKOFF_MAX_MS;
+            }
+            bus_health[i].backoff = backoff;
+            bus_health[i].retry_at = HAL_GetTick() + backoff;
+            TRACE(TRACE_EV_I2C_DEGRADE, (addr & 0xFF) | ((uint16_t)bus_health[i].fails << 8));
+        }
+        return;
+    }
+}
+
+/**
+ * @brief 判断是否接受发往某个设备的提交
+ * @details 降级的设备每个退避间隔只放行一个提交，放行后把下一次放行推迟一个间隔，
+ *          避免多个事务同时去试探一个不应答的设备。
+ * @note 调用时需处于关中断状态。
+ * @param[in] addr 设备地址
+ * @return bool 接受返回 true
+ */
+static bool bus_health_admit(uint16_t addr)
+{
+    uint32_t now = HAL_GetTick();
+
+    for (uint8_t i = 0; i < I2C_BUS_HEALTH_DEVICES; i++) {
+        if (bus_health[i].addr == addr && bus_health[i].backoff != 0) {
+            if ((int32_t)(now - bus_health[i].retry_at) < 0) {
+                return false;
+            }
+            bus_health[i].retry_at = now + bus_health[i].backoff;
+            return true;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 对忙碌设备做一次 ACK 轮询，设备应答则结束忙碌期
+ * @details 只在总线空闲、且有事务在等待该设备时探测，每个系统滴答最多一次。
+ *          HAL_I2C_IsDeviceReady 是轮询实现 (一次探测约 25us)，且依赖 SysTick 计时，
+ *          因此在开中断的情况下执行；期间先把总线标记为 BUS_PROBING，
+ *          中断中提交的事务只会排队，探测结束后再统一启动。
+ * @note 调用时需处于关中断状态，返回时仍为关中断。
+ * @param[in,out] b 总线
+ * @return 无
+ */
+static void bus_poll_hold(Bus_t *b)
+{
+    uint32_t now = HAL_GetTick();
+    uint16_t addr = b->hold.addr;
+    HAL_StatusTypeDef status;
+#if PROFILER_ENABLE
+    uint32_t start_us;
+#endif
+
+    if (b->active != BUS_IDLE || !b->hold.active || now == b->hold.polled || !bus_hold_has_waiter(b)) {
+        return;
+    }
+    b->hold.polled = now;
+    b->active = BUS_PROBING;
+    bus_apply_speed(b, addr);
+
+    __enable_irq();
+#if PROFILER_ENABLE
+    start_us = Timebase_Us();
+#endif
+    status = HAL_I2C_IsDeviceReady(b->hi2c, addr, 1, I2C_BUS_POLL_TIMEOUT_MS);
+    __disable_irq();
+
+    b->active = BUS_IDLE;
+#if PROFILER_ENABLE
+    Profiler_Count_I2C(addr, 0, Timebase_Us() - start_us, (status == HAL_OK) ? PROF_I2C_OK : PROF_I2C_RETRY);
+#endif
+    if (status == HAL_OK && b->hold.active && b->hold.addr == addr) {
+        b->hold.active = false; // 写周期已提前结束
+    }
+}
+
+/**
+ * @brief 判断事务是否走寄存器级发送路径
+ * @param[in] b 总线
+ * @param[in] slot 事务槽位
+ * @return bool 显示器优先级的发送或 8 位存储地址的写入，且总线有 DMA 发送通道时返回 true
+ */
+static bool bus_fast_eligible(const Bus_t *b, const Bus_Slot_t *slot)
+{
+    const I2C_Bus_Txn_t *txn = &slot->txn;
+
+    if (!I2C_BUS_FAST_TX || !bus_fast_on || b->hi2c->hdmatx == NULL || txn->size == 0) {
+        return false;
+    }
+    if (slot->prio != I2C_BUS_PRIO_DISPLAY && slot->prio != I2C_BUS_PRIO_PANEL) {
+        return false;
+    }
+    return txn->op == I2C_BUS_OP_TX ||
+           (txn->op == I2C_BUS_OP_MEM_WRITE && txn->mem_addr_size == I2C_MEMADD_SIZE_8BIT);
+}
+
+/**
+ * @brief 以寄存器操作启动一次 DMA 发送
+ * @details 先配置好 DMA 通道 (外设侧的 DMA 请求在地址应答后才打开)，再使能事件和错误中断并发出起始条件。
+ *          上一个事务刚发出停止条件时先等它发送完毕，与 bus_apply_speed 相同。
+ * @param[in,out] b 总线
+ * @param[in] txn 事务描述
+ * @return HAL_StatusTypeDef 外设的 BUSY 标志卡住时返回 HAL_BUSY
+ */
+static HAL_StatusTypeDef bus_fast_start(Bus_t *b, const I2C_Bus_Txn_t *txn)
+{
+    I2C_TypeDef *i2c = b->hi2c->Instance;
+    DMA_HandleTypeDef *hdma = b->hi2c->hdmatx;
+    DMA_Channel_TypeDef *ch = hdma->Instance;
+
+    for (uint16_t spin = 0; (i2c->CR1 & I2C_CR1_STOP) && spin < 1000; spin++) {
+    }
+    if (i2c->SR2 & I2C_SR2_BUSY) {
+        return HAL_BUSY;
+    }
+
+    ch->CCR &= ~(DMA_CCR_EN | DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE);
+    hdma->DmaBaseAddress->IFCR = DMA_ISR_GIF1 << hdma->ChannelIndex;
+    ch->CNDTR = txn->size;
+    ch->CPAR = (uint32_t)&i2c->DR;
+    ch->CMAR = (uint32_t)txn->data;
+    hdma->XferCpltCallback = bus_fast_dma_cplt;
+    hdma->XferErrorCallback = bus_fast_dma_error;
+    hdma->Parent = b->hi2c;
+    ch->CCR |= DMA_CCR_TCIE | DMA_CCR_TEIE | DMA_CCR_EN;
+
+    b->fast_head = (txn->op == I2C_BUS_OP_MEM_WRITE);
+    b->fast_mem = (uint8_t)txn->mem_addr;
+    b->fast = BUS_FAST_SB;
+    b->hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    i2c->CR1 &= ~I2C_CR1_POS;
+    i2c->CR2 |= I2C_CR2_ITEVTEN | I2C_CR2_ITERREN;
+    i2c->CR1 |= I2C_CR1_START;
+    return HAL_OK;
+}
+
+/**
+ * @brief 结束寄存器级路径的事务
+ * @details 关闭事件、错误中断和 DMA 请求，发出停止条件 (仲裁丢失时外设已退回从模式，不发)，然后结束事务。
+ * @param[in,out] b 总线
+ * @param[in] status 事务结果
+ * @param[in] error 失败时记入 hi2c->ErrorCode 的 HAL_I2C_ERROR_xxx
+ * @return 无
+ */
+static void bus_fast_stop(Bus_t *b, HAL_StatusTypeDef status, uint32_t error)
+{
+    I2C_TypeDef *i2c = b->hi2c->Instance;
+
+    i2c->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITERREN | I2C_CR2_DMAEN);
+    if (status != HAL_OK) {
+        b->hi2c->hdmatx->Instance->CCR &= ~(DMA_CCR_EN | DMA_CCR_TCIE | DMA_CCR_TEIE);
+    }
+    if (!(error & HAL_I2C_ERROR_ARLO)) {
+        i2c->CR1 |= I2C_CR1_STOP;
+    }
+    b->hi2c->ErrorCode = error;
+    b->fast = BUS_FAST_NONE;
+    bus_complete(b, status);
+}
+
+/**
+ * @brief 寄存器级路径的 DMA 传输完成回调
+ * @details 最后一个字节此时还在移位寄存器中，重新打开事件中断等待 BTF。
+ * @param[in] hdma DMA 句柄
+ * @return 无
+ */
+static void bus_fast_dma_cplt(DMA_HandleTypeDef *hdma)
+{
+    Bus_t *b = bus_of_handle((I2C_HandleTypeDef *)hdma->Parent);
+
+    if (b == NULL || b->fast != BUS_FAST_DMA) {
+        return;
+    }
+    b->hi2c->Instance->CR2 &= ~I2C_CR2_DMAEN;
+    b->fast = BUS_FAST_BTF;
+    b->hi2c->Instance->CR2 |= I2C_CR2_ITEVTEN;
+}
+
+/**
+ * @brief 寄存器级路径的 DMA 传输错误回调
+ * @param[in] hdma DMA 句柄
+ * @return 无
+ */
+static void bus_fast_dma_error(DMA_HandleTypeDef *hdma)
+{
+    Bus_t *b = bus_of_handle((I2C_HandleTypeDef *)hdma->Parent);
+
+    if (b != NULL && b->fast != BUS_FAST_NONE) {
+        bus_fast_stop(b, HAL_ERROR, HAL_I2C_ERROR_DMA);
+    }
+}
+
+/**
+ * @brief 按事务类型启动传输
+ * @details 显示器的写事务走寄存器级路径，其余启动对应的 HAL 非阻塞传输。
+ * @param[in] b 总线
+ * @param[in] slot 事务槽位
+ * @return HAL_StatusTypeDef 启动结果
+ */
+static HAL_StatusTypeDef bus_start(Bus_t *b, const Bus_Slot_t *slot)
+{
+    I2C_HandleTypeDef *hi2c = b->hi2c;
+    const I2C_Bus_Txn_t *txn = &slot->txn;
+
+    if (bus_fast_eligible(b, slot)) {
+        return bus_fast_start(b, txn);
+    }
+    switch (txn->op) {
+        case I2C_BUS_OP_TX:
+            return HAL_I2C_Master_Transmit_DMA(hi2c, txn->dev_addr, txn->data, txn->size);
+        case I2C_BUS_OP_RX:
+            return HAL_I2C_Master_Receive_IT(hi2c, txn->dev_addr, txn->data, txn->size);
+        case I2C_BUS_OP_MEM_WRITE:
+            return HAL_I2C_Mem_Write_DMA(hi2c, txn->dev_addr, txn->mem_addr, txn->mem_addr_size,
+                                         txn->data, txn->size);
+        case I2C_BUS_OP_MEM_READ:
+            return HAL_I2C_Mem_Read_IT(hi2c, txn->dev_addr, txn->mem_addr, txn->mem_addr_size,
+                                       txn->data, txn->size);
+        default:
+            return HAL_ERROR;
+    }
+}
+
+/**
+ * @brief 总线空闲时启动下一个可执行的事务
+ * @note 调用者需保证处于关中断或I2C中断上下文中。
+ * @param[in,out] b 总线
+ * @return 无
+ */
+static void bus_kick(Bus_t *b)
+{
+    while (!b->halted && b->active == BUS_IDLE) {
+        int8_t best = -1;
+
+        for (int8_t i = 0; i < I2C_BUS_QUEUE_SIZE; i++) {
+            Bus_Slot_t *slot = &b->slots[i];
+            if (!slot->used || bus_is_held(b, slot->txn.dev_addr)) {
+                continue;
+            }
+            if (best < 0 || slot->prio < b->slots[best].prio ||
+                (slot->prio == b->slots[best].prio && (int32_t)(slot->seq - b->slots[best].seq) < 0)) {
+                best = i;
+            }
+        }
+        if (best < 0) {
+            return; // 没有可执行的事务
+        }
+
+        b->active = best;
+        b->active_start = HAL_GetTick();
+        b->active_start_us = Timebase_Us();
+        b->active_budget = bus_txn_budget(&b->slots[best].txn);
+        bus_apply_speed(b, b->slots[best].txn.dev_addr);
+        HAL_StatusTypeDef started = bus_start(b, &b->slots[best]);
+        if (started == HAL_OK) {
+            TRACE(TRACE_EV_I2C_START, b->slots[best].txn.dev_addr);
+            return;
+        }
+        if (started == HAL_BUSY) {
+            b->recover_pending = true; // BUSY 标志卡住 (SDA 被拉低或外设状态异常)，由主循环恢复
+        }
+        bus_complete(b, HAL_ERROR); // 启动失败，结束该事务后继续尝试下一个
+    }
+}
+
+/**
+ * @brief 结束当前事务：释放槽位、记录忙碌期、调用回调并启动下一个事务
+ * @param[in,out] b 总线
+ * @param[in] status 事务结果
+ * @return 无
+ */
+static void bus_complete(Bus_t *b, HAL_StatusTypeDef status)
+{
+    if (b->active < 0) {
+        return;
+    }
+
+    Bus_Slot_t *slot = &b->slots[b->active];
+    I2C_Bus_Callback_t cb = slot->txn.cb;
+    void *ctx = slot->txn.ctx;
+
+    bus_busy_us += Timebase_Us() - b->active_start_us;
+
+#if PROFILER_ENABLE
+    Profiler_I2C_Result_e result = PROF_I2C_OK;
+    if (status == HAL_TIMEOUT) {
+        result = PROF_I2C_TIMEOUT;
+    } else if (status != HAL_OK) {
+        result = (b->hi2c->ErrorCode & HAL_I2C_ERROR_AF) ? PROF_I2C_NACK : PROF_I2C_ERROR;
+    }
+    Profiler_Count_I2C(slot->txn.dev_addr, (status == HAL_OK) ? slot->txn.size : 0,
+                       Timebase_Us() - b->active_start_us, result);
+#endif
+    if (!b->recover_pending) {
+        bus_health_update(slot->txn.dev_addr, status == HAL_OK); // 外设自身卡住导致的启动失败不记在设备上
+    }
+    if (status == HAL_OK && slot->txn.hold_ms > 0) {
+        b->hold.active = true;
+        b->hold.addr = slot->txn.dev_addr;
+        b->hold.until = HAL_GetTick() + slot->txn.hold_ms;
+        b->hold.polled = HAL_GetTick(); // 刚写完时设备必然不应答，下一个滴答再开始轮询
+    }
+    slot->used = false;
+    b->active = BUS_IDLE;
+    TRACE(TRACE_EV_I2C_DONE, (slot->txn.dev_addr & 0xFF) | ((uint16_t)status << 8));
+
+    if (cb != NULL) {
+        cb(status, ctx); // 回调中提交的高优先级事务会在下面立即被选中
+    }
+    bus_kick(b);
+}
+
+/**
+ * @brief 阻塞传输使用的完成回调
+ * @param[in] status 事务结果
+ * @param[in] ctx 指向 Bus_Wait_t 的指针
+ * @return 无
+ */
+static void bus_wait_cb(HAL_StatusTypeDef status, void *ctx)
+{
+    Bus_Wait_t *wait = (Bus_Wait_t *)ctx;
+    wait->status = status;
+    wait->done = true;
+}
+
+/**
+ * @brief 紧急写入中等待 SR1 的某个标志
+ * @param[in] i2c 外设寄存器
+ * @param[in] flag 等待的 SR1 标志
+ * @param[in] start 开始计时的 CYCCNT
+ * @param[in] limit 超时周期数
+ * @return HAL_StatusTypeDef 从机 NACK 返回 HAL_ERROR (AF 已清除)，超时返回 HAL_TIMEOUT
+ */
+static HAL_StatusTypeDef bus_emerg_wait(I2C_TypeDef *i2c, uint32_t flag, uint32_t start, uint32_t limit)
+{
+    while (!(i2c->SR1 & flag)) {
+        if (i2c->SR1 & I2C_SR1_AF) {
+            i2c->SR1 = (uint32_t)~I2C_SR1_AF;
+            return HAL_ERROR;
+        }
+        if (DWT->CYCCNT - start > limit) {
+            return HAL_TIMEOUT;
+        }
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief 以寄存器轮询方式进行一次写入
+ * @details 起始条件、设备地址、存储地址 (高字节在前)、数据，最后发送停止条件。
+ *          无论结果如何都以停止条件结束，EEPROM 内部写周期期间的 NACK 可以直接重试。
+ * @param[in] i2c 外设寄存器
+ * @param[in] dev_addr 设备8位地址
+ * @param[in] mem_addr 存储地址
+ * @param[in] mem_addr_size 存储地址长度
+ * @param[in] data 数据
+ * @param[in] size 数据长度
+ * @param[in] start 开始计时的 CYCCNT
+ * @param[in] limit 超时周期数
+ * @return HAL_StatusTypeDef 设备未应答返回 HAL_ERROR，超时返回 HAL_TIMEOUT
+ */
+static HAL_StatusTypeDef bus_emerg_attempt(I2C_TypeDef *i2c, uint16_t dev_addr, uint16_t mem_addr,
+                                           uint16_t mem_addr_size, const uint8_t *data, uint16_t size,
+                                           uint32_t start, uint32_t limit)
+{
+    HAL_StatusTypeDef status;
+    uint8_t head[2];
+    uint16_t head_len = 0;
+
+    if (mem_addr_size == I2C_MEMADD_SIZE_16BIT) {
+        head[head_len++] = (uint8_t)(mem_addr >> 8);
+    }
+    head[head_len++] = (uint8_t)mem_addr;
+
+    i2c->CR1 |= I2C_CR1_START;
+    status = bus_emerg_wait(i2c, I2C_SR1_SB, start, limit);
+    if (status == HAL_OK) {
+        i2c->DR = (uint8_t)(dev_addr & ~1U);
+        status = bus_emerg_wait(i2c, I2C_SR1_ADDR, start, limit);
+    }
+    if (status == HAL_OK) {
+        (void)i2c->SR2; // 读 SR1 后读 SR2 清除 ADDR
+    }
+    for (uint16_t i = 0; status == HAL_OK && i < head_len + size; i++) {
+        status = bus_emerg_wait(i2c, I2C_SR1_TXE, start, limit);
+        if (status == HAL_OK) {
+            i2c->DR = i < head_len ? head[i] : data[i - head_len];
+        }
+    }
+    if (status == HAL_OK) {
+        status = bus_emerg_wait(i2c, I2C_SR1_BTF, start, limit);
+    }
+
+    i2c->CR1 |= I2C_CR1_STOP;
+    while ((i2c->CR1 & I2C_CR1_STOP) && DWT->CYCCNT - start <= limit) {
+    }
+    return status;
+}
+
+/**
+ * @brief 登记一条总线并复位它的状态
+ * @details 恢复引脚按外设选择：I2C2 为 I2C_BUS2_SCL/SDA，其余为 I2C_BUS_SCL/SDA。
+ *          MCU 复位时从机可能正停在读操作的中间，SDA 为低或外设的 BUSY 标志卡住时先恢复总线。
+ * @param[in] hi2c HAL句柄，须已初始化
+ * @return Bus_t* 总线，总线数已满时为 NULL
+ */
+static Bus_t *bus_setup(I2C_HandleTypeDef *hi2c)
+{
+    Bus_t *b = bus_of_handle(hi2c);
+
+    if (b == NULL) {
+        if (bus_count >= I2C_BUS_COUNT) {
+            return NULL;
+        }
+        b = &buses[bus_count++];
+    }
+
+    b->hi2c = hi2c;
+    b->active = BUS_IDLE;
+    b->fast = BUS_FAST_NONE;
+    b->hold.active = false;
+    b->recover_pending = false;
+    b->speed_now = hi2c->Init.ClockSpeed;
+    for (uint8_t i = 0; i < I2C_BUS_QUEUE_SIZE; i++) {
+        b->slots[i].used = false;
+    }
+#ifdef I2C2
+    if (hi2c->Instance == I2C2) {
+        b->scl_port = I2C_BUS2_SCL_PORT;
+        b->scl_pin = I2C_BUS2_SCL_PIN;
+        b->sda_port = I2C_BUS2_SDA_PORT;
+        b->sda_pin = I2C_BUS2_SDA_PIN;
+    } else
+#endif
+    {
+        b->scl_port = I2C_BUS_SCL_PORT;
+        b->scl_pin = I2C_BUS_SCL_PIN;
+        b->sda_port = I2C_BUS_SDA_PORT;
+        b->sda_pin = I2C_BUS_SDA_PIN;
+    }
+
+    if (HAL_GPIO_ReadPin(b->sda_port, b->sda_pin) == GPIO_PIN_RESET || __HAL_I2C_GET_FLAG(hi2c, I2C_FLAG_BUSY)) {
+        bus_recover(b);
+    }
+    return b;
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 初始化总线管理模块
+ * @param[in] hi2c 指向默认I2C外设的HAL句柄
+ * @return 无
+ */
+void I2C_Bus_Init(I2C_HandleTypeDef *hi2c)
+{
+    bus_count = 0;
+    for (uint8_t i = 0; i < I2C_BUS_ROUTES; i++) {
+        bus_route[i].bus = 0;
+    }
+    for (uint8_t i = 0; i < I2C_BUS_HEALTH_DEVICES; i++) {
+        bus_health[i].addr = 0;
+    }
+    bus_setup(hi2c);
+}
+
+/**
+ * @brief 增加一条总线，并把一个设备的事务改走这条总线
+ * @param[in] hi2c 指向I2C外设的HAL句柄
+ * @param[in] dev_addr 设备8位地址
+ * @return HAL_StatusTypeDef 未初始化、总线数或路由表已满返回 HAL_ERROR
+ */
+HAL_StatusTypeDef I2C_Bus_Attach(I2C_HandleTypeDef *hi2c, uint16_t dev_addr)
+{
+    Bus_t *b;
+    int8_t free_slot = -1;
+
+    if (bus_count == 0 || hi2c == NULL) {
+        return HAL_ERROR;
+    }
+    for (int8_t i = 0; i < I2C_BUS_ROUTES; i++) {
+        if (bus_route[i].bus == 0 && free_slot < 0) {
+            free_slot = i;
+        }
+        if (bus_route[i].bus != 0 && bus_route[i].addr == dev_addr) {
+            free_slot = i; // 已登记过，改为新的总线
+            break;
+        }
+    }
+    if (free_slot < 0) {
+        return HAL_ERROR;
+    }
+    b = bus_of_handle(hi2c);
+    if (b == NULL) {
+        b = bus_setup(hi2c);
+    }
+    if (b == NULL) {
+        return HAL_ERROR;
+    }
+
+    bus_route[free_slot].addr = dev_addr;
+    bus_route[free_slot].bus = (uint8_t)(b - buses); // 默认总线下标为 0，登记它等于删除表项
+    return HAL_OK;
+}
+
+/**
+ * @brief 提交一个异步事务
+ * @param[in] txn 事务描述
+ * @param[in] prio 事务优先级
+ * @return HAL_StatusTypeDef 已加入队列返回 HAL_OK，队列已满返回 HAL_BUSY，设备降级且未到重试时间返回 HAL_ERROR
+ */
+HAL_StatusTypeDef I2C_Bus_Submit(const I2C_Bus_Txn_t *txn, I2C_Bus_Prio_e prio)
+{
+    Bus_t *b = (txn != NULL) ? bus_of_addr(txn->dev_addr) : NULL;
+
+    if (b == NULL || prio >= I2C_BUS_PRIO_COUNT) {
+        return HAL_ERROR;
+    }
+
+    HAL_StatusTypeDef ret = HAL_BUSY;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (!bus_health_admit(txn->dev_addr)) {
+        __set_PRIMASK(primask);
+        return HAL_ERROR;
+    }
+    for (uint8_t i = 0; i < I2C_BUS_QUEUE_SIZE; i++) {
+        if (!b->slots[i].used) {
+            b->slots[i].txn = *txn;
+            b->slots[i].prio = (uint8_t)prio;
+            b->slots[i].seq = bus_seq++;
+            b->slots[i].used = true;
+            ret = HAL_OK;
+            break;
+        }
+    }
+    if (ret == HAL_OK) {
+        bus_kick(b);
+    }
+
+    __set_PRIMASK(primask);
+    return ret;
+}
+
+/**
+ * @brief 提交事务并等待其完成
+ * @param[in] txn 事务描述 (cb/ctx 字段被忽略)
+ * @param[in] prio 事务优先级
+ * @param[in] timeout 超时时间 (ms)
+ * @return HAL_StatusTypeDef 事务结果，排队超时返回 HAL_TIMEOUT
+ */
+HAL_StatusTypeDef I2C_Bus_Transfer(const I2C_Bus_Txn_t *txn, I2C_Bus_Prio_e prio, uint32_t timeout)
+{
+    Bus_Wait_t wait = {false, HAL_ERROR};
+    I2C_Bus_Txn_t t = *txn;
+    Bus_t *b = bus_of_addr(txn->dev_addr);
+    uint32_t tickstart = HAL_GetTick();
+    HAL_StatusTypeDef ret;
+
+    t.cb = bus_wait_cb;
+    t.ctx = &wait;
+    PROF_BEGIN(PROF_SEC_I2C_WAIT); // 主循环在这里停顿的时间计入卡顿归因
+
+    // 队列满时等待空位
+    while ((ret = I2C_Bus_Submit(&t, prio)) == HAL_BUSY) {
+        if (HAL_GetTick() - tickstart > timeout) {
+            ret = HAL_TIMEOUT;
+            break;
+        }
+        I2C_Bus_Service();
+    }
+    if (ret != HAL_OK) {
+        PROF_END(PROF_SEC_I2C_WAIT);
+        return ret;
+    }
+
+    while (!wait.done) {
+        I2C_Bus_Service();
+
+        if (HAL_GetTick() - tickstart > timeout) {
+            // 尚未开始执行的事务直接撤销；已在执行的事务由执行时间上限兜底结束
+            uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+            for (int8_t i = 0; i < I2C_BUS_QUEUE_SIZE; i++) {
+                if (b->slots[i].used && i != b->active && b->slots[i].txn.ctx == &wait) {
+                    b->slots[i].used = false;
+                    wait.status = HAL_TIMEOUT;
+                    wait.done = true;
+                }
+            }
+            __set_PRIMASK(primask);
+        }
+    }
+    PROF_END(PROF_SEC_I2C_WAIT);
+    return wait.status;
+}
+
+/**
+ * @brief 总线维护函数，需在主循环中周期调用
+ * @return 无
+ */
+void I2C_Bus_Service(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint8_t i = 0; i < bus_count; i++) {
+        Bus_t *b = &buses[i];
+
+        if (b->halted) {
+            continue;
+        }
+        if (b->active >= 0 && HAL_GetTick() - b->active_start > b->active_budget) {
+            // 事务卡死 (如从机拉低SDA)，释放总线、复位外设后以超时结束该事务
+            bus_recover(b);
+            bus_complete(b, HAL_TIMEOUT);
+        } else if (b->recover_pending && b->active == BUS_IDLE) {
+            bus_recover(b);
+        }
+        if (primask == 0) {
+            bus_poll_hold(b); // 探测期间需要开中断，调用者已关中断时跳过，忙碌期按 hold_ms 到期
+        }
+        bus_kick(b); // 忙碌期结束后启动被推迟的事务
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 查询设备是否处于降级状态
+ * @param[in] dev_addr 设备8位地址
+ * @return bool 降级返回 true
+ */
+bool I2C_Bus_Is_Degraded(uint16_t dev_addr)
+{
+    for (uint8_t i = 0; i < I2C_BUS_HEALTH_DEVICES; i++) {
+        if (bus_health[i].addr == dev_addr) {
+            return bus_health[i].backoff != 0;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 查询所有总线是否空闲 (无进行中和排队中的事务)
+ * @return bool 空闲返回 true
+ */
+bool I2C_Bus_Is_Idle(void)
+{
+    for (uint8_t n = 0; n < bus_count; n++) {
+        if (buses[n].active != BUS_IDLE) {
+            return false;
+        }
+        for (uint8_t i = 0; i < I2C_BUS_QUEUE_SIZE; i++) {
+            if (buses[n].slots[i].used) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 获取启动以来所有总线上事务执行的累计时间
+ * @return uint64_t 累计时间 (us)
+ */
+uint64_t I2C_Bus_Get_Busy_Us(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint64_t us;
+
+    __disable_irq(); // 完成回调在中断中累加，64位的值分两次读
+    us = bus_busy_us;
+    __set_PRIMASK(primask);
+    return us;
+}
+
+/**
+ * @brief 系统时钟改变后按新的 PCLK1 重新计算外设时序
+ * @details 与 bus_apply_speed() 相同，寄存器只允许在 PE=0 时修改。所有总线都在 APB1 上。
+ * @return 无
+ */
+void I2C_Bus_Clock_Changed(void)
+{
+    uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+
+    for (uint8_t n = 0; n < bus_count; n++) {
+        Bus_t *b = &buses[n];
+        I2C_TypeDef *i2c = b->hi2c->Instance;
+
+        for (uint16_t spin = 0; (i2c->CR1 & I2C_CR1_STOP) && spin < 1000; spin++) {
+        }
+
+        __HAL_I2C_DISABLE(b->hi2c);
+        MODIFY_REG(i2c->CR2, I2C_CR2_FREQ, I2C_FREQRANGE(pclk));
+        i2c->TRISE = I2C_RISE_TIME(I2C_FREQRANGE(pclk), b->speed_now);
+        i2c->CCR = I2C_SPEED(pclk, b->speed_now, b->hi2c->Init.DutyCycle);
+        __HAL_I2C_ENABLE(b->hi2c);
+    }
+}
+
+/**
+ * @brief 设置发往某个设备的事务使用的 SCL 速率
+ * @param[in] dev_addr 设备8位地址
+ * @param[in] hz 速率 (Hz)，0 表示恢复为默认速率
+ * @return HAL_StatusTypeDef 速率表已满返回 HAL_BUSY
+ */
+HAL_StatusTypeDef I2C_Bus_Set_Speed(uint16_t dev_addr, uint32_t hz)
+{
+    int8_t free_slot = -1;
+
+    for (int8_t i = 0; i < I2C_BUS_PROFILES; i++) {
+        if (bus_speed[i].hz != 0 && bus_speed[i].addr == dev_addr) {
+            bus_speed[i].hz = hz; // 总线线程只读取，32位写入是原子的
+            return HAL_OK;
+        }
+        if (bus_speed[i].hz == 0 && free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    if (hz == 0) {
+        return HAL_OK;
+    }
+    if (free_slot < 0) {
+        return HAL_BUSY;
+    }
+    bus_speed[free_slot].addr = dev_addr;
+    bus_speed[free_slot].hz = hz;
+    return HAL_OK;
+}
+
+/**
+ * @brief 获取发往某个设备的事务使用的 SCL 速率
+ * @param[in] dev_addr 设备8位地址
+ * @return uint32_t 速率 (Hz)
+ */
+uint32_t I2C_Bus_Get_Speed(uint16_t dev_addr)
+{
+    for (uint8_t i = 0; i < I2C_BUS_PROFILES; i++) {
+        if (bus_speed[i].hz != 0 && bus_speed[i].addr == dev_addr) {
+            return bus_speed[i].hz;
+        }
+    }
+    Bus_t *b = bus_of_addr(dev_addr);
+
+    return (b != NULL) ? b->hi2c->Init.ClockSpeed : 0;
+}
+
+/**
+ * @brief 校准某个设备的 SCL 速率 (阻塞)
+ * @param[in] dev_addr 设备8位地址
+ * @param[in] min_hz 最低速率 (Hz)
+ * @param[in] max_hz 尝试的最高速率 (Hz)
+ * @param[in] verify 验证函数
+ * @param[in] ctx 验证函数的上下文
+ * @return uint32_t 最终使用的速率 (Hz)
+ */
+uint32_t I2C_Bus_Calibrate(uint16_t dev_addr, uint32_t min_hz, uint32_t max_hz, I2C_Bus_Verify_t verify, void *ctx)
+{
+    uint32_t result = min_hz;
+
+    for (uint32_t hz = max_hz; hz > min_hz; hz -= I2C_BUS_CAL_STEP_HZ) {
+        uint8_t tries = 0;
+
+        if (I2C_Bus_Set_Speed(dev_addr, hz) != HAL_OK) {
+            break;
+        }
+        while (tries < I2C_BUS_CAL_TRIES && verify(ctx) == HAL_OK) {
+            tries++;
+        }
+        if (tries == I2C_BUS_CAL_TRIES) {
+            uint32_t margin = (uint32_t)I2C_BUS_CAL_MARGIN * I2C_BUS_CAL_STEP_HZ;
+            result = (hz - min_hz > margin) ? hz - margin : min_hz;
+            break;
+        }
+        if (hz - min_hz < I2C_BUS_CAL_STEP_HZ) {
+            break; // 下一档会低于最低速率
+        }
+    }
+
+    I2C_Bus_Set_Speed(dev_addr, result);
+    return result;
+}
+
+/**
+ * @brief 掉电前的紧急写入 (阻塞，可在中断中调用)
+ * @param[in] dev_addr 设备8位地址
+ * @param[in] mem_addr 存储地址
+ * @param[in] mem_addr_size 存储地址长度 (I2C_MEMADD_SIZE_8BIT 或 I2C_MEMADD_SIZE_16BIT)
+ * @param[in] data 数据
+ * @param[in] size 数据长度
+ * @param[in] timeout_us 包括 ACK 轮询在内的总时间上限 (us)
+ * @return HAL_StatusTypeDef 设备始终未应答返回 HAL_ERROR，超时返回 HAL_TIMEOUT
+ */
+HAL_StatusTypeDef I2C_Bus_Emergency_Write(uint16_t dev_addr, uint16_t mem_addr, uint16_t mem_addr_size,
+                                          const uint8_t *data, uint16_t size, uint32_t timeout_us)
+{
+    Bus_t *b = bus_of_addr(dev_addr);
+    HAL_StatusTypeDef status;
+    uint32_t primask;
+    uint32_t start;
+    uint32_t limit;
+
+    if (b == NULL) {
+        return HAL_ERROR;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    b->halted = true;
+    b->hi2c->Instance->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITERREN | I2C_CR2_ITBUFEN | I2C_CR2_DMAEN);
+    SystemCoreClockUpdate(); // 可能刚从停止模式唤醒，仍运行在 HSI 上
+    bus_recover(b);          // 中止进行中的事务，外设和 DMA 通道一并复位
+    bus_apply_speed(b, dev_addr);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    limit = timeout_us * (SystemCoreClock / 1000000U);
+    start = DWT->CYCCNT;
+    do {
+        status = bus_emerg_attempt(b->hi2c->Instance, dev_addr, mem_addr, mem_addr_size, data, size, start, limit);
+    } while (status == HAL_ERROR && DWT->CYCCNT - start <= limit); // 上一次写周期未结束时 NACK，继续轮询
+
+    __set_PRIMASK(primask);
+    return status;
+}
+
+/**
+ * @brief 运行时切换显示器写事务的发送路径
+ * @param[in] enable true 走寄存器级路径
+ * @return 无
+ */
+void I2C_Bus_Set_Fast(bool enable)
+{
+    bus_fast_on = enable;
+}
+
+/**
+ * @brief I2C 事件中断的寄存器级处理
+ * @details SB 时发送设备地址；ADDR 时读 SR2 清除标志，先写入存储地址 (如有)，再打开 DMA 请求并关闭事件中断；
+ *          DMA 完成后的 BTF 时结束事务。
+ * @param[in] hi2c 产生中断的外设的HAL句柄
+ * @return bool 中断已处理时返回 true
+ */
+bool I2C_Bus_EV_IRQHandler(I2C_HandleTypeDef *hi2c)
+{
+    Bus_t *b = bus_of_handle(hi2c);
+    I2C_TypeDef *i2c = hi2c->Instance;
+    uint32_t sr1;
+
+    if (b == NULL || b->fast == BUS_FAST_NONE) {
+        return false;
+    }
+
+    sr1 = i2c->SR1;
+    switch (b->fast) {
+        case BUS_FAST_SB:
+            if (sr1 & I2C_SR1_SB) {
+                i2c->DR = (uint8_t)(b->slots[b->active].txn.dev_addr & ~1U);
+                b->fast = BUS_FAST_ADDR;
+            }
+            break;
+        case BUS_FAST_ADDR:
+            if (sr1 & I2C_SR1_ADDR) {
+                i2c->CR2 &= ~I2C_CR2_ITEVTEN; // DMA 发送期间不需要事件中断
+                (void)i2c->SR2;               // 读 SR1 后读 SR2 清除 ADDR
+                if (b->fast_head) {
+                    i2c->DR = b->fast_mem;
+                }
+                b->fast = BUS_FAST_DMA;
+                i2c->CR2 |= I2C_CR2_DMAEN;
+            }
+            break;
+        case BUS_FAST_BTF:
+            if (sr1 & I2C_SR1_BTF) {
+                bus_fast_stop(b, HAL_OK, HAL_I2C_ERROR_NONE);
+            }
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+/**
+ * @brief I2C 错误中断的寄存器级处理
+ * @details 清除错误标志并结束事务，NACK 记为 HAL_I2C_ERROR_AF，与 HAL 路径的统计一致。
+ * @param[in] hi2c 产生中断的外设的HAL句柄
+ * @return bool 中断已处理时返回 true
+ */
+bool I2C_Bus_ER_IRQHandler(I2C_HandleTypeDef *hi2c)
+{
+    Bus_t *b = bus_of_handle(hi2c);
+    I2C_TypeDef *i2c = hi2c->Instance;
+    uint32_t sr1;
+    uint32_t error = HAL_I2C_ERROR_NONE;
+
+    if (b == NULL || b->fast == BUS_FAST_NONE) {
+        return false;
+    }
+
+    sr1 = i2c->SR1;
+    if (sr1 & I2C_SR1_BERR) {
+        error |= HAL_I2C_ERROR_BERR;
+    }
+    if (sr1 & I2C_SR1_ARLO) {
+        error |= HAL_I2C_ERROR_ARLO;
+    }
+    if (sr1 & I2C_SR1_AF) {
+        error |= HAL_I2C_ERROR_AF;
+    }
+    if (sr1 & I2C_SR1_OVR) {
+        error |= HAL_I2C_ERROR_OVR;
+    }
+    i2c->SR1 = (uint32_t)~(I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR);
+    if (error != HAL_I2C_ERROR_NONE) {
+        bus_fast_stop(b, HAL_ERROR, error);
+    }
+    return true;
+}
+
+/* HAL callbacks -------------------------------------------------------------*/
+
+/**
+ * @brief I2C 主机发送完成回调
+ * @param[in] hi2c 指向 I2C 句柄的指针
+ * @return 无
+ */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    Bus_t *b = bus_of_handle(hi2c);
+
+    if (b != NULL) {
+        bus_complete(b, HAL_OK);
+    }
+}
+
+/**
+ * @brief I2C 主机接收完成回调
+ * @param[in] hi2c 指向 I2C 句柄的指针
+ * @return 无
+ */
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    Bus_t *b = bus_of_handle(hi2c);
+
+    if (b != NULL) {
+        bus_complete(b, HAL_OK);
+    }
+}
+
+/**
+ * @brief I2C 存储器写完成回调
+ * @param[in] hi2c 指向 I2C 句柄的指针
+ * @return 无
+ */
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    Bus_t *b = bus_of_handle(hi2c);
+
+    if (b != NULL) {
+        bus_complete(b, HAL_OK);
+    }
+}
+
+/**
+ * @brief I2C 存储器读完成回调
+ * @param[in] hi2c 指向 I2C 句柄的指针
+ * @return 无
+ */
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    Bus_t *b = bus_of_handle(hi2c);
+
+    if (b != NULL) {
+        bus_complete(b, HAL_OK);
+    }
+}
+
+/**
+ * @brief I2C 错误回调 (NACK、仲裁丢失等)
+ * @param[in] hi2c 指向 I2C 句柄的指针
+ * @return 无
+ */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    Bus_t *b = bus_of_handle(hi2c);
+
+    if (b != NULL) {
+        bus_complete(b, HAL_ERROR);
+    }
+}
+
+/**
+ * @}
+ */
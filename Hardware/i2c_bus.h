@@ -0,0 +1,272 @@
+/**
+ * @file      i2c_bus.h
+ * @brief     共享I2C总线管理模块头文件
+ * @details   I2C1 上挂有 SSD1306、DS3231、AT24C32 和 AHT20 四个设备。
+ *            本模块把所有访问统一为带优先级的事务队列，由 DMA/中断驱动逐个完成，
+ *            完成后通过回调通知发起者。各驱动不再直接调用 HAL I2C 函数。
+ *            每个设备可以有自己的 SCL 速率 (见 I2C_Bus_Set_Speed)，启动发往该设备的事务前切换。
+ *            每个事务的执行时间上限按数据长度和速率计算，超时后释放卡死的总线 (9 个 SCL 脉冲和停止条件)
+ *            并复位外设；连续失败的设备被标记为降级，按指数退避的间隔放行重试，其余时间提交直接失败，
+ *            不再占用总线，显示刷新不受影响。
+ *            显示屏可以单独接在 I2C2 上 (U8G2_TRANSPORT_I2C2)：I2C_Bus_Attach 登记第二条总线，
+ *            两条总线各有自己的队列并同时工作，整帧刷新不再推迟传感器和 RTC 的读取。
+ *            同一总线上的副显示器以 I2C_BUS_PRIO_PANEL 按页提交，主显示器和传感器的事务插在它的两页之间。
+ *            显示器的写事务 (I2C_BUS_FAST_TX) 直接操作 I2C 和 DMA 寄存器，其余设备仍走 HAL。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.4
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __I2C_BUS_H
+#define __I2C_BUS_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup I2C_Bus I2C总线管理
+ * @brief 提供了带优先级的异步I2C事务队列。
+ * @{
+ */
+
+/**
+ * @defgroup I2C_Bus_Config I2C总线配置
+ * @{
+ */
+#define I2C_BUS_QUEUE_SIZE      8   ///< 事务队列的槽位数
+#define I2C_BUS_TXN_BASE_MS     2   ///< 事务执行时间上限的固定部分 (ms)，覆盖启动延迟和 SysTick 的计时粒度
+#define I2C_BUS_TXN_SLACK       2   ///< 事务执行时间上限相对按速率算出的传输时间的倍数 (时钟延展等)
+#define I2C_BUS_POLL_TIMEOUT_MS 1   ///< 忙碌设备 ACK 轮询的单次超时 (ms)
+#define I2C_BUS_PROFILES        4   ///< 可单独设置速率的设备数，其余设备使用 hi2c->Init.ClockSpeed
+#define I2C_BUS_CAL_STEP_HZ     100000 ///< 速率校准每一档的步长 (Hz)
+#define I2C_BUS_CAL_TRIES       16  ///< 速率校准中每一档需要连续通过的验证次数
+#define I2C_BUS_CAL_MARGIN      1   ///< 校准结果比最高通过的档位低的档数 (留出温度和电压余量)
+#define I2C_BUS_SCL_PORT        GPIOB       ///< 总线恢复时以 GPIO 方式驱动的 SCL 引脚
+#define I2C_BUS_SCL_PIN         GPIO_PIN_6
+#define I2C_BUS_SDA_PORT        GPIOB       ///< 总线恢复时以 GPIO 方式驱动的 SDA 引脚
+#define I2C_BUS_SDA_PIN         GPIO_PIN_7
+#define I2C_BUS_RECOVER_PULSES  9   ///< 总线恢复时最多发出的 SCL 脉冲数
+#define I2C_BUS_RECOVER_HALF_US 5   ///< 总线恢复时 SCL 的半周期 (us, 约 100kHz)
+#define I2C_BUS_HEALTH_DEVICES  4   ///< 跟踪失败次数的设备数
+#define I2C_BUS_DEGRADE_FAILS   3   ///< 连续失败多少次后设备被标记为降级
+#define I2C_BUS_BACKOFF_MIN_MS  100    ///< 降级后第一次重试的间隔 (ms)，之后每次失败加倍
+#define I2C_BUS_BACKOFF_MAX_MS  30000  ///< 重试间隔的上限 (ms)
+#define I2C_BUS_COUNT           2   ///< 最多管理的总线 (I2C 外设) 数
+#define I2C_BUS_ROUTES          4   ///< 不在默认总线上的设备数
+#define I2C_BUS2_SCL_PORT       GPIOB       ///< I2C2 总线恢复时以 GPIO 方式驱动的 SCL 引脚
+#define I2C_BUS2_SCL_PIN        GPIO_PIN_10
+#define I2C_BUS2_SDA_PORT       GPIOB       ///< I2C2 总线恢复时以 GPIO 方式驱动的 SDA 引脚
+#define I2C_BUS2_SDA_PIN        GPIO_PIN_11
+#ifndef I2C_BUS_FAST_TX
+#define I2C_BUS_FAST_TX         1   ///< 为 1 时显示器 (DISPLAY/PANEL 优先级) 的写事务走寄存器级的 DMA 发送路径
+#endif
+/** @} */
+
+/**
+ * @brief 事务优先级，数值越小越先执行
+ */
+typedef enum {
+    I2C_BUS_PRIO_DISPLAY = 0, ///< 显示刷新
+    I2C_BUS_PRIO_SENSOR,      ///< 传感器和RTC读写
+    I2C_BUS_PRIO_PANEL,       ///< 副显示器刷新 (按页提交，主显示器和传感器的事务插在两页之间)
+    I2C_BUS_PRIO_STORAGE,     ///< EEPROM读写
+    I2C_BUS_PRIO_COUNT
+} I2C_Bus_Prio_e;
+
+/**
+ * @brief 事务类型
+ */
+typedef enum {
+    I2C_BUS_OP_TX = 0,    ///< 主机发送
+    I2C_BUS_OP_RX,        ///< 主机接收
+    I2C_BUS_OP_MEM_WRITE, ///< 写设备寄存器/存储器
+    I2C_BUS_OP_MEM_READ   ///< 读设备寄存器/存储器
+} I2C_Bus_Op_e;
+
+/**
+ * @brief 事务完成回调
+ * @note 在I2C中断上下文中调用，应尽量简短；允许在回调中提交新事务。
+ * @param[in] status 事务结果 (HAL_OK / HAL_ERROR / HAL_TIMEOUT)
+ * @param[in] ctx 提交事务时传入的上下文指针
+ */
+typedef void (*I2C_Bus_Callback_t)(HAL_StatusTypeDef status, void *ctx);
+
+/**
+ * @brief I2C事务描述
+ * @details 提交时整体拷贝进队列，但 data 指向的缓冲区必须保持有效直到回调被调用。
+ */
+typedef struct {
+    I2C_Bus_Op_e op;          ///< 事务类型
+    uint16_t dev_addr;        ///< 设备8位地址
+    uint16_t mem_addr;        ///< 寄存器/存储器地址 (仅 MEM 类型)
+    uint16_t mem_addr_size;   ///< I2C_MEMADD_SIZE_8BIT 或 I2C_MEMADD_SIZE_16BIT
+    uint8_t *data;            ///< 数据缓冲区
+    uint16_t size;            ///< 数据长度
+    uint16_t hold_ms;         ///< 完成后该设备最长的忙碌时间 (如EEPROM写周期)，期间总线仍可服务其他设备，设备提前应答则提前结束
+    I2C_Bus_Callback_t cb;    ///< 完成回调，可为NULL
+    void *ctx;                ///< 回调上下文
+} I2C_Bus_Txn_t;
+
+/**
+ * @brief 速率校准的验证函数
+ * @details 以当前设置的速率对设备做一次完整的读写 (如写入后读回比较 CRC)，在主循环上下文中调用。
+ * @param[in] ctx 调用 I2C_Bus_Calibrate 时传入的上下文
+ * @return HAL_StatusTypeDef 通过返回 HAL_OK
+ */
+typedef HAL_StatusTypeDef (*I2C_Bus_Verify_t)(void *ctx);
+
+/**
+ * @brief 初始化总线管理模块
+ * @details hi2c 为默认总线，没有经 I2C_Bus_Attach 登记的设备都走这条总线。
+ * @param[in] hi2c 指向默认I2C外设的HAL句柄
+ * @return 无
+ */
+void I2C_Bus_Init(I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief 增加一条总线，并把一个设备的事务改走这条总线
+ * @details 须在 I2C_Bus_Init 之后、向该设备提交事务之前调用，hi2c 须已初始化。
+ *          同一条总线可以登记多个设备，每次调用登记一个；对默认总线调用则把设备改回默认总线。
+ *          各总线的队列、忙碌期和超时恢复互相独立，速率表和降级记录按设备地址共用。
+ * @param[in] hi2c 指向I2C外设的HAL句柄
+ * @param[in] dev_addr 设备8位地址
+ * @return HAL_StatusTypeDef
+ *         - @retval HAL_OK 登记成功
+ *         - @retval HAL_ERROR 未初始化，或总线数 (I2C_BUS_COUNT)、路由表 (I2C_BUS_ROUTES) 已满
+ */
+HAL_StatusTypeDef I2C_Bus_Attach(I2C_HandleTypeDef *hi2c, uint16_t dev_addr);
+
+/**
+ * @brief 提交一个异步事务
+ * @details 可在主循环或中断 (包括事务回调) 中调用。
+ * @param[in] txn 事务描述
+ * @param[in] prio 事务优先级
+ * @return HAL_StatusTypeDef
+ *         - @retval HAL_OK 已加入队列
+ *         - @retval HAL_BUSY 队列已满
+ *         - @retval HAL_ERROR 未初始化、参数错误，或目标设备已降级且未到重试时间
+ */
+HAL_StatusTypeDef I2C_Bus_Submit(const I2C_Bus_Txn_t *txn, I2C_Bus_Prio_e prio);
+
+/**
+ * @brief 提交事务并等待其完成
+ * @details 供初始化阶段和少量低频操作使用，等待期间其他事务照常执行。
+ *          不可在中断中调用。
+ * @param[in] txn 事务描述 (cb/ctx 字段被忽略)
+ * @param[in] prio 事务优先级
+ * @param[in] timeout 超时时间 (ms)
+ * @return HAL_StatusTypeDef 事务结果
+ */
+HAL_StatusTypeDef I2C_Bus_Transfer(const I2C_Bus_Txn_t *txn, I2C_Bus_Prio_e prio, uint32_t timeout);
+
+/**
+ * @brief 总线维护函数，需在主循环中周期调用
+ * @details 依次处理每条总线：对忙碌设备做 ACK 轮询，忙碌期 (hold_ms) 结束后启动被推迟的事务，并处理事务超时和总线恢复。
+ * @return 无
+ */
+void I2C_Bus_Service(void);
+
+/**
+ * @brief 查询设备是否处于降级状态
+ * @details 连续失败 I2C_BUS_DEGRADE_FAILS 次后进入降级，下一次成功的事务后恢复。
+ * @param[in] dev_addr 设备8位地址
+ * @return bool 降级返回 true
+ */
+bool I2C_Bus_Is_Degraded(uint16_t dev_addr);
+
+/**
+ * @brief 查询所有总线是否空闲 (无进行中和排队中的事务)
+ * @return bool 空闲返回 true
+ */
+bool I2C_Bus_Is_Idle(void);
+
+/**
+ * @brief 获取启动以来所有总线上事务执行的累计时间
+ * @details 从事务启动到完成 (包括出错和超时) 的时间之和，供低功耗管理估算上拉电阻的耗电。
+ * @return uint64_t 累计时间 (us)
+ */
+uint64_t I2C_Bus_Get_Busy_Us(void);
+
+/**
+ * @brief 系统时钟改变后按新的 PCLK1 重新计算外设时序
+ * @details 更新 CR2 的 FREQ、TRISE 和 CCR，SCL 速率保持为当前设备的速率。对所有总线生效，只能在总线空闲时调用。
+ * @return 无
+ */
+void I2C_Bus_Clock_Changed(void);
+
+/**
+ * @brief 设置发往某个设备的事务使用的 SCL 速率
+ * @details 新速率从下一个发往该设备的事务开始生效。STM32F1 的 I2C 外设标称最高 400kHz，
+ *          更高的速率 (超频) 应先用 I2C_Bus_Calibrate 确认设备能可靠工作。
+ * @param[in] dev_addr 设备8位地址
+ * @param[in] hz 速率 (Hz)，0 表示恢复为 hi2c->Init.ClockSpeed
+ * @return HAL_StatusTypeDef 速率表已满返回 HAL_BUSY
+ */
+HAL_StatusTypeDef I2C_Bus_Set_Speed(uint16_t dev_addr, uint32_t hz);
+
+/**
+ * @brief 获取发往某个设备的事务使用的 SCL 速率
+ * @param[in] dev_addr 设备8位地址
+ * @return uint32_t 速率 (Hz)
+ */
+uint32_t I2C_Bus_Get_Speed(uint16_t dev_addr);
+
+/**
+ * @brief 校准某个设备的 SCL 速率 (阻塞)
+ * @details 从 max_hz 起每次降低 I2C_BUS_CAL_STEP_HZ，在每一档连续调用 verify I2C_BUS_CAL_TRIES 次，
+ *          找到第一个全部通过的档位后再降低 I2C_BUS_CAL_MARGIN 档作为该设备的速率；
+ *          没有档位通过时使用 min_hz。不可在中断中调用，其他设备的事务照常执行。
+ * @param[in] dev_addr 设备8位地址
+ * @param[in] min_hz 最低速率，也是校准失败时的结果 (Hz)
+ * @param[in] max_hz 尝试的最高速率 (Hz)
+ * @param[in] verify 验证函数
+ * @param[in] ctx 验证函数的上下文
+ * @return uint32_t 最终使用的速率 (Hz)
+ */
+uint32_t I2C_Bus_Calibrate(uint16_t dev_addr, uint32_t min_hz, uint32_t max_hz, I2C_Bus_Verify_t verify, void *ctx);
+
+/**
+ * @brief 掉电前的紧急写入 (阻塞，可在中断中调用)
+ * @details 接管目标设备所在的总线：中止正在进行的事务 (被中止的事务不再回调)，复位外设后以寄存器轮询
+ *          完成一次写入，设备处于写周期 (NACK) 时重试直到 timeout_us。计时使用 DWT 周期计数器，
+ *          不依赖 SysTick。调用后该总线停止调度，之后提交的事务留在队列中，直到系统复位。
+ * @param[in] dev_addr 设备8位地址
+ * @param[in] mem_addr 存储地址
+ * @param[in] mem_addr_size 存储地址长度 (I2C_MEMADD_SIZE_8BIT 或 I2C_MEMADD_SIZE_16BIT)
+ * @param[in] data 数据
+ * @param[in] size 数据长度
+ * @param[in] timeout_us 包括 ACK 轮询在内的总时间上限 (us)
+ * @return HAL_StatusTypeDef 设备始终未应答返回 HAL_ERROR，超时返回 HAL_TIMEOUT
+ */
+HAL_StatusTypeDef I2C_Bus_Emergency_Write(uint16_t dev_addr, uint16_t mem_addr, uint16_t mem_addr_size,
+                                          const uint8_t *data, uint16_t size, uint32_t timeout_us);
+
+/**
+ * @brief 运行时切换显示器写事务的发送路径
+ * @details 从下一个启动的事务开始生效，供基准测试比较两条路径；I2C_BUS_FAST_TX 为 0 时没有作用。
+ * @param[in] enable true 走寄存器级路径 (默认)，false 走 HAL 的 DMA 传输
+ * @return 无
+ */
+void I2C_Bus_Set_Fast(bool enable);
+
+/**
+ * @brief I2C 事件中断的寄存器级处理
+ * @details 在 I2Cx_EV_IRQHandler 中先于 HAL_I2C_EV_IRQHandler 调用。
+ * @param[in] hi2c 产生中断的外设的HAL句柄
+ * @return bool 当前事务走寄存器级路径、中断已处理时返回 true (不再调用HAL)
+ */
+bool I2C_Bus_EV_IRQHandler(I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief I2C 错误中断的寄存器级处理
+ * @details 在 I2Cx_ER_IRQHandler 中先于 HAL_I2C_ER_IRQHandler 调用。
+ * @param[in] hi2c 产生中断的外设的HAL句柄
+ * @return bool 当前事务走寄存器级路径、中断已处理时返回 true
+ */
+bool I2C_Bus_ER_IRQHandler(I2C_HandleTypeDef *hi2c);
+
+/** @} */
+
+#endif /* __I2C_BUS_H */
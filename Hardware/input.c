@@ -4,45 +4,135 @@
  * @details   本文件实现了输入事件的生成、排队和提取。
  *            它使用一个定时器中断来定期扫描按键状态和编码器计数，
  *            并将检测到的变化作为事件推入一个FIFO循环队列。
+ *            扫描定时器只在有输入时运行：按键 (下降沿) 和编码器两相 (双边沿) 的 EXTI
+ *            启动定时器，按键状态机全部回到空闲、编码器静止 INPUT_SCAN_IDLE_MS 后停止。
+ *            队列为单生产者 (TIM2 中断) / 单消费者 (主循环) 的无锁环形缓冲区，
+ *            读写指针自由递增、各自只由一方修改，因此无需关中断。
+ *            队列中最多只有一个未被取走的编码器事件，之后的旋转量先在中断中累加，
+ *            等该事件被取走后再作为一个事件发布，快速旋转不会占满队列，也不会丢格。
+ *            入队的事件可由 input_replay 录制；回放期间队列中的实际输入被丢弃，
+ *            取事件、计数、清空和空闲查询都改为针对到期的回放事件。
+ *            按键的消抖按位并行：每次扫描读一次端口 IDR，每个按键在两个计数字 (垂直计数器) 中各占一位，
+ *            与消抖后状态不同的位加一、相同的位清零，计数到 INPUT_KEY_DEBOUNCE 的位翻转状态，
+ *            翻转的位与新状态相与/相与非即得到按下和松开的位掩码。按键都空闲时扫描只有十几条位运算，
+ *            只有发生翻转或正被按住的按键才进入各自的长按/双击状态机。
+ *            编码器的两路输入使用 TIM3 的数字滤波去掉毛刺；扫描中断把 16 位计数的差值累加为 32 位的计数，
+ *            再按 INPUT_ENC_DETENT 量化为格数，事件和 encoder_get_position() 都以格为单位。
+ *            INPUT_SCAN_DMA 为 1 时 TIM2 只发出 DMA 请求 (UDE)，DMA1 通道2 以循环模式把 IDR 的低16位写入
+ *            INPUT_SCAN_DMA_DEPTH 个采样的缓冲区。半满/全满中断和主循环的 input_service() 从上次处理到的位置起
+ *            依次消抖 (时间戳按采样的先后从当前时刻倒推)，垂直计数器看到的采样序列与逐次中断时相同；
+ *            编码器计数在每次处理时读取一次。两处调用都在输入一级 (主循环中以 BASEPRI 屏蔽到这一级)，
+ *            与 EXTI 不会互相打断。
  * @author    SandOcean
- * @date      2025-08-26
- * @version   1.0
+ * @date      2025-10-08
+ * @version   1.4
  * @copyright Copyright (c) 2025 SandOcean
  */
 
 #include "input.h"
+#include "input_replay.h"
+#include "profiler.h"
+#include "trace.h"
+#include "mark.h"
+#include <stdbool.h>
+#if INPUT_SCAN_DMA
+#include "audio.h"
+#endif
 
 /**
  * @addtogroup Input_Driver
  * @{
  */
 
+#if (INPUT_FIFO_SIZE & (INPUT_FIFO_SIZE - 1)) != 0 || INPUT_FIFO_SIZE > 128
+#error "INPUT_FIFO_SIZE must be a power of two no larger than 128"
+#endif
+
+#define INPUT_FIFO_MASK (INPUT_FIFO_SIZE - 1) ///< 自由递增的指针对队列长度取模
+
+#if INPUT_KEY_DEBOUNCE < 1 || INPUT_KEY_DEBOUNCE > 3
+#error "INPUT_KEY_DEBOUNCE must be 1..3 (two-bit vertical counter)"
+#endif
+
+#define INPUT_KEY_MASK (KEY_BCK_Pin | KEY_CON_Pin | KEY_EN_Pin) ///< INPUT_KEY_PORT 上所有按键的引脚
+
+#if INPUT_SCAN_DMA
+#if AUDIO_ENABLE
+#error "AUDIO_ENABLE and INPUT_SCAN_DMA both use DMA1 channel 2"
+#endif
+#if (INPUT_SCAN_DMA_DEPTH & 1) != 0 || INPUT_SCAN_DMA_DEPTH < 2 || INPUT_SCAN_DMA_DEPTH > 128
+#error "INPUT_SCAN_DMA_DEPTH must be an even number in 2..128"
+#endif
+#define INPUT_SCAN_DMA_CH DMA1_Channel2 ///< TIM2_UP 的 DMA 请求所在的通道
+#endif
+
+/**
+ * @brief 垂直计数器中计数等于 INPUT_KEY_DEBOUNCE 的位
+ * @param c0 计数的低位字
+ * @param c1 计数的高位字
+ */
+#define KEY_COUNT_HIT(c0, c1) (((INPUT_KEY_DEBOUNCE & 1) ? (c0) : (uint16_t)~(c0)) & \
+                               ((INPUT_KEY_DEBOUNCE & 2) ? (c1) : (uint16_t)~(c1)))
+
 /* Private variables ---------------------------------------------------------*/
 static Input_Event_Data_t input_event_fifo[INPUT_FIFO_SIZE]; ///< 输入事件的FIFO循环队列
-static uint8_t fifo_head = 0;      ///< FIFO队列的写指针
-static uint8_t fifo_tail = 0;      ///< FIFO队列的读指针
-static uint8_t fifo_count = 0;     ///< FIFO队列中当前的事件数量
+static volatile uint8_t fifo_head = 0; ///< FIFO队列的写指针 (自由递增，只由中断修改)
+static volatile uint8_t fifo_tail = 0; ///< FIFO队列的读指针 (自由递增，只由主循环修改)
 
 static TIM_HandleTypeDef *g_htim_encoder = NULL; ///< 用于编码器的定时器句柄
 static TIM_HandleTypeDef *g_htim_scan = NULL;    ///< 用于按键扫描的定时器句柄
 
 static volatile int32_t last_encoder_count = 0; ///< 上一次读取的编码器计数值
+static int32_t enc_count = 0;              ///< 扩展为 32 位的编码器计数 (只由中断修改)
+static volatile int32_t enc_position = 0;  ///< 量化后的绝对位置 (格，只由中断修改)
+
+static int16_t enc_pending = 0;            ///< 尚未发布的编码器增量 (只由中断修改)
+static int16_t enc_pending_accel = 0;      ///< 尚未发布的加速增量 (只由中断修改)
+static uint32_t enc_last_move = 0;         ///< 上一次检测到旋转的时间戳
+static volatile uint8_t enc_pushed = 0;    ///< 已入队的编码器事件数 (只由中断修改)
+static volatile uint8_t enc_popped = 0;    ///< 已取走的编码器事件数 (只由主循环修改)
 
 static uint32_t system_tick = 0; ///< 由 `input_tick` 更新的系统时间戳，用于事件时间戳记录
+static volatile bool scan_running = false; ///< 扫描定时器是否在运行
+static volatile uint32_t event_count[INPUT_EVENT_COUNT]; ///< 启动以来各类事件的入队次数 (只由中断修改)
+#if INPUT_SCAN_DMA
+static uint16_t scan_buf[INPUT_SCAN_DMA_DEPTH]; ///< DMA 写入的按键端口采样 (IDR 的低16位)
+static uint8_t scan_read = 0;                   ///< 下一个待处理的采样
+#endif
 
-static Key_t Key_Back = {INPUT_STATE_IDLE, 0, KEY_BCK_GPIO_Port, KEY_BCK_Pin};     ///< 返回键对象实例
-static Key_t Key_Confirm = {INPUT_STATE_IDLE, 0, KEY_CON_GPIO_Port, KEY_CON_Pin}; ///< 确认键对象实例
-static Key_t Key_Encoder = {INPUT_STATE_IDLE, 0, KEY_EN_GPIO_Port, KEY_EN_Pin};   ///< 编码器按键对象实例
+/**
+ * @brief 按键对象实例，同一次扫描中的事件按此顺序入队
+ * @details 所有按键须在 INPUT_KEY_PORT 上。目前没有页面读取连发事件 (数值由编码器调节)，各按键都不连发。
+ */
+static Key_t keys[] = {
+    {INPUT_STATE_IDLE, INPUT_EVENT_BACK_PRESSED, KEY_BCK_Pin, false},    // 返回键
+    {INPUT_STATE_IDLE, INPUT_EVENT_COMFIRM_PRESSED, KEY_CON_Pin, false}, // 确认键
+    {INPUT_STATE_IDLE, INPUT_EVENT_ENCODER_PRESSED, KEY_EN_Pin, false},  // 编码器按键
+};
+
+static uint16_t key_down = 0; ///< 消抖后处于按下状态的引脚
+static uint16_t key_ct0 = 0;  ///< 垂直计数器的低位：每位为对应引脚与 key_down 连续不同的扫描次数
+static uint16_t key_ct1 = 0;  ///< 垂直计数器的高位
 
 
 /* Private function prototypes -----------------------------------------------*/
-static uint8_t fifo_push_event(Input_Event_t event, int16_t value);
+static uint8_t fifo_push_event(Input_Event_t event, int16_t value, int16_t accel_value);
+static int16_t Encoder_Accel(int16_t delta, uint32_t now);
+static int32_t Encoder_Quantize(int32_t count);
+static void Encoder_Flush(bool force);
 static uint8_t fifo_pop_event(Input_Event_Data_t *event);
 static void input_tick(void);
 static void Encoder_Reset(void);
 static void Encoder_Update(void);
-static void Key_Update(Key_t *key, Input_Event_t press_event);
-static void Keys_Update(void);
+static void Key_Update(Key_t *key, bool changed);
+static void Keys_Update(uint16_t idr);
+static bool Keys_Idle(void);
+static void Scan_Start(void);
+static void Scan_Stop_If_Idle(void);
+#if INPUT_SCAN_DMA
+static void Scan_Drain(void);
+#endif
+static void Encoder_Exti_Init(void);
 
 /* Private Function implementations ------------------------------------------*/
 
@@ -50,27 +140,32 @@ static void Keys_Update(void);
  * @brief 将一个新事件推入FIFO队列
  * @param[in] event 事件类型
  * @param[in] value 事件相关的值
+ * @param[in] accel_value 加速后的值 (仅编码器事件使用)
  * @return uint8_t
  *      - @retval 1 成功推入。
  *      - @retval 0 队列已满。
  */
-static uint8_t fifo_push_event(Input_Event_t event, int16_t value)
+static uint8_t fifo_push_event(Input_Event_t event, int16_t value, int16_t accel_value)
 {
-    if (fifo_count >= INPUT_FIFO_SIZE) {
+    uint8_t head = fifo_head;
+
+    if ((uint8_t)(head - fifo_tail) >= INPUT_FIFO_SIZE) {
+        PROF_COUNT(PROF_CNT_INPUT_DROP);
         return 0; // FIFO满
     }
-    
-    __disable_irq();
-
-    input_event_fifo[fifo_head].event = event;
-    input_event_fifo[fifo_head].value = value;
-    input_event_fifo[fifo_head].timestamp = system_tick;
-    
-    fifo_head = (fifo_head + 1) % INPUT_FIFO_SIZE;
-    fifo_count++;
-    
-    __enable_irq();
-    
+
+    Input_Event_Data_t *slot = &input_event_fifo[head & INPUT_FIFO_MASK];
+    slot->event = event;
+    slot->value = value;
+    slot->accel_value = accel_value;
+    slot->timestamp = system_tick;
+
+    __DMB(); // 先写完元素，再发布写指针
+    fifo_head = head + 1;
+    event_count[event]++;
+    Input_Replay_On_Push(slot);
+    input_event_callback();
+
     return 1;
 }
 
@@ -83,17 +178,22 @@ static uint8_t fifo_push_event(Input_Event_t event, int16_t value)
  */
 static uint8_t fifo_pop_event(Input_Event_Data_t *event)
 {
-    if (fifo_count == 0) {
+    uint8_t tail = fifo_tail;
+
+    if (tail == fifo_head) {
         return 0; // FIFO空
     }
-    
-    __disable_irq();
-
-    *event = input_event_fifo[fifo_tail];
-    fifo_tail = (fifo_tail + 1) % INPUT_FIFO_SIZE;
-    fifo_count--;
-    
-    __enable_irq();
+
+    __DMB(); // 读到写指针之后再读取元素
+    *event = input_event_fifo[tail & INPUT_FIFO_MASK];
+
+    __DMB(); // 元素拷贝完成后才释放槽位
+    fifo_tail = tail + 1;
+
+    if (event->event == INPUT_EVENT_ENCODER) {
+        enc_popped++; // 允许中断发布下一个合并后的编码器事件
+    }
+
     return 1;
 }
 
@@ -117,11 +217,75 @@ static void Encoder_Reset(void)
         __HAL_TIM_SET_COUNTER(g_htim_encoder, 0);
     }
     last_encoder_count = 0;
+    enc_count = 0;
+    enc_position = 0;
+}
+
+/**
+ * @brief 把 32 位计数量化为格数
+ * @details 四舍五入到最近的定位点 (向下取整的除法，负数同样成立)，计数在两格的中点附近才会改变结果。
+ * @param[in] count 32 位计数
+ * @return int32_t 格数
+ */
+static int32_t Encoder_Quantize(int32_t count)
+{
+#if INPUT_ENC_DETENT > 1
+    int32_t shifted = count + INPUT_ENC_DETENT / 2;
+
+    return (shifted >= 0) ? shifted / INPUT_ENC_DETENT : -((INPUT_ENC_DETENT - 1 - shifted) / INPUT_ENC_DETENT);
+#else
+    return count;
+#endif
+}
+
+/**
+ * @brief 根据旋转速度计算加速后的增量
+ * @details 用本次扫描的时间差除以格数得到每格的平均间隔，间隔越短倍率越高。
+ * @param[in] delta 本次扫描检测到的格数
+ * @param[in] now 当前时间戳
+ * @return int16_t 加速后的增量
+ */
+static int16_t Encoder_Accel(int16_t delta, uint32_t now)
+{
+    uint16_t steps = (uint16_t)(delta < 0 ? -delta : delta);
+    uint32_t interval = (now - enc_last_move) / steps;
+    int16_t mult = 1;
+
+    if (interval < INPUT_ENC_ACCEL_X8_MS) {
+        mult = 8;
+    } else if (interval < INPUT_ENC_ACCEL_X4_MS) {
+        mult = 4;
+    } else if (interval < INPUT_ENC_ACCEL_X2_MS) {
+        mult = 2;
+    }
+    return delta * mult;
+}
+
+/**
+ * @brief 发布累加的编码器增量
+ * @param[in] force 为 true 时即使队列中已有编码器事件也单独入队 (用于保证与按键事件的先后顺序)
+ * @return 无
+ */
+static void Encoder_Flush(bool force)
+{
+    if (enc_pending == 0) {
+        return;
+    }
+    if (!force && enc_pushed != enc_popped) {
+        return; // 上一个编码器事件还没被取走，继续累加
+    }
+    if (fifo_push_event(INPUT_EVENT_ENCODER, enc_pending, enc_pending_accel)) {
+        enc_pushed++;
+        enc_pending = 0;
+        enc_pending_accel = 0;
+    }
+    // 队列已满时保留累加值，下次扫描再试
 }
 
 /**
  * @brief 检查并更新编码器状态
- * @details 检测编码器定时器计数值的变化，并将变化量作为 `INPUT_EVENT_ENCODER` 事件推入队列。
+ * @details 检测编码器定时器计数值的变化 (两次扫描之间不超过 32767 个计数)，扩展为 32 位并量化为格数，
+ *          格数的变化累加到待发布的增量中，队列中没有未取走的编码器事件时作为一个 `INPUT_EVENT_ENCODER` 事件推入队列。
  * @return 无
  */
 static void Encoder_Update(void) 
@@ -129,71 +293,201 @@ static void Encoder_Update(void)
     if (!g_htim_encoder) return;
 
     uint16_t current_count = __HAL_TIM_GET_COUNTER(g_htim_encoder); 
-    int16_t delta = (int16_t)(current_count - (uint16_t)last_encoder_count);
+    int16_t counts = (int16_t)(current_count - (uint16_t)last_encoder_count);
+    int32_t position;
+    int16_t delta;
+
+    enc_count += counts;
+    last_encoder_count = current_count;
+    position = Encoder_Quantize(enc_count);
+    delta = (int16_t)(position - enc_position);
+    enc_position = position;
 
     if (delta != 0) {
-        fifo_push_event(INPUT_EVENT_ENCODER, delta);
-        last_encoder_count = current_count;
+        int32_t raw = (int32_t)enc_pending + delta;
+        int32_t accel = (int32_t)enc_pending_accel + Encoder_Accel(delta, system_tick);
+
+        // 限幅，防止长时间无人取走时溢出
+        enc_pending = (int16_t)((raw > INT16_MAX) ? INT16_MAX : (raw < INT16_MIN) ? INT16_MIN : raw);
+        enc_pending_accel = (int16_t)((accel > INT16_MAX) ? INT16_MAX : (accel < INT16_MIN) ? INT16_MIN : accel);
+        enc_last_move = system_tick;
     }
+
+    Encoder_Flush(false);
 }
 
 /**
  * @brief 更新单个按键的状态机
- * @details 实现了一个包含“空闲->消抖->按下”的状态机来处理按键输入。
- *          当按键被确认为按下时，将相应的事件推入队列。
- * @param[in] key 指向要更新的按键对象
- * @param[in] press_event 该按键按下时对应的事件类型
+ * @details 消抖后的按下产生按下事件；按下状态下跟踪按住时长：超过 INPUT_LONG_PRESS_MS 产生一次 LONG_PRESS，
+ *          选择了连发的按键之后每 INPUT_REPEAT_INTERVAL_MS 产生一次 REPEAT (其余按键不产生，避免无人读取的事件占满FIFO)；
+ *          单击松开后 INPUT_DOUBLE_CLICK_MS 内再次按下，在按下事件之后追加 DOUBLE_CLICK。
+ * @param[in,out] key 指向要更新的按键对象
+ * @param[in] changed 本次扫描该按键的消抖状态是否翻转
+ * @return 无
+ */
+static void Key_Update(Key_t *key, bool changed)
+{
+    Input_Event_t press_event = key->press_event;
+
+    if (changed && key->state == INPUT_STATE_IDLE) { // 按键按下
+        key->state = INPUT_STATE_PRESSED;
+        key->next_repeat = system_tick + INPUT_LONG_PRESS_MS;
+        key->long_pressed = false;
+        Encoder_Flush(true); // 按键之前的旋转必须先于按键被处理
+        fifo_push_event(press_event, 0, 0);
+
+        if (key->click_armed && system_tick - key->release_time <= INPUT_DOUBLE_CLICK_MS) {
+            key->click_armed = false; // 第三次按下重新开始计数
+            fifo_push_event(INPUT_EVENT_DOUBLE_CLICK, press_event, 0);
+        } else {
+            key->click_armed = true;
+        }
+    } else if (changed) { // 按键弹起
+        key->state = INPUT_STATE_IDLE;
+        key->release_time = system_tick;
+        if (key->long_pressed) {
+            key->click_armed = false; // 长按不参与双击判定
+        }
+    } else if (key->state == INPUT_STATE_PRESSED && (!key->long_pressed || key->repeat) &&
+               (int32_t)(system_tick - key->next_repeat) >= 0) {
+        fifo_push_event(key->long_pressed ? INPUT_EVENT_REPEAT : INPUT_EVENT_LONG_PRESS, press_event, 0);
+        key->long_pressed = true;
+        key->next_repeat = system_tick + INPUT_REPEAT_INTERVAL_MS;
+    }
+}
+
+/**
+ * @brief 用一次端口采样并行消抖所有按键
+ * @details 与 key_down 不同的位计数加一 (两位计数器的逐位加法：ct0 取反，ct1 异或 ct0)，相同的位清零；
+ *          计数到 INPUT_KEY_DEBOUNCE 的位翻转 key_down 并清零计数。
+ *          只有翻转的按键和正被按住的按键 (长按、连发计时) 调用 `Key_Update`。
+ * @param[in] idr INPUT_KEY_PORT 的 IDR
+ * @return 无
+ */
+static void Keys_Update(uint16_t idr)
+{
+    uint16_t raw = (uint16_t)~idr & INPUT_KEY_MASK; // 按键低电平有效
+    uint16_t diff = raw ^ key_down;
+    uint16_t ct0 = (uint16_t)~key_ct0 & diff;
+    uint16_t ct1 = (uint16_t)(key_ct1 ^ key_ct0) & diff;
+    uint16_t toggled = KEY_COUNT_HIT(ct0, ct1) & diff;
+
+    key_ct0 = ct0 & (uint16_t)~toggled;
+    key_ct1 = ct1 & (uint16_t)~toggled;
+    key_down ^= toggled;
+
+    if ((toggled | key_down) == 0) {
+        return;
+    }
+    for (uint8_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+        if ((toggled | key_down) & keys[i].pin) {
+            Key_Update(&keys[i], (toggled & keys[i].pin) != 0);
+        }
+    }
+}
+
+/**
+ * @brief 判断所有按键是否都已松开且没有正在消抖的按键
+ * @return bool 全部空闲返回 true
+ */
+static bool Keys_Idle(void)
+{
+    return (key_down | key_ct0 | key_ct1) == 0;
+}
+
+/**
+ * @brief 启动扫描定时器 (已在运行时不做任何事)
+ * @note 只在中断上下文或初始化时调用，所有相关中断优先级相同，不会互相抢占。
+ * @return 无
+ */
+static void Scan_Start(void)
+{
+    if (scan_running || !g_htim_scan) {
+        return;
+    }
+    scan_running = true;
+    __HAL_TIM_SET_COUNTER(g_htim_scan, 0);
+#if INPUT_SCAN_DMA
+    // 每次启动从缓冲区开头写起，外设为 32 位读取、存储器为 16 位写入 (截取低半字)
+    scan_read = 0;
+    INPUT_SCAN_DMA_CH->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF2;
+    INPUT_SCAN_DMA_CH->CNDTR = INPUT_SCAN_DMA_DEPTH;
+    INPUT_SCAN_DMA_CH->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_PSIZE_1 | DMA_CCR_MSIZE_0 |
+                             DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_EN;
+    __HAL_TIM_ENABLE_DMA(g_htim_scan, TIM_DMA_UPDATE);
+    HAL_TIM_Base_Start(g_htim_scan);
+#else
+    HAL_TIM_Base_Start_IT(g_htim_scan);
+#endif
+}
+
+/**
+ * @brief 无人操作时停止扫描，等待下一个 EXTI 边沿
+ * @return 无
+ */
+static void Scan_Stop_If_Idle(void)
+{
+    if (!Keys_Idle() || enc_pending != 0 || system_tick - enc_last_move < INPUT_SCAN_IDLE_MS) {
+        return;
+    }
+#if INPUT_SCAN_DMA
+    HAL_TIM_Base_Stop(g_htim_scan);
+    __HAL_TIM_DISABLE_DMA(g_htim_scan, TIM_DMA_UPDATE);
+    INPUT_SCAN_DMA_CH->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF2;
+#else
+    HAL_TIM_Base_Stop_IT(g_htim_scan);
+#endif
+    scan_running = false;
+}
+
+#if INPUT_SCAN_DMA
+/**
+ * @brief 处理 DMA 写入的全部新采样并读取编码器计数
+ * @details 写入位置由 CNDTR 得出，落后整整一个缓冲区 (处理被推迟了 INPUT_SCAN_DMA_DEPTH 个周期) 时
+ *          无法与没有新采样区分，这些采样被跳过；半满中断保证正常情况下最多落后半个缓冲区。
+ *          在输入一级的中断中或屏蔽到这一级后调用。
  * @return 无
  */
-static void Key_Update(Key_t *key, Input_Event_t press_event)
+static void Scan_Drain(void)
 {
-    GPIO_PinState pin_state = HAL_GPIO_ReadPin(key->port, key->pin);
-    
-    switch (key->state) {
-        case INPUT_STATE_IDLE:
-            if (pin_state == GPIO_PIN_RESET) { // 按键按下
-                key->state = INPUT_STATE_DEBOUNCE;
-                key->debounce_count = 1;
-            }
-            break;
-        
-        case INPUT_STATE_DEBOUNCE:
-            if (pin_state == GPIO_PIN_RESET) {
-                key->debounce_count++;
-                if (key->debounce_count >= INPUT_KEY_DEBOUNCE) {
-                    key->state = INPUT_STATE_PRESSED;
-                    fifo_push_event(press_event, 0);
-                }
-            } else {
-                key->state = INPUT_STATE_IDLE;
-                key->debounce_count = 0;
-            }
-            break;
-        
-        case INPUT_STATE_PRESSED:
-            if (pin_state == GPIO_PIN_SET) { // 按键弹起
-                key->state = INPUT_STATE_IDLE;
-                key->debounce_count = 0;
-            }
-            break;
-        
-        default:
-            key->state = INPUT_STATE_IDLE;
-            key->debounce_count = 0;
-            break;
+    uint8_t write;
+    uint8_t n;
+    uint32_t now;
+
+    if (!scan_running) {
+        return;
     }
+    write = (uint8_t)((INPUT_SCAN_DMA_DEPTH - INPUT_SCAN_DMA_CH->CNDTR) % INPUT_SCAN_DMA_DEPTH);
+    n = (uint8_t)((write + INPUT_SCAN_DMA_DEPTH - scan_read) % INPUT_SCAN_DMA_DEPTH);
+    now = HAL_GetTick();
+
+    for (; n > 0; n--) {
+        system_tick = now - (uint32_t)(n - 1U) * INPUT_SCAN_PERIOD_MS; // 之后还有 n - 1 个采样
+        Keys_Update(scan_buf[scan_read]);
+        scan_read = (uint8_t)((scan_read + 1U) % INPUT_SCAN_DMA_DEPTH);
+    }
+    system_tick = now;
+    Encoder_Update();
+    Scan_Stop_If_Idle();
 }
+#endif
 
 /**
- * @brief 更新所有已定义的按键状态
- * @details 轮询调用 `Key_Update` 来处理所有按键。
+ * @brief 将编码器两相引脚配置为双边沿 EXTI
+ * @details F1 的定时器输入通道只要求引脚为输入模式，与 EXTI 可以同时工作，
+ *          上下拉保持与 TIM3 MSP 中的配置一致。
  * @return 无
  */
-static void Keys_Update(void)
+static void Encoder_Exti_Init(void)
 {
-    Key_Update(&Key_Back, INPUT_EVENT_BACK_PRESSED);
-    Key_Update(&Key_Confirm, INPUT_EVENT_COMFIRM_PRESSED);
-    Key_Update(&Key_Encoder, INPUT_EVENT_ENCODER_PRESSED);
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    GPIO_InitStruct.Pin = EA_Pin | EB_Pin;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
+    GPIO_InitStruct.Pull = GPIO_PULLDOWN;
+    HAL_GPIO_Init(EA_GPIO_Port, &GPIO_InitStruct);
 }
 
 /* Public Function implementations -------------------------------------------*/
@@ -209,9 +503,60 @@ void input_scan_timer_irq_handler(TIM_HandleTypeDef *htim)
 {
     if (htim == g_htim_scan)
     {
+        MARK_BEGIN(ISR);
+        TRACE(TRACE_EV_INPUT_SCAN, enc_pending);
         input_tick();
-        Keys_Update();
+        Keys_Update((uint16_t)INPUT_KEY_PORT->IDR);
         Encoder_Update();
+        Scan_Stop_If_Idle();
+        MARK_END(ISR);
+    }
+}
+
+#if INPUT_SCAN_DMA
+/**
+ * @brief 按键采样 DMA 的半满/全满中断
+ * @details 启动文件中的弱定义由本函数覆盖 (AUDIO_ENABLE 为 0 时 audio.c 不定义它)。
+ * @return 无
+ */
+void DMA1_Channel2_IRQHandler(void)
+{
+    MARK_BEGIN(ISR);
+    DMA1->IFCR = DMA_IFCR_CGIF2;
+    TRACE(TRACE_EV_INPUT_SCAN, enc_pending);
+    Scan_Drain();
+    MARK_END(ISR);
+}
+#endif
+
+/**
+ * @brief 在主循环中处理 DMA 写入的按键采样
+ * @return 无
+ */
+void input_service(void)
+{
+#if INPUT_SCAN_DMA
+    uint32_t basepri = __get_BASEPRI();
+
+    __set_BASEPRI_MAX(IRQ_PRIO_INPUT << (8U - __NVIC_PRIO_BITS)); // 与 EXTI 和 DMA 中断互斥
+    Scan_Drain();
+    __set_BASEPRI(basepri);
+#endif
+}
+
+/**
+ * @brief 按键/编码器引脚的 EXTI 处理函数
+ * @param[in] GPIO_Pin 触发中断的引脚
+ * @return 无
+ */
+void input_exti_irq_handler(uint16_t GPIO_Pin)
+{
+    if (GPIO_Pin & (KEY_BCK_Pin | KEY_CON_Pin | KEY_EN_Pin | EA_Pin | EB_Pin)) {
+        if (!scan_running) {
+            input_tick();
+            enc_last_move = system_tick; // 编码器边沿也算作一次活动，避免刚启动就停止
+        }
+        Scan_Start();
     }
 }
 
@@ -228,22 +573,36 @@ void input_init(TIM_HandleTypeDef *htim_encoder, TIM_HandleTypeDef *htim_scan)
     g_htim_encoder = htim_encoder;
     g_htim_scan = htim_scan;
 
-    // 初始化FIFO
+    // 初始化FIFO (扫描定时器尚未启动，可以直接复位两个指针)
     memset(input_event_fifo, 0, sizeof(input_event_fifo));
     fifo_head = 0;
     fifo_tail = 0;
-    fifo_count = 0;
 
     input_tick();
 
+#if INPUT_SCAN_DMA
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    INPUT_SCAN_DMA_CH->CCR = 0;
+    INPUT_SCAN_DMA_CH->CPAR = (uint32_t)&INPUT_KEY_PORT->IDR;
+    INPUT_SCAN_DMA_CH->CMAR = (uint32_t)scan_buf;
+    HAL_NVIC_SetPriority(DMA1_Channel2_IRQn, IRQ_PRIO_INPUT, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+#endif
+
     if (g_htim_encoder) {
+        // 滤波的采样时钟 fDTS 取计数时钟的 1/4 (CKD)，与 ICxF 一起滤除宽度小于约 14us (72MHz) 的毛刺
+        MODIFY_REG(g_htim_encoder->Instance->CR1, TIM_CR1_CKD, TIM_CR1_CKD_1);
+        MODIFY_REG(g_htim_encoder->Instance->CCMR1, TIM_CCMR1_IC1F | TIM_CCMR1_IC2F,
+                   ((uint32_t)INPUT_ENC_FILTER << TIM_CCMR1_IC1F_Pos) | ((uint32_t)INPUT_ENC_FILTER << TIM_CCMR1_IC2F_Pos));
         HAL_TIM_Encoder_Start(g_htim_encoder, TIM_CHANNEL_ALL);
-    }
-    if (g_htim_scan) {
-        HAL_TIM_Base_Start_IT(g_htim_scan); 
+        Encoder_Exti_Init();
     }
 
     Encoder_Reset();
+
+    // 先扫描一段时间，处理上电时已经按下的按键；空闲后定时器自行停止
+    enc_last_move = system_tick;
+    Scan_Start();
 }
 
 /**
@@ -255,31 +614,117 @@ void input_init(TIM_HandleTypeDef *htim_encoder, TIM_HandleTypeDef *htim_scan)
  */
 uint8_t input_get_event(Input_Event_Data_t *event)
 {
+    if (Input_Replay_Mode() == INPUT_REPLAY_PLAYING) {
+        while (fifo_pop_event(event)) {
+            // 回放期间丢弃实际的输入，保证事件序列与录制时相同
+        }
+        return Input_Replay_Pop(event) ? 1 : 0;
+    }
     return fifo_pop_event(event);
 }
 
+/**
+ * @brief 获取编码器的绝对位置
+ * @return int32_t 启动以来累计的格数
+ */
+int32_t encoder_get_position(void)
+{
+    return enc_position; // 32 位的读取是原子的
+}
+
+/**
+ * @brief 获取编码器自上一次调用以来转过的格数
+ * @param[in,out] mark 使用者保存的上一次位置
+ * @return int32_t 转过的格数
+ */
+int32_t encoder_get_delta(int32_t *mark)
+{
+    int32_t position = enc_position;
+    int32_t delta = position - *mark;
+
+    *mark = position;
+    return delta;
+}
+
 /**
  * @brief 获取队列中当前未处理事件的数量
  * @return uint8_t - 返回队列中未处理事件的个数。
  */
 uint8_t input_count_events(void)
 {
-    return fifo_count;
+    if (Input_Replay_Mode() == INPUT_REPLAY_PLAYING) {
+        return Input_Replay_Due();
+    }
+    return (uint8_t)(fifo_head - fifo_tail);
+}
+
+/**
+ * @brief 获取启动以来某类事件的入队次数
+ * @param[in] event 事件类型
+ * @return uint32_t 入队次数，event 无效时为0
+ */
+uint32_t input_get_event_count(Input_Event_t event)
+{
+    if ((unsigned)event >= INPUT_EVENT_COUNT) {
+        return 0;
+    }
+    return event_count[event];
 }
 
 /**
  * @brief 清空输入事件队列
  * @details 在某些场景下（如从休眠唤醒时），可能需要丢弃旧的输入事件。
+ *          只由消费者调用：把读指针追到写指针即可，不触碰中断使用的写指针。
+ *          必须先移动读指针再同步编码器计数，否则中途入队的编码器事件会让合并永久停止。
  * @return 无
  */
 void input_clear_events(void)
 {
-    __disable_irq();
-    memset(input_event_fifo, 0, sizeof(input_event_fifo));
-    fifo_head = 0;
-    fifo_tail = 0;
-    fifo_count = 0;
-    __enable_irq();
+    Input_Event_Data_t skipped;
+
+    fifo_tail = fifo_head;
+    __DMB();
+    enc_popped = enc_pushed;
+
+    while (Input_Replay_Pop(&skipped)) {
+        // 到期的回放事件同样丢弃
+    }
+}
+
+/**
+ * @brief 查询输入模块是否完全空闲
+ * @return bool 扫描定时器已停止、队列为空且没有到期的回放事件时返回 true
+ */
+bool input_is_idle(void)
+{
+    return !scan_running && fifo_head == fifo_tail && Input_Replay_Due() == 0;
+}
+
+/**
+ * @brief 系统时钟改变后重新设置扫描定时器的预分频
+ * @details APB1 分频时定时器时钟为 PCLK1 的两倍，不分频时与 PCLK1 相同。
+ * @return 无
+ */
+void input_clock_changed(void)
+{
+    uint32_t timclk = HAL_RCC_GetPCLK1Freq();
+
+    if (!g_htim_scan) {
+        return;
+    }
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1) {
+        timclk *= 2U;
+    }
+    __HAL_TIM_SET_PRESCALER(g_htim_scan, timclk / 1000000U - 1U);
+}
+
+/**
+ * @brief 新事件入队的回调
+ * @details 默认为空实现，应用层可重新定义。
+ * @return 无
+ */
+__weak void input_event_callback(void)
+{
 }
 
 /**
@@ -4,7 +4,7 @@
  * @details   定义了输入事件、按键状态机、数据结构以及外部函数原型。
  * @author    SandOcean
  * @date      2025-08-26
- * @version   1.0
+ * @version   1.1
  * @copyright Copyright (c) 2025 SandOcean
  */
 
@@ -15,11 +15,15 @@
 #include "tim.h"
 #include "stdint.h"
 #include "string.h"
+#include <stdbool.h>
 
 /**
  * @defgroup Input_Driver 输入处理模块
  * @brief 提供了对旋钮编码器（带按键）的事件驱动式输入处理。
- *        通过定时器中断扫描硬件，并将输入动作转换为事件存入FIFO队列。
+ *        按键和编码器引脚的 EXTI 边沿启动扫描定时器，定时器中断完成消抖和计数，
+ *        并将输入动作转换为事件存入FIFO队列；无人操作时定时器停止。
+ *        INPUT_SCAN_DMA 为 1 时定时器不产生中断，每个更新事件由 DMA 把按键端口的 IDR 写入环形缓冲区，
+ *        采样在 DMA 半满/全满中断或主循环调用 input_service() 时成批消抖。
  * @{
  */
 
@@ -27,8 +31,27 @@
  * @defgroup Input_Config 输入模块配置
  * @{ 
  */
-#define INPUT_KEY_DEBOUNCE 2 ///< 按键消抖所需的连续扫描次数
-#define INPUT_FIFO_SIZE    16 ///< 输入事件FIFO队列的大小
+#define INPUT_KEY_DEBOUNCE 2 ///< 按键按下或松开需要连续保持的扫描次数 (1~3)
+#define INPUT_KEY_PORT     KEY_BCK_GPIO_Port ///< 所有按键所在的端口，每次扫描只读取一次它的 IDR
+#define INPUT_FIFO_SIZE    16 ///< 输入事件FIFO队列的大小 (必须为2的幂)
+
+#define INPUT_ENC_ACCEL_X2_MS 60 ///< 相邻两格的间隔小于该值时，加速值为 2 倍
+#define INPUT_ENC_ACCEL_X4_MS 30 ///< 相邻两格的间隔小于该值时，加速值为 4 倍
+#define INPUT_ENC_ACCEL_X8_MS 15 ///< 相邻两格的间隔小于该值时，加速值为 8 倍
+#define INPUT_ENC_DETENT      1  ///< 编码器每一格 (定位点) 的计数值，TIM3 按两相的全部边沿计数 (全周期一格的编码器为 4)
+#define INPUT_ENC_FILTER      0xF ///< TIM3 两路输入的数字滤波 (ICxF)，0xF 为 fDTS/32 采样连续 8 次相同，见 input_init
+
+#define INPUT_SCAN_IDLE_MS 100   ///< 所有按键松开且编码器静止超过该时间后停止扫描定时器
+#define INPUT_SCAN_PERIOD_MS 10  ///< 扫描周期，与 tim.c 中 TIM2 的更新周期一致
+
+#ifndef INPUT_SCAN_DMA
+#define INPUT_SCAN_DMA       0   ///< 为 1 时按键采样由 TIM2 更新事件触发 DMA1 通道2 完成 (与 AUDIO_ENABLE 共用通道2)
+#endif
+#define INPUT_SCAN_DMA_DEPTH 8   ///< DMA 采样缓冲区的深度 (偶数)，主循环睡眠时按键最迟在半个缓冲区 (40ms) 后处理
+
+#define INPUT_LONG_PRESS_MS      600 ///< 按住超过该时间产生一次长按事件
+#define INPUT_REPEAT_INTERVAL_MS 100 ///< 长按之后，每隔该时间产生一次连发事件 (只对 Key_t::repeat 为 true 的按键)
+#define INPUT_DOUBLE_CLICK_MS    300 ///< 松开后在该时间内再次按下视为双击
 /** @} */
 
 /**
@@ -40,23 +63,29 @@ typedef enum {
     INPUT_EVENT_COMFIRM_PRESSED,    ///< 确认键按下事件
     INPUT_EVENT_ENCODER_PRESSED,    ///< 编码器按键按下事件
     INPUT_EVENT_ENCODER,            ///< 编码器旋转事件，具体增量在value中
+    INPUT_EVENT_LONG_PRESS,         ///< 长按事件，value 为对应按键的按下事件类型 (如 INPUT_EVENT_BACK_PRESSED)
+    INPUT_EVENT_REPEAT,             ///< 长按后的连发事件，value 同上；只有在 input.c 的按键表中选择了连发的按键才产生
+    INPUT_EVENT_DOUBLE_CLICK,       ///< 双击事件 (在第二次按下事件之后产生)，value 同上
 } Input_Event_t;
 
+#define INPUT_EVENT_COUNT (INPUT_EVENT_DOUBLE_CLICK + 1) ///< 事件类型的个数 (含 INPUT_EVENT_NONE)
+
 /**
  * @brief 输入事件的数据结构，用于在FIFO中传递
  */
 typedef struct {
     Input_Event_t event;    ///< 事件类型, 来自 @ref Input_Event_t
     int16_t value;          ///< 事件相关的值 (例如编码器旋转的增量)
+    int16_t accel_value;    ///< 编码器事件按旋转速度加速后的增量，适合数值调节；列表选择应使用 value
     uint32_t timestamp;     ///< 事件发生时的时间戳 (ms)
 } Input_Event_Data_t;
 
 /**
  * @brief 按键状态机的状态定义
+ * @details 消抖由所有按键共用的垂直计数器完成，状态机只看到消抖后的按下和松开。
  */
 typedef enum {
     INPUT_STATE_IDLE = 0,   ///< 空闲状态，按键未按下
-    INPUT_STATE_DEBOUNCE,   ///< 消抖状态，检测到按键按下，正在确认中
     INPUT_STATE_PRESSED,    ///< 按下状态，已确认按键被按下
 } Key_State_t;
 
@@ -65,9 +94,13 @@ typedef enum {
  */
 typedef struct {
     Key_State_t state;          ///< 按键当前的状态机状态, 来自 @ref Key_State_t
-    uint8_t debounce_count;     ///< 用于消抖的计数器
-    GPIO_TypeDef* port;         ///< 按键连接的GPIO端口
-    uint16_t pin;               ///< 按键连接的GPIO引脚
+    Input_Event_t press_event;  ///< 按下时产生的事件类型
+    uint16_t pin;               ///< 按键在 INPUT_KEY_PORT 上的引脚
+    bool repeat;                ///< 长按之后是否产生连发事件，为 false 时只产生一次长按事件
+    uint32_t release_time;      ///< 上一次松开的时间戳，用于双击判定
+    uint32_t next_repeat;       ///< 下一次产生长按/连发事件的时间戳
+    bool long_pressed;          ///< 本次按下是否已经产生过长按事件
+    bool click_armed;           ///< 上一次是单击，下一次按下可能构成双击
 } Key_t;
 
 /**
@@ -99,12 +132,56 @@ uint8_t input_get_event(Input_Event_Data_t *event);
  */
 void input_scan_timer_irq_handler(TIM_HandleTypeDef *htim);
 
+/**
+ * @brief 按键/编码器引脚的 EXTI 处理函数
+ * @details 这个函数应该在全局的 HAL_GPIO_EXTI_Callback 中被调用。
+ *          扫描定时器未运行时启动它。
+ * @param[in] GPIO_Pin 触发中断的引脚
+ * @return 无
+ */
+void input_exti_irq_handler(uint16_t GPIO_Pin);
+
+/**
+ * @brief 在主循环中处理 DMA 写入的按键采样
+ * @details INPUT_SCAN_DMA 为 1 时，在每一轮主循环开始时调用，把上一次处理以来的采样逐个消抖并读取编码器计数，
+ *          主循环正在运行 (如动画期间) 时按键响应不必等到 DMA 半满中断。处理期间屏蔽输入一级及更低的中断。
+ *          INPUT_SCAN_DMA 为 0 时为空操作。
+ * @return 无
+ */
+void input_service(void);
+
+/**
+ * @brief 获取编码器的绝对位置
+ * @details TIM3 的 16 位计数在扫描中断中扩展为 32 位，并按 INPUT_ENC_DETENT 量化为格数 (四舍五入到最近的定位点，
+ *          停在定位点上时一两个计数的抖动不会改变位置)。位置只随实际旋转变化，不受事件是否被取走、是否在回放的影响。
+ *          编码器静止且扫描定时器停止后，位置在下一次旋转的第一次扫描时更新。
+ * @return int32_t 启动以来累计的格数 (顺时针为正)
+ */
+int32_t encoder_get_position(void);
+
+/**
+ * @brief 获取编码器自上一次调用以来转过的格数
+ * @details 适合每帧读取一次累计旋转量的控件：每个使用者保存自己的标记，互不影响。
+ *          第一次调用前将 *mark 设为 encoder_get_position() 的值。
+ * @param[in,out] mark 使用者保存的上一次位置，返回时更新为当前位置
+ * @return int32_t 两次调用之间转过的格数
+ */
+int32_t encoder_get_delta(int32_t *mark);
+
 /**
  * @brief 获取队列中当前未处理事件的数量
  * @return uint8_t - 返回队列中未处理事件的个数。
  */
 uint8_t input_count_events(void);
 
+/**
+ * @brief 获取启动以来某类事件的入队次数
+ * @details 只统计按键和编码器产生的事件 (回放的事件不计入)，队列已满而丢弃的事件也不计入。
+ * @param[in] event 事件类型
+ * @return uint32_t 入队次数，event 无效时为0
+ */
+uint32_t input_get_event_count(Input_Event_t event);
+
 /**
  * @brief 清空输入事件队列
  * @details 在某些场景下（如从休眠唤醒时），可能需要丢弃旧的输入事件。
@@ -112,6 +189,30 @@ uint8_t input_count_events(void);
  */
 void input_clear_events(void);
 
+/**
+ * @brief 查询输入模块是否完全空闲
+ * @details 扫描定时器已停止 (按键全部松开、编码器静止) 且队列为空。
+ *          此时只有 EXTI 边沿能产生新的输入，可以进入停止模式。
+ * @return bool 空闲返回 true
+ */
+bool input_is_idle(void);
+
+/**
+ * @brief 系统时钟改变后重新设置扫描定时器的预分频
+ * @details 扫描定时器 (APB1) 保持 1MHz 计数，扫描周期不随系统时钟变化。新的预分频在下一个更新事件起生效。
+ *          编码器输入滤波的采样频率随时钟变化 (8MHz 时滤除宽度约为 128us，72MHz 时约 14us)，不重新设置。
+ * @return 无
+ */
+void input_clock_changed(void);
+
+/**
+ * @brief 新事件入队的回调
+ * @details 在中断上下文中、事件已可被 input_get_event() 读到之后调用，用于唤醒处理输入的任务。
+ *          默认为空实现，应用层可重新定义 (见 app_main.c)。
+ * @return 无
+ */
+void input_event_callback(void);
+
 /**
  * @}
  */
@@ -0,0 +1,197 @@
+/**
+ * @file      input_replay.c
+ * @brief     输入事件录制与回放实现
+ * @details   录制在输入中断中进行 (单生产者)，事件先写入槽位再增加计数；开始和停止只在主循环中调用。
+ *            回放只在主循环中进行，到期时刻由开始回放的时刻逐个累加时间间隔得到，不会随主循环的快慢漂移。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "input_replay.h"
+
+/**
+ * @addtogroup Input_Replay
+ * @{
+ */
+
+/* Private variables ---------------------------------------------------------*/
+static Input_Replay_Rec_t rec_buf[INPUT_REPLAY_CAPACITY]; ///< 录制的事件
+static volatile uint8_t rec_count;                        ///< 已录制的事件数 (录制时只由中断修改)
+static volatile uint8_t replay_mode = INPUT_REPLAY_OFF;   ///< 当前状态 (Input_Replay_Mode_e)
+static uint32_t rec_last_ms;                              ///< 录制时上一个事件 (或开始录制) 的时间戳
+static uint8_t play_index;                                ///< 回放时下一个事件的序号
+static uint32_t play_due_ms;                              ///< 回放时下一个事件的到期时刻
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 清空录制内容并开始录制
+ * @return 无
+ */
+void Input_Replay_Record(void)
+{
+    replay_mode = INPUT_REPLAY_OFF;
+    rec_count = 0;
+    rec_last_ms = HAL_GetTick();
+    replay_mode = INPUT_REPLAY_RECORDING;
+}
+
+/**
+ * @brief 从头开始回放
+ * @return bool 没有录制内容时返回 false
+ */
+bool Input_Replay_Play(void)
+{
+    replay_mode = INPUT_REPLAY_OFF;
+    if (rec_count == 0) {
+        return false;
+    }
+    play_index = 0;
+    play_due_ms = HAL_GetTick() + rec_buf[0].dt_ms;
+    replay_mode = INPUT_REPLAY_PLAYING;
+    return true;
+}
+
+/**
+ * @brief 停止录制或回放
+ * @return 无
+ */
+void Input_Replay_Stop(void)
+{
+    replay_mode = INPUT_REPLAY_OFF;
+}
+
+/**
+ * @brief 查询当前状态
+ * @return Input_Replay_Mode_e 状态
+ */
+Input_Replay_Mode_e Input_Replay_Mode(void)
+{
+    return (Input_Replay_Mode_e)replay_mode;
+}
+
+/**
+ * @brief 查询已录制的事件数
+ * @return uint8_t 事件数
+ */
+uint8_t Input_Replay_Count(void)
+{
+    return rec_count;
+}
+
+/**
+ * @brief 读取一条录制的事件
+ * @param[in] index 序号
+ * @param[out] rec 事件
+ * @return bool 序号超出范围返回 false
+ */
+bool Input_Replay_Get(uint8_t index, Input_Replay_Rec_t *rec)
+{
+    if (index >= rec_count) {
+        return false;
+    }
+    *rec = rec_buf[index];
+    return true;
+}
+
+/**
+ * @brief 写入一条事件
+ * @param[in] index 序号
+ * @param[in] rec 事件
+ * @return bool 成功返回 true
+ */
+bool Input_Replay_Put(uint8_t index, const Input_Replay_Rec_t *rec)
+{
+    if (replay_mode != INPUT_REPLAY_OFF || index >= INPUT_REPLAY_CAPACITY) {
+        return false;
+    }
+    if (index == 0) {
+        rec_count = 0;
+    }
+    if (index != rec_count) {
+        return false;
+    }
+    rec_buf[index] = *rec;
+    rec_count = index + 1;
+    return true;
+}
+
+/**
+ * @brief 录制一个刚入队的事件
+ * @details 录满时停止录制，已录制的内容保留。
+ * @param[in] event 事件
+ * @return 无
+ */
+void Input_Replay_On_Push(const Input_Event_Data_t *event)
+{
+    uint8_t n = rec_count;
+    uint32_t dt;
+
+    if (replay_mode != INPUT_REPLAY_RECORDING) {
+        return;
+    }
+    dt = event->timestamp - rec_last_ms;
+    rec_last_ms = event->timestamp;
+
+    rec_buf[n].dt_ms = (dt > 0xFFFFU) ? 0xFFFFU : (uint16_t)dt;
+    rec_buf[n].event = (uint16_t)event->event;
+    rec_buf[n].value = event->value;
+    rec_buf[n].accel_value = event->accel_value;
+    rec_count = n + 1;
+    if (rec_count >= INPUT_REPLAY_CAPACITY) {
+        replay_mode = INPUT_REPLAY_OFF;
+    }
+}
+
+/**
+ * @brief 查询回放中已到期、尚未取走的事件数
+ * @return uint8_t 事件数
+ */
+uint8_t Input_Replay_Due(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t due = play_due_ms;
+    uint8_t n = 0;
+
+    if (replay_mode != INPUT_REPLAY_PLAYING) {
+        return 0;
+    }
+    for (uint8_t i = play_index; i < rec_count && (int32_t)(now - due) >= 0; i++) {
+        n++;
+        if (i + 1 < rec_count) {
+            due += rec_buf[i + 1].dt_ms;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief 取出下一个到期的回放事件
+ * @param[out] event 事件
+ * @return bool 没有到期的事件返回 false
+ */
+bool Input_Replay_Pop(Input_Event_Data_t *event)
+{
+    const Input_Replay_Rec_t *rec;
+
+    if (replay_mode != INPUT_REPLAY_PLAYING || (int32_t)(HAL_GetTick() - play_due_ms) < 0) {
+        return false;
+    }
+    rec = &rec_buf[play_index];
+    event->event = (Input_Event_t)rec->event;
+    event->value = rec->value;
+    event->accel_value = rec->accel_value;
+    event->timestamp = play_due_ms;
+
+    play_index++;
+    if (play_index >= rec_count) {
+        replay_mode = INPUT_REPLAY_OFF;
+    } else {
+        play_due_ms += rec_buf[play_index].dt_ms;
+    }
+    return true;
+}
+
+/** @} */
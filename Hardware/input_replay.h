@@ -0,0 +1,128 @@
+/**
+ * @file      input_replay.h
+ * @brief     输入事件录制与回放头文件
+ * @details   录制时把进入输入队列的每个事件 (按键状态机和编码器合并之后的结果) 连同时间间隔记入 RAM；
+ *            回放时按录制的时间间隔从 input_get_event() 交出这些事件，期间实际的按键和编码器输入被丢弃。
+ *            事件在主循环取事件的那一刻按时间戳判断是否到期，与中断的时机无关，
+ *            同一段录制在不同的固件版本上得到相同的事件序列，可以比较导航过程中的帧耗时和总线流量。
+ *            目标板上由远程控制命令开始/停止，录制内容可经串口读出保存，再写回任意固件回放；
+ *            主机仿真的 sim_input.c 使用同一个模块，基准测试程序可直接回放保存的文件。
+ *            文件和串口上的格式均为连续的 8 字节记录 (Input_Replay_Rec_t，小端)。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __INPUT_REPLAY_H
+#define __INPUT_REPLAY_H
+
+#include "input.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup Input_Replay 输入录制与回放
+ * @brief 在输入队列的入口录制事件，在出口按录制的时间回放。
+ * @{
+ */
+
+/**
+ * @defgroup Input_Replay_Config 输入录制与回放配置
+ * @{
+ */
+#define INPUT_REPLAY_CAPACITY 64 ///< 最多录制的事件数，录满后自动停止
+/** @} */
+
+/**
+ * @brief 录制与回放的状态
+ */
+typedef enum {
+    INPUT_REPLAY_OFF = 0,   ///< 空闲，输入照常
+    INPUT_REPLAY_RECORDING, ///< 正在录制
+    INPUT_REPLAY_PLAYING,   ///< 正在回放，实际输入被丢弃
+} Input_Replay_Mode_e;
+
+/**
+ * @brief 一条录制的事件 (8 字节)
+ */
+typedef struct {
+    uint16_t dt_ms;      ///< 距上一个事件 (第一个事件为距开始录制) 的时间，超过 65535ms 时按 65535ms 记录
+    uint16_t event;      ///< 事件类型 (Input_Event_t)
+    int16_t value;       ///< 事件值
+    int16_t accel_value; ///< 加速后的值
+} Input_Replay_Rec_t;
+
+/**
+ * @brief 清空录制内容并开始录制
+ * @return 无
+ */
+void Input_Replay_Record(void);
+
+/**
+ * @brief 从头开始回放
+ * @details 第一个事件在 dt_ms 之后到期。回放完最后一个事件后自动回到 INPUT_REPLAY_OFF。
+ * @return bool 没有录制内容时返回 false
+ */
+bool Input_Replay_Play(void);
+
+/**
+ * @brief 停止录制或回放
+ * @return 无
+ */
+void Input_Replay_Stop(void);
+
+/**
+ * @brief 查询当前状态
+ * @return Input_Replay_Mode_e 状态
+ */
+Input_Replay_Mode_e Input_Replay_Mode(void);
+
+/**
+ * @brief 查询已录制 (或已写入) 的事件数
+ * @return uint8_t 事件数
+ */
+uint8_t Input_Replay_Count(void);
+
+/**
+ * @brief 读取一条录制的事件
+ * @param[in] index 序号
+ * @param[out] rec 事件
+ * @return bool 序号超出范围返回 false
+ */
+bool Input_Replay_Get(uint8_t index, Input_Replay_Rec_t *rec);
+
+/**
+ * @brief 写入一条事件 (用于回放保存的录制)
+ * @details 只在空闲时可写。序号为 0 时先清空，否则必须等于当前的事件数 (按顺序追加)。
+ * @param[in] index 序号
+ * @param[in] rec 事件
+ * @return bool 正在录制或回放、序号不连续或已满时返回 false
+ */
+bool Input_Replay_Put(uint8_t index, const Input_Replay_Rec_t *rec);
+
+/**
+ * @brief 录制一个刚入队的事件，由输入驱动在事件入队时调用
+ * @note 可在中断中调用，不在录制时直接返回。
+ * @param[in] event 事件
+ * @return 无
+ */
+void Input_Replay_On_Push(const Input_Event_Data_t *event);
+
+/**
+ * @brief 查询回放中已到期、尚未取走的事件数，由输入驱动调用
+ * @return uint8_t 事件数，不在回放时为 0
+ */
+uint8_t Input_Replay_Due(void);
+
+/**
+ * @brief 取出下一个到期的回放事件，由输入驱动的 input_get_event() 调用
+ * @details 事件的时间戳为它按录制应到期的时刻，而不是被取走的时刻。
+ * @param[out] event 事件
+ * @return bool 没有到期的事件返回 false
+ */
+bool Input_Replay_Pop(Input_Event_Data_t *event);
+
+/** @} */
+
+#endif /* __INPUT_REPLAY_H */
@@ -0,0 +1,317 @@
+/**
+ * @file      light.c
+ * @brief     环境光采样模块实现
+ * @details   规则组序列为 | 通道4 | 通道17 |，采样时间都取 239.5 个 ADC 时钟 (分压电阻的内阻较大)，
+ *            每次触发约 40us (12MHz)。EXTSEL 选择 TIM4_CC4，CC4 为 PWM 模式，每个周期在比较匹配时产生一次上升沿；
+ *            PB9 保持默认的输入状态，CC4E 只是让比较输出参与触发，不会驱动引脚。
+ *            缓冲区为 LIGHT_HALF 对读数的两倍，DMA 每写满一半产生一次中断，中断中只对刚写完的一半求和，
+ *            与另一半的 DMA 写入互不影响 (下一次写到这一半要在 LIGHT_HALF 个采样周期之后)。
+ *            停止模式中 ADC 断电会使正在进行的序列作废，唤醒后 DMA 从缓冲区开头重新开始，
+ *            未写满的半区被丢弃，读数的配对不会错位。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "light.h"
+#include "radio_time.h"
+#include "timebase.h"
+
+/**
+ * @addtogroup Light
+ * @{
+ */
+
+#if LIGHT_ENABLE
+
+#if RADIO_ENABLE
+#error "LIGHT_ENABLE and RADIO_ENABLE both use TIM4"
+#endif
+
+/* Private defines -----------------------------------------------------------*/
+#define LIGHT_VREF_CHANNEL 17U     ///< 内部参考电压所在的通道
+#define LIGHT_TICK_HZ      10000U  ///< TIM4 的计数频率
+#define LIGHT_BUF_LEN      (LIGHT_HALF * 4U) ///< 缓冲区的长度 (两个半区，每次采样两个读数)
+#define LIGHT_LEVEL_WIDTH  (4096U / LIGHT_LEVELS) ///< 每个亮度等级覆盖的读数范围
+#define LIGHT_STAB_US      2U      ///< ADC 上电后到可以转换的等待时间
+#define LIGHT_CAL_MS       2U      ///< 校准的超时时间 (ms)
+
+/* Private variables ---------------------------------------------------------*/
+static uint16_t light_buf[LIGHT_BUF_LEN];           ///< DMA 写入的读数，偶数为光敏电阻，奇数为参考电压
+static uint32_t light_blocks[LIGHT_AVG_BLOCKS][2];  ///< 最近各半区的和 (光敏电阻、参考电压)
+static uint32_t light_total[2];                     ///< light_blocks 各列之和
+static uint8_t light_block_next;                    ///< 下一个半区写入 light_blocks 的位置
+static uint8_t light_block_count;                   ///< light_blocks 中有效的半区数
+static volatile uint16_t light_avg;                 ///< 光敏电阻的滑动平均
+static volatile uint16_t light_vref;                ///< 参考电压的滑动平均
+static volatile uint8_t light_level = LIGHT_LEVELS - 1U; ///< 当前的亮度等级
+
+/* Private function prototypes -----------------------------------------------*/
+void DMA1_Channel1_IRQHandler(void);
+static uint32_t light_timclk(void);
+static void light_wait_clear(uint32_t bit);
+static void light_dma_restart(void);
+static void light_accumulate(const uint16_t *half);
+static bool light_update_level(uint16_t avg);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 获取 TIM4 的计数时钟
+ * @return uint32_t 定时器时钟 (Hz)，APB1 分频不为 1 时为 PCLK1 的两倍
+ */
+static uint32_t light_timclk(void)
+{
+    uint32_t timclk = HAL_RCC_GetPCLK1Freq();
+
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1) {
+        timclk *= 2U;
+    }
+    return timclk;
+}
+
+/**
+ * @brief 等待 ADC 的 CR2 中某一位被硬件清零
+ * @param[in] bit 等待的位 (ADC_CR2_RSTCAL 或 ADC_CR2_CAL)
+ * @return 无
+ */
+static void light_wait_clear(uint32_t bit)
+{
+    uint32_t start = HAL_GetTick();
+
+    while ((ADC1->CR2 & bit) && HAL_GetTick() - start < LIGHT_CAL_MS) {
+    }
+}
+
+/**
+ * @brief 让 DMA 从缓冲区开头重新开始
+ * @return 无
+ */
+static void light_dma_restart(void)
+{
+    DMA1_Channel1->CCR &= ~DMA_CCR_EN; // 关闭通道后才能重新装入传输次数
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+    DMA1_Channel1->CNDTR = LIGHT_BUF_LEN;
+    DMA1_Channel1->CCR |= DMA_CCR_EN;
+}
+
+/**
+ * @brief 把一个半区计入滑动平均
+ * @param[in] half 半区的开头
+ * @return 无
+ */
+static void light_accumulate(const uint16_t *half)
+{
+    uint32_t sum[2] = {0, 0};
+    uint32_t n;
+
+    for (uint8_t i = 0; i < LIGHT_HALF; i++) {
+        sum[0] += half[2U * i];
+        sum[1] += half[2U * i + 1U];
+    }
+    for (uint8_t c = 0; c < 2; c++) {
+        light_total[c] += sum[c] - light_blocks[light_block_next][c];
+        light_blocks[light_block_next][c] = sum[c];
+    }
+    light_block_next = (uint8_t)((light_block_next + 1U) % LIGHT_AVG_BLOCKS);
+    if (light_block_count < LIGHT_AVG_BLOCKS) {
+        light_block_count++;
+    }
+
+    n = (uint32_t)light_block_count * LIGHT_HALF;
+    light_avg = (uint16_t)(light_total[0] / n);
+    light_vref = (uint16_t)(light_total[1] / n);
+}
+
+/**
+ * @brief 按回差更新亮度等级
+ * @details 第一个半区直接取平均值所在的等级；之后平均值须越过当前等级的边界 LIGHT_HYST 以上才改变，
+ *          在边界附近的波动不会使等级来回跳动。
+ * @param[in] avg 光敏电阻的滑动平均
+ * @return bool 等级改变返回 true
+ */
+static bool light_update_level(uint16_t avg)
+{
+    uint8_t level = (uint8_t)(avg / LIGHT_LEVEL_WIDTH);
+    uint32_t low = (uint32_t)light_level * LIGHT_LEVEL_WIDTH;
+    uint32_t high = low + LIGHT_LEVEL_WIDTH;
+
+    if (light_block_count > 1U && avg + LIGHT_HYST >= low && avg < high + LIGHT_HYST) {
+        return false;
+    }
+    if (level == light_level) {
+        return false;
+    }
+    light_level = level;
+    return true;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief DMA1 通道1中断：缓冲区的一半写满
+ * @return 无
+ */
+void DMA1_Channel1_IRQHandler(void)
+{
+    uint32_t isr = DMA1->ISR;
+
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+    if (isr & DMA_ISR_TCIF1) {
+        light_accumulate(&light_buf[LIGHT_BUF_LEN / 2U]);
+    } else if (isr & DMA_ISR_HTIF1) {
+        light_accumulate(light_buf);
+    } else {
+        return;
+    }
+    if (light_update_level(light_avg)) {
+        Light_Changed_Callback();
+    }
+}
+
+#endif /* LIGHT_ENABLE */
+
+/**
+ * @brief 初始化并开始环境光采样
+ * @return 无
+ */
+void Light_Init(void)
+{
+#if LIGHT_ENABLE
+    GPIO_InitTypeDef gpio = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_ADC1_CLK_ENABLE();
+    __HAL_RCC_TIM4_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_ADCPRE, RCC_CFGR_ADCPRE_DIV6); // ADC 时钟不得超过 14MHz
+
+    gpio.Pin = LIGHT_PIN;
+    gpio.Mode = GPIO_MODE_ANALOG;
+    HAL_GPIO_Init(LIGHT_PORT, &gpio);
+
+    ADC1->CR1 = ADC_CR1_SCAN;
+    ADC1->SMPR1 = ADC_SMPR1_SMP17; // 239.5 个周期
+    ADC1->SMPR2 = ADC_SMPR2_SMP0 << (3U * LIGHT_CHANNEL); // 每个通道3位
+    ADC1->SQR3 = LIGHT_CHANNEL | (LIGHT_VREF_CHANNEL << 5U);
+    ADC1->SQR2 = 0;
+    ADC1->SQR1 = 1U << ADC_SQR1_L_Pos; // 两次转换
+    ADC1->CR2 = ADC_CR2_TSVREFE | ADC_CR2_EXTTRIG | ADC_CR2_EXTSEL_2 | ADC_CR2_EXTSEL_0 | ADC_CR2_DMA; // TIM4_CC4
+
+    // 校准前 ADC 须已上电至少两个 ADC 时钟周期
+    ADC1->CR2 |= ADC_CR2_ADON;
+    Timebase_Delay_Us(LIGHT_STAB_US);
+    ADC1->CR2 |= ADC_CR2_RSTCAL;
+    light_wait_clear(ADC_CR2_RSTCAL);
+    ADC1->CR2 |= ADC_CR2_CAL;
+    light_wait_clear(ADC_CR2_CAL);
+
+    DMA1_Channel1->CCR = 0;
+    DMA1_Channel1->CPAR = (uint32_t)&ADC1->DR;
+    DMA1_Channel1->CMAR = (uint32_t)light_buf;
+    DMA1_Channel1->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 |
+                         DMA_CCR_HTIE | DMA_CCR_TCIE;
+    light_dma_restart();
+    HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, IRQ_PRIO_BACKGROUND, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+
+    TIM4->CR1 = TIM_CR1_ARPE;
+    TIM4->PSC = light_timclk() / LIGHT_TICK_HZ - 1U;
+    TIM4->ARR = LIGHT_TICK_HZ / LIGHT_SAMPLE_HZ - 1U;
+    TIM4->CCR4 = LIGHT_TICK_HZ / LIGHT_SAMPLE_HZ / 2U;
+    TIM4->CCMR2 = TIM_CCMR2_OC4M_2 | TIM_CCMR2_OC4M_1 | TIM_CCMR2_OC4PE;
+    TIM4->CCER = TIM_CCER_CC4E;
+    TIM4->EGR = TIM_EGR_UG;
+    TIM4->CR1 |= TIM_CR1_CEN;
+#endif
+}
+
+/**
+ * @brief 获取当前的亮度等级
+ * @return uint8_t 亮度等级
+ */
+uint8_t Light_Get_Level(void)
+{
+#if LIGHT_ENABLE
+    return light_level;
+#else
+    return LIGHT_LEVELS - 1U;
+#endif
+}
+
+/**
+ * @brief 获取光敏电阻分压的滑动平均
+ * @return uint16_t ADC 读数
+ */
+uint16_t Light_Get_Average(void)
+{
+#if LIGHT_ENABLE
+    return light_avg;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief 获取内部参考电压的滑动平均
+ * @return uint16_t ADC 读数
+ */
+uint16_t Light_Get_Vrefint(void)
+{
+#if LIGHT_ENABLE
+    return light_vref;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief 进入停止模式前关闭 ADC 和触发定时器
+ * @return 无
+ */
+void Light_Suspend(void)
+{
+#if LIGHT_ENABLE
+    TIM4->CR1 &= ~TIM_CR1_CEN;
+    ADC1->CR2 &= ~ADC_CR2_ADON;
+#endif
+}
+
+/**
+ * @brief 停止模式唤醒后恢复采样
+ * @details ADC 上电时 ADON 从 0 变为 1 只是唤醒，不会开始转换。
+ * @return 无
+ */
+void Light_Resume(void)
+{
+#if LIGHT_ENABLE
+    light_dma_restart();
+    ADC1->CR2 |= ADC_CR2_ADON;
+    Timebase_Delay_Us(LIGHT_STAB_US);
+    TIM4->CR1 |= TIM_CR1_CEN;
+#endif
+}
+
+/**
+ * @brief 系统时钟切换后重新设置 TIM4 的分频
+ * @details 预分频在下一个更新事件生效，其间的一个采样周期按原来的分频计数。
+ * @return 无
+ */
+void Light_Clock_Changed(void)
+{
+#if LIGHT_ENABLE
+    TIM4->PSC = light_timclk() / LIGHT_TICK_HZ - 1U;
+#endif
+}
+
+/**
+ * @brief 亮度等级变化时的回调
+ * @details 默认为空实现，应用层可重新定义。
+ * @return 无
+ */
+__weak void Light_Changed_Callback(void)
+{
+}
+
+/** @} */
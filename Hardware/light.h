@@ -0,0 +1,108 @@
+/**
+ * @file      light.h
+ * @brief     环境光采样模块头文件
+ * @details   光敏电阻与固定电阻分压后接在 PA4 (ADC1 通道4)，光越强电压越高。
+ *            TIM4 的 CC4 事件以 LIGHT_SAMPLE_HZ 触发 ADC1 的规则组 (光敏电阻和内部参考电压两个通道)，
+ *            DMA1 通道1 以循环模式把结果搬入缓冲区；半满和全满中断各把刚写完的一半求和，
+ *            最近 LIGHT_AVG_BLOCKS 个半区的和构成滑动平均 (整数运算)。平均值越过亮度等级的边界再加上回差时
+ *            等级才改变，并在中断中调用 Light_Changed_Callback()，主循环不需要轮询。
+ *            同一序列中的内部参考电压供 supply 模块换算供电电压：启用本模块时 ADC1 和 DMA1 通道1 归本模块所有，
+ *            Supply_Start() 直接取用这里的滑动平均。
+ *            定时器和 ADC 在停止模式下不工作：进入停止模式前由 Light_Suspend() 关闭 ADC (减小停止模式的电流)，
+ *            唤醒后 Light_Resume() 重新上电，滑动平均接着停止前的数据继续。
+ *            TIM4 也是电波授时的捕获定时器，两者不能同时启用。
+ *            TIM4、ADC1 和 DMA1 通道1 由本模块直接操作寄存器，中断服务函数也在本模块中。
+ *            LIGHT_ENABLE 为 0 (默认，板上没有光敏电阻) 时所有函数为空操作。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __LIGHT_H
+#define __LIGHT_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup Light 环境光采样
+ * @brief 定时器触发 ADC、DMA 循环缓冲和中断中的滑动平均。
+ * @{
+ */
+
+/**
+ * @defgroup Light_Config 环境光采样配置
+ * @{
+ */
+#ifndef LIGHT_ENABLE
+#define LIGHT_ENABLE      0          ///< 为 1 时启用环境光采样 (需要在 PA4 接上光敏电阻分压电路)
+#endif
+#define LIGHT_PORT        GPIOA      ///< 光敏电阻分压所接的引脚
+#define LIGHT_PIN         GPIO_PIN_4
+#define LIGHT_CHANNEL     4U         ///< 引脚对应的 ADC 通道
+#define LIGHT_SAMPLE_HZ   64U        ///< 每秒采样次数
+#define LIGHT_HALF        16U        ///< 每个半区的采样次数 (每半区一次中断，64Hz 下为 250ms)
+#define LIGHT_AVG_BLOCKS  4U         ///< 滑动平均包含的半区个数 (64Hz 下为最近 1 秒)
+#define LIGHT_LEVELS      8U         ///< 亮度等级数，等级 0 最暗
+#define LIGHT_HYST        48U        ///< 等级边界两侧的回差 (ADC 读数)
+/** @} */
+
+/**
+ * @brief 初始化并开始环境光采样
+ * @details 配置 PA4 为模拟输入、ADC1 的两通道序列 (完成一次校准)、DMA1 通道1 的循环传输和 TIM4 的触发，
+ *          第一个滑动平均在 LIGHT_HALF / LIGHT_SAMPLE_HZ 后可用。LIGHT_ENABLE 为 0 时为空操作。
+ * @return 无
+ */
+void Light_Init(void);
+
+/**
+ * @brief 获取当前的亮度等级
+ * @return uint8_t 0 (最暗) ~ LIGHT_LEVELS - 1 (最亮)；尚无数据或未启用时返回 LIGHT_LEVELS - 1
+ */
+uint8_t Light_Get_Level(void);
+
+/**
+ * @brief 获取光敏电阻分压的滑动平均
+ * @return uint16_t ADC 读数 (0~4095)，尚无数据或未启用时返回 0
+ */
+uint16_t Light_Get_Average(void);
+
+/**
+ * @brief 获取内部参考电压的滑动平均
+ * @details 供 supply 模块换算供电电压。
+ * @return uint16_t ADC 读数，尚无数据或未启用时返回 0
+ */
+uint16_t Light_Get_Vrefint(void);
+
+/**
+ * @brief 进入停止模式前关闭 ADC 和触发定时器
+ * @note 在关中断时调用。
+ * @return 无
+ */
+void Light_Suspend(void);
+
+/**
+ * @brief 停止模式唤醒后恢复采样
+ * @note 在关中断时调用，须在系统时钟恢复之后。
+ * @return 无
+ */
+void Light_Resume(void);
+
+/**
+ * @brief 系统时钟切换后重新设置 TIM4 的分频
+ * @return 无
+ */
+void Light_Clock_Changed(void);
+
+/**
+ * @brief 亮度等级变化时的回调
+ * @details 在 DMA 中断中调用，默认为空实现，应用层可重新定义以发布数据总线的主题。
+ * @return 无
+ */
+void Light_Changed_Callback(void);
+
+/** @} */
+
+#endif /* __LIGHT_H */
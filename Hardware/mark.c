@@ -0,0 +1,70 @@
+/**
+ * @file      mark.c
+ * @brief     逻辑分析仪时序标记
+ * @details   引脚在停止模式中保持输出状态，唤醒后不需要重新配置；SLEEP 引脚在停止期间一直为高。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "mark.h"
+
+#if MARK_ENABLE
+
+/**
+ * @addtogroup Mark
+ * @{
+ */
+
+/* Private function prototypes -----------------------------------------------*/
+static void Mark_Pin_Init(GPIO_TypeDef *port, uint16_t pin);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 把一个引脚配置为推挽输出
+ * @details 输出速度取最高档，边沿不会因压摆率而拖后。
+ * @param[in] port 端口
+ * @param[in] pin 引脚
+ * @return 无
+ */
+static void Mark_Pin_Init(GPIO_TypeDef *port, uint16_t pin)
+{
+    GPIO_InitTypeDef gpio = {0};
+
+    gpio.Pin = pin;
+    gpio.Mode = GPIO_MODE_OUTPUT_PP;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(port, &gpio);
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 把标记引脚配置为推挽输出并置低
+ * @details 先写输出寄存器再切换模式，配置时引脚上不会出现毛刺。
+ * @return 无
+ */
+void Mark_Init(void)
+{
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+
+    MARK_END(FRAME);
+    MARK_END(DRAW);
+    MARK_END(FLUSH);
+    MARK_END(ISR);
+    MARK_END(SLEEP);
+
+    Mark_Pin_Init(MARK_FRAME_PORT, MARK_FRAME_PIN);
+    Mark_Pin_Init(MARK_DRAW_PORT, MARK_DRAW_PIN);
+    Mark_Pin_Init(MARK_FLUSH_PORT, MARK_FLUSH_PIN);
+    Mark_Pin_Init(MARK_ISR_PORT, MARK_ISR_PIN);
+    Mark_Pin_Init(MARK_SLEEP_PORT, MARK_SLEEP_PIN);
+}
+
+/** @} */
+
+#endif /* MARK_ENABLE */
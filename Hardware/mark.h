@@ -0,0 +1,76 @@
+/**
+ * @file      mark.h
+ * @brief     逻辑分析仪时序标记头文件
+ * @details   在几个空闲引脚上用高电平标出主循环一帧、页面绘制、屏幕发送、输入扫描中断和低功耗等待，
+ *            与 SDA/SCL (和电源电流) 一起接到逻辑分析仪上，不需要 CPU 输出任何数据就能看到整条流水线。
+ *            每个标记是一次对 BSRR 的 32 位写入 (置位用低16位，复位用高16位)，原子且没有读改写，
+ *            可以放在中断和绘制的热路径中，也不受其他上下文同时改写同一端口的影响。
+ *            MARK_ENABLE 为 0 时所有标记展开为空，不占用引脚。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __MARK_H
+#define __MARK_H
+
+#include "main.h"
+
+/**
+ * @defgroup Mark 时序标记
+ * @brief 提供了用 GPIO 引脚输出各阶段起止时刻的功能。
+ * @{
+ */
+
+/**
+ * @defgroup Mark_Config 时序标记配置
+ * @details 引脚选用板上未使用的 PB12~PB15 和 PA8 (各硬件版本都没有占用)。
+ * @{
+ */
+#ifndef MARK_ENABLE
+#define MARK_ENABLE       0            ///< 为 1 时编入时序标记 (默认关闭)
+#endif
+#define MARK_FRAME_PORT   GPIOB        ///< Page_Manager_Loop 一次调用
+#define MARK_FRAME_PIN    GPIO_PIN_12
+#define MARK_DRAW_PORT    GPIOB        ///< 页面的 draw 回调 (分页模式下每个条带一次)
+#define MARK_DRAW_PIN     GPIO_PIN_13
+#define MARK_FLUSH_PORT   GPIOB        ///< 主显示器一帧从开始发送到完成 (被放弃的帧保持为高，直到下一帧完成)
+#define MARK_FLUSH_PIN    GPIO_PIN_14
+#define MARK_ISR_PORT     GPIOB        ///< 输入扫描定时器中断
+#define MARK_ISR_PIN      GPIO_PIN_15
+#define MARK_SLEEP_PORT   GPIOA        ///< 低功耗等待 (睡眠或停止模式)
+#define MARK_SLEEP_PIN    GPIO_PIN_8
+/** @} */
+
+#if MARK_ENABLE
+
+/**
+ * @brief 标记一个阶段开始 (引脚置高)
+ * @param ch 阶段名：FRAME、DRAW、FLUSH、ISR 或 SLEEP
+ */
+#define MARK_BEGIN(ch) do { MARK_##ch##_PORT->BSRR = MARK_##ch##_PIN; } while (0)
+
+/**
+ * @brief 标记一个阶段结束 (引脚置低)
+ * @param ch 阶段名
+ */
+#define MARK_END(ch)   do { MARK_##ch##_PORT->BSRR = (uint32_t)MARK_##ch##_PIN << 16; } while (0)
+
+/**
+ * @brief 把标记引脚配置为推挽输出并置低
+ * @return 无
+ */
+void Mark_Init(void);
+
+#else
+
+#define MARK_BEGIN(ch) do { } while (0)
+#define MARK_END(ch)   do { } while (0)
+#define Mark_Init()    do { } while (0)
+
+#endif /* MARK_ENABLE */
+
+/** @} */
+
+#endif /* __MARK_H */
@@ -0,0 +1,835 @@
+/**
+ * @file      profiler.c
+ * @brief     基于 DWT 周期计数器的性能分析模块
+ * @details   每个代码段一份统计，窗口结束时锁存并清零，报告通过 printf 逐行输出。
+ *            CPU 负载 = (窗口内 CYCCNT 增量 - 空闲段耗时) / 窗口内的总周期数。
+ *            总周期数按 HAL_GetTick() 计算，因此无论睡眠/停止模式下 CYCCNT 是否计数，结果都成立。
+ *            系统时钟调速后 CYCCNT 的计数频率随之改变，所有耗时在记录时按 Q8 系数换算为
+ *            启动时频率 (标称频率) 下的周期数，窗口内的 CYCCNT 增量在每次换频时分段折算。
+ *            事件计数器和I2C流量另按 PROFILER_RATE_INTERVAL_MS 的短窗口换算成速率，供诊断页面显示。
+ *            I2C各设备的总线利用率 = 窗口内事务占用总线的时间之和 / 窗口长度，每个窗口记录一次跟踪事件，
+ *            并随报告每个设备输出一行。
+ *            速率窗口的结果以顺序锁 (seqlock.h) 发布，Profiler_Get_Live 拷贝时不关中断。
+ *            栈和堆在启动时填充固定图案，每个速率窗口扫描一次最大使用量，增加时记录跟踪事件。
+ *            卡顿归因在 PROF_SEC_FRAME 结束时进行：各代码段在记录时把耗时累加到所属原因，
+ *            帧结束时取出并清零，忙碌时间 = 两次帧结束之间的 CYCCNT 增量 - 其间的空闲段耗时。
+ *            输入延迟的直方图从启动起累计，某个桶的计数饱和时所有桶减半，分布的形状不变；
+ *            百分位在每个速率窗口结束时计算一次。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.4
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "profiler.h"
+
+#if PROFILER_ENABLE
+
+#include "seqlock.h"
+#include "trace.h"
+#include "uart.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @addtogroup Profiler
+ * @{
+ */
+
+/**
+ * @brief 单个代码段的统计数据
+ */
+typedef struct {
+    uint32_t count;                       ///< 测量次数
+    uint32_t min;                         ///< 最短耗时 (周期)
+    uint32_t max;                         ///< 最长耗时 (周期)
+    uint64_t sum;                         ///< 总耗时 (周期)
+    uint16_t hist[PROFILER_HIST_BINS];    ///< 耗时直方图，计数饱和于 UINT16_MAX
+} Prof_Stat_t;
+
+/**
+ * @brief 单个I2C设备在当前速率窗口内的累加值
+ */
+typedef struct {
+    uint32_t bytes;                       ///< 成功传输的字节数
+    uint32_t txns;                        ///< 结束的事务数
+    uint32_t busy_us;                     ///< 占用总线的时间 (us)
+    uint16_t fails[PROF_I2C_RETRY + 1];   ///< 按结果分类的次数 (PROF_I2C_OK 项不使用)
+} Prof_I2C_Acc_t;
+
+/* Private defines -----------------------------------------------------------*/
+#define PROF_STACK_PAINT     0xA5A5A5A5UL ///< 栈填充图案
+#define PROF_STACK_MARGIN    64           ///< 填充时在当前栈指针以下保留的字节数 (Profiler_Init 自身的栈帧)
+#define PROF_JANK_NONE       PROF_JANK_COUNT ///< 不计入任何卡顿原因的代码段
+#define PROF_JANK_TOTAL      0xFU         ///< TRACE_EV_JANK_CAUSE 中表示忙碌时间的原因字段
+#define PROF_JANK_UNIT_US    100U         ///< TRACE_EV_JANK_CAUSE 中时间字段的单位 (us)
+#define PROF_JANK_TIME_MAX   0xFFFU       ///< TRACE_EV_JANK_CAUSE 中时间字段的最大值 (饱和)
+#define PROF_REPORT_LINES    (3 + 2 * PROF_SEC_COUNT + PROFILER_I2C_DEVICES) ///< 一份报告的行数 (最后一行为输入延迟)
+
+#if defined(__MICROLIB)
+extern uint32_t __heap_base;  ///< 堆的起始地址，由启动文件导出
+extern uint32_t __heap_limit; ///< 堆的结束地址，由启动文件导出
+#define PROF_HEAP_BASE  (&__heap_base)
+#define PROF_HEAP_LIMIT (&__heap_limit)
+#else
+#define PROF_HEAP_BASE  ((uint32_t *)NULL) ///< 标准库的堆位置由链接器决定，不做统计
+#define PROF_HEAP_LIMIT ((uint32_t *)NULL)
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+uint32_t g_prof_start[PROF_SEC_COUNT];
+uint32_t g_prof_counts[PROF_CNT_COUNT];
+
+static Prof_Stat_t prof_live[PROF_SEC_COUNT];   ///< 当前窗口的统计
+static Prof_Stat_t prof_report[PROF_SEC_COUNT]; ///< 上一个窗口锁存的统计，供逐行输出
+static uint32_t cycles_per_us;                  ///< 标称频率下每微秒的CPU周期数
+static uint32_t clock_scale_q8;                 ///< 当前 CYCCNT 周期换算为标称周期的系数 (Q8)
+static uint32_t window_acc_cyc;                 ///< 当前窗口内换频之前各段折算后的周期数
+static uint32_t window_start_ms;                ///< 当前窗口开始的时间戳
+static uint32_t window_start_cyc;               ///< 当前窗口开始时的 CYCCNT
+static uint32_t report_window_ms;               ///< 锁存窗口的长度 (ms)
+static uint32_t report_window_cyc;              ///< 锁存窗口内 CYCCNT 的增量 (标称周期)
+static uint8_t report_line;                     ///< 下一行要输出的报告行，0 表示没有待输出的报告
+
+static uint32_t rate_start_ms;                  ///< 当前速率窗口开始的时间戳
+static Prof_I2C_Acc_t rate_i2c[PROFILER_I2C_DEVICES]; ///< 当前速率窗口内各设备的累加值
+static uint32_t rate_frame_count;               ///< 当前速率窗口内 PROF_SEC_FRAME 的测量次数
+static uint64_t rate_frame_sum;                 ///< 当前速率窗口内 PROF_SEC_FRAME 的总耗时 (周期)
+static uint32_t rate_frame_max;                 ///< 当前速率窗口内 PROF_SEC_FRAME 的最长耗时 (周期)
+static uint32_t rate_irq_lat_max;               ///< 当前速率窗口内 PROF_SEC_IRQ_LAT 的最长延迟 (周期)
+static Profiler_Live_t prof_rates;              ///< 上一个速率窗口锁存的结果
+static Seqlock_t prof_rates_lock;               ///< prof_rates 的顺序锁 (设备地址在中断中登记，16位写入是原子的，不经过锁)
+static uint32_t *stack_top;                     ///< 主栈的栈顶 (初始SP)
+
+static uint32_t jank_acc[PROF_JANK_COUNT];      ///< 当前帧间隔内各原因的耗时 (标称周期)，中断的耗时在中断中累加
+static uint32_t jank_idle;                      ///< 当前帧间隔内空闲段的耗时 (标称周期)
+static uint32_t jank_start_cyc;                 ///< 上一帧结束时的 CYCCNT
+static uint32_t jank_start_ms;                  ///< 上一帧结束时的时间戳
+static bool jank_drawn;                         ///< 当前帧间隔内是否绘制过页面
+static bool jank_valid;                         ///< jank_start_cyc 是否有效 (启动和换频后的第一个间隔不判定)
+static uint32_t jank_frame;                     ///< 启动以来结束的帧数，即最近一帧的序号
+static uint32_t jank_frames;                    ///< 启动以来的卡顿帧数
+static uint32_t jank_cause[PROF_JANK_COUNT];    ///< 启动以来以各原因耗时最多的卡顿帧数
+static uint32_t jank_last_us;                   ///< 最近一次卡顿的忙碌时间 (us)
+static uint32_t jank_last_frame;                ///< 最近一次卡顿的帧序号
+
+static uint16_t input_hist[PROFILER_INPUT_BINS]; ///< 输入延迟直方图，在中断中累加
+static uint32_t input_count;                    ///< 启动以来记录的输入延迟次数
+static uint32_t input_max;                      ///< 启动以来最长的输入延迟 (ms)
+
+static const char *const prof_names[PROF_SEC_COUNT] = {
+    [PROF_SEC_FRAME]       = "frame",
+    [PROF_SEC_PAGE_LOOP]   = "loop",
+    [PROF_SEC_DRAW]        = "draw",
+    [PROF_SEC_DISP_DIFF]   = "diff",
+    [PROF_SEC_DISP_TX]     = "disp_tx",
+    [PROF_SEC_RTC_READ]    = "rtc_rd",
+    [PROF_SEC_SENSOR_READ] = "aht_rd",
+    [PROF_SEC_IDLE]        = "idle",
+    [PROF_SEC_IRQ_LAT]     = "irq_lat",
+    [PROF_SEC_I2C_WAIT]    = "i2c_wt",
+    [PROF_SEC_SENSOR]      = "sensor",
+    [PROF_SEC_STORE]       = "store",
+    [PROF_SEC_ISR]         = "isr",
+};
+
+/**
+ * @brief 各代码段所属的卡顿原因，PROF_JANK_NONE 表示不计入 (跨越多帧的异步传输、空闲和延迟)
+ */
+static const uint8_t prof_jank_of[PROF_SEC_COUNT] = {
+    [PROF_SEC_FRAME]       = PROF_JANK_NONE,
+    [PROF_SEC_PAGE_LOOP]   = PROF_JANK_NONE,
+    [PROF_SEC_DRAW]        = PROF_JANK_DRAW,
+    [PROF_SEC_DISP_DIFF]   = PROF_JANK_FLUSH,
+    [PROF_SEC_DISP_TX]     = PROF_JANK_NONE,
+    [PROF_SEC_RTC_READ]    = PROF_JANK_NONE,
+    [PROF_SEC_SENSOR_READ] = PROF_JANK_NONE,
+    [PROF_SEC_IDLE]        = PROF_JANK_NONE,
+    [PROF_SEC_IRQ_LAT]     = PROF_JANK_NONE,
+    [PROF_SEC_I2C_WAIT]    = PROF_JANK_I2C,
+    [PROF_SEC_SENSOR]      = PROF_JANK_SENSOR,
+    [PROF_SEC_STORE]       = PROF_JANK_EEPROM,
+    [PROF_SEC_ISR]         = PROF_JANK_ISR,
+};
+
+static const char *const prof_jank_names[PROF_JANK_COUNT] = {
+    [PROF_JANK_DRAW]   = "draw",
+    [PROF_JANK_FLUSH]  = "flush",
+    [PROF_JANK_I2C]    = "i2c",
+    [PROF_JANK_SENSOR] = "sensor",
+    [PROF_JANK_EEPROM] = "eeprom",
+    [PROF_JANK_ISR]    = "isr",
+    [PROF_JANK_OTHER]  = "other",
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t Hist_Bin(uint32_t us);
+static uint32_t Scale_Cycles(uint32_t cycles);
+static uint32_t Report_Load_Pm(void);
+static bool Report_Line(uint8_t line);
+static void Report_I2C_Line(uint8_t dev);
+static bool Report_Jank_Line(void);
+static bool Report_Input_Line(void);
+static uint32_t Input_Percentile(const uint16_t *hist, uint32_t permille);
+static void Rate_Latch(uint32_t now);
+static uint16_t Jank_Arg(uint8_t cause, uint32_t cycles);
+static void Jank_Log(uint32_t busy, uint32_t *acc);
+static void Jank_Frame_End(void);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 计算耗时所属的直方图桶
+ * @details 桶 0 为 [0, MIN)，桶 i 为 [MIN*2^(i-1), MIN*2^i)，最后一个桶不设上限。
+ * @param[in] us 耗时 (us)
+ * @return uint8_t 桶序号
+ */
+static uint8_t Hist_Bin(uint32_t us)
+{
+    uint32_t scaled = us / PROFILER_HIST_MIN_US;
+    uint8_t bin;
+
+    if (scaled == 0) {
+        return 0;
+    }
+    bin = (uint8_t)(32 - __CLZ(scaled)); // floor(log2(scaled)) + 1
+    return (bin < PROFILER_HIST_BINS) ? bin : PROFILER_HIST_BINS - 1;
+}
+
+/**
+ * @brief 把当前频率下的 CYCCNT 周期数换算为标称周期数
+ * @param[in] cycles CYCCNT 增量
+ * @return uint32_t 标称频率下的周期数
+ */
+static uint32_t Scale_Cycles(uint32_t cycles)
+{
+    return (uint32_t)(((uint64_t)cycles * clock_scale_q8) >> 8);
+}
+
+/**
+ * @brief 计算锁存窗口的CPU负载
+ * @return uint32_t CPU负载 (千分比)
+ */
+static uint32_t Report_Load_Pm(void)
+{
+    uint64_t wall = (uint64_t)report_window_ms * cycles_per_us * 1000U;
+    uint64_t idle = prof_report[PROF_SEC_IDLE].sum;
+    uint64_t active = (report_window_cyc > idle) ? report_window_cyc - idle : 0;
+
+    return (wall > 0) ? (uint32_t)(active * 1000U / wall) : 0;
+}
+
+/**
+ * @brief 输出一个I2C设备的统计行
+ * @details 利用率和速率取自最近一个速率窗口，失败次数为启动以来的累计值。
+ * @param[in] dev 设备序号
+ * @return 无
+ */
+static void Report_I2C_Line(uint8_t dev)
+{
+    const Profiler_I2C_Live_t *d = &prof_rates.i2c[dev];
+
+    printf("[prof] i2c %02X util %u.%u%% %luB/s %lutxn/s nack %lu tmo %lu err %lu retry %lu\r\n",
+           (unsigned)(d->addr >> 1), (unsigned)(d->util_pm / 10), (unsigned)(d->util_pm % 10),
+           (unsigned long)d->bytes, (unsigned long)d->txns,
+           (unsigned long)d->nacks, (unsigned long)d->timeouts,
+           (unsigned long)d->errors, (unsigned long)d->retries);
+}
+
+/**
+ * @brief 输出卡顿统计行
+ * @details 启动以来的卡顿帧数、最近一次的帧序号和忙碌时间，以及以各原因耗时最多的帧数。
+ * @return bool 还没有发生过卡顿时不输出，返回 false
+ */
+static bool Report_Jank_Line(void)
+{
+    char buf[PROF_JANK_COUNT * 18 + 1];
+    uint8_t len = 0;
+
+    if (prof_rates.jank_frames == 0) {
+        return false;
+    }
+    for (uint8_t i = 0; i < PROF_JANK_COUNT; i++) {
+        len += (uint8_t)snprintf(&buf[len], sizeof(buf) - len, " %s %lu", prof_jank_names[i],
+                                 (unsigned long)prof_rates.jank_cause[i]);
+    }
+    printf("[prof] jank n=%lu last #%lu %luus%s\r\n", (unsigned long)prof_rates.jank_frames,
+           (unsigned long)prof_rates.jank_last_frame, (unsigned long)prof_rates.jank_last_us, buf);
+    return true;
+}
+
+/**
+ * @brief 输出输入延迟统计行
+ * @details 启动以来的次数、P50/P95/P99 和最长延迟，取自最近一个速率窗口。
+ * @return bool 还没有记录过输入延迟时不输出，返回 false
+ */
+static bool Report_Input_Line(void)
+{
+    if (prof_rates.input_count == 0) {
+        return false;
+    }
+    printf("[prof] input n=%lu p50=%lu p95=%lu p99=%lu max=%lums\r\n", (unsigned long)prof_rates.input_count,
+           (unsigned long)prof_rates.input_p50_ms, (unsigned long)prof_rates.input_p95_ms,
+           (unsigned long)prof_rates.input_p99_ms, (unsigned long)prof_rates.input_max_ms);
+    return true;
+}
+
+/**
+ * @brief 输出一行报告
+ * @details 第 1 行为窗口长度和CPU负载，之后每个代码段两行：统计值和直方图，然后每个I2C设备一行，
+ *          最后两行为卡顿统计和输入延迟。没有测量记录的代码段、未登记的设备、没有卡顿和没有输入时的统计行不输出。
+ * @param[in] line 行号 (从1开始)
+ * @return bool 实际输出了内容返回 true
+ */
+static bool Report_Line(uint8_t line)
+{
+    if (line == 1) {
+        uint32_t load_pm = Report_Load_Pm();
+
+        printf("[prof] window %lums load %lu.%lu%% clk %luMHz stack %lu/%u heap %lu/%lu\r\n",
+               (unsigned long)report_window_ms, (unsigned long)(load_pm / 10), (unsigned long)(load_pm % 10),
+               (unsigned long)(prof_rates.sysclk_hz / 1000000U),
+               (unsigned long)prof_rates.stack_used, (unsigned)PROFILER_STACK_SIZE,
+               (unsigned long)prof_rates.heap_used, (unsigned long)prof_rates.heap_size);
+        return true;
+    }
+
+    if (line >= PROF_REPORT_LINES) {
+        return Report_Input_Line();
+    }
+    if (line == PROF_REPORT_LINES - 1) {
+        return Report_Jank_Line();
+    }
+
+    if (line >= 2 + 2 * PROF_SEC_COUNT) {
+        uint8_t dev = line - (2 + 2 * PROF_SEC_COUNT);
+        if (prof_rates.i2c[dev].addr == 0) {
+            return false;
+        }
+        Report_I2C_Line(dev);
+        return true;
+    }
+
+    uint8_t sec = (line - 2) / 2;
+    const Prof_Stat_t *s = &prof_report[sec];
+
+    if (s->count == 0) {
+        return false;
+    }
+
+    if ((line & 1) == 0) {
+        printf("[prof] %-7s n=%lu min=%lu avg=%lu max=%lu us\r\n", prof_names[sec],
+               (unsigned long)s->count,
+               (unsigned long)(s->min / cycles_per_us),
+               (unsigned long)(s->sum / s->count / cycles_per_us),
+               (unsigned long)(s->max / cycles_per_us));
+    } else {
+        char buf[PROFILER_HIST_BINS * 6 + 1];
+        uint8_t len = 0;
+        for (uint8_t i = 0; i < PROFILER_HIST_BINS; i++) {
+            len += (uint8_t)snprintf(&buf[len], sizeof(buf) - len, " %u", (unsigned)s->hist[i]);
+        }
+        printf("[prof] %-7s hist%s\r\n", prof_names[sec], buf);
+    }
+    return true;
+}
+
+/**
+ * @brief 求输入延迟的百分位
+ * @param[in] hist 直方图
+ * @param[in] permille 百分位 (千分比)
+ * @return uint32_t 该百分位所在桶的上限 (ms)，不超过最长延迟；直方图为空时为0
+ */
+static uint32_t Input_Percentile(const uint16_t *hist, uint32_t permille)
+{
+    uint32_t total = 0;
+    uint32_t rank;
+    uint32_t seen = 0;
+
+    for (uint8_t i = 0; i < PROFILER_INPUT_BINS; i++) {
+        total += hist[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    rank = (total * permille + 999U) / 1000U;
+    for (uint8_t i = 0; i < PROFILER_INPUT_BINS - 1; i++) {
+        seen += hist[i];
+        if (seen >= rank) {
+            uint32_t top = (uint32_t)(i + 1) * PROFILER_INPUT_BIN_MS;
+            return (top < input_max) ? top : input_max;
+        }
+    }
+    return input_max;
+}
+
+/**
+ * @brief 结束当前速率窗口并锁存结果
+ * @details 窗口长度不足一秒时按实际长度换算成每秒的值。
+ * @param[in] now 当前时间戳
+ * @return 无
+ */
+static void Rate_Latch(uint32_t now)
+{
+    uint32_t elapsed = now - rate_start_ms;
+    uint32_t counts[PROF_CNT_COUNT];
+    Prof_I2C_Acc_t i2c[PROFILER_I2C_DEVICES];
+    uint32_t frame_count;
+    uint64_t frame_sum;
+    uint32_t frame_max;
+    uint32_t irq_lat_max;
+    uint16_t in_hist[PROFILER_INPUT_BINS];
+    uint32_t in_count;
+
+    // I2C流量、输入丢弃、中断延迟和输入延迟在中断中累加
+    __disable_irq();
+    memcpy(counts, g_prof_counts, sizeof(counts));
+    memset(g_prof_counts, 0, sizeof(g_prof_counts));
+    memcpy(i2c, rate_i2c, sizeof(i2c));
+    memset(rate_i2c, 0, sizeof(rate_i2c));
+    frame_count = rate_frame_count;
+    frame_sum = rate_frame_sum;
+    frame_max = rate_frame_max;
+    rate_frame_count = 0;
+    rate_frame_sum = 0;
+    rate_frame_max = 0;
+    irq_lat_max = rate_irq_lat_max;
+    rate_irq_lat_max = 0;
+    memcpy(in_hist, input_hist, sizeof(in_hist));
+    in_count = input_count;
+    __enable_irq();
+
+    uint32_t stack_used = Profiler_Stack_Used();
+    uint32_t heap_used = Profiler_Heap_Used();
+
+    Seqlock_Write_Begin(&prof_rates_lock);
+    for (uint8_t i = 0; i < PROF_CNT_COUNT; i++) {
+        prof_rates.total[i] += counts[i];
+        prof_rates.rate[i] = counts[i] * 1000U / elapsed;
+    }
+    for (uint8_t i = 0; i < PROFILER_I2C_DEVICES; i++) {
+        Profiler_I2C_Live_t *d = &prof_rates.i2c[i];
+        uint32_t util_pm = i2c[i].busy_us / elapsed; // us / (ms * 1000) * 1000
+
+        if (d->addr == 0) {
+            continue;
+        }
+        d->util_pm = (uint16_t)((util_pm > 1000U) ? 1000U : util_pm);
+        d->bytes = i2c[i].bytes * 1000U / elapsed;
+        d->txns = i2c[i].txns * 1000U / elapsed;
+        d->nacks += i2c[i].fails[PROF_I2C_NACK];
+        d->errors += i2c[i].fails[PROF_I2C_ERROR];
+        d->timeouts += i2c[i].fails[PROF_I2C_TIMEOUT];
+        d->retries += i2c[i].fails[PROF_I2C_RETRY];
+        // 高字节为利用率 (%)，低字节为8位地址，与 TRACE_EV_I2C_DONE 的地址字段一致
+        TRACE(TRACE_EV_I2C_UTIL, (d->addr & 0xFFU) | ((d->util_pm / 10U) << 8));
+    }
+    prof_rates.frame_avg_us = (frame_count != 0) ? (uint32_t)(frame_sum / frame_count / cycles_per_us) : 0;
+    prof_rates.frame_max_us = frame_max / cycles_per_us;
+    prof_rates.irq_lat_max_us = irq_lat_max / cycles_per_us;
+    if (prof_rates.irq_lat_max_us > prof_rates.irq_lat_worst_us) {
+        prof_rates.irq_lat_worst_us = prof_rates.irq_lat_max_us;
+    }
+
+    if (stack_used > prof_rates.stack_used) {
+        TRACE(TRACE_EV_STACK_HWM, stack_used);
+    }
+    if (heap_used > prof_rates.heap_used) {
+        TRACE(TRACE_EV_HEAP_HWM, heap_used);
+    }
+    prof_rates.stack_used = stack_used;
+    prof_rates.heap_used = heap_used;
+    prof_rates.jank_frames = jank_frames; // 卡顿统计只在主循环中更新
+    memcpy(prof_rates.jank_cause, jank_cause, sizeof(jank_cause));
+    prof_rates.jank_last_us = jank_last_us;
+    prof_rates.jank_last_frame = jank_last_frame;
+    prof_rates.input_count = in_count;
+    prof_rates.input_p50_ms = Input_Percentile(in_hist, 500);
+    prof_rates.input_p95_ms = Input_Percentile(in_hist, 950);
+    prof_rates.input_p99_ms = Input_Percentile(in_hist, 990);
+    prof_rates.input_max_ms = input_max;
+    prof_rates.seq++;
+    Seqlock_Write_End(&prof_rates_lock);
+    rate_start_ms = now;
+}
+
+/**
+ * @brief 组成 TRACE_EV_JANK_CAUSE 的参数
+ * @param[in] cause 原因 (Profiler_Jank_e 或 PROF_JANK_TOTAL)
+ * @param[in] cycles 耗时 (标称周期)
+ * @return uint16_t 高4位为原因，低12位为耗时 (0.1ms，饱和于 409.5ms)
+ */
+static uint16_t Jank_Arg(uint8_t cause, uint32_t cycles)
+{
+    uint32_t t = cycles / cycles_per_us / PROF_JANK_UNIT_US;
+
+    return (uint16_t)(((uint32_t)cause << 12) | ((t < PROF_JANK_TIME_MAX) ? t : PROF_JANK_TIME_MAX));
+}
+
+/**
+ * @brief 记录一次卡顿
+ * @details 写入帧序号、忙碌时间和耗时最多的 PROFILER_JANK_TOP 个原因 (为0的原因不写)，
+ *          并按耗时最多的原因计数。
+ * @param[in] busy 忙碌时间 (标称周期)
+ * @param[in,out] acc 各原因的耗时，选出的原因被清零
+ * @return 无
+ */
+static void Jank_Log(uint32_t busy, uint32_t *acc)
+{
+    jank_frames++;
+    jank_last_us = busy / cycles_per_us;
+    jank_last_frame = jank_frame;
+    TRACE(TRACE_EV_JANK, jank_frame);
+    TRACE(TRACE_EV_JANK_CAUSE, Jank_Arg(PROF_JANK_TOTAL, busy));
+
+    for (uint8_t k = 0; k < PROFILER_JANK_TOP; k++) {
+        uint8_t top = 0;
+
+        for (uint8_t i = 1; i < PROF_JANK_COUNT; i++) {
+            if (acc[i] > acc[top]) {
+                top = i;
+            }
+        }
+        if (k == 0) {
+            jank_cause[(acc[top] != 0) ? top : PROF_JANK_OTHER]++;
+        }
+        if (acc[top] == 0) {
+            break;
+        }
+        TRACE(TRACE_EV_JANK_CAUSE, Jank_Arg(top, acc[top]));
+        acc[top] = 0;
+    }
+}
+
+/**
+ * @brief 一帧结束，判定从上一帧结束以来的间隔是否卡顿
+ * @details 只判定绘制了页面的帧：没有绘制的循环晚了也看不出来。与上一帧相隔超过 PROFILER_JANK_GAP_MS 时
+ *          CYCCNT 的增量可能已经回绕，同样不判定。
+ * @return 无
+ */
+static void Jank_Frame_End(void)
+{
+    uint32_t cyc = DWT->CYCCNT;
+    uint32_t now = HAL_GetTick();
+    uint32_t acc[PROF_JANK_COUNT];
+    uint32_t primask = __get_PRIMASK();
+    bool check = jank_valid && jank_drawn && now - jank_start_ms <= PROFILER_JANK_GAP_MS;
+    uint32_t busy = Scale_Cycles(cyc - jank_start_cyc);
+    uint32_t sum = 0;
+
+    __disable_irq(); // 中断的耗时在中断中累加
+    memcpy(acc, jank_acc, sizeof(acc));
+    memset(jank_acc, 0, sizeof(jank_acc));
+    __set_PRIMASK(primask);
+
+    busy = (busy > jank_idle) ? busy - jank_idle : 0;
+    jank_start_cyc = cyc;
+    jank_start_ms = now;
+    jank_idle = 0;
+    jank_drawn = false;
+    jank_valid = true;
+    jank_frame++;
+
+    if (!check || busy <= PROFILER_JANK_BUDGET_US * cycles_per_us) {
+        return;
+    }
+    for (uint8_t i = 0; i < PROF_JANK_OTHER; i++) {
+        sum += acc[i];
+    }
+    acc[PROF_JANK_OTHER] = (busy > sum) ? busy - sum : 0;
+    Jank_Log(busy, acc);
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 记录一次测量结果
+ * @param[in] sec 代码段
+ * @param[in] cycles 耗时 (CPU周期)
+ * @return 无
+ */
+void Profiler_Record(Profiler_Section_e sec, uint32_t cycles)
+{
+    Prof_Stat_t *s = &prof_live[sec];
+    uint8_t bin;
+
+    cycles = Scale_Cycles(cycles);
+    bin = Hist_Bin(cycles / cycles_per_us);
+
+    if (s->count == 0 || cycles < s->min) {
+        s->min = cycles;
+    }
+    if (cycles > s->max) {
+        s->max = cycles;
+    }
+    s->count++;
+    s->sum += cycles;
+    if (s->hist[bin] != UINT16_MAX) {
+        s->hist[bin]++;
+    }
+
+    if (sec == PROF_SEC_FRAME) {
+        rate_frame_count++;
+        rate_frame_sum += cycles;
+        if (cycles > rate_frame_max) {
+            rate_frame_max = cycles;
+        }
+        Jank_Frame_End();
+    } else if (sec == PROF_SEC_IRQ_LAT && cycles > rate_irq_lat_max) {
+        rate_irq_lat_max = cycles;
+    } else if (sec == PROF_SEC_IDLE) {
+        jank_idle += cycles;
+    } else if (prof_jank_of[sec] != PROF_JANK_NONE) {
+        jank_acc[prof_jank_of[sec]] += cycles;
+        if (sec == PROF_SEC_DRAW) {
+            jank_drawn = true;
+        }
+    }
+}
+
+/**
+ * @brief 记录一次I2C事务 (或 ACK 轮询) 的结果
+ * @param[in] dev_addr 设备8位地址
+ * @param[in] bytes 成功传输的数据字节数
+ * @param[in] busy_us 占用总线的时间 (us)
+ * @param[in] result 结果
+ * @return 无
+ */
+void Profiler_Count_I2C(uint16_t dev_addr, uint16_t bytes, uint32_t busy_us, Profiler_I2C_Result_e result)
+{
+    for (uint8_t i = 0; i < PROFILER_I2C_DEVICES; i++) {
+        if (prof_rates.i2c[i].addr == 0) {
+            prof_rates.i2c[i].addr = dev_addr;
+        }
+        if (prof_rates.i2c[i].addr == dev_addr) {
+            Prof_I2C_Acc_t *a = &rate_i2c[i];
+            a->bytes += bytes;
+            a->txns++;
+            a->busy_us += busy_us;
+            if (result != PROF_I2C_OK && a->fails[result] != UINT16_MAX) {
+                a->fails[result]++;
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 记录一次输入到画面的延迟
+ * @param[in] ms 延迟 (ms)
+ * @return 无
+ */
+void Profiler_Record_Input(uint32_t ms)
+{
+    uint32_t bin = ms / PROFILER_INPUT_BIN_MS;
+    uint16_t *h = &input_hist[(bin < PROFILER_INPUT_BINS) ? bin : PROFILER_INPUT_BINS - 1];
+
+    if (*h == UINT16_MAX) {
+        for (uint8_t i = 0; i < PROFILER_INPUT_BINS; i++) {
+            input_hist[i] /= 2U;
+        }
+    }
+    (*h)++;
+    input_count++;
+    if (ms > input_max) {
+        input_max = ms;
+    }
+}
+
+/**
+ * @brief 初始化性能分析模块并启动 DWT 周期计数器
+ * @return 无
+ */
+void Profiler_Init(void)
+{
+    // 栈顶取自向量表的第一项，栈向下生长，[栈底, 当前SP - 余量) 尚未使用过
+    stack_top = (uint32_t *)(*(volatile uint32_t *)SCB->VTOR);
+    uint32_t *stack_limit = (uint32_t *)(__get_MSP() - PROF_STACK_MARGIN);
+
+    for (volatile uint32_t *p = stack_top - PROFILER_STACK_SIZE / sizeof(uint32_t); p < stack_limit; p++) {
+        *p = PROF_STACK_PAINT;
+    }
+    // 此时还没有调用过 malloc，整个堆都可以填充
+    for (volatile uint32_t *p = PROF_HEAP_BASE; p < PROF_HEAP_LIMIT; p++) {
+        *p = PROF_STACK_PAINT;
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    cycles_per_us = SystemCoreClock / 1000000U;
+    clock_scale_q8 = 256U;
+    memset(prof_live, 0, sizeof(prof_live));
+    window_start_ms = HAL_GetTick();
+    window_start_cyc = DWT->CYCCNT;
+    window_acc_cyc = 0;
+    report_line = 0;
+    memset(g_prof_counts, 0, sizeof(g_prof_counts));
+    memset(&prof_rates, 0, sizeof(prof_rates));
+    prof_rates.heap_size = (uint32_t)(PROF_HEAP_LIMIT - PROF_HEAP_BASE) * sizeof(uint32_t);
+    prof_rates.sysclk_hz = SystemCoreClock;
+    rate_start_ms = window_start_ms;
+    memset(jank_acc, 0, sizeof(jank_acc));
+    memset(jank_cause, 0, sizeof(jank_cause));
+    jank_idle = 0;
+    jank_drawn = false;
+    jank_valid = false;
+    jank_frame = 0;
+    jank_frames = 0;
+    memset(input_hist, 0, sizeof(input_hist));
+    input_count = 0;
+    input_max = 0;
+
+    UART_Printf_Init();
+}
+
+/**
+ * @brief 性能分析维护函数，需在主循环中周期调用
+ * @return 无
+ */
+void Profiler_Service(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    if (now - rate_start_ms >= PROFILER_RATE_INTERVAL_MS) {
+        Rate_Latch(now);
+    }
+
+    if (report_line == 0) {
+        if (now - window_start_ms < PROFILER_REPORT_INTERVAL_MS) {
+            return;
+        }
+
+        uint32_t cyc = DWT->CYCCNT;
+
+        // 部分代码段在中断中结束，锁存时关中断保证每份统计完整
+        __disable_irq();
+        memcpy(prof_report, prof_live, sizeof(prof_report));
+        memset(prof_live, 0, sizeof(prof_live));
+        __enable_irq();
+
+        report_window_ms = now - window_start_ms;
+        report_window_cyc = window_acc_cyc + Scale_Cycles(cyc - window_start_cyc);
+        window_start_ms = now;
+        window_start_cyc = cyc;
+        window_acc_cyc = 0;
+        report_line = 1;
+        return;
+    }
+
+    if (!UART_Printf_Is_Idle()) {
+        return;
+    }
+
+    // 跳过没有记录的代码段，每次最多输出一行
+    while (report_line != 0) {
+        bool printed = Report_Line(report_line);
+        report_line++;
+        if (report_line > PROF_REPORT_LINES) {
+            report_line = 0;
+        }
+        if (printed) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 系统时钟频率改变后更新周期换算系数
+ * @details 先把本窗口到目前为止的 CYCCNT 增量按旧系数折算，之后的增量按新系数折算。
+ * @param[in] hz 新的 SystemCoreClock
+ * @return 无
+ */
+void Profiler_Set_Clock(uint32_t hz)
+{
+    uint32_t cyc = DWT->CYCCNT;
+
+    window_acc_cyc += Scale_Cycles(cyc - window_start_cyc);
+    window_start_cyc = cyc;
+    clock_scale_q8 = (cycles_per_us * 256U) / (hz / 1000000U);
+    prof_rates.sysclk_hz = hz;
+    jank_valid = false; // 当前帧间隔的前后两部分计数频率不同，不判定
+}
+
+/**
+ * @brief 获取代码段在上一个统计窗口中的摘要
+ * @param[in] sec 代码段
+ * @param[out] out 摘要，该窗口内没有测量时各项为0
+ * @return bool 还没有结束过任何窗口时返回 false
+ */
+bool Profiler_Get_Summary(Profiler_Section_e sec, Profiler_Summary_t *out)
+{
+    const Prof_Stat_t *s = &prof_report[sec];
+
+    if (report_window_ms == 0) {
+        return false;
+    }
+    memset(out, 0, sizeof(*out));
+    if (s->count != 0) {
+        out->count = s->count;
+        out->min_us = s->min / cycles_per_us;
+        out->avg_us = (uint32_t)(s->sum / s->count / cycles_per_us);
+        out->max_us = s->max / cycles_per_us;
+    }
+    return true;
+}
+
+/**
+ * @brief 获取上一个统计窗口的长度和CPU负载
+ * @param[out] load_pm CPU负载 (千分比)
+ * @return uint32_t 窗口长度 (ms)，还没有结束过任何窗口时为0
+ */
+uint32_t Profiler_Get_Load(uint16_t *load_pm)
+{
+    *load_pm = (uint16_t)Report_Load_Pm();
+    return report_window_ms;
+}
+
+/**
+ * @brief 获取最近一个速率窗口的实时统计
+ * @param[out] out 统计结果
+ * @return bool 还没有结束过任何窗口时返回 false
+ */
+bool Profiler_Get_Live(Profiler_Live_t *out)
+{
+    uint32_t seq;
+
+    do {
+        seq = Seqlock_Read_Begin(&prof_rates_lock);
+        *out = prof_rates;
+    } while (Seqlock_Read_Retry(&prof_rates_lock, seq));
+    return out->seq != 0;
+}
+
+/**
+ * @brief 获取主栈的最大使用量
+ * @return uint32_t 启动以来的最大使用量 (字节)
+ */
+uint32_t Profiler_Stack_Used(void)
+{
+    const uint32_t *p = stack_top - PROFILER_STACK_SIZE / sizeof(uint32_t);
+
+    while (p < stack_top && *p == PROF_STACK_PAINT) {
+        p++;
+    }
+    return (uint32_t)(stack_top - p) * sizeof(uint32_t);
+}
+
+/**
+ * @brief 获取堆的最大使用量
+ * @return uint32_t 启动以来的最大使用量 (字节)，未使用 MicroLib 时为0
+ */
+uint32_t Profiler_Heap_Used(void)
+{
+    const uint32_t *p = PROF_HEAP_LIMIT;
+
+    while (p > PROF_HEAP_BASE && *(p - 1) == PROF_STACK_PAINT) {
+        p--;
+    }
+    return (uint32_t)(p - PROF_HEAP_BASE) * sizeof(uint32_t);
+}
+
+/** @} */
+
+#endif /* PROFILER_ENABLE */
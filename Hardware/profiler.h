@@ -0,0 +1,328 @@
+/**
+ * @file      profiler.h
+ * @brief     基于 DWT 周期计数器的性能分析模块头文件
+ * @details   用 Cortex-M3 的 DWT->CYCCNT 测量各代码段的耗时，统计最小/平均/最大值和
+ *            对数直方图，并通过 uart.c 的 DMA printf 周期性输出，同时给出 CPU 负载。
+ *            系统时钟调速时由 Profiler_Set_Clock() 通知新的频率，耗时仍按启动时的频率换算为微秒。
+ *            I2C总线按设备统计流量、事务数、占用时间和各类失败次数，每秒换算一次总线利用率。
+ *            按键扫描定时器的中断响应延迟由定时器自身的计数值测得，验证 main.h 中的中断优先级规划。
+ *            卡顿归因：两帧之间 (上一帧结束到本帧结束，除去低功耗等待) 的忙碌时间超过 PROFILER_JANK_BUDGET_US
+ *            且本帧绘制了页面时，按原因 (绘制、刷新、阻塞的I2C等待、传感器任务、存储任务、中断) 汇总该间隔内
+ *            各代码段的耗时，把帧序号、忙碌时间和耗时最多的几个原因写入跟踪记录 (TRACE_EV_JANK)，
+ *            并按耗时最多的原因计数，供诊断页面显示。
+ *            输入延迟：输入事件的时间戳随页面管理器的下一帧交给显示驱动，该帧发送完成时记录从事件发生到
+ *            画面到达屏幕的时间 (Profiler_Record_Input)，按 PROFILER_INPUT_BIN_MS 的等宽直方图统计启动以来的
+ *            P50/P95/P99，随报告输出一行并供诊断页面显示。
+ *            PROFILER_ENABLE 为 0 时所有标记展开为空，不占用任何代码和RAM。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.5
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __PROFILER_H
+#define __PROFILER_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup Profiler 性能分析
+ * @brief 提供了代码段耗时统计功能。
+ * @{
+ */
+
+/**
+ * @defgroup Profiler_Config 性能分析配置
+ * @{
+ */
+#ifndef PROFILER_ENABLE
+#define PROFILER_ENABLE             1     ///< 为 0 时关闭全部性能分析代码 (主机仿真构建中由编译选项置 0)
+#endif
+#define PROFILER_REPORT_INTERVAL_MS 10000 ///< 统计窗口长度，每个窗口结束时输出一次报告
+#define PROFILER_HIST_BINS          12    ///< 直方图的桶数
+#define PROFILER_HIST_MIN_US        16    ///< 第一个桶的上限 (us)，之后每个桶翻倍，最后一个桶不设上限
+#define PROFILER_RATE_INTERVAL_MS   1000  ///< 计数器速率的统计窗口 (诊断页面每个窗口更新一次)
+#define PROFILER_I2C_DEVICES        4     ///< 分别统计流量的I2C设备数，按首次出现的顺序登记
+#define PROFILER_STACK_SIZE         0x400 ///< 主栈大小，须与启动文件中的 Stack_Size 一致
+#define PROFILER_JANK_BUDGET_US     20000 ///< 两帧之间忙碌时间的上限，超过时记录卡顿 (略高于 60FPS 的帧周期)
+#define PROFILER_JANK_TOP           3     ///< 每次卡顿写入跟踪记录的原因数 (按耗时从多到少)
+#define PROFILER_JANK_GAP_MS        30000 ///< 与上一帧相隔超过该值时不判定 (CYCCNT 在 72MHz 下约 59 秒回绕)
+#define PROFILER_INPUT_BIN_MS       4     ///< 输入延迟直方图每个桶的宽度 (事件时间戳的分辨率为 1ms)
+#define PROFILER_INPUT_BINS         32    ///< 输入延迟直方图的桶数，最后一个桶不设上限
+/** @} */
+
+/**
+ * @brief 被测量的代码段
+ */
+typedef enum {
+    PROF_SEC_FRAME = 0,   ///< Page_Manager_Loop 整体
+    PROF_SEC_PAGE_LOOP,   ///< 页面的 loop 回调
+    PROF_SEC_DRAW,        ///< 页面的 draw 回调 (绘制到u8g2缓冲区，分页模式下每个条带记录一次)
+    PROF_SEC_DISP_DIFF,   ///< 显存逐页比较并提交刷新
+    PROF_SEC_DISP_TX,     ///< 一帧从开始发送到最后一页完成 (I2C传输时间)
+    PROF_SEC_RTC_READ,    ///< DS3231 时间缓存重新同步的读事务
+    PROF_SEC_SENSOR_READ, ///< AHT20 测量结果的读事务
+    PROF_SEC_IDLE,        ///< 低功耗等待，用于计算CPU负载
+    PROF_SEC_IRQ_LAT,     ///< 按键扫描定时器 (TIM2) 从更新事件到进入中断的延迟 (PROF_IRQ_LATENCY)
+    PROF_SEC_I2C_WAIT,    ///< 阻塞的I2C事务 (I2C_Bus_Transfer) 从提交到完成的等待
+    PROF_SEC_SENSOR,      ///< 主循环的传感器任务 (温湿度测量、温度历史、供电电压)
+    PROF_SEC_STORE,       ///< 主循环的存储任务 (设置、持久区和日志的 EEPROM 读写)
+    PROF_SEC_ISR,         ///< 主要中断处理函数的执行时间 (PROF_ISR_BEGIN/PROF_ISR_END，每次中断记录一次)
+    PROF_SEC_COUNT
+} Profiler_Section_e;
+
+/**
+ * @brief 卡顿的原因
+ * @details 每个原因对应一个或几个代码段，代码段的耗时包含期间被执行的中断，
+ *          阻塞的I2C等待也可能发生在传感器或存储任务中，因此各原因的时间可能重叠。
+ *          PROF_JANK_OTHER 为忙碌时间减去其余各项之和 (没有测量的代码)，各项之和超过忙碌时间时为0。
+ * @note 编号即为 TRACE_EV_JANK_CAUSE 参数中的原因字段。
+ */
+typedef enum {
+    PROF_JANK_DRAW = 0, ///< 页面绘制 (PROF_SEC_DRAW)
+    PROF_JANK_FLUSH,    ///< 显存比较并提交刷新 (PROF_SEC_DISP_DIFF)
+    PROF_JANK_I2C,      ///< 阻塞的I2C等待 (PROF_SEC_I2C_WAIT)
+    PROF_JANK_SENSOR,   ///< 传感器任务 (PROF_SEC_SENSOR)
+    PROF_JANK_EEPROM,   ///< 存储任务 (PROF_SEC_STORE)
+    PROF_JANK_ISR,      ///< 中断 (PROF_SEC_ISR)
+    PROF_JANK_OTHER,    ///< 未归入以上各项的时间
+    PROF_JANK_COUNT
+} Profiler_Jank_e;
+
+/**
+ * @brief 事件计数器
+ * @note 加一不是原子操作，同时在主循环和中断中累加的计数器偶尔会少计一次，对诊断显示没有影响。
+ */
+typedef enum {
+    PROF_CNT_LOOP = 0,     ///< 主循环迭代次数
+    PROF_CNT_FRAME,        ///< 发送到屏幕的帧数
+    PROF_CNT_INPUT_DROP,   ///< 输入FIFO已满而丢弃的事件数
+    PROF_CNT_EEPROM_WRITE, ///< EEPROM 页写入次数
+    PROF_CNT_FRAME_SKIP,   ///< 帧时刻到达时上一帧仍在发送而放弃的帧数
+    PROF_CNT_COUNT
+} Profiler_Counter_e;
+
+/**
+ * @brief 一次I2C总线操作的结果
+ */
+typedef enum {
+    PROF_I2C_OK = 0,  ///< 成功
+    PROF_I2C_NACK,    ///< 设备不应答 (地址或数据 NACK)
+    PROF_I2C_ERROR,   ///< 其他总线错误 (仲裁丢失、总线错误、启动失败)
+    PROF_I2C_TIMEOUT, ///< 事务卡死，外设被复位
+    PROF_I2C_RETRY    ///< 对忙碌设备的 ACK 轮询没有应答，稍后重试
+} Profiler_I2C_Result_e;
+
+/**
+ * @brief 单个I2C设备最近一个速率窗口的统计
+ */
+typedef struct {
+    uint16_t addr;     ///< 设备8位地址，0 表示未登记
+    uint16_t util_pm;  ///< 总线被发往该设备的事务占用的时间 (千分比)
+    uint32_t bytes;    ///< 成功传输的字节数 (每秒)
+    uint32_t txns;     ///< 结束的事务数，包括失败的事务和 ACK 轮询 (每秒)
+    uint32_t nacks;    ///< 启动以来 NACK 的次数
+    uint32_t errors;   ///< 启动以来其他总线错误的次数
+    uint32_t timeouts; ///< 启动以来事务超时的次数
+    uint32_t retries;  ///< 启动以来 ACK 轮询没有应答的次数
+} Profiler_I2C_Live_t;
+
+/**
+ * @brief 最近一个速率窗口的实时统计，供诊断页面显示
+ */
+typedef struct {
+    uint32_t seq;                               ///< 窗口序号，每个窗口结束时加一
+    uint32_t total[PROF_CNT_COUNT];             ///< 启动以来的累计值
+    uint32_t rate[PROF_CNT_COUNT];              ///< 上一个窗口内的增量 (每秒)
+    Profiler_I2C_Live_t i2c[PROFILER_I2C_DEVICES]; ///< 各I2C设备，按首次出现的顺序
+    uint32_t frame_avg_us;                      ///< 上一个窗口内 Page_Manager_Loop 的平均耗时
+    uint32_t frame_max_us;                      ///< 上一个窗口内 Page_Manager_Loop 的最长耗时
+    uint32_t irq_lat_max_us;                    ///< 上一个窗口内 TIM2 中断的最长响应延迟
+    uint32_t irq_lat_worst_us;                  ///< 启动以来 TIM2 中断的最长响应延迟
+    uint32_t stack_used;                        ///< 启动以来主栈的最大使用量 (字节)
+    uint32_t heap_used;                         ///< 启动以来堆的最大使用量 (字节)
+    uint32_t heap_size;                         ///< 堆的大小 (字节)，未使用 MicroLib 时为0
+    uint32_t sysclk_hz;                         ///< 当前的系统时钟频率 (Hz)
+    uint32_t jank_frames;                       ///< 启动以来超过 PROFILER_JANK_BUDGET_US 的帧数
+    uint32_t jank_cause[PROF_JANK_COUNT];       ///< 启动以来以各原因耗时最多的卡顿帧数
+    uint32_t jank_last_us;                      ///< 最近一次卡顿的忙碌时间 (us)
+    uint32_t jank_last_frame;                   ///< 最近一次卡顿的帧序号
+    uint32_t input_count;                       ///< 启动以来记录了延迟的输入 (每帧最多一个，取其中最早的事件)
+    uint32_t input_p50_ms;                      ///< 启动以来输入到画面的延迟的中位数 (所在桶的上限)
+    uint32_t input_p95_ms;                      ///< 输入到画面的延迟的 P95
+    uint32_t input_p99_ms;                      ///< 输入到画面的延迟的 P99
+    uint32_t input_max_ms;                      ///< 输入到画面的最长延迟
+} Profiler_Live_t;
+
+/**
+ * @brief 单个代码段在上一个统计窗口中的摘要
+ */
+typedef struct {
+    uint32_t count;  ///< 测量次数
+    uint32_t min_us; ///< 最短耗时 (us)
+    uint32_t avg_us; ///< 平均耗时 (us)
+    uint32_t max_us; ///< 最长耗时 (us)
+} Profiler_Summary_t;
+
+#if PROFILER_ENABLE
+
+/**
+ * @brief 各代码段的开始时刻 (CYCCNT)，仅供 PROF_BEGIN/PROF_END 使用
+ */
+extern uint32_t g_prof_start[PROF_SEC_COUNT];
+
+/**
+ * @brief 各计数器当前窗口的值，仅供 PROF_COUNT 使用
+ */
+extern uint32_t g_prof_counts[PROF_CNT_COUNT];
+
+/**
+ * @brief 计数器加一
+ */
+#define PROF_COUNT(cnt) do { g_prof_counts[(cnt)]++; } while (0)
+
+/**
+ * @brief 记录一次测量结果
+ * @param[in] sec 代码段
+ * @param[in] cycles 耗时 (CPU周期)
+ * @return 无
+ */
+void Profiler_Record(Profiler_Section_e sec, uint32_t cycles);
+
+/**
+ * @brief 标记代码段开始
+ * @note 同一代码段不可嵌套；开始和结束可以在不同的上下文中 (如提交事务和完成回调)。
+ */
+#define PROF_BEGIN(sec) do { g_prof_start[(sec)] = DWT->CYCCNT; } while (0)
+
+/**
+ * @brief 标记代码段结束并记录耗时
+ */
+#define PROF_END(sec)   Profiler_Record((sec), DWT->CYCCNT - g_prof_start[(sec)])
+
+/**
+ * @brief 记录定时器更新中断的响应延迟
+ * @details 须作为中断处理函数的第一条语句。定时器以 1MHz 计数 (时钟调速后由 input_clock_changed 重设分频)，
+ *          更新事件时计数值回到0，进入中断时的计数值就是从更新事件到开始执行处理函数的时间 (us)，
+ *          包括同级或更高优先级的中断和关中断临界区造成的等待。按当前系统时钟换算为周期后记录，
+ *          与 DWT 测量的其他代码段使用同一套统计。
+ */
+#define PROF_IRQ_LATENCY(sec, tim) Profiler_Record((sec), (tim)->CNT * (SystemCoreClock / 1000000U))
+
+/**
+ * @brief 标记中断处理函数开始，须与 PROF_ISR_END 在同一个函数中成对使用
+ * @details 开始时刻保存在局部变量中，不同优先级的中断嵌套时各自计时 (外层包含内层的时间)。
+ *          同一代码段的统计在嵌套的中断中同时更新时偶尔会少计一次，与计数器相同，对诊断没有影响。
+ */
+#define PROF_ISR_BEGIN() uint32_t prof_isr_start = DWT->CYCCNT
+
+/**
+ * @brief 标记中断处理函数结束并记录耗时 (每个返回路径都需要)
+ */
+#define PROF_ISR_END()   Profiler_Record(PROF_SEC_ISR, DWT->CYCCNT - prof_isr_start)
+
+/**
+ * @brief 初始化性能分析模块并启动 DWT 周期计数器
+ * @return 无
+ */
+void Profiler_Init(void);
+
+/**
+ * @brief 性能分析维护函数，需在主循环中周期调用
+ * @details 统计窗口结束时锁存一份统计结果，之后在串口空闲时每次输出一行，
+ *          避免一次写入过多内容超出 printf 的DMA缓冲区。
+ * @return 无
+ */
+void Profiler_Service(void);
+
+/**
+ * @brief 系统时钟频率改变后更新周期换算系数
+ * @details 由时钟调速在切换完成后 (关中断状态下) 调用。切换时不能有代码段正在测量，
+ *          否则该次测量的前后两部分按同一个系数换算。
+ * @param[in] hz 新的 SystemCoreClock (须为 1MHz 的整数倍)
+ * @return 无
+ */
+void Profiler_Set_Clock(uint32_t hz);
+
+/**
+ * @brief 获取代码段在上一个统计窗口中的摘要
+ * @param[in] sec 代码段
+ * @param[out] out 摘要，该窗口内没有测量时各项为0
+ * @return bool 还没有结束过任何窗口时返回 false
+ */
+bool Profiler_Get_Summary(Profiler_Section_e sec, Profiler_Summary_t *out);
+
+/**
+ * @brief 获取上一个统计窗口的长度和CPU负载
+ * @param[out] load_pm CPU负载 (千分比)
+ * @return uint32_t 窗口长度 (ms)，还没有结束过任何窗口时为0
+ */
+uint32_t Profiler_Get_Load(uint16_t *load_pm);
+
+/**
+ * @brief 记录一次I2C事务 (或 ACK 轮询) 的结果
+ * @details 在事务完成的上下文 (I2C中断) 中调用。登记的设备超过 PROFILER_I2C_DEVICES 时不再统计新设备。
+ * @param[in] dev_addr 设备8位地址
+ * @param[in] bytes 成功传输的数据字节数
+ * @param[in] busy_us 从启动到结束占用总线的时间 (us)
+ * @param[in] result 结果
+ * @return 无
+ */
+void Profiler_Count_I2C(uint16_t dev_addr, uint16_t bytes, uint32_t busy_us, Profiler_I2C_Result_e result);
+
+/**
+ * @brief 记录一次输入到画面的延迟
+ * @details 由显示驱动在带有输入时间戳的一帧发送完成时调用 (通常在I2C中断中)。
+ * @param[in] ms 从输入事件发生到该帧最后一个事务完成的时间 (ms)
+ * @return 无
+ */
+void Profiler_Record_Input(uint32_t ms);
+
+/**
+ * @brief 获取最近一个速率窗口的实时统计
+ * @param[out] out 统计结果
+ * @return bool 还没有结束过任何窗口时返回 false
+ */
+bool Profiler_Get_Live(Profiler_Live_t *out);
+
+/**
+ * @brief 获取主栈的最大使用量
+ * @details 启动时在当前栈指针以下填充了固定图案，从栈底向上找到第一个被改写的字即为最深位置。
+ *          需要扫描栈中从未用到的部分，速率窗口结束时自动扫描一次，结果见 Profiler_Live_t。
+ * @return uint32_t 启动以来的最大使用量 (字节)
+ */
+uint32_t Profiler_Stack_Used(void);
+
+/**
+ * @brief 获取堆的最大使用量
+ * @details 与栈相同采用填充图案，MicroLib 的堆从 __heap_base 向上分配，从堆顶向下找到第一个被改写的字。
+ * @return uint32_t 启动以来的最大使用量 (字节)，未使用 MicroLib 时为0
+ */
+uint32_t Profiler_Heap_Used(void);
+
+#else
+
+#define PROF_BEGIN(sec)    do { } while (0)
+#define PROF_END(sec)      do { } while (0)
+#define PROF_IRQ_LATENCY(sec, tim) do { } while (0)
+#define PROF_ISR_BEGIN()   do { } while (0)
+#define PROF_ISR_END()     do { } while (0)
+#define Profiler_Init()    do { } while (0)
+#define Profiler_Service() do { } while (0)
+#define Profiler_Set_Clock(hz)         do { (void)(hz); } while (0)
+#define Profiler_Get_Summary(sec, out) ((void)(sec), (void)(out), false)
+#define Profiler_Get_Load(load_pm)     ((void)(load_pm), 0U)
+#define PROF_COUNT(cnt)                do { } while (0)
+#define Profiler_Count_I2C(addr, bytes, busy_us, result) do { } while (0)
+#define Profiler_Record_Input(ms)      do { (void)(ms); } while (0)
+#define Profiler_Get_Live(out)         ((void)(out), false)
+#define Profiler_Stack_Used()          (0U)
+#define Profiler_Heap_Used()           (0U)
+
+#endif /* PROFILER_ENABLE */
+
+/** @} */
+
+#endif /* __PROFILER_H */
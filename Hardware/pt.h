@@ -0,0 +1,88 @@
+/**
+ * @file      pt.h
+ * @brief     无栈协程 (protothread)
+ * @details   用 switch/case 保存函数中的断点：每个等待点把当前行号记入 PT_t::lc 后返回，
+ *            下次调用时 switch 直接跳回该行继续执行。这样多步的总线事务和设备延时可以按顺序书写，
+ *            每个等待点都把控制权交还主循环，每个协程只占用2字节RAM。
+ *            使用限制：
+ *            - 等待点之间的局部变量不会保留，需要跨等待点的状态放在静态变量中；
+ *            - 协程函数体中不能使用 switch 语句 (会与断点的 case 冲突)；
+ *            - 同一行只能有一个等待点，宏内部也不能再包含等待点。
+ * @author    SandOcean
+ * @date      2025-10-04
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __PT_H
+#define __PT_H
+
+#include "main.h"
+#include <stdint.h>
+
+/**
+ * @defgroup PT 无栈协程
+ * @brief 顺序书写、在等待点让出的非阻塞流程。
+ * @{
+ */
+
+/**
+ * @brief 协程的断点
+ */
+typedef struct {
+    uint16_t lc; ///< 下次继续执行的行号，0为从头开始
+} PT_t;
+
+/**
+ * @defgroup PT_Result 协程函数的返回值
+ * @{
+ */
+#define PT_WAITING 0 ///< 在等待条件成立
+#define PT_YIELDED 1 ///< 主动让出一次
+#define PT_EXITED  2 ///< 通过 PT_EXIT 提前结束
+#define PT_ENDED   3 ///< 执行到 PT_END
+/** @} */
+
+/** 初始化 (或复位) 协程，下次调用从头开始 */
+#define PT_INIT(pt) ((pt)->lc = 0)
+
+/** 协程函数体的开始 */
+#define PT_BEGIN(pt) switch ((pt)->lc) { case 0:
+
+/** 协程函数体的结束，之后再调用从头开始 */
+#define PT_END(pt) } PT_INIT(pt); return PT_ENDED
+
+/** 等待条件成立，不成立时返回 PT_WAITING，下次调用时重新判断 */
+#define PT_WAIT_UNTIL(pt, cond)              \
+    do {                                     \
+        (pt)->lc = (uint16_t)__LINE__;       \
+        case __LINE__:                       \
+        if (!(cond)) {                       \
+            return PT_WAITING;               \
+        }                                    \
+    } while (0)
+
+/** 条件成立期间一直等待 */
+#define PT_WAIT_WHILE(pt, cond) PT_WAIT_UNTIL(pt, !(cond))
+
+/** 等到 HAL_GetTick() 时间戳 t (可以回绕) */
+#define PT_WAIT_TICK(pt, t) PT_WAIT_UNTIL(pt, (int32_t)(HAL_GetTick() - (uint32_t)(t)) >= 0)
+
+/** 让出一次，下次调用从下一条语句继续 */
+#define PT_YIELD(pt)                         \
+    do {                                     \
+        (pt)->lc = (uint16_t)__LINE__;       \
+        return PT_YIELDED;                   \
+        case __LINE__:;                      \
+    } while (0)
+
+/** 提前结束，之后再调用从头开始 */
+#define PT_EXIT(pt)                          \
+    do {                                     \
+        PT_INIT(pt);                         \
+        return PT_EXITED;                    \
+    } while (0)
+
+/** @} */
+
+#endif /* __PT_H */
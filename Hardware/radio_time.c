@@ -0,0 +1,561 @@
+/**
+ * @file      radio_time.c
+ * @brief     长波授时信号 (DCF77/WWVB) 解码模块实现
+ * @details   中断只维护"当前是第几秒"和已收到的位：
+ *            - 前沿 (CH3)：与上一个前沿相隔约 1 秒时秒序号加一；DCF77 相隔约 2 秒为分钟标记 (第59秒没有脉冲)，
+ *              此时若恰好收齐 0-58 秒且没有无效脉冲，当前帧即交出，交出的时刻就是新一分钟第0秒的起点；
+ *              间隔太短的前沿视为干扰忽略，其余间隔说明丢失了脉冲，秒序号作废直到下一个分钟起点。
+ *            - 后沿 (CH4)：按脉冲宽度分为 0、1、标记或无效，写入当前秒的位；短于最小宽度的后沿视为
+ *              脉冲中间的干扰，继续等待真正的后沿。WWVB 连续两个标记中的第二个是第0秒，
+ *              此时收齐了 0-59 秒的上一帧在第1秒的前沿交出。
+ *            边沿时刻由捕获值与当前计数值之差从 HAL_GetTick() 中扣除，不受中断延迟影响。
+ *            帧经顺序锁交给主循环，主循环校验固定位、奇偶校验 (DCF77) 或标记位置 (WWVB) 和各字段的范围，
+ *            换算为交出时刻的本地标准时间。相邻两帧的时间差与边沿间隔一致才算确认，
+ *            确认后若距边沿不超过 RADIO_COMMIT_MAX_MS 立即写入 DS3231 (写秒寄存器即从该时刻起计秒)，
+ *            否则等下一帧。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "radio_time.h"
+#include "DS3231.h"
+#include "seqlock.h"
+#include "time_core.h"
+#include "trace.h"
+
+/**
+ * @addtogroup Radio_Time
+ * @{
+ */
+
+#if RADIO_ENABLE
+
+/* Private defines -----------------------------------------------------------*/
+#define RADIO_TICKS_PER_MS (RADIO_TICK_HZ / 1000U)        ///< 每毫秒的计数值
+#define RADIO_TICKS(ms)    ((uint16_t)((ms) * RADIO_TICKS_PER_MS)) ///< 毫秒换算为计数值
+#define RADIO_LOST_MS      3000U ///< 相邻前沿超过该时间视为信号中断 (16位计数器约 6.5 秒回绕一次)
+
+#if RADIO_PROTOCOL == RADIO_PROTOCOL_DCF77
+#define RADIO_FRAME_SECONDS 59 ///< 一帧的脉冲数 (第59秒没有脉冲)
+#define RADIO_FRAME_LAG_S   0  ///< 帧内容相对交出时刻所在分钟的偏移 (DCF77 预告即将开始的一分钟)
+#else
+#define RADIO_FRAME_SECONDS 60 ///< 一帧的脉冲数
+#define RADIO_FRAME_LAG_S   60 ///< 帧内容相对交出时刻所在分钟的偏移 (WWVB 发送本帧开始的那一分钟)
+#define RADIO_WWVB_MARKS    ((1ULL << 0) | (1ULL << 9) | (1ULL << 19) | (1ULL << 29) | \
+                             (1ULL << 39) | (1ULL << 49) | (1ULL << 59)) ///< 标记应出现的秒
+#define RADIO_WWVB_UNUSED   ((1ULL << 4) | (1ULL << 10) | (1ULL << 11) | (1ULL << 14) | (1ULL << 20) | \
+                             (1ULL << 21) | (1ULL << 24) | (1ULL << 34) | (1ULL << 35) | (1ULL << 44) | \
+                             (1ULL << 54)) ///< 恒为 0 的秒
+#endif
+
+/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 按宽度分类的脉冲
+ */
+typedef enum {
+    RADIO_SYM_ZERO = 0, ///< 0
+    RADIO_SYM_ONE,      ///< 1
+    RADIO_SYM_MARK,     ///< 标记 (只有 WWVB)
+    RADIO_SYM_BAD       ///< 宽度不在任何范围内
+} Radio_Sym_e;
+
+/**
+ * @brief 中断交给主循环的一帧
+ */
+typedef struct {
+    uint64_t bits;    ///< 值为 1 的秒
+    uint64_t marks;   ///< 收到标记的秒
+    uint32_t edge_ms; ///< 交出帧的前沿对应的 HAL_GetTick()
+    uint32_t count;   ///< 启动以来交出的帧数
+    uint8_t second;   ///< 该前沿是新一分钟的第几秒
+} Radio_Frame_t;
+
+/* Private function prototypes -----------------------------------------------*/
+void TIM4_IRQHandler(void);
+static void radio_publish(uint64_t bits, uint64_t marks, uint32_t edge_ms, uint8_t second);
+static void radio_lead(uint16_t ccr);
+static void radio_trail(uint16_t ccr);
+static uint16_t radio_field(uint64_t bits, uint8_t first, const uint8_t *weights, uint8_t n);
+static bool radio_decode(const Radio_Frame_t *f, Epoch_t *epoch);
+static void radio_handle(const Radio_Frame_t *f, uint32_t now);
+static void radio_start(void);
+static void radio_stop(uint32_t next_s);
+
+/* Private variables ---------------------------------------------------------*/
+// 以下由 TIM4 中断独占
+static uint16_t radio_lead_ccr;  ///< 上一个前沿的捕获值
+static uint32_t radio_lead_ms;   ///< 上一个前沿的时刻
+static bool radio_have_lead;     ///< radio_lead_ccr 是否有效
+static bool radio_in_pulse;      ///< 已收到前沿，等待后沿
+static int8_t radio_index = -1;  ///< 当前是一分钟内的第几秒，-1 表示还没有找到分钟起点
+static bool radio_error;         ///< 当前帧中出现了无效脉冲
+static uint64_t radio_bits;      ///< 当前帧中值为 1 的秒
+static uint64_t radio_marks;     ///< 当前帧中收到标记的秒
+#if RADIO_PROTOCOL == RADIO_PROTOCOL_WWVB
+static bool radio_last_mark;     ///< 上一个脉冲是标记
+static bool radio_ready;         ///< 上一帧已收齐，在第1秒的前沿交出
+static uint64_t radio_ready_bits;  ///< 已收齐的上一帧
+static uint64_t radio_ready_marks;
+#endif
+
+// 中断写、主循环读
+static Radio_Frame_t radio_frame; ///< 最近交出的一帧
+static Seqlock_t radio_frame_lock;
+
+// 以下由主循环独占
+static volatile bool radio_receiving; ///< 是否处于接收窗口内
+static uint32_t radio_next_ms;   ///< 接收中为窗口结束时刻，否则为下一个窗口的开始时刻
+static uint32_t radio_seen;      ///< 已处理的帧数
+static uint8_t radio_confirm;    ///< 连续一致的帧数
+static Epoch_t radio_last_epoch; ///< 上一个有效帧的时间
+static uint32_t radio_last_edge; ///< 上一个有效帧的边沿时刻
+
+#if RADIO_PROTOCOL == RADIO_PROTOCOL_DCF77
+static const uint8_t radio_bcd[8] = {1, 2, 4, 8, 10, 20, 40, 80}; ///< BCD 各位的权值
+#else
+static const uint8_t radio_w_minute[8] = {40, 20, 10, 0, 8, 4, 2, 1};         ///< 第1-8秒：分钟
+static const uint8_t radio_w_hour[7] = {20, 10, 0, 8, 4, 2, 1};               ///< 第12-18秒：小时
+static const uint8_t radio_w_yday[12] = {200, 100, 0, 80, 40, 20, 10, 0, 8, 4, 2, 1}; ///< 第22-33秒：年内第几天
+static const uint8_t radio_w_year[9] = {80, 40, 20, 10, 0, 8, 4, 2, 1};       ///< 第45-53秒：年份后两位
+#endif
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 把一帧交给主循环 (在中断中调用)
+ * @param[in] bits 值为 1 的秒
+ * @param[in] marks 收到标记的秒
+ * @param[in] edge_ms 交出帧的前沿时刻
+ * @param[in] second 该前沿是新一分钟的第几秒
+ * @return 无
+ */
+static void radio_publish(uint64_t bits, uint64_t marks, uint32_t edge_ms, uint8_t second)
+{
+    Seqlock_Write_Begin(&radio_frame_lock);
+    radio_frame.bits = bits;
+    radio_frame.marks = marks;
+    radio_frame.edge_ms = edge_ms;
+    radio_frame.second = second;
+    radio_frame.count++;
+    Seqlock_Write_End(&radio_frame_lock);
+    Radio_Frame_Callback();
+}
+
+/**
+ * @brief 处理一个前沿
+ * @param[in] ccr CH3 的捕获值
+ * @return 无
+ */
+static void radio_lead(uint16_t ccr)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t edge_ms = now - (uint16_t)((uint16_t)TIM4->CNT - ccr) / RADIO_TICKS_PER_MS;
+    uint16_t gap = (uint16_t)(ccr - radio_lead_ccr);
+
+    if (!radio_have_lead || edge_ms - radio_lead_ms > RADIO_LOST_MS) {
+        radio_index = -1;
+    } else if (gap < RADIO_TICKS(RADIO_GLITCH_MS)) {
+        return; // 干扰，仍以上一个前沿为准
+    } else if (gap >= RADIO_TICKS(RADIO_SECOND_MIN_MS) && gap <= RADIO_TICKS(RADIO_SECOND_MAX_MS)) {
+        if (radio_index >= 0 && ++radio_index > RADIO_FRAME_SECONDS) {
+            radio_index = -1;
+        }
+#if RADIO_PROTOCOL == RADIO_PROTOCOL_DCF77
+    } else if (gap >= RADIO_TICKS(RADIO_MINUTE_MIN_MS) && gap <= RADIO_TICKS(RADIO_MINUTE_MAX_MS)) {
+        if (radio_index == RADIO_FRAME_SECONDS - 1 && !radio_error) {
+            radio_publish(radio_bits, radio_marks, edge_ms, 0);
+        }
+        radio_index = 0;
+        radio_error = false;
+        radio_bits = 0;
+        radio_marks = 0;
+#endif
+    } else {
+        radio_index = -1;
+    }
+
+#if RADIO_PROTOCOL == RADIO_PROTOCOL_WWVB
+    if (radio_ready && radio_index == 1) {
+        radio_publish(radio_ready_bits, radio_ready_marks, edge_ms, 1);
+    }
+    radio_ready = false;
+#endif
+
+    radio_lead_ccr = ccr;
+    radio_lead_ms = edge_ms;
+    radio_have_lead = true;
+    radio_in_pulse = true;
+}
+
+/**
+ * @brief 处理一个后沿
+ * @param[in] ccr CH4 的捕获值
+ * @return 无
+ */
+static void radio_trail(uint16_t ccr)
+{
+    uint16_t width = (uint16_t)(ccr - radio_lead_ccr);
+    Radio_Sym_e sym;
+
+    if (!radio_in_pulse || width < RADIO_TICKS(RADIO_WIDTH_MIN_MS)) {
+        return; // 没有对应的前沿，或者是脉冲中间的干扰
+    }
+    radio_in_pulse = false;
+
+    if (width < RADIO_TICKS(RADIO_WIDTH_ONE_MS)) {
+        sym = RADIO_SYM_ZERO;
+    } else if (width < RADIO_TICKS(RADIO_WIDTH_MARK_MS)) {
+        sym = RADIO_SYM_ONE;
+    } else if (width < RADIO_TICKS(RADIO_WIDTH_MAX_MS)) {
+        sym = RADIO_SYM_MARK;
+    } else {
+        sym = RADIO_SYM_BAD;
+    }
+
+#if RADIO_PROTOCOL == RADIO_PROTOCOL_WWVB
+    if (sym == RADIO_SYM_MARK && radio_last_mark) {
+        // 连续两个标记，第二个是新一分钟的第0秒
+        radio_ready = radio_index == RADIO_FRAME_SECONDS && !radio_error;
+        radio_ready_bits = radio_bits;
+        radio_ready_marks = radio_marks;
+        radio_index = 0;
+        radio_error = false;
+        radio_bits = 0;
+        radio_marks = 0;
+    }
+    radio_last_mark = sym == RADIO_SYM_MARK;
+#endif
+
+    if (radio_index < 0 || radio_index >= RADIO_FRAME_SECONDS) {
+        return;
+    }
+    if (sym == RADIO_SYM_ONE) {
+        radio_bits |= 1ULL << radio_index;
+    } else if (sym == RADIO_SYM_MARK) {
+        radio_marks |= 1ULL << radio_index;
+    } else if (sym == RADIO_SYM_BAD) {
+        radio_error = true;
+    }
+}
+
+/**
+ * @brief 按权值累加帧中连续若干秒的位
+ * @param[in] bits 帧中值为 1 的秒
+ * @param[in] first 第一位所在的秒
+ * @param[in] weights 各位的权值，0 表示该位不属于字段
+ * @param[in] n 位数
+ * @return uint16_t 字段的值
+ */
+static uint16_t radio_field(uint64_t bits, uint8_t first, const uint8_t *weights, uint8_t n)
+{
+    uint16_t value = 0;
+
+    for (uint8_t i = 0; i < n; i++) {
+        if ((bits >> (first + i)) & 1U) {
+            value += weights[i];
+        }
+    }
+    return value;
+}
+
+#if RADIO_PROTOCOL == RADIO_PROTOCOL_DCF77
+/**
+ * @brief 检查连续若干秒 (含校验位) 的偶校验
+ * @param[in] bits 帧中值为 1 的秒
+ * @param[in] first 第一位所在的秒
+ * @param[in] n 位数 (含校验位)
+ * @return bool 1 的个数为偶数返回 true
+ */
+static bool radio_even(uint64_t bits, uint8_t first, uint8_t n)
+{
+    uint32_t ones = 0;
+
+    for (uint8_t i = 0; i < n; i++) {
+        ones += (uint32_t)(bits >> (first + i)) & 1U;
+    }
+    return (ones & 1U) == 0;
+}
+#endif
+
+/**
+ * @brief 校验并解码一帧
+ * @param[in] f 帧
+ * @param[out] epoch 交出时刻的本地标准时间
+ * @return bool 帧有效返回 true
+ */
+static bool radio_decode(const Radio_Frame_t *f, Epoch_t *epoch)
+{
+    uint64_t b = f->bits;
+    int32_t utc;
+
+#if RADIO_PROTOCOL == RADIO_PROTOCOL_DCF77
+    Time_t t;
+    bool cest = (b >> 17) & 1U;
+
+    // 第0秒恒为0，第20秒恒为1，Z1 (夏令时) 与 Z2 (冬令时) 恰有一个为1
+    if (f->marks != 0 || (b & 1U) || !((b >> 20) & 1U) || cest == (bool)((b >> 18) & 1U)) {
+        return false;
+    }
+    if (!radio_even(b, 21, 8) || !radio_even(b, 29, 7) || !radio_even(b, 36, 23)) {
+        return false;
+    }
+    t.minute = (uint8_t)radio_field(b, 21, radio_bcd, 7);
+    t.hour = (uint8_t)radio_field(b, 29, radio_bcd, 6);
+    t.day = (uint8_t)radio_field(b, 36, radio_bcd, 6);
+    t.week = (uint8_t)radio_field(b, 42, radio_bcd, 3);
+    t.month = (uint8_t)radio_field(b, 45, radio_bcd, 5);
+    t.year = (uint16_t)(TIME_EPOCH_YEAR + radio_field(b, 50, radio_bcd, 8));
+    t.second = 0;
+    if (t.minute > 59 || t.hour > 23 || t.week < 1 || t.week > 7 || t.month < 1 || t.month > 12 ||
+        t.day < 1 || t.day > Time_Days_In_Month(t.year, t.month)) {
+        return false;
+    }
+    // 中欧时间为 UTC+1，夏令时为 UTC+2
+    utc = (int32_t)Time_To_Epoch(&t) - (cest ? 7200 : 3600);
+#else
+    uint16_t yday;
+    uint16_t year;
+    uint8_t minute;
+    uint8_t hour;
+
+    if (f->marks != RADIO_WWVB_MARKS || (b & RADIO_WWVB_UNUSED)) {
+        return false;
+    }
+    minute = (uint8_t)radio_field(b, 1, radio_w_minute, 8);
+    hour = (uint8_t)radio_field(b, 12, radio_w_hour, 7);
+    yday = radio_field(b, 22, radio_w_yday, 12);
+    year = (uint16_t)(TIME_EPOCH_YEAR + radio_field(b, 45, radio_w_year, 9));
+    if (minute > 59 || hour > 23 || yday < 1 || yday > (Time_Is_Leap(year) ? 366 : 365)) {
+        return false;
+    }
+    utc = (int32_t)((Time_Days_From_Civil(year, 1, 1) + yday - 1U) * TIME_SECS_PER_DAY) + hour * 3600 + minute * 60;
+#endif
+
+    *epoch = (Epoch_t)(utc + RADIO_UTC_OFFSET_MIN * 60 + RADIO_FRAME_LAG_S + f->second);
+    return true;
+}
+
+/**
+ * @brief 处理一帧：确认后写入 RTC
+ * @param[in] f 帧
+ * @param[in] now 当前时间戳
+ * @return 无
+ */
+static void radio_handle(const Radio_Frame_t *f, uint32_t now)
+{
+    Epoch_t epoch;
+
+    if (!radio_decode(f, &epoch)) {
+        radio_confirm = 0;
+        TRACE(TRACE_EV_RADIO_FRAME, 0);
+        return;
+    }
+
+    // 与上一个有效帧的时间差应等于两个边沿的间隔 (中间可以丢帧)
+    if (radio_confirm > 0 && epoch - radio_last_epoch == (f->edge_ms - radio_last_edge + 500U) / 1000U) {
+        if (radio_confirm < RADIO_CONFIRM_FRAMES) {
+            radio_confirm++;
+        }
+    } else {
+        radio_confirm = 1;
+    }
+    radio_last_epoch = epoch;
+    radio_last_edge = f->edge_ms;
+
+    if (radio_confirm < RADIO_CONFIRM_FRAMES || now - f->edge_ms > RADIO_COMMIT_MAX_MS) {
+        TRACE(TRACE_EV_RADIO_FRAME, 1);
+        return; // 还没有确认，或者处理得太晚，等下一帧
+    }
+
+    DS3231_SetTimeSync(epoch, f->edge_ms); // 这一秒从分钟标志的边沿开始，写入完成后记入对时误差日志
+    TRACE(TRACE_EV_RADIO_FRAME, 2);
+    radio_stop(RADIO_SYNC_INTERVAL_S);
+}
+
+/**
+ * @brief 打开接收窗口
+ * @return 无
+ */
+static void radio_start(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    radio_have_lead = false;
+    radio_in_pulse = false;
+    radio_index = -1;
+#if RADIO_PROTOCOL == RADIO_PROTOCOL_WWVB
+    radio_last_mark = false;
+    radio_ready = false;
+#endif
+    __set_PRIMASK(primask);
+
+    radio_confirm = 0;
+    radio_seen = radio_frame.count; // 只有主循环会在这之后读它，此时中断已停止
+    radio_receiving = true;
+    radio_next_ms = HAL_GetTick() + RADIO_RX_WINDOW_S * 1000U;
+
+    TIM4->SR = 0;
+    TIM4->DIER = TIM_DIER_CC3IE | TIM_DIER_CC4IE;
+    TIM4->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief 关闭接收窗口
+ * @param[in] next_s 到下一个窗口的间隔 (s)
+ * @return 无
+ */
+static void radio_stop(uint32_t next_s)
+{
+    TIM4->CR1 &= ~TIM_CR1_CEN;
+    TIM4->DIER = 0;
+    radio_receiving = false;
+    radio_next_ms = HAL_GetTick() + next_s * 1000U;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief TIM4 中断：处理前沿和后沿的捕获
+ * @details 读 CCR 即清除对应的捕获标志。发生重复捕获说明漏掉了边沿，当前帧作废。
+ * @return 无
+ */
+void TIM4_IRQHandler(void)
+{
+    uint32_t sr = TIM4->SR;
+
+    if (sr & TIM_SR_CC3IF) {
+        radio_lead((uint16_t)TIM4->CCR3);
+    }
+    if (sr & TIM_SR_CC4IF) {
+        radio_trail((uint16_t)TIM4->CCR4);
+    }
+    if (sr & (TIM_SR_CC3OF | TIM_SR_CC4OF)) {
+        TIM4->SR = (uint32_t)~(TIM_SR_CC3OF | TIM_SR_CC4OF);
+        radio_index = -1;
+    }
+}
+
+#endif /* RADIO_ENABLE */
+
+/**
+ * @brief 初始化授时接收
+ * @details PB8 配置为浮空输入 (接收模块为推挽或带上拉的开漏输出)。
+ *          TIM4 的 fDTS 为计数时钟的 1/4，输入滤波器取最大值 (连续 8 次采样)，滤掉微秒级的尖峰；
+ *          CH3 映射到 TI3 并捕获有效电平的开始，CH4 映射到 TI3 并捕获相反的边沿。
+ * @return 无
+ */
+void Radio_Time_Init(void)
+{
+#if RADIO_ENABLE
+    GPIO_InitTypeDef gpio = {0};
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_TIM4_CLK_ENABLE();
+
+    gpio.Pin = RADIO_PIN;
+    gpio.Mode = GPIO_MODE_INPUT;
+    gpio.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(RADIO_PORT, &gpio);
+
+    TIM4->CR1 = TIM_CR1_CKD_1;
+    TIM4->ARR = 0xFFFF;
+    TIM4->CCMR2 = TIM_CCMR2_CC3S_0 | TIM_CCMR2_IC3F | TIM_CCMR2_CC4S_1 | TIM_CCMR2_IC4F;
+#if RADIO_ACTIVE_HIGH
+    TIM4->CCER = TIM_CCER_CC3E | TIM_CCER_CC4E | TIM_CCER_CC4P;
+#else
+    TIM4->CCER = TIM_CCER_CC3E | TIM_CCER_CC4E | TIM_CCER_CC3P;
+#endif
+    Radio_Clock_Changed();
+
+    HAL_NVIC_SetPriority(TIM4_IRQn, IRQ_PRIO_INPUT, 0);
+    HAL_NVIC_EnableIRQ(TIM4_IRQn);
+    radio_start();
+#endif
+}
+
+/**
+ * @brief 授时接收的主循环服务
+ * @return 无
+ */
+void Radio_Time_Service(void)
+{
+#if RADIO_ENABLE
+    uint32_t now = HAL_GetTick();
+    Radio_Frame_t f;
+    uint32_t seq;
+
+    if (!radio_receiving) {
+        if ((int32_t)(now - radio_next_ms) >= 0) {
+            radio_start();
+        }
+        return;
+    }
+
+    do {
+        seq = Seqlock_Read_Begin(&radio_frame_lock);
+        f = radio_frame;
+    } while (Seqlock_Read_Retry(&radio_frame_lock, seq));
+    if (f.count != radio_seen) {
+        radio_seen = f.count;
+        radio_handle(&f, now);
+    }
+
+    if (radio_receiving && (int32_t)(now - radio_next_ms) >= 0) {
+        radio_stop(RADIO_RETRY_INTERVAL_S);
+    }
+#endif
+}
+
+/**
+ * @brief 是否处于接收窗口内
+ * @return bool 正在接收返回 true
+ */
+bool Radio_Is_Receiving(void)
+{
+#if RADIO_ENABLE
+    return radio_receiving;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 系统时钟切换后重新设置 TIM4 的预分频
+ * @details 与 input_clock_changed() 相同：APB1 分频不为 1 时定时器时钟为 PCLK1 的两倍。
+ *          写预分频后立即产生更新事件使其生效，计数器因此清零，上一个前沿的捕获值作废。
+ * @return 无
+ */
+void Radio_Clock_Changed(void)
+{
+#if RADIO_ENABLE
+    uint32_t timclk = HAL_RCC_GetPCLK1Freq();
+    uint32_t primask;
+
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1) {
+        timclk *= 2U;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    TIM4->PSC = timclk / RADIO_TICK_HZ - 1U;
+    TIM4->EGR = TIM_EGR_UG;
+    radio_have_lead = false;
+    radio_in_pulse = false;
+    radio_index = -1;
+    __set_PRIMASK(primask);
+#endif
+}
+
+/**
+ * @brief 中断交出一帧时的回调
+ * @details 默认为空实现，应用层可重新定义。
+ * @return 无
+ */
+__weak void Radio_Frame_Callback(void)
+{
+}
+
+/** @} */
@@ -0,0 +1,110 @@
+/**
+ * @file      radio_time.h
+ * @brief     长波授时信号 (DCF77/WWVB) 解码模块头文件
+ * @details   授时接收模块的解调输出接在 PB8 (TIM4_CH3)。TIM4 以 10kHz 计数，CH3 直接捕获脉冲的前沿，
+ *            CH4 经 TI3 间接捕获后沿 (F1 的输入捕获不支持双边沿)，脉冲宽度完全由硬件测量，
+ *            中断里只做两次减法和一次比较，每秒两次中断。每个后沿把一位写入当前帧，
+ *            帧在分钟起点 (DCF77 缺少第59秒脉冲后的第一个前沿，WWVB 连续两个标记之后的第一秒) 交给主循环，
+ *            主循环校验后按 RADIO_UTC_OFFSET_MIN 换算为本地标准时间 (夏令时仍由时钟自己的规则处理)，
+ *            连续两帧一致 (相差60秒) 时写入 DS3231。
+ *            写入经 DS3231_SetTimeSync 安排在帧边沿之后的第一个整秒，芯片的秒边界与授时信号对齐，
+ *            对时点同样记入对时误差日志，参与漂移估计。
+ *            接收只在对时窗口内进行：上电后和每次对时成功后间隔 RADIO_SYNC_INTERVAL_S 打开一次，
+ *            窗口内没有成功时每隔 RADIO_RETRY_INTERVAL_S 重试；窗口内停止模式被禁止 (TIM4 需要时钟)。
+ *            TIM4 不在 CubeMX 配置中，由本模块直接操作寄存器，中断服务函数也在本模块中。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __RADIO_TIME_H
+#define __RADIO_TIME_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup Radio_Time 长波授时解码
+ * @brief 用定时器输入捕获解码 DCF77/WWVB 时间码并校准 DS3231。
+ * @{
+ */
+
+#define RADIO_PROTOCOL_DCF77 0 ///< 德国 DCF77 (77.5kHz)，发送中欧时间，带夏令时标志
+#define RADIO_PROTOCOL_WWVB  1 ///< 美国 WWVB (60kHz)，发送 UTC
+
+/**
+ * @defgroup Radio_Time_Config 长波授时解码配置
+ * @{
+ */
+#ifndef RADIO_ENABLE
+#define RADIO_ENABLE           0    ///< 为 1 时启用授时接收 (需要在 PB8 接上接收模块)
+#endif
+#define RADIO_PROTOCOL         RADIO_PROTOCOL_DCF77 ///< 接收的电台
+#define RADIO_ACTIVE_HIGH      1    ///< 接收模块在载波降低期间输出高电平为 1，输出低电平为 0
+#define RADIO_PORT             GPIOB       ///< 接收模块输出所接的引脚 (TIM4_CH3)
+#define RADIO_PIN              GPIO_PIN_8
+#define RADIO_TICK_HZ          10000 ///< TIM4 的计数频率 (Hz)
+#define RADIO_GLITCH_MS        900  ///< 与上一个前沿间隔小于该值的前沿视为干扰
+#define RADIO_SECOND_MIN_MS    900  ///< 相邻前沿间隔在 [MIN, MAX] 内为一秒
+#define RADIO_SECOND_MAX_MS    1100
+#define RADIO_MINUTE_MIN_MS    1900 ///< DCF77 缺少第59秒脉冲时相邻前沿的间隔范围 (分钟标记)
+#define RADIO_MINUTE_MAX_MS    2100
+#if RADIO_PROTOCOL == RADIO_PROTOCOL_DCF77
+#define RADIO_UTC_OFFSET_MIN   60   ///< 本地标准时间相对 UTC 的偏移 (分钟)，RTC 中保存的是标准时间
+#define RADIO_WIDTH_MIN_MS     40   ///< 短于该值的脉冲视为干扰并忽略
+#define RADIO_WIDTH_ONE_MS     150  ///< 不短于该值为 1 (100ms 为 0，200ms 为 1)
+#define RADIO_WIDTH_MARK_MS    260  ///< DCF77 没有标记，与 MAX 相同
+#define RADIO_WIDTH_MAX_MS     260  ///< 不短于该值为无效脉冲
+#else
+#define RADIO_UTC_OFFSET_MIN   (-300) ///< 本地标准时间相对 UTC 的偏移 (分钟)，RTC 中保存的是标准时间
+#define RADIO_WIDTH_MIN_MS     100  ///< 短于该值的脉冲视为干扰并忽略
+#define RADIO_WIDTH_ONE_MS     350  ///< 不短于该值为 1 (200ms 为 0，500ms 为 1)
+#define RADIO_WIDTH_MARK_MS    650  ///< 不短于该值为标记 (800ms)
+#define RADIO_WIDTH_MAX_MS     950  ///< 不短于该值为无效脉冲
+#endif
+#define RADIO_CONFIRM_FRAMES   2    ///< 写入 RTC 之前需要连续一致的帧数
+#define RADIO_COMMIT_MAX_MS    50   ///< 帧边沿之后超过该时间才处理的帧不写入 (写入时刻决定了秒的起点)
+#define RADIO_SYNC_INTERVAL_S  21600 ///< 对时成功后到下一次接收的间隔 (s)
+#define RADIO_RETRY_INTERVAL_S 3600 ///< 接收窗口内没有成功时到下一次接收的间隔 (s)
+#define RADIO_RX_WINDOW_S      600  ///< 每次接收窗口的长度 (s)
+/** @} */
+
+/**
+ * @brief 初始化授时接收
+ * @details 配置 PB8 和 TIM4，并立即打开第一个接收窗口。RADIO_ENABLE 为 0 时为空操作。
+ * @return 无
+ */
+void Radio_Time_Init(void);
+
+/**
+ * @brief 授时接收的主循环服务
+ * @details 解码中断交来的帧，确认后写入 RTC，并按计划打开和关闭接收窗口。应在主循环中持续调用。
+ * @return 无
+ */
+void Radio_Time_Service(void);
+
+/**
+ * @brief 是否处于接收窗口内
+ * @return bool 正在接收返回 true，此时不能进入停止模式
+ */
+bool Radio_Is_Receiving(void);
+
+/**
+ * @brief 系统时钟切换后重新设置 TIM4 的预分频
+ * @details 切换时正在测量的脉冲作废，当前分钟的帧不会交出。
+ * @return 无
+ */
+void Radio_Clock_Changed(void);
+
+/**
+ * @brief 中断交出一帧时的回调
+ * @details 在 TIM4 中断中调用，默认为空实现，应用层可重新定义以唤醒处理它的任务。
+ * @return 无
+ */
+void Radio_Frame_Callback(void);
+
+/** @} */
+
+#endif /* __RADIO_TIME_H */
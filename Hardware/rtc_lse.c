@@ -0,0 +1,173 @@
+/**
+ * @file      rtc_lse.c
+ * @brief     片内RTC (LSE) 备用时间源
+ * @details   读取前须等 RSF 置位 (复位后 APB1 与 RTC 时钟域重新同步)，写入须在配置模式 (CNF) 中进行，
+ *            进入配置模式前等待 RTOFF。几个状态只由主循环推进，中断中只读写计数器。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "rtc_lse.h"
+
+/**
+ * @addtogroup RtcLse
+ * @{
+ */
+
+#if RTC_LSE_ENABLE
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 片内RTC的状态
+ */
+typedef enum {
+    LSE_OFF = 0,  ///< 未使用
+    LSE_STARTING, ///< 等待 LSE 起振
+    LSE_RUNNING,  ///< 计数器在走动 (是否已校准看计数器的值)
+} Lse_State_e;
+
+/* Private variables ---------------------------------------------------------*/
+static volatile uint8_t lse_state; ///< Lse_State_e
+
+/* Private function prototypes -----------------------------------------------*/
+static bool lse_config_begin(void);
+static void lse_config_end(void);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 进入配置模式
+ * @return bool 上一次写入已完成并进入配置模式时返回 true
+ */
+static bool lse_config_begin(void)
+{
+    uint16_t spins = RTC_LSE_RTOFF_SPINS;
+
+    while ((RTC->CRL & RTC_CRL_RTOFF) == 0) {
+        if (--spins == 0) {
+            return false;
+        }
+    }
+    RTC->CRL |= RTC_CRL_CNF;
+    return true;
+}
+
+/**
+ * @brief 退出配置模式，写入在后台完成
+ * @return 无
+ */
+static void lse_config_end(void)
+{
+    RTC->CRL &= (uint16_t)~RTC_CRL_CNF;
+}
+
+#endif /* RTC_LSE_ENABLE */
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 初始化片内RTC
+ * @return 无
+ */
+void RTC_Lse_Init(void)
+{
+#if RTC_LSE_ENABLE
+    uint32_t bdcr;
+
+    __HAL_RCC_BKP_CLK_ENABLE(); // PWR 时钟已在 HAL_MspInit 中打开
+    HAL_PWR_EnableBkUpAccess();
+
+    bdcr = RCC->BDCR;
+    if ((bdcr & RCC_BDCR_RTCSEL) == RCC_BDCR_RTCSEL_LSE && (bdcr & RCC_BDCR_RTCEN) != 0) {
+        RTC->CRL &= (uint16_t)~RTC_CRL_RSF;
+        lse_state = LSE_RUNNING;
+    } else if ((bdcr & RCC_BDCR_RTCSEL) == 0) {
+        RCC->BDCR |= RCC_BDCR_LSEON;
+        lse_state = LSE_STARTING;
+    } else {
+        lse_state = LSE_OFF;
+    }
+#endif
+}
+
+/**
+ * @brief 片内RTC维护函数
+ * @return 无
+ */
+void RTC_Lse_Service(void)
+{
+#if RTC_LSE_ENABLE
+    if (lse_state != LSE_STARTING || (RCC->BDCR & RCC_BDCR_LSERDY) == 0) {
+        return;
+    }
+    RCC->BDCR |= RCC_BDCR_RTCSEL_LSE;
+    RCC->BDCR |= RCC_BDCR_RTCEN;
+    RTC->CRL &= (uint16_t)~RTC_CRL_RSF;
+    if (!lse_config_begin()) {
+        return; // 下一次调用时重试
+    }
+    RTC->PRLH = 0;
+    RTC->PRLL = (uint16_t)(LSE_VALUE - 1U);
+    RTC->CNTH = 0; // 校准之前低于 RTC_LSE_EPOCH_MIN，不会被当作时间
+    RTC->CNTL = 0;
+    lse_config_end();
+    lse_state = LSE_RUNNING;
+#endif
+}
+
+/**
+ * @brief 读取计数器
+ * @param[out] epoch 纪元秒
+ * @return bool 计数器已校准过时返回 true
+ */
+bool RTC_Lse_Read(Epoch_t *epoch)
+{
+#if RTC_LSE_ENABLE
+    uint16_t high, low;
+    Epoch_t cnt;
+
+    if (lse_state != LSE_RUNNING || (RTC->CRL & RTC_CRL_RSF) == 0) {
+        return false;
+    }
+    do {
+        high = (uint16_t)RTC->CNTH;
+        low = (uint16_t)RTC->CNTL;
+    } while (high != (uint16_t)RTC->CNTH);
+
+    cnt = ((Epoch_t)high << 16) | low;
+    if (cnt < RTC_LSE_EPOCH_MIN) {
+        return false;
+    }
+    *epoch = cnt;
+    return true;
+#else
+    (void)epoch;
+    return false;
+#endif
+}
+
+/**
+ * @brief 写入计数器
+ * @param[in] epoch 纪元秒
+ * @return bool 已写入时返回 true
+ */
+bool RTC_Lse_Write(Epoch_t epoch)
+{
+#if RTC_LSE_ENABLE
+    if (lse_state != LSE_RUNNING || !lse_config_begin()) {
+        return false;
+    }
+    RTC->CNTH = (uint16_t)(epoch >> 16);
+    RTC->CNTL = (uint16_t)epoch;
+    lse_config_end();
+    return true;
+#else
+    (void)epoch;
+    return false;
+#endif
+}
+
+/** @} */
@@ -0,0 +1,82 @@
+/**
+ * @file      rtc_lse.h
+ * @brief     片内RTC (LSE) 备用时间源头文件
+ * @details   STM32F103 的 RTC 是备份域中的32位秒计数器，由 32.768kHz 的 LSE 晶振经 PRL 分频驱动，
+ *            读取时间只是两次寄存器读，停止模式中照常计数。本模块把它当作纪元秒 (Epoch_t) 的计数器：
+ *            DS3231 的时间缓存每次与芯片同步后在下一个SQW边沿写入计数器 (校准)，平时缓存照常由SQW推进，
+ *            只在每个重新同步周期拿计数器核对一次是否漏掉了脉冲，芯片读取因此从每分钟一次减少为
+ *            每 RTC_LSE_DISCIPLINE_S 一次；SQW失效、DS3231 缺失或总线故障时，缓存改为读取计数器，时钟以
+ *            LSE 晶振的精度 (约 ±20ppm，每天约2秒) 继续走动，不再每 200ms 经总线轮询芯片。
+ *            计数器不小于 RTC_LSE_EPOCH_MIN 时才视为有效：备份域掉电后计数器从0开始，
+ *            在第一次与芯片同步之前不会被当作时间使用。BKP_DR1~DR10 全部归 app_resume，本模块不占用数据寄存器。
+ *            HAL 的 RTC 模块未启用，这里直接操作 RCC->BDCR 和 RTC 寄存器。LSE 起振需要约1秒，
+ *            初始化只打开振荡器，起振后由 RTC_Lse_Service 完成配置，启动过程不等待。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __RTC_LSE_H
+#define __RTC_LSE_H
+
+#include "main.h"
+#include "time_core.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup RtcLse 片内RTC
+ * @brief 以 LSE 驱动的片内RTC计数器作为 DS3231 之外不经过I2C的时间源。
+ * @{
+ */
+
+/**
+ * @defgroup RtcLse_Config 片内RTC配置
+ * @{
+ */
+#ifndef RTC_LSE_ENABLE
+#define RTC_LSE_ENABLE        0          ///< 为 1 时启用片内RTC (需要在 PC14/PC15 接上 32.768kHz 晶振)
+#endif
+#define RTC_LSE_DISCIPLINE_S  900        ///< 计数器有效时 DS3231 缓存与芯片重新同步的间隔 (s)，每小时4次
+#define RTC_LSE_EPOCH_MIN     789004800UL ///< 计数器有效的下限 (2025-01-01 00:00:00 的纪元秒)
+#define RTC_LSE_RTOFF_SPINS   2000       ///< 等待上一次写入完成的最多次数 (写入需要3个 LSE 周期，约92us)
+/** @} */
+
+/**
+ * @brief 初始化片内RTC
+ * @details 打开备份域的写访问。备份域仍保持着上一次的配置 (热复位或 VBAT 供电) 时计数器继续走动，
+ *          否则打开 LSE 振荡器，起振后由 RTC_Lse_Service 选择时钟并设置分频。
+ *          备份域已选择了别的时钟源时不使用片内RTC (改选时钟须复位备份域，会清除 app_resume 的数据)。
+ *          RTC_LSE_ENABLE 为 0 时为空操作。
+ * @return 无
+ */
+void RTC_Lse_Init(void);
+
+/**
+ * @brief 片内RTC维护函数，需在主循环中周期调用
+ * @details LSE 起振之后完成时钟选择和分频设置，只执行一次。
+ * @return 无
+ */
+void RTC_Lse_Service(void);
+
+/**
+ * @brief 读取计数器
+ * @details 两次读取高半字不同时重读，可在中断中调用。
+ * @param[out] epoch 标准时间 (未应用夏令时) 的纪元秒
+ * @return bool 计数器已校准过 (不小于 RTC_LSE_EPOCH_MIN) 时返回 true，否则 epoch 不变
+ */
+bool RTC_Lse_Read(Epoch_t *epoch);
+
+/**
+ * @brief 写入计数器
+ * @details 应在这一秒开始的时刻 (SQW边沿) 调用，分频器的相位不随写入改变，计数器与芯片的相位差小于1秒。
+ *          只等待上一次写入完成，本次写入在后台用3个 LSE 周期完成。可在中断中调用。
+ * @param[in] epoch 标准时间 (未应用夏令时) 的纪元秒
+ * @return bool RTC 已在运行并写入时返回 true
+ */
+bool RTC_Lse_Write(Epoch_t epoch);
+
+/** @} */
+
+#endif /* __RTC_LSE_H */
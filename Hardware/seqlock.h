@@ -0,0 +1,94 @@
+/**
+ * @file      seqlock.h
+ * @brief     顺序锁 (seqlock)
+ * @details   让主循环无需关中断就能读出由中断更新的多字段数据而不被撕裂。
+ *            写者在修改前后各把序号加一 (修改期间序号为奇数)，读者在拷贝前后各读一次序号，
+ *            两次不同或为奇数说明拷贝期间发生了写入，重新拷贝即可。写者从不等待读者。
+ *            使用限制：
+ *            - 读者不能打断写者 (读者的优先级不高于写者)，否则写入未完成时读者会一直重试；
+ *              典型用法是中断写、主循环读，或者读写都在主循环中；
+ *            - 多个写者之间需要互斥，主循环中的写者在写入期间关中断；
+ *            - 读者的拷贝只能是普通的内存读，不能有副作用。
+ *            读取的写法：
+ *            @code
+ *            uint32_t seq;
+ *            do {
+ *                seq = Seqlock_Read_Begin(&lock);
+ *                copy = shared;
+ *            } while (Seqlock_Read_Retry(&lock, seq));
+ *            @endcode
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __SEQLOCK_H
+#define __SEQLOCK_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup Seqlock 顺序锁
+ * @brief 无需关中断的多字段数据一致读取。
+ * @{
+ */
+
+/**
+ * @brief 顺序锁
+ */
+typedef struct {
+    volatile uint32_t seq; ///< 写入次数的两倍，写入期间为奇数
+} Seqlock_t;
+
+/**
+ * @brief 开始写入
+ * @param[in,out] sl 顺序锁
+ * @return 无
+ */
+__STATIC_INLINE void Seqlock_Write_Begin(Seqlock_t *sl)
+{
+    sl->seq++;
+    __DMB(); // 序号先变为奇数，再修改数据
+}
+
+/**
+ * @brief 结束写入
+ * @param[in,out] sl 顺序锁
+ * @return 无
+ */
+__STATIC_INLINE void Seqlock_Write_End(Seqlock_t *sl)
+{
+    __DMB(); // 数据全部写完，序号才变回偶数
+    sl->seq++;
+}
+
+/**
+ * @brief 开始读取
+ * @param[in] sl 顺序锁
+ * @return uint32_t 读取开始时的序号，传给 Seqlock_Read_Retry()
+ */
+__STATIC_INLINE uint32_t Seqlock_Read_Begin(const Seqlock_t *sl)
+{
+    uint32_t seq = sl->seq;
+    __DMB();
+    return seq;
+}
+
+/**
+ * @brief 判断读取期间是否发生了写入
+ * @param[in] sl 顺序锁
+ * @param[in] seq Seqlock_Read_Begin() 的返回值
+ * @return bool 需要重新读取返回 true
+ */
+__STATIC_INLINE bool Seqlock_Read_Retry(const Seqlock_t *sl, uint32_t seq)
+{
+    __DMB();
+    return (seq & 1U) != 0 || sl->seq != seq;
+}
+
+/** @} */
+
+#endif /* __SEQLOCK_H */
@@ -0,0 +1,220 @@
+/**
+ * @file      supply.c
+ * @brief     供电电压测量模块实现
+ * @details   转换序列为 SUPPLY_CONV 次通道17，采样时间取最长的 239.5 个 ADC 时钟 (Vrefint 要求不短于 17.1us)，
+ *            12MHz 下每次转换 21us，一次测量约 0.2ms；降频运行时 ADC 时钟随 PCLK2 降低，测量相应变长。
+ *            ADC 由 SWSTART 触发，两次测量之间 ADON 清零使 ADC 断电，上电后等待 tSTAB 再触发，
+ *            参考电压在断电期间保持使能，丢弃的第一次转换覆盖了它的建立时间。
+ *            DMA 每次测量前重新装入传输次数，传输完成中断中求和并交给主循环。
+ *            启用环境光采样 (LIGHT_ENABLE) 时 ADC1 由 light 模块持续采样，其序列中包含通道17，
+ *            本模块不再操作 ADC：Supply_Start() 直接取用参考电压读数的滑动平均并立即完成。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "supply.h"
+#include "light.h"
+#include "timebase.h"
+
+/**
+ * @addtogroup Supply
+ * @{
+ */
+
+#if SUPPLY_ENABLE
+
+/* Private defines -----------------------------------------------------------*/
+#define SUPPLY_OWN_ADC  (!LIGHT_ENABLE)       ///< ADC1 是否由本模块操作
+#define SUPPLY_CHANNEL  17U                   ///< 内部参考电压所在的通道
+#define SUPPLY_CONV     (SUPPLY_SAMPLES + 1U) ///< 转换序列的长度 (含丢弃的第一次)
+#define SUPPLY_STAB_US  2U                    ///< ADC 上电后到可以转换的等待时间 (手册 tSTAB 不超过 1us)
+#define SUPPLY_CAL_MS   2U                    ///< 校准的超时时间 (ms)，正常只需几微秒
+
+#if SUPPLY_CONV > 16
+#error "SUPPLY_SAMPLES must not exceed 15"
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+static volatile bool supply_busy;        ///< 测量进行中
+static volatile bool supply_ready;       ///< 有尚未取走的结果
+static volatile uint32_t supply_sum;     ///< 最近一次测量的有效转换之和
+
+#if SUPPLY_OWN_ADC
+static uint16_t supply_buf[SUPPLY_CONV]; ///< DMA 写入的转换结果
+
+/* Private function prototypes -----------------------------------------------*/
+void DMA1_Channel1_IRQHandler(void);
+static void supply_wait_clear(uint32_t bit);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 等待 ADC 的 CR2 中某一位被硬件清零
+ * @param[in] bit 等待的位 (ADC_CR2_RSTCAL 或 ADC_CR2_CAL)
+ * @return 无
+ */
+static void supply_wait_clear(uint32_t bit)
+{
+    uint32_t start = HAL_GetTick();
+
+    while ((ADC1->CR2 & bit) && HAL_GetTick() - start < SUPPLY_CAL_MS) {
+    }
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief DMA1 通道1中断：一次测量完成
+ * @details 先关闭 ADC 再求和，结果经 supply_ready 交给主循环。
+ * @return 无
+ */
+void DMA1_Channel1_IRQHandler(void)
+{
+    uint32_t sum = 0;
+
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+    ADC1->CR2 &= ~ADC_CR2_ADON;
+    for (uint8_t i = 1; i < SUPPLY_CONV; i++) {
+        sum += supply_buf[i];
+    }
+    supply_sum = sum;
+    supply_ready = true;
+    supply_busy = false;
+    Supply_Done_Callback();
+}
+
+#endif /* SUPPLY_OWN_ADC */
+
+#endif /* SUPPLY_ENABLE */
+
+/**
+ * @brief 初始化供电电压测量
+ * @return 无
+ */
+void Supply_Init(void)
+{
+#if SUPPLY_ENABLE && SUPPLY_OWN_ADC
+    uint32_t sqr[3] = {0, 0, 0}; // SQR3 (第1-6次)、SQR2 (第7-12次)、SQR1 (第13-16次)
+
+    __HAL_RCC_ADC1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_ADCPRE, RCC_CFGR_ADCPRE_DIV6); // ADC 时钟不得超过 14MHz
+
+    for (uint8_t i = 0; i < SUPPLY_CONV; i++) {
+        sqr[i / 6U] |= SUPPLY_CHANNEL << (5U * (i % 6U));
+    }
+    ADC1->CR1 = ADC_CR1_SCAN;
+    ADC1->SMPR1 = ADC_SMPR1_SMP17; // 239.5 个周期
+    ADC1->SQR3 = sqr[0];
+    ADC1->SQR2 = sqr[1];
+    ADC1->SQR1 = sqr[2] | ((SUPPLY_CONV - 1U) << ADC_SQR1_L_Pos);
+    ADC1->CR2 = ADC_CR2_TSVREFE | ADC_CR2_EXTTRIG | ADC_CR2_EXTSEL | ADC_CR2_DMA; // EXTSEL 全1为 SWSTART
+
+    // 校准前 ADC 须已上电至少两个 ADC 时钟周期
+    ADC1->CR2 |= ADC_CR2_ADON;
+    Timebase_Delay_Us(SUPPLY_STAB_US);
+    ADC1->CR2 |= ADC_CR2_RSTCAL;
+    supply_wait_clear(ADC_CR2_RSTCAL);
+    ADC1->CR2 |= ADC_CR2_CAL;
+    supply_wait_clear(ADC_CR2_CAL);
+    ADC1->CR2 &= ~ADC_CR2_ADON;
+
+    DMA1_Channel1->CCR = 0;
+    DMA1_Channel1->CPAR = (uint32_t)&ADC1->DR;
+    DMA1_Channel1->CMAR = (uint32_t)supply_buf;
+    DMA1_Channel1->CCR = DMA_CCR_MINC | DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 | DMA_CCR_TCIE;
+
+    HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, IRQ_PRIO_BACKGROUND, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+#endif
+}
+
+/**
+ * @brief 开始一次测量
+ * @return bool 已开始返回 true
+ */
+bool Supply_Start(void)
+{
+#if SUPPLY_ENABLE && !SUPPLY_OWN_ADC
+    uint16_t vref = Light_Get_Vrefint();
+
+    if (vref == 0) {
+        return false; // 第一个半区尚未完成
+    }
+    supply_sum = (uint32_t)vref * SUPPLY_SAMPLES;
+    supply_ready = true;
+    Supply_Done_Callback();
+    return true;
+#elif SUPPLY_ENABLE
+    if (supply_busy) {
+        return false;
+    }
+    supply_busy = true;
+
+    DMA1_Channel1->CCR &= ~DMA_CCR_EN; // 关闭通道后才能重新装入传输次数
+    DMA1_Channel1->CNDTR = SUPPLY_CONV;
+    DMA1_Channel1->CCR |= DMA_CCR_EN;
+
+    ADC1->CR2 |= ADC_CR2_ADON; // 从断电状态唤醒，此时不会开始转换
+    Timebase_Delay_Us(SUPPLY_STAB_US);
+    ADC1->CR2 |= ADC_CR2_SWSTART;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 取走最近一次完成的测量结果
+ * @param[out] mv 供电电压 (mV)
+ * @return bool 有新的结果返回 true
+ */
+bool Supply_Take(uint16_t *mv)
+{
+#if SUPPLY_ENABLE
+    uint32_t primask = __get_PRIMASK();
+    uint32_t sum;
+    bool ready;
+
+    __disable_irq();
+    ready = supply_ready;
+    sum = supply_sum;
+    supply_ready = false;
+    __set_PRIMASK(primask);
+
+    if (!ready || sum == 0) {
+        return false;
+    }
+    *mv = (uint16_t)((uint32_t)SUPPLY_VREFINT_MV * 4095U * SUPPLY_SAMPLES / sum);
+    return true;
+#else
+    (void)mv;
+    return false;
+#endif
+}
+
+/**
+ * @brief 是否正在测量
+ * @return bool 转换进行中返回 true
+ */
+bool Supply_Is_Busy(void)
+{
+#if SUPPLY_ENABLE
+    return supply_busy;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 测量完成时的回调
+ * @details 默认为空实现，应用层可重新定义。
+ * @return 无
+ */
+__weak void Supply_Done_Callback(void)
+{
+}
+
+/** @} */
@@ -0,0 +1,80 @@
+/**
+ * @file      supply.h
+ * @brief     供电电压测量模块头文件
+ * @details   通过 ADC1 的内部参考电压通道 (通道17，Vrefint 典型值 1.20V) 反推 VDD：
+ *            ADC 以 VDD 为参考，Vrefint 的读数越大说明 VDD 越低，VDD = Vrefint × 4095 / 读数。
+ *            每次测量由调用者 (软件定时器) 触发：ADC 上电后以扫描模式连续转换 SUPPLY_SAMPLES + 1 次通道17，
+ *            结果由 DMA1 通道1 搬入缓冲区，传输完成中断中关闭 ADC 并求和 (第一次转换在参考电压稳定前，丢弃)，
+ *            主循环取走结果后换算为毫伏。转换期间 CPU 不轮询，两次测量之间 ADC 断电。
+ *            ADC1 和 DMA1 通道1 不在 CubeMX 配置中，由本模块直接操作寄存器，中断服务函数也在本模块中；
+ *            启用环境光采样 (light.h) 时两者归 light 模块，测量改为取用它的参考电压读数。
+ *            适用于电池直接 (或经低压差稳压器) 给 VDD 供电的版本；稳压输出正常时读数恒定在稳压值附近。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __SUPPLY_H
+#define __SUPPLY_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup Supply 供电电压测量
+ * @brief 用内部参考电压通道测量 VDD，DMA 取回结果。
+ * @{
+ */
+
+/**
+ * @defgroup Supply_Config 供电电压测量配置
+ * @{
+ */
+#ifndef SUPPLY_ENABLE
+#define SUPPLY_ENABLE       1    ///< 为 1 时测量供电电压 (只用片内资源，不需要外部电路)
+#endif
+#define SUPPLY_VREFINT_MV   1200 ///< 内部参考电压 (mV)，F103 没有出厂校准值，手册给出 1.16~1.24V，可按实测修改
+#define SUPPLY_SAMPLES      8    ///< 每次测量平均的转换次数 (另有一次丢弃的转换，合计不超过16)
+/** @} */
+
+/**
+ * @brief 初始化供电电压测量
+ * @details 设置 ADC 时钟 (PCLK2 六分频，72MHz 时为 12MHz)、转换序列和 DMA，完成一次 ADC 校准后断电。
+ *          SUPPLY_ENABLE 为 0 时为空操作。
+ * @return 无
+ */
+void Supply_Init(void);
+
+/**
+ * @brief 开始一次测量
+ * @details 给 ADC 上电并由软件触发转换序列，立即返回，约 0.2ms (72MHz) 后在 DMA 中断中完成。
+ *          启用环境光采样时立即完成 (在本函数中调用 Supply_Done_Callback)。
+ * @return bool 已开始返回 true；上一次测量尚未完成或未启用时返回 false
+ */
+bool Supply_Start(void);
+
+/**
+ * @brief 取走最近一次完成的测量结果
+ * @param[out] mv 供电电压 (mV)
+ * @return bool 有新的结果返回 true
+ */
+bool Supply_Take(uint16_t *mv);
+
+/**
+ * @brief 是否正在测量
+ * @return bool 转换进行中返回 true，此时不能进入停止模式 (ADC 和 DMA 需要时钟)
+ */
+bool Supply_Is_Busy(void);
+
+/**
+ * @brief 测量完成时的回调
+ * @details 在 DMA 中断中 (启用环境光采样时在 Supply_Start 中) 调用，默认为空实现，应用层可重新定义以唤醒处理它的任务。
+ * @return 无
+ */
+void Supply_Done_Callback(void);
+
+/** @} */
+
+#endif /* __SUPPLY_H */
@@ -0,0 +1,327 @@
+/**
+ * @file      time_core.c
+ * @brief     基于纪元秒的时间与日历计算实现
+ * @details   日期换算使用 H. Hinnant 的 days-from-civil 公式：把每年的起点移到3月1日，
+ *            闰日落在一年的最后，月份天数可以用 (153*m+2)/5 直接求出，不需要逐月累加。
+ * @author    SandOcean
+ * @date      2025-09-24
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "time_core.h"
+#include <stddef.h> // For NULL
+
+/**
+ * @addtogroup TimeCore
+ * @{
+ */
+
+/* Private variables ---------------------------------------------------------*/
+#define TIME_DAYS_PER_ERA   146097U ///< 400年的天数
+#define TIME_EPOCH_OFFSET   730425U ///< 0000-03-01 到 2000-01-01 的天数
+
+/**
+ * @brief 内置的夏令时规则表
+ * @details 切换时刻均为该地区的本地时间，与芯片中保存的本地标准时间一致。
+ *          时区库 (Tools/tz_gen.py) 按序号引用这些规则，新规则只能追加在末尾。
+ */
+static const Time_Dst_Zone_t dst_zones[] = {
+    {"US", { 3, 2, 7, 2}, {11, 1, 7, 2}, 60}, ///< 北美：3月第二个周日 02:00 至 11月第一个周日 02:00
+    {"EU", { 3, 5, 7, 2}, {10, 5, 7, 3}, 60}, ///< 中欧：3月最后一个周日 02:00 至 10月最后一个周日 03:00
+    {"UK", { 3, 5, 7, 1}, {10, 5, 7, 2}, 60}, ///< 英国：3月最后一个周日 01:00 至 10月最后一个周日 02:00
+    {"AU", {10, 1, 7, 2}, { 4, 1, 7, 3}, 60}, ///< 澳大利亚东南部：10月第一个周日 02:00 至 4月第一个周日 03:00
+    {"NZ", { 9, 5, 7, 2}, { 4, 1, 7, 3}, 60}, ///< 新西兰：9月最后一个周日 02:00 至 4月第一个周日 03:00
+    {"EE", { 3, 5, 7, 3}, {10, 5, 7, 4}, 60}, ///< 东欧：3月最后一个周日 03:00 至 10月最后一个周日 04:00
+};
+
+#define DST_ZONE_COUNT (sizeof(dst_zones) / sizeof(dst_zones[0]))
+
+static Time_Dst_Cache_t dst_cache = { .zone = &dst_zones[TIME_DST_ZONE_DEFAULT] }; ///< 本地时间使用的夏令时缓存
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 计算某月第N个星期几对应的天数
+ * @param[in] year 年份
+ * @param[in] month 月份 (1-12)
+ * @param[in] week 第几个 (1~4)，5 表示最后一个
+ * @param[in] wday 星期 (1=周一, 7=周日)
+ * @return uint32_t 2000-01-01 起的天数
+ */
+static uint32_t nth_weekday_days(uint16_t year, uint8_t month, uint8_t week, uint8_t wday)
+{
+    uint32_t first = Time_Days_From_Civil(year, month, 1);
+    uint8_t day = 1 + (uint8_t)((wday + 7 - Time_Weekday_From_Days(first)) % 7) + (uint8_t)((week - 1) * 7);
+
+    if (day > Time_Days_In_Month(year, month)) {
+        day -= 7; // 第5个不存在时取最后一个
+    }
+    return first + day - 1;
+}
+
+/**
+ * @brief 计算某一年中切换规则对应的时刻
+ * @param[in] year 年份
+ * @param[in] rule 切换规则
+ * @return Epoch_t 切换时刻的纪元秒 (按规则中给出的本地时间)
+ */
+static Epoch_t rule_epoch(uint16_t year, const Time_Dst_Rule_t *rule)
+{
+    return nth_weekday_days(year, rule->month, rule->week, rule->wday) * TIME_SECS_PER_DAY + rule->hour * 3600U;
+}
+
+/**
+ * @brief 为给定时间所在的年份重新计算夏令时起止时刻
+ * @param[in,out] cache 缓存 (zone 不为 NULL)
+ * @param[in] epoch 标准时间的纪元秒
+ * @return 无
+ */
+static void dst_cache_update(Time_Dst_Cache_t *cache, Epoch_t epoch)
+{
+    const Time_Dst_Zone_t *zone = cache->zone;
+    uint16_t year;
+    uint8_t month, day;
+
+    Time_Civil_From_Days(epoch / TIME_SECS_PER_DAY, &year, &month, &day);
+
+    cache->year_start = Time_Days_From_Civil(year, 1, 1) * TIME_SECS_PER_DAY;
+    cache->year_end = Time_Days_From_Civil(year + 1, 1, 1) * TIME_SECS_PER_DAY;
+    cache->dst_start = rule_epoch(year, &zone->start);
+    // 结束时刻按夏令时给出，换算回标准时间
+    cache->dst_end = rule_epoch(year, &zone->end) - zone->offset_min * 60U;
+    cache->valid = true;
+}
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 判断是否为闰年
+ * @param[in] year 年份
+ * @return bool 是闰年返回 true
+ */
+bool Time_Is_Leap(uint16_t year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+}
+
+/**
+ * @brief 获取指定年份和月份的天数
+ * @param[in] year 年份
+ * @param[in] month 月份 (1-12)
+ * @return uint8_t 该月的天数
+ */
+uint8_t Time_Days_In_Month(uint16_t year, uint8_t month)
+{
+    static const uint8_t days_in_month[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    if (month == 2 && Time_Is_Leap(year)) {
+        return 29;
+    }
+    return days_in_month[(month - 1) % 12];
+}
+
+/**
+ * @brief 日期转换为纪元起的天数
+ * @param[in] year 年份 (不早于 TIME_EPOCH_YEAR)
+ * @param[in] month 月份 (1-12)
+ * @param[in] day 日期 (1-31)
+ * @return uint32_t 2000-01-01 起的天数
+ */
+uint32_t Time_Days_From_Civil(uint16_t year, uint8_t month, uint8_t day)
+{
+    uint32_t y = year - (month <= 2);                        // 1、2月算作上一年的最后两个月
+    uint32_t era = y / 400;
+    uint32_t yoe = y - era * 400;                            // [0, 399]
+    uint32_t mp = (month > 2) ? month - 3U : month + 9U;     // 从3月起算的月份 [0, 11]
+    uint32_t doy = (153 * mp + 2) / 5 + day - 1;             // [0, 365]
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;    // [0, 146096]
+
+    return era * TIME_DAYS_PER_ERA + doe - TIME_EPOCH_OFFSET;
+}
+
+/**
+ * @brief 纪元起的天数转换为日期
+ * @param[in] days 2000-01-01 起的天数
+ * @param[out] year 年份
+ * @param[out] month 月份 (1-12)
+ * @param[out] day 日期 (1-31)
+ * @return 无
+ */
+void Time_Civil_From_Days(uint32_t days, uint16_t *year, uint8_t *month, uint8_t *day)
+{
+    uint32_t z = days + TIME_EPOCH_OFFSET;
+    uint32_t era = z / TIME_DAYS_PER_ERA;
+    uint32_t doe = z - era * TIME_DAYS_PER_ERA;                               // [0, 146096]
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;    // [0, 399]
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                   // [0, 365]
+    uint32_t mp = (5 * doy + 2) / 153;                                        // [0, 11]
+    uint32_t m = (mp < 10) ? mp + 3 : mp - 9;
+
+    *day = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+    *month = (uint8_t)m;
+    *year = (uint16_t)(yoe + era * 400 + (m <= 2));
+}
+
+/**
+ * @brief 纪元起的天数对应的星期
+ * @param[in] days 2000-01-01 起的天数
+ * @return uint8_t 星期 (1=周一, 7=周日)
+ */
+uint8_t Time_Weekday_From_Days(uint32_t days)
+{
+    return (uint8_t)((days + 5) % 7 + 1); // 2000-01-01 为星期六
+}
+
+/**
+ * @brief 日历时间转换为纪元秒
+ * @param[in] time 日历时间
+ * @return Epoch_t 纪元秒
+ */
+Epoch_t Time_To_Epoch(const Time_t *time)
+{
+    return Time_Days_From_Civil(time->year, time->month, time->day) * TIME_SECS_PER_DAY
+         + time->hour * 3600U + time->minute * 60U + time->second;
+}
+
+/**
+ * @brief 纪元秒转换为日历时间
+ * @param[in] epoch 纪元秒
+ * @param[out] time 日历时间
+ * @return 无
+ */
+void Time_From_Epoch(Epoch_t epoch, Time_t *time)
+{
+    uint32_t days = epoch / TIME_SECS_PER_DAY;
+    uint32_t sod = epoch - days * TIME_SECS_PER_DAY;
+
+    time->hour = (uint8_t)(sod / 3600);
+    sod -= time->hour * 3600U;
+    time->minute = (uint8_t)(sod / 60);
+    time->second = (uint8_t)(sod - time->minute * 60U);
+    time->week = Time_Weekday_From_Days(days);
+    Time_Civil_From_Days(days, &time->year, &time->month, &time->day);
+}
+
+/**
+ * @brief 内置夏令时规则的数量
+ * @return uint8_t 规则数
+ */
+uint8_t Time_Dst_Zone_Count(void)
+{
+    return (uint8_t)DST_ZONE_COUNT;
+}
+
+/**
+ * @brief 按序号获取内置的夏令时规则
+ * @param[in] index 规则序号
+ * @return const Time_Dst_Zone_t* 规则，序号无效时返回默认规则
+ */
+const Time_Dst_Zone_t *Time_Dst_Get_Zone(uint8_t index)
+{
+    return &dst_zones[(index < DST_ZONE_COUNT) ? index : TIME_DST_ZONE_DEFAULT];
+}
+
+/**
+ * @brief 选择当前使用的夏令时规则
+ * @param[in] index 规则序号，无效时使用 TIME_DST_ZONE_DEFAULT
+ * @return 无
+ */
+void Time_Dst_Select_Zone(uint8_t index)
+{
+    const Time_Dst_Zone_t *zone = Time_Dst_Get_Zone(index);
+
+    if (zone != dst_cache.zone) {
+        dst_cache.zone = zone;
+        dst_cache.valid = false;
+    }
+}
+
+/**
+ * @brief 判断标准时间是否处在夏令时区间内
+ * @param[in] std_epoch 标准时间 (未应用夏令时) 的纪元秒
+ * @return bool 处在夏令时区间内返回 true
+ */
+bool Time_In_Dst(Epoch_t std_epoch)
+{
+    return Time_Dst_Cache_In(&dst_cache, std_epoch);
+}
+
+/**
+ * @brief 初始化一个独立的夏令时缓存
+ * @param[out] cache 缓存
+ * @param[in] index 规则序号，TIME_DST_ZONE_NONE 为不使用夏令时
+ * @return 无
+ */
+void Time_Dst_Cache_Init(Time_Dst_Cache_t *cache, uint8_t index)
+{
+    cache->zone = (index == TIME_DST_ZONE_NONE) ? NULL : Time_Dst_Get_Zone(index);
+    cache->valid = false;
+}
+
+/**
+ * @brief 按独立的缓存判断标准时间是否处在夏令时区间内
+ * @param[in,out] cache 缓存
+ * @param[in] std_epoch 该地区标准时间的纪元秒
+ * @return bool 处在夏令时区间内返回 true
+ */
+bool Time_Dst_Cache_In(Time_Dst_Cache_t *cache, Epoch_t std_epoch)
+{
+    if (cache->zone == NULL) {
+        return false;
+    }
+    if (!cache->valid || std_epoch < cache->year_start || std_epoch >= cache->year_end) {
+        dst_cache_update(cache, std_epoch);
+    }
+    if (cache->dst_start < cache->dst_end) {
+        return std_epoch >= cache->dst_start && std_epoch < cache->dst_end;
+    }
+    return std_epoch >= cache->dst_start || std_epoch < cache->dst_end; // 南半球：跨越年底
+}
+
+/**
+ * @brief 获取包含给定时间、夏令时状态不变的区间
+ * @param[in,out] cache 缓存
+ * @param[in] std_epoch 该地区标准时间的纪元秒
+ * @param[out] from 区间起点 (含)
+ * @param[out] until 区间终点 (不含)
+ * @return 无
+ */
+void Time_Dst_Cache_Span(Time_Dst_Cache_t *cache, Epoch_t std_epoch, Epoch_t *from, Epoch_t *until)
+{
+    Epoch_t edge[2];
+
+    if (cache->zone == NULL) {
+        *from = 0;
+        *until = 0xFFFFFFFFU;
+        return;
+    }
+    (void)Time_Dst_Cache_In(cache, std_epoch); // 使缓存覆盖 std_epoch 所在的年份
+    *from = cache->year_start;
+    *until = cache->year_end;
+    edge[0] = cache->dst_start;
+    edge[1] = cache->dst_end;
+    for (uint8_t i = 0; i < 2; i++) {
+        if (edge[i] <= std_epoch && edge[i] > *from) {
+            *from = edge[i];
+        } else if (edge[i] > std_epoch && edge[i] < *until) {
+            *until = edge[i];
+        }
+    }
+}
+
+/**
+ * @brief 对标准时间应用夏令时规则
+ * @param[in] std_epoch 标准时间的纪元秒
+ * @param[in] dst_enabled 是否启用夏令时
+ * @return Epoch_t 本地时间的纪元秒
+ */
+Epoch_t Time_Apply_Dst(Epoch_t std_epoch, bool dst_enabled)
+{
+    if (dst_enabled && Time_In_Dst(std_epoch)) {
+        return std_epoch + dst_cache.zone->offset_min * 60U;
+    }
+    return std_epoch;
+}
+
+/** @} */
@@ -0,0 +1,222 @@
+/**
+ * @file      time_core.h
+ * @brief     基于纪元秒的时间与日历计算头文件
+ * @details   以 2000-01-01 00:00:00 起的32位秒数 (Epoch_t) 表示时间，可覆盖到 2136 年。
+ *            日期与天数之间用不含循环的公式互相换算 (days-from-civil)，
+ *            夏令时的起止时刻按"某月第N个星期几"的规则计算，规则在运行时从内置的地区表中选择，
+ *            每年 (或切换规则后) 只计算一次并缓存，之后判断夏令时和加上偏移都只是整数比较和加法。
+ * @author    SandOcean
+ * @date      2025-09-24
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __TIME_CORE_H
+#define __TIME_CORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup TimeCore 时间核心
+ * @brief 提供了纪元秒与日历时间的换算以及夏令时规则。
+ * @{
+ */
+
+/**
+ * @defgroup TimeCore_Config 时间核心配置
+ * @{
+ */
+#define TIME_EPOCH_YEAR    2000  ///< 纪元起点年份 (该年1月1日为星期六)
+#define TIME_SECS_PER_DAY  86400 ///< 每天的秒数
+/** @} */
+
+/**
+ * @defgroup DST_Config 夏令时配置
+ * @{
+ */
+#define TIME_DST_ZONE_DEFAULT 0    ///< 默认使用的夏令时规则 (北美)
+#define TIME_DST_ZONE_NONE    0xFF ///< 不使用夏令时 (用于 Time_Dst_Cache_Init)
+/** @} */
+
+/**
+ * @brief 纪元秒，2000-01-01 00:00:00 起的秒数
+ */
+typedef uint32_t Epoch_t;
+
+/**
+ * @brief 时间结构体定义
+ * @details 用于存储和传递年、月、日、时、分、秒、星期等时间信息
+ */
+typedef struct {
+    uint8_t hour;    ///< 小时 (0-23)
+    uint8_t minute;  ///< 分钟 (0-59)
+    uint8_t second;  ///< 秒 (0-59)
+    uint16_t year;   ///< 年份 (2000-2099)
+    uint8_t month;   ///< 月份 (1-12)
+    uint8_t day;     ///< 日期 (1-31)
+    uint8_t week;    ///< 星期 (1=周一, 7=周日)
+} Time_t;
+
+/**
+ * @brief 夏令时切换规则：某月的第N个星期几的某一时刻
+ */
+typedef struct {
+    uint8_t month;  ///< 月份 (1-12)
+    uint8_t week;   ///< 第几个 (1~4)，5 表示该月最后一个
+    uint8_t wday;   ///< 星期 (1=周一, 7=周日)
+    uint8_t hour;   ///< 切换时刻，按切换前正在使用的本地时间 (开始为标准时间，结束为夏令时)
+} Time_Dst_Rule_t;
+
+/**
+ * @brief 一个地区的夏令时规则
+ * @details 南半球地区的开始月份晚于结束月份，夏令时跨越年底。
+ */
+typedef struct {
+    const char *name;      ///< 显示名称
+    Time_Dst_Rule_t start; ///< 夏令时开始
+    Time_Dst_Rule_t end;   ///< 夏令时结束
+    uint8_t offset_min;    ///< 夏令时的偏移量 (分钟)
+} Time_Dst_Zone_t;
+
+/**
+ * @brief 夏令时起止时刻的缓存
+ * @details 保存一整年的范围和该年的两个切换时刻，时间仍在该年内时不必重新计算。
+ *          每个需要独立判断夏令时的地区 (如世界时钟中的城市) 各用一个。
+ */
+typedef struct {
+    const Time_Dst_Zone_t *zone; ///< 使用的规则，为 NULL 时不使用夏令时
+    bool valid;                  ///< 缓存是否有效
+    Epoch_t year_start;          ///< 该年1月1日 00:00 的纪元秒
+    Epoch_t year_end;            ///< 下一年1月1日 00:00 的纪元秒
+    Epoch_t dst_start;           ///< 夏令时开始时刻 (标准时间)
+    Epoch_t dst_end;             ///< 夏令时结束时刻 (标准时间)
+} Time_Dst_Cache_t;
+
+/**
+ * @brief 判断是否为闰年
+ * @param[in] year 年份
+ * @return bool 是闰年返回 true
+ */
+bool Time_Is_Leap(uint16_t year);
+
+/**
+ * @brief 获取指定年份和月份的天数
+ * @param[in] year 年份
+ * @param[in] month 月份 (1-12)
+ * @return uint8_t 该月的天数
+ */
+uint8_t Time_Days_In_Month(uint16_t year, uint8_t month);
+
+/**
+ * @brief 日期转换为纪元起的天数
+ * @param[in] year 年份 (不早于 TIME_EPOCH_YEAR)
+ * @param[in] month 月份 (1-12)
+ * @param[in] day 日期 (1-31)
+ * @return uint32_t 2000-01-01 起的天数
+ */
+uint32_t Time_Days_From_Civil(uint16_t year, uint8_t month, uint8_t day);
+
+/**
+ * @brief 纪元起的天数转换为日期
+ * @param[in] days 2000-01-01 起的天数
+ * @param[out] year 年份
+ * @param[out] month 月份 (1-12)
+ * @param[out] day 日期 (1-31)
+ * @return 无
+ */
+void Time_Civil_From_Days(uint32_t days, uint16_t *year, uint8_t *month, uint8_t *day);
+
+/**
+ * @brief 纪元起的天数对应的星期
+ * @param[in] days 2000-01-01 起的天数
+ * @return uint8_t 星期 (1=周一, 7=周日)
+ */
+uint8_t Time_Weekday_From_Days(uint32_t days);
+
+/**
+ * @brief 日历时间转换为纪元秒
+ * @details 忽略 week 字段。
+ * @param[in] time 日历时间
+ * @return Epoch_t 纪元秒
+ */
+Epoch_t Time_To_Epoch(const Time_t *time);
+
+/**
+ * @brief 纪元秒转换为日历时间
+ * @details 同时计算星期。
+ * @param[in] epoch 纪元秒
+ * @param[out] time 日历时间
+ * @return 无
+ */
+void Time_From_Epoch(Epoch_t epoch, Time_t *time);
+
+/**
+ * @brief 内置夏令时规则的数量
+ * @return uint8_t 规则数
+ */
+uint8_t Time_Dst_Zone_Count(void);
+
+/**
+ * @brief 按序号获取内置的夏令时规则
+ * @param[in] index 规则序号
+ * @return const Time_Dst_Zone_t* 规则，序号无效时返回默认规则
+ */
+const Time_Dst_Zone_t *Time_Dst_Get_Zone(uint8_t index);
+
+/**
+ * @brief 选择当前使用的夏令时规则
+ * @details 缓存的切换时刻随之失效，下一次判断时按新规则重新计算。
+ * @param[in] index 规则序号，无效时使用 TIME_DST_ZONE_DEFAULT
+ * @return 无
+ */
+void Time_Dst_Select_Zone(uint8_t index);
+
+/**
+ * @brief 判断标准时间是否处在夏令时区间内
+ * @details 起止时刻按年缓存，同一年内只需两次比较。
+ * @param[in] std_epoch 标准时间 (未应用夏令时) 的纪元秒
+ * @return bool 处在夏令时区间内返回 true
+ */
+bool Time_In_Dst(Epoch_t std_epoch);
+
+/**
+ * @brief 初始化一个独立的夏令时缓存
+ * @details 切换时刻在第一次判断时计算。
+ * @param[out] cache 缓存
+ * @param[in] index 规则序号，TIME_DST_ZONE_NONE 为不使用夏令时，其他无效值使用 TIME_DST_ZONE_DEFAULT
+ * @return 无
+ */
+void Time_Dst_Cache_Init(Time_Dst_Cache_t *cache, uint8_t index);
+
+/**
+ * @brief 按独立的缓存判断标准时间是否处在夏令时区间内
+ * @param[in,out] cache 缓存，时间不在缓存的年份内时重新计算
+ * @param[in] std_epoch 该地区标准时间的纪元秒
+ * @return bool 处在夏令时区间内返回 true，不使用夏令时的缓存总是返回 false
+ */
+bool Time_Dst_Cache_In(Time_Dst_Cache_t *cache, Epoch_t std_epoch);
+
+/**
+ * @brief 获取包含给定时间、夏令时状态不变的区间
+ * @details 区间的端点为年初、年底和该年的两个切换时刻，调用者可以在区间内直接复用判断结果。
+ *          不使用夏令时的缓存返回整个纪元范围。
+ * @param[in,out] cache 缓存
+ * @param[in] std_epoch 该地区标准时间的纪元秒
+ * @param[out] from 区间起点 (含)
+ * @param[out] until 区间终点 (不含)
+ * @return 无
+ */
+void Time_Dst_Cache_Span(Time_Dst_Cache_t *cache, Epoch_t std_epoch, Epoch_t *from, Epoch_t *until);
+
+/**
+ * @brief 对标准时间应用夏令时规则
+ * @param[in] std_epoch 标准时间的纪元秒
+ * @param[in] dst_enabled 是否启用夏令时
+ * @return Epoch_t 本地时间的纪元秒
+ */
+Epoch_t Time_Apply_Dst(Epoch_t std_epoch, bool dst_enabled);
+
+/** @} */
+
+#endif /* __TIME_CORE_H */
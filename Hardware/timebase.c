@@ -0,0 +1,59 @@
+/**
+ * @file      timebase.c
+ * @brief     微秒时基
+ * @details   SysTick 从 LOAD 向下计数到0时重载并使 uwTick 加一。读取时先后读 uwTick 和 VAL，
+ *            uwTick 在两次读取之间变化则重读；在关中断或更高优先级的中断中调用时
+ *            SysTick 中断可能挂起未执行，此时按挂起标志补上这一毫秒。
+ * @author    SandOcean
+ * @date      2025-10-02
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "timebase.h"
+
+/**
+ * @addtogroup Timebase
+ * @{
+ */
+
+/* Function implementations --------------------------------------------------*/
+
+uint32_t Timebase_Read(uint32_t *us)
+{
+    uint32_t ms;
+    uint32_t val;
+    uint32_t load = SysTick->LOAD;
+
+    do {
+        ms = uwTick;
+        val = SysTick->VAL;
+        // 重载已经发生但滴答中断还没执行 (计数值刚从 LOAD 开始)
+        if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) && val > load / 2) {
+            ms++;
+        }
+    } while (ms != uwTick && !(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk));
+
+    if (us != NULL) {
+        *us = ms * 1000U + (load - val) * 1000U / (load + 1U);
+    }
+    return ms;
+}
+
+uint32_t Timebase_Us(void)
+{
+    uint32_t us;
+
+    Timebase_Read(&us);
+    return us;
+}
+
+void Timebase_Delay_Us(uint32_t us)
+{
+    uint32_t start = Timebase_Us();
+
+    while (Timebase_Us() - start < us) {
+    }
+}
+
+/** @} */
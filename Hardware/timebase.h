@@ -0,0 +1,49 @@
+/**
+ * @file      timebase.h
+ * @brief     微秒时基头文件
+ * @details   以 HAL 的毫秒滴答 (uwTick) 加上 SysTick 当前计数值得到32位的微秒时间戳，约71.6分钟回绕一次。
+ *            不占用额外的定时器；停止模式后 app_power 补回 uwTick 时微秒时基一起补回，
+ *            因此与 HAL_GetTick() 始终一致 (Timebase_Us() / 1000 在回绕之前等于 HAL_GetTick())。
+ * @author    SandOcean
+ * @date      2025-10-02
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __TIMEBASE_H
+#define __TIMEBASE_H
+
+#include "main.h"
+#include <stdint.h>
+
+/**
+ * @defgroup Timebase 微秒时基
+ * @brief 提供了与 HAL_GetTick() 一致的微秒时间戳和短延时。
+ * @{
+ */
+
+/**
+ * @brief 同时读取毫秒和微秒时间戳
+ * @details 两个值取自同一时刻，可在中断中调用。
+ * @param[out] us 微秒时间戳，可为 NULL
+ * @return uint32_t 毫秒时间戳 (与 HAL_GetTick() 相同)
+ */
+uint32_t Timebase_Read(uint32_t *us);
+
+/**
+ * @brief 读取微秒时间戳
+ * @return uint32_t 微秒时间戳，比较时使用无符号差值
+ */
+uint32_t Timebase_Us(void);
+
+/**
+ * @brief 忙等待指定的微秒数
+ * @details 精度约1us，用于外设时序要求的短延时；较长的等待请用 HAL_Delay() 或非阻塞的方式。
+ * @param[in] us 等待的微秒数
+ * @return 无
+ */
+void Timebase_Delay_Us(uint32_t us);
+
+/** @} */
+
+#endif /* __TIMEBASE_H */
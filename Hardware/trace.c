@@ -0,0 +1,191 @@
+/**
+ * @file      trace.c
+ * @brief     二进制事件跟踪模块
+ * @details   trace_head 是已预留的记录数，trace_tail 是已发送的记录数，两者只增不减，取模后得到槽位。
+ *            记录方用 LDREX/STREX 原子地预留槽位后再填写内容；发送只在主循环中进行，
+ *            此时被它打断过的中断都已返回，[tail, head) 中的记录必然已经填写完整。
+ *            帧格式：0x00 + COBS(负载) + 0x00，负载 =
+ *            | 0xF0 (1) | 序号 (1) | 累计丢弃数低16位 (2) | 记录 x n (8n) | Fletcher-16 (2) |，
+ *            记录 = | DWT时间戳 (4) | 事件 (2) | 参数 (2) |，均为小端。
+ *            帧前多发一个 0x00，把之前的 printf 文本与帧分开，主机按 0x00 切分后文本段解码失败，原样显示即可。
+ * @author    SandOcean
+ * @date      2025-09-24
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "trace.h"
+
+#if TRACE_ENABLE
+
+#include "cobs.h"
+#include "uart.h"
+#include <string.h>
+
+/**
+ * @addtogroup Trace
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define TRACE_FRAME_TAG     0xF0                                        ///< 跟踪帧的类型字节 (不与远程控制的应答冲突)
+#define TRACE_HEADER_SIZE   4                                           ///< 类型 + 序号 + 丢弃数
+#define TRACE_PAYLOAD_MAX   (TRACE_HEADER_SIZE + 8 * TRACE_DRAIN_BATCH + 2) ///< 最长的负载
+
+/** 编译期检查：槽位取模用位与实现 */
+typedef char trace_capacity_check[((TRACE_CAPACITY & (TRACE_CAPACITY - 1)) == 0) ? 1 : -1];
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 一条跟踪记录
+ */
+typedef struct {
+    uint32_t ts;  ///< DWT->CYCCNT
+    uint16_t ev;  ///< 事件 (Trace_Event_e)
+    uint16_t arg; ///< 参数
+} Trace_Rec_t;
+
+/** 编译期检查：每条记录8字节，按内存布局直接发送 */
+typedef char trace_rec_size_check[(sizeof(Trace_Rec_t) == 8) ? 1 : -1];
+
+/* Private variables ---------------------------------------------------------*/
+static Trace_Rec_t trace_buf[TRACE_CAPACITY];     ///< 记录环形缓冲区
+static volatile uint32_t trace_head;              ///< 已预留的记录数
+static volatile uint32_t trace_tail;              ///< 已发送的记录数
+static volatile uint32_t trace_dropped;           ///< 因缓冲区已满丢弃的记录数
+static uint32_t trace_dropped_sent;               ///< 最近一帧报告的丢弃数
+static uint8_t trace_seq;                         ///< 帧序号，主机据此发现丢失的帧
+static uint8_t trace_payload[TRACE_PAYLOAD_MAX];  ///< 正在组装的负载
+static uint8_t trace_frame[COBS_ENCODED_MAX(TRACE_PAYLOAD_MAX) + 2]; ///< 编码后的帧 (含前后分隔符)
+
+/* Private function prototypes -----------------------------------------------*/
+static void Trace_Atomic_Inc(volatile uint32_t *v);
+static uint16_t Trace_Checksum(const uint8_t *data, uint16_t len);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 原子地加一
+ * @param[in,out] v 计数器
+ * @return 无
+ */
+static void Trace_Atomic_Inc(volatile uint32_t *v)
+{
+    uint32_t x;
+
+    do {
+        x = __LDREXW(v);
+    } while (__STREXW(x + 1, v) != 0);
+}
+
+/**
+ * @brief 计算 Fletcher-16 校验和
+ * @param[in] data 数据
+ * @param[in] len 长度
+ * @return uint16_t 校验和 (高8位为第二个累加和)
+ */
+static uint16_t Trace_Checksum(const uint8_t *data, uint16_t len)
+{
+    uint16_t a = 0;
+    uint16_t b = 0;
+
+    while (len--) {
+        a = (uint16_t)((a + *data++) % 255);
+        b = (uint16_t)((b + a) % 255);
+    }
+    return (uint16_t)((b << 8) | a);
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 记录一个事件
+ * @details 时间戳在预留槽位之前读取，嵌套的中断可能使相邻记录的时间戳略有倒序，主机按时间戳排序即可。
+ * @param[in] ev 事件
+ * @param[in] arg 参数
+ * @return 无
+ */
+void Trace_Record(Trace_Event_e ev, uint16_t arg)
+{
+    uint32_t ts = DWT->CYCCNT;
+    uint32_t idx;
+    Trace_Rec_t *rec;
+
+    do {
+        idx = __LDREXW(&trace_head);
+        if (idx - trace_tail >= TRACE_CAPACITY) {
+            __CLREX();
+            Trace_Atomic_Inc(&trace_dropped);
+            return;
+        }
+    } while (__STREXW(idx + 1, &trace_head) != 0);
+
+    rec = &trace_buf[idx & (TRACE_CAPACITY - 1)];
+    rec->ts = ts;
+    rec->ev = (uint16_t)ev;
+    rec->arg = arg;
+}
+
+/**
+ * @brief 初始化跟踪模块并启动 DWT 周期计数器
+ * @return 无
+ */
+void Trace_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    trace_head = 0;
+    trace_tail = 0;
+    trace_dropped = 0;
+    trace_dropped_sent = 0;
+    trace_seq = 0;
+}
+
+/**
+ * @brief 跟踪维护函数，需在主循环中周期调用
+ * @return 无
+ */
+void Trace_Service(void)
+{
+    uint32_t tail = trace_tail;
+    uint32_t count = trace_head - tail;
+    uint32_t dropped = trace_dropped;
+    uint16_t len = TRACE_HEADER_SIZE;
+    uint16_t sum;
+    uint16_t frame_len;
+
+    if ((count == 0 && dropped == trace_dropped_sent) || !UART_Printf_Is_Idle()) {
+        return;
+    }
+    if (count > TRACE_DRAIN_BATCH) {
+        count = TRACE_DRAIN_BATCH;
+    }
+
+    trace_payload[0] = TRACE_FRAME_TAG;
+    trace_payload[1] = trace_seq;
+    trace_payload[2] = (uint8_t)dropped;
+    trace_payload[3] = (uint8_t)(dropped >> 8);
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(&trace_payload[len], &trace_buf[(tail + i) & (TRACE_CAPACITY - 1)], sizeof(Trace_Rec_t));
+        len += sizeof(Trace_Rec_t);
+    }
+    sum = Trace_Checksum(trace_payload, len);
+    trace_payload[len++] = (uint8_t)sum;
+    trace_payload[len++] = (uint8_t)(sum >> 8);
+
+    trace_frame[0] = 0x00;
+    frame_len = (uint16_t)(1 + COBS_Encode(trace_payload, len, &trace_frame[1]));
+    trace_frame[frame_len++] = 0x00;
+
+    if (UART_Write(trace_frame, frame_len)) {
+        trace_tail = tail + count; // 发送缓冲区已保存一份副本，槽位可以释放
+        trace_dropped_sent = dropped;
+        trace_seq++;
+    }
+}
+
+/** @} */
+
+#endif /* TRACE_ENABLE */
@@ -0,0 +1,107 @@
+/**
+ * @file      trace.h
+ * @brief     二进制事件跟踪模块头文件
+ * @details   在 RAM 环形缓冲区中记录 (DWT 时间戳, 事件, 参数)，每条 8 字节，记录一条只需十几个周期，
+ *            可以放在中断和绘制的热路径中而不影响时序。主循环在串口空闲时把记录打包成
+ *            COBS 帧经 uart.c 的 DMA 发送，由 Tools/trace_decode.py 在主机上解码。
+ *            缓冲区满时丢弃新记录并计数，已记录的内容不会被覆盖。
+ *            TRACE_ENABLE 为 0 时所有跟踪点展开为空。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.2
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup Trace 事件跟踪
+ * @brief 提供了低开销的二进制事件记录功能。
+ * @{
+ */
+
+/**
+ * @defgroup Trace_Config 事件跟踪配置
+ * @{
+ */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE       0          ///< 为 1 时编入跟踪功能 (默认关闭，串口上会出现二进制帧)
+#endif
+#define TRACE_CAPACITY     256        ///< 环形缓冲区的记录数，必须是2的幂
+#define TRACE_DRAIN_BATCH  16         ///< 每帧最多发送的记录数
+#define TRACE_EVENT_MASK   0xFFFFFFFFUL ///< 按事件编号启用的位掩码，用于屏蔽过于频繁的事件
+/** @} */
+
+/**
+ * @brief 跟踪事件
+ * @note 编号即为帧中的事件字段，Tools/trace_decode.py 从本枚举读取事件名，新增事件时请显式写出编号。
+ */
+typedef enum {
+    TRACE_EV_FRAME_BEGIN = 0, ///< Page_Manager_Loop 开始
+    TRACE_EV_FRAME_END   = 1, ///< Page_Manager_Loop 结束
+    TRACE_EV_INPUT_SCAN  = 2, ///< 输入扫描定时器中断，参数为待处理的编码器步数
+    TRACE_EV_I2C_START   = 3, ///< I2C 事务开始，参数为设备地址
+    TRACE_EV_I2C_DONE    = 4, ///< I2C 事务结束，参数低8位为设备地址，高8位为 HAL 状态
+    TRACE_EV_DISP_BEGIN  = 5, ///< 开始向屏幕发送一帧
+    TRACE_EV_DISP_END    = 6, ///< 一帧发送完成
+    TRACE_EV_RTC_SQW     = 7, ///< DS3231 SQW 秒脉冲
+    TRACE_EV_IDLE_BEGIN  = 8, ///< 进入低功耗等待
+    TRACE_EV_IDLE_END    = 9, ///< 退出低功耗等待
+    TRACE_EV_STACK_HWM   = 10, ///< 主栈最大使用量增加，参数为新的使用量 (字节)
+    TRACE_EV_HEAP_HWM    = 11, ///< 堆最大使用量增加，参数为新的使用量 (字节)
+    TRACE_EV_CLOCK       = 12, ///< 系统时钟已切换，参数为新的频率 (MHz)，之后的时间戳按新频率计数
+    TRACE_EV_I2C_UTIL    = 13, ///< 每秒一次的I2C设备总线利用率，参数低8位为设备地址，高8位为利用率 (%)
+    TRACE_EV_I2C_RECOVER = 14, ///< I2C总线恢复，参数低8位为发出的 SCL 脉冲数，高8位为1表示 SDA 已释放
+    TRACE_EV_I2C_DEGRADE = 15, ///< I2C设备降级后又一次失败，参数低8位为设备地址，高8位为连续失败次数
+    TRACE_EV_RADIO_FRAME = 16, ///< 收到一帧授时信号，参数为 0 校验失败、1 有效但未写入、2 已写入RTC
+    TRACE_EV_POWER_FAIL  = 17, ///< 供电电压低于掉电检测阈值
+    TRACE_EV_JANK        = 18, ///< 一帧超出忙碌时间预算 (profiler.h)，参数为帧序号低16位，之后是几条 JANK_CAUSE
+    TRACE_EV_JANK_CAUSE  = 19, ///< 卡顿的原因，参数高4位为 Profiler_Jank_e (0xF 为忙碌时间)，低12位为耗时 (0.1ms)
+    TRACE_EV_COUNT
+} Trace_Event_e;
+
+#if TRACE_ENABLE
+
+/**
+ * @brief 记录一个事件
+ * @details 可在任意上下文 (包括嵌套的中断) 中调用，用 LDREX/STREX 预留槽位，不关中断。
+ * @param[in] ev 事件
+ * @param[in] arg 参数
+ * @return 无
+ */
+void Trace_Record(Trace_Event_e ev, uint16_t arg);
+
+/**
+ * @brief 记录一个跟踪事件，未在 TRACE_EVENT_MASK 中启用的事件在编译期被去掉
+ */
+#define TRACE(ev, arg) do { if (TRACE_EVENT_MASK & (1UL << (ev))) { Trace_Record((ev), (uint16_t)(arg)); } } while (0)
+
+/**
+ * @brief 初始化跟踪模块并启动 DWT 周期计数器
+ * @return 无
+ */
+void Trace_Init(void);
+
+/**
+ * @brief 跟踪维护函数，需在主循环中周期调用
+ * @details 只在串口发送缓冲区为空时发送一帧，不与其他输出争抢。
+ * @return 无
+ */
+void Trace_Service(void);
+
+#else
+
+#define TRACE(ev, arg)   do { } while (0)
+#define Trace_Init()     do { } while (0)
+#define Trace_Service()  do { } while (0)
+
+#endif /* TRACE_ENABLE */
+
+/** @} */
+
+#endif /* __TRACE_H */
@@ -1,6 +1,7 @@
 #include "uart.h"
 #include "stdio.h"
 #include "usart.h"
+#include "usb_cdc.h"
 #include "string.h"
 
 #ifdef __GNUC__
@@ -10,42 +11,144 @@
 #endif /* __GNUC__ */
 
 // 静态变量定义
-static uint8_t printf_buffer[PRINTF_DMA_BUFFER_SIZE];
-static volatile uint16_t buffer_index = 0; 
-static volatile uint8_t dma_busy = 0;       
+// 发送环形缓冲区：[tx_tail, tx_tail + tx_dma_len) 正在由DMA发送，[tx_tail + tx_dma_len, tx_head) 等待发送。
+// 写入方只移动 tx_head，发送完成回调只移动 tx_tail，DMA正在读取的部分不会被覆盖。
+// USB 虚拟串口打开时同一个缓冲区改由批量 IN 传输发送，tx_dma_len 为正在传输的长度，
+// 切换时正在进行的一段在原来的端口上发完，之后的数据从新端口发出。
+static uint8_t tx_ring[PRINTF_DMA_BUFFER_SIZE];
+static volatile uint16_t tx_head = 0;
+static volatile uint16_t tx_tail = 0;
+static volatile uint16_t tx_dma_len = 0;
+static volatile uint32_t tx_dropped = 0;
+static uint8_t rx_ring[UART_RX_RING_SIZE];
+static volatile uint16_t rx_usb_head = 0; // USB 虚拟串口打开时由收包回调移动的写入位置 (USART1 接收DMA已停止)
+static volatile uint8_t rx_events = 0;
+static volatile uint16_t rx_idle_pos = 0; // 最近一次总线空闲时DMA的写入位置 (USART1)
+static volatile uint32_t rx_idle_ms = 0;  // 最近一次总线空闲的 HAL_GetTick() 时间戳
+static volatile uint8_t rx_idle_seen = 0; // 是否检测到过总线空闲
+
+#define UART_RX_WAKE_LINE GPIO_PIN_10 // RX (PA10) 所在的 EXTI 线
+
+void EXTI15_10_IRQHandler(void);
 
 /**
-  * @brief  初始化UART printf DMA发送
+  * @brief  进入临界区：屏蔽 IRQ_PRIO_SERIAL 及更低优先级的中断
+  * @note   缓冲区只与 USART1/DMA/USB 的回调共享，它们都在 IRQ_PRIO_SERIAL 一级；
+  *         按键扫描、I2C 和显示器的中断不受影响，不会因打印而推迟。
+  *         因此本文件的函数只能在主循环或不高于 IRQ_PRIO_SERIAL 的中断中调用
   * @param  None
+  * @retval 进入前的 BASEPRI，交给 Uart_Unlock 恢复
+  */
+static uint32_t Uart_Lock(void)
+{
+    uint32_t basepri = __get_BASEPRI();
+
+    __set_BASEPRI_MAX(IRQ_PRIO_SERIAL << (8U - __NVIC_PRIO_BITS)); // 只会提高屏蔽级别，嵌套调用是安全的
+    __DSB();
+    __ISB();
+    return basepri;
+}
+
+/**
+  * @brief  退出临界区
+  * @param  basepri: Uart_Lock 的返回值
   * @retval None
   */
-void UART_Printf_Init(void)
+static void Uart_Unlock(uint32_t basepri)
 {
-    buffer_index = 0;
-    dma_busy = 0;
-    memset(printf_buffer, 0, PRINTF_DMA_BUFFER_SIZE);
+    __set_BASEPRI(basepri);
 }
 
 /**
-  * @brief  刷新缓冲区，使用DMA发送数据 (增加了临界区保护)
+  * @brief  发送缓冲区中已使用的字节数
+  * @param  None
+  * @retval 已使用的字节数 (含正在发送的部分)
+  */
+static uint16_t Tx_Used(void)
+{
+    return (uint16_t)((tx_head + PRINTF_DMA_BUFFER_SIZE - tx_tail) % PRINTF_DMA_BUFFER_SIZE);
+}
+
+/**
+  * @brief  DMA空闲时发送下一段连续的数据
+  * @note   必须在临界区 (Uart_Lock) 或发送完成回调中调用。数据跨越缓冲区末尾时先发送到末尾，
+  *         剩下的部分由发送完成回调接着发送
   * @param  None
   * @retval None
   */
-void UART_Printf_Flush(void)
+static void Tx_Kick(void)
 {
-    // 进入临界区，防止在检查和启动DMA之间被中断
-    __disable_irq();
+    uint16_t head = tx_head;
+    uint16_t len;
+
+    if (tx_dma_len != 0 || head == tx_tail)
+    {
+        return;
+    }
 
-    if (buffer_index > 0 && !dma_busy)
+    len = (head > tx_tail) ? (uint16_t)(head - tx_tail) : (uint16_t)(PRINTF_DMA_BUFFER_SIZE - tx_tail);
+    tx_dma_len = len;
+    if (USB_CDC_Is_Open())
+    {
+        if (!USB_CDC_Transmit(&tx_ring[tx_tail], len))
+        {
+            tx_dma_len = 0;
+        }
+    }
+    else if (huart1.hdmatx == NULL)
     {
-        dma_busy = 1;
-        // 注意：HAL_UART_Transmit_DMA本身会处理DMA和中断的配置，
-        // 我们只需保护我们自己的状态变量。
-        HAL_UART_Transmit_DMA(&huart1, printf_buffer, buffer_index);
-        buffer_index = 0; // DMA启动后，逻辑缓冲区可以清空
+        if (HAL_UART_Transmit_IT(&huart1, &tx_ring[tx_tail], len) != HAL_OK)
+        {
+            tx_dma_len = 0; // DMA 通道让给了其他外设 (双总线版本的 I2C2)，逐字节中断发送
+        }
     }
-    
-    __enable_irq(); // 退出临界区
+    else if (HAL_UART_Transmit_DMA(&huart1, &tx_ring[tx_tail], len) != HAL_OK)
+    {
+        tx_dma_len = 0; // 由下一次写入或刷新重试
+    }
+}
+
+/**
+  * @brief  释放刚发送完的一段，并接着发送剩下的数据 (包括绕回缓冲区开头的部分)
+  * @note   在 USART1 DMA 或 USB 的发送完成回调中调用
+  * @param  None
+  * @retval None
+  */
+static void Tx_Done(void)
+{
+    tx_tail = (uint16_t)((tx_tail + tx_dma_len) % PRINTF_DMA_BUFFER_SIZE);
+    tx_dma_len = 0;
+    Tx_Kick();
+}
+
+/**
+  * @brief  初始化UART printf DMA发送
+  * @param  None
+  * @retval None
+  */
+void UART_Printf_Init(void)
+{
+    uint32_t basepri = Uart_Lock();
+    if (tx_dma_len == 0)
+    {
+        tx_head = 0;
+        tx_tail = 0;
+    }
+    tx_dropped = 0;
+    Uart_Unlock(basepri);
+}
+
+/**
+  * @brief  启动发送缓冲区中等待的数据
+  * @param  None
+  * @retval None
+  */
+void UART_Printf_Flush(void)
+{
+    // 进入临界区，防止在检查和启动DMA之间被发送完成回调打断
+    uint32_t basepri = Uart_Lock();
+    Tx_Kick();
+    Uart_Unlock(basepri); // 退出临界区
 }
 
 /**
@@ -55,43 +158,267 @@ void UART_Printf_Flush(void)
   */
 void UART_Printf_DeInit(void)
 {
-    // 等待DMA发送完成
-    while (dma_busy)
+    // 等待缓冲区中的数据全部发送完成
+    UART_Printf_Flush();
+    while (!UART_Printf_Is_Idle())
     {
         HAL_Delay(1);
     }
-    buffer_index = 0;
-    dma_busy = 0;
+}
+
+/**
+  * @brief  查询printf缓冲区是否已全部发送完毕
+  * @param  None
+  * @retval 1: 没有待发送的数据且DMA空闲; 0: 仍有数据在发送
+  */
+uint8_t UART_Printf_Is_Idle(void)
+{
+    return (tx_head == tx_tail && tx_dma_len == 0) ? 1 : 0;
+}
+
+/**
+  * @brief  查询因缓冲区已满而未能写入的字节数
+  * @param  None
+  * @retval 自初始化以来丢弃的字节数
+  */
+uint32_t UART_Printf_Dropped(void)
+{
+    return tx_dropped;
+}
+
+/**
+  * @brief  把一段数据整体写入发送缓冲区并启动发送 (不阻塞)
+  * @note   空间不足时整段都不写入，因此一段数据 (如一帧协议应答) 要么完整发送，
+  *         要么完全不发送，不会被截断或与其他输出交错
+  * @param  data: 数据，写入后即可释放
+  * @param  len: 长度
+  * @retval 1: 已全部写入; 0: 空间不足，未写入
+  */
+uint8_t UART_Write(const uint8_t *data, uint16_t len)
+{
+    uint16_t head;
+    uint16_t first;
+    uint32_t basepri = Uart_Lock();
+
+    // 保留一个字节区分空和满
+    if (len > PRINTF_DMA_BUFFER_SIZE - 1 - Tx_Used())
+    {
+        tx_dropped += len;
+        Uart_Unlock(basepri);
+        return 0;
+    }
+
+    head = tx_head;
+    first = (uint16_t)(PRINTF_DMA_BUFFER_SIZE - head);
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(&tx_ring[head], data, first);
+    memcpy(tx_ring, data + first, len - first);
+    tx_head = (uint16_t)((head + len) % PRINTF_DMA_BUFFER_SIZE);
+    Tx_Kick();
+
+    Uart_Unlock(basepri);
+    return 1;
+}
+
+/**
+  * @brief  系统时钟改变后按新的 PCLK2 重新设置波特率
+  * @note   应在发送空闲时调用，切换瞬间正在接收的一个字节可能出错
+  * @param  None
+  * @retval None
+  */
+void UART_Clock_Changed(void)
+{
+    huart1.Instance->BRR = UART_BRR_SAMPLING16(HAL_RCC_GetPCLK2Freq(), huart1.Init.BaudRate);
+}
+
+/**
+  * @brief  启动DMA循环接收
+  * @note   DMA 一直在 rx_ring 中循环写入，读取方自己记录读到的位置，
+  *         总线空闲时产生 UART_RX_EVENT_DATA 事件，不需要逐字节中断
+  * @param  None
+  * @retval None
+  */
+void UART_Rx_Start(void)
+{
+    if (USB_CDC_Is_Open())
+    {
+        return; // 由 USB 收包回调写入，串口关闭后再启动
+    }
+    if (HAL_UARTEx_ReceiveToIdle_DMA(&huart1, rx_ring, UART_RX_RING_SIZE) == HAL_OK)
+    {
+        // 半满事件对按帧解析没有意义，只保留空闲和写满一圈的事件
+        __HAL_DMA_DISABLE_IT(huart1.hdmarx, DMA_IT_HT);
+    }
+}
+
+/**
+  * @brief  获取接收环形缓冲区
+  * @note   DMA 已写过、读取方尚未释放的部分可以由读取方原地修改 (如原地解码)
+  * @param  None
+  * @retval 缓冲区首地址，长度为 UART_RX_RING_SIZE
+  */
+uint8_t *UART_Rx_Ring(void)
+{
+    return rx_ring;
+}
+
+/**
+  * @brief  获取DMA下一个要写入的位置
+  * @param  None
+  * @retval 写入位置 (0 ~ UART_RX_RING_SIZE-1)
+  */
+uint16_t UART_Rx_Head(void)
+{
+    if (USB_CDC_Is_Open())
+    {
+        return rx_usb_head;
+    }
+    return (uint16_t)((UART_RX_RING_SIZE - __HAL_DMA_GET_COUNTER(huart1.hdmarx)) % UART_RX_RING_SIZE);
+}
+
+/**
+  * @brief  取出并清除接收事件
+  * @param  None
+  * @retval UART_RX_EVENT_xxx 的组合
+  */
+uint8_t UART_Rx_Take_Events(void)
+{
+    uint8_t events;
+
+    uint32_t basepri = Uart_Lock();
+    events = rx_events;
+    rx_events = 0;
+    Uart_Unlock(basepri);
+    return events;
+}
+
+/**
+  * @brief  获取最近一次总线空闲的时刻
+  * @note   空闲在一帧的最后一个字节之后再过一个字符时间被检测到，时间戳在中断中记录，
+  *         与主循环何时处理这一帧无关。用于按帧的结束时刻推算发送方开始发送的时刻 (时间信标)。
+  * @param  pos: 输出空闲时DMA的写入位置 (该帧最后一个字节之后)
+  * @param  ms: 输出空闲时的 HAL_GetTick() 时间戳
+  * @retval 1: 有记录; 0: 还没有空闲事件或正在使用 USB 虚拟串口 (没有字符时序)
+  */
+uint8_t UART_Rx_Idle_Stamp(uint16_t *pos, uint32_t *ms)
+{
+    uint32_t basepri;
+    uint8_t seen;
+
+    if (USB_CDC_Is_Open())
+    {
+        return 0;
+    }
+    basepri = Uart_Lock();
+    *pos = rx_idle_pos;
+    *ms = rx_idle_ms;
+    seen = rx_idle_seen;
+    Uart_Unlock(basepri);
+    return seen;
+}
+
+/**
+  * @brief  获取一个字符 (起始位 + 8 数据位 + 停止位) 在线上的时间
+  * @param  None
+  * @retval 微秒数 (115200 波特时为 87)
+  */
+uint16_t UART_Char_Us(void)
+{
+    return (uint16_t)((10UL * 1000000UL + huart1.Init.BaudRate / 2U) / huart1.Init.BaudRate);
+}
+
+/**
+  * @brief  把 RX 线设为停止模式的唤醒源
+  * @note   引脚保持 USART1 的输入配置，只在 EXTI10 上选择 PA10 并打开下降沿中断 (起始位)。
+  *         接收 DMA 保持循环模式不动：睡眠模式中照常写入，停止模式中暂停，唤醒后从原来的位置继续。
+  *         USB 虚拟串口打开时不使用 USART1，不设置。须在关中断后、进入停止模式之前调用
+  * @param  None
+  * @retval None
+  */
+void UART_Rx_Wake_Arm(void)
+{
+    if (USB_CDC_Is_Open())
+    {
+        return;
+    }
+    MODIFY_REG(AFIO->EXTICR[2], AFIO_EXTICR3_EXTI10, AFIO_EXTICR3_EXTI10_PA);
+    SET_BIT(EXTI->FTSR, UART_RX_WAKE_LINE);
+    CLEAR_BIT(EXTI->RTSR, UART_RX_WAKE_LINE);
+    EXTI->PR = UART_RX_WAKE_LINE;
+    HAL_NVIC_ClearPendingIRQ(EXTI15_10_IRQn);
+    HAL_NVIC_SetPriority(EXTI15_10_IRQn, IRQ_PRIO_SERIAL, 0);
+    HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+    SET_BIT(EXTI->IMR, UART_RX_WAKE_LINE);
+}
+
+/**
+  * @brief  撤销 RX 线的唤醒，并查询停止模式是否由它唤醒
+  * @note   须在唤醒后恢复系统时钟之后调用。由 RX 唤醒时产生 UART_RX_EVENT_WAKE：
+  *         时钟恢复期间 (HSE 起振和 PLL 锁定) 到达的字节已丢失，之后的字节照常由 DMA 接收。
+  *         EXTI 中断在唤醒后保持挂起，这里一并清除
+  * @param  None
+  * @retval 1: 由 RX 线唤醒; 0: 由其他唤醒源唤醒
+  */
+uint8_t UART_Rx_Wake_Disarm(void)
+{
+    uint8_t woke;
+
+    CLEAR_BIT(EXTI->IMR, UART_RX_WAKE_LINE);
+    woke = (EXTI->PR & UART_RX_WAKE_LINE) != 0 ? 1 : 0;
+    EXTI->PR = UART_RX_WAKE_LINE;
+    HAL_NVIC_ClearPendingIRQ(EXTI15_10_IRQn);
+    if (woke)
+    {
+        rx_events |= UART_RX_EVENT_WAKE;
+    }
+    return woke;
+}
+
+/**
+  * @brief  EXTI10 (RX 唤醒) 中断处理函数
+  * @note   唤醒源在 UART_Rx_Wake_Disarm 中处理，这里只清除撤销之前线上又出现的边沿
+  * @param  None
+  * @retval None
+  */
+void EXTI15_10_IRQHandler(void)
+{
+    EXTI->PR = UART_RX_WAKE_LINE;
 }
 
 /**
   * @brief  重定向 C 库函数 printf 到 USART (非阻塞版本)
+  * @note   字符先进入发送缓冲区，遇到换行或缓冲区过半时才启动发送，
+  *         以便把一行合并成一次DMA传输；缓冲区满时丢弃该字符并计数
   * @param  ch: 要发送的字符
-  * @retval 发送的字符
+  * @retval 发送的字符，缓冲区已满时返回 -1
   */
 PUTCHAR_PROTOTYPE
 {
-    // 如果缓冲区满了，则丢弃该字符 (或者返回错误)
-    // 这是非阻塞设计的常见策略
-    if (buffer_index >= PRINTF_DMA_BUFFER_SIZE)
+    uint8_t c = (uint8_t)ch;
+    uint8_t ok;
+    uint32_t basepri = Uart_Lock();
+
+    ok = (Tx_Used() < PRINTF_DMA_BUFFER_SIZE - 1) ? 1 : 0;
+    if (ok)
     {
-        // 可以选择在这里触发一次刷新，尝试清空缓冲区
-        UART_Printf_Flush();
-        return -1; // 表示失败
+        tx_ring[tx_head] = c;
+        tx_head = (uint16_t)((tx_head + 1) % PRINTF_DMA_BUFFER_SIZE);
     }
-    
-    // 进入临界区，保护 buffer_index
-    __disable_irq();
-    printf_buffer[buffer_index++] = (uint8_t)ch;
-    __enable_irq();
-    
-    // 如果是换行符，或者缓冲区半满，可以触发一次刷新
-    if (ch == '\n' || buffer_index >= PRINTF_DMA_BUFFER_SIZE / 2)
+    else
     {
-        UART_Printf_Flush();
+        tx_dropped++;
     }
-    
-    return ch;
+
+    if (c == '\n' || Tx_Used() >= PRINTF_DMA_BUFFER_SIZE / 2)
+    {
+        Tx_Kick();
+    }
+
+    Uart_Unlock(basepri);
+    return ok ? ch : -1;
 }
 
 /**
@@ -103,12 +430,94 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 {
     if (huart->Instance == USART1)
     {
-        dma_busy = 0;  // 清除DMA忙标志
+        Tx_Done();
     }
 }
 
+/**
+  * @brief  UART 空闲/接收事件回调函数
+  * @param  huart: UART句柄指针
+  * @param  Size: DMA当前写入的位置
+  * @retval None
+  */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    if (huart->Instance == USART1)
+    {
+        if (huart->RxEventType == HAL_UART_RXEVENT_IDLE)
+        {
+            rx_idle_pos = (uint16_t)(Size % UART_RX_RING_SIZE);
+            rx_idle_ms = HAL_GetTick();
+            rx_idle_seen = 1;
+        }
+        rx_events |= UART_RX_EVENT_DATA;
+    }
+}
 
+/**
+  * @brief  UART 错误回调函数
+  * @note   溢出、噪声等错误会让 HAL 停止DMA接收，在这里重新启动
+  * @param  huart: UART句柄指针
+  * @retval None
+  */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART1 && huart->RxState == HAL_UART_STATE_READY)
+    {
+        UART_Rx_Start();
+        rx_events |= UART_RX_EVENT_RESET;
+    }
+}
 
+/**
+  * @brief  USB 虚拟串口打开或关闭
+  * @note   打开时停止 USART1 的DMA接收，之后由收包回调从环形缓冲区开头写入；关闭时重新启动DMA接收。
+  *         两种情况下都产生 UART_RX_EVENT_RESET，读取方丢弃未处理的数据，从头开始读取
+  * @param  open: 打开为 true
+  * @retval None
+  */
+void USB_CDC_Open_Callback(bool open)
+{
+    if (open)
+    {
+        (void)HAL_UART_AbortReceive(&huart1);
+        rx_usb_head = 0;
+    }
+    else
+    {
+        UART_Rx_Start();
+    }
+    rx_events |= UART_RX_EVENT_RESET;
+}
 
+/**
+  * @brief  USB 收包回调函数
+  * @note   与DMA循环接收相同，写满一圈后覆盖最早的数据
+  * @param  data: 数据
+  * @param  len: 长度
+  * @retval None
+  */
+void USB_CDC_Rx_Callback(const uint8_t *data, uint16_t len)
+{
+    uint16_t head = rx_usb_head;
+    uint16_t first = (uint16_t)(UART_RX_RING_SIZE - head);
 
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(&rx_ring[head], data, first);
+    memcpy(rx_ring, data + first, len - first);
+    rx_usb_head = (uint16_t)((head + len) % UART_RX_RING_SIZE);
+    rx_events |= UART_RX_EVENT_DATA;
+}
 
+/**
+  * @brief  USB 发送完成回调函数
+  * @param  None
+  * @retval None
+  */
+void USB_CDC_Tx_Cplt_Callback(void)
+{
+    Tx_Done();
+}
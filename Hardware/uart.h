@@ -3,12 +3,38 @@
 
 #include "main.h"
 
-// DMA发送缓冲区大小
-#define PRINTF_DMA_BUFFER_SIZE 256
+// 所有输出 (printf、UART_Write) 和接收环形缓冲区都经过本模块。USB 虚拟串口 (usb_cdc) 被主机打开时
+// 收发都切换到 USB，关闭或拔掉电缆后切回 USART1，调用方不需要区分。
+
+// DMA发送环形缓冲区大小 (可写入 PRINTF_DMA_BUFFER_SIZE-1 字节)
+#define PRINTF_DMA_BUFFER_SIZE 512
+
+// DMA循环接收缓冲区大小
+#define UART_RX_RING_SIZE 256
+
+// UART_Rx_Take_Events 返回的事件
+#define UART_RX_EVENT_DATA  0x01  // 收到了新数据 (总线空闲、半满或写满一圈)
+#define UART_RX_EVENT_RESET 0x02  // 接收出错后已重新启动或切换了端口，环形缓冲区从头开始写入
+#define UART_RX_EVENT_WAKE  0x04  // 停止模式被 RX 线 (PA10) 的下降沿唤醒，时钟恢复之前线上的字节已丢失
 
 // 函数声明
 void UART_Printf_Init(void);
 void UART_Printf_Flush(void);
 void UART_Printf_DeInit(void);
+uint8_t UART_Printf_Is_Idle(void);
+uint32_t UART_Printf_Dropped(void);
+uint8_t UART_Write(const uint8_t *data, uint16_t len);
+void UART_Clock_Changed(void);
+
+void UART_Rx_Start(void);
+uint8_t *UART_Rx_Ring(void);
+uint16_t UART_Rx_Head(void);
+uint8_t UART_Rx_Take_Events(void);
+uint8_t UART_Rx_Idle_Stamp(uint16_t *pos, uint32_t *ms);
+uint16_t UART_Char_Us(void);
+
+// 停止模式中 USART1 和 DMA 都没有时钟，进入前把 RX 线作为 EXTI10 下降沿唤醒源，唤醒后撤销
+void UART_Rx_Wake_Arm(void);
+uint8_t UART_Rx_Wake_Disarm(void);
 
 #endif
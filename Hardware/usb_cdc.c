@@ -0,0 +1,592 @@
+/**
+ * @file      usb_cdc.c
+ * @brief     USB CDC 虚拟串口实现
+ * @details   HAL PCD 只负责端点的包收发，标准请求和 CDC 类请求在 HAL 的回调中直接处理：
+ *            - 控制端点的 IN 数据阶段由本文件逐包发送 (HAL 不自动续传端点0)，
+ *              应答比请求的长度短且是包长的整数倍时补发零长度包；
+ *            - SET_ADDRESS 的新地址由 HAL 在状态阶段完成后生效；
+ *            - SET_CONFIGURATION 时打开三个端点：批量 OUT 0x01 (单缓冲，主机下发的命令很短)、
+ *              批量 IN 0x82 (双缓冲，占用该端点的两个缓冲区描述符，因此与 OUT 使用不同的端点号)、
+ *              中断 IN 0x83 (只为满足 CDC-ACM 的描述符要求，不发送通知)。
+ *            PMA 共 512 字节：缓冲区描述符表 32 字节 (4个端点)，其后依次为各端点的缓冲区。
+ *            所有回调都在 USB 中断中执行，与 USART1/DMA 中断同为最高优先级，彼此不会嵌套。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "usb_cdc.h"
+#include "usb.h"
+#include <stddef.h>
+
+/**
+ * @addtogroup USB_CDC
+ * @{
+ */
+
+/* Private defines -----------------------------------------------------------*/
+#define CDC_OUT_EP    0x01U ///< 批量 OUT 端点
+#define CDC_IN_EP     0x82U ///< 批量 IN 端点 (双缓冲)
+#define CDC_NOTIFY_EP 0x83U ///< 中断 IN 端点
+
+#define PMA_EP0_OUT   0x020U ///< 端点0 OUT 缓冲区
+#define PMA_EP0_IN    0x060U ///< 端点0 IN 缓冲区
+#define PMA_OUT       0x0A0U ///< 批量 OUT 缓冲区
+#define PMA_IN_0      0x0E0U ///< 批量 IN 缓冲区0
+#define PMA_IN_1      0x120U ///< 批量 IN 缓冲区1
+#define PMA_NOTIFY    0x160U ///< 中断 IN 缓冲区
+
+#define STR_MAX_CHARS 16U    ///< 字符串描述符的最大字符数
+
+#define LO(x) ((uint8_t)((x) & 0xFFU))        ///< 16位数的低字节
+#define HI(x) ((uint8_t)(((x) >> 8) & 0xFFU)) ///< 16位数的高字节
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 控制传输的阶段
+ */
+typedef enum {
+    EP0_IDLE = 0,  ///< 等待 SETUP (或主机的状态阶段)
+    EP0_DATA_IN,   ///< 正在发送数据阶段
+    EP0_DATA_OUT,  ///< 正在接收数据阶段 (SET_LINE_CODING)
+    EP0_STATUS_IN  ///< 正在发送状态阶段的零长度包
+} Ep0_State_e;
+
+/* Private variables ---------------------------------------------------------*/
+
+/**
+ * @brief 设备描述符
+ */
+static const uint8_t dev_desc[18] = {
+    18, 0x01, 0x00, 0x02,        // bLength, DEVICE, bcdUSB 2.00
+    0x02, 0x00, 0x00,            // bDeviceClass CDC
+    USB_CDC_PACKET,              // bMaxPacketSize0
+    LO(USB_CDC_VID), HI(USB_CDC_VID),
+    LO(USB_CDC_PID), HI(USB_CDC_PID),
+    0x00, 0x02,                  // bcdDevice 2.00
+    1, 2, 3,                     // iManufacturer, iProduct, iSerialNumber
+    1                            // bNumConfigurations
+};
+
+/**
+ * @brief 配置描述符 (包括接口、CDC 功能和端点描述符)
+ */
+static const uint8_t cfg_desc[67] = {
+    9, 0x02, 67, 0x00, 2, 1, 0, 0x80, USB_CDC_MAX_POWER_MA / 2U,
+    // 接口0：通信接口 (ACM)
+    9, 0x04, 0, 0, 1, 0x02, 0x02, 0x01, 0,
+    5, 0x24, 0x00, 0x10, 0x01,   // Header, bcdCDC 1.10
+    5, 0x24, 0x01, 0x00, 1,      // Call Management，数据接口为1
+    4, 0x24, 0x02, 0x02,         // ACM：支持 Line Coding 和 Control Line State
+    5, 0x24, 0x06, 0, 1,         // Union：主接口0，从接口1
+    7, 0x05, CDC_NOTIFY_EP, 0x03, USB_CDC_NOTIFY_PACKET, 0x00, 16,
+    // 接口1：数据接口
+    9, 0x04, 1, 0, 2, 0x0A, 0x00, 0x00, 0,
+    7, 0x05, CDC_OUT_EP, 0x02, USB_CDC_PACKET, 0x00, 0,
+    7, 0x05, CDC_IN_EP, 0x02, USB_CDC_PACKET, 0x00, 0
+};
+
+static const uint8_t lang_desc[4] = {4, 0x03, 0x09, 0x04}; ///< 语言ID：英语 (美国)
+
+static uint8_t ep0_buf[2 + STR_MAX_CHARS * 2U];   ///< 字符串描述符和短应答的缓冲区
+static uint8_t line_coding[7] = {0x00, 0xC2, 0x01, 0x00, 0, 0, 8}; ///< 115200 8N1，只保存主机的设置
+static uint8_t rx_pkt[USB_CDC_PACKET];            ///< 批量 OUT 的接收缓冲区
+
+static Ep0_State_e ep0_state = EP0_IDLE;  ///< 控制传输的阶段
+static const uint8_t *ep0_ptr;            ///< 数据阶段下一个包的位置
+static uint16_t ep0_left;                 ///< 数据阶段剩余的字节数
+static bool ep0_zlp;                      ///< 数据阶段结束后是否需要补发零长度包
+
+static volatile bool cdc_active;      ///< 总线活动 (已复位、未挂起)
+static volatile bool cdc_configured;  ///< 主机已选择配置1
+static volatile bool cdc_dtr;         ///< 主机置位了 DTR
+static volatile bool cdc_open;        ///< 串口已打开
+static volatile bool tx_busy;         ///< 批量 IN 传输进行中
+static bool tx_zlp;                   ///< 当前传输结束后是否需要补发零长度包
+
+/* Private function prototypes -----------------------------------------------*/
+static void ep0_send(const uint8_t *data, uint16_t len, uint16_t w_length);
+static void ep0_in_next(void);
+static void ep0_status_in(void);
+static void ep0_stall(void);
+static uint16_t string_desc(uint8_t index);
+static void cdc_set_configuration(uint8_t config);
+static void cdc_update_open(void);
+static bool std_request(const uint8_t *s, uint16_t w_value, uint16_t w_length);
+static bool class_request(const uint8_t *s, uint16_t w_value, uint16_t w_length);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 开始控制传输的 IN 数据阶段
+ * @param[in] data 应答数据，须在传输期间保持有效
+ * @param[in] len 应答长度
+ * @param[in] w_length 主机请求的长度，应答截断到此长度
+ * @return 无
+ */
+static void ep0_send(const uint8_t *data, uint16_t len, uint16_t w_length)
+{
+    if (w_length == 0) {
+        ep0_status_in();
+        return;
+    }
+    if (len > w_length) {
+        len = w_length;
+    }
+    ep0_ptr = data;
+    ep0_left = len;
+    ep0_zlp = len < w_length && len % USB_CDC_PACKET == 0;
+    ep0_state = EP0_DATA_IN;
+    ep0_in_next();
+}
+
+/**
+ * @brief 端点0 IN 完成后发送下一个包
+ * @details 数据阶段发完后准备接收主机的状态阶段；状态阶段发完后回到空闲。
+ * @return 无
+ */
+static void ep0_in_next(void)
+{
+    uint16_t n;
+
+    if (ep0_state == EP0_STATUS_IN) {
+        ep0_state = EP0_IDLE;
+        return;
+    }
+    if (ep0_state != EP0_DATA_IN) {
+        return;
+    }
+    if (ep0_left == 0 && !ep0_zlp) {
+        ep0_state = EP0_IDLE;
+        (void)HAL_PCD_EP_Receive(&hpcd_USB_FS, 0x00, NULL, 0);
+        return;
+    }
+
+    n = (ep0_left > USB_CDC_PACKET) ? USB_CDC_PACKET : ep0_left;
+    if (n < USB_CDC_PACKET) {
+        ep0_zlp = false; // 短包 (包括零长度包) 本身就结束了数据阶段
+    }
+    (void)HAL_PCD_EP_Transmit(&hpcd_USB_FS, 0x80, (uint8_t *)ep0_ptr, n);
+    ep0_ptr += n;
+    ep0_left -= n;
+}
+
+/**
+ * @brief 发送状态阶段的零长度包
+ * @return 无
+ */
+static void ep0_status_in(void)
+{
+    ep0_state = EP0_STATUS_IN;
+    (void)HAL_PCD_EP_Transmit(&hpcd_USB_FS, 0x80, NULL, 0);
+}
+
+/**
+ * @brief 不支持的请求，使端点0返回 STALL (下一个 SETUP 自动解除)
+ * @return 无
+ */
+static void ep0_stall(void)
+{
+    ep0_state = EP0_IDLE;
+    (void)HAL_PCD_EP_SetStall(&hpcd_USB_FS, 0x80);
+    (void)HAL_PCD_EP_SetStall(&hpcd_USB_FS, 0x00);
+}
+
+/**
+ * @brief 在 ep0_buf 中生成字符串描述符
+ * @details 序列号取芯片唯一ID三个字的异或，显示为8位十六进制数，同一块板子每次枚举都相同。
+ * @param[in] index 字符串索引 (1~3)
+ * @return uint16_t 描述符长度，不支持的索引返回0
+ */
+static uint16_t string_desc(uint8_t index)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char serial[9];
+    const char *s;
+    uint8_t n = 0;
+
+    switch (index) {
+        case 1:
+            s = "SandOcean";
+            break;
+        case 2:
+            s = "Table Clock";
+            break;
+        case 3: {
+            uint32_t uid = HAL_GetUIDw0() ^ HAL_GetUIDw1() ^ HAL_GetUIDw2();
+            for (uint8_t i = 0; i < 8; i++) {
+                serial[i] = hex[(uid >> (28 - i * 4)) & 0x0FU];
+            }
+            serial[8] = '\0';
+            s = serial;
+            break;
+        }
+        default:
+            return 0;
+    }
+
+    while (s[n] != '\0' && n < STR_MAX_CHARS) {
+        ep0_buf[2 + n * 2] = (uint8_t)s[n];
+        ep0_buf[3 + n * 2] = 0;
+        n++;
+    }
+    ep0_buf[0] = (uint8_t)(2 + n * 2);
+    ep0_buf[1] = 0x03;
+    return ep0_buf[0];
+}
+
+/**
+ * @brief 选择配置，打开或关闭数据端点
+ * @param[in] config 配置值，1 打开，0 关闭
+ * @return 无
+ */
+static void cdc_set_configuration(uint8_t config)
+{
+    PCD_HandleTypeDef *hpcd = &hpcd_USB_FS;
+
+    if (config != 0 && !cdc_configured) {
+        (void)HAL_PCDEx_PMAConfig(hpcd, CDC_OUT_EP, PCD_SNG_BUF, PMA_OUT);
+        (void)HAL_PCDEx_PMAConfig(hpcd, CDC_IN_EP, PCD_DBL_BUF, PMA_IN_0 | (PMA_IN_1 << 16));
+        (void)HAL_PCDEx_PMAConfig(hpcd, CDC_NOTIFY_EP, PCD_SNG_BUF, PMA_NOTIFY);
+        (void)HAL_PCD_EP_Open(hpcd, CDC_OUT_EP, USB_CDC_PACKET, EP_TYPE_BULK);
+        (void)HAL_PCD_EP_Open(hpcd, CDC_IN_EP, USB_CDC_PACKET, EP_TYPE_BULK);
+        (void)HAL_PCD_EP_Open(hpcd, CDC_NOTIFY_EP, USB_CDC_NOTIFY_PACKET, EP_TYPE_INTR);
+        (void)HAL_PCD_EP_Receive(hpcd, CDC_OUT_EP, rx_pkt, USB_CDC_PACKET);
+        cdc_configured = true;
+    } else if (config == 0 && cdc_configured) {
+        cdc_configured = false;
+        cdc_update_open(); // 先放弃进行中的传输，再关闭端点
+        (void)HAL_PCD_EP_Close(hpcd, CDC_OUT_EP);
+        (void)HAL_PCD_EP_Close(hpcd, CDC_IN_EP);
+        (void)HAL_PCD_EP_Close(hpcd, CDC_NOTIFY_EP);
+    }
+    cdc_update_open();
+}
+
+/**
+ * @brief 按当前状态更新串口是否打开，变化时通知
+ * @details 先清除打开标志再结束被放弃的传输，发送完成回调中接着启动的发送不会再进入本端口。
+ * @return 无
+ */
+static void cdc_update_open(void)
+{
+    bool open = cdc_active && cdc_configured && cdc_dtr;
+
+    if (open == cdc_open) {
+        return;
+    }
+    cdc_open = open;
+    if (!open) {
+        tx_zlp = false;
+        if (tx_busy) {
+            tx_busy = false;
+            USB_CDC_Tx_Cplt_Callback();
+        }
+    }
+    USB_CDC_Open_Callback(open);
+}
+
+/**
+ * @brief 处理标准请求
+ * @param[in] s SETUP 包
+ * @param[in] w_value wValue
+ * @param[in] w_length wLength
+ * @return bool 已处理返回 true，不支持返回 false
+ */
+static bool std_request(const uint8_t *s, uint16_t w_value, uint16_t w_length)
+{
+    uint8_t recipient = s[0] & 0x1FU;
+
+    switch (s[1]) {
+        case 0x00: // GET_STATUS
+            ep0_buf[0] = 0;
+            ep0_buf[1] = 0;
+            ep0_send(ep0_buf, 2, w_length);
+            return true;
+        case 0x01: // CLEAR_FEATURE
+        case 0x03: // SET_FEATURE
+            if (recipient == 0x02 && w_value == 0 && (s[4] & 0x7FU) != 0) { // ENDPOINT_HALT
+                if (s[1] == 0x03) {
+                    (void)HAL_PCD_EP_SetStall(&hpcd_USB_FS, s[4]);
+                } else {
+                    (void)HAL_PCD_EP_ClrStall(&hpcd_USB_FS, s[4]);
+                }
+            }
+            ep0_status_in(); // 远程唤醒不支持，忽略即可
+            return true;
+        case 0x05: // SET_ADDRESS，状态阶段完成后由 HAL 写入地址寄存器
+            (void)HAL_PCD_SetAddress(&hpcd_USB_FS, (uint8_t)(w_value & 0x7FU));
+            ep0_status_in();
+            return true;
+        case 0x06: // GET_DESCRIPTOR
+            switch (HI(w_value)) {
+                case 0x01:
+                    ep0_send(dev_desc, sizeof(dev_desc), w_length);
+                    return true;
+                case 0x02:
+                    ep0_send(cfg_desc, sizeof(cfg_desc), w_length);
+                    return true;
+                case 0x03:
+                    if (LO(w_value) == 0) {
+                        ep0_send(lang_desc, sizeof(lang_desc), w_length);
+                        return true;
+                    } else {
+                        uint16_t len = string_desc(LO(w_value));
+                        if (len != 0) {
+                            ep0_send(ep0_buf, len, w_length);
+                            return true;
+                        }
+                    }
+                    return false;
+                default:
+                    return false; // 全速设备没有 DEVICE_QUALIFIER
+            }
+        case 0x08: // GET_CONFIGURATION
+            ep0_buf[0] = cdc_configured ? 1 : 0;
+            ep0_send(ep0_buf, 1, w_length);
+            return true;
+        case 0x09: // SET_CONFIGURATION
+            if (w_value > 1) {
+                return false;
+            }
+            cdc_set_configuration((uint8_t)w_value);
+            ep0_status_in();
+            return true;
+        case 0x0A: // GET_INTERFACE
+            ep0_buf[0] = 0;
+            ep0_send(ep0_buf, 1, w_length);
+            return true;
+        case 0x0B: // SET_INTERFACE，两个接口都只有一个备用设置
+            ep0_status_in();
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief 处理 CDC 类请求
+ * @param[in] s SETUP 包
+ * @param[in] w_value wValue
+ * @param[in] w_length wLength
+ * @return bool 已处理返回 true，不支持返回 false
+ */
+static bool class_request(const uint8_t *s, uint16_t w_value, uint16_t w_length)
+{
+    switch (s[1]) {
+        case 0x20: // SET_LINE_CODING，波特率对虚拟串口没有意义，只保存下来供主机读回
+            if (w_length != sizeof(line_coding)) {
+                return false;
+            }
+            ep0_state = EP0_DATA_OUT;
+            (void)HAL_PCD_EP_Receive(&hpcd_USB_FS, 0x00, line_coding, sizeof(line_coding));
+            return true;
+        case 0x21: // GET_LINE_CODING
+            ep0_send(line_coding, sizeof(line_coding), w_length);
+            return true;
+        case 0x22: // SET_CONTROL_LINE_STATE，DTR 表示主机打开了串口
+            cdc_dtr = (w_value & 0x01U) != 0;
+            ep0_status_in();
+            cdc_update_open();
+            return true;
+        case 0x23: // SEND_BREAK
+            ep0_status_in();
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+ * @brief 启动 USB 设备
+ * @return 无
+ */
+void USB_CDC_Init(void)
+{
+    (void)HAL_PCD_Start(&hpcd_USB_FS);
+}
+
+/**
+ * @brief 查询主机是否已打开虚拟串口
+ * @return bool 已打开返回 true
+ */
+bool USB_CDC_Is_Open(void)
+{
+    return cdc_open;
+}
+
+/**
+ * @brief 查询 USB 总线是否处于活动状态
+ * @return bool 活动返回 true
+ */
+bool USB_CDC_Is_Active(void)
+{
+    return cdc_active;
+}
+
+/**
+ * @brief 启动一次批量 IN 传输
+ * @param[in] data 数据
+ * @param[in] len 长度
+ * @return uint8_t 1: 已启动; 0: 串口未打开或上一次传输尚未完成
+ */
+uint8_t USB_CDC_Transmit(const uint8_t *data, uint16_t len)
+{
+    if (!cdc_open || tx_busy || len == 0) {
+        return 0;
+    }
+    tx_busy = true;
+    tx_zlp = (len % USB_CDC_PACKET) == 0;
+    if (HAL_PCD_EP_Transmit(&hpcd_USB_FS, CDC_IN_EP, (uint8_t *)data, len) != HAL_OK) {
+        tx_busy = false;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 虚拟串口打开或关闭的通知 (弱定义)
+ * @param[in] open 打开为 true，关闭为 false
+ * @return 无
+ */
+__weak void USB_CDC_Open_Callback(bool open)
+{
+    (void)open;
+}
+
+/**
+ * @brief 收到一个批量 OUT 包的通知 (弱定义)
+ * @param[in] data 数据
+ * @param[in] len 长度
+ * @return 无
+ */
+__weak void USB_CDC_Rx_Callback(const uint8_t *data, uint16_t len)
+{
+    (void)data;
+    (void)len;
+}
+
+/**
+ * @brief 批量 IN 传输完成的通知 (弱定义)
+ * @return 无
+ */
+__weak void USB_CDC_Tx_Cplt_Callback(void)
+{
+}
+
+/**
+ * @brief 总线复位：重新打开端点0，回到未配置状态
+ * @param[in] hpcd PCD句柄指针
+ * @return 无
+ */
+void HAL_PCD_ResetCallback(PCD_HandleTypeDef *hpcd)
+{
+    (void)HAL_PCDEx_PMAConfig(hpcd, 0x00, PCD_SNG_BUF, PMA_EP0_OUT);
+    (void)HAL_PCDEx_PMAConfig(hpcd, 0x80, PCD_SNG_BUF, PMA_EP0_IN);
+    (void)HAL_PCD_EP_Open(hpcd, 0x00, USB_CDC_PACKET, EP_TYPE_CTRL);
+    (void)HAL_PCD_EP_Open(hpcd, 0x80, USB_CDC_PACKET, EP_TYPE_CTRL);
+
+    ep0_state = EP0_IDLE;
+    cdc_active = true;
+    cdc_configured = false; // 复位后端点寄存器已清零，不需要逐个关闭
+    cdc_dtr = false;
+    cdc_update_open();
+}
+
+/**
+ * @brief 总线挂起 (主机休眠或拔掉电缆)
+ * @param[in] hpcd PCD句柄指针
+ * @return 无
+ */
+void HAL_PCD_SuspendCallback(PCD_HandleTypeDef *hpcd)
+{
+    (void)hpcd;
+    cdc_active = false;
+    cdc_update_open();
+}
+
+/**
+ * @brief 总线恢复
+ * @param[in] hpcd PCD句柄指针
+ * @return 无
+ */
+void HAL_PCD_ResumeCallback(PCD_HandleTypeDef *hpcd)
+{
+    (void)hpcd;
+    cdc_active = true;
+    cdc_update_open();
+}
+
+/**
+ * @brief 收到 SETUP 包
+ * @param[in] hpcd PCD句柄指针
+ * @return 无
+ */
+void HAL_PCD_SetupStageCallback(PCD_HandleTypeDef *hpcd)
+{
+    const uint8_t *s = (const uint8_t *)hpcd->Setup;
+    uint16_t w_value = (uint16_t)(s[2] | (s[3] << 8));
+    uint16_t w_length = (uint16_t)(s[6] | (s[7] << 8));
+    bool handled;
+
+    ep0_state = EP0_IDLE; // 新的 SETUP 放弃未完成的控制传输
+    switch (s[0] & 0x60U) {
+        case 0x00:
+            handled = std_request(s, w_value, w_length);
+            break;
+        case 0x20:
+            handled = class_request(s, w_value, w_length);
+            break;
+        default:
+            handled = false;
+            break;
+    }
+    if (!handled) {
+        ep0_stall();
+    }
+}
+
+/**
+ * @brief OUT 传输完成
+ * @param[in] hpcd PCD句柄指针
+ * @param[in] epnum 端点号
+ * @return 无
+ */
+void HAL_PCD_DataOutStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+    if (epnum == 0) {
+        if (ep0_state == EP0_DATA_OUT) {
+            ep0_status_in(); // line_coding 已由 HAL 写入
+        }
+    } else if (epnum == (CDC_OUT_EP & 0x7FU)) {
+        USB_CDC_Rx_Callback(rx_pkt, (uint16_t)HAL_PCD_EP_GetRxCount(hpcd, CDC_OUT_EP));
+        (void)HAL_PCD_EP_Receive(hpcd, CDC_OUT_EP, rx_pkt, USB_CDC_PACKET);
+    }
+}
+
+/**
+ * @brief IN 传输完成
+ * @param[in] hpcd PCD句柄指针
+ * @param[in] epnum 端点号
+ * @return 无
+ */
+void HAL_PCD_DataInStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+    if (epnum == 0) {
+        ep0_in_next();
+    } else if (epnum == (CDC_IN_EP & 0x7FU) && tx_busy) {
+        if (tx_zlp) {
+            tx_zlp = false;
+            (void)HAL_PCD_EP_Transmit(hpcd, CDC_IN_EP, NULL, 0);
+            return;
+        }
+        tx_busy = false;
+        USB_CDC_Tx_Cplt_Callback();
+    }
+}
+
+/** @} */
@@ -0,0 +1,100 @@
+/**
+ * @file      usb_cdc.h
+ * @brief     USB CDC 虚拟串口头文件
+ * @details   直接在 HAL PCD 驱动上实现的最小 CDC-ACM 设备 (不使用 ST 的 USB 中间件)：
+ *            一个通信接口 (中断端点，不发送通知) 和一个数据接口 (批量 OUT/IN 端点)。
+ *            批量 IN 端点为双缓冲，一个包在总线上发送时下一个包已写入另一半 PMA，
+ *            连续发送时每帧可以传输多个包，不再受 USART1 115200 波特率的限制。
+ *            主机打开串口 (置位 DTR) 后 uart.c 把发送和接收切换到本端口，关闭或拔掉电缆后切回 USART1，
+ *            跟踪日志、性能分析输出和设置协议都不需要修改。
+ *            USB 需要 PLL 提供 48MHz 时钟：总线活动 (未挂起) 期间不降频，也不进入停止模式。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __USB_CDC_H
+#define __USB_CDC_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup USB_CDC USB虚拟串口
+ * @brief 基于 HAL PCD 的 CDC-ACM 设备，数据由 uart.c 的收发缓冲区收发。
+ * @{
+ */
+
+/**
+ * @defgroup USB_CDC_Config USB虚拟串口配置
+ * @{
+ */
+#define USB_CDC_VID           0x0483U ///< 厂商ID (ST)
+#define USB_CDC_PID           0x5740U ///< 产品ID (ST 虚拟串口，主机使用系统自带的 CDC 驱动)
+#define USB_CDC_PACKET        64U     ///< 批量端点和控制端点的最大包长
+#define USB_CDC_NOTIFY_PACKET 8U      ///< 通知端点的最大包长
+#define USB_CDC_MAX_POWER_MA  100U    ///< 配置描述符中声明的最大电流 (mA)
+/** @} */
+
+/**
+ * @brief 启动 USB 设备 (连接到总线)
+ * @details 需在 MX_USB_PCD_Init() 之后调用。
+ * @return 无
+ */
+void USB_CDC_Init(void);
+
+/**
+ * @brief 查询主机是否已打开虚拟串口
+ * @details 已完成配置、主机置位了 DTR 且总线未挂起时为 true。
+ * @return bool 已打开返回 true
+ */
+bool USB_CDC_Is_Open(void);
+
+/**
+ * @brief 查询 USB 总线是否处于活动状态
+ * @details 收到总线复位后、挂起之前为 true (包括尚未打开串口的时候)。
+ *          活动期间 USB 外设需要 48MHz 时钟，低功耗管理据此保持 PLL 并禁止停止模式。
+ * @return bool 活动返回 true
+ */
+bool USB_CDC_Is_Active(void);
+
+/**
+ * @brief 启动一次批量 IN 传输 (不阻塞)
+ * @details 长度不限于一个包，由 HAL 在双缓冲中逐包填充；长度是包长的整数倍时在最后补发一个零长度包，
+ *          主机据此立即交付数据。完成后调用 USB_CDC_Tx_Cplt_Callback()，数据在此之前必须保持有效。
+ * @note 必须在关中断或 USB 中断 (包括本模块的回调) 中调用。
+ * @param[in] data 数据
+ * @param[in] len 长度
+ * @return uint8_t 1: 已启动; 0: 串口未打开或上一次传输尚未完成
+ */
+uint8_t USB_CDC_Transmit(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 虚拟串口打开或关闭的通知 (弱定义，默认为空)
+ * @note 在 USB 中断中调用。关闭时如有未完成的 IN 传输，之前已经以 USB_CDC_Tx_Cplt_Callback() 结束。
+ * @param[in] open 打开为 true，关闭 (包括总线复位、挂起和主机清除 DTR) 为 false
+ * @return 无
+ */
+void USB_CDC_Open_Callback(bool open);
+
+/**
+ * @brief 收到一个批量 OUT 包的通知 (弱定义，默认为空)
+ * @note 在 USB 中断中调用，返回后重新接收下一个包，data 在返回后即失效。
+ * @param[in] data 数据
+ * @param[in] len 长度 (不超过 USB_CDC_PACKET)
+ * @return 无
+ */
+void USB_CDC_Rx_Callback(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 批量 IN 传输完成的通知 (弱定义，默认为空)
+ * @note 在 USB 中断中调用，可在回调中启动下一次传输。串口关闭时被放弃的传输也以此结束。
+ * @return 无
+ */
+void USB_CDC_Tx_Cplt_Callback(void);
+
+/** @} */
+
+#endif /* __USB_CDC_H */
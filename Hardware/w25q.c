@@ -0,0 +1,387 @@
+/**
+ * @file      w25q.c
+ * @brief     W25Q 系列 SPI NOR 闪存驱动实现
+ * @details   SPI1 和两个 DMA 通道直接操作寄存器 (不在 CubeMX 工程中)。SPI1 为主机、模式0、软件片选。
+ *            命令与地址逐字节收发时每个字节都读出接收寄存器，启动 DMA 时接收端没有遗留的数据。
+ *            接收通道的优先级高于发送通道，接收寄存器总在下一个字节到达之前被取走。
+ *            编程和擦除命令发出后记下 WIP 待查，下一次 W25Q_Is_Busy() 读状态寄存器直到 WIP 清零。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "w25q.h"
+#include "audio.h"
+#include "input.h"
+#include "u8g2_stm32_hal.h"
+
+/**
+ * @addtogroup W25Q
+ * @{
+ */
+
+#if W25Q_ENABLE && U8G2_TRANSPORT == U8G2_TRANSPORT_SPI
+#error "W25Q_ENABLE and the SPI display both use SPI1 (PB3/PB4/PB5/PA15)"
+#endif
+#if W25Q_ENABLE && (AUDIO_ENABLE || INPUT_SCAN_DMA)
+#error "W25Q_ENABLE, AUDIO_ENABLE and INPUT_SCAN_DMA all use DMA1 channel 2"
+#endif
+
+#define W25Q_CMD_WRITE_ENABLE 0x06 ///< 写使能
+#define W25Q_CMD_READ_STATUS  0x05 ///< 读状态寄存器1
+#define W25Q_CMD_READ         0x03 ///< 读数据
+#define W25Q_CMD_PAGE_PROGRAM 0x02 ///< 页编程
+#define W25Q_CMD_SECTOR_ERASE 0x20 ///< 4KB 扇区擦除
+#define W25Q_CMD_JEDEC_ID     0x9F ///< 读 JEDEC ID
+#define W25Q_CMD_RELEASE_PD   0xAB ///< 释放掉电
+#define W25Q_SR_WIP           0x01 ///< 状态寄存器1：编程或擦除进行中
+
+#if W25Q_ENABLE
+
+/* Private variables ---------------------------------------------------------*/
+static volatile bool w25q_active;  ///< DMA 传输进行中 (片选为低)
+static bool w25q_wip;              ///< 编程或擦除已发出，尚未确认结束
+static uint16_t w25q_sectors;      ///< 扇区数，0 为没有检测到闪存
+static uint8_t w25q_sink;          ///< 写入时接收通道丢弃的字节
+static const uint8_t w25q_fill = 0xFF; ///< 读取时发送通道重复发送的字节
+
+/* Private function prototypes -----------------------------------------------*/
+void DMA1_Channel2_IRQHandler(void);
+static uint8_t w25q_xfer(uint8_t v);
+static void w25q_select(void);
+static void w25q_release(void);
+static void w25q_command(uint8_t cmd, uint32_t addr);
+static void w25q_write_enable(void);
+static void w25q_dma_start(uint8_t *rx, const uint8_t *tx, uint16_t len);
+static void w25q_dma_stop(void);
+
+/* Private Function implementations ------------------------------------------*/
+
+/**
+ * @brief 收发一个字节 (轮询)
+ * @param[in] v 发送的字节
+ * @return uint8_t 同时收到的字节
+ */
+static uint8_t w25q_xfer(uint8_t v)
+{
+    while ((SPI1->SR & SPI_SR_TXE) == 0) {
+    }
+    *(volatile uint8_t *)&SPI1->DR = v;
+    while ((SPI1->SR & SPI_SR_RXNE) == 0) {
+    }
+    return (uint8_t)SPI1->DR;
+}
+
+/**
+ * @brief 片选置为有效
+ * @return 无
+ */
+static void w25q_select(void)
+{
+    W25Q_CS_PORT->BRR = W25Q_CS_PIN;
+}
+
+/**
+ * @brief 片选置为无效
+ * @details 轮询收发的最后一个字节读出时已经全部移出，可以直接释放。
+ * @return 无
+ */
+static void w25q_release(void)
+{
+    W25Q_CS_PORT->BSRR = W25Q_CS_PIN;
+}
+
+/**
+ * @brief 选中芯片并发出命令和三字节地址
+ * @param[in] cmd 命令
+ * @param[in] addr 地址
+ * @return 无
+ */
+static void w25q_command(uint8_t cmd, uint32_t addr)
+{
+    w25q_select();
+    w25q_xfer(cmd);
+    w25q_xfer((uint8_t)(addr >> 16));
+    w25q_xfer((uint8_t)(addr >> 8));
+    w25q_xfer((uint8_t)addr);
+}
+
+/**
+ * @brief 写使能 (每次编程和擦除之前都需要，完成后芯片自动清除)
+ * @return 无
+ */
+static void w25q_write_enable(void)
+{
+    w25q_select();
+    w25q_xfer(W25Q_CMD_WRITE_ENABLE);
+    w25q_release();
+}
+
+/**
+ * @brief 启动数据段的 DMA 传输，片选保持为低，由接收完成中断释放
+ * @param[out] rx 接收缓冲区，为 NULL 时丢弃收到的字节
+ * @param[in] tx 发送缓冲区，为 NULL 时发送 0xFF
+ * @param[in] len 长度
+ * @return 无
+ */
+static void w25q_dma_start(uint8_t *rx, const uint8_t *tx, uint16_t len)
+{
+    w25q_active = true;
+    DMA1->IFCR = DMA_IFCR_CGIF2 | DMA_IFCR_CGIF3;
+    DMA1_Channel2->CPAR = (uint32_t)&SPI1->DR;
+    DMA1_Channel2->CMAR = (uint32_t)((rx != NULL) ? rx : &w25q_sink);
+    DMA1_Channel2->CNDTR = len;
+    DMA1_Channel2->CCR = ((rx != NULL) ? DMA_CCR_MINC : 0U) | DMA_CCR_PL_1 | DMA_CCR_TCIE | DMA_CCR_EN;
+    DMA1_Channel3->CPAR = (uint32_t)&SPI1->DR;
+    DMA1_Channel3->CMAR = (uint32_t)((tx != NULL) ? tx : &w25q_fill);
+    DMA1_Channel3->CNDTR = len;
+    DMA1_Channel3->CCR = DMA_CCR_DIR | ((tx != NULL) ? DMA_CCR_MINC : 0U) | DMA_CCR_PL_0 | DMA_CCR_EN;
+    SPI1->CR2 = SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN; // 参考手册要求先使能接收请求
+}
+
+/**
+ * @brief 结束 DMA 传输并释放片选
+ * @return 无
+ */
+static void w25q_dma_stop(void)
+{
+    SPI1->CR2 = 0;
+    DMA1_Channel2->CCR = 0;
+    DMA1_Channel3->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF2 | DMA_IFCR_CGIF3;
+    w25q_release();
+    w25q_active = false;
+}
+
+/**
+ * @brief SPI1 接收 DMA 的传输完成中断
+ * @details 启动文件中的弱定义由本函数覆盖 (与 audio.c、input.c 中的定义由编译检查互斥)。
+ * @return 无
+ */
+void DMA1_Channel2_IRQHandler(void)
+{
+    w25q_dma_stop();
+}
+
+#endif /* W25Q_ENABLE */
+
+/* Public Function implementations -------------------------------------------*/
+
+/**
+ * @brief 初始化 SPI1、DMA 和片选，读出 JEDEC ID
+ * @return bool 检测到闪存返回 true
+ */
+bool W25Q_Init(void)
+{
+#if W25Q_ENABLE
+    GPIO_InitTypeDef gpio = {0};
+    uint32_t start;
+    uint8_t capacity;
+
+    __HAL_RCC_SPI1_CLK_ENABLE();
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_AFIO_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_AFIO_REMAP_SPI1_ENABLE();
+
+    w25q_release();
+    gpio.Pin = W25Q_CS_PIN;
+    gpio.Mode = GPIO_MODE_OUTPUT_PP;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(W25Q_CS_PORT, &gpio);
+    gpio.Pin = GPIO_PIN_3 | GPIO_PIN_5; // SCK, MOSI
+    gpio.Mode = GPIO_MODE_AF_PP;
+    HAL_GPIO_Init(GPIOB, &gpio);
+    gpio.Pin = GPIO_PIN_4; // MISO
+    gpio.Mode = GPIO_MODE_INPUT;
+    gpio.Pull = GPIO_PULLUP; // 没有芯片时读到 0xFF
+    HAL_GPIO_Init(GPIOB, &gpio);
+
+    SPI1->CR1 = SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI | (W25Q_SPI_BR << SPI_CR1_BR_Pos);
+    SPI1->CR2 = 0;
+    SPI1->CR1 |= SPI_CR1_SPE;
+
+    DMA1_Channel2->CCR = 0;
+    DMA1_Channel3->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF2 | DMA_IFCR_CGIF3;
+    HAL_NVIC_SetPriority(DMA1_Channel2_IRQn, IRQ_PRIO_BACKGROUND, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+
+    w25q_select();
+    w25q_xfer(W25Q_CMD_RELEASE_PD);
+    w25q_release();
+    HAL_Delay(1); // tRES1 最长 3us
+
+    w25q_select();
+    w25q_xfer(W25Q_CMD_JEDEC_ID);
+    w25q_xfer(0xFF); // 厂家
+    w25q_xfer(0xFF); // 类型
+    capacity = w25q_xfer(0xFF);
+    w25q_release();
+
+    w25q_sectors = 0;
+    if (capacity < 0x11 || capacity > 0x18) {
+        return false;
+    }
+    w25q_sectors = (uint16_t)((1UL << capacity) / W25Q_SECTOR_SIZE);
+
+    start = HAL_GetTick();
+    w25q_wip = true;
+    while (W25Q_Is_Busy()) {
+        if (HAL_GetTick() - start > W25Q_ERASE_MAX_MS) {
+            w25q_sectors = 0;
+            return false;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 获取扇区数
+ * @return uint16_t 4KB 扇区的个数
+ */
+uint16_t W25Q_Sector_Count(void)
+{
+#if W25Q_ENABLE
+    return w25q_sectors;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief 查询闪存是否忙
+ * @return bool 忙返回 true
+ */
+bool W25Q_Is_Busy(void)
+{
+#if W25Q_ENABLE
+    if (w25q_active) {
+        return true;
+    }
+    if (w25q_wip) {
+        uint8_t sr;
+
+        w25q_select();
+        w25q_xfer(W25Q_CMD_READ_STATUS);
+        sr = w25q_xfer(0xFF);
+        w25q_release();
+        w25q_wip = (sr & W25Q_SR_WIP) != 0;
+    }
+    return w25q_wip;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 查询是否有 DMA 传输正在进行
+ * @return bool 正在传输返回 true
+ */
+bool W25Q_Is_Transferring(void)
+{
+#if W25Q_ENABLE
+    return w25q_active;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 读取
+ * @details 超时 (DMA 或 SPI 异常) 时停止传输并释放片选。
+ * @param[in] addr 起始地址
+ * @param[out] buf 接收缓冲区
+ * @param[in] len 长度
+ * @return HAL_StatusTypeDef 执行结果
+ */
+HAL_StatusTypeDef W25Q_Read(uint32_t addr, uint8_t *buf, uint16_t len)
+{
+#if W25Q_ENABLE
+    uint32_t start = HAL_GetTick();
+
+    if (w25q_sectors == 0 || len == 0) {
+        return HAL_ERROR;
+    }
+    if (W25Q_Is_Busy()) {
+        return HAL_BUSY;
+    }
+    w25q_command(W25Q_CMD_READ, addr);
+    w25q_dma_start(buf, NULL, len);
+    while (w25q_active) {
+        if (HAL_GetTick() - start > W25Q_TIMEOUT_MS) {
+            HAL_NVIC_DisableIRQ(DMA1_Channel2_IRQn);
+            w25q_dma_stop();
+            HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+            return HAL_TIMEOUT;
+        }
+    }
+    return HAL_OK;
+#else
+    (void)addr;
+    (void)buf;
+    (void)len;
+    return HAL_ERROR;
+#endif
+}
+
+/**
+ * @brief 页编程
+ * @param[in] addr 起始地址
+ * @param[in] data 数据
+ * @param[in] len 长度
+ * @return HAL_StatusTypeDef 执行结果
+ */
+HAL_StatusTypeDef W25Q_Program(uint32_t addr, const uint8_t *data, uint16_t len)
+{
+#if W25Q_ENABLE
+    if (w25q_sectors == 0 || len == 0 || (addr % W25Q_PAGE_SIZE) + len > W25Q_PAGE_SIZE) {
+        return HAL_ERROR;
+    }
+    if (W25Q_Is_Busy()) {
+        return HAL_BUSY;
+    }
+    w25q_write_enable();
+    w25q_command(W25Q_CMD_PAGE_PROGRAM, addr);
+    w25q_wip = true; // 片选释放后芯片开始编程
+    w25q_dma_start(NULL, data, len);
+    return HAL_OK;
+#else
+    (void)addr;
+    (void)data;
+    (void)len;
+    return HAL_ERROR;
+#endif
+}
+
+/**
+ * @brief 擦除一个 4KB 扇区
+ * @param[in] addr 扇区内的任一地址
+ * @return HAL_StatusTypeDef 执行结果
+ */
+HAL_StatusTypeDef W25Q_Erase_Sector(uint32_t addr)
+{
+#if W25Q_ENABLE
+    if (w25q_sectors == 0) {
+        return HAL_ERROR;
+    }
+    if (W25Q_Is_Busy()) {
+        return HAL_BUSY;
+    }
+    w25q_write_enable();
+    w25q_command(W25Q_CMD_SECTOR_ERASE, addr);
+    w25q_release();
+    w25q_wip = true;
+    return HAL_OK;
+#else
+    (void)addr;
+    return HAL_ERROR;
+#endif
+}
+
+/** @} */
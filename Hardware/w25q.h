@@ -0,0 +1,108 @@
+/**
+ * @file      w25q.h
+ * @brief     W25Q 系列 SPI NOR 闪存驱动头文件
+ * @details   闪存接在重映射的 SPI1 上：SCK PB3、MISO PB4、MOSI PB5、片选 PA15 (JTAG 已关闭，这几个引脚空闲)，
+ *            与 SPI 版显示器使用同一组引脚，两者不能同时启用。
+ *            命令和地址 (4字节) 由 CPU 逐字节收发，数据段经 DMA1 通道2 (SPI1_RX) 和通道3 (SPI1_TX) 全双工传输：
+ *            读取时发送端重复发送 0xFF，写入时接收端丢弃读到的字节，接收通道的传输完成中断释放片选，
+ *            因此中断到来时最后一个字节已经移出。
+ *            页编程和扇区擦除发出命令后立即返回，由芯片自行完成 (页编程约0.7ms，4KB 擦除典型 45ms、最长 400ms)，
+ *            之后 W25Q_Is_Busy() 读状态寄存器的 WIP 位查询是否结束，调用者不必等待。
+ *            容量由 JEDEC ID 的第三个字节 (2 的幂次) 得出，兼容的其他厂家芯片 (GD25Q 等) 同样可用。
+ *            W25Q_ENABLE 为 0 (默认，板上没有闪存) 时所有函数为空操作，W25Q_Init 返回 false。
+ *            DMA1 通道2 只能给 SPI1 接收、蜂鸣器 (AUDIO_ENABLE) 和按键 DMA 采样 (INPUT_SCAN_DMA) 中的一个使用。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __W25Q_H
+#define __W25Q_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup W25Q SPI NOR 闪存
+ * @brief W25Q 系列闪存的读取、页编程和扇区擦除。
+ * @{
+ */
+
+/**
+ * @defgroup W25Q_Config SPI NOR 闪存配置
+ * @{
+ */
+#ifndef W25Q_ENABLE
+#define W25Q_ENABLE       0          ///< 为 1 时启用外部闪存 (需要在 SPI1 重映射的引脚上接 W25Qxx)
+#endif
+#define W25Q_CS_PORT      GPIOA      ///< 片选 (低有效)
+#define W25Q_CS_PIN       GPIO_PIN_15
+#define W25Q_SPI_BR       1U         ///< SPI1 时钟分频 (CR1.BR)：1 为 4 分频即 18MHz，普通读命令 (0x03) 最高 50MHz
+#define W25Q_PAGE_SIZE    256U       ///< 编程页的大小，一次页编程不能跨页
+#define W25Q_SECTOR_SIZE  4096U      ///< 最小擦除单位
+#define W25Q_TIMEOUT_MS   10U        ///< 等待一次 DMA 读取完成的最长时间
+#define W25Q_ERASE_MAX_MS 400U       ///< 扇区擦除的最长时间 (初始化时等待复位前发出的擦除结束)
+/** @} */
+
+/**
+ * @brief 初始化 SPI1、DMA 和片选，读出 JEDEC ID
+ * @details 先发送释放掉电命令 (0xAB)，再读 JEDEC ID：容量字节在 0x11~0x18 (128KB~16MB，三字节地址) 之外时认为没有芯片。
+ *          MCU 复位不影响闪存，复位前发出的编程或擦除可能仍在进行，检测到芯片后等待 WIP 清零 (最长 W25Q_ERASE_MAX_MS)。
+ * @return bool 检测到闪存返回 true
+ */
+bool W25Q_Init(void);
+
+/**
+ * @brief 获取扇区数
+ * @return uint16_t 4KB 扇区的个数，没有检测到闪存时为 0
+ */
+uint16_t W25Q_Sector_Count(void);
+
+/**
+ * @brief 查询闪存是否忙
+ * @details DMA 传输进行中，或上一次编程/擦除尚未结束 (此时读一次状态寄存器，约1us) 时为忙。
+ * @return bool 忙返回 true，此时不能发出新的命令
+ */
+bool W25Q_Is_Busy(void);
+
+/**
+ * @brief 查询是否有 DMA 传输正在进行
+ * @details 传输期间不能进入停止模式，也不能修改 W25Q_Program 的数据缓冲区。一次传输最长约 0.12ms。
+ * @return bool 正在传输返回 true
+ */
+bool W25Q_Is_Transferring(void);
+
+/**
+ * @brief 读取
+ * @details 发出读命令后经 DMA 接收并等待完成 (18MHz 下每字节约0.45us)。
+ * @param[in] addr 起始地址
+ * @param[out] buf 接收缓冲区
+ * @param[in] len 长度 (1~65535)
+ * @return HAL_StatusTypeDef HAL_OK 成功；HAL_BUSY 闪存忙；HAL_TIMEOUT 传输超时；HAL_ERROR 未检测到闪存
+ */
+HAL_StatusTypeDef W25Q_Read(uint32_t addr, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief 页编程
+ * @details 写使能后发出页编程命令，数据经 DMA 发送后立即返回，之后芯片自行编程。
+ *          只能把 1 改为 0：写入的区域须已擦除，或只在已擦除的部分写入 (同一页可以分多次写入不同的部分)。
+ * @param[in] addr 起始地址
+ * @param[in] data 数据，在 W25Q_Is_Transferring() 返回 false 之前不能修改
+ * @param[in] len 长度 (1~256)，不能跨越页边界
+ * @return HAL_StatusTypeDef HAL_OK 已开始；HAL_BUSY 闪存忙；HAL_ERROR 参数无效或未检测到闪存
+ */
+HAL_StatusTypeDef W25Q_Program(uint32_t addr, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 擦除一个 4KB 扇区
+ * @details 发出命令后立即返回，擦除期间 W25Q_Is_Busy() 返回 true。
+ * @param[in] addr 扇区内的任一地址
+ * @return HAL_StatusTypeDef HAL_OK 已开始；HAL_BUSY 闪存忙；HAL_ERROR 未检测到闪存
+ */
+HAL_StatusTypeDef W25Q_Erase_Sector(uint32_t addr);
+
+/** @} */
+
+#endif /* __W25Q_H */
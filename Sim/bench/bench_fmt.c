@@ -0,0 +1,133 @@
+/**
+ * @file      bench_fmt.c
+ * @brief     app_fmt 与 sprintf 的格式化耗时对比 (主机端)
+ * @details   对主页面和时间/日期设置页面中实际用到的几种格式，分别用 sprintf 和 app_fmt
+ *            各格式化 BENCH_FMT_LOOPS 次，先比较两者输出是否一致，再输出每次调用的平均耗时。
+ *            主机上的绝对值与 Cortex-M3 不同，但可以反映两者的相对开销。
+ *            用法：table_clock_fmt_bench
+ * @author    SandOcean
+ * @date      2025-09-23
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_fmt.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FMT_LOOPS 2000000U ///< 每种格式的重复次数
+
+volatile char g_bench_sink; ///< 防止编译器把格式化结果优化掉
+
+/**
+ * @brief 一种被比较的格式
+ */
+typedef struct {
+    const char *name;                    ///< 格式名
+    void (*with_sprintf)(char *buf, uint32_t i); ///< sprintf 实现
+    void (*with_fmt)(char *buf, uint32_t i);     ///< app_fmt 实现
+} Bench_Fmt_t;
+
+static void time_sprintf(char *buf, uint32_t i)
+{
+    sprintf(buf, "%02d:%02d:%02d", (int)(i % 24), (int)(i % 60), (int)((i >> 3) % 60));
+}
+
+static void time_fmt(char *buf, uint32_t i)
+{
+    char *p = fmt_u2(buf, i % 24);
+    p = fmt_char(p, ':');
+    p = fmt_u2(p, i % 60);
+    p = fmt_char(p, ':');
+    fmt_u2(p, (i >> 3) % 60);
+}
+
+static void date_sprintf(char *buf, uint32_t i)
+{
+    sprintf(buf, "%04d-%02d-%02d", (int)(2000 + i % 100), (int)(1 + i % 12), (int)(1 + i % 31));
+}
+
+static void date_fmt(char *buf, uint32_t i)
+{
+    char *p = fmt_u4(buf, 2000 + i % 100);
+    p = fmt_char(p, '-');
+    p = fmt_u2(p, 1 + i % 12);
+    p = fmt_char(p, '-');
+    fmt_u2(p, 1 + i % 31);
+}
+
+static void env_sprintf(char *buf, uint32_t i)
+{
+    int temp_d = (int)(i % 800) - 200;
+    unsigned temp_abs = (unsigned)(temp_d < 0 ? -temp_d : temp_d);
+    unsigned humi = i % 1001;
+    sprintf(buf, "T:%s%u.%u\260C H:%u.%u%%", temp_d < 0 ? "-" : "", temp_abs / 10, temp_abs % 10, humi / 10, humi % 10);
+}
+
+static void env_fmt(char *buf, uint32_t i)
+{
+    char *p = fmt_str(buf, "T:");
+    p = fmt_q1(p, (int32_t)(i % 800) - 200);
+    p = fmt_str(p, "\260C H:");
+    p = fmt_q1(p, i % 1001);
+    fmt_char(p, '%');
+}
+
+static void slot_sprintf(char *buf, uint32_t i)
+{
+    sprintf(buf, "%02d", (int)(i % 60));
+}
+
+static void slot_fmt(char *buf, uint32_t i)
+{
+    fmt_u2(buf, i % 60);
+}
+
+static const Bench_Fmt_t bench_fmts[] = {
+    { "time",     time_sprintf, time_fmt },
+    { "date",     date_sprintf, date_fmt },
+    { "temp_humi", env_sprintf,  env_fmt },
+    { "slot_u2",  slot_sprintf, slot_fmt },
+};
+
+static double bench_ns_per_call(void (*f)(char *, uint32_t))
+{
+    char buf[32];
+    struct timespec t0, t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t i = 0; i < BENCH_FMT_LOOPS; i++) {
+        f(buf, i);
+        g_bench_sink = buf[1];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / BENCH_FMT_LOOPS;
+}
+
+int main(void)
+{
+    int rc = 0;
+
+    printf("%-10s %12s %12s %8s\n", "format", "sprintf_ns", "app_fmt_ns", "speedup");
+    for (uint32_t n = 0; n < sizeof(bench_fmts) / sizeof(bench_fmts[0]); n++) {
+        const Bench_Fmt_t *b = &bench_fmts[n];
+        char a[32], c[32];
+
+        // 先确认输出一致
+        for (uint32_t i = 0; i < 100000U; i++) {
+            b->with_sprintf(a, i);
+            b->with_fmt(c, i);
+            if (strcmp(a, c) != 0) {
+                printf("%s: mismatch at %lu: \"%s\" vs \"%s\"\n", b->name, (unsigned long)i, a, c);
+                rc = 1;
+                break;
+            }
+        }
+
+        double ns_sprintf = bench_ns_per_call(b->with_sprintf);
+        double ns_fmt = bench_ns_per_call(b->with_fmt);
+        printf("%-10s %12.1f %12.1f %7.1fx\n", b->name, ns_sprintf, ns_fmt, ns_sprintf / ns_fmt);
+    }
+    return rc;
+}
@@ -0,0 +1,682 @@
+/**
+ * @file      bench_main.c
+ * @brief     页面渲染基准测试程序 (主机端)
+ * @details   把 App 层和真实的 u8g2 适配层 (Core/Src/u8g2_stm32_hal.c，含脏区比较) 链接到
+ *            仿真驱动上，对每个页面回放一段脚本输入，按帧统计：
+ *            - 渲染时间：产生该帧的那次 Page_Manager_Loop 的主机耗时；
+ *            - 绘制调用：该帧中页面 draw 回调被调用的次数 (经 Page_Manager_DrawCallback 统计)；
+ *            - 字形：该帧中经 u8g2 字体解码绘制的字符数 (字形缓存命中的字符不计入)；
+ *            - 推送字节：该帧发往 OLED 的 I2C 字节数，以及按 400kHz 估算的总线时间；
+ *            - 画面散列：每帧送到屏幕的画面的 FNV-1a 散列，按帧顺序合成每个场景一个值
+ *              (包括切换到被测页面的动画帧)。
+ *            虚拟时钟每次循环推进 1ms，结果中除渲染时间外都与主机无关，可直接用于比较回归：
+ *            --save 把帧数、画面散列和各项开销的总数写入基线文件，--check 与基线比较，
+ *            画面散列或帧数不同、或任一项开销超过基线的 --threshold 百分比 (默认 5%) 时以非零值退出。
+ *            --replay 载入在目标板上录制的输入 (Tools/input_replay.py save 保存的文件)，
+ *            从主页面开始回放，作为最后一个场景 "replay" 输出，用于比较真实导航过程的开销。
+ *            --soak HOURS 改为运行耐久测试 (App/app_soak.c)：以虚拟时钟把导航脚本、设置写入和采样连续运行
+ *            HOURS 小时，页面静止时时钟直接跳到页面管理器下一次需要运行的时刻，每10分钟 (虚拟时间) 输出一份报告，
+ *            最终判定失败时以非零值退出。
+ *            用法：table_clock_bench [--csv] [--replay FILE] [--save FILE | --check FILE [--threshold PCT]]
+ *                  table_clock_bench --soak HOURS
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.3
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "sim.h"
+#include "input_replay.h"
+#include "app_display.h"
+#include "app_settings.h"
+#include "app_sensor.h"
+#include "app_bus.h"
+#include "app_astro.h"
+#include "app_lunar.h"
+#include "app_soak.h"
+#include "time_core.h"
+#include "DS3231.h"
+#include "i2c_bus.h"
+#include "u8g2_stm32_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_OLED_ADDR   0x78 ///< OLED 的8位I2C地址
+#define BENCH_SETTLE_MS   600  ///< 切换到被测页面后等待动画结束的时间
+#define BENCH_MAX_STEPS   32   ///< 单个脚本的最大步数
+#define BENCH_THRESHOLD   5.0  ///< --check 默认允许的开销增长 (%)
+#ifndef BENCH_WRAP
+#define BENCH_WRAP        0    ///< 链接时是否包装了 u8g2 函数 (由 Sim/CMakeLists.txt 在默认配置中置 1)
+#endif
+#define BENCH_FNV_OFFSET  2166136261U ///< FNV-1a 初值
+#define BENCH_FNV_PRIME   16777619U   ///< FNV-1a 乘数
+
+bool g_settings_load_failed = false; ///< 原定义在 app_main.c 中，仿真不链接该文件
+
+/**
+ * @brief 脚本中的一步：等待 delay_ms 后注入一个事件
+ */
+typedef struct {
+    uint16_t delay_ms;   ///< 距上一步的时间
+    Input_Event_t event; ///< 注入的事件
+    int16_t value;       ///< 事件值
+} Bench_Step_t;
+
+/**
+ * @brief 一个测试场景
+ */
+typedef struct {
+    const char *name;          ///< 场景名
+    const Page_Base *page;     ///< 被测页面，NULL 表示停留在主页面
+    uint32_t duration_ms;      ///< 测量时长
+    const Bench_Step_t *steps; ///< 输入脚本
+    uint8_t step_count;        ///< 脚本步数
+    bool replay;               ///< 为 true 时回放载入的录制，代替输入脚本
+} Bench_Scenario_t;
+
+/**
+ * @brief 单个场景的测量结果
+ */
+typedef struct {
+    uint32_t frames;
+    uint64_t render_ns_sum;
+    uint64_t render_ns_max;
+    uint32_t draw_calls;
+    uint32_t glyphs;
+    uint32_t bytes_sum;
+    uint32_t bytes_max;
+    uint32_t txns_sum;
+    uint32_t hash;
+} Bench_Result_t;
+
+/**
+ * @brief 基线文件中一个场景的记录 (只含与主机无关的结果)
+ */
+typedef struct {
+    char name[32];
+    unsigned long frames;
+    unsigned long hash;
+    unsigned long draw_calls;
+    unsigned long glyphs;
+    unsigned long bytes;
+} Bench_Baseline_t;
+
+/* 输入脚本 ------------------------------------------------------------------*/
+
+/** 列表页：向下滚动到底再滚回来，间隔足够让每次滚动动画播完 */
+static const Bench_Step_t script_list_scroll[] = {
+    { 300, INPUT_EVENT_ENCODER,  1 }, { 300, INPUT_EVENT_ENCODER,  1 },
+    { 300, INPUT_EVENT_ENCODER,  1 }, { 300, INPUT_EVENT_ENCODER,  1 },
+    { 300, INPUT_EVENT_ENCODER,  1 }, { 300, INPUT_EVENT_ENCODER, -1 },
+    { 300, INPUT_EVENT_ENCODER, -1 }, { 300, INPUT_EVENT_ENCODER, -1 },
+    { 300, INPUT_EVENT_ENCODER, -1 }, { 300, INPUT_EVENT_ENCODER, -1 },
+};
+
+/** 快速连续旋转，检验动画被打断时的重绘开销 */
+static const Bench_Step_t script_fast_spin[] = {
+    { 40, INPUT_EVENT_ENCODER, 1 }, { 40, INPUT_EVENT_ENCODER, 1 },
+    { 40, INPUT_EVENT_ENCODER, 1 }, { 40, INPUT_EVENT_ENCODER, 1 },
+    { 40, INPUT_EVENT_ENCODER, 1 }, { 40, INPUT_EVENT_ENCODER, 1 },
+    { 40, INPUT_EVENT_ENCODER, 1 }, { 40, INPUT_EVENT_ENCODER, 1 },
+};
+
+/** 夏令时页：移到规则项后切换两次规则，每次弹出的提示框显示1秒后关闭，页面留在原处 */
+static const Bench_Step_t script_toast[] = {
+    { 300, INPUT_EVENT_ENCODER, 1 }, { 300, INPUT_EVENT_ENCODER, 1 },
+    { 300, INPUT_EVENT_COMFIRM_PRESSED, 0 }, { 1300, INPUT_EVENT_COMFIRM_PRESSED, 0 },
+};
+
+/** 主页面：切换到指针表盘停留几秒 (每秒只重绘秒针)，再经简洁表盘和日月表盘切回数字表盘 */
+static const Bench_Step_t script_analog[] = {
+    { 100, INPUT_EVENT_ENCODER_PRESSED, 0 }, { 4700, INPUT_EVENT_ENCODER_PRESSED, 0 },
+    { 100, INPUT_EVENT_ENCODER_PRESSED, 0 }, { 100, INPUT_EVENT_ENCODER_PRESSED, 0 },
+};
+
+/** 秒表：开始计时，运行中计次一次 (每帧通常只重绘百分位和十分位) */
+static const Bench_Step_t script_stopwatch[] = {
+    { 100, INPUT_EVENT_COMFIRM_PRESSED, 0 }, { 2000, INPUT_EVENT_ENCODER_PRESSED, 0 },
+};
+
+/** 倒计时：把秒调到 3，开始后运行到期，1 秒后按键停止提示 */
+static const Bench_Step_t script_countdown[] = {
+    { 100, INPUT_EVENT_ENCODER_PRESSED, 0 }, { 100, INPUT_EVENT_ENCODER, 3 },
+    { 300, INPUT_EVENT_COMFIRM_PRESSED, 0 }, { 4000, INPUT_EVENT_BACK_PRESSED, 0 },
+};
+
+/** 主菜单：进入子页面，滑入途中按返回键使动画原路退回；再进入一次，停留后连按两次返回 (第二次排队) */
+static const Bench_Step_t script_nav_reverse[] = {
+    { 300, INPUT_EVENT_COMFIRM_PRESSED, 0 }, { 120, INPUT_EVENT_BACK_PRESSED, 0 },
+    { 600, INPUT_EVENT_COMFIRM_PRESSED, 0 }, { 600, INPUT_EVENT_BACK_PRESSED, 0 },
+    { 60, INPUT_EVENT_BACK_PRESSED, 0 },
+};
+
+#define BENCH_SCRIPT(s) (s), (uint8_t)(sizeof(s) / sizeof((s)[0]))
+
+static const Bench_Scenario_t bench_scenarios[] = {
+    { "main_idle",      NULL,               5000, NULL, 0 },
+    { "main_analog",    NULL,               5000, BENCH_SCRIPT(script_analog) },
+    { "main_menu",      &g_page_main_menu,  3500, BENCH_SCRIPT(script_list_scroll) },
+    { "main_menu_fast", &g_page_main_menu,  1500, BENCH_SCRIPT(script_fast_spin) },
+    { "time_set",       &g_page_time_set,   3500, BENCH_SCRIPT(script_list_scroll) },
+    { "time_date",      &g_page_time_date,  3500, BENCH_SCRIPT(script_list_scroll) },
+    { "time_time",      &g_page_time_time,  3500, BENCH_SCRIPT(script_list_scroll) },
+    { "time_dst",       &g_page_time_dst,   3500, BENCH_SCRIPT(script_list_scroll) },
+    { "toast",          &g_page_time_dst,   3500, BENCH_SCRIPT(script_toast) },
+    { "auto_off",       &g_page_auto_off,   3500, BENCH_SCRIPT(script_list_scroll) },
+    { "language",       &g_page_language,   3500, BENCH_SCRIPT(script_list_scroll) },
+    { "display",        &g_page_display,    3500, BENCH_SCRIPT(script_list_scroll) },
+    { "alarm",          &g_page_alarm,      3500, BENCH_SCRIPT(script_list_scroll) },
+    { "history",        &g_page_history,    3000, NULL, 0 },
+    { "info",           &g_page_info,       3000, NULL, 0 },
+    { "stopwatch",      &g_page_stopwatch,  3000, BENCH_SCRIPT(script_stopwatch) },
+    { "countdown",      &g_page_countdown,  5000, BENCH_SCRIPT(script_countdown) },
+    { "diag",           &g_page_diag,       3000, NULL, 0 },
+    { "ambient",        &g_page_ambient,    3000, NULL, 0 },
+    { "calendar",       &g_page_calendar,   3500, BENCH_SCRIPT(script_list_scroll) },
+    { "world",          &g_page_world,      3500, BENCH_SCRIPT(script_list_scroll) },
+    { "nav_reverse",    &g_page_main_menu,  3000, BENCH_SCRIPT(script_nav_reverse) },
+};
+
+/* 绘制调用计数 --------------------------------------------------------------*/
+
+static uint32_t bench_draw_calls = 0;   ///< 当前循环中的 draw 调用次数
+static uint32_t bench_glyphs = 0;       ///< 当前循环中经字体解码绘制的字符数
+static uint32_t bench_frames_done = 0;  ///< 当前循环中完成的帧数
+static uint32_t bench_frame_hash = BENCH_FNV_OFFSET; ///< 正在发送的帧的画面散列 (分页模式下逐条带累加)
+static uint32_t bench_scene_hash = BENCH_FNV_OFFSET; ///< 当前场景已完成各帧的散列
+
+static uint32_t bench_fnv(uint32_t h, const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        h = (h ^ data[i]) * BENCH_FNV_PRIME;
+    }
+    return h;
+}
+
+#if BENCH_WRAP
+/*
+ * u8g2 的字符串、字形和缓冲区发送函数由链接器 --wrap 转到这里 (见 Sim/CMakeLists.txt)：
+ * 只有 App 层和适配层的调用经过包装，u8g2 内部的调用不受影响。
+ */
+u8g2_uint_t __real_u8g2_DrawStr(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str);
+u8g2_uint_t __real_u8g2_DrawUTF8(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str);
+u8g2_uint_t __real_u8g2_DrawGlyph(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, uint16_t encoding);
+void __real_u8g2_SendBuffer(u8g2_t *u8g2);
+u8g2_uint_t __wrap_u8g2_DrawStr(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str);
+u8g2_uint_t __wrap_u8g2_DrawUTF8(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str);
+u8g2_uint_t __wrap_u8g2_DrawGlyph(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, uint16_t encoding);
+void __wrap_u8g2_SendBuffer(u8g2_t *u8g2);
+
+u8g2_uint_t __wrap_u8g2_DrawStr(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str)
+{
+    bench_glyphs += (uint32_t)strlen(str);
+    return __real_u8g2_DrawStr(u8g2, x, y, str);
+}
+
+u8g2_uint_t __wrap_u8g2_DrawUTF8(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str)
+{
+    for (const char *p = str; *p; p++) {
+        if (((uint8_t)*p & 0xC0U) != 0x80U) { // 不计后续字节
+            bench_glyphs++;
+        }
+    }
+    return __real_u8g2_DrawUTF8(u8g2, x, y, str);
+}
+
+u8g2_uint_t __wrap_u8g2_DrawGlyph(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, uint16_t encoding)
+{
+    bench_glyphs++;
+    return __real_u8g2_DrawGlyph(u8g2, x, y, encoding);
+}
+
+/**
+ * @brief 分页模式下由适配层逐条带调用，把条带的位置和内容计入本帧的散列
+ */
+void __wrap_u8g2_SendBuffer(u8g2_t *u8g2)
+{
+    uint8_t row = u8g2_GetBufferCurrTileRow(u8g2);
+    uint32_t len = (uint32_t)u8g2_GetBufferTileHeight(u8g2) * u8g2_GetBufferTileWidth(u8g2) * 8U;
+
+    bench_frame_hash = bench_fnv(bench_frame_hash, &row, 1);
+    bench_frame_hash = bench_fnv(bench_frame_hash, u8g2_GetBufferPtr(u8g2), len);
+    __real_u8g2_SendBuffer(u8g2);
+}
+#endif /* BENCH_WRAP */
+
+/**
+ * @brief 覆盖弱定义的绘制通知，用于统计 draw 调用次数
+ */
+void Page_Manager_DrawCallback(const Page_Base *page)
+{
+    (void)page;
+    bench_draw_calls++;
+}
+
+/**
+ * @brief 覆盖弱定义的整帧刷新完成回调，用于统计帧数和结束本帧的散列
+ * @details 整帧模式下散列取影子副本 (刷新完成后即屏幕上的画面) 和显示起始行。
+ */
+void u8g2_stm32_FlushCpltCallback(void)
+{
+#if U8G2_BUFFER_MODE == 0
+    uint8_t line;
+    const uint8_t *shadow = u8g2_stm32_GetShadow(&line);
+
+    bench_frame_hash = bench_fnv(bench_frame_hash, &line, 1);
+    bench_frame_hash = bench_fnv(bench_frame_hash, shadow, U8G2_FRAME_BUF_SIZE);
+#endif
+    bench_scene_hash = bench_fnv(bench_scene_hash, (const uint8_t *)&bench_frame_hash, sizeof(bench_frame_hash));
+    bench_frame_hash = BENCH_FNV_OFFSET;
+    bench_frames_done++;
+}
+
+/* 测量 ----------------------------------------------------------------------*/
+
+static uint64_t host_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 代替主循环的系统任务发布时间主题并分发通知
+ * @details 仿真只运行页面管理器，时间主题在这里按缓存中的纪元秒发布 (与 app_main.c 的 publish_time 相同)。
+ * @return 无
+ */
+static void bench_bus_service(void)
+{
+    static Epoch_t last;
+    static uint32_t last_day;
+    static bool last_valid;
+    DS3231_Cache_Snap_t snap;
+
+    if (DS3231_Cache_Get(&snap) && (!last_valid || snap.epoch != last)) {
+        app_bus_publish(APP_BUS_TIME_SECOND);
+        if (!last_valid || snap.epoch / 60 != last / 60) {
+            uint32_t day = Time_Apply_Dst(snap.epoch, g_app_settings.dst_enabled) / TIME_SECS_PER_DAY;
+
+            app_bus_publish(APP_BUS_TIME_MINUTE);
+            if (!last_valid || day != last_day) {
+                app_bus_publish(APP_BUS_TIME_DAY);
+                last_day = day;
+            }
+        }
+        last = snap.epoch;
+        last_valid = true;
+    }
+    app_bus_service();
+}
+
+/**
+ * @brief 不做测量地运行主循环
+ * @param[in] ms 运行时长 (虚拟时间)
+ * @return 无
+ */
+static void bench_run_idle(uint32_t ms)
+{
+    for (uint32_t t = 0; t < ms; t++) {
+        Sim_Advance(1);
+        bench_bus_service();
+        Page_Manager_Loop();
+    }
+}
+
+/**
+ * @brief 运行一个场景并统计
+ * @param[in] sc 场景
+ * @param[out] res 结果
+ * @return 无
+ */
+static void bench_run(const Bench_Scenario_t *sc, Bench_Result_t *res)
+{
+    uint8_t step = 0;
+    uint32_t next_step_ms = sc->step_count ? sc->steps[0].delay_ms : 0;
+
+    memset(res, 0, sizeof(*res));
+
+    Page_Manager_Go_Home();
+    bench_run_idle(BENCH_SETTLE_MS);
+    // 画面散列从切换到被测页面开始，静态页面 (测量期间没有新的帧) 也能比较进入时的画面
+    bench_scene_hash = BENCH_FNV_OFFSET;
+    bench_frame_hash = BENCH_FNV_OFFSET;
+    if (sc->page) {
+        Switch_Page(sc->page);
+        bench_run_idle(BENCH_SETTLE_MS);
+    }
+    if (sc->replay) {
+        (void)Input_Replay_Play();
+    }
+
+    for (uint32_t t = 0; t < sc->duration_ms; t++) {
+        Sim_Bus_Stats_t bus;
+
+        if (step < sc->step_count && t >= next_step_ms) {
+            Sim_Input_Push(sc->steps[step].event, sc->steps[step].value);
+            step++;
+            if (step < sc->step_count) {
+                next_step_ms += sc->steps[step].delay_ms;
+            }
+        }
+
+        Sim_Advance(1);
+        Sim_Bus_Reset_Stats();
+        bench_draw_calls = 0;
+        bench_glyphs = 0;
+        bench_frames_done = 0;
+
+        bench_bus_service();
+        uint64_t t0 = host_ns();
+        Page_Manager_Loop();
+        uint64_t dt = host_ns() - t0;
+
+        if (bench_frames_done == 0) {
+            continue;
+        }
+        Sim_Bus_Get_Stats(BENCH_OLED_ADDR, &bus);
+        res->frames += bench_frames_done;
+        res->render_ns_sum += dt;
+        if (dt > res->render_ns_max) {
+            res->render_ns_max = dt;
+        }
+        res->draw_calls += bench_draw_calls;
+        res->glyphs += bench_glyphs;
+        res->bytes_sum += bus.bytes;
+        res->txns_sum += bus.txns;
+        if (bus.bytes > res->bytes_max) {
+            res->bytes_max = bus.bytes;
+        }
+    }
+    res->hash = bench_scene_hash;
+}
+
+/**
+ * @brief 运行耐久测试
+ * @details 每次循环推进到页面管理器下一次需要运行的时刻 (至少1ms)，回放的事件最多晚到几毫秒，
+ *          按到期时刻打上时间戳，不影响导航。设置的后台写入和I2C队列照常推进，
+ *          帧耗时为产生该帧的 Page_Manager_Loop 的主机耗时。
+ * @param[in] hours 运行时长 (虚拟时间，小时)
+ * @return bool 判定通过时返回 true
+ */
+static bool bench_soak(double hours)
+{
+    uint64_t end_ms = (uint64_t)(hours * 3600000.0);
+    uint64_t t = 0;
+    App_Soak_Report_t r;
+
+    while (t < end_ms) {
+        uint32_t now = HAL_GetTick();
+        uint32_t step = Page_Manager_Next_Due(now) - now;
+
+        step = (step == 0 || step > 5) ? 1 : step; // 已经到期或截止时间在回绕之后
+        Sim_Advance(step);
+        t += step;
+        bench_bus_service();
+        I2C_Bus_Service();
+        (void)app_settings_service();
+        app_soak_service();
+
+        bench_frames_done = 0;
+        uint64_t t0 = host_ns();
+        Page_Manager_Loop();
+        uint64_t dt = host_ns() - t0;
+        if (bench_frames_done != 0) {
+            app_soak_frame((uint32_t)(dt / 1000U));
+        }
+    }
+    app_soak_print();
+    return app_soak_report(&r);
+}
+
+/**
+ * @brief 估算一帧的总线时间
+ * @details 每个字节9个时钟 (8位 + ACK)，每个事务额外计入起始、设备地址和停止约 10 个时钟。
+ * @return uint32_t 估算值 (us)
+ */
+static uint32_t bench_bus_us(uint32_t bytes, uint32_t txns)
+{
+    return (uint32_t)(((uint64_t)bytes * 9U + (uint64_t)txns * 10U) * 1000000U / SIM_I2C_BUS_HZ);
+}
+
+/**
+ * @brief 载入录制的输入
+ * @details 文件为连续的 8 字节小端记录 (Input_Replay_Rec_t)，与目标板上的录制相同。
+ * @param[in] path 文件路径
+ * @param[out] duration_ms 回放的总时长 (最后一个事件的时刻)
+ * @return bool 载入了至少一个事件时返回 true
+ */
+static bool bench_load_replay(const char *path, uint32_t *duration_ms)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t b[8];
+    uint8_t n = 0;
+
+    *duration_ms = 0;
+    if (f == NULL) {
+        return false;
+    }
+    while (fread(b, 1, sizeof(b), f) == sizeof(b)) {
+        Input_Replay_Rec_t rec;
+        rec.dt_ms = (uint16_t)(b[0] | (b[1] << 8));
+        rec.event = (uint16_t)(b[2] | (b[3] << 8));
+        rec.value = (int16_t)(b[4] | (b[5] << 8));
+        rec.accel_value = (int16_t)(b[6] | (b[7] << 8));
+        if (!Input_Replay_Put(n, &rec)) {
+            break;
+        }
+        *duration_ms += rec.dt_ms;
+        n++;
+    }
+    fclose(f);
+    return n > 0;
+}
+
+/**
+ * @brief 读取基线文件
+ * @details 每行一个场景：名称 帧数 画面散列(十六进制) draw调用 字形 推送字节，# 开头的行为注释。
+ * @param[in] path 文件路径
+ * @param[out] base 记录
+ * @param[in] max 最多读取的记录数
+ * @return int 读到的记录数，文件无法打开时返回 -1
+ */
+static int bench_load_baseline(const char *path, Bench_Baseline_t *base, int max)
+{
+    FILE *f = fopen(path, "r");
+    char line[128];
+    int n = 0;
+
+    if (f == NULL) {
+        return -1;
+    }
+    while (n < max && fgets(line, sizeof(line), f) != NULL) {
+        Bench_Baseline_t *b = &base[n];
+        if (line[0] == '#') {
+            continue;
+        }
+        if (sscanf(line, "%31s %lu %lx %lu %lu %lu", b->name, &b->frames, &b->hash, &b->draw_calls,
+                   &b->glyphs, &b->bytes) == 6) {
+            n++;
+        }
+    }
+    fclose(f);
+    return n;
+}
+
+/**
+ * @brief 检查一项开销是否超过基线的允许范围
+ * @return bool 超过时返回 true 并输出说明
+ */
+static bool bench_cost_regressed(const char *scenario, const char *what, unsigned long base, unsigned long now,
+                                 double threshold)
+{
+    if ((double)now <= (double)base * (1.0 + threshold / 100.0)) {
+        return false;
+    }
+    fprintf(stderr, "FAIL %s: %s %lu -> %lu (+%.1f%%)\n", scenario, what, base, now,
+            base ? ((double)now - (double)base) * 100.0 / (double)base : 100.0);
+    return true;
+}
+
+/**
+ * @brief 把一个场景的结果与基线比较
+ * @return bool 画面变化或开销超标时返回 false
+ */
+static bool bench_check(const char *scenario, const Bench_Result_t *r, const Bench_Baseline_t *base, int count,
+                        double threshold)
+{
+    const Bench_Baseline_t *b = NULL;
+    bool ok = true;
+
+    for (int i = 0; i < count; i++) {
+        if (strcmp(base[i].name, scenario) == 0) {
+            b = &base[i];
+            break;
+        }
+    }
+    if (b == NULL) {
+        fprintf(stderr, "NOTE %s: not in baseline\n", scenario);
+        return true;
+    }
+    if (b->frames != r->frames || b->hash != r->hash) {
+        fprintf(stderr, "FAIL %s: output changed (frames %lu -> %lu, hash %08lx -> %08lx)\n", scenario,
+                b->frames, (unsigned long)r->frames, b->hash, (unsigned long)r->hash);
+        ok = false;
+    }
+    ok &= !bench_cost_regressed(scenario, "draw calls", b->draw_calls, r->draw_calls, threshold);
+    ok &= !bench_cost_regressed(scenario, "glyphs", b->glyphs, r->glyphs, threshold);
+    ok &= !bench_cost_regressed(scenario, "bytes", b->bytes, r->bytes_sum, threshold);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    bool csv = false;
+    const char *replay_path = NULL;
+    const char *save_path = NULL;
+    const char *check_path = NULL;
+    double threshold = BENCH_THRESHOLD;
+    double soak_hours = 0;
+    uint32_t count = sizeof(bench_scenarios) / sizeof(bench_scenarios[0]);
+    Bench_Scenario_t replay = { "replay", NULL, 0, NULL, 0, true };
+    Bench_Baseline_t base[sizeof(bench_scenarios) / sizeof(bench_scenarios[0]) + 1];
+    int base_count = 0;
+    FILE *save = NULL;
+    bool pass = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            save_path = argv[++i];
+        } else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc) {
+            check_path = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--soak") == 0 && i + 1 < argc) {
+            soak_hours = atof(argv[++i]);
+        }
+    }
+
+    if (soak_hours > 0) {
+        app_soak_init(); // 先把虚拟时钟拨到回绕之前，各模块按拨过的时间初始化
+        I2C_Bus_Init(&hi2c1);
+        u8g2Init(&u8g2);
+        app_settings_init();
+        app_astro_init();
+        app_lunar_init();
+        app_sensor_update(AHT20_Get_Last(), true);
+        Page_Manager_Init(&u8g2);
+        input_init(&htim3, &htim2);
+        return bench_soak(soak_hours) ? 0 : 1;
+    }
+
+    if ((check_path != NULL || save_path != NULL) && !BENCH_WRAP) {
+        fprintf(stderr, "--save/--check need the default build profile (glyph counting uses ld --wrap)\n");
+        return 1;
+    }
+    if (check_path != NULL) {
+        base_count = bench_load_baseline(check_path, base, (int)(sizeof(base) / sizeof(base[0])));
+        if (base_count < 0) {
+            fprintf(stderr, "cannot read baseline %s\n", check_path);
+            return 1;
+        }
+    }
+    if (save_path != NULL) {
+        save = fopen(save_path, "w");
+        if (save == NULL) {
+            fprintf(stderr, "cannot write baseline %s\n", save_path);
+            return 1;
+        }
+        fprintf(save, "# scenario frames hash draw_calls glyphs bytes (U8G2_BUFFER_MODE=%d)\n", U8G2_BUFFER_MODE);
+    }
+
+    I2C_Bus_Init(&hi2c1);
+    u8g2Init(&u8g2);
+    app_settings_init();
+    app_astro_init();
+    app_lunar_init();
+    app_sensor_update(AHT20_Get_Last(), true); // 仿真不运行主循环的采样，直接输入固定的测量值
+    Page_Manager_Init(&u8g2);
+    input_init(&htim3, &htim2);
+
+    if (replay_path != NULL) {
+        if (!bench_load_replay(replay_path, &replay.duration_ms)) {
+            fprintf(stderr, "cannot load input recording %s\n", replay_path);
+            return 1;
+        }
+        replay.duration_ms += BENCH_SETTLE_MS; // 最后一个事件之后的动画也计入
+        count++;
+    }
+
+    if (csv) {
+        printf("scenario,frames,fps,render_avg_us,render_max_us,draws_per_frame,bytes_avg,bytes_max,bus_avg_us,"
+               "glyphs_per_frame,hash\n");
+    } else {
+        printf("%-15s %6s %5s %10s %10s %6s %9s %9s %9s %7s %8s\n", "scenario", "frames", "fps",
+               "render_us", "max_us", "draws", "bytes", "max_B", "bus_us", "glyphs", "hash");
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const Bench_Scenario_t *sc = (replay_path != NULL && i == count - 1) ? &replay : &bench_scenarios[i];
+        Bench_Result_t r;
+        bench_run(sc, &r);
+
+        uint32_t n = r.frames ? r.frames : 1;
+        double fps = r.frames * 1000.0 / sc->duration_ms;
+        double render_avg = r.render_ns_sum / 1000.0 / n;
+        double render_max = r.render_ns_max / 1000.0;
+        double draws = (double)r.draw_calls / n;
+        double glyphs = (double)r.glyphs / n;
+        uint32_t bytes_avg = r.bytes_sum / n;
+        uint32_t bus_avg = bench_bus_us(r.bytes_sum, r.txns_sum) / n;
+
+        if (csv) {
+            printf("%s,%lu,%.1f,%.1f,%.1f,%.2f,%lu,%lu,%lu,%.2f,%08lx\n", sc->name, (unsigned long)r.frames, fps,
+                   render_avg, render_max, draws, (unsigned long)bytes_avg, (unsigned long)r.bytes_max,
+                   (unsigned long)bus_avg, glyphs, (unsigned long)r.hash);
+        } else {
+            printf("%-15s %6lu %5.1f %10.1f %10.1f %6.2f %9lu %9lu %9lu %7.2f %08lx\n", sc->name,
+                   (unsigned long)r.frames, fps, render_avg, render_max, draws, (unsigned long)bytes_avg,
+                   (unsigned long)r.bytes_max, (unsigned long)bus_avg, glyphs, (unsigned long)r.hash);
+        }
+        if (save != NULL) {
+            fprintf(save, "%s %lu %08lx %lu %lu %lu\n", sc->name, (unsigned long)r.frames, (unsigned long)r.hash,
+                    (unsigned long)r.draw_calls, (unsigned long)r.glyphs, (unsigned long)r.bytes_sum);
+        }
+        if (check_path != NULL) {
+            pass &= bench_check(sc->name, &r, base, base_count, threshold);
+        }
+    }
+
+    if (save != NULL) {
+        fclose(save);
+    }
+    if (check_path != NULL) {
+        fprintf(stderr, pass ? "baseline check passed\n" : "baseline check FAILED\n");
+    }
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file      sim.h
+ * @brief     主机仿真环境接口
+ * @details   仿真用的驱动桩 (sim_*.c) 和基准测试程序之间的接口：
+ *            - 虚拟时钟：HAL_GetTick() 只由 Sim_Advance() 推进，结果与主机速度无关；
+ *            - 虚拟I2C总线：事务立即完成，按设备地址统计字节数；
+ *            - 输入注入：脚本事件直接写入输入队列。
+ * @author    SandOcean
+ * @date      2025-09-21
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __SIM_H
+#define __SIM_H
+
+#include "main.h"
+#include "DS3231.h"
+#include "input.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SIM_I2C_BUS_HZ 400000U ///< 仿真的I2C总线速率，用于估算传输时间
+
+/**
+ * @brief 单个I2C设备的总线流量统计
+ */
+typedef struct {
+    uint32_t txns;  ///< 事务数
+    uint32_t bytes; ///< 数据字节数 (含寄存器地址, 不含设备地址)
+} Sim_Bus_Stats_t;
+
+/**
+ * @brief 推进虚拟时钟
+ * @details 同时推进仿真RTC，每满1000ms走一秒。
+ * @param[in] ms 推进的毫秒数
+ * @return 无
+ */
+void Sim_Advance(uint32_t ms);
+
+/**
+ * @brief 设置仿真RTC的当前时间
+ * @param[in] time 时间
+ * @return 无
+ */
+void Sim_Rtc_Set(const Time_t *time);
+
+/**
+ * @brief 向输入队列注入一个事件
+ * @param[in] event 事件类型
+ * @param[in] value 事件值 (编码器为增量)
+ * @return bool 队列已满返回 false
+ */
+bool Sim_Input_Push(Input_Event_t event, int16_t value);
+
+/**
+ * @brief 获取某个设备的总线流量统计
+ * @param[in] dev_addr 设备8位地址
+ * @param[out] stats 统计结果
+ * @return 无
+ */
+void Sim_Bus_Get_Stats(uint16_t dev_addr, Sim_Bus_Stats_t *stats);
+
+/**
+ * @brief 清零所有设备的总线流量统计
+ * @return 无
+ */
+void Sim_Bus_Reset_Stats(void);
+
+#endif /* __SIM_H */
@@ -0,0 +1,80 @@
+/**
+ * @file      stm32f1xx_hal.h
+ * @brief     主机仿真用的 HAL 头文件
+ * @details   替代 STM32F1 HAL，被 CubeMX 生成的 Core/Inc/main.h 包含。只提供 App 层和
+ *            u8g2 适配层实际用到的 HAL 类型、常量和函数声明，使它们可以在 PC 上编译。
+ * @author    SandOcean
+ * @date      2025-09-21
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#ifndef __STM32F1xx_HAL_H
+#define __STM32F1xx_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0U,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct {
+    uint32_t IDR;
+    uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef struct {
+    void *Instance;
+} I2C_HandleTypeDef;
+
+typedef struct {
+    void *Instance;
+} TIM_HandleTypeDef;
+
+#define I2C_MEMADD_SIZE_8BIT  0x00000001U
+#define I2C_MEMADD_SIZE_16BIT 0x00000010U
+
+#define __weak          __attribute__((weak))
+#define __STATIC_INLINE static inline
+#define __NOP()         do { } while (0)
+#define __DMB()         do { } while (0)
+#define __WFI()         do { } while (0)
+#define __disable_irq() do { } while (0)
+#define __enable_irq()  do { } while (0)
+#define __get_PRIMASK() 0U
+#define __set_PRIMASK(x) ((void)(x))
+
+/* DWT 周期计数器，CYCCNT 随虚拟时钟推进 (Sim_Advance) */
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type sim_dwt;
+extern CoreDebug_Type sim_core_debug;
+extern uint32_t SystemCoreClock;
+extern volatile uint32_t uwTick; ///< 虚拟系统滴答 (ms)，与 HAL 一样可直接改写
+
+#define DWT                        (&sim_dwt)
+#define CoreDebug                  (&sim_core_debug)
+#define DWT_CTRL_CYCCNTENA_Msk     (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay);
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+
+#endif /* __STM32F1xx_HAL_H */
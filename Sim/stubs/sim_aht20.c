@@ -0,0 +1,84 @@
+/**
+ * @file      sim_aht20.c
+ * @brief     主机仿真用的 AHT20 驱动
+ * @details   与 Hardware/AHT20.h 接口一致，始终返回固定的 23.50℃ / 45.0%RH。
+ * @author    SandOcean
+ * @date      2025-09-21
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "AHT20.h"
+#include "sim.h"
+
+#define SIM_AHT20_TEMP_CDEG 2350 ///< 仿真温度 (0.01℃)
+#define SIM_AHT20_HUMI_PM   450  ///< 仿真湿度 (0.1%RH)
+
+static AHT20_Data_t sim_aht20_last = {
+    .temperature_cdeg = SIM_AHT20_TEMP_CDEG,
+    .humidity_pm = SIM_AHT20_HUMI_PM,
+    .timestamp = 0,
+    .valid = true,
+};
+
+HAL_StatusTypeDef AHT20_Init(I2C_HandleTypeDef *hi2c)
+{
+    (void)hi2c;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef AHT20_Soft_Reset(void)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef AHT20_Read_Temp_Humi(float *temperature, float *humidity)
+{
+    *temperature = SIM_AHT20_TEMP_CDEG / 100.0f;
+    *humidity = SIM_AHT20_HUMI_PM / 10.0f;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef AHT20_Read_Temp_Humi_Int(int16_t *temperature_cdeg, uint16_t *humidity_pm)
+{
+    *temperature_cdeg = SIM_AHT20_TEMP_CDEG;
+    *humidity_pm = SIM_AHT20_HUMI_PM;
+    return HAL_OK;
+}
+
+void AHT20_Begin(I2C_HandleTypeDef *hi2c)
+{
+    (void)hi2c;
+}
+
+bool AHT20_Is_Ready(void)
+{
+    return true;
+}
+
+HAL_StatusTypeDef AHT20_StartMeasurement(void)
+{
+    sim_aht20_last.timestamp = HAL_GetTick();
+    return HAL_OK;
+}
+
+bool AHT20_Poll(void)
+{
+    return false;
+}
+
+bool AHT20_Is_Measuring(void)
+{
+    return false;
+}
+
+const AHT20_Data_t *AHT20_Get_Last(void)
+{
+    return &sim_aht20_last;
+}
+
+bool AHT20_Read_Last(AHT20_Data_t *out)
+{
+    *out = sim_aht20_last;
+    return out->valid;
+}
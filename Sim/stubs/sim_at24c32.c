@@ -0,0 +1,88 @@
+/**
+ * @file      sim_at24c32.c
+ * @brief     主机仿真用的 AT24C32 驱动
+ * @details   与 Hardware/AT24C32.h 接口一致。EEPROM 为一块 RAM，初始内容为 0xFF
+ *            (与空白芯片一致，设置加载会回落到默认值)。异步操作在函数返回前完成并调用回调。
+ * @author    SandOcean
+ * @date      2025-10-06
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "AT24C32.h"
+#include <string.h>
+
+#define SIM_EEPROM_SIZE 4096 ///< AT24C32 容量 (字节)
+
+static uint8_t eeprom[SIM_EEPROM_SIZE];
+static bool eeprom_ready = false;
+
+static void eeprom_init(void)
+{
+    if (!eeprom_ready) {
+        memset(eeprom, 0xFF, sizeof(eeprom));
+        eeprom_ready = true;
+    }
+}
+
+HAL_StatusTypeDef AT24C32_WriteByte(uint16_t mem_addr, uint8_t data)
+{
+    return AT24C32_WritePage(mem_addr, &data, 1);
+}
+
+uint8_t AT24C32_ReadByte(uint16_t mem_addr)
+{
+    uint8_t data = 0xFF;
+    AT24C32_ReadPage(mem_addr, &data, 1);
+    return data;
+}
+
+HAL_StatusTypeDef AT24C32_WritePage(uint16_t mem_addr, uint8_t *data, uint16_t size)
+{
+    eeprom_init();
+    if ((uint32_t)mem_addr + size > SIM_EEPROM_SIZE) {
+        return HAL_ERROR;
+    }
+    memcpy(&eeprom[mem_addr], data, size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef AT24C32_ReadPage(uint16_t mem_addr, uint8_t *data, uint16_t size)
+{
+    eeprom_init();
+    if ((uint32_t)mem_addr + size > SIM_EEPROM_SIZE) {
+        return HAL_ERROR;
+    }
+    memcpy(data, &eeprom[mem_addr], size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef AT24C32_WritePage_Async(uint16_t mem_addr, uint8_t *data, uint16_t size,
+                                          I2C_Bus_Callback_t cb, void *ctx)
+{
+    HAL_StatusTypeDef status = AT24C32_WritePage(mem_addr, data, size);
+    if (status == HAL_OK && cb != NULL) {
+        cb(status, ctx); // 仿真中没有写周期，立即完成
+    }
+    return status;
+}
+
+HAL_StatusTypeDef AT24C32_ReadPage_Async(uint16_t mem_addr, uint8_t *data, uint16_t size,
+                                         I2C_Bus_Callback_t cb, void *ctx)
+{
+    HAL_StatusTypeDef status = AT24C32_ReadPage(mem_addr, data, size);
+    if (status == HAL_OK && cb != NULL) {
+        cb(status, ctx);
+    }
+    return status;
+}
+
+HAL_StatusTypeDef AT24C32_WritePage_Emergency(uint16_t mem_addr, const uint8_t *data, uint16_t size)
+{
+    return AT24C32_WritePage(mem_addr, (uint8_t *)data, size);
+}
+
+bool AT24C32_Is_Busy(void)
+{
+    return false;
+}
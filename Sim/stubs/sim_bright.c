@@ -0,0 +1,16 @@
+/**
+ * @file      sim_bright.c
+ * @brief     主机仿真用的亮度上限
+ * @details   与 App/app_bright.h 中 app_bright_set_cap() 的接口一致。仿真不调节对比度，低电量模式的亮度限制为空操作。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_bright.h"
+
+void app_bright_set_cap(uint8_t cap)
+{
+    (void)cap;
+}
@@ -0,0 +1,25 @@
+/**
+ * @file      sim_crc.c
+ * @brief     主机仿真用的硬件 CRC
+ * @details   与 Hardware/hw_crc.h 接口一致，按 CRC 单元的算法 (CRC-32/MPEG-2，按字从高位起) 逐位计算，
+ *            仿真写出的 EEPROM 记录与真机相同。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "hw_crc.h"
+
+uint32_t HW_CRC32(const uint32_t *words, uint16_t count)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+
+    while (count-- > 0) {
+        crc ^= *words++;
+        for (uint8_t i = 0; i < 32; i++) {
+            crc = (crc & 0x80000000U) ? (crc << 1) ^ 0x04C11DB7U : (crc << 1);
+        }
+    }
+    return crc;
+}
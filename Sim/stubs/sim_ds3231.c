@@ -0,0 +1,194 @@
+/**
+ * @file      sim_ds3231.c
+ * @brief     主机仿真用的 DS3231 驱动
+ * @details   与 Hardware/DS3231.h 接口一致。时间由设置值加上虚拟时钟经过的秒数得到。
+ * @author    SandOcean
+ * @date      2025-09-21
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "DS3231.h"
+#include "sim.h"
+#include <string.h>
+#include <time.h>
+
+static time_t rtc_base = 0;       ///< Sim_Rtc_Set 设置的时间 (UTC 秒)
+static uint32_t rtc_base_tick = 0; ///< 设置时刻的虚拟时钟
+
+/**
+ * @brief 在 Time_t 和 struct tm 之间转换，星期按 DS3231 的 1=周一, 7=周日
+ */
+static void tm_to_time(const struct tm *tm, Time_t *time)
+{
+    time->year = (uint16_t)(tm->tm_year + 1900);
+    time->month = (uint8_t)(tm->tm_mon + 1);
+    time->day = (uint8_t)tm->tm_mday;
+    time->hour = (uint8_t)tm->tm_hour;
+    time->minute = (uint8_t)tm->tm_min;
+    time->second = (uint8_t)tm->tm_sec;
+    time->week = (uint8_t)(tm->tm_wday == 0 ? 7 : tm->tm_wday);
+}
+
+static time_t sim_rtc_now(void)
+{
+    if (rtc_base == 0) {
+        struct tm tm = { .tm_year = 2025 - 1900, .tm_mon = 8, .tm_mday = 21, .tm_hour = 12 };
+        rtc_base = timegm(&tm);
+        rtc_base_tick = HAL_GetTick();
+    }
+    return rtc_base + (time_t)((HAL_GetTick() - rtc_base_tick) / 1000U);
+}
+
+/**
+ * @brief 设置仿真RTC的当前时间
+ * @param[in] time 时间
+ * @return 无
+ */
+void Sim_Rtc_Set(const Time_t *time)
+{
+    struct tm tm = {
+        .tm_year = time->year - 1900,
+        .tm_mon = time->month - 1,
+        .tm_mday = time->day,
+        .tm_hour = time->hour,
+        .tm_min = time->minute,
+        .tm_sec = time->second,
+    };
+    rtc_base = timegm(&tm);
+    rtc_base_tick = HAL_GetTick();
+}
+
+void DS3231_Init(I2C_HandleTypeDef *hi2c)
+{
+    (void)hi2c;
+}
+
+void DS3231_SetTime(Time_t *time)
+{
+    Sim_Rtc_Set(time);
+}
+
+HAL_StatusTypeDef DS3231_SetTimeSync(Epoch_t epoch, uint32_t ref_ms)
+{
+    Time_t time;
+
+    Time_From_Epoch(epoch, &time);
+    Sim_Rtc_Set(&time);
+    rtc_base_tick = ref_ms; // 虚拟时钟没有写入延迟，直接采用参考时间的秒相位
+    return HAL_OK;
+}
+
+bool DS3231_SetTimeSync_Pending(void)
+{
+    return false;
+}
+
+void DS3231_Tick_Handler(void)
+{
+}
+
+void DS3231_GetTime(Time_t *time)
+{
+    time_t now = sim_rtc_now();
+    struct tm tm;
+    gmtime_r(&now, &tm);
+    tm_to_time(&tm, time);
+}
+
+void DS3231_DST_GetTime(Time_t *time, bool dst_enabled)
+{
+    DS3231_GetTime(time);
+    Time_From_Epoch(Time_Apply_Dst(Time_To_Epoch(time), dst_enabled), time);
+}
+
+float DS3231_GetTemperature(void)
+{
+    return 25.0f;
+}
+
+HAL_StatusTypeDef DS3231_GetTemperature_x4(int16_t *temp_x4)
+{
+    *temp_x4 = 25 * 4;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef DS3231_Snapshot(DS3231_Snapshot_t *snap)
+{
+    memset(snap, 0, sizeof(*snap));
+    DS3231_GetTime(&snap->time);
+    snap->temp_x4 = 25 * 4;
+    return HAL_OK;
+}
+
+void DS3231_SetTimeFromCompileTime(void)
+{
+}
+
+HAL_StatusTypeDef DS3231_EnableSqw1Hz(void)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef DS3231_SetAlarm(uint8_t index, const DS3231_Alarm_t *alarm)
+{
+    (void)alarm;
+    return (index == 1 || index == 2) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef DS3231_EnableAlarmInterrupt(uint8_t index, bool enable)
+{
+    (void)enable;
+    return (index == 1 || index == 2) ? HAL_OK : HAL_ERROR;
+}
+
+void DS3231_Cache_Resync(void)
+{
+}
+
+void DS3231_Cache_Service(void)
+{
+}
+
+void DS3231_GetCachedTime(Time_t *time)
+{
+    DS3231_GetTime(time);
+}
+
+Epoch_t DS3231_GetCachedEpoch(void)
+{
+    Time_t time;
+    DS3231_GetTime(&time);
+    return Time_To_Epoch(&time);
+}
+
+bool DS3231_Cache_Get(DS3231_Cache_Snap_t *snap)
+{
+    uint32_t elapsed = HAL_GetTick() - rtc_base_tick;
+
+    snap->epoch = DS3231_GetCachedEpoch();
+    snap->edge_ms = rtc_base_tick + elapsed / 1000U * 1000U;
+    snap->ticks = elapsed / 1000U + 1U;
+    snap->valid = true;
+    return true;
+}
+
+void DS3231_DST_GetCachedTime(Time_t *time, bool dst_enabled)
+{
+    DS3231_DST_GetTime(time, dst_enabled);
+}
+
+void DS3231_SQW_IRQ_Handler(void)
+{
+}
+
+bool DS3231_SQW_Get_Last_Edge(uint32_t *edge_ms)
+{
+    *edge_ms = rtc_base_tick + (HAL_GetTick() - rtc_base_tick) / 1000U * 1000U;
+    return true;
+}
+
+uint32_t DS3231_SQW_Get_Period(void)
+{
+    return DS3231_SQW_PERIOD_MS;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file      sim_hal.c
+ * @brief     主机仿真用的 HAL 替代实现
+ * @details   虚拟时钟只由 Sim_Advance() 推进；HAL_Delay() 直接推进虚拟时钟，不占用主机时间。
+ * @author    SandOcean
+ * @date      2025-09-21
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+I2C_HandleTypeDef hi2c1;
+TIM_HandleTypeDef htim2;
+TIM_HandleTypeDef htim3;
+
+DWT_Type sim_dwt;
+CoreDebug_Type sim_core_debug;
+uint32_t SystemCoreClock = 72000000U;
+
+volatile uint32_t uwTick = 0; ///< 虚拟系统滴答 (ms)
+
+uint32_t HAL_GetTick(void)
+{
+    return uwTick;
+}
+
+void HAL_Delay(uint32_t delay)
+{
+    Sim_Advance(delay);
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    (void)port;
+    (void)pin;
+    (void)state;
+}
+
+void Error_Handler(void)
+{
+    fprintf(stderr, "Error_Handler called\n");
+    abort();
+}
+
+/**
+ * @brief 推进虚拟时钟
+ * @param[in] ms 推进的毫秒数
+ * @return 无
+ */
+void Sim_Advance(uint32_t ms)
+{
+    uwTick += ms;
+    sim_dwt.CYCCNT += ms * (SystemCoreClock / 1000U);
+}
@@ -0,0 +1,150 @@
+/**
+ * @file      sim_i2c_bus.c
+ * @brief     主机仿真用的 I2C 总线管理模块
+ * @details   与 Hardware/i2c_bus.h 接口一致。所有事务立即成功完成 (回调在提交函数内调用)，
+ *            读事务返回全零数据，同时按设备地址统计事务数和字节数。
+ *            总线速率固定为 SIM_I2C_BUS_HZ，速率设置和校准不改变时间估算。
+ * @author    SandOcean
+ * @date      2025-09-21
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "i2c_bus.h"
+#include "sim.h"
+#include <string.h>
+
+#define SIM_BUS_MAX_DEVICES 8 ///< 可分别统计的设备数
+
+static struct {
+    uint16_t dev_addr;
+    Sim_Bus_Stats_t stats;
+} sim_bus_dev[SIM_BUS_MAX_DEVICES];
+
+/**
+ * @brief 执行一个事务并计入统计
+ * @param[in] txn 事务描述
+ * @return 无
+ */
+static void sim_bus_execute(const I2C_Bus_Txn_t *txn)
+{
+    uint32_t bytes = txn->size;
+
+    if (txn->op == I2C_BUS_OP_MEM_WRITE || txn->op == I2C_BUS_OP_MEM_READ) {
+        bytes += (txn->mem_addr_size == I2C_MEMADD_SIZE_16BIT) ? 2 : 1;
+    }
+    if ((txn->op == I2C_BUS_OP_RX || txn->op == I2C_BUS_OP_MEM_READ) && txn->data) {
+        memset(txn->data, 0, txn->size);
+    }
+
+    for (uint8_t i = 0; i < SIM_BUS_MAX_DEVICES; i++) {
+        if (sim_bus_dev[i].dev_addr == txn->dev_addr || sim_bus_dev[i].stats.txns == 0) {
+            sim_bus_dev[i].dev_addr = txn->dev_addr;
+            sim_bus_dev[i].stats.txns++;
+            sim_bus_dev[i].stats.bytes += bytes;
+            return;
+        }
+    }
+}
+
+void I2C_Bus_Init(I2C_HandleTypeDef *hi2c)
+{
+    (void)hi2c;
+    Sim_Bus_Reset_Stats();
+}
+
+HAL_StatusTypeDef I2C_Bus_Attach(I2C_HandleTypeDef *hi2c, uint16_t dev_addr)
+{
+    (void)hi2c;
+    (void)dev_addr;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef I2C_Bus_Submit(const I2C_Bus_Txn_t *txn, I2C_Bus_Prio_e prio)
+{
+    (void)prio;
+
+    if (!txn || prio >= I2C_BUS_PRIO_COUNT) {
+        return HAL_ERROR;
+    }
+    sim_bus_execute(txn);
+    if (txn->cb) {
+        txn->cb(HAL_OK, txn->ctx);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef I2C_Bus_Transfer(const I2C_Bus_Txn_t *txn, I2C_Bus_Prio_e prio, uint32_t timeout)
+{
+    (void)timeout;
+
+    if (!txn || prio >= I2C_BUS_PRIO_COUNT) {
+        return HAL_ERROR;
+    }
+    sim_bus_execute(txn);
+    return HAL_OK;
+}
+
+void I2C_Bus_Service(void)
+{
+}
+
+bool I2C_Bus_Is_Degraded(uint16_t dev_addr)
+{
+    (void)dev_addr;
+    return false;
+}
+
+bool I2C_Bus_Is_Idle(void)
+{
+    return true;
+}
+
+HAL_StatusTypeDef I2C_Bus_Set_Speed(uint16_t dev_addr, uint32_t hz)
+{
+    (void)dev_addr;
+    (void)hz;
+    return HAL_OK;
+}
+
+uint32_t I2C_Bus_Get_Speed(uint16_t dev_addr)
+{
+    (void)dev_addr;
+    return SIM_I2C_BUS_HZ;
+}
+
+uint32_t I2C_Bus_Calibrate(uint16_t dev_addr, uint32_t min_hz, uint32_t max_hz, I2C_Bus_Verify_t verify, void *ctx)
+{
+    (void)dev_addr;
+    (void)min_hz;
+    (void)max_hz;
+    (void)verify;
+    (void)ctx;
+    return SIM_I2C_BUS_HZ;
+}
+
+/**
+ * @brief 获取某个设备的总线流量统计
+ * @param[in] dev_addr 设备8位地址
+ * @param[out] stats 统计结果
+ * @return 无
+ */
+void Sim_Bus_Get_Stats(uint16_t dev_addr, Sim_Bus_Stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    for (uint8_t i = 0; i < SIM_BUS_MAX_DEVICES; i++) {
+        if (sim_bus_dev[i].stats.txns != 0 && sim_bus_dev[i].dev_addr == dev_addr) {
+            *stats = sim_bus_dev[i].stats;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 清零所有设备的总线流量统计
+ * @return 无
+ */
+void Sim_Bus_Reset_Stats(void)
+{
+    memset(sim_bus_dev, 0, sizeof(sim_bus_dev));
+}
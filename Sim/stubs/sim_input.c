@@ -0,0 +1,111 @@
+/**
+ * @file      sim_input.c
+ * @brief     主机仿真用的输入模块
+ * @details   与 Hardware/input.h 接口一致。没有按键扫描和编码器，
+ *            事件由 Sim_Input_Push() 直接写入队列，编码器的加速值与原始增量相同，
+ *            编码器的绝对位置为注入的编码器事件增量之和。
+ *            录制与回放使用与目标板相同的 input_replay 模块，接入方式与 Hardware/input.c 相同。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.2
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "input.h"
+#include "input_replay.h"
+#include "sim.h"
+
+static Input_Event_Data_t sim_fifo[INPUT_FIFO_SIZE];
+static uint8_t sim_head = 0;
+static uint8_t sim_tail = 0;
+static int32_t sim_position = 0;
+
+/**
+ * @brief 向输入队列注入一个事件
+ * @param[in] event 事件类型
+ * @param[in] value 事件值
+ * @return bool 队列已满返回 false
+ */
+bool Sim_Input_Push(Input_Event_t event, int16_t value)
+{
+    if ((uint8_t)(sim_head - sim_tail) >= INPUT_FIFO_SIZE) {
+        return false;
+    }
+    Input_Event_Data_t *slot = &sim_fifo[sim_head % INPUT_FIFO_SIZE];
+    slot->event = event;
+    slot->value = value;
+    slot->accel_value = value;
+    slot->timestamp = HAL_GetTick();
+    sim_head++;
+    if (event == INPUT_EVENT_ENCODER) {
+        sim_position += value;
+    }
+    Input_Replay_On_Push(slot);
+    return true;
+}
+
+void input_init(TIM_HandleTypeDef *htim_encoder, TIM_HandleTypeDef *htim_scan)
+{
+    (void)htim_encoder;
+    (void)htim_scan;
+    sim_head = sim_tail = 0;
+}
+
+uint8_t input_get_event(Input_Event_Data_t *event)
+{
+    if (Input_Replay_Mode() == INPUT_REPLAY_PLAYING) {
+        sim_tail = sim_head;
+        return Input_Replay_Pop(event) ? 1 : 0;
+    }
+    if (sim_head == sim_tail) {
+        return 0;
+    }
+    *event = sim_fifo[sim_tail % INPUT_FIFO_SIZE];
+    sim_tail++;
+    return 1;
+}
+
+void input_scan_timer_irq_handler(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+void input_exti_irq_handler(uint16_t GPIO_Pin)
+{
+    (void)GPIO_Pin;
+}
+
+int32_t encoder_get_position(void)
+{
+    return sim_position;
+}
+
+int32_t encoder_get_delta(int32_t *mark)
+{
+    int32_t delta = sim_position - *mark;
+
+    *mark = sim_position;
+    return delta;
+}
+
+uint8_t input_count_events(void)
+{
+    if (Input_Replay_Mode() == INPUT_REPLAY_PLAYING) {
+        return Input_Replay_Due();
+    }
+    return (uint8_t)(sim_head - sim_tail);
+}
+
+void input_clear_events(void)
+{
+    Input_Event_Data_t skipped;
+
+    sim_tail = sim_head;
+    while (Input_Replay_Pop(&skipped)) {
+    }
+}
+
+bool input_is_idle(void)
+{
+    return sim_head == sim_tail && Input_Replay_Due() == 0;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file      sim_power.c
+ * @brief     主机仿真用的功耗统计
+ * @details   与 App/app_power.h 中功耗统计部分的接口一致。仿真没有睡眠和停止模式，累计时间全部为0，
+ *            诊断页面的功耗视图显示为0%。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "app_power.h"
+#include <string.h>
+
+void Power_Set_Display(Power_Display_e state)
+{
+    (void)state;
+}
+
+void Power_Get_Residency(uint32_t ms[POWER_RES_COUNT])
+{
+    memset(ms, 0, sizeof(uint32_t) * POWER_RES_COUNT);
+}
+
+uint32_t Power_Estimate_uAh_Day(void)
+{
+    return 0;
+}
@@ -0,0 +1,35 @@
+/**
+ * @file      sim_supply.c
+ * @brief     主机仿真用的供电电压测量
+ * @details   与 Hardware/supply.h 接口一致。仿真没有 ADC，测量从不开始，低电量模式保持在正常等级。
+ * @author    SandOcean
+ * @date      2025-10-08
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "supply.h"
+
+void Supply_Init(void)
+{
+}
+
+bool Supply_Start(void)
+{
+    return false;
+}
+
+bool Supply_Take(uint16_t *mv)
+{
+    (void)mv;
+    return false;
+}
+
+bool Supply_Is_Busy(void)
+{
+    return false;
+}
+
+void Supply_Done_Callback(void)
+{
+}
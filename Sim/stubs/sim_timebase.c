@@ -0,0 +1,32 @@
+/**
+ * @file      sim_timebase.c
+ * @brief     主机仿真用的微秒时基
+ * @details   与 Hardware/timebase.h 接口一致，由虚拟时钟换算，虚拟时钟以毫秒推进，微秒部分始终为0。
+ * @author    SandOcean
+ * @date      2025-10-02
+ * @version   1.0
+ * @copyright Copyright (c) 2025 SandOcean
+ */
+
+#include "timebase.h"
+#include "sim.h"
+
+uint32_t Timebase_Read(uint32_t *us)
+{
+    uint32_t ms = HAL_GetTick();
+
+    if (us != NULL) {
+        *us = ms * 1000U;
+    }
+    return ms;
+}
+
+uint32_t Timebase_Us(void)
+{
+    return HAL_GetTick() * 1000U;
+}
+
+void Timebase_Delay_Us(uint32_t us)
+{
+    (void)us; // 虚拟时钟只按毫秒推进，短延时不计入
+}
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""打包外部闪存的资源块 (App/app_asset.h)，并经远程控制协议写入时钟的资源区。
+
+资源按 App_Asset_Id_e 的顺序排列，数据直接从固件源码中读出，不另外维护一份：
+    0 农历表：App/app_lunar.c 的 lunar_years[] (1999~2099 年，每年一个小端的字)
+块格式：标识 "ASST" 块长度 (4) 资源数 (2) CRC-16 (2，块头之后的全部字节)，之后每个资源一个索引项 (偏移 4、长度 4) 和数据。
+写入：REMOTE_CMD_ASSET_INFO 查询资源区容量 -> 擦除块所占的扇区 -> 每帧 16 字节写入 (全为 0xFF 的段跳过)
+-> REMOTE_CMD_ASSET_INFO 带参数 1 重新校验，块长度相符即完成。闪存忙 (擦除约 0.4s，或长期数据记录正在写入) 时重发。
+以 APP_ASSET_LUNAR=1 构建的固件在写入之前不显示农历日期。
+
+用法:
+    python3 Tools/asset_pack.py --out assets.bin
+    python3 Tools/asset_pack.py /dev/ttyUSB0                     # 需要 pyserial
+    python3 Tools/asset_pack.py /dev/ttyUSB0 --blob assets.bin
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import time
+
+from input_replay import Link
+from screen_mirror import crc16
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(__file__), ".."))
+LUNAR_C = os.path.join(ROOT, "App", "app_lunar.c")
+CMD_ASSET_INFO, CMD_ASSET_ERASE, CMD_ASSET_WRITE = 0x70, 0x71, 0x72
+MAGIC = 0x54535341
+HEADER = struct.Struct("<IIHH")
+ENTRY = struct.Struct("<II")
+INFO = struct.Struct("<IIB")
+SECTOR_SIZE = 4096
+PAGE_SIZE = 256
+WRITE_MAX = 16
+LUNAR_YEARS = 2099 - 1999 + 1
+BUSY_RETRY_S = 0.05
+BUSY_TIMEOUT_S = 1.0
+
+
+def lunar_years():
+    """从 app_lunar.c 读出农历表，返回资源的数据。"""
+    with open(LUNAR_C, encoding="utf-8") as f:
+        src = f.read()
+    body = re.search(r"lunar_years\[[^\]]*\]\s*=\s*\{(.*?)\};", src, re.S)
+    if not body:
+        sys.exit(f"{LUNAR_C}: lunar_years[] not found")
+    words = [int(v, 16) for v in re.findall(r"0x[0-9A-Fa-f]+", re.sub(r"//[^\n]*", "", body.group(1)))]
+    if len(words) != LUNAR_YEARS:
+        sys.exit(f"{LUNAR_C}: expected {LUNAR_YEARS} entries, found {len(words)}")
+    return struct.pack(f"<{len(words)}I", *words)
+
+
+def build():
+    """按编号顺序生成资源块。"""
+    assets = [lunar_years()]
+    data = bytearray()
+    index = bytearray()
+    offset = HEADER.size + ENTRY.size * len(assets)
+    for blob in assets:
+        index += ENTRY.pack(offset + len(data), len(blob))
+        data += blob
+    body = bytes(index + data)
+    return HEADER.pack(MAGIC, HEADER.size + len(body), len(assets), crc16(body)) + body
+
+
+def request(link, cmd, data=b""):
+    """发送请求，闪存忙时等待后重发。"""
+    deadline = time.monotonic() + BUSY_TIMEOUT_S
+    while True:
+        try:
+            return link.request(cmd, data)
+        except RuntimeError as e:
+            if not str(e).endswith("busy") or time.monotonic() > deadline:
+                raise
+            time.sleep(BUSY_RETRY_S)
+
+
+def upload(link, blob):
+    """擦除并写入资源块，再让时钟重新校验。"""
+    region, _length, known = INFO.unpack(request(link, CMD_ASSET_INFO))
+    if len(blob) > region:
+        sys.exit(f"blob is {len(blob)} bytes, the asset region holds {region}")
+    count = HEADER.unpack_from(blob)[2]
+    if known < count:
+        print(f"warning: firmware knows {known} of {count} assets", file=sys.stderr)
+    for offset in range(0, len(blob), SECTOR_SIZE):
+        request(link, CMD_ASSET_ERASE, struct.pack("<I", offset))
+    for offset in range(0, len(blob), WRITE_MAX):
+        chunk = blob[offset:offset + WRITE_MAX]  # WRITE_MAX 整除 PAGE_SIZE，一段不会跨页
+        if chunk.count(0xFF) != len(chunk):
+            request(link, CMD_ASSET_WRITE, struct.pack("<I", offset) + chunk)
+        if offset % (PAGE_SIZE * 16) == 0:
+            print(f"\r{offset * 100 // len(blob)}%", end="", flush=True)
+    _region, length, _known = INFO.unpack(request(link, CMD_ASSET_INFO, b"\x01"))
+    print("\r100%")
+    if length != len(blob):
+        sys.exit("verify failed: the clock rejected the asset blob")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", nargs="?", help="串口设备 (省略时只生成文件)")
+    parser.add_argument("--out", help="把资源块保存到文件")
+    parser.add_argument("--blob", help="写入已生成的资源块文件，而不是重新打包")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+    if not args.port and not args.out:
+        parser.error("give a serial port, --out, or both")
+
+    if args.blob:
+        with open(args.blob, "rb") as f:
+            blob = f.read()
+    else:
+        blob = build()
+    if args.out:
+        with open(args.out, "wb") as f:
+            f.write(blob)
+    print(f"asset blob: {len(blob)} bytes, {HEADER.unpack_from(blob)[2]} assets")
+
+    if args.port:
+        import serial  # pylint: disable=import-outside-toplevel
+        with serial.Serial(args.port, args.baud, timeout=0.05) as port:
+            upload(Link(port), blob)
+        print("asset region written and verified")
+
+
+if __name__ == "__main__":
+    main()
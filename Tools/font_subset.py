@@ -0,0 +1,287 @@
+#!/usr/bin/env python3
+"""从 u8g2 字库中裁剪出界面实际用到的字形，生成 App/app_fonts.c 和 App/app_fonts.h。
+
+要裁剪的字体由 App/app_display.h 中形如 `#define MENU_FONT APP_FONT(ncenB10_tr)` 的定义给出。
+扫描 App/ 和 App/UI_pages/ 下全部 .c 文件及其包含的 App 头文件中的字符串字面量，
+一个文件中出现的字符计入该文件引用的每个字体宏；数字、空格和常用标点 (运行时由 app_fmt 格式化的内容) 总是保留。
+App/app_i18n.c 中的多语言字符串表、App/app_lunar.c 中的农历月、日名称和 App/app_tzdb_data.c 中的时区名称计入所有字体。中文界面字体 (APP_I18N_FONT) 保留全部可打印 ASCII，
+以及字符串表中用到的汉字 (UTF-8 字面量按 Unicode 码位统计)。
+
+u8g2 字体中每个字形是独立的一条记录 (编码、记录长度、位流)，裁剪时原样复制保留的记录，
+重新计算字体头中 'A'、'a' 和 Unicode 段的起始偏移。Unicode 段 (码位 >= 0x100) 同样按记录裁剪，
+裁剪后只有一个查找表项。
+
+用法:
+    python3 Tools/font_subset.py                       # 默认读取 Hardware/OLED/u8g2/u8g2_fonts.c
+    python3 Tools/font_subset.py --fonts path/to/u8g2_fonts.c --extra "°"
+生成后在 Keil 的 App 组中加入 App/app_fonts.c，并把 app_display.h 中的 APP_DISPLAY_FONT_SUBSET 置1。
+界面文字改动后需要重新运行。
+"""
+
+import argparse
+import os
+import re
+import sys
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(__file__), ".."))
+DISPLAY_H = os.path.join(ROOT, "App", "app_display.h")
+SOURCE_DIRS = [os.path.join(ROOT, "App"), os.path.join(ROOT, "App", "UI_pages")]
+DEFAULT_FONTS = os.path.join(ROOT, "Hardware", "OLED", "u8g2", "u8g2_fonts.c")
+OUT_C = os.path.join(ROOT, "App", "app_fonts.c")
+OUT_H = os.path.join(ROOT, "App", "app_fonts.h")
+
+ALWAYS = b" 0123456789:-./%+"
+GLOBAL_SOURCES = ["app_i18n.c", "app_lunar.c", "app_tzdb_data.c"]  # 字符串计入所有字体的文件
+I18N_MACRO = "APP_I18N_FONT"     # 保留全部可打印 ASCII 的字体
+FONT_MACRO = re.compile(r"^#define\s+(\w+)\s+APP_FONT\((\w+)\)", re.M)
+HEADER_SIZE = 23  # U8G2_FONT_DATA_STRUCT_SIZE
+SIMPLE_ESCAPES = {"n": 10, "t": 9, "r": 13, "0": 0, "a": 7, "b": 8, "f": 12, "v": 11,
+                  "\\": 92, '"': 34, "'": 39, "?": 63}
+
+
+def unescape(body, encoding="utf-8"):
+    """C 字符串字面量内容 (不含引号) 转为字节，未转义的字符按 encoding 编码。"""
+    out = bytearray()
+    i = 0
+    while i < len(body):
+        c = body[i]
+        if c != "\\":
+            out += c.encode(encoding)
+            i += 1
+            continue
+        i += 1
+        m = re.match(r"[0-7]{1,3}", body[i:])
+        if m:
+            out.append(int(m.group(0), 8) & 0xFF)
+            i += len(m.group(0))
+        elif body[i] == "x":
+            m = re.match(r"[0-9a-fA-F]+", body[i + 1:])
+            out.append(int(m.group(0), 16) & 0xFF)
+            i += 1 + len(m.group(0))
+        else:
+            out.append(SIMPLE_ESCAPES.get(body[i], ord(body[i])))
+            i += 1
+    return bytes(out)
+
+
+def code_points(literal):
+    """字面量的字符集合：合法的 UTF-8 按码位，否则按字节 (如 "\\260" 是 Latin-1 的度数符号)。"""
+    try:
+        return {ord(c) for c in literal.decode("utf-8")}
+    except UnicodeDecodeError:
+        return set(literal)
+
+
+def split_source(text):
+    """返回 (去掉注释和字面量后的代码, [字符串字面量的字节])。"""
+    code = []
+    strings = []
+    i = 0
+    n = len(text)
+    while i < n:
+        if text.startswith("//", i):
+            i = text.find("\n", i)
+            i = n if i < 0 else i
+        elif text.startswith("/*", i):
+            j = text.find("*/", i + 2)
+            i = n if j < 0 else j + 2
+            code.append(" ")
+        elif text[i] in "\"'":
+            quote = text[i]
+            j = i + 1
+            while j < n and text[j] != quote:
+                j += 2 if text[j] == "\\" else 1
+            if quote == '"':
+                strings.append(unescape(text[i + 1:j]))
+            code.append(quote * 2)
+            i = j + 1
+        else:
+            code.append(text[i])
+            i += 1
+    return "".join(code), strings
+
+
+def header_strings(text, directory, seen):
+    """text 中 #include 的 App 头文件 (递归) 里的字符串字面量，例如 app_config.h 中的版本信息。"""
+    strings = []
+    for name in re.findall(r'^\s*#\s*include\s+"([^"]+)"', text, re.M):
+        for base in [directory] + SOURCE_DIRS:
+            path = os.path.normpath(os.path.join(base, name))
+            if os.path.exists(path):
+                break
+        else:
+            continue
+        if path in seen:
+            continue
+        seen.add(path)
+        with open(path, encoding="utf-8") as f:
+            header = f.read()
+        strings += split_source(header)[1] + header_strings(header, os.path.dirname(path), seen)
+    return strings
+
+
+def collect_charsets(macros, extra):
+    """按字体统计用到的字符，返回 {u8g2 字体名: set(字节)}。"""
+    charsets = {font: set(ALWAYS) | set(extra) for font in set(macros.values())}
+    if I18N_MACRO in macros:
+        charsets[macros[I18N_MACRO]] |= set(range(32, 127))
+    for directory in SOURCE_DIRS:
+        for name in sorted(os.listdir(directory)):
+            if not name.endswith(".c") or name == os.path.basename(OUT_C):
+                continue
+            with open(os.path.join(directory, name), encoding="utf-8") as f:
+                text = f.read()
+            code, strings = split_source(text)
+            strings += header_strings(text, directory, {os.path.normpath(DISPLAY_H)})
+            if name in GLOBAL_SOURCES:
+                used = set(charsets)
+            else:
+                used = {font for macro, font in macros.items() if re.search(r"\b%s\b" % macro, code)}
+            chars = set().union(*map(code_points, strings))
+            for font in used:
+                wide_ok = font == macros.get(I18N_MACRO)  # 只有中文字体需要 Unicode 段
+                charsets[font] |= chars if wide_ok else {c for c in chars if c <= 0xFF}
+    return charsets
+
+
+def load_font(source, name):
+    """从 u8g2_fonts.c 中取出一个字体数组的字节。"""
+    m = re.search(r"const\s+uint8_t\s+%s\s*\[\s*\d+\s*\][^=]*=" % re.escape(name), source)
+    if not m:
+        sys.exit(f"u8g2 字库中找不到 {name}")
+    piece = re.compile(r'\s*"((?:[^"\\]|\\.)*)"', re.S)
+    pieces = []
+    pos = m.end()
+    while True:
+        p = piece.match(source, pos)
+        if not p:
+            break
+        pieces.append(unescape(p.group(1), "latin-1"))  # 相邻字面量分别转义，"\1" "2" 不是 "\12"
+        pos = p.end()
+    return b"".join(pieces)
+
+
+def word(data, pos):
+    return (data[pos] << 8) | data[pos + 1]
+
+
+def subset_unicode(data, pos, keep):
+    """裁剪 Unicode 段，返回 (新的 Unicode 段, 保留的码位)。"""
+    table = pos
+    while word(data, table + 2) != 0xFFFF:  # 查找表项：(到下一块的偏移, 块内最大码位)
+        table += 4
+    pos += word(data, pos)  # 第一块紧跟在查找表之后
+    body = bytearray([0x00, 0x04, 0xFF, 0xFF])  # 只有一个表项，覆盖全部码位
+    found = set()
+    while word(data, pos) != 0:
+        encoding, size = word(data, pos), data[pos + 2]
+        if encoding in keep:
+            body += data[pos:pos + size]
+            found.add(encoding)
+        pos += size
+    return bytes(body + b"\0\0"), found
+
+
+def subset_font(data, keep):
+    """返回只含 keep 中码位的字体数据 (不含末尾的NUL)，保留的字形数以及字体中没有的码位。"""
+    header = bytearray(data[:HEADER_SIZE])
+    unicode_pos = HEADER_SIZE + word(header, 21)
+    records = []
+    found = set()
+    pos = HEADER_SIZE
+    while pos + 1 < len(data) and data[pos + 1] != 0:
+        size = data[pos + 1]
+        if data[pos] in keep:
+            records.append((data[pos], data[pos:pos + size]))
+            found.add(data[pos])
+        pos += size
+    if unicode_pos < pos:
+        sys.exit("字体的 Unicode 段位于8位字形之间，无法裁剪")
+
+    body = bytearray()
+    upper_a = lower_a = None
+    for encoding, record in records:
+        if upper_a is None and encoding >= ord("A"):
+            upper_a = len(body)
+        if lower_a is None and encoding >= ord("a"):
+            lower_a = len(body)
+        body += record
+    end = len(body)
+    body += b"\0\0"  # 8位字形表的结束标记
+    unicode_start = len(body)
+    wide = {c for c in keep if c > 0xFF}
+    if wide:
+        section, wide_found = subset_unicode(data, unicode_pos, wide)
+        body += section
+        found |= wide_found
+    else:
+        body += data[unicode_pos:]  # 没有要保留的 Unicode 字形，原样保留
+    count = len(found)
+
+    header[0] = min(count, 0xFF)
+    for index, value in ((17, end if upper_a is None else upper_a),
+                         (19, end if lower_a is None else lower_a),
+                         (21, unicode_start)):
+        header[index] = value >> 8
+        header[index + 1] = value & 0xFF
+    return bytes(header + body), count, set(keep) - found
+
+
+def c_literal(data, width=72):
+    """字节转为多行 C 字符串字面量，不可打印字符用3位八进制转义。"""
+    lines = []
+    line = ""
+    for b in data:
+        ch = chr(b)
+        piece = ch if 32 <= b < 127 and ch not in '"\\?' else "\\%03o" % b
+        if len(line) + len(piece) > width:
+            lines.append(line)
+            line = ""
+        line += piece
+    lines.append(line)
+    return "\n".join('  "%s"' % l for l in lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--fonts", default=DEFAULT_FONTS, help="u8g2 的 u8g2_fonts.c")
+    parser.add_argument("--extra", default="", help="每个字体额外保留的字符 (按 Latin-1 编码)")
+    args = parser.parse_args()
+
+    with open(DISPLAY_H, encoding="utf-8") as f:
+        macros = dict(FONT_MACRO.findall(f.read()))
+    macros = {macro: "u8g2_font_" + font for macro, font in macros.items()}
+    if not macros:
+        sys.exit(f"{DISPLAY_H} 中没有 APP_FONT(...) 字体定义")
+    if not os.path.exists(args.fonts):
+        sys.exit(f"找不到 {args.fonts}，可用 --fonts 指定 u8g2 的 csrc/u8g2_fonts.c")
+    with open(args.fonts, encoding="latin-1") as f:
+        source = f.read()
+
+    charsets = collect_charsets(macros, args.extra.encode("latin-1"))
+    decls = []
+    defs = []
+    for font in sorted(charsets):
+        name = "app_font_" + font[len("u8g2_font_"):]
+        data = load_font(source, font)
+        subset, count, missing = subset_font(data, charsets[font])
+        if any(c > 0x7F for c in missing):
+            print(f"警告: {font} 中没有 {''.join(chr(c) for c in sorted(missing) if c > 0x7F)}")
+        chars = "".join(chr(c) for c in sorted(charsets[font]) if 32 < c < 127 or c > 0xFF)
+        print(f"{font:<28} {len(data) + 1:>6} -> {len(subset) + 1:>5} 字节, {count} 个字形")
+        decls.append(f"extern const uint8_t {name}[{len(subset) + 1}]; ///< {font} 的子集")
+        defs.append(f"/* {chars.replace('*/', '* /')} */\n"
+                    f"const uint8_t {name}[{len(subset) + 1}] U8G2_FONT_SECTION(\"{name}\") =\n"
+                    f"{c_literal(subset)};\n")
+
+    banner = ("/* 由 Tools/font_subset.py 生成，请勿手工修改。界面文字改动后重新运行该脚本。 */\n\n")
+    with open(OUT_H, "w", encoding="utf-8", newline="\n") as f:
+        f.write(banner + "#ifndef __APP_FONTS_H\n#define __APP_FONTS_H\n\n#include \"u8g2.h\"\n\n"
+                + "\n".join(decls) + "\n\n#endif /* __APP_FONTS_H */\n")
+    with open(OUT_C, "w", encoding="utf-8", newline="\n") as f:
+        f.write(banner + "#include \"app_fonts.h\"\n\n" + "\n".join(defs))
+    print(f"已生成 {os.path.relpath(OUT_C, ROOT)} 和 {os.path.relpath(OUT_H, ROOT)}")
+
+
+if __name__ == "__main__":
+    main()
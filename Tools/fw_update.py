@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""经串口升级固件 (Boot/boot.c 的引导程序)。
+
+先以远程控制命令 REMOTE_CMD_BOOT 让正在运行的应用程序复位进入引导程序 (--no-app 跳过这一步，
+用于复位时按住返回键或上次升级被打断、已停留在引导程序中的情况)，然后：
+BOOT_CMD_BEGIN 擦除记录页 -> BOOT_CMD_QUERY 读出各块的 CRC，与映像相同的块不再发送 (续传)
+-> 按 BOOT_WINDOW 的窗口流水发送其余的块，引导程序擦写一块的同时接收下一块 -> BOOT_CMD_COMMIT 校验整个映像并启动。
+传输在任何时候中断 (包括断电) 都可以重新运行本工具继续。映像为 Table Clock App 目标生成的 .hex 或 .bin
+(从 0x08001000 开始)。引导程序只在 USART1 上通信：用 USB 虚拟串口发送 REMOTE_CMD_BOOT 时，以 --boot-port 指定 USART1。
+
+用法:
+    python3 Tools/fw_update.py /dev/ttyUSB0 "MDK-ARM/Table Clock App/Table Clock.hex"   # 需要 pyserial
+    python3 Tools/fw_update.py /dev/ttyACM0 app.bin --boot-port /dev/ttyUSB0
+    python3 Tools/fw_update.py /dev/ttyUSB0 app.hex --no-app
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+from screen_mirror import cobs_decode, command, crc16, wake
+
+CMD_REMOTE_BOOT = 0x60
+CMD_INFO, CMD_BEGIN, CMD_QUERY, CMD_WRITE, CMD_COMMIT = 0x01, 0x02, 0x03, 0x04, 0x05
+REPLY_FLAG = 0x80
+STATUS = ["ok", "length", "arg", "state", "command", "flash", "verify"]
+APP_BASE = 0x08001000
+QUERY_MAX = 16
+TIMEOUT_S = 1.0
+RETRIES = 5
+
+
+def load_image(path):
+    """读取 .bin 或 Intel HEX，返回从 APP_BASE 开始的映像。"""
+    with open(path, "rb") as f:
+        raw = f.read()
+    if not path.lower().endswith(".hex"):
+        return raw
+    mem = {}
+    upper = 0
+    for line in raw.decode("ascii").split():
+        rec = bytes.fromhex(line.lstrip(":"))
+        count, addr, kind, data = rec[0], (rec[1] << 8) | rec[2], rec[3], rec[4:4 + rec[0]]
+        if sum(rec) & 0xFF or len(data) != count:
+            raise ValueError(f"bad hex record: {line}")
+        if kind == 0x00:
+            for i, b in enumerate(data):
+                mem[upper + addr + i] = b
+        elif kind == 0x04:
+            upper = ((data[0] << 8) | data[1]) << 16
+        elif kind == 0x02:
+            upper = ((data[0] << 8) | data[1]) << 4
+    if not mem or min(mem) != APP_BASE:
+        raise ValueError(f"image must start at 0x{APP_BASE:08X} (build the Table Clock App target)")
+    image = bytearray(b"\xFF" * (max(mem) + 1 - APP_BASE))
+    for a, b in mem.items():
+        image[a - APP_BASE] = b
+    return bytes(image)
+
+
+class Link:
+    """可以同时有多个请求在途的帧链路。"""
+
+    def __init__(self, port):
+        self.port = port
+        self.seq = 0
+        self.pending = bytearray()
+        wake(port)
+
+    def send(self, cmd, data=b""):
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        self.port.write(command(cmd, seq, data))
+        return seq
+
+    def replies(self):
+        """返回已收到的应答 [(命令, 序号, 状态, 数据)]。"""
+        self.pending += self.port.read(256)
+        *chunks, rest = self.pending.split(b"\x00")
+        self.pending = bytearray(rest)
+        out = []
+        for chunk in chunks:
+            payload = cobs_decode(chunk) if chunk else None
+            if payload is None or len(payload) < 5:
+                continue
+            body, (crc,) = payload[:-2], struct.unpack("<H", payload[-2:])
+            if crc16(body) == crc and body[0] & REPLY_FLAG:
+                out.append((body[0] & ~REPLY_FLAG, body[1], body[2], body[3:]))
+        return out
+
+    def request(self, cmd, data=b"", timeout=TIMEOUT_S, retries=RETRIES):
+        """发送请求并等待应答，超时重发，返回应答的数据 (不含状态)。"""
+        for _ in range(retries):
+            seq = self.send(cmd, data)
+            deadline = time.monotonic() + timeout
+            while time.monotonic() < deadline:
+                for rcmd, rseq, status, body in self.replies():
+                    if rcmd != cmd or rseq != seq:
+                        continue
+                    if status != 0:
+                        name = STATUS[status] if status < len(STATUS) else status
+                        raise RuntimeError(f"command 0x{cmd:02X} failed: {name}")
+                    return body
+        raise TimeoutError(f"no reply to command 0x{cmd:02X}")
+
+
+def write_blocks(link, image, page, blocks, window):
+    """按窗口流水发送各块，超时的块重发。"""
+    todo = list(blocks)
+    inflight = {}  # 序号 -> (块号, 发送时刻)
+    tries = {}
+    done = 0
+    while todo or inflight:
+        while todo and len(inflight) < window:
+            block = todo.pop(0)
+            tries[block] = tries.get(block, 0) + 1
+            if tries[block] > RETRIES:
+                raise TimeoutError(f"block {block} not acknowledged")
+            data = image[block * page:(block + 1) * page]
+            inflight[link.send(CMD_WRITE, struct.pack("<H", block) + data)] = (block, time.monotonic())
+        for rcmd, rseq, status, _ in link.replies():
+            if rcmd != CMD_WRITE or rseq not in inflight:
+                continue
+            block, _ = inflight.pop(rseq)
+            if status != 0:
+                raise RuntimeError(f"block {block} failed: {STATUS[status] if status < len(STATUS) else status}")
+            done += 1
+            print(f"\r{done}/{len(blocks)} blocks", end="", file=sys.stderr)
+        now = time.monotonic()
+        for rseq, (block, sent) in list(inflight.items()):
+            if now - sent > TIMEOUT_S:
+                del inflight[rseq]  # 帧丢失或 CRC 错误，引导程序不应答
+                todo.insert(0, block)
+    print(file=sys.stderr)
+
+
+def update(link, image):
+    info = None
+    for _ in range(20):  # 应用程序复位后引导程序立即就绪，这里只留出串口重新打开的时间
+        try:
+            info = link.request(CMD_INFO, timeout=0.2, retries=1)
+            break
+        except TimeoutError:
+            continue
+    if info is None:
+        raise TimeoutError("bootloader not responding")
+    version, page, base, size_max, window, valid = struct.unpack("<BHIIBB", info[:13])
+    print(f"bootloader v{version}: app 0x{base:08X}, {size_max // 1024} KB max, app {'valid' if valid else 'invalid'}")
+    if len(image) > size_max:
+        raise ValueError(f"image is {len(image)} bytes, {size_max} max")
+
+    padded = image + b"\xFF" * (-len(image) % page)
+    count = len(padded) // page
+    link.request(CMD_BEGIN, struct.pack("<IH", len(image), crc16(image)))
+
+    stale = []
+    for first in range(0, count, QUERY_MAX):
+        n = min(QUERY_MAX, count - first)
+        crcs = struct.unpack(f"<{n}H", link.request(CMD_QUERY, struct.pack("<HB", first, n))[:2 * n])
+        stale += [first + i for i, crc in enumerate(crcs) if crc != crc16(padded[(first + i) * page:(first + i + 1) * page])]
+    print(f"{count} blocks, {count - len(stale)} already up to date")
+
+    start = time.monotonic()
+    write_blocks(link, padded, page, stale, window)
+    link.request(CMD_COMMIT, timeout=2.0)
+    elapsed = time.monotonic() - start
+    print(f"done: {len(stale) * page / 1024:.0f} KB in {elapsed:.1f} s")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="串口设备 (运行中的应用程序)")
+    parser.add_argument("image", help="Table Clock App 目标的 .hex 或 .bin")
+    parser.add_argument("--baud", type=int, default=115200, help="应用程序和引导程序的波特率 (BOOT_UART_BAUD)")
+    parser.add_argument("--boot-port", help="引导程序所在的 USART1 (默认与 port 相同)")
+    parser.add_argument("--no-app", action="store_true", help="设备已在引导程序中，跳过 REMOTE_CMD_BOOT")
+    args = parser.parse_args()
+
+    import serial  # pylint: disable=import-outside-toplevel
+    try:
+        image = load_image(args.image)
+        if not args.no_app:
+            with serial.Serial(args.port, args.baud, timeout=0.05) as port:
+                try:
+                    Link(port).request(CMD_REMOTE_BOOT, b"BOOT")
+                except RuntimeError:
+                    raise RuntimeError("the running firmware cannot enter the bootloader "
+                                       "(not the Table Clock App target, or already in the bootloader: use --no-app)")
+        with serial.Serial(args.boot_port or args.port, args.baud, timeout=0.05) as port:
+            update(Link(port), image)
+    except (RuntimeError, TimeoutError, ValueError) as e:
+        print(e, file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""经远程控制协议增量导出时钟的温度历史 (App/app_history.c) 和使用统计 (App/app_usage.c)。
+
+每台时钟读到的最后一个序号保存在状态文件中，下一次只读取新的样本，可以定时轮询多台时钟。
+样本追加到 CSV 文件：端口, 纪元秒 (标准时间), AHT20 温度, DS3231 温度 (°C)。
+--usage 同时把各项使用统计追加为一行：端口, 读取时间, usage, 各项计数。
+--log 改为读取外部闪存中的长期记录 (App/app_datalog.h)，第一次从 --since 指定的纪元秒起，之后从上次读到的位置继续；
+每条样本记录追加为：端口, 纪元秒, AHT20 温度, DS3231 温度 (°C), 气压 (hPa)，没有结果的值为空。
+差值编码 (zigzag + varint) 见 App/app_remote.h 中 REMOTE_CMD_GET_HISTORY 的说明。
+
+用法:
+    python3 Tools/history_export.py /dev/ttyUSB0 /dev/ttyUSB1 --csv history.csv   # 需要 pyserial
+    python3 Tools/history_export.py /dev/ttyUSB0 --csv history.csv --usage
+    python3 Tools/history_export.py /dev/ttyUSB0 --csv archive.csv --log --since 0
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+import time
+
+from input_replay import Link
+
+CMD_GET_USAGE = 0x33
+CMD_GET_HISTORY = 0x34
+CMD_LOG_READ = 0x35
+HEADER = struct.Struct("<IIIHB")
+SERIES = 2
+LOG_HEADER = struct.Struct("<III")
+LOG_RECORD = struct.Struct("<BBI")
+LOG_SAMPLE = 0x01
+BUSY_RETRY_S = 0.5
+BUSY_RETRIES = 4
+
+
+def varint(data, pos):
+    """从 pos 读出一个 varint，返回 (数值, 下一个位置)。"""
+    value = shift = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return value, pos
+
+
+def read_history(link, start):
+    """从序号 start 起读出全部新样本，返回 (样本列表, 样本总数)；样本为 (纪元秒, 各序列的值)。"""
+    samples = []
+    while True:
+        data = link.request(CMD_GET_HISTORY, struct.pack("<I", start))
+        first, total, newest, period, count = HEADER.unpack_from(data)
+        if total < start:
+            start = 0  # 记录已清空，从头读取
+            continue
+        pos = HEADER.size
+        values = [0] * SERIES
+        for k in range(count):
+            for s in range(SERIES):
+                z, pos = varint(data, pos)
+                values[s] += (z >> 1) ^ -(z & 1)
+            samples.append((newest - (total - 1 - (first + k)) * period, list(values)))
+        start = first + count
+        if count == 0 or start >= total:
+            return samples, total
+
+
+def read_log(link, pos, since):
+    """从位置 pos (为 None 时按纪元秒 since 查找) 起读出全部新记录，返回 (记录列表, 下一位置)；记录为 (类型, 纪元秒, 负载)。"""
+    records = []
+    mode, value = (1, since) if pos is None else (0, pos)
+    retries = BUSY_RETRIES
+    while True:
+        try:
+            data = link.request(CMD_LOG_READ, struct.pack("<BI", mode, value))
+        except RuntimeError as e:
+            if not str(e).endswith("busy") or retries == 0:
+                raise
+            retries -= 1
+            time.sleep(BUSY_RETRY_S)  # 正在擦除扇区 (最长约0.4s)
+            continue
+        _oldest, end, value = LOG_HEADER.unpack_from(data)
+        mode = 0
+        at = LOG_HEADER.size
+        while at + LOG_RECORD.size <= len(data):
+            kind, length, epoch = LOG_RECORD.unpack_from(data, at)
+            at += LOG_RECORD.size
+            records.append((kind, epoch, bytes(data[at:at + length])))
+            at += length
+        if at == LOG_HEADER.size or value >= end:
+            return records, value
+
+
+def sample_row(payload):
+    """把一条样本记录的负载转换为 CSV 的各列。"""
+    aht, rtc, dhpa = struct.unpack_from("<hhH", payload)
+    cols = [f"{v / 10:.1f}" if v != -0x8000 else "" for v in (aht, rtc)]
+    cols.append(f"{dhpa / 10:.1f}" if dhpa else "")
+    return ",".join(cols)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("ports", nargs="+", help="串口设备")
+    parser.add_argument("--csv", required=True, help="追加样本的 CSV 文件")
+    parser.add_argument("--state", default="history_state.json", help="记录各端口已读到的序号")
+    parser.add_argument("--usage", action="store_true", help="同时导出使用统计")
+    parser.add_argument("--log", action="store_true", help="导出外部闪存中的长期记录 (代替温度历史)")
+    parser.add_argument("--since", type=int, default=0, help="第一次导出长期记录时的起始纪元秒")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    state = {}
+    if os.path.exists(args.state):
+        with open(args.state, encoding="utf-8") as f:
+            state = json.load(f)
+
+    import serial  # pylint: disable=import-outside-toplevel
+    failed = False
+    with open(args.csv, "a", encoding="utf-8") as out:
+        for name in args.ports:
+            try:
+                with serial.Serial(name, args.baud, timeout=0.05) as port:
+                    link = Link(port)
+                    if args.log:
+                        records, state[name + ":log"] = read_log(link, state.get(name + ":log"), args.since)
+                        samples = [r for r in records if r[0] == LOG_SAMPLE]
+                        for _kind, epoch, payload in samples:
+                            out.write(f"{name},{epoch},{sample_row(payload)}\n")
+                    else:
+                        samples, total = read_history(link, state.get(name, 0))
+                        for epoch, values in samples:
+                            out.write(f"{name},{epoch}," + ",".join(f"{v / 10:.1f}" for v in values) + "\n")
+                        state[name] = total
+                    if args.usage:
+                        data = link.request(CMD_GET_USAGE)
+                        counts = struct.unpack(f"<{len(data) // 4}I", data[:len(data) // 4 * 4])
+                        out.write(f"{name},{int(time.time())},usage," + ",".join(map(str, counts)) + "\n")
+                print(f"{name}: {len(samples)} samples")
+            except (RuntimeError, TimeoutError, OSError) as e:
+                print(f"{name}: {e}", file=sys.stderr)
+                failed = True
+
+    with open(args.state, "w", encoding="utf-8") as f:
+        json.dump(state, f, indent=1)
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
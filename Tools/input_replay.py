@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""经远程控制协议录制、保存和回放时钟上的输入事件 (Hardware/input_replay.c)。
+
+录制从 record 开始，之后在时钟上实际操作，stop 结束；save 把录制读出保存为文件，
+load 把文件写回 (可以是另一个版本的固件)，play 按录制的时间间隔回放。
+文件为连续的 8 字节小端记录，与 Sim 基准测试程序的 --replay 使用同一格式。
+为了让回放从相同的状态开始，录制的第一个操作建议是长按返回键回到主页面。
+
+用法:
+    python3 Tools/input_replay.py /dev/ttyUSB0 record     # 需要 pyserial
+    python3 Tools/input_replay.py /dev/ttyUSB0 stop
+    python3 Tools/input_replay.py /dev/ttyUSB0 save nav.bin
+    python3 Tools/input_replay.py /dev/ttyUSB0 load nav.bin
+    python3 Tools/input_replay.py /dev/ttyUSB0 play
+    ./build-sim/table_clock_bench --replay nav.bin
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+from screen_mirror import cobs_decode, command, crc16, wake
+
+CMD_INPUT_MODE = 0x50
+CMD_INPUT_READ = 0x51
+CMD_INPUT_WRITE = 0x52
+REPLY_FLAG = 0x80
+MODES = {"stop": 0, "record": 1, "play": 2}
+MODE_NAMES = ["off", "recording", "playing"]
+STATUS = ["ok", "length", "arg", "busy", "command", "unsupported"]
+RECORD = struct.Struct("<HHhh")
+TIMEOUT_S = 1.0
+
+
+class Link:
+    def __init__(self, port):
+        self.port = port
+        self.seq = 0
+        self.pending = bytearray()
+        wake(port)
+
+    def request(self, cmd, data=b""):
+        """发送一个请求并等待对应的应答，返回应答的数据 (不含状态)。"""
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        self.port.write(command(cmd, seq, data))
+        deadline = time.monotonic() + TIMEOUT_S
+        while time.monotonic() < deadline:
+            self.pending += self.port.read(256)
+            *chunks, rest = self.pending.split(b"\x00")
+            self.pending = bytearray(rest)
+            for chunk in chunks:
+                payload = cobs_decode(chunk) if chunk else None
+                if payload is None or len(payload) < 5:
+                    continue
+                body, (crc,) = payload[:-2], struct.unpack("<H", payload[-2:])
+                if crc16(body) != crc or body[0] != cmd | REPLY_FLAG or body[1] != seq:
+                    continue
+                if body[2] != 0:
+                    name = STATUS[body[2]] if body[2] < len(STATUS) else body[2]
+                    raise RuntimeError(f"command 0x{cmd:02X} failed: {name}")
+                return body[3:]
+        raise TimeoutError(f"no reply to command 0x{cmd:02X}")
+
+
+def save(link, path):
+    records = []
+    while True:
+        data = link.request(CMD_INPUT_READ, bytes([len(records)]))
+        count, body = data[0], data[1:]
+        records += [body[i:i + RECORD.size] for i in range(0, len(body), RECORD.size)]
+        if len(records) >= count or not body:
+            break
+    with open(path, "wb") as f:
+        f.write(b"".join(records))
+    total = sum(RECORD.unpack(r)[0] for r in records)
+    print(f"{len(records)} events, {total / 1000:.1f} s")
+
+
+def load(link, path):
+    with open(path, "rb") as f:
+        data = f.read()
+    records = [data[i:i + RECORD.size] for i in range(0, len(data) - RECORD.size + 1, RECORD.size)]
+    for index, rec in enumerate(records):
+        link.request(CMD_INPUT_WRITE, bytes([index]) + rec)
+    print(f"{len(records)} events written")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="串口设备")
+    parser.add_argument("action", choices=["record", "stop", "play", "save", "load"])
+    parser.add_argument("file", nargs="?", help="save/load 的文件")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+    if args.action in ("save", "load") and not args.file:
+        parser.error(f"{args.action} needs a file")
+
+    import serial  # pylint: disable=import-outside-toplevel
+    with serial.Serial(args.port, args.baud, timeout=0.05) as port:
+        link = Link(port)
+        try:
+            if args.action == "save":
+                save(link, args.file)
+            elif args.action == "load":
+                load(link, args.file)
+            else:
+                mode, count = link.request(CMD_INPUT_MODE, bytes([MODES[args.action]]))[:2]
+                print(f"{MODE_NAMES[mode]}, {count} events")
+        except (RuntimeError, TimeoutError) as e:
+            print(e, file=sys.stderr)
+            sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
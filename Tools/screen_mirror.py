@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+"""显示 App/app_mirror.c 经串口发出的屏幕镜像。
+
+打开串口后以远程控制命令 REMOTE_CMD_MIRROR 开始镜像，之后每 2 秒续约一次 (固件在 5 秒没有续约时停止)；
+发现帧序号不连续时请求整屏重发。串口上的数据按 0x00 切分：能通过 COBS 解码和 CRC-16 校验、
+且类型字节为 0xF1 的是镜像帧，其余的段 (printf 文本、跟踪帧、远程控制应答) 忽略。
+画面按显示起始行还原为屏幕上看到的样子，在终端中用半格字符绘制 (每个字符上下两个像素)。
+也可以解码抓取的二进制文件，用 --save 把最后一帧保存为 PBM 图像。
+
+用法:
+    python3 Tools/screen_mirror.py /dev/ttyUSB0              # 需要 pyserial, USB 虚拟串口为 /dev/ttyACM0
+    python3 Tools/screen_mirror.py /dev/ttyACM0 --save screen.pbm
+    python3 Tools/screen_mirror.py capture.bin --save screen.pbm
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+FRAME_TAG = 0xF1
+CMD_MIRROR = 0x40
+MIRROR_STOP, MIRROR_START, MIRROR_KEYFRAME = 0, 1, 2
+HEADER = struct.Struct("<BBBBB")
+WIDTH, HEIGHT, PAGES = 128, 64, 8
+LEASE_RENEW_S = 2.0
+WAKE_S = 0.02  # 熄屏时 MCU 在停止模式中，RX 线的起始位唤醒它，等待时钟恢复后再发送请求
+
+
+def cobs_encode(data):
+    out = bytearray()
+    block = bytearray()
+    for byte in data:
+        if byte == 0:
+            out.append(len(block) + 1)
+            out += block
+            block.clear()
+            continue
+        block.append(byte)
+        if len(block) == 0xFE:
+            out.append(0xFF)
+            out += block
+            block.clear()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def crc16(data):
+    """CRC-16/CCITT (初值 0xFFFF)，与 app_store_crc16() 相同。"""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def rle_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        c = data[i]
+        i += 1
+        if c < 0x80:
+            out += data[i:i + c + 1]
+            i += c + 1
+        else:
+            out += bytes([data[i]]) * (c - 0x80 + 3)
+            i += 1
+    return bytes(out)
+
+
+def command(cmd, seq, data=b""):
+    body = bytes([cmd, seq & 0xFF]) + data
+    return cobs_encode(body + struct.pack("<H", crc16(body))) + b"\x00"
+
+
+def wake(port):
+    """发送一个帧分隔符唤醒停止模式中的时钟，这个字节会丢失，之后的几秒内串口保持工作。"""
+    port.write(b"\x00")
+    port.flush()
+    time.sleep(WAKE_S)
+
+
+def parse_frame(chunk):
+    """返回 (序号, 起始行, 页, 起始列, 数据)，不是镜像帧时返回 None。"""
+    payload = cobs_decode(chunk)
+    if payload is None or len(payload) < HEADER.size + 2:
+        return None
+    body, (crc,) = payload[:-2], struct.unpack("<H", payload[-2:])
+    if crc16(body) != crc or body[0] != FRAME_TAG:
+        return None
+    _, seq, line, page, x0 = HEADER.unpack_from(body)
+    data = rle_decode(body[HEADER.size:])
+    if page >= PAGES or x0 + len(data) > WIDTH:
+        return None
+    return seq, line, page, x0, data
+
+
+class Screen:
+    def __init__(self):
+        self.buf = bytearray(WIDTH * PAGES)
+        self.line = 0
+
+    def apply(self, line, page, x0, data):
+        self.line = line & 0x3F
+        self.buf[page * WIDTH + x0:page * WIDTH + x0 + len(data)] = data
+
+    def pixel(self, x, y):
+        """屏幕第 y 行显示显存第 (y + 起始行) % 64 行。"""
+        row = (y + self.line) % HEIGHT
+        return (self.buf[(row // 8) * WIDTH + x] >> (row % 8)) & 1
+
+    def render(self):
+        glyphs = " ▀▄█"
+        rows = []
+        for y in range(0, HEIGHT, 2):
+            rows.append("".join(glyphs[self.pixel(x, y) | (self.pixel(x, y + 1) << 1)] for x in range(WIDTH)))
+        return "\n".join(rows)
+
+    def save_pbm(self, path):
+        with open(path, "w", encoding="ascii") as f:
+            f.write(f"P1\n{WIDTH} {HEIGHT}\n")
+            for y in range(HEIGHT):
+                f.write(" ".join(str(self.pixel(x, y)) for x in range(WIDTH)) + "\n")
+
+
+def decode_file(args):
+    screen = Screen()
+    with open(args.source, "rb") as f:
+        chunks = f.read().split(b"\x00")
+    frames = 0
+    for chunk in chunks:
+        frame = parse_frame(chunk) if chunk else None
+        if frame is not None:
+            screen.apply(*frame[1:])
+            frames += 1
+    print(screen.render())
+    print(f"{frames} frames", file=sys.stderr)
+    if args.save:
+        screen.save_pbm(args.save)
+
+
+def mirror_port(args):
+    import serial  # pylint: disable=import-outside-toplevel
+    screen = Screen()
+    pending = bytearray()
+    cmd_seq = 0
+    expect = None
+    renew = 0.0
+    keyframe = True
+    with serial.Serial(args.source, args.baud, timeout=0.05) as port:
+        wake(port)
+        sys.stdout.write("\x1b[2J")
+        try:
+            while True:
+                now = time.monotonic()
+                if keyframe or now >= renew:
+                    port.write(command(CMD_MIRROR, cmd_seq, bytes([MIRROR_KEYFRAME if keyframe else MIRROR_START])))
+                    cmd_seq += 1
+                    renew = now + LEASE_RENEW_S
+                    keyframe = False
+                pending += port.read(4096)
+                *chunks, rest = pending.split(b"\x00")
+                pending = bytearray(rest)
+                dirty = False
+                for chunk in chunks:
+                    frame = parse_frame(chunk) if chunk else None
+                    if frame is None:
+                        continue
+                    seq = frame[0]
+                    if expect is not None and seq != expect:
+                        keyframe = True  # 丢了帧，屏幕上可能有没收到的变化
+                    expect = (seq + 1) & 0xFF
+                    screen.apply(*frame[1:])
+                    dirty = True
+                if dirty:
+                    sys.stdout.write("\x1b[H" + screen.render() + "\n")
+                    sys.stdout.flush()
+        except KeyboardInterrupt:
+            pass
+        finally:
+            port.write(command(CMD_MIRROR, cmd_seq, bytes([MIRROR_STOP])))
+    if args.save:
+        screen.save_pbm(args.save)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="串口设备或抓取的二进制文件")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--save", help="退出时把画面保存为 PBM 图像")
+    args = parser.parse_args()
+
+    if os.path.exists(args.source) and not args.source.startswith("/dev/"):
+        decode_file(args)
+    else:
+        mirror_port(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""按模块统计 Keil 链接映射文件 (.map) 中的 Flash 和 RAM 占用。
+
+读取 .map 末尾 "Image component sizes" 中的目标文件表和库成员表：
+Flash = Code + RO Data + RW Data (RW 的初值存放在 Flash 中)，RAM = RW Data + ZI Data。
+C 库中体积较大的成员 (printf/scanf 系列、双精度浮点运算、数学函数) 单独列出，
+用于确认精简配置 (见 README 的 "精简构建") 确实没有把它们链接进来。
+
+用法:
+    python3 Tools/size_report.py                                  # 默认读取 MDK-ARM/Table Clock/Table Clock.map
+    python3 Tools/size_report.py path/to/Table\\ Clock.map --top 15
+    python3 Tools/size_report.py old.map --csv > sizes.csv
+"""
+
+import argparse
+import os
+import re
+import sys
+
+DEFAULT_MAP = os.path.join(os.path.dirname(__file__), "..", "MDK-ARM", "Table Clock", "Table Clock.map")
+ROW = re.compile(r"^\s*(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\S.*?)\s*$")
+HEAVY = re.compile(r"printf|scanf|strtod|_fp_|^d(add|mul|div|sub|cmp)|^f(add|mul|div)|pow|exp|log|sqrt|_dsqrt|_drem")
+
+
+def parse_tables(path):
+    """返回 {表头名: [(code, ro, rw, zi, name), ...]}，表头名为 "Object Name" 等。"""
+    tables = {}
+    current = None
+    with open(path, encoding="latin-1") as f:
+        for line in f:
+            if "Code (inc. data)" in line:
+                current = line.split("Debug", 1)[-1].strip()
+                tables.setdefault(current, [])
+                continue
+            if current is None:
+                continue
+            if "Totals" in line:
+                current = None  # 表的末尾
+                continue
+            m = ROW.match(line)
+            if m:
+                code, _inc, ro, rw, zi, _debug, name = m.groups()
+                tables[current].append((int(code), int(ro), int(rw), int(zi), name))
+    return tables
+
+
+def flash(row):
+    return row[0] + row[1] + row[2]
+
+
+def ram(row):
+    return row[2] + row[3]
+
+
+def print_table(title, rows, top):
+    rows = sorted(rows, key=flash, reverse=True)
+    print(f"{title:<28} {'Flash':>7} {'Code':>7} {'RO':>6} {'RW':>5} {'ZI':>6} {'RAM':>6}")
+    for row in rows[:top] if top else rows:
+        code, ro, rw, zi, name = row
+        print(f"{name:<28} {flash(row):>7} {code:>7} {ro:>6} {rw:>5} {zi:>6} {ram(row):>6}")
+    if top and len(rows) > top:
+        rest = rows[top:]
+        print(f"{'(其余 %d 个)' % len(rest):<28} {sum(map(flash, rest)):>7} {'':>7} {'':>6} {'':>5} {'':>6} "
+              f"{sum(map(ram, rest)):>6}")
+    print(f"{'合计':<28} {sum(map(flash, rows)):>7} {'':>7} {'':>6} {'':>5} {'':>6} {sum(map(ram, rows)):>6}")
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map", nargs="?", default=DEFAULT_MAP, help="Keil .map 文件")
+    parser.add_argument("--top", type=int, default=0, help="每张表只列出最大的 N 项")
+    parser.add_argument("--csv", action="store_true", help="以 CSV 输出全部目标文件和库成员")
+    args = parser.parse_args()
+
+    if not os.path.exists(args.map):
+        sys.exit(f"找不到 {args.map}，请先在 Keil 中编译 (Options → Listing 中勾选 Linker Listing)")
+    tables = parse_tables(args.map)
+    objects = tables.get("Object Name", [])
+    members = tables.get("Library Member Name", [])
+    if not objects:
+        sys.exit(f"{args.map} 中没有 Image component sizes 表")
+
+    if args.csv:
+        print("kind,name,flash,code,ro,rw,zi,ram")
+        for kind, rows in (("object", objects), ("library", members)):
+            for row in rows:
+                code, ro, rw, zi, name = row
+                print(f"{kind},{name},{flash(row)},{code},{ro},{rw},{zi},{ram(row)}")
+        return
+
+    print_table("目标文件", objects, args.top)
+    if members:
+        print_table("库成员", members, args.top)
+        heavy = [row for row in members if HEAVY.search(row[4])]
+        if heavy:
+            print("注意：链接了以下体积较大的库函数")
+            print_table("库成员", heavy, 0)
+
+    total = objects + members
+    print(f"Flash 合计 {sum(map(flash, total))} 字节，RAM 合计 {sum(map(ram, total))} 字节 (栈和堆计入 startup_stm32f103xb.o 的 ZI)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""解码 Hardware/trace.c 经串口发出的二进制跟踪帧。
+
+串口上的数据按 0x00 切分：能通过 COBS 解码和 Fletcher-16 校验、且类型字节为 0xF0 的是跟踪帧，
+其余的段 (printf 文本、远程控制应答) 原样输出到标准错误。事件名从 Hardware/trace.h 的
+Trace_Event_e 枚举中读取，修改事件后不需要改这个脚本。
+时钟调速会改变 CYCCNT 的计数频率：遇到 CLOCK 事件后，之后的时间差按事件参数给出的新频率 (MHz) 换算。
+JANK_CAUSE 事件另外显示原因名 (从 Hardware/profiler.h 的 Profiler_Jank_e 读取) 和耗时。
+
+用法:
+    python3 Tools/trace_decode.py /dev/ttyUSB0            # 需要 pyserial
+    python3 Tools/trace_decode.py capture.bin --hz 72000000
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+FRAME_TAG = 0xF0
+HEADER = struct.Struct("<BBH")
+RECORD = struct.Struct("<IHH")
+
+
+def load_event_names(header_path):
+    """从 trace.h 中读取 TRACE_EV_xxx = n 形式的枚举项。"""
+    names = {}
+    with open(header_path, encoding="utf-8") as f:
+        for m in re.finditer(r"TRACE_EV_(\w+)\s*=\s*(\d+)", f.read()):
+            names[int(m.group(2))] = m.group(1)
+    return names
+
+
+def load_jank_causes(header_path):
+    """从 profiler.h 中按顺序读取 Profiler_Jank_e 的枚举项。"""
+    with open(header_path, encoding="utf-8") as f:
+        m = re.search(r"typedef enum \{(.*?)\} Profiler_Jank_e;", f.read(), re.S)
+    if m is None:
+        return {}
+    names = [n.lower() for n in re.findall(r"^\s*PROF_JANK_(\w+)", m.group(1), re.M) if n != "COUNT"]
+    return dict(enumerate(names))
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def fletcher16(data):
+    a = b = 0
+    for byte in data:
+        a = (a + byte) % 255
+        b = (b + a) % 255
+    return (b << 8) | a
+
+
+def parse_frame(chunk):
+    """返回 (序号, 丢弃数, [(时间戳, 事件, 参数)])，不是跟踪帧时返回 None。"""
+    payload = cobs_decode(chunk)
+    if payload is None or len(payload) < HEADER.size + 2:
+        return None
+    body, (crc,) = payload[:-2], struct.unpack("<H", payload[-2:])
+    if fletcher16(body) != crc or body[0] != FRAME_TAG:
+        return None
+    if (len(body) - HEADER.size) % RECORD.size != 0:
+        return None
+    _, seq, dropped = HEADER.unpack_from(body)
+    records = [RECORD.unpack_from(body, off) for off in range(HEADER.size, len(body), RECORD.size)]
+    return seq, dropped, records
+
+
+def read_stream(args):
+    if os.path.exists(args.source) and not args.source.startswith("/dev/"):
+        with open(args.source, "rb") as f:
+            yield f.read()
+        return
+    import serial  # pylint: disable=import-outside-toplevel
+    with serial.Serial(args.source, args.baud, timeout=0.1) as port:
+        while True:
+            yield port.read(4096)
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="串口设备或抓取的二进制文件")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--hz", type=float, default=72e6, help="DWT 初始计数频率 (SystemCoreClock)")
+    parser.add_argument("--header", default=os.path.join(root, "Hardware", "trace.h"))
+    parser.add_argument("--profiler-header", default=os.path.join(root, "Hardware", "profiler.h"))
+    args = parser.parse_args()
+
+    names = load_event_names(args.header)
+    causes = load_jank_causes(args.profiler_header)
+    pending = bytearray()
+    last_seq = None
+    last_dropped = None
+    prev_ts = None
+    t_us = 0.0
+    hz = args.hz
+
+    for data in read_stream(args):
+        pending += data
+        *chunks, pending = pending.split(b"\x00")
+        pending = bytearray(pending)
+        for chunk in chunks:
+            if not chunk:
+                continue
+            frame = parse_frame(bytes(chunk))
+            if frame is None:
+                sys.stderr.write(chunk.decode("utf-8", "replace"))
+                continue
+            seq, dropped, records = frame
+            if last_seq is not None and seq != (last_seq + 1) & 0xFF:
+                print(f"# lost {(seq - last_seq - 1) & 0xFF} frame(s)")
+            if last_dropped is not None and dropped != last_dropped:
+                print(f"# target dropped {(dropped - last_dropped) & 0xFFFF} record(s)")
+            last_seq, last_dropped = seq, dropped
+
+            for ts, ev, arg in records:
+                # CYCCNT 约一分钟回绕一次，按相邻记录的有符号差值展开；
+                # 嵌套中断造成的轻微倒序同样表现为小的负差值
+                if prev_ts is not None:
+                    delta = (ts - prev_ts) & 0xFFFFFFFF
+                    if delta >= 0x80000000:
+                        delta -= 0x100000000
+                    t_us += delta * 1e6 / hz
+                prev_ts = ts
+                name = names.get(ev, f"EV{ev}")
+                if name == "CLOCK" and arg:
+                    hz = arg * 1e6
+                text = f"0x{arg:04X}"
+                if name == "JANK_CAUSE":
+                    cause = "busy" if arg >> 12 == 0xF else causes.get(arg >> 12, f"cause{arg >> 12}")
+                    text += f" {cause} {(arg & 0xFFF) / 10:.1f} ms"
+                print(f"{t_us:14.1f} us  {name:<12} {text}")
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,276 @@
+#!/usr/bin/env python3
+"""由主机的 tzdata 生成内置时区库 App/app_tzdb_data.c 和 App/app_tzdb_data.h。
+
+收录的时区和它们的编号由 Tools/tz_zones.txt 给出 (格式见该文件开头的说明)。
+每个时区取 --year 年的标准时间 UTC 偏移，并在这一年的实际切换时刻中找出对应的夏令时规则：
+规则表从 Hardware/time_core.c 的 dst_zones[] 读取，时区的两次切换 (按本地时间) 与某条规则完全一致时记为该规则的序号，
+不使用夏令时的时区记为 TIME_DST_ZONE_NONE，其他情况 (规则表中没有的切换方式) 报错退出。
+
+生成的表每项 8 字节：名称在字符串池中的偏移、以 15 分钟为单位的 UTC 偏移、夏令时规则和 0.1° 的坐标。
+字符串池中相同的名称只存一份，一个名称是另一个名称的后缀时共用后者的尾部。
+另有一张按名称 (字节序) 排好的编号表，运行时以二分查找按名称定位，并按字母顺序给出选择列表。
+
+用法:
+    python3 Tools/tz_gen.py                          # 默认读取 /usr/share/zoneinfo
+    python3 Tools/tz_gen.py --tzdir path/to/zoneinfo --year 2026
+tz_zones.txt 或 tzdata 更新后需要重新运行。
+"""
+
+import argparse
+import calendar
+import datetime as dt
+import os
+import re
+import sys
+import zoneinfo
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(__file__), ".."))
+ZONES_TXT = os.path.join(ROOT, "Tools", "tz_zones.txt")
+TIME_CORE_C = os.path.join(ROOT, "Hardware", "time_core.c")
+OUT_C = os.path.join(ROOT, "App", "app_tzdb_data.c")
+OUT_H = os.path.join(ROOT, "App", "app_tzdb_data.h")
+
+ID_MAX = 254          # 编号保存在设置的一个字节中，0xFF 留作无效值
+GAP_NAME = "--"       # 空位和无效编号的名称，位于字符串池的开头
+RULE = re.compile(r'\{\s*"(\w+)",\s*\{\s*(\d+),\s*(\d+),\s*(\d+),\s*(\d+)\s*\},'
+                  r'\s*\{\s*(\d+),\s*(\d+),\s*(\d+),\s*(\d+)\s*\},\s*(\d+)\s*\}')
+
+
+def load_rules():
+    """读取 time_core.c 的夏令时规则表：[(名称, 开始 (月, 第几个, 星期, 时), 结束 (...), 偏移分钟)]。"""
+    with open(TIME_CORE_C, encoding="utf-8") as f:
+        text = f.read()
+    body = re.search(r"dst_zones\[\]\s*=\s*\{(.*?)\n\};", text, re.S)
+    if not body:
+        sys.exit(f"{TIME_CORE_C} 中没有 dst_zones[] 规则表")
+    rules = []
+    for m in RULE.finditer(body.group(1)):
+        v = [int(x) for x in m.groups()[1:]]
+        rules.append((m.group(1), tuple(v[0:4]), tuple(v[4:8]), v[8]))
+    return rules
+
+
+def load_zones():
+    """读取 tz_zones.txt：[(tzdb 名称, 显示名称, 坐标或 None)]，空位为 None。"""
+    zones = []
+    with open(ZONES_TXT, encoding="utf-8") as f:
+        for number, line in enumerate(f, 1):
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            if line == "-":
+                zones.append(None)
+                continue
+            fields = [x.strip() for x in line.split(";")]
+            key = fields[0]
+            name = fields[1] if len(fields) > 1 and fields[1] else key.rsplit("/", 1)[-1].replace("_", " ")
+            coords = None
+            if len(fields) > 2 and fields[2]:
+                try:
+                    lat, lon = (float(x) for x in fields[2].split())
+                except ValueError:
+                    sys.exit(f"tz_zones.txt 第 {number} 行：坐标应为 \"纬度 经度\"")
+                coords = (lat, lon)
+            zones.append((key, name, coords))
+    return zones
+
+
+def parse_iso6709(text):
+    """zone.tab 的 ±DDMM[SS]±DDDMM[SS] 坐标转为 (纬度, 经度)。"""
+    m = re.fullmatch(r"([+-])(\d{2})(\d{2})(\d{2})?([+-])(\d{3})(\d{2})(\d{2})?", text)
+    if not m:
+        return None
+    values = []
+    for sign, deg, minute, sec in (m.groups()[0:4], m.groups()[4:8]):
+        value = int(deg) + int(minute) / 60 + int(sec or 0) / 3600
+        values.append(-value if sign == "-" else value)
+    return tuple(values)
+
+
+def load_coords(tzdir):
+    """从 zone1970.tab 和 zone.tab 读取各时区主要城市的坐标，前者优先。"""
+    coords = {}
+    for table in ("zone.tab", "zone1970.tab"):
+        path = os.path.join(tzdir, table)
+        if not os.path.exists(path):
+            continue
+        with open(path, encoding="utf-8") as f:
+            for line in f:
+                if line.startswith("#"):
+                    continue
+                fields = line.rstrip("\n").split("\t")
+                if len(fields) >= 3:
+                    value = parse_iso6709(fields[1])
+                    if value:
+                        coords[fields[2]] = value
+    return coords
+
+
+def nth_weekday(year, month, week, wday, hour):
+    """某月第 week 个星期 wday (1=周一, 7=周日) 的 hour 点，第5个不存在时取最后一个 (与 time_core.c 一致)。"""
+    first = dt.date(year, month, 1)
+    day = 1 + (wday - 1 - first.weekday()) % 7 + (week - 1) * 7
+    if day > calendar.monthrange(year, month)[1]:
+        day -= 7
+    return dt.datetime(year, month, day, hour)
+
+
+def transitions(tz, year):
+    """一年中 UTC 偏移的变化：[(UTC 时刻, 之前的偏移, 之后的偏移)]。按天扫描，再二分到分钟。"""
+    def offset(t):
+        return t.astimezone(tz).utcoffset()
+
+    out = []
+    t = dt.datetime(year, 1, 1, tzinfo=dt.timezone.utc)
+    end = dt.datetime(year + 1, 1, 1, tzinfo=dt.timezone.utc)
+    prev = offset(t)
+    while t < end:
+        nxt = t + dt.timedelta(days=1)
+        value = offset(nxt)
+        if value != prev:
+            lo, hi = t, nxt
+            while hi - lo > dt.timedelta(minutes=1):
+                mid = lo + (hi - lo) / 2
+                mid = mid.replace(second=0, microsecond=0)
+                if mid <= lo:
+                    break
+                if offset(mid) == prev:
+                    lo = mid
+                else:
+                    hi = mid
+            out.append((hi, prev, value))
+            prev = value
+        t = nxt
+    return out
+
+
+def classify(key, year, rules):
+    """返回 (标准时间的 UTC 偏移分钟, 规则序号或 None)。"""
+    try:
+        tz = zoneinfo.ZoneInfo(key)
+    except zoneinfo.ZoneInfoNotFoundError:
+        sys.exit(f"tzdata 中没有时区 {key}")
+    changes = transitions(tz, year)
+    if not changes:
+        off = dt.datetime(year, 7, 1, tzinfo=dt.timezone.utc).astimezone(tz).utcoffset()
+        return int(off.total_seconds()) // 60, None
+    starts = [c for c in changes if c[2] > c[1]]
+    ends = [c for c in changes if c[2] < c[1]]
+    if len(starts) == 1 and len(ends) == 1:
+        start, stop = starts[0], ends[0]
+        std = start[1]
+        shift = int((start[2] - start[1]).total_seconds()) // 60
+        local_start = (start[0] + start[1]).replace(tzinfo=None)  # 切换前的本地标准时间
+        local_end = (stop[0] + stop[1]).replace(tzinfo=None)      # 切换前的本地夏令时
+        for index, (_, s, e, offset_min) in enumerate(rules):
+            if (offset_min == shift and stop[2] == std
+                    and local_start == nth_weekday(year, *s) and local_end == nth_weekday(year, *e)):
+                return int(std.total_seconds()) // 60, index
+    detail = ", ".join(f"{(t + b).replace(tzinfo=None):%m-%d %H:%M} {b}->{a}" for t, b, a in changes)
+    sys.exit(f"{key} 的夏令时 ({detail}) 不在 time_core.c 的规则表中")
+
+
+def build_pool(names):
+    """字符串池：相同的名称只存一份，是另一个名称后缀的名称共用后者的尾部。返回 (池中的名称, {名称: 偏移})。"""
+    unique = sorted(set(names))
+    stored = [n for n in unique if not any(o != n and o.endswith(n) for o in unique)]
+    pool = [GAP_NAME] + stored
+    offsets = {}
+    pos = 0
+    for name in pool:
+        offsets[name] = pos
+        pos += len(name) + 1
+    for name in unique:
+        if name not in offsets:
+            owner = next(o for o in stored if o.endswith(name))
+            offsets[name] = offsets[owner] + len(owner) - len(name)
+    return pool, offsets
+
+
+def c_literal(pool, width=72):
+    """字符串池转为多行 C 字符串字面量，每行只含完整的名称，名称之间以 \\0 分隔 (最后一个的结束符由字面量给出)。"""
+    lines = []
+    line = ""
+    for index, name in enumerate(pool):
+        piece = name.replace("\\", "\\\\").replace('"', '\\"') + ("\\0" if index + 1 < len(pool) else "")
+        if line and len(line) + len(piece) > width:
+            lines.append(line)
+            line = ""
+        line += piece
+    lines.append(line)
+    # "\\0" 后紧跟数字时会被当作更长的八进制转义，补成 "\\000"
+    return "\n".join('    "%s"' % re.sub(r"\\0(?=[0-7])", r"\\000", l) for l in lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--tzdir", default="/usr/share/zoneinfo", help="tzdata 的 zoneinfo 目录")
+    parser.add_argument("--year", type=int, default=dt.date.today().year, help="取哪一年的偏移和切换时刻")
+    args = parser.parse_args()
+
+    zoneinfo.reset_tzpath([args.tzdir])
+    rules = load_rules()
+    zones = load_zones()
+    coords = load_coords(args.tzdir)
+    if len(zones) - 1 > ID_MAX:
+        sys.exit(f"tz_zones.txt 收录了 {len(zones)} 个时区，编号不能超过 {ID_MAX}")
+
+    names = [z[1] for z in zones if z]
+    dup = {n for n in names if names.count(n) > 1}
+    if dup or GAP_NAME in names:
+        sys.exit(f"显示名称重复: {', '.join(sorted(dup | ({GAP_NAME} & set(names))))}")
+    bad = [n for n in names if not n.isascii()]
+    if bad:
+        sys.exit(f"显示名称须为 ASCII: {', '.join(bad)}")
+    pool, offsets = build_pool(names)
+    size = sum(len(n) + 1 for n in pool)
+
+    rows = []
+    for index, zone in enumerate(zones):
+        if zone is None:
+            rows.append(f"    {{{0:5}, {0:4}, {'APP_TZDB_DST_GAP,':<19} {0:5}, {0:5}}}, /* {index:3} (空位) */")
+            continue
+        key, name, where = zone
+        utc_min, rule = classify(key, args.year, rules)
+        if utc_min % 15:
+            sys.exit(f"{key} 的 UTC 偏移 {utc_min} 分钟不是 15 分钟的整数倍")
+        where = where or coords.get(key)
+        if where is None:
+            sys.exit(f"{key} 没有坐标，请在 tz_zones.txt 中给出")
+        lat_d, lon_d = (int(round(v * 10)) for v in where)
+        dst = "TIME_DST_ZONE_NONE" if rule is None else str(rule)
+        label = key if rule is None else f"{key}, {rules[rule][0]}"
+        rows.append(f"    {{{offsets[name]:5}, {utc_min // 15:4}, {dst + ',':<19} {lat_d:5}, {lon_d:5}}}, /* {index:3} {label} */")
+
+    order = sorted((i for i, z in enumerate(zones) if z), key=lambda i: zones[i][1].encode("ascii"))
+    order_rows = []
+    for start in range(0, len(order), 16):
+        order_rows.append("    " + ", ".join(f"{i:3}" for i in order[start:start + 16]) + ",")
+
+    banner = ("/* 由 Tools/tz_gen.py 根据 Tools/tz_zones.txt 和 tzdata 生成，请勿手工修改。"
+              "收录的时区改动后重新运行该脚本。 */\n\n")
+    with open(OUT_H, "w", encoding="utf-8", newline="\n") as f:
+        f.write(banner + "#ifndef __APP_TZDB_DATA_H\n#define __APP_TZDB_DATA_H\n\n"
+                f"#define APP_TZDB_COUNT      {len(zones)}U ///< 时区表的项数 (编号的上限，含空位)\n"
+                f"#define APP_TZDB_LIST_COUNT {len(order)}U ///< 选择列表中的时区数 (不含空位)\n"
+                f"#define APP_TZDB_POOL_SIZE  {size}U ///< 字符串池的字节数\n\n"
+                "#endif /* __APP_TZDB_DATA_H */\n")
+    with open(OUT_C, "w", encoding="utf-8", newline="\n") as f:
+        f.write(banner + "#include \"app_tzdb.h\"\n\n"
+                "/* { 名称, UTC 偏移 (15 分钟), 夏令时规则, 纬度 (0.1°), 经度 (0.1°) } */\n"
+                "const App_Tzdb_Zone_t app_tzdb_zones[APP_TZDB_COUNT] = {\n"
+                + "\n".join(rows) + "\n};\n\n"
+                "/* 按名称排序的时区编号 */\n"
+                "const uint8_t app_tzdb_by_name[APP_TZDB_LIST_COUNT] = {\n"
+                + "\n".join(order_rows) + "\n};\n\n"
+                "/* 字符串池 */\n"
+                "const char app_tzdb_pool[APP_TZDB_POOL_SIZE] =\n"
+                + c_literal(pool) + ";\n")
+    raw = sum(len(n) + 1 for n in names)
+    print(f"{len(order)} 个时区 (编号 0~{len(zones) - 1})，"
+          f"表 {8 * len(zones)} + {len(order)} 字节，字符串池 {raw} -> {size} 字节")
+    print(f"已生成 {os.path.relpath(OUT_C, ROOT)} 和 {os.path.relpath(OUT_H, ROOT)}")
+
+
+if __name__ == "__main__":
+    main()